@@ -0,0 +1,425 @@
+// benchmarks/c/bench_cache.c
+//
+// Native benchmark of catzilla_cache eviction policies. Replays key streams
+// cache-aside style (a get, and a set of a fixed-size value on every miss)
+// against a fresh cache per policy and reports hit ratio and time per
+// operation as JSON. The synthetic streams are a Zipf-skewed one, a loop
+// over more keys than fit, and the skewed stream broken up by one-off scans;
+// --trace replays a log with one key per line instead.
+//
+//   catzilla_bench_cache [--capacity N] [--keys N] [--ops N] [--skew S]
+//                        [--trace FILE] [--seed N] [--output FILE]
+
+#include "cache_engine.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_KEY_MAX 32
+#define BENCH_LINE_MAX 1024
+#define BENCH_VALUE_SIZE 64
+
+typedef struct {
+    char* text;                       // Key bytes, NUL separated
+    char** keys;                      // One pointer into text per operation
+    size_t count;
+    size_t distinct;
+} bench_workload_t;
+
+typedef struct {
+    const char* name;
+    cache_eviction_policy_t policy;
+} bench_policy_t;
+
+static const bench_policy_t bench_policies[] = {
+    { "clock", CACHE_EVICTION_CLOCK },
+    { "tinylfu", CACHE_EVICTION_TINYLFU },
+};
+#define BENCH_POLICY_COUNT (sizeof(bench_policies) / sizeof(bench_policies[0]))
+
+// xorshift64*, so every run with the same seed sees the same keys
+static uint64_t bench_state;
+
+static uint64_t bench_random(void) {
+    bench_state ^= bench_state >> 12;
+    bench_state ^= bench_state << 25;
+    bench_state ^= bench_state >> 27;
+    return bench_state * 2685821657736338717ULL;
+}
+
+static double bench_uniform(void) {
+    return (double)(bench_random() >> 11) / 9007199254740992.0; // [0, 1)
+}
+
+static uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// ---------------------------------------------------------------------------
+// Workloads
+// ---------------------------------------------------------------------------
+
+static int bench_workload_alloc(bench_workload_t* workload, size_t count) {
+    memset(workload, 0, sizeof(*workload));
+    workload->text = malloc(count * BENCH_KEY_MAX + 1);
+    workload->keys = malloc((count ? count : 1) * sizeof(char*));
+    if (!workload->text || !workload->keys) {
+        free(workload->text);
+        free(workload->keys);
+        return -1;
+    }
+    return 0;
+}
+
+static void bench_workload_free(bench_workload_t* workload) {
+    free(workload->text);
+    free(workload->keys);
+}
+
+// Turn a stream of key ids into key strings
+static void bench_workload_fill(bench_workload_t* workload, const uint64_t* ids, size_t count,
+                                size_t distinct) {
+    char* cursor = workload->text;
+    for (size_t i = 0; i < count; i++) {
+        int len = snprintf(cursor, BENCH_KEY_MAX, "key:%" PRIu64, ids[i]);
+        workload->keys[i] = cursor;
+        cursor += len + 1;
+    }
+    workload->count = count;
+    workload->distinct = distinct;
+}
+
+typedef struct {
+    double* cdf;
+    size_t keys;
+} bench_zipf_t;
+
+static int bench_zipf_init(bench_zipf_t* zipf, size_t keys, double skew) {
+    zipf->keys = keys;
+    zipf->cdf = malloc(keys * sizeof(double));
+    if (!zipf->cdf) return -1;
+    double total = 0.0;
+    for (size_t i = 0; i < keys; i++) {
+        total += 1.0 / pow((double)(i + 1), skew);
+        zipf->cdf[i] = total;
+    }
+    for (size_t i = 0; i < keys; i++) zipf->cdf[i] /= total;
+    return 0;
+}
+
+// Rank of the next key; rank 0 is the most popular
+static uint64_t bench_zipf_next(const bench_zipf_t* zipf) {
+    double u = bench_uniform();
+    size_t low = 0, high = zipf->keys - 1;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (zipf->cdf[mid] < u) low = mid + 1;
+        else high = mid;
+    }
+    return low;
+}
+
+// Ranks map to scattered ids, so popularity does not follow insertion order
+static uint64_t bench_rank_id(uint64_t rank) {
+    return (rank * 0x9E3779B97F4A7C15ULL) >> 16;
+}
+
+static int bench_build_zipf(bench_workload_t* workload, const bench_zipf_t* zipf, size_t ops) {
+    uint64_t* ids = malloc(ops * sizeof(uint64_t));
+    if (!ids || bench_workload_alloc(workload, ops) != 0) {
+        free(ids);
+        return -1;
+    }
+    for (size_t i = 0; i < ops; i++) ids[i] = bench_rank_id(bench_zipf_next(zipf));
+    bench_workload_fill(workload, ids, ops, zipf->keys);
+    free(ids);
+    return 0;
+}
+
+// A loop over twice the capacity: every key is reused, but too late for recency
+static int bench_build_loop(bench_workload_t* workload, size_t capacity, size_t ops) {
+    size_t span = capacity * 2;
+    uint64_t* ids = malloc(ops * sizeof(uint64_t));
+    if (!ids || bench_workload_alloc(workload, ops) != 0) {
+        free(ids);
+        return -1;
+    }
+    for (size_t i = 0; i < ops; i++) ids[i] = i % span;
+    bench_workload_fill(workload, ids, ops, span);
+    free(ids);
+    return 0;
+}
+
+// The skewed stream with a scan of capacity one-off keys after every
+// 2 * capacity skewed operations, like a crawler or report job
+static int bench_build_zipf_scan(bench_workload_t* workload, const bench_zipf_t* zipf,
+                                 size_t capacity, size_t ops) {
+    uint64_t* ids = malloc(ops * sizeof(uint64_t));
+    if (!ids || bench_workload_alloc(workload, ops) != 0) {
+        free(ids);
+        return -1;
+    }
+    uint64_t scan_id = 1ULL << 48; // Above every id bench_rank_id returns
+    size_t scanned = 0;
+    for (size_t i = 0; i < ops; i++) {
+        bool scanning = (i % (capacity * 3)) >= capacity * 2;
+        if (scanning) {
+            ids[i] = scan_id++;
+            scanned++;
+        } else {
+            ids[i] = bench_rank_id(bench_zipf_next(zipf));
+        }
+    }
+    bench_workload_fill(workload, ids, ops, zipf->keys + scanned);
+    free(ids);
+    return 0;
+}
+
+// One key per line; blank lines are skipped and long keys cut at BENCH_LINE_MAX
+static int bench_load_trace(bench_workload_t* workload, const char* path) {
+    FILE* in = fopen(path, "r");
+    if (!in) {
+        fprintf(stderr, "cannot open %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    memset(workload, 0, sizeof(*workload));
+    size_t text_size = 0, text_capacity = 0, key_capacity = 0;
+    size_t* offsets = NULL;
+    char line[BENCH_LINE_MAX];
+    int status = 0;
+
+    while (status == 0 && fgets(line, sizeof(line), in)) {
+        size_t len = strcspn(line, "\r\n");
+        bool complete = line[len] != '\0' || feof(in);
+        if (!complete) {
+            // Drop the rest of an overlong line
+            int c;
+            while ((c = fgetc(in)) != EOF && c != '\n') {}
+        }
+        line[len] = '\0';
+        if (len == 0) continue;
+
+        if (text_size + len + 1 > text_capacity) {
+            size_t grown = text_capacity ? text_capacity * 2 : 1 << 16;
+            while (grown < text_size + len + 1) grown *= 2;
+            char* text = realloc(workload->text, grown);
+            if (!text) { status = -1; break; }
+            workload->text = text;
+            text_capacity = grown;
+        }
+        if (workload->count == key_capacity) {
+            size_t grown = key_capacity ? key_capacity * 2 : 4096;
+            size_t* grown_offsets = realloc(offsets, grown * sizeof(size_t));
+            if (!grown_offsets) { status = -1; break; }
+            offsets = grown_offsets;
+            key_capacity = grown;
+        }
+        memcpy(workload->text + text_size, line, len + 1);
+        offsets[workload->count++] = text_size;
+        text_size += len + 1;
+    }
+    fclose(in);
+
+    // The text moved while growing; resolve pointers once it is final
+    if (status == 0 && workload->count > 0) {
+        workload->keys = malloc(workload->count * sizeof(char*));
+        if (!workload->keys) status = -1;
+        for (size_t i = 0; status == 0 && i < workload->count; i++) {
+            workload->keys[i] = workload->text + offsets[i];
+        }
+    }
+    free(offsets);
+    if (status != 0) {
+        fprintf(stderr, "out of memory reading %s\n", path);
+        bench_workload_free(workload);
+        return -1;
+    }
+    if (workload->count == 0) {
+        fprintf(stderr, "%s has no keys\n", path);
+        bench_workload_free(workload);
+        return -1;
+    }
+    workload->distinct = 0; // Not counted for traces
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// Measurement
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    size_t hits;
+    double hit_ratio;
+    double ns_per_op;
+    uint64_t evictions;
+    uint64_t rejections;
+} bench_result_t;
+
+static int bench_run(const bench_workload_t* workload, size_t capacity, cache_eviction_policy_t policy,
+                     bench_result_t* result) {
+    memset(result, 0, sizeof(*result));
+    cache_config_t config = {
+        .capacity = capacity,
+        .default_ttl = 3600,
+        .max_value_size = BENCH_VALUE_SIZE,
+        .eviction_policy = policy,
+    };
+    catzilla_cache_t* cache = catzilla_cache_create_with_config(&config);
+    if (!cache) return -1;
+
+    static const char value[BENCH_VALUE_SIZE] = { 0 };
+    size_t hits = 0;
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < workload->count; i++) {
+        const char* key = workload->keys[i];
+        if (catzilla_cache_get(cache, key).found) {
+            hits++;
+        } else {
+            catzilla_cache_set(cache, key, value, sizeof(value), 0);
+        }
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+
+    cache_statistics_t stats = catzilla_cache_get_stats(cache);
+    result->hits = hits;
+    result->hit_ratio = workload->count ? (double)hits / (double)workload->count : 0.0;
+    result->ns_per_op = workload->count ? (double)elapsed / (double)workload->count : 0.0;
+    result->evictions = stats.evictions;
+    result->rejections = stats.rejections;
+    catzilla_cache_destroy(cache);
+    return 0;
+}
+
+static void bench_print_result(FILE* out, bool first, const char* workload_name, const char* policy,
+                               const bench_workload_t* workload, const bench_result_t* result) {
+    fprintf(out, "%s    {\"workload\": \"%s\", \"policy\": \"%s\", \"ops\": %zu, ",
+            first ? "" : ",\n", workload_name, policy, workload->count);
+    if (workload->distinct) {
+        fprintf(out, "\"distinct_keys\": %zu, ", workload->distinct);
+    } else {
+        fprintf(out, "\"distinct_keys\": null, ");
+    }
+    fprintf(out, "\"hits\": %zu, \"hit_ratio\": %.4f, \"ns_per_op\": %.2f, "
+                 "\"evictions\": %" PRIu64 ", \"rejections\": %" PRIu64 "}",
+            result->hits, result->hit_ratio, result->ns_per_op, result->evictions, result->rejections);
+}
+
+static void bench_usage(const char* program) {
+    fprintf(stderr,
+            "usage: %s [--capacity N] [--keys N] [--ops N] [--skew S] [--trace FILE] "
+            "[--seed N] [--output FILE]\n",
+            program);
+}
+
+int main(int argc, char** argv) {
+    size_t capacity = 10000;
+    size_t keys = 100000;
+    size_t ops = 2000000;
+    double skew = 0.99;
+    uint64_t seed = 0x5eed;
+    const char* trace = NULL;
+    const char* output = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(argv[i], "--capacity") == 0 && value) {
+            capacity = (size_t)strtoull(value, NULL, 10);
+        } else if (strcmp(argv[i], "--keys") == 0 && value) {
+            keys = (size_t)strtoull(value, NULL, 10);
+        } else if (strcmp(argv[i], "--ops") == 0 && value) {
+            ops = (size_t)strtoull(value, NULL, 10);
+        } else if (strcmp(argv[i], "--skew") == 0 && value) {
+            skew = strtod(value, NULL);
+        } else if (strcmp(argv[i], "--trace") == 0 && value) {
+            trace = value;
+        } else if (strcmp(argv[i], "--seed") == 0 && value) {
+            seed = strtoull(value, NULL, 0);
+        } else if (strcmp(argv[i], "--output") == 0 && value) {
+            output = value;
+        } else {
+            bench_usage(argv[0]);
+            return 2;
+        }
+        i++;
+    }
+    if (capacity == 0 || keys == 0 || ops == 0 || skew < 0.0) {
+        bench_usage(argv[0]);
+        return 2;
+    }
+    bench_state = seed ? seed : 1;
+
+    bench_workload_t workloads[3];
+    const char* names[3];
+    size_t workload_count = 0;
+    int status = 0;
+
+    if (trace) {
+        if (bench_load_trace(&workloads[0], trace) != 0) return 1;
+        names[workload_count++] = "trace";
+    } else {
+        bench_zipf_t zipf;
+        if (bench_zipf_init(&zipf, keys, skew) != 0) {
+            fprintf(stderr, "out of memory\n");
+            return 1;
+        }
+        if (bench_build_zipf(&workloads[workload_count], &zipf, ops) == 0) {
+            names[workload_count++] = "zipf";
+        } else {
+            status = 1;
+        }
+        if (status == 0 && bench_build_loop(&workloads[workload_count], capacity, ops) == 0) {
+            names[workload_count++] = "loop";
+        } else {
+            status = 1;
+        }
+        if (status == 0 && bench_build_zipf_scan(&workloads[workload_count], &zipf, capacity, ops) == 0) {
+            names[workload_count++] = "zipf_scan";
+        } else {
+            status = 1;
+        }
+        free(zipf.cdf);
+        if (status != 0) {
+            fprintf(stderr, "out of memory\n");
+            for (size_t w = 0; w < workload_count; w++) bench_workload_free(&workloads[w]);
+            return 1;
+        }
+    }
+
+    FILE* out = stdout;
+    if (output && !(out = fopen(output, "w"))) {
+        fprintf(stderr, "cannot open %s: %s\n", output, strerror(errno));
+        for (size_t w = 0; w < workload_count; w++) bench_workload_free(&workloads[w]);
+        return 1;
+    }
+
+    fprintf(out, "{\n  \"benchmark\": \"cache_policy\",\n  \"seed\": %" PRIu64 ",\n"
+                 "  \"capacity\": %zu,\n  \"keys\": %zu,\n  \"skew\": %.3f,\n"
+                 "  \"value_bytes\": %d,\n  \"results\": [\n",
+            seed, capacity, trace ? (size_t)0 : keys, skew, BENCH_VALUE_SIZE);
+
+    bool first = true;
+    for (size_t w = 0; w < workload_count && status == 0; w++) {
+        for (size_t p = 0; p < BENCH_POLICY_COUNT; p++) {
+            bench_result_t result;
+            if (bench_run(&workloads[w], capacity, bench_policies[p].policy, &result) != 0) {
+                fprintf(stderr, "cannot create a cache of %zu entries\n", capacity);
+                status = 1;
+                break;
+            }
+            bench_print_result(out, first, names[w], bench_policies[p].name, &workloads[w], &result);
+            first = false;
+        }
+    }
+
+    fprintf(out, "\n  ]\n}\n");
+    for (size_t w = 0; w < workload_count; w++) bench_workload_free(&workloads[w]);
+    if (out != stdout) fclose(out);
+    return status;
+}
@@ -0,0 +1,990 @@
+// benchmarks/c/bench_http.c
+//
+// HTTP/1.1 load generator on one libuv loop, and a regression gate. Runs the
+// endpoints of a benchmarks/servers/*/endpoints.json scenario (or one URL)
+// against a server that is already listening, and reports throughput and
+// latency percentiles per endpoint as JSON.
+//
+// Closed loop (default): every connection sends its next request as soon as
+// the previous response is in. Open loop (--rate): requests are due at a
+// constant rate whether or not the server kept up; a request no connection
+// is free for waits, and its latency counts from when it was due. Both
+// report latency free of coordinated omission: open-loop latencies start at
+// the intended send time, and closed-loop histograms get the samples a
+// stalled connection did not send back-filled (as HdrHistogram's
+// recordValueWithExpectedInterval does), with the raw figures alongside.
+//
+// With --baseline, results are compared endpoint by endpoint against an
+// earlier output; a p50, p99 or throughput regression beyond its threshold
+// makes the exit status 1.
+//
+//   catzilla_bench (--url http://HOST:PORT/PATH | --endpoints FILE [--host H] [--port P])
+//                  [--connections N] [--duration S] [--warmup S] [--rate R]
+//                  [--endpoint NAME] [--output FILE] [--baseline FILE]
+//                  [--max-p50-regression PCT] [--max-p99-regression PCT]
+//                  [--max-throughput-regression PCT]
+
+#include "metrics.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <uv.h>
+#include <yyjson.h>
+
+#ifdef _WIN32
+#define strcasecmp _stricmp
+#define strncasecmp _strnicmp
+#else
+#include <strings.h>
+#endif
+
+#define BENCH_MAX_ENDPOINTS 64
+#define BENCH_MAX_VARIANTS 16
+#define BENCH_NAME_MAX 288
+#define BENCH_READ_CHUNK (64 * 1024)
+#define BENCH_TICK_MS 1
+
+typedef struct {
+    char name[BENCH_NAME_MAX];
+    char method[16];
+    char path[256];
+    const char* skipped;               // Why the endpoint cannot be run, or NULL
+    char* requests[BENCH_MAX_VARIANTS];  // Complete requests, sent in turn
+    size_t lengths[BENCH_MAX_VARIANTS];
+    size_t count;
+} bench_endpoint_t;
+
+typedef struct {
+    uint64_t completed;
+    uint64_t errors;                   // Failed connections and malformed or cut responses
+    uint64_t non_2xx;
+    uint64_t unfinished;               // Due in the window, still waiting when it closed
+    uint64_t backlog_max;              // Open loop: most requests waiting for a connection
+    double seconds;
+    double requests_per_sec;
+    catzilla_histogram_t latency;      // Corrected for coordinated omission
+    catzilla_histogram_t service;      // Send to last byte, as measured
+} bench_result_t;
+
+struct bench_run_s;
+
+typedef struct {
+    uv_tcp_t tcp;
+    uv_connect_t connect;
+    uv_write_t write;
+    struct bench_run_s* run;
+    bool open;
+    bool busy;
+    bool writing;                      // The write request is in use
+    bool send_queued;                  // Response came back before its write completed
+    uint64_t intended_ns;              // When the request in flight was due
+    uint64_t sent_ns;
+    size_t next_variant;
+    char* in;
+    size_t in_length;
+    size_t in_capacity;
+} bench_conn_t;
+
+typedef struct bench_run_s {
+    uv_loop_t loop;
+    uv_timer_t tick;
+    struct sockaddr_storage address;
+    const bench_endpoint_t* endpoint;
+    bench_conn_t* conns;
+    int conn_count;
+    int conns_closed;
+    double rate;                       // Requests per second; 0 = closed loop
+    uint64_t start_ns;
+    uint64_t measure_ns;               // Warmup ends
+    uint64_t end_ns;
+    uint64_t scheduled;                // Open loop: requests due so far
+    uint64_t* backlog;                 // Open loop: due times waiting for a connection
+    size_t backlog_head;
+    size_t backlog_count;
+    size_t backlog_capacity;
+    bool stopping;
+    bench_result_t* result;
+} bench_run_t;
+
+// ---------------------------------------------------------------------------
+// Endpoints
+// ---------------------------------------------------------------------------
+
+// Scalar as text; false for null and containers
+static bool bench_scalar_text(yyjson_val* value, char* out, size_t size) {
+    if (yyjson_is_str(value)) {
+        snprintf(out, size, "%s", yyjson_get_str(value));
+    } else if (yyjson_is_bool(value)) {
+        snprintf(out, size, "%s", yyjson_get_bool(value) ? "true" : "false");
+    } else if (yyjson_is_uint(value)) {
+        snprintf(out, size, "%" PRIu64, yyjson_get_uint(value));
+    } else if (yyjson_is_sint(value)) {
+        snprintf(out, size, "%" PRId64, yyjson_get_sint(value));
+    } else if (yyjson_is_real(value)) {
+        snprintf(out, size, "%g", yyjson_get_real(value));
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// A list picks one entry per variant, a scalar is always itself
+static yyjson_val* bench_pick(yyjson_val* value, size_t variant) {
+    if (yyjson_is_arr(value)) {
+        size_t size = yyjson_arr_size(value);
+        return size ? yyjson_arr_get(value, variant % size) : NULL;
+    }
+    return value;
+}
+
+static void bench_append_encoded(char* out, size_t size, const char* text) {
+    static const char hex[] = "0123456789ABCDEF";
+    size_t length = strlen(out);
+    for (const unsigned char* p = (const unsigned char*)text; *p && length + 4 < size; p++) {
+        if ((*p >= 'A' && *p <= 'Z') || (*p >= 'a' && *p <= 'z') || (*p >= '0' && *p <= '9') ||
+            *p == '-' || *p == '_' || *p == '.' || *p == '~') {
+            out[length++] = (char)*p;
+        } else {
+            out[length++] = '%';
+            out[length++] = hex[*p >> 4];
+            out[length++] = hex[*p & 15];
+        }
+    }
+    out[length] = '\0';
+}
+
+// Request target of one variant: {name} path parameters filled in, query appended
+static void bench_build_target(yyjson_val* item, size_t variant, char* target, size_t size) {
+    const char* path = yyjson_get_str(yyjson_obj_get(item, "path"));
+    yyjson_val* path_params = yyjson_obj_get(item, "path_params");
+    size_t length = 0;
+    target[0] = '\0';
+    for (const char* p = path; *p && length + 1 < size; ) {
+        const char* close = *p == '{' ? strchr(p, '}') : NULL;
+        if (close) {
+            char name[64];
+            snprintf(name, sizeof(name), "%.*s", (int)(close - p - 1), p + 1);
+            char value[128] = "1";
+            bench_scalar_text(bench_pick(yyjson_obj_get(path_params, name), variant), value, sizeof(value));
+            target[length] = '\0';
+            bench_append_encoded(target, size, value);
+            length = strlen(target);
+            p = close + 1;
+        } else {
+            target[length++] = *p++;
+        }
+    }
+    target[length] = '\0';
+
+    yyjson_val* query = yyjson_obj_get(item, "params");
+    if (!query) query = yyjson_obj_get(item, "query_params");
+    bool first = strchr(target, '?') == NULL;
+    size_t idx, max;
+    yyjson_val *key, *value;
+    yyjson_obj_foreach(query, idx, max, key, value) {
+        char text[128];
+        if (!bench_scalar_text(bench_pick(value, variant + idx), text, sizeof(text))) continue;
+        length = strlen(target);
+        if (length + 2 >= size) break;
+        target[length] = first ? '?' : '&';
+        target[length + 1] = '\0';
+        first = false;
+        bench_append_encoded(target, size, yyjson_get_str(key));
+        length = strlen(target);
+        if (length + 2 >= size) break;
+        target[length] = '=';
+        target[length + 1] = '\0';
+        bench_append_encoded(target, size, text);
+    }
+}
+
+static int bench_build_request(bench_endpoint_t* endpoint, yyjson_val* item, size_t variant,
+                               const char* host_header) {
+    char target[2048];
+    bench_build_target(item, variant, target, sizeof(target));
+
+    yyjson_val* body_value = yyjson_obj_get(item, "body");
+    if (!body_value) body_value = yyjson_obj_get(item, "test_data");
+    size_t body_length = 0;
+    char* body = NULL;
+    if (body_value && !yyjson_is_null(body_value)) {
+        body = yyjson_val_write(body_value, YYJSON_WRITE_NOFLAG, &body_length);
+        if (!body) return -1;
+    }
+
+    size_t capacity = strlen(target) + body_length + 4096;
+    char* request = malloc(capacity);
+    if (!request) {
+        free(body);
+        return -1;
+    }
+    int length = snprintf(request, capacity, "%s %s HTTP/1.1\r\nHost: %s\r\n", endpoint->method, target, host_header);
+
+    bool has_content_type = false;
+    size_t idx, max;
+    yyjson_val *key, *value;
+    yyjson_obj_foreach(yyjson_obj_get(item, "headers"), idx, max, key, value) {
+        char text[512];
+        if (!bench_scalar_text(bench_pick(value, variant), text, sizeof(text))) continue;
+        if (strcasecmp(yyjson_get_str(key), "Content-Type") == 0) has_content_type = true;
+        length += snprintf(request + length, capacity - (size_t)length, "%s: %s\r\n", yyjson_get_str(key), text);
+    }
+    if (body) {
+        if (!has_content_type) {
+            length += snprintf(request + length, capacity - (size_t)length, "Content-Type: application/json\r\n");
+        }
+        length += snprintf(request + length, capacity - (size_t)length, "Content-Length: %zu\r\n", body_length);
+    }
+    length += snprintf(request + length, capacity - (size_t)length, "\r\n");
+    if (body) {
+        memcpy(request + length, body, body_length);
+        length += (int)body_length;
+        free(body);
+    }
+
+    endpoint->requests[endpoint->count] = request;
+    endpoint->lengths[endpoint->count] = (size_t)length;
+    endpoint->count++;
+    return 0;
+}
+
+// Variants cover the longest value list of the endpoint, up to BENCH_MAX_VARIANTS
+static size_t bench_variant_count(yyjson_val* item) {
+    static const char* const fields[] = { "params", "query_params", "path_params", "headers" };
+    size_t count = 1;
+    for (size_t f = 0; f < sizeof(fields) / sizeof(fields[0]); f++) {
+        size_t idx, max;
+        yyjson_val *key, *value;
+        yyjson_obj_foreach(yyjson_obj_get(item, fields[f]), idx, max, key, value) {
+            (void)key;
+            if (yyjson_arr_size(value) > count) count = yyjson_arr_size(value);
+        }
+    }
+    return count < BENCH_MAX_VARIANTS ? count : BENCH_MAX_VARIANTS;
+}
+
+static int bench_load_endpoints(const char* file, const char* host_header, const char* only,
+                                bench_endpoint_t* endpoints, size_t* count) {
+    FILE* in = fopen(file, "rb");
+    if (!in) {
+        fprintf(stderr, "cannot open %s: %s\n", file, strerror(errno));
+        return -1;
+    }
+    fseek(in, 0, SEEK_END);
+    long size = ftell(in);
+    fseek(in, 0, SEEK_SET);
+    char* data = size > 0 ? malloc((size_t)size) : NULL;
+    size_t got = data ? fread(data, 1, (size_t)size, in) : 0;
+    fclose(in);
+    yyjson_doc* doc = data ? yyjson_read(data, got, YYJSON_READ_NOFLAG) : NULL;
+    free(data);
+    yyjson_val* list = yyjson_obj_get(yyjson_doc_get_root(doc), "endpoints");
+    if (!yyjson_is_arr(list)) {
+        fprintf(stderr, "%s has no endpoints list\n", file);
+        yyjson_doc_free(doc);
+        return -1;
+    }
+
+    *count = 0;
+    size_t idx, max;
+    yyjson_val* item;
+    yyjson_arr_foreach(list, idx, max, item) {
+        const char* path = yyjson_get_str(yyjson_obj_get(item, "path"));
+        if (!path || *count == BENCH_MAX_ENDPOINTS) continue;
+        const char* method = yyjson_get_str(yyjson_obj_get(item, "method"));
+        const char* name = yyjson_get_str(yyjson_obj_get(item, "name"));
+
+        bench_endpoint_t* endpoint = &endpoints[*count];
+        memset(endpoint, 0, sizeof(*endpoint));
+        snprintf(endpoint->method, sizeof(endpoint->method), "%s", method ? method : "GET");
+        snprintf(endpoint->path, sizeof(endpoint->path), "%s", path);
+        if (name) {
+            snprintf(endpoint->name, sizeof(endpoint->name), "%s", name);
+        } else {
+            snprintf(endpoint->name, sizeof(endpoint->name), "%s %s", endpoint->method, path);
+        }
+        if (only && strcmp(only, endpoint->name) != 0) continue;
+
+        if (yyjson_obj_get(item, "form_data")) {
+            endpoint->skipped = "multipart form data is not generated";
+        } else {
+            size_t variants = bench_variant_count(item);
+            for (size_t v = 0; v < variants; v++) {
+                if (bench_build_request(endpoint, item, v, host_header) != 0) {
+                    yyjson_doc_free(doc);
+                    return -1;
+                }
+            }
+        }
+        (*count)++;
+    }
+    yyjson_doc_free(doc);
+    return 0;
+}
+
+static void bench_free_endpoints(bench_endpoint_t* endpoints, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        for (size_t v = 0; v < endpoints[i].count; v++) free(endpoints[i].requests[v]);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Responses
+// ---------------------------------------------------------------------------
+
+typedef enum { BENCH_PARTIAL, BENCH_COMPLETE, BENCH_MALFORMED } bench_parse_t;
+
+static const char* bench_find_header(const char* headers, size_t length, const char* name) {
+    size_t name_length = strlen(name);
+    const char* end = headers + length;
+    for (const char* line = headers; line < end; ) {
+        const char* next = memchr(line, '\n', (size_t)(end - line));
+        if (!next) break;
+        if ((size_t)(next - line) > name_length && strncasecmp(line, name, name_length) == 0 &&
+            line[name_length] == ':') {
+            const char* value = line + name_length + 1;
+            while (*value == ' ') value++;
+            return value;
+        }
+        line = next + 1;
+    }
+    return NULL;
+}
+
+// Whole chunked body in data? Sets its length including the final CRLF
+static bench_parse_t bench_chunked_length(const char* data, size_t length, size_t* consumed) {
+    size_t offset = 0;
+    for (;;) {
+        const char* line_end = memchr(data + offset, '\n', length - offset);
+        if (!line_end) return BENCH_PARTIAL;
+        char* digits_end = NULL;
+        unsigned long long size = strtoull(data + offset, &digits_end, 16);
+        if (digits_end == data + offset) return BENCH_MALFORMED;
+        offset = (size_t)(line_end - data) + 1;
+        if (size == 0) {
+            // Trailers end with an empty line
+            for (;;) {
+                const char* trailer_end = memchr(data + offset, '\n', length - offset);
+                if (!trailer_end) return BENCH_PARTIAL;
+                size_t line_length = (size_t)(trailer_end - (data + offset));
+                offset = (size_t)(trailer_end - data) + 1;
+                if (line_length == 0 || (line_length == 1 && trailer_end[-1] == '\r')) {
+                    *consumed = offset;
+                    return BENCH_COMPLETE;
+                }
+            }
+        }
+        if (length - offset < size + 2) return BENCH_PARTIAL;
+        offset += (size_t)size + 2;
+    }
+}
+
+/**
+ * Parse one response at the start of data
+ * @return BENCH_COMPLETE with its length, status and whether the server closes
+ */
+static bench_parse_t bench_parse_response(const char* data, size_t length, size_t* consumed,
+                                          int* status, bool* closes) {
+    if (length < 12) return BENCH_PARTIAL;
+    if (memcmp(data, "HTTP/1.", 7) != 0) return BENCH_MALFORMED;
+
+    const char* header_end = NULL;
+    for (const char* p = data; p + 3 < data + length; p++) {
+        p = memchr(p, '\r', (size_t)(data + length - p));
+        if (!p || p + 3 >= data + length) break;
+        if (p[1] == '\n' && p[2] == '\r' && p[3] == '\n') {
+            header_end = p + 4;
+            break;
+        }
+    }
+    if (!header_end) return length > 64 * 1024 ? BENCH_MALFORMED : BENCH_PARTIAL;
+
+    size_t header_length = (size_t)(header_end - data);
+    *status = atoi(data + 9);
+    const char* connection = bench_find_header(data, header_length, "Connection");
+    *closes = connection && strncasecmp(connection, "close", 5) == 0;
+
+    const char* encoding = bench_find_header(data, header_length, "Transfer-Encoding");
+    if (encoding && strncasecmp(encoding, "chunked", 7) == 0) {
+        size_t body_length = 0;
+        bench_parse_t parsed = bench_chunked_length(header_end, length - header_length, &body_length);
+        if (parsed == BENCH_COMPLETE) *consumed = header_length + body_length;
+        return parsed;
+    }
+
+    const char* content_length = bench_find_header(data, header_length, "Content-Length");
+    size_t body_length = content_length ? (size_t)strtoull(content_length, NULL, 10) : 0;
+    if (length - header_length < body_length) return BENCH_PARTIAL;
+    *consumed = header_length + body_length;
+    return BENCH_COMPLETE;
+}
+
+// ---------------------------------------------------------------------------
+// Load
+// ---------------------------------------------------------------------------
+
+static void bench_connect(bench_conn_t* conn);
+static void bench_send(bench_conn_t* conn, uint64_t intended_ns);
+static void bench_on_write(uv_write_t* req, int status);
+
+static bool bench_measuring(const bench_run_t* run, uint64_t intended_ns) {
+    return intended_ns >= run->measure_ns && intended_ns < run->end_ns;
+}
+
+// Next request for a free connection: the oldest overdue one in open loop,
+// a new one at once in closed loop
+static void bench_dispatch(bench_conn_t* conn) {
+    bench_run_t* run = conn->run;
+    if (run->stopping || !conn->open || conn->busy) return;
+    if (run->rate <= 0.0) {
+        uint64_t now = uv_hrtime();
+        if (now < run->end_ns) bench_send(conn, now);
+    } else if (run->backlog_count > 0) {
+        uint64_t intended = run->backlog[run->backlog_head];
+        run->backlog_head = (run->backlog_head + 1) % run->backlog_capacity;
+        run->backlog_count--;
+        bench_send(conn, intended);
+    }
+}
+
+static void bench_on_close(uv_handle_t* handle) {
+    bench_conn_t* conn = handle->data;
+    bench_run_t* run = conn->run;
+    conn->in_length = 0;
+    if (run->stopping) {
+        run->conns_closed++;
+        return;
+    }
+    bench_connect(conn);
+}
+
+static void bench_drop(bench_conn_t* conn, bool failed) {
+    bench_run_t* run = conn->run;
+    if (failed && conn->busy && bench_measuring(run, conn->intended_ns)) run->result->errors++;
+    if (failed && !conn->busy && !run->stopping) run->result->errors++;
+    conn->open = false;
+    conn->busy = false;
+    conn->send_queued = false;
+    if (!uv_is_closing((uv_handle_t*)&conn->tcp)) uv_close((uv_handle_t*)&conn->tcp, bench_on_close);
+}
+
+static void bench_on_alloc(uv_handle_t* handle, size_t suggested, uv_buf_t* buf) {
+    (void)suggested;
+    bench_conn_t* conn = handle->data;
+    if (conn->in_capacity - conn->in_length < BENCH_READ_CHUNK) {
+        size_t capacity = conn->in_capacity ? conn->in_capacity * 2 : 2 * BENCH_READ_CHUNK;
+        char* grown = realloc(conn->in, capacity);
+        if (!grown) {
+            *buf = uv_buf_init(NULL, 0);
+            return;
+        }
+        conn->in = grown;
+        conn->in_capacity = capacity;
+    }
+    *buf = uv_buf_init(conn->in + conn->in_length, (unsigned int)(conn->in_capacity - conn->in_length));
+}
+
+static void bench_on_read(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
+    (void)buf;
+    bench_conn_t* conn = stream->data;
+    bench_run_t* run = conn->run;
+    if (nread < 0) {
+        bench_drop(conn, conn->busy || nread != UV_EOF);
+        return;
+    }
+    conn->in_length += (size_t)nread;
+    if (!conn->busy) {
+        if (conn->in_length > 0) bench_drop(conn, true);  // Bytes nobody asked for
+        return;
+    }
+
+    size_t consumed = 0;
+    int status = 0;
+    bool closes = false;
+    bench_parse_t parsed = bench_parse_response(conn->in, conn->in_length, &consumed, &status, &closes);
+    if (parsed == BENCH_PARTIAL) return;
+    if (parsed == BENCH_MALFORMED) {
+        bench_drop(conn, true);
+        return;
+    }
+
+    uint64_t now = uv_hrtime();
+    if (bench_measuring(run, conn->intended_ns)) {
+        bench_result_t* result = run->result;
+        result->completed++;
+        if (status < 200 || status > 299) result->non_2xx++;
+        catzilla_histogram_record(&result->latency, now - conn->intended_ns);
+        catzilla_histogram_record(&result->service, now - conn->sent_ns);
+    }
+    memmove(conn->in, conn->in + consumed, conn->in_length - consumed);
+    conn->in_length -= consumed;
+    conn->busy = false;
+
+    if (closes) {
+        bench_drop(conn, false);
+        return;
+    }
+    bench_dispatch(conn);
+}
+
+static void bench_write(bench_conn_t* conn) {
+    const bench_endpoint_t* endpoint = conn->run->endpoint;
+    size_t variant = conn->next_variant++ % endpoint->count;
+    conn->sent_ns = uv_hrtime();
+    conn->writing = true;
+    uv_buf_t buf = uv_buf_init(endpoint->requests[variant], (unsigned int)endpoint->lengths[variant]);
+    conn->write.data = conn;
+    if (uv_write(&conn->write, (uv_stream_t*)&conn->tcp, &buf, 1, bench_on_write) != 0) {
+        conn->writing = false;
+        bench_drop(conn, true);
+    }
+}
+
+static void bench_on_write(uv_write_t* req, int status) {
+    bench_conn_t* conn = req->data;
+    conn->writing = false;
+    if (uv_is_closing((uv_handle_t*)&conn->tcp)) return;
+    if (status < 0) {
+        bench_drop(conn, true);
+    } else if (conn->send_queued) {
+        conn->send_queued = false;
+        bench_write(conn);
+    }
+}
+
+static void bench_send(bench_conn_t* conn, uint64_t intended_ns) {
+    conn->busy = true;
+    conn->intended_ns = intended_ns;
+    if (conn->writing) {
+        // uv_write_t is reused; the request goes out once the last write completed
+        conn->send_queued = true;
+        conn->sent_ns = uv_hrtime();
+        return;
+    }
+    bench_write(conn);
+}
+
+static void bench_on_connect(uv_connect_t* req, int status) {
+    bench_conn_t* conn = req->data;
+    if (status < 0) {
+        // Back off a little before trying again: the server may be gone
+        bench_drop(conn, true);
+        uv_sleep(1);
+        return;
+    }
+    uv_tcp_nodelay(&conn->tcp, 1);
+    conn->open = true;
+    uv_read_start((uv_stream_t*)&conn->tcp, bench_on_alloc, bench_on_read);
+    bench_dispatch(conn);
+}
+
+static void bench_connect(bench_conn_t* conn) {
+    bench_run_t* run = conn->run;
+    uv_tcp_init(&run->loop, &conn->tcp);
+    conn->tcp.data = conn;
+    conn->connect.data = conn;
+    if (uv_tcp_connect(&conn->connect, &conn->tcp, (const struct sockaddr*)&run->address, bench_on_connect) != 0) {
+        conn->open = false;
+        uv_close((uv_handle_t*)&conn->tcp, bench_on_close);
+    }
+}
+
+// Requests still waiting when the window closes have taken at least this long
+static void bench_record_unfinished(bench_run_t* run, uint64_t intended_ns, uint64_t now) {
+    if (!bench_measuring(run, intended_ns)) return;
+    run->result->unfinished++;
+    catzilla_histogram_record(&run->result->latency, now - intended_ns);
+}
+
+static void bench_stop(bench_run_t* run) {
+    uint64_t now = uv_hrtime();
+    for (size_t i = 0; i < run->backlog_count; i++) {
+        bench_record_unfinished(run, run->backlog[(run->backlog_head + i) % run->backlog_capacity], now);
+    }
+    for (int i = 0; i < run->conn_count; i++) {
+        if (run->conns[i].busy) bench_record_unfinished(run, run->conns[i].intended_ns, now);
+    }
+    run->backlog_count = 0;
+    run->stopping = true;
+    uv_timer_stop(&run->tick);
+    uv_close((uv_handle_t*)&run->tick, NULL);
+    for (int i = 0; i < run->conn_count; i++) {
+        bench_conn_t* conn = &run->conns[i];
+        if (!uv_is_closing((uv_handle_t*)&conn->tcp)) {
+            uv_close((uv_handle_t*)&conn->tcp, bench_on_close);
+        }
+    }
+}
+
+// Open loop: queue every request that fell due since the last tick
+static void bench_on_tick(uv_timer_t* timer) {
+    bench_run_t* run = timer->data;
+    uint64_t now = uv_hrtime();
+    if (now >= run->end_ns) {
+        bench_stop(run);
+        return;
+    }
+    if (run->rate <= 0.0) return;
+
+    uint64_t due = (uint64_t)((double)(now - run->start_ns) * run->rate / 1e9);
+    while (run->scheduled < due) {
+        uint64_t intended = run->start_ns + (uint64_t)((double)run->scheduled * 1e9 / run->rate);
+        run->scheduled++;
+        if (run->backlog_count == run->backlog_capacity) {
+            // A server this far behind has failed the run anyway; count what cannot be queued
+            if (bench_measuring(run, intended)) run->result->errors++;
+            continue;
+        }
+        run->backlog[(run->backlog_head + run->backlog_count) % run->backlog_capacity] = intended;
+        run->backlog_count++;
+    }
+    if (run->backlog_count > run->result->backlog_max) run->result->backlog_max = run->backlog_count;
+    for (int i = 0; i < run->conn_count && run->backlog_count > 0; i++) {
+        bench_dispatch(&run->conns[i]);
+    }
+}
+
+// Closed loop: add the samples a connection would have taken while it was
+// stuck on a slow response, one per expected interval
+static void bench_backfill(catzilla_histogram_t* latency, const catzilla_histogram_t* raw, uint64_t interval_ns) {
+    memset(latency, 0, sizeof(*latency));
+    catzilla_histogram_merge(latency, raw);
+    if (interval_ns == 0) return;
+    for (size_t i = 0; i < CATZILLA_HISTOGRAM_BUCKETS; i++) {
+        uint64_t count = raw->buckets[i];
+        if (count == 0) continue;
+        uint64_t value_ns = catzilla_histogram_bucket_upper(i) * 1000;
+        for (uint64_t missing = value_ns > interval_ns ? value_ns - interval_ns : 0;
+             missing >= interval_ns; missing -= interval_ns) {
+            latency->buckets[catzilla_histogram_bucket_index(missing / 1000)] += count;
+            latency->count += count;
+            latency->sum_ns += missing * count;
+        }
+    }
+}
+
+static int bench_run_endpoint(const bench_endpoint_t* endpoint, const struct sockaddr_storage* address,
+                              int connections, double duration_s, double warmup_s, double rate,
+                              bench_result_t* result) {
+    memset(result, 0, sizeof(*result));
+    bench_run_t run;
+    memset(&run, 0, sizeof(run));
+    run.endpoint = endpoint;
+    run.address = *address;
+    run.rate = rate;
+    run.result = result;
+    run.conn_count = connections;
+    run.conns = calloc((size_t)connections, sizeof(bench_conn_t));
+    run.backlog_capacity = rate > 0.0 ? (size_t)(rate * 2.0) + 1024 : 1;
+    run.backlog = malloc(run.backlog_capacity * sizeof(uint64_t));
+    if (!run.conns || !run.backlog || uv_loop_init(&run.loop) != 0) {
+        free(run.conns);
+        free(run.backlog);
+        return -1;
+    }
+
+    run.start_ns = uv_hrtime();
+    run.measure_ns = run.start_ns + (uint64_t)(warmup_s * 1e9);
+    run.end_ns = run.measure_ns + (uint64_t)(duration_s * 1e9);
+    uv_timer_init(&run.loop, &run.tick);
+    run.tick.data = &run;
+    uv_timer_start(&run.tick, bench_on_tick, BENCH_TICK_MS, BENCH_TICK_MS);
+    for (int i = 0; i < connections; i++) {
+        run.conns[i].run = &run;
+        bench_connect(&run.conns[i]);
+    }
+    uv_run(&run.loop, UV_RUN_DEFAULT);
+    uv_loop_close(&run.loop);
+
+    result->seconds = duration_s;
+    result->requests_per_sec = duration_s > 0 ? (double)result->completed / duration_s : 0.0;
+    if (rate <= 0.0 && result->completed > 0) {
+        // Each connection is expected to turn a request around in the mean service time
+        catzilla_histogram_t raw = result->latency;
+        bench_backfill(&result->latency, &raw, raw.sum_ns / raw.count);
+    }
+
+    for (int i = 0; i < connections; i++) free(run.conns[i].in);
+    free(run.conns);
+    free(run.backlog);
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// Report and gate
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    double p50_us;
+    double p99_us;
+    double requests_per_sec;
+} bench_summary_t;
+
+static double bench_us(const catzilla_histogram_t* histogram, double percentile) {
+    return (double)catzilla_histogram_percentile(histogram, percentile) / 1000.0;
+}
+
+static void bench_print_latency(FILE* out, const char* name, const catzilla_histogram_t* histogram) {
+    fprintf(out, "\"%s\": {\"p50\": %.1f, \"p90\": %.1f, \"p99\": %.1f, \"p999\": %.1f, "
+                 "\"max\": %.1f, \"mean\": %.1f}",
+            name, bench_us(histogram, 50.0), bench_us(histogram, 90.0), bench_us(histogram, 99.0),
+            bench_us(histogram, 99.9), (double)histogram->max_ns / 1000.0,
+            histogram->count ? (double)histogram->sum_ns / (double)histogram->count / 1000.0 : 0.0);
+}
+
+static void bench_print_result(FILE* out, bool first, const bench_endpoint_t* endpoint,
+                               const bench_result_t* result) {
+    fprintf(out, "%s    {\"name\": \"%s\", \"method\": \"%s\", \"path\": \"%s\"",
+            first ? "" : ",\n", endpoint->name, endpoint->method, endpoint->path);
+    if (endpoint->skipped) {
+        fprintf(out, ", \"skipped\": \"%s\"}", endpoint->skipped);
+        return;
+    }
+    fprintf(out, ", \"requests\": %" PRIu64 ", \"errors\": %" PRIu64 ", \"non_2xx\": %" PRIu64
+                 ", \"unfinished\": %" PRIu64 ", \"requests_per_sec\": %.1f, \"backlog_max\": %" PRIu64 ", ",
+            result->completed, result->errors, result->non_2xx, result->unfinished,
+            result->requests_per_sec, result->backlog_max);
+    bench_print_latency(out, "latency_us", &result->latency);
+    fprintf(out, ", ");
+    bench_print_latency(out, "service_us", &result->service);
+    fprintf(out, "}");
+}
+
+static bool bench_baseline_summary(yyjson_val* results, const char* name, bench_summary_t* summary) {
+    size_t idx, max;
+    yyjson_val* item;
+    yyjson_arr_foreach(results, idx, max, item) {
+        const char* item_name = yyjson_get_str(yyjson_obj_get(item, "name"));
+        yyjson_val* latency = yyjson_obj_get(item, "latency_us");
+        if (!item_name || strcmp(item_name, name) != 0 || !latency) continue;
+        summary->p50_us = yyjson_get_num(yyjson_obj_get(latency, "p50"));
+        summary->p99_us = yyjson_get_num(yyjson_obj_get(latency, "p99"));
+        summary->requests_per_sec = yyjson_get_num(yyjson_obj_get(item, "requests_per_sec"));
+        return true;
+    }
+    return false;
+}
+
+static bool bench_check(FILE* out, bool* first, const char* name, const char* metric,
+                        double baseline, double current, bool lower_is_better, double threshold_pct) {
+    if (baseline <= 0.0) return true;
+    double change_pct = (current - baseline) / baseline * 100.0;
+    double worse_pct = lower_is_better ? change_pct : -change_pct;
+    bool passed = worse_pct <= threshold_pct;
+    fprintf(stderr, "%-32s %-16s %12.1f -> %12.1f  %+7.1f%%  %s\n", name, metric, baseline, current,
+            change_pct, passed ? "ok" : "REGRESSION");
+    if (!passed) {
+        fprintf(out, "%s\n      {\"name\": \"%s\", \"metric\": \"%s\", \"baseline\": %.1f, \"current\": %.1f, "
+                     "\"change_pct\": %.1f, \"threshold_pct\": %.1f}",
+                *first ? "" : ",", name, metric, baseline, current, change_pct, threshold_pct);
+        *first = false;
+    }
+    return passed;
+}
+
+// Compare against a baseline run; prints the gate object, returns false on a regression
+static bool bench_gate(FILE* out, const char* baseline_file, const bench_endpoint_t* endpoints,
+                       const bench_result_t* results, size_t count, const double thresholds[3]) {
+    FILE* in = fopen(baseline_file, "rb");
+    yyjson_doc* doc = NULL;
+    if (in) {
+        fseek(in, 0, SEEK_END);
+        long size = ftell(in);
+        fseek(in, 0, SEEK_SET);
+        char* data = size > 0 ? malloc((size_t)size) : NULL;
+        size_t got = data ? fread(data, 1, (size_t)size, in) : 0;
+        fclose(in);
+        doc = data ? yyjson_read(data, got, YYJSON_READ_NOFLAG) : NULL;
+        free(data);
+    }
+    yyjson_val* baseline = yyjson_obj_get(yyjson_doc_get_root(doc), "results");
+    if (!yyjson_is_arr(baseline)) {
+        fprintf(stderr, "cannot read baseline %s\n", baseline_file);
+        fprintf(out, ",\n  \"gate\": {\"baseline\": \"%s\", \"passed\": false, \"error\": \"unreadable baseline\"}",
+                baseline_file);
+        yyjson_doc_free(doc);
+        return false;
+    }
+
+    fprintf(out, ",\n  \"gate\": {\"baseline\": \"%s\", \"max_p50_regression_pct\": %.1f, "
+                 "\"max_p99_regression_pct\": %.1f, \"max_throughput_regression_pct\": %.1f,\n"
+                 "    \"regressions\": [",
+            baseline_file, thresholds[0], thresholds[1], thresholds[2]);
+    bool passed = true;
+    bool first = true;
+    for (size_t i = 0; i < count; i++) {
+        bench_summary_t before;
+        if (endpoints[i].skipped || !bench_baseline_summary(baseline, endpoints[i].name, &before)) continue;
+        const bench_result_t* result = &results[i];
+        passed &= bench_check(out, &first, endpoints[i].name, "p50_us", before.p50_us,
+                              bench_us(&result->latency, 50.0), true, thresholds[0]);
+        passed &= bench_check(out, &first, endpoints[i].name, "p99_us", before.p99_us,
+                              bench_us(&result->latency, 99.0), true, thresholds[1]);
+        passed &= bench_check(out, &first, endpoints[i].name, "requests_per_sec", before.requests_per_sec,
+                              result->requests_per_sec, false, thresholds[2]);
+    }
+    fprintf(out, "%s],\n    \"passed\": %s}", first ? "" : "\n    ", passed ? "true" : "false");
+    yyjson_doc_free(doc);
+    return passed;
+}
+
+// ---------------------------------------------------------------------------
+// Main
+// ---------------------------------------------------------------------------
+
+// http://host[:port][/path]
+static int bench_parse_url(const char* url, char* host, size_t host_size, int* port, char* path, size_t path_size) {
+    if (strncmp(url, "http://", 7) != 0) return -1;
+    const char* start = url + 7;
+    const char* slash = strchr(start, '/');
+    const char* authority_end = slash ? slash : start + strlen(start);
+    const char* colon = memchr(start, ':', (size_t)(authority_end - start));
+    const char* host_end = colon ? colon : authority_end;
+    if (host_end == start || (size_t)(host_end - start) >= host_size) return -1;
+    snprintf(host, host_size, "%.*s", (int)(host_end - start), start);
+    *port = colon ? atoi(colon + 1) : 80;
+    snprintf(path, path_size, "%s", slash ? slash : "/");
+    return 0;
+}
+
+static void bench_usage(const char* program) {
+    fprintf(stderr,
+            "usage: %s (--url http://HOST:PORT/PATH | --endpoints FILE [--host H] [--port P])\n"
+            "          [--connections N] [--duration S] [--warmup S] [--rate R] [--endpoint NAME]\n"
+            "          [--output FILE] [--baseline FILE] [--max-p50-regression PCT]\n"
+            "          [--max-p99-regression PCT] [--max-throughput-regression PCT]\n",
+            program);
+}
+
+int main(int argc, char** argv) {
+    const char* url = NULL;
+    const char* endpoints_file = NULL;
+    const char* only = NULL;
+    const char* output = NULL;
+    const char* baseline = NULL;
+    char host[256] = "127.0.0.1";
+    int port = 8000;
+    int connections = 64;
+    double duration_s = 10.0;
+    double warmup_s = 2.0;
+    double rate = 0.0;
+    double thresholds[3] = { 10.0, 15.0, 5.0 };  // p50, p99, throughput (percent)
+
+    for (int i = 1; i < argc; i++) {
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!value) {
+            bench_usage(argv[0]);
+            return 2;
+        }
+        if (strcmp(argv[i], "--url") == 0) {
+            url = value;
+        } else if (strcmp(argv[i], "--endpoints") == 0) {
+            endpoints_file = value;
+        } else if (strcmp(argv[i], "--host") == 0) {
+            snprintf(host, sizeof(host), "%s", value);
+        } else if (strcmp(argv[i], "--port") == 0) {
+            port = atoi(value);
+        } else if (strcmp(argv[i], "--connections") == 0) {
+            connections = atoi(value);
+        } else if (strcmp(argv[i], "--duration") == 0) {
+            duration_s = atof(value);
+        } else if (strcmp(argv[i], "--warmup") == 0) {
+            warmup_s = atof(value);
+        } else if (strcmp(argv[i], "--rate") == 0) {
+            rate = atof(value);
+        } else if (strcmp(argv[i], "--endpoint") == 0) {
+            only = value;
+        } else if (strcmp(argv[i], "--output") == 0) {
+            output = value;
+        } else if (strcmp(argv[i], "--baseline") == 0) {
+            baseline = value;
+        } else if (strcmp(argv[i], "--max-p50-regression") == 0) {
+            thresholds[0] = atof(value);
+        } else if (strcmp(argv[i], "--max-p99-regression") == 0) {
+            thresholds[1] = atof(value);
+        } else if (strcmp(argv[i], "--max-throughput-regression") == 0) {
+            thresholds[2] = atof(value);
+        } else {
+            bench_usage(argv[0]);
+            return 2;
+        }
+        i++;
+    }
+
+    static bench_endpoint_t endpoints[BENCH_MAX_ENDPOINTS];
+    size_t count = 0;
+    char url_path[256] = "/";
+    if (url && bench_parse_url(url, host, sizeof(host), &port, url_path, sizeof(url_path)) != 0) {
+        fprintf(stderr, "cannot parse %s\n", url);
+        return 2;
+    }
+    if ((!url == !endpoints_file) || connections < 1 || duration_s <= 0.0 || warmup_s < 0.0 || rate < 0.0) {
+        bench_usage(argv[0]);
+        return 2;
+    }
+
+    char host_header[300];
+    snprintf(host_header, sizeof(host_header), "%s:%d", host, port);
+    if (endpoints_file) {
+        if (bench_load_endpoints(endpoints_file, host_header, only, endpoints, &count) != 0) return 2;
+    } else {
+        bench_endpoint_t* endpoint = &endpoints[0];
+        memset(endpoint, 0, sizeof(*endpoint));
+        snprintf(endpoint->name, sizeof(endpoint->name), "GET %s", url_path);
+        snprintf(endpoint->method, sizeof(endpoint->method), "GET");
+        snprintf(endpoint->path, sizeof(endpoint->path), "%s", url_path);
+        char request[1024];
+        int length = snprintf(request, sizeof(request), "GET %s HTTP/1.1\r\nHost: %s\r\n\r\n", url_path, host_header);
+        endpoint->requests[0] = strdup(request);
+        endpoint->lengths[0] = (size_t)length;
+        endpoint->count = endpoint->requests[0] ? 1 : 0;
+        count = 1;
+    }
+
+    struct sockaddr_storage address;
+    if (uv_ip4_addr(host, port, (struct sockaddr_in*)&address) != 0 &&
+        uv_ip6_addr(host, port, (struct sockaddr_in6*)&address) != 0) {
+        fprintf(stderr, "%s is not an IP address\n", host);
+        bench_free_endpoints(endpoints, count);
+        return 2;
+    }
+
+    FILE* out = stdout;
+    if (output && !(out = fopen(output, "w"))) {
+        fprintf(stderr, "cannot open %s: %s\n", output, strerror(errno));
+        bench_free_endpoints(endpoints, count);
+        return 1;
+    }
+
+    static bench_result_t results[BENCH_MAX_ENDPOINTS];
+    int status = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (endpoints[i].skipped || endpoints[i].count == 0) continue;
+        fprintf(stderr, "%s: %s %s\n", endpoints[i].name, endpoints[i].method, endpoints[i].path);
+        if (bench_run_endpoint(&endpoints[i], &address, connections, duration_s, warmup_s, rate, &results[i]) != 0) {
+            fprintf(stderr, "out of memory\n");
+            status = 3;
+            break;
+        }
+    }
+
+    fprintf(out, "{\n  \"benchmark\": \"http_load\",\n  \"mode\": \"%s\",\n  \"rate\": %.1f,\n"
+                 "  \"connections\": %d,\n  \"duration_s\": %.1f,\n  \"warmup_s\": %.1f,\n"
+                 "  \"target\": \"%s\",\n  \"results\": [\n",
+            rate > 0.0 ? "open" : "closed", rate, connections, duration_s, warmup_s, host_header);
+    for (size_t i = 0; i < count; i++) {
+        bench_print_result(out, i == 0, &endpoints[i], &results[i]);
+    }
+    fprintf(out, "\n  ]");
+    if (status == 0 && baseline && !bench_gate(out, baseline, endpoints, results, count, thresholds)) {
+        status = 1;
+    }
+    fprintf(out, "\n}\n");
+
+    if (out != stdout) fclose(out);
+    bench_free_endpoints(endpoints, count);
+    return status;
+}
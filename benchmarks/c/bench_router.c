@@ -0,0 +1,443 @@
+// benchmarks/c/bench_router.c
+//
+// Native microbenchmark of catzilla_router_match. Builds synthetic route
+// sets of a given size, the way real applications shape them, and reports
+// per-lookup time, hardware counters (Linux perf events, when the kernel
+// allows them) and router memory per route as JSON.
+//
+//   catzilla_bench_router [--routes 100,1000,10000] [--lookups N]
+//                         [--repeat N] [--seed N] [--output FILE]
+
+#include "router.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#define BENCH_MAX_SIZES 8
+#define BENCH_PATH_MAX 256
+
+static const char* const bench_methods[] = { "GET", "GET", "GET", "POST", "PUT", "DELETE" };
+static const char* const bench_resources[] = {
+    "users", "orders", "products", "invoices", "teams", "projects", "files", "events",
+    "sessions", "payments", "reports", "tags", "comments", "accounts", "devices", "jobs",
+};
+#define BENCH_RESOURCE_COUNT (sizeof(bench_resources) / sizeof(bench_resources[0]))
+
+typedef struct {
+    char method[CATZILLA_METHOD_MAX];
+    char path[BENCH_PATH_MAX];
+} bench_request_t;
+
+typedef struct {
+    bench_request_t* items;
+    size_t count;
+} bench_workload_t;
+
+typedef struct {
+    const char* name;
+    bench_workload_t workload;
+} bench_scenario_t;
+
+// xorshift64*, so every run with the same seed sees the same routes
+static uint64_t bench_state;
+
+static uint64_t bench_random(void) {
+    bench_state ^= bench_state >> 12;
+    bench_state ^= bench_state << 25;
+    bench_state ^= bench_state >> 27;
+    return bench_state * 2685821657736338717ULL;
+}
+
+static uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// ---------------------------------------------------------------------------
+// Hardware counters
+// ---------------------------------------------------------------------------
+
+enum { BENCH_CYCLES, BENCH_INSTRUCTIONS, BENCH_CACHE_REFERENCES, BENCH_CACHE_MISSES, BENCH_COUNTERS };
+
+static const char* const bench_counter_names[BENCH_COUNTERS] = {
+    "cycles", "instructions", "cache_references", "cache_misses",
+};
+
+typedef struct {
+    int fds[BENCH_COUNTERS];          // -1 = not available
+    uint64_t values[BENCH_COUNTERS];
+} bench_counters_t;
+
+static void bench_counters_open(bench_counters_t* counters) {
+    for (int i = 0; i < BENCH_COUNTERS; i++) counters->fds[i] = -1;
+#ifdef __linux__
+    static const uint64_t configs[BENCH_COUNTERS] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_REFERENCES, PERF_COUNT_HW_CACHE_MISSES,
+    };
+    for (int i = 0; i < BENCH_COUNTERS; i++) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = configs[i];
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        counters->fds[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+#endif
+}
+
+static void bench_counters_close(bench_counters_t* counters) {
+#ifdef __linux__
+    for (int i = 0; i < BENCH_COUNTERS; i++) {
+        if (counters->fds[i] >= 0) close(counters->fds[i]);
+    }
+#endif
+    (void)counters;
+}
+
+static void bench_counters_start(bench_counters_t* counters) {
+#ifdef __linux__
+    for (int i = 0; i < BENCH_COUNTERS; i++) {
+        if (counters->fds[i] < 0) continue;
+        ioctl(counters->fds[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl(counters->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+    (void)counters;
+}
+
+static void bench_counters_stop(bench_counters_t* counters) {
+    for (int i = 0; i < BENCH_COUNTERS; i++) {
+        counters->values[i] = 0;
+#ifdef __linux__
+        if (counters->fds[i] < 0) continue;
+        ioctl(counters->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+        uint64_t value = 0;
+        if (read(counters->fds[i], &value, sizeof(value)) == (ssize_t)sizeof(value)) {
+            counters->values[i] = value;
+        }
+#endif
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Route sets
+// ---------------------------------------------------------------------------
+
+// Append one route and a request that should reach it
+static int bench_add_route(catzilla_router_t* router, bench_workload_t* hits,
+                           const char* method, const char* pattern, const char* request) {
+    if (catzilla_router_add_route(router, method, pattern, (void*)0x1, NULL, false) == 0) {
+        // Refused (e.g. a conflict); keep it out of the workload
+        return 0;
+    }
+    bench_request_t* item = &hits->items[hits->count++];
+    snprintf(item->method, sizeof(item->method), "%s", method);
+    snprintf(item->path, sizeof(item->path), "%s", request);
+    return 1;
+}
+
+/*
+ * Build about `count` routes: 60% static, 40% parameterised. Half of them sit
+ * in wide trees (many services with a few shallow resources), the rest in
+ * deep ones (nested resources up to six segments), like REST APIs.
+ */
+static void bench_build_routes(catzilla_router_t* router, size_t count,
+                               bench_workload_t* statics, bench_workload_t* params) {
+    size_t services = count / 20 + 1;
+    for (size_t i = 0; router->route_count < (int)count && i < count * 4; i++) {
+        uint64_t r = bench_random();
+        const char* method = bench_methods[r % 6];
+        const char* resource = bench_resources[(r >> 8) % BENCH_RESOURCE_COUNT];
+        const char* child = bench_resources[(r >> 16) % BENCH_RESOURCE_COUNT];
+        unsigned service = (unsigned)((r >> 24) % services);
+        unsigned version = (unsigned)((r >> 40) % 3) + 1;
+        unsigned id = (unsigned)((r >> 44) % 100000);
+        bool deep = ((r >> 4) & 1) != 0;
+        bool parameterised = (r >> 32) % 10 < 4;
+
+        char pattern[BENCH_PATH_MAX];
+        char request[BENCH_PATH_MAX];
+        if (!deep && !parameterised) {
+            snprintf(pattern, sizeof(pattern), "/svc%u/%s/%u", service, resource, (unsigned)i);
+            snprintf(request, sizeof(request), "%s", pattern);
+        } else if (!deep) {
+            snprintf(pattern, sizeof(pattern), "/svc%u/%s/{id:int}/%s%u", service, resource, child, (unsigned)i);
+            snprintf(request, sizeof(request), "/svc%u/%s/%u/%s%u", service, resource, id, child, (unsigned)i);
+        } else if (!parameterised) {
+            snprintf(pattern, sizeof(pattern), "/api/v%u/%s/%s/settings/%s/%u",
+                     version, resource, child, resource, (unsigned)i);
+            snprintf(request, sizeof(request), "%s", pattern);
+        } else {
+            snprintf(pattern, sizeof(pattern), "/api/v%u/%s/{org}/%s/{item}/history/%u",
+                     version, resource, child, (unsigned)i);
+            snprintf(request, sizeof(request), "/api/v%u/%s/org%u/%s/item-%u/history/%u",
+                     version, resource, id % 97, child, id, (unsigned)i);
+        }
+        bench_add_route(router, parameterised ? params : statics, method, pattern, request);
+    }
+}
+
+// Requests that look real but match nothing: unknown leaves of known prefixes
+static void bench_build_misses(bench_workload_t* misses, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        uint64_t r = bench_random();
+        bench_request_t* item = &misses->items[misses->count++];
+        snprintf(item->method, sizeof(item->method), "GET");
+        if (r & 1) {
+            snprintf(item->path, sizeof(item->path), "/api/v%u/%s/unknown/%u",
+                     (unsigned)((r >> 8) % 3) + 1, bench_resources[(r >> 16) % BENCH_RESOURCE_COUNT],
+                     (unsigned)(r >> 32));
+        } else {
+            snprintf(item->path, sizeof(item->path), "/svc%u/missing-%u",
+                     (unsigned)((r >> 8) % 50), (unsigned)(r >> 32));
+        }
+    }
+}
+
+static int bench_workload_alloc(bench_workload_t* workload, size_t capacity) {
+    workload->items = calloc(capacity ? capacity : 1, sizeof(bench_request_t));
+    workload->count = 0;
+    return workload->items ? 0 : -1;
+}
+
+static void bench_workload_shuffle(bench_workload_t* workload) {
+    for (size_t i = workload->count; i > 1; i--) {
+        size_t j = (size_t)(bench_random() % i);
+        bench_request_t tmp = workload->items[i - 1];
+        workload->items[i - 1] = workload->items[j];
+        workload->items[j] = tmp;
+    }
+}
+
+// A shuffled blend of hits and misses: 45% static, 45% parameterised, 10% 404
+static int bench_build_mixed(bench_workload_t* mixed, const bench_workload_t* statics,
+                             const bench_workload_t* params, const bench_workload_t* misses) {
+    size_t total = statics->count + params->count;
+    if (bench_workload_alloc(mixed, total + total / 9 + 1) != 0) return -1;
+    for (size_t i = 0; i < total; i++) {
+        const bench_workload_t* source = (i & 1) ? params : statics;
+        if (source->count == 0) source = (source == params) ? statics : params;
+        mixed->items[mixed->count++] = source->items[i % source->count];
+    }
+    for (size_t i = 0; i < total / 9 && misses->count > 0; i++) {
+        mixed->items[mixed->count++] = misses->items[i % misses->count];
+    }
+    bench_workload_shuffle(mixed);
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// Measurement
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    double ns_per_lookup;
+    double counters_per_lookup[BENCH_COUNTERS];
+    bool has_counter[BENCH_COUNTERS];
+    size_t matched;
+} bench_result_t;
+
+static volatile uintptr_t bench_sink;
+
+static void bench_run(catzilla_router_t* router, const bench_workload_t* workload, size_t lookups,
+                      int repeat, bench_counters_t* counters, bench_result_t* result) {
+    memset(result, 0, sizeof(*result));
+    if (workload->count == 0 || lookups == 0) return;
+
+    // Warm up caches and branch predictors once over the whole working set
+    catzilla_route_match_t match;
+    for (size_t i = 0; i < workload->count; i++) {
+        catzilla_router_match(router, workload->items[i].method, workload->items[i].path, &match);
+    }
+
+    // Report the fastest of the repeats; slower ones measure the machine
+    double best = -1.0;
+    for (int run = 0; run < repeat; run++) {
+        size_t matched = 0;
+        bench_counters_start(counters);
+        uint64_t start = bench_now_ns();
+        for (size_t i = 0; i < lookups; i++) {
+            const bench_request_t* item = &workload->items[i % workload->count];
+            if (catzilla_router_match(router, item->method, item->path, &match) == 0) {
+                matched++;
+                bench_sink = (uintptr_t)match.route;
+            }
+        }
+        uint64_t elapsed = bench_now_ns() - start;
+        bench_counters_stop(counters);
+
+        double ns = (double)elapsed / (double)lookups;
+        if (best < 0 || ns < best) {
+            best = ns;
+            result->matched = matched;
+            for (int c = 0; c < BENCH_COUNTERS; c++) {
+                result->has_counter[c] = counters->fds[c] >= 0;
+                result->counters_per_lookup[c] = (double)counters->values[c] / (double)lookups;
+            }
+        }
+    }
+    result->ns_per_lookup = best;
+}
+
+static void bench_print_result(FILE* out, bool first, size_t route_count, const char* scenario, bool shared,
+                               size_t lookups, size_t working_set, size_t memory, const bench_result_t* result) {
+    fprintf(out, "%s    {\"routes\": %zu, \"scenario\": \"%s\", \"shared\": %s, \"lookups\": %zu, "
+                 "\"working_set\": %zu, \"matched\": %zu, \"ns_per_lookup\": %.2f",
+            first ? "" : ",\n", route_count, scenario, shared ? "true" : "false", lookups,
+            working_set, result->matched, result->ns_per_lookup);
+    for (int c = 0; c < BENCH_COUNTERS; c++) {
+        if (result->has_counter[c]) {
+            fprintf(out, ", \"%s_per_lookup\": %.3f", bench_counter_names[c], result->counters_per_lookup[c]);
+        } else {
+            fprintf(out, ", \"%s_per_lookup\": null", bench_counter_names[c]);
+        }
+    }
+    fprintf(out, ", \"memory_bytes\": %zu, \"bytes_per_route\": %.1f}",
+            memory, route_count ? (double)memory / (double)route_count : 0.0);
+}
+
+static int bench_parse_sizes(const char* text, size_t* sizes, int* count) {
+    *count = 0;
+    char* copy = strdup(text);
+    if (!copy) return -1;
+    for (char* token = strtok(copy, ","); token; token = strtok(NULL, ",")) {
+        char* end = NULL;
+        unsigned long long value = strtoull(token, &end, 10);
+        if (*count == BENCH_MAX_SIZES || !end || *end != '\0' || value == 0) {
+            free(copy);
+            return -1;
+        }
+        sizes[(*count)++] = (size_t)value;
+    }
+    free(copy);
+    return *count > 0 ? 0 : -1;
+}
+
+static void bench_usage(const char* program) {
+    fprintf(stderr,
+            "usage: %s [--routes 100,1000,10000] [--lookups N] [--repeat N] [--seed N] [--output FILE]\n",
+            program);
+}
+
+int main(int argc, char** argv) {
+    size_t sizes[BENCH_MAX_SIZES] = { 100, 1000, 10000 };
+    int size_count = 3;
+    size_t lookups = 2000000;
+    int repeat = 5;
+    uint64_t seed = 0x5eed;
+    const char* output = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(argv[i], "--routes") == 0 && value) {
+            if (bench_parse_sizes(value, sizes, &size_count) != 0) {
+                bench_usage(argv[0]);
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--lookups") == 0 && value) {
+            lookups = (size_t)strtoull(value, NULL, 10);
+        } else if (strcmp(argv[i], "--repeat") == 0 && value) {
+            repeat = atoi(value);
+        } else if (strcmp(argv[i], "--seed") == 0 && value) {
+            seed = strtoull(value, NULL, 0);
+        } else if (strcmp(argv[i], "--output") == 0 && value) {
+            output = value;
+        } else {
+            bench_usage(argv[0]);
+            return 2;
+        }
+        i++;
+    }
+    if (repeat < 1) repeat = 1;
+    bench_state = seed ? seed : 1;
+
+    FILE* out = stdout;
+    if (output && !(out = fopen(output, "w"))) {
+        fprintf(stderr, "cannot open %s: %s\n", output, strerror(errno));
+        return 1;
+    }
+
+    bench_counters_t counters;
+    bench_counters_open(&counters);
+    bool have_counters = false;
+    for (int c = 0; c < BENCH_COUNTERS; c++) have_counters |= counters.fds[c] >= 0;
+
+    fprintf(out, "{\n  \"benchmark\": \"router_match\",\n  \"seed\": %" PRIu64 ",\n"
+                 "  \"repeat\": %d,\n  \"perf_counters\": %s,\n  \"route_struct_bytes\": %zu,\n"
+                 "  \"match_struct_bytes\": %zu,\n  \"results\": [\n",
+            seed, repeat, have_counters ? "true" : "false",
+            sizeof(catzilla_route_t), sizeof(catzilla_route_match_t));
+
+    int status = 0;
+    bool first = true;
+    for (int s = 0; s < size_count && status == 0; s++) {
+        catzilla_router_t router;
+        bench_workload_t statics, params, misses, mixed;
+        if (catzilla_router_init(&router) != 0 ||
+            bench_workload_alloc(&statics, sizes[s]) != 0 ||
+            bench_workload_alloc(&params, sizes[s]) != 0 ||
+            bench_workload_alloc(&misses, sizes[s] / 4 + 16) != 0) {
+            fprintf(stderr, "out of memory\n");
+            status = 1;
+            break;
+        }
+
+        bench_build_routes(&router, sizes[s], &statics, &params);
+        bench_build_misses(&misses, sizes[s] / 4 + 16);
+        bench_workload_shuffle(&statics);
+        bench_workload_shuffle(&params);
+        if (bench_build_mixed(&mixed, &statics, &params, &misses) != 0) {
+            fprintf(stderr, "out of memory\n");
+            status = 1;
+        }
+
+        size_t route_count = (size_t)router.route_count;
+        size_t memory = catzilla_router_memory_usage(&router);
+        bench_scenario_t scenarios[] = {
+            { "static", statics }, { "param", params }, { "miss", misses }, { "mixed", mixed },
+        };
+        for (size_t i = 0; status == 0 && i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+            bench_result_t result;
+            bench_run(&router, &scenarios[i].workload, lookups, repeat, &counters, &result);
+            bench_print_result(out, first, route_count, scenarios[i].name, false, lookups,
+                               scenarios[i].workload.count, memory, &result);
+            first = false;
+        }
+
+        // What a running server does: lookups through the snapshot epoch
+        if (status == 0) {
+            catzilla_router_share(&router);
+            bench_result_t result;
+            bench_run(&router, &mixed, lookups, repeat, &counters, &result);
+            bench_print_result(out, first, route_count, "mixed", true, lookups, mixed.count,
+                               catzilla_router_memory_usage(&router), &result);
+        }
+
+        free(statics.items);
+        free(params.items);
+        free(misses.items);
+        free(mixed.items);
+        catzilla_router_cleanup(&router);
+    }
+
+    fprintf(out, "\n  ]\n}\n");
+    bench_counters_close(&counters);
+    if (out != stdout) fclose(out);
+    return status;
+}
@@ -0,0 +1,224 @@
+// benchmarks/c/bench_urlencoded.c
+//
+// Native benchmark of query string and form decoding. Parses a corpus of
+// query strings shaped like real traffic (search, pagination, tracking
+// links, OAuth callbacks, filter arrays, a long form post) with
+// catzilla_urlencoded_parse and with the byte at a time decoder it
+// replaced, and reports time per string and throughput as JSON.
+//
+//   catzilla_bench_urlencoded [--iterations N] [--output FILE]
+
+#include "urlencoded.h"
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct {
+    const char* name;
+    char* text;
+    size_t length;
+} bench_query_t;
+
+static const char* const bench_fixed_queries[][2] = {
+    { "search", "q=catzilla+web+framework&lang=en&page=2" },
+    { "pagination", "limit=50&offset=1500&sort=-created_at&include=author,comments" },
+    { "tracking", "utm_source=newsletter&utm_medium=email&utm_campaign=spring_sale_2024"
+                  "&utm_content=hero_button&utm_term=running%20shoes&gclid=EAIaIQobChMI8_"
+                  "Puqf2q_wIVDZBoCR0mWAs2EAAYASAAEgK3-vD_BwE&fbclid=IwAR2xK9hFq" },
+    { "oauth_callback", "code=4%2F0AeaYSHB7kR9vJq2mLxA3nTzP1yWcE8uFgHdK5sQ&"
+                        "state=eyJyZXR1cm5fdG8iOiIvZGFzaGJvYXJkIiwibm9uY2UiOiJhYmMxMjMifQ%3D%3D"
+                        "&scope=email%20profile%20openid%20https%3A%2F%2Fwww.googleapis.com%2F"
+                        "auth%2Fuserinfo.email&authuser=0&prompt=consent" },
+    { "filters", "category%5B%5D=shoes&category%5B%5D=running&brand%5B%5D=acme&brand%5B%5D=zoom"
+                 "&price%5Bmin%5D=50&price%5Bmax%5D=200&size=10.5&color=blue&in_stock=true" },
+    { "redirect", "next=https%3A%2F%2Fexample.com%2Faccount%2Fsettings%3Ftab%3Dsecurity%26ref%3Dmail" },
+};
+#define BENCH_FIXED_COUNT (sizeof(bench_fixed_queries) / sizeof(bench_fixed_queries[0]))
+#define BENCH_QUERY_COUNT (BENCH_FIXED_COUNT + 1)
+
+static uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// A checkout form: a few dozen fields, mostly plain text with some escapes
+static char* bench_build_form(size_t* length) {
+    size_t size = 8192;
+    char* text = malloc(size);
+    if (!text) return NULL;
+    size_t used = 0;
+    for (int i = 0; i < 40; i++) {
+        used += (size_t)snprintf(text + used, size - used,
+                                 "%sfield_%d=Some+longer+free+text+value+number+%d%%2C+with+punctuation",
+                                 i ? "&" : "", i, i);
+    }
+    *length = used;
+    return text;
+}
+
+// ---------------------------------------------------------------------------
+// Baseline: the decoder parse_query_params used before, one byte at a time
+// and two allocations per pair
+// ---------------------------------------------------------------------------
+
+static void baseline_decode_segment(const char* src, size_t length, char* dst) {
+    const char* end = src + length;
+    while (src < end) {
+        if (*src == '%' && (src + 2) < end && isxdigit((unsigned char)src[1]) &&
+            isxdigit((unsigned char)src[2])) {
+            char a = src[1];
+            char b = src[2];
+            if (a >= 'a') a -= 'a' - 'A';
+            if (a >= 'A') a -= ('A' - 10);
+            else a -= '0';
+            if (b >= 'a') b -= 'a' - 'A';
+            if (b >= 'A') b -= ('A' - 10);
+            else b -= '0';
+            *dst++ = (char)(16 * a + b);
+            src += 3;
+            continue;
+        }
+        *dst++ = *src == '+' ? ' ' : *src;
+        src++;
+    }
+    *dst = '\0';
+}
+
+static int baseline_parse(catzilla_request_arena_t* arena, const char* cursor, char** names,
+                          char** values, int max_pairs) {
+    int count = 0;
+    while (*cursor && count < max_pairs) {
+        const char* key_start = cursor;
+        while (*cursor && *cursor != '&' && *cursor != '=') cursor++;
+        const char* key_end = cursor;
+        const char* value_start = NULL;
+        if (*cursor == '=') {
+            value_start = ++cursor;
+            while (*cursor && *cursor != '&') cursor++;
+        }
+        if (value_start) {
+            size_t key_length = (size_t)(key_end - key_start);
+            size_t value_length = (size_t)(cursor - value_start);
+            names[count] = catzilla_arena_alloc(arena, key_length + 1);
+            values[count] = catzilla_arena_alloc(arena, value_length + 1);
+            if (!names[count] || !values[count]) return -1;
+            baseline_decode_segment(key_start, key_length, names[count]);
+            baseline_decode_segment(value_start, value_length, values[count]);
+            count++;
+        }
+        if (*cursor == '&') cursor++;
+    }
+    return count;
+}
+
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    double baseline_ns;
+    double parse_ns;
+    int pairs;
+} bench_result_t;
+
+static int bench_run(const bench_query_t* query, size_t iterations, bench_result_t* result) {
+    catzilla_request_arena_t arena;
+    memset(&arena, 0, sizeof(arena));
+    char* names[64];
+    char* values[64];
+    volatile int sink = 0;
+
+    // The baseline stopped at 50 pairs; compare the same amount of work
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < iterations; i++) {
+        int count = baseline_parse(&arena, query->text, names, values, 50);
+        if (count < 0) return -1;
+        sink += count;
+        catzilla_arena_reset(&arena);
+    }
+    result->baseline_ns = (double)(bench_now_ns() - start) / (double)iterations;
+
+    start = bench_now_ns();
+    for (size_t i = 0; i < iterations; i++) {
+        catzilla_param_table_t table;
+        memset(&table, 0, sizeof(table));
+        if (catzilla_urlencoded_parse(&arena, query->text, query->length, false, &table) != 0) return -1;
+        sink += table.count;
+        result->pairs = table.count;
+        catzilla_arena_reset(&arena);
+    }
+    result->parse_ns = (double)(bench_now_ns() - start) / (double)iterations;
+    (void)sink;
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    size_t iterations = 500000;
+    const char* output = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(argv[i], "--iterations") == 0 && value) {
+            iterations = (size_t)strtoull(value, NULL, 10);
+        } else if (strcmp(argv[i], "--output") == 0 && value) {
+            output = value;
+        } else {
+            fprintf(stderr, "usage: %s [--iterations N] [--output FILE]\n", argv[0]);
+            return 2;
+        }
+        i++;
+    }
+    if (iterations == 0) {
+        fprintf(stderr, "usage: %s [--iterations N] [--output FILE]\n", argv[0]);
+        return 2;
+    }
+
+    bench_query_t queries[BENCH_QUERY_COUNT];
+    for (size_t q = 0; q < BENCH_FIXED_COUNT; q++) {
+        queries[q].name = bench_fixed_queries[q][0];
+        queries[q].text = (char*)bench_fixed_queries[q][1];
+        queries[q].length = strlen(queries[q].text);
+    }
+    queries[BENCH_FIXED_COUNT].name = "form_post";
+    queries[BENCH_FIXED_COUNT].text = bench_build_form(&queries[BENCH_FIXED_COUNT].length);
+    if (!queries[BENCH_FIXED_COUNT].text) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    FILE* out = stdout;
+    if (output && !(out = fopen(output, "w"))) {
+        fprintf(stderr, "cannot open %s: %s\n", output, strerror(errno));
+        free(queries[BENCH_FIXED_COUNT].text);
+        return 1;
+    }
+
+    fprintf(out, "{\n  \"benchmark\": \"urlencoded\",\n  \"iterations\": %zu,\n  \"results\": [\n",
+            iterations);
+    int status = 0;
+    for (size_t q = 0; q < BENCH_QUERY_COUNT; q++) {
+        bench_result_t result;
+        if (bench_run(&queries[q], iterations, &result) != 0) {
+            fprintf(stderr, "out of memory\n");
+            status = 1;
+            break;
+        }
+        double bytes = (double)queries[q].length;
+        fprintf(out, "%s    {\"query\": \"%s\", \"bytes\": %zu, \"pairs\": %d, "
+                     "\"baseline_ns\": %.1f, \"ns\": %.1f, \"mb_per_s\": %.1f, \"speedup\": %.2f}",
+                q ? ",\n" : "", queries[q].name, queries[q].length, result.pairs,
+                result.baseline_ns, result.parse_ns,
+                result.parse_ns > 0 ? bytes * 1000.0 / result.parse_ns : 0.0,
+                result.parse_ns > 0 ? result.baseline_ns / result.parse_ns : 0.0);
+    }
+    fprintf(out, "\n  ]\n}\n");
+
+    catzilla_arena_pool_trim();
+    free(queries[BENCH_FIXED_COUNT].text);
+    if (out != stdout) fclose(out);
+    return status;
+}
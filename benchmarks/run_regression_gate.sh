@@ -0,0 +1,120 @@
+#!/usr/bin/env bash
+# Catzilla Regression Gate
+#
+# Starts each Catzilla benchmark server in turn, drives its endpoints.json
+# with the native load generator (catzilla_bench) and compares the result
+# with the stored baseline for that category. Exits non-zero when any
+# endpoint's p50, p99 or throughput regressed past its threshold.
+#
+#   ./run_regression_gate.sh                   # gate every category
+#   ./run_regression_gate.sh basic validation  # gate some categories
+#   UPDATE_BASELINE=1 ./run_regression_gate.sh # record new baselines
+
+set -u
+
+BENCHMARK_DIR="$(cd "$(dirname "$0")" && pwd)"
+PROJECT_ROOT="$(cd "$BENCHMARK_DIR/.." && pwd)"
+SERVERS_DIR="$BENCHMARK_DIR/servers"
+BASELINE_DIR="${BASELINE_DIR:-$BENCHMARK_DIR/results/baseline}"
+OUTPUT_DIR="${OUTPUT_DIR:-$BENCHMARK_DIR/results/gate}"
+
+BENCH="${CATZILLA_BENCH:-$PROJECT_ROOT/build/catzilla_bench}"
+PYTHON_CMD="${PYTHON_CMD:-python3}"
+PORT="${PORT:-8900}"
+CONNECTIONS="${CONNECTIONS:-64}"
+DURATION="${DURATION:-10}"
+WARMUP="${WARMUP:-2}"
+RATE="${RATE:-}"                 # Empty: closed loop; requests/s: open loop
+MAX_P50_REGRESSION="${MAX_P50_REGRESSION:-10}"    # Percent
+MAX_P99_REGRESSION="${MAX_P99_REGRESSION:-15}"
+MAX_THROUGHPUT_REGRESSION="${MAX_THROUGHPUT_REGRESSION:-5}"
+UPDATE_BASELINE="${UPDATE_BASELINE:-0}"
+
+# category:server script
+CATEGORIES=(
+    "basic:basic/catzilla_server.py"
+    "validation:validation/catzilla_validation.py"
+    "middleware:middleware/catzilla_middleware.py"
+    "dependency_injection:dependency_injection/catzilla_di.py"
+    "background_tasks:background_tasks/catzilla_tasks.py"
+    "file_operations:file_operations/catzilla_file.py"
+    "real_world_scenarios:real_world_scenarios/catzilla_realworld.py"
+)
+
+if [ ! -x "$BENCH" ]; then
+    echo "catzilla_bench not found at $BENCH" >&2
+    echo "Build it with: cmake -S . -B build && cmake --build build --target catzilla_bench" >&2
+    exit 2
+fi
+
+mkdir -p "$OUTPUT_DIR" "$BASELINE_DIR"
+
+wait_for_port() {
+    local port="$1"
+    for _ in $(seq 1 100); do
+        if (exec 3<>"/dev/tcp/127.0.0.1/$port") 2>/dev/null; then
+            return 0
+        fi
+        sleep 0.1
+    done
+    return 1
+}
+
+SERVER_PID=""
+stop_server() {
+    if [ -n "$SERVER_PID" ]; then
+        kill "$SERVER_PID" 2>/dev/null
+        wait "$SERVER_PID" 2>/dev/null
+        SERVER_PID=""
+    fi
+}
+trap stop_server EXIT INT TERM
+
+failed=0
+for entry in "${CATEGORIES[@]}"; do
+    category="${entry%%:*}"
+    script="${entry#*:}"
+    if [ $# -gt 0 ] && [[ ! " $* " =~ " $category " ]]; then
+        continue
+    fi
+
+    echo "🔍 $category"
+    (cd "$PROJECT_ROOT" && exec "$PYTHON_CMD" "$SERVERS_DIR/$script" --port "$PORT") > "$OUTPUT_DIR/$category.server.log" 2>&1 &
+    SERVER_PID=$!
+    if ! wait_for_port "$PORT"; then
+        echo "❌ $category: server did not start (see $OUTPUT_DIR/$category.server.log)" >&2
+        stop_server
+        failed=1
+        continue
+    fi
+
+    args=(--endpoints "$SERVERS_DIR/$category/endpoints.json" --port "$PORT"
+          --connections "$CONNECTIONS" --duration "$DURATION" --warmup "$WARMUP"
+          --output "$OUTPUT_DIR/$category.json")
+    if [ -n "$RATE" ]; then
+        args+=(--rate "$RATE")
+    fi
+    baseline="$BASELINE_DIR/$category.json"
+    if [ "$UPDATE_BASELINE" != "1" ] && [ -f "$baseline" ]; then
+        args+=(--baseline "$baseline"
+               --max-p50-regression "$MAX_P50_REGRESSION"
+               --max-p99-regression "$MAX_P99_REGRESSION"
+               --max-throughput-regression "$MAX_THROUGHPUT_REGRESSION")
+    fi
+
+    "$BENCH" "${args[@]}"
+    status=$?
+    stop_server
+
+    if [ $status -ne 0 ]; then
+        echo "❌ $category: regression or load generator error" >&2
+        failed=1
+    elif [ "$UPDATE_BASELINE" = "1" ] || [ ! -f "$baseline" ]; then
+        cp "$OUTPUT_DIR/$category.json" "$baseline"
+        echo "📌 $category: baseline recorded in $baseline"
+    else
+        echo "✅ $category: within thresholds"
+    fi
+done
+
+exit $failed
@@ -2,6 +2,10 @@
 Catzilla is a revolutionary web framework designed to push the boundaries of Python web development.
 """
 
+from time import perf_counter as _perf_counter
+
+_import_started = _perf_counter()
+
 from .app import Catzilla
 
 # Backward compatibility alias
@@ -9,13 +13,6 @@ App = Catzilla
 
 # Auto-validation system (FastAPI-style with 20x performance)
 from .auto_validation import Form, Header, Path, Query, create_auto_validated_handler
-from .cache_middleware import (
-    ConditionalCacheMiddleware,
-    SmartCacheMiddleware,
-    create_api_cache_middleware,
-    create_page_cache_middleware,
-    create_static_cache_middleware,
-)
 from .decorators import Depends, auto_inject, depends, inject, scoped, service
 
 # Revolutionary Dependency Injection System
@@ -77,25 +74,6 @@ from .middleware import (
 )
 from .response import ResponseBuilder, response
 from .router import RouterGroup
-from .scope import (
-    ScopeContext,
-    ScopedDIContainer,
-    ScopeManager,
-    ScopeType,
-    create_request_scope,
-    create_session_scope,
-    get_scope_manager,
-    request_scope,
-    scoped_service,
-    session_scope,
-)
-
-# Revolutionary Smart Cache System (Multi-level C-accelerated caching)
-# Revolutionary Smart Cache System
-from .smart_cache import SmartCache, SmartCacheConfig, cached, get_cache, reset_cache
-
-# Streaming and WebSocket support
-from .streaming import StreamingResponse, StreamingWriter, stream_template
 from .types import HTMLResponse, JSONResponse, Request, Response
 
 # Revolutionary File Upload System (C-native, 10-100x faster)
@@ -113,6 +91,57 @@ from .validation import (
     reset_performance_stats,
 )
 
+# Subsystems an app may never touch are imported on first use (PEP 562),
+# which keeps them off the startup path of apps that don't
+_LAZY_IMPORTS = {
+    # Scope Management
+    "ScopeContext": "scope",
+    "ScopedDIContainer": "scope",
+    "ScopeManager": "scope",
+    "ScopeType": "scope",
+    "create_request_scope": "scope",
+    "create_session_scope": "scope",
+    "get_scope_manager": "scope",
+    "request_scope": "scope",
+    "scoped_service": "scope",
+    "session_scope": "scope",
+    # Revolutionary Smart Cache System (Multi-level C-accelerated caching)
+    "SmartCache": "smart_cache",
+    "SmartCacheConfig": "smart_cache",
+    "cached": "smart_cache",
+    "get_cache": "smart_cache",
+    "reset_cache": "smart_cache",
+    "ConditionalCacheMiddleware": "cache_middleware",
+    "SmartCacheMiddleware": "cache_middleware",
+    "create_api_cache_middleware": "cache_middleware",
+    "create_page_cache_middleware": "cache_middleware",
+    "create_static_cache_middleware": "cache_middleware",
+    # Streaming and WebSocket support
+    "EventHub": "streaming",
+    "StreamingResponse": "streaming",
+    "StreamingWriter": "streaming",
+    "stream_template": "streaming",
+}
+
+
+def __getattr__(name):
+    module_name = _LAZY_IMPORTS.get(name)
+    if module_name is None:
+        raise AttributeError(f"module {__name__!r} has no attribute {name!r}")
+    from importlib import import_module
+
+    value = getattr(import_module(f".{module_name}", __name__), name)
+    globals()[name] = value
+    return value
+
+
+def __dir__():
+    return sorted(set(globals()) | set(_LAZY_IMPORTS))
+
+
+# Reported as the "import" phase of Catzilla.get_startup_report()
+_import_seconds = _perf_counter() - _import_started
+
 __version__ = "0.2.3"
 
 __all__ = [
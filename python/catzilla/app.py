@@ -8,12 +8,13 @@ The Catzilla v0.2.0 Memory Revolution provides 30-35% memory efficiency gains.
 
 import asyncio
 import functools
+import json
 import os
 import signal
 import sys
 import threading
 import time
-from typing import Any, Callable, Dict, List, Optional, Union
+from typing import Any, Callable, Dict, List, Optional, Sequence, Union
 from urllib.parse import parse_qs
 
 
@@ -49,6 +50,7 @@ from .decorators import (
 
 # Import DI system for Phase 3 integration
 from .dependency_injection import DIContainer, DIContext
+from .event_loop import schedule_async_response as schedule_on_loop
 from .hybrid_executor import ExecutionError, ExecutorConfig, HybridExecutor
 from .integration import DIMiddleware, DIRouteEnhancer
 from .middleware import ZeroAllocMiddleware
@@ -63,6 +65,7 @@ try:
     from catzilla._catzilla import (  # New runtime allocator functions
         get_current_allocator,
         get_memory_stats,
+        get_route_latency,
         has_jemalloc,
         init_memory_system,
         init_memory_with_allocator,
@@ -70,6 +73,8 @@ try:
         schedule_async_response,
         send_response,
         set_allocator,
+        set_counter_sampling,
+        start_allocation_profiler,
     )
 except ImportError as e:
     # Check if this is a jemalloc TLS error
@@ -185,6 +190,28 @@ class Catzilla:
         title: Optional[str] = None,
         description: Optional[str] = None,
         version: Optional[str] = "1.0.0",
+        max_body_size: Optional[int] = None,
+        http2: bool = False,
+        header_timeout: float = 30.0,
+        body_timeout: float = 60.0,
+        keepalive_timeout: float = 15.0,
+        write_timeout: float = 60.0,
+        max_connections: int = 0,
+        ssl_certfile: Optional[str] = None,
+        ssl_keyfile: Optional[str] = None,
+        ktls: bool = True,
+        python_batch_size: int = 32,
+        python_batch_budget: float = 0.002,
+        memory_budget: Optional[int] = None,
+        memory_check_interval: float = 1.0,
+        pressure_upload_limit: int = 1024 * 1024,
+        compression: Union[bool, Dict[str, Any]] = False,
+        websocket_ping_interval: float = 30.0,
+        websocket_pong_timeout: float = 10.0,
+        websocket_max_message_size: int = 16 * 1024 * 1024,
+        websocket_max_queue: int = 1024 * 1024,
+        websocket_deflate: bool = True,
+        async_mode: str = "loop",
     ):
         """Initialize Catzilla with advanced memory optimization and dependency injection
 
@@ -204,6 +231,52 @@ class Catzilla:
             enable_colors: Enable colorized output for better developer experience
             show_request_details: Show detailed request information in development mode
             upload_config: Configuration for the revolutionary C-native upload system
+            max_body_size: Reject request bodies above this many bytes with 413
+                (None = unlimited). Routes can override it with set_route_body_mode().
+            http2: Also accept HTTP/2 on the same port: over cleartext with prior
+                knowledge (h2c), or negotiated through ALPN with TLS. Streams go through the same routes; static files and
+                streaming responses stay HTTP/1.1-only.
+            header_timeout: Seconds allowed to receive a request's headers; a stalled
+                request gets 408 (0 = no limit)
+            body_timeout: Seconds allowed between reads of a request body (0 = no limit)
+            keepalive_timeout: Seconds an idle keep-alive connection stays open (0 = no limit)
+            write_timeout: Seconds allowed for a client to read a response (0 = no limit)
+            max_connections: Stop accepting new connections while this many are open,
+                resuming below 90% of it (0 = unlimited)
+            ssl_certfile: PEM certificate chain; with ssl_keyfile, every connection
+                speaks TLS. ALPN offers h2 when http2 is enabled, http/1.1 otherwise.
+            ssl_keyfile: PEM private key for ssl_certfile
+            ktls: On Linux, let the kernel encrypt TLS 1.3 sends after the handshake
+                (needs the tls kernel module; falls back to userspace silently)
+            python_batch_size: Requests that completed during one read pass are
+                handed to Python together under one GIL hold, up to this many
+                (1 = dispatch each request on its own)
+            python_batch_budget: Seconds one such batch may hold the GIL before
+                the loop goes back to I/O (0 = bounded by size only)
+            memory_budget: Resident memory budget in bytes (None = no governor).
+                Near the budget the response and static file caches and the
+                buffer pools shrink; at the budget large uploads get 503.
+            memory_check_interval: Seconds between resident memory checks
+            pressure_upload_limit: Largest request body accepted while
+                resident memory is over the budget
+            compression: Compress responses of text-like media types with
+                gzip, br or zstd, whichever the client prefers and the build
+                supports; streaming responses are compressed chunk by chunk.
+                True uses the defaults; a dict may set min_size,
+                br_max_size, gzip_level, br_quality and zstd_level.
+            websocket_ping_interval: Seconds a WebSocket may be quiet before
+                it is pinged (0 = never)
+            websocket_pong_timeout: Seconds a ping has to be answered before
+                the connection is dropped (0 = no limit)
+            websocket_max_message_size: Largest WebSocket message accepted,
+                after decompression; larger ones close with 1009 (0 = unlimited)
+            websocket_max_queue: Bytes that may wait unsent for a WebSocket
+                client before it is dropped as too slow (0 = unlimited)
+            websocket_deflate: Accept permessage-deflate when the build has zlib
+            async_mode: Where async handlers run. "loop" runs them on an
+                asyncio loop driven by the I/O thread's own libuv loop, so they
+                start and resume without a thread hop; "thread" hands them to
+                a separate asyncio thread, for handlers that block that loop.
 
         Note:
             The `use_jemalloc` parameter now uses conditional runtime support. If jemalloc
@@ -220,6 +293,9 @@ class Catzilla:
             - Enterprise-grade virus scanning with ClamAV
             - Real-time performance monitoring
         """
+        init_started = time.perf_counter()
+        self._startup_phases: Dict[str, float] = {}
+
         # Store configuration
         self.production = production
         self.debug = not production  # For easier reference
@@ -286,6 +362,47 @@ class Catzilla:
         self._init_memory_revolution()
 
         self.server = _Server()
+        if max_body_size:
+            self.server.set_max_body_size(max_body_size)
+        if http2:
+            self.server.set_http2(True)
+        self.server.set_timeouts(
+            int(header_timeout * 1000),
+            int(body_timeout * 1000),
+            int(keepalive_timeout * 1000),
+            int(write_timeout * 1000),
+        )
+        if max_connections:
+            self.server.set_max_connections(max_connections)
+        self.server.set_python_batching(
+            python_batch_size, int(python_batch_budget * 1_000_000)
+        )
+        if memory_budget:
+            self.server.set_memory_budget(
+                memory_budget,
+                int(memory_check_interval * 1000),
+                pressure_upload_limit,
+            )
+        if ssl_certfile or ssl_keyfile:
+            if not (ssl_certfile and ssl_keyfile):
+                raise ValueError("ssl_certfile and ssl_keyfile must be given together")
+            self.server.set_tls(ssl_certfile, ssl_keyfile, ktls)
+        if compression:
+            options = compression if isinstance(compression, dict) else {}
+            self.server.set_compression(True, **options)
+        self.server.set_websocket_options(
+            int(websocket_ping_interval * 1000),
+            int(websocket_pong_timeout * 1000),
+            websocket_max_message_size,
+            websocket_max_queue,
+            websocket_deflate,
+        )
+        if async_mode not in ("loop", "thread"):
+            raise ValueError(f"async_mode must be 'loop' or 'thread', not {async_mode!r}")
+        self.async_mode = async_mode
+        self._route_body_modes: List[tuple] = []
+        self._route_caches: List[tuple] = []
+        self._route_access_samples: List[tuple] = []
 
         # Use C-accelerated router - the only router option
         # Since Catzilla is fundamentally C-based, if this fails, nothing works
@@ -313,6 +430,9 @@ class Catzilla:
         # Initialize Zero-Allocation Middleware System (after app is set up)
         self.middleware_system = ZeroAllocMiddleware(self)
 
+        self._init_finished = time.perf_counter()
+        self._startup_phases["init"] = self._init_finished - init_started
+
         # Signal handling is now handled natively at the C level for better performance
         # and integration. No Python signal handling overhead needed.
         if self.debug:
@@ -321,6 +441,22 @@ class Catzilla:
                 flush=True,
             )
 
+    def get_startup_report(self) -> Dict[str, float]:
+        """Milliseconds each startup phase took, in order
+
+        Phases: "import" (importing the catzilla package), "init" (this
+        constructor), "setup" (from there until listen(): registering routes
+        and the rest of the app's code), "banner" (printing the banner and
+        route list) and "routes" (handing the route table to the server).
+        Phases that have not run yet are missing; "total" sums the rest.
+        """
+        from . import _import_seconds
+
+        phases = {"import": _import_seconds, **self._startup_phases}
+        report = {name: round(seconds * 1000, 3) for name, seconds in phases.items()}
+        report["total"] = round(sum(phases.values()) * 1000, 3)
+        return report
+
     def _init_memory_revolution(self):
         """Initialize the jemalloc memory revolution with advanced options"""
         try:
@@ -542,6 +678,65 @@ class Catzilla:
             "total_checks": len(self._memory_stats_history),
         }
 
+    def enable_heap_profiling(
+        self, path: str = "/debug/pprof/heap", lg_sample: int = 0
+    ) -> None:
+        """Sample allocations with jemalloc prof and serve the heap profile
+
+        GET on the path returns a profile in jemalloc heap format, readable by
+        jeprof or pprof. Sampled stacks go through the typed catzilla_*_alloc
+        functions, so each allocation is attributed to its arena.
+
+        Args:
+            path: Route that serves the profile
+            lg_sample: log2 of the mean bytes between samples (0 = 512 KiB)
+
+        Raises:
+            RuntimeError: If this build has no jemalloc heap profiling
+        """
+        start_allocation_profiler(lg_sample)
+        self.server.set_heap_profile_endpoint(path)
+
+    def enable_metrics(self, path: str = "/metrics", sample_counters: int = 0) -> None:
+        """Serve Prometheus metrics and record per-route latency
+
+        GET on the path returns the server's counters and, for every route,
+        histograms of the time spent queued, waiting for the GIL, in the
+        handler and writing the response. The route is answered in C without
+        taking the GIL, so scrapes keep working while handlers are busy.
+
+        With sample_counters, one request in that many also has its handler
+        measured with the CPU's hardware counters (Linux perf events):
+        cycles, instructions and cache misses per route. Where the kernel
+        refuses the counters a warning is issued and nothing is sampled.
+
+        Args:
+            path: Route that serves the metrics
+            sample_counters: Measure one handler in this many (0 = never)
+
+        Raises:
+            RuntimeError: If the path cannot be routed
+        """
+        self.server.set_metrics_endpoint(path)
+        if sample_counters and not set_counter_sampling(sample_counters):
+            import warnings
+
+            warnings.warn(
+                "Hardware counters are unavailable (perf_event_open refused); "
+                "handlers are not sampled"
+            )
+
+    def get_route_latency(self) -> List[Dict[str, Any]]:
+        """Per-route latency recorded since enable_metrics(), in seconds
+
+        Each entry has the route's method and path and, for the phases
+        queue, gil, handler and write, its count, sum, max, p50, p90 and p99.
+        "counters" holds the number of handlers measured with hardware
+        counters (see enable_metrics) and their total cycles, instructions
+        and cache misses.
+        """
+        return get_route_latency()
+
     def get_async_performance_stats(self) -> dict:
         """Get async/sync handler performance statistics"""
         if not self._async_enabled:
@@ -616,14 +811,14 @@ class Catzilla:
         """Normalize handler return values to a Response instance."""
         if isinstance(response, Response):
             return response
-        if isinstance(response, dict):
+        if isinstance(response, (dict, list)):
             return JSONResponse(response)
         if isinstance(response, str):
             return HTMLResponse(response)
 
         raise TypeError(
             f"Handler returned unsupported type {type(response)}. "
-            "Must return Response, dict, or str."
+            "Must return Response, dict, list, or str."
         )
 
     def _apply_post_route_middlewares(
@@ -756,34 +951,32 @@ class Catzilla:
                 return 0
 
         try:
-            # Create request object with empty query params dict - will be populated by C layer
+            # Headers and query params are read from the C request on first access
             request = Request(
                 method=method,
                 path=path,  # Use full path with query string
                 body=body,
                 client=client,
                 request_capsule=request_capsule,
-                _query_params={},  # Changed from query_params to _query_params
-            )  # Header extraction temporarily disabled for performance testing
-            # TODO: Re-enable with lazy loading for production
-            request.headers = {}
+            )
 
             route = None
             path_params = {}
             allowed_methods = None
             use_fallback_match = True
 
-            if isinstance(route_match, dict):
-                matched = bool(route_match.get("matched"))
-                if matched:
-                    route_id = route_match.get("route_id")
-                    route = self.router.route_map.get(route_id)
-                    path_params = route_match.get("path_params") or {}
+            if route_match is not None:
+                # NativeRequest from the C server: the C router already matched
+                if route_match.matched:
+                    route = route_match.route or self.router.route_map.get(
+                        route_match.route_id
+                    )
+                    path_params = route_match.path_params
                     use_fallback_match = route is None
                 else:
                     use_fallback_match = False
-                    if route_match.get("status_code") == 405:
-                        allowed_methods_str = route_match.get("allowed_methods")
+                    if route_match.status_code == 405:
+                        allowed_methods_str = route_match.allowed_methods
                         if allowed_methods_str:
                             allowed_methods = set(allowed_methods_str.split(", "))
                         else:
@@ -915,7 +1108,12 @@ class Catzilla:
 
                     is_async_route = self._is_async_route_handler(route.handler)
 
-                    if is_async_route and schedule_async_response is not None:
+                    schedule_async = (
+                        schedule_on_loop
+                        if self.async_mode == "loop"
+                        else schedule_async_response
+                    )
+                    if is_async_route and schedule_async is not None:
                         async_coro = self._execute_async_route_request(
                             route,
                             request,
@@ -967,7 +1165,7 @@ class Catzilla:
                                 )
 
                         try:
-                            scheduled = schedule_async_response(
+                            scheduled = schedule_async(
                                 async_coro,
                                 complete_async_response,
                             )
@@ -1121,6 +1319,27 @@ class Catzilla:
 
         return decorator
 
+    def websocket(self, path: str):
+        """Register a WebSocket route
+
+        The handler is called once per upgraded connection with a WebSocket
+        and sets its on_message and on_close callbacks. Callbacks run on the
+        connection's event loop; send() and close() are called from them.
+
+            @app.websocket("/echo")
+            def echo(ws):
+                ws.on_message = ws.send
+        """
+
+        def decorator(handler: Callable):
+            if self._routes_buffered:
+                handler_name = getattr(handler, "__name__", "unknown")
+                self._route_buffer.append(f"📍 WS      {path} → {handler_name}")
+            self.server.add_websocket_route(path, handler)
+            return handler
+
+        return decorator
+
     def get(
         self,
         path: str,
@@ -1741,6 +1960,7 @@ class Catzilla:
         enable_range_requests: bool = True,
         enable_directory_listing: bool = False,
         enable_hidden_files: bool = False,
+        use_io_uring: bool = False,
     ) -> None:
         """Mount a static file directory with ultra-high performance C-native serving
 
@@ -1761,7 +1981,10 @@ class Catzilla:
             cache_ttl_seconds: Time-to-live for cached files in seconds (default: 3600)
                               Files are automatically revalidated after this period
             enable_compression: Enable gzip compression for compatible files (default: True)
-                               Reduces bandwidth usage by 60-80% for text files
+                               Reduces bandwidth usage by 60-80% for text files.
+                               Cached files are gzipped once, and precompressed
+                               file.br / file.gz siblings are served to clients
+                               that accept them
             compression_level: Gzip compression level 1-9 (default: 6)
                               Higher values provide better compression but use more CPU
             max_file_size: Maximum file size to serve in bytes (default: 100MB)
@@ -1774,6 +1997,8 @@ class Catzilla:
                                      Security consideration: only enable if needed
             enable_hidden_files: Allow serving files starting with "." (default: False)
                                 Security consideration: usually should remain disabled
+            use_io_uring: Load uncached files through io_uring on Linux (default: False)
+                         Falls back to the libuv threadpool where io_uring is unavailable
 
         Examples:
             # Basic static file serving
@@ -1877,6 +2102,7 @@ class Catzilla:
                 enable_range_requests=enable_range_requests,
                 enable_directory_listing=enable_directory_listing,
                 enable_hidden_files=enable_hidden_files,
+                use_io_uring=use_io_uring,
             )
 
             # Log the successful mount
@@ -1913,11 +2139,282 @@ class Catzilla:
 
             raise RuntimeError(error_msg) from e
 
-    def listen(self, port: int = 8000, host: str = "0.0.0.0"):
-        """Start the server with beautiful startup banner"""
+    def set_route_body_mode(
+        self,
+        method: str,
+        path: str,
+        mode: str = "buffered",
+        *,
+        max_body_size: int = 0,
+        spool_threshold: int = 0,
+    ):
+        """Choose how a route receives its request body
+
+        Args:
+            method: HTTP method of the route
+            path: Path pattern the route was registered with
+            mode: "buffered" keeps the body in memory; "spool" spills bodies above
+                spool_threshold to a temp file exposed as request.body_file
+            max_body_size: Route limit in bytes, answered with 413 (0 = app default)
+            spool_threshold: Bytes held in memory before spilling (0 = 1 MB default)
+        """
+        if mode not in ("buffered", "spool"):
+            raise ValueError("mode must be 'buffered' or 'spool'")
+        # Applied once routes are registered with the C server in listen()
+        self._route_body_modes.append(
+            (method.upper(), path, mode, max_body_size, spool_threshold)
+        )
+
+    def cache_route(
+        self,
+        method: str,
+        path: str,
+        ttl: int,
+        *,
+        vary_query: bool = True,
+        vary_headers: Optional[List[str]] = None,
+    ):
+        """Cache a route's responses in C
+
+        Cache hits are written before the GIL is taken, without creating a
+        request object or running middleware. Only GET requests and 200
+        responses without Set-Cookie are stored. The handler's
+        Cache-Control is honoured (no-store, no-cache and private are not
+        stored; s-maxage or max-age replace ttl), a response with Vary is
+        cached per value of the headers it names, and stored responses get
+        an ETag and Last-Modified so If-None-Match and If-Modified-Since
+        are answered with 304 in C.
+
+        Args:
+            method: HTTP method of the route
+            path: Path pattern the route was registered with
+            ttl: Seconds a response stays cached (0 stops caching)
+            vary_query: Whether requests with different query strings are
+                cached separately
+            vary_headers: Request headers whose values are part of the key
+        """
+        if ttl < 0:
+            raise ValueError("ttl must not be negative")
+        # Applied once routes are registered with the C server in listen()
+        self._route_caches.append(
+            (method.upper(), path, ttl, vary_query, ",".join(vary_headers or ()))
+        )
+
+    def enable_access_log(
+        self,
+        path: str = "-",
+        *,
+        format: str = "json",
+        sample_rate: float = 1.0,
+        ring_records: int = 0,
+        flush_interval_ms: int = 0,
+    ):
+        """Log responses without formatting or writing on the event loop
+
+        Each loop copies a fixed-size record per response into a ring of its
+        own; a writer thread formats the records and appends them to the file
+        in batches. When a ring is full the record is dropped and counted
+        (get_access_log_stats()) rather than making the loop wait.
+
+        Args:
+            path: File to append to, "-" for stdout
+            format: "json" for one JSON object per line, "clf" for Common Log Format
+            sample_rate: Share of requests logged, 0 to 1
+            ring_records: Records each loop holds before dropping (0 = 4096)
+            flush_interval_ms: How often the writer drains the rings (0 = 100)
+        """
+        if not 0.0 <= sample_rate <= 1.0:
+            raise ValueError("sample_rate must be between 0 and 1")
+        self.server.set_access_log(
+            path, format, sample_rate, ring_records, flush_interval_ms
+        )
+
+    def sample_access_log(self, method: str, path: str, sample_rate: float):
+        """Log a share of one route's requests instead of the default rate
+
+        Args:
+            method: HTTP method of the route
+            path: Path pattern the route was registered with
+            sample_rate: Share of the route's requests logged, 0 to 1
+        """
+        if not 0.0 <= sample_rate <= 1.0:
+            raise ValueError("sample_rate must be between 0 and 1")
+        # Applied once routes are registered with the C server in listen()
+        self._route_access_samples.append((method.upper(), path, sample_rate))
+
+    def get_access_log_stats(self) -> Dict[str, Any]:
+        """Records written and dropped by the access log"""
+        return self.server.get_access_log_stats()
+
+    def clear_response_cache(self):
+        """Drop every response cached by cache_route()"""
+        self.server.clear_response_cache()
+
+    def response_cache_disk(self, directory: str, max_bytes: int = 0):
+        """Keep responses cached by cache_route() on disk as well
+
+        Entries evicted from memory are then served from memory-mapped
+        segment files under ``directory`` and promoted back to memory,
+        instead of being rendered again. Entries also survive a restart
+        until their TTL runs out.
+
+        Args:
+            directory: Directory for the segment files (created if missing)
+            max_bytes: Disk space to use; oldest entries go first (0 = 256 MiB)
+        """
+        if max_bytes < 0:
+            raise ValueError("max_bytes must not be negative")
+        self.server.set_response_cache_disk(directory, max_bytes)
+
+    def cache_snapshot(self, directory: str):
+        """Keep the response and static file caches warm across restarts
+
+        On a graceful stop the responses cached by cache_route() and the
+        files cached by mounted static directories are written to snapshot
+        files under ``directory``; the next listen() maps them and restores
+        each entry, with the TTL it had left, the first time its key is
+        used. Static files changed on disk since are read again. Call
+        before listen(). Not available on Windows.
+
+        Args:
+            directory: Directory for the snapshot files (created if missing)
+        """
+        self.server.set_cache_snapshot(directory)
+
+    def handoff_socket(self, path: str, drain_timeout: float = 30.0):
+        """Reload without closing the listening sockets
+
+        listen() first asks a server already running with the same ``path``
+        for its listening sockets and serves on those instead of binding the
+        port, so no connection is refused in between. The old server then
+        writes its cache snapshots (see cache_snapshot()) for the new one to
+        load, stops accepting, answers remaining requests with
+        ``Connection: close``, closes idle keep-alive connections, sends
+        WebSocket clients a 1001 close and returns from listen() once every
+        connection closed or ``drain_timeout`` passed. To reload, start the
+        new process while the old one runs. Call before listen(). Not
+        available on Windows.
+
+        Args:
+            path: Unix socket path shared by the old and the new process
+            drain_timeout: Longest drain in seconds after a handoff (0 = no limit)
+        """
+        if drain_timeout < 0:
+            raise ValueError("drain_timeout must not be negative")
+        self.server.set_handoff(path, int(drain_timeout * 1000))
+
+    def response_cache_redis(self, url: str, key_prefix: str = "catzilla:", pool_size: int = 0):
+        """Share responses cached by cache_route() with other nodes through Redis
+
+        A request that misses this node's cache asks Redis without blocking
+        the event loop, and goes to the handler if Redis misses or is down.
+        Responses are stored in Redis for the route's TTL. Call before listen().
+
+        Args:
+            url: redis://[[user]:password@]host[:port][/db]
+            key_prefix: Prepended to every key in Redis
+            pool_size: Connections per event loop (0 = 2)
+        """
+        if pool_size < 0:
+            raise ValueError("pool_size must not be negative")
+        self.server.set_response_cache_redis(url, key_prefix, pool_size)
+
+    def clamd(self, address: str = "unix:/var/run/clamav/clamd.ctl", pool_size: int = 0):
+        """Scan uploaded files with clamd while they are received
+
+        File parts of multipart bodies are streamed to clamd with INSTREAM
+        as they arrive, without blocking the event loop, and the handler runs
+        once every file has a verdict. A file has ``virus_scanned`` set in
+        request.files; an infected file, or one clamd gave no verdict for,
+        also has an ``error``. Call before listen().
+
+        Args:
+            address: "unix:/path", "/path", "tcp://host[:port]" or "host[:port]"
+            pool_size: Connections per event loop (0 = 4)
+        """
+        if pool_size < 0:
+            raise ValueError("pool_size must not be negative")
+        self.server.set_clamd(address, pool_size)
+
+    def upload_options(self, digests: Sequence[str] = (), direct_io: bool = False):
+        """Choose how uploaded files are received
+
+        Digests are computed from each chunk while the file is parsed, using
+        the CPU's SHA and CRC instructions where available, and show up as
+        ``sha256`` (hex) and ``crc32c`` (int) in request.files, so the file
+        never has to be read again to checksum it. Files spilled to disk get
+        their space reserved from Content-Length.
+
+        Args:
+            digests: Any of "sha256" and "crc32c"
+            direct_io: Write spilled files with O_DIRECT, bypassing the page
+                cache, where the file system supports it
+        """
+        unknown = set(digests) - {"sha256", "crc32c"}
+        if unknown:
+            raise ValueError(f"Unknown upload digests: {', '.join(sorted(unknown))}")
+        self.server.set_upload_options(
+            "sha256" in digests, "crc32c" in digests, direct_io
+        )
+
+    def native_response(
+        self,
+        path: str,
+        body: Union[str, bytes, dict, list],
+        *,
+        method: str = "GET",
+        status_code: int = 200,
+        content_type: Optional[str] = None,
+        headers: Optional[Dict[str, str]] = None,
+    ):
+        """Serve a fixed response for a route entirely from C
+
+        The response never enters Python or takes the GIL, which suits health
+        checks and other precomputed endpoints. Calling this again for the same
+        route swaps the response atomically, also while the server is running;
+        new routes must be added before listen(). The path cannot also have a
+        Python handler.
+
+        Args:
+            path: Path pattern to serve
+            body: Response body; dicts and lists are serialized as JSON
+            method: HTTP method of the route
+            status_code: HTTP status code
+            content_type: Content type (default: JSON for dicts and lists,
+                text/plain otherwise)
+            headers: Extra response headers
+        """
+        if isinstance(body, (dict, list)):
+            body = json.dumps(body, separators=(",", ":"))
+            content_type = content_type or "application/json"
+        if isinstance(body, str):
+            body = body.encode("utf-8")
+        header_lines = f"Content-Type: {content_type or 'text/plain'}\r\n"
+        for name, value in (headers or {}).items():
+            header_lines += f"{name}: {value}\r\n"
+        self.server.set_native_response(
+            method.upper(), path, body, status_code, header_lines
+        )
+
+    def listen(self, port: int = 8000, host: str = "0.0.0.0", workers: int = 1):
+        """Start the server with beautiful startup banner
+
+        Args:
+            port: Port to listen on
+            host: Host address to bind
+            workers: Number of event loops sharing the port via SO_REUSEPORT
+                (0 = one per CPU core, 1 = single loop). C-level parsing, routing
+                and I/O scale across loops; Python handlers share the GIL, except on
+                free-threaded CPython builds (3.13t+, see
+                catzilla._catzilla.FREE_THREADED) where each loop runs its handlers
+                in parallel.
+        """
 
         # Signal handlers are now handled natively at the C level for better integration
 
+        listen_started = time.perf_counter()
+        self._startup_phases["setup"] = listen_started - self._init_finished
+
         # Show beautiful startup banner
         if self.banner_renderer and self.server_info_collector:
             try:
@@ -1948,17 +2445,43 @@ class Catzilla:
             mode = "development" if self.debug else "production"
             self.logger.log_server_start(host, port, mode)
 
+        routes_started = time.perf_counter()
+        self._startup_phases["banner"] = routes_started - listen_started
+
         # Routes are already logged during registration, no need to log again here
 
-        # Add our Python handler for all registered routes
+        # Add our Python handler for all registered routes in one call. The
+        # route object is kept on the C route, so dispatch needs no lookup by
+        # id; resolving the handler type now caches it on the handler.
+        route_table = []
         for route_id, route in self.router.route_map.items():
-            self.server.add_route(route.method, route.path, self._handle_request, route_id)
+            self._is_async_route_handler(route.handler)
+            route_table.append((route.method, route.path, route_id, route))
+        self.server.add_routes(self._handle_request, route_table)
+
+        for method, path, mode, max_body_size, spool_threshold in self._route_body_modes:
+            self.server.set_route_body_mode(
+                method, path, mode, max_body_size, spool_threshold
+            )
+
+        for method, path, ttl, vary_query, vary_headers in self._route_caches:
+            self.server.set_route_cache(method, path, ttl, vary_query, vary_headers)
+
+        for method, path, sample_rate in self._route_access_samples:
+            self.server.set_route_access_log_sample(method, path, sample_rate)
 
         # Display buffered routes after banner
         self._display_buffered_routes()
 
+        self._startup_phases["routes"] = time.perf_counter() - routes_started
+        if self.debug and self.banner_renderer:
+            report = self.get_startup_report()
+            total = report.pop("total")
+            phases = ", ".join(f"{name} {ms:.1f} ms" for name, ms in report.items())
+            _safe_print(f"⏱️  Startup: {phases} ({total:.1f} ms)")
+
         # Start the server
-        self.server.listen(port, host)
+        self.server.listen(port, host, workers)
 
     def stop(self):
         """Stop the server"""
@@ -321,20 +321,19 @@ def auto_validate_request(
         # 1. JSON Body Validation (most common, optimize first)
         if validation_spec.json_body_params:
             try:
-                json_data = request.json()
-
                 # Ultra-fast C validation for each JSON body parameter
                 for param_name in validation_spec.json_body_params:
                     param_spec = validation_spec.parameters[param_name]
 
                     if param_spec.c_validation_spec:
                         # Direct C engine validation (2.3μs)
-                        validated_model = param_spec.annotation.validate(json_data)
+                        validated_model = param_spec.annotation.validate(request.json())
                         validated_params[param_name] = validated_model
                     else:
-                        # Fallback to Python validation
-                        validated_params[param_name] = param_spec.annotation(
-                            **json_data
+                        # Validate straight off the parsed body, falling back to
+                        # Python validation of request.json()
+                        validated_params[param_name] = (
+                            param_spec.annotation.from_request(request)
                         )
 
             except json.JSONDecodeError:
@@ -598,6 +597,8 @@ def auto_validate_request(
 
                             # Mark as finalized since the C layer already parsed and finalized it
                             upload_file._is_finalized = True
+                            upload_file._sha256 = file_data.get("sha256")
+                            upload_file._crc32c = file_data.get("crc32c")
 
                             validated_params[param_name] = upload_file
                         else:
@@ -645,6 +646,14 @@ def _convert_primitive_type(value: str, target_type: Type) -> Any:
                 actual_type = args[0] if args[1] is type(None) else args[1]
                 return _convert_primitive_type(value, actual_type)
 
+    # Typed path parameters ({id:int}, {key:uuid}) arrive converted already
+    if not isinstance(value, str):
+        if target_type == str:
+            return str(value)
+        if target_type == float:
+            return float(value)
+        return value
+
     if target_type == str or target_type == Any:
         return value
     elif target_type == int:
@@ -19,6 +19,7 @@ import asyncio
 import inspect
 import logging
 import os
+import pickle
 import queue
 import threading
 import time
@@ -36,6 +37,15 @@ HAS_C_EXTENSION = True  # Will integrate with catzilla._catzilla for core operat
 T = TypeVar("T")
 
 
+def _open_task_log(directory: str, sync_interval_ms: int):
+    """Open the native write-ahead task log used by durable task queues"""
+    try:
+        from catzilla._catzilla import TaskLog
+    except ImportError as e:
+        raise RuntimeError(f"Durable tasks need the Catzilla C extension: {e}")
+    return TaskLog(directory, sync_interval_ms=sync_interval_ms)
+
+
 class TaskPriority(Enum):
     """Task priority levels with performance targets"""
 
@@ -435,6 +445,8 @@ class BackgroundTasks:
         memory_pool_mb: int = 500,
         enable_c_compilation: bool = True,
         enable_profiling: bool = False,
+        durable_dir: Optional[str] = None,
+        durable_sync_ms: int = 5,
     ):
         # Auto-detect optimal worker count
         if workers is None:
@@ -471,10 +483,44 @@ class BackgroundTasks:
         self._task_id_lock = threading.Lock()
         self._running = False
 
+        # Write-ahead log: tasks queued with durable=True survive a crash or
+        # restart and are run again, so durable tasks must be idempotent
+        self._task_log = None
+        if durable_dir is not None:
+            self._task_log = _open_task_log(durable_dir, durable_sync_ms)
+
         # Pure Python worker pool (fallback)
         if not self._c_engine:
             self._init_python_workers()
 
+        if self._task_log is not None:
+            self._replay_durable_tasks()
+
+    def _replay_durable_tasks(self):
+        """Queue the tasks a previous process logged but did not finish"""
+        replayed = 0
+        for entry_id, payload in self._task_log.pending():
+            try:
+                func, args, kwargs, priority = pickle.loads(payload)
+                priority = TaskPriority(priority)
+            except Exception as e:
+                logging.error(f"Dropping unreadable durable task {entry_id}: {e}")
+                self._task_log.complete(entry_id)
+                continue
+
+            future = TaskFuture(self._generate_task_id(), self)
+            try:
+                self._task_queues[priority].put_nowait(
+                    (int(time.time() * 1000000), func, args, kwargs, future, entry_id)
+                )
+                replayed += 1
+            except queue.Full:
+                # Stays pending in the log and is retried on the next start
+                logging.warning(f"Task queue full, durable task {entry_id} deferred")
+
+        if replayed:
+            logging.info(f"Replayed {replayed} durable background tasks")
+
     def _init_python_workers(self):
         """Initialize pure Python worker pool as fallback"""
         import queue
@@ -512,9 +558,14 @@ class BackgroundTasks:
                     TaskPriority.LOW,
                 ]:
                     try:
-                        _, task_func, args, kwargs, result_future = self._task_queues[
-                            priority
-                        ].get_nowait()
+                        (
+                            _,
+                            task_func,
+                            args,
+                            kwargs,
+                            result_future,
+                            entry_id,
+                        ) = self._task_queues[priority].get_nowait()
 
                         # Execute task
                         try:
@@ -522,6 +573,12 @@ class BackgroundTasks:
                             result_future.set_result(result)
                         except Exception as e:
                             result_future.set_exception(e)
+                        finally:
+                            # After shutdown closed the log the task stays
+                            # pending and runs again on the next start
+                            task_log = self._task_log
+                            if entry_id is not None and task_log is not None:
+                                task_log.complete(entry_id)
 
                         task_executed = True
                         break
@@ -553,12 +610,24 @@ class BackgroundTasks:
         max_retries: int = 3,
         timeout_ms: int = 30000,
         compile_to_c: Optional[bool] = None,
+        durable: Optional[bool] = None,
         **kwargs,
     ) -> TaskResult[T]:
-        """Add task with automatic C compilation if possible"""
+        """Add task with automatic C compilation if possible
+
+        With durable=True (the default when the system has a durable_dir) the
+        task is written to the task log before it is queued and runs at least
+        once, even across a crash. Its function and arguments must pickle.
+        """
 
         if compile_to_c is None:
             compile_to_c = self.enable_c_compilation
+        if durable is None:
+            durable = self._task_log is not None
+        if durable:
+            if self._task_log is None:
+                raise RuntimeError("Durable tasks need BackgroundTasks(durable_dir=...)")
+            return self._add_durable_task(func, args, kwargs, priority)
 
         task_id = self._generate_task_id()
 
@@ -599,7 +668,7 @@ class BackgroundTasks:
 
             try:
                 self._task_queues[priority].put_nowait(
-                    (priority_value, func, args, kwargs, future)
+                    (priority_value, func, args, kwargs, future, None)
                 )
                 result._result = future
             except queue.Full:
@@ -609,6 +678,37 @@ class BackgroundTasks:
 
         return result
 
+    def _add_durable_task(
+        self, func: Callable[..., T], args: tuple, kwargs: dict, priority: TaskPriority
+    ) -> TaskResult[T]:
+        """Log a task durably, then queue it on the Python workers"""
+        task_id = self._generate_task_id()
+        result = TaskResult(task_id, self)
+        future = TaskFuture(task_id, self)
+        result._result = future
+
+        try:
+            payload = pickle.dumps((func, args, kwargs, priority.value))
+        except Exception as e:
+            future.set_exception(RuntimeError(f"Durable task does not pickle: {e}"))
+            return result
+
+        # Returns once the record is fsynced, sharing the fsync with any
+        # other appends in the same group commit window
+        entry_id = self._task_log.append(payload, True)
+
+        try:
+            self._task_queues[priority].put_nowait(
+                (int(time.time() * 1000000), func, args, kwargs, future, entry_id)
+            )
+        except queue.Full:
+            self._task_log.complete(entry_id)
+            future.set_exception(
+                RuntimeError(f"Task queue for priority {priority} is full")
+            )
+
+        return result
+
     def task(
         self,
         priority: TaskPriority = TaskPriority.NORMAL,
@@ -706,6 +806,12 @@ class BackgroundTasks:
                 for worker in self._workers:
                     worker.join(timeout=timeout)
 
+        # Tasks still queued stay pending in the log for the next start
+        task_log = getattr(self, "_task_log", None)
+        if task_log is not None:
+            self._task_log = None
+            task_log.close()
+
         self._running = False
 
     def __del__(self):
@@ -33,6 +33,8 @@ class SmartCacheMiddleware:
         include_paths: Optional[List[str]] = None,
         cache_vary_headers: Optional[Set[str]] = None,
         custom_key_generator: Optional[Callable] = None,
+        stale_ttl: int = 0,
+        coalesce: bool = True,
     ):
         """
         Initialize Smart Cache Middleware
@@ -51,6 +53,10 @@ class SmartCacheMiddleware:
             include_paths: Paths to include in caching (if set, only these are cached)
             cache_vary_headers: Headers that should vary the cache
             custom_key_generator: Custom function to generate cache keys
+            stale_ttl: Seconds an expired response is still served while one
+                       request refreshes it
+            coalesce: Let concurrent misses on one key wait for the first
+                      request's response instead of all running the handler
         """
         super().__init__()
 
@@ -84,12 +90,18 @@ class SmartCacheMiddleware:
         # Custom key generator
         self.custom_key_generator = custom_key_generator
 
+        # Thundering herd protection
+        self.stale_ttl = stale_ttl
+        self.coalesce = coalesce
+
         # Statistics
         self.stats = {
             "cache_hits": 0,
             "cache_misses": 0,
             "cache_sets": 0,
             "cache_skips": 0,
+            "cache_coalesced": 0,
+            "cache_stale": 0,
             "total_requests": 0,
         }
 
@@ -250,22 +262,22 @@ class SmartCacheMiddleware:
 
         return json.dumps(response_data).encode("utf-8")
 
-    def _deserialize_response(self, data: bytes) -> Response:
+    def _deserialize_response(self, data: bytes, status: str = "HIT") -> Response:
         """Deserialize cached response"""
         response_data = json.loads(data.decode("utf-8"))
 
         # Create response object
         response = Response(
-            content=response_data["body"],
             status_code=response_data["status_code"],
+            content_type=response_data.get("media_type") or "text/plain",
+            body=response_data["body"],
             headers=response_data["headers"],
-            media_type=response_data.get("media_type"),
         )
 
         # Add cache headers
-        response.headers["x-cache"] = "HIT"
-        response.headers["x-cache-time"] = str(
-            int(time.time() - response_data["cached_at"])
+        response.set_header("x-cache", status)
+        response.set_header(
+            "x-cache-time", str(int(time.time() - response_data["cached_at"]))
         )
 
         return response
@@ -283,7 +295,32 @@ class SmartCacheMiddleware:
         cache_key = self._generate_cache_key(request)
 
         # Try to get cached response
-        cached_data, found = self.cache.get(cache_key)
+        cached_data, found, stale = self.cache.lookup(cache_key)
+        flight = None
+
+        if not found and self.coalesce:
+            # One request runs the handler; the others wait for its response
+            leader, flight = self.cache.claim(cache_key)
+            if not leader:
+                await flight.wait_async(self.cache.config.fill_timeout)
+                flight = None
+                cached_data, found, stale = self.cache.lookup(cache_key)
+                if found:
+                    self.stats["cache_coalesced"] += 1
+                    self.cache.note_coalesced()
+
+        if found and stale and self.coalesce:
+            # Past its TTL: the first request refreshes, the rest get it stale
+            leader, flight = self.cache.claim(cache_key)
+            if not leader:
+                flight = None
+                self.stats["cache_stale"] += 1
+                self.cache.note_stale_hit()
+                try:
+                    return self._deserialize_response(cached_data, "STALE")
+                except Exception:
+                    self.cache.delete(cache_key)
+            found = False
 
         if found:
             self.stats["cache_hits"] += 1
@@ -299,6 +336,7 @@ class SmartCacheMiddleware:
 
         # Store cache key in request for use in process_response
         request.state.cache_key = cache_key
+        request.state.cache_flight = flight
 
         return None
 
@@ -309,6 +347,16 @@ class SmartCacheMiddleware:
         if not cache_key:
             return response
 
+        flight = getattr(request.state, "cache_flight", None)
+        try:
+            return self._store_response(cache_key, response)
+        finally:
+            if flight is not None:
+                request.state.cache_flight = None
+                self.cache.release(cache_key, flight)
+
+    def _store_response(self, cache_key: str, response: Response) -> Response:
+        """Cache a response to a miss if appropriate"""
         # Check if response should be cached
         if not self._should_cache_response(response):
             return response
@@ -319,7 +367,7 @@ class SmartCacheMiddleware:
 
             # Serialize and cache response
             cached_data = self._serialize_response(response)
-            success = self.cache.set(cache_key, cached_data, ttl)
+            success = self.cache.set(cache_key, cached_data, ttl, self.stale_ttl)
 
             if success:
                 self.stats["cache_sets"] += 1
@@ -0,0 +1,153 @@
+"""
+Catzilla Event Loop Module
+
+Runs async handlers on the libuv loop that serves the request, instead of
+handing them to a separate asyncio thread.
+
+CatzillaEventLoop is a standard asyncio SelectorEventLoop whose selector is
+fed by libuv: each registered socket is watched with a uv_poll handle on the
+server's loop, the earliest timer is a uv_timer, and while callbacks are ready
+a uv_idle handle runs one asyncio iteration per libuv iteration. asyncio never
+blocks in select; libuv does, on behalf of both. Coroutines therefore start
+on the I/O thread right after the request is parsed and resume between reads
+with no thread hop or GIL handoff.
+
+Each I/O thread (one per worker loop) gets its own event loop on first use.
+When the server's loop shuts down, its event loop stops with it; tasks still
+pending are dropped.
+"""
+
+import asyncio
+import selectors
+import threading
+from asyncio import events
+from typing import Any, Callable, Coroutine, Optional
+
+from catzilla._catzilla import LoopDriver
+
+__all__ = ["CatzillaEventLoop", "get_event_loop", "schedule_async_response"]
+
+
+class _LoopDriverSelector(selectors._BaseSelectorImpl):
+    """Selector reporting readiness that libuv already collected"""
+
+    def __init__(self, driver: LoopDriver):
+        super().__init__()
+        self._driver = driver
+
+    def register(self, fileobj, events, data=None):
+        key = super().register(fileobj, events, data)
+        try:
+            self._driver.watch(key.fd, events)
+        except Exception:
+            super().unregister(fileobj)
+            raise
+        return key
+
+    def unregister(self, fileobj):
+        key = super().unregister(fileobj)
+        self._driver.watch(key.fd, 0)
+        return key
+
+    def select(self, timeout=None):
+        # Never blocks: the tick only runs once libuv has polled
+        ready = []
+        for fd, mask in self._driver.take_events():
+            key = self._key_from_fd(fd)
+            if key is not None and mask & key.events:
+                ready.append((key, mask & key.events))
+        return ready
+
+
+class CatzillaEventLoop(asyncio.SelectorEventLoop):
+    """asyncio event loop running on the libuv loop of the thread creating it
+
+    The loop counts as running from creation until close(): tasks may be
+    created from request handlers directly, while run_forever() and
+    run_until_complete() are refused since libuv does the running.
+    """
+
+    def __init__(self):
+        self._driver = LoopDriver(self._tick)
+        super().__init__(_LoopDriverSelector(self._driver))
+        self._thread_id = threading.get_ident()
+
+    def call_soon(self, callback, *args, context=None):
+        handle = super().call_soon(callback, *args, context=context)
+        self._driver.poke()
+        return handle
+
+    def call_at(self, when, callback, *args, context=None):
+        timer = super().call_at(when, callback, *args, context=context)
+        self._driver.poke()
+        return timer
+
+    def _tick(self) -> Optional[float]:
+        """Run one asyncio iteration; return seconds until the next is due"""
+        if self.is_closed():
+            return None
+
+        previous = events._get_running_loop()
+        events._set_running_loop(self)
+        try:
+            self._run_once()
+        finally:
+            events._set_running_loop(previous)
+
+        if self._ready:
+            return 0.0
+        if self._scheduled:
+            return max(self._scheduled[0]._when - self.time(), 0.0)
+        return None
+
+    def close(self):
+        if self.is_closed():
+            return
+        self._thread_id = None
+        try:
+            super().close()
+        finally:
+            self._driver.close()
+
+
+_local = threading.local()
+
+
+def get_event_loop() -> CatzillaEventLoop:
+    """Return the event loop of the calling I/O thread, creating it on first use"""
+    loop = getattr(_local, "loop", None)
+    if loop is None or loop._driver.closed:
+        # Also replaces the loop of a server loop that shut down
+        if loop is not None:
+            loop.close()
+        loop = CatzillaEventLoop()
+        _local.loop = loop
+    return loop
+
+
+def schedule_async_response(
+    coro: Coroutine[Any, Any, Any],
+    completion: Callable[[Any, Optional[BaseException]], None],
+) -> bool:
+    """Run a handler coroutine on the calling thread's event loop
+
+    Same contract as the asyncio-thread bridge: completion(result, None) or
+    completion(None, error) runs on the I/O thread once the coroutine ends.
+
+    Returns:
+        True once the coroutine is scheduled
+    """
+    task = get_event_loop().create_task(coro)
+
+    def on_done(done: "asyncio.Task") -> None:
+        if done.cancelled():
+            completion(None, RuntimeError("Async route was cancelled"))
+            return
+        error = done.exception()
+        if error is not None:
+            completion(None, error)
+        else:
+            completion(done.result(), None)
+
+    task.add_done_callback(on_done)
+    return True
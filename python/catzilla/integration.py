@@ -107,7 +107,7 @@ class DIRouteEnhancer:
 
         # Auto-discover dependencies if not provided
         if dependencies is None:
-            dependencies = self._discover_dependencies(route_func)
+            dependencies = self._discover_dependencies(route_func, sig)
 
         # Build parameter -> service mapping for Depends objects
         for param_name, param in sig.parameters.items():
@@ -142,15 +142,19 @@ class DIRouteEnhancer:
         di_route_handler._catzilla_param_dependencies = param_dependencies
         di_route_handler._catzilla_container = self.container
         di_route_handler._original_route_func = route_func
+        # Auto-validation inspects the wrapper next; spare it unwrapping again
+        di_route_handler.__signature__ = sig
 
         return di_route_handler
 
-    def _discover_dependencies(self, func: Callable) -> List[str]:
+    def _discover_dependencies(
+        self, func: Callable, sig: Optional[inspect.Signature] = None
+    ) -> List[str]:
         """Auto-discover dependencies from function signature and type hints"""
         dependencies = []
 
         try:
-            sig = inspect.signature(func)
+            sig = sig or inspect.signature(func)
             type_hints = get_type_hints(func)
 
             for param_name, param in sig.parameters.items():
@@ -7,7 +7,8 @@ management and organization.
 """
 
 import re
-from dataclasses import dataclass
+import uuid
+from dataclasses import dataclass, field
 from typing import Callable, Dict, List, Optional, Set, Tuple, Union
 
 from .types import Request, Response, RouteHandler
@@ -30,12 +31,81 @@ class Route:
     path: str
     handler: RouteHandler
     param_names: List[str]  # Names of path parameters
-    pattern: re.Pattern  # Compiled regex pattern for matching
+    regex: str  # Source of the fallback regex, compiled on first use
     overwrite: bool = False  # Whether this route can overwrite existing ones
     tags: List[str] = None  # Tags for API organization
     description: str = ""  # Route description
     metadata: Dict[str, any] = None  # Additional metadata
     middleware: List[Callable] = None  # Per-route middleware (NEW!)
+    param_types: Dict[str, tuple] = None  # name -> (type, min, max) of typed parameters
+    _pattern: Optional[re.Pattern] = field(default=None, init=False, repr=False, compare=False)
+
+    @property
+    def pattern(self) -> re.Pattern:
+        """Regex for the Python fallback matcher; routes the C router
+        matches never compile it"""
+        if self._pattern is None:
+            self._pattern = re.compile(self.regex)
+        return self._pattern
+
+
+# {name} or {name:type}, optionally bounded: {id:int(1,100)}, {slug:str(3,)}
+_PARAM_SEGMENT = re.compile(
+    r"\{([A-Za-z_][A-Za-z0-9_]*)(?::(str|int|uuid|path)(?:\((-?\d*),(-?\d*)\))?)?\}"
+)
+
+_PARAM_REGEX = {
+    "str": r"[^/]+",
+    "int": r"-?[0-9]+",
+    "uuid": r"[0-9a-fA-F]{8}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{12}",
+    "path": r".+",
+}
+
+
+def _compile_path(path: str) -> Tuple[str, List[str], Dict[str, tuple]]:
+    """Build the fallback regex source of a route path, mirroring the C
+    router's parameter types"""
+    parts = []
+    names = []
+    types = {}
+    position = 0
+    for segment in _PARAM_SEGMENT.finditer(path):
+        name, kind, low, high = segment.groups()
+        kind = kind or "str"
+        parts.append(re.escape(path[position : segment.start()]))
+        parts.append(f"(?P<{name}>{_PARAM_REGEX[kind]})")
+        names.append(name)
+        types[name] = (
+            kind,
+            int(low) if low else None,
+            int(high) if high else None,
+        )
+        position = segment.end()
+    parts.append(re.escape(path[position:]))
+    return f"^{''.join(parts)}$", names, types
+
+
+def _convert_path_params(
+    route: Route, raw: Dict[str, str]
+) -> Optional[Dict[str, object]]:
+    """Convert regex captures the way the C router does; None when a value
+    is out of bounds"""
+    params = {}
+    for name, value in raw.items():
+        kind, low, high = (route.param_types or {}).get(name, ("str", None, None))
+        if kind == "int":
+            converted = int(value)
+            measured = converted
+        elif kind == "uuid":
+            converted = uuid.UUID(value)
+            measured = len(value)
+        else:
+            converted = value
+            measured = len(value)
+        if (low is not None and measured < low) or (high is not None and measured > high):
+            return None
+        params[name] = converted
+    return params
 
 
 class RouteNode:
@@ -456,6 +526,7 @@ class CAcceleratedRouter:
 
     def __init__(self):
         self._routes: List[Route] = []  # Renamed to avoid conflict with routes() method
+        self._first_routes: Dict[Tuple[str, str], Route] = {}  # (method, path) -> first route
         self.route_map: Dict[int, Route] = {}  # route_id -> Route mapping
         self.next_route_id = 1
         self._c_routes_synced = False
@@ -487,19 +558,8 @@ class CAcceleratedRouter:
         # Normalize method to uppercase
         method = method.upper()
 
-        # Extract parameter names from path
-        param_names = []
-        pattern_str = path
-
-        # Find all {param} patterns and extract names
-        param_matches = re.findall(r"\{([^}]+)\}", path)
-        param_names = param_matches
-
-        # Convert path to regex pattern for Python fallback
-        pattern_str = re.escape(path)
-        pattern_str = re.sub(r"\\{([^}]+)\\}", r"(?P<\1>[^/]+)", pattern_str)
-        pattern_str = f"^{pattern_str}$"
-        pattern = re.compile(pattern_str)
+        # Parameter names and types, and the regex for the Python fallback
+        regex, param_names, param_types = _compile_path(path)
 
         # Create Python route object
         route = Route(
@@ -507,28 +567,26 @@ class CAcceleratedRouter:
             path=path,
             handler=handler,
             param_names=param_names,
-            pattern=pattern,
+            regex=regex,
             overwrite=overwrite,
             tags=metadata.get("tags"),
             description=metadata.get("description", ""),
             metadata=metadata,
             middleware=middleware,  # Store per-route middleware
+            param_types=param_types,
         )
 
         # Check for conflicts if not overwriting
-        if not overwrite:
-            for existing_route in self._routes:
-                if existing_route.method == method and existing_route.path == path:
-                    if not existing_route.overwrite:
-                        import warnings
-
-                        warnings.warn(
-                            f"Route conflict: {method} {path} already exists. "
-                            f"Use overwrite=True to replace it.",
-                            UserWarning,
-                            stacklevel=3,
-                        )
-                    break
+        existing_route = self._first_routes.setdefault((method, path), route)
+        if not overwrite and existing_route is not route and not existing_route.overwrite:
+            import warnings
+
+            warnings.warn(
+                f"Route conflict: {method} {path} already exists. "
+                f"Use overwrite=True to replace it.",
+                UserWarning,
+                stacklevel=3,
+            )
 
         # Assign unique route ID
         route_id = self.next_route_id
@@ -635,20 +693,14 @@ class CAcceleratedRouter:
 
         for route_method, routes in path_routes_by_method.items():
             for route in routes:
-                # Convert route path to regex
-                pattern = route.path
-                # Replace {param} with regex groups
-                pattern = re.sub(r"\{([^}]+)\}", r"(?P<\1>[^/]+)", pattern)
-                pattern = f"^{pattern}$"
-
-                match = re.match(pattern, path)
-                if match:
+                match = route.pattern.match(path)
+                path_params = _convert_path_params(route, match.groupdict()) if match else None
+                if path_params is not None:
                     path_exists = True
                     allowed_methods.add(route_method)
 
                     if route_method == method:
                         # Method and path match
-                        path_params = match.groupdict()
                         return route, path_params, None
 
         if path_exists:
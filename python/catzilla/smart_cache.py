@@ -6,9 +6,11 @@ This module provides Python bindings for the C-level cache engine and implements
 a comprehensive multi-level caching system with Redis and disk fallback.
 """
 
+import asyncio
 import ctypes
 import hashlib
 import json
+import logging
 import os
 import pickle
 import time
@@ -25,8 +27,8 @@ from ctypes import (
     c_void_p,
 )
 from dataclasses import dataclass
-from threading import Lock
-from typing import Any, Dict, List, Optional, Tuple, Union
+from threading import Event, Lock
+from typing import Any, Callable, Dict, List, Optional, Tuple, Union
 
 try:
     import redis
@@ -192,6 +194,10 @@ class SmartCacheConfig:
     disk_ttl: int = 604800  # 7 days
     disk_max_size: int = 1024 * 1024 * 1024  # 1GB
 
+    # Request coalescing
+    stale_ttl: int = 0  # Seconds a value is served stale while it refreshes
+    fill_timeout: float = 10.0  # Seconds callers wait on another's computation
+
     # General Settings
     enable_stats: bool = True
     stats_collection_interval: int = 60  # seconds
@@ -211,6 +217,9 @@ class CacheStats:
     size: int = 0
     capacity: int = 0
     tier_stats: Dict[str, Dict[str, int]] = None
+    coalesced: int = 0  # Misses that waited for another caller's value
+    stale_hits: int = 0  # Stale values served while refreshing
+    refreshes: int = 0  # Background refreshes started
 
 
 # ============================================================================
@@ -242,6 +251,74 @@ class CacheValueError(CacheError):
     pass
 
 
+# ============================================================================
+# Request Coalescing
+# ============================================================================
+
+
+class _StaleEntry:
+    """Stored value that goes stale before its tiers expire it"""
+
+    __slots__ = ("value", "fresh_until")
+
+    def __init__(self, value: Any, fresh_until: float):
+        self.value = value
+        self.fresh_until = fresh_until
+
+    def __getstate__(self):
+        return (self.value, self.fresh_until)
+
+    def __setstate__(self, state):
+        self.value, self.fresh_until = state
+
+    def is_stale(self) -> bool:
+        return time.time() > self.fresh_until
+
+
+def _unwrap(value: Any) -> Any:
+    return value.value if isinstance(value, _StaleEntry) else value
+
+
+def _resolve_waiter(future: "asyncio.Future") -> None:
+    if not future.done():
+        future.set_result(None)
+
+
+class _Flight:
+    """One computation of a key that concurrent callers wait on"""
+
+    __slots__ = ("started", "_done", "_lock", "_waiters")
+
+    def __init__(self):
+        self.started = time.monotonic()
+        self._done = Event()
+        self._lock = Lock()
+        self._waiters = []  # (loop, future) of coroutines waiting
+
+    def finish(self) -> None:
+        with self._lock:
+            self._done.set()
+            waiters, self._waiters = self._waiters, []
+        for loop, future in waiters:
+            loop.call_soon_threadsafe(_resolve_waiter, future)
+
+    def wait(self, timeout: float) -> bool:
+        return self._done.wait(timeout)
+
+    async def wait_async(self, timeout: float) -> bool:
+        loop = asyncio.get_running_loop()
+        future = loop.create_future()
+        with self._lock:
+            if self._done.is_set():
+                return True
+            self._waiters.append((loop, future))
+        try:
+            await asyncio.wait_for(future, timeout)
+            return True
+        except asyncio.TimeoutError:
+            return False
+
+
 # ============================================================================
 # Memory Cache (C-Level)
 # ============================================================================
@@ -652,6 +729,11 @@ class SmartCache:
         self._disk_cache = None
         self._lock = Lock()
 
+        # Keys being computed, so concurrent misses compute once
+        self._flights: Dict[str, _Flight] = {}
+        self._flights_lock = Lock()
+        self._coalescing = {"coalesced": 0, "stale_hits": 0, "refreshes": 0}
+
         # Initialize cache tiers
         self._init_caches()
 
@@ -736,8 +818,25 @@ class SmartCache:
         else:
             return f"{method}:{path}:{headers_hash:08x}"
 
-    def set(self, key: str, value: Any, ttl: Optional[int] = None) -> bool:
-        """Store value in all available cache tiers"""
+    def set(
+        self,
+        key: str,
+        value: Any,
+        ttl: Optional[int] = None,
+        stale_ttl: Optional[int] = None,
+    ) -> bool:
+        """Store value in all available cache tiers
+
+        With a stale_ttl the value stays in the tiers that much longer than
+        its TTL, and get_or_set serves it stale while one caller refreshes it.
+        """
+        if stale_ttl is None:
+            stale_ttl = self.config.stale_ttl
+        if stale_ttl > 0:
+            fresh = ttl or self.config.memory_ttl
+            value = _StaleEntry(value, time.time() + fresh)
+            ttl = fresh + stale_ttl
+
         success = False
 
         # Store in memory cache first
@@ -759,6 +858,17 @@ class SmartCache:
 
     def get(self, key: str) -> Tuple[Any, bool]:
         """Retrieve value from cache tiers (L1 -> L2 -> L3)"""
+        value, found = self._get_stored(key)
+        return _unwrap(value), found
+
+    def lookup(self, key: str) -> Tuple[Any, bool, bool]:
+        """Retrieve a value and whether it is past its TTL but still served"""
+        value, found = self._get_stored(key)
+        stale = isinstance(value, _StaleEntry) and value.is_stale()
+        return _unwrap(value), found, stale
+
+    def _get_stored(self, key: str) -> Tuple[Any, bool]:
+        """Retrieve a value as stored, promoting it to the faster tiers"""
         # Try memory cache first (L1)
         if self._memory_cache:
             value, found = self._memory_cache.get(key)
@@ -796,6 +906,113 @@ class SmartCache:
 
         return None, False
 
+    def claim(self, key: str) -> Tuple[bool, _Flight]:
+        """Claim the computation of a key.
+
+        Returns (True, flight) to the caller that must compute the value and
+        then call release(key, flight), stored or not; everyone else gets
+        (False, flight) and waits on it. A claim older than fill_timeout is
+        taken over, so a caller that never releases cannot stall the key.
+        """
+        with self._flights_lock:
+            flight = self._flights.get(key)
+            if (
+                flight is not None
+                and time.monotonic() - flight.started < self.config.fill_timeout
+            ):
+                return False, flight
+            lapsed = flight
+            flight = _Flight()
+            self._flights[key] = flight
+        if lapsed is not None:
+            lapsed.finish()
+        return True, flight
+
+    def release(self, key: str, flight: _Flight) -> None:
+        """End a claim and wake the callers waiting on it"""
+        with self._flights_lock:
+            if self._flights.get(key) is flight:
+                del self._flights[key]
+        flight.finish()
+
+    def note_coalesced(self) -> None:
+        """Count a miss that was answered by another caller's computation"""
+        self._coalescing["coalesced"] += 1
+
+    def note_stale_hit(self) -> None:
+        """Count a stale value served while it refreshes"""
+        self._coalescing["stale_hits"] += 1
+
+    def get_or_set(
+        self,
+        key: str,
+        compute: Callable[[], Any],
+        ttl: Optional[int] = None,
+        stale_ttl: Optional[int] = None,
+    ) -> Any:
+        """Return the cached value, computing it once however many callers miss.
+
+        The first caller to miss runs compute while the others wait for its
+        result. A value past its TTL but within stale_ttl is returned at once,
+        and one refresh runs in the background task engine.
+        """
+        waited = False
+        while True:
+            value, found, stale = self.lookup(key)
+            if found:
+                if waited:
+                    self.note_coalesced()
+                if stale:
+                    self.note_stale_hit()
+                    self._refresh_in_background(key, compute, ttl, stale_ttl)
+                return value
+
+            leader, flight = self.claim(key)
+            if leader:
+                try:
+                    value = compute()
+                    self.set(key, value, ttl, stale_ttl)
+                    return value
+                finally:
+                    self.release(key, flight)
+
+            # The claimer failed or stored nothing; the next round claims
+            if not flight.wait(self.config.fill_timeout):
+                return compute()
+            waited = True
+
+    def _refresh_in_background(
+        self,
+        key: str,
+        compute: Callable[[], Any],
+        ttl: Optional[int],
+        stale_ttl: Optional[int],
+    ) -> None:
+        """Recompute a stale value in the task engine, once per key"""
+        leader, flight = self.claim(key)
+        if not leader:
+            return
+
+        def refresh():
+            try:
+                self.set(key, compute(), ttl, stale_ttl)
+            except Exception as e:
+                logging.warning(f"Cache refresh of {key!r} failed: {e}")
+            finally:
+                self.release(key, flight)
+
+        try:
+            from .background_tasks import TaskPriority, get_global_task_system
+
+            get_global_task_system().add_task(
+                refresh, priority=TaskPriority.LOW, max_retries=0
+            )
+            self._coalescing["refreshes"] += 1
+        except Exception as e:
+            # A full queue leaves the claim to lapse; anything else frees it now
+            logging.warning(f"Cannot schedule cache refresh of {key!r}: {e}")
+            self.release(key, flight)
+
     def delete(self, key: str) -> bool:
         """Delete key from all cache tiers"""
         results = []
@@ -843,6 +1060,7 @@ class SmartCache:
                 "disk": {"hits": 0, "misses": 0},
             }
         )
+        self._coalescing = {"coalesced": 0, "stale_hits": 0, "refreshes": 0}
 
     def get_stats(self) -> CacheStats:
         """Get comprehensive cache statistics"""
@@ -859,6 +1077,10 @@ class SmartCache:
             stats.size += memory_stats.size
             stats.capacity = memory_stats.capacity
 
+        stats.coalesced = self._coalescing["coalesced"]
+        stats.stale_hits = self._coalescing["stale_hits"]
+        stats.refreshes = self._coalescing["refreshes"]
+
         # Calculate overall hit ratio
         if stats.total_requests > 0:
             stats.hit_ratio = stats.hits / stats.total_requests
@@ -928,8 +1150,12 @@ def reset_cache():
 # ============================================================================
 
 
-def cached(ttl: int = 3600, key_prefix: str = ""):
-    """Decorator for caching function results"""
+def cached(ttl: int = 3600, key_prefix: str = "", stale_ttl: int = 0):
+    """Decorator for caching function results
+
+    Concurrent calls that miss run the function once; with a stale_ttl an
+    expired result keeps being returned while it refreshes in the background.
+    """
 
     def decorator(func):
         def wrapper(*args, **kwargs):
@@ -937,18 +1163,9 @@ def cached(ttl: int = 3600, key_prefix: str = ""):
             key_data = f"{key_prefix}{func.__name__}:{str(args)}:{str(kwargs)}"
             key = hashlib.md5(key_data.encode()).hexdigest()
 
-            # Try to get from cache
-            cache = get_cache()
-            value, found = cache.get(key)
-
-            if found:
-                return value
-
-            # Execute function and cache result
-            result = func(*args, **kwargs)
-            cache.set(key, result, ttl)
-
-            return result
+            return get_cache().get_or_set(
+                key, lambda: func(*args, **kwargs), ttl, stale_ttl
+            )
 
         return wrapper
 
@@ -73,6 +73,7 @@ def _unregister_streaming_response(streaming_id: str) -> None:
 
 # Make registry functions accessible for C extension
 __all__ = [
+    "EventHub",
     "StreamingResponse",
     "StreamingWriter",
     "stream_template",
@@ -404,6 +405,78 @@ class StreamingWriter(io.StringIO):
             super().close()
 
 
+class EventHub:
+    """
+    Server-sent events broadcast to every connection that subscribed.
+
+    Each published event is formatted once in C and the same buffer is
+    written to all subscribers, on whichever event loop they live. A
+    subscriber whose unsent bytes pass ``queue_limit`` is disconnected
+    rather than buffered for.
+
+    Example:
+        ```python
+        prices = EventHub()
+
+        @app.get("/prices")
+        def subscribe(request):
+            return prices.subscribe()
+
+        # From any handler or thread
+        prices.publish(json.dumps(quote), event="quote")
+        ```
+    """
+
+    def __init__(self, queue_limit: int = 256 * 1024):
+        """
+        Args:
+            queue_limit: Unsent bytes a subscriber may fall behind by
+        """
+        if not _HAS_C_STREAMING or not hasattr(_catzilla_streaming, "sse_hub_create"):
+            raise RuntimeError("EventHub requires the Catzilla C extension")
+        self._hub = _catzilla_streaming.sse_hub_create(queue_limit)
+
+    def publish(
+        self,
+        data: Union[str, bytes],
+        event: Optional[str] = None,
+        id: Optional[str] = None,
+    ) -> None:
+        """
+        Send an event to every current subscriber.
+
+        Args:
+            data: Event data; line breaks split it over several data lines
+            event: Event type (``message`` when omitted)
+            id: Event ID clients report in Last-Event-ID when reconnecting
+        """
+        _catzilla_streaming.sse_publish(self._hub, data, event=event, id=id)
+
+    def subscribe(self, headers: Optional[Dict[str, str]] = None) -> StreamingResponse:
+        """
+        Response that subscribes the requesting connection to this hub.
+
+        Args:
+            headers: Additional HTTP headers
+
+        Returns:
+            A text/event-stream StreamingResponse to return from the handler
+        """
+        stream_headers = {"cache-control": "no-cache"}
+        if headers:
+            stream_headers.update(headers)
+        response = StreamingResponse(
+            content=[], content_type="text/event-stream", headers=stream_headers
+        )
+        response._sse_hub = self._hub
+        return response
+
+    @property
+    def stats(self) -> Dict[str, int]:
+        """Subscribers, and counts of events published, written and subscribers dropped."""
+        return _catzilla_streaming.sse_hub_stats(self._hub)
+
+
 def stream_template(template: str, **context) -> StreamingResponse:
     """
     Stream a template response.
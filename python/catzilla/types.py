@@ -19,7 +19,7 @@ class Request:
     body: str
     client: Any  # The client capsule from C
     request_capsule: Any  # The request capsule from C
-    headers: Dict[str, str] = None
+    headers: Dict[str, str] = None  # Loaded lazily from the C request (see below)
     _query_params: Dict[str, str] = None  # Internal storage for query params
     _path_params: Dict[str, str] = None  # Internal storage for path params
     _client_ip: Optional[str] = None
@@ -28,19 +28,16 @@ class Request:
     _json: Optional[Any] = None
     _content_type: Optional[str] = None
     _files: Optional[Dict[str, Any]] = None
+    _body_file: Optional[tuple] = None
     _loaded_query_params: bool = False
+    _headers = None  # Not a field: backing store of the headers property
 
     def __post_init__(self):
-        if self.headers is None:
-            self.headers = {}
         if self._query_params is None:
             self._query_params = {}
         if self._path_params is None:
             self._path_params = {}
 
-        # Normalize header keys to lowercase for consistent access
-        self.headers = {k.lower(): v for k, v in self.headers.items()}
-
     @property
     def path_params(self) -> Dict[str, str]:
         """Get path parameters extracted from the URL"""
@@ -320,6 +317,30 @@ class Request:
                 self._files = {}
         return self._files
 
+    @property
+    def body_file(self) -> Optional[str]:
+        """Path of the temp file holding a spooled body (routes in "spool" mode).
+
+        The file is removed once the next request on the connection starts or the
+        connection closes; read or move it inside the handler.
+        """
+        if self._body_file is None:
+            try:
+                from catzilla._catzilla import get_body_file
+
+                self._body_file = get_body_file(self.request_capsule) or ()
+            except Exception as e:
+                log_types_error("Error getting body file from C: %s", e)
+                self._body_file = ()
+        return self._body_file[0] if self._body_file else None
+
+    @property
+    def body_file_size(self) -> int:
+        """Size in bytes of a spooled body, 0 when the body is in memory"""
+        if self.body_file is None:
+            return 0
+        return self._body_file[1]
+
     def get_header(self, name: str) -> Optional[str]:
         """Get a request header by name using lazy loading from C"""
         try:
@@ -339,6 +360,26 @@ class Request:
         """Get all request headers as a dictionary"""
         return {k.lower(): v for k, v in self.headers.items()}
 
+def _request_headers(self) -> Dict[str, str]:
+    """Request headers with lowercase names, built from C on first access"""
+    if self._headers is None:
+        native_headers = getattr(self.request_capsule, "headers", None)
+        self._headers = native_headers if isinstance(native_headers, dict) else {}
+    return self._headers
+
+
+def _set_request_headers(self, value: Optional[Dict[str, str]]):
+    # None keeps the lazy C-backed headers; a dict replaces them
+    if value is None:
+        self._headers = None
+    else:
+        # Normalize header keys to lowercase for consistent access
+        self._headers = {k.lower(): v for k, v in value.items()}
+
+
+# Installed after @dataclass so the generated __init__ goes through the setter
+Request.headers = property(_request_headers, _set_request_headers)
+
 
 class Response:
     """Base HTTP Response class"""
@@ -431,21 +472,15 @@ class Response:
         cookie_str = morsel.output(header="").strip()
         self.set_header("Set-Cookie", cookie_str)
 
-    def send(self, client):
-        """Send the response using the C extension"""
-        from catzilla._catzilla import send_response
+    def _header_block(self, body_length: Optional[int]) -> str:
+        """Format Content-Type, Content-Length and custom headers for the C side
 
-        # Calculate body length in bytes for Content-Length header
-        body_bytes = (
-            self.body.encode("utf-8") if isinstance(self.body, str) else self.body
-        )
-        body_length = len(body_bytes) if body_bytes else 0
-
-        # Build properly formatted headers including Content-Type and all custom headers
-        headers = [
-            f"Content-Type: {self.content_type}",
-            f"Content-Length: {body_length}",
-        ]
+        Content-Length is left out when body_length is None; the C send path
+        then adds it for the body it writes.
+        """
+        headers = [f"Content-Type: {self.content_type}"]
+        if body_length is not None:
+            headers.append(f"Content-Length: {body_length}")
 
         # Add all custom headers
         for name, value in self._headers.items():
@@ -462,18 +497,41 @@ class Response:
                 headers.append(f"{name.title()}: {value}")
 
         # Join headers with proper HTTP line endings
-        headers_str = "\r\n".join(headers) + "\r\n" if headers else ""
+        return "\r\n".join(headers) + "\r\n"
+
+    def send(self, client):
+        """Send the response using the C extension"""
+        from catzilla._catzilla import send_response
+
+        # Calculate body length in bytes for Content-Length header
+        body_bytes = (
+            self.body.encode("utf-8") if isinstance(self.body, str) else self.body
+        )
+        body_length = len(body_bytes) if body_bytes else 0
 
-        # Send response with formatted headers
-        # Convert body to string for C interface
-        body_str = (
-            body_bytes.decode("utf-8") if isinstance(body_bytes, bytes) else self.body
+        # Send response with formatted headers; the C side accepts bytes and
+        # writes large bodies straight from this object without copying
+        send_response(
+            client, self.status_code, self._header_block(body_length), body_bytes or b""
         )
-        send_response(client, self.status_code, headers_str, body_str)
+
+
+def _dumps_json(data: Any) -> str:
+    """Compact JSON text, from the C serializer when the extension is built"""
+    try:
+        from catzilla._catzilla import json_dumps
+    except ImportError:
+        return json.dumps(data, separators=(",", ":"), ensure_ascii=False)
+    return json_dumps(data).decode("utf-8")
 
 
 class JSONResponse(Response):
-    """HTTP Response with JSON body"""
+    """HTTP Response with JSON body
+
+    The data is serialized when the response is sent, in C and straight into
+    the buffer that is written to the socket. Reading ``body`` serializes it
+    to a str instead (and that str is what gets sent afterwards).
+    """
 
     def __init__(
         self,
@@ -488,13 +546,34 @@ class JSONResponse(Response):
         # Ensure content type is set
         headers["Content-Type"] = "application/json"
 
+        self.data = data
         super().__init__(
             status_code=status_code,
             content_type="application/json",
-            body=json.dumps(data, separators=(",", ":"), ensure_ascii=False),
+            body=None,
             headers=headers,
         )
 
+    @property
+    def body(self) -> str:
+        if self._body is None:
+            self._body = _dumps_json(self.data)
+        return self._body
+
+    @body.setter
+    def body(self, value) -> None:
+        self._body = value
+
+    def send(self, client):
+        """Send the response, serializing data in C when body was not read"""
+        if self._body is not None:
+            return super().send(client)
+        from catzilla._catzilla import send_json_response
+
+        send_json_response(
+            client, self.status_code, self._header_block(None), self.data
+        )
+
 
 class HTMLResponse(Response):
     """HTTP Response with HTML body"""
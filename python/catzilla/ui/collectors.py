@@ -197,6 +197,12 @@ class ServerInfoCollector:
 
     def _get_version(self) -> str:
         """Get Catzilla version"""
+        # The package's own version needs no scan of installed distributions
+        import catzilla
+
+        if getattr(catzilla, "__version__", None):
+            return catzilla.__version__
+
         try:
             # Try to get version from importlib.metadata (Python 3.8+)
             from importlib.metadata import version
@@ -119,6 +119,10 @@ class CatzillaUploadFile:
         self._virus_scanned = False
         self._virus_scan_result = None
 
+        # Digests the server computed while the file arrived (see App.upload_options)
+        self._sha256 = None
+        self._crc32c = None
+
         # Initialize C-native upload file if available
         if _C_UPLOAD_AVAILABLE:
             self._c_file_handle = upload_file_create(filename, content_type)
@@ -485,6 +489,16 @@ class CatzillaUploadFile:
         """Get virus scan result with detailed information."""
         return self._virus_scan_result
 
+    @property
+    def sha256(self) -> Optional[str]:
+        """Hex SHA-256 of the file, when the server was asked to compute it."""
+        return self._sha256
+
+    @property
+    def crc32c(self) -> Optional[int]:
+        """CRC32C of the file, when the server was asked to compute it."""
+        return self._crc32c
+
     def finalize(self):
         """Mark the upload as complete and finalized."""
         if self._c_file_handle and _C_UPLOAD_AVAILABLE:
@@ -19,8 +19,10 @@ Example usage:
         tags: List[str] = Field(max_items=10)
 """
 
+import datetime
 import gc
 import inspect
+import re
 import sys
 from typing import (
     Any,
@@ -92,6 +94,58 @@ __all__ = [
     "reset_performance_stats",
 ]
 
+# Python mirrors of the C format matchers in src/core/pattern.c. A request the
+# C validator rejects is validated again here, so these must not be looser.
+_HOSTNAME_LABEL = r"[A-Za-z0-9](?:[A-Za-z0-9-]{0,61}[A-Za-z0-9])?"
+_STRING_FORMATS = {
+    "email": re.compile(
+        r"[A-Za-z0-9!#$%&'*+/=?^_`{|}~-]+(?:\.[A-Za-z0-9!#$%&'*+/=?^_`{|}~-]+)*"
+        rf"@{_HOSTNAME_LABEL}(?:\.{_HOSTNAME_LABEL})+"
+    ),
+    "uuid": re.compile(
+        r"[0-9A-Fa-f]{8}-[0-9A-Fa-f]{4}-[0-9A-Fa-f]{4}-[0-9A-Fa-f]{4}-[0-9A-Fa-f]{12}"
+    ),
+    "datetime": re.compile(
+        r"([0-9]{4})-([0-9]{2})-([0-9]{2})[Tt ]([0-9]{2}):([0-9]{2})"
+        r"(?::([0-9]{2})(?:\.[0-9]{1,9})?)?"
+        r"(?:[Zz]|[+-]([0-9]{2}):([0-9]{2}))?"
+    ),
+    "url": re.compile(
+        r"[Hh][Tt][Tt][Pp][Ss]?://(?:[A-Za-z0-9\-._~!$&'()*+,;=:%]*@)?"
+        rf"({_HOSTNAME_LABEL}(?:\.{_HOSTNAME_LABEL})*|\[[0-9A-Fa-f:.]+\])"
+        r"(?::([0-9]{1,5}))?(?:[/?#][^\x00-\x20\x7f]*)?"
+    ),
+    "digits": re.compile(r"[0-9]+"),
+}
+
+
+def _matches_string_format(fmt, value):
+    """Check value against a built-in string format"""
+    match = _STRING_FORMATS[fmt].fullmatch(value)
+    if not match:
+        return False
+
+    if fmt == "email":
+        local, _, domain = value.rpartition("@")
+        return len(value) <= 254 and len(local) <= 64 and len(domain) <= 253
+    if fmt == "datetime":
+        year, month, day, hour, minute, second, offset_hour, offset_minute = (
+            int(group) if group is not None else 0 for group in match.groups()
+        )
+        if offset_hour > 23 or offset_minute > 59 or second > 59:
+            return False
+        try:
+            datetime.datetime(year, month, day, hour, minute, second)
+        except ValueError:
+            return False
+        return True
+    if fmt == "url":
+        host, port = match.groups()
+        if not host.startswith("[") and len(host) > 253:
+            return False
+        return port is None or int(port) <= 65535
+    return True
+
 
 class ValidationError(ValueError):
     """Validation error compatible with Pydantic ValidationError"""
@@ -108,12 +162,14 @@ class Field:
     - min_length, max_length (strings)
     - min_items, max_items (lists)
     - regex (strings)
+    - format (strings): "email", "uuid", "datetime", "url" or "digits"
     - default (default values)
     - description (field documentation)
 
     Example usage:
         # Basic usage
         name: str = Field(min_length=3, max_length=50)
+        email: str = Field(format="email")
         age: int = Field(ge=18, le=120)
         score: float = Field(gt=0.0, lt=100.0)
         tags: List[str] = Field(min_items=1, max_items=10)
@@ -134,6 +190,7 @@ class Field:
         min_length=None,
         max_length=None,
         regex=None,
+        format=None,
         # Numeric constraints (FastAPI compatible names)
         gt=None,  # greater than
         ge=None,  # greater than or equal
@@ -160,6 +217,11 @@ class Field:
         self.min_length = min_length
         self.max_length = max_length
         self.regex = regex
+        if format is not None and format not in _STRING_FORMATS:
+            raise ValueError(
+                f"Unknown string format '{format}', expected one of {sorted(_STRING_FORMATS)}"
+            )
+        self.format = format
 
         # Numeric constraints (FastAPI compatible names)
         self.gt = gt  # greater than
@@ -268,7 +330,10 @@ class Field:
     def _create_string_validator(self):
         """Create string validator with FastAPI-compatible constraints"""
         return create_string_validator(
-            min_len=self.min_length, max_len=self.max_length, pattern=self.regex
+            min_len=self.min_length,
+            max_len=self.max_length,
+            pattern=self.regex,
+            format=self.format,
         )
 
     def _create_float_validator(self):
@@ -361,6 +426,8 @@ class Field:
 
                 if not re.match(self.regex, value):
                     raise ValidationError(f"String does not match pattern {self.regex}")
+            if self.format is not None and not _matches_string_format(self.format, value):
+                raise ValidationError(f"String is not a valid {self.format}")
 
         elif field_type == float or field_type is float:
             if not isinstance(value, (int, float)):
@@ -711,6 +778,93 @@ class BaseModel(metaclass=BaseModelMeta):
             if gc_was_enabled:
                 gc.enable()
 
+    @classmethod
+    def validate_many(cls, items, stop_on_first_error=False):
+        """
+        Validate a list of records, such as the body of a bulk-ingest endpoint
+
+        Records are validated in C, split across the background task engine's
+        workers when it is running. Records the C validator rejects are
+        validated again in Python, which reports the definitive errors.
+
+        Args:
+            items: List of dictionaries to validate
+            stop_on_first_error: Raise for the first invalid record instead of
+                collecting the errors of all of them
+
+        Returns:
+            List of validated/coerced dictionaries, in input order
+
+        Raises:
+            ValidationError: If any record is invalid, naming its index
+        """
+        items = list(items)
+        results = [None] * len(items)
+
+        validate_batch = getattr(getattr(cls, "_c_model", None), "validate_batch", None)
+        if validate_batch is not None:
+            try:
+                results, _ = validate_batch(
+                    [
+                        cls._preprocess_for_c_validation(item)
+                        if isinstance(item, dict)
+                        else item
+                        for item in items
+                    ],
+                    stop_on_first_error=stop_on_first_error,
+                )
+            except (TypeError, ValueError):
+                results = [None] * len(items)
+
+        errors = []
+        for index, result in enumerate(results):
+            if result is not None:
+                continue
+            try:
+                if not isinstance(items[index], dict):
+                    raise ValidationError(
+                        f"Expected dict, got {type(items[index]).__name__}"
+                    )
+                results[index] = cls.validate(items[index])
+            except ValidationError as e:
+                if stop_on_first_error:
+                    raise ValidationError(f"Item {index}: {e}") from e
+                errors.append(f"Item {index}: {e}")
+
+        if errors:
+            raise ValidationError("; ".join(errors))
+        return results
+
+    @classmethod
+    def from_request(cls, request):
+        """
+        Build a model instance from a request's JSON body
+
+        Validates the document the C server already parsed and fills the
+        instance in the same pass, without building an intermediate dict.
+        Falls back to ``cls(**request.json())`` when that is not possible,
+        so Python validation reports the definitive error.
+        """
+        c_model = getattr(cls, "_c_model", None)
+        capsule = getattr(request, "request_capsule", None)
+        validate_request = getattr(c_model, "validate_request", None)
+
+        if validate_request is not None and capsule is not None:
+            instance = cls.__new__(cls)
+            try:
+                filled = validate_request(capsule, instance.__dict__)
+            except (TypeError, ValueError):
+                filled = None
+
+            if filled is not None:
+                if hasattr(instance, "__post_init__") and callable(
+                    getattr(instance, "__post_init__")
+                ):
+                    instance.__post_init__()
+                return instance
+
+        return cls(**request.json())
+
     @classmethod
     def _validate_python(cls, data):
         """Fallback Python validation (much slower but functional)"""
@@ -0,0 +1,52 @@
+#!/usr/bin/env bash
+# Run one of the bpftrace scripts against Catzilla's USDT probes
+#
+#   sudo scripts/bpftrace/run.sh [-p PID] request_phases.bt [script args...]
+#
+# The scripts name the probes as usdt:CATZILLA_LIB:catzilla:<probe>; the
+# placeholder is replaced by the _catzilla extension the Python on PATH
+# imports (set CATZILLA_LIB to pick another). With a PID only that process
+# is traced. The extension must be built with the probes: cmake reports
+# "USDT probes: ENABLED" when <sys/sdt.h> (systemtap-sdt-dev) was found.
+#
+# List the probes a build has with:
+#   readelf -n "$(python3 -c 'import catzilla._catzilla as c; print(c.__file__)')" | grep -A2 stapsdt
+
+set -euo pipefail
+
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
+
+pid_args=()
+if [ $# -ge 2 ] && [ "$1" = "-p" ]; then
+    pid_args=(-p "$2")
+    shift 2
+fi
+
+if [ $# -lt 1 ]; then
+    echo "usage: $0 [-p PID] SCRIPT.bt [script args...]" >&2
+    echo "scripts: $(cd "$SCRIPT_DIR" && ls *.bt | tr '\n' ' ')" >&2
+    exit 2
+fi
+
+script="$1"
+shift
+[ -f "$script" ] || script="$SCRIPT_DIR/$script"
+if [ ! -f "$script" ]; then
+    echo "no such script: $script" >&2
+    exit 2
+fi
+
+lib="${CATZILLA_LIB:-$(${PYTHON:-python3} -c 'import catzilla._catzilla as c; print(c.__file__)')}"
+if [ ! -f "$lib" ]; then
+    echo "cannot find the _catzilla extension (set CATZILLA_LIB)" >&2
+    exit 2
+fi
+if ! readelf -n "$lib" 2>/dev/null | grep -q 'Provider: catzilla'; then
+    echo "$lib has no catzilla USDT probes; rebuild with systemtap-sdt-dev installed" >&2
+    exit 2
+fi
+
+program="$(mktemp "${TMPDIR:-/tmp}/catzilla-XXXXXX.bt")"
+trap 'rm -f "$program"' EXIT
+sed "s|CATZILLA_LIB|$lib|g" "$script" > "$program"
+bpftrace ${pid_args[@]+"${pid_args[@]}"} "$program" "$@"
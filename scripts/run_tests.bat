@@ -366,7 +366,7 @@ if %errorlevel% neq 0 (
 
 REM List of C test executables to run
 echo %YELLOW%Identifying test executables...%NC%
-set test_executables=test_router test_advanced_router test_server_integration test_validation_engine test_dependency_injection test_middleware_minimal test_streaming
+set test_executables=test_router test_advanced_router test_server_integration test_validation_engine test_dependency_injection test_middleware_minimal test_streaming test_http_response test_read_buffer_pool test_http_headers test_hpack test_http2 test_timer_wheel test_tls test_disk_cache test_redis_client test_http_cache
 set all_passed=true
 
 REM Run each C test executable
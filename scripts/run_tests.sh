@@ -273,7 +273,7 @@ run_c_tests() {
     cmake --build build
 
     # List of C test executables to run
-    local test_executables=("test_router" "test_advanced_router" "test_server_integration" "test_validation_engine" "test_dependency_injection" "test_middleware_minimal" "test_streaming")
+    local test_executables=("test_router" "test_advanced_router" "test_server_integration" "test_validation_engine" "test_pattern" "test_dependency_injection" "test_dependency_plan" "test_dependency_pool" "test_middleware_minimal" "test_middleware_pipeline" "test_rate_limiter" "test_compression" "test_streaming" "test_sse_hub" "test_metrics" "test_access_log" "test_perf_counters" "test_websocket" "test_http_response" "test_read_buffer_pool" "test_request_arena" "test_urlencoded" "test_multipart_stream" "test_upload_digest" "test_task_engine" "test_task_log" "test_http_headers" "test_hpack" "test_http2" "test_timer_wheel" "test_tls" "test_disk_cache" "test_redis_client" "test_clamd_client" "test_http_cache" "test_handoff")
     local all_passed=true
 
     # Run each C test executable
@@ -0,0 +1,499 @@
+/*
+ * Catzilla Access Log
+ *
+ * Rings are single producer, single consumer: the loop thread owning a ring
+ * writes records at head, the writer thread (or a flush, under drain_lock)
+ * reads them at tail. Each side publishes its index with a sequentially
+ * consistent store after touching the slots, so the other side never sees
+ * an index ahead of the slot it covers. Rings live until the log closes.
+ */
+
+#include "access_log.h"
+#include "logging.h"
+#include "platform_atomic.h"
+#include "platform_compat.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <uv.h>
+
+#define ACCESS_LOG_BATCH_BYTES (64 * 1024)
+#define ACCESS_LOG_LINE_MAX 2048  // Fits a record with every byte escaped
+#define ACCESS_LOG_ALWAYS (1ULL << 32)  // Sample threshold letting every request through
+
+typedef struct access_ring_s {
+    catzilla_atomic_uint64_t head;      // Next slot the loop fills
+    char head_pad[56];
+    catzilla_atomic_uint64_t tail;      // Next slot the writer reads
+    char tail_pad[56];
+    catzilla_atomic_uint64_t dropped;   // Written by the loop only
+    uint64_t mask;
+    uv_thread_t owner;
+    struct access_ring_s* next;
+    catzilla_access_record_t records[];
+} access_ring_t;
+
+struct catzilla_access_log_s {
+    catzilla_access_log_config_t config;
+    uint64_t id;
+    uv_file fd;
+    bool owns_fd;
+
+    // hrtime of the open and the wall clock at that moment, for timestamps
+    uint64_t base_hrtime_ns;
+    uint64_t base_wall_us;
+
+    // Sample thresholds out of 2^32; route entries hold threshold + 1, 0 = default
+    uint64_t default_threshold;
+    uint64_t* route_thresholds;
+    uint32_t route_capacity;
+
+    uv_mutex_t rings_lock;
+    access_ring_t* rings;
+    uint64_t ring_count;
+
+    // One drain at a time: the writer thread or catzilla_access_log_flush
+    uv_mutex_t drain_lock;
+    char* batch;
+    catzilla_atomic_uint64_t written;
+    catzilla_atomic_uint64_t write_errors;
+
+    uv_thread_t thread;
+    uv_mutex_t wake_lock;
+    uv_cond_t wake;
+    bool thread_started;
+    bool stopping;
+};
+
+static catzilla_atomic_uint64_t next_log_id = 1;
+
+// The calling thread's ring in the log it appended to last
+static CATZILLA_THREAD_LOCAL access_ring_t* thread_ring;
+static CATZILLA_THREAD_LOCAL uint64_t thread_ring_log;
+static CATZILLA_THREAD_LOCAL uint64_t sample_state;
+
+// ---------------------------------------------------------------------------
+// Sampling
+// ---------------------------------------------------------------------------
+
+static uint64_t rate_threshold(double rate) {
+    if (!(rate > 0.0)) return 0;
+    if (rate >= 1.0) return ACCESS_LOG_ALWAYS;
+    return (uint64_t)(rate * (double)ACCESS_LOG_ALWAYS);
+}
+
+void catzilla_access_log_set_sample_rate(catzilla_access_log_t* log, double rate) {
+    if (log) log->default_threshold = rate_threshold(rate);
+}
+
+int catzilla_access_log_set_route_sample_rate(catzilla_access_log_t* log, uint32_t route_id, double rate) {
+    if (!log) return -1;
+    if (route_id >= log->route_capacity) {
+        uint32_t capacity = log->route_capacity ? log->route_capacity : 64;
+        while (capacity <= route_id) capacity *= 2;
+        uint64_t* grown = realloc(log->route_thresholds, capacity * sizeof(*grown));
+        if (!grown) return -1;
+        memset(grown + log->route_capacity, 0, (capacity - log->route_capacity) * sizeof(*grown));
+        log->route_thresholds = grown;
+        log->route_capacity = capacity;
+    }
+    log->route_thresholds[route_id] = rate_threshold(rate) + 1;
+    return 0;
+}
+
+// xorshift64*, seeded per thread
+static uint32_t sample_random(void) {
+    if (sample_state == 0) {
+        sample_state = uv_hrtime() ^ ((uint64_t)(uintptr_t)&sample_state << 16) ^ 0x9e3779b97f4a7c15ULL;
+    }
+    sample_state ^= sample_state >> 12;
+    sample_state ^= sample_state << 25;
+    sample_state ^= sample_state >> 27;
+    return (uint32_t)((sample_state * 0x2545f4914f6cdd1dULL) >> 32);
+}
+
+bool catzilla_access_log_sampled(catzilla_access_log_t* log, uint32_t route_id) {
+    if (!log) return false;
+    uint64_t threshold = log->default_threshold;
+    if (route_id < log->route_capacity && log->route_thresholds[route_id]) {
+        threshold = log->route_thresholds[route_id] - 1;
+    }
+    if (threshold >= ACCESS_LOG_ALWAYS) return true;
+    if (threshold == 0) return false;
+    return sample_random() < threshold;
+}
+
+// ---------------------------------------------------------------------------
+// Rings
+// ---------------------------------------------------------------------------
+
+static access_ring_t* current_ring(catzilla_access_log_t* log) {
+    if (thread_ring && thread_ring_log == log->id) return thread_ring;
+
+    uv_thread_t self = uv_thread_self();
+    uv_mutex_lock(&log->rings_lock);
+    access_ring_t* ring = log->rings;
+    while (ring && !uv_thread_equal(&ring->owner, &self)) ring = ring->next;
+    if (!ring) {
+        size_t records = log->config.ring_records;
+        ring = calloc(1, sizeof(*ring) + records * sizeof(catzilla_access_record_t));
+        if (ring) {
+            ring->mask = records - 1;
+            ring->owner = self;
+            ring->next = log->rings;
+            log->rings = ring;
+            log->ring_count++;
+        }
+    }
+    uv_mutex_unlock(&log->rings_lock);
+
+    if (ring) {
+        thread_ring = ring;
+        thread_ring_log = log->id;
+    }
+    return ring;
+}
+
+bool catzilla_access_log_append(catzilla_access_log_t* log, const catzilla_access_record_t* record) {
+    if (!log || !record) return false;
+    access_ring_t* ring = current_ring(log);
+    if (!ring) return false;
+
+    uint64_t head = catzilla_atomic_load(&ring->head);
+    uint64_t tail = catzilla_atomic_load_seq(&ring->tail);
+    if (head - tail > ring->mask) {
+        catzilla_atomic_store(&ring->dropped, catzilla_atomic_load(&ring->dropped) + 1);
+        return false;
+    }
+    memcpy(&ring->records[head & ring->mask], record, sizeof(*record));
+    catzilla_atomic_store_seq(&ring->head, head + 1);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Formatting
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    char* data;
+    size_t length;
+    size_t capacity;
+    bool overflow;
+} line_t;
+
+static void put(line_t* line, const char* data, size_t length) {
+    if (line->overflow || length > line->capacity - line->length) {
+        line->overflow = true;
+        return;
+    }
+    memcpy(line->data + line->length, data, length);
+    line->length += length;
+}
+
+static void put_str(line_t* line, const char* text) {
+    put(line, text, strlen(text));
+}
+
+static void put_u64(line_t* line, uint64_t value) {
+    char digits[24];
+    int length = snprintf(digits, sizeof(digits), "%llu", (unsigned long long)value);
+    put(line, digits, (size_t)length);
+}
+
+// JSON string contents; bytes outside printable ASCII are \u escaped
+static void put_json_escaped(line_t* line, const char* text) {
+    static const char hex[] = "0123456789abcdef";
+    for (const unsigned char* p = (const unsigned char*)text; *p; p++) {
+        if (*p == '"' || *p == '\\') {
+            char escaped[2] = {'\\', (char)*p};
+            put(line, escaped, 2);
+        } else if (*p < 0x20 || *p >= 0x7f) {
+            char escaped[6] = {'\\', 'u', '0', '0', hex[*p >> 4], hex[*p & 0xf]};
+            put(line, escaped, 6);
+        } else {
+            put(line, (const char*)p, 1);
+        }
+    }
+}
+
+// CLF request line contents; quotes and unprintable bytes as \xHH
+static void put_clf_escaped(line_t* line, const char* text) {
+    static const char hex[] = "0123456789abcdef";
+    for (const unsigned char* p = (const unsigned char*)text; *p; p++) {
+        if (*p == '"' || *p == '\\' || *p < 0x20 || *p >= 0x7f) {
+            char escaped[4] = {'\\', 'x', hex[*p >> 4], hex[*p & 0xf]};
+            put(line, escaped, 4);
+        } else {
+            put(line, (const char*)p, 1);
+        }
+    }
+}
+
+typedef struct {
+    int year;
+    unsigned month;  // 1-12
+    unsigned day;
+    unsigned hour;
+    unsigned minute;
+    unsigned second;
+    unsigned micros;
+} utc_time_t;
+
+// Civil date from days since the epoch (proleptic Gregorian)
+static utc_time_t utc_from_micros(uint64_t wall_us) {
+    utc_time_t t;
+    uint64_t seconds = wall_us / 1000000;
+    t.micros = (unsigned)(wall_us % 1000000);
+    int64_t days = (int64_t)(seconds / 86400);
+    unsigned of_day = (unsigned)(seconds % 86400);
+    t.hour = of_day / 3600;
+    t.minute = of_day / 60 % 60;
+    t.second = of_day % 60;
+
+    days += 719468;
+    int64_t era = days / 146097;
+    unsigned day_of_era = (unsigned)(days - era * 146097);
+    unsigned year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+    unsigned day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    unsigned mp = (5 * day_of_year + 2) / 153;
+    t.day = day_of_year - (153 * mp + 2) / 5 + 1;
+    t.month = mp < 10 ? mp + 3 : mp - 9;
+    t.year = (int)(year_of_era + era * 400) + (t.month <= 2);
+    return t;
+}
+
+size_t catzilla_access_log_format_record(catzilla_access_log_format_t format,
+                                         const catzilla_access_record_t* record,
+                                         uint64_t wall_us, char* out, size_t capacity) {
+    static const char* months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                   "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+    line_t line = {out, 0, capacity, false};
+    utc_time_t t = utc_from_micros(wall_us);
+    const char* remote = record->remote_addr[0] ? record->remote_addr : "-";
+    char scratch[64];
+    int length;
+
+    if (format == CATZILLA_ACCESS_LOG_CLF) {
+        put_clf_escaped(&line, remote);
+        length = snprintf(scratch, sizeof(scratch), " - - [%02u/%s/%04d:%02u:%02u:%02u +0000] \"",
+                          t.day, months[t.month - 1], t.year, t.hour, t.minute, t.second);
+        put(&line, scratch, (size_t)length);
+        put_clf_escaped(&line, record->method);
+        put_str(&line, " ");
+        put_clf_escaped(&line, record->target);
+        length = snprintf(scratch, sizeof(scratch), " HTTP/%u.%u\" %u ",
+                          record->http_major, record->http_minor, record->status);
+        put(&line, scratch, (size_t)length);
+        put_u64(&line, record->bytes);
+        put_str(&line, "\n");
+    } else {
+        length = snprintf(scratch, sizeof(scratch), "{\"time\":\"%04d-%02u-%02uT%02u:%02u:%02u.%06uZ\",\"remote\":\"",
+                          t.year, t.month, t.day, t.hour, t.minute, t.second, t.micros);
+        put(&line, scratch, (size_t)length);
+        put_json_escaped(&line, remote);
+        put_str(&line, "\",\"method\":\"");
+        put_json_escaped(&line, record->method);
+        put_str(&line, "\",\"target\":\"");
+        put_json_escaped(&line, record->target);
+        length = snprintf(scratch, sizeof(scratch), "\",\"protocol\":\"HTTP/%u.%u\",\"route\":%u,\"status\":%u,\"bytes\":",
+                          record->http_major, record->http_minor, record->route_id, record->status);
+        put(&line, scratch, (size_t)length);
+        put_u64(&line, record->bytes);
+        length = snprintf(scratch, sizeof(scratch), ",\"duration_ms\":%.3f}\n",
+                          (double)record->duration_ns / 1e6);
+        put(&line, scratch, (size_t)length);
+    }
+    return line.overflow ? 0 : line.length;
+}
+
+// ---------------------------------------------------------------------------
+// Writer
+// ---------------------------------------------------------------------------
+
+static void write_batch(catzilla_access_log_t* log, const char* data, size_t length) {
+    while (length > 0) {
+        uv_buf_t buf = uv_buf_init((char*)data, (unsigned int)length);
+        uv_fs_t req;
+        int rc = uv_fs_write(NULL, &req, log->fd, &buf, 1, -1, NULL);
+        uv_fs_req_cleanup(&req);
+        if (rc <= 0) {
+            catzilla_atomic_fetch_add(&log->write_errors, 1);
+            return;
+        }
+        data += rc;
+        length -= (size_t)rc;
+    }
+}
+
+static uint64_t wall_clock_us(const catzilla_access_log_t* log, uint64_t hrtime_ns) {
+    if (hrtime_ns >= log->base_hrtime_ns) {
+        return log->base_wall_us + (hrtime_ns - log->base_hrtime_ns) / 1000;
+    }
+    uint64_t before_us = (log->base_hrtime_ns - hrtime_ns) / 1000;
+    return before_us < log->base_wall_us ? log->base_wall_us - before_us : 0;
+}
+
+// Format and write what every ring holds; caller holds drain_lock
+static size_t drain_rings(catzilla_access_log_t* log) {
+    size_t written = 0;
+    size_t used = 0;
+
+    uv_mutex_lock(&log->rings_lock);
+    access_ring_t* rings = log->rings;
+    uv_mutex_unlock(&log->rings_lock);
+
+    // Rings are only ever pushed at the front, so the list from here is stable
+    for (access_ring_t* ring = rings; ring; ring = ring->next) {
+        uint64_t tail = catzilla_atomic_load(&ring->tail);
+        uint64_t head = catzilla_atomic_load_seq(&ring->head);
+        while (tail != head) {
+            if (ACCESS_LOG_BATCH_BYTES - used < ACCESS_LOG_LINE_MAX) {
+                write_batch(log, log->batch, used);
+                used = 0;
+            }
+            const catzilla_access_record_t* record = &ring->records[tail & ring->mask];
+            used += catzilla_access_log_format_record(log->config.format, record,
+                                                      wall_clock_us(log, record->started_ns),
+                                                      log->batch + used, ACCESS_LOG_LINE_MAX);
+            tail++;
+            written++;
+            // Hand slots back as lines are formatted, not once the batch is out
+            if ((tail & 63) == 0) catzilla_atomic_store_seq(&ring->tail, tail);
+        }
+        catzilla_atomic_store_seq(&ring->tail, tail);
+    }
+    if (used > 0) write_batch(log, log->batch, used);
+
+    catzilla_atomic_fetch_add(&log->written, written);
+    return written;
+}
+
+size_t catzilla_access_log_flush(catzilla_access_log_t* log) {
+    if (!log) return 0;
+    uv_mutex_lock(&log->drain_lock);
+    size_t written = drain_rings(log);
+    uv_mutex_unlock(&log->drain_lock);
+    return written;
+}
+
+static void writer_thread(void* arg) {
+    catzilla_access_log_t* log = arg;
+    uint64_t interval_ns = (uint64_t)log->config.flush_interval_ms * 1000000ULL;
+
+    uv_mutex_lock(&log->wake_lock);
+    while (!log->stopping) {
+        uv_cond_timedwait(&log->wake, &log->wake_lock, interval_ns);
+        if (log->stopping) break;
+        uv_mutex_unlock(&log->wake_lock);
+        catzilla_access_log_flush(log);
+        uv_mutex_lock(&log->wake_lock);
+    }
+    uv_mutex_unlock(&log->wake_lock);
+}
+
+// ---------------------------------------------------------------------------
+// Lifecycle
+// ---------------------------------------------------------------------------
+
+catzilla_access_log_t* catzilla_access_log_open(const char* path,
+                                                const catzilla_access_log_config_t* config) {
+    catzilla_access_log_t* log = calloc(1, sizeof(*log));
+    if (!log) return NULL;
+    if (config) log->config = *config;
+    if (log->config.ring_records == 0) log->config.ring_records = CATZILLA_ACCESS_LOG_RING_RECORDS;
+    if (log->config.flush_interval_ms == 0) log->config.flush_interval_ms = CATZILLA_ACCESS_LOG_FLUSH_INTERVAL_MS;
+    uint32_t records = 2;
+    while (records < log->config.ring_records && records < (1u << 24)) records *= 2;
+    log->config.ring_records = records;
+
+    log->batch = malloc(ACCESS_LOG_BATCH_BYTES);
+    if (!log->batch) {
+        free(log);
+        return NULL;
+    }
+
+    if (!path || strcmp(path, "-") == 0) {
+        log->fd = 1;
+    } else {
+        uv_fs_t req;
+        int fd = uv_fs_open(NULL, &req, path, O_WRONLY | O_CREAT | O_APPEND, 0644, NULL);
+        uv_fs_req_cleanup(&req);
+        if (fd < 0) {
+            LOG_SERVER_ERROR("Cannot open access log %s: %s", path, uv_strerror(fd));
+            free(log->batch);
+            free(log);
+            return NULL;
+        }
+        log->fd = fd;
+        log->owns_fd = true;
+    }
+
+    log->id = catzilla_atomic_fetch_add(&next_log_id, 1);
+    log->default_threshold = ACCESS_LOG_ALWAYS;
+    uv_timeval64_t now;
+    uv_gettimeofday(&now);
+    log->base_hrtime_ns = uv_hrtime();
+    log->base_wall_us = (uint64_t)now.tv_sec * 1000000ULL + (uint64_t)now.tv_usec;
+
+    uv_mutex_init(&log->rings_lock);
+    uv_mutex_init(&log->drain_lock);
+    uv_mutex_init(&log->wake_lock);
+    uv_cond_init(&log->wake);
+    if (!log->config.no_background) {
+        if (uv_thread_create(&log->thread, writer_thread, log) == 0) {
+            log->thread_started = true;
+        } else {
+            LOG_SERVER_WARN("Access log writer thread did not start; records wait for a flush");
+        }
+    }
+    return log;
+}
+
+void catzilla_access_log_close(catzilla_access_log_t* log) {
+    if (!log) return;
+
+    if (log->thread_started) {
+        uv_mutex_lock(&log->wake_lock);
+        log->stopping = true;
+        uv_cond_signal(&log->wake);
+        uv_mutex_unlock(&log->wake_lock);
+        uv_thread_join(&log->thread);
+    }
+    catzilla_access_log_flush(log);
+
+    access_ring_t* ring = log->rings;
+    while (ring) {
+        access_ring_t* next = ring->next;
+        free(ring);
+        ring = next;
+    }
+    if (log->owns_fd) {
+        uv_fs_t req;
+        uv_fs_close(NULL, &req, log->fd, NULL);
+        uv_fs_req_cleanup(&req);
+    }
+    uv_cond_destroy(&log->wake);
+    uv_mutex_destroy(&log->wake_lock);
+    uv_mutex_destroy(&log->drain_lock);
+    uv_mutex_destroy(&log->rings_lock);
+    free(log->route_thresholds);
+    free(log->batch);
+    free(log);
+}
+
+void catzilla_access_log_get_stats(catzilla_access_log_t* log, catzilla_access_log_stats_t* stats) {
+    if (!stats) return;
+    memset(stats, 0, sizeof(*stats));
+    if (!log) return;
+
+    stats->written = catzilla_atomic_load(&log->written);
+    stats->write_errors = catzilla_atomic_load(&log->write_errors);
+    uv_mutex_lock(&log->rings_lock);
+    for (access_ring_t* ring = log->rings; ring; ring = ring->next) {
+        stats->dropped += catzilla_atomic_load(&ring->dropped);
+    }
+    stats->rings = log->ring_count;
+    uv_mutex_unlock(&log->rings_lock);
+}
@@ -0,0 +1,147 @@
+/*
+ * Catzilla Access Log - request logging off the event loop
+ *
+ * Each loop thread copies a fixed-size record per response into a ring of
+ * its own; a writer thread drains the rings every flush interval, formats
+ * the records as JSON lines or Common Log Format and writes them with one
+ * write per batch. Appending is a copy and a release store: no locks, no
+ * formatting and no system calls on the loop. A full ring drops the record
+ * and counts it instead of waiting for the writer.
+ */
+
+#ifndef CATZILLA_ACCESS_LOG_H
+#define CATZILLA_ACCESS_LOG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct catzilla_access_log_s catzilla_access_log_t;
+
+#define CATZILLA_ACCESS_LOG_RING_RECORDS 4096
+#define CATZILLA_ACCESS_LOG_FLUSH_INTERVAL_MS 100
+#define CATZILLA_ACCESS_LOG_TARGET_MAX 160   // Request target bytes kept; longer ones are cut
+#define CATZILLA_ACCESS_LOG_NO_ROUTE 0       // route_id of responses no route matched
+
+typedef enum {
+    CATZILLA_ACCESS_LOG_JSON,  // One JSON object per line
+    CATZILLA_ACCESS_LOG_CLF    // Common Log Format
+} catzilla_access_log_format_t;
+
+// Access log configuration; zero fields take the defaults above
+typedef struct catzilla_access_log_config_s {
+    catzilla_access_log_format_t format;
+    uint32_t ring_records;        // Records each loop holds before dropping (rounded up to a power of two)
+    uint32_t flush_interval_ms;   // How often the writer drains the rings
+    bool no_background;           // Write only when catzilla_access_log_flush is called
+} catzilla_access_log_config_t;
+
+/**
+ * One response, as the loop hands it over. Strings are NUL-terminated and
+ * cut to fit.
+ */
+typedef struct catzilla_access_record_s {
+    uint64_t started_ns;          // Request start (uv_hrtime)
+    uint64_t duration_ns;         // Request start until its response was queued
+    uint64_t bytes;               // Response bytes, headers included
+    uint32_t route_id;            // Matched route, or CATZILLA_ACCESS_LOG_NO_ROUTE
+    uint16_t status;
+    uint8_t http_major;
+    uint8_t http_minor;
+    char method[16];
+    char remote_addr[46];         // INET6_ADDRSTRLEN
+    char target[CATZILLA_ACCESS_LOG_TARGET_MAX];  // Path and query string
+} catzilla_access_record_t;
+
+typedef struct catzilla_access_log_stats_s {
+    uint64_t written;             // Records formatted and written
+    uint64_t dropped;             // Records lost to a full ring
+    uint64_t write_errors;        // Batches the file did not take
+    uint64_t rings;               // Loops that logged
+} catzilla_access_log_stats_t;
+
+/**
+ * Open an access log appending to a file and start its writer thread
+ * @param path File to append to (created if missing); NULL or "-" for stdout
+ * @param config Configuration, or NULL for the defaults
+ * @return Access log, or NULL on failure
+ */
+catzilla_access_log_t* catzilla_access_log_open(const char* path,
+                                                const catzilla_access_log_config_t* config);
+
+/**
+ * Stop the writer, write every record still queued and free the log.
+ * No loop may append anymore.
+ * @param log Access log (may be NULL)
+ */
+void catzilla_access_log_close(catzilla_access_log_t* log);
+
+/**
+ * Set the share of requests logged for routes without a rate of their own.
+ * Call before loops append.
+ * @param log Access log
+ * @param rate 0 (none) to 1 (all)
+ */
+void catzilla_access_log_set_sample_rate(catzilla_access_log_t* log, double rate);
+
+/**
+ * Set the share of a route's requests that are logged. Call before loops
+ * append.
+ * @param log Access log
+ * @param route_id Route ID (catzilla_route_t.id)
+ * @param rate 0 (none) to 1 (all)
+ * @return 0 on success, -1 if memory runs out
+ */
+int catzilla_access_log_set_route_sample_rate(catzilla_access_log_t* log, uint32_t route_id, double rate);
+
+/**
+ * Decide whether a request is logged, by its route's sample rate
+ * @param log Access log
+ * @param route_id Route ID, or CATZILLA_ACCESS_LOG_NO_ROUTE
+ * @return true if the request's record should be appended
+ */
+bool catzilla_access_log_sampled(catzilla_access_log_t* log, uint32_t route_id);
+
+/**
+ * Append a record to the calling thread's ring, created on first use
+ * @param log Access log
+ * @param record Record to copy
+ * @return true if queued, false if the ring was full and the record dropped
+ */
+bool catzilla_access_log_append(catzilla_access_log_t* log, const catzilla_access_record_t* record);
+
+/**
+ * Drain every ring and write the records now
+ * @param log Access log
+ * @return Number of records written
+ */
+size_t catzilla_access_log_flush(catzilla_access_log_t* log);
+
+/**
+ * @param log Access log
+ * @param stats Receives the counters
+ */
+void catzilla_access_log_get_stats(catzilla_access_log_t* log, catzilla_access_log_stats_t* stats);
+
+/**
+ * Format one record as it is written, newline included
+ * @param format Output format
+ * @param record Record
+ * @param wall_us Wall clock time of the request start, in microseconds since the epoch
+ * @param out Buffer
+ * @param capacity Buffer size
+ * @return Bytes written, or 0 if the buffer is too small
+ */
+size_t catzilla_access_log_format_record(catzilla_access_log_format_t format,
+                                         const catzilla_access_record_t* record,
+                                         uint64_t wall_us, char* out, size_t capacity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CATZILLA_ACCESS_LOG_H
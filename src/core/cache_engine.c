@@ -4,9 +4,9 @@
  *
  * This implements a revolutionary multi-level caching system that operates
  * at C-level speeds with enterprise-grade features:
- * - Hash table with LRU eviction
+ * - Sharded hash table with CLOCK or W-TinyLFU eviction
  * - jemalloc arena-based memory management
- * - Thread-safe operations with minimal locking
+ * - Hits take only their shard's read lock
  * - Real-time statistics collection
  * - Zero-copy operations where possible
  */
@@ -27,7 +27,22 @@
 #include <jemalloc/jemalloc.h>
 #endif
 
+#ifdef CATZILLA_HAS_LZ4
+#include <lz4.h>
+#endif
+#ifdef CATZILLA_HAS_ZSTD
+#include <zstd.h>
+#endif
+
+#include <uv.h>
+
 #include "cache_engine.h"
+#include "platform_compat.h"
+#include "disk_cache.h"
+#include "redis_client.h"
+#include "cache_snapshot.h"
+#include "logging.h"
+#include "probes.h"
 
 // Hash function for cache keys (FNV-1a algorithm)
 static uint32_t hash_key(const char* key, size_t len) {
@@ -53,110 +68,593 @@ static uint64_t get_timestamp_us() {
 #endif
 }
 
-// Move entry to front of LRU list (most recently used)
-static void lru_move_to_front(catzilla_cache_t* cache, cache_entry_t* entry) {
-    if (entry == cache->lru_head) {
-        return; // Already at front
+// Free an entry's memory
+static void entry_free(catzilla_cache_t* cache, cache_entry_t* entry) {
+#ifdef JEMALLOC_ENABLED
+    if (entry->key) dallocx(entry->key, MALLOCX_ARENA(cache->arena_index));
+    if (entry->value) dallocx(entry->value, MALLOCX_ARENA(cache->arena_index));
+    dallocx(entry, MALLOCX_ARENA(cache->arena_index));
+#else
+    (void)cache;
+    free(entry->key);
+    free(entry->value);
+    free(entry);
+#endif
+}
+
+static void* cache_alloc(catzilla_cache_t* cache, size_t size) {
+#ifdef JEMALLOC_ENABLED
+    return mallocx(size > 0 ? size : 1, MALLOCX_ARENA(cache->arena_index));
+#else
+    (void)cache;
+    return malloc(size > 0 ? size : 1);
+#endif
+}
+
+static void cache_dealloc(catzilla_cache_t* cache, void* ptr) {
+#ifdef JEMALLOC_ENABLED
+    if (ptr) dallocx(ptr, MALLOCX_ARENA(cache->arena_index));
+#else
+    (void)cache;
+    free(ptr);
+#endif
+}
+
+static size_t entry_bytes(const cache_entry_t* entry, size_t key_len) {
+    return entry->stored_size + key_len + sizeof(cache_entry_t);
+}
+
+// Add or take an entry's bytes from its shard's counters
+static void shard_account(cache_shard_t* shard, const cache_entry_t* entry, size_t key_len, bool add) {
+    uint64_t bytes = entry_bytes(entry, key_len);
+    if (add) {
+        catzilla_atomic_fetch_add(&shard->memory_usage, bytes);
+    } else {
+        catzilla_atomic_fetch_sub(&shard->memory_usage, bytes);
+    }
+    if (entry->codec == CACHE_CODEC_NONE) {
+        return;
     }
+    if (add) {
+        catzilla_atomic_fetch_add(&shard->compressed_entries, 1);
+        catzilla_atomic_fetch_add(&shard->compressed_bytes, entry->stored_size);
+        catzilla_atomic_fetch_add(&shard->uncompressed_bytes, entry->value_size);
+    } else {
+        catzilla_atomic_fetch_sub(&shard->compressed_entries, 1);
+        catzilla_atomic_fetch_sub(&shard->compressed_bytes, entry->stored_size);
+        catzilla_atomic_fetch_sub(&shard->uncompressed_bytes, entry->value_size);
+    }
+}
 
-    // Remove from current position
-    if (entry->lru_prev) {
-        entry->lru_prev->lru_next = entry->lru_next;
+// ============================================================================
+// Value Compression
+// ============================================================================
+
+// zstd level; higher ones cost far more CPU for little gain on JSON
+#define CACHE_ZSTD_LEVEL 3
+// Scratch buffers larger than this are shrunk once a smaller value is read
+#define CACHE_SCRATCH_KEEP (256 * 1024)
+
+typedef struct cache_scratch {
+    char* data;
+    size_t capacity;
+} cache_scratch_t;
+
+// Per-thread buffers: read_scratch holds the value catzilla_cache_get
+// returned last, work_scratch never outlives the call using it
+static CATZILLA_THREAD_LOCAL cache_scratch_t read_scratch;
+static CATZILLA_THREAD_LOCAL cache_scratch_t work_scratch;
+#ifdef CATZILLA_HAS_ZSTD
+static CATZILLA_THREAD_LOCAL ZSTD_CCtx* zstd_cctx;
+static CATZILLA_THREAD_LOCAL ZSTD_DCtx* zstd_dctx;
+#endif
+
+// Make room for size bytes; the old contents are not kept
+static char* scratch_reserve(cache_scratch_t* scratch, size_t size) {
+    if (size == 0) size = 1;
+    if (size <= scratch->capacity &&
+        (scratch->capacity <= CACHE_SCRATCH_KEEP || size > CACHE_SCRATCH_KEEP)) {
+        return scratch->data;
+    }
+    size_t capacity = size > CACHE_SCRATCH_KEEP ? size : CACHE_SCRATCH_KEEP;
+    free(scratch->data);
+    scratch->data = malloc(capacity);
+    scratch->capacity = scratch->data ? capacity : 0;
+    return scratch->data;
+}
+
+static void scratch_release(cache_scratch_t* scratch) {
+    free(scratch->data);
+    scratch->data = NULL;
+    scratch->capacity = 0;
+}
+
+bool catzilla_cache_codec_available(cache_codec_t codec) {
+    switch (codec) {
+    case CACHE_CODEC_NONE:
+        return true;
+#ifdef CATZILLA_HAS_LZ4
+    case CACHE_CODEC_LZ4:
+        return true;
+#endif
+#ifdef CATZILLA_HAS_ZSTD
+    case CACHE_CODEC_ZSTD:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+// Pick the codec for a configuration, falling back to what this build has
+static cache_codec_t resolve_codec(bool enabled, cache_codec_t requested) {
+    if (!enabled) {
+        return CACHE_CODEC_NONE;
     }
-    if (entry->lru_next) {
-        entry->lru_next->lru_prev = entry->lru_prev;
+    if (requested != CACHE_CODEC_NONE && catzilla_cache_codec_available(requested)) {
+        return requested;
     }
-    if (entry == cache->lru_tail) {
-        cache->lru_tail = entry->lru_prev;
+    cache_codec_t fallback = catzilla_cache_codec_available(CACHE_CODEC_LZ4) ? CACHE_CODEC_LZ4
+                           : catzilla_cache_codec_available(CACHE_CODEC_ZSTD) ? CACHE_CODEC_ZSTD
+                           : CACHE_CODEC_NONE;
+    if (fallback == CACHE_CODEC_NONE) {
+        LOG_CACHE_WARN("Cache compression requested but no codec is built in");
+    } else if (requested != CACHE_CODEC_NONE) {
+        LOG_CACHE_WARN("Cache codec %d not built in, using %d", (int)requested, (int)fallback);
     }
+    return fallback;
+}
 
-    // Add to front
-    entry->lru_prev = NULL;
-    entry->lru_next = cache->lru_head;
-    if (cache->lru_head) {
-        cache->lru_head->lru_prev = entry;
+// Compress into work_scratch; returns the compressed size, 0 on failure
+static size_t compress_into_scratch(cache_codec_t codec, const void* value, size_t size) {
+    switch (codec) {
+#ifdef CATZILLA_HAS_LZ4
+    case CACHE_CODEC_LZ4: {
+        if (size > LZ4_MAX_INPUT_SIZE) return 0;
+        int bound = LZ4_compressBound((int)size);
+        char* out = scratch_reserve(&work_scratch, (size_t)bound);
+        if (!out) return 0;
+        int written = LZ4_compress_default(value, out, (int)size, bound);
+        return written > 0 ? (size_t)written : 0;
+    }
+#endif
+#ifdef CATZILLA_HAS_ZSTD
+    case CACHE_CODEC_ZSTD: {
+        if (!zstd_cctx && !(zstd_cctx = ZSTD_createCCtx())) return 0;
+        size_t bound = ZSTD_compressBound(size);
+        char* out = scratch_reserve(&work_scratch, bound);
+        if (!out) return 0;
+        size_t written = ZSTD_compressCCtx(zstd_cctx, out, bound, value, size, CACHE_ZSTD_LEVEL);
+        return ZSTD_isError(written) ? 0 : written;
     }
-    cache->lru_head = entry;
+#endif
+    default:
+        (void)value;
+        (void)size;
+        return 0;
+    }
+}
 
-    if (!cache->lru_tail) {
-        cache->lru_tail = entry;
+/**
+ * Compress a value into a new allocation sized to fit. Returns NULL to store
+ * the value as is: no codec, a value under the threshold, or one that does
+ * not shrink by at least an eighth.
+ */
+static void* compress_value(catzilla_cache_t* cache, const void* value, size_t size,
+                            uint8_t* codec, size_t* stored_size) {
+    cache_codec_t use = cache->codec;
+    if (use == CACHE_CODEC_NONE || size < cache->compression_threshold) {
+        return NULL;
+    }
+    size_t compressed = compress_into_scratch(use, value, size);
+    if (compressed == 0 || compressed > size - size / 8) {
+        return NULL;
     }
+    void* stored = cache_alloc(cache, compressed);
+    if (!stored) {
+        return NULL;
+    }
+    memcpy(stored, work_scratch.data, compressed);
+    *codec = (uint8_t)use;
+    *stored_size = compressed;
+    return stored;
 }
 
-// Remove entry from LRU list
-static void lru_remove(catzilla_cache_t* cache, cache_entry_t* entry) {
-    if (entry->lru_prev) {
-        entry->lru_prev->lru_next = entry->lru_next;
-    } else {
-        cache->lru_head = entry->lru_next;
+// Decompress an entry into a buffer of value_size bytes; holds the shard lock
+static bool decompress_value(const cache_entry_t* entry, void* out) {
+    switch ((cache_codec_t)entry->codec) {
+#ifdef CATZILLA_HAS_LZ4
+    case CACHE_CODEC_LZ4:
+        return LZ4_decompress_safe(entry->value, out, (int)entry->stored_size,
+                                   (int)entry->value_size) == (int)entry->value_size;
+#endif
+#ifdef CATZILLA_HAS_ZSTD
+    case CACHE_CODEC_ZSTD: {
+        if (!zstd_dctx && !(zstd_dctx = ZSTD_createDCtx())) return false;
+        size_t written = ZSTD_decompressDCtx(zstd_dctx, out, entry->value_size,
+                                             entry->value, entry->stored_size);
+        return !ZSTD_isError(written) && written == entry->value_size;
+    }
+#endif
+    default:
+        (void)out;
+        return false;
+    }
+}
+
+// Decompress an entry into a per-thread buffer; holds the shard lock
+static void* entry_decompress(const cache_entry_t* entry, cache_scratch_t* scratch) {
+    char* out = scratch_reserve(scratch, entry->value_size);
+    if (!out || !decompress_value(entry, out)) {
+        LOG_CACHE_ERROR("Failed to decompress cache entry '%s'", entry->key);
+        return NULL;
+    }
+    return out;
+}
+
+void catzilla_cache_release_thread_buffers(void) {
+    scratch_release(&read_scratch);
+    scratch_release(&work_scratch);
+#ifdef CATZILLA_HAS_ZSTD
+    ZSTD_freeCCtx(zstd_cctx);
+    ZSTD_freeDCtx(zstd_dctx);
+    zstd_cctx = NULL;
+    zstd_dctx = NULL;
+#endif
+}
+
+// Pick a shard from the high bits of the hash; buckets use the low bits
+static cache_shard_t* shard_for(catzilla_cache_t* cache, uint32_t hash) {
+    return &cache->shards[((uint64_t)hash * cache->shard_count) >> 32];
+}
+
+// Find an entry in a shard; the caller holds the shard lock
+static cache_entry_t* shard_find(cache_shard_t* shard, const char* key, uint32_t hash) {
+    for (cache_entry_t* entry = shard->buckets[hash % shard->bucket_count]; entry; entry = entry->next) {
+        if (entry->hash == hash && strcmp(entry->key, key) == 0) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+// Pending fills are few (one per key being computed), so a list will do;
+// the caller holds the shard write lock for all three
+static cache_fill_t* shard_find_fill(cache_shard_t* shard, const char* key, uint32_t hash) {
+    for (cache_fill_t* fill = shard->fills; fill; fill = fill->next) {
+        if (fill->hash == hash && strcmp(fill->key, key) == 0) {
+            return fill;
+        }
+    }
+    return NULL;
+}
+
+static cache_fill_t* shard_add_fill(cache_shard_t* shard, const char* key, size_t key_len, uint32_t hash) {
+    cache_fill_t* fill = malloc(sizeof(cache_fill_t));
+    char* key_copy = malloc(key_len + 1);
+    if (!fill || !key_copy) {
+        free(fill);
+        free(key_copy);
+        return NULL;
+    }
+    memcpy(key_copy, key, key_len + 1);
+    fill->key = key_copy;
+    fill->hash = hash;
+    fill->claimed_at = 0;
+    fill->next = shard->fills;
+    shard->fills = fill;
+    return fill;
+}
+
+static bool shard_drop_fill(cache_shard_t* shard, const char* key, uint32_t hash) {
+    for (cache_fill_t** current = &shard->fills; *current; current = &(*current)->next) {
+        cache_fill_t* fill = *current;
+        if (fill->hash == hash && strcmp(fill->key, key) == 0) {
+            *current = fill->next;
+            free(fill->key);
+            free(fill);
+            return true;
+        }
+    }
+    return false;
+}
+
+static cache_entry_t** ring_hand(cache_shard_t* shard, const cache_entry_t* entry) {
+    switch (entry->region) {
+        case CACHE_REGION_WINDOW: return &shard->window_hand;
+        case CACHE_REGION_PROTECTED: return &shard->protected_hand;
+        default: return &shard->clock_hand;
     }
+}
 
-    if (entry->lru_next) {
-        entry->lru_next->lru_prev = entry->lru_prev;
+// Add an entry to its ring just behind the hand, so it is inspected last
+static void clock_insert(cache_shard_t* shard, cache_entry_t* entry) {
+    cache_entry_t** hand = ring_hand(shard, entry);
+    shard->region_size[entry->region]++;
+    if (!*hand) {
+        entry->clock_prev = entry->clock_next = entry;
+        *hand = entry;
+        return;
+    }
+    entry->clock_next = *hand;
+    entry->clock_prev = (*hand)->clock_prev;
+    (*hand)->clock_prev->clock_next = entry;
+    (*hand)->clock_prev = entry;
+}
+
+static void clock_remove(cache_shard_t* shard, cache_entry_t* entry) {
+    cache_entry_t** hand = ring_hand(shard, entry);
+    shard->region_size[entry->region]--;
+    if (entry->clock_next == entry) {
+        *hand = NULL;
     } else {
-        cache->lru_tail = entry->lru_prev;
+        if (*hand == entry) {
+            *hand = entry->clock_next;
+        }
+        entry->clock_prev->clock_next = entry->clock_next;
+        entry->clock_next->clock_prev = entry->clock_prev;
+    }
+    entry->clock_prev = entry->clock_next = NULL;
+}
+
+// Move an entry to another ring with its access bit cleared
+static void region_move(cache_shard_t* shard, cache_entry_t* entry, cache_region_t region) {
+    clock_remove(shard, entry);
+    entry->region = (uint8_t)region;
+    entry->referenced = 0;
+    clock_insert(shard, entry);
+}
+
+// Advance a ring's hand with CLOCK to the first entry that is unreferenced
+// or expired; referenced entries lose their bit on the way
+static cache_entry_t* ring_victim(cache_entry_t** hand, size_t ring_size, uint64_t now) {
+    // Two laps at most: after one, every bit is clear
+    for (size_t step = 0; *hand && step <= 2 * ring_size; step++) {
+        cache_entry_t* entry = *hand;
+        if (!entry->referenced || now > entry->expires_at) {
+            return entry;
+        }
+        entry->referenced = 0;
+        *hand = entry->clock_next;
     }
+    return *hand;
+}
+
+// Sketch rows index with different odd multipliers of the key hash
+static const uint32_t sketch_seeds[CATZILLA_CACHE_SKETCH_DEPTH] = {
+    0x9E3779B1u, 0x85EBCA77u, 0xC2B2AE3Du, 0x27D4EB2Fu
+};
+
+static size_t sketch_index(const cache_shard_t* shard, uint32_t hash, int row) {
+    uint32_t h = hash * sketch_seeds[row];
+    h ^= h >> 15;
+    return (size_t)row * (shard->sketch_mask + 1) + (h & shard->sketch_mask);
 }
 
-// Evict least recently used entry
-static void evict_lru(catzilla_cache_t* cache) {
-    if (!cache->lru_tail) {
+// Count an access to a key. Runs under the read lock too: racing
+// increments may be lost, which only makes the estimate a little low.
+static void sketch_record(cache_shard_t* shard, uint32_t hash) {
+    if (!shard->sketch) {
         return;
     }
+    for (int row = 0; row < CATZILLA_CACHE_SKETCH_DEPTH; row++) {
+        size_t i = sketch_index(shard, hash, row);
+        uint8_t count = shard->sketch[i];
+        if (count < 15) {
+            shard->sketch[i] = (uint8_t)(count + 1);
+        }
+    }
+    // Age the counts so keys that were popular once fade out
+    if (catzilla_atomic_fetch_add(&shard->sketch_additions, 1) + 1 == shard->sketch_sample) {
+        size_t cells = (size_t)CATZILLA_CACHE_SKETCH_DEPTH * (shard->sketch_mask + 1);
+        for (size_t i = 0; i < cells; i++) {
+            shard->sketch[i] = (uint8_t)(shard->sketch[i] >> 1);
+        }
+        catzilla_atomic_store(&shard->sketch_additions, shard->sketch_sample / 2);
+    }
+}
 
-    cache_entry_t* entry = cache->lru_tail;
+static uint8_t sketch_estimate(const cache_shard_t* shard, uint32_t hash) {
+    uint8_t estimate = 15;
+    for (int row = 0; row < CATZILLA_CACHE_SKETCH_DEPTH; row++) {
+        uint8_t count = shard->sketch[sketch_index(shard, hash, row)];
+        if (count < estimate) estimate = count;
+    }
+    return estimate;
+}
 
-    // Remove from hash table
-    uint32_t bucket_index = entry->hash % cache->bucket_count;
-    cache_entry_t** current = &cache->buckets[bucket_index];
+// Size the window, protected segment and sketch for the shard's capacity;
+// holds the write lock (or owns the shard)
+static int shard_size_regions(cache_shard_t* shard) {
+    size_t window = shard->capacity * CATZILLA_CACHE_WINDOW_PERCENT / 100;
+    shard->window_capacity = window > 0 ? window : 1;
+    size_t main_capacity = shard->capacity > shard->window_capacity
+                         ? shard->capacity - shard->window_capacity : 0;
+    shard->protected_capacity = main_capacity * CATZILLA_CACHE_PROTECTED_PERCENT / 100;
+
+    size_t width = 64;
+    while (width < shard->capacity) width <<= 1;
+    if (!shard->sketch || width != (size_t)shard->sketch_mask + 1) {
+        uint8_t* sketch = calloc((size_t)CATZILLA_CACHE_SKETCH_DEPTH * width, 1);
+        if (!sketch) {
+            return shard->sketch ? 0 : -1; // Keep the old sketch if there is one
+        }
+        free((void*)shard->sketch);
+        shard->sketch = sketch;
+        shard->sketch_mask = (uint32_t)(width - 1);
+        catzilla_atomic_store(&shard->sketch_additions, 0);
+    }
+    shard->sketch_sample = (uint64_t)CATZILLA_CACHE_SKETCH_SAMPLE * (shard->sketch_mask + 1);
+    return 0;
+}
 
+// Unlink an entry from its bucket and ring and free it; holds the write lock
+static void shard_remove(catzilla_cache_t* cache, cache_shard_t* shard, cache_entry_t* entry) {
+    cache_entry_t** current = &shard->buckets[entry->hash % shard->bucket_count];
     while (*current && *current != entry) {
         current = &(*current)->next;
     }
-
     if (*current) {
         *current = entry->next;
     }
+    clock_remove(shard, entry);
 
-    // Remove from LRU list
-    lru_remove(cache, entry);
+    shard_account(shard, entry, strlen(entry->key), false);
+    shard->size--;
+    catzilla_atomic_fetch_sub(&cache->size, 1);
+    entry_free(cache, entry);
+}
 
-    // Free memory using jemalloc if available
-#ifdef JEMALLOC_ENABLED
-    dallocx(entry->key, MALLOCX_ARENA(cache->arena_index));
-    dallocx(entry->value, MALLOCX_ARENA(cache->arena_index));
-    dallocx(entry, MALLOCX_ARENA(cache->arena_index));
-#else
-    free(entry->key);
-    free(entry->value);
-    free(entry);
-#endif
+// Evict one entry with CLOCK: referenced entries get their bit cleared and a
+// second chance, expired ones go first. Holds the write lock.
+static void shard_evict(catzilla_cache_t* cache, cache_shard_t* shard, uint64_t now) {
+    cache_entry_t* victim = ring_victim(&shard->clock_hand, shard->size, now);
+    if (victim) {
+        shard_remove(cache, shard, victim);
+        catzilla_atomic_fetch_add(&shard->evictions, 1);
+    }
+}
 
-    catzilla_atomic_fetch_sub(&cache->size, 1);
-    catzilla_atomic_fetch_add(&cache->stats.evictions, 1);
+// Find the probation entry to evict. Entries hit while on probation move to
+// the protected segment instead, pushing its coldest entries back.
+static cache_entry_t* probation_victim(cache_shard_t* shard, uint64_t now) {
+    for (size_t step = 0; step <= 2 * shard->size; step++) {
+        cache_entry_t* entry = shard->clock_hand;
+        if (!entry) {
+            cache_entry_t* demoted = ring_victim(&shard->protected_hand,
+                                                 shard->region_size[CACHE_REGION_PROTECTED], now);
+            if (!demoted) return NULL;
+            region_move(shard, demoted, CACHE_REGION_MAIN);
+            continue;
+        }
+        if (!entry->referenced || now > entry->expires_at) {
+            return entry;
+        }
+        region_move(shard, entry, CACHE_REGION_PROTECTED);
+        while (shard->region_size[CACHE_REGION_PROTECTED] > shard->protected_capacity) {
+            cache_entry_t* demoted = ring_victim(&shard->protected_hand,
+                                                 shard->region_size[CACHE_REGION_PROTECTED], now);
+            region_move(shard, demoted, CACHE_REGION_MAIN);
+        }
+    }
+    return shard->clock_hand;
 }
 
-// Create a new cache instance
-catzilla_cache_t* catzilla_cache_create(size_t capacity, size_t bucket_count) {
-    catzilla_cache_t* cache = malloc(sizeof(catzilla_cache_t));
-    if (!cache) {
+// Bring a W-TinyLFU shard back within its capacities. An entry leaving the
+// window joins probation and then competes with probation's victim: the
+// one the sketch has seen less often is evicted. Holds the write lock.
+static void shard_evict_tinylfu(catzilla_cache_t* cache, cache_shard_t* shard, uint64_t now) {
+    while (shard->region_size[CACHE_REGION_WINDOW] > shard->window_capacity) {
+        cache_entry_t* candidate = ring_victim(&shard->window_hand,
+                                               shard->region_size[CACHE_REGION_WINDOW], now);
+        region_move(shard, candidate, CACHE_REGION_MAIN);
+        if (shard->size <= shard->capacity) {
+            continue;
+        }
+        cache_entry_t* victim = probation_victim(shard, now);
+        if (victim != candidate && now <= candidate->expires_at && now <= victim->expires_at &&
+            sketch_estimate(shard, candidate->hash) <= sketch_estimate(shard, victim->hash)) {
+            victim = candidate;
+            catzilla_atomic_fetch_add(&shard->rejections, 1);
+        }
+        shard_remove(cache, shard, victim);
+        catzilla_atomic_fetch_add(&shard->evictions, 1);
+    }
+
+    // Shrunk below what the main region holds
+    while (shard->size > shard->capacity) {
+        cache_entry_t* victim = probation_victim(shard, now);
+        if (!victim) {
+            victim = ring_victim(&shard->window_hand, shard->region_size[CACHE_REGION_WINDOW], now);
+        }
+        if (!victim) {
+            break;
+        }
+        shard_remove(cache, shard, victim);
+        catzilla_atomic_fetch_add(&shard->evictions, 1);
+    }
+}
+
+// Free every entry of a shard; holds the write lock
+static void shard_clear(catzilla_cache_t* cache, cache_shard_t* shard) {
+    for (size_t i = 0; i < shard->bucket_count; i++) {
+        cache_entry_t* entry = shard->buckets[i];
+        while (entry) {
+            cache_entry_t* next = entry->next;
+            entry_free(cache, entry);
+            entry = next;
+        }
+        shard->buckets[i] = NULL;
+    }
+    catzilla_atomic_fetch_sub(&cache->size, shard->size);
+    shard->size = 0;
+    shard->clock_hand = shard->window_hand = shard->protected_hand = NULL;
+    memset(shard->region_size, 0, sizeof(shard->region_size));
+    catzilla_atomic_store(&shard->memory_usage, 0);
+    catzilla_atomic_store(&shard->compressed_entries, 0);
+    catzilla_atomic_store(&shard->compressed_bytes, 0);
+    catzilla_atomic_store(&shard->uncompressed_bytes, 0);
+}
+
+// Split a capacity over the shards; the first ones take the remainder
+static size_t shard_capacity(size_t capacity, size_t shard_count, size_t index) {
+    return capacity / shard_count + (index < capacity % shard_count ? 1 : 0);
+}
+
+// Mark a hit; skips the store when the bit is already set, so hot entries
+// do not bounce their cache line between readers
+static void entry_touch(cache_entry_t* entry) {
+    if (!catzilla_atomic_load(&entry->referenced)) {
+        catzilla_atomic_store(&entry->referenced, 1);
+    }
+}
+
+static catzilla_cache_t* cache_create_sharded(size_t capacity, size_t bucket_count, size_t shard_count) {
+    if (capacity == 0) {
         return NULL;
     }
+    if (shard_count == 0) {
+        shard_count = capacity / CATZILLA_CACHE_MIN_SHARD_CAPACITY;
+        if (shard_count > CATZILLA_CACHE_MAX_SHARDS) shard_count = CATZILLA_CACHE_MAX_SHARDS;
+        if (shard_count == 0) shard_count = 1;
+    }
+    if (shard_count > capacity) {
+        shard_count = capacity;
+    }
+    if (bucket_count == 0) {
+        bucket_count = capacity / 4;
+    }
 
-    // Initialize hash table
-    cache->buckets = calloc(bucket_count, sizeof(cache_entry_t*));
-    if (!cache->buckets) {
+    catzilla_cache_t* cache = calloc(1, sizeof(catzilla_cache_t));
+    if (!cache) {
+        return NULL;
+    }
+    cache->shards = calloc(shard_count, sizeof(cache_shard_t));
+    if (!cache->shards) {
         free(cache);
         return NULL;
     }
-
-    cache->bucket_count = bucket_count;
+    cache->shard_count = shard_count;
     cache->capacity = capacity;
     catzilla_atomic_store(&cache->size, 0);
 
-    // Initialize LRU list
-    cache->lru_head = NULL;
-    cache->lru_tail = NULL;
+    for (size_t i = 0; i < shard_count; i++) {
+        cache_shard_t* shard = &cache->shards[i];
+        shard->bucket_count = bucket_count / shard_count;
+        if (shard->bucket_count < 16) shard->bucket_count = 16;
+        shard->buckets = calloc(shard->bucket_count, sizeof(cache_entry_t*));
+        if (!shard->buckets) {
+            for (size_t j = 0; j < i; j++) {
+                catzilla_rwlock_destroy(&cache->shards[j].rwlock);
+                free(cache->shards[j].buckets);
+            }
+            free(cache->shards);
+            free(cache);
+            return NULL;
+        }
+        shard->capacity = shard_capacity(capacity, shard_count, i);
+        catzilla_rwlock_init(&shard->rwlock);
+    }
 
     // Initialize jemalloc arena if available
 #ifdef JEMALLOC_ENABLED
@@ -168,133 +666,191 @@ catzilla_cache_t* catzilla_cache_create(size_t capacity, size_t bucket_count) {
     cache->arena_index = 0;
 #endif
 
-    // Initialize statistics
-    catzilla_atomic_store(&cache->stats.hits, 0);
-    catzilla_atomic_store(&cache->stats.misses, 0);
-    catzilla_atomic_store(&cache->stats.evictions, 0);
-    catzilla_atomic_store(&cache->stats.memory_usage, 0);
-    catzilla_atomic_store(&cache->stats.total_requests, 0);
-    cache->stats.hit_ratio = 0.0;
-
-    // Initialize thread safety
-    catzilla_rwlock_init(&cache->rwlock);
-
     // Configuration defaults
     cache->default_ttl = 3600; // 1 hour
     cache->max_value_size = 100 * 1024 * 1024; // 100MB
     cache->compression_enabled = false;
+    cache->codec = CACHE_CODEC_NONE;
+    cache->compression_threshold = CATZILLA_CACHE_COMPRESSION_THRESHOLD;
+    cache->fill_timeout_us = (uint64_t)CATZILLA_CACHE_FILL_TIMEOUT_MS * 1000;
 
     return cache;
 }
 
+// Create a new cache instance
+catzilla_cache_t* catzilla_cache_create(size_t capacity, size_t bucket_count) {
+    return cache_create_sharded(capacity, bucket_count, 0);
+}
+
 // Set a value in the cache
 int catzilla_cache_set(catzilla_cache_t* cache, const char* key, const void* value,
                        size_t value_size, uint32_t ttl) {
-    if (!cache || !key || !value || value_size > cache->max_value_size) {
-        return -1;
-    }
-
-    size_t key_len = strlen(key);
-    uint32_t hash = hash_key(key, key_len);
-    uint32_t bucket_index = hash % cache->bucket_count;
-    uint64_t now = get_timestamp_us();
-    uint64_t expires_at = now + (uint64_t)ttl * 1000000; // Convert to microseconds
-
-    catzilla_rwlock_wrlock(&cache->rwlock);
-
-    // Check if key already exists
-    cache_entry_t* existing = cache->buckets[bucket_index];
-    while (existing) {
-        if (existing->hash == hash && strcmp(existing->key, key) == 0) {
-            // Update existing entry
-#ifdef JEMALLOC_ENABLED
-            dallocx(existing->value, MALLOCX_ARENA(cache->arena_index));
-            existing->value = mallocx(value_size, MALLOCX_ARENA(cache->arena_index));
-#else
-            free(existing->value);
-            existing->value = malloc(value_size);
-#endif
-            if (!existing->value) {
-                catzilla_rwlock_unlock(&cache->rwlock);
-                return -1;
-            }
-
-            memcpy(existing->value, value, value_size);
-            existing->value_size = value_size;
-            existing->expires_at = expires_at;
-            existing->last_access = now;
-            existing->access_count++;
+    return catzilla_cache_set_ex(cache, key, value, value_size, ttl, 0);
+}
 
-            lru_move_to_front(cache, existing);
-            catzilla_rwlock_unlock(&cache->rwlock);
-            return 0;
-        }
-        existing = existing->next;
+// Store a value copy made by the caller; the shard takes ownership of it.
+// A restored entry never replaces a key stored since the snapshot was loaded.
+static int shard_store(catzilla_cache_t* cache, const char* key, size_t key_len, uint32_t hash,
+                       void* copy, size_t value_size, size_t stored_size, uint8_t codec,
+                       uint64_t now, uint64_t stale_at, uint64_t expires_at, bool restoring) {
+    cache_shard_t* shard = shard_for(cache, hash);
+
+    catzilla_rwlock_wrlock(&shard->rwlock);
+    cache_entry_t* existing = shard_find(shard, key, hash);
+    if (restoring && existing) {
+        catzilla_rwlock_unlock(&shard->rwlock);
+        cache_dealloc(cache, copy);
+        return 0;
+    }
+    if (!restoring) {
+        shard_drop_fill(shard, key, hash);
+        sketch_record(shard, hash);
     }
 
-    // Evict entries if at capacity
-    while (catzilla_atomic_load(&cache->size) >= cache->capacity) {
-        evict_lru(cache);
+    if (existing) {
+        shard_account(shard, existing, key_len, false);
+        void* previous = existing->value;
+        existing->value = copy;
+        existing->value_size = value_size;
+        existing->stored_size = stored_size;
+        existing->codec = codec;
+        shard_account(shard, existing, key_len, true);
+        existing->expires_at = expires_at;
+        existing->stale_at = stale_at;
+        existing->refresh_claimed_at = 0;
+        existing->last_access = now;
+        existing->access_count++;
+        existing->referenced = 1;
+        catzilla_rwlock_unlock(&shard->rwlock);
+        cache_dealloc(cache, previous);
+        return 0;
     }
 
-    // Create new entry
-#ifdef JEMALLOC_ENABLED
-    cache_entry_t* entry = mallocx(sizeof(cache_entry_t), MALLOCX_ARENA(cache->arena_index));
-    entry->key = mallocx(key_len + 1, MALLOCX_ARENA(cache->arena_index));
-    entry->value = mallocx(value_size, MALLOCX_ARENA(cache->arena_index));
-#else
-    cache_entry_t* entry = malloc(sizeof(cache_entry_t));
-    entry->key = malloc(key_len + 1);
-    entry->value = malloc(value_size);
-#endif
+    // Evict entries if this shard is full; W-TinyLFU evicts once the
+    // entry is in the window, since it may turn the newcomer away
+    bool tinylfu = cache->eviction_policy == CACHE_EVICTION_TINYLFU;
+    while (!tinylfu && shard->size >= shard->capacity && shard->clock_hand) {
+        shard_evict(cache, shard, now);
+    }
 
-    if (!entry || !entry->key || !entry->value) {
-        if (entry) {
-#ifdef JEMALLOC_ENABLED
-            if (entry->key) dallocx(entry->key, MALLOCX_ARENA(cache->arena_index));
-            if (entry->value) dallocx(entry->value, MALLOCX_ARENA(cache->arena_index));
-            dallocx(entry, MALLOCX_ARENA(cache->arena_index));
-#else
-            if (entry->key) free(entry->key);
-            if (entry->value) free(entry->value);
-            free(entry);
-#endif
-        }
-        catzilla_rwlock_unlock(&cache->rwlock);
+    cache_entry_t* entry = cache_alloc(cache, sizeof(cache_entry_t));
+    char* key_copy = cache_alloc(cache, key_len + 1);
+    if (!entry || !key_copy) {
+        catzilla_rwlock_unlock(&shard->rwlock);
+        cache_dealloc(cache, entry);
+        cache_dealloc(cache, key_copy);
+        cache_dealloc(cache, copy);
         return -1;
     }
 
-    // Initialize entry
-    strcpy(entry->key, key);
-    memcpy(entry->value, value, value_size);
+    memcpy(key_copy, key, key_len + 1);
+    entry->key = key_copy;
+    entry->value = copy;
     entry->value_size = value_size;
+    entry->stored_size = stored_size;
+    entry->codec = codec;
     entry->created_at = now;
     entry->expires_at = expires_at;
+    entry->stale_at = stale_at;
+    entry->refresh_claimed_at = 0;
     entry->access_count = 1;
     entry->last_access = now;
     entry->hash = hash;
+    entry->referenced = 0;
+    entry->region = tinylfu ? CACHE_REGION_WINDOW : CACHE_REGION_MAIN;
 
-    // Add to hash table
-    entry->next = cache->buckets[bucket_index];
-    cache->buckets[bucket_index] = entry;
+    cache_entry_t** bucket = &shard->buckets[hash % shard->bucket_count];
+    entry->next = *bucket;
+    *bucket = entry;
+    clock_insert(shard, entry);
 
-    // Add to front of LRU list
-    entry->lru_prev = NULL;
-    entry->lru_next = cache->lru_head;
-    if (cache->lru_head) {
-        cache->lru_head->lru_prev = entry;
+    shard->size++;
+    catzilla_atomic_fetch_add(&cache->size, 1);
+    shard_account(shard, entry, key_len, true);
+    if (tinylfu) {
+        shard_evict_tinylfu(cache, shard, now);
     }
-    cache->lru_head = entry;
 
-    if (!cache->lru_tail) {
-        cache->lru_tail = entry;
+    catzilla_rwlock_unlock(&shard->rwlock);
+    return 0;
+}
+
+// Insert one snapshot record, with the lifetime it has left
+static void restore_entry(void* data, const catzilla_snapshot_record_t* record,
+                          const char* key, const void* value) {
+    catzilla_cache_t* cache = data;
+    if (record->value_size > cache->max_value_size ||
+        (record->codec != CACHE_CODEC_NONE && !catzilla_cache_codec_available(record->codec)) ||
+        (record->codec == CACHE_CODEC_NONE && record->stored_size != record->value_size)) {
+        return;
     }
 
-    catzilla_atomic_fetch_add(&cache->size, 1);
-    catzilla_atomic_fetch_add(&cache->stats.memory_usage, value_size + key_len + sizeof(cache_entry_t));
+    void* copy = cache_alloc(cache, record->stored_size > 0 ? (size_t)record->stored_size : 1);
+    if (!copy) {
+        return;
+    }
+    memcpy(copy, value, (size_t)record->stored_size);
 
-    catzilla_rwlock_unlock(&cache->rwlock);
-    return 0;
+    uint64_t now = get_timestamp_us();
+    uint64_t expires_at = now + (uint64_t)record->expires_us;
+    uint64_t stale_at = record->fresh_us > 0 ? now + (uint64_t)record->fresh_us : now;
+    if (shard_store(cache, key, record->key_len, hash_key(key, record->key_len), copy,
+                    (size_t)record->value_size, (size_t)record->stored_size, (uint8_t)record->codec,
+                    now, stale_at, expires_at, true) == 0) {
+        catzilla_atomic_fetch_add(&cache->restored, 1);
+    }
+}
+
+// Restore the snapshot bucket of a key before it is first used; must be
+// called without a shard lock held
+static void snapshot_fault(catzilla_cache_t* cache, uint32_t hash) {
+    if (catzilla_snapshot_pending(cache->snapshot)) {
+        catzilla_snapshot_restore(cache->snapshot, hash, restore_entry, cache);
+    }
+}
+
+// Set a value that is served stale for stale_ttl seconds after its TTL
+int catzilla_cache_set_ex(catzilla_cache_t* cache, const char* key, const void* value,
+                          size_t value_size, uint32_t ttl, uint32_t stale_ttl) {
+    if (!cache || !key || !value || value_size > cache->max_value_size) {
+        return -1;
+    }
+
+    size_t key_len = strlen(key);
+    uint32_t hash = hash_key(key, key_len);
+    snapshot_fault(cache, hash);
+    uint64_t now = get_timestamp_us();
+    if (ttl == 0) {
+        ttl = cache->default_ttl;
+    }
+    uint64_t stale_at = now + (uint64_t)ttl * 1000000; // Convert to microseconds
+    uint64_t expires_at = stale_at + (uint64_t)stale_ttl * 1000000;
+
+    // Compress or copy outside the lock; only pointers change under it
+    uint8_t codec = CACHE_CODEC_NONE;
+    size_t stored_size = value_size;
+    void* copy = compress_value(cache, value, value_size, &codec, &stored_size);
+    if (!copy) {
+        copy = cache_alloc(cache, value_size);
+        if (!copy) {
+            return -1;
+        }
+        memcpy(copy, value, value_size);
+    }
+
+    return shard_store(cache, key, key_len, hash, copy, value_size, stored_size, codec,
+                       now, stale_at, expires_at, false);
+}
+
+// Drop an entry found expired by a reader, unless it was replaced meanwhile
+static void shard_remove_expired(catzilla_cache_t* cache, cache_shard_t* shard,
+                                 const char* key, uint32_t hash, uint64_t now) {
+    catzilla_rwlock_wrlock(&shard->rwlock);
+    cache_entry_t* entry = shard_find(shard, key, hash);
+    if (entry && now > entry->expires_at) {
+        shard_remove(cache, shard, entry);
+    }
+    catzilla_rwlock_unlock(&shard->rwlock);
 }
 
 // Get a value from the cache
@@ -302,84 +858,202 @@ cache_result_t catzilla_cache_get(catzilla_cache_t* cache, const char* key) {
     cache_result_t result = {NULL, 0, false};
 
     if (!cache || !key) {
-        catzilla_atomic_fetch_add(&cache->stats.misses, 1);
         return result;
     }
 
     size_t key_len = strlen(key);
     uint32_t hash = hash_key(key, key_len);
-    uint32_t bucket_index = hash % cache->bucket_count;
+    snapshot_fault(cache, hash);
+    cache_shard_t* shard = shard_for(cache, hash);
     uint64_t now = get_timestamp_us();
+    bool expired = false;
+
+    catzilla_rwlock_rdlock(&shard->rwlock);
+    sketch_record(shard, hash);
+    cache_entry_t* entry = shard_find(shard, key, hash);
+    if (entry && now <= entry->expires_at) {
+        result.data = entry->codec == CACHE_CODEC_NONE ? entry->value
+                    : entry_decompress(entry, &read_scratch);
+        if (result.data) {
+            entry_touch(entry);
+            result.size = entry->value_size;
+            result.found = true;
+        }
+    } else if (entry) {
+        expired = true;
+    }
+    catzilla_rwlock_unlock(&shard->rwlock);
 
-    catzilla_rwlock_rdlock(&cache->rwlock);
+    if (expired) {
+        shard_remove_expired(cache, shard, key, hash, now);
+    }
+    catzilla_atomic_fetch_add(result.found ? &shard->hits : &shard->misses, 1);
+    if (result.found) {
+        CATZILLA_PROBE2(cache_hit, key, key_len);
+    } else {
+        CATZILLA_PROBE2(cache_miss, key, key_len);
+    }
+    return result;
+}
 
-    cache_entry_t* entry = cache->buckets[bucket_index];
-    while (entry) {
-        if (entry->hash == hash && strcmp(entry->key, key) == 0) {
-            // Check if expired
-            if (now > entry->expires_at) {
-                catzilla_rwlock_unlock(&cache->rwlock);
-
-                // Remove expired entry (requires write lock)
-                catzilla_rwlock_wrlock(&cache->rwlock);
-                // Re-find entry in case it was removed by another thread
-                cache_entry_t** current = &cache->buckets[bucket_index];
-                while (*current && (*current != entry || strcmp((*current)->key, key) != 0)) {
-                    current = &(*current)->next;
-                }
-                if (*current) {
-                    *current = entry->next;
-                    lru_remove(cache, entry);
-#ifdef JEMALLOC_ENABLED
-                    dallocx(entry->key, MALLOCX_ARENA(cache->arena_index));
-                    dallocx(entry->value, MALLOCX_ARENA(cache->arena_index));
-                    dallocx(entry, MALLOCX_ARENA(cache->arena_index));
-#else
-                    free(entry->key);
-                    free(entry->value);
-                    free(entry);
-#endif
-                    catzilla_atomic_fetch_sub(&cache->size, 1);
-                }
-                catzilla_rwlock_unlock(&cache->rwlock);
+// Copy an entry's value for the caller and mark the hit; holds the shard lock
+static void* entry_copy(cache_entry_t* entry, void* (*alloc_fn)(size_t), size_t* size_out) {
+    // Decompress before allocating: a failed copy cannot be freed here
+    const void* value = entry->codec == CACHE_CODEC_NONE ? entry->value
+                      : entry_decompress(entry, &work_scratch);
+    void* copy = value ? alloc_fn(entry->value_size > 0 ? entry->value_size : 1) : NULL;
+    if (copy) {
+        memcpy(copy, value, entry->value_size);
+        if (size_out) *size_out = entry->value_size;
+        entry_touch(entry);
+    }
+    return copy;
+}
 
-                catzilla_atomic_fetch_add(&cache->stats.misses, 1);
-                return result;
-            }
+// Retrieve a copy of a value made under the read lock
+void* catzilla_cache_get_copy(catzilla_cache_t* cache, const char* key,
+                              void* (*alloc_fn)(size_t), size_t* size_out) {
+    if (!cache || !key || !alloc_fn) {
+        return NULL;
+    }
 
-            // Found valid entry
-            entry->access_count++;
-            entry->last_access = now;
+    size_t key_len = strlen(key);
+    uint32_t hash = hash_key(key, key_len);
+    snapshot_fault(cache, hash);
+    cache_shard_t* shard = shard_for(cache, hash);
+    uint64_t now = get_timestamp_us();
+    void* copy = NULL;
+
+    catzilla_rwlock_rdlock(&shard->rwlock);
+    sketch_record(shard, hash);
+    cache_entry_t* entry = shard_find(shard, key, hash);
+    // Expired entries are left for catzilla_cache_get, eviction or expire_entries
+    if (entry && now <= entry->expires_at) {
+        copy = entry_copy(entry, alloc_fn, size_out);
+    }
+    catzilla_rwlock_unlock(&shard->rwlock);
 
-            result.data = entry->value;
-            result.size = entry->value_size;
-            result.found = true;
+    catzilla_atomic_fetch_add(copy ? &shard->hits : &shard->misses, 1);
+    if (copy) {
+        CATZILLA_PROBE2(cache_hit, key, key_len);
+    } else {
+        CATZILLA_PROBE2(cache_miss, key, key_len);
+    }
+    return copy;
+}
+
+static bool claim_held(const catzilla_cache_t* cache, uint64_t claimed_at, uint64_t now) {
+    return claimed_at != 0 && now - claimed_at < cache->fill_timeout_us;
+}
 
-            catzilla_rwlock_unlock(&cache->rwlock);
+// The read-locked part of a lookup: settles fresh values and stale ones
+// already being refreshed, which is nearly every call
+static void* lookup_shared(catzilla_cache_t* cache, cache_shard_t* shard, const char* key,
+                           uint32_t hash, uint64_t now, void* (*alloc_fn)(size_t),
+                           size_t* size_out, cache_lookup_state_t* state) {
+    void* copy = NULL;
+    catzilla_rwlock_rdlock(&shard->rwlock);
+    sketch_record(shard, hash);
+    cache_entry_t* entry = shard_find(shard, key, hash);
+    if (entry && now <= entry->expires_at &&
+        (now <= entry->stale_at || claim_held(cache, entry->refresh_claimed_at, now))) {
+        copy = entry_copy(entry, alloc_fn, size_out);
+        *state = now <= entry->stale_at ? CACHE_LOOKUP_FRESH : CACHE_LOOKUP_STALE;
+    }
+    catzilla_rwlock_unlock(&shard->rwlock);
+    return copy;
+}
 
-            // Move to front of LRU (requires write lock)
-            catzilla_rwlock_wrlock(&cache->rwlock);
-            lru_move_to_front(cache, entry);
-            catzilla_rwlock_unlock(&cache->rwlock);
+// Look a key up, handing misses and stale values to one caller at a time
+void* catzilla_cache_lookup(catzilla_cache_t* cache, const char* key,
+                            void* (*alloc_fn)(size_t), size_t* size_out,
+                            cache_lookup_state_t* state) {
+    if (!cache || !key || !alloc_fn || !state) {
+        return NULL;
+    }
 
-            catzilla_atomic_fetch_add(&cache->stats.hits, 1);
-            catzilla_atomic_fetch_add(&cache->stats.total_requests, 1);
+    size_t key_len = strlen(key);
+    uint32_t hash = hash_key(key, key_len);
+    snapshot_fault(cache, hash);
+    cache_shard_t* shard = shard_for(cache, hash);
+    uint64_t now = get_timestamp_us();
 
-            // Update hit ratio
-            uint64_t total_hits = catzilla_atomic_load(&cache->stats.hits);
-            uint64_t total_requests = catzilla_atomic_load(&cache->stats.total_requests);
-            cache->stats.hit_ratio = (double)total_hits / total_requests;
+    void* copy = lookup_shared(cache, shard, key, hash, now, alloc_fn, size_out, state);
+    if (copy) {
+        catzilla_atomic_fetch_add(&shard->hits, 1);
+        if (*state == CACHE_LOOKUP_STALE) catzilla_atomic_fetch_add(&shard->stale_hits, 1);
+        CATZILLA_PROBE2(cache_hit, key, key_len);
+        return copy;
+    }
 
-            return result;
+    // Claims change only under the write lock; check everything again
+    catzilla_rwlock_wrlock(&shard->rwlock);
+    cache_entry_t* entry = shard_find(shard, key, hash);
+    if (entry && now > entry->expires_at) {
+        shard_remove(cache, shard, entry);
+        entry = NULL;
+    }
+    if (entry) {
+        copy = entry_copy(entry, alloc_fn, size_out);
+        if (now <= entry->stale_at) {
+            *state = CACHE_LOOKUP_FRESH;
+        } else if (claim_held(cache, entry->refresh_claimed_at, now)) {
+            *state = CACHE_LOOKUP_STALE;
+        } else {
+            entry->refresh_claimed_at = now;
+            *state = CACHE_LOOKUP_REFRESH;
+        }
+    } else {
+        cache_fill_t* fill = shard_find_fill(shard, key, hash);
+        if (fill && claim_held(cache, fill->claimed_at, now)) {
+            *state = CACHE_LOOKUP_WAIT;
+        } else if (fill || (fill = shard_add_fill(shard, key, key_len, hash))) {
+            fill->claimed_at = now;
+            *state = CACHE_LOOKUP_FILL;
+        } else {
+            // Out of memory for the claim: compute without coalescing
+            *state = CACHE_LOOKUP_FILL;
         }
-        entry = entry->next;
     }
+    catzilla_rwlock_unlock(&shard->rwlock);
+
+    if (copy) {
+        catzilla_atomic_fetch_add(&shard->hits, 1);
+        if (*state != CACHE_LOOKUP_FRESH) catzilla_atomic_fetch_add(&shard->stale_hits, 1);
+        if (*state == CACHE_LOOKUP_REFRESH) catzilla_atomic_fetch_add(&shard->refreshes, 1);
+        CATZILLA_PROBE2(cache_hit, key, key_len);
+        return copy;
+    }
+    if (entry) {
+        // The copy failed; the caller computes the value but holds no claim
+        *state = CACHE_LOOKUP_FILL;
+    }
+    catzilla_atomic_fetch_add(&shard->misses, 1);
+    catzilla_atomic_fetch_add(*state == CACHE_LOOKUP_WAIT ? &shard->coalesced : &shard->fill_claims, 1);
+    CATZILLA_PROBE2(cache_miss, key, key_len);
+    return NULL;
+}
 
-    catzilla_rwlock_unlock(&cache->rwlock);
-    catzilla_atomic_fetch_add(&cache->stats.misses, 1);
-    catzilla_atomic_fetch_add(&cache->stats.total_requests, 1);
+// Drop a fill or refresh claim without storing
+int catzilla_cache_abandon(catzilla_cache_t* cache, const char* key) {
+    if (!cache || !key) {
+        return -1;
+    }
 
-    return result;
+    size_t key_len = strlen(key);
+    uint32_t hash = hash_key(key, key_len);
+    cache_shard_t* shard = shard_for(cache, hash);
+
+    catzilla_rwlock_wrlock(&shard->rwlock);
+    bool dropped = shard_drop_fill(shard, key, hash);
+    cache_entry_t* entry = shard_find(shard, key, hash);
+    if (entry && entry->refresh_claimed_at != 0) {
+        entry->refresh_claimed_at = 0;
+        dropped = true;
+    }
+    catzilla_rwlock_unlock(&shard->rwlock);
+
+    return dropped ? 0 : -1;
 }
 
 // Delete a key from the cache
@@ -390,37 +1064,17 @@ int catzilla_cache_delete(catzilla_cache_t* cache, const char* key) {
 
     size_t key_len = strlen(key);
     uint32_t hash = hash_key(key, key_len);
-    uint32_t bucket_index = hash % cache->bucket_count;
-
-    catzilla_rwlock_wrlock(&cache->rwlock);
-
-    cache_entry_t** current = &cache->buckets[bucket_index];
-    while (*current) {
-        if ((*current)->hash == hash && strcmp((*current)->key, key) == 0) {
-            cache_entry_t* entry = *current;
-            *current = entry->next;
-
-            lru_remove(cache, entry);
-
-#ifdef JEMALLOC_ENABLED
-            dallocx(entry->key, MALLOCX_ARENA(cache->arena_index));
-            dallocx(entry->value, MALLOCX_ARENA(cache->arena_index));
-            dallocx(entry, MALLOCX_ARENA(cache->arena_index));
-#else
-            free(entry->key);
-            free(entry->value);
-            free(entry);
-#endif
+    snapshot_fault(cache, hash);
+    cache_shard_t* shard = shard_for(cache, hash);
 
-            catzilla_atomic_fetch_sub(&cache->size, 1);
-            catzilla_rwlock_unlock(&cache->rwlock);
-            return 0;
-        }
-        current = &(*current)->next;
+    catzilla_rwlock_wrlock(&shard->rwlock);
+    cache_entry_t* entry = shard_find(shard, key, hash);
+    if (entry) {
+        shard_remove(cache, shard, entry);
     }
+    catzilla_rwlock_unlock(&shard->rwlock);
 
-    catzilla_rwlock_unlock(&cache->rwlock);
-    return -1; // Key not found
+    return entry ? 0 : -1;
 }
 
 // Get cache statistics
@@ -431,14 +1085,32 @@ cache_statistics_t catzilla_cache_get_stats(catzilla_cache_t* cache) {
         return stats;
     }
 
-    stats.hits = catzilla_atomic_load(&cache->stats.hits);
-    stats.misses = catzilla_atomic_load(&cache->stats.misses);
-    stats.evictions = catzilla_atomic_load(&cache->stats.evictions);
-    stats.memory_usage = catzilla_atomic_load(&cache->stats.memory_usage);
-    stats.total_requests = catzilla_atomic_load(&cache->stats.total_requests);
-    stats.hit_ratio = cache->stats.hit_ratio;
+    uint64_t hits = 0, misses = 0, evictions = 0, memory_usage = 0;
+    for (size_t i = 0; i < cache->shard_count; i++) {
+        cache_shard_t* shard = &cache->shards[i];
+        hits += catzilla_atomic_load(&shard->hits);
+        misses += catzilla_atomic_load(&shard->misses);
+        evictions += catzilla_atomic_load(&shard->evictions);
+        memory_usage += catzilla_atomic_load(&shard->memory_usage);
+        stats.compressed_entries += catzilla_atomic_load(&shard->compressed_entries);
+        stats.compressed_bytes += catzilla_atomic_load(&shard->compressed_bytes);
+        stats.uncompressed_bytes += catzilla_atomic_load(&shard->uncompressed_bytes);
+        stats.fills += catzilla_atomic_load(&shard->fill_claims);
+        stats.coalesced += catzilla_atomic_load(&shard->coalesced);
+        stats.stale_hits += catzilla_atomic_load(&shard->stale_hits);
+        stats.refreshes += catzilla_atomic_load(&shard->refreshes);
+        stats.rejections += catzilla_atomic_load(&shard->rejections);
+    }
+
+    stats.hits = hits;
+    stats.misses = misses;
+    stats.evictions = evictions;
+    stats.memory_usage = memory_usage;
+    stats.total_requests = hits + misses;
+    stats.hit_ratio = hits + misses > 0 ? (double)hits / (double)(hits + misses) : 0.0;
     stats.size = catzilla_atomic_load(&cache->size);
     stats.capacity = cache->capacity;
+    stats.restored = catzilla_atomic_load(&cache->restored);
 
     return stats;
 }
@@ -449,32 +1121,15 @@ void catzilla_cache_clear(catzilla_cache_t* cache) {
         return;
     }
 
-    catzilla_rwlock_wrlock(&cache->rwlock);
+    // Entries not restored yet are cleared as well
+    catzilla_snapshot_discard(cache->snapshot);
 
-    for (size_t i = 0; i < cache->bucket_count; i++) {
-        cache_entry_t* entry = cache->buckets[i];
-        while (entry) {
-            cache_entry_t* next = entry->next;
-#ifdef JEMALLOC_ENABLED
-            dallocx(entry->key, MALLOCX_ARENA(cache->arena_index));
-            dallocx(entry->value, MALLOCX_ARENA(cache->arena_index));
-            dallocx(entry, MALLOCX_ARENA(cache->arena_index));
-#else
-            free(entry->key);
-            free(entry->value);
-            free(entry);
-#endif
-            entry = next;
-        }
-        cache->buckets[i] = NULL;
+    for (size_t i = 0; i < cache->shard_count; i++) {
+        cache_shard_t* shard = &cache->shards[i];
+        catzilla_rwlock_wrlock(&shard->rwlock);
+        shard_clear(cache, shard);
+        catzilla_rwlock_unlock(&shard->rwlock);
     }
-
-    cache->lru_head = NULL;
-    cache->lru_tail = NULL;
-    catzilla_atomic_store(&cache->size, 0);
-    catzilla_atomic_store(&cache->stats.memory_usage, 0);
-
-    catzilla_rwlock_unlock(&cache->rwlock);
 }
 
 // Destroy the cache and free all memory
@@ -485,8 +1140,20 @@ void catzilla_cache_destroy(catzilla_cache_t* cache) {
 
     catzilla_cache_clear(cache);
 
-    catzilla_rwlock_destroy(&cache->rwlock);
-    free(cache->buckets);
+    for (size_t i = 0; i < cache->shard_count; i++) {
+        cache_fill_t* fill = cache->shards[i].fills;
+        while (fill) {
+            cache_fill_t* next = fill->next;
+            free(fill->key);
+            free(fill);
+            fill = next;
+        }
+        catzilla_rwlock_destroy(&cache->shards[i].rwlock);
+        free(cache->shards[i].buckets);
+        free((void*)cache->shards[i].sketch);
+    }
+    free(cache->shards);
+    catzilla_snapshot_close(cache->snapshot);
 
 #ifdef JEMALLOC_ENABLED
     // Destroy jemalloc arena
@@ -508,23 +1175,15 @@ bool catzilla_cache_exists(catzilla_cache_t* cache, const char* key) {
 
     size_t key_len = strlen(key);
     uint32_t hash = hash_key(key, key_len);
-    uint32_t bucket_index = hash % cache->bucket_count;
+    snapshot_fault(cache, hash);
+    cache_shard_t* shard = shard_for(cache, hash);
     uint64_t now = get_timestamp_us();
 
-    catzilla_rwlock_rdlock(&cache->rwlock);
-
-    cache_entry_t* entry = cache->buckets[bucket_index];
-    while (entry) {
-        if (entry->hash == hash && strcmp(entry->key, key) == 0) {
-            bool exists = (now <= entry->expires_at);
-            catzilla_rwlock_unlock(&cache->rwlock);
-            return exists;
-        }
-        entry = entry->next;
-    }
-
-    catzilla_rwlock_unlock(&cache->rwlock);
-    return false;
+    catzilla_rwlock_rdlock(&shard->rwlock);
+    cache_entry_t* entry = shard_find(shard, key, hash);
+    bool exists = entry && now <= entry->expires_at;
+    catzilla_rwlock_unlock(&shard->rwlock);
+    return exists;
 }
 
 // Create cache with custom configuration
@@ -539,7 +1198,7 @@ catzilla_cache_t* catzilla_cache_create_with_config(const cache_config_t* config
         if (bucket_count < 16) bucket_count = 16;
     }
 
-    catzilla_cache_t* cache = catzilla_cache_create(config->capacity, bucket_count);
+    catzilla_cache_t* cache = cache_create_sharded(config->capacity, bucket_count, config->shard_count);
     if (!cache) {
         return NULL;
     }
@@ -547,6 +1206,21 @@ catzilla_cache_t* catzilla_cache_create_with_config(const cache_config_t* config
     cache->default_ttl = config->default_ttl;
     cache->max_value_size = config->max_value_size;
     cache->compression_enabled = config->compression_enabled;
+    cache->codec = resolve_codec(config->compression_enabled, config->codec);
+    cache->compression_threshold = config->compression_threshold > 0
+        ? config->compression_threshold : CATZILLA_CACHE_COMPRESSION_THRESHOLD;
+    cache->fill_timeout_us = (uint64_t)(config->fill_timeout_ms > 0
+        ? config->fill_timeout_ms : CATZILLA_CACHE_FILL_TIMEOUT_MS) * 1000;
+
+    if (config->eviction_policy == CACHE_EVICTION_TINYLFU) {
+        cache->eviction_policy = CACHE_EVICTION_TINYLFU;
+        for (size_t i = 0; i < cache->shard_count; i++) {
+            if (shard_size_regions(&cache->shards[i]) != 0) {
+                catzilla_cache_destroy(cache);
+                return NULL;
+            }
+        }
+    }
 
     return cache;
 }
@@ -560,46 +1234,48 @@ size_t catzilla_cache_expire_entries(catzilla_cache_t* cache) {
     size_t expired_count = 0;
     uint64_t now = get_timestamp_us();
 
-    catzilla_rwlock_wrlock(&cache->rwlock);
-
-    for (size_t i = 0; i < cache->bucket_count; i++) {
-        cache_entry_t** current = &cache->buckets[i];
-
-        while (*current) {
-            if (now > (*current)->expires_at) {
-                cache_entry_t* entry = *current;
-                *current = entry->next;
-
-                lru_remove(cache, entry);
-
-#ifdef JEMALLOC_ENABLED
-                dallocx(entry->key, MALLOCX_ARENA(cache->arena_index));
-                dallocx(entry->value, MALLOCX_ARENA(cache->arena_index));
-                dallocx(entry, MALLOCX_ARENA(cache->arena_index));
-#else
-                free(entry->key);
-                free(entry->value);
-                free(entry);
-#endif
-
-                catzilla_atomic_fetch_sub(&cache->size, 1);
-                expired_count++;
-            } else {
-                current = &(*current)->next;
+    for (size_t s = 0; s < cache->shard_count; s++) {
+        cache_shard_t* shard = &cache->shards[s];
+        catzilla_rwlock_wrlock(&shard->rwlock);
+        for (size_t i = 0; i < shard->bucket_count; i++) {
+            cache_entry_t* entry = shard->buckets[i];
+            while (entry) {
+                cache_entry_t* next = entry->next;
+                if (now > entry->expires_at) {
+                    shard_remove(cache, shard, entry);
+                    expired_count++;
+                }
+                entry = next;
             }
         }
+        catzilla_rwlock_unlock(&shard->rwlock);
     }
 
-    catzilla_rwlock_unlock(&cache->rwlock);
     return expired_count;
 }
 
 // Get cache memory usage
 size_t catzilla_cache_memory_usage(catzilla_cache_t* cache) {
-    if (!cache) {
-        return 0;
+    return (size_t)catzilla_cache_get_stats(cache).memory_usage;
+}
+
+// Give each shard its part of a new capacity, evicting what no longer fits
+static void cache_set_capacity(catzilla_cache_t* cache, size_t new_capacity) {
+    uint64_t now = get_timestamp_us();
+    for (size_t i = 0; i < cache->shard_count; i++) {
+        cache_shard_t* shard = &cache->shards[i];
+        catzilla_rwlock_wrlock(&shard->rwlock);
+        shard->capacity = shard_capacity(new_capacity, cache->shard_count, i);
+        if (cache->eviction_policy == CACHE_EVICTION_TINYLFU) {
+            shard_size_regions(shard);
+            shard_evict_tinylfu(cache, shard, now);
+        }
+        while (shard->size > shard->capacity && shard->clock_hand) {
+            shard_evict(cache, shard, now);
+        }
+        catzilla_rwlock_unlock(&shard->rwlock);
     }
-    return catzilla_atomic_load(&cache->stats.memory_usage);
+    cache->capacity = new_capacity;
 }
 
 // Resize cache capacity
@@ -607,20 +1283,84 @@ int catzilla_cache_resize(catzilla_cache_t* cache, size_t new_capacity) {
     if (!cache) {
         return -1;
     }
+    cache_set_capacity(cache, new_capacity);
+    return 0;
+}
 
-    catzilla_rwlock_wrlock(&cache->rwlock);
+// Restores run on every bucket of a snapshot before it is replaced
+static void snapshot_restore_all(catzilla_cache_t* cache) {
+    if (catzilla_snapshot_pending(cache->snapshot)) {
+        catzilla_snapshot_restore_next(cache->snapshot, SIZE_MAX, restore_entry, cache);
+    }
+}
 
-    // If reducing capacity, evict entries as needed
-    while (catzilla_atomic_load(&cache->size) > new_capacity) {
-        evict_lru(cache);
+int catzilla_cache_save_snapshot(catzilla_cache_t* cache, const char* path) {
+    if (!cache || !path) {
+        return -1;
     }
 
-    cache->capacity = new_capacity;
-    catzilla_rwlock_unlock(&cache->rwlock);
+    snapshot_restore_all(cache);
+
+    // About eight records per snapshot bucket
+    uint32_t bucket_count = (uint32_t)(catzilla_atomic_load(&cache->size) / 8 + 1);
+    catzilla_snapshot_writer_t* writer = catzilla_snapshot_writer_open(path, CATZILLA_SNAPSHOT_KIND_CACHE,
+                                                                      bucket_count);
+    if (!writer) {
+        return -1;
+    }
 
+    int rc = 0;
+    uint64_t now = get_timestamp_us();
+    for (size_t i = 0; i < cache->shard_count && rc == 0; i++) {
+        cache_shard_t* shard = &cache->shards[i];
+        catzilla_rwlock_rdlock(&shard->rwlock);
+        for (size_t b = 0; b < shard->bucket_count && rc == 0; b++) {
+            for (cache_entry_t* entry = shard->buckets[b]; entry && rc == 0; entry = entry->next) {
+                if (now >= entry->expires_at) {
+                    continue;
+                }
+                catzilla_snapshot_record_t record = {0};
+                record.hash = entry->hash;
+                record.key_len = (uint32_t)strlen(entry->key);
+                record.value_size = entry->value_size;
+                record.stored_size = entry->stored_size;
+                record.codec = entry->codec;
+                record.fresh_us = (int64_t)entry->stale_at - (int64_t)now;
+                record.expires_us = (int64_t)(entry->expires_at - now);
+                rc = catzilla_snapshot_writer_add(writer, &record, entry->key, entry->value);
+            }
+        }
+        catzilla_rwlock_unlock(&shard->rwlock);
+    }
+
+    if (rc != 0) {
+        catzilla_snapshot_writer_abort(writer);
+        return -1;
+    }
+    return catzilla_snapshot_writer_commit(writer);
+}
+
+int catzilla_cache_load_snapshot(catzilla_cache_t* cache, const char* path) {
+    if (!cache || !path || catzilla_snapshot_pending(cache->snapshot)) {
+        return -1;
+    }
+
+    catzilla_snapshot_t* snapshot = catzilla_snapshot_open(path, CATZILLA_SNAPSHOT_KIND_CACHE);
+    if (!snapshot) {
+        return -1;
+    }
+    catzilla_snapshot_close(cache->snapshot);
+    cache->snapshot = snapshot;
     return 0;
 }
 
+size_t catzilla_cache_restore_pending(catzilla_cache_t* cache, size_t max_buckets) {
+    if (!cache || !catzilla_snapshot_pending(cache->snapshot)) {
+        return 0;
+    }
+    return catzilla_snapshot_restore_next(cache->snapshot, max_buckets, restore_entry, cache);
+}
+
 // Generate cache key from request components
 int catzilla_cache_generate_key(const char* method, const char* path,
                                 const char* query_string, uint32_t headers_hash,
@@ -661,20 +1401,402 @@ int catzilla_cache_configure(catzilla_cache_t* cache, const cache_config_t* conf
         return -1;
     }
 
-    catzilla_rwlock_wrlock(&cache->rwlock);
-
     cache->default_ttl = config->default_ttl;
     cache->max_value_size = config->max_value_size;
     cache->compression_enabled = config->compression_enabled;
+    cache->codec = resolve_codec(config->compression_enabled, config->codec);
+    cache->compression_threshold = config->compression_threshold > 0
+        ? config->compression_threshold : CATZILLA_CACHE_COMPRESSION_THRESHOLD;
+    cache->fill_timeout_us = (uint64_t)(config->fill_timeout_ms > 0
+        ? config->fill_timeout_ms : CATZILLA_CACHE_FILL_TIMEOUT_MS) * 1000;
 
-    // Resize if needed
+    // The shard count is fixed at creation; capacity is split again
     if (config->capacity != cache->capacity) {
-        while (catzilla_atomic_load(&cache->size) > config->capacity) {
-            evict_lru(cache);
-        }
-        cache->capacity = config->capacity;
+        cache_set_capacity(cache, config->capacity);
+    }
+    return 0;
+}
+
+// ============================================================================
+// Multi-Level Cache
+// ============================================================================
+
+#define MULTI_CACHE_REDIS_TTL (24 * 3600)
+#define MULTI_CACHE_DISK_TTL (7 * 24 * 3600)
+#define MULTI_CACHE_REDIS_PREFIX "catzilla:"
+
+// A loop thread and its client. A slot is only written by its own thread
+// (under the lock), so a reader finds its client without locking.
+typedef struct {
+    uv_thread_t thread;
+    catzilla_redis_t* volatile client;
+} multi_cache_redis_slot_t;
+
+struct multi_cache_redis_s {
+    char* url;
+    char* key_prefix;
+    size_t key_prefix_len;
+    catzilla_redis_config_t config;
+    uv_mutex_t lock;
+    volatile int slot_count;
+    multi_cache_redis_slot_t slots[MULTI_CACHE_MAX_REDIS_LOOPS];
+};
+
+// Remote lookup in flight; the key is kept to promote a hit into L1
+typedef struct {
+    multi_cache_t* cache;
+    multi_cache_fetch_cb callback;
+    void* data;
+    char key[];
+} multi_cache_fetch_t;
+
+// A tier keeps a value for its own TTL, or less when the caller asks for less
+static uint32_t tier_ttl(uint32_t tier, uint32_t ttl) {
+    return ttl != 0 && (tier == 0 || ttl < tier) ? ttl : tier;
+}
+
+multi_cache_t* multi_cache_create(const cache_config_t* memory_config,
+                                  const char* redis_url, const char* disk_path) {
+    multi_cache_t* cache = calloc(1, sizeof(multi_cache_t));
+    if (!cache) {
+        return NULL;
+    }
+
+    cache_config_t defaults = { 10000, 0, 0, 3600, 100 * 1024 * 1024, false, false, CACHE_CODEC_NONE, 0, 0, CACHE_EVICTION_CLOCK };
+    cache->memory_cache = catzilla_cache_create_with_config(memory_config ? memory_config : &defaults);
+    if (!cache->memory_cache) {
+        free(cache);
+        return NULL;
     }
+    cache->memory_ttl = cache->memory_cache->default_ttl;
+    cache->redis_ttl = MULTI_CACHE_REDIS_TTL;
+    cache->disk_ttl = MULTI_CACHE_DISK_TTL;
 
-    catzilla_rwlock_unlock(&cache->rwlock);
+    if (redis_url && multi_cache_enable_redis(cache, redis_url, NULL, NULL) != 0) {
+        multi_cache_destroy(cache);
+        return NULL;
+    }
+
+    if (disk_path && multi_cache_attach_disk(cache, disk_path, NULL) != 0) {
+        multi_cache_destroy(cache);
+        return NULL;
+    }
+
+    return cache;
+}
+
+int multi_cache_attach_disk(multi_cache_t* cache, const char* disk_path,
+                            const catzilla_disk_cache_config_t* config) {
+    if (!cache || !disk_path || cache->disk_enabled) {
+        return -1;
+    }
+
+    cache->disk_cache_path = strdup(disk_path);
+    cache->disk_cache = cache->disk_cache_path ? catzilla_disk_cache_open(disk_path, config) : NULL;
+    if (!cache->disk_cache) {
+        free(cache->disk_cache_path);
+        cache->disk_cache_path = NULL;
+        return -1;
+    }
+    cache->disk_enabled = true;
+    return 0;
+}
+
+int multi_cache_enable_redis(multi_cache_t* cache, const char* redis_url, const char* key_prefix,
+                             const catzilla_redis_config_t* config) {
+    if (!cache || !redis_url || cache->redis_enabled) {
+        return -1;
+    }
+    if (!catzilla_redis_url_valid(redis_url)) {
+        LOG_CACHE_ERROR("Invalid Redis URL (expected redis://[[user]:password@]host[:port][/db])");
+        return -1;
+    }
+
+    struct multi_cache_redis_s* redis = calloc(1, sizeof(*redis));
+    if (!redis) {
+        return -1;
+    }
+    redis->url = strdup(redis_url);
+    redis->key_prefix = strdup(key_prefix ? key_prefix : MULTI_CACHE_REDIS_PREFIX);
+    if (!redis->url || !redis->key_prefix || uv_mutex_init(&redis->lock) != 0) {
+        free(redis->url);
+        free(redis->key_prefix);
+        free(redis);
+        return -1;
+    }
+    redis->key_prefix_len = strlen(redis->key_prefix);
+    if (config) {
+        redis->config = *config;
+    }
+
+    cache->redis_connection = redis;
+    cache->redis_enabled = true;
     return 0;
 }
+
+int multi_cache_attach_redis_loop(multi_cache_t* cache, struct uv_loop_s* loop) {
+    if (!cache || !cache->redis_enabled) {
+        return 0;
+    }
+    struct multi_cache_redis_s* redis = cache->redis_connection;
+    uv_thread_t self = uv_thread_self();
+    int rc = -1;
+
+    uv_mutex_lock(&redis->lock);
+    int free_slot = -1;
+    for (int i = 0; i < redis->slot_count; i++) {
+        if (!redis->slots[i].client) {
+            if (free_slot < 0) free_slot = i;
+        } else if (uv_thread_equal(&redis->slots[i].thread, &self)) {
+            free_slot = -2;  // Already attached
+            break;
+        }
+    }
+    if (free_slot == -2) {
+        rc = 0;
+    } else if (free_slot >= 0 || redis->slot_count < MULTI_CACHE_MAX_REDIS_LOOPS) {
+        catzilla_redis_t* client = catzilla_redis_create(loop, redis->url, &redis->config);
+        if (client) {
+            int index = free_slot >= 0 ? free_slot : redis->slot_count;
+            redis->slots[index].thread = self;
+            catzilla_atomic_fence();
+            redis->slots[index].client = client;
+            if (index == redis->slot_count) {
+                catzilla_atomic_store_seq(&redis->slot_count, index + 1);
+            }
+            rc = 0;
+        }
+    }
+    uv_mutex_unlock(&redis->lock);
+    return rc;
+}
+
+// Client of the calling loop thread, NULL on other threads
+static catzilla_redis_t* current_redis_client(multi_cache_t* cache) {
+    struct multi_cache_redis_s* redis = cache->redis_connection;
+    if (!redis) {
+        return NULL;
+    }
+
+    uv_thread_t self = uv_thread_self();
+    int count = catzilla_atomic_load_seq(&redis->slot_count);
+    for (int i = 0; i < count; i++) {
+        catzilla_redis_t* client = redis->slots[i].client;
+        if (client && uv_thread_equal(&redis->slots[i].thread, &self)) {
+            return client;
+        }
+    }
+    return NULL;
+}
+
+void multi_cache_detach_redis_loop(multi_cache_t* cache) {
+    if (!cache || !cache->redis_enabled) {
+        return;
+    }
+    struct multi_cache_redis_s* redis = cache->redis_connection;
+
+    uv_mutex_lock(&redis->lock);
+    catzilla_redis_t* client = current_redis_client(cache);
+    for (int i = 0; client && i < redis->slot_count; i++) {
+        if (redis->slots[i].client == client) {
+            redis->slots[i].client = NULL;
+        }
+    }
+    uv_mutex_unlock(&redis->lock);
+    catzilla_redis_close(client);
+}
+
+// Redis key: prefix + key, in buffer when it fits, otherwise malloc'd
+static char* redis_key(const struct multi_cache_redis_s* redis, const char* key,
+                       char* buffer, size_t buffer_size, size_t* length) {
+    size_t key_len = strlen(key);
+    *length = redis->key_prefix_len + key_len;
+    char* out = *length < buffer_size ? buffer : malloc(*length + 1);
+    if (out) {
+        memcpy(out, redis->key_prefix, redis->key_prefix_len);
+        memcpy(out + redis->key_prefix_len, key, key_len + 1);
+    }
+    return out;
+}
+
+static void on_remote_value(void* data, bool ok, const void* value, size_t size, int64_t ttl_ms) {
+    (void)ok;
+    multi_cache_fetch_t* fetch = data;
+    multi_cache_t* cache = fetch->cache;
+
+    if (value) {
+        // L1 keeps it no longer than Redis does
+        uint32_t left = ttl_ms > 0 ? (uint32_t)(ttl_ms / 1000) : 0;
+        if (ttl_ms >= 0 && left == 0) left = 1;
+        catzilla_cache_set(cache->memory_cache, fetch->key, value, size, tier_ttl(cache->memory_ttl, left));
+    }
+    fetch->callback(fetch->data, value, value ? size : 0);
+    free(fetch);
+}
+
+int multi_cache_fetch_remote(multi_cache_t* cache, const char* key,
+                             multi_cache_fetch_cb callback, void* data) {
+    if (!cache || !key || !callback) {
+        return -1;
+    }
+    catzilla_redis_t* client = current_redis_client(cache);
+    if (!client) {
+        return -1;
+    }
+
+    size_t key_len = strlen(key);
+    multi_cache_fetch_t* fetch = malloc(sizeof(*fetch) + key_len + 1);
+    if (!fetch) {
+        return -1;
+    }
+    fetch->cache = cache;
+    fetch->callback = callback;
+    fetch->data = data;
+    memcpy(fetch->key, key, key_len + 1);
+
+    char buffer[512];
+    size_t length;
+    char* remote_key = redis_key(cache->redis_connection, key, buffer, sizeof(buffer), &length);
+    int rc = remote_key ? catzilla_redis_get(client, remote_key, length, on_remote_value, fetch) : -1;
+    if (remote_key != buffer) free(remote_key);
+    if (rc != 0) {
+        free(fetch);
+    }
+    return rc;
+}
+
+// Copy a disk entry into L1 for at most the time it has left on disk
+static void promote_from_disk(multi_cache_t* cache, const char* key, const catzilla_disk_ref_t* ref) {
+    uint32_t ttl = cache->memory_ttl;
+    if (ref->expires_at != 0) {
+        uint64_t now = (uint64_t)time(NULL);
+        uint64_t left = ref->expires_at > now ? ref->expires_at - now : 1;
+        if (ttl == 0 || left < ttl) ttl = (uint32_t)left;
+    }
+    catzilla_cache_set(cache->memory_cache, key, ref->data, ref->size, ttl);
+}
+
+cache_result_t multi_cache_get(multi_cache_t* cache, const char* key) {
+    cache_result_t result = {NULL, 0, false};
+    if (!cache || !key) {
+        return result;
+    }
+
+    result = catzilla_cache_get(cache->memory_cache, key);
+    if (result.found || !cache->disk_enabled) {
+        return result;
+    }
+
+    catzilla_disk_ref_t ref;
+    if (catzilla_disk_cache_get(cache->disk_cache, key, &ref)) {
+        promote_from_disk(cache, key, &ref);
+        catzilla_disk_cache_release(cache->disk_cache, &ref);
+        result = catzilla_cache_get(cache->memory_cache, key);
+    }
+    return result;
+}
+
+void* multi_cache_get_copy(multi_cache_t* cache, const char* key,
+                           void* (*alloc_fn)(size_t), size_t* size_out) {
+    if (!cache || !key || !alloc_fn) {
+        return NULL;
+    }
+
+    void* copy = catzilla_cache_get_copy(cache->memory_cache, key, alloc_fn, size_out);
+    if (copy || !cache->disk_enabled) {
+        return copy;
+    }
+
+    // Copied straight out of the segment mapping while it is pinned
+    catzilla_disk_ref_t ref;
+    if (catzilla_disk_cache_get(cache->disk_cache, key, &ref)) {
+        copy = alloc_fn(ref.size > 0 ? ref.size : 1);
+        if (copy) {
+            memcpy(copy, ref.data, ref.size);
+            if (size_out) *size_out = ref.size;
+        }
+        promote_from_disk(cache, key, &ref);
+        catzilla_disk_cache_release(cache->disk_cache, &ref);
+    }
+    return copy;
+}
+
+int multi_cache_set(multi_cache_t* cache, const char* key, const void* value,
+                    size_t value_size, uint32_t ttl) {
+    if (!cache || !key || !value) {
+        return -1;
+    }
+
+    // L1 refuses values over its size limit; the disk tier can still hold them
+    int memory_rc = catzilla_cache_set(cache->memory_cache, key, value, value_size,
+                                       tier_ttl(cache->memory_ttl, ttl));
+    int disk_rc = -1;
+    if (cache->disk_enabled) {
+        disk_rc = catzilla_disk_cache_put(cache->disk_cache, key, value, value_size,
+                                          tier_ttl(cache->disk_ttl, ttl));
+    }
+    int redis_rc = -1;
+    catzilla_redis_t* client = current_redis_client(cache);
+    if (client) {
+        char buffer[512];
+        size_t length;
+        char* remote_key = redis_key(cache->redis_connection, key, buffer, sizeof(buffer), &length);
+        if (remote_key) {
+            redis_rc = catzilla_redis_set(client, remote_key, length, value, value_size,
+                                          tier_ttl(cache->redis_ttl, ttl));
+            if (remote_key != buffer) free(remote_key);
+        }
+    }
+    return memory_rc == 0 || disk_rc == 0 || redis_rc == 0 ? 0 : -1;
+}
+
+int multi_cache_delete(multi_cache_t* cache, const char* key) {
+    if (!cache || !key) {
+        return -1;
+    }
+
+    int memory_rc = catzilla_cache_delete(cache->memory_cache, key);
+    int disk_rc = cache->disk_enabled ? catzilla_disk_cache_delete(cache->disk_cache, key) : -1;
+    int redis_rc = -1;
+    catzilla_redis_t* client = current_redis_client(cache);
+    if (client) {
+        char buffer[512];
+        size_t length;
+        char* remote_key = redis_key(cache->redis_connection, key, buffer, sizeof(buffer), &length);
+        if (remote_key) {
+            redis_rc = catzilla_redis_del(client, remote_key, length);
+            if (remote_key != buffer) free(remote_key);
+        }
+    }
+    return memory_rc == 0 || disk_rc == 0 || redis_rc == 0 ? 0 : -1;
+}
+
+void multi_cache_clear(multi_cache_t* cache) {
+    if (!cache) {
+        return;
+    }
+
+    catzilla_cache_clear(cache->memory_cache);
+    if (cache->disk_enabled) {
+        catzilla_disk_cache_clear(cache->disk_cache);
+    }
+}
+
+void multi_cache_destroy(multi_cache_t* cache) {
+    if (!cache) {
+        return;
+    }
+
+    struct multi_cache_redis_s* redis = cache->redis_connection;
+    if (redis) {
+        // Clients belong to their loops, which detached them already
+        uv_mutex_destroy(&redis->lock);
+        free(redis->url);
+        free(redis->key_prefix);
+        free(redis);
+    }
+    catzilla_disk_cache_close(cache->disk_cache);
+    free(cache->disk_cache_path);
+    catzilla_cache_destroy(cache->memory_cache);
+    free(cache);
+}
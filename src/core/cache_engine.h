@@ -20,20 +20,32 @@ extern "C" {
 // Forward declarations
 typedef struct cache_entry cache_entry_t;
 typedef struct catzilla_cache catzilla_cache_t;
+struct catzilla_disk_cache_s;
+struct catzilla_disk_cache_config_s;
+struct catzilla_redis_config_s;
+struct multi_cache_redis_s;
+struct catzilla_snapshot_s;
+struct uv_loop_s;
 
 // Cache entry structure
 struct cache_entry {
     char* key;                    // Cache key (jemalloc allocated)
-    void* value;                  // Serialized response data
-    size_t value_size;           // Size of cached data
+    void* value;                  // Serialized response data, compressed when codec is set
+    size_t value_size;           // Size of cached data as stored by the caller
+    size_t stored_size;          // Bytes held in value (value_size unless compressed)
+    uint8_t codec;               // cache_codec_t the value is compressed with
     uint64_t created_at;         // Creation timestamp (microseconds)
     uint64_t expires_at;         // Expiration timestamp (microseconds)
-    uint32_t access_count;       // LRU tracking
-    uint64_t last_access;        // Last access time (microseconds)
+    uint64_t stale_at;           // Served stale past this, until expires_at
+    uint64_t refresh_claimed_at; // When a caller took the refresh of a stale value, 0 if none
+    uint32_t access_count;       // Number of stores of this key
+    uint64_t last_access;        // Last store time (microseconds)
     uint32_t hash;               // Pre-computed hash for fast lookup
+    volatile uint32_t referenced; // CLOCK access bit, set by hits under the read lock
+    uint8_t region;              // cache_region_t ring the entry is on
     struct cache_entry* next;    // Hash table chaining
-    struct cache_entry* lru_prev; // LRU doubly-linked list
-    struct cache_entry* lru_next;
+    struct cache_entry* clock_prev; // CLOCK ring of the shard
+    struct cache_entry* clock_next;
 };
 
 // Cache statistics structure
@@ -46,8 +58,56 @@ typedef struct cache_statistics {
     double hit_ratio;
     uint64_t size;              // Current number of entries
     uint64_t capacity;          // Maximum number of entries
+    uint64_t compressed_entries; // Entries held compressed
+    uint64_t compressed_bytes;  // Bytes those entries hold
+    uint64_t uncompressed_bytes; // Bytes they would hold uncompressed
+    uint64_t fills;             // Misses handed to a caller to compute
+    uint64_t coalesced;         // Misses told to wait for a fill in progress
+    uint64_t stale_hits;        // Stale values served
+    uint64_t refreshes;         // Stale values handed to a caller to refresh
+    uint64_t rejections;        // New entries the TinyLFU filter evicted instead of older ones
+    uint64_t restored;          // Entries restored from a snapshot
 } cache_statistics_t;
 
+/**
+ * Value compression. A compressed value is decompressed on every read into
+ * a buffer owned by the reading thread.
+ */
+typedef enum cache_codec {
+    CACHE_CODEC_NONE = 0,
+    CACHE_CODEC_LZ4 = 1,        // Fast; the default when available
+    CACHE_CODEC_ZSTD = 2        // Denser, slower to compress
+} cache_codec_t;
+
+// Values smaller than this stay uncompressed unless configured otherwise
+#define CATZILLA_CACHE_COMPRESSION_THRESHOLD 1024
+
+/**
+ * Outcome of catzilla_cache_lookup. A caller told to fill or refresh a key
+ * holds a claim on it until it stores the key or abandons the claim; other
+ * callers meanwhile wait (misses) or get the stale value (soft-expired keys).
+ * A claim lapses after the fill timeout, so a caller that never finishes
+ * cannot hold a key forever.
+ */
+typedef enum cache_lookup_state {
+    CACHE_LOOKUP_FRESH = 0,     // Value returned, within its TTL
+    CACHE_LOOKUP_STALE,         // Stale value returned; another caller is refreshing it
+    CACHE_LOOKUP_REFRESH,       // Stale value returned; the caller must refresh it
+    CACHE_LOOKUP_FILL,          // No value; the caller must compute and store it
+    CACHE_LOOKUP_WAIT           // No value; another caller is computing it, retry shortly
+} cache_lookup_state_t;
+
+// Missing or stale key claimed by one caller
+typedef struct cache_fill {
+    char* key;
+    uint32_t hash;
+    uint64_t claimed_at;         // Microseconds
+    struct cache_fill* next;
+} cache_fill_t;
+
+// How long a fill or refresh claim holds by default
+#define CATZILLA_CACHE_FILL_TIMEOUT_MS 10000
+
 // Cache result structure
 typedef struct cache_result {
     void* data;                 // Pointer to cached data (do not free!)
@@ -55,19 +115,86 @@ typedef struct cache_result {
     bool found;                // Whether the key was found
 } cache_result_t;
 
-// Main cache structure
-struct catzilla_cache {
+/**
+ * Eviction policies. CLOCK keeps one ring per shard and gives referenced
+ * entries a second chance. W-TinyLFU puts new entries in a small window
+ * ring; an entry leaving the window replaces the main region's victim only
+ * if a count-min sketch has seen its key more often, so one-off scans do
+ * not flush keys that are hit again and again. The main region is split
+ * into probation and a protected segment for entries hit while on
+ * probation. Hits only mark entries; entries change rings on eviction.
+ */
+typedef enum cache_eviction_policy {
+    CACHE_EVICTION_CLOCK = 0,
+    CACHE_EVICTION_TINYLFU = 1
+} cache_eviction_policy_t;
+
+// Rings an entry can be on; CLOCK shards use the main ring only
+typedef enum cache_region {
+    CACHE_REGION_MAIN = 0,       // CLOCK ring, or TinyLFU probation
+    CACHE_REGION_WINDOW = 1,     // TinyLFU admission window
+    CACHE_REGION_PROTECTED = 2   // TinyLFU entries hit while on probation
+} cache_region_t;
+
+#define CACHE_REGION_COUNT 3
+
+// W-TinyLFU sizing: window and protected shares of a shard, sketch depth
+#define CATZILLA_CACHE_WINDOW_PERCENT 1
+#define CATZILLA_CACHE_PROTECTED_PERCENT 80
+#define CATZILLA_CACHE_SKETCH_DEPTH 4
+// Counters are halved after this many recorded accesses per entry of capacity
+#define CATZILLA_CACHE_SKETCH_SAMPLE 10
+
+/**
+ * One independent part of a cache: keys hash to exactly one shard, which has
+ * its own buckets, lock, CLOCK ring and counters. Hits hold the read lock
+ * only; they mark the entry referenced instead of reordering a list.
+ */
+typedef struct cache_shard {
     cache_entry_t** buckets;     // Hash table buckets
     size_t bucket_count;         // Number of hash table buckets
-    size_t capacity;             // Maximum number of entries
-    catzilla_atomic_size_t size; // Current number of entries
+    size_t capacity;             // Maximum number of entries in this shard
+    size_t size;                 // Current number of entries (under the lock)
+    cache_entry_t* clock_hand;   // Next eviction candidate, NULL when empty
+    cache_fill_t* fills;         // Claimed missing keys (under the lock)
+
+    // W-TinyLFU only; clock_hand is the probation ring
+    cache_entry_t* window_hand;
+    cache_entry_t* protected_hand;
+    size_t region_size[CACHE_REGION_COUNT];
+    size_t window_capacity;
+    size_t protected_capacity;
+    volatile uint8_t* sketch;    // DEPTH rows of saturating 4-bit counts, one per byte
+    uint32_t sketch_mask;        // Row width - 1 (a power of two)
+    catzilla_atomic_uint64_t sketch_additions;
+    uint64_t sketch_sample;      // Additions between two halvings
+
+    catzilla_rwlock_t rwlock;
 
-    // LRU list management
-    cache_entry_t* lru_head;     // Most recently used
-    cache_entry_t* lru_tail;     // Least recently used
+    catzilla_atomic_uint64_t hits;
+    catzilla_atomic_uint64_t misses;
+    catzilla_atomic_uint64_t evictions;
+    catzilla_atomic_uint64_t memory_usage;
+    catzilla_atomic_uint64_t compressed_entries;
+    catzilla_atomic_uint64_t compressed_bytes;
+    catzilla_atomic_uint64_t uncompressed_bytes;
+    catzilla_atomic_uint64_t fill_claims;
+    catzilla_atomic_uint64_t coalesced;
+    catzilla_atomic_uint64_t stale_hits;
+    catzilla_atomic_uint64_t refreshes;
+    catzilla_atomic_uint64_t rejections;
+} cache_shard_t;
+
+// Shards chosen for a cache when none are configured
+#define CATZILLA_CACHE_MAX_SHARDS 16
+#define CATZILLA_CACHE_MIN_SHARD_CAPACITY 64
 
-    // Thread safety
-    catzilla_rwlock_t rwlock;     // Reader-writer lock for thread safety
+// Main cache structure
+struct catzilla_cache {
+    cache_shard_t* shards;       // Key hash selects the shard
+    size_t shard_count;
+    size_t capacity;             // Maximum number of entries, over all shards
+    catzilla_atomic_size_t size; // Current number of entries
 
     // jemalloc integration
     unsigned arena_index;        // jemalloc arena index for this cache
@@ -76,19 +203,29 @@ struct catzilla_cache {
     uint32_t default_ttl;        // Default TTL in seconds
     size_t max_value_size;       // Maximum size of a single cached value
     bool compression_enabled;    // Whether to compress large values
-
-    // Statistics
-    cache_statistics_t stats;
+    cache_codec_t codec;         // Codec used when compression is enabled
+    size_t compression_threshold; // Smallest value that is compressed
+    uint64_t fill_timeout_us;    // Lifetime of a fill or refresh claim
+    cache_eviction_policy_t eviction_policy; // Fixed at creation
+
+    // Warm start: snapshot whose buckets are restored on first use
+    struct catzilla_snapshot_s* snapshot;
+    catzilla_atomic_uint64_t restored;
 };
 
 // Cache configuration structure
 typedef struct cache_config {
     size_t capacity;             // Maximum number of entries (default: 10000)
     size_t bucket_count;         // Number of hash buckets (default: capacity/4)
+    size_t shard_count;          // Independent shards (default: up to 16, 64+ entries each)
     uint32_t default_ttl;        // Default TTL in seconds (default: 3600)
     size_t max_value_size;       // Max value size in bytes (default: 100MB)
     bool compression_enabled;    // Enable compression for large values
     bool jemalloc_enabled;       // Use jemalloc arena allocation
+    cache_codec_t codec;         // Compression codec (NONE picks LZ4, else zstd)
+    size_t compression_threshold; // Compress values of at least this size (default: 1024)
+    uint32_t fill_timeout_ms;    // Fill and refresh claims lapse after this (default: 10000)
+    cache_eviction_policy_t eviction_policy; // Eviction policy (default: CLOCK)
 } cache_config_t;
 
 // Cache tier types for multi-level caching
@@ -101,8 +238,9 @@ typedef enum cache_tier {
 // Multi-level cache coordinator
 typedef struct multi_cache {
     catzilla_cache_t* memory_cache;  // L1: Memory cache
-    void* redis_connection;          // L2: Redis cache (opaque pointer)
+    struct multi_cache_redis_s* redis_connection;  // L2: Redis clients, one per event loop
     char* disk_cache_path;           // L3: Disk cache directory
+    struct catzilla_disk_cache_s* disk_cache;  // L3: segment store (disk_cache.h)
     bool redis_enabled;
     bool disk_enabled;
     uint32_t memory_ttl;            // TTL for memory cache
@@ -110,12 +248,22 @@ typedef struct multi_cache {
     uint32_t disk_ttl;              // TTL for disk cache
 } multi_cache_t;
 
+// Event loops that can hold a Redis client for one multi_cache
+#define MULTI_CACHE_MAX_REDIS_LOOPS 64
+
+/**
+ * Called when a Redis lookup finishes. value is NULL on a miss or failure
+ * and only valid during the call.
+ */
+typedef void (*multi_cache_fetch_cb)(void* data, const void* value, size_t size);
+
 // ============================================================================
 // Core Cache API
 // ============================================================================
 
 /**
- * Create a new cache instance with default configuration
+ * Create a new cache instance with default configuration. Capacity is split
+ * over the shards, and each shard evicts on its own when it is full.
  * @param capacity Maximum number of entries to store
  * @param bucket_count Number of hash table buckets (0 for auto)
  * @return New cache instance or NULL on failure
@@ -142,13 +290,66 @@ int catzilla_cache_set(catzilla_cache_t* cache, const char* key, const void* val
                        size_t value_size, uint32_t ttl);
 
 /**
- * Retrieve a value from the cache
+ * Store a value that goes stale before it expires. Past its TTL the value is
+ * still returned by catzilla_cache_lookup, which asks one caller to refresh
+ * it, for stale_ttl more seconds. Storing a key ends any claim on it.
+ * @param cache Cache instance
+ * @param key Cache key (null-terminated string)
+ * @param value Data to cache
+ * @param value_size Size of data in bytes
+ * @param ttl Fresh lifetime in seconds (0 for default TTL)
+ * @param stale_ttl Seconds the value may be served stale after that
+ * @return 0 on success, -1 on failure
+ */
+int catzilla_cache_set_ex(catzilla_cache_t* cache, const char* key, const void* value,
+                          size_t value_size, uint32_t ttl, uint32_t stale_ttl);
+
+/**
+ * Look a key up for a caller that computes missing values. Concurrent misses
+ * on one key are coalesced: the first caller is told to fill it and the
+ * others to wait, and a stale value is handed to one caller to refresh while
+ * everyone else keeps getting it. Never blocks on other callers.
+ * @param cache Cache instance
+ * @param key Cache key to look up
+ * @param alloc_fn Allocator for the copy (the caller frees it to match)
+ * @param size_out Receives the value size
+ * @param state Receives the outcome
+ * @return Copy of the value for FRESH, STALE and REFRESH, otherwise NULL
+ */
+void* catzilla_cache_lookup(catzilla_cache_t* cache, const char* key,
+                            void* (*alloc_fn)(size_t), size_t* size_out,
+                            cache_lookup_state_t* state);
+
+/**
+ * Give up a fill or refresh claim without storing a value, so the next
+ * lookup hands the key to another caller
+ * @param cache Cache instance
+ * @param key Claimed key
+ * @return 0 if a claim was dropped, -1 if there was none
+ */
+int catzilla_cache_abandon(catzilla_cache_t* cache, const char* key);
+
+/**
+ * Retrieve a value from the cache. A compressed value is decompressed into a
+ * buffer owned by the calling thread, valid until its next catzilla_cache_get.
  * @param cache Cache instance
  * @param key Cache key to look up
  * @return Cache result structure (check .found field)
  */
 cache_result_t catzilla_cache_get(catzilla_cache_t* cache, const char* key);
 
+/**
+ * Retrieve a copy of a value, taken while the cache is locked so a
+ * concurrent set or eviction cannot free it underneath the caller
+ * @param cache Cache instance
+ * @param key Cache key to look up
+ * @param alloc_fn Allocator for the copy (the caller frees it to match)
+ * @param size_out Receives the value size
+ * @return Copy of the value, or NULL if absent, expired or allocation failed
+ */
+void* catzilla_cache_get_copy(catzilla_cache_t* cache, const char* key,
+                              void* (*alloc_fn)(size_t), size_t* size_out);
+
 /**
  * Delete a key from the cache
  * @param cache Cache instance
@@ -166,7 +367,7 @@ int catzilla_cache_delete(catzilla_cache_t* cache, const char* key);
 bool catzilla_cache_exists(catzilla_cache_t* cache, const char* key);
 
 /**
- * Get current cache statistics
+ * Get current cache statistics, summed over the shards
  * @param cache Cache instance
  * @return Cache statistics structure
  */
@@ -204,12 +405,27 @@ int catzilla_cache_configure(catzilla_cache_t* cache, const cache_config_t* conf
 size_t catzilla_cache_expire_entries(catzilla_cache_t* cache);
 
 /**
- * Get cache memory usage in bytes
+ * Get cache memory usage in bytes, counting compressed values at the size
+ * they are held at
  * @param cache Cache instance
  * @return Memory usage in bytes
  */
 size_t catzilla_cache_memory_usage(catzilla_cache_t* cache);
 
+/**
+ * Check whether this build can compress with a codec
+ * @param codec Codec
+ * @return true if values can be stored with it
+ */
+bool catzilla_cache_codec_available(cache_codec_t codec);
+
+/**
+ * Free the calling thread's decompression buffers and codec contexts. Call
+ * it before a thread that read compressed values exits; values returned by
+ * catzilla_cache_get on this thread are invalid afterwards.
+ */
+void catzilla_cache_release_thread_buffers(void);
+
 /**
  * Resize the cache capacity
  * @param cache Cache instance
@@ -218,6 +434,36 @@ size_t catzilla_cache_memory_usage(catzilla_cache_t* cache);
  */
 int catzilla_cache_resize(catzilla_cache_t* cache, size_t new_capacity);
 
+/**
+ * Write the live entries to a snapshot file (cache_snapshot.h), with the
+ * lifetime each has left. Values are written as held, compressed or not.
+ * Entries of a snapshot still being restored are restored first.
+ * @param cache Cache instance
+ * @param path Snapshot file, replaced atomically
+ * @return 0 on success, -1 on failure (always on Windows)
+ */
+int catzilla_cache_save_snapshot(catzilla_cache_t* cache, const char* path);
+
+/**
+ * Map a snapshot for a warm start. Nothing is read yet: the first use of a
+ * key restores the snapshot bucket it falls in, keeping keys stored since
+ * and dropping entries that expired meanwhile. Call before other threads
+ * use the cache.
+ * @param cache Cache instance
+ * @param path Snapshot file written by catzilla_cache_save_snapshot
+ * @return 0 on success, -1 if the file is missing or malformed, or a
+ *         snapshot is still being restored
+ */
+int catzilla_cache_load_snapshot(catzilla_cache_t* cache, const char* path);
+
+/**
+ * Restore snapshot buckets ahead of use, e.g. from an idle callback
+ * @param cache Cache instance
+ * @param max_buckets Most buckets to restore in this call
+ * @return Buckets still not restored
+ */
+size_t catzilla_cache_restore_pending(catzilla_cache_t* cache, size_t max_buckets);
+
 // ============================================================================
 // Multi-Level Cache API
 // ============================================================================
@@ -233,7 +479,64 @@ multi_cache_t* multi_cache_create(const cache_config_t* memory_config,
                                   const char* redis_url, const char* disk_path);
 
 /**
- * Get value from multi-level cache (checks all tiers)
+ * Add the disk tier to a multi-level cache that has none
+ * @param cache Multi-cache instance
+ * @param disk_path Disk cache directory
+ * @param config Disk cache configuration (catzilla_disk_cache_config_t, NULL = defaults)
+ * @return 0 on success, -1 on failure (the cache keeps working without it)
+ */
+int multi_cache_attach_disk(multi_cache_t* cache, const char* disk_path,
+                            const struct catzilla_disk_cache_config_s* config);
+
+/**
+ * Add the Redis tier. Redis is only reached from event loop threads that
+ * attached a client with multi_cache_attach_redis_loop; on other threads the
+ * cache works with its local tiers.
+ * @param cache Multi-cache instance
+ * @param redis_url redis://[[user]:password@]host[:port][/db]
+ * @param key_prefix Prepended to every key stored in Redis (NULL = "catzilla:")
+ * @param config Client configuration (catzilla_redis_config_t, NULL = defaults)
+ * @return 0 on success, -1 if the URL is invalid or Redis is already configured
+ */
+int multi_cache_enable_redis(multi_cache_t* cache, const char* redis_url, const char* key_prefix,
+                             const struct catzilla_redis_config_s* config);
+
+/**
+ * Start a Redis client for the calling thread's event loop. Call from the
+ * loop's thread before it runs; does nothing without a Redis tier.
+ * @param cache Multi-cache instance
+ * @param loop Event loop of the calling thread
+ * @return 0 on success or without a Redis tier, -1 on failure
+ */
+int multi_cache_attach_redis_loop(multi_cache_t* cache, struct uv_loop_s* loop);
+
+/**
+ * Close the calling thread's Redis client. Outstanding lookups finish as
+ * misses; the client is freed once its loop runs the close callbacks. Every
+ * loop must detach before the cache is destroyed.
+ * @param cache Multi-cache instance
+ */
+void multi_cache_detach_redis_loop(multi_cache_t* cache);
+
+/**
+ * Ask Redis for a key without blocking, after L1 and the disk tier missed.
+ * A hit is promoted to L1 for at most the time it has left in Redis before
+ * the callback runs. Only works on a thread with an attached client.
+ * @param cache Multi-cache instance
+ * @param key Cache key
+ * @param callback Called once from the event loop with the result
+ * @param data Passed to the callback
+ * @return 0 if the lookup was sent (the callback runs later), -1 if Redis
+ *         cannot be asked from here (the callback never runs)
+ */
+int multi_cache_fetch_remote(multi_cache_t* cache, const char* key,
+                             multi_cache_fetch_cb callback, void* data);
+
+/**
+ * Get value from the local tiers of a multi-level cache; never waits for
+ * Redis (see multi_cache_fetch_remote). A value found on disk is promoted to
+ * L1 and returned from there, so the result follows the rules of
+ * catzilla_cache_get; values too large for L1 are not returned.
  * @param cache Multi-cache instance
  * @param key Cache key
  * @return Cache result from the first tier that has the key
@@ -241,13 +544,27 @@ multi_cache_t* multi_cache_create(const cache_config_t* memory_config,
 cache_result_t multi_cache_get(multi_cache_t* cache, const char* key);
 
 /**
- * Set value in multi-level cache (stores in all enabled tiers)
+ * Get a copy of a value from the local tiers of a multi-level cache; an L1
+ * miss served by the disk tier is promoted to L1 for the memory TTL
+ * @param cache Multi-cache instance
+ * @param key Cache key
+ * @param alloc_fn Allocator for the copy (the caller frees it to match)
+ * @param size_out Receives the value size
+ * @return Copy of the value, or NULL if no tier has it
+ */
+void* multi_cache_get_copy(multi_cache_t* cache, const char* key,
+                           void* (*alloc_fn)(size_t), size_t* size_out);
+
+/**
+ * Set value in multi-level cache (stores in all enabled tiers). Each tier
+ * keeps it for its own TTL, capped by ttl when ttl is not 0. The Redis SET is
+ * queued on the calling loop's client and sent with the loop's next batch.
  * @param cache Multi-cache instance
  * @param key Cache key
  * @param value Value to store
  * @param value_size Size of value
  * @param ttl Time-to-live in seconds
- * @return 0 on success, -1 on failure
+ * @return 0 if at least one tier stored it, -1 on failure
  */
 int multi_cache_set(multi_cache_t* cache, const char* key, const void* value,
                     size_t value_size, uint32_t ttl);
@@ -260,6 +577,13 @@ int multi_cache_set(multi_cache_t* cache, const char* key, const void* value,
  */
 int multi_cache_delete(multi_cache_t* cache, const char* key);
 
+/**
+ * Drop every entry from the local cache tiers. Entries in Redis are shared
+ * with other nodes and expire on their TTL.
+ * @param cache Multi-cache instance
+ */
+void multi_cache_clear(multi_cache_t* cache);
+
 /**
  * Destroy multi-level cache
  * @param cache Multi-cache instance
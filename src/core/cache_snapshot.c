@@ -0,0 +1,453 @@
+/*
+ * Catzilla Cache Snapshot - write and lazily restore cache snapshot files
+ *
+ * The writer streams records to a temporary file while remembering their
+ * offsets and buckets, then appends the index, writes the header's magic
+ * and renames the file into place, so a crash mid-write leaves the previous
+ * snapshot untouched. The index is the bucket start table (bucket_count + 1
+ * positions into the offset list) followed by the offset list itself.
+ */
+
+#include "cache_snapshot.h"
+#include "platform_atomic.h"
+#include "logging.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+
+// Snapshots are mapped when loaded; warm restarts are not available on Windows
+
+catzilla_snapshot_writer_t* catzilla_snapshot_writer_open(const char* path, uint32_t kind,
+                                                          uint32_t bucket_count) {
+    (void)path; (void)kind; (void)bucket_count;
+    LOG_CACHE_WARN("Cache snapshots are not supported on Windows");
+    return NULL;
+}
+
+int catzilla_snapshot_writer_add(catzilla_snapshot_writer_t* writer,
+                                 const catzilla_snapshot_record_t* record,
+                                 const char* key, const void* value) {
+    (void)writer; (void)record; (void)key; (void)value;
+    return -1;
+}
+
+int catzilla_snapshot_writer_commit(catzilla_snapshot_writer_t* writer) {
+    (void)writer;
+    return -1;
+}
+
+void catzilla_snapshot_writer_abort(catzilla_snapshot_writer_t* writer) { (void)writer; }
+
+catzilla_snapshot_t* catzilla_snapshot_open(const char* path, uint32_t kind) {
+    (void)path; (void)kind;
+    LOG_CACHE_WARN("Cache snapshots are not supported on Windows");
+    return NULL;
+}
+
+size_t catzilla_snapshot_restore(catzilla_snapshot_t* snapshot, uint32_t hash,
+                                 catzilla_snapshot_restore_fn restore, void* data) {
+    (void)snapshot; (void)hash; (void)restore; (void)data;
+    return 0;
+}
+
+size_t catzilla_snapshot_restore_next(catzilla_snapshot_t* snapshot, size_t max_buckets,
+                                      catzilla_snapshot_restore_fn restore, void* data) {
+    (void)snapshot; (void)max_buckets; (void)restore; (void)data;
+    return 0;
+}
+
+bool catzilla_snapshot_pending(const catzilla_snapshot_t* snapshot) {
+    (void)snapshot;
+    return false;
+}
+
+void catzilla_snapshot_discard(catzilla_snapshot_t* snapshot) { (void)snapshot; }
+
+void catzilla_snapshot_close(catzilla_snapshot_t* snapshot) { (void)snapshot; }
+
+int64_t catzilla_snapshot_wall_time_us(void) {
+    return (int64_t)time(NULL) * 1000000;
+}
+
+#else
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define SNAPSHOT_MAGIC 0x31535a43u  // "CZS1"
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_MAX_BUCKETS (1u << 20)
+
+typedef struct {
+    uint32_t magic;               // Written last
+    uint32_t version;
+    uint32_t kind;
+    uint32_t bucket_count;        // A power of two
+    uint64_t entry_count;
+    int64_t saved_at_us;          // Wall clock
+    uint64_t index_offset;        // Records end here
+    uint64_t file_size;
+} snapshot_header_t;
+
+struct catzilla_snapshot_writer_s {
+    FILE* file;
+    char path[PATH_MAX];
+    char temp_path[PATH_MAX];
+    snapshot_header_t header;
+    uint64_t offset;              // Where the next record goes
+    uint32_t* buckets;            // Bucket of each record, in file order
+    uint64_t* offsets;
+    size_t count;
+    size_t capacity;
+    bool failed;
+};
+
+struct catzilla_snapshot_s {
+    char* map;                    // NULL once every bucket is restored
+    size_t map_size;
+    uint32_t bucket_count;
+    uint32_t bucket_mask;
+    const uint64_t* bucket_start;
+    const uint64_t* offsets;
+    uint64_t records_end;
+    int64_t saved_at_us;
+    volatile uint8_t* restored;   // One flag per bucket
+    volatile size_t remaining;    // Buckets not restored yet
+    size_t cursor;                // Next bucket catzilla_snapshot_restore_next looks at
+    pthread_mutex_t lock;         // Held while a bucket is restored
+};
+
+static size_t padded(size_t size) {
+    return (size + 7) & ~(size_t)7;
+}
+
+int64_t catzilla_snapshot_wall_time_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+catzilla_snapshot_writer_t* catzilla_snapshot_writer_open(const char* path, uint32_t kind,
+                                                          uint32_t bucket_count) {
+    if (!path) return NULL;
+
+    uint32_t buckets = 1;
+    while (buckets < bucket_count && buckets < SNAPSHOT_MAX_BUCKETS) buckets <<= 1;
+
+    catzilla_snapshot_writer_t* writer = calloc(1, sizeof(*writer));
+    if (!writer) return NULL;
+    if (snprintf(writer->path, sizeof(writer->path), "%s", path) >= (int)sizeof(writer->path) ||
+        snprintf(writer->temp_path, sizeof(writer->temp_path), "%s.%ld.tmp", path,
+                 (long)getpid()) >= (int)sizeof(writer->temp_path)) {
+        free(writer);
+        return NULL;
+    }
+
+    writer->file = fopen(writer->temp_path, "wb");
+    if (!writer->file) {
+        LOG_CACHE_WARN("Cannot write cache snapshot %s: %s", writer->temp_path, strerror(errno));
+        free(writer);
+        return NULL;
+    }
+    writer->header.version = SNAPSHOT_VERSION;
+    writer->header.kind = kind;
+    writer->header.bucket_count = buckets;
+    writer->header.saved_at_us = catzilla_snapshot_wall_time_us();
+
+    // The header is rewritten, with its magic, on commit
+    writer->offset = sizeof(snapshot_header_t);
+    if (fwrite(&writer->header, sizeof(writer->header), 1, writer->file) != 1) {
+        writer->failed = true;
+    }
+    return writer;
+}
+
+int catzilla_snapshot_writer_add(catzilla_snapshot_writer_t* writer,
+                                 const catzilla_snapshot_record_t* record,
+                                 const char* key, const void* value) {
+    if (!writer || !record || !key || (!value && record->stored_size > 0)) return -1;
+    if (writer->failed) return -1;
+
+    if (writer->count == writer->capacity) {
+        size_t capacity = writer->capacity ? writer->capacity * 2 : 256;
+        uint32_t* buckets = realloc(writer->buckets, capacity * sizeof(uint32_t));
+        if (!buckets) {
+            writer->failed = true;
+            return -1;
+        }
+        writer->buckets = buckets;
+        uint64_t* offsets = realloc(writer->offsets, capacity * sizeof(uint64_t));
+        if (!offsets) {
+            writer->failed = true;
+            return -1;
+        }
+        writer->offsets = offsets;
+        writer->capacity = capacity;
+    }
+
+    // The key is written with its NUL so restores can hand it out as is
+    static const char zeros[8] = {0};
+    size_t length = sizeof(*record) + record->key_len + 1 + (size_t)record->stored_size;
+    if (fwrite(record, sizeof(*record), 1, writer->file) != 1 ||
+        fwrite(key, 1, record->key_len, writer->file) != record->key_len ||
+        fwrite(zeros, 1, 1, writer->file) != 1 ||
+        (record->stored_size > 0 &&
+         fwrite(value, 1, (size_t)record->stored_size, writer->file) != (size_t)record->stored_size) ||
+        fwrite(zeros, 1, padded(length) - length, writer->file) != padded(length) - length) {
+        writer->failed = true;
+        return -1;
+    }
+
+    writer->buckets[writer->count] = record->hash & (writer->header.bucket_count - 1);
+    writer->offsets[writer->count] = writer->offset;
+    writer->count++;
+    writer->offset += padded(length);
+    return 0;
+}
+
+void catzilla_snapshot_writer_abort(catzilla_snapshot_writer_t* writer) {
+    if (!writer) return;
+    if (writer->file) {
+        fclose(writer->file);
+        unlink(writer->temp_path);
+    }
+    free(writer->buckets);
+    free(writer->offsets);
+    free(writer);
+}
+
+int catzilla_snapshot_writer_commit(catzilla_snapshot_writer_t* writer) {
+    if (!writer) return -1;
+
+    uint32_t bucket_count = writer->header.bucket_count;
+    uint64_t* starts = calloc((size_t)bucket_count + 1, sizeof(uint64_t));
+    uint64_t* sorted = malloc((writer->count ? writer->count : 1) * sizeof(uint64_t));
+    if (writer->failed || !starts || !sorted) {
+        free(starts);
+        free(sorted);
+        catzilla_snapshot_writer_abort(writer);
+        return -1;
+    }
+
+    // Counting sort of the offsets by bucket; file order is kept within one
+    for (size_t i = 0; i < writer->count; i++) starts[writer->buckets[i] + 1]++;
+    for (uint32_t b = 0; b < bucket_count; b++) starts[b + 1] += starts[b];
+    uint64_t* fill = calloc(bucket_count, sizeof(uint64_t));
+    if (!fill) {
+        free(starts);
+        free(sorted);
+        catzilla_snapshot_writer_abort(writer);
+        return -1;
+    }
+    for (size_t i = 0; i < writer->count; i++) {
+        uint32_t b = writer->buckets[i];
+        sorted[starts[b] + fill[b]++] = writer->offsets[i];
+    }
+    free(fill);
+
+    writer->header.magic = SNAPSHOT_MAGIC;
+    writer->header.entry_count = writer->count;
+    writer->header.index_offset = writer->offset;
+    writer->header.file_size = writer->offset + ((uint64_t)bucket_count + 1) * sizeof(uint64_t) +
+                               writer->count * sizeof(uint64_t);
+
+    bool ok = fwrite(starts, sizeof(uint64_t), (size_t)bucket_count + 1, writer->file) == (size_t)bucket_count + 1 &&
+              fwrite(sorted, sizeof(uint64_t), writer->count, writer->file) == writer->count &&
+              fseek(writer->file, 0, SEEK_SET) == 0 &&
+              fwrite(&writer->header, sizeof(writer->header), 1, writer->file) == 1 &&
+              fflush(writer->file) == 0 &&
+              fsync(fileno(writer->file)) == 0;
+    free(starts);
+    free(sorted);
+    if (!ok) {
+        LOG_CACHE_WARN("Cannot write cache snapshot %s: %s", writer->temp_path, strerror(errno));
+        catzilla_snapshot_writer_abort(writer);
+        return -1;
+    }
+
+    fclose(writer->file);
+    writer->file = NULL;
+    int rc = rename(writer->temp_path, writer->path);
+    if (rc != 0) {
+        LOG_CACHE_WARN("Cannot replace cache snapshot %s: %s", writer->path, strerror(errno));
+        unlink(writer->temp_path);
+    }
+    catzilla_snapshot_writer_abort(writer);
+    return rc == 0 ? 0 : -1;
+}
+
+catzilla_snapshot_t* catzilla_snapshot_open(const char* path, uint32_t kind) {
+    if (!path) return NULL;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(snapshot_header_t)) {
+        close(fd);
+        return NULL;
+    }
+    char* map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return NULL;
+
+    const snapshot_header_t* header = (const snapshot_header_t*)map;
+    uint64_t index_size = ((uint64_t)header->bucket_count + 1) * sizeof(uint64_t) +
+                          header->entry_count * sizeof(uint64_t);
+    bool valid = header->magic == SNAPSHOT_MAGIC && header->version == SNAPSHOT_VERSION &&
+                 header->kind == kind && header->file_size == (uint64_t)st.st_size &&
+                 header->bucket_count > 0 && header->bucket_count <= SNAPSHOT_MAX_BUCKETS &&
+                 (header->bucket_count & (header->bucket_count - 1)) == 0 &&
+                 header->entry_count <= (uint64_t)st.st_size / sizeof(catzilla_snapshot_record_t) &&
+                 header->index_offset >= sizeof(snapshot_header_t) &&
+                 header->index_offset % 8 == 0 &&
+                 header->index_offset + index_size == header->file_size;
+    const uint64_t* starts = valid ? (const uint64_t*)(map + header->index_offset) : NULL;
+    for (uint32_t b = 0; valid && b < header->bucket_count; b++) {
+        valid = starts[b] <= starts[b + 1];
+    }
+    if (!valid || starts[0] != 0 || starts[header->bucket_count] != header->entry_count) {
+        LOG_CACHE_WARN("Ignoring cache snapshot %s: not a snapshot of this kind or damaged", path);
+        munmap(map, (size_t)st.st_size);
+        return NULL;
+    }
+
+    catzilla_snapshot_t* snapshot = calloc(1, sizeof(*snapshot));
+    uint8_t* restored = snapshot ? calloc(header->bucket_count, 1) : NULL;
+    if (!restored) {
+        free(snapshot);
+        munmap(map, (size_t)st.st_size);
+        return NULL;
+    }
+#ifdef MADV_RANDOM
+    // Buckets are faulted in in request order
+    madvise(map, (size_t)st.st_size, MADV_RANDOM);
+#endif
+    snapshot->map = map;
+    snapshot->map_size = (size_t)st.st_size;
+    snapshot->bucket_count = header->bucket_count;
+    snapshot->bucket_mask = header->bucket_count - 1;
+    snapshot->bucket_start = starts;
+    snapshot->offsets = starts + header->bucket_count + 1;
+    snapshot->records_end = header->index_offset;
+    snapshot->saved_at_us = header->saved_at_us;
+    snapshot->restored = restored;
+    snapshot->remaining = header->bucket_count;
+    pthread_mutex_init(&snapshot->lock, NULL);
+
+    LOG_CACHE_INFO("Loaded cache snapshot %s: %llu entries in %u buckets", path,
+                   (unsigned long long)header->entry_count, header->bucket_count);
+    return snapshot;
+}
+
+static void snapshot_unmap(catzilla_snapshot_t* snapshot) {
+    if (snapshot->map) {
+        munmap(snapshot->map, snapshot->map_size);
+        snapshot->map = NULL;
+        snapshot->bucket_start = NULL;
+        snapshot->offsets = NULL;
+    }
+}
+
+// Hand a bucket's live records to restore; holds the snapshot lock
+static size_t restore_bucket(catzilla_snapshot_t* snapshot, uint32_t bucket,
+                             catzilla_snapshot_restore_fn restore, void* data) {
+    int64_t elapsed = catzilla_snapshot_wall_time_us() - snapshot->saved_at_us;
+    if (elapsed < 0) elapsed = 0;  // The clock went back; do not extend lifetimes
+
+    size_t count = 0;
+    for (uint64_t i = snapshot->bucket_start[bucket]; i < snapshot->bucket_start[bucket + 1]; i++) {
+        uint64_t offset = snapshot->offsets[i];
+        if (offset % 8 != 0 || offset + sizeof(catzilla_snapshot_record_t) > snapshot->records_end) {
+            continue;
+        }
+        catzilla_snapshot_record_t record;
+        memcpy(&record, snapshot->map + offset, sizeof(record));
+        const char* key = snapshot->map + offset + sizeof(record);
+        uint64_t end = offset + sizeof(record) + (uint64_t)record.key_len + 1;
+        if (end > snapshot->records_end || record.stored_size > snapshot->records_end - end ||
+            key[record.key_len] != '\0') {
+            continue;
+        }
+        record.expires_us -= elapsed;
+        record.fresh_us -= elapsed;
+        if (record.expires_us <= 0) {
+            continue;
+        }
+        restore(data, &record, key, key + record.key_len + 1);
+        count++;
+    }
+
+    catzilla_atomic_store_seq(&snapshot->restored[bucket], 1);
+    catzilla_atomic_store_seq(&snapshot->remaining, snapshot->remaining - 1);
+    if (snapshot->remaining == 0) {
+        snapshot_unmap(snapshot);
+    }
+    return count;
+}
+
+size_t catzilla_snapshot_restore(catzilla_snapshot_t* snapshot, uint32_t hash,
+                                 catzilla_snapshot_restore_fn restore, void* data) {
+    if (!catzilla_snapshot_pending(snapshot) || !restore) return 0;
+    uint32_t bucket = hash & snapshot->bucket_mask;
+    if (catzilla_atomic_load_seq(&snapshot->restored[bucket])) return 0;
+
+    size_t count = 0;
+    pthread_mutex_lock(&snapshot->lock);
+    if (!snapshot->restored[bucket]) {
+        count = restore_bucket(snapshot, bucket, restore, data);
+    }
+    pthread_mutex_unlock(&snapshot->lock);
+    return count;
+}
+
+size_t catzilla_snapshot_restore_next(catzilla_snapshot_t* snapshot, size_t max_buckets,
+                                      catzilla_snapshot_restore_fn restore, void* data) {
+    if (!catzilla_snapshot_pending(snapshot) || !restore) return 0;
+
+    pthread_mutex_lock(&snapshot->lock);
+    while (max_buckets > 0 && snapshot->remaining > 0) {
+        uint32_t bucket = (uint32_t)snapshot->cursor;
+        snapshot->cursor = (snapshot->cursor + 1) % snapshot->bucket_count;
+        if (!snapshot->restored[bucket]) {
+            restore_bucket(snapshot, bucket, restore, data);
+            max_buckets--;
+        }
+    }
+    size_t remaining = snapshot->remaining;
+    pthread_mutex_unlock(&snapshot->lock);
+    return remaining;
+}
+
+bool catzilla_snapshot_pending(const catzilla_snapshot_t* snapshot) {
+    return snapshot && catzilla_atomic_load_seq(&snapshot->remaining) > 0;
+}
+
+void catzilla_snapshot_discard(catzilla_snapshot_t* snapshot) {
+    if (!snapshot) return;
+    pthread_mutex_lock(&snapshot->lock);
+    for (uint32_t b = 0; b < snapshot->bucket_count; b++) {
+        catzilla_atomic_store_seq(&snapshot->restored[b], 1);
+    }
+    catzilla_atomic_store_seq(&snapshot->remaining, 0);
+    snapshot_unmap(snapshot);
+    pthread_mutex_unlock(&snapshot->lock);
+}
+
+void catzilla_snapshot_close(catzilla_snapshot_t* snapshot) {
+    if (!snapshot) return;
+    snapshot_unmap(snapshot);
+    pthread_mutex_destroy(&snapshot->lock);
+    free((void*)snapshot->restored);
+    free(snapshot);
+}
+
+#endif // _WIN32
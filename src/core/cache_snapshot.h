@@ -0,0 +1,152 @@
+/*
+ * Catzilla Cache Snapshot - warm restarts for the in-process caches
+ *
+ * A snapshot is one file: a header, the records back to back (each one a
+ * record header, the key and the value, padded to 8 bytes), then an index
+ * of record offsets grouped by bucket. Records carry the lifetime they had
+ * left when they were written, and the header the wall-clock time of the
+ * write, so whatever time passes until the restore is taken off.
+ *
+ * A loaded snapshot stays mapped and is restored one bucket at a time: a
+ * cache restores the bucket a key falls in the first time the key is used,
+ * so startup does not wait for the whole file. The mapping is dropped once
+ * every bucket is restored.
+ */
+
+#ifndef CATZILLA_CACHE_SNAPSHOT_H
+#define CATZILLA_CACHE_SNAPSHOT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct catzilla_snapshot_s catzilla_snapshot_t;
+typedef struct catzilla_snapshot_writer_s catzilla_snapshot_writer_t;
+
+// What a snapshot holds; a snapshot is only loaded into the kind of cache that wrote it
+#define CATZILLA_SNAPSHOT_KIND_CACHE 1   // catzilla_cache entries
+#define CATZILLA_SNAPSHOT_KIND_STATIC 2  // Static file hot cache entries
+
+/**
+ * One saved entry. When handed to a restore callback, fresh_us and
+ * expires_us are what is left from the time of the restore.
+ */
+typedef struct catzilla_snapshot_record_s {
+    uint32_t hash;                // Key hash; its low bits pick the bucket
+    uint32_t key_len;
+    uint64_t value_size;          // Size of the value as the caller stored it
+    uint64_t stored_size;         // Bytes following the key
+    uint32_t codec;               // cache_codec_t of the stored bytes
+    uint32_t reserved;
+    int64_t fresh_us;             // Lifetime left before the entry goes stale
+    int64_t expires_us;           // Lifetime left before it expires
+    int64_t mtime;                // File modification time (static entries)
+} catzilla_snapshot_record_t;
+
+/**
+ * Called for every live record of a bucket being restored. key and value
+ * point into the mapping and are only valid during the call.
+ */
+typedef void (*catzilla_snapshot_restore_fn)(void* data, const catzilla_snapshot_record_t* record,
+                                             const char* key, const void* value);
+
+/**
+ * Start writing a snapshot; it replaces path only when committed
+ * @param path Snapshot file
+ * @param kind CATZILLA_SNAPSHOT_KIND_*
+ * @param bucket_count Buckets of the index, rounded up to a power of two
+ * @return Writer, or NULL on failure (always NULL on Windows)
+ */
+catzilla_snapshot_writer_t* catzilla_snapshot_writer_open(const char* path, uint32_t kind,
+                                                          uint32_t bucket_count);
+
+/**
+ * Append a record
+ * @param writer Snapshot writer
+ * @param record Record header; key_len and stored_size give the sizes to copy
+ * @param key Key bytes
+ * @param value Stored value bytes
+ * @return 0 on success, -1 on failure (the writer must still be aborted)
+ */
+int catzilla_snapshot_writer_add(catzilla_snapshot_writer_t* writer,
+                                 const catzilla_snapshot_record_t* record,
+                                 const char* key, const void* value);
+
+/**
+ * Write the index, sync the file and rename it over the snapshot path
+ * @param writer Snapshot writer, freed by the call
+ * @return 0 on success, -1 on failure (the previous snapshot is left alone)
+ */
+int catzilla_snapshot_writer_commit(catzilla_snapshot_writer_t* writer);
+
+/**
+ * Drop a snapshot being written
+ * @param writer Snapshot writer, freed by the call (may be NULL)
+ */
+void catzilla_snapshot_writer_abort(catzilla_snapshot_writer_t* writer);
+
+/**
+ * Map a snapshot and check its header and index; no record is read yet
+ * @param path Snapshot file
+ * @param kind Kind the snapshot must have
+ * @return Snapshot, or NULL if the file is missing, of another kind or malformed
+ */
+catzilla_snapshot_t* catzilla_snapshot_open(const char* path, uint32_t kind);
+
+/**
+ * Restore the bucket a key hash falls in, once; calls from other threads
+ * for the same snapshot wait for it. The callback must not restore other
+ * buckets of the snapshot.
+ * @param snapshot Loaded snapshot
+ * @param hash Key hash
+ * @param restore Called for every record that has not expired
+ * @param data Passed to restore
+ * @return Records handed to restore
+ */
+size_t catzilla_snapshot_restore(catzilla_snapshot_t* snapshot, uint32_t hash,
+                                 catzilla_snapshot_restore_fn restore, void* data);
+
+/**
+ * Restore buckets not restored yet, in order
+ * @param snapshot Loaded snapshot
+ * @param max_buckets Most buckets to restore
+ * @param restore Called for every record that has not expired
+ * @param data Passed to restore
+ * @return Buckets still not restored
+ */
+size_t catzilla_snapshot_restore_next(catzilla_snapshot_t* snapshot, size_t max_buckets,
+                                      catzilla_snapshot_restore_fn restore, void* data);
+
+/**
+ * Check whether any bucket is still to be restored; cheap enough for every lookup
+ * @param snapshot Loaded snapshot (may be NULL)
+ * @return true while buckets are left
+ */
+bool catzilla_snapshot_pending(const catzilla_snapshot_t* snapshot);
+
+/**
+ * Give up the buckets not restored yet and drop the mapping
+ * @param snapshot Loaded snapshot
+ */
+void catzilla_snapshot_discard(catzilla_snapshot_t* snapshot);
+
+/**
+ * Free a snapshot; nothing may use it any more
+ * @param snapshot Loaded snapshot (may be NULL)
+ */
+void catzilla_snapshot_close(catzilla_snapshot_t* snapshot);
+
+/**
+ * @return Current wall-clock time in microseconds, as written to snapshot headers
+ */
+int64_t catzilla_snapshot_wall_time_us(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CATZILLA_CACHE_SNAPSHOT_H
@@ -0,0 +1,944 @@
+/*
+ * Catzilla clamd Client - non-blocking INSTREAM virus scanning on a libuv loop
+ *
+ * Each pooled connection opens with "zIDSESSION" so it can carry one scan
+ * after another. A scan attached to a connection appends "zINSTREAM" and
+ * then one length-prefixed chunk per write to the connection's output
+ * buffer; a zero-length chunk ends the stream. A prepare handle writes every
+ * buffer out right before the loop polls. Replies are NUL-terminated and
+ * carry the session's command id, which is stripped before parsing. A scan
+ * started while all connections are busy keeps its chunks in its own buffer
+ * until a connection takes it.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "clamd_client.h"
+#include "logging.h"
+
+#define CLAMD_INITIAL_BACKOFF_MS 100
+#define CLAMD_MAX_REPLY 1024
+#define CLAMD_MAX_CHUNK (1024 * 1024)
+#define CLAMD_SESSION_COMMAND "zIDSESSION"
+#define CLAMD_STREAM_COMMAND "zINSTREAM"
+#define CLAMD_END_COMMAND "zEND"
+
+typedef enum {
+    CLAMD_CONN_DOWN = 0,
+    CLAMD_CONN_RESOLVING,
+    CLAMD_CONN_CONNECTING,
+    CLAMD_CONN_READY,
+    CLAMD_CONN_CLOSING
+} clamd_conn_state_t;
+
+typedef struct clamd_conn_s {
+    catzilla_clamd_t* client;
+    union {
+        uv_pipe_t pipe;
+        uv_tcp_t tcp;
+    } handle;
+    uv_getaddrinfo_t resolver;
+    uv_connect_t connect_req;
+    clamd_conn_state_t state;
+    bool handle_open;
+    bool resolving;
+    bool ever_connected;
+    bool backoff;               // Wait before reconnecting once the socket closed
+    uint64_t state_since;
+    uint64_t retry_at;
+    uint32_t backoff_ms;
+
+    // A verdict is outstanding; scan is NULL once that scan was canceled
+    bool busy;
+    catzilla_clamd_scan_t* scan;
+    uint64_t deadline;          // Set once the stream ended
+
+    // Framed data not written yet
+    char* out;
+    size_t out_len;
+    size_t out_cap;
+
+    // Reply received so far
+    char in[CLAMD_MAX_REPLY];
+    size_t in_len;
+} clamd_conn_t;
+
+struct catzilla_clamd_scan_s {
+    catzilla_clamd_t* client;
+    clamd_conn_t* conn;         // NULL while waiting for a connection
+    catzilla_clamd_scan_t* next;
+    catzilla_clamd_callback_t callback;
+    void* data;
+
+    // Chunks framed before a connection took the scan
+    char* buf;
+    size_t buf_len;
+    size_t buf_cap;
+
+    uint64_t bytes;
+    uint64_t started_at;
+    uint64_t deadline;          // Set once the stream ended
+    bool finished;
+};
+
+struct catzilla_clamd_s {
+    uv_loop_t* loop;
+    uv_prepare_t flush_handle;
+    uv_timer_t tick;
+
+    bool unix_socket;
+    char path[256];             // Unix socket path, or host
+    char port[8];
+
+    int pool_size;
+    uint32_t timeout_ms;
+    size_t max_buffered;
+    clamd_conn_t conns[CATZILLA_CLAMD_MAX_POOL_SIZE];
+
+    // Scans waiting for a free connection, oldest first
+    catzilla_clamd_scan_t* waiting_head;
+    catzilla_clamd_scan_t* waiting_tail;
+
+    bool closing;
+    int open_handles;  // Handles and resolver requests not finished yet
+    catzilla_clamd_stats_t stats;
+};
+
+typedef struct {
+    uv_write_t req;
+    uv_buf_t buf;
+} clamd_write_t;
+
+static void start_connect(clamd_conn_t* conn);
+static void reset_connection(clamd_conn_t* conn, bool backoff, const char* reason);
+static void on_flush(uv_prepare_t* handle);
+static void assign_waiting(catzilla_clamd_t* client);
+
+// ============================================================================
+// Reply parsing
+// ============================================================================
+
+static void set_signature(catzilla_clamd_result_t* result, const char* text, size_t len) {
+    if (len >= sizeof(result->signature)) len = sizeof(result->signature) - 1;
+    memcpy(result->signature, text, len);
+    result->signature[len] = '\0';
+}
+
+int catzilla_clamd_parse_reply(const char* reply, size_t len, catzilla_clamd_result_t* result) {
+    if (!reply || !result) return -1;
+    while (len > 0 && (reply[len - 1] == '\n' || reply[len - 1] == '\r' || reply[len - 1] == '\0')) len--;
+
+    // Session replies start with the command id
+    size_t digits = 0;
+    while (digits < len && reply[digits] >= '0' && reply[digits] <= '9') digits++;
+    if (digits > 0 && digits + 1 < len && reply[digits] == ':' && reply[digits + 1] == ' ') {
+        reply += digits + 2;
+        len -= digits + 2;
+    }
+
+    result->verdict = CATZILLA_CLAMD_ERROR;
+    result->signature[0] = '\0';
+
+    static const char ok[] = "stream: OK";
+    static const char found[] = " FOUND";
+    static const char error[] = " ERROR";
+    static const char prefix[] = "stream: ";
+    size_t ok_len = sizeof(ok) - 1;
+    size_t found_len = sizeof(found) - 1;
+    size_t error_len = sizeof(error) - 1;
+    size_t prefix_len = sizeof(prefix) - 1;
+
+    if (len == ok_len && memcmp(reply, ok, ok_len) == 0) {
+        result->verdict = CATZILLA_CLAMD_CLEAN;
+        return 0;
+    }
+    if (len > prefix_len + found_len && memcmp(reply, prefix, prefix_len) == 0 &&
+        memcmp(reply + len - found_len, found, found_len) == 0) {
+        result->verdict = CATZILLA_CLAMD_INFECTED;
+        set_signature(result, reply + prefix_len, len - prefix_len - found_len);
+        return 0;
+    }
+    if (len > error_len && memcmp(reply + len - error_len, error, error_len) == 0) {
+        // "INSTREAM size limit exceeded. ERROR", "stream: Can't ... ERROR"
+        size_t skip = len - error_len > prefix_len && memcmp(reply, prefix, prefix_len) == 0 ? prefix_len : 0;
+        set_signature(result, reply + skip, len - error_len - skip);
+        return 0;
+    }
+    set_signature(result, reply, len);
+    return -1;
+}
+
+// ============================================================================
+// Address parsing
+// ============================================================================
+
+static int parse_address(const char* address, catzilla_clamd_t* client) {
+    if (!address || !*address) return -1;
+
+    if (strncmp(address, "unix:", 5) == 0 || address[0] == '/') {
+        const char* path = address[0] == '/' ? address : address + 5;
+        size_t path_len = strlen(path);
+        if (path_len == 0 || path_len >= sizeof(client->path)) return -1;
+        memcpy(client->path, path, path_len + 1);
+        client->unix_socket = true;
+        return 0;
+    }
+
+    const char* host = strncmp(address, "tcp://", 6) == 0 ? address + 6 : address;
+    const char* end = host + strlen(host);
+    const char* host_end;
+    const char* port = NULL;
+    if (*host == '[') {
+        host++;
+        host_end = memchr(host, ']', (size_t)(end - host));
+        if (!host_end) return -1;
+        if (host_end + 1 < end) {
+            if (host_end[1] != ':') return -1;
+            port = host_end + 2;
+        }
+    } else {
+        host_end = memchr(host, ':', (size_t)(end - host));
+        if (host_end) {
+            port = host_end + 1;
+        } else {
+            host_end = end;
+        }
+    }
+
+    size_t host_len = (size_t)(host_end - host);
+    if (host_len == 0 || host_len >= sizeof(client->path) || memchr(host, '/', host_len)) return -1;
+    memcpy(client->path, host, host_len);
+    client->path[host_len] = '\0';
+
+    long port_number = CATZILLA_CLAMD_DEFAULT_PORT;
+    if (port) {
+        char* port_end = NULL;
+        port_number = strtol(port, &port_end, 10);
+        if (port_end == port || *port_end != '\0' || port_number < 1 || port_number > 65535) return -1;
+    }
+    snprintf(client->port, sizeof(client->port), "%ld", port_number);
+    client->unix_socket = false;
+    return 0;
+}
+
+bool catzilla_clamd_address_valid(const char* address) {
+    catzilla_clamd_t probe;
+    memset(&probe, 0, sizeof(probe));
+    return parse_address(address, &probe) == 0;
+}
+
+// ============================================================================
+// Buffers and framing
+// ============================================================================
+
+static int reserve(char** data, size_t* cap, size_t len, size_t extra) {
+    if (len + extra <= *cap) return 0;
+    size_t new_cap = *cap ? *cap : 4096;
+    while (new_cap < len + extra) new_cap *= 2;
+    char* grown = realloc(*data, new_cap);
+    if (!grown) return -1;
+    *data = grown;
+    *cap = new_cap;
+    return 0;
+}
+
+static int append(char** data, size_t* len, size_t* cap, const void* bytes, size_t size) {
+    if (reserve(data, cap, *len, size) != 0) return -1;
+    memcpy(*data + *len, bytes, size);
+    *len += size;
+    return 0;
+}
+
+// One 4-byte big-endian length per chunk, then its bytes
+static int append_chunks(char** data, size_t* len, size_t* cap, const char* bytes, size_t size) {
+    size_t chunks = size / CLAMD_MAX_CHUNK + 1;
+    if (reserve(data, cap, *len, size + chunks * 4) != 0) return -1;
+    do {
+        size_t take = size < CLAMD_MAX_CHUNK ? size : CLAMD_MAX_CHUNK;
+        unsigned char* header = (unsigned char*)*data + *len;
+        header[0] = (unsigned char)(take >> 24);
+        header[1] = (unsigned char)(take >> 16);
+        header[2] = (unsigned char)(take >> 8);
+        header[3] = (unsigned char)take;
+        memcpy(*data + *len + 4, bytes, take);
+        *len += take + 4;
+        bytes += take;
+        size -= take;
+    } while (size > 0);
+    return 0;
+}
+
+static int append_stream_end(char** data, size_t* len, size_t* cap) {
+    static const char end[4] = { 0, 0, 0, 0 };
+    return append(data, len, cap, end, sizeof(end));
+}
+
+static uv_stream_t* conn_stream(clamd_conn_t* conn) {
+    return (uv_stream_t*)&conn->handle;
+}
+
+static void schedule_flush(catzilla_clamd_t* client) {
+    if (!client->closing && !uv_is_active((uv_handle_t*)&client->flush_handle)) {
+        uv_prepare_start(&client->flush_handle, on_flush);
+    }
+}
+
+// ============================================================================
+// Scan lifecycle
+// ============================================================================
+
+static void unlink_waiting(catzilla_clamd_scan_t* scan) {
+    catzilla_clamd_t* client = scan->client;
+    catzilla_clamd_scan_t* prev = NULL;
+    for (catzilla_clamd_scan_t* cursor = client->waiting_head; cursor; prev = cursor, cursor = cursor->next) {
+        if (cursor != scan) continue;
+        if (prev) {
+            prev->next = scan->next;
+        } else {
+            client->waiting_head = scan->next;
+        }
+        if (client->waiting_tail == scan) client->waiting_tail = prev;
+        client->stats.waiting--;
+        break;
+    }
+    scan->next = NULL;
+}
+
+static void free_scan(catzilla_clamd_scan_t* scan) {
+    free(scan->buf);
+    free(scan);
+}
+
+// Hand the verdict to the callback and free the scan
+static void complete_scan(catzilla_clamd_scan_t* scan, catzilla_clamd_result_t* result) {
+    catzilla_clamd_t* client = scan->client;
+    result->bytes = scan->bytes;
+    result->elapsed_ms = uv_now(client->loop) - scan->started_at;
+    switch (result->verdict) {
+    case CATZILLA_CLAMD_CLEAN:    client->stats.clean++; break;
+    case CATZILLA_CLAMD_INFECTED: client->stats.infected++; break;
+    default:                      client->stats.errors++; break;
+    }
+
+    catzilla_clamd_callback_t callback = scan->callback;
+    void* data = scan->data;
+    free_scan(scan);
+    if (callback) callback(data, result);
+}
+
+static void fail_scan(catzilla_clamd_scan_t* scan, const char* reason) {
+    catzilla_clamd_result_t result;
+    memset(&result, 0, sizeof(result));
+    result.verdict = CATZILLA_CLAMD_ERROR;
+    set_signature(&result, reason, strlen(reason));
+    complete_scan(scan, &result);
+}
+
+// Start streaming a scan on an idle connection
+static int attach_scan(clamd_conn_t* conn, catzilla_clamd_scan_t* scan) {
+    catzilla_clamd_t* client = conn->client;
+    size_t mark = conn->out_len;
+    if (append(&conn->out, &conn->out_len, &conn->out_cap, CLAMD_STREAM_COMMAND, sizeof(CLAMD_STREAM_COMMAND)) != 0 ||
+        (scan->buf_len > 0 &&
+         append(&conn->out, &conn->out_len, &conn->out_cap, scan->buf, scan->buf_len) != 0)) {
+        conn->out_len = mark;
+        return -1;
+    }
+    free(scan->buf);
+    scan->buf = NULL;
+    scan->buf_len = 0;
+    scan->buf_cap = 0;
+
+    scan->conn = conn;
+    conn->scan = scan;
+    conn->busy = true;
+    conn->deadline = scan->deadline;
+    if (conn->state == CLAMD_CONN_READY) schedule_flush(client);
+    return 0;
+}
+
+// An idle connection that is up or on its way; a down one is started when
+// its backoff allows it
+static clamd_conn_t* pick_connection(catzilla_clamd_t* client) {
+    clamd_conn_t* connecting = NULL;
+    clamd_conn_t* down = NULL;
+    uint64_t now = uv_now(client->loop);
+    for (int i = 0; i < client->pool_size; i++) {
+        clamd_conn_t* conn = &client->conns[i];
+        if (conn->busy) continue;
+        if (conn->state == CLAMD_CONN_READY) return conn;
+        if (conn->state == CLAMD_CONN_CONNECTING || conn->state == CLAMD_CONN_RESOLVING) {
+            if (!connecting) connecting = conn;
+        } else if (conn->state == CLAMD_CONN_DOWN && now >= conn->retry_at && !conn->handle_open && !down) {
+            down = conn;
+        }
+    }
+    if (connecting) return connecting;
+    if (down) {
+        start_connect(down);
+        if (down->state == CLAMD_CONN_CONNECTING || down->state == CLAMD_CONN_RESOLVING) return down;
+    }
+    return NULL;
+}
+
+// True while some connection is up or may be tried right away
+static bool any_connection_usable(catzilla_clamd_t* client) {
+    uint64_t now = uv_now(client->loop);
+    for (int i = 0; i < client->pool_size; i++) {
+        clamd_conn_t* conn = &client->conns[i];
+        switch (conn->state) {
+        case CLAMD_CONN_READY:
+        case CLAMD_CONN_CONNECTING:
+        case CLAMD_CONN_RESOLVING:
+            return true;
+        case CLAMD_CONN_CLOSING:
+            if (!conn->backoff) return true;
+            break;
+        case CLAMD_CONN_DOWN:
+            if (now >= conn->retry_at) return true;
+            break;
+        }
+    }
+    return false;
+}
+
+static void assign_waiting(catzilla_clamd_t* client) {
+    while (client->waiting_head && !client->closing) {
+        clamd_conn_t* conn = pick_connection(client);
+        if (!conn) return;
+        catzilla_clamd_scan_t* scan = client->waiting_head;
+        unlink_waiting(scan);
+        if (attach_scan(conn, scan) != 0) {
+            fail_scan(scan, "out of memory");
+        }
+    }
+}
+
+// ============================================================================
+// Replies
+// ============================================================================
+
+static void process_input(clamd_conn_t* conn) {
+    catzilla_clamd_t* client = conn->client;
+    char* nul;
+    while (conn->state == CLAMD_CONN_READY && (nul = memchr(conn->in, '\0', conn->in_len)) != NULL) {
+        size_t reply_len = (size_t)(nul - conn->in);
+        if (!conn->busy) {
+            LOG_CLAMAV_ERROR("clamd sent a reply nobody asked for: %.*s", (int)reply_len, conn->in);
+            reset_connection(conn, true, "clamd protocol error");
+            return;
+        }
+
+        catzilla_clamd_result_t result;
+        memset(&result, 0, sizeof(result));
+        if (catzilla_clamd_parse_reply(conn->in, reply_len, &result) != 0) {
+            LOG_CLAMAV_ERROR("Unexpected clamd reply: %.*s", (int)reply_len, conn->in);
+        }
+        memmove(conn->in, nul + 1, conn->in_len - reply_len - 1);
+        conn->in_len -= reply_len + 1;
+
+        catzilla_clamd_scan_t* scan = conn->scan;
+        conn->scan = NULL;
+        conn->busy = false;
+        conn->deadline = 0;
+
+        // clamd ends the session after refusing a stream
+        bool refused = result.verdict == CATZILLA_CLAMD_ERROR;
+        if (refused) {
+            LOG_CLAMAV_WARN("clamd could not scan a stream: %s", result.signature);
+            reset_connection(conn, false, "clamd error");
+        }
+        if (scan) {
+            scan->conn = NULL;
+            complete_scan(scan, &result);
+        }
+        if (client->closing || refused) return;
+    }
+
+    if (conn->state == CLAMD_CONN_READY && conn->in_len == sizeof(conn->in)) {
+        LOG_CLAMAV_ERROR("clamd reply too long");
+        reset_connection(conn, true, "clamd protocol error");
+    }
+}
+
+// ============================================================================
+// Connection lifecycle
+// ============================================================================
+
+static void release_handle(catzilla_clamd_t* client) {
+    if (--client->open_handles > 0 || !client->closing) return;
+
+    for (int i = 0; i < client->pool_size; i++) {
+        free(client->conns[i].out);
+    }
+    free(client);
+}
+
+static void on_client_handle_closed(uv_handle_t* handle) {
+    release_handle((catzilla_clamd_t*)handle->data);
+}
+
+static void mark_down(clamd_conn_t* conn, bool backoff) {
+    conn->state = CLAMD_CONN_DOWN;
+    if (!backoff) {
+        // clamd closed an idle session: reconnect when a scan needs it
+        conn->retry_at = 0;
+        return;
+    }
+    conn->retry_at = uv_now(conn->client->loop) + conn->backoff_ms;
+    conn->backoff_ms = conn->backoff_ms * 2 < CATZILLA_CLAMD_RECONNECT_MAX_MS ?
+        conn->backoff_ms * 2 : CATZILLA_CLAMD_RECONNECT_MAX_MS;
+}
+
+static void on_conn_closed(uv_handle_t* handle) {
+    clamd_conn_t* conn = (clamd_conn_t*)handle->data;
+    catzilla_clamd_t* client = conn->client;
+    conn->handle_open = false;
+    if (!client->closing) {
+        mark_down(conn, conn->backoff);
+        assign_waiting(client);
+    }
+    release_handle(client);
+}
+
+// Drop the socket and fail the scan streaming on it
+static void reset_connection(clamd_conn_t* conn, bool backoff, const char* reason) {
+    if (conn->state == CLAMD_CONN_CLOSING || conn->state == CLAMD_CONN_DOWN) return;
+
+    conn->backoff = backoff;
+    if (conn->state == CLAMD_CONN_RESOLVING) {
+        // The resolver callback sees the state and stops there
+        conn->state = CLAMD_CONN_CLOSING;
+    } else if (conn->handle_open) {
+        conn->state = CLAMD_CONN_CLOSING;
+        uv_close((uv_handle_t*)&conn->handle, on_conn_closed);
+    } else {
+        mark_down(conn, backoff);
+    }
+    conn->out_len = 0;
+    conn->in_len = 0;
+    conn->busy = false;
+    conn->deadline = 0;
+
+    catzilla_clamd_scan_t* scan = conn->scan;
+    conn->scan = NULL;
+    if (scan) {
+        scan->conn = NULL;
+        fail_scan(scan, reason);
+    }
+}
+
+static void on_input(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
+    (void)buf;
+    clamd_conn_t* conn = (clamd_conn_t*)stream->data;
+    if (nread < 0) {
+        // clamd closes sessions that sit idle; only a lost scan is a failure
+        if (conn->busy) {
+            LOG_CLAMAV_WARN("clamd connection lost: %s", uv_strerror((int)nread));
+        }
+        reset_connection(conn, conn->busy, "clamd connection lost");
+        return;
+    }
+    conn->in_len += (size_t)nread;
+    process_input(conn);
+}
+
+static void alloc_input(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf) {
+    (void)suggested_size;
+    clamd_conn_t* conn = (clamd_conn_t*)handle->data;
+    *buf = uv_buf_init(conn->in + conn->in_len, (unsigned int)(sizeof(conn->in) - conn->in_len));
+}
+
+static void on_connect(uv_connect_t* req, int status) {
+    clamd_conn_t* conn = (clamd_conn_t*)req->data;
+    catzilla_clamd_t* client = conn->client;
+    if (conn->state != CLAMD_CONN_CONNECTING) return;
+
+    if (status < 0) {
+        LOG_CLAMAV_WARN("Cannot connect to clamd at %s%s%s: %s", client->path,
+                        client->unix_socket ? "" : ":", client->unix_socket ? "" : client->port,
+                        uv_strerror(status));
+        reset_connection(conn, true, "clamd unreachable");
+        return;
+    }
+
+    conn->state = CLAMD_CONN_READY;
+    conn->state_since = uv_now(client->loop);
+    conn->backoff_ms = CLAMD_INITIAL_BACKOFF_MS;
+    if (conn->ever_connected) client->stats.reconnects++;
+    conn->ever_connected = true;
+    uv_read_start(conn_stream(conn), alloc_input, on_input);
+    schedule_flush(client);
+    LOG_CLAMAV_DEBUG("Connected to clamd");
+}
+
+static void connect_address(clamd_conn_t* conn, const struct sockaddr* addr) {
+    catzilla_clamd_t* client = conn->client;
+    int rc = client->unix_socket ? uv_pipe_init(client->loop, &conn->handle.pipe, 0)
+                                 : uv_tcp_init(client->loop, &conn->handle.tcp);
+    if (rc != 0) {
+        mark_down(conn, true);
+        return;
+    }
+    conn->handle.tcp.data = conn;
+    conn->handle_open = true;
+    client->open_handles++;
+
+    conn->state = CLAMD_CONN_CONNECTING;
+    conn->state_since = uv_now(client->loop);
+    conn->connect_req.data = conn;
+    if (client->unix_socket) {
+        uv_pipe_connect(&conn->connect_req, &conn->handle.pipe, client->path, on_connect);
+        return;
+    }
+
+    uv_tcp_nodelay(&conn->handle.tcp, 1);
+    rc = uv_tcp_connect(&conn->connect_req, &conn->handle.tcp, addr, on_connect);
+    if (rc != 0) {
+        LOG_CLAMAV_WARN("Cannot connect to clamd at %s:%s: %s", client->path, client->port, uv_strerror(rc));
+        reset_connection(conn, true, "clamd unreachable");
+    }
+}
+
+static void on_resolved(uv_getaddrinfo_t* req, int status, struct addrinfo* result) {
+    clamd_conn_t* conn = (clamd_conn_t*)req->data;
+    catzilla_clamd_t* client = conn->client;
+    conn->resolving = false;
+
+    if (client->closing || conn->state != CLAMD_CONN_RESOLVING) {
+        if (!client->closing) {
+            mark_down(conn, conn->backoff);
+            assign_waiting(client);
+        }
+    } else if (status < 0 || !result) {
+        LOG_CLAMAV_WARN("Cannot resolve clamd host %s: %s", client->path, uv_strerror(status));
+        reset_connection(conn, true, "clamd unreachable");
+    } else {
+        connect_address(conn, result->ai_addr);
+    }
+    if (result) uv_freeaddrinfo(result);
+    release_handle(client);
+}
+
+static void start_connect(clamd_conn_t* conn) {
+    catzilla_clamd_t* client = conn->client;
+    conn->state = CLAMD_CONN_RESOLVING;
+    conn->state_since = uv_now(client->loop);
+
+    // The session command goes out before any scan attached while connecting
+    conn->out_len = 0;
+    if (append(&conn->out, &conn->out_len, &conn->out_cap, CLAMD_SESSION_COMMAND, sizeof(CLAMD_SESSION_COMMAND)) != 0) {
+        mark_down(conn, true);
+        return;
+    }
+
+    // Unix sockets and numeric addresses skip the resolver
+    struct sockaddr_storage addr;
+    if (client->unix_socket ||
+        uv_ip4_addr(client->path, atoi(client->port), (struct sockaddr_in*)&addr) == 0 ||
+        uv_ip6_addr(client->path, atoi(client->port), (struct sockaddr_in6*)&addr) == 0) {
+        connect_address(conn, (const struct sockaddr*)&addr);
+        return;
+    }
+
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    conn->resolver.data = conn;
+    int rc = uv_getaddrinfo(client->loop, &conn->resolver, on_resolved, client->path, client->port, &hints);
+    if (rc != 0) {
+        LOG_CLAMAV_WARN("Cannot resolve clamd host %s: %s", client->path, uv_strerror(rc));
+        mark_down(conn, true);
+        return;
+    }
+    conn->resolving = true;
+    client->open_handles++;
+}
+
+// ============================================================================
+// Flushing and timeouts
+// ============================================================================
+
+static void on_write_done(uv_write_t* req, int status) {
+    clamd_write_t* write = (clamd_write_t*)req;
+    clamd_conn_t* conn = (clamd_conn_t*)req->handle->data;
+    free(write->buf.base);
+    free(write);
+    if (status < 0 && conn->state == CLAMD_CONN_READY) {
+        LOG_CLAMAV_WARN("clamd write failed: %s", uv_strerror(status));
+        reset_connection(conn, true, "clamd write failed");
+    }
+}
+
+static void flush_connection(clamd_conn_t* conn) {
+    uv_buf_t buf = uv_buf_init(conn->out, (unsigned int)conn->out_len);
+    // Queued writes go first; writing around them would reorder the stream
+    int written = conn_stream(conn)->write_queue_size == 0 ?
+        uv_try_write(conn_stream(conn), &buf, 1) : UV_EAGAIN;
+    if (written < 0 && written != UV_EAGAIN && written != UV_ENOSYS) {
+        LOG_CLAMAV_WARN("clamd write failed: %s", uv_strerror(written));
+        reset_connection(conn, true, "clamd write failed");
+        return;
+    }
+    size_t done = written > 0 ? (size_t)written : 0;
+    if (done == conn->out_len) {
+        conn->out_len = 0;
+        return;
+    }
+
+    // The rest goes out with a write that owns the buffer
+    clamd_write_t* write = malloc(sizeof(*write));
+    if (!write) {
+        reset_connection(conn, true, "out of memory");
+        return;
+    }
+    if (done > 0) memmove(conn->out, conn->out + done, conn->out_len - done);
+    write->buf = uv_buf_init(conn->out, (unsigned int)(conn->out_len - done));
+    conn->out = NULL;
+    conn->out_len = 0;
+    conn->out_cap = 0;
+
+    int rc = uv_write(&write->req, conn_stream(conn), &write->buf, 1, on_write_done);
+    if (rc != 0) {
+        free(write->buf.base);
+        free(write);
+        reset_connection(conn, true, "clamd write failed");
+    }
+}
+
+// Runs right before the loop polls: everything framed this iteration goes out
+static void on_flush(uv_prepare_t* handle) {
+    catzilla_clamd_t* client = (catzilla_clamd_t*)handle->data;
+    uv_prepare_stop(handle);
+    for (int i = 0; i < client->pool_size; i++) {
+        clamd_conn_t* conn = &client->conns[i];
+        if (conn->state == CLAMD_CONN_READY && conn->out_len > 0) {
+            flush_connection(conn);
+        }
+    }
+}
+
+static void on_tick(uv_timer_t* handle) {
+    catzilla_clamd_t* client = (catzilla_clamd_t*)handle->data;
+    uint64_t now = uv_now(client->loop);
+    uint64_t connect_timeout = client->timeout_ms < 2000 ? client->timeout_ms : 2000;
+
+    for (int i = 0; i < client->pool_size && !client->closing; i++) {
+        clamd_conn_t* conn = &client->conns[i];
+        if (conn->state == CLAMD_CONN_READY && conn->busy && conn->deadline && now >= conn->deadline) {
+            LOG_CLAMAV_WARN("clamd did not answer within %ums; reconnecting", client->timeout_ms);
+            client->stats.timeouts++;
+            reset_connection(conn, true, "clamd timed out");
+        } else if (conn->state == CLAMD_CONN_CONNECTING && now - conn->state_since > connect_timeout) {
+            client->stats.timeouts++;
+            reset_connection(conn, true, "clamd unreachable");
+        }
+    }
+
+    // Scans whose data is complete do not wait for a connection forever. A
+    // callback may change the queue, so the search starts over after each.
+    while (!client->closing) {
+        catzilla_clamd_scan_t* scan = client->waiting_head;
+        while (scan && !(scan->deadline && now >= scan->deadline)) scan = scan->next;
+        if (!scan) break;
+        unlink_waiting(scan);
+        fail_scan(scan, any_connection_usable(client) ? "clamd busy" : "clamd unreachable");
+    }
+    assign_waiting(client);
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+catzilla_clamd_t* catzilla_clamd_create(uv_loop_t* loop, const char* address,
+                                        const catzilla_clamd_config_t* config) {
+    if (!loop || !address) return NULL;
+
+    catzilla_clamd_t* client = calloc(1, sizeof(*client));
+    if (!client) return NULL;
+    if (parse_address(address, client) != 0) {
+        LOG_CLAMAV_ERROR("Invalid clamd address (expected unix:/path or host:port)");
+        free(client);
+        return NULL;
+    }
+
+    int pool_size = config && config->pool_size > 0 ? config->pool_size : CATZILLA_CLAMD_POOL_SIZE;
+    client->pool_size = pool_size < CATZILLA_CLAMD_MAX_POOL_SIZE ? pool_size : CATZILLA_CLAMD_MAX_POOL_SIZE;
+    client->timeout_ms = config && config->scan_timeout_ms > 0 ?
+        config->scan_timeout_ms : CATZILLA_CLAMD_SCAN_TIMEOUT_MS;
+    client->max_buffered = config && config->max_buffered > 0 ?
+        config->max_buffered : CATZILLA_CLAMD_MAX_BUFFERED;
+    client->loop = loop;
+
+    uv_prepare_init(loop, &client->flush_handle);
+    client->flush_handle.data = client;
+    uv_timer_init(loop, &client->tick);
+    client->tick.data = client;
+    client->open_handles = 2;
+
+    // Retries and timeouts never keep the loop alive on their own
+    uint64_t period = client->timeout_ms / 4 < 100 ? client->timeout_ms / 4 : 100;
+    if (period < 10) period = 10;
+    uv_timer_start(&client->tick, on_tick, period, period);
+    uv_unref((uv_handle_t*)&client->tick);
+
+    for (int i = 0; i < client->pool_size; i++) {
+        clamd_conn_t* conn = &client->conns[i];
+        conn->client = client;
+        conn->backoff_ms = CLAMD_INITIAL_BACKOFF_MS;
+    }
+    return client;
+}
+
+void catzilla_clamd_close(catzilla_clamd_t* client) {
+    if (!client || client->closing) return;
+    client->closing = true;
+
+    uv_prepare_stop(&client->flush_handle);
+    uv_close((uv_handle_t*)&client->flush_handle, on_client_handle_closed);
+    uv_timer_stop(&client->tick);
+    uv_close((uv_handle_t*)&client->tick, on_client_handle_closed);
+
+    for (int i = 0; i < client->pool_size; i++) {
+        clamd_conn_t* conn = &client->conns[i];
+        if (conn->state == CLAMD_CONN_READY && !conn->busy && conn_stream(conn)->write_queue_size == 0) {
+            // A polite goodbye to a session that is idle; never waited for
+            uv_buf_t buf = uv_buf_init((char*)CLAMD_END_COMMAND, sizeof(CLAMD_END_COMMAND));
+            uv_try_write(conn_stream(conn), &buf, 1);
+        }
+        reset_connection(conn, false, "clamd client closed");
+        if (conn->resolving) {
+            uv_cancel((uv_req_t*)&conn->resolver);
+        }
+    }
+
+    while (client->waiting_head) {
+        catzilla_clamd_scan_t* scan = client->waiting_head;
+        unlink_waiting(scan);
+        fail_scan(scan, "clamd client closed");
+    }
+}
+
+catzilla_clamd_scan_t* catzilla_clamd_scan_start(catzilla_clamd_t* client,
+                                                 catzilla_clamd_callback_t callback, void* data) {
+    if (!client || client->closing) return NULL;
+    catzilla_clamd_scan_t* scan = calloc(1, sizeof(*scan));
+    if (!scan) {
+        client->stats.rejected++;
+        return NULL;
+    }
+    scan->client = client;
+    scan->callback = callback;
+    scan->data = data;
+    scan->started_at = uv_now(client->loop);
+
+    clamd_conn_t* conn = pick_connection(client);
+    if (conn && attach_scan(conn, scan) == 0) {
+        client->stats.scans++;
+        return scan;
+    }
+    if (!conn && any_connection_usable(client)) {
+        // Every connection is streaming another scan
+        if (client->waiting_tail) {
+            client->waiting_tail->next = scan;
+        } else {
+            client->waiting_head = scan;
+        }
+        client->waiting_tail = scan;
+        client->stats.waiting++;
+        client->stats.scans++;
+        return scan;
+    }
+
+    free_scan(scan);
+    client->stats.rejected++;
+    return NULL;
+}
+
+int catzilla_clamd_scan_write(catzilla_clamd_scan_t* scan, const void* data, size_t len) {
+    if (!scan || scan->finished || (!data && len > 0)) return -1;
+    if (len == 0) return 0;  // An empty chunk would end the stream
+
+    catzilla_clamd_t* client = scan->client;
+    clamd_conn_t* conn = scan->conn;
+    size_t backlog = scan->buf_len;
+    if (conn) {
+        backlog = conn->out_len + (conn->state == CLAMD_CONN_READY ? conn_stream(conn)->write_queue_size : 0);
+    }
+    if (backlog + len > client->max_buffered) {
+        LOG_CLAMAV_WARN("clamd is not keeping up; dropping a scan with %zu bytes waiting", backlog);
+        client->stats.rejected++;
+        catzilla_clamd_scan_cancel(scan);
+        return -1;
+    }
+
+    int rc = conn ? append_chunks(&conn->out, &conn->out_len, &conn->out_cap, data, len)
+                  : append_chunks(&scan->buf, &scan->buf_len, &scan->buf_cap, data, len);
+    if (rc != 0) {
+        catzilla_clamd_scan_cancel(scan);
+        return -1;
+    }
+    scan->bytes += len;
+    client->stats.bytes += len;
+    if (conn && conn->state == CLAMD_CONN_READY) schedule_flush(client);
+    return 0;
+}
+
+int catzilla_clamd_scan_finish(catzilla_clamd_scan_t* scan) {
+    if (!scan || scan->finished) return -1;
+    catzilla_clamd_t* client = scan->client;
+    clamd_conn_t* conn = scan->conn;
+
+    int rc = conn ? append_stream_end(&conn->out, &conn->out_len, &conn->out_cap)
+                  : append_stream_end(&scan->buf, &scan->buf_len, &scan->buf_cap);
+    if (rc != 0) {
+        catzilla_clamd_scan_cancel(scan);
+        return -1;
+    }
+    scan->finished = true;
+    scan->deadline = uv_now(client->loop) + client->timeout_ms;
+    if (conn) {
+        conn->deadline = scan->deadline;
+        if (conn->state == CLAMD_CONN_READY) schedule_flush(client);
+    }
+    return 0;
+}
+
+void catzilla_clamd_scan_cancel(catzilla_clamd_scan_t* scan) {
+    if (!scan) return;
+    clamd_conn_t* conn = scan->conn;
+    if (!conn) {
+        unlink_waiting(scan);
+        free_scan(scan);
+        return;
+    }
+
+    // The connection stays busy until clamd answers the ended stream
+    conn->scan = NULL;
+    if (!scan->finished) {
+        catzilla_clamd_t* client = conn->client;
+        if (append_stream_end(&conn->out, &conn->out_len, &conn->out_cap) != 0) {
+            free_scan(scan);
+            reset_connection(conn, false, "out of memory");
+            return;
+        }
+        conn->deadline = uv_now(client->loop) + client->timeout_ms;
+        if (conn->state == CLAMD_CONN_READY) schedule_flush(client);
+    }
+    free_scan(scan);
+}
+
+void catzilla_clamd_get_stats(const catzilla_clamd_t* client, catzilla_clamd_stats_t* stats) {
+    if (!stats) return;
+    memset(stats, 0, sizeof(*stats));
+    if (!client) return;
+
+    *stats = client->stats;
+    for (int i = 0; i < client->pool_size; i++) {
+        if (client->conns[i].state == CLAMD_CONN_READY) stats->connected++;
+    }
+}
@@ -0,0 +1,157 @@
+/*
+ * Catzilla clamd Client - non-blocking INSTREAM virus scanning on a libuv loop
+ *
+ * One client belongs to one event loop and is only used from that loop's
+ * thread. It keeps a small pool of IDSESSION connections to clamd over its
+ * Unix or TCP socket; each connection streams one scan at a time, and a
+ * scan started while every connection is busy waits for the next free one.
+ * Data handed to a scan is framed as INSTREAM chunks right away and written
+ * right before the loop polls, so a file is scanned while it is still being
+ * received and the verdict arrives shortly after its last chunk. Results are
+ * delivered to a callback from the loop. Connections open on demand, and a
+ * connection that fails or stalls past the scan timeout is reset: the scan
+ * on it fails, and it reconnects with backoff.
+ */
+
+#ifndef CATZILLA_CLAMD_CLIENT_H
+#define CATZILLA_CLAMD_CLIENT_H
+
+#include <uv.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct catzilla_clamd_s catzilla_clamd_t;
+typedef struct catzilla_clamd_scan_s catzilla_clamd_scan_t;
+
+#define CATZILLA_CLAMD_DEFAULT_PORT 3310
+#define CATZILLA_CLAMD_POOL_SIZE 4
+#define CATZILLA_CLAMD_MAX_POOL_SIZE 16
+#define CATZILLA_CLAMD_SCAN_TIMEOUT_MS 30000
+#define CATZILLA_CLAMD_MAX_BUFFERED (8 * 1024 * 1024)
+#define CATZILLA_CLAMD_RECONNECT_MAX_MS 5000
+#define CATZILLA_CLAMD_SIGNATURE_MAX 128
+
+// Client configuration; zero fields take the defaults above
+typedef struct catzilla_clamd_config_s {
+    int pool_size;                // Connections per loop
+    uint32_t scan_timeout_ms;     // Fail a scan whose verdict is this late after its last chunk
+    size_t max_buffered;          // Bytes a scan may have waiting to be written before it fails
+} catzilla_clamd_config_t;
+
+typedef enum {
+    CATZILLA_CLAMD_CLEAN = 0,     // stream: OK
+    CATZILLA_CLAMD_INFECTED,      // stream: <signature> FOUND
+    CATZILLA_CLAMD_ERROR          // clamd refused the stream, or no verdict arrived
+} catzilla_clamd_verdict_t;
+
+typedef struct {
+    catzilla_clamd_verdict_t verdict;
+    char signature[CATZILLA_CLAMD_SIGNATURE_MAX];  // Signature when infected, reason on error
+    uint64_t bytes;               // Bytes streamed to clamd
+    uint64_t elapsed_ms;          // From the start of the scan to the verdict
+} catzilla_clamd_result_t;
+
+/**
+ * Verdict callback. Runs once per scan from the loop, unless the scan was
+ * canceled; the scan is freed when it returns.
+ */
+typedef void (*catzilla_clamd_callback_t)(void* data, const catzilla_clamd_result_t* result);
+
+typedef struct catzilla_clamd_stats_s {
+    uint64_t scans;               // Scans started
+    uint64_t clean;               // Verdicts: clean
+    uint64_t infected;            // Verdicts: infected
+    uint64_t errors;              // Scans that ended without a verdict
+    uint64_t rejected;            // Scans refused (clamd down) or dropped (backlog full)
+    uint64_t timeouts;            // Connections reset for a late verdict
+    uint64_t reconnects;          // Connections established after the first
+    uint64_t bytes;               // Bytes streamed
+    int waiting;                  // Scans waiting for a connection right now
+    int connected;                // Connections ready right now
+} catzilla_clamd_stats_t;
+
+/**
+ * Parse a clamd reply to INSTREAM ("[id: ]stream: OK", "... FOUND" or "... ERROR")
+ * @param reply Reply text, without the terminating NUL or newline
+ * @param len Length of reply
+ * @param result Receives the verdict and signature (bytes and elapsed_ms are left alone)
+ * @return 0 on success, -1 if the reply is not an INSTREAM verdict
+ */
+int catzilla_clamd_parse_reply(const char* reply, size_t len, catzilla_clamd_result_t* result);
+
+/**
+ * Check an address without connecting
+ * @param address "unix:/path", "/path", "tcp://host[:port]" or "host[:port]"
+ * @return true if catzilla_clamd_create would accept it
+ */
+bool catzilla_clamd_address_valid(const char* address);
+
+/**
+ * Create a client for a loop. Connections open when scans need them.
+ * @param loop Loop the client runs on; every call must come from its thread
+ * @param address clamd socket, see catzilla_clamd_address_valid
+ * @param config Configuration, or NULL for the defaults
+ * @return Client, or NULL if the address is invalid or memory runs out
+ */
+catzilla_clamd_t* catzilla_clamd_create(uv_loop_t* loop, const char* address,
+                                        const catzilla_clamd_config_t* config);
+
+/**
+ * Fail every outstanding scan and close the connections. The client frees
+ * itself once the loop has run the close callbacks, so call this before the
+ * loop's handles are walked and closed.
+ * @param client Client (may be NULL)
+ */
+void catzilla_clamd_close(catzilla_clamd_t* client);
+
+/**
+ * Start a scan. Its data follows with catzilla_clamd_scan_write.
+ * @param client Client
+ * @param callback Verdict callback
+ * @param data Passed to the callback
+ * @return Scan, or NULL if refused because clamd is unreachable (the callback never runs)
+ */
+catzilla_clamd_scan_t* catzilla_clamd_scan_start(catzilla_clamd_t* client,
+                                                 catzilla_clamd_callback_t callback, void* data);
+
+/**
+ * Stream the next bytes of the scanned data
+ * @param scan Scan that was not finished yet
+ * @param data Bytes
+ * @param len Length of data (0 is a no-op)
+ * @return 0 on success, -1 if the backlog is full or memory runs out; the
+ *         scan is canceled then and its callback never runs
+ */
+int catzilla_clamd_scan_write(catzilla_clamd_scan_t* scan, const void* data, size_t len);
+
+/**
+ * End the data; the verdict follows through the callback
+ * @param scan Scan that was not finished yet
+ * @return 0 on success, -1 on failure (the scan is canceled, its callback never runs)
+ */
+int catzilla_clamd_scan_finish(catzilla_clamd_scan_t* scan);
+
+/**
+ * Drop a scan whose callback has not run. The callback never runs; a
+ * connection streaming it ends the stream and discards the verdict.
+ * @param scan Scan (may be NULL)
+ */
+void catzilla_clamd_scan_cancel(catzilla_clamd_scan_t* scan);
+
+/**
+ * Get client statistics
+ * @param client Client
+ * @param stats Receives the statistics
+ */
+void catzilla_clamd_get_stats(const catzilla_clamd_t* client, catzilla_clamd_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CATZILLA_CLAMD_CLIENT_H
@@ -0,0 +1,654 @@
+#include "compression.h"
+#include "memory.h"
+#include "platform_compat.h"
+#include "platform_atomic.h"
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#ifndef _WIN32
+#include <strings.h>
+#endif
+#ifdef CATZILLA_HAS_ZLIB
+#include <zlib.h>
+#endif
+#ifdef CATZILLA_HAS_BROTLI
+#include <brotli/encode.h>
+#endif
+#ifdef CATZILLA_HAS_ZSTD
+#include <zstd.h>
+#endif
+
+// ---------------------------------------------------------------------------
+// Statistics
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    catzilla_atomic_uint64_t responses;
+    catzilla_atomic_uint64_t skipped;
+    catzilla_atomic_uint64_t bytes_in;
+    catzilla_atomic_uint64_t bytes_out;
+    catzilla_atomic_uint64_t cpu_ns;
+} encoding_counters_t;
+
+// Indexed by encoding_index()
+static encoding_counters_t encoding_counters[CATZILLA_ENCODING_COUNT];
+static catzilla_atomic_uint64_t stat_buffer_hits = 0;
+static catzilla_atomic_uint64_t stat_buffer_misses = 0;
+
+static int encoding_index(int encoding) {
+    switch (encoding) {
+        case CATZILLA_ENCODING_GZIP: return 0;
+        case CATZILLA_ENCODING_BR: return 1;
+        case CATZILLA_ENCODING_ZSTD: return 2;
+        default: return -1;
+    }
+}
+
+static uint64_t thread_cpu_ns(void) {
+#ifdef _WIN32
+    FILETIME creation, exit_time, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exit_time, &kernel, &user)) return 0;
+    uint64_t ticks = ((uint64_t)kernel.dwHighDateTime << 32 | kernel.dwLowDateTime) +
+                     ((uint64_t)user.dwHighDateTime << 32 | user.dwLowDateTime);
+    return ticks * 100;  // 100 ns units
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static void count_compression(int encoding, size_t in, size_t out, uint64_t cpu_ns, bool skipped) {
+    int index = encoding_index(encoding);
+    if (index < 0) return;
+    encoding_counters_t* counters = &encoding_counters[index];
+    if (skipped) {
+        catzilla_atomic_fetch_add(&counters->skipped, 1);
+    } else {
+        catzilla_atomic_fetch_add(&counters->bytes_in, (uint64_t)in);
+        catzilla_atomic_fetch_add(&counters->bytes_out, (uint64_t)out);
+    }
+    catzilla_atomic_fetch_add(&counters->cpu_ns, cpu_ns);
+}
+
+// ---------------------------------------------------------------------------
+// Output buffer pool
+// ---------------------------------------------------------------------------
+
+// Each event loop runs on its own thread, so a thread-local freelist per size
+// class needs no locking
+typedef struct {
+    catzilla_compress_buffer_t* free_buffers[CATZILLA_COMPRESS_BUFFER_CLASSES][CATZILLA_COMPRESS_POOL_MAX_RETAINED];
+    int count[CATZILLA_COMPRESS_BUFFER_CLASSES];
+} compress_buffer_pool_t;
+
+static CATZILLA_THREAD_LOCAL compress_buffer_pool_t buffer_pool;
+
+static size_t class_capacity(int size_class) {
+    return (size_t)CATZILLA_COMPRESS_BUFFER_MIN << (2 * size_class);
+}
+
+catzilla_compress_buffer_t* catzilla_compress_buffer_acquire(size_t min_capacity) {
+    int size_class = 0;
+    while (size_class < CATZILLA_COMPRESS_BUFFER_CLASSES && class_capacity(size_class) < min_capacity) {
+        size_class++;
+    }
+
+    if (size_class < CATZILLA_COMPRESS_BUFFER_CLASSES && buffer_pool.count[size_class] > 0) {
+        catzilla_compress_buffer_t* buffer = buffer_pool.free_buffers[size_class][--buffer_pool.count[size_class]];
+        buffer->length = 0;
+        catzilla_atomic_fetch_add(&stat_buffer_hits, 1);
+        return buffer;
+    }
+
+    size_t capacity = size_class < CATZILLA_COMPRESS_BUFFER_CLASSES ? class_capacity(size_class) : min_capacity;
+    catzilla_compress_buffer_t* buffer = catzilla_response_alloc(sizeof(*buffer) + capacity);
+    if (!buffer) return NULL;
+    buffer->capacity = capacity;
+    buffer->length = 0;
+    buffer->size_class = size_class < CATZILLA_COMPRESS_BUFFER_CLASSES ? size_class : -1;
+    catzilla_atomic_fetch_add(&stat_buffer_misses, 1);
+    return buffer;
+}
+
+void catzilla_compress_buffer_release(catzilla_compress_buffer_t* buffer) {
+    if (!buffer) return;
+
+    int size_class = buffer->size_class;
+    if (size_class >= 0 && buffer_pool.count[size_class] < CATZILLA_COMPRESS_POOL_MAX_RETAINED) {
+        buffer_pool.free_buffers[size_class][buffer_pool.count[size_class]++] = buffer;
+        return;
+    }
+    catzilla_response_free(buffer);
+}
+
+// Move the bytes so far into a buffer at least twice as large; the old
+// buffer is released either way
+static catzilla_compress_buffer_t* grow_buffer(catzilla_compress_buffer_t* buffer) {
+    catzilla_compress_buffer_t* larger = catzilla_compress_buffer_acquire(buffer->capacity * 2);
+    if (!larger) {
+        catzilla_compress_buffer_release(buffer);
+        return NULL;
+    }
+    memcpy(larger->data, buffer->data, buffer->length);
+    larger->length = buffer->length;
+    catzilla_compress_buffer_release(buffer);
+    return larger;
+}
+
+// ---------------------------------------------------------------------------
+// Reusable per-thread encoders for whole bodies
+// ---------------------------------------------------------------------------
+
+typedef struct {
+#ifdef CATZILLA_HAS_ZLIB
+    z_stream gzip;
+    bool gzip_ready;
+    int gzip_level;
+#endif
+#ifdef CATZILLA_HAS_ZSTD
+    ZSTD_CCtx* zstd;
+#endif
+    int unused;
+} thread_encoders_t;
+
+static CATZILLA_THREAD_LOCAL thread_encoders_t encoders;
+
+void catzilla_compression_trim(void) {
+    for (int c = 0; c < CATZILLA_COMPRESS_BUFFER_CLASSES; c++) {
+        while (buffer_pool.count[c] > 0) {
+            catzilla_response_free(buffer_pool.free_buffers[c][--buffer_pool.count[c]]);
+        }
+    }
+#ifdef CATZILLA_HAS_ZLIB
+    if (encoders.gzip_ready) {
+        deflateEnd(&encoders.gzip);
+        encoders.gzip_ready = false;
+    }
+#endif
+#ifdef CATZILLA_HAS_ZSTD
+    ZSTD_freeCCtx(encoders.zstd);
+    encoders.zstd = NULL;
+#endif
+}
+
+// ---------------------------------------------------------------------------
+// Configuration and negotiation
+// ---------------------------------------------------------------------------
+
+void catzilla_compression_config_init(catzilla_compression_config_t* config) {
+    if (!config) return;
+    config->enabled = true;
+    config->min_size = CATZILLA_COMPRESSION_DEFAULT_MIN_SIZE;
+    config->br_max_size = CATZILLA_COMPRESSION_DEFAULT_BR_MAX_SIZE;
+    config->gzip_level = CATZILLA_COMPRESSION_DEFAULT_GZIP_LEVEL;
+    config->br_quality = CATZILLA_COMPRESSION_DEFAULT_BR_QUALITY;
+    config->zstd_level = CATZILLA_COMPRESSION_DEFAULT_ZSTD_LEVEL;
+}
+
+int catzilla_compression_available(void) {
+    int available = 0;
+#ifdef CATZILLA_HAS_ZLIB
+    available |= CATZILLA_ENCODING_GZIP;
+#endif
+#ifdef CATZILLA_HAS_BROTLI
+    available |= CATZILLA_ENCODING_BR;
+#endif
+#ifdef CATZILLA_HAS_ZSTD
+    available |= CATZILLA_ENCODING_ZSTD;
+#endif
+    return available;
+}
+
+const char* catzilla_compression_encoding_name(int encoding) {
+    switch (encoding) {
+        case CATZILLA_ENCODING_GZIP: return "gzip";
+        case CATZILLA_ENCODING_BR: return "br";
+        case CATZILLA_ENCODING_ZSTD: return "zstd";
+        default: return "identity";
+    }
+}
+
+int catzilla_compression_level(const catzilla_compression_config_t* config, int encoding) {
+    switch (encoding) {
+        case CATZILLA_ENCODING_GZIP: return config->gzip_level;
+        case CATZILLA_ENCODING_BR: return config->br_quality;
+        case CATZILLA_ENCODING_ZSTD: return config->zstd_level;
+        default: return 0;
+    }
+}
+
+static bool prefix_matches(const char* value, size_t length, const char* prefix) {
+    size_t prefix_len = strlen(prefix);
+    return length >= prefix_len && strncasecmp(value, prefix, prefix_len) == 0;
+}
+
+bool catzilla_compression_type_compressible(const char* content_type, size_t length) {
+    if (!content_type) return false;
+
+    // Media type without parameters
+    size_t media_len = 0;
+    while (media_len < length && content_type[media_len] != ';' && content_type[media_len] != ' ') {
+        media_len++;
+    }
+
+    if (prefix_matches(content_type, media_len, "text/")) return true;
+
+    static const char* const types[] = {
+        "application/json", "application/javascript", "application/x-javascript",
+        "application/xml", "application/xhtml+xml", "application/rss+xml",
+        "application/atom+xml", "application/ld+json", "application/manifest+json",
+        "application/graphql-response+json", "application/x-ndjson", "application/wasm",
+        "image/svg+xml", "image/x-icon", "font/ttf", "font/otf", NULL
+    };
+    for (int i = 0; types[i]; i++) {
+        if (media_len == strlen(types[i]) && prefix_matches(content_type, media_len, types[i])) {
+            return true;
+        }
+    }
+
+    // Structured syntax suffixes (RFC 6839)
+    return (media_len > 5 && strncasecmp(content_type + media_len - 5, "+json", 5) == 0) ||
+           (media_len > 4 && strncasecmp(content_type + media_len - 4, "+xml", 4) == 0);
+}
+
+// Quality value of one Accept-Encoding entry in thousandths (RFC 9110 qvalue)
+static int entry_quality(const char* params, const char* end) {
+    const char* q = params;
+    while (q < end && (q = memchr(q, ';', (size_t)(end - q))) != NULL) {
+        q++;
+        while (q < end && (*q == ' ' || *q == '\t')) q++;
+        if (q + 1 < end && (q[0] == 'q' || q[0] == 'Q') && q[1] == '=') {
+            q += 2;
+            if (q < end && *q == '1') return 1000;
+            int value = 0;
+            int digits = 0;
+            if (q < end && *q == '0') q++;
+            if (q < end && *q == '.') {
+                q++;
+                while (q < end && digits < 3 && *q >= '0' && *q <= '9') {
+                    value = value * 10 + (*q - '0');
+                    digits++;
+                    q++;
+                }
+            }
+            while (digits++ < 3) value *= 10;
+            return value;
+        }
+    }
+    return 1000;
+}
+
+void catzilla_compression_parse_accept_encoding(const char* accept_encoding,
+                                                catzilla_accept_encoding_t* accept) {
+    if (!accept) return;
+    for (int i = 0; i < CATZILLA_ENCODING_COUNT; i++) accept->quality[i] = -1;
+    accept->wildcard = -1;
+    if (!accept_encoding) return;
+
+    const char* p = accept_encoding;
+    while (*p) {
+        while (*p == ' ' || *p == '\t' || *p == ',') p++;
+        if (!*p) break;
+        const char* end = strchr(p, ',');
+        if (!end) end = p + strlen(p);
+        size_t name_len = strcspn(p, ";, \t");
+        if (name_len > (size_t)(end - p)) name_len = (size_t)(end - p);
+
+        int q = entry_quality(p + name_len, end);
+        if ((name_len == 4 && strncasecmp(p, "gzip", 4) == 0) ||
+            (name_len == 6 && strncasecmp(p, "x-gzip", 6) == 0)) {
+            accept->quality[encoding_index(CATZILLA_ENCODING_GZIP)] = q;
+        } else if (name_len == 2 && strncasecmp(p, "br", 2) == 0) {
+            accept->quality[encoding_index(CATZILLA_ENCODING_BR)] = q;
+        } else if (name_len == 4 && strncasecmp(p, "zstd", 4) == 0) {
+            accept->quality[encoding_index(CATZILLA_ENCODING_ZSTD)] = q;
+        } else if (name_len == 1 && *p == '*') {
+            accept->wildcard = q;
+        }
+        p = end;
+    }
+}
+
+int catzilla_compression_select(const catzilla_accept_encoding_t* accept, int candidates,
+                                size_t body_size, size_t br_max_size) {
+    if (!accept) return CATZILLA_ENCODING_IDENTITY;
+
+    // Preference between equal quality values: br compresses text best at
+    // low qualities, zstd and gzip are cheaper per byte on large bodies
+    static const int small_order[] = { CATZILLA_ENCODING_BR, CATZILLA_ENCODING_ZSTD, CATZILLA_ENCODING_GZIP };
+    static const int large_order[] = { CATZILLA_ENCODING_ZSTD, CATZILLA_ENCODING_GZIP, CATZILLA_ENCODING_BR };
+    const int* order = body_size <= br_max_size ? small_order : large_order;
+
+    int best = CATZILLA_ENCODING_IDENTITY;
+    int best_quality = 0;
+    for (int i = 0; i < CATZILLA_ENCODING_COUNT; i++) {
+        int encoding = order[i];
+        if (!(candidates & encoding)) continue;
+        int q = accept->quality[encoding_index(encoding)];
+        if (q < 0) q = accept->wildcard;
+        if (q > best_quality) {
+            best = encoding;
+            best_quality = q;
+        }
+    }
+    return best;
+}
+
+int catzilla_compression_negotiate(const catzilla_compression_config_t* config,
+                                   const char* accept_encoding, size_t body_size) {
+    if (!config || !config->enabled || !accept_encoding) return CATZILLA_ENCODING_IDENTITY;
+    if (body_size != SIZE_MAX && body_size < config->min_size) return CATZILLA_ENCODING_IDENTITY;
+
+    catzilla_accept_encoding_t accept;
+    catzilla_compression_parse_accept_encoding(accept_encoding, &accept);
+    return catzilla_compression_select(&accept, catzilla_compression_available(), body_size,
+                                       config->br_max_size);
+}
+
+// ---------------------------------------------------------------------------
+// Whole bodies
+// ---------------------------------------------------------------------------
+
+// Each returns the compressed size, or 0 if it does not fit in capacity
+#ifdef CATZILLA_HAS_ZLIB
+static size_t gzip_into(int level, const void* data, size_t size, char* out, size_t capacity) {
+    if (size > UINT_MAX || capacity > UINT_MAX) return 0;
+
+    if (!encoders.gzip_ready) {
+        memset(&encoders.gzip, 0, sizeof(encoders.gzip));
+        // 16 + MAX_WBITS writes a gzip header and trailer instead of zlib's
+        if (deflateInit2(&encoders.gzip, level, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            return 0;
+        }
+        encoders.gzip_ready = true;
+        encoders.gzip_level = level;
+    } else if (encoders.gzip_level != level) {
+        deflateParams(&encoders.gzip, level, Z_DEFAULT_STRATEGY);
+        encoders.gzip_level = level;
+    }
+
+    z_stream* stream = &encoders.gzip;
+    stream->next_in = (Bytef*)data;
+    stream->avail_in = (uInt)size;
+    stream->next_out = (Bytef*)out;
+    stream->avail_out = (uInt)capacity;
+    int rc = deflate(stream, Z_FINISH);
+    size_t written = stream->total_out;
+    deflateReset(stream);
+    return rc == Z_STREAM_END ? written : 0;
+}
+#endif
+
+#ifdef CATZILLA_HAS_BROTLI
+static size_t brotli_into(int quality, const void* data, size_t size, char* out, size_t capacity) {
+    size_t written = capacity;
+    if (!BrotliEncoderCompress(quality, BROTLI_DEFAULT_WINDOW, BROTLI_MODE_TEXT, size,
+                               (const uint8_t*)data, &written, (uint8_t*)out)) {
+        return 0;
+    }
+    return written;
+}
+#endif
+
+#ifdef CATZILLA_HAS_ZSTD
+static size_t zstd_into(int level, const void* data, size_t size, char* out, size_t capacity) {
+    if (!encoders.zstd) {
+        encoders.zstd = ZSTD_createCCtx();
+        if (!encoders.zstd) return 0;
+    }
+    size_t written = ZSTD_compressCCtx(encoders.zstd, out, capacity, data, size, level);
+    return ZSTD_isError(written) ? 0 : written;
+}
+#endif
+
+size_t catzilla_compress_into(int encoding, int level, const void* data, size_t size,
+                              void* out, size_t capacity) {
+    if (!data || !out || capacity == 0) return 0;
+
+    switch (encoding) {
+#ifdef CATZILLA_HAS_ZLIB
+        case CATZILLA_ENCODING_GZIP: return gzip_into(level, data, size, out, capacity);
+#endif
+#ifdef CATZILLA_HAS_BROTLI
+        case CATZILLA_ENCODING_BR: return brotli_into(level, data, size, out, capacity);
+#endif
+#ifdef CATZILLA_HAS_ZSTD
+        case CATZILLA_ENCODING_ZSTD: return zstd_into(level, data, size, out, capacity);
+#endif
+        default:
+            (void)level;
+            (void)size;
+            return 0;
+    }
+}
+
+int catzilla_compress(int encoding, int level, const void* data, size_t size,
+                      catzilla_compress_buffer_t** out) {
+    if (!data || !out || size < 2) return -1;
+    *out = NULL;
+    if (!(catzilla_compression_available() & encoding)) return -1;
+
+    // Only a smaller body is worth sending, so the input size bounds the output
+    catzilla_compress_buffer_t* buffer = catzilla_compress_buffer_acquire(size);
+    if (!buffer) return -1;
+
+    uint64_t start = thread_cpu_ns();
+    size_t written = catzilla_compress_into(encoding, level, data, size, buffer->data, size - 1);
+    uint64_t cpu_ns = thread_cpu_ns() - start;
+
+    if (written == 0) {
+        count_compression(encoding, size, 0, cpu_ns, true);
+        catzilla_compress_buffer_release(buffer);
+        return 1;
+    }
+
+    count_compression(encoding, size, written, cpu_ns, false);
+    catzilla_atomic_fetch_add(&encoding_counters[encoding_index(encoding)].responses, 1);
+    buffer->length = written;
+    *out = buffer;
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// Streams
+// ---------------------------------------------------------------------------
+
+struct catzilla_compressor_s {
+    int encoding;
+    bool finished;
+#ifdef CATZILLA_HAS_ZLIB
+    z_stream gzip;
+#endif
+#ifdef CATZILLA_HAS_BROTLI
+    BrotliEncoderState* br;
+#endif
+#ifdef CATZILLA_HAS_ZSTD
+    ZSTD_CCtx* zstd;
+#endif
+};
+
+catzilla_compressor_t* catzilla_compressor_create(int encoding, int level) {
+    if (!(catzilla_compression_available() & encoding) || encoding_index(encoding) < 0) return NULL;
+
+    catzilla_compressor_t* compressor = catzilla_calloc(1, sizeof(*compressor));
+    if (!compressor) return NULL;
+    compressor->encoding = encoding;
+
+    bool ready = false;
+    switch (encoding) {
+#ifdef CATZILLA_HAS_ZLIB
+        case CATZILLA_ENCODING_GZIP:
+            ready = deflateInit2(&compressor->gzip, level, Z_DEFLATED, 16 + MAX_WBITS, 8,
+                                 Z_DEFAULT_STRATEGY) == Z_OK;
+            break;
+#endif
+#ifdef CATZILLA_HAS_BROTLI
+        case CATZILLA_ENCODING_BR:
+            compressor->br = BrotliEncoderCreateInstance(NULL, NULL, NULL);
+            ready = compressor->br &&
+                    BrotliEncoderSetParameter(compressor->br, BROTLI_PARAM_QUALITY, (uint32_t)level) &&
+                    BrotliEncoderSetParameter(compressor->br, BROTLI_PARAM_MODE, BROTLI_MODE_TEXT);
+            break;
+#endif
+#ifdef CATZILLA_HAS_ZSTD
+        case CATZILLA_ENCODING_ZSTD:
+            compressor->zstd = ZSTD_createCCtx();
+            ready = compressor->zstd &&
+                    !ZSTD_isError(ZSTD_CCtx_setParameter(compressor->zstd, ZSTD_c_compressionLevel, level));
+            break;
+#endif
+        default:
+            (void)level;
+            break;
+    }
+    if (!ready) {
+        catzilla_compressor_destroy(compressor);
+        return NULL;
+    }
+
+    catzilla_atomic_fetch_add(&encoding_counters[encoding_index(encoding)].responses, 1);
+    return compressor;
+}
+
+#ifdef CATZILLA_HAS_ZLIB
+static int gzip_stream(z_stream* stream, const void* data, size_t len, bool finish,
+                       catzilla_compress_buffer_t** buffer) {
+    if (len > UINT_MAX) return -1;
+    stream->next_in = (Bytef*)data;
+    stream->avail_in = (uInt)len;
+    int flush = finish ? Z_FINISH : Z_SYNC_FLUSH;
+
+    for (;;) {
+        size_t space = (*buffer)->capacity - (*buffer)->length;
+        if (space > UINT_MAX) space = UINT_MAX;
+        stream->next_out = (Bytef*)(*buffer)->data + (*buffer)->length;
+        stream->avail_out = (uInt)space;
+        int rc = deflate(stream, flush);
+        (*buffer)->length += space - stream->avail_out;
+
+        if (rc == Z_STREAM_ERROR) return -1;
+        if (finish ? rc == Z_STREAM_END : stream->avail_out > 0) return 0;
+        if (stream->avail_out == 0 && !(*buffer = grow_buffer(*buffer))) return -1;
+    }
+}
+#endif
+
+#ifdef CATZILLA_HAS_BROTLI
+static int brotli_stream(BrotliEncoderState* state, const void* data, size_t len, bool finish,
+                         catzilla_compress_buffer_t** buffer) {
+    const uint8_t* next_in = data;
+    size_t avail_in = len;
+    BrotliEncoderOperation op = finish ? BROTLI_OPERATION_FINISH : BROTLI_OPERATION_FLUSH;
+
+    for (;;) {
+        size_t space = (*buffer)->capacity - (*buffer)->length;
+        uint8_t* next_out = (uint8_t*)(*buffer)->data + (*buffer)->length;
+        size_t avail_out = space;
+        if (!BrotliEncoderCompressStream(state, op, &avail_in, &next_in, &avail_out, &next_out, NULL)) {
+            return -1;
+        }
+        (*buffer)->length += space - avail_out;
+
+        if (avail_in == 0 && !BrotliEncoderHasMoreOutput(state) &&
+            (!finish || BrotliEncoderIsFinished(state))) {
+            return 0;
+        }
+        if (avail_out == 0 && !(*buffer = grow_buffer(*buffer))) return -1;
+    }
+}
+#endif
+
+#ifdef CATZILLA_HAS_ZSTD
+static int zstd_stream(ZSTD_CCtx* cctx, const void* data, size_t len, bool finish,
+                       catzilla_compress_buffer_t** buffer) {
+    ZSTD_inBuffer in = { data, len, 0 };
+    ZSTD_EndDirective mode = finish ? ZSTD_e_end : ZSTD_e_flush;
+
+    for (;;) {
+        ZSTD_outBuffer out = { (*buffer)->data, (*buffer)->capacity, (*buffer)->length };
+        size_t remaining = ZSTD_compressStream2(cctx, &out, &in, mode);
+        if (ZSTD_isError(remaining)) return -1;
+        (*buffer)->length = out.pos;
+
+        if (remaining == 0 && in.pos == in.size) return 0;
+        if (out.pos == out.size && !(*buffer = grow_buffer(*buffer))) return -1;
+    }
+}
+#endif
+
+int catzilla_compressor_write(catzilla_compressor_t* compressor, const void* data, size_t len,
+                              bool finish, catzilla_compress_buffer_t** out) {
+    if (!compressor || !out || (!data && len > 0)) return -1;
+    *out = NULL;
+    if (compressor->finished) return -1;
+
+    // A flush adds a few bytes on top of what the chunk compresses to
+    catzilla_compress_buffer_t* buffer = catzilla_compress_buffer_acquire(len / 2 + 64);
+    if (!buffer) return -1;
+
+    uint64_t start = thread_cpu_ns();
+    int rc = -1;
+    switch (compressor->encoding) {
+#ifdef CATZILLA_HAS_ZLIB
+        case CATZILLA_ENCODING_GZIP: rc = gzip_stream(&compressor->gzip, data, len, finish, &buffer); break;
+#endif
+#ifdef CATZILLA_HAS_BROTLI
+        case CATZILLA_ENCODING_BR: rc = brotli_stream(compressor->br, data, len, finish, &buffer); break;
+#endif
+#ifdef CATZILLA_HAS_ZSTD
+        case CATZILLA_ENCODING_ZSTD: rc = zstd_stream(compressor->zstd, data, len, finish, &buffer); break;
+#endif
+        default: break;
+    }
+    uint64_t cpu_ns = thread_cpu_ns() - start;
+
+    if (rc != 0) {
+        // NULL when growing it failed, which released it
+        catzilla_compress_buffer_release(buffer);
+        return -1;
+    }
+    if (finish) compressor->finished = true;
+
+    count_compression(compressor->encoding, len, buffer->length, cpu_ns, false);
+    if (buffer->length == 0) {
+        catzilla_compress_buffer_release(buffer);
+        return 0;
+    }
+    *out = buffer;
+    return 0;
+}
+
+void catzilla_compressor_destroy(catzilla_compressor_t* compressor) {
+    if (!compressor) return;
+
+    switch (compressor->encoding) {
+#ifdef CATZILLA_HAS_ZLIB
+        case CATZILLA_ENCODING_GZIP: deflateEnd(&compressor->gzip); break;
+#endif
+#ifdef CATZILLA_HAS_BROTLI
+        case CATZILLA_ENCODING_BR: if (compressor->br) BrotliEncoderDestroyInstance(compressor->br); break;
+#endif
+#ifdef CATZILLA_HAS_ZSTD
+        case CATZILLA_ENCODING_ZSTD: ZSTD_freeCCtx(compressor->zstd); break;
+#endif
+        default: break;
+    }
+    catzilla_free(compressor);
+}
+
+void catzilla_compression_get_stats(catzilla_compression_stats_t* stats) {
+    if (!stats) return;
+    memset(stats, 0, sizeof(*stats));
+
+    catzilla_compress_encoding_stats_t* targets[CATZILLA_ENCODING_COUNT] = { &stats->gzip, &stats->br, &stats->zstd };
+    for (int i = 0; i < CATZILLA_ENCODING_COUNT; i++) {
+        targets[i]->responses = catzilla_atomic_load(&encoding_counters[i].responses);
+        targets[i]->skipped = catzilla_atomic_load(&encoding_counters[i].skipped);
+        targets[i]->bytes_in = catzilla_atomic_load(&encoding_counters[i].bytes_in);
+        targets[i]->bytes_out = catzilla_atomic_load(&encoding_counters[i].bytes_out);
+        targets[i]->cpu_ns = catzilla_atomic_load(&encoding_counters[i].cpu_ns);
+    }
+    stats->buffer_hits = catzilla_atomic_load(&stat_buffer_hits);
+    stats->buffer_misses = catzilla_atomic_load(&stat_buffer_misses);
+}
@@ -0,0 +1,238 @@
+/*
+ * Catzilla Response Compression - gzip, Brotli and zstd for dynamic responses
+ *
+ * The send path negotiates a content coding from Accept-Encoding (quality
+ * values first, then the server's preference for the body size), compresses
+ * the body into a pooled output buffer and sends it only when it came out
+ * smaller. Streamed responses keep one compressor per stream and flush it
+ * after every chunk, so each chunk can be decoded as soon as it arrives.
+ *
+ * Each coding is compiled in when its library is found at build time
+ * (CATZILLA_HAS_ZLIB, CATZILLA_HAS_BROTLI, CATZILLA_HAS_ZSTD); the others are
+ * never negotiated.
+ */
+
+#ifndef CATZILLA_COMPRESSION_H
+#define CATZILLA_COMPRESSION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Content codings; gzip and br match STATIC_ENCODING_* of the static server
+#define CATZILLA_ENCODING_IDENTITY 0
+#define CATZILLA_ENCODING_GZIP 0x1
+#define CATZILLA_ENCODING_BR 0x2
+#define CATZILLA_ENCODING_ZSTD 0x4
+#define CATZILLA_ENCODING_COUNT 3
+
+// Defaults tuned for per-request compression rather than for best ratio
+#define CATZILLA_COMPRESSION_DEFAULT_MIN_SIZE 1024          // Smaller bodies gain too little
+#define CATZILLA_COMPRESSION_DEFAULT_BR_MAX_SIZE (256 * 1024) // Larger bodies prefer zstd/gzip
+#define CATZILLA_COMPRESSION_DEFAULT_GZIP_LEVEL 6
+#define CATZILLA_COMPRESSION_DEFAULT_BR_QUALITY 4
+#define CATZILLA_COMPRESSION_DEFAULT_ZSTD_LEVEL 3
+
+// Pooled output buffers come in CATZILLA_COMPRESS_BUFFER_CLASSES sizes from
+// CATZILLA_COMPRESS_BUFFER_MIN up, each size class four times the previous;
+// every thread keeps up to CATZILLA_COMPRESS_POOL_MAX_RETAINED of each
+#define CATZILLA_COMPRESS_BUFFER_MIN (4 * 1024)
+#define CATZILLA_COMPRESS_BUFFER_CLASSES 5                   // 4 KB .. 1 MB
+#define CATZILLA_COMPRESS_POOL_MAX_RETAINED 8
+
+typedef struct catzilla_compression_config_s {
+    bool enabled;
+    size_t min_size;        // Bodies below this are sent as they are
+    size_t br_max_size;     // Above this, zstd and gzip are preferred over br
+    int gzip_level;         // 1-9
+    int br_quality;         // 0-11
+    int zstd_level;         // 1-22
+} catzilla_compression_config_t;
+
+// Output buffer; data holds length bytes of capacity
+typedef struct catzilla_compress_buffer_s {
+    size_t capacity;
+    size_t length;
+    int size_class;         // -1 when the buffer is too large to pool
+    char data[];
+} catzilla_compress_buffer_t;
+
+typedef struct catzilla_compress_encoding_stats_s {
+    uint64_t responses;     // Bodies sent compressed (streams count once)
+    uint64_t skipped;       // Bodies sent as they were because they did not shrink
+    uint64_t bytes_in;
+    uint64_t bytes_out;
+    uint64_t cpu_ns;        // Thread CPU time spent compressing
+} catzilla_compress_encoding_stats_t;
+
+typedef struct catzilla_compression_stats_s {
+    catzilla_compress_encoding_stats_t gzip;
+    catzilla_compress_encoding_stats_t br;
+    catzilla_compress_encoding_stats_t zstd;
+    uint64_t buffer_hits;   // Output buffers served from a pool
+    uint64_t buffer_misses;
+} catzilla_compression_stats_t;
+
+// Quality values of one Accept-Encoding header in thousandths (RFC 9110
+// qvalues); -1 for codings it does not list
+typedef struct catzilla_accept_encoding_s {
+    int quality[CATZILLA_ENCODING_COUNT];   // gzip, br, zstd
+    int wildcard;                           // "*"
+} catzilla_accept_encoding_t;
+
+typedef struct catzilla_compressor_s catzilla_compressor_t;
+
+/**
+ * Fill a configuration with the defaults (compression enabled)
+ * @param config Configuration to fill
+ */
+void catzilla_compression_config_init(catzilla_compression_config_t* config);
+
+/**
+ * Get the codings this build can produce
+ * @return Mask of CATZILLA_ENCODING_*
+ */
+int catzilla_compression_available(void);
+
+/**
+ * Get the HTTP name of a coding
+ * @param encoding CATZILLA_ENCODING_*
+ * @return "gzip", "br", "zstd" or "identity"
+ */
+const char* catzilla_compression_encoding_name(int encoding);
+
+/**
+ * Get the configured level of a coding
+ * @param config Configuration
+ * @param encoding CATZILLA_ENCODING_*
+ * @return Level or quality
+ */
+int catzilla_compression_level(const catzilla_compression_config_t* config, int encoding);
+
+/**
+ * Check whether a media type is worth compressing (text, JSON, JavaScript,
+ * XML, SVG and similar); already compressed media is not
+ * @param content_type Content-Type value, parameters allowed (may be NULL)
+ * @param length Length of content_type
+ * @return true if compressible
+ */
+bool catzilla_compression_type_compressible(const char* content_type, size_t length);
+
+/**
+ * Parse an Accept-Encoding header; x-gzip counts as gzip
+ * @param accept_encoding Header value (may be NULL, which lists nothing)
+ * @param accept Receives the quality values
+ */
+void catzilla_compression_parse_accept_encoding(const char* accept_encoding,
+                                                catzilla_accept_encoding_t* accept);
+
+/**
+ * Pick one of the candidate codings. The highest quality value wins, a coding
+ * not listed takes the wildcard's and q=0 rules it out; between equal ones br
+ * is preferred up to br_max_size and zstd, then gzip above it. Both the
+ * dynamic responses and the static files are negotiated with this.
+ * @param accept Parsed Accept-Encoding
+ * @param candidates Mask of CATZILLA_ENCODING_* the response can be sent in
+ * @param body_size Body size, SIZE_MAX when not known (streams)
+ * @param br_max_size Largest body br is preferred for
+ * @return CATZILLA_ENCODING_*, CATZILLA_ENCODING_IDENTITY when none is acceptable
+ */
+int catzilla_compression_select(const catzilla_accept_encoding_t* accept, int candidates,
+                                size_t body_size, size_t br_max_size);
+
+/**
+ * Pick the coding for a response from the codings this build can produce
+ * (catzilla_compression_select with the configured sizes)
+ * @param config Configuration
+ * @param accept_encoding Accept-Encoding value (may be NULL)
+ * @param body_size Body size, SIZE_MAX when not known (streams)
+ * @return CATZILLA_ENCODING_*, CATZILLA_ENCODING_IDENTITY when nothing applies
+ */
+int catzilla_compression_negotiate(const catzilla_compression_config_t* config,
+                                   const char* accept_encoding, size_t body_size);
+
+/**
+ * Take an output buffer from the calling thread's pool
+ * @param min_capacity Bytes needed
+ * @return Buffer with length 0, or NULL on allocation failure
+ */
+catzilla_compress_buffer_t* catzilla_compress_buffer_acquire(size_t min_capacity);
+
+/**
+ * Return an output buffer to the calling thread's pool
+ * @param buffer Buffer (NULL is ignored)
+ */
+void catzilla_compress_buffer_release(catzilla_compress_buffer_t* buffer);
+
+/**
+ * Compress a whole body. The output must come out smaller than the input.
+ * @param encoding CATZILLA_ENCODING_GZIP, _BR or _ZSTD
+ * @param level Level or quality
+ * @param data Body
+ * @param size Body size
+ * @param out Receives the compressed body
+ * @return 0 on success, 1 if the output would not be smaller, -1 on error
+ */
+int catzilla_compress(int encoding, int level, const void* data, size_t size,
+                      catzilla_compress_buffer_t** out);
+
+/**
+ * Compress a whole body into a caller's buffer, without counting it in the
+ * statistics; for bodies kept rather than sent, such as cached static files
+ * @param encoding CATZILLA_ENCODING_GZIP, _BR or _ZSTD
+ * @param level Level or quality
+ * @param data Body
+ * @param size Body size
+ * @param out Output buffer
+ * @param capacity Size of out; a larger output is not produced
+ * @return Compressed size, or 0 if it did not fit or the coding is not available
+ */
+size_t catzilla_compress_into(int encoding, int level, const void* data, size_t size,
+                              void* out, size_t capacity);
+
+/**
+ * Create a streaming compressor
+ * @param encoding CATZILLA_ENCODING_GZIP, _BR or _ZSTD
+ * @param level Level or quality
+ * @return Compressor, or NULL if the coding is not available
+ */
+catzilla_compressor_t* catzilla_compressor_create(int encoding, int level);
+
+/**
+ * Compress one chunk of a stream and flush it, or end the stream
+ * @param compressor Compressor
+ * @param data Chunk (may be NULL when len is 0)
+ * @param len Chunk length
+ * @param finish Whether this is the end of the stream
+ * @param out Receives the compressed bytes; NULL when there are none
+ * @return 0 on success, -1 on error
+ */
+int catzilla_compressor_write(catzilla_compressor_t* compressor, const void* data, size_t len,
+                              bool finish, catzilla_compress_buffer_t** out);
+
+/**
+ * Free a streaming compressor
+ * @param compressor Compressor (may be NULL)
+ */
+void catzilla_compressor_destroy(catzilla_compressor_t* compressor);
+
+/**
+ * Free the calling thread's pooled buffers and reusable encoders
+ */
+void catzilla_compression_trim(void);
+
+/**
+ * Get compression statistics, aggregated over all threads
+ * @param stats Receives the statistics
+ */
+void catzilla_compression_get_stats(catzilla_compression_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CATZILLA_COMPRESSION_H
@@ -2,6 +2,7 @@
 #include "platform_compat.h"
 #include "memory.h"
 #include "logging.h"
+#include "platform_atomic.h"
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
@@ -37,6 +38,14 @@ static uint64_t catzilla_di_get_timestamp(void) {
     return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
 }
 
+/**
+ * Grow an array; rallocx() does not take NULL, so first allocations go
+ * through alloc
+ */
+static void* catzilla_di_grow(void* ptr, size_t size) {
+    return ptr ? catzilla_cache_realloc(ptr, size) : catzilla_cache_alloc(size);
+}
+
 /**
  * Generate unique ID (simple counter-based approach)
  */
@@ -301,6 +310,235 @@ static void catzilla_di_pop_resolution_stack(catzilla_di_context_t* context) {
     }
 }
 
+// ============================================================================
+// REQUEST-SCOPED INSTANCE POOL
+// ============================================================================
+
+typedef struct catzilla_di_owned_instance_s {
+    catzilla_di_service_t* service;
+    void* instance;
+} catzilla_di_owned_instance_t;
+
+// One service's free instances on one thread. Entries are keyed by pool_key
+// rather than the service, and carry what it takes to destroy what they
+// hold, so they stay safe to trim after the service is gone
+typedef struct {
+    uint64_t key;                            // 0 = unused entry
+    catzilla_di_destroy_func_t destroy_func;
+    void* user_data;
+    int count;
+    void* instances[CATZILLA_DI_POOL_MAX_INSTANCES];
+} catzilla_di_pool_entry_t;
+
+typedef struct {
+    catzilla_di_pool_entry_t entries[CATZILLA_DI_POOL_MAX_SERVICES];
+} catzilla_di_instance_pool_t;
+
+// Allocated on first use, so a thread that never pools pays nothing
+static CATZILLA_THREAD_LOCAL catzilla_di_instance_pool_t* instance_pool;
+
+static catzilla_atomic_uint64_t pool_stat_created = 0;
+static catzilla_atomic_uint64_t pool_stat_reused = 0;
+static catzilla_atomic_uint64_t pool_stat_returned = 0;
+static catzilla_atomic_uint64_t pool_stat_destroyed = 0;
+static catzilla_atomic_uint64_t pool_stat_outstanding = 0;
+static catzilla_atomic_uint64_t pool_stat_leaked = 0;
+
+static bool catzilla_di_has_lifecycle(const catzilla_di_service_t* service) {
+    return (service->scope == CATZILLA_DI_SCOPE_SCOPED || service->scope == CATZILLA_DI_SCOPE_REQUEST) &&
+           service->factory && (service->factory->reset_func || service->factory->destroy_func);
+}
+
+/**
+ * Find the calling thread's entry for a pool key
+ * @param create Claim an unused entry (allocating the pool) if there is none
+ */
+static catzilla_di_pool_entry_t* catzilla_di_pool_entry(uint64_t key, bool create) {
+    if (!instance_pool) {
+        if (!create) return NULL;
+        instance_pool = catzilla_cache_alloc(sizeof(catzilla_di_instance_pool_t));
+        if (!instance_pool) return NULL;
+        memset(instance_pool, 0, sizeof(catzilla_di_instance_pool_t));
+    }
+
+    catzilla_di_pool_entry_t* unused = NULL;
+    for (int i = 0; i < CATZILLA_DI_POOL_MAX_SERVICES; i++) {
+        catzilla_di_pool_entry_t* entry = &instance_pool->entries[i];
+        if (entry->key == key) return entry;
+        if (entry->key == 0 && !unused) unused = entry;
+    }
+    if (!create || !unused) return NULL;
+    unused->key = key;
+    unused->count = 0;
+    return unused;
+}
+
+static void* catzilla_di_pool_take(const catzilla_di_factory_t* factory) {
+    catzilla_di_pool_entry_t* entry = catzilla_di_pool_entry(factory->pool_key, false);
+    if (!entry || entry->count == 0) return NULL;
+    return entry->instances[--entry->count];
+}
+
+static bool catzilla_di_pool_put(const catzilla_di_factory_t* factory, void* instance) {
+    catzilla_di_pool_entry_t* entry = catzilla_di_pool_entry(factory->pool_key, true);
+    if (!entry || entry->count >= factory->pool_max) return false;
+    entry->destroy_func = factory->destroy_func;
+    entry->user_data = factory->user_data;
+    entry->instances[entry->count++] = instance;
+    return true;
+}
+
+static void catzilla_di_pool_clear_entry(catzilla_di_pool_entry_t* entry) {
+    for (int i = 0; i < entry->count; i++) {
+        if (entry->destroy_func) entry->destroy_func(entry->instances[i], entry->user_data);
+    }
+    catzilla_atomic_fetch_add(&pool_stat_destroyed, (uint64_t)entry->count);
+    entry->count = 0;
+    entry->key = 0;
+}
+
+/**
+ * Destroy the calling thread's pooled instances of one service; other
+ * threads drop theirs at their next trim
+ */
+static void catzilla_di_pool_purge(const catzilla_di_factory_t* factory) {
+    if (!factory || !factory->reset_func) return;
+    catzilla_di_pool_entry_t* entry = catzilla_di_pool_entry(factory->pool_key, false);
+    if (entry) catzilla_di_pool_clear_entry(entry);
+}
+
+/**
+ * Record an instance the context must reset or destroy at cleanup
+ */
+static void catzilla_di_context_track(catzilla_di_context_t* context,
+                                      catzilla_di_service_t* service,
+                                      void* instance) {
+    if (context->owned_count == context->owned_capacity) {
+        int capacity = context->owned_capacity ? context->owned_capacity * 2 : 4;
+        catzilla_di_owned_instance_t* owned = catzilla_di_grow(context->owned,
+                                                               capacity * sizeof(catzilla_di_owned_instance_t));
+        if (!owned) {
+            // Left to the caller, as instances without lifecycle hooks are
+            LOG_WARN("DI", "Could not track an instance of '%s'", service->name);
+            return;
+        }
+        context->owned = owned;
+        context->owned_capacity = capacity;
+    }
+    context->owned[context->owned_count].service = service;
+    context->owned[context->owned_count].instance = instance;
+    context->owned_count++;
+    catzilla_atomic_fetch_add(&service->factory->outstanding, 1);
+    catzilla_atomic_fetch_add(&pool_stat_outstanding, 1);
+}
+
+/**
+ * Reset the context's instances into the pool, or destroy them; the last
+ * resolved go first, since they may use the earlier ones
+ */
+static void catzilla_di_context_release(catzilla_di_context_t* context) {
+    for (int i = context->owned_count - 1; i >= 0; i--) {
+        catzilla_di_factory_t* factory = context->owned[i].service->factory;
+        void* instance = context->owned[i].instance;
+        catzilla_atomic_fetch_sub(&factory->outstanding, 1);
+        catzilla_atomic_fetch_sub(&pool_stat_outstanding, 1);
+
+        if (factory->reset_func && factory->reset_func(instance, factory->user_data) == 0 &&
+            catzilla_di_pool_put(factory, instance)) {
+            catzilla_atomic_fetch_add(&pool_stat_returned, 1);
+            continue;
+        }
+        if (factory->destroy_func) factory->destroy_func(instance, factory->user_data);
+        catzilla_atomic_fetch_add(&pool_stat_destroyed, 1);
+    }
+
+    catzilla_cache_free(context->owned);
+    context->owned = NULL;
+    context->owned_count = 0;
+    context->owned_capacity = 0;
+}
+
+int catzilla_di_set_service_lifecycle(catzilla_di_container_t* container,
+                                      const char* name,
+                                      catzilla_di_reset_func_t reset_func,
+                                      catzilla_di_destroy_func_t destroy_func,
+                                      int pool_max) {
+    if (!container || !name || pool_max < 0 || pool_max > CATZILLA_DI_POOL_MAX_INSTANCES) return -1;
+
+    // Only the container's own registrations; a parent's belong to the parent
+    catzilla_di_service_t* service = NULL;
+    for (int i = 0; i < container->service_count; i++) {
+        if (container->services[i] && strcmp(container->services[i]->name, name) == 0) {
+            service = container->services[i];
+            break;
+        }
+    }
+    if (!service || !service->factory) return -1;
+    if (service->scope != CATZILLA_DI_SCOPE_SCOPED && service->scope != CATZILLA_DI_SCOPE_REQUEST) {
+        LOG_ERROR("DI", "Only request-scoped services have lifecycle hooks, not '%s'", name);
+        return -1;
+    }
+
+    // A pooled instance keeps the dependencies it was made with
+    if (reset_func) {
+        for (int i = 0; i < service->dependency_count; i++) {
+            catzilla_di_service_t* dependency = catzilla_di_find_service(container, service->dependencies[i]);
+            if (!dependency || dependency->scope != CATZILLA_DI_SCOPE_SINGLETON) {
+                LOG_ERROR("DI", "Pooled service '%s' depends on '%s', which is not a singleton",
+                          name, service->dependencies[i]);
+                return -1;
+            }
+        }
+    }
+
+    catzilla_di_pool_purge(service->factory);
+    service->factory->reset_func = reset_func;
+    service->factory->destroy_func = destroy_func;
+    service->factory->pool_max = pool_max ? pool_max : CATZILLA_DI_POOL_DEFAULT_INSTANCES;
+    service->factory->pool_key = ((uint64_t)container->container_id << 32) | service->registration_id;
+    return 0;
+}
+
+void catzilla_di_instance_pool_trim(void) {
+    if (!instance_pool) return;
+
+    for (int i = 0; i < CATZILLA_DI_POOL_MAX_SERVICES; i++) {
+        if (instance_pool->entries[i].key != 0) {
+            catzilla_di_pool_clear_entry(&instance_pool->entries[i]);
+        }
+    }
+    catzilla_cache_free(instance_pool);
+    instance_pool = NULL;
+}
+
+void catzilla_di_get_instance_pool_stats(catzilla_di_instance_pool_stats_t* stats) {
+    if (!stats) return;
+
+    stats->created = catzilla_atomic_load(&pool_stat_created);
+    stats->reused = catzilla_atomic_load(&pool_stat_reused);
+    stats->returned = catzilla_atomic_load(&pool_stat_returned);
+    stats->destroyed = catzilla_atomic_load(&pool_stat_destroyed);
+    stats->outstanding = catzilla_atomic_load(&pool_stat_outstanding);
+    stats->leaked = catzilla_atomic_load(&pool_stat_leaked);
+}
+
+uint64_t catzilla_di_check_instance_leaks(catzilla_di_container_t* container) {
+    if (!container) return 0;
+
+    uint64_t total = 0;
+    for (int i = 0; i < container->service_count; i++) {
+        catzilla_di_service_t* service = container->services[i];
+        if (!service || !service->factory) continue;
+        uint64_t outstanding = catzilla_atomic_load(&service->factory->outstanding);
+        if (outstanding > 0) {
+            LOG_WARN("DI", "%" PRIu64 " instance(s) of '%s' were never returned; was a context not cleaned up?",
+                     outstanding, service->name);
+            total += outstanding;
+        }
+    }
+    return total;
+}
+
 // ============================================================================
 // CORE CONTAINER MANAGEMENT API IMPLEMENTATION
 // ============================================================================
@@ -354,10 +592,16 @@ int catzilla_di_container_init(catzilla_di_container_t* container,
 void catzilla_di_container_cleanup(catzilla_di_container_t* container) {
     if (!container || !container->is_initialized) return;
 
+    uint64_t leaked = catzilla_di_check_instance_leaks(container);
+    if (leaked > 0) {
+        catzilla_atomic_fetch_add(&pool_stat_leaked, leaked);
+    }
+
     // Cleanup all services
     for (int i = 0; i < container->service_count; i++) {
         if (container->services[i]) {
             if (container->services[i]->factory) {
+                catzilla_di_pool_purge(container->services[i]->factory);
                 catzilla_cache_free(container->services[i]->factory);
             }
             catzilla_cache_free(container->services[i]);
@@ -463,6 +707,7 @@ int catzilla_di_register_service(catzilla_di_container_t* container,
     // Add to container
     container->services[container->service_count] = service;
     container->service_count++;
+    container->generation++;
 
     return 0;
 }
@@ -480,6 +725,7 @@ int catzilla_di_register_service_c(catzilla_di_container_t* container,
     // Create factory structure
     catzilla_di_factory_t* factory = catzilla_cache_alloc(sizeof(catzilla_di_factory_t));
     if (!factory) return -1;
+    memset(factory, 0, sizeof(catzilla_di_factory_t));
 
     factory->create_func = factory_func;
     factory->python_factory = NULL;
@@ -507,6 +753,7 @@ int catzilla_di_register_service_python(catzilla_di_container_t* container,
     // Create factory structure
     catzilla_di_factory_t* factory = catzilla_cache_alloc(sizeof(catzilla_di_factory_t));
     if (!factory) return -1;
+    memset(factory, 0, sizeof(catzilla_di_factory_t));
 
     factory->create_func = NULL;
     factory->python_factory = python_factory;
@@ -532,6 +779,7 @@ int catzilla_di_unregister_service(catzilla_di_container_t* container, const cha
             // Free service resources
             catzilla_di_service_t* service = container->services[i];
             if (service->factory) {
+                catzilla_di_pool_purge(service->factory);
                 catzilla_cache_free(service->factory);
             }
             catzilla_cache_free(service);
@@ -541,6 +789,7 @@ int catzilla_di_unregister_service(catzilla_di_container_t* container, const cha
                 container->services[j] = container->services[j + 1];
             }
             container->service_count--;
+            container->generation++;
 
             return 0;
         }
@@ -576,6 +825,7 @@ static void* catzilla_di_resolve_service_internal(catzilla_di_container_t* conta
     if (!context && create_context_if_null) {
         context = catzilla_di_create_context(container);
         if (!context) return NULL;
+        context->is_temporary = true;
         should_cleanup_context = true;
     }
 
@@ -606,6 +856,18 @@ static void* catzilla_di_resolve_service_internal(catzilla_di_container_t* conta
         goto cleanup;
     }
 
+    // Instances a context gives back at cleanup: borrow a pooled one first
+    bool tracked = context && !context->is_temporary && catzilla_di_has_lifecycle(service);
+    if (tracked && service->factory->reset_func) {
+        result = catzilla_di_pool_take(service->factory);
+        if (result) {
+            catzilla_atomic_fetch_add(&pool_stat_reused, 1);
+            catzilla_di_context_track(context, service, result);
+            catzilla_di_cache_set(context->resolution_cache, name, result);
+            goto cleanup;
+        }
+    }
+
     // Push onto resolution stack
     if (context) {
         if (catzilla_di_push_resolution_stack(context, name) != 0) {
@@ -643,6 +905,11 @@ static void* catzilla_di_resolve_service_internal(catzilla_di_container_t* conta
 
     if (!result) goto cleanup;
 
+    if (tracked) {
+        catzilla_atomic_fetch_add(&pool_stat_created, 1);
+        catzilla_di_context_track(context, service, result);
+    }
+
     // Cache based on scope
     if (service->scope == CATZILLA_DI_SCOPE_SINGLETON) {
         service->cached_instance = result;
@@ -673,6 +940,7 @@ int catzilla_di_resolve_services(catzilla_di_container_t* container,
     if (!context) {
         context = catzilla_di_create_context(container);
         if (!context) return 0;
+        context->is_temporary = true;
         should_cleanup_context = true;
     }
 
@@ -692,6 +960,207 @@ int catzilla_di_resolve_services(catzilla_di_container_t* container,
     return resolved_count;
 }
 
+// ============================================================================
+// RESOLUTION PLANS
+// ============================================================================
+
+/**
+ * Sum of the generations up the parent chain; each only ever grows, so any
+ * registration change in the chain changes the sum
+ */
+static uint32_t catzilla_di_chain_generation(const catzilla_di_container_t* container) {
+    uint32_t generation = 0;
+    for (; container; container = container->parent) {
+        generation += container->generation;
+    }
+    return generation;
+}
+
+typedef struct {
+    catzilla_di_plan_t* plan;
+    catzilla_di_service_t** slot_services;   // Service of each slot
+    bool* on_path;                           // Slot is being compiled (cycle check)
+    int slot_capacity;
+    int step_capacity;
+} catzilla_di_plan_builder_t;
+
+static int catzilla_di_plan_reserve_slot(catzilla_di_plan_builder_t* builder) {
+    catzilla_di_plan_t* plan = builder->plan;
+    if (plan->slot_count < builder->slot_capacity) return 0;
+    if (builder->slot_capacity >= CATZILLA_DI_MAX_SERVICES) return -1;
+
+    int capacity = builder->slot_capacity ? builder->slot_capacity * 2 : 16;
+    if (capacity > CATZILLA_DI_MAX_SERVICES) capacity = CATZILLA_DI_MAX_SERVICES;
+
+    void** singletons = catzilla_di_grow(plan->singletons, capacity * sizeof(void*));
+    if (!singletons) return -1;
+    plan->singletons = singletons;
+    catzilla_di_service_t** services = catzilla_di_grow(builder->slot_services,
+                                                              capacity * sizeof(catzilla_di_service_t*));
+    if (!services) return -1;
+    builder->slot_services = services;
+    bool* on_path = catzilla_di_grow(builder->on_path, capacity * sizeof(bool));
+    if (!on_path) return -1;
+    builder->on_path = on_path;
+
+    builder->slot_capacity = capacity;
+    return 0;
+}
+
+static catzilla_di_plan_step_t* catzilla_di_plan_append_step(catzilla_di_plan_builder_t* builder) {
+    catzilla_di_plan_t* plan = builder->plan;
+    if (plan->step_count == builder->step_capacity) {
+        int capacity = builder->step_capacity ? builder->step_capacity * 2 : 8;
+        catzilla_di_plan_step_t* steps = catzilla_di_grow(plan->steps,
+                                                                capacity * sizeof(catzilla_di_plan_step_t));
+        if (!steps) return NULL;
+        plan->steps = steps;
+        builder->step_capacity = capacity;
+    }
+    return &plan->steps[plan->step_count++];
+}
+
+/**
+ * Give a service a slot, compiling its dependencies first (post-order, so
+ * steps end up topologically sorted)
+ * @return Slot, or -1 on failure
+ */
+static int catzilla_di_plan_visit(catzilla_di_plan_builder_t* builder, const char* name) {
+    catzilla_di_plan_t* plan = builder->plan;
+    catzilla_di_service_t* service = catzilla_di_find_service(plan->container, name);
+    if (!service) {
+        LOG_ERROR("DI", "Plan dependency '%s' is not registered", name);
+        return -1;
+    }
+
+    // Plans hold a handful of services, so a scan beats hashing here
+    for (int i = 0; i < plan->slot_count; i++) {
+        if (builder->slot_services[i] == service) {
+            if (builder->on_path[i]) {
+                LOG_ERROR("DI", "Circular dependency through '%s'", name);
+                return -1;
+            }
+            return i;
+        }
+    }
+
+    if (catzilla_di_plan_reserve_slot(builder) != 0) return -1;
+    int slot = plan->slot_count++;
+    builder->slot_services[slot] = service;
+    builder->on_path[slot] = false;
+    plan->singletons[slot] = NULL;
+
+    if (service->scope == CATZILLA_DI_SCOPE_SINGLETON) {
+        plan->singletons[slot] = catzilla_di_resolve_service(plan->container, service->name, NULL);
+        if (!plan->singletons[slot]) {
+            LOG_ERROR("DI", "Singleton '%s' could not be resolved for a plan", name);
+            return -1;
+        }
+        return slot;
+    }
+
+    if (!service->factory || service->factory->is_python_factory || !service->factory->create_func) {
+        LOG_ERROR("DI", "Service '%s' has no C factory to plan", name);
+        return -1;
+    }
+
+    builder->on_path[slot] = true;
+    int dependency_slots[CATZILLA_DI_MAX_DEPENDENCIES];
+    for (int i = 0; i < service->dependency_count; i++) {
+        dependency_slots[i] = catzilla_di_plan_visit(builder, service->dependencies[i]);
+        if (dependency_slots[i] < 0) return -1;
+    }
+    // Through the builder: the arrays may have moved while compiling those
+    builder->on_path[slot] = false;
+
+    catzilla_di_plan_step_t* step = catzilla_di_plan_append_step(builder);
+    if (!step) return -1;
+    step->service = service;
+    step->slot = slot;
+    step->dependency_count = service->dependency_count;
+    memcpy(step->dependency_slots, dependency_slots, service->dependency_count * sizeof(int));
+    return slot;
+}
+
+catzilla_di_plan_t* catzilla_di_plan_compile(catzilla_di_container_t* container,
+                                             const char** names,
+                                             int count) {
+    if (!container || !names || count <= 0) return NULL;
+
+    catzilla_di_plan_t* plan = catzilla_cache_alloc(sizeof(catzilla_di_plan_t));
+    if (!plan) return NULL;
+    memset(plan, 0, sizeof(catzilla_di_plan_t));
+    plan->container = container;
+
+    plan->root_slots = catzilla_cache_alloc(count * sizeof(int));
+    if (!plan->root_slots) {
+        catzilla_cache_free(plan);
+        return NULL;
+    }
+    plan->root_count = count;
+
+    catzilla_di_plan_builder_t builder;
+    memset(&builder, 0, sizeof(builder));
+    builder.plan = plan;
+
+    int result = 0;
+    for (int i = 0; i < count && result == 0; i++) {
+        plan->root_slots[i] = names[i] ? catzilla_di_plan_visit(&builder, names[i]) : -1;
+        if (plan->root_slots[i] < 0) result = -1;
+    }
+
+    catzilla_cache_free(builder.slot_services);
+    catzilla_cache_free(builder.on_path);
+    if (result != 0) {
+        catzilla_di_plan_destroy(plan);
+        return NULL;
+    }
+
+    // Taken last: resolving singletons above must not make the plan stale
+    plan->generation = catzilla_di_chain_generation(container);
+    return plan;
+}
+
+bool catzilla_di_plan_is_current(const catzilla_di_plan_t* plan) {
+    return plan && plan->generation == catzilla_di_chain_generation(plan->container);
+}
+
+int catzilla_di_plan_execute(const catzilla_di_plan_t* plan,
+                             catzilla_request_arena_t* arena,
+                             void** results) {
+    if (!plan || !arena || !results) return -1;
+    if (!catzilla_di_plan_is_current(plan)) return -1;
+
+    void** instances = catzilla_arena_alloc(arena, plan->slot_count * sizeof(void*));
+    if (!instances) return -1;
+    memcpy(instances, plan->singletons, plan->slot_count * sizeof(void*));
+
+    void* dependencies[CATZILLA_DI_MAX_DEPENDENCIES];
+    for (int i = 0; i < plan->step_count; i++) {
+        const catzilla_di_plan_step_t* step = &plan->steps[i];
+        for (int j = 0; j < step->dependency_count; j++) {
+            dependencies[j] = instances[step->dependency_slots[j]];
+        }
+        instances[step->slot] = step->service->factory->create_func(
+            dependencies, step->dependency_count, step->service->factory->user_data);
+        if (!instances[step->slot]) return -1;
+    }
+
+    for (int i = 0; i < plan->root_count; i++) {
+        results[i] = instances[plan->root_slots[i]];
+    }
+    return 0;
+}
+
+void catzilla_di_plan_destroy(catzilla_di_plan_t* plan) {
+    if (!plan) return;
+
+    catzilla_cache_free(plan->singletons);
+    catzilla_cache_free(plan->steps);
+    catzilla_cache_free(plan->root_slots);
+    catzilla_cache_free(plan);
+}
+
 bool catzilla_di_has_service(catzilla_di_container_t* container, const char* name) {
     return catzilla_di_find_service(container, name) != NULL;
 }
@@ -736,6 +1205,10 @@ catzilla_di_context_t* catzilla_di_create_context(catzilla_di_container_t* conta
 void catzilla_di_cleanup_context(catzilla_di_context_t* context) {
     if (!context) return;
 
+    if (context->owned_count > 0 || context->owned) {
+        catzilla_di_context_release(context);
+    }
+
     if (context->resolution_cache) {
         catzilla_di_cache_cleanup(context->resolution_cache);
         catzilla_cache_free(context->resolution_cache);
@@ -885,7 +1358,8 @@ void catzilla_di_reset_caches(catzilla_di_container_t* container) {
         }
     }
 
-    // Reset singleton cached instances
+    // Reset singleton cached instances; plans holding them are stale now
+    container->generation++;
     for (int i = 0; i < container->service_count; i++) {
         if (container->services[i] &&
             container->services[i]->scope == CATZILLA_DI_SCOPE_SINGLETON) {
@@ -4,6 +4,7 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include "request_arena.h"
 
 // Maximum limits for dependency injection
 #define CATZILLA_DI_NAME_MAX 128
@@ -12,6 +13,11 @@
 #define CATZILLA_DI_MAX_SERVICES 1000
 #define CATZILLA_DI_CACHE_SIZE 256
 
+// Pooled request-scoped instances, kept per thread (one pool per event loop)
+#define CATZILLA_DI_POOL_MAX_SERVICES 64       // Services with a pool on one thread
+#define CATZILLA_DI_POOL_MAX_INSTANCES 32      // Largest pool one service may ask for
+#define CATZILLA_DI_POOL_DEFAULT_INSTANCES 8
+
 // Phase 4: Advanced Memory Optimization Configuration
 #define CATZILLA_DI_MEMORY_POOL_SINGLETON_SIZE (64 * 1024)    // 64KB for long-lived singletons
 #define CATZILLA_DI_MEMORY_POOL_REQUEST_SIZE (32 * 1024)      // 32KB per request context
@@ -143,6 +149,21 @@ typedef struct {
  */
 typedef void* (*catzilla_di_factory_func_t)(void** dependencies, int dependency_count, void* user_data);
 
+/**
+ * Reset hook of a pooled service, run when its context is cleaned up
+ * @param instance Instance to make ready for the next request
+ * @param user_data User data passed during registration
+ * @return 0 if the instance can be reused, -1 to have it destroyed
+ */
+typedef int (*catzilla_di_reset_func_t)(void* instance, void* user_data);
+
+/**
+ * Destroy hook of a service instance
+ * @param instance Instance to free
+ * @param user_data User data passed during registration
+ */
+typedef void (*catzilla_di_destroy_func_t)(void* instance, void* user_data);
+
 /**
  * Service factory configuration
  */
@@ -151,6 +172,13 @@ typedef struct catzilla_di_factory_s {
     void* python_factory;                     // Python factory object reference
     void* user_data;                          // Additional factory data
     bool is_python_factory;                   // Whether to use Python or C factory
+
+    // Lifecycle of request-scoped instances (see catzilla_di_set_service_lifecycle)
+    catzilla_di_reset_func_t reset_func;      // NULL = never pooled
+    catzilla_di_destroy_func_t destroy_func;  // NULL = instances are not freed
+    int pool_max;                             // Instances kept per thread
+    uint64_t pool_key;                        // Container and registration ID, never reused
+    uint64_t outstanding;                     // Instances held by contexts (atomic)
 } catzilla_di_factory_t;
 
 /**
@@ -227,6 +255,13 @@ typedef struct catzilla_di_context_s {
     uint32_t context_id;                     // Unique context ID
     uint64_t creation_time;                  // When context was created
     void* request_data;                      // Associated request data (optional)
+
+    // Request-scoped instances with lifecycle hooks this context holds; they
+    // are reset into the pool or destroyed at cleanup
+    struct catzilla_di_owned_instance_s* owned;
+    int owned_count;
+    int owned_capacity;
+    bool is_temporary;                       // Made for one resolve call; instances go to the caller
 } catzilla_di_context_t;
 
 /**
@@ -258,10 +293,23 @@ typedef struct catzilla_di_container_s {
     // Container metadata
     uint32_t container_id;                   // Unique container identifier
     uint32_t next_service_id;                // Next service registration ID
+    uint32_t generation;                     // Bumped on every registration change
     uint64_t creation_time;                  // When container was created
     bool is_initialized;                     // Initialization status
 } catzilla_di_container_t;
 
+/**
+ * Request-scoped instance pool statistics, aggregated over all threads
+ */
+typedef struct catzilla_di_instance_pool_stats_s {
+    uint64_t created;        // Instances of services with lifecycle hooks made by their factory
+    uint64_t reused;         // Instances borrowed from a pool instead
+    uint64_t returned;       // Instances reset and put back at context cleanup
+    uint64_t destroyed;      // Instances destroyed: no reset hook, reset failed or pool full
+    uint64_t outstanding;    // Instances held by contexts right now
+    uint64_t leaked;         // Instances still held when their container was cleaned up
+} catzilla_di_instance_pool_stats_t;
+
 /**
  * Dependency injection performance statistics
  */
@@ -290,6 +338,33 @@ typedef struct catzilla_di_stats_s {
     uint64_t factory_errors;
 } catzilla_di_stats_t;
 
+/**
+ * One request-scoped service of a resolution plan
+ */
+typedef struct catzilla_di_plan_step_s {
+    struct catzilla_di_service_s* service;   // Service to create
+    int slot;                                // Slot its instance goes to
+    int dependency_count;
+    int dependency_slots[CATZILLA_DI_MAX_DEPENDENCIES]; // Slots of its dependencies, in order
+} catzilla_di_plan_step_t;
+
+/**
+ * Resolution plan for a fixed set of services (typically one route's).
+ * Every service the set needs gets an integer slot; singletons are resolved
+ * when the plan is compiled and the remaining services are created per
+ * execution in dependency order, so executing a plan never looks a name up.
+ */
+typedef struct catzilla_di_plan_s {
+    struct catzilla_di_container_s* container;
+    uint32_t generation;                     // Container generations it was compiled against
+    int slot_count;
+    void** singletons;                       // slot_count entries, NULL for request-scoped slots
+    catzilla_di_plan_step_t* steps;          // Request-scoped services, dependencies first
+    int step_count;
+    int* root_slots;                         // Slot of each requested service
+    int root_count;
+} catzilla_di_plan_t;
+
 // ============================================================================
 // CORE CONTAINER MANAGEMENT API
 // ============================================================================
@@ -385,6 +460,45 @@ int catzilla_di_register_service_python(catzilla_di_container_t* container,
                                         const char** dependencies,
                                         int dependency_count);
 
+/**
+ * Give a request-scoped service lifecycle hooks. With a reset hook, the
+ * instances a context resolved are reset at catzilla_di_cleanup_context()
+ * and kept in the calling thread's pool, and later contexts on that thread
+ * borrow them instead of running the factory. An instance whose reset fails,
+ * or that finds the pool full, is destroyed.
+ * A pooled instance outlives the request that made it, so every dependency
+ * of a service with a reset hook must be a singleton.
+ * @param container Container the service is registered in
+ * @param name Service name (scoped or request scope)
+ * @param reset_func Reset hook, or NULL to only destroy instances
+ * @param destroy_func Destroy hook (may be NULL)
+ * @param pool_max Instances kept per thread, 0 for CATZILLA_DI_POOL_DEFAULT_INSTANCES
+ * @return 0 on success, -1 on failure
+ */
+int catzilla_di_set_service_lifecycle(catzilla_di_container_t* container,
+                                      const char* name,
+                                      catzilla_di_reset_func_t reset_func,
+                                      catzilla_di_destroy_func_t destroy_func,
+                                      int pool_max);
+
+/**
+ * Destroy the instances pooled on the calling thread
+ */
+void catzilla_di_instance_pool_trim(void);
+
+/**
+ * Get request-scoped instance pool statistics
+ * @param stats Receives the statistics
+ */
+void catzilla_di_get_instance_pool_stats(catzilla_di_instance_pool_stats_t* stats);
+
+/**
+ * Count instances still held by contexts, logging each service that has some
+ * @param container Container to check
+ * @return Number of instances not returned yet
+ */
+uint64_t catzilla_di_check_instance_leaks(catzilla_di_container_t* container);
+
 /**
  * Unregister a service from the container
  * @param container Target container
@@ -423,6 +537,44 @@ int catzilla_di_resolve_services(catzilla_di_container_t* container,
                                  catzilla_di_context_t* context,
                                  void** results);
 
+/**
+ * Compile a resolution plan for a set of services. Singletons the set needs
+ * are resolved now; registering, unregistering or resetting caches in the
+ * container (or a parent) afterwards makes the plan stale.
+ * @param container Source container
+ * @param names Service names, in the order the results should come in
+ * @param count Number of names
+ * @return New plan, or NULL if a service is missing, circular or has no C factory
+ */
+catzilla_di_plan_t* catzilla_di_plan_compile(catzilla_di_container_t* container,
+                                             const char** names,
+                                             int count);
+
+/**
+ * Execute a resolution plan. Request-scoped services are created once each,
+ * with their instance table allocated in one block from the arena.
+ * @param plan Compiled plan
+ * @param arena Request arena the instance table is allocated from
+ * @param results Output array of plan->root_count instances
+ * @return 0 on success, -1 if the plan is stale or a factory failed
+ */
+int catzilla_di_plan_execute(const catzilla_di_plan_t* plan,
+                             catzilla_request_arena_t* arena,
+                             void** results);
+
+/**
+ * Check whether a plan still matches its container's registrations
+ * @param plan Compiled plan
+ * @return true if the plan can be executed
+ */
+bool catzilla_di_plan_is_current(const catzilla_di_plan_t* plan);
+
+/**
+ * Free a resolution plan
+ * @param plan Plan to free (may be NULL)
+ */
+void catzilla_di_plan_destroy(catzilla_di_plan_t* plan);
+
 /**
  * Check if a service is registered in the container
  * @param container Source container
@@ -0,0 +1,726 @@
+/*
+ * Catzilla Disk Cache - memory-mapped segment store
+ *
+ * Segment files hold records back to back, each one a header, the key and
+ * the value, padded to 8 bytes. The header's magic is written last, so a
+ * scan stops cleanly at an append that never finished. A segment is mapped
+ * once, at its full size, and only the last one takes appends.
+ *
+ * Segments are reference counted: the cache holds one reference while a
+ * segment is listed and every reader holds one while it uses a value, so
+ * compaction and eviction can unlink a segment that is still being read.
+ */
+
+#include "disk_cache.h"
+#include "cache_engine.h"
+#include "logging.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+
+// The segment store needs mmap; the disk tier is not available on Windows
+
+catzilla_disk_cache_t* catzilla_disk_cache_open(const char* directory,
+                                                const catzilla_disk_cache_config_t* config) {
+    (void)directory;
+    (void)config;
+    LOG_CACHE_WARN("Disk cache is not supported on Windows");
+    return NULL;
+}
+
+void catzilla_disk_cache_close(catzilla_disk_cache_t* cache) { (void)cache; }
+
+int catzilla_disk_cache_put(catzilla_disk_cache_t* cache, const char* key,
+                            const void* value, size_t size, uint32_t ttl_seconds) {
+    (void)cache; (void)key; (void)value; (void)size; (void)ttl_seconds;
+    return -1;
+}
+
+bool catzilla_disk_cache_get(catzilla_disk_cache_t* cache, const char* key, catzilla_disk_ref_t* ref) {
+    (void)cache; (void)key;
+    if (ref) memset(ref, 0, sizeof(*ref));
+    return false;
+}
+
+void catzilla_disk_cache_release(catzilla_disk_cache_t* cache, catzilla_disk_ref_t* ref) {
+    (void)cache;
+    if (ref) memset(ref, 0, sizeof(*ref));
+}
+
+int catzilla_disk_cache_delete(catzilla_disk_cache_t* cache, const char* key) {
+    (void)cache; (void)key;
+    return -1;
+}
+
+void catzilla_disk_cache_clear(catzilla_disk_cache_t* cache) { (void)cache; }
+
+int catzilla_disk_cache_compact(catzilla_disk_cache_t* cache) {
+    (void)cache;
+    return 0;
+}
+
+void catzilla_disk_cache_get_stats(catzilla_disk_cache_t* cache, catzilla_disk_cache_stats_t* stats) {
+    (void)cache;
+    if (stats) memset(stats, 0, sizeof(*stats));
+}
+
+#else
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define DISK_RECORD_MAGIC 0x31435a43u  // "CZC1"
+#define DISK_RECORD_TOMBSTONE 1u
+#define DISK_KEY_MAX 65535
+#define DISK_PAGE_SIZE 4096
+
+typedef struct {
+    uint32_t magic;               // Written last
+    uint32_t flags;
+    uint32_t key_len;
+    uint32_t hash;
+    uint64_t value_len;
+    uint64_t expires_at;          // Unix time in seconds, 0 = never
+} disk_record_header_t;
+
+struct catzilla_disk_segment_s {
+    uint32_t id;
+    int fd;
+    char* map;
+    size_t capacity;
+    size_t used;
+    uint64_t live_bytes;          // Bytes of records the index points at
+    catzilla_atomic_uint64_t refs;
+    char path[PATH_MAX];
+};
+
+typedef struct disk_index_entry_s {
+    struct disk_index_entry_s* next;
+    catzilla_disk_segment_t* segment;
+    size_t offset;                // Record offset in the segment
+    uint64_t value_len;
+    uint64_t expires_at;
+    uint32_t hash;
+    uint32_t key_len;
+    char key[];
+} disk_index_entry_t;
+
+struct catzilla_disk_cache_s {
+    char directory[PATH_MAX];
+    catzilla_disk_cache_config_t config;
+
+    // Index and segment list; readers share it, appends and compaction own it
+    catzilla_rwlock_t lock;
+    disk_index_entry_t** buckets;
+    size_t bucket_count;
+    size_t entry_count;
+    catzilla_disk_segment_t** segments;   // Oldest first; the last takes appends
+    size_t segment_count;
+    size_t segment_capacity;
+    uint32_t next_segment_id;
+    uint64_t disk_bytes;
+    uint64_t live_bytes;
+
+    catzilla_atomic_uint64_t hits;
+    catzilla_atomic_uint64_t misses;
+    uint64_t compactions;
+    uint64_t evicted_segments;
+
+    // Background compaction
+    pthread_t thread;
+    pthread_mutex_t wake_lock;
+    pthread_cond_t wake;
+    bool thread_started;
+    bool stopping;
+};
+
+static size_t record_size(size_t key_len, uint64_t value_len) {
+    return (sizeof(disk_record_header_t) + key_len + (size_t)value_len + 7) & ~(size_t)7;
+}
+
+static uint64_t now_seconds(void) {
+    return (uint64_t)time(NULL);
+}
+
+static bool expired_at(uint64_t expires_at, uint64_t now) {
+    return expires_at != 0 && now >= expires_at;
+}
+
+// ---------------------------------------------------------------------------
+// Segments
+// ---------------------------------------------------------------------------
+
+static void segment_unref(catzilla_disk_segment_t* segment) {
+    if (catzilla_atomic_fetch_sub(&segment->refs, 1) != 1) return;
+    munmap(segment->map, segment->capacity);
+    close(segment->fd);
+    free(segment);
+}
+
+// Map a segment file; creates it with `capacity` bytes when `create` is set
+static catzilla_disk_segment_t* segment_map(catzilla_disk_cache_t* cache, uint32_t id,
+                                            size_t capacity, bool create) {
+    catzilla_disk_segment_t* segment = calloc(1, sizeof(*segment));
+    if (!segment) return NULL;
+    segment->id = id;
+    snprintf(segment->path, sizeof(segment->path), "%s/seg-%08u.czc", cache->directory, id);
+
+    segment->fd = open(segment->path, create ? (O_RDWR | O_CREAT | O_EXCL) : O_RDWR, 0600);
+    if (segment->fd < 0) {
+        LOG_CACHE_ERROR("Cannot open disk cache segment %s: %s", segment->path, strerror(errno));
+        free(segment);
+        return NULL;
+    }
+
+    if (create) {
+        if (ftruncate(segment->fd, (off_t)capacity) != 0) {
+            LOG_CACHE_ERROR("Cannot size disk cache segment %s: %s", segment->path, strerror(errno));
+            close(segment->fd);
+            unlink(segment->path);
+            free(segment);
+            return NULL;
+        }
+    } else {
+        struct stat st;
+        if (fstat(segment->fd, &st) != 0 || st.st_size < (off_t)sizeof(disk_record_header_t)) {
+            close(segment->fd);
+            free(segment);
+            return NULL;
+        }
+        capacity = (size_t)st.st_size;
+    }
+
+    segment->map = mmap(NULL, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, segment->fd, 0);
+    if (segment->map == MAP_FAILED) {
+        LOG_CACHE_ERROR("Cannot map disk cache segment %s: %s", segment->path, strerror(errno));
+        close(segment->fd);
+        if (create) unlink(segment->path);
+        free(segment);
+        return NULL;
+    }
+    segment->capacity = capacity;
+    segment->refs = 1;
+    return segment;
+}
+
+static int segment_list_append(catzilla_disk_cache_t* cache, catzilla_disk_segment_t* segment) {
+    if (cache->segment_count == cache->segment_capacity) {
+        size_t capacity = cache->segment_capacity ? cache->segment_capacity * 2 : 16;
+        catzilla_disk_segment_t** segments = realloc(cache->segments, sizeof(*segments) * capacity);
+        if (!segments) return -1;
+        cache->segments = segments;
+        cache->segment_capacity = capacity;
+    }
+    cache->segments[cache->segment_count++] = segment;
+    cache->disk_bytes += segment->capacity;
+    return 0;
+}
+
+// Take a segment out of the list and unlink its file; readers keep the mapping
+static void segment_retire(catzilla_disk_cache_t* cache, size_t index) {
+    catzilla_disk_segment_t* segment = cache->segments[index];
+    memmove(&cache->segments[index], &cache->segments[index + 1],
+            sizeof(*cache->segments) * (cache->segment_count - index - 1));
+    cache->segment_count--;
+    cache->disk_bytes -= segment->capacity;
+    unlink(segment->path);
+    segment_unref(segment);
+}
+
+// ---------------------------------------------------------------------------
+// Index
+// ---------------------------------------------------------------------------
+
+static disk_index_entry_t* index_find(catzilla_disk_cache_t* cache, const char* key,
+                                      size_t key_len, uint32_t hash) {
+    for (disk_index_entry_t* entry = cache->buckets[hash % cache->bucket_count]; entry; entry = entry->next) {
+        if (entry->hash == hash && entry->key_len == key_len && memcmp(entry->key, key, key_len) == 0) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static void index_grow(catzilla_disk_cache_t* cache) {
+    size_t bucket_count = cache->bucket_count * 2;
+    disk_index_entry_t** buckets = calloc(bucket_count, sizeof(*buckets));
+    if (!buckets) return;  // Longer chains, still correct
+    for (size_t i = 0; i < cache->bucket_count; i++) {
+        disk_index_entry_t* entry = cache->buckets[i];
+        while (entry) {
+            disk_index_entry_t* next = entry->next;
+            entry->next = buckets[entry->hash % bucket_count];
+            buckets[entry->hash % bucket_count] = entry;
+            entry = next;
+        }
+    }
+    free(cache->buckets);
+    cache->buckets = buckets;
+    cache->bucket_count = bucket_count;
+}
+
+// Forget an entry; its record becomes dead space
+static void index_remove(catzilla_disk_cache_t* cache, disk_index_entry_t* entry) {
+    disk_index_entry_t** link = &cache->buckets[entry->hash % cache->bucket_count];
+    while (*link != entry) link = &(*link)->next;
+    *link = entry->next;
+
+    uint64_t bytes = record_size(entry->key_len, entry->value_len);
+    entry->segment->live_bytes -= bytes;
+    cache->live_bytes -= bytes;
+    cache->entry_count--;
+    free(entry);
+}
+
+// Point a key at a record, replacing what it pointed at before
+static int index_set(catzilla_disk_cache_t* cache, const char* key, size_t key_len, uint32_t hash,
+                     catzilla_disk_segment_t* segment, size_t offset, uint64_t value_len,
+                     uint64_t expires_at) {
+    disk_index_entry_t* entry = index_find(cache, key, key_len, hash);
+    if (entry) {
+        uint64_t bytes = record_size(entry->key_len, entry->value_len);
+        entry->segment->live_bytes -= bytes;
+        cache->live_bytes -= bytes;
+    } else {
+        entry = malloc(sizeof(*entry) + key_len + 1);
+        if (!entry) return -1;
+        memcpy(entry->key, key, key_len);
+        entry->key[key_len] = '\0';
+        entry->key_len = (uint32_t)key_len;
+        entry->hash = hash;
+        entry->next = cache->buckets[hash % cache->bucket_count];
+        cache->buckets[hash % cache->bucket_count] = entry;
+        if (++cache->entry_count > cache->bucket_count) index_grow(cache);
+    }
+
+    entry->segment = segment;
+    entry->offset = offset;
+    entry->value_len = value_len;
+    entry->expires_at = expires_at;
+    uint64_t bytes = record_size(key_len, value_len);
+    segment->live_bytes += bytes;
+    cache->live_bytes += bytes;
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// Appends
+// ---------------------------------------------------------------------------
+
+// Append a record to the active segment, starting a new one when it is full
+static int append_record(catzilla_disk_cache_t* cache, const char* key, size_t key_len, uint32_t hash,
+                         uint32_t flags, const void* value, uint64_t value_len, uint64_t expires_at,
+                         catzilla_disk_segment_t** segment_out, size_t* offset_out) {
+    size_t need = record_size(key_len, value_len);
+    catzilla_disk_segment_t* segment = cache->segment_count ? cache->segments[cache->segment_count - 1] : NULL;
+
+    if (!segment || segment->capacity - segment->used < need) {
+        size_t capacity = cache->config.segment_size;
+        if (need > capacity) capacity = (need + DISK_PAGE_SIZE - 1) & ~(size_t)(DISK_PAGE_SIZE - 1);
+        segment = segment_map(cache, cache->next_segment_id, capacity, true);
+        if (!segment) return -1;
+        cache->next_segment_id++;
+        if (segment_list_append(cache, segment) != 0) {
+            unlink(segment->path);
+            segment_unref(segment);
+            return -1;
+        }
+    }
+
+    char* record = segment->map + segment->used;
+    disk_record_header_t header = { 0, flags, (uint32_t)key_len, hash, value_len, expires_at };
+    memcpy(record, &header, sizeof(header));
+    memcpy(record + sizeof(header), key, key_len);
+    if (value_len > 0) memcpy(record + sizeof(header) + key_len, value, (size_t)value_len);
+    uint32_t magic = DISK_RECORD_MAGIC;
+    memcpy(record, &magic, sizeof(magic));
+
+    *segment_out = segment;
+    *offset_out = segment->used;
+    segment->used += need;
+    return 0;
+}
+
+// Drop the oldest segments, and the keys in them, until under max_bytes
+static void enforce_max_bytes(catzilla_disk_cache_t* cache) {
+    while (cache->disk_bytes > cache->config.max_bytes && cache->segment_count > 1) {
+        catzilla_disk_segment_t* oldest = cache->segments[0];
+        for (size_t offset = 0; offset < oldest->used && oldest->live_bytes > 0;) {
+            disk_record_header_t header;
+            memcpy(&header, oldest->map + offset, sizeof(header));
+            disk_index_entry_t* entry = index_find(cache, oldest->map + offset + sizeof(header),
+                                                   header.key_len, header.hash);
+            if (entry && entry->segment == oldest && entry->offset == offset) {
+                index_remove(cache, entry);
+            }
+            offset += record_size(header.key_len, header.value_len);
+        }
+        segment_retire(cache, 0);
+        cache->evicted_segments++;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Compaction
+// ---------------------------------------------------------------------------
+
+// Rewrite sealed segments that are at least half dead; holds the write lock
+static int compact_locked(catzilla_disk_cache_t* cache) {
+    uint64_t now = now_seconds();
+
+    // Expired keys are dead space too
+    for (size_t i = 0; i < cache->bucket_count; i++) {
+        disk_index_entry_t* entry = cache->buckets[i];
+        while (entry) {
+            disk_index_entry_t* next = entry->next;
+            if (expired_at(entry->expires_at, now)) index_remove(cache, entry);
+            entry = next;
+        }
+    }
+
+    int compacted = 0;
+    for (size_t i = 0; i + 1 < cache->segment_count;) {
+        catzilla_disk_segment_t* segment = cache->segments[i];
+        if (segment->live_bytes * 2 > segment->used) {
+            i++;
+            continue;
+        }
+
+        // Copy the records the index still points at to the active segment
+        bool moved_all = true;
+        for (size_t offset = 0; offset < segment->used && segment->live_bytes > 0;) {
+            disk_record_header_t header;
+            memcpy(&header, segment->map + offset, sizeof(header));
+            const char* key = segment->map + offset + sizeof(header);
+            disk_index_entry_t* entry = index_find(cache, key, header.key_len, header.hash);
+            if (entry && entry->segment == segment && entry->offset == offset) {
+                catzilla_disk_segment_t* target = NULL;
+                size_t target_offset = 0;
+                if (append_record(cache, key, header.key_len, header.hash, 0, key + header.key_len,
+                                  header.value_len, header.expires_at, &target, &target_offset) != 0) {
+                    moved_all = false;
+                    break;
+                }
+                index_set(cache, key, header.key_len, header.hash, target, target_offset,
+                          header.value_len, header.expires_at);
+            }
+            offset += record_size(header.key_len, header.value_len);
+        }
+        if (!moved_all) break;
+
+        segment_retire(cache, i);
+        cache->compactions++;
+        compacted++;
+    }
+
+    enforce_max_bytes(cache);
+    return compacted;
+}
+
+static void* compaction_thread(void* arg) {
+    catzilla_disk_cache_t* cache = arg;
+
+    pthread_mutex_lock(&cache->wake_lock);
+    while (!cache->stopping) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        uint64_t nanos = (uint64_t)deadline.tv_nsec + (uint64_t)cache->config.compact_interval_ms * 1000000ULL;
+        deadline.tv_sec += (time_t)(nanos / 1000000000ULL);
+        deadline.tv_nsec = (long)(nanos % 1000000000ULL);
+        pthread_cond_timedwait(&cache->wake, &cache->wake_lock, &deadline);
+        if (cache->stopping) break;
+        pthread_mutex_unlock(&cache->wake_lock);
+
+        catzilla_rwlock_wrlock(&cache->lock);
+        compact_locked(cache);
+        catzilla_rwlock_unlock(&cache->lock);
+
+        pthread_mutex_lock(&cache->wake_lock);
+    }
+    pthread_mutex_unlock(&cache->wake_lock);
+    return NULL;
+}
+
+// ---------------------------------------------------------------------------
+// Open and close
+// ---------------------------------------------------------------------------
+
+static int compare_ids(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+// Replay a segment's records into the index
+static void scan_segment(catzilla_disk_cache_t* cache, catzilla_disk_segment_t* segment, uint64_t now) {
+    size_t offset = 0;
+    while (offset + sizeof(disk_record_header_t) <= segment->capacity) {
+        disk_record_header_t header;
+        memcpy(&header, segment->map + offset, sizeof(header));
+        size_t size = record_size(header.key_len, header.value_len);
+        if (header.magic != DISK_RECORD_MAGIC || header.key_len > DISK_KEY_MAX ||
+            header.value_len > segment->capacity || size > segment->capacity - offset) {
+            break;
+        }
+
+        const char* key = segment->map + offset + sizeof(header);
+        if ((header.flags & DISK_RECORD_TOMBSTONE) || expired_at(header.expires_at, now)) {
+            disk_index_entry_t* entry = index_find(cache, key, header.key_len, header.hash);
+            if (entry) index_remove(cache, entry);
+        } else {
+            index_set(cache, key, header.key_len, header.hash, segment, offset,
+                      header.value_len, header.expires_at);
+        }
+        offset += size;
+    }
+    segment->used = offset;
+}
+
+static int load_segments(catzilla_disk_cache_t* cache) {
+    DIR* dir = opendir(cache->directory);
+    if (!dir) return -1;
+
+    uint32_t* ids = NULL;
+    size_t count = 0, capacity = 0;
+    struct dirent* item;
+    while ((item = readdir(dir)) != NULL) {
+        unsigned id = 0;
+        char tail = 0;
+        if (sscanf(item->d_name, "seg-%8u.cz%c", &id, &tail) != 2 || tail != 'c') continue;
+        if (count == capacity) {
+            capacity = capacity ? capacity * 2 : 16;
+            uint32_t* grown = realloc(ids, sizeof(*ids) * capacity);
+            if (!grown) break;
+            ids = grown;
+        }
+        ids[count++] = id;
+    }
+    closedir(dir);
+    if (count > 0) qsort(ids, count, sizeof(*ids), compare_ids);
+
+    uint64_t now = now_seconds();
+    for (size_t i = 0; i < count; i++) {
+        if (ids[i] >= cache->next_segment_id) cache->next_segment_id = ids[i] + 1;
+        catzilla_disk_segment_t* segment = segment_map(cache, ids[i], 0, false);
+        if (!segment) continue;
+        if (segment_list_append(cache, segment) != 0) {
+            segment_unref(segment);
+            break;
+        }
+        scan_segment(cache, segment, now);
+    }
+    free(ids);
+    return 0;
+}
+
+catzilla_disk_cache_t* catzilla_disk_cache_open(const char* directory,
+                                                const catzilla_disk_cache_config_t* config) {
+    if (!directory || strlen(directory) + 32 >= PATH_MAX) return NULL;
+
+    catzilla_disk_cache_t* cache = calloc(1, sizeof(*cache));
+    if (!cache) return NULL;
+    snprintf(cache->directory, sizeof(cache->directory), "%s", directory);
+    if (config) cache->config = *config;
+    if (cache->config.segment_size == 0) cache->config.segment_size = CATZILLA_DISK_CACHE_SEGMENT_SIZE;
+    if (cache->config.max_bytes == 0) cache->config.max_bytes = CATZILLA_DISK_CACHE_MAX_BYTES;
+    if (cache->config.compact_interval_ms == 0) {
+        cache->config.compact_interval_ms = CATZILLA_DISK_CACHE_COMPACT_INTERVAL_MS;
+    }
+    cache->config.segment_size = (cache->config.segment_size + DISK_PAGE_SIZE - 1) & ~(size_t)(DISK_PAGE_SIZE - 1);
+
+    if (mkdir(directory, 0700) != 0 && errno != EEXIST) {
+        LOG_CACHE_ERROR("Cannot create disk cache directory %s: %s", directory, strerror(errno));
+        free(cache);
+        return NULL;
+    }
+
+    cache->bucket_count = 1024;
+    cache->buckets = calloc(cache->bucket_count, sizeof(*cache->buckets));
+    if (!cache->buckets) {
+        free(cache);
+        return NULL;
+    }
+    catzilla_rwlock_init(&cache->lock);
+    pthread_mutex_init(&cache->wake_lock, NULL);
+    pthread_cond_init(&cache->wake, NULL);
+
+    if (load_segments(cache) != 0) {
+        LOG_CACHE_ERROR("Cannot read disk cache directory %s", directory);
+        catzilla_disk_cache_close(cache);
+        return NULL;
+    }
+    catzilla_rwlock_wrlock(&cache->lock);
+    enforce_max_bytes(cache);
+    catzilla_rwlock_unlock(&cache->lock);
+
+    if (!cache->config.no_background) {
+        if (pthread_create(&cache->thread, NULL, compaction_thread, cache) == 0) {
+            cache->thread_started = true;
+        } else {
+            LOG_CACHE_WARN("Disk cache compaction thread did not start; compaction runs on demand only");
+        }
+    }
+
+    LOG_CACHE_DEBUG("Disk cache at %s: %zu entries in %zu segments",
+                    directory, cache->entry_count, cache->segment_count);
+    return cache;
+}
+
+void catzilla_disk_cache_close(catzilla_disk_cache_t* cache) {
+    if (!cache) return;
+
+    if (cache->thread_started) {
+        pthread_mutex_lock(&cache->wake_lock);
+        cache->stopping = true;
+        pthread_cond_signal(&cache->wake);
+        pthread_mutex_unlock(&cache->wake_lock);
+        pthread_join(cache->thread, NULL);
+    }
+
+    for (size_t i = 0; i < cache->bucket_count; i++) {
+        disk_index_entry_t* entry = cache->buckets[i];
+        while (entry) {
+            disk_index_entry_t* next = entry->next;
+            free(entry);
+            entry = next;
+        }
+    }
+    for (size_t i = 0; i < cache->segment_count; i++) {
+        segment_unref(cache->segments[i]);
+    }
+    free(cache->segments);
+    free(cache->buckets);
+    catzilla_rwlock_destroy(&cache->lock);
+    pthread_mutex_destroy(&cache->wake_lock);
+    pthread_cond_destroy(&cache->wake);
+    free(cache);
+}
+
+// ---------------------------------------------------------------------------
+// Operations
+// ---------------------------------------------------------------------------
+
+int catzilla_disk_cache_put(catzilla_disk_cache_t* cache, const char* key,
+                            const void* value, size_t size, uint32_t ttl_seconds) {
+    if (!cache || !key || (!value && size > 0)) return -1;
+    size_t key_len = strlen(key);
+    if (key_len > DISK_KEY_MAX) return -1;
+
+    uint32_t hash = catzilla_cache_hash_key(key, key_len);
+    uint64_t expires_at = ttl_seconds ? now_seconds() + ttl_seconds : 0;
+
+    catzilla_rwlock_wrlock(&cache->lock);
+    catzilla_disk_segment_t* segment = NULL;
+    size_t offset = 0;
+    int rc = append_record(cache, key, key_len, hash, 0, value, size, expires_at, &segment, &offset);
+    if (rc == 0) {
+        rc = index_set(cache, key, key_len, hash, segment, offset, size, expires_at);
+        enforce_max_bytes(cache);
+    }
+    catzilla_rwlock_unlock(&cache->lock);
+    return rc;
+}
+
+bool catzilla_disk_cache_get(catzilla_disk_cache_t* cache, const char* key, catzilla_disk_ref_t* ref) {
+    if (!ref) return false;
+    memset(ref, 0, sizeof(*ref));
+    if (!cache || !key) return false;
+
+    size_t key_len = strlen(key);
+    uint32_t hash = catzilla_cache_hash_key(key, key_len);
+
+    catzilla_rwlock_rdlock(&cache->lock);
+    disk_index_entry_t* entry = index_find(cache, key, key_len, hash);
+    if (entry && !expired_at(entry->expires_at, now_seconds())) {
+        catzilla_atomic_fetch_add(&entry->segment->refs, 1);
+        ref->segment = entry->segment;
+        ref->data = entry->segment->map + entry->offset + sizeof(disk_record_header_t) + key_len;
+        ref->size = (size_t)entry->value_len;
+        ref->expires_at = entry->expires_at;
+    }
+    catzilla_rwlock_unlock(&cache->lock);
+
+    catzilla_atomic_fetch_add(ref->segment ? &cache->hits : &cache->misses, 1);
+    return ref->segment != NULL;
+}
+
+void catzilla_disk_cache_release(catzilla_disk_cache_t* cache, catzilla_disk_ref_t* ref) {
+    (void)cache;
+    if (!ref || !ref->segment) return;
+    segment_unref(ref->segment);
+    memset(ref, 0, sizeof(*ref));
+}
+
+int catzilla_disk_cache_delete(catzilla_disk_cache_t* cache, const char* key) {
+    if (!cache || !key) return -1;
+    size_t key_len = strlen(key);
+    uint32_t hash = catzilla_cache_hash_key(key, key_len);
+
+    catzilla_rwlock_wrlock(&cache->lock);
+    disk_index_entry_t* entry = index_find(cache, key, key_len, hash);
+    if (entry) {
+        index_remove(cache, entry);
+        // Without the tombstone a restart would bring the key back
+        catzilla_disk_segment_t* segment = NULL;
+        size_t offset = 0;
+        append_record(cache, key, key_len, hash, DISK_RECORD_TOMBSTONE, NULL, 0, 0, &segment, &offset);
+    }
+    catzilla_rwlock_unlock(&cache->lock);
+    return entry ? 0 : -1;
+}
+
+void catzilla_disk_cache_clear(catzilla_disk_cache_t* cache) {
+    if (!cache) return;
+    catzilla_rwlock_wrlock(&cache->lock);
+    for (size_t i = 0; i < cache->bucket_count; i++) {
+        disk_index_entry_t* entry = cache->buckets[i];
+        while (entry) {
+            disk_index_entry_t* next = entry->next;
+            free(entry);
+            entry = next;
+        }
+        cache->buckets[i] = NULL;
+    }
+    cache->entry_count = 0;
+    cache->live_bytes = 0;
+    while (cache->segment_count > 0) {
+        segment_retire(cache, cache->segment_count - 1);
+    }
+    catzilla_rwlock_unlock(&cache->lock);
+}
+
+int catzilla_disk_cache_compact(catzilla_disk_cache_t* cache) {
+    if (!cache) return 0;
+    catzilla_rwlock_wrlock(&cache->lock);
+    int compacted = compact_locked(cache);
+    catzilla_rwlock_unlock(&cache->lock);
+    return compacted;
+}
+
+void catzilla_disk_cache_get_stats(catzilla_disk_cache_t* cache, catzilla_disk_cache_stats_t* stats) {
+    if (!stats) return;
+    memset(stats, 0, sizeof(*stats));
+    if (!cache) return;
+
+    catzilla_rwlock_rdlock(&cache->lock);
+    stats->entries = cache->entry_count;
+    stats->live_bytes = cache->live_bytes;
+    stats->disk_bytes = cache->disk_bytes;
+    stats->segments = cache->segment_count;
+    stats->compactions = cache->compactions;
+    stats->evicted_segments = cache->evicted_segments;
+    catzilla_rwlock_unlock(&cache->lock);
+    stats->hits = catzilla_atomic_load(&cache->hits);
+    stats->misses = catzilla_atomic_load(&cache->misses);
+}
+
+#endif // _WIN32
@@ -0,0 +1,140 @@
+/*
+ * Catzilla Disk Cache - memory-mapped segment store
+ *
+ * The L3 tier of multi_cache. Values are appended to fixed-size segment
+ * files that stay mapped; an in-memory index points each key at its latest
+ * record. Reads return a pointer into the mapping, pinned until released.
+ * Replaced, deleted and expired records are dropped by compaction, which
+ * copies the live records of mostly-dead segments forward and unlinks them.
+ * The index is rebuilt from the segment files on open, so entries survive a
+ * restart.
+ */
+
+#ifndef CATZILLA_DISK_CACHE_H
+#define CATZILLA_DISK_CACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct catzilla_disk_cache_s catzilla_disk_cache_t;
+typedef struct catzilla_disk_segment_s catzilla_disk_segment_t;
+
+#define CATZILLA_DISK_CACHE_SEGMENT_SIZE (8 * 1024 * 1024)
+#define CATZILLA_DISK_CACHE_MAX_BYTES (256ULL * 1024 * 1024)
+#define CATZILLA_DISK_CACHE_COMPACT_INTERVAL_MS 1000
+
+// Disk cache configuration; zero fields take the defaults above
+typedef struct catzilla_disk_cache_config_s {
+    size_t segment_size;          // Bytes per segment file (larger values get their own)
+    uint64_t max_bytes;           // Segment bytes kept on disk; oldest segments go first
+    uint32_t compact_interval_ms; // Background compaction period
+    bool no_background;           // Compact only when catzilla_disk_cache_compact is called
+} catzilla_disk_cache_config_t;
+
+/**
+ * A value read from the disk cache. data points into the segment mapping and
+ * stays valid until catzilla_disk_cache_release, even if the key is replaced,
+ * deleted or compacted away meanwhile.
+ */
+typedef struct catzilla_disk_ref_s {
+    const void* data;
+    size_t size;
+    uint64_t expires_at;          // Unix time in seconds
+    catzilla_disk_segment_t* segment;  // Pinned segment, NULL when empty
+} catzilla_disk_ref_t;
+
+typedef struct catzilla_disk_cache_stats_s {
+    uint64_t entries;             // Keys in the index
+    uint64_t live_bytes;          // Record bytes the index still points at
+    uint64_t disk_bytes;          // Bytes of all segment files
+    uint64_t segments;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t compactions;         // Segments rewritten and unlinked
+    uint64_t evicted_segments;    // Segments dropped to stay under max_bytes
+} catzilla_disk_cache_stats_t;
+
+/**
+ * Open a disk cache in a directory, creating it if needed, and index the
+ * segments already there
+ * @param directory Directory holding the segment files (one cache per directory)
+ * @param config Configuration, or NULL for the defaults
+ * @return Disk cache, or NULL on failure (always NULL on Windows)
+ */
+catzilla_disk_cache_t* catzilla_disk_cache_open(const char* directory,
+                                                const catzilla_disk_cache_config_t* config);
+
+/**
+ * Stop background compaction, unmap every segment and free the cache. The
+ * files stay on disk. Every reference must have been released.
+ * @param cache Disk cache (may be NULL)
+ */
+void catzilla_disk_cache_close(catzilla_disk_cache_t* cache);
+
+/**
+ * Append a value, replacing any previous one for the key
+ * @param cache Disk cache
+ * @param key Key (NUL-terminated)
+ * @param value Value bytes
+ * @param size Value size
+ * @param ttl_seconds Lifetime (0 = never expires)
+ * @return 0 on success, -1 on failure
+ */
+int catzilla_disk_cache_put(catzilla_disk_cache_t* cache, const char* key,
+                            const void* value, size_t size, uint32_t ttl_seconds);
+
+/**
+ * Look a key up without copying its value
+ * @param cache Disk cache
+ * @param key Key
+ * @param ref Receives the value; release it with catzilla_disk_cache_release
+ * @return true if the key is present and not expired
+ */
+bool catzilla_disk_cache_get(catzilla_disk_cache_t* cache, const char* key, catzilla_disk_ref_t* ref);
+
+/**
+ * Release a value returned by catzilla_disk_cache_get
+ * @param cache Disk cache
+ * @param ref Reference (cleared; releasing an empty one does nothing)
+ */
+void catzilla_disk_cache_release(catzilla_disk_cache_t* cache, catzilla_disk_ref_t* ref);
+
+/**
+ * Delete a key; a tombstone record keeps it deleted across a restart
+ * @param cache Disk cache
+ * @param key Key
+ * @return 0 if the key was present, -1 otherwise
+ */
+int catzilla_disk_cache_delete(catzilla_disk_cache_t* cache, const char* key);
+
+/**
+ * Drop every entry and segment file
+ * @param cache Disk cache
+ */
+void catzilla_disk_cache_clear(catzilla_disk_cache_t* cache);
+
+/**
+ * Run one compaction pass now: rewrite sealed segments that are mostly
+ * dead and unlink them
+ * @param cache Disk cache
+ * @return Number of segments compacted
+ */
+int catzilla_disk_cache_compact(catzilla_disk_cache_t* cache);
+
+/**
+ * Get disk cache statistics
+ * @param cache Disk cache
+ * @param stats Receives the statistics
+ */
+void catzilla_disk_cache_get_stats(catzilla_disk_cache_t* cache, catzilla_disk_cache_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CATZILLA_DISK_CACHE_H
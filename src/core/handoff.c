@@ -0,0 +1,337 @@
+/*
+ * Catzilla Listener Handoff - zero-downtime reloads
+ *
+ * The exchange on a connected handoff socket:
+ *   server -> successor  handoff_message_t, with the listening sockets
+ *                        attached as SCM_RIGHTS
+ *   successor -> server  one HANDOFF_ACK byte once it holds them
+ * A successor that dies before answering leaves the server serving as if
+ * nothing happened; the copies it received close with it.
+ */
+
+#include "handoff.h"
+#include "logging.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+
+int catzilla_handoff_request(const char* path, int* fds, int max_fds, int timeout_ms) {
+    (void)path; (void)fds; (void)max_fds; (void)timeout_ms;
+    LOG_SERVER_WARN("Listener handoff is not supported on Windows");
+    return -1;
+}
+
+int catzilla_handoff_listen(const char* path, uint64_t* inode) {
+    (void)path;
+    if (inode) *inode = 0;
+    return -1;
+}
+
+int catzilla_handoff_accept(int listen_fd) {
+    (void)listen_fd;
+    return -1;
+}
+
+int catzilla_handoff_send(int peer_fd, const int* fds, int count, int timeout_ms) {
+    (void)peer_fd; (void)fds; (void)count; (void)timeout_ms;
+    return -1;
+}
+
+void catzilla_handoff_close(int listen_fd, const char* path, uint64_t inode) {
+    (void)listen_fd; (void)path; (void)inode;
+}
+
+#else
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define HANDOFF_MAGIC 0x4f485a43u  // "CZHO"
+#define HANDOFF_ACK 'K'
+
+typedef struct {
+    uint32_t magic;
+    uint32_t count;  // Descriptors attached
+} handoff_message_t;
+
+#ifdef MSG_NOSIGNAL
+#define HANDOFF_SEND_FLAGS MSG_NOSIGNAL
+#else
+#define HANDOFF_SEND_FLAGS 0
+#endif
+
+#ifdef MSG_CMSG_CLOEXEC
+#define HANDOFF_RECV_FLAGS MSG_CMSG_CLOEXEC
+#else
+#define HANDOFF_RECV_FLAGS 0
+#endif
+
+static int handoff_address(const char* path, struct sockaddr_un* addr) {
+    if (!path || !*path || strlen(path) >= sizeof(addr->sun_path)) {
+        LOG_SERVER_ERROR("Handoff socket path is empty or too long: %s", path ? path : "(null)");
+        return -1;
+    }
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    memcpy(addr->sun_path, path, strlen(path) + 1);
+    return 0;
+}
+
+static int handoff_socket(void) {
+#ifdef SOCK_CLOEXEC
+    return socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+#else
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0) fcntl(fd, F_SETFD, FD_CLOEXEC);
+    return fd;
+#endif
+}
+
+// Wait until fd is readable (POLLIN) or writable (POLLOUT); 0 when ready
+static int handoff_wait(int fd, short events, int timeout_ms) {
+    struct pollfd entry = {fd, events, 0};
+    int rc;
+    do {
+        rc = poll(&entry, 1, timeout_ms);
+    } while (rc < 0 && errno == EINTR);
+    if (rc == 0) errno = ETIMEDOUT;
+    return rc > 0 ? 0 : -1;
+}
+
+static void close_received(int* fds, int count) {
+    for (int i = 0; i < count; i++) close(fds[i]);
+}
+
+#ifndef MSG_CMSG_CLOEXEC
+static void set_cloexec(int* fds, int count) {
+    for (int i = 0; i < count; i++) fcntl(fds[i], F_SETFD, FD_CLOEXEC);
+}
+#endif
+
+int catzilla_handoff_request(const char* path, int* fds, int max_fds, int timeout_ms) {
+    struct sockaddr_un addr;
+    if (!fds || max_fds <= 0 || handoff_address(path, &addr) != 0) return -1;
+
+    int sock = handoff_socket();
+    if (sock < 0) return -1;
+
+    if (connect(sock, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        int err = errno;
+        close(sock);
+        if (err == ENOENT) return 0;
+        if (err == ECONNREFUSED) {
+            // Nobody accepts on it: the server that bound it is gone
+            unlink(path);
+            return 0;
+        }
+        LOG_SERVER_ERROR("Cannot connect to handoff socket %s: %s", path, strerror(err));
+        return -1;
+    }
+
+    handoff_message_t message;
+    struct iovec iov = {&message, sizeof(message)};
+    union {
+        struct cmsghdr align;
+        char buffer[CMSG_SPACE(sizeof(int) * CATZILLA_HANDOFF_MAX_FDS)];
+    } control;
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buffer;
+    msg.msg_controllen = sizeof(control.buffer);
+
+    ssize_t received = -1;
+    if (handoff_wait(sock, POLLIN, timeout_ms) == 0) {
+        do {
+            received = recvmsg(sock, &msg, HANDOFF_RECV_FLAGS);
+        } while (received < 0 && errno == EINTR);
+    }
+    if (received < 0) {
+        LOG_SERVER_ERROR("No listeners received from handoff socket %s: %s", path, strerror(errno));
+        close(sock);
+        return -1;
+    }
+
+    // Whatever arrived is ours to close, even in a message we refuse
+    int count = 0;
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) continue;
+        int attached = (int)((cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int));
+        for (int i = 0; i < attached; i++) {
+            int fd;
+            memcpy(&fd, CMSG_DATA(cmsg) + i * sizeof(int), sizeof(int));
+            if (count < max_fds) {
+                fds[count++] = fd;
+            } else {
+                close(fd);
+                count = max_fds + 1;
+            }
+        }
+    }
+    if (count > max_fds || (msg.msg_flags & MSG_CTRUNC) || received != (ssize_t)sizeof(message) ||
+        message.magic != HANDOFF_MAGIC || message.count != (uint32_t)count || count == 0) {
+        LOG_SERVER_ERROR("Handoff socket %s sent an unusable message", path);
+        close_received(fds, count > max_fds ? max_fds : count);
+        close(sock);
+        return -1;
+    }
+#ifndef MSG_CMSG_CLOEXEC
+    set_cloexec(fds, count);
+#endif
+
+    // The server stops accepting only once it has heard back
+    char ack = HANDOFF_ACK;
+    ssize_t sent;
+    do {
+        sent = send(sock, &ack, 1, HANDOFF_SEND_FLAGS);
+    } while (sent < 0 && errno == EINTR);
+    close(sock);
+    if (sent != 1) {
+        LOG_SERVER_ERROR("Cannot confirm handoff on %s: %s", path, strerror(errno));
+        close_received(fds, count);
+        return -1;
+    }
+    return count;
+}
+
+int catzilla_handoff_listen(const char* path, uint64_t* inode) {
+    struct sockaddr_un addr;
+    if (handoff_address(path, &addr) != 0) return -1;
+
+    int sock = handoff_socket();
+    if (sock < 0) return -1;
+
+    // A predecessor's socket file stays until it closes; the name is ours now
+    unlink(path);
+    struct stat st;
+    if (bind(sock, (struct sockaddr*)&addr, sizeof(addr)) != 0 ||
+        chmod(path, S_IRUSR | S_IWUSR) != 0 ||
+        listen(sock, 4) != 0 ||
+        fcntl(sock, F_SETFL, fcntl(sock, F_GETFL) | O_NONBLOCK) != 0 ||
+        stat(path, &st) != 0) {
+        LOG_SERVER_ERROR("Cannot listen on handoff socket %s: %s", path, strerror(errno));
+        close(sock);
+        return -1;
+    }
+    if (inode) *inode = (uint64_t)st.st_ino;
+    return sock;
+}
+
+// Turn away peers running as another user where the platform can tell;
+// elsewhere the socket file's mode is the only guard
+static bool handoff_peer_allowed(int sock) {
+#if defined(SO_PEERCRED) && defined(__linux__)
+    struct ucred cred;
+    socklen_t length = sizeof(cred);
+    if (getsockopt(sock, SOL_SOCKET, SO_PEERCRED, &cred, &length) != 0) return false;
+    return cred.uid == geteuid();
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__)
+    uid_t uid;
+    gid_t gid;
+    if (getpeereid(sock, &uid, &gid) != 0) return false;
+    return uid == geteuid();
+#else
+    (void)sock;
+    return true;
+#endif
+}
+
+int catzilla_handoff_accept(int listen_fd) {
+    if (listen_fd < 0) return -1;
+
+    int sock;
+    do {
+        sock = accept(listen_fd, NULL, NULL);
+    } while (sock < 0 && errno == EINTR);
+    if (sock < 0) {
+        if (errno == EWOULDBLOCK) errno = EAGAIN;
+        return -1;
+    }
+    // The accepted socket may inherit O_NONBLOCK; the waits in
+    // catzilla_handoff_send bound it
+    fcntl(sock, F_SETFL, fcntl(sock, F_GETFL) | O_NONBLOCK);
+    fcntl(sock, F_SETFD, FD_CLOEXEC);
+
+    if (!handoff_peer_allowed(sock)) {
+        LOG_SERVER_WARN("Refused listener handoff to a process of another user");
+        close(sock);
+        errno = EPERM;
+        return -1;
+    }
+    return sock;
+}
+
+int catzilla_handoff_send(int sock, const int* fds, int count, int timeout_ms) {
+    if (sock < 0) return -1;
+    if (!fds || count <= 0 || count > CATZILLA_HANDOFF_MAX_FDS) {
+        close(sock);
+        return -1;
+    }
+
+    handoff_message_t message = {HANDOFF_MAGIC, (uint32_t)count};
+    struct iovec iov = {&message, sizeof(message)};
+    union {
+        struct cmsghdr align;
+        char buffer[CMSG_SPACE(sizeof(int) * CATZILLA_HANDOFF_MAX_FDS)];
+    } control;
+    memset(&control, 0, sizeof(control));
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buffer;
+    msg.msg_controllen = CMSG_SPACE(sizeof(int) * (size_t)count);
+
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int) * (size_t)count);
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * (size_t)count);
+
+    ssize_t sent = -1;
+    if (handoff_wait(sock, POLLOUT, timeout_ms) == 0) {
+        do {
+            sent = sendmsg(sock, &msg, HANDOFF_SEND_FLAGS);
+        } while (sent < 0 && errno == EINTR);
+    }
+    if (sent != (ssize_t)sizeof(message)) {
+        LOG_SERVER_WARN("Listener handoff not sent: %s", sent < 0 ? strerror(errno) : "short write");
+        close(sock);
+        return -1;
+    }
+
+    char ack = 0;
+    ssize_t received = -1;
+    if (handoff_wait(sock, POLLIN, timeout_ms) == 0) {
+        do {
+            received = recv(sock, &ack, 1, 0);
+        } while (received < 0 && errno == EINTR);
+    }
+    close(sock);
+    if (received != 1 || ack != HANDOFF_ACK) {
+        LOG_SERVER_WARN("Successor did not confirm the listener handoff; still serving");
+        return -1;
+    }
+    return 0;
+}
+
+void catzilla_handoff_close(int listen_fd, const char* path, uint64_t inode) {
+    if (listen_fd < 0) return;
+    close(listen_fd);
+
+    struct stat st;
+    if (path && stat(path, &st) == 0 && (uint64_t)st.st_ino == inode) {
+        unlink(path);
+    }
+}
+
+#endif
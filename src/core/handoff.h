@@ -0,0 +1,90 @@
+/*
+ * Catzilla Listener Handoff - zero-downtime reloads
+ *
+ * A server with a handoff socket binds a Unix socket next to its TCP port.
+ * A successor started for a reload connects to it before binding anything
+ * and is sent every listening socket of the running server in one
+ * SCM_RIGHTS message; it answers with one byte once it holds them. Only
+ * then does the old server stop accepting and drain, so the sockets, and
+ * the connections waiting in their accept queues, are never closed in
+ * between. Not available on Windows.
+ */
+
+#ifndef CATZILLA_HANDOFF_H
+#define CATZILLA_HANDOFF_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Listening sockets one handoff carries at most (one per event loop)
+#define CATZILLA_HANDOFF_MAX_FDS 64
+
+// How long a successor waits for the listening sockets; the running server
+// writes its cache snapshots first, so this is generous
+#define CATZILLA_HANDOFF_TIMEOUT_MS 10000
+
+// How long the running server waits for a successor's answer
+#define CATZILLA_HANDOFF_ACK_TIMEOUT_MS 1000
+
+/**
+ * Ask the server listening on a handoff socket for its listening sockets.
+ * The received descriptors are close-on-exec and belong to the caller.
+ * @param path Handoff socket of the running server
+ * @param fds Receives the listening sockets
+ * @param max_fds Capacity of fds; a server offering more is refused
+ * @param timeout_ms Longest wait for the server's answer
+ * @return Number of sockets received, 0 when no server listens on path (a
+ *         stale socket file left by a crashed one is removed), -1 on error
+ */
+int catzilla_handoff_request(const char* path, int* fds, int max_fds, int timeout_ms);
+
+/**
+ * Bind a handoff socket for the next successor, replacing any file at path.
+ * The socket is readable to the owner only and does not block.
+ * @param path Socket file
+ * @param inode Receives an identity of the file, for catzilla_handoff_close
+ * @return Listening descriptor, or -1 on error
+ */
+int catzilla_handoff_listen(const char* path, uint64_t* inode);
+
+/**
+ * Accept a successor waiting on a handoff socket. Peers running as another
+ * user are turned away where the platform can tell.
+ * @param listen_fd Descriptor from catzilla_handoff_listen
+ * @return Connected descriptor for catzilla_handoff_send, -1 with errno
+ *         EAGAIN when nobody is waiting, -1 on any other error
+ */
+int catzilla_handoff_accept(int listen_fd);
+
+/**
+ * Hand the listening sockets to an accepted successor and close the
+ * connection to it. The caller keeps its descriptors; once this returns 0
+ * the successor holds its own copies, and the caller should close its
+ * listeners.
+ * @param peer_fd Descriptor from catzilla_handoff_accept
+ * @param fds Listening sockets to send
+ * @param count Number of sockets (1 to CATZILLA_HANDOFF_MAX_FDS)
+ * @param timeout_ms Longest wait for the successor's answer
+ * @return 0 once the successor took the sockets, -1 if the handoff failed
+ *         (the caller keeps serving)
+ */
+int catzilla_handoff_send(int peer_fd, const int* fds, int count, int timeout_ms);
+
+/**
+ * Close a handoff socket, removing its file unless a successor already
+ * bound its own socket at the same path
+ * @param listen_fd Descriptor from catzilla_handoff_listen
+ * @param path Socket file it was bound to
+ * @param inode Identity returned by catzilla_handoff_listen
+ */
+void catzilla_handoff_close(int listen_fd, const char* path, uint64_t inode);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CATZILLA_HANDOFF_H
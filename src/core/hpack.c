@@ -0,0 +1,507 @@
+#include "hpack.h"
+#include "memory.h"
+#include <string.h>
+
+typedef struct {
+    const char* name;
+    const char* value;
+    uint8_t name_length;
+    uint8_t value_length;
+} hpack_static_entry_t;
+
+#define HPACK_STATIC(name, value) { name, value, sizeof(name) - 1, sizeof(value) - 1 }
+
+// RFC 7541 Appendix A
+static const hpack_static_entry_t hpack_static_table[CATZILLA_HPACK_STATIC_COUNT] = {
+    HPACK_STATIC(":authority", ""),
+    HPACK_STATIC(":method", "GET"),
+    HPACK_STATIC(":method", "POST"),
+    HPACK_STATIC(":path", "/"),
+    HPACK_STATIC(":path", "/index.html"),
+    HPACK_STATIC(":scheme", "http"),
+    HPACK_STATIC(":scheme", "https"),
+    HPACK_STATIC(":status", "200"),
+    HPACK_STATIC(":status", "204"),
+    HPACK_STATIC(":status", "206"),
+    HPACK_STATIC(":status", "304"),
+    HPACK_STATIC(":status", "400"),
+    HPACK_STATIC(":status", "404"),
+    HPACK_STATIC(":status", "500"),
+    HPACK_STATIC("accept-charset", ""),
+    HPACK_STATIC("accept-encoding", "gzip, deflate"),
+    HPACK_STATIC("accept-language", ""),
+    HPACK_STATIC("accept-ranges", ""),
+    HPACK_STATIC("accept", ""),
+    HPACK_STATIC("access-control-allow-origin", ""),
+    HPACK_STATIC("age", ""),
+    HPACK_STATIC("allow", ""),
+    HPACK_STATIC("authorization", ""),
+    HPACK_STATIC("cache-control", ""),
+    HPACK_STATIC("content-disposition", ""),
+    HPACK_STATIC("content-encoding", ""),
+    HPACK_STATIC("content-language", ""),
+    HPACK_STATIC("content-length", ""),
+    HPACK_STATIC("content-location", ""),
+    HPACK_STATIC("content-range", ""),
+    HPACK_STATIC("content-type", ""),
+    HPACK_STATIC("cookie", ""),
+    HPACK_STATIC("date", ""),
+    HPACK_STATIC("etag", ""),
+    HPACK_STATIC("expect", ""),
+    HPACK_STATIC("expires", ""),
+    HPACK_STATIC("from", ""),
+    HPACK_STATIC("host", ""),
+    HPACK_STATIC("if-match", ""),
+    HPACK_STATIC("if-modified-since", ""),
+    HPACK_STATIC("if-none-match", ""),
+    HPACK_STATIC("if-range", ""),
+    HPACK_STATIC("if-unmodified-since", ""),
+    HPACK_STATIC("last-modified", ""),
+    HPACK_STATIC("link", ""),
+    HPACK_STATIC("location", ""),
+    HPACK_STATIC("max-forwards", ""),
+    HPACK_STATIC("proxy-authenticate", ""),
+    HPACK_STATIC("proxy-authorization", ""),
+    HPACK_STATIC("range", ""),
+    HPACK_STATIC("referer", ""),
+    HPACK_STATIC("refresh", ""),
+    HPACK_STATIC("retry-after", ""),
+    HPACK_STATIC("server", ""),
+    HPACK_STATIC("set-cookie", ""),
+    HPACK_STATIC("strict-transport-security", ""),
+    HPACK_STATIC("transfer-encoding", ""),
+    HPACK_STATIC("user-agent", ""),
+    HPACK_STATIC("vary", ""),
+    HPACK_STATIC("via", ""),
+    HPACK_STATIC("www-authenticate", ""),
+};
+
+/*
+ * The RFC 7541 Huffman code is canonical: within one code length the codes
+ * are consecutive and ordered by symbol. Decoding therefore needs only the
+ * first code and symbol count of every length plus the symbols sorted by
+ * (length, code), instead of a 257-entry tree or a large state table.
+ */
+typedef struct {
+    uint8_t length;
+    uint32_t first_code;
+    uint16_t count;
+    uint16_t offset;  // Index of the first symbol of this length in huffman_symbols
+} huffman_length_t;
+
+static const huffman_length_t huffman_lengths[] = {
+    { 5, 0x0, 10, 0 },
+    { 6, 0x14, 26, 10 },
+    { 7, 0x5c, 32, 36 },
+    { 8, 0xf8, 6, 68 },
+    { 10, 0x3f8, 5, 74 },
+    { 11, 0x7fa, 3, 79 },
+    { 12, 0xffa, 2, 82 },
+    { 13, 0x1ff8, 6, 84 },
+    { 14, 0x3ffc, 2, 90 },
+    { 15, 0x7ffc, 3, 92 },
+    { 19, 0x7fff0, 3, 95 },
+    { 20, 0xfffe6, 8, 98 },
+    { 21, 0x1fffdc, 13, 106 },
+    { 22, 0x3fffd2, 26, 119 },
+    { 23, 0x7fffd8, 29, 145 },
+    { 24, 0xffffea, 12, 174 },
+    { 25, 0x1ffffec, 4, 186 },
+    { 26, 0x3ffffe0, 15, 190 },
+    { 27, 0x7ffffde, 19, 205 },
+    { 28, 0xfffffe2, 29, 224 },
+    { 30, 0x3ffffffc, 4, 253 },
+};
+
+#define HUFFMAN_LENGTH_COUNT (sizeof(huffman_lengths) / sizeof(huffman_lengths[0]))
+#define HUFFMAN_EOS 256
+
+static const uint16_t huffman_symbols[257] = {
+    48, 49, 50, 97, 99, 101, 105, 111, 115, 116, 32, 37,
+    45, 46, 47, 51, 52, 53, 54, 55, 56, 57, 61, 65,
+    95, 98, 100, 102, 103, 104, 108, 109, 110, 112, 114, 117,
+    58, 66, 67, 68, 69, 70, 71, 72, 73, 74, 75, 76,
+    77, 78, 79, 80, 81, 82, 83, 84, 85, 86, 87, 89,
+    106, 107, 113, 118, 119, 120, 121, 122, 38, 42, 44, 59,
+    88, 90, 33, 34, 40, 41, 63, 39, 43, 124, 35, 62,
+    0, 36, 64, 91, 93, 126, 94, 125, 60, 96, 123, 92,
+    195, 208, 128, 130, 131, 162, 184, 194, 224, 226, 153, 161,
+    167, 172, 176, 177, 179, 209, 216, 217, 227, 229, 230, 129,
+    132, 133, 134, 136, 146, 154, 156, 160, 163, 164, 169, 170,
+    173, 178, 181, 185, 186, 187, 189, 190, 196, 198, 228, 232,
+    233, 1, 135, 137, 138, 139, 140, 141, 143, 147, 149, 150,
+    151, 152, 155, 157, 158, 165, 166, 168, 174, 175, 180, 182,
+    183, 188, 191, 197, 231, 239, 9, 142, 144, 145, 148, 159,
+    171, 206, 215, 225, 236, 237, 199, 207, 234, 235, 192, 193,
+    200, 201, 202, 205, 210, 213, 218, 219, 238, 240, 242, 243,
+    255, 203, 204, 211, 212, 214, 221, 222, 223, 241, 244, 245,
+    246, 247, 248, 250, 251, 252, 253, 254, 2, 3, 4, 5,
+    6, 7, 8, 11, 12, 14, 15, 16, 17, 18, 19, 20,
+    21, 23, 24, 25, 26, 27, 28, 29, 30, 31, 127, 220,
+    249, 10, 13, 22, 256
+};
+
+void catzilla_hpack_decoder_init(catzilla_hpack_decoder_t* decoder, size_t max_table_size) {
+    if (!decoder) return;
+    memset(decoder, 0, sizeof(*decoder));
+    if (max_table_size > CATZILLA_HPACK_DEFAULT_TABLE_SIZE) {
+        max_table_size = CATZILLA_HPACK_DEFAULT_TABLE_SIZE;
+    }
+    decoder->max_size = max_table_size;
+    decoder->settings_size = max_table_size;
+}
+
+static void hpack_evict_oldest(catzilla_hpack_decoder_t* decoder) {
+    catzilla_hpack_entry_t* entry = &decoder->entries[decoder->start];
+    decoder->size -= entry->name_length + entry->value_length + CATZILLA_HPACK_ENTRY_OVERHEAD;
+    catzilla_cache_free(entry->name);
+    memset(entry, 0, sizeof(*entry));
+    decoder->start = (decoder->start + 1) % CATZILLA_HPACK_MAX_ENTRIES;
+    decoder->count--;
+}
+
+static void hpack_evict_to(catzilla_hpack_decoder_t* decoder, size_t limit) {
+    while (decoder->count > 0 && decoder->size > limit) {
+        hpack_evict_oldest(decoder);
+    }
+}
+
+void catzilla_hpack_decoder_free(catzilla_hpack_decoder_t* decoder) {
+    if (!decoder) return;
+    hpack_evict_to(decoder, 0);
+    catzilla_cache_free(decoder->name_scratch);
+    catzilla_cache_free(decoder->value_scratch);
+    decoder->name_scratch = NULL;
+    decoder->value_scratch = NULL;
+    decoder->name_scratch_size = 0;
+    decoder->value_scratch_size = 0;
+}
+
+int catzilla_hpack_decode_integer(const uint8_t** pos, const uint8_t* end,
+                                  int prefix_bits, uint32_t* value_out) {
+    const uint8_t* p = *pos;
+    if (p >= end || prefix_bits < 1 || prefix_bits > 8) return -1;
+
+    uint32_t mask = (1u << prefix_bits) - 1;
+    uint64_t value = *p++ & mask;
+    if (value == mask) {
+        int shift = 0;
+        uint8_t byte;
+        do {
+            if (p >= end || shift > 28) return -1;
+            byte = *p++;
+            value += (uint64_t)(byte & 0x7f) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+        if (value > UINT32_MAX) return -1;
+    }
+
+    *pos = p;
+    *value_out = (uint32_t)value;
+    return 0;
+}
+
+int catzilla_hpack_huffman_decode(const uint8_t* src, size_t length,
+                                  char* dst, size_t dst_size, size_t* length_out) {
+    uint32_t code = 0;
+    unsigned int bits = 0;
+    size_t level = 0;
+    size_t out = 0;
+
+    for (size_t i = 0; i < length; i++) {
+        for (int bit = 7; bit >= 0; bit--) {
+            code = (code << 1) | ((src[i] >> bit) & 1u);
+            bits++;
+
+            const huffman_length_t* entry = &huffman_lengths[level];
+            if (entry->length != bits) continue;
+
+            uint32_t delta = code - entry->first_code;
+            if (code >= entry->first_code && delta < entry->count) {
+                uint16_t symbol = huffman_symbols[entry->offset + delta];
+                if (symbol == HUFFMAN_EOS || out >= dst_size) return -1;
+                dst[out++] = (char)symbol;
+                code = 0;
+                bits = 0;
+                level = 0;
+                continue;
+            }
+
+            // Prefix of a longer code
+            if (++level >= HUFFMAN_LENGTH_COUNT) return -1;
+        }
+    }
+
+    // Padding is at most 7 bits, all ones (the most significant bits of EOS)
+    if (bits > 7 || code != (1u << bits) - 1) return -1;
+
+    *length_out = out;
+    return 0;
+}
+
+static int hpack_reserve_scratch(char** buffer, size_t* size, size_t needed) {
+    if (needed <= *size) return 0;
+    char* grown = catzilla_cache_realloc(*buffer, needed);
+    if (!grown) return -1;
+    *buffer = grown;
+    *size = needed;
+    return 0;
+}
+
+// String literal (RFC 7541 5.2); Huffman-coded strings land in scratch space
+static int hpack_decode_string(const uint8_t** pos, const uint8_t* end,
+                               char** scratch, size_t* scratch_size,
+                               const char** str_out, size_t* length_out) {
+    if (*pos >= end) return -1;
+    int huffman = (**pos & 0x80) != 0;
+
+    uint32_t length;
+    if (catzilla_hpack_decode_integer(pos, end, 7, &length) != 0) return -1;
+    if (length > CATZILLA_HPACK_MAX_STRING || (size_t)(end - *pos) < length) return -1;
+
+    if (!huffman) {
+        *str_out = (const char*)*pos;
+        *length_out = length;
+        *pos += length;
+        return 0;
+    }
+
+    // Shortest codes are 5 bits, so the output is at most 8/5 of the input
+    size_t capacity = (size_t)length * 8 / 5 + 1;
+    if (hpack_reserve_scratch(scratch, scratch_size, capacity) != 0) return -1;
+    if (catzilla_hpack_huffman_decode(*pos, length, *scratch, capacity, length_out) != 0) return -1;
+    *str_out = *scratch;
+    *pos += length;
+    return 0;
+}
+
+static int hpack_lookup(const catzilla_hpack_decoder_t* decoder, uint32_t index,
+                        const char** name, size_t* name_length,
+                        const char** value, size_t* value_length) {
+    if (index == 0) return -1;
+
+    if (index <= CATZILLA_HPACK_STATIC_COUNT) {
+        const hpack_static_entry_t* entry = &hpack_static_table[index - 1];
+        *name = entry->name;
+        *name_length = entry->name_length;
+        *value = entry->value;
+        *value_length = entry->value_length;
+        return 0;
+    }
+
+    uint32_t dynamic_index = index - CATZILLA_HPACK_STATIC_COUNT - 1;  // 0 = newest
+    if (dynamic_index >= (uint32_t)decoder->count) return -1;
+
+    int slot = (decoder->start + decoder->count - 1 - (int)dynamic_index) % CATZILLA_HPACK_MAX_ENTRIES;
+    const catzilla_hpack_entry_t* entry = &decoder->entries[slot];
+    *name = entry->name;
+    *name_length = entry->name_length;
+    *value = entry->value;
+    *value_length = entry->value_length;
+    return 0;
+}
+
+// Add a field to the dynamic table (RFC 7541 4.4). The copy is made before
+// evicting so a name referring to an evicted entry stays valid. Returns 0 when
+// stored, 1 when the field is larger than the whole table and only the copy in
+// *entry_out exists (the caller frees it), -1 on allocation failure.
+static int hpack_insert(catzilla_hpack_decoder_t* decoder,
+                        const char* name, size_t name_length,
+                        const char* value, size_t value_length,
+                        catzilla_hpack_entry_t* entry_out) {
+    char* block = catzilla_cache_alloc(name_length + value_length + 2);
+    if (!block) return -1;
+
+    memcpy(block, name, name_length);
+    block[name_length] = '\0';
+    memcpy(block + name_length + 1, value, value_length);
+    block[name_length + 1 + value_length] = '\0';
+
+    entry_out->name = block;
+    entry_out->name_length = (uint32_t)name_length;
+    entry_out->value = block + name_length + 1;
+    entry_out->value_length = (uint32_t)value_length;
+
+    size_t entry_size = name_length + value_length + CATZILLA_HPACK_ENTRY_OVERHEAD;
+    if (entry_size > decoder->max_size) {
+        // Oversized entries empty the table and are not stored
+        hpack_evict_to(decoder, 0);
+        return 1;
+    }
+
+    hpack_evict_to(decoder, decoder->max_size - entry_size);
+    int slot = (decoder->start + decoder->count) % CATZILLA_HPACK_MAX_ENTRIES;
+    decoder->entries[slot] = *entry_out;
+    decoder->count++;
+    decoder->size += entry_size;
+    return 0;
+}
+
+int catzilla_hpack_decode(catzilla_hpack_decoder_t* decoder,
+                          const uint8_t* data, size_t length,
+                          catzilla_hpack_emit_fn emit, void* user_data) {
+    if (!decoder || (!data && length > 0) || !emit) return -1;
+
+    const uint8_t* pos = data;
+    const uint8_t* end = data + length;
+    int fields = 0;
+
+    while (pos < end) {
+        uint8_t lead = *pos;
+        const char* name = NULL;
+        const char* value = NULL;
+        size_t name_length = 0;
+        size_t value_length = 0;
+        uint32_t index;
+
+        if (lead & 0x80) {
+            // Indexed header field
+            if (catzilla_hpack_decode_integer(&pos, end, 7, &index) != 0 ||
+                hpack_lookup(decoder, index, &name, &name_length, &value, &value_length) != 0) {
+                return -1;
+            }
+            if (emit(user_data, name, name_length, value, value_length) != 0) return -1;
+            fields++;
+            continue;
+        }
+
+        if ((lead & 0xe0) == 0x20) {
+            // Dynamic table size update, only before the first field
+            if (fields > 0 || catzilla_hpack_decode_integer(&pos, end, 5, &index) != 0 ||
+                index > decoder->settings_size) {
+                return -1;
+            }
+            decoder->max_size = index;
+            hpack_evict_to(decoder, decoder->max_size);
+            continue;
+        }
+
+        // Literal: with incremental indexing (6-bit prefix), without indexing
+        // or never indexed (4-bit prefix)
+        int incremental = (lead & 0xc0) == 0x40;
+        if (catzilla_hpack_decode_integer(&pos, end, incremental ? 6 : 4, &index) != 0) return -1;
+
+        if (index > 0) {
+            const char* unused_value;
+            size_t unused_length;
+            if (hpack_lookup(decoder, index, &name, &name_length, &unused_value, &unused_length) != 0) {
+                return -1;
+            }
+        } else if (hpack_decode_string(&pos, end, &decoder->name_scratch, &decoder->name_scratch_size,
+                                       &name, &name_length) != 0) {
+            return -1;
+        }
+
+        if (hpack_decode_string(&pos, end, &decoder->value_scratch, &decoder->value_scratch_size,
+                                &value, &value_length) != 0) {
+            return -1;
+        }
+
+        int rc;
+        if (incremental) {
+            catzilla_hpack_entry_t entry;
+            int inserted = hpack_insert(decoder, name, name_length, value, value_length, &entry);
+            if (inserted < 0) return -1;
+            rc = emit(user_data, entry.name, entry.name_length, entry.value, entry.value_length);
+            if (inserted > 0) {
+                catzilla_cache_free(entry.name);
+            }
+        } else {
+            rc = emit(user_data, name, name_length, value, value_length);
+        }
+        if (rc != 0) return -1;
+        fields++;
+    }
+
+    return 0;
+}
+
+static size_t hpack_encode_integer(uint8_t* out, uint32_t value, int prefix_bits, uint8_t flags) {
+    uint32_t mask = (1u << prefix_bits) - 1;
+    if (value < mask) {
+        out[0] = flags | (uint8_t)value;
+        return 1;
+    }
+
+    size_t written = 0;
+    out[written++] = flags | (uint8_t)mask;
+    value -= mask;
+    while (value >= 0x80) {
+        out[written++] = (uint8_t)((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+    out[written++] = (uint8_t)value;
+    return written;
+}
+
+size_t catzilla_hpack_encoded_size_bound(size_t name_length, size_t value_length) {
+    // Name index or name length, plus value length, each at most 6 bytes
+    return name_length + value_length + 18;
+}
+
+size_t catzilla_hpack_encode_status(uint8_t* out, int status) {
+    switch (status) {
+        case 200: out[0] = 0x80 | 8; return 1;
+        case 204: out[0] = 0x80 | 9; return 1;
+        case 206: out[0] = 0x80 | 10; return 1;
+        case 304: out[0] = 0x80 | 11; return 1;
+        case 400: out[0] = 0x80 | 12; return 1;
+        case 404: out[0] = 0x80 | 13; return 1;
+        case 500: out[0] = 0x80 | 14; return 1;
+        default: break;
+    }
+
+    if (status < 100 || status > 999) status = 500;
+
+    // Literal without indexing, name from static entry 8 (:status)
+    out[0] = 0x08;
+    out[1] = 3;
+    out[2] = (uint8_t)('0' + status / 100);
+    out[3] = (uint8_t)('0' + (status / 10) % 10);
+    out[4] = (uint8_t)('0' + status % 10);
+    return 5;
+}
+
+static int hpack_static_name_index(const char* name, size_t name_length) {
+    // Only regular header names (entry 15 onward); pseudo-headers are encoded separately
+    for (int i = 14; i < CATZILLA_HPACK_STATIC_COUNT; i++) {
+        const hpack_static_entry_t* entry = &hpack_static_table[i];
+        if (entry->name_length != name_length) continue;
+
+        size_t j = 0;
+        while (j < name_length && (char)(name[j] | 0x20) == entry->name[j]) {
+            j++;
+        }
+        if (j == name_length) return i + 1;
+    }
+    return 0;
+}
+
+size_t catzilla_hpack_encode_header(uint8_t* out, size_t out_size,
+                                    const char* name, size_t name_length,
+                                    const char* value, size_t value_length) {
+    if (!out || !name || out_size < catzilla_hpack_encoded_size_bound(name_length, value_length)) {
+        return 0;
+    }
+
+    size_t written;
+    int index = hpack_static_name_index(name, name_length);
+    if (index > 0) {
+        written = hpack_encode_integer(out, (uint32_t)index, 4, 0x00);
+    } else {
+        out[0] = 0x00;
+        written = 1;
+        written += hpack_encode_integer(out + written, (uint32_t)name_length, 7, 0x00);
+        for (size_t i = 0; i < name_length; i++) {
+            char c = name[i];
+            out[written++] = (uint8_t)((c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c);
+        }
+    }
+
+    written += hpack_encode_integer(out + written, (uint32_t)value_length, 7, 0x00);
+    if (value_length > 0) {
+        memcpy(out + written, value, value_length);
+        written += value_length;
+    }
+    return written;
+}
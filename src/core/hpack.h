@@ -0,0 +1,147 @@
+#ifndef CATZILLA_HPACK_H
+#define CATZILLA_HPACK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// HPACK (RFC 7541) header compression for HTTP/2 connections
+
+// SETTINGS_HEADER_TABLE_SIZE default, and the largest table a peer may ask for
+#define CATZILLA_HPACK_DEFAULT_TABLE_SIZE 4096
+
+// Entries in the static table (indices 1..61)
+#define CATZILLA_HPACK_STATIC_COUNT 61
+
+// Every entry costs at least 32 bytes, which bounds the dynamic table's entry count
+#define CATZILLA_HPACK_ENTRY_OVERHEAD 32
+#define CATZILLA_HPACK_MAX_ENTRIES (CATZILLA_HPACK_DEFAULT_TABLE_SIZE / CATZILLA_HPACK_ENTRY_OVERHEAD)
+
+// Longest decoded name or value accepted from a peer
+#define CATZILLA_HPACK_MAX_STRING (64 * 1024)
+
+/**
+ * One dynamic table entry; name and value share a single allocation and are
+ * NUL terminated
+ */
+typedef struct {
+    char* name;
+    char* value;
+    uint32_t name_length;
+    uint32_t value_length;
+} catzilla_hpack_entry_t;
+
+/**
+ * Decoder state of one connection: the dynamic table as a ring (oldest entry
+ * at start) plus scratch space for Huffman-coded strings
+ */
+typedef struct catzilla_hpack_decoder_s {
+    catzilla_hpack_entry_t entries[CATZILLA_HPACK_MAX_ENTRIES];
+    int start;
+    int count;
+    size_t size;            // Sum of entry sizes as defined by RFC 7541 4.1
+    size_t max_size;        // Current limit, changed by dynamic table size updates
+    size_t settings_size;   // Upper bound we advertised in SETTINGS
+    char* name_scratch;
+    char* value_scratch;
+    size_t name_scratch_size;
+    size_t value_scratch_size;
+} catzilla_hpack_decoder_t;
+
+/**
+ * Receives one decoded header field. Pointers are valid only during the call.
+ * @return 0 to continue, non-zero to abort decoding
+ */
+typedef int (*catzilla_hpack_emit_fn)(void* user_data,
+                                      const char* name, size_t name_length,
+                                      const char* value, size_t value_length);
+
+/**
+ * Initialize a decoder
+ * @param decoder Decoder
+ * @param max_table_size Table size advertised to the peer (at most CATZILLA_HPACK_DEFAULT_TABLE_SIZE)
+ */
+void catzilla_hpack_decoder_init(catzilla_hpack_decoder_t* decoder, size_t max_table_size);
+
+/**
+ * Free the dynamic table and scratch buffers
+ * @param decoder Decoder
+ */
+void catzilla_hpack_decoder_free(catzilla_hpack_decoder_t* decoder);
+
+/**
+ * Decode a complete header block, updating the dynamic table
+ * @param decoder Decoder
+ * @param data Header block (all HEADERS/CONTINUATION fragments joined)
+ * @param length Block length
+ * @param emit Called once per header field, in order
+ * @param user_data Passed to emit
+ * @return 0 on success, -1 on a compression error (the connection must be closed)
+ */
+int catzilla_hpack_decode(catzilla_hpack_decoder_t* decoder,
+                          const uint8_t* data, size_t length,
+                          catzilla_hpack_emit_fn emit, void* user_data);
+
+/**
+ * Decode an integer with an N-bit prefix (RFC 7541 5.1)
+ * @param pos Cursor, advanced past the integer
+ * @param end End of input
+ * @param prefix_bits Prefix size, 1 to 8
+ * @param value_out Receives the value
+ * @return 0 on success, -1 on truncated input or overflow
+ */
+int catzilla_hpack_decode_integer(const uint8_t** pos, const uint8_t* end,
+                                  int prefix_bits, uint32_t* value_out);
+
+/**
+ * Decode a Huffman-coded string (RFC 7541 Appendix B)
+ * @param src Coded bytes
+ * @param length Number of coded bytes
+ * @param dst Output buffer (length * 8 / 5 bytes always suffice)
+ * @param dst_size Output buffer size
+ * @param length_out Receives the decoded length
+ * @return 0 on success, -1 on invalid coding or a full output buffer
+ */
+int catzilla_hpack_huffman_decode(const uint8_t* src, size_t length,
+                                  char* dst, size_t dst_size, size_t* length_out);
+
+/**
+ * Upper bound of the bytes catzilla_hpack_encode_header writes for one field
+ * @param name_length Name length
+ * @param value_length Value length
+ * @return Byte count
+ */
+size_t catzilla_hpack_encoded_size_bound(size_t name_length, size_t value_length);
+
+/**
+ * Encode :status, using the static table entry when there is one
+ * @param out Output buffer with room for at least 5 bytes
+ * @param status HTTP status code
+ * @return Bytes written
+ */
+size_t catzilla_hpack_encode_status(uint8_t* out, int status);
+
+/**
+ * Encode a header field as a literal without indexing. The name is lowercased
+ * and refers to the static table when it has a matching name. Responses never
+ * touch the peer's dynamic table, so no encoder state is needed.
+ * @param out Output buffer
+ * @param out_size Output buffer size
+ * @param name Header name (any case)
+ * @param name_length Name length
+ * @param value Header value
+ * @param value_length Value length
+ * @return Bytes written, or 0 if the buffer is too small
+ */
+size_t catzilla_hpack_encode_header(uint8_t* out, size_t out_size,
+                                    const char* name, size_t name_length,
+                                    const char* value, size_t value_length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CATZILLA_HPACK_H
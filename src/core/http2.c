@@ -0,0 +1,899 @@
+#include "http2.h"
+#include "memory.h"
+#include "logging.h"
+#include <string.h>
+
+// Frame types (RFC 9113 6)
+#define H2_FRAME_DATA 0x0
+#define H2_FRAME_HEADERS 0x1
+#define H2_FRAME_PRIORITY 0x2
+#define H2_FRAME_RST_STREAM 0x3
+#define H2_FRAME_SETTINGS 0x4
+#define H2_FRAME_PUSH_PROMISE 0x5
+#define H2_FRAME_PING 0x6
+#define H2_FRAME_GOAWAY 0x7
+#define H2_FRAME_WINDOW_UPDATE 0x8
+#define H2_FRAME_CONTINUATION 0x9
+
+// Frame flags
+#define H2_FLAG_END_STREAM 0x1
+#define H2_FLAG_ACK 0x1
+#define H2_FLAG_END_HEADERS 0x4
+#define H2_FLAG_PADDED 0x8
+#define H2_FLAG_PRIORITY 0x20
+
+// SETTINGS identifiers
+#define H2_SETTINGS_HEADER_TABLE_SIZE 0x1
+#define H2_SETTINGS_ENABLE_PUSH 0x2
+#define H2_SETTINGS_MAX_CONCURRENT_STREAMS 0x3
+#define H2_SETTINGS_INITIAL_WINDOW_SIZE 0x4
+#define H2_SETTINGS_MAX_FRAME_SIZE 0x5
+#define H2_SETTINGS_MAX_HEADER_LIST_SIZE 0x6
+
+#define H2_MAX_FRAME_SIZE_LIMIT 16777215
+
+// Receive windows are topped up once half of them has been consumed
+#define H2_WINDOW_UPDATE_THRESHOLD (CATZILLA_H2_DEFAULT_WINDOW / 2)
+
+// Response header blocks up to this size are encoded on the stack
+#define H2_HEADER_BLOCK_STACK 2048
+
+struct catzilla_h2_stream_s {
+    uint32_t id;
+    catzilla_header_set_t headers;
+    char method[CATZILLA_H2_METHOD_MAX];
+    char path[CATZILLA_H2_PATH_MAX];
+    bool has_method;
+    bool has_path;
+    bool has_scheme;
+    bool malformed;
+    bool end_stream_received;
+    bool ready;
+    bool responded;
+
+    char* body;
+    size_t body_length;
+    size_t body_capacity;
+    bool body_rejected;
+    uint32_t recv_consumed;
+
+    // Response body still waiting for flow-control credit
+    int64_t send_window;
+    char* pending;
+    size_t pending_length;
+    size_t pending_offset;
+
+    catzilla_h2_stream_t* next_ready;
+};
+
+typedef struct {
+    catzilla_h2_stream_t* stream;  // NULL while a refused or closed stream's block is skipped
+    bool regular_seen;
+} h2_decode_state_t;
+
+static void h2_flush(catzilla_h2_session_t* session);
+static void h2_flush_stream(catzilla_h2_session_t* session, catzilla_h2_stream_t* stream);
+
+bool catzilla_h2_is_preface(const char* data, size_t length) {
+    if (!data || length < 4) return false;
+    size_t compare = length < CATZILLA_H2_PREFACE_LEN ? length : CATZILLA_H2_PREFACE_LEN;
+    return memcmp(data, CATZILLA_H2_PREFACE, compare) == 0;
+}
+
+static uint32_t h2_read_u32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static int h2_reserve(char** buffer, size_t* capacity, size_t needed) {
+    if (needed <= *capacity) return 0;
+    size_t grown = *capacity ? *capacity : 1024;
+    while (grown < needed) grown *= 2;
+    char* data = catzilla_cache_realloc(*buffer, grown);
+    if (!data) return -1;
+    *buffer = data;
+    *capacity = grown;
+    return 0;
+}
+
+static int h2_output_append(catzilla_h2_session_t* session, const void* data, size_t length) {
+    if (h2_reserve(&session->output, &session->output_capacity, session->output_length + length) != 0) {
+        return -1;
+    }
+    memcpy(session->output + session->output_length, data, length);
+    session->output_length += length;
+    return 0;
+}
+
+static int h2_write_frame(catzilla_h2_session_t* session, uint8_t type, uint8_t flags,
+                          uint32_t stream_id, const void* payload, size_t length) {
+    uint8_t header[CATZILLA_H2_FRAME_HEADER_LEN] = {
+        (uint8_t)(length >> 16), (uint8_t)(length >> 8), (uint8_t)length,
+        type, flags,
+        (uint8_t)((stream_id >> 24) & 0x7f), (uint8_t)(stream_id >> 16),
+        (uint8_t)(stream_id >> 8), (uint8_t)stream_id
+    };
+    if (h2_output_append(session, header, sizeof(header)) != 0) return -1;
+    if (length > 0 && h2_output_append(session, payload, length) != 0) return -1;
+    return 0;
+}
+
+static void h2_write_u32_frame(catzilla_h2_session_t* session, uint8_t type, uint32_t stream_id, uint32_t value) {
+    uint8_t payload[4] = { (uint8_t)(value >> 24), (uint8_t)(value >> 16), (uint8_t)(value >> 8), (uint8_t)value };
+    h2_write_frame(session, type, 0, stream_id, payload, sizeof(payload));
+}
+
+// Queue GOAWAY; the connection closes once it has been written
+static int h2_connection_error(catzilla_h2_session_t* session, uint32_t error_code) {
+    if (!session->goaway_sent) {
+        LOG_HTTP_DEBUG("HTTP/2 connection error 0x%x", error_code);
+        uint8_t payload[8];
+        uint32_t last = session->last_stream_id;
+        payload[0] = (uint8_t)((last >> 24) & 0x7f);
+        payload[1] = (uint8_t)(last >> 16);
+        payload[2] = (uint8_t)(last >> 8);
+        payload[3] = (uint8_t)last;
+        payload[4] = (uint8_t)(error_code >> 24);
+        payload[5] = (uint8_t)(error_code >> 16);
+        payload[6] = (uint8_t)(error_code >> 8);
+        payload[7] = (uint8_t)error_code;
+        h2_write_frame(session, H2_FRAME_GOAWAY, 0, 0, payload, sizeof(payload));
+        session->goaway_sent = true;
+    }
+    session->closed = true;
+    return -1;
+}
+
+static catzilla_h2_stream_t* h2_find_stream(const catzilla_h2_session_t* session, uint32_t stream_id) {
+    for (int i = 0; i < session->stream_count; i++) {
+        if (session->streams[i]->id == stream_id) {
+            return session->streams[i];
+        }
+    }
+    return NULL;
+}
+
+static void h2_unlink_ready(catzilla_h2_session_t* session, catzilla_h2_stream_t* stream) {
+    if (!stream->ready) return;
+
+    catzilla_h2_stream_t** link = &session->ready_head;
+    catzilla_h2_stream_t* previous = NULL;
+    while (*link && *link != stream) {
+        previous = *link;
+        link = &(*link)->next_ready;
+    }
+    if (*link) {
+        *link = stream->next_ready;
+        if (session->ready_tail == stream) {
+            session->ready_tail = previous;
+        }
+    }
+    stream->next_ready = NULL;
+    stream->ready = false;
+}
+
+static void h2_close_stream(catzilla_h2_session_t* session, catzilla_h2_stream_t* stream) {
+    for (int i = 0; i < session->stream_count; i++) {
+        if (session->streams[i] == stream) {
+            session->streams[i] = session->streams[--session->stream_count];
+            break;
+        }
+    }
+
+    h2_unlink_ready(session, stream);
+    catzilla_header_set_free(&stream->headers);
+    catzilla_request_free(stream->body);
+    catzilla_response_free(stream->pending);
+    catzilla_cache_free(stream);
+}
+
+static void h2_reset_stream(catzilla_h2_session_t* session, catzilla_h2_stream_t* stream, uint32_t error_code) {
+    h2_write_u32_frame(session, H2_FRAME_RST_STREAM, stream->id, error_code);
+    h2_close_stream(session, stream);
+}
+
+static catzilla_h2_stream_t* h2_open_stream(catzilla_h2_session_t* session, uint32_t stream_id) {
+    catzilla_h2_stream_t* stream = catzilla_cache_alloc(sizeof(*stream));
+    if (!stream) return NULL;
+
+    memset(stream, 0, sizeof(*stream));
+    stream->id = stream_id;
+    stream->send_window = session->peer_initial_window;
+    catzilla_header_set_init(&stream->headers);
+    session->streams[session->stream_count++] = stream;
+    return stream;
+}
+
+static void h2_mark_ready(catzilla_h2_session_t* session, catzilla_h2_stream_t* stream) {
+    stream->end_stream_received = true;
+    if (stream->ready || stream->responded) return;
+
+    stream->ready = true;
+    stream->next_ready = NULL;
+    if (session->ready_tail) {
+        session->ready_tail->next_ready = stream;
+    } else {
+        session->ready_head = stream;
+    }
+    session->ready_tail = stream;
+}
+
+catzilla_h2_session_t* catzilla_h2_session_create(catzilla_h2_request_fn on_request,
+                                                  catzilla_h2_send_fn send,
+                                                  void* user_data,
+                                                  uint64_t max_body_size) {
+    catzilla_h2_session_t* session = catzilla_cache_alloc(sizeof(*session));
+    if (!session) return NULL;
+
+    memset(session, 0, sizeof(*session));
+    catzilla_hpack_decoder_init(&session->decoder, CATZILLA_HPACK_DEFAULT_TABLE_SIZE);
+    session->on_request = on_request;
+    session->send = send;
+    session->user_data = user_data;
+    session->send_window = CATZILLA_H2_DEFAULT_WINDOW;
+    session->peer_initial_window = CATZILLA_H2_DEFAULT_WINDOW;
+    session->peer_max_frame_size = CATZILLA_H2_DEFAULT_FRAME_SIZE;
+    session->max_body_size = max_body_size;
+
+    // The server preface: our SETTINGS go out with the first flush
+    uint8_t settings[12] = {
+        0x00, H2_SETTINGS_MAX_CONCURRENT_STREAMS,
+        0x00, 0x00, 0x00, CATZILLA_H2_MAX_STREAMS,
+        0x00, H2_SETTINGS_MAX_HEADER_LIST_SIZE,
+        (uint8_t)(CATZILLA_HEADER_DATA_MAX >> 24), (uint8_t)(CATZILLA_HEADER_DATA_MAX >> 16),
+        (uint8_t)(CATZILLA_HEADER_DATA_MAX >> 8), (uint8_t)CATZILLA_HEADER_DATA_MAX
+    };
+    if (h2_write_frame(session, H2_FRAME_SETTINGS, 0, 0, settings, sizeof(settings)) != 0) {
+        catzilla_h2_session_free(session);
+        return NULL;
+    }
+    return session;
+}
+
+void catzilla_h2_session_free(catzilla_h2_session_t* session) {
+    if (!session) return;
+
+    while (session->stream_count > 0) {
+        h2_close_stream(session, session->streams[session->stream_count - 1]);
+    }
+    catzilla_hpack_decoder_free(&session->decoder);
+    catzilla_cache_free(session->input);
+    catzilla_cache_free(session->header_block);
+    catzilla_cache_free(session->output);
+    catzilla_cache_free(session);
+}
+
+int catzilla_h2_session_open_streams(const catzilla_h2_session_t* session) {
+    return session ? session->stream_count : 0;
+}
+
+// Store one decoded field on its stream, splitting off pseudo-headers
+static int h2_on_header_field(void* user_data, const char* name, size_t name_length,
+                              const char* value, size_t value_length) {
+    h2_decode_state_t* state = (h2_decode_state_t*)user_data;
+    catzilla_h2_stream_t* stream = state->stream;
+    if (!stream || stream->malformed) return 0;
+
+    if (name_length > 0 && name[0] == ':') {
+        // Pseudo-headers must precede regular ones (RFC 9113 8.3)
+        if (state->regular_seen) {
+            stream->malformed = true;
+        } else if (name_length == 7 && memcmp(name, ":method", 7) == 0) {
+            if (value_length == 0 || value_length >= CATZILLA_H2_METHOD_MAX) {
+                stream->malformed = true;
+            } else {
+                memcpy(stream->method, value, value_length);
+                stream->method[value_length] = '\0';
+                stream->has_method = true;
+            }
+        } else if (name_length == 5 && memcmp(name, ":path", 5) == 0) {
+            if (value_length == 0 || value_length >= CATZILLA_H2_PATH_MAX) {
+                stream->malformed = true;
+            } else {
+                memcpy(stream->path, value, value_length);
+                stream->path[value_length] = '\0';
+                stream->has_path = true;
+            }
+        } else if (name_length == 7 && memcmp(name, ":scheme", 7) == 0) {
+            stream->has_scheme = true;
+        } else if (name_length == 10 && memcmp(name, ":authority", 10) == 0) {
+            // Handlers look for the authority under Host, as in HTTP/1.1
+            if (catzilla_header_set_append_name(&stream->headers, "host", 4) != 0 ||
+                catzilla_header_set_append_value(&stream->headers, value, value_length) != 0) {
+                stream->malformed = true;
+            }
+            catzilla_header_set_commit(&stream->headers);
+        } else {
+            stream->malformed = true;
+        }
+        return 0;
+    }
+
+    state->regular_seen = true;
+    if (catzilla_header_set_append_name(&stream->headers, name, name_length) != 0 ||
+        (value_length > 0 && catzilla_header_set_append_value(&stream->headers, value, value_length) != 0)) {
+        stream->malformed = true;
+    }
+    catzilla_header_set_commit(&stream->headers);
+    return 0;
+}
+
+static int h2_complete_header_block(catzilla_h2_session_t* session) {
+    uint32_t stream_id = session->header_block_stream;
+    bool end_stream = session->header_block_end_stream;
+    const uint8_t* block = session->header_block;
+    size_t block_length = session->header_block_length;
+
+    session->header_block_stream = 0;
+    session->header_block_length = 0;
+
+    h2_decode_state_t state = { NULL, false };
+    catzilla_h2_stream_t* stream = h2_find_stream(session, stream_id);
+    bool trailers = false;
+    bool refuse = false;
+
+    if (stream) {
+        // A second block on an open stream carries trailers, which are dropped
+        if (stream->end_stream_received || !end_stream) {
+            return h2_connection_error(session, CATZILLA_H2_PROTOCOL_ERROR);
+        }
+        trailers = true;
+    } else {
+        if (stream_id <= session->last_stream_id) {
+            return h2_connection_error(session, CATZILLA_H2_STREAM_CLOSED);
+        }
+        session->last_stream_id = stream_id;
+
+        if (session->stream_count >= CATZILLA_H2_MAX_STREAMS) {
+            refuse = true;
+        } else {
+            stream = h2_open_stream(session, stream_id);
+            if (!stream) refuse = true;
+            state.stream = stream;
+        }
+    }
+
+    // Refused blocks are still decoded to keep the HPACK table in sync
+    if (catzilla_hpack_decode(&session->decoder, block, block_length, h2_on_header_field, &state) != 0) {
+        return h2_connection_error(session, CATZILLA_H2_COMPRESSION_ERROR);
+    }
+
+    if (refuse) {
+        h2_write_u32_frame(session, H2_FRAME_RST_STREAM, stream_id, CATZILLA_H2_REFUSED_STREAM);
+        return 0;
+    }
+
+    if (!trailers) {
+        bool is_connect = strcmp(stream->method, "CONNECT") == 0;
+        if (stream->malformed || !stream->has_method ||
+            (!is_connect && (!stream->has_path || !stream->has_scheme))) {
+            h2_reset_stream(session, stream, CATZILLA_H2_PROTOCOL_ERROR);
+            return 0;
+        }
+    }
+
+    if (end_stream) {
+        h2_mark_ready(session, stream);
+    }
+    return 0;
+}
+
+static int h2_append_header_fragment(catzilla_h2_session_t* session, const uint8_t* data, size_t length) {
+    if (session->header_block_length + length > CATZILLA_HEADER_DATA_MAX) {
+        return h2_connection_error(session, CATZILLA_H2_PROTOCOL_ERROR);
+    }
+    if (h2_reserve((char**)&session->header_block, &session->header_block_capacity,
+                   session->header_block_length + length) != 0) {
+        return h2_connection_error(session, CATZILLA_H2_INTERNAL_ERROR);
+    }
+    memcpy(session->header_block + session->header_block_length, data, length);
+    session->header_block_length += length;
+    return 0;
+}
+
+// Strip padding (and priority fields) from DATA and HEADERS payloads
+static int h2_unpad(uint8_t flags, const uint8_t** payload, size_t* length, size_t priority_length) {
+    size_t padding = 0;
+    if (flags & H2_FLAG_PADDED) {
+        if (*length < 1) return -1;
+        padding = (*payload)[0];
+        (*payload)++;
+        (*length)--;
+    }
+    if (*length < priority_length + padding) return -1;
+    *payload += priority_length;
+    *length -= priority_length + padding;
+    return 0;
+}
+
+static int h2_on_headers(catzilla_h2_session_t* session, uint8_t flags, uint32_t stream_id,
+                         const uint8_t* payload, size_t length) {
+    if (stream_id == 0 || (stream_id & 1) == 0) {
+        return h2_connection_error(session, CATZILLA_H2_PROTOCOL_ERROR);
+    }
+    if (h2_unpad(flags, &payload, &length, (flags & H2_FLAG_PRIORITY) ? 5 : 0) != 0) {
+        return h2_connection_error(session, CATZILLA_H2_PROTOCOL_ERROR);
+    }
+
+    session->header_block_stream = stream_id;
+    session->header_block_end_stream = (flags & H2_FLAG_END_STREAM) != 0;
+    session->header_block_length = 0;
+    if (h2_append_header_fragment(session, payload, length) != 0) return -1;
+
+    if (flags & H2_FLAG_END_HEADERS) {
+        return h2_complete_header_block(session);
+    }
+    return 0;
+}
+
+static void h2_consume_connection_window(catzilla_h2_session_t* session, size_t length) {
+    session->recv_consumed += (uint32_t)length;
+    if (session->recv_consumed >= H2_WINDOW_UPDATE_THRESHOLD) {
+        h2_write_u32_frame(session, H2_FRAME_WINDOW_UPDATE, 0, session->recv_consumed);
+        session->recv_consumed = 0;
+    }
+}
+
+// Answer 413 on a stream whose body outgrew the limit
+static void h2_reject_body(catzilla_h2_session_t* session, catzilla_h2_stream_t* stream) {
+    static const char body[] = "413 Payload Too Large";
+    static const catzilla_h2_header_t headers[] = {
+        { "content-type", 12, "text/plain", 10 },
+        { "content-length", 14, "21", 2 },
+    };
+
+    stream->body_rejected = true;
+    catzilla_request_free(stream->body);
+    stream->body = NULL;
+    stream->body_length = 0;
+    stream->body_capacity = 0;
+
+    uint32_t id = stream->id;
+    catzilla_h2_submit_response(session, id, 413, headers, 2, body, sizeof(body) - 1);
+
+    // Once the response is out, nothing more is wanted from the peer on this
+    // stream (RFC 9113 8.1); until then further DATA is dropped
+    if (!h2_find_stream(session, id)) {
+        h2_write_u32_frame(session, H2_FRAME_RST_STREAM, id, CATZILLA_H2_NO_ERROR);
+    }
+}
+
+static int h2_on_data(catzilla_h2_session_t* session, uint8_t flags, uint32_t stream_id,
+                      const uint8_t* payload, size_t length) {
+    if (stream_id == 0) {
+        return h2_connection_error(session, CATZILLA_H2_PROTOCOL_ERROR);
+    }
+
+    // The whole frame, padding included, counts against the connection window
+    h2_consume_connection_window(session, length);
+
+    catzilla_h2_stream_t* stream = h2_find_stream(session, stream_id);
+    if (!stream) {
+        // Frames still in flight after we reset or finished a stream are ignored
+        return stream_id > session->last_stream_id ?
+            h2_connection_error(session, CATZILLA_H2_PROTOCOL_ERROR) : 0;
+    }
+    if (stream->end_stream_received) {
+        h2_reset_stream(session, stream, CATZILLA_H2_STREAM_CLOSED);
+        return 0;
+    }
+    if (stream->body_rejected) {
+        return 0;
+    }
+
+    size_t frame_length = length;
+    if (h2_unpad(flags, &payload, &length, 0) != 0) {
+        return h2_connection_error(session, CATZILLA_H2_PROTOCOL_ERROR);
+    }
+
+    if (session->max_body_size > 0 && stream->body_length + length > session->max_body_size) {
+        h2_reject_body(session, stream);
+        return 0;
+    }
+
+    if (length > 0) {
+        size_t needed = stream->body_length + length + 1;  // Room for a terminator
+        if (needed > stream->body_capacity) {
+            size_t capacity = stream->body_capacity ? stream->body_capacity * 2 : 4096;
+            while (capacity < needed) capacity *= 2;
+            char* body = catzilla_request_realloc(stream->body, capacity);
+            if (!body) {
+                h2_reset_stream(session, stream, CATZILLA_H2_INTERNAL_ERROR);
+                return 0;
+            }
+            stream->body = body;
+            stream->body_capacity = capacity;
+        }
+        memcpy(stream->body + stream->body_length, payload, length);
+        stream->body_length += length;
+        stream->body[stream->body_length] = '\0';
+    }
+
+    if (flags & H2_FLAG_END_STREAM) {
+        h2_mark_ready(session, stream);
+        return 0;
+    }
+
+    // Buffered bodies are consumed as they arrive, so the stream window is
+    // reopened right away; the body limit bounds what a peer can make us hold
+    stream->recv_consumed += (uint32_t)frame_length;
+    if (stream->recv_consumed >= H2_WINDOW_UPDATE_THRESHOLD) {
+        h2_write_u32_frame(session, H2_FRAME_WINDOW_UPDATE, stream_id, stream->recv_consumed);
+        stream->recv_consumed = 0;
+    }
+    return 0;
+}
+
+static void h2_flush_all_streams(catzilla_h2_session_t* session) {
+    // Backwards, because a finished stream is replaced by the last one
+    for (int i = session->stream_count - 1; i >= 0; i--) {
+        if (i < session->stream_count && session->streams[i]->pending) {
+            h2_flush_stream(session, session->streams[i]);
+        }
+    }
+}
+
+static int h2_on_settings(catzilla_h2_session_t* session, uint8_t flags, uint32_t stream_id,
+                          const uint8_t* payload, size_t length) {
+    if (stream_id != 0) {
+        return h2_connection_error(session, CATZILLA_H2_PROTOCOL_ERROR);
+    }
+    if (flags & H2_FLAG_ACK) {
+        return length == 0 ? 0 : h2_connection_error(session, CATZILLA_H2_FRAME_SIZE_ERROR);
+    }
+    if (length % 6 != 0) {
+        return h2_connection_error(session, CATZILLA_H2_FRAME_SIZE_ERROR);
+    }
+
+    for (size_t offset = 0; offset < length; offset += 6) {
+        uint16_t id = (uint16_t)((payload[offset] << 8) | payload[offset + 1]);
+        uint32_t value = h2_read_u32(payload + offset + 2);
+
+        switch (id) {
+            case H2_SETTINGS_ENABLE_PUSH:
+                if (value > 1) return h2_connection_error(session, CATZILLA_H2_PROTOCOL_ERROR);
+                break;
+            case H2_SETTINGS_INITIAL_WINDOW_SIZE: {
+                if (value > CATZILLA_H2_MAX_WINDOW) {
+                    return h2_connection_error(session, CATZILLA_H2_FLOW_CONTROL_ERROR);
+                }
+                // Applies retroactively to every open stream (RFC 9113 6.9.2)
+                int64_t delta = (int64_t)value - session->peer_initial_window;
+                session->peer_initial_window = value;
+                for (int i = 0; i < session->stream_count; i++) {
+                    session->streams[i]->send_window += delta;
+                }
+                break;
+            }
+            case H2_SETTINGS_MAX_FRAME_SIZE:
+                if (value < CATZILLA_H2_DEFAULT_FRAME_SIZE || value > H2_MAX_FRAME_SIZE_LIMIT) {
+                    return h2_connection_error(session, CATZILLA_H2_PROTOCOL_ERROR);
+                }
+                session->peer_max_frame_size = value;
+                break;
+            default:
+                // Responses never use the peer's dynamic table, and we do not push
+                break;
+        }
+    }
+
+    h2_write_frame(session, H2_FRAME_SETTINGS, H2_FLAG_ACK, 0, NULL, 0);
+    h2_flush_all_streams(session);
+    return 0;
+}
+
+static int h2_on_window_update(catzilla_h2_session_t* session, uint32_t stream_id,
+                               const uint8_t* payload, size_t length) {
+    if (length != 4) {
+        return h2_connection_error(session, CATZILLA_H2_FRAME_SIZE_ERROR);
+    }
+
+    uint32_t increment = h2_read_u32(payload) & 0x7fffffff;
+    if (stream_id == 0) {
+        if (increment == 0) return h2_connection_error(session, CATZILLA_H2_PROTOCOL_ERROR);
+        session->send_window += increment;
+        if (session->send_window > CATZILLA_H2_MAX_WINDOW) {
+            return h2_connection_error(session, CATZILLA_H2_FLOW_CONTROL_ERROR);
+        }
+        h2_flush_all_streams(session);
+        return 0;
+    }
+
+    catzilla_h2_stream_t* stream = h2_find_stream(session, stream_id);
+    if (!stream) return 0;  // Closed streams may still receive updates
+
+    if (increment == 0) {
+        h2_reset_stream(session, stream, CATZILLA_H2_PROTOCOL_ERROR);
+        return 0;
+    }
+    stream->send_window += increment;
+    if (stream->send_window > CATZILLA_H2_MAX_WINDOW) {
+        h2_reset_stream(session, stream, CATZILLA_H2_FLOW_CONTROL_ERROR);
+        return 0;
+    }
+    if (stream->pending) {
+        h2_flush_stream(session, stream);
+    }
+    return 0;
+}
+
+static int h2_handle_frame(catzilla_h2_session_t* session, uint8_t type, uint8_t flags,
+                           uint32_t stream_id, const uint8_t* payload, size_t length) {
+    // A header block must continue without interleaved frames
+    if (session->header_block_stream != 0) {
+        if (type != H2_FRAME_CONTINUATION || stream_id != session->header_block_stream) {
+            return h2_connection_error(session, CATZILLA_H2_PROTOCOL_ERROR);
+        }
+        if (h2_append_header_fragment(session, payload, length) != 0) return -1;
+        return (flags & H2_FLAG_END_HEADERS) ? h2_complete_header_block(session) : 0;
+    }
+
+    switch (type) {
+        case H2_FRAME_DATA:
+            return h2_on_data(session, flags, stream_id, payload, length);
+        case H2_FRAME_HEADERS:
+            return h2_on_headers(session, flags, stream_id, payload, length);
+        case H2_FRAME_PRIORITY:
+            // Responses go out in dispatch order; priorities are not used
+            if (stream_id == 0) return h2_connection_error(session, CATZILLA_H2_PROTOCOL_ERROR);
+            return length == 5 ? 0 : h2_connection_error(session, CATZILLA_H2_FRAME_SIZE_ERROR);
+        case H2_FRAME_RST_STREAM: {
+            if (stream_id == 0) return h2_connection_error(session, CATZILLA_H2_PROTOCOL_ERROR);
+            if (length != 4) return h2_connection_error(session, CATZILLA_H2_FRAME_SIZE_ERROR);
+            catzilla_h2_stream_t* stream = h2_find_stream(session, stream_id);
+            if (stream) {
+                h2_close_stream(session, stream);
+            }
+            return 0;
+        }
+        case H2_FRAME_SETTINGS:
+            return h2_on_settings(session, flags, stream_id, payload, length);
+        case H2_FRAME_PUSH_PROMISE:
+            // Clients cannot push
+            return h2_connection_error(session, CATZILLA_H2_PROTOCOL_ERROR);
+        case H2_FRAME_PING:
+            if (stream_id != 0) return h2_connection_error(session, CATZILLA_H2_PROTOCOL_ERROR);
+            if (length != 8) return h2_connection_error(session, CATZILLA_H2_FRAME_SIZE_ERROR);
+            if (!(flags & H2_FLAG_ACK)) {
+                h2_write_frame(session, H2_FRAME_PING, H2_FLAG_ACK, 0, payload, length);
+            }
+            return 0;
+        case H2_FRAME_GOAWAY:
+            // Streams already received are still answered
+            LOG_HTTP_DEBUG("HTTP/2 peer sent GOAWAY");
+            return 0;
+        case H2_FRAME_WINDOW_UPDATE:
+            return h2_on_window_update(session, stream_id, payload, length);
+        case H2_FRAME_CONTINUATION:
+            return h2_connection_error(session, CATZILLA_H2_PROTOCOL_ERROR);
+        default:
+            // Unknown frame types are ignored (RFC 9113 4.1)
+            return 0;
+    }
+}
+
+// Hand complete requests to the server one at a time
+static void h2_dispatch(catzilla_h2_session_t* session) {
+    while (!session->closed && session->deferred_stream_id == 0 && session->ready_head) {
+        catzilla_h2_stream_t* stream = session->ready_head;
+        h2_unlink_ready(session, stream);
+
+        catzilla_h2_request_t request;
+        request.stream_id = stream->id;
+        memcpy(request.method, stream->method, sizeof(request.method));
+        memcpy(request.path, stream->path, sizeof(request.path));
+        request.headers = &stream->headers;
+        request.body = stream->body;
+        request.body_length = stream->body_length;
+        stream->body = NULL;
+        stream->body_length = 0;
+        stream->body_capacity = 0;
+
+        uint32_t id = stream->id;
+        int rc = session->on_request(session->user_data, &request);
+        catzilla_request_free(request.body);
+
+        // The stream is gone once its response has been written in full
+        stream = h2_find_stream(session, id);
+        if (!stream || stream->responded) continue;
+
+        if (rc == CATZILLA_H2_DISPATCH_DEFERRED) {
+            session->deferred_stream_id = id;
+        } else {
+            h2_reset_stream(session, stream, CATZILLA_H2_INTERNAL_ERROR);
+        }
+    }
+}
+
+static void h2_flush(catzilla_h2_session_t* session) {
+    if (session->depth > 0 || session->output_length == 0 || !session->send) return;
+
+    size_t length = session->output_length;
+    session->output_length = 0;
+    if (session->send(session->user_data, session->output, length, session->closed) != 0) {
+        session->closed = true;
+    }
+}
+
+int catzilla_h2_session_receive(catzilla_h2_session_t* session, const char* data, size_t length) {
+    if (!session || session->closed) return -1;
+
+    session->depth++;
+
+    // Continue a partial frame from the previous read in the input buffer
+    const uint8_t* buffer = (const uint8_t*)data;
+    size_t available = length;
+    if (session->input_length > 0) {
+        if (h2_reserve(&session->input, &session->input_capacity, session->input_length + length) != 0) {
+            h2_connection_error(session, CATZILLA_H2_INTERNAL_ERROR);
+            goto done;
+        }
+        memcpy(session->input + session->input_length, data, length);
+        session->input_length += length;
+        buffer = (const uint8_t*)session->input;
+        available = session->input_length;
+    }
+
+    size_t pos = 0;
+    if (!session->preface_received) {
+        size_t compare = available < CATZILLA_H2_PREFACE_LEN ? available : CATZILLA_H2_PREFACE_LEN;
+        if (memcmp(buffer, CATZILLA_H2_PREFACE, compare) != 0) {
+            h2_connection_error(session, CATZILLA_H2_PROTOCOL_ERROR);
+            goto done;
+        }
+        if (available >= CATZILLA_H2_PREFACE_LEN) {
+            session->preface_received = true;
+            pos = CATZILLA_H2_PREFACE_LEN;
+        }
+        // A partial preface is kept below like a partial frame
+    }
+
+    while (session->preface_received && !session->closed &&
+           available - pos >= CATZILLA_H2_FRAME_HEADER_LEN) {
+        const uint8_t* frame = buffer + pos;
+        size_t frame_length = ((size_t)frame[0] << 16) | ((size_t)frame[1] << 8) | frame[2];
+        if (frame_length > CATZILLA_H2_DEFAULT_FRAME_SIZE) {
+            h2_connection_error(session, CATZILLA_H2_FRAME_SIZE_ERROR);
+            break;
+        }
+        if (available - pos < CATZILLA_H2_FRAME_HEADER_LEN + frame_length) break;
+
+        uint32_t stream_id = h2_read_u32(frame + 5) & 0x7fffffff;
+        h2_handle_frame(session, frame[3], frame[4], stream_id,
+                        frame + CATZILLA_H2_FRAME_HEADER_LEN, frame_length);
+        pos += CATZILLA_H2_FRAME_HEADER_LEN + frame_length;
+    }
+
+    // Keep the unparsed tail for the next read
+    if (!session->closed) {
+        size_t remaining = available - pos;
+        if (buffer == (const uint8_t*)session->input) {
+            memmove(session->input, session->input + pos, remaining);
+            session->input_length = remaining;
+        } else if (remaining > 0) {
+            if (h2_reserve(&session->input, &session->input_capacity, remaining) != 0) {
+                h2_connection_error(session, CATZILLA_H2_INTERNAL_ERROR);
+            } else {
+                memcpy(session->input, buffer + pos, remaining);
+                session->input_length = remaining;
+            }
+        }
+        h2_dispatch(session);
+    }
+
+done:
+    session->depth--;
+    h2_flush(session);
+    return session->closed ? -1 : 0;
+}
+
+int catzilla_h2_session_resume(catzilla_h2_session_t* session) {
+    if (!session) return -1;
+
+    session->deferred_stream_id = 0;
+    if (session->depth > 0) {
+        // Called from inside receive; its dispatch loop picks up from here
+        return 0;
+    }
+
+    session->depth++;
+    h2_dispatch(session);
+    session->depth--;
+    h2_flush(session);
+    return session->closed ? -1 : 0;
+}
+
+// Send as much of a stream's pending body as both windows allow
+static void h2_flush_stream(catzilla_h2_session_t* session, catzilla_h2_stream_t* stream) {
+    while (stream->pending_offset < stream->pending_length) {
+        int64_t window = session->send_window < stream->send_window ? session->send_window : stream->send_window;
+        if (window <= 0) return;
+
+        size_t chunk = stream->pending_length - stream->pending_offset;
+        if (chunk > session->peer_max_frame_size) chunk = session->peer_max_frame_size;
+        if ((int64_t)chunk > window) chunk = (size_t)window;
+
+        bool last = stream->pending_offset + chunk == stream->pending_length;
+        if (h2_write_frame(session, H2_FRAME_DATA, last ? H2_FLAG_END_STREAM : 0, stream->id,
+                           stream->pending + stream->pending_offset, chunk) != 0) {
+            h2_connection_error(session, CATZILLA_H2_INTERNAL_ERROR);
+            return;
+        }
+        stream->pending_offset += chunk;
+        session->send_window -= (int64_t)chunk;
+        stream->send_window -= (int64_t)chunk;
+    }
+
+    h2_close_stream(session, stream);
+}
+
+int catzilla_h2_submit_response(catzilla_h2_session_t* session,
+                                uint32_t stream_id,
+                                int status,
+                                const catzilla_h2_header_t* headers,
+                                int header_count,
+                                const char* body,
+                                size_t body_length) {
+    if (!session || session->closed) return -1;
+
+    catzilla_h2_stream_t* stream = h2_find_stream(session, stream_id);
+    if (!stream || stream->responded) return -1;
+
+    size_t bound = 5;
+    for (int i = 0; i < header_count; i++) {
+        bound += catzilla_hpack_encoded_size_bound(headers[i].name_length, headers[i].value_length);
+    }
+
+    uint8_t stack_block[H2_HEADER_BLOCK_STACK];
+    uint8_t* block = bound <= sizeof(stack_block) ? stack_block : catzilla_response_alloc(bound);
+    if (!block) return -1;
+
+    size_t block_length = catzilla_hpack_encode_status(block, status);
+    for (int i = 0; i < header_count; i++) {
+        block_length += catzilla_hpack_encode_header(block + block_length, bound - block_length,
+                                                     headers[i].name, headers[i].name_length,
+                                                     headers[i].value, headers[i].value_length);
+    }
+
+    // Keep the body before anything is queued so a failure leaves the stream untouched
+    char* pending = NULL;
+    if (body_length > 0) {
+        pending = catzilla_response_alloc(body_length);
+        if (!pending) {
+            if (block != stack_block) catzilla_response_free(block);
+            return -1;
+        }
+        memcpy(pending, body, body_length);
+    }
+
+    session->depth++;
+
+    // HEADERS, then CONTINUATION frames when the block exceeds the peer's frame size
+    size_t offset = 0;
+    uint8_t type = H2_FRAME_HEADERS;
+    do {
+        size_t chunk = block_length - offset;
+        if (chunk > session->peer_max_frame_size) chunk = session->peer_max_frame_size;
+        uint8_t flags = offset + chunk == block_length ? H2_FLAG_END_HEADERS : 0;
+        if (type == H2_FRAME_HEADERS && body_length == 0) flags |= H2_FLAG_END_STREAM;
+        h2_write_frame(session, type, flags, stream_id, block + offset, chunk);
+        offset += chunk;
+        type = H2_FRAME_CONTINUATION;
+    } while (offset < block_length);
+
+    if (block != stack_block) catzilla_response_free(block);
+
+    stream->responded = true;
+    h2_unlink_ready(session, stream);
+    if (pending) {
+        stream->pending = pending;
+        stream->pending_length = body_length;
+        stream->pending_offset = 0;
+        h2_flush_stream(session, stream);
+    } else {
+        h2_close_stream(session, stream);
+    }
+
+    session->depth--;
+    h2_flush(session);
+    return 0;
+}
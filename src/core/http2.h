@@ -0,0 +1,207 @@
+#ifndef CATZILLA_HTTP2_H
+#define CATZILLA_HTTP2_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "hpack.h"
+#include "http_headers.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// HTTP/2 (RFC 9113) connection state, independent of the socket layer. The
+// server feeds received bytes in and gets requests and outgoing bytes back
+// through callbacks.
+
+#define CATZILLA_H2_PREFACE "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n"
+#define CATZILLA_H2_PREFACE_LEN 24
+
+#define CATZILLA_H2_FRAME_HEADER_LEN 9
+#define CATZILLA_H2_DEFAULT_FRAME_SIZE 16384
+#define CATZILLA_H2_DEFAULT_WINDOW 65535
+#define CATZILLA_H2_MAX_WINDOW 0x7fffffff
+
+// Concurrent streams we advertise; further HEADERS are refused
+#define CATZILLA_H2_MAX_STREAMS 100
+
+#define CATZILLA_H2_METHOD_MAX 32
+#define CATZILLA_H2_PATH_MAX 2048
+
+// Error codes (RFC 9113 7)
+#define CATZILLA_H2_NO_ERROR 0x0
+#define CATZILLA_H2_PROTOCOL_ERROR 0x1
+#define CATZILLA_H2_INTERNAL_ERROR 0x2
+#define CATZILLA_H2_FLOW_CONTROL_ERROR 0x3
+#define CATZILLA_H2_STREAM_CLOSED 0x5
+#define CATZILLA_H2_FRAME_SIZE_ERROR 0x6
+#define CATZILLA_H2_REFUSED_STREAM 0x7
+#define CATZILLA_H2_COMPRESSION_ERROR 0x9
+
+// Return values of the request callback
+#define CATZILLA_H2_DISPATCH_DONE 0
+#define CATZILLA_H2_DISPATCH_DEFERRED 1
+
+typedef struct catzilla_h2_stream_s catzilla_h2_stream_t;
+typedef struct catzilla_h2_session_s catzilla_h2_session_t;
+
+/**
+ * A complete request on one stream, handed to the request callback
+ */
+typedef struct {
+    uint32_t stream_id;
+    char method[CATZILLA_H2_METHOD_MAX];
+    char path[CATZILLA_H2_PATH_MAX];
+    catzilla_header_set_t* headers;  // Regular headers; :authority is stored as host
+    char* body;                      // catzilla_request_alloc'd; the callback may take it and set NULL
+    size_t body_length;
+} catzilla_h2_request_t;
+
+/**
+ * Called once per complete request, one stream at a time
+ * @return CATZILLA_H2_DISPATCH_DONE once a response was submitted, or
+ *         CATZILLA_H2_DISPATCH_DEFERRED when it will be submitted later; the
+ *         session then dispatches nothing until catzilla_h2_session_resume
+ */
+typedef int (*catzilla_h2_request_fn)(void* user_data, catzilla_h2_request_t* request);
+
+/**
+ * Write bytes to the peer. The data must be copied before returning.
+ * @param close_after Close the connection once the data is written
+ * @return 0 on success, -1 if the connection is gone
+ */
+typedef int (*catzilla_h2_send_fn)(void* user_data, const char* data, size_t length, bool close_after);
+
+/**
+ * One response header for catzilla_h2_submit_response
+ */
+typedef struct {
+    const char* name;
+    size_t name_length;
+    const char* value;
+    size_t value_length;
+} catzilla_h2_header_t;
+
+struct catzilla_h2_session_s {
+    catzilla_hpack_decoder_t decoder;
+    catzilla_h2_request_fn on_request;
+    catzilla_h2_send_fn send;
+    void* user_data;
+
+    // Unparsed input: the preface or a partial frame
+    char* input;
+    size_t input_length;
+    size_t input_capacity;
+    bool preface_received;
+
+    // Header block spread over HEADERS and CONTINUATION frames
+    uint8_t* header_block;
+    size_t header_block_length;
+    size_t header_block_capacity;
+    uint32_t header_block_stream;
+    bool header_block_end_stream;
+
+    catzilla_h2_stream_t* streams[CATZILLA_H2_MAX_STREAMS];
+    int stream_count;
+    uint32_t last_stream_id;
+
+    // Complete requests waiting for dispatch, in arrival order
+    catzilla_h2_stream_t* ready_head;
+    catzilla_h2_stream_t* ready_tail;
+    uint32_t deferred_stream_id;  // Stream whose response is still outstanding, 0 if none
+
+    // Flow control
+    int64_t send_window;           // Connection-level window granted by the peer
+    int64_t peer_initial_window;   // SETTINGS_INITIAL_WINDOW_SIZE of the peer
+    uint32_t peer_max_frame_size;
+    uint32_t recv_consumed;        // Connection bytes received since the last WINDOW_UPDATE
+
+    uint64_t max_body_size;        // 0 = unlimited
+
+    // Outgoing frames, flushed through send when the outermost call returns
+    char* output;
+    size_t output_length;
+    size_t output_capacity;
+    int depth;
+
+    bool goaway_sent;
+    bool closed;
+};
+
+/**
+ * Check whether the first bytes of a connection start the HTTP/2 preface
+ * @param data Received bytes
+ * @param length Number of bytes (at least 4 are needed to decide)
+ * @return true for a prior-knowledge HTTP/2 connection
+ */
+bool catzilla_h2_is_preface(const char* data, size_t length);
+
+/**
+ * Create a session and queue the server SETTINGS frame
+ * @param on_request Request callback
+ * @param send Output callback
+ * @param user_data Passed to both callbacks
+ * @param max_body_size Largest request body accepted (0 = unlimited)
+ * @return Session, or NULL on allocation failure
+ */
+catzilla_h2_session_t* catzilla_h2_session_create(catzilla_h2_request_fn on_request,
+                                                  catzilla_h2_send_fn send,
+                                                  void* user_data,
+                                                  uint64_t max_body_size);
+
+/**
+ * Free a session and all of its streams
+ * @param session Session (NULL is ignored)
+ */
+void catzilla_h2_session_free(catzilla_h2_session_t* session);
+
+/**
+ * Feed received bytes, starting with the client preface
+ * @param session Session
+ * @param data Bytes read from the socket
+ * @param length Number of bytes
+ * @return 0 to keep reading, -1 after a connection error (GOAWAY was queued
+ *         with close_after set)
+ */
+int catzilla_h2_session_receive(catzilla_h2_session_t* session, const char* data, size_t length);
+
+/**
+ * Continue dispatching after a deferred response was submitted
+ * @param session Session
+ * @return 0, or -1 if the connection failed meanwhile
+ */
+int catzilla_h2_session_resume(catzilla_h2_session_t* session);
+
+/**
+ * Send a complete response on a stream. The body is copied; what does not fit
+ * the peer's flow-control windows is queued until WINDOW_UPDATE arrives.
+ * @param session Session
+ * @param stream_id Stream to answer
+ * @param status HTTP status code
+ * @param headers Response headers (connection-specific ones must be left out)
+ * @param header_count Number of headers
+ * @param body Response body (may be NULL)
+ * @param body_length Body length
+ * @return 0 on success, -1 if the stream is gone or on allocation failure
+ */
+int catzilla_h2_submit_response(catzilla_h2_session_t* session,
+                                uint32_t stream_id,
+                                int status,
+                                const catzilla_h2_header_t* headers,
+                                int header_count,
+                                const char* body,
+                                size_t body_length);
+
+/**
+ * Number of streams with a response still being sent or awaited
+ * @param session Session
+ * @return Open stream count
+ */
+int catzilla_h2_session_open_streams(const catzilla_h2_session_t* session);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CATZILLA_HTTP2_H
@@ -0,0 +1,510 @@
+#include "http_cache.h"
+#include "http_response.h"
+#include "memory.h"
+#include "platform_compat.h"
+#include <stdio.h>
+#include <string.h>
+#ifndef _WIN32
+#include <strings.h>  // For strncasecmp on POSIX systems
+#endif
+
+// Hash value standing in for an absent request header
+#define VARY_ABSENT_HASH 0x9e3779b9u
+
+// Accept-Encoding codings that pick different variants
+enum {
+    CODING_GZIP = 1 << 0,
+    CODING_BR = 1 << 1,
+    CODING_ZSTD = 1 << 2,
+    CODING_DEFLATE = 1 << 3,
+    CODING_ANY = 1 << 4,
+    CODING_NO_IDENTITY = 1 << 5,
+    CODING_PRESENT = 1 << 6
+};
+
+static bool is_space(char c) {
+    return c == ' ' || c == '\t';
+}
+
+static void trim(const char** start, const char** end) {
+    while (*start < *end && is_space(**start)) (*start)++;
+    while (*end > *start && is_space((*end)[-1])) (*end)--;
+}
+
+static bool token_equals(const char* start, const char* end, const char* token) {
+    size_t length = strlen(token);
+    return (size_t)(end - start) == length && strncasecmp(start, token, length) == 0;
+}
+
+// Step over one "Name: value\r\n" line; false at the end of the block
+static bool next_line(const char** cursor, const char** line, size_t* line_len) {
+    if (!**cursor) return false;
+    const char* line_end = strstr(*cursor, "\r\n");
+    *line = *cursor;
+    *line_len = line_end ? (size_t)(line_end - *cursor) : strlen(*cursor);
+    *cursor = line_end ? line_end + 2 : *cursor + *line_len;
+    return true;
+}
+
+static bool line_has_name(const char* line, size_t line_len, const char* name, size_t name_len) {
+    return line_len > name_len && line[name_len] == ':' && strncasecmp(line, name, name_len) == 0;
+}
+
+static uint64_t fnv1a64(const char* data, size_t length) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (uint8_t)data[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+const char* catzilla_header_block_get(const char* headers, const char* name, size_t* length_out) {
+    // A bare content type has no fields
+    if (!headers || !name || !strchr(headers, ':')) return NULL;
+
+    size_t name_len = strlen(name);
+    const char* cursor = headers;
+    const char* line;
+    size_t line_len;
+    while (next_line(&cursor, &line, &line_len)) {
+        if (line_has_name(line, line_len, name, name_len)) {
+            const char* value = line + name_len + 1;
+            const char* end = line + line_len;
+            trim(&value, &end);
+            if (length_out) *length_out = (size_t)(end - value);
+            return value;
+        }
+    }
+    return NULL;
+}
+
+// delta-seconds, optionally quoted; values past 2^31 - 1 are capped
+static int64_t parse_delta_seconds(const char* start, const char* end) {
+    if (end - start >= 2 && *start == '"' && end[-1] == '"') {
+        start++;
+        end--;
+    }
+    if (start == end) return -1;
+    int64_t value = 0;
+    for (const char* p = start; p < end; p++) {
+        if (*p < '0' || *p > '9') return -1;
+        if (value < 2147483647) value = value * 10 + (*p - '0');
+    }
+    return value < 2147483647 ? value : 2147483647;
+}
+
+void catzilla_cache_control_parse(const char* value, size_t length, catzilla_cache_control_t* out) {
+    memset(out, 0, sizeof(*out));
+    out->max_age = -1;
+    out->s_maxage = -1;
+    if (!value) return;
+
+    const char* cursor = value;
+    const char* end = value + length;
+    while (cursor < end) {
+        const char* directive_end = memchr(cursor, ',', (size_t)(end - cursor));
+        if (!directive_end) directive_end = end;
+
+        const char* name = cursor;
+        const char* name_end = memchr(cursor, '=', (size_t)(directive_end - cursor));
+        const char* argument = name_end ? name_end + 1 : directive_end;
+        const char* argument_end = directive_end;
+        if (!name_end) name_end = directive_end;
+        trim(&name, &name_end);
+        trim(&argument, &argument_end);
+
+        // no-cache="Set-Cookie" and private="..." limit the directive to
+        // some fields; this cache stores whole responses, so treat them whole
+        if (token_equals(name, name_end, "no-store")) {
+            out->no_store = true;
+        } else if (token_equals(name, name_end, "no-cache")) {
+            out->no_cache = true;
+        } else if (token_equals(name, name_end, "private")) {
+            out->is_private = true;
+        } else if (token_equals(name, name_end, "max-age")) {
+            out->max_age = parse_delta_seconds(argument, argument_end);
+        } else if (token_equals(name, name_end, "s-maxage")) {
+            out->s_maxage = parse_delta_seconds(argument, argument_end);
+        }
+        cursor = directive_end + 1;
+    }
+}
+
+uint32_t catzilla_http_cache_ttl(const char* headers, uint32_t route_ttl) {
+    if (!headers || !strchr(headers, ':')) return route_ttl;
+    if (catzilla_header_block_get(headers, "Set-Cookie", NULL)) return 0;
+
+    char names[CATZILLA_HTTP_CACHE_VARY_LEN_MAX];
+    if (catzilla_http_cache_vary_names(headers, names, sizeof(names)) < 0) return 0;
+
+    size_t length = 0;
+    const char* value = catzilla_header_block_get(headers, "Cache-Control", &length);
+    if (!value) return route_ttl;
+
+    catzilla_cache_control_t control;
+    catzilla_cache_control_parse(value, length, &control);
+    if (control.no_store || control.no_cache || control.is_private) return 0;
+    // This is a shared cache: s-maxage speaks to it before max-age does
+    if (control.s_maxage >= 0) return (uint32_t)control.s_maxage;
+    if (control.max_age >= 0) return (uint32_t)control.max_age;
+    return route_ttl;
+}
+
+int catzilla_http_cache_vary_names(const char* headers, char* out, size_t out_size) {
+    if (out_size == 0) return -1;
+    out[0] = '\0';
+
+    size_t length = 0;
+    const char* value = catzilla_header_block_get(headers, "Vary", &length);
+    if (!value) return 0;
+
+    size_t used = 0;
+    const char* cursor = value;
+    const char* end = value + length;
+    while (cursor < end) {
+        const char* token = cursor;
+        const char* token_end = memchr(cursor, ',', (size_t)(end - cursor));
+        if (!token_end) token_end = end;
+        cursor = token_end + 1;
+        trim(&token, &token_end);
+        if (token == token_end) continue;
+        if (token_equals(token, token_end, "*")) return -1;
+
+        size_t token_len = (size_t)(token_end - token);
+        if (used + (used > 0) + token_len + 1 > out_size) return -1;
+        if (used > 0) out[used++] = ',';
+        for (size_t i = 0; i < token_len; i++) {
+            char c = token[i];
+            out[used++] = (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+        }
+    }
+    out[used] = '\0';
+    return (int)used;
+}
+
+// A q of zero ("0", "0.0", "0.000") refuses the coding
+static bool quality_is_zero(const char* params, const char* end) {
+    const char* q = params;
+    while (q < end) {
+        const char* param_end = memchr(q, ';', (size_t)(end - q));
+        if (!param_end) param_end = end;
+        const char* name = q;
+        const char* name_end = memchr(q, '=', (size_t)(param_end - q));
+        if (name_end) {
+            const char* weight = name_end + 1;
+            const char* weight_end = param_end;
+            trim(&name, &name_end);
+            trim(&weight, &weight_end);
+            if (token_equals(name, name_end, "q")) {
+                if (weight == weight_end || *weight != '0') return false;
+                for (const char* p = weight + 1; p < weight_end; p++) {
+                    if (*p != '.' && *p != '0') return false;
+                }
+                return true;
+            }
+        }
+        q = param_end + 1;
+    }
+    return false;
+}
+
+static uint32_t accept_encoding_mask(const char* value, size_t length) {
+    uint32_t mask = CODING_PRESENT;
+    const char* cursor = value;
+    const char* end = value + length;
+    while (cursor < end) {
+        const char* item_end = memchr(cursor, ',', (size_t)(end - cursor));
+        if (!item_end) item_end = end;
+        const char* coding = cursor;
+        const char* coding_end = memchr(cursor, ';', (size_t)(item_end - cursor));
+        const char* params = coding_end ? coding_end + 1 : item_end;
+        if (!coding_end) coding_end = item_end;
+        trim(&coding, &coding_end);
+        bool refused = quality_is_zero(params, item_end);
+
+        uint32_t bit = 0;
+        if (token_equals(coding, coding_end, "gzip") || token_equals(coding, coding_end, "x-gzip")) {
+            bit = CODING_GZIP;
+        } else if (token_equals(coding, coding_end, "br")) {
+            bit = CODING_BR;
+        } else if (token_equals(coding, coding_end, "zstd")) {
+            bit = CODING_ZSTD;
+        } else if (token_equals(coding, coding_end, "deflate")) {
+            bit = CODING_DEFLATE;
+        } else if (token_equals(coding, coding_end, "*")) {
+            bit = CODING_ANY;
+        } else if (token_equals(coding, coding_end, "identity") && refused) {
+            mask |= CODING_NO_IDENTITY;
+        }
+        if (!refused) mask |= bit;
+        cursor = item_end + 1;
+    }
+    return mask;
+}
+
+uint32_t catzilla_http_cache_variant_hash(const char* names, size_t names_len,
+                                          const catzilla_header_set_t* request_headers) {
+    uint32_t hash = 0;
+    const char* cursor = names;
+    const char* end = names + names_len;
+    while (cursor < end) {
+        const char* name_end = memchr(cursor, ',', (size_t)(end - cursor));
+        if (!name_end) name_end = end;
+
+        char name[CATZILLA_HTTP_CACHE_VARY_LEN_MAX];
+        size_t name_len = (size_t)(name_end - cursor);
+        memcpy(name, cursor, name_len);
+        name[name_len] = '\0';
+        cursor = name_end + 1;
+
+        size_t length = 0;
+        const char* value = request_headers ? catzilla_header_set_get(request_headers, name, &length) : NULL;
+        uint32_t value_hash = VARY_ABSENT_HASH;
+        if (value && strcmp(name, "accept-encoding") == 0) {
+            value_hash = accept_encoding_mask(value, length);
+        } else if (value) {
+            const char* value_end = value + length;
+            trim(&value, &value_end);
+            uint64_t wide = fnv1a64(value, (size_t)(value_end - value));
+            value_hash = (uint32_t)(wide ^ (wide >> 32));
+        }
+        hash = hash * 31u + value_hash;
+    }
+    return hash;
+}
+
+void catzilla_http_cache_variant_key(char* key, uint32_t variant_hash) {
+    size_t length = strlen(key);
+    snprintf(key + length, CATZILLA_HTTP_CACHE_VARIANT_SUFFIX_LEN + 1, "#%08x", variant_hash);
+}
+
+size_t catzilla_http_etag(const char* body, size_t body_len, char* out) {
+    uint64_t hash = fnv1a64(body, body_len) ^ ((uint64_t)body_len * 0x9E3779B97F4A7C15ULL);
+    static const char hex[] = "0123456789abcdef";
+    out[0] = '"';
+    for (int i = 0; i < 16; i++) {
+        out[1 + i] = hex[(hash >> (60 - 4 * i)) & 0xf];
+    }
+    out[17] = '"';
+    out[18] = '\0';
+    return 18;
+}
+
+// Strip W/ and the quotes: the weak comparison looks at the opaque part only
+static bool etag_opaque(const char* etag, size_t length, const char** opaque, size_t* opaque_len) {
+    if (length >= 2 && etag[0] == 'W' && etag[1] == '/') {
+        etag += 2;
+        length -= 2;
+    }
+    if (length < 2 || etag[0] != '"' || etag[length - 1] != '"') return false;
+    *opaque = etag + 1;
+    *opaque_len = length - 2;
+    return true;
+}
+
+bool catzilla_http_etag_matches(const char* list, size_t list_len, const char* etag, size_t etag_len) {
+    const char* wanted;
+    size_t wanted_len;
+    if (!list || !etag || !etag_opaque(etag, etag_len, &wanted, &wanted_len)) return false;
+
+    const char* cursor = list;
+    const char* end = list + list_len;
+    while (cursor < end) {
+        while (cursor < end && (is_space(*cursor) || *cursor == ',')) cursor++;
+        if (cursor == end) break;
+        if (*cursor == '*') return true;
+
+        // Entity tags are quoted and may contain commas, so scan for the quote
+        const char* start = cursor;
+        if (end - cursor >= 2 && cursor[0] == 'W' && cursor[1] == '/') cursor += 2;
+        if (cursor == end || *cursor != '"') return false;
+        const char* close = memchr(cursor + 1, '"', (size_t)(end - cursor - 1));
+        if (!close) return false;
+        cursor = close + 1;
+
+        const char* opaque;
+        size_t opaque_len;
+        if (etag_opaque(start, (size_t)(cursor - start), &opaque, &opaque_len) &&
+            opaque_len == wanted_len && memcmp(opaque, wanted, wanted_len) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static char* append(char* out, const char* data, size_t length) {
+    memcpy(out, data, length);
+    return out + length;
+}
+
+char* catzilla_http_cache_encode(int status_code, const char* headers, const char* body,
+                                 size_t body_len, int64_t now, size_t* size_out) {
+    size_t headers_len = headers ? strlen(headers) : 0;
+    bool formatted = headers && strchr(headers, ':');
+
+    // Room for the copied fields plus every field this may add
+    size_t block_max = headers_len + sizeof("Content-Type: \r\n") + sizeof("ETag: \r\n") + 18 +
+                       2 + sizeof("Last-Modified: \r\n") + CATZILLA_HTTP_DATE_LEN;
+    char* entry = catzilla_response_alloc(sizeof(catzilla_cached_header_t) + block_max + 1 + body_len);
+    if (!entry) return NULL;
+
+    catzilla_cached_header_t header;
+    memset(&header, 0, sizeof(header));
+    header.magic = CATZILLA_HTTP_CACHE_MAGIC;
+    header.kind = CATZILLA_CACHED_RESPONSE;
+    header.status_code = status_code;
+    header.last_modified = -1;
+
+    char* block = entry + sizeof(header);
+    char* out = block;
+    bool has_etag = false, has_last_modified = false;
+    if (formatted) {
+        const char* cursor = headers;
+        const char* line;
+        size_t line_len;
+        while (next_line(&cursor, &line, &line_len)) {
+            if (line_len == 0 || line_has_name(line, line_len, "Date", 4)) continue;
+            if (line_has_name(line, line_len, "ETag", 4)) {
+                const char* value = line + 5;
+                const char* value_end = line + line_len;
+                trim(&value, &value_end);
+                // Keep the first ETag; a duplicate or an oversized one is dropped
+                if (has_etag || value_end - value > CATZILLA_ETAG_MAX) continue;
+                has_etag = true;
+                header.etag_offset = (uint32_t)(value - line + (out - block));
+                header.etag_len = (uint32_t)(value_end - value);
+            } else if (line_has_name(line, line_len, "Last-Modified", 13) && !has_last_modified) {
+                const char* value = line + 14;
+                const char* value_end = line + line_len;
+                trim(&value, &value_end);
+                has_last_modified = true;
+                header.last_modified = catzilla_http_date_parse(value, (size_t)(value_end - value));
+            }
+            out = append(out, line, line_len);
+            out = append(out, "\r\n", 2);
+        }
+    } else if (headers_len > 0) {
+        out = append(out, "Content-Type: ", 14);
+        out = append(out, headers, headers_len);
+        out = append(out, "\r\n", 2);
+    }
+
+    if (!has_etag) {
+        out = append(out, "ETag: ", 6);
+        header.etag_offset = (uint32_t)(out - block);
+        header.etag_len = (uint32_t)catzilla_http_etag(body, body_len, out);
+        out += header.etag_len;
+        out = append(out, "\r\n", 2);
+    }
+    if (!has_last_modified) {
+        out = append(out, "Last-Modified: ", 15);
+        out += catzilla_http_date_format(now, out);
+        out = append(out, "\r\n", 2);
+        header.last_modified = now;
+    }
+    *out = '\0';
+
+    header.headers_len = (uint32_t)(out - block);
+    memcpy(entry, &header, sizeof(header));
+    if (body_len > 0) memcpy(out + 1, body, body_len);
+    *size_out = sizeof(header) + header.headers_len + 1 + body_len;
+    return entry;
+}
+
+char* catzilla_http_cache_encode_variants(const char* names, size_t names_len, size_t* size_out) {
+    char* entry = catzilla_response_alloc(sizeof(catzilla_cached_header_t) + names_len + 1);
+    if (!entry) return NULL;
+
+    catzilla_cached_header_t header;
+    memset(&header, 0, sizeof(header));
+    header.magic = CATZILLA_HTTP_CACHE_MAGIC;
+    header.kind = CATZILLA_CACHED_VARIANTS;
+    header.headers_len = (uint32_t)names_len;
+    header.last_modified = -1;
+    memcpy(entry, &header, sizeof(header));
+    memcpy(entry + sizeof(header), names, names_len);
+    entry[sizeof(header) + names_len] = '\0';
+    *size_out = sizeof(header) + names_len + 1;
+    return entry;
+}
+
+bool catzilla_http_cache_decode(const char* entry, size_t size, catzilla_cached_view_t* view) {
+    catzilla_cached_header_t header;
+    if (!entry || size < sizeof(header)) return false;
+    memcpy(&header, entry, sizeof(header));
+    if (header.magic != CATZILLA_HTTP_CACHE_MAGIC ||
+        (header.kind != CATZILLA_CACHED_RESPONSE && header.kind != CATZILLA_CACHED_VARIANTS)) {
+        return false;
+    }
+    size_t body_offset = sizeof(header) + (size_t)header.headers_len + 1;
+    if (body_offset > size || entry[body_offset - 1] != '\0' ||
+        (size_t)header.etag_offset + header.etag_len > header.headers_len) {
+        return false;
+    }
+
+    view->kind = (catzilla_cached_kind_t)header.kind;
+    view->status_code = header.status_code;
+    view->headers = entry + sizeof(header);
+    view->headers_len = header.headers_len;
+    view->body = entry + body_offset;
+    view->body_len = size - body_offset;
+    view->etag = header.etag_len ? view->headers + header.etag_offset : NULL;
+    view->etag_len = header.etag_len;
+    view->last_modified = header.last_modified;
+    return true;
+}
+
+bool catzilla_http_cache_not_modified(const catzilla_cached_view_t* view,
+                                      const catzilla_header_set_t* request_headers) {
+    if (view->kind != CATZILLA_CACHED_RESPONSE || view->status_code != 200 || !request_headers) {
+        return false;
+    }
+
+    size_t length = 0;
+    const char* if_none_match = catzilla_header_set_get_known(request_headers, CATZILLA_HDR_IF_NONE_MATCH, &length);
+    if (if_none_match) {
+        return catzilla_http_etag_matches(if_none_match, length, view->etag, view->etag_len);
+    }
+
+    const char* if_modified_since = catzilla_header_set_get_known(request_headers, CATZILLA_HDR_IF_MODIFIED_SINCE, &length);
+    if (if_modified_since && view->last_modified >= 0) {
+        int64_t since = catzilla_http_date_parse(if_modified_since, length);
+        return since >= 0 && view->last_modified <= since;
+    }
+    return false;
+}
+
+size_t catzilla_http_cache_not_modified_headers(const catzilla_cached_view_t* view,
+                                                char* out, size_t out_size) {
+    // Fields a 304 repeats from the 200 it stands for (RFC 9110 section 15.4.5)
+    static const char* const kept[] = {
+        "ETag", "Last-Modified", "Cache-Control", "Expires", "Vary", "Content-Location",
+    };
+
+    size_t used = 0;
+    const char* cursor = view->headers;
+    const char* line;
+    size_t line_len;
+    while (next_line(&cursor, &line, &line_len)) {
+        for (size_t i = 0; i < sizeof(kept) / sizeof(kept[0]); i++) {
+            if (line_has_name(line, line_len, kept[i], strlen(kept[i]))) {
+                if (used + line_len + 2 >= out_size) return 0;
+                memcpy(out + used, line, line_len);
+                memcpy(out + used + line_len, "\r\n", 2);
+                used += line_len + 2;
+                break;
+            }
+        }
+    }
+
+    char digits[CATZILLA_U64_DIGITS_MAX];
+    size_t digits_len = catzilla_u64toa((uint64_t)view->body_len, digits);
+    if (used + 16 + digits_len + 2 >= out_size) return 0;
+    memcpy(out + used, "Content-Length: ", 16);
+    memcpy(out + used + 16, digits, digits_len);
+    memcpy(out + used + 16 + digits_len, "\r\n", 2);
+    used += 16 + digits_len + 2;
+    out[used] = '\0';
+    return used;
+}
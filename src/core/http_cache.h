@@ -0,0 +1,218 @@
+/*
+ * Catzilla HTTP cache semantics for the response cache
+ *
+ * The response cache stores entries in the format below instead of opaque
+ * bytes. Each response entry carries its validators: a strong ETag computed
+ * once when it is stored (unless the handler set one) and Last-Modified
+ * (the store time unless the handler set one). Conditional requests are
+ * answered from them with a 304 before any handler runs.
+ *
+ * The handler's Cache-Control decides whether a response is stored and for
+ * how long. A response with Vary is stored under a variant key derived from
+ * the request headers it names; the base key then holds a small variants
+ * entry listing those names, so the next lookup knows which variant to ask
+ * for. Accept-Encoding is reduced to the codings it accepts, so the many
+ * spellings browsers send do not split the cache.
+ */
+
+#ifndef CATZILLA_HTTP_CACHE_H
+#define CATZILLA_HTTP_CACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "http_headers.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// "CZC1"; entries written in an older format are treated as misses
+#define CATZILLA_HTTP_CACHE_MAGIC 0x31435a43u
+
+// Longest ETag kept, quotes and W/ included
+#define CATZILLA_ETAG_MAX 128
+
+// Longest normalized Vary list ("accept-encoding,accept-language")
+#define CATZILLA_HTTP_CACHE_VARY_LEN_MAX 256
+
+// Bytes a variant suffix adds to a base key ("#" and 8 hex digits)
+#define CATZILLA_HTTP_CACHE_VARIANT_SUFFIX_LEN 9
+
+typedef enum {
+    CATZILLA_CACHED_RESPONSE = 1,   // Status, header block and body
+    CATZILLA_CACHED_VARIANTS = 2    // Vary names; the responses live under variant keys
+} catzilla_cached_kind_t;
+
+/**
+ * Start of every stored entry. A response entry continues with its
+ * NUL-terminated header block, then the body; a variants entry with its
+ * NUL-terminated list of lowercase header names.
+ */
+typedef struct {
+    uint32_t magic;
+    uint32_t kind;
+    int32_t status_code;
+    uint32_t headers_len;         // Header block (or name list) length
+    int64_t last_modified;        // Unix time, -1 when unknown
+    uint32_t etag_offset;         // ETag value inside the header block
+    uint32_t etag_len;            // 0 when the entry has no ETag
+} catzilla_cached_header_t;
+
+// A decoded entry; every pointer points into the entry
+typedef struct {
+    catzilla_cached_kind_t kind;
+    int status_code;
+    const char* headers;          // Formatted "Name: value\r\n" lines, NUL terminated
+    size_t headers_len;
+    const char* body;
+    size_t body_len;
+    const char* etag;
+    size_t etag_len;
+    int64_t last_modified;
+} catzilla_cached_view_t;
+
+// Directives of a Cache-Control header this cache acts on
+typedef struct {
+    bool no_store;
+    bool no_cache;
+    bool is_private;
+    int64_t max_age;              // -1 when absent
+    int64_t s_maxage;             // -1 when absent
+} catzilla_cache_control_t;
+
+/**
+ * Find a field in a formatted "Name: value\r\n" header block
+ * @param headers Header block (may be NULL)
+ * @param name Field name (any case)
+ * @param length_out Receives the value length, surrounding spaces trimmed
+ * @return Start of the first matching value, or NULL if absent
+ */
+const char* catzilla_header_block_get(const char* headers, const char* name, size_t* length_out);
+
+/**
+ * Parse a Cache-Control value
+ * @param value Header value (may be NULL)
+ * @param length Value length
+ * @param out Receives the directives
+ */
+void catzilla_cache_control_parse(const char* value, size_t length, catzilla_cache_control_t* out);
+
+/**
+ * Decide how long a response may be stored. Responses with Set-Cookie,
+ * Vary: *, or Cache-Control no-store, no-cache or private are not stored;
+ * s-maxage, then max-age, override the route's TTL.
+ * @param headers Response header block, or a bare content type
+ * @param route_ttl TTL configured for the route
+ * @return Seconds to store the response, 0 to not store it
+ */
+uint32_t catzilla_http_cache_ttl(const char* headers, uint32_t route_ttl);
+
+/**
+ * Normalize a response's Vary header to a lowercase comma-separated list
+ * @param headers Response header block, or a bare content type
+ * @param out Receives the NUL-terminated list
+ * @param out_size Size of out
+ * @return List length, 0 without Vary, -1 for Vary: * or a list that does not fit
+ */
+int catzilla_http_cache_vary_names(const char* headers, char* out, size_t out_size);
+
+/**
+ * Hash the request headers a Vary list names. Absent and empty headers hash
+ * differently; Accept-Encoding hashes the set of codings it accepts.
+ * @param names Normalized list from catzilla_http_cache_vary_names
+ * @param names_len List length
+ * @param request_headers Request headers
+ * @return Hash for the variant key
+ */
+uint32_t catzilla_http_cache_variant_hash(const char* names, size_t names_len,
+                                          const catzilla_header_set_t* request_headers);
+
+/**
+ * Append the variant suffix to a base key
+ * @param key NUL-terminated base key; must have room for
+ *            CATZILLA_HTTP_CACHE_VARIANT_SUFFIX_LEN more bytes
+ * @param variant_hash Hash from catzilla_http_cache_variant_hash
+ */
+void catzilla_http_cache_variant_key(char* key, uint32_t variant_hash);
+
+/**
+ * Compute the strong ETag of a body
+ * @param body Body bytes
+ * @param body_len Body length
+ * @param out Receives the quoted ETag, NUL terminated (at least 19 bytes)
+ * @return ETag length
+ */
+size_t catzilla_http_etag(const char* body, size_t body_len, char* out);
+
+/**
+ * Check an If-None-Match list against an ETag with the weak comparison
+ * @param list If-None-Match value
+ * @param list_len Value length
+ * @param etag ETag, quotes included
+ * @param etag_len ETag length
+ * @return true if the list is "*" or holds the ETag
+ */
+bool catzilla_http_etag_matches(const char* list, size_t list_len, const char* etag, size_t etag_len);
+
+/**
+ * Build a response entry. Date is dropped from the stored headers, a bare
+ * content type becomes a Content-Type field, and ETag and Last-Modified
+ * are added when the handler did not set them.
+ * @param status_code Response status
+ * @param headers Response header block, or a bare content type (may be NULL)
+ * @param body Body bytes
+ * @param body_len Body length
+ * @param now Unix time used for Last-Modified
+ * @param size_out Receives the entry size
+ * @return Entry allocated with catzilla_response_alloc, or NULL
+ */
+char* catzilla_http_cache_encode(int status_code, const char* headers, const char* body,
+                                 size_t body_len, int64_t now, size_t* size_out);
+
+/**
+ * Build a variants entry for a base key
+ * @param names Normalized Vary list
+ * @param names_len List length
+ * @param size_out Receives the entry size
+ * @return Entry allocated with catzilla_response_alloc, or NULL
+ */
+char* catzilla_http_cache_encode_variants(const char* names, size_t names_len, size_t* size_out);
+
+/**
+ * Decode an entry without copying it
+ * @param entry Entry bytes
+ * @param size Entry size
+ * @param view Receives the decoded entry
+ * @return false if the entry is malformed or in another format
+ */
+bool catzilla_http_cache_decode(const char* entry, size_t size, catzilla_cached_view_t* view);
+
+/**
+ * Evaluate a request's preconditions against a stored response.
+ * If-None-Match wins over If-Modified-Since, which needs a Last-Modified.
+ * @param view Decoded response entry
+ * @param request_headers Request headers
+ * @return true if the request can be answered with 304 Not Modified
+ */
+bool catzilla_http_cache_not_modified(const catzilla_cached_view_t* view,
+                                      const catzilla_header_set_t* request_headers);
+
+/**
+ * Build the header block of a 304 for a stored response: its ETag,
+ * Last-Modified, Cache-Control, Expires, Vary and Content-Location fields,
+ * and the Content-Length a 200 would have had
+ * @param view Decoded response entry
+ * @param out Receives the NUL-terminated block
+ * @param out_size Size of out; view->headers_len + 48 always fits
+ * @return Block length, or 0 if it does not fit
+ */
+size_t catzilla_http_cache_not_modified_headers(const catzilla_cached_view_t* view,
+                                                char* out, size_t out_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CATZILLA_HTTP_CACHE_H
@@ -0,0 +1,295 @@
+#include "http_headers.h"
+#include "memory.h"
+#include "platform_compat.h"
+#include <string.h>
+#ifndef _WIN32
+#include <strings.h>  // For strncasecmp on POSIX systems
+#endif
+
+#define CATZILLA_HDR_HASH_SIZE 64
+#define CATZILLA_HDR_MIN_LENGTH 4
+#define CATZILLA_HDR_MAX_LENGTH 17
+
+// Initial data block size; one block per connection is reused across requests
+#define CATZILLA_HEADER_DATA_INITIAL 1024
+
+enum {
+    HEADER_BUILD_NONE = 0,
+    HEADER_BUILD_NAME = 1,
+    HEADER_BUILD_VALUE = 2
+};
+
+typedef struct {
+    const char* name;
+    uint8_t length;
+    int8_t id;
+} known_header_slot_t;
+
+static const char* const known_header_names[CATZILLA_HDR_COUNT] = {
+#define CATZILLA_HDR_NAME(id, name) name,
+    CATZILLA_KNOWN_HEADER_LIST(CATZILLA_HDR_NAME)
+#undef CATZILLA_HDR_NAME
+};
+
+/*
+ * Perfect hash over CATZILLA_KNOWN_HEADER_LIST:
+ *   (len + 2*first + 28*last + middle) & 63, characters folded to lowercase.
+ * Every known name lands in its own bucket, so a lookup is one hash and one
+ * case-insensitive compare. Adding a header means re-checking the table
+ * (test_http_headers verifies every name resolves to itself).
+ */
+static const known_header_slot_t known_header_table[CATZILLA_HDR_HASH_SIZE] = {
+    [0] = { "authorization", 13, CATZILLA_HDR_AUTHORIZATION },
+    [3] = { "cookie", 6, CATZILLA_HDR_COOKIE },
+    [5] = { "user-agent", 10, CATZILLA_HDR_USER_AGENT },
+    [6] = { "cache-control", 13, CATZILLA_HDR_CACHE_CONTROL },
+    [8] = { "referer", 7, CATZILLA_HDR_REFERER },
+    [9] = { "accept-language", 15, CATZILLA_HDR_ACCEPT_LANGUAGE },
+    [17] = { "x-request-id", 12, CATZILLA_HDR_X_REQUEST_ID },
+    [18] = { "content-type", 12, CATZILLA_HDR_CONTENT_TYPE },
+    [19] = { "origin", 6, CATZILLA_HDR_ORIGIN },
+    [24] = { "if-modified-since", 17, CATZILLA_HDR_IF_MODIFIED_SINCE },
+    [26] = { "x-real-ip", 9, CATZILLA_HDR_X_REAL_IP },
+    [29] = { "accept", 6, CATZILLA_HDR_ACCEPT },
+    [33] = { "content-length", 14, CATZILLA_HDR_CONTENT_LENGTH },
+    [34] = { "sec-websocket-key", 17, CATZILLA_HDR_SEC_WEBSOCKET_KEY },
+    [35] = { "range", 5, CATZILLA_HDR_RANGE },
+    [36] = { "if-none-match", 13, CATZILLA_HDR_IF_NONE_MATCH },
+    [37] = { "expect", 6, CATZILLA_HDR_EXPECT },
+    [41] = { "x-forwarded-for", 15, CATZILLA_HDR_X_FORWARDED_FOR },
+    [42] = { "transfer-encoding", 17, CATZILLA_HDR_TRANSFER_ENCODING },
+    [47] = { "upgrade", 7, CATZILLA_HDR_UPGRADE },
+    [55] = { "host", 4, CATZILLA_HDR_HOST },
+    [58] = { "accept-encoding", 15, CATZILLA_HDR_ACCEPT_ENCODING },
+    [59] = { "connection", 10, CATZILLA_HDR_CONNECTION },
+    [63] = { "content-encoding", 16, CATZILLA_HDR_CONTENT_ENCODING },
+};
+
+int catzilla_known_header_lookup(const char* name, size_t length) {
+    if (!name || length < CATZILLA_HDR_MIN_LENGTH || length > CATZILLA_HDR_MAX_LENGTH) {
+        return CATZILLA_HDR_UNKNOWN;
+    }
+
+    // OR-ing 0x20 lowercases letters and leaves '-' unchanged
+    unsigned int first = (unsigned char)name[0] | 0x20;
+    unsigned int last = (unsigned char)name[length - 1] | 0x20;
+    unsigned int middle = (unsigned char)name[length / 2] | 0x20;
+    unsigned int hash = ((unsigned int)length + 2 * first + 28 * last + middle) & (CATZILLA_HDR_HASH_SIZE - 1);
+
+    const known_header_slot_t* slot = &known_header_table[hash];
+    if (slot->name && slot->length == length && strncasecmp(slot->name, name, length) == 0) {
+        return slot->id;
+    }
+    return CATZILLA_HDR_UNKNOWN;
+}
+
+const char* catzilla_known_header_name(int id) {
+    if (id < 0 || id >= CATZILLA_HDR_COUNT) {
+        return NULL;
+    }
+    return known_header_names[id];
+}
+
+void catzilla_header_set_init(catzilla_header_set_t* set) {
+    if (!set) return;
+    memset(set, 0, sizeof(*set));
+}
+
+void catzilla_header_set_reset(catzilla_header_set_t* set) {
+    if (!set) return;
+    set->data_length = 0;
+    set->count = 0;
+    set->building = HEADER_BUILD_NONE;
+    memset(set->known, 0, sizeof(set->known));
+}
+
+void catzilla_header_set_free(catzilla_header_set_t* set) {
+    if (!set) return;
+    if (set->data) {
+        catzilla_cache_free(set->data);
+    }
+    catzilla_header_set_init(set);
+}
+
+static int header_set_reserve(catzilla_header_set_t* set, size_t extra) {
+    size_t required = (size_t)set->data_length + extra;
+    if (required > CATZILLA_HEADER_DATA_MAX) {
+        return -1;
+    }
+    if (required <= set->data_capacity) {
+        return 0;
+    }
+
+    size_t capacity = set->data_capacity ? set->data_capacity : CATZILLA_HEADER_DATA_INITIAL;
+    while (capacity < required) {
+        capacity *= 2;
+    }
+    if (capacity > CATZILLA_HEADER_DATA_MAX) {
+        capacity = CATZILLA_HEADER_DATA_MAX;
+    }
+
+    char* data = catzilla_cache_realloc(set->data, capacity);
+    if (!data) {
+        return -1;
+    }
+    set->data = data;
+    set->data_capacity = (uint32_t)capacity;
+    return 0;
+}
+
+static int header_set_append(catzilla_header_set_t* set, const char* at, size_t length) {
+    // Reserve one extra byte so the terminator always fits
+    if (header_set_reserve(set, length + 1) != 0) {
+        return -1;
+    }
+    memcpy(set->data + set->data_length, at, length);
+    set->data_length += (uint32_t)length;
+    return 0;
+}
+
+static int header_set_terminate(catzilla_header_set_t* set) {
+    if (header_set_reserve(set, 1) != 0) {
+        return -1;
+    }
+    set->data[set->data_length++] = '\0';
+    return 0;
+}
+
+int catzilla_header_set_append_name(catzilla_header_set_t* set, const char* at, size_t length) {
+    if (!set) return -1;
+
+    // Headers beyond the entry limit are parsed but not stored
+    if (set->count >= CATZILLA_MAX_HEADERS) {
+        return 0;
+    }
+
+    catzilla_header_t* header = &set->entries[set->count];
+    if (set->building != HEADER_BUILD_NAME) {
+        header->name_offset = set->data_length;
+        header->name_length = 0;
+        header->value_offset = 0;
+        header->value_length = 0;
+        set->building = HEADER_BUILD_NAME;
+    }
+
+    if (header_set_append(set, at, length) != 0) {
+        return -1;
+    }
+    header->name_length += (uint32_t)length;
+    return 0;
+}
+
+static int header_set_begin_value(catzilla_header_set_t* set, catzilla_header_t* header) {
+    if (header_set_terminate(set) != 0) {
+        return -1;
+    }
+    header->value_offset = set->data_length;
+    header->value_length = 0;
+    set->building = HEADER_BUILD_VALUE;
+    return 0;
+}
+
+int catzilla_header_set_append_value(catzilla_header_set_t* set, const char* at, size_t length) {
+    if (!set) return -1;
+    if (set->count >= CATZILLA_MAX_HEADERS || set->building == HEADER_BUILD_NONE) {
+        return 0;
+    }
+
+    catzilla_header_t* header = &set->entries[set->count];
+    if (set->building == HEADER_BUILD_NAME && header_set_begin_value(set, header) != 0) {
+        return -1;
+    }
+
+    if (header_set_append(set, at, length) != 0) {
+        return -1;
+    }
+    header->value_length += (uint32_t)length;
+    return 0;
+}
+
+int catzilla_header_set_commit(catzilla_header_set_t* set) {
+    if (!set || set->count >= CATZILLA_MAX_HEADERS || set->building == HEADER_BUILD_NONE) {
+        if (set) set->building = HEADER_BUILD_NONE;
+        return -1;
+    }
+
+    catzilla_header_t* header = &set->entries[set->count];
+
+    // Empty values produce no value callback
+    if (set->building == HEADER_BUILD_NAME && header_set_begin_value(set, header) != 0) {
+        set->building = HEADER_BUILD_NONE;
+        return -1;
+    }
+    set->building = HEADER_BUILD_NONE;
+    if (header_set_terminate(set) != 0) {
+        return -1;
+    }
+
+    int index = set->count++;
+    int id = catzilla_known_header_lookup(set->data + header->name_offset, header->name_length);
+    // First occurrence wins, matching the old linear search
+    if (id != CATZILLA_HDR_UNKNOWN && set->known[id] == 0) {
+        set->known[id] = (uint8_t)(index + 1);
+    }
+    return index;
+}
+
+int catzilla_header_set_copy(catzilla_header_set_t* dst, const catzilla_header_set_t* src) {
+    if (!dst || !src) return -1;
+
+    if (dst->data) {
+        catzilla_cache_free(dst->data);
+    }
+    memcpy(dst, src, sizeof(*dst));
+    dst->data = NULL;
+    dst->data_capacity = 0;
+    dst->building = HEADER_BUILD_NONE;
+
+    if (src->data_length == 0) {
+        dst->data_length = 0;
+        return 0;
+    }
+
+    dst->data = catzilla_cache_alloc(src->data_length);
+    if (!dst->data) {
+        catzilla_header_set_init(dst);
+        return -1;
+    }
+    memcpy(dst->data, src->data, src->data_length);
+    dst->data_capacity = src->data_length;
+    return 0;
+}
+
+const char* catzilla_header_set_get_known(const catzilla_header_set_t* set, int id, size_t* length_out) {
+    if (length_out) *length_out = 0;
+    if (!set || id < 0 || id >= CATZILLA_HDR_COUNT || set->known[id] == 0) {
+        return NULL;
+    }
+
+    const catzilla_header_t* header = &set->entries[set->known[id] - 1];
+    if (length_out) *length_out = header->value_length;
+    return set->data + header->value_offset;
+}
+
+const char* catzilla_header_set_get(const catzilla_header_set_t* set, const char* name, size_t* length_out) {
+    if (length_out) *length_out = 0;
+    if (!set || !name) {
+        return NULL;
+    }
+
+    size_t name_length = strlen(name);
+    int id = catzilla_known_header_lookup(name, name_length);
+    if (id != CATZILLA_HDR_UNKNOWN) {
+        return catzilla_header_set_get_known(set, id, length_out);
+    }
+
+    for (int i = 0; i < set->count; i++) {
+        const catzilla_header_t* header = &set->entries[i];
+        if (header->name_length == name_length &&
+            strncasecmp(set->data + header->name_offset, name, name_length) == 0) {
+            if (length_out) *length_out = header->value_length;
+            return set->data + header->value_offset;
+        }
+    }
+    return NULL;
+}
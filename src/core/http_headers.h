@@ -0,0 +1,176 @@
+#ifndef CATZILLA_HTTP_HEADERS_H
+#define CATZILLA_HTTP_HEADERS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CATZILLA_MAX_HEADERS 50
+
+// Upper bound on the bytes a single request may spend on header names and values
+#define CATZILLA_HEADER_DATA_MAX (64 * 1024)
+
+// Well-known headers resolved at parse time into a fixed slot table
+#define CATZILLA_KNOWN_HEADER_LIST(X) \
+    X(HOST, "host") \
+    X(CONTENT_TYPE, "content-type") \
+    X(CONTENT_LENGTH, "content-length") \
+    X(CONNECTION, "connection") \
+    X(ACCEPT, "accept") \
+    X(ACCEPT_ENCODING, "accept-encoding") \
+    X(ACCEPT_LANGUAGE, "accept-language") \
+    X(AUTHORIZATION, "authorization") \
+    X(COOKIE, "cookie") \
+    X(IF_NONE_MATCH, "if-none-match") \
+    X(IF_MODIFIED_SINCE, "if-modified-since") \
+    X(USER_AGENT, "user-agent") \
+    X(TRANSFER_ENCODING, "transfer-encoding") \
+    X(UPGRADE, "upgrade") \
+    X(ORIGIN, "origin") \
+    X(REFERER, "referer") \
+    X(X_FORWARDED_FOR, "x-forwarded-for") \
+    X(X_REQUEST_ID, "x-request-id") \
+    X(CACHE_CONTROL, "cache-control") \
+    X(RANGE, "range") \
+    X(EXPECT, "expect") \
+    X(CONTENT_ENCODING, "content-encoding") \
+    X(SEC_WEBSOCKET_KEY, "sec-websocket-key") \
+    X(X_REAL_IP, "x-real-ip")
+
+typedef enum {
+    CATZILLA_HDR_UNKNOWN = -1,
+#define CATZILLA_HDR_ENUM(id, name) CATZILLA_HDR_##id,
+    CATZILLA_KNOWN_HEADER_LIST(CATZILLA_HDR_ENUM)
+#undef CATZILLA_HDR_ENUM
+    CATZILLA_HDR_COUNT
+} catzilla_known_header_t;
+
+/**
+ * One request header, stored as slices into its header set's data block.
+ * Names and values are NUL terminated inside the block.
+ */
+typedef struct catzilla_header_s {
+    uint32_t name_offset;
+    uint32_t name_length;
+    uint32_t value_offset;
+    uint32_t value_length;
+} catzilla_header_t;
+
+/**
+ * All headers of one request: a single contiguous data block holding every
+ * name and value, the slices into it, and O(1) slots for well-known headers
+ */
+typedef struct catzilla_header_set_s {
+    char* data;
+    uint32_t data_length;
+    uint32_t data_capacity;
+    catzilla_header_t entries[CATZILLA_MAX_HEADERS];
+    int count;
+    uint8_t known[CATZILLA_HDR_COUNT];  // Entry index + 1, 0 when absent
+    uint8_t building;                   // Parse state of the header being appended
+} catzilla_header_set_t;
+
+/**
+ * Resolve a header name to its well-known slot using the perfect hash
+ * @param name Header name (any case, not necessarily NUL terminated)
+ * @param length Name length
+ * @return Slot id, or CATZILLA_HDR_UNKNOWN
+ */
+int catzilla_known_header_lookup(const char* name, size_t length);
+
+/**
+ * Get the lowercase name of a well-known header
+ * @param id Slot id
+ * @return Static name, or NULL for an invalid id
+ */
+const char* catzilla_known_header_name(int id);
+
+/**
+ * Initialize an empty header set
+ * @param set Header set
+ */
+void catzilla_header_set_init(catzilla_header_set_t* set);
+
+/**
+ * Drop all headers but keep the data block for the next request
+ * @param set Header set
+ */
+void catzilla_header_set_reset(catzilla_header_set_t* set);
+
+/**
+ * Release the data block
+ * @param set Header set
+ */
+void catzilla_header_set_free(catzilla_header_set_t* set);
+
+/**
+ * Append a piece of the header name being parsed. The parser may deliver a
+ * name in several pieces when it spans reads.
+ * @param set Header set
+ * @param at Name bytes
+ * @param length Number of bytes
+ * @return 0 on success, -1 on allocation failure or size limit
+ */
+int catzilla_header_set_append_name(catzilla_header_set_t* set, const char* at, size_t length);
+
+/**
+ * Append a piece of the header value being parsed
+ * @param set Header set
+ * @param at Value bytes
+ * @param length Number of bytes
+ * @return 0 on success, -1 on allocation failure or size limit
+ */
+int catzilla_header_set_append_value(catzilla_header_set_t* set, const char* at, size_t length);
+
+/**
+ * Finish the header being parsed and resolve its well-known slot.
+ * Headers beyond CATZILLA_MAX_HEADERS are dropped.
+ * @param set Header set
+ * @return Entry index, or -1 if the header was dropped or on failure
+ */
+int catzilla_header_set_commit(catzilla_header_set_t* set);
+
+/**
+ * Copy a header set with a single allocation for the data block
+ * @param dst Destination (initialized or zeroed; previous data is freed)
+ * @param src Source
+ * @return 0 on success, -1 on allocation failure
+ */
+int catzilla_header_set_copy(catzilla_header_set_t* dst, const catzilla_header_set_t* src);
+
+/**
+ * Get a well-known header value in O(1)
+ * @param set Header set
+ * @param id Slot id
+ * @param length_out Receives the value length (may be NULL)
+ * @return NUL terminated value, or NULL if absent
+ */
+const char* catzilla_header_set_get_known(const catzilla_header_set_t* set, int id, size_t* length_out);
+
+/**
+ * Get a header value by name. Well-known names are resolved through the
+ * slot table; other names fall back to a case-insensitive scan.
+ * @param set Header set
+ * @param name Header name (any case)
+ * @param length_out Receives the value length (may be NULL)
+ * @return NUL terminated value, or NULL if absent
+ */
+const char* catzilla_header_set_get(const catzilla_header_set_t* set, const char* name, size_t* length_out);
+
+static inline const char* catzilla_header_name(const catzilla_header_set_t* set, const catzilla_header_t* header) {
+    return set->data + header->name_offset;
+}
+
+static inline const char* catzilla_header_value(const catzilla_header_set_t* set, const catzilla_header_t* header) {
+    return set->data + header->value_offset;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CATZILLA_HTTP_HEADERS_H
@@ -0,0 +1,265 @@
+#include "http_response.h"
+#include "platform_compat.h"
+#include <string.h>
+#include <time.h>
+
+// Standard status codes (RFC 9110 plus common extensions)
+#define CATZILLA_HTTP_STATUS_LIST(X) \
+    X(100, "Continue") \
+    X(101, "Switching Protocols") \
+    X(102, "Processing") \
+    X(103, "Early Hints") \
+    X(200, "OK") \
+    X(201, "Created") \
+    X(202, "Accepted") \
+    X(203, "Non-Authoritative Information") \
+    X(204, "No Content") \
+    X(205, "Reset Content") \
+    X(206, "Partial Content") \
+    X(207, "Multi-Status") \
+    X(208, "Already Reported") \
+    X(226, "IM Used") \
+    X(300, "Multiple Choices") \
+    X(301, "Moved Permanently") \
+    X(302, "Found") \
+    X(303, "See Other") \
+    X(304, "Not Modified") \
+    X(305, "Use Proxy") \
+    X(307, "Temporary Redirect") \
+    X(308, "Permanent Redirect") \
+    X(400, "Bad Request") \
+    X(401, "Unauthorized") \
+    X(402, "Payment Required") \
+    X(403, "Forbidden") \
+    X(404, "Not Found") \
+    X(405, "Method Not Allowed") \
+    X(406, "Not Acceptable") \
+    X(407, "Proxy Authentication Required") \
+    X(408, "Request Timeout") \
+    X(409, "Conflict") \
+    X(410, "Gone") \
+    X(411, "Length Required") \
+    X(412, "Precondition Failed") \
+    X(413, "Payload Too Large") \
+    X(414, "URI Too Long") \
+    X(415, "Unsupported Media Type") \
+    X(416, "Range Not Satisfiable") \
+    X(417, "Expectation Failed") \
+    X(418, "I'm a teapot") \
+    X(421, "Misdirected Request") \
+    X(422, "Unprocessable Entity") \
+    X(423, "Locked") \
+    X(424, "Failed Dependency") \
+    X(425, "Too Early") \
+    X(426, "Upgrade Required") \
+    X(428, "Precondition Required") \
+    X(429, "Too Many Requests") \
+    X(431, "Request Header Fields Too Large") \
+    X(451, "Unavailable For Legal Reasons") \
+    X(500, "Internal Server Error") \
+    X(501, "Not Implemented") \
+    X(502, "Bad Gateway") \
+    X(503, "Service Unavailable") \
+    X(504, "Gateway Timeout") \
+    X(505, "HTTP Version Not Supported") \
+    X(506, "Variant Also Negotiates") \
+    X(507, "Insufficient Storage") \
+    X(508, "Loop Detected") \
+    X(510, "Not Extended") \
+    X(511, "Network Authentication Required")
+
+#define STATUS_LINE_CASE(code, text) \
+    case code: \
+        if (len_out) *len_out = sizeof("HTTP/1.1 " #code " " text "\r\n") - 1; \
+        return "HTTP/1.1 " #code " " text "\r\n";
+
+#define STATUS_TEXT_CASE(code, text) \
+    case code: return text;
+
+const char* catzilla_http_status_line(int status_code, size_t* len_out) {
+    switch (status_code) {
+        CATZILLA_HTTP_STATUS_LIST(STATUS_LINE_CASE)
+        default:
+            if (len_out) *len_out = 0;
+            return NULL;
+    }
+}
+
+const char* catzilla_http_status_text(int status_code) {
+    switch (status_code) {
+        CATZILLA_HTTP_STATUS_LIST(STATUS_TEXT_CASE)
+        default:
+            return "Unknown";
+    }
+}
+
+#undef STATUS_LINE_CASE
+#undef STATUS_TEXT_CASE
+
+size_t catzilla_u64toa(uint64_t value, char* out) {
+    static const char digit_pairs[201] =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899";
+
+    char tmp[CATZILLA_U64_DIGITS_MAX];
+    char* p = tmp + sizeof(tmp);
+
+    // Emit two digits per division, back to front
+    while (value >= 100) {
+        unsigned idx = (unsigned)(value % 100) * 2;
+        value /= 100;
+        *--p = digit_pairs[idx + 1];
+        *--p = digit_pairs[idx];
+    }
+    if (value >= 10) {
+        unsigned idx = (unsigned)value * 2;
+        *--p = digit_pairs[idx + 1];
+        *--p = digit_pairs[idx];
+    } else {
+        *--p = (char)('0' + value);
+    }
+
+    size_t len = (size_t)(tmp + sizeof(tmp) - p);
+    memcpy(out, p, len);
+    return len;
+}
+
+// Per-thread Date cache: each event loop thread owns its own copy, so the
+// hot path never takes a lock or formats a date
+typedef struct {
+    char line[CATZILLA_DATE_HEADER_LEN + 1];
+    time_t second;
+    int timer_driven;
+} date_cache_t;
+
+static CATZILLA_THREAD_LOCAL date_cache_t date_cache;
+
+static void put2(char* out, int value) {
+    out[0] = (char)('0' + value / 10);
+    out[1] = (char)('0' + value % 10);
+}
+
+static const char date_days[7][4] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+static const char date_months[12][4] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                        "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+size_t catzilla_http_date_format(int64_t seconds, char* out) {
+    time_t when = (time_t)seconds;
+    struct tm tm;
+#ifdef _WIN32
+    gmtime_s(&tm, &when);
+#else
+    gmtime_r(&when, &tm);
+#endif
+
+    // IMF-fixdate (RFC 7231 section 7.1.1.1), formatted without the locale
+    char* p = out;
+    memcpy(p, date_days[tm.tm_wday], 3); p += 3;
+    *p++ = ',';
+    *p++ = ' ';
+    put2(p, tm.tm_mday); p += 2;
+    *p++ = ' ';
+    memcpy(p, date_months[tm.tm_mon], 3); p += 3;
+    *p++ = ' ';
+    int year = tm.tm_year + 1900;
+    put2(p, year / 100); p += 2;
+    put2(p, year % 100); p += 2;
+    *p++ = ' ';
+    put2(p, tm.tm_hour); p += 2;
+    *p++ = ':';
+    put2(p, tm.tm_min); p += 2;
+    *p++ = ':';
+    put2(p, tm.tm_sec); p += 2;
+    memcpy(p, " GMT", 4); p += 4;
+    *p = '\0';
+    return CATZILLA_HTTP_DATE_LEN;
+}
+
+static int parse_digits(const char* p, int count) {
+    int value = 0;
+    for (int i = 0; i < count; i++) {
+        if (p[i] < '0' || p[i] > '9') return -1;
+        value = value * 10 + (p[i] - '0');
+    }
+    return value;
+}
+
+int64_t catzilla_http_date_parse(const char* value, size_t length) {
+    // "Sun, 06 Nov 1994 08:49:37 GMT"
+    if (!value || length != CATZILLA_HTTP_DATE_LEN || value[3] != ',' || value[4] != ' ' ||
+        value[7] != ' ' || value[11] != ' ' || value[16] != ' ' || value[19] != ':' ||
+        value[22] != ':' || memcmp(value + 25, " GMT", 4) != 0) {
+        return -1;
+    }
+    int month = -1;
+    for (int i = 0; i < 12; i++) {
+        if (memcmp(value + 8, date_months[i], 3) == 0) month = i + 1;
+    }
+    int day = parse_digits(value + 5, 2);
+    int year = parse_digits(value + 12, 4);
+    int hour = parse_digits(value + 17, 2);
+    int minute = parse_digits(value + 20, 2);
+    int second = parse_digits(value + 23, 2);
+    if (month < 0 || day < 1 || day > 31 || year < 1970 || hour < 0 || hour > 23 ||
+        minute < 0 || minute > 59 || second < 0 || second > 60) {
+        return -1;
+    }
+
+    // Days since the epoch for a proleptic Gregorian date, without timegm
+    int y = month <= 2 ? year - 1 : year;
+    int era = y / 400;
+    int year_of_era = y - era * 400;
+    int day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    int64_t days = (int64_t)era * 146097 + day_of_era - 719468;
+    return days * 86400 + hour * 3600 + minute * 60 + second;
+}
+
+static void format_date_line(time_t now) {
+    memcpy(date_cache.line, "Date: ", 6);
+    catzilla_http_date_format((int64_t)now, date_cache.line + 6);
+    memcpy(date_cache.line + 6 + CATZILLA_HTTP_DATE_LEN, "\r\n", 3);
+    date_cache.second = now;
+}
+
+static void on_date_timer(uv_timer_t* timer) {
+    (void)timer;
+    format_date_line(time(NULL));
+}
+
+int catzilla_date_cache_start(uv_loop_t* loop, uv_timer_t* timer) {
+    format_date_line(time(NULL));
+
+    int rc = uv_timer_init(loop, timer);
+    if (rc) return rc;
+
+    rc = uv_timer_start(timer, on_date_timer, 1000, 1000);
+    if (rc) return rc;
+
+    // The refresh timer alone must not keep the loop running
+    uv_unref((uv_handle_t*)timer);
+    date_cache.timer_driven = 1;
+    return 0;
+}
+
+void catzilla_date_cache_stop(void) {
+    date_cache.timer_driven = 0;
+}
+
+const char* catzilla_date_header(void) {
+    if (!date_cache.timer_driven) {
+        time_t now = time(NULL);
+        if (now != date_cache.second || date_cache.line[0] == '\0') {
+            format_date_line(now);
+        }
+    }
+    return date_cache.line;
+}
@@ -0,0 +1,89 @@
+#ifndef CATZILLA_HTTP_RESPONSE_H
+#define CATZILLA_HTTP_RESPONSE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <uv.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// "Date: Sun, 06 Nov 1994 08:49:37 GMT\r\n" is always 37 bytes
+#define CATZILLA_DATE_HEADER_LEN 37
+
+// "Sun, 06 Nov 1994 08:49:37 GMT" without a terminator
+#define CATZILLA_HTTP_DATE_LEN 29
+
+// Longest decimal uint64_t plus terminator
+#define CATZILLA_U64_DIGITS_MAX 21
+
+/**
+ * Get the preformatted "HTTP/1.1 NNN Reason\r\n" line for a status code
+ * @param status_code HTTP status code
+ * @param len_out Receives the line length (may be NULL)
+ * @return Static status line, or NULL for codes outside the standard table
+ */
+const char* catzilla_http_status_line(int status_code, size_t* len_out);
+
+/**
+ * Get the reason phrase for a status code
+ * @param status_code HTTP status code
+ * @return Static reason phrase, "Unknown" for codes outside the standard table
+ */
+const char* catzilla_http_status_text(int status_code);
+
+/**
+ * Write a decimal representation of value (no terminator)
+ * @param value Value to format
+ * @param out Buffer of at least CATZILLA_U64_DIGITS_MAX bytes
+ * @return Number of characters written
+ */
+size_t catzilla_u64toa(uint64_t value, char* out);
+
+/**
+ * Format a time as an IMF-fixdate HTTP-date
+ * @param seconds Unix time
+ * @param out Buffer of at least CATZILLA_HTTP_DATE_LEN + 1 bytes
+ * @return CATZILLA_HTTP_DATE_LEN
+ */
+size_t catzilla_http_date_format(int64_t seconds, char* out);
+
+/**
+ * Parse an IMF-fixdate HTTP-date. The obsolete RFC 850 and asctime forms
+ * are not accepted; callers treat them like a missing date.
+ * @param value Date text (not necessarily NUL terminated)
+ * @param length Text length
+ * @return Unix time, or -1 if the text is not an IMF-fixdate
+ */
+int64_t catzilla_http_date_parse(const char* value, size_t length);
+
+/**
+ * Start refreshing the calling thread's cached Date header once per second.
+ * Must be called on the thread that runs loop; the timer is unref'd so it
+ * never keeps the loop alive on its own.
+ * @param loop Event loop driving the current thread
+ * @param timer Timer handle owned by the caller, closed with the loop
+ * @return 0 on success, libuv error code on failure
+ */
+int catzilla_date_cache_start(uv_loop_t* loop, uv_timer_t* timer);
+
+/**
+ * Mark the calling thread's Date cache as no longer timer driven.
+ * Call after the loop passed to catzilla_date_cache_start has stopped.
+ */
+void catzilla_date_cache_stop(void);
+
+/**
+ * Get the cached "Date: ...\r\n" header line for the calling thread.
+ * Threads without a refresh timer format it on first use and whenever the
+ * second changes.
+ * @return Header line of CATZILLA_DATE_HEADER_LEN bytes (NUL terminated)
+ */
+const char* catzilla_date_header(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CATZILLA_HTTP_RESPONSE_H
@@ -131,6 +131,11 @@ static inline int catzilla_debug_enabled() {
 #define LOG_MEMORY_ERROR(fmt, ...)     LOG_ERROR("Memory", fmt, ##__VA_ARGS__)
 #define LOG_MEMORY_WARN(fmt, ...)      LOG_WARN("Memory", fmt, ##__VA_ARGS__)
 
+#define LOG_CACHE_DEBUG(fmt, ...)      LOG_DEBUG("Cache", fmt, ##__VA_ARGS__)
+#define LOG_CACHE_INFO(fmt, ...)       LOG_INFO("Cache", fmt, ##__VA_ARGS__)
+#define LOG_CACHE_ERROR(fmt, ...)      LOG_ERROR("Cache", fmt, ##__VA_ARGS__)
+#define LOG_CACHE_WARN(fmt, ...)       LOG_WARN("Cache", fmt, ##__VA_ARGS__)
+
 #define LOG_STREAM_DEBUG(fmt, ...)     LOG_DEBUG("Stream", fmt, ##__VA_ARGS__)
 #define LOG_STREAM_INFO(fmt, ...)      LOG_INFO("Stream", fmt, ##__VA_ARGS__)
 #define LOG_STREAM_ERROR(fmt, ...)     LOG_ERROR("Stream", fmt, ##__VA_ARGS__)
@@ -151,6 +156,11 @@ static inline int catzilla_debug_enabled() {
 #define LOG_PERF_ERROR(fmt, ...)       LOG_ERROR("Performance", fmt, ##__VA_ARGS__)
 #define LOG_PERF_WARN(fmt, ...)        LOG_WARN("Performance", fmt, ##__VA_ARGS__)
 
+#define LOG_TASK_DEBUG(fmt, ...)       LOG_DEBUG("Tasks", fmt, ##__VA_ARGS__)
+#define LOG_TASK_INFO(fmt, ...)        LOG_INFO("Tasks", fmt, ##__VA_ARGS__)
+#define LOG_TASK_ERROR(fmt, ...)       LOG_ERROR("Tasks", fmt, ##__VA_ARGS__)
+#define LOG_TASK_WARN(fmt, ...)        LOG_WARN("Tasks", fmt, ##__VA_ARGS__)
+
 // Missing function declaration for compatibility
 #ifndef strcasestr
 char* strcasestr(const char* haystack, const char* needle);
@@ -12,6 +12,11 @@
 #include <string.h>
 #include <assert.h>
 #include <time.h>
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#elif defined(__GLIBC__)
+#include <malloc.h>
+#endif
 
 // ============================================================================
 // 🚀 CATZILLA MEMORY SYSTEM - CONDITIONAL JEMALLOC SUPPORT
@@ -70,6 +75,23 @@ static bool g_memory_initialized = false;
 static bool g_profiling_enabled = false;
 static catzilla_allocator_type_t g_current_allocator = CATZILLA_ALLOCATOR_MALLOC;
 
+#if defined(CATZILLA_HAS_JEMALLOC) && defined(CATZILLA_JEMALLOC_PROF)
+// Heap profiling has to be on from the first allocation, so it is switched
+// on here with sampling inactive until catzilla_memory_profiler_start.
+// MALLOC_CONF in the environment still overrides these.
+#define CATZILLA_PROF_CONF "prof:true,prof_active:false,prof_accum:false,lg_prof_sample:19"
+#if CATZILLA_JEMALLOC_USES_PREFIX
+const char* je_malloc_conf = CATZILLA_PROF_CONF;
+#else
+const char* malloc_conf = CATZILLA_PROF_CONF;
+#endif
+#endif
+
+static bool g_profiler_active = false;
+static bool g_profiler_started = false;   // Some samples may exist to dump
+static unsigned g_profiler_lg_sample = CATZILLA_PROFILER_DEFAULT_LG_SAMPLE;
+static uint64_t g_profiler_dumps = 0;
+
 static void catzilla_memory_configure_jemalloc_runtime(void) {
 #ifdef CATZILLA_HAS_JEMALLOC
     if (g_current_allocator != CATZILLA_ALLOCATOR_JEMALLOC) {
@@ -862,6 +884,125 @@ int catzilla_memory_get_arena_stats(catzilla_memory_type_t type, size_t* allocat
     return 0;
 }
 
+size_t catzilla_memory_get_rss(void) {
+#if defined(__linux__)
+    FILE* statm = fopen("/proc/self/statm", "r");
+    if (statm) {
+        unsigned long pages = 0, resident = 0;
+        int fields = fscanf(statm, "%lu %lu", &pages, &resident);
+        fclose(statm);
+        if (fields == 2) return (size_t)resident * (size_t)sysconf(_SC_PAGESIZE);
+    }
+#elif defined(__APPLE__)
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) == KERN_SUCCESS) {
+        return (size_t)info.resident_size;
+    }
+#endif
+
+    // Elsewhere only the allocator's own view is available
+    catzilla_memory_stats_t stats;
+    memset(&stats, 0, sizeof(stats));
+    catzilla_memory_get_stats(&stats);
+    return stats.resident;
+}
+
+void catzilla_memory_release_unused(bool purge) {
+#ifdef CATZILLA_HAS_JEMALLOC
+    if (g_current_allocator == CATZILLA_ALLOCATOR_JEMALLOC) {
+        // decay returns pages past their decay time, purge all unused ones
+        const char* op = purge ? "purge" : "decay";
+        unsigned arenas[] = {
+            g_memory_stats.request_arena, g_memory_stats.response_arena, g_memory_stats.cache_arena,
+            g_memory_stats.static_arena, g_memory_stats.task_arena
+        };
+        char arena_cmd[64];
+        for (size_t i = 0; i < sizeof(arenas) / sizeof(arenas[0]); i++) {
+            snprintf(arena_cmd, sizeof(arena_cmd), "arena.%u.%s", arenas[i], op);
+            JEMALLOC_MALLCTL(arena_cmd, NULL, NULL, NULL, 0);
+        }
+#ifdef MALLCTL_ARENAS_ALL
+        // The automatic arenas hold everything allocated without a type
+        snprintf(arena_cmd, sizeof(arena_cmd), "arena.%u.%s", (unsigned)MALLCTL_ARENAS_ALL, op);
+        JEMALLOC_MALLCTL(arena_cmd, NULL, NULL, NULL, 0);
+#endif
+        return;
+    }
+#endif
+#if defined(__GLIBC__)
+    // glibc keeps freed memory in its heaps until asked to trim them
+    if (purge) malloc_trim(0);
+#else
+    (void)purge;
+#endif
+}
+
+bool catzilla_memory_profiler_available(void) {
+#ifdef CATZILLA_HAS_JEMALLOC
+    if (g_current_allocator == CATZILLA_ALLOCATOR_JEMALLOC) {
+        bool prof = false;
+        size_t sz = sizeof(prof);
+        return JEMALLOC_MALLCTL("opt.prof", &prof, &sz, NULL, 0) == 0 && prof;
+    }
+#endif
+    return false;
+}
+
+int catzilla_memory_profiler_start(unsigned lg_sample) {
+    if (!catzilla_memory_profiler_available()) return -1;
+#ifdef CATZILLA_HAS_JEMALLOC
+    if (lg_sample == 0) lg_sample = CATZILLA_PROFILER_DEFAULT_LG_SAMPLE;
+    if (lg_sample > 40) return -1;
+
+    // prof.reset drops the samples taken so far and sets the new sample rate
+    size_t lg = lg_sample;
+    if (JEMALLOC_MALLCTL("prof.reset", NULL, NULL, &lg, sizeof(lg)) != 0) return -1;
+
+    bool active = true;
+    if (JEMALLOC_MALLCTL("prof.active", NULL, NULL, &active, sizeof(active)) != 0) return -1;
+    g_profiler_active = true;
+    g_profiler_started = true;
+    g_profiler_lg_sample = lg_sample;
+    return 0;
+#else
+    (void)lg_sample;
+    return -1;
+#endif
+}
+
+void catzilla_memory_profiler_stop(void) {
+#ifdef CATZILLA_HAS_JEMALLOC
+    if (g_profiler_active) {
+        // Samples already taken stay in the profile until the next start
+        bool active = false;
+        JEMALLOC_MALLCTL("prof.active", NULL, NULL, &active, sizeof(active));
+    }
+#endif
+    g_profiler_active = false;
+}
+
+int catzilla_memory_profiler_dump(const char* path) {
+    if (!path || !g_profiler_started) return -1;
+#ifdef CATZILLA_HAS_JEMALLOC
+    if (JEMALLOC_MALLCTL("prof.dump", NULL, NULL, &path, sizeof(path)) != 0) {
+        return -1;
+    }
+    ATOMIC_ADD(&g_profiler_dumps, 1);
+    return 0;
+#else
+    return -1;
+#endif
+}
+
+void catzilla_memory_profiler_get_status(catzilla_profiler_status_t* status) {
+    if (!status) return;
+    status->available = catzilla_memory_profiler_available();
+    status->active = g_profiler_active;
+    status->lg_sample = g_profiler_lg_sample;
+    status->dumps = g_profiler_dumps;
+}
+
 #ifdef DEBUG
 void catzilla_memory_dump_stats(void) {
     catzilla_memory_stats_t stats;
@@ -118,6 +118,62 @@ void catzilla_memory_auto_optimize(void);
 int catzilla_memory_purge_arena(catzilla_memory_type_t type);
 int catzilla_memory_get_arena_stats(catzilla_memory_type_t type, size_t* allocated, size_t* active);
 
+// Memory pressure
+size_t catzilla_memory_get_rss(void);               // Resident set size in bytes, 0 if unknown
+void catzilla_memory_release_unused(bool purge);    // Return freed pages to the OS (decay, or purge all)
+
+// ============================================================================
+// ALLOCATION PROFILING (jemalloc prof)
+// ============================================================================
+
+// An allocation is sampled for about every 2^19 bytes (512 KB) allocated
+#define CATZILLA_PROFILER_DEFAULT_LG_SAMPLE 19
+
+/**
+ * Allocation profiler state
+ */
+typedef struct {
+    bool available;      // jemalloc runs with prof compiled in and enabled
+    bool active;         // Sampling allocations
+    unsigned lg_sample;  // log2 of the mean bytes between samples
+    uint64_t dumps;      // Profiles written
+} catzilla_profiler_status_t;
+
+/**
+ * Check whether heap profiling can be started: jemalloc is the allocator,
+ * was built with --enable-prof and started with prof on (CATZILLA_JEMALLOC_PROF)
+ * @return true if catzilla_memory_profiler_start can succeed
+ */
+bool catzilla_memory_profiler_available(void);
+
+/**
+ * Start sampling allocations; samples taken before are dropped. Stacks of
+ * sampled allocations pass through catzilla_<type>_alloc, which tags them
+ * by arena in the profile.
+ * @param lg_sample log2 of the mean bytes between samples (0 = CATZILLA_PROFILER_DEFAULT_LG_SAMPLE)
+ * @return 0 on success, -1 if profiling is unavailable or lg_sample is out of range
+ */
+int catzilla_memory_profiler_start(unsigned lg_sample);
+
+/**
+ * Stop sampling; memory sampled so far can still be dumped
+ */
+void catzilla_memory_profiler_stop(void);
+
+/**
+ * Write the sampled live heap in jemalloc's heap profile format, which
+ * jeprof and pprof read
+ * @param path File to write
+ * @return 0 on success, -1 if the profiler was never started or the write failed
+ */
+int catzilla_memory_profiler_dump(const char* path);
+
+/**
+ * Get allocation profiler state
+ * @param status Pointer to status structure to fill
+ */
+void catzilla_memory_profiler_get_status(catzilla_profiler_status_t* status);
+
 // Memory debugging (debug builds only)
 #ifdef DEBUG
 void catzilla_memory_dump_stats(void);
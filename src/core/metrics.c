@@ -0,0 +1,453 @@
+#include "metrics.h"
+#include "platform_compat.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <uv.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// ================================
+// HISTOGRAMS
+// ================================
+
+static int highest_bit(uint64_t value) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return (int)index;
+#else
+    return 63 - __builtin_clzll(value);
+#endif
+}
+
+size_t catzilla_histogram_bucket_index(uint64_t value_us) {
+    if (value_us > CATZILLA_HISTOGRAM_MAX_US) value_us = CATZILLA_HISTOGRAM_MAX_US;
+    if (value_us < CATZILLA_HISTOGRAM_SUB_BUCKETS) return (size_t)value_us;
+
+    // The top 4 bits pick the bucket: 3 under the leading one, 8 per octave
+    int msb = highest_bit(value_us);
+    return (size_t)(msb - 2) * CATZILLA_HISTOGRAM_SUB_BUCKETS +
+           (size_t)(value_us >> (msb - 3)) - CATZILLA_HISTOGRAM_SUB_BUCKETS;
+}
+
+uint64_t catzilla_histogram_bucket_upper(size_t index) {
+    if (index < CATZILLA_HISTOGRAM_SUB_BUCKETS) return index;
+    if (index >= CATZILLA_HISTOGRAM_BUCKETS) index = CATZILLA_HISTOGRAM_BUCKETS - 1;
+
+    size_t octave = index / CATZILLA_HISTOGRAM_SUB_BUCKETS;
+    uint64_t sub = index % CATZILLA_HISTOGRAM_SUB_BUCKETS + CATZILLA_HISTOGRAM_SUB_BUCKETS;
+    return ((sub + 1) << (octave - 1)) - 1;
+}
+
+// Single writer: plain load and store instead of an atomic add
+static void bump(catzilla_atomic_uint64_t* counter, uint64_t amount) {
+    catzilla_atomic_store(counter, catzilla_atomic_load(counter) + amount);
+}
+
+void catzilla_histogram_record(catzilla_histogram_t* histogram, uint64_t value_ns) {
+    bump(&histogram->buckets[catzilla_histogram_bucket_index(value_ns / 1000)], 1);
+    bump(&histogram->count, 1);
+    bump(&histogram->sum_ns, value_ns);
+    if (value_ns > catzilla_atomic_load(&histogram->max_ns)) {
+        catzilla_atomic_store(&histogram->max_ns, value_ns);
+    }
+}
+
+void catzilla_histogram_merge(catzilla_histogram_t* into, const catzilla_histogram_t* from) {
+    for (size_t i = 0; i < CATZILLA_HISTOGRAM_BUCKETS; i++) {
+        into->buckets[i] += catzilla_atomic_load(&from->buckets[i]);
+    }
+    into->count += catzilla_atomic_load(&from->count);
+    into->sum_ns += catzilla_atomic_load(&from->sum_ns);
+    uint64_t max = catzilla_atomic_load(&from->max_ns);
+    if (max > into->max_ns) into->max_ns = max;
+}
+
+uint64_t catzilla_histogram_percentile(const catzilla_histogram_t* histogram, double percentile) {
+    // Summed from the buckets: the count may run ahead of them mid-record
+    uint64_t total = 0;
+    for (size_t i = 0; i < CATZILLA_HISTOGRAM_BUCKETS; i++) {
+        total += catzilla_atomic_load(&histogram->buckets[i]);
+    }
+    if (total == 0) return 0;
+
+    if (percentile < 0.0) percentile = 0.0;
+    if (percentile > 100.0) percentile = 100.0;
+    uint64_t rank = (uint64_t)((percentile / 100.0) * (double)total + 0.5);
+    if (rank == 0) rank = 1;
+
+    uint64_t max_ns = catzilla_atomic_load(&histogram->max_ns);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < CATZILLA_HISTOGRAM_BUCKETS; i++) {
+        seen += catzilla_atomic_load(&histogram->buckets[i]);
+        if (seen >= rank) {
+            // A bucket's values end just below the next microsecond
+            uint64_t upper_ns = catzilla_histogram_bucket_upper(i) * 1000 + 999;
+            return upper_ns < max_ns ? upper_ns : max_ns;
+        }
+    }
+    return max_ns;
+}
+
+// ================================
+// PER-LOOP ROUTE HISTOGRAMS
+// ================================
+
+// A loop's histograms, indexed by route ID. The loop reads its table
+// without the lock; it takes it only to grow the table or add a route, so a
+// scrape holding it never sees a table being replaced.
+typedef struct metrics_loop_s {
+    uv_mutex_t lock;
+    catzilla_route_metrics_t** routes;
+    uint32_t capacity;
+    struct metrics_loop_s* next;
+} metrics_loop_t;
+
+static uv_once_t loops_once = UV_ONCE_INIT;
+static uv_mutex_t loops_lock;
+static metrics_loop_t* loops;
+
+// Bumped by catzilla_metrics_reset so no thread keeps using a freed table
+static catzilla_atomic_uint64_t loops_generation = 1;
+static CATZILLA_THREAD_LOCAL metrics_loop_t* loop_metrics;
+static CATZILLA_THREAD_LOCAL uint64_t loop_metrics_generation;
+
+static void init_loops_lock(void) {
+    uv_mutex_init(&loops_lock);
+}
+
+static metrics_loop_t* current_loop_metrics(void) {
+    uint64_t generation = catzilla_atomic_load(&loops_generation);
+    if (loop_metrics && loop_metrics_generation == generation) return loop_metrics;
+
+    metrics_loop_t* state = calloc(1, sizeof(*state));
+    if (!state) return NULL;
+    uv_mutex_init(&state->lock);
+
+    uv_once(&loops_once, init_loops_lock);
+    uv_mutex_lock(&loops_lock);
+    state->next = loops;
+    loops = state;
+    uv_mutex_unlock(&loops_lock);
+
+    loop_metrics = state;
+    loop_metrics_generation = generation;
+    return state;
+}
+
+catzilla_route_metrics_t* catzilla_metrics_route(uint32_t route_id, const char* method, const char* path) {
+    metrics_loop_t* state = current_loop_metrics();
+    if (!state) return NULL;
+    if (route_id < state->capacity && state->routes[route_id]) return state->routes[route_id];
+
+    catzilla_route_metrics_t* route = calloc(1, sizeof(*route));
+    if (!route) return NULL;
+    route->route_id = route_id;
+    snprintf(route->method, sizeof(route->method), "%s", method ? method : "");
+    snprintf(route->path, sizeof(route->path), "%s", path ? path : "");
+
+    uv_mutex_lock(&state->lock);
+    if (route_id >= state->capacity) {
+        uint32_t capacity = state->capacity ? state->capacity : 16;
+        while (capacity <= route_id) capacity *= 2;
+        catzilla_route_metrics_t** routes = realloc(state->routes, capacity * sizeof(*routes));
+        if (!routes) {
+            uv_mutex_unlock(&state->lock);
+            free(route);
+            return NULL;
+        }
+        memset(routes + state->capacity, 0, (capacity - state->capacity) * sizeof(*routes));
+        state->routes = routes;
+        state->capacity = capacity;
+    }
+    state->routes[route_id] = route;
+    uv_mutex_unlock(&state->lock);
+    return route;
+}
+
+void catzilla_metrics_record(const catzilla_latency_sample_t* sample) {
+    if (!sample || !sample->route) return;
+    for (int phase = 0; phase < CATZILLA_LATENCY_PHASE_COUNT; phase++) {
+        catzilla_histogram_record(&sample->route->phases[phase], sample->durations_ns[phase]);
+    }
+    if (sample->counted) {
+        bump(&sample->route->counted, 1);
+        for (int i = 0; i < CATZILLA_PERF_COUNTER_COUNT; i++) {
+            bump(&sample->route->counters[i], sample->counters.values[i]);
+        }
+    }
+}
+
+catzilla_route_metrics_t* catzilla_metrics_snapshot(size_t* count) {
+    if (count) *count = 0;
+    uv_once(&loops_once, init_loops_lock);
+    uv_mutex_lock(&loops_lock);
+
+    // Route IDs are small and dense: merge through a table indexed by ID
+    uint32_t id_limit = 0;
+    for (metrics_loop_t* state = loops; state; state = state->next) {
+        uv_mutex_lock(&state->lock);
+        for (uint32_t id = state->capacity; id > id_limit; id--) {
+            if (state->routes[id - 1]) {
+                id_limit = id;
+                break;
+            }
+        }
+        uv_mutex_unlock(&state->lock);
+    }
+
+    int32_t* slots = id_limit ? malloc(id_limit * sizeof(*slots)) : NULL;
+    catzilla_route_metrics_t* merged = NULL;
+    size_t merged_count = 0;
+    if (slots) {
+        memset(slots, 0xff, id_limit * sizeof(*slots));
+        uint32_t distinct = 0;
+        for (metrics_loop_t* state = loops; state; state = state->next) {
+            uv_mutex_lock(&state->lock);
+            for (uint32_t id = 0; id < state->capacity && id < id_limit; id++) {
+                if (state->routes[id] && slots[id] < 0) {
+                    slots[id] = 0;  // Seen; its position is assigned below
+                    distinct++;
+                }
+            }
+            uv_mutex_unlock(&state->lock);
+        }
+        // Routes added since the first pass have IDs past id_limit: left for the next scrape
+        merged = distinct ? calloc(distinct, sizeof(*merged)) : NULL;
+    }
+
+    if (merged) {
+        for (uint32_t id = 0; id < id_limit; id++) {
+            if (slots[id] == 0) slots[id] = (int32_t)merged_count++;
+        }
+        for (metrics_loop_t* state = loops; state; state = state->next) {
+            uv_mutex_lock(&state->lock);
+            for (uint32_t id = 0; id < state->capacity && id < id_limit; id++) {
+                catzilla_route_metrics_t* route = state->routes[id];
+                if (!route || slots[id] < 0) continue;
+                catzilla_route_metrics_t* into = &merged[slots[id]];
+                if (!into->method[0] && !into->path[0]) {
+                    into->route_id = id;
+                    memcpy(into->method, route->method, sizeof(into->method));
+                    memcpy(into->path, route->path, sizeof(into->path));
+                }
+                for (int phase = 0; phase < CATZILLA_LATENCY_PHASE_COUNT; phase++) {
+                    catzilla_histogram_merge(&into->phases[phase], &route->phases[phase]);
+                }
+                into->counted += catzilla_atomic_load(&route->counted);
+                for (int i = 0; i < CATZILLA_PERF_COUNTER_COUNT; i++) {
+                    into->counters[i] += catzilla_atomic_load(&route->counters[i]);
+                }
+            }
+            uv_mutex_unlock(&state->lock);
+        }
+    }
+    uv_mutex_unlock(&loops_lock);
+
+    free(slots);
+    if (count) *count = merged_count;
+    return merged;
+}
+
+void catzilla_metrics_snapshot_free(catzilla_route_metrics_t* snapshot) {
+    free(snapshot);
+}
+
+void catzilla_metrics_reset(void) {
+    uv_once(&loops_once, init_loops_lock);
+    uv_mutex_lock(&loops_lock);
+    metrics_loop_t* state = loops;
+    loops = NULL;
+    catzilla_atomic_fetch_add(&loops_generation, 1);
+    uv_mutex_unlock(&loops_lock);
+
+    while (state) {
+        metrics_loop_t* next = state->next;
+        for (uint32_t id = 0; id < state->capacity; id++) {
+            free(state->routes[id]);
+        }
+        free(state->routes);
+        uv_mutex_destroy(&state->lock);
+        free(state);
+        state = next;
+    }
+    loop_metrics = NULL;
+}
+
+// ================================
+// PROMETHEUS TEXT EXPOSITION
+// ================================
+
+static const char* const phase_names[CATZILLA_LATENCY_PHASE_COUNT] = {
+    "queue", "gil", "handler", "write"
+};
+
+// Bucket bounds of the exposition, in microseconds
+static const uint64_t exposition_buckets_us[] = {
+    50, 100, 250, 500,
+    1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000,
+    1000000, 2500000, 5000000, 10000000
+};
+
+void catzilla_metrics_text_init(catzilla_metrics_text_t* text) {
+    memset(text, 0, sizeof(*text));
+}
+
+void catzilla_metrics_text_free(catzilla_metrics_text_t* text) {
+    free(text->data);
+    memset(text, 0, sizeof(*text));
+}
+
+void catzilla_metrics_append(catzilla_metrics_text_t* text, const char* format, ...) {
+    if (text->failed) return;
+
+    for (int attempt = 0; attempt < 2; attempt++) {
+        size_t room = text->capacity - text->length;
+        va_list args;
+        va_start(args, format);
+        int written = vsnprintf(text->data ? text->data + text->length : NULL, room, format, args);
+        va_end(args);
+        if (written < 0) {
+            text->failed = true;
+            return;
+        }
+        if ((size_t)written < room) {
+            text->length += (size_t)written;
+            return;
+        }
+
+        size_t capacity = text->capacity ? text->capacity : 4096;
+        while (capacity < text->length + (size_t)written + 1) capacity *= 2;
+        char* data = realloc(text->data, capacity);
+        if (!data) {
+            text->failed = true;
+            return;
+        }
+        text->data = data;
+        text->capacity = capacity;
+    }
+}
+
+void catzilla_metrics_write_value(catzilla_metrics_text_t* text, const char* name, const char* type,
+                                  const char* help, double value) {
+    catzilla_metrics_append(text, "# HELP %s %s\n# TYPE %s %s\n%s %.17g\n", name, help, name, type, name, value);
+}
+
+// Label values escape backslash, quote and newline
+static void append_label_value(catzilla_metrics_text_t* text, const char* value) {
+    char escaped[CATZILLA_PATH_MAX * 2];
+    size_t length = 0;
+    for (const char* p = value; *p && length < sizeof(escaped) - 2; p++) {
+        if (*p == '\\' || *p == '"') {
+            escaped[length++] = '\\';
+            escaped[length++] = *p;
+        } else if (*p == '\n') {
+            escaped[length++] = '\\';
+            escaped[length++] = 'n';
+        } else {
+            escaped[length++] = *p;
+        }
+    }
+    escaped[length] = '\0';
+    catzilla_metrics_append(text, "%s", escaped);
+}
+
+static void append_route_labels(catzilla_metrics_text_t* text, const catzilla_route_metrics_t* route) {
+    catzilla_metrics_append(text, "{method=\"");
+    append_label_value(text, route->method);
+    catzilla_metrics_append(text, "\",route=\"");
+    append_label_value(text, route->path);
+    catzilla_metrics_append(text, "\"");
+}
+
+static void append_labels(catzilla_metrics_text_t* text, const catzilla_route_metrics_t* route, int phase) {
+    append_route_labels(text, route);
+    catzilla_metrics_append(text, ",phase=\"%s\"", phase_names[phase]);
+}
+
+void catzilla_metrics_write_latency(catzilla_metrics_text_t* text) {
+    const char* name = "catzilla_request_phase_seconds";
+    catzilla_metrics_append(text,
+                            "# HELP %s Time requests spent per route in each phase: dispatch queue, "
+                            "GIL wait, handler and response write\n# TYPE %s histogram\n",
+                            name, name);
+
+    size_t count = 0;
+    catzilla_route_metrics_t* routes = catzilla_metrics_snapshot(&count);
+    size_t bucket_count = sizeof(exposition_buckets_us) / sizeof(exposition_buckets_us[0]);
+
+    for (size_t r = 0; r < count; r++) {
+        for (int phase = 0; phase < CATZILLA_LATENCY_PHASE_COUNT; phase++) {
+            const catzilla_histogram_t* histogram = &routes[r].phases[phase];
+            uint64_t cumulative = 0;
+            size_t hdr = 0;
+
+            for (size_t b = 0; b < bucket_count; b++) {
+                while (hdr < CATZILLA_HISTOGRAM_BUCKETS &&
+                       catzilla_histogram_bucket_upper(hdr) <= exposition_buckets_us[b]) {
+                    cumulative += histogram->buckets[hdr++];
+                }
+                catzilla_metrics_append(text, "%s_bucket", name);
+                append_labels(text, &routes[r], phase);
+                catzilla_metrics_append(text, ",le=\"%g\"} %llu\n",
+                                        (double)exposition_buckets_us[b] / 1e6,
+                                        (unsigned long long)cumulative);
+            }
+            while (hdr < CATZILLA_HISTOGRAM_BUCKETS) {
+                cumulative += histogram->buckets[hdr++];
+            }
+
+            // The count comes from the buckets so that +Inf always equals it
+            catzilla_metrics_append(text, "%s_bucket", name);
+            append_labels(text, &routes[r], phase);
+            catzilla_metrics_append(text, ",le=\"+Inf\"} %llu\n", (unsigned long long)cumulative);
+            catzilla_metrics_append(text, "%s_sum", name);
+            append_labels(text, &routes[r], phase);
+            catzilla_metrics_append(text, "} %.9f\n", (double)histogram->sum_ns / 1e9);
+            catzilla_metrics_append(text, "%s_count", name);
+            append_labels(text, &routes[r], phase);
+            catzilla_metrics_append(text, "} %llu\n", (unsigned long long)cumulative);
+        }
+    }
+    catzilla_metrics_snapshot_free(routes);
+}
+
+void catzilla_metrics_write_counters(catzilla_metrics_text_t* text) {
+    size_t count = 0;
+    catzilla_route_metrics_t* routes = catzilla_metrics_snapshot(&count);
+    bool sampled = false;
+    for (size_t r = 0; r < count && !sampled; r++) {
+        sampled = routes[r].counted > 0;
+    }
+    if (!sampled) {
+        catzilla_metrics_snapshot_free(routes);
+        return;
+    }
+
+    static const struct {
+        const char* name;
+        const char* help;
+        int counter;  // -1 = the number of requests measured
+    } series[] = {
+        {"catzilla_handler_counted_requests_total", "Requests whose handler was measured with hardware counters", -1},
+        {"catzilla_handler_cycles_total", "CPU cycles of the measured handlers", CATZILLA_PERF_CYCLES},
+        {"catzilla_handler_instructions_total", "Instructions retired by the measured handlers", CATZILLA_PERF_INSTRUCTIONS},
+        {"catzilla_handler_cache_misses_total", "Last level cache misses of the measured handlers", CATZILLA_PERF_CACHE_MISSES},
+    };
+    for (size_t s = 0; s < sizeof(series) / sizeof(series[0]); s++) {
+        catzilla_metrics_append(text, "# HELP %s %s\n# TYPE %s counter\n",
+                                series[s].name, series[s].help, series[s].name);
+        for (size_t r = 0; r < count; r++) {
+            if (routes[r].counted == 0) continue;
+            uint64_t value = series[s].counter < 0 ? routes[r].counted : routes[r].counters[series[s].counter];
+            catzilla_metrics_append(text, "%s", series[s].name);
+            append_route_labels(text, &routes[r]);
+            catzilla_metrics_append(text, "} %llu\n", (unsigned long long)value);
+        }
+    }
+    catzilla_metrics_snapshot_free(routes);
+}
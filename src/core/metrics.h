@@ -0,0 +1,207 @@
+#ifndef CATZILLA_METRICS_H
+#define CATZILLA_METRICS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "perf_counters.h"
+#include "platform_atomic.h"
+#include "router.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Request latency histograms per route, recorded by the loop threads.
+// Each loop fills histograms of its own, without locks or atomic
+// read-modify-writes; a scrape merges them. Buckets are HDR-style:
+// exact below 8 us, then 8 per power of two, so a value is known to within
+// 1/8 up to CATZILLA_HISTOGRAM_MAX_US.
+
+#define CATZILLA_HISTOGRAM_SUB_BUCKETS 8
+#define CATZILLA_HISTOGRAM_BUCKETS 240
+#define CATZILLA_HISTOGRAM_MAX_US ((1ULL << 32) - 1)  // ~71 minutes; longer values are clamped
+
+/**
+ * Where a request's time went. Phases are back to back: the route was
+ * matched, the request waited in the loop's dispatch queue, then for the GIL,
+ * the handler ran until it sent its response, and the response was written.
+ */
+typedef enum {
+    CATZILLA_LATENCY_QUEUE,    // Matched until its dispatch batch asked for the GIL
+    CATZILLA_LATENCY_GIL,      // Waiting for the GIL
+    CATZILLA_LATENCY_HANDLER,  // Handler start until its response was queued
+    CATZILLA_LATENCY_WRITE,    // Response queued until the socket took all of it
+    CATZILLA_LATENCY_PHASE_COUNT
+} catzilla_latency_phase_t;
+
+/**
+ * One histogram. Only its loop writes it; readers may see a record half
+ * applied, never a torn counter.
+ */
+typedef struct {
+    catzilla_atomic_uint64_t buckets[CATZILLA_HISTOGRAM_BUCKETS];  // Counts in microseconds
+    catzilla_atomic_uint64_t count;
+    catzilla_atomic_uint64_t sum_ns;
+    catzilla_atomic_uint64_t max_ns;
+} catzilla_histogram_t;
+
+/**
+ * Latency of one route, on one loop or merged over all of them
+ */
+typedef struct {
+    uint32_t route_id;
+    char method[CATZILLA_METHOD_MAX];
+    char path[CATZILLA_PATH_MAX];
+    catzilla_histogram_t phases[CATZILLA_LATENCY_PHASE_COUNT];
+    catzilla_atomic_uint64_t counted;  // Requests whose handler was measured with hardware counters
+    catzilla_atomic_uint64_t counters[CATZILLA_PERF_COUNTER_COUNT];  // Totals over those requests
+} catzilla_route_metrics_t;
+
+/**
+ * A request being timed; carried by its connection, then by its response
+ */
+typedef struct {
+    catzilla_route_metrics_t* route;  // NULL = not timed
+    uint64_t mark_ns;                 // Start of the phase being timed (uv_hrtime)
+    uint64_t durations_ns[CATZILLA_LATENCY_PHASE_COUNT];
+    bool counted;                     // counters holds the handler's start reading, then its cost
+    catzilla_perf_reading_t counters;
+} catzilla_latency_sample_t;
+
+/**
+ * @param value_us Value in microseconds
+ * @return Index of the bucket counting value_us
+ */
+size_t catzilla_histogram_bucket_index(uint64_t value_us);
+
+/**
+ * @param index Bucket index
+ * @return Largest value, in microseconds, the bucket counts
+ */
+uint64_t catzilla_histogram_bucket_upper(size_t index);
+
+/**
+ * Record a value; only the histogram's own thread may call this
+ * @param histogram Histogram
+ * @param value_ns Value in nanoseconds
+ */
+void catzilla_histogram_record(catzilla_histogram_t* histogram, uint64_t value_ns);
+
+/**
+ * Add the counts of one histogram to another
+ * @param into Histogram receiving the counts
+ * @param from Histogram to add (may be written meanwhile)
+ */
+void catzilla_histogram_merge(catzilla_histogram_t* into, const catzilla_histogram_t* from);
+
+/**
+ * @param histogram Histogram
+ * @param percentile 0 to 100
+ * @return Upper bound in nanoseconds of the bucket holding the percentile,
+ *         at most the largest value recorded (0 when empty)
+ */
+uint64_t catzilla_histogram_percentile(const catzilla_histogram_t* histogram, double percentile);
+
+/**
+ * The calling loop's histograms of a route, created on first use
+ * @param route_id Route ID (catzilla_route_t.id)
+ * @param method Route method, copied on creation
+ * @param path Route path pattern, copied on creation
+ * @return Histograms, or NULL when memory runs out
+ */
+catzilla_route_metrics_t* catzilla_metrics_route(uint32_t route_id, const char* method, const char* path);
+
+/**
+ * Record a timed request into its route's histograms
+ * @param sample Sample (ignored when its route is NULL)
+ */
+void catzilla_metrics_record(const catzilla_latency_sample_t* sample);
+
+/**
+ * Merge every loop's histograms route by route
+ * @param count Receives the number of routes
+ * @return Routes ordered by ID, freed with catzilla_metrics_snapshot_free;
+ *         NULL when nothing was recorded or memory ran out
+ */
+catzilla_route_metrics_t* catzilla_metrics_snapshot(size_t* count);
+
+/**
+ * @param snapshot Result of catzilla_metrics_snapshot (NULL is ignored)
+ */
+void catzilla_metrics_snapshot_free(catzilla_route_metrics_t* snapshot);
+
+/**
+ * Forget everything recorded. Only safe while no loop records.
+ */
+void catzilla_metrics_reset(void);
+
+// ============================================================================
+// PROMETHEUS TEXT EXPOSITION
+// ============================================================================
+
+/**
+ * Growing text buffer for an exposition; appends after a failed allocation
+ * are dropped and leave failed set
+ */
+typedef struct {
+    char* data;
+    size_t length;
+    size_t capacity;
+    bool failed;
+} catzilla_metrics_text_t;
+
+/**
+ * @param text Buffer to initialize (empty)
+ */
+void catzilla_metrics_text_init(catzilla_metrics_text_t* text);
+
+/**
+ * @param text Buffer whose memory is released
+ */
+void catzilla_metrics_text_free(catzilla_metrics_text_t* text);
+
+/**
+ * Append printf-style
+ * @param text Buffer
+ * @param format Format string
+ */
+void catzilla_metrics_append(catzilla_metrics_text_t* text, const char* format, ...)
+#if defined(__GNUC__) || defined(__clang__)
+    __attribute__((format(printf, 2, 3)))
+#endif
+    ;
+
+/**
+ * Append a metric without labels, with its HELP and TYPE lines
+ * @param text Buffer
+ * @param name Metric name
+ * @param type "counter" or "gauge"
+ * @param help Help text
+ * @param value Value
+ */
+void catzilla_metrics_write_value(catzilla_metrics_text_t* text, const char* name, const char* type,
+                                  const char* help, double value);
+
+/**
+ * Append catzilla_request_phase_seconds: one histogram per route and phase,
+ * in Prometheus buckets derived from the HDR buckets (a value counts
+ * towards the first le at or above its bucket's upper bound)
+ * @param text Buffer
+ */
+void catzilla_metrics_write_latency(catzilla_metrics_text_t* text);
+
+/**
+ * Append the hardware counter totals of sampled handlers per route:
+ * catzilla_handler_counted_requests_total, catzilla_handler_cycles_total,
+ * catzilla_handler_instructions_total and catzilla_handler_cache_misses_total.
+ * Nothing is written before a request was sampled.
+ * @param text Buffer
+ */
+void catzilla_metrics_write_counters(catzilla_metrics_text_t* text);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CATZILLA_METRICS_H
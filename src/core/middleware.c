@@ -234,23 +234,15 @@ int catzilla_execute_middleware_chain(catzilla_middleware_chain_t* chain,
         }
     }
 
-    uint64_t start_time = get_timestamp_ns();
-
-    // Allocate middleware context from specialized pool
-    catzilla_middleware_context_t* ctx =
-        catzilla_di_pool_alloc(chain->context_pool, sizeof(catzilla_middleware_context_t));
+    // Context lives in the request arena and goes with it
+    catzilla_middleware_context_t* ctx = catzilla_middleware_context_create(
+        request, route_match, chain->pre_route_count + chain->post_route_count);
 
     if (!ctx) return -1;
 
-    // Initialize context (zero-copy where possible)
-    memset(ctx, 0, sizeof(catzilla_middleware_context_t));
-    ctx->request = request;                 // Zero-copy reference
-    ctx->route_match = route_match;         // Zero-copy reference
+    uint64_t start_time = ctx->execution_start_time;
     ctx->di_container = di_container;
-    ctx->should_continue = true;
-    ctx->should_skip_route = false;
     ctx->response_status = 200;
-    ctx->execution_start_time = start_time;
 
     // Create DI context if container is provided
     if (di_container) {
@@ -317,9 +309,6 @@ cleanup:
         catzilla_di_cleanup_context(ctx->di_context);
     }
 
-    // Clean up context memory
-    catzilla_di_pool_free(chain->context_pool, ctx);
-
     return result;
 }
 
@@ -363,6 +352,33 @@ void catzilla_middleware_reset_stats(catzilla_middleware_chain_t* chain) {
 // MIDDLEWARE CONTEXT UTILITIES
 // ============================================================================
 
+catzilla_middleware_context_t* catzilla_middleware_context_create(catzilla_request_t* request,
+                                                                  catzilla_route_match_t* route_match,
+                                                                  int timing_count) {
+    if (!request || timing_count < 0) return NULL;
+
+    // Timings follow the context in the same allocation
+    size_t timings_size = sizeof(uint64_t) * (size_t)timing_count;
+    catzilla_middleware_context_t* ctx =
+        catzilla_arena_alloc(&request->arena, sizeof(catzilla_middleware_context_t) + timings_size);
+    if (!ctx) return NULL;
+
+    *ctx = (catzilla_middleware_context_t){
+        .request = request,
+        .route_match = route_match,
+        .arena = &request->arena,
+        .should_continue = true,
+        .execution_start_time = get_timestamp_ns(),
+        .timing_count = timing_count,
+    };
+    if (timing_count > 0) {
+        ctx->middleware_timings = (uint64_t*)(ctx + 1);
+        memset(ctx->middleware_timings, 0, timings_size);
+    }
+
+    return ctx;
+}
+
 void catzilla_middleware_set_status(catzilla_middleware_context_t* ctx, int status) {
     if (ctx) {
         ctx->response_status = status;
@@ -378,6 +394,13 @@ int catzilla_middleware_set_header(catzilla_middleware_context_t* ctx,
         return -1; // Header limit reached
     }
 
+    if (!ctx->response_headers) {
+        if (!ctx->arena) return -1;
+        ctx->response_headers = catzilla_arena_alloc(
+            ctx->arena, sizeof(catzilla_response_header_t) * CATZILLA_MAX_RESPONSE_HEADERS);
+        if (!ctx->response_headers) return -1;
+    }
+
     catzilla_response_header_t* header = &ctx->response_headers[ctx->response_header_count];
 
     strncpy(header->name, name, sizeof(header->name) - 1);    header->name[sizeof(header->name) - 1] = '\0';
@@ -416,13 +439,14 @@ const char* catzilla_middleware_get_header(catzilla_middleware_context_t* ctx,
                                           const char* name) {
     if (!ctx || !ctx->request || !name) return NULL;
 
-    for (int i = 0; i < ctx->request->header_count; i++) {
-        if (strcasecmp(ctx->request->headers[i].name, name) == 0) {
-            return ctx->request->headers[i].value;
-        }
-    }
+    return catzilla_header_set_get(&ctx->request->headers, name, NULL);
+}
 
-    return NULL;
+const char* catzilla_middleware_get_known_header(catzilla_middleware_context_t* ctx,
+                                                int header_id) {
+    if (!ctx || !ctx->request) return NULL;
+
+    return catzilla_header_set_get_known(&ctx->request->headers, header_id, NULL);
 }
 
 void catzilla_middleware_set_error(catzilla_middleware_context_t* ctx,
@@ -433,27 +457,33 @@ void catzilla_middleware_set_error(catzilla_middleware_context_t* ctx,
     ctx->response_status = status;
     ctx->error_code = status;
 
-    if (message) {
-        size_t msg_len = strlen(message);
-        // Allocate memory for error message from context pool
-        ctx->error_message = catzilla_malloc(msg_len + 1);
-        if (ctx->error_message) {
-            strcpy(ctx->error_message, message);
-        }
+    if (message && ctx->arena) {
+        // Released with the request arena
+        ctx->error_message = catzilla_arena_strndup(ctx->arena, message, strlen(message));
     }
 }
 
 void catzilla_middleware_set_data(catzilla_middleware_context_t* ctx,
                                  int middleware_index,
                                  void* data) {
-    if (ctx && middleware_index >= 0 && middleware_index < CATZILLA_MAX_MIDDLEWARES) {
-        ctx->middleware_data[middleware_index] = data;
+    if (!ctx || middleware_index < 0 || middleware_index >= CATZILLA_MAX_MIDDLEWARES) {
+        return;
     }
+
+    if (!ctx->middleware_data) {
+        if (!ctx->arena) return;
+        size_t size = sizeof(void*) * CATZILLA_MAX_MIDDLEWARES;
+        ctx->middleware_data = catzilla_arena_alloc(ctx->arena, size);
+        if (!ctx->middleware_data) return;
+        memset(ctx->middleware_data, 0, size);
+    }
+    ctx->middleware_data[middleware_index] = data;
 }
 
 void* catzilla_middleware_get_data(catzilla_middleware_context_t* ctx,
                                   int middleware_index) {
-    if (ctx && middleware_index >= 0 && middleware_index < CATZILLA_MAX_MIDDLEWARES) {
+    if (ctx && ctx->middleware_data &&
+        middleware_index >= 0 && middleware_index < CATZILLA_MAX_MIDDLEWARES) {
         return ctx->middleware_data[middleware_index];
     }
     return NULL;
@@ -470,8 +500,9 @@ int catzilla_middleware_resolve_dependency(catzilla_middleware_context_t* ctx,
 
     if (!ctx->di_container) return -1;
 
-    // Use existing DI container resolution in C
-    *service_instance = catzilla_di_resolve_service(ctx->di_container, service_name, NULL);
+    // Resolve in the request's context, so request-scoped instances are
+    // shared for the request and handed back when the context is cleaned up
+    *service_instance = catzilla_di_resolve_service(ctx->di_container, service_name, ctx->di_context);
 
     return (*service_instance != NULL) ? 0 : -1;
 }
@@ -512,14 +543,118 @@ uint64_t catzilla_middleware_calculate_duration(uint64_t start_time, uint64_t en
 // ============================================================================
 
 /**
- * Execute per-route middleware chain for a specific route
- * This function provides zero-allocation execution of route-specific middleware
- *
- * @param route_middleware The per-route middleware chain to execute
- * @param ctx The middleware context for execution
- * @param di_container Optional DI container for dependency injection
- * @return 0 on success, -1 on error
+ * Run the steps of one phase. Pre-route steps can end the chain; post-route
+ * steps all run and only report errors.
  */
+static int run_middleware_steps(const catzilla_middleware_step_t* steps,
+                                int count,
+                                int first_index,
+                                bool pre_route,
+                                catzilla_middleware_context_t* ctx) {
+    int result = 0;
+
+    for (int i = 0; i < count && (!pre_route || ctx->should_continue); i++) {
+        int index = first_index + i;
+        ctx->current_middleware_index = index;
+
+        uint64_t middleware_start = get_timestamp_ns();
+        int middleware_result = steps[i].fn(ctx);
+        if (index < ctx->timing_count) {
+            ctx->middleware_timings[index] = get_timestamp_ns() - middleware_start;
+        }
+
+        if (middleware_result == CATZILLA_MIDDLEWARE_ERROR_CODE) {
+            result = -1;
+            if (pre_route) break;
+        } else if (pre_route && middleware_result == CATZILLA_MIDDLEWARE_SKIP_ROUTE) {
+            ctx->should_skip_route = true;
+            break;
+        } else if (pre_route && middleware_result == CATZILLA_MIDDLEWARE_STOP) {
+            ctx->should_continue = false;
+            break;
+        }
+    }
+
+    return result;
+}
+
+int catzilla_route_middleware_compile(catzilla_route_middleware_t* route_middleware,
+                                      const catzilla_middleware_chain_t* global) {
+    if (!route_middleware) {
+        return -1;
+    }
+
+    int global_count = global ? global->middleware_count : 0;
+    int total = global_count + route_middleware->middleware_count;
+    catzilla_middleware_step_t* steps = NULL;
+    int pre_count = 0;
+    int post_count = 0;
+
+    if (total > 0) {
+        catzilla_middleware_step_t* merged = catzilla_cache_alloc(sizeof(catzilla_middleware_step_t) * total);
+        if (!merged) {
+            return -1;
+        }
+
+        int n = 0;
+        for (int i = 0; i < global_count; i++) {
+            const catzilla_middleware_registration_t* reg = global->middlewares[i];
+            merged[n].fn = reg->c_function;
+            merged[n].priority = reg->priority;
+            merged[n].phases = reg->flags & (CATZILLA_MIDDLEWARE_PRE_ROUTE | CATZILLA_MIDDLEWARE_POST_ROUTE);
+            n++;
+        }
+        for (int i = 0; i < route_middleware->middleware_count; i++) {
+            merged[n++] = route_middleware->entries[i];
+        }
+
+        // Stable insertion sort, so global middleware wins a priority tie
+        for (int i = 1; i < n; i++) {
+            catzilla_middleware_step_t step = merged[i];
+            int j = i;
+            while (j > 0 && merged[j - 1].priority > step.priority) {
+                merged[j] = merged[j - 1];
+                j--;
+            }
+            merged[j] = step;
+        }
+
+        for (int i = 0; i < n; i++) {
+            if (!merged[i].fn) continue;
+            if (merged[i].phases & CATZILLA_MIDDLEWARE_PRE_ROUTE) pre_count++;
+            if (merged[i].phases & CATZILLA_MIDDLEWARE_POST_ROUTE) post_count++;
+        }
+
+        if (pre_count + post_count > 0) {
+            steps = catzilla_cache_alloc(sizeof(catzilla_middleware_step_t) * (pre_count + post_count));
+            if (!steps) {
+                catzilla_cache_free(merged);
+                return -1;
+            }
+
+            int pre_idx = 0, post_idx = pre_count;
+            for (int i = 0; i < n; i++) {
+                if (!merged[i].fn) continue;
+                if (merged[i].phases & CATZILLA_MIDDLEWARE_PRE_ROUTE) steps[pre_idx++] = merged[i];
+                if (merged[i].phases & CATZILLA_MIDDLEWARE_POST_ROUTE) steps[post_idx++] = merged[i];
+            }
+        }
+        catzilla_cache_free(merged);
+    }
+
+    if (route_middleware->steps) {
+        catzilla_cache_free(route_middleware->steps);
+    }
+    route_middleware->steps = steps;
+    route_middleware->pre_count = pre_count;
+    route_middleware->post_count = post_count;
+    route_middleware->phases = (pre_count > 0 ? CATZILLA_MIDDLEWARE_PRE_ROUTE : 0) |
+                               (post_count > 0 ? CATZILLA_MIDDLEWARE_POST_ROUTE : 0);
+    route_middleware->global = global;
+
+    return 0;
+}
+
 int catzilla_middleware_execute_per_route(catzilla_route_middleware_t* route_middleware,
                                          catzilla_middleware_context_t* ctx,
                                          catzilla_di_container_t* di_container) {
@@ -527,69 +662,37 @@ int catzilla_middleware_execute_per_route(catzilla_route_middleware_t* route_mid
         return -1;
     }
 
-    // If no middleware is configured, continue with route execution
-    if (route_middleware->middleware_count == 0) {
+    // Nothing to run before the handler
+    if (!(route_middleware->phases & CATZILLA_MIDDLEWARE_PRE_ROUTE)) {
         return 0;
     }
 
-    uint64_t start_time = get_timestamp_ns();
-
     // Create DI context if container is provided
     if (di_container && !ctx->di_context) {
+        ctx->di_container = di_container;
         ctx->di_context = catzilla_di_create_context(di_container);
     }
 
-    int result = 0;
-
-    // Execute per-route middleware chain in priority order
-    for (int i = 0; i < route_middleware->middleware_count && ctx->should_continue; i++) {
-        ctx->current_middleware_index = i;
-
-        // Get middleware function pointer
-        catzilla_middleware_fn_t middleware_fn = (catzilla_middleware_fn_t)route_middleware->middleware_functions[i];
-        if (!middleware_fn) {
-            continue; // Skip NULL middleware functions
-        }
-
-        uint64_t middleware_start = get_timestamp_ns();
-        int middleware_result = middleware_fn(ctx);
-
-        // Track timing if we have space (avoid allocation)
-        if (i < CATZILLA_MAX_MIDDLEWARE_TIMINGS) {
-            ctx->middleware_timings[i] = get_timestamp_ns() - middleware_start;
-        }
+    return run_middleware_steps(route_middleware->steps, route_middleware->pre_count, 0, true, ctx);
+}
 
-        // Handle middleware execution results
-        if (middleware_result != CATZILLA_MIDDLEWARE_CONTINUE) {
-            if (middleware_result == CATZILLA_MIDDLEWARE_SKIP_ROUTE) {
-                ctx->should_skip_route = true;
-                break;
-            } else if (middleware_result == CATZILLA_MIDDLEWARE_STOP) {
-                ctx->should_continue = false;
-                break;
-            } else if (middleware_result == CATZILLA_MIDDLEWARE_ERROR_CODE) {
-                result = -1;
-                goto cleanup;
-            }
-        }
+int catzilla_middleware_execute_post_route(catzilla_route_middleware_t* route_middleware,
+                                          catzilla_middleware_context_t* ctx) {
+    if (!route_middleware || !ctx) {
+        return -1;
     }
 
-cleanup:
-    // Update performance metrics (zero-allocation tracking)
-    {
-        uint64_t total_time = get_timestamp_ns() - start_time;
-        if (route_middleware->middleware_count > 0) {
-            // Track execution stats without allocation
-            route_middleware->middleware_flags[0] |= 0x1; // Mark as executed
-        }
+    if (!(route_middleware->phases & CATZILLA_MIDDLEWARE_POST_ROUTE)) {
+        return 0;
     }
 
-    return result;
+    return run_middleware_steps(route_middleware->steps + route_middleware->pre_count,
+                                route_middleware->post_count, route_middleware->pre_count,
+                                false, ctx);
 }
 
 /**
  * Initialize per-route middleware chain
- * Zero-allocation initialization for route-specific middleware
  *
  * @param route_middleware The middleware chain to initialize
  * @param initial_capacity Initial capacity for middleware functions
@@ -606,32 +709,19 @@ int catzilla_route_middleware_init(catzilla_route_middleware_t* route_middleware
         initial_capacity = 4; // Default capacity
     }
 
-    // Allocate arrays using cache allocator for zero fragmentation
-    route_middleware->middleware_functions = catzilla_cache_alloc(sizeof(void*) * initial_capacity);
-    route_middleware->middleware_priorities = catzilla_cache_alloc(sizeof(uint32_t) * initial_capacity);
-    route_middleware->middleware_flags = catzilla_cache_alloc(sizeof(uint32_t) * initial_capacity);
-
-    if (!route_middleware->middleware_functions ||
-        !route_middleware->middleware_priorities ||
-        !route_middleware->middleware_flags) {
-        catzilla_route_middleware_cleanup(route_middleware);
+    route_middleware->entries = catzilla_cache_alloc(sizeof(catzilla_middleware_step_t) * initial_capacity);
+    if (!route_middleware->entries) {
         return -1;
     }
 
     route_middleware->middleware_capacity = initial_capacity;
     route_middleware->middleware_count = 0;
 
-    // Zero-initialize arrays
-    memset(route_middleware->middleware_functions, 0, sizeof(void*) * initial_capacity);
-    memset(route_middleware->middleware_priorities, 0, sizeof(uint32_t) * initial_capacity);
-    memset(route_middleware->middleware_flags, 0, sizeof(uint32_t) * initial_capacity);
-
     return 0;
 }
 
 /**
- * Add middleware to per-route chain
- * Zero-allocation addition with priority-based ordering
+ * Add pre-route middleware to per-route chain and recompile its pipeline
  *
  * @param route_middleware The middleware chain to add to
  * @param middleware_fn The middleware function to add
@@ -647,52 +737,29 @@ int catzilla_route_middleware_add(catzilla_route_middleware_t* route_middleware,
 
     // Check if we need to expand capacity
     if (route_middleware->middleware_count >= route_middleware->middleware_capacity) {
-        int new_capacity = route_middleware->middleware_capacity * 2;
+        int new_capacity = route_middleware->middleware_capacity > 0 ?
+                           route_middleware->middleware_capacity * 2 : 4;
 
-        // Reallocate arrays
-        void** new_functions = catzilla_cache_alloc(sizeof(void*) * new_capacity);
-        uint32_t* new_priorities = catzilla_cache_alloc(sizeof(uint32_t) * new_capacity);
-        uint32_t* new_flags = catzilla_cache_alloc(sizeof(uint32_t) * new_capacity);
-
-        if (!new_functions || !new_priorities || !new_flags) {
-            if (new_functions) catzilla_cache_free(new_functions);
-            if (new_priorities) catzilla_cache_free(new_priorities);
-            if (new_flags) catzilla_cache_free(new_flags);
+        catzilla_middleware_step_t* new_entries =
+            catzilla_cache_alloc(sizeof(catzilla_middleware_step_t) * new_capacity);
+        if (!new_entries) {
             return -1;
         }
 
-        // Copy existing data
-        memcpy(new_functions, route_middleware->middleware_functions,
-               sizeof(void*) * route_middleware->middleware_count);
-        memcpy(new_priorities, route_middleware->middleware_priorities,
-               sizeof(uint32_t) * route_middleware->middleware_count);
-        memcpy(new_flags, route_middleware->middleware_flags,
-               sizeof(uint32_t) * route_middleware->middleware_count);
-
-        // Free old arrays
-        catzilla_cache_free(route_middleware->middleware_functions);
-        catzilla_cache_free(route_middleware->middleware_priorities);
-        catzilla_cache_free(route_middleware->middleware_flags);
-
-        // Update to new arrays
-        route_middleware->middleware_functions = new_functions;
-        route_middleware->middleware_priorities = new_priorities;
-        route_middleware->middleware_flags = new_flags;
-        route_middleware->middleware_capacity = new_capacity;
+        if (route_middleware->entries) {
+            memcpy(new_entries, route_middleware->entries,
+                   sizeof(catzilla_middleware_step_t) * route_middleware->middleware_count);
+            catzilla_cache_free(route_middleware->entries);
+        }
 
-        // Zero-initialize new slots
-        memset(&new_functions[route_middleware->middleware_count], 0,
-               sizeof(void*) * (new_capacity - route_middleware->middleware_count));
-        memset(&new_priorities[route_middleware->middleware_count], 0,
-               sizeof(uint32_t) * (new_capacity - route_middleware->middleware_count));
-        memset(&new_flags[route_middleware->middleware_count], 0,
-               sizeof(uint32_t) * (new_capacity - route_middleware->middleware_count));
+        route_middleware->entries = new_entries;
+        route_middleware->middleware_capacity = new_capacity;
     }
 
     // Find insertion point to maintain priority order
     int insert_pos = route_middleware->middleware_count;
     for (int i = 0; i < route_middleware->middleware_count; i++) {
-        if (priority < route_middleware->middleware_priorities[i]) {
+        if (priority < route_middleware->entries[i].priority) {
             insert_pos = i;
             break;
         }
@@ -700,29 +767,22 @@ int catzilla_route_middleware_add(catzilla_route_middleware_t* route_middleware,
 
     // Shift existing middleware to make room
     if (insert_pos < route_middleware->middleware_count) {
-        memmove(&route_middleware->middleware_functions[insert_pos + 1],
-                &route_middleware->middleware_functions[insert_pos],
-                sizeof(void*) * (route_middleware->middleware_count - insert_pos));
-        memmove(&route_middleware->middleware_priorities[insert_pos + 1],
-                &route_middleware->middleware_priorities[insert_pos],
-                sizeof(uint32_t) * (route_middleware->middleware_count - insert_pos));
-        memmove(&route_middleware->middleware_flags[insert_pos + 1],
-                &route_middleware->middleware_flags[insert_pos],
-                sizeof(uint32_t) * (route_middleware->middleware_count - insert_pos));
-    }
-
-    // Insert new middleware
-    route_middleware->middleware_functions[insert_pos] = (void*)middleware_fn;
-    route_middleware->middleware_priorities[insert_pos] = priority;
-    route_middleware->middleware_flags[insert_pos] = 0; // Initialize flags
+        memmove(&route_middleware->entries[insert_pos + 1],
+                &route_middleware->entries[insert_pos],
+                sizeof(catzilla_middleware_step_t) * (route_middleware->middleware_count - insert_pos));
+    }
+
+    route_middleware->entries[insert_pos].fn = middleware_fn;
+    route_middleware->entries[insert_pos].priority = priority;
+    route_middleware->entries[insert_pos].phases = CATZILLA_MIDDLEWARE_PRE_ROUTE;
     route_middleware->middleware_count++;
 
-    return 0;
+    return catzilla_route_middleware_compile(route_middleware, route_middleware->global);
 }
 
 /**
  * Cleanup per-route middleware chain
- * Zero-allocation cleanup that only frees the allocated arrays
+ * Frees the entries and the compiled pipeline
  *
  * @param route_middleware The middleware chain to cleanup
  */
@@ -731,21 +791,19 @@ void catzilla_route_middleware_cleanup(catzilla_route_middleware_t* route_middle
         return;
     }
 
-    if (route_middleware->middleware_functions) {
-        catzilla_cache_free(route_middleware->middleware_functions);
-        route_middleware->middleware_functions = NULL;
-    }
-
-    if (route_middleware->middleware_priorities) {
-        catzilla_cache_free(route_middleware->middleware_priorities);
-        route_middleware->middleware_priorities = NULL;
+    if (route_middleware->entries) {
+        catzilla_cache_free(route_middleware->entries);
+        route_middleware->entries = NULL;
     }
 
-    if (route_middleware->middleware_flags) {
-        catzilla_cache_free(route_middleware->middleware_flags);
-        route_middleware->middleware_flags = NULL;
+    if (route_middleware->steps) {
+        catzilla_cache_free(route_middleware->steps);
+        route_middleware->steps = NULL;
     }
 
     route_middleware->middleware_count = 0;
     route_middleware->middleware_capacity = 0;
+    route_middleware->pre_count = 0;
+    route_middleware->post_count = 0;
+    route_middleware->phases = 0;
 }
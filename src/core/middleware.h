@@ -98,12 +98,15 @@ typedef struct catzilla_middleware_chain_s {
 } catzilla_middleware_chain_t;
 
 /**
- * Per-request middleware execution context
+ * Per-request middleware execution context. Allocated from the request
+ * arena by catzilla_middleware_context_create; the larger tables are only
+ * allocated once a middleware uses them.
  */
 typedef struct catzilla_middleware_context_s {
     // Request data (zero-copy references)
     catzilla_request_t* request;
     catzilla_route_match_t* route_match;
+    catzilla_request_arena_t* arena;            // Request arena backing the context
 
     // Middleware execution state
     int current_middleware_index;
@@ -121,7 +124,8 @@ typedef struct catzilla_middleware_context_s {
 
     // Performance tracking
     uint64_t execution_start_time;
-    uint64_t middleware_timings[CATZILLA_MAX_MIDDLEWARES];
+    uint64_t* middleware_timings;               // One slot per pipeline step
+    int timing_count;
 
     // Response building (if middleware handles response)
     char* response_body;
@@ -129,8 +133,8 @@ typedef struct catzilla_middleware_context_s {
     char* response_content_type;
     int response_status;
 
-    // Response headers
-    catzilla_response_header_t response_headers[CATZILLA_MAX_RESPONSE_HEADERS];
+    // Response headers (CATZILLA_MAX_RESPONSE_HEADERS slots, allocated on the first one)
+    catzilla_response_header_t* response_headers;
     int response_header_count;
 
     // Error handling
@@ -140,8 +144,8 @@ typedef struct catzilla_middleware_context_s {
     // Python bridge (for business logic fallback)
     void* python_context;                       // Only allocated if needed
 
-    // Middleware-specific context data
-    void* middleware_data[CATZILLA_MAX_MIDDLEWARES];
+    // Middleware-specific context data (CATZILLA_MAX_MIDDLEWARES slots, allocated on first use)
+    void** middleware_data;
 } catzilla_middleware_context_t;
 
 /**
@@ -242,6 +246,18 @@ void catzilla_middleware_reset_stats(catzilla_middleware_chain_t* chain);
 // MIDDLEWARE CONTEXT UTILITIES
 // ============================================================================
 
+/**
+ * Allocate a middleware context from the request's arena. It is released
+ * with the arena; nothing needs to free it.
+ * @param request Request the middleware runs for
+ * @param route_match Route match result (may be NULL)
+ * @param timing_count Number of pipeline steps to keep timings for
+ * @return Context, or NULL on allocation failure
+ */
+catzilla_middleware_context_t* catzilla_middleware_context_create(catzilla_request_t* request,
+                                                                  catzilla_route_match_t* route_match,
+                                                                  int timing_count);
+
 /**
  * Set response status in middleware context
  * @param ctx Middleware context
@@ -290,6 +306,15 @@ void catzilla_middleware_set_error(catzilla_middleware_context_t* ctx,
 const char* catzilla_middleware_get_header(catzilla_middleware_context_t* ctx,
                                           const char* name);
 
+/**
+ * Get a well-known request header value in O(1)
+ * @param ctx Middleware context
+ * @param header_id Slot id from catzilla_known_header_t (e.g. CATZILLA_HDR_AUTHORIZATION)
+ * @return Header value or NULL if not found
+ */
+const char* catzilla_middleware_get_known_header(catzilla_middleware_context_t* ctx,
+                                                int header_id);
+
 /**
  * Set middleware-specific context data
  * @param ctx Middleware context
@@ -367,8 +392,19 @@ uint64_t catzilla_middleware_calculate_duration(uint64_t start_time, uint64_t en
 // ============================================================================
 
 /**
- * Execute per-route middleware chain for a specific route
- * Zero-allocation execution of route-specific middleware
+ * Flatten a route's middleware and the global chain into the route's
+ * pipeline, ordered by priority (global middleware first on a tie)
+ *
+ * @param route_middleware The per-route middleware chain to compile
+ * @param global Global middleware chain (may be NULL)
+ * @return 0 on success, -1 on error
+ */
+int catzilla_route_middleware_compile(catzilla_route_middleware_t* route_middleware,
+                                      const catzilla_middleware_chain_t* global);
+
+/**
+ * Execute the pre-route steps of a route's compiled pipeline
+ * Returns at once when the route has no pre-route middleware
  *
  * @param route_middleware The per-route middleware chain to execute
  * @param ctx The middleware context for execution
@@ -379,6 +415,17 @@ int catzilla_middleware_execute_per_route(catzilla_route_middleware_t* route_mid
                                          catzilla_middleware_context_t* ctx,
                                          catzilla_di_container_t* di_container);
 
+/**
+ * Execute the post-route steps of a route's compiled pipeline; every step
+ * runs even after one fails
+ *
+ * @param route_middleware The per-route middleware chain to execute
+ * @param ctx The middleware context used for the pre-route steps
+ * @return 0 on success, -1 if a step returned an error
+ */
+int catzilla_middleware_execute_post_route(catzilla_route_middleware_t* route_middleware,
+                                          catzilla_middleware_context_t* ctx);
+
 /**
  * Initialize per-route middleware chain
  * Zero-allocation initialization for route-specific middleware
@@ -390,8 +437,8 @@ int catzilla_middleware_execute_per_route(catzilla_route_middleware_t* route_mid
 int catzilla_route_middleware_init(catzilla_route_middleware_t* route_middleware, int initial_capacity);
 
 /**
- * Add middleware to per-route chain
- * Zero-allocation addition with priority-based ordering
+ * Add pre-route middleware to per-route chain and recompile its pipeline
+ * Priority-based ordering; call before the router is shared
  *
  * @param route_middleware The middleware chain to add to
  * @param middleware_fn The middleware function to add
@@ -410,4 +457,35 @@ int catzilla_route_middleware_add(catzilla_route_middleware_t* route_middleware,
  */
 void catzilla_route_middleware_cleanup(catzilla_route_middleware_t* route_middleware);
 
+// ============================================================================
+// BUILT-IN MIDDLEWARE (middleware_builtins.c)
+// ============================================================================
+
+int catzilla_middleware_cors(catzilla_middleware_context_t* ctx);
+int catzilla_middleware_request_logging(catzilla_middleware_context_t* ctx);
+int catzilla_middleware_response_logging(catzilla_middleware_context_t* ctx);
+int catzilla_middleware_rate_limit(catzilla_middleware_context_t* ctx);
+int catzilla_middleware_auth(catzilla_middleware_context_t* ctx);
+int catzilla_middleware_security_headers(catzilla_middleware_context_t* ctx);
+int catzilla_middleware_compression(catzilla_middleware_context_t* ctx);
+
+/**
+ * Register all built-in middleware with a chain
+ * @param chain Middleware chain
+ * @return 0 on success, -1 on failure
+ */
+int catzilla_register_builtin_middleware(catzilla_middleware_chain_t* chain);
+
+/**
+ * Configure the default rate limit, used by routes without their own
+ * @param max_requests Maximum requests per window
+ * @param window_seconds Window size in seconds
+ */
+void catzilla_configure_rate_limiting(int max_requests, int window_seconds);
+
+/**
+ * Drop the default rate limiter and its buckets
+ */
+void catzilla_reset_rate_limiting(void);
+
 #endif /* CATZILLA_MIDDLEWARE_H */
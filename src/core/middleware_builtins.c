@@ -1,27 +1,23 @@
 #include "middleware.h"
 #include "memory.h"
+#include "rate_limiter.h"
+#include "compression.h"
+#include "platform_atomic.h"
 #include <string.h>
 #include <stdio.h>
 #include <time.h>
 #include <stdlib.h>
+#include <stdint.h>
 
 // ============================================================================
 // 🌪️ BUILT-IN ZERO-ALLOCATION MIDDLEWARE - HIGH-PERFORMANCE C IMPLEMENTATIONS
 // ============================================================================
 
-// Simple rate limiting state (in production, would use more sophisticated storage)
-static struct {
-    char client_ips[1000][16];    // Simple IP storage
-    uint64_t request_times[1000]; // Request timestamps
-    int request_counts[1000];     // Request counts
-    int entry_count;
-    uint64_t window_size_ns;      // Rate limiting window in nanoseconds
-    int max_requests;             // Max requests per window
-} rate_limit_state = {
-    .window_size_ns = 60ULL * 1000000000ULL, // 60 seconds
-    .max_requests = 1000,
-    .entry_count = 0
-};
+// Limiter for routes without their own limits; created on first use with
+// 1000 requests per minute unless configured
+static catzilla_rate_limiter_t* default_rate_limiter = NULL;
+static uint32_t default_rate_requests = 1000;
+static uint32_t default_rate_period_ms = 60 * 1000;
 
 // ============================================================================
 // CORS MIDDLEWARE - ZERO ALLOCATION
@@ -77,14 +73,14 @@ int catzilla_middleware_request_logging(catzilla_middleware_context_t* ctx) {
     if (!client_ip) client_ip = "unknown";
 
     // Get user agent (with fallback)
-    const char* user_agent = ctx->request->user_agent;
+    const char* user_agent = catzilla_middleware_get_known_header(ctx, CATZILLA_HDR_USER_AGENT);
     if (!user_agent) user_agent = "-";
 
     // Format: [timestamp] METHOD path client_ip "user_agent"
-    printf("[%llu] %s %s %s \"%s\"\\n",
-           timestamp,
-           ctx->request->method ? ctx->request->method : "UNKNOWN",
-           ctx->request->path ? ctx->request->path : "/",
+    printf("[%llu] %s %s %s \"%s\"\n",
+           (unsigned long long)timestamp,
+           ctx->request->method[0] ? ctx->request->method : "UNKNOWN",
+           ctx->request->path[0] ? ctx->request->path : "/",
            client_ip,
            user_agent);
 
@@ -114,7 +110,7 @@ int catzilla_middleware_response_logging(catzilla_middleware_context_t* ctx) {
         uint64_t end_time = catzilla_middleware_get_timestamp();
         uint64_t duration = end_time - *start_time;
 
-        printf("[RESPONSE] %d %llu ns\\n", ctx->response_status, duration);
+        printf("[RESPONSE] %d %llu ns\n", ctx->response_status, (unsigned long long)duration);
 
         // Free the start time memory
         catzilla_request_free(start_time);
@@ -127,74 +123,81 @@ int catzilla_middleware_response_logging(catzilla_middleware_context_t* ctx) {
 // RATE LIMITING MIDDLEWARE - C-ONLY IMPLEMENTATION
 // ============================================================================
 
+static catzilla_rate_limiter_t* get_default_rate_limiter(void) {
+    catzilla_rate_limiter_t* limiter = catzilla_atomic_load_seq(&default_rate_limiter);
+    if (limiter) return limiter;
+
+    catzilla_rate_limit_config_t config = {0};
+    config.requests = default_rate_requests;
+    config.period_ms = default_rate_period_ms;
+    catzilla_rate_limiter_t* created = catzilla_rate_limiter_create(&config);
+    if (!created) return NULL;
+
+    // Threads racing on the first request agree on one limiter
+    limiter = catzilla_atomic_publish_ptr(&default_rate_limiter, created);
+    if (limiter != created) {
+        catzilla_rate_limiter_destroy(created);
+    }
+    return limiter;
+}
+
 /**
- * Simple rate limiting middleware with token bucket algorithm
- * In production, would use Redis or other distributed storage
+ * Rate limiting middleware: GCRA buckets keyed by client address, a header
+ * or the route, with per-route limits taking precedence over the default
  */
 int catzilla_middleware_rate_limit(catzilla_middleware_context_t* ctx) {
     if (!ctx || !ctx->request) {
         return CATZILLA_MIDDLEWARE_ERROR_CODE;
     }
 
-    const char* client_ip = ctx->request->remote_addr;
-    if (!client_ip) {
-        // No IP available, allow request
+    catzilla_route_t* route = ctx->route_match ? ctx->route_match->route : NULL;
+    catzilla_rate_limiter_t* limiter = route && route->rate_limit ?
+                                       route->rate_limit : get_default_rate_limiter();
+    if (!limiter) {
         return CATZILLA_MIDDLEWARE_CONTINUE;
     }
 
-    uint64_t current_time = catzilla_middleware_get_timestamp();
-    uint64_t window_start = current_time - rate_limit_state.window_size_ns;
-
-    // Find or create entry for this IP
-    int ip_index = -1;
-    for (int i = 0; i < rate_limit_state.entry_count; i++) {
-        if (strcmp(rate_limit_state.client_ips[i], client_ip) == 0) {
-            ip_index = i;
+    const catzilla_rate_limit_config_t* config = catzilla_rate_limiter_get_config(limiter);
+    const char* key = NULL;
+    switch (config->key_kind) {
+        case CATZILLA_RATE_KEY_HEADER:
+            key = catzilla_middleware_get_header(ctx, config->key_header);
+            break;
+        case CATZILLA_RATE_KEY_ROUTE:
+            key = route ? route->path : ctx->request->path;
+            break;
+        case CATZILLA_RATE_KEY_CLIENT:
+        default:
+            key = ctx->request->remote_addr;
             break;
-        }
-    }
-
-    if (ip_index == -1) {
-        // New IP, create entry if we have space
-        if (rate_limit_state.entry_count < 1000) {
-            ip_index = rate_limit_state.entry_count++;
-            strncpy(rate_limit_state.client_ips[ip_index], client_ip, 15);
-            rate_limit_state.client_ips[ip_index][15] = '\\0';
-            rate_limit_state.request_times[ip_index] = current_time;
-            rate_limit_state.request_counts[ip_index] = 1;
-        }
-        return CATZILLA_MIDDLEWARE_CONTINUE; // Allow new IPs
     }
-
-    // Check if we're within the rate limit window
-    if (rate_limit_state.request_times[ip_index] < window_start) {
-        // Outside window, reset counter
-        rate_limit_state.request_times[ip_index] = current_time;
-        rate_limit_state.request_counts[ip_index] = 1;
+    if (!key) {
+        // Nothing to count the request against, allow it
         return CATZILLA_MIDDLEWARE_CONTINUE;
     }
 
-    // Within window, check if over limit
-    if (rate_limit_state.request_counts[ip_index] >= rate_limit_state.max_requests) {
-        // Rate limited
+    catzilla_rate_limit_result_t result;
+    int outcome = catzilla_rate_limiter_check(limiter, key, strlen(key), &result);
+
+    char limit[16], remaining[16];
+    snprintf(limit, sizeof(limit), "%u", result.limit);
+    snprintf(remaining, sizeof(remaining), "%u", result.remaining);
+
+    if (outcome == 1) {
+        char retry_after[24];
+        snprintf(retry_after, sizeof(retry_after), "%llu",
+                 (unsigned long long)((result.retry_after_ms + 999) / 1000));
+
         catzilla_middleware_set_status(ctx, 429);
-        catzilla_middleware_set_header(ctx, "Retry-After", "60");
-        catzilla_middleware_set_header(ctx, "X-RateLimit-Limit", "1000");
+        catzilla_middleware_set_header(ctx, "Retry-After", retry_after);
+        catzilla_middleware_set_header(ctx, "X-RateLimit-Limit", limit);
         catzilla_middleware_set_header(ctx, "X-RateLimit-Remaining", "0");
         catzilla_middleware_set_body(ctx, "Rate limit exceeded", "text/plain");
 
         return CATZILLA_MIDDLEWARE_SKIP_ROUTE;
     }
 
-    // Increment counter and allow
-    rate_limit_state.request_counts[ip_index]++;
-
-    // Add rate limit headers
-    char remaining[32];
-    snprintf(remaining, sizeof(remaining), "%d",
-             rate_limit_state.max_requests - rate_limit_state.request_counts[ip_index]);
-
-    catzilla_middleware_set_header(ctx, "X-RateLimit-Limit", "1000");
+    catzilla_middleware_set_header(ctx, "X-RateLimit-Limit", limit);
     catzilla_middleware_set_header(ctx, "X-RateLimit-Remaining", remaining);
 
     return CATZILLA_MIDDLEWARE_CONTINUE;
@@ -290,19 +293,18 @@ int catzilla_middleware_security_headers(catzilla_middleware_context_t* ctx) {
 
 /**
  * Response compression middleware
- * Note: This is a simplified implementation. Production would use zlib.
+ * The body is compressed in the send path once the server has compression
+ * enabled; here the response only advertises that it varies by coding.
  */
 int catzilla_middleware_compression(catzilla_middleware_context_t* ctx) {
     if (!ctx) {
         return CATZILLA_MIDDLEWARE_ERROR_CODE;
     }
 
-    // Check if client accepts gzip compression
+    catzilla_compression_config_t config;
+    catzilla_compression_config_init(&config);
     const char* accept_encoding = catzilla_middleware_get_header(ctx, "Accept-Encoding");
-
-    if (accept_encoding && strstr(accept_encoding, "gzip") != NULL) {
-        // Add compression header (actual compression would happen in response building)
-        catzilla_middleware_set_header(ctx, "Content-Encoding", "gzip");
+    if (catzilla_compression_negotiate(&config, accept_encoding, SIZE_MAX) != CATZILLA_ENCODING_IDENTITY) {
         catzilla_middleware_set_header(ctx, "Vary", "Accept-Encoding");
     }
 
@@ -376,21 +378,24 @@ int catzilla_register_builtin_middleware(catzilla_middleware_chain_t* chain) {
 }
 
 /**
- * Configure rate limiting parameters
+ * Configure the default rate limit, used by routes without their own
  * @param max_requests Maximum requests per window
  * @param window_seconds Window size in seconds
  */
 void catzilla_configure_rate_limiting(int max_requests, int window_seconds) {
-    rate_limit_state.max_requests = max_requests;
-    rate_limit_state.window_size_ns = (uint64_t)window_seconds * 1000000000ULL;
+    if (max_requests <= 0 || window_seconds <= 0) return;
+
+    default_rate_requests = (uint32_t)max_requests;
+    default_rate_period_ms = (uint32_t)window_seconds * 1000;
+    catzilla_reset_rate_limiting();
 }
 
 /**
- * Reset rate limiting state (for testing)
+ * Drop the default limiter and its buckets; the next request creates a new
+ * one. Not safe while requests are being served (for configuration and tests).
  */
 void catzilla_reset_rate_limiting(void) {
-    rate_limit_state.entry_count = 0;
-    memset(rate_limit_state.client_ips, 0, sizeof(rate_limit_state.client_ips));
-    memset(rate_limit_state.request_times, 0, sizeof(rate_limit_state.request_times));
-    memset(rate_limit_state.request_counts, 0, sizeof(rate_limit_state.request_counts));
+    catzilla_rate_limiter_t* limiter = catzilla_atomic_load_seq(&default_rate_limiter);
+    catzilla_atomic_store_seq(&default_rate_limiter, NULL);
+    catzilla_rate_limiter_destroy(limiter);
 }
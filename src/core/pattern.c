@@ -0,0 +1,1221 @@
+#include "pattern.h"
+#include "memory.h"
+#include "platform_compat.h"
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#include <strings.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CATZILLA_PATTERN_SSE2 1
+#endif
+
+#define PATTERN_DEAD_STATE 0
+
+typedef enum {
+    PATTERN_KIND_DFA,
+    PATTERN_KIND_CHARSET
+} pattern_kind_t;
+
+struct catzilla_pattern_s {
+    pattern_kind_t kind;
+    bool anchored_start;
+    bool anchored_end;
+
+    // DFA: transitions[state * class_count + byte_class[byte]], state 0 is dead
+    uint8_t byte_class[256];
+    int class_count;
+    int state_count;
+    int start_state;
+    uint16_t* transitions;
+    uint8_t* accepting;
+
+    // Charset: every byte in set, between min_count and max_count of them
+    uint8_t set[32];
+    size_t min_count;
+    size_t max_count;       // SIZE_MAX when unbounded
+    bool is_range;          // set is exactly [range_lo-range_hi]
+    uint8_t range_lo;
+    uint8_t range_hi;
+};
+
+static inline bool set_has(const uint8_t* set, uint8_t c) {
+    return (set[c >> 3] >> (c & 7)) & 1;
+}
+
+static inline void set_add(uint8_t* set, uint8_t c) {
+    set[c >> 3] |= (uint8_t)(1u << (c & 7));
+}
+
+static void set_add_range(uint8_t* set, int lo, int hi) {
+    for (int c = lo; c <= hi; c++) set_add(set, (uint8_t)c);
+}
+
+static inline int popcount64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (int)((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// ---------------------------------------------------------------------------
+// SIMD helpers
+// ---------------------------------------------------------------------------
+
+size_t catzilla_utf8_length(const char* str, size_t len) {
+    const uint8_t* s = (const uint8_t*)str;
+    size_t count = 0;
+    size_t i = 0;
+
+#ifdef CATZILLA_PATTERN_SSE2
+    // Continuation bytes are 0x80-0xBF: as signed bytes, -128..-65
+    const __m128i threshold = _mm_set1_epi8((char)0xBF);
+    for (; i + 16 <= len; i += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)(s + i));
+        count += (size_t)popcount64((uint64_t)_mm_movemask_epi8(_mm_cmpgt_epi8(block, threshold)));
+    }
+#else
+    for (; i + 8 <= len; i += 8) {
+        uint64_t block;
+        memcpy(&block, s + i, sizeof(block));
+        // Top bits 10 mark a continuation byte
+        uint64_t continuation = block & ~(block << 1) & 0x8080808080808080ULL;
+        count += 8 - (size_t)popcount64(continuation);
+    }
+#endif
+
+    for (; i < len; i++) {
+        if ((s[i] & 0xC0) != 0x80) count++;
+    }
+    return count;
+}
+
+// Check that every byte lies in [lo, hi]
+static bool bytes_in_range(const uint8_t* s, size_t len, uint8_t lo, uint8_t hi) {
+    const uint8_t span = (uint8_t)(hi - lo);
+    size_t i = 0;
+
+#ifdef CATZILLA_PATTERN_SSE2
+    const __m128i vlo = _mm_set1_epi8((char)lo);
+    const __m128i vspan = _mm_set1_epi8((char)span);
+    for (; i + 16 <= len; i += 16) {
+        __m128i offset = _mm_sub_epi8(_mm_loadu_si128((const __m128i*)(s + i)), vlo);
+        // offset <= span (unsigned) exactly when max(offset, span) == span
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(offset, vspan), vspan)) != 0xFFFF) {
+            return false;
+        }
+    }
+#endif
+
+    for (; i < len; i++) {
+        if ((uint8_t)(s[i] - lo) > span) return false;
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Parser: pattern text to syntax tree
+// ---------------------------------------------------------------------------
+
+typedef enum {
+    NODE_EMPTY,
+    NODE_SET,
+    NODE_CONCAT,
+    NODE_ALT,
+    NODE_REPEAT
+} node_type_t;
+
+typedef struct pattern_node {
+    node_type_t type;
+    int min;                        // NODE_REPEAT
+    int max;                        // NODE_REPEAT, -1 when unbounded
+    uint8_t set[32];                // NODE_SET
+    struct pattern_node* child;     // First child of CONCAT, ALT and REPEAT
+    struct pattern_node* next;      // Next sibling
+} pattern_node_t;
+
+typedef struct {
+    const char* p;
+    const char* end;
+    pattern_node_t* nodes;
+    int node_count;
+    int node_capacity;
+    int depth;                      // Open groups
+    bool top_level_alternation;     // '|' outside any group
+    bool failed;
+} pattern_parser_t;
+
+static pattern_node_t* new_node(pattern_parser_t* parser, node_type_t type) {
+    if (parser->node_count >= parser->node_capacity) {
+        parser->failed = true;
+        return NULL;
+    }
+    pattern_node_t* node = &parser->nodes[parser->node_count++];
+    memset(node, 0, sizeof(*node));
+    node->type = type;
+    return node;
+}
+
+static pattern_node_t* new_set_node(pattern_parser_t* parser, const uint8_t* set) {
+    pattern_node_t* node = new_node(parser, NODE_SET);
+    if (node) memcpy(node->set, set, sizeof(node->set));
+    return node;
+}
+
+static pattern_node_t* new_range_node(pattern_parser_t* parser, int lo, int hi) {
+    uint8_t set[32] = {0};
+    set_add_range(set, lo, hi);
+    return new_set_node(parser, set);
+}
+
+// Append child to a CONCAT or ALT node
+static void append_child(pattern_node_t* parent, pattern_node_t** last, pattern_node_t* child) {
+    if (*last) {
+        (*last)->next = child;
+    } else {
+        parent->child = child;
+    }
+    *last = child;
+}
+
+// One UTF-8 encoded character other than the ASCII bytes in excluded:
+// the ASCII rest | [C2-DF][80-BF] | [E0-EF][80-BF]{2} | [F0-F4][80-BF]{3}
+static pattern_node_t* new_any_char_node(pattern_parser_t* parser, const uint8_t* excluded) {
+    static const int leads[3][2] = { {0xC2, 0xDF}, {0xE0, 0xEF}, {0xF0, 0xF4} };
+
+    pattern_node_t* alt = new_node(parser, NODE_ALT);
+    if (!alt) return NULL;
+    pattern_node_t* last = NULL;
+
+    uint8_t ascii[32] = {0};
+    for (int c = 1; c < 0x80; c++) {
+        if (!excluded || !set_has(excluded, (uint8_t)c)) set_add(ascii, (uint8_t)c);
+    }
+    pattern_node_t* single = new_set_node(parser, ascii);
+    if (!single) return NULL;
+    append_child(alt, &last, single);
+
+    for (int i = 0; i < 3; i++) {
+        pattern_node_t* sequence = new_node(parser, NODE_CONCAT);
+        pattern_node_t* lead = new_range_node(parser, leads[i][0], leads[i][1]);
+        if (!sequence || !lead) return NULL;
+        pattern_node_t* seq_last = NULL;
+        append_child(sequence, &seq_last, lead);
+        for (int k = 0; k <= i; k++) {
+            pattern_node_t* continuation = new_range_node(parser, 0x80, 0xBF);
+            if (!continuation) return NULL;
+            append_child(sequence, &seq_last, continuation);
+        }
+        append_child(alt, &last, sequence);
+    }
+    return alt;
+}
+
+// Fill set for \d \w \s (and their negations); returns -1 for other letters
+static int shorthand_class(char c, uint8_t* set, bool* negated) {
+    *negated = (c == 'D' || c == 'W' || c == 'S');
+    switch (c) {
+        case 'd': case 'D':
+            set_add_range(set, '0', '9');
+            return 0;
+        case 'w': case 'W':
+            set_add_range(set, 'a', 'z');
+            set_add_range(set, 'A', 'Z');
+            set_add_range(set, '0', '9');
+            set_add(set, '_');
+            return 0;
+        case 's': case 'S':
+            set_add(set, ' ');
+            set_add_range(set, '\t', '\r');  // \t \n \v \f \r
+            return 0;
+        default:
+            return -1;
+    }
+}
+
+// Decode an escaped literal; returns -1 for escapes the engine does not know
+static int escaped_literal(char c) {
+    switch (c) {
+        case 'n': return '\n';
+        case 't': return '\t';
+        case 'r': return '\r';
+        case 'f': return '\f';
+        case 'v': return '\v';
+        default:
+            // Escaped punctuation stands for itself; letters and digits are
+            // back-references, anchors or classes the engine does not support
+            if ((unsigned char)c < 0x80 && c > ' ' &&
+                !((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9'))) {
+                return (unsigned char)c;
+            }
+            return -1;
+    }
+}
+
+static bool add_posix_class(const char* name, size_t len, uint8_t* set) {
+    #define POSIX_CLASS_IS(literal) (len == sizeof(literal) - 1 && memcmp(name, literal, len) == 0)
+    if (POSIX_CLASS_IS("alpha")) {
+        set_add_range(set, 'a', 'z');
+        set_add_range(set, 'A', 'Z');
+    } else if (POSIX_CLASS_IS("digit")) {
+        set_add_range(set, '0', '9');
+    } else if (POSIX_CLASS_IS("alnum")) {
+        set_add_range(set, 'a', 'z');
+        set_add_range(set, 'A', 'Z');
+        set_add_range(set, '0', '9');
+    } else if (POSIX_CLASS_IS("upper")) {
+        set_add_range(set, 'A', 'Z');
+    } else if (POSIX_CLASS_IS("lower")) {
+        set_add_range(set, 'a', 'z');
+    } else if (POSIX_CLASS_IS("space")) {
+        set_add(set, ' ');
+        set_add_range(set, '\t', '\r');
+    } else if (POSIX_CLASS_IS("xdigit")) {
+        set_add_range(set, '0', '9');
+        set_add_range(set, 'a', 'f');
+        set_add_range(set, 'A', 'F');
+    } else if (POSIX_CLASS_IS("punct")) {
+        set_add_range(set, '!', '/');
+        set_add_range(set, ':', '@');
+        set_add_range(set, '[', '`');
+        set_add_range(set, '{', '~');
+    } else {
+        return false;
+    }
+    return true;
+    #undef POSIX_CLASS_IS
+}
+
+// Parse one class member that can start or end a range; returns -1 on failure
+static int parse_class_literal(pattern_parser_t* parser) {
+    if (parser->p >= parser->end) return -1;
+    unsigned char c = (unsigned char)*parser->p;
+    if (c >= 0x80) return -1;   // Multibyte members need a UTF-8 aware class
+    if (c == '\\') {
+        if (parser->p + 1 >= parser->end) return -1;
+        int literal = escaped_literal(parser->p[1]);
+        if (literal < 0) return -1;
+        parser->p += 2;
+        return literal;
+    }
+    parser->p++;
+    return c;
+}
+
+static pattern_node_t* parse_class(pattern_parser_t* parser) {
+    uint8_t set[32] = {0};
+    bool negate = false;
+    bool first = true;
+
+    if (parser->p < parser->end && *parser->p == '^') {
+        negate = true;
+        parser->p++;
+    }
+
+    while (parser->p < parser->end && (*parser->p != ']' || first)) {
+        first = false;
+
+        if (parser->p[0] == '[' && parser->p + 1 < parser->end && parser->p[1] == ':') {
+            const char* name = parser->p + 2;
+            const char* close = name;
+            while (close + 1 < parser->end && !(close[0] == ':' && close[1] == ']')) close++;
+            if (close + 1 >= parser->end || !add_posix_class(name, (size_t)(close - name), set)) {
+                return NULL;
+            }
+            parser->p = close + 2;
+            continue;
+        }
+
+        if (parser->p[0] == '\\' && parser->p + 1 < parser->end) {
+            bool negated;
+            uint8_t shorthand[32] = {0};
+            if (shorthand_class(parser->p[1], shorthand, &negated) == 0) {
+                if (negated) return NULL;
+                for (int i = 0; i < 32; i++) set[i] |= shorthand[i];
+                parser->p += 2;
+                continue;
+            }
+        }
+
+        int lo = parse_class_literal(parser);
+        if (lo < 0) return NULL;
+
+        if (parser->p + 1 < parser->end && parser->p[0] == '-' && parser->p[1] != ']') {
+            parser->p++;
+            int hi = parse_class_literal(parser);
+            if (hi < lo) return NULL;
+            set_add_range(set, lo, hi);
+        } else {
+            set_add(set, (uint8_t)lo);
+        }
+    }
+
+    if (parser->p >= parser->end) return NULL;   // Unterminated class
+    parser->p++;
+
+    return negate ? new_any_char_node(parser, set) : new_set_node(parser, set);
+}
+
+static pattern_node_t* parse_alternation(pattern_parser_t* parser);
+
+static pattern_node_t* parse_atom(pattern_parser_t* parser) {
+    unsigned char c = (unsigned char)*parser->p;
+
+    switch (c) {
+        case '(': {
+            parser->p++;
+            if (parser->p < parser->end && *parser->p == '?') {
+                if (parser->p + 1 < parser->end && parser->p[1] == ':') {
+                    parser->p += 2;
+                } else if (parser->p + 2 < parser->end && parser->p[1] == 'P' && parser->p[2] == '<') {
+                    const char* close = memchr(parser->p, '>', (size_t)(parser->end - parser->p));
+                    if (!close) return NULL;
+                    parser->p = close + 1;
+                } else {
+                    return NULL;   // Lookaround and inline flags
+                }
+            }
+            parser->depth++;
+            pattern_node_t* inner = parse_alternation(parser);
+            parser->depth--;
+            if (!inner || parser->p >= parser->end || *parser->p != ')') return NULL;
+            parser->p++;
+            return inner;
+        }
+
+        case '[':
+            parser->p++;
+            return parse_class(parser);
+
+        case '.':
+            parser->p++;
+            return new_any_char_node(parser, NULL);
+
+        case '\\': {
+            if (parser->p + 1 >= parser->end) return NULL;
+            char escaped = parser->p[1];
+            parser->p += 2;
+
+            bool negated;
+            uint8_t set[32] = {0};
+            if (shorthand_class(escaped, set, &negated) == 0) {
+                return negated ? new_any_char_node(parser, set) : new_set_node(parser, set);
+            }
+            int literal = escaped_literal(escaped);
+            if (literal < 0) return NULL;
+            set_add(set, (uint8_t)literal);
+            return new_set_node(parser, set);
+        }
+
+        case '^': case '$': case '*': case '+': case '?': case '{': case ')': case '|':
+            // Anchors inside the pattern and stray operators
+            return NULL;
+
+        default:
+            break;
+    }
+
+    if (c < 0x80) {
+        uint8_t set[32] = {0};
+        set_add(set, c);
+        parser->p++;
+        return new_set_node(parser, set);
+    }
+
+    // A multibyte character is one atom, so quantifiers apply to all of it
+    int length = (c >= 0xF0) ? 4 : (c >= 0xE0) ? 3 : (c >= 0xC2) ? 2 : 0;
+    if (length == 0 || c > 0xF4 || parser->end - parser->p < length) return NULL;
+
+    pattern_node_t* sequence = new_node(parser, NODE_CONCAT);
+    if (!sequence) return NULL;
+    pattern_node_t* last = NULL;
+    for (int i = 0; i < length; i++) {
+        unsigned char byte = (unsigned char)parser->p[i];
+        if (i > 0 && (byte & 0xC0) != 0x80) return NULL;
+        pattern_node_t* node = new_range_node(parser, byte, byte);
+        if (!node) return NULL;
+        append_child(sequence, &last, node);
+    }
+    parser->p += length;
+    return sequence;
+}
+
+// Parse {n}, {n,} or {n,m}; parser->p is just past '{'
+static bool parse_bounds(pattern_parser_t* parser, int* min, int* max) {
+    int values[2] = { -1, -1 };
+    int index = 0;
+    bool comma = false;
+
+    while (parser->p < parser->end && *parser->p != '}') {
+        char c = *parser->p++;
+        if (c >= '0' && c <= '9') {
+            if (values[index] < 0) values[index] = 0;
+            values[index] = values[index] * 10 + (c - '0');
+            if (values[index] > CATZILLA_PATTERN_MAX_REPEAT) return false;
+        } else if (c == ',' && !comma) {
+            comma = true;
+            index = 1;
+        } else {
+            return false;
+        }
+    }
+    if (parser->p >= parser->end || values[0] < 0) return false;
+    parser->p++;
+
+    *min = values[0];
+    *max = comma ? values[1] : values[0];
+    return *max < 0 || *max >= *min;
+}
+
+static pattern_node_t* parse_repeat(pattern_parser_t* parser) {
+    pattern_node_t* atom = parse_atom(parser);
+    if (!atom) return NULL;
+    if (parser->p >= parser->end) return atom;
+
+    int min, max;
+    switch (*parser->p) {
+        case '*': min = 0; max = -1; parser->p++; break;
+        case '+': min = 1; max = -1; parser->p++; break;
+        case '?': min = 0; max = 1; parser->p++; break;
+        case '{':
+            parser->p++;
+            if (!parse_bounds(parser, &min, &max)) return NULL;
+            break;
+        default:
+            return atom;
+    }
+
+    // Lazy quantifiers accept the same strings
+    if (parser->p < parser->end && *parser->p == '?') parser->p++;
+    // Stacked quantifiers are an error in Python and undefined in POSIX
+    if (parser->p < parser->end && strchr("*+?{", *parser->p)) return NULL;
+
+    pattern_node_t* repeat = new_node(parser, NODE_REPEAT);
+    if (!repeat) return NULL;
+    repeat->min = min;
+    repeat->max = max;
+    repeat->child = atom;
+    return repeat;
+}
+
+static pattern_node_t* parse_concatenation(pattern_parser_t* parser) {
+    pattern_node_t* concat = NULL;
+    pattern_node_t* first = NULL;
+    pattern_node_t* last = NULL;
+
+    while (parser->p < parser->end && *parser->p != '|' && *parser->p != ')') {
+        pattern_node_t* item = parse_repeat(parser);
+        if (!item) return NULL;
+        if (!first) {
+            first = item;
+            continue;
+        }
+        if (!concat) {
+            concat = new_node(parser, NODE_CONCAT);
+            if (!concat) return NULL;
+            append_child(concat, &last, first);
+        }
+        append_child(concat, &last, item);
+    }
+
+    if (concat) return concat;
+    return first ? first : new_node(parser, NODE_EMPTY);
+}
+
+static pattern_node_t* parse_alternation(pattern_parser_t* parser) {
+    pattern_node_t* first = parse_concatenation(parser);
+    if (!first || parser->p >= parser->end || *parser->p != '|') return first;
+
+    if (parser->depth == 0) parser->top_level_alternation = true;
+    pattern_node_t* alt = new_node(parser, NODE_ALT);
+    if (!alt) return NULL;
+    pattern_node_t* last = NULL;
+    append_child(alt, &last, first);
+
+    while (parser->p < parser->end && *parser->p == '|') {
+        parser->p++;
+        pattern_node_t* branch = parse_concatenation(parser);
+        if (!branch) return NULL;
+        append_child(alt, &last, branch);
+    }
+    return alt;
+}
+
+// ---------------------------------------------------------------------------
+// Thompson NFA
+// ---------------------------------------------------------------------------
+
+#define PATTERN_MAX_NFA_STATES 8192
+
+typedef enum {
+    NFA_SET,
+    NFA_SPLIT,
+    NFA_MATCH
+} nfa_type_t;
+
+typedef struct {
+    nfa_type_t type;
+    const uint8_t* set;     // NFA_SET
+    int out;
+    int out1;               // NFA_SPLIT
+} nfa_state_t;
+
+typedef struct {
+    nfa_state_t* states;
+    int count;
+    bool failed;
+} nfa_t;
+
+static int nfa_add(nfa_t* nfa, nfa_type_t type, const uint8_t* set, int out, int out1) {
+    if (nfa->count >= PATTERN_MAX_NFA_STATES) {
+        nfa->failed = true;
+        return -1;
+    }
+    nfa_state_t* state = &nfa->states[nfa->count];
+    state->type = type;
+    state->set = set;
+    state->out = out;
+    state->out1 = out1;
+    return nfa->count++;
+}
+
+// Build node so that it continues to next; returns its entry state. The
+// automaton is built back to front, so every state knows its successor.
+static int nfa_build(nfa_t* nfa, const pattern_node_t* node, int next);
+
+static int nfa_build_sequence(nfa_t* nfa, const pattern_node_t* child, int next) {
+    if (!child) return next;
+    int rest = nfa_build_sequence(nfa, child->next, next);
+    return rest < 0 ? -1 : nfa_build(nfa, child, rest);
+}
+
+static int nfa_build_branches(nfa_t* nfa, const pattern_node_t* child, int next) {
+    int entry = nfa_build(nfa, child, next);
+    if (entry < 0 || !child->next) return entry;
+    int rest = nfa_build_branches(nfa, child->next, next);
+    return rest < 0 ? -1 : nfa_add(nfa, NFA_SPLIT, NULL, entry, rest);
+}
+
+static int nfa_build(nfa_t* nfa, const pattern_node_t* node, int next) {
+    if (nfa->failed) return -1;
+
+    switch (node->type) {
+        case NODE_EMPTY:
+            return next;
+
+        case NODE_SET:
+            return nfa_add(nfa, NFA_SET, node->set, next, -1);
+
+        case NODE_CONCAT:
+            return nfa_build_sequence(nfa, node->child, next);
+
+        case NODE_ALT:
+            return nfa_build_branches(nfa, node->child, next);
+
+        case NODE_REPEAT: {
+            int tail = next;
+            if (node->max < 0) {
+                int loop = nfa_add(nfa, NFA_SPLIT, NULL, -1, next);
+                if (loop < 0) return -1;
+                int body = nfa_build(nfa, node->child, loop);
+                if (body < 0) return -1;
+                nfa->states[loop].out = body;
+                tail = loop;
+            } else {
+                for (int i = 0; i < node->max - node->min; i++) {
+                    int body = nfa_build(nfa, node->child, tail);
+                    if (body < 0) return -1;
+                    tail = nfa_add(nfa, NFA_SPLIT, NULL, body, tail);
+                    if (tail < 0) return -1;
+                }
+            }
+            for (int i = 0; i < node->min; i++) {
+                tail = nfa_build(nfa, node->child, tail);
+                if (tail < 0) return -1;
+            }
+            return tail;
+        }
+    }
+    return -1;
+}
+
+// ---------------------------------------------------------------------------
+// Subset construction
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    const nfa_t* nfa;
+    int* stack;
+    uint32_t* marks;         // marks[state] == mark_id when already in the set
+    uint32_t mark_id;
+
+    // DFA state sets, stored back to back in pool
+    int* pool;
+    size_t pool_count;
+    size_t pool_capacity;
+    int* set_offsets;
+    int* set_sizes;
+    int state_count;
+
+    int* hash_table;         // DFA state ids, -1 when empty
+    int hash_capacity;
+} dfa_builder_t;
+
+static int compare_ints(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+// Epsilon closure of seeds into out (sorted); returns the number of states
+static int nfa_closure(dfa_builder_t* builder, const int* seeds, int seed_count, int* out) {
+    const nfa_state_t* states = builder->nfa->states;
+    int stack_size = 0;
+    int count = 0;
+
+    builder->mark_id++;
+    for (int i = 0; i < seed_count; i++) {
+        if (builder->marks[seeds[i]] != builder->mark_id) {
+            builder->marks[seeds[i]] = builder->mark_id;
+            builder->stack[stack_size++] = seeds[i];
+        }
+    }
+
+    while (stack_size > 0) {
+        int s = builder->stack[--stack_size];
+        if (states[s].type != NFA_SPLIT) {
+            out[count++] = s;
+            continue;
+        }
+        int targets[2] = { states[s].out, states[s].out1 };
+        for (int k = 0; k < 2; k++) {
+            if (builder->marks[targets[k]] != builder->mark_id) {
+                builder->marks[targets[k]] = builder->mark_id;
+                builder->stack[stack_size++] = targets[k];
+            }
+        }
+    }
+
+    qsort(out, (size_t)count, sizeof(int), compare_ints);
+    return count;
+}
+
+static uint32_t hash_state_set(const int* set, int count) {
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < count; i++) {
+        hash = (hash ^ (uint32_t)set[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// Find or add the DFA state for a sorted NFA state set; -1 on overflow
+static int dfa_state_for(dfa_builder_t* builder, const int* set, int count) {
+    uint32_t slot = hash_state_set(set, count) & (uint32_t)(builder->hash_capacity - 1);
+
+    for (;;) {
+        int id = builder->hash_table[slot];
+        if (id < 0) break;
+        if (builder->set_sizes[id] == count &&
+            (count == 0 ||
+             memcmp(builder->pool + builder->set_offsets[id], set, sizeof(int) * (size_t)count) == 0)) {
+            return id;
+        }
+        slot = (slot + 1) & (uint32_t)(builder->hash_capacity - 1);
+    }
+
+    if (builder->state_count >= CATZILLA_PATTERN_MAX_STATES) return -1;
+
+    if (builder->pool_count + (size_t)count > builder->pool_capacity) {
+        size_t capacity = builder->pool_capacity * 2 + (size_t)count;
+        int* pool = catzilla_realloc(builder->pool, sizeof(int) * capacity);
+        if (!pool) return -1;
+        builder->pool = pool;
+        builder->pool_capacity = capacity;
+    }
+
+    int id = builder->state_count++;
+    if (count > 0) memcpy(builder->pool + builder->pool_count, set, sizeof(int) * (size_t)count);
+    builder->set_offsets[id] = (int)builder->pool_count;
+    builder->set_sizes[id] = count;
+    builder->pool_count += (size_t)count;
+    builder->hash_table[slot] = id;
+    return id;
+}
+
+// Split the 256 byte values into classes no NFA set tells apart
+static int compute_byte_classes(const nfa_t* nfa, uint8_t* byte_class, int* representative) {
+    int class_count = 1;
+    memset(byte_class, 0, 256);
+
+    for (int s = 0; s < nfa->count; s++) {
+        const uint8_t* set = nfa->states[s].set;
+        if (nfa->states[s].type != NFA_SET) continue;
+
+        int remap[512];
+        int refined = 0;
+        for (int i = 0; i < class_count * 2; i++) remap[i] = -1;
+        for (int b = 0; b < 256; b++) {
+            int key = byte_class[b] * 2 + (set_has(set, (uint8_t)b) ? 1 : 0);
+            if (remap[key] < 0) remap[key] = refined++;
+            byte_class[b] = (uint8_t)remap[key];
+        }
+        class_count = refined;
+        if (class_count == 256) break;
+    }
+
+    for (int k = 0; k < class_count; k++) representative[k] = -1;
+    for (int b = 0; b < 256; b++) {
+        if (representative[byte_class[b]] < 0) representative[byte_class[b]] = b;
+    }
+    return class_count;
+}
+
+static bool build_dfa(catzilla_pattern_t* pattern, const nfa_t* nfa, int nfa_start, int nfa_match) {
+    bool ok = false;
+    int representative[256];
+    pattern->class_count = compute_byte_classes(nfa, pattern->byte_class, representative);
+
+    dfa_builder_t builder = {0};
+    builder.nfa = nfa;
+    builder.hash_capacity = CATZILLA_PATTERN_MAX_STATES * 2;
+    builder.stack = catzilla_malloc(sizeof(int) * (size_t)nfa->count);
+    builder.marks = catzilla_calloc((size_t)nfa->count, sizeof(uint32_t));
+    builder.set_offsets = catzilla_malloc(sizeof(int) * CATZILLA_PATTERN_MAX_STATES);
+    builder.set_sizes = catzilla_malloc(sizeof(int) * CATZILLA_PATTERN_MAX_STATES);
+    builder.hash_table = catzilla_malloc(sizeof(int) * (size_t)builder.hash_capacity);
+    builder.pool_capacity = (size_t)nfa->count * 4;
+    builder.pool = catzilla_malloc(sizeof(int) * builder.pool_capacity);
+
+    int* seeds = catzilla_malloc(sizeof(int) * ((size_t)nfa->count + 1));
+    int* closure = catzilla_malloc(sizeof(int) * (size_t)nfa->count);
+    uint16_t* transitions = catzilla_malloc(sizeof(uint16_t) * (size_t)pattern->class_count *
+                                            CATZILLA_PATTERN_MAX_STATES);
+    uint8_t* accepting = catzilla_calloc(CATZILLA_PATTERN_MAX_STATES, 1);
+
+    if (!builder.stack || !builder.marks || !builder.set_offsets || !builder.set_sizes ||
+        !builder.hash_table || !builder.pool || !seeds || !closure || !transitions || !accepting) {
+        goto done;
+    }
+    memset(builder.hash_table, 0xFF, sizeof(int) * (size_t)builder.hash_capacity);
+
+    // State 0 is the dead state, the empty set
+    dfa_state_for(&builder, NULL, 0);
+
+    int count = nfa_closure(&builder, &nfa_start, 1, closure);
+    pattern->start_state = dfa_state_for(&builder, closure, count);
+
+    for (int id = 0; id < builder.state_count; id++) {
+        uint16_t* row = transitions + (size_t)id * (size_t)pattern->class_count;
+        const int* set = builder.pool + builder.set_offsets[id];
+        int size = builder.set_sizes[id];
+
+        for (int i = 0; i < size; i++) {
+            if (set[i] == nfa_match) accepting[id] = 1;
+        }
+
+        // Without $ the first accepting state ends the search, so nothing
+        // beyond it is needed
+        if (id == PATTERN_DEAD_STATE || (accepting[id] && !pattern->anchored_end)) {
+            for (int k = 0; k < pattern->class_count; k++) row[k] = (uint16_t)id;
+            continue;
+        }
+
+        for (int k = 0; k < pattern->class_count; k++) {
+            uint8_t byte = (uint8_t)representative[k];
+            int seed_count = 0;
+            set = builder.pool + builder.set_offsets[id];   // The pool may have moved
+            for (int i = 0; i < size; i++) {
+                const nfa_state_t* state = &nfa->states[set[i]];
+                if (state->type == NFA_SET && set_has(state->set, byte)) {
+                    seeds[seed_count++] = state->out;
+                }
+            }
+            // An unanchored search may start a new match at every byte
+            if (!pattern->anchored_start) seeds[seed_count++] = nfa_start;
+
+            count = seed_count > 0 ? nfa_closure(&builder, seeds, seed_count, closure) : 0;
+            int target = dfa_state_for(&builder, closure, count);
+            if (target < 0) goto done;
+            row[k] = (uint16_t)target;
+        }
+    }
+
+    pattern->state_count = builder.state_count;
+    pattern->transitions = catzilla_cache_alloc(sizeof(uint16_t) * (size_t)pattern->class_count *
+                                                (size_t)pattern->state_count);
+    pattern->accepting = catzilla_cache_alloc((size_t)pattern->state_count);
+    if (!pattern->transitions || !pattern->accepting) goto done;
+    memcpy(pattern->transitions, transitions,
+           sizeof(uint16_t) * (size_t)pattern->class_count * (size_t)pattern->state_count);
+    memcpy(pattern->accepting, accepting, (size_t)pattern->state_count);
+    ok = true;
+
+done:
+    catzilla_free(builder.stack);
+    catzilla_free(builder.marks);
+    catzilla_free(builder.set_offsets);
+    catzilla_free(builder.set_sizes);
+    catzilla_free(builder.hash_table);
+    catzilla_free(builder.pool);
+    catzilla_free(seeds);
+    catzilla_free(closure);
+    catzilla_free(transitions);
+    catzilla_free(accepting);
+    return ok;
+}
+
+// ^C$, ^C*$, ^C+$ or ^C{n,m}$ for one ASCII class C becomes a charset check
+static bool try_charset(catzilla_pattern_t* pattern, const pattern_node_t* root) {
+    if (!pattern->anchored_start || !pattern->anchored_end) return false;
+
+    const pattern_node_t* set_node = root;
+    size_t min = 1, max = 1;
+    if (root->type == NODE_REPEAT) {
+        set_node = root->child;
+        min = (size_t)root->min;
+        max = root->max < 0 ? SIZE_MAX : (size_t)root->max;
+    }
+    if (set_node->type != NODE_SET) return false;
+
+    int lo = -1, hi = -1;
+    for (int c = 0; c < 256; c++) {
+        if (!set_has(set_node->set, (uint8_t)c)) continue;
+        if (c >= 0x80) return false;
+        if (lo < 0) lo = c;
+        hi = c;
+    }
+    if (lo < 0) return false;
+
+    pattern->kind = PATTERN_KIND_CHARSET;
+    memcpy(pattern->set, set_node->set, sizeof(pattern->set));
+    pattern->min_count = min;
+    pattern->max_count = max;
+    pattern->is_range = true;
+    for (int c = lo; c <= hi; c++) {
+        if (!set_has(set_node->set, (uint8_t)c)) pattern->is_range = false;
+    }
+    pattern->range_lo = (uint8_t)lo;
+    pattern->range_hi = (uint8_t)hi;
+    return true;
+}
+
+catzilla_pattern_t* catzilla_pattern_compile(const char* text) {
+    if (!text) return NULL;
+    size_t length = strlen(text);
+    if (length > CATZILLA_PATTERN_MAX_LENGTH) return NULL;
+
+    catzilla_pattern_t* pattern = catzilla_cache_alloc(sizeof(catzilla_pattern_t));
+    if (!pattern) return NULL;
+    memset(pattern, 0, sizeof(*pattern));
+
+    pattern_parser_t parser = {0};
+    parser.p = text;
+    parser.end = text + length;
+
+    // Anchors are only supported around the whole pattern
+    if (parser.p < parser.end && *parser.p == '^') {
+        pattern->anchored_start = true;
+        parser.p++;
+    }
+    if (parser.end > parser.p && parser.end[-1] == '$' &&
+        !(parser.end - parser.p >= 2 && parser.end[-2] == '\\')) {
+        pattern->anchored_end = true;
+        parser.end--;
+    }
+
+    // new_any_char_node makes 14 nodes per '.' or negated class
+    parser.node_capacity = (int)length * 16 + 16;
+    parser.nodes = catzilla_malloc(sizeof(pattern_node_t) * (size_t)parser.node_capacity);
+    nfa_t nfa = {0};
+    nfa.states = catzilla_malloc(sizeof(nfa_state_t) * PATTERN_MAX_NFA_STATES);
+    bool ok = false;
+
+    if (parser.nodes && nfa.states) {
+        pattern_node_t* root = parse_alternation(&parser);
+        bool parsed = root && !parser.failed && parser.p == parser.end;
+        // ^a|b means (^a)|b, which a whole-pattern anchor cannot express
+        if (parsed && parser.top_level_alternation && (pattern->anchored_start || pattern->anchored_end)) {
+            parsed = false;
+        }
+
+        if (parsed && try_charset(pattern, root)) {
+            ok = true;
+        } else if (parsed) {
+            int match = nfa_add(&nfa, NFA_MATCH, NULL, -1, -1);
+            int start = nfa_build(&nfa, root, match);
+            if (start >= 0 && !nfa.failed) {
+                pattern->kind = PATTERN_KIND_DFA;
+                ok = build_dfa(pattern, &nfa, start, match);
+            }
+        }
+    }
+
+    catzilla_free(parser.nodes);
+    catzilla_free(nfa.states);
+    if (!ok) {
+        catzilla_pattern_free(pattern);
+        return NULL;
+    }
+    return pattern;
+}
+
+bool catzilla_pattern_match(const catzilla_pattern_t* pattern, const char* str, size_t len) {
+    const uint8_t* s = (const uint8_t*)str;
+
+    if (pattern->kind == PATTERN_KIND_CHARSET) {
+        if (len < pattern->min_count || len > pattern->max_count) return false;
+        if (pattern->is_range) return bytes_in_range(s, len, pattern->range_lo, pattern->range_hi);
+        for (size_t i = 0; i < len; i++) {
+            if (!set_has(pattern->set, s[i])) return false;
+        }
+        return true;
+    }
+
+    const uint16_t* transitions = pattern->transitions;
+    const uint8_t* byte_class = pattern->byte_class;
+    const size_t class_count = (size_t)pattern->class_count;
+    size_t state = (size_t)pattern->start_state;
+
+    if (pattern->anchored_end) {
+        for (size_t i = 0; i < len; i++) {
+            state = transitions[state * class_count + byte_class[s[i]]];
+            if (state == PATTERN_DEAD_STATE) return false;
+        }
+        return pattern->accepting[state];
+    }
+
+    if (pattern->accepting[state]) return true;
+    for (size_t i = 0; i < len; i++) {
+        state = transitions[state * class_count + byte_class[s[i]]];
+        if (pattern->accepting[state]) return true;
+        if (state == PATTERN_DEAD_STATE) return false;
+    }
+    return false;
+}
+
+int catzilla_pattern_state_count(const catzilla_pattern_t* pattern) {
+    return pattern && pattern->kind == PATTERN_KIND_DFA ? pattern->state_count : 0;
+}
+
+void catzilla_pattern_free(catzilla_pattern_t* pattern) {
+    if (!pattern) return;
+    if (pattern->transitions) catzilla_cache_free(pattern->transitions);
+    if (pattern->accepting) catzilla_cache_free(pattern->accepting);
+    catzilla_cache_free(pattern);
+}
+
+// ---------------------------------------------------------------------------
+// Built-in formats
+// ---------------------------------------------------------------------------
+
+static const char* const format_names[] = {
+    [CATZILLA_STRING_FORMAT_NONE] = "none",
+    [CATZILLA_STRING_FORMAT_EMAIL] = "email",
+    [CATZILLA_STRING_FORMAT_UUID] = "uuid",
+    [CATZILLA_STRING_FORMAT_DATETIME] = "datetime",
+    [CATZILLA_STRING_FORMAT_URL] = "url",
+    [CATZILLA_STRING_FORMAT_DIGITS] = "digits",
+};
+
+catzilla_string_format_t catzilla_string_format_from_name(const char* name) {
+    if (!name) return CATZILLA_STRING_FORMAT_NONE;
+    for (int i = CATZILLA_STRING_FORMAT_EMAIL; i <= CATZILLA_STRING_FORMAT_DIGITS; i++) {
+        if (strcmp(name, format_names[i]) == 0) return (catzilla_string_format_t)i;
+    }
+    return CATZILLA_STRING_FORMAT_NONE;
+}
+
+const char* catzilla_string_format_name(catzilla_string_format_t format) {
+    if ((int)format < CATZILLA_STRING_FORMAT_NONE || format > CATZILLA_STRING_FORMAT_DIGITS) return "none";
+    return format_names[format];
+}
+
+static inline bool is_digit(uint8_t c) { return c >= '0' && c <= '9'; }
+static inline bool is_alpha(uint8_t c) { return (c | 0x20) >= 'a' && (c | 0x20) <= 'z'; }
+static inline bool is_alnum(uint8_t c) { return is_digit(c) || is_alpha(c); }
+static inline bool is_hex(uint8_t c) { return is_digit(c) || ((c | 0x20) >= 'a' && (c | 0x20) <= 'f'); }
+
+// Parse exactly count digits at s
+static bool parse_digits(const uint8_t* s, int count, int* value) {
+    int v = 0;
+    for (int i = 0; i < count; i++) {
+        if (!is_digit(s[i])) return false;
+        v = v * 10 + (s[i] - '0');
+    }
+    *value = v;
+    return true;
+}
+
+// Dot-separated labels of letters, digits and inner hyphens, 1-63 bytes each
+static bool match_hostname(const uint8_t* s, size_t len, bool need_dot) {
+    if (len == 0 || len > 253) return false;
+
+    size_t label_start = 0;
+    bool saw_dot = false;
+    for (size_t i = 0; i <= len; i++) {
+        if (i == len || s[i] == '.') {
+            size_t label_length = i - label_start;
+            if (label_length == 0 || label_length > 63) return false;
+            if (s[label_start] == '-' || s[i - 1] == '-') return false;
+            if (i < len) saw_dot = true;
+            label_start = i + 1;
+        } else if (!is_alnum(s[i]) && s[i] != '-') {
+            return false;
+        }
+    }
+    return saw_dot || !need_dot;
+}
+
+static bool match_email(const uint8_t* s, size_t len) {
+    if (len > 254) return false;
+    const uint8_t* at = memchr(s, '@', len);
+    if (!at) return false;
+
+    size_t local_length = (size_t)(at - s);
+    if (local_length == 0 || local_length > 64) return false;
+    if (s[0] == '.' || s[local_length - 1] == '.') return false;
+
+    static const char atext[] = "!#$%&'*+/=?^_`{|}~.-";
+    for (size_t i = 0; i < local_length; i++) {
+        if (s[i] == '.' && s[i + 1] == '.') return false;
+        if (!is_alnum(s[i]) && !(s[i] && strchr(atext, s[i]))) return false;
+    }
+    return match_hostname(at + 1, len - local_length - 1, true);
+}
+
+static bool match_uuid(const uint8_t* s, size_t len) {
+    if (len != 36) return false;
+    for (size_t i = 0; i < 36; i++) {
+        if (i == 8 || i == 13 || i == 18 || i == 23) {
+            if (s[i] != '-') return false;
+        } else if (!is_hex(s[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool match_datetime(const uint8_t* s, size_t len) {
+    static const int days_in_month[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    int year, month, day, hour, minute, second = 0;
+
+    // YYYY-MM-DD[Tt ]HH:MM
+    if (len < 16 || s[4] != '-' || s[7] != '-' || s[13] != ':') return false;
+    if (s[10] != 'T' && s[10] != 't' && s[10] != ' ') return false;
+    if (!parse_digits(s, 4, &year) || !parse_digits(s + 5, 2, &month) || !parse_digits(s + 8, 2, &day) ||
+        !parse_digits(s + 11, 2, &hour) || !parse_digits(s + 14, 2, &minute)) {
+        return false;
+    }
+
+    size_t i = 16;
+    if (i < len && s[i] == ':') {
+        if (i + 3 > len || !parse_digits(s + i + 1, 2, &second)) return false;
+        i += 3;
+        if (i < len && s[i] == '.') {
+            size_t digits = 0;
+            for (i++; i < len && is_digit(s[i]); i++) digits++;
+            if (digits == 0 || digits > 9) return false;
+        }
+    }
+
+    if (i < len) {
+        if ((s[i] == 'Z' || s[i] == 'z') && i + 1 == len) {
+            i++;
+        } else if ((s[i] == '+' || s[i] == '-') && i + 6 == len && s[i + 3] == ':') {
+            int offset_hour, offset_minute;
+            if (!parse_digits(s + i + 1, 2, &offset_hour) || !parse_digits(s + i + 4, 2, &offset_minute) ||
+                offset_hour > 23 || offset_minute > 59) {
+                return false;
+            }
+            i += 6;
+        } else {
+            return false;
+        }
+    }
+
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    if (year < 1 || month < 1 || month > 12 || day < 1) return false;
+    if (day > days_in_month[month - 1] + (month == 2 && leap ? 1 : 0)) return false;
+    return hour <= 23 && minute <= 59 && second <= 59;
+}
+
+static bool match_url(const uint8_t* s, size_t len) {
+    size_t i;
+    if (len >= 7 && strncasecmp((const char*)s, "http://", 7) == 0) {
+        i = 7;
+    } else if (len >= 8 && strncasecmp((const char*)s, "https://", 8) == 0) {
+        i = 8;
+    } else {
+        return false;
+    }
+
+    size_t authority_end = i;
+    while (authority_end < len && s[authority_end] != '/' && s[authority_end] != '?' && s[authority_end] != '#') {
+        authority_end++;
+    }
+
+    // userinfo@ (unreserved, percent-encoded, sub-delims and ':')
+    const uint8_t* at = memchr(s + i, '@', authority_end - i);
+    if (at) {
+        static const char userinfo[] = "-._~!$&'()*+,;=:%";
+        for (const uint8_t* c = s + i; c < at; c++) {
+            if (!is_alnum(*c) && !(*c && strchr(userinfo, *c))) return false;
+        }
+        i = (size_t)(at - s) + 1;
+    }
+
+    size_t host_end;
+    if (i < authority_end && s[i] == '[') {
+        const uint8_t* close = memchr(s + i, ']', authority_end - i);
+        if (!close || close == s + i + 1) return false;
+        for (const uint8_t* c = s + i + 1; c < close; c++) {
+            if (!is_hex(*c) && *c != ':' && *c != '.') return false;
+        }
+        host_end = (size_t)(close - s) + 1;
+    } else {
+        host_end = i;
+        while (host_end < authority_end && s[host_end] != ':') host_end++;
+        if (!match_hostname(s + i, host_end - i, false)) return false;
+    }
+
+    if (host_end < authority_end) {
+        int port = 0;
+        size_t digits = authority_end - host_end - 1;
+        if (s[host_end] != ':' || digits == 0 || digits > 5 ||
+            !parse_digits(s + host_end + 1, (int)digits, &port) || port > 65535) {
+            return false;
+        }
+    }
+
+    // Path, query and fragment: anything but controls and spaces
+    for (i = authority_end; i < len; i++) {
+        if (s[i] <= 0x20 || s[i] == 0x7F) return false;
+    }
+    return true;
+}
+
+bool catzilla_string_format_match(catzilla_string_format_t format, const char* str, size_t len) {
+    const uint8_t* s = (const uint8_t*)str;
+
+    switch (format) {
+        case CATZILLA_STRING_FORMAT_NONE:
+            return true;
+        case CATZILLA_STRING_FORMAT_EMAIL:
+            return match_email(s, len);
+        case CATZILLA_STRING_FORMAT_UUID:
+            return match_uuid(s, len);
+        case CATZILLA_STRING_FORMAT_DATETIME:
+            return match_datetime(s, len);
+        case CATZILLA_STRING_FORMAT_URL:
+            return match_url(s, len);
+        case CATZILLA_STRING_FORMAT_DIGITS:
+            return len > 0 && bytes_in_range(s, len, '0', '9');
+    }
+    return false;
+}
@@ -0,0 +1,120 @@
+/*
+ * Catzilla Pattern Engine - linear-time string pattern matching for validators
+ *
+ * String validator patterns are compiled to a DFA, so every check is one
+ * table lookup per byte and no pattern can backtrack. The supported subset
+ * covers what validation patterns use in practice:
+ *
+ *   literals, ., [...] and [^...] (ranges, [:alpha:] style classes),
+ *   \d \w \s \D \W \S, groups ( ) (?: ) (?P<name> ), |, * + ? {n} {n,} {n,m}
+ *   (lazy forms match the same strings), ^ at the start and $ at the end.
+ *
+ * Matching follows regexec() with REG_EXTENDED: it searches the string unless
+ * the pattern is anchored. '.' and negated classes match one UTF-8 encoded
+ * character; \d \w \s are ASCII. Patterns outside the subset (back-references,
+ * word boundaries, non-ASCII class members, ...) or whose DFA would grow past
+ * CATZILLA_PATTERN_MAX_STATES are not compiled, and callers fall back to
+ * POSIX regex for them.
+ *
+ * A pattern that is one ASCII class repeated over the whole string, such as
+ * ^[0-9]+$ or ^[a-z_]{3,16}$, skips the DFA and becomes a charset check,
+ * vectorised with SSE2 when the class is a single range.
+ *
+ * Built-in formats (email, UUID, ISO 8601 datetime, http(s) URL, digits) have
+ * hand-written single-pass matchers that also check what regexes cannot,
+ * such as day-of-month and port ranges.
+ */
+
+#ifndef CATZILLA_PATTERN_H
+#define CATZILLA_PATTERN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CATZILLA_PATTERN_MAX_LENGTH 1024   // Longer patterns go to POSIX regex
+#define CATZILLA_PATTERN_MAX_STATES 1024   // DFA states, including the dead state
+#define CATZILLA_PATTERN_MAX_REPEAT 1000   // Largest {n,m} bound
+
+typedef enum {
+    CATZILLA_STRING_FORMAT_NONE = 0,
+    CATZILLA_STRING_FORMAT_EMAIL,      // local@domain.tld, RFC 5321 lengths
+    CATZILLA_STRING_FORMAT_UUID,       // 8-4-4-4-12 hex digits, any version
+    CATZILLA_STRING_FORMAT_DATETIME,   // YYYY-MM-DD[T ]HH:MM[:SS[.f]][Z|+HH:MM]
+    CATZILLA_STRING_FORMAT_URL,        // http:// or https:// URL with a host
+    CATZILLA_STRING_FORMAT_DIGITS      // One or more ASCII digits
+} catzilla_string_format_t;
+
+typedef struct catzilla_pattern_s catzilla_pattern_t;
+
+/**
+ * Compile a pattern to a DFA (or a charset check)
+ * @param pattern Pattern, NUL-terminated
+ * @return Compiled pattern, or NULL if the pattern is outside the supported
+ *         subset, too large, or memory ran out
+ */
+catzilla_pattern_t* catzilla_pattern_compile(const char* pattern);
+
+/**
+ * Check a string against a compiled pattern
+ * @param pattern Compiled pattern
+ * @param str String (need not be NUL-terminated)
+ * @param len Length of str in bytes
+ * @return true if the pattern matches
+ */
+bool catzilla_pattern_match(const catzilla_pattern_t* pattern, const char* str, size_t len);
+
+/**
+ * Get the number of DFA states of a compiled pattern
+ * @param pattern Compiled pattern
+ * @return State count, 0 for charset checks
+ */
+int catzilla_pattern_state_count(const catzilla_pattern_t* pattern);
+
+/**
+ * Free a compiled pattern
+ * @param pattern Compiled pattern (may be NULL)
+ */
+void catzilla_pattern_free(catzilla_pattern_t* pattern);
+
+/**
+ * Look up a built-in format by name ("email", "uuid", "datetime", "url", "digits")
+ * @param name Format name
+ * @return Format, CATZILLA_STRING_FORMAT_NONE if the name is unknown
+ */
+catzilla_string_format_t catzilla_string_format_from_name(const char* name);
+
+/**
+ * Get the name of a built-in format
+ * @param format Format
+ * @return Name, "none" for CATZILLA_STRING_FORMAT_NONE
+ */
+const char* catzilla_string_format_name(catzilla_string_format_t format);
+
+/**
+ * Check a string against a built-in format
+ * @param format Format (CATZILLA_STRING_FORMAT_NONE accepts everything)
+ * @param str String (need not be NUL-terminated)
+ * @param len Length of str in bytes
+ * @return true if the string has the format
+ */
+bool catzilla_string_format_match(catzilla_string_format_t format, const char* str, size_t len);
+
+/**
+ * Count the characters of a UTF-8 string (bytes that do not continue a
+ * sequence), 16 bytes at a time with SSE2 and 8 at a time elsewhere
+ * @param str String
+ * @param len Length of str in bytes
+ * @return Character count
+ */
+size_t catzilla_utf8_length(const char* str, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CATZILLA_PATTERN_H
@@ -0,0 +1,154 @@
+#include "perf_counters.h"
+#include "platform_compat.h"
+#include <string.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Written rarely, read by every loop per request: a word-sized plain store
+static volatile uint32_t sample_interval;
+
+// The calling thread's counter group
+typedef struct {
+    int fds[CATZILLA_PERF_COUNTER_COUNT];    // -1 = not opened
+    int slots[CATZILLA_PERF_COUNTER_COUNT];  // Position in a group read, -1 = missing
+    int members;
+    bool opened;
+    bool failed;                             // The kernel refused; never retried
+    uint32_t until_sample;
+} perf_thread_t;
+
+static CATZILLA_THREAD_LOCAL perf_thread_t perf_thread;
+
+void catzilla_perf_set_sample_interval(uint32_t one_in) {
+    sample_interval = one_in;
+}
+
+uint32_t catzilla_perf_sample_interval(void) {
+    return sample_interval;
+}
+
+#ifdef __linux__
+
+static const uint64_t counter_configs[CATZILLA_PERF_COUNTER_COUNT] = {
+    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES,
+};
+
+static int open_counter(uint64_t config, int group_fd) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.exclude_kernel = 1;  // Allowed at perf_event_paranoid 2
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+
+// Cycles lead the group; members the PMU lacks are left out
+static bool open_thread_counters(perf_thread_t* thread) {
+    if (thread->opened) return true;
+    if (thread->failed) return false;
+
+    for (int i = 0; i < CATZILLA_PERF_COUNTER_COUNT; i++) {
+        thread->fds[i] = -1;
+        thread->slots[i] = -1;
+    }
+    thread->members = 0;
+    for (int i = 0; i < CATZILLA_PERF_COUNTER_COUNT; i++) {
+        int fd = open_counter(counter_configs[i], i == 0 ? -1 : thread->fds[0]);
+        if (fd < 0) {
+            if (i == 0) {
+                thread->failed = true;
+                return false;
+            }
+            continue;
+        }
+        thread->fds[i] = fd;
+        thread->slots[i] = thread->members++;
+    }
+    thread->opened = true;
+    return true;
+}
+
+bool catzilla_perf_read(catzilla_perf_reading_t* reading) {
+    perf_thread_t* thread = &perf_thread;
+    if (!open_thread_counters(thread)) return false;
+
+    // nr, time_enabled, time_running, then one value per member
+    uint64_t data[3 + CATZILLA_PERF_COUNTER_COUNT];
+    ssize_t expected = (ssize_t)((3 + (size_t)thread->members) * sizeof(uint64_t));
+    if (read(thread->fds[0], data, sizeof(data)) != expected) return false;
+
+    for (int i = 0; i < CATZILLA_PERF_COUNTER_COUNT; i++) {
+        reading->values[i] = thread->slots[i] >= 0 ? data[3 + thread->slots[i]] : 0;
+    }
+    reading->time_enabled = data[1];
+    reading->time_running = data[2];
+    reading->owner = thread;
+    return true;
+}
+
+void catzilla_perf_thread_close(void) {
+    perf_thread_t* thread = &perf_thread;
+    if (thread->opened) {
+        // Members first; closing the leader alone would leave them orphaned
+        for (int i = CATZILLA_PERF_COUNTER_COUNT - 1; i >= 0; i--) {
+            if (thread->fds[i] >= 0) close(thread->fds[i]);
+        }
+    }
+    memset(thread, 0, sizeof(*thread));
+}
+
+#else
+
+bool catzilla_perf_read(catzilla_perf_reading_t* reading) {
+    (void)reading;
+    return false;
+}
+
+void catzilla_perf_thread_close(void) {
+    memset(&perf_thread, 0, sizeof(perf_thread));
+}
+
+#endif
+
+bool catzilla_perf_available(void) {
+    catzilla_perf_reading_t reading;
+    return catzilla_perf_read(&reading);
+}
+
+bool catzilla_perf_sample_due(void) {
+    uint32_t interval = sample_interval;
+    perf_thread_t* thread = &perf_thread;
+    if (interval == 0 || thread->failed) return false;
+
+    if (thread->until_sample == 0 || thread->until_sample > interval) {
+        thread->until_sample = interval;
+    }
+    if (--thread->until_sample > 0) return false;
+    thread->until_sample = interval;
+    return true;
+}
+
+bool catzilla_perf_elapsed(const catzilla_perf_reading_t* start, const catzilla_perf_reading_t* end,
+                           catzilla_perf_reading_t* delta) {
+    if (!start->owner || start->owner != end->owner) return false;
+
+    uint64_t enabled = end->time_enabled - start->time_enabled;
+    uint64_t running = end->time_running - start->time_running;
+    if (running != enabled) return false;
+
+    for (int i = 0; i < CATZILLA_PERF_COUNTER_COUNT; i++) {
+        delta->values[i] = end->values[i] - start->values[i];
+    }
+    delta->time_enabled = enabled;
+    delta->time_running = running;
+    delta->owner = end->owner;
+    return true;
+}
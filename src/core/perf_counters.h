@@ -0,0 +1,93 @@
+/*
+ * Catzilla Hardware Counters - per-request CPU cycles and cache misses
+ *
+ * Each loop thread opens one group of counters (cycles, instructions, cache
+ * misses) on itself with perf_event_open the first time it samples, and
+ * leaves it counting. A sampled request reads the group as its handler
+ * starts and again as its response is queued; the difference is its cost.
+ * Requests are sampled one in N, so the two reads (a system call each)
+ * touch few requests. Linux only: elsewhere, or when the kernel refuses the
+ * counters (perf_event_paranoid, containers, virtual machines without a
+ * PMU), nothing is ever sampled.
+ */
+
+#ifndef CATZILLA_PERF_COUNTERS_H
+#define CATZILLA_PERF_COUNTERS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    CATZILLA_PERF_CYCLES,
+    CATZILLA_PERF_INSTRUCTIONS,
+    CATZILLA_PERF_CACHE_MISSES,
+    CATZILLA_PERF_COUNTER_COUNT
+} catzilla_perf_counter_t;
+
+/**
+ * Counter values of one thread at one moment, or a difference of two
+ */
+typedef struct {
+    uint64_t values[CATZILLA_PERF_COUNTER_COUNT];
+    uint64_t time_enabled;   // Nanoseconds the group was enabled
+    uint64_t time_running;   // Nanoseconds it was on the PMU; less means multiplexed
+    const void* owner;       // Thread whose counters were read
+} catzilla_perf_reading_t;
+
+/**
+ * Sample one request in every one_in; 0 stops sampling. Loops pick the
+ * change up at their next request.
+ * @param one_in Sampling interval
+ */
+void catzilla_perf_set_sample_interval(uint32_t one_in);
+
+/**
+ * @return Current sampling interval (0 = off)
+ */
+uint32_t catzilla_perf_sample_interval(void);
+
+/**
+ * Whether the calling thread's counters can be opened; opens them
+ * @return true when counters are readable on this thread
+ */
+bool catzilla_perf_available(void);
+
+/**
+ * Count a request on the calling thread and decide whether it is sampled
+ * @return true for every one_in-th request while sampling is on
+ */
+bool catzilla_perf_sample_due(void);
+
+/**
+ * Read the calling thread's counters, opening them on first use
+ * @param reading Receives the values
+ * @return true on success, false when counters are unavailable
+ */
+bool catzilla_perf_read(catzilla_perf_reading_t* reading);
+
+/**
+ * Difference of two readings of the same thread
+ * @param start Earlier reading
+ * @param end Later reading
+ * @param delta Receives end - start
+ * @return false when the readings come from different threads or the
+ *         counters were multiplexed in between (the values would be scaled
+ *         guesses)
+ */
+bool catzilla_perf_elapsed(const catzilla_perf_reading_t* start, const catzilla_perf_reading_t* end,
+                           catzilla_perf_reading_t* delta);
+
+/**
+ * Close the calling thread's counters; a later read opens them again
+ */
+void catzilla_perf_thread_close(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CATZILLA_PERF_COUNTERS_H
@@ -15,6 +15,7 @@
 
     typedef volatile uint64_t catzilla_atomic_uint64_t;
     typedef volatile size_t catzilla_atomic_size_t;
+    typedef volatile uint8_t catzilla_atomic_uint8_t;
     typedef volatile void* catzilla_atomic_ptr_t;
     typedef volatile double catzilla_atomic_double_t;
 
@@ -28,16 +29,54 @@
     #define catzilla_atomic_fetch_add(ptr, val) InterlockedAdd64((LONGLONG*)(ptr), (val))
     #define catzilla_atomic_fetch_sub(ptr, val) InterlockedAdd64((LONGLONG*)(ptr), -(val))
 
+    // Relaxed load and store, for flags that order nothing else
+    #define catzilla_atomic_load_relaxed(ptr) (*(ptr))
+    #define catzilla_atomic_store_relaxed(ptr, val) (*(ptr) = (val))
+
+    // Sequentially consistent load and store, for publishing pointers
+    #define catzilla_atomic_fence() MemoryBarrier()
+    #define catzilla_atomic_load_seq(ptr) (MemoryBarrier(), *(ptr))
+    #define catzilla_atomic_store_seq(ptr, val) do { MemoryBarrier(); *(ptr) = (val); MemoryBarrier(); } while (0)
+    // Install val if *ptr is still NULL; evaluates to the pointer that won
+    #define catzilla_atomic_publish_ptr(ptr, val) \
+        (InterlockedCompareExchangePointer((PVOID volatile*)(ptr), (PVOID)(val), NULL) ? \
+         (void*)*(ptr) : (void*)(val))
+    // Replace *ptr with NULL; evaluates to the pointer it held
+    #define catzilla_atomic_take_ptr(ptr) \
+        InterlockedExchangePointer((PVOID volatile*)(ptr), NULL)
+    // Store desired if *ptr still holds expected; evaluates to whether it did
+    #define catzilla_atomic_compare_swap(ptr, expected, desired) \
+        (InterlockedCompareExchange64((LONGLONG volatile*)(ptr), (LONGLONG)(desired), \
+                                      (LONGLONG)(expected)) == (LONGLONG)(expected))
+
 #else
     // Unix/Linux/macOS implementation
     typedef uint64_t catzilla_atomic_uint64_t;
     typedef size_t catzilla_atomic_size_t;
+    typedef uint8_t catzilla_atomic_uint8_t;
 
     #define catzilla_atomic_load(ptr) (*(ptr))
     #define catzilla_atomic_store(ptr, val) (*(ptr) = (val))
     #define catzilla_atomic_fetch_add(ptr, val) __sync_fetch_and_add(ptr, val)
     #define catzilla_atomic_fetch_sub(ptr, val) __sync_fetch_and_sub(ptr, val)
 
+    // Relaxed load and store, for flags that order nothing else
+    #define catzilla_atomic_load_relaxed(ptr) __atomic_load_n(ptr, __ATOMIC_RELAXED)
+    #define catzilla_atomic_store_relaxed(ptr, val) __atomic_store_n(ptr, val, __ATOMIC_RELAXED)
+
+    // Sequentially consistent load and store, for publishing pointers
+    #define catzilla_atomic_fence() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+    #define catzilla_atomic_load_seq(ptr) __atomic_load_n(ptr, __ATOMIC_SEQ_CST)
+    #define catzilla_atomic_store_seq(ptr, val) __atomic_store_n(ptr, val, __ATOMIC_SEQ_CST)
+    // Install val if *ptr is still NULL; evaluates to the pointer that won
+    #define catzilla_atomic_publish_ptr(ptr, val) \
+        (__sync_val_compare_and_swap(ptr, NULL, val) ?: (val))
+    // Replace *ptr with NULL; evaluates to the pointer it held
+    #define catzilla_atomic_take_ptr(ptr) __atomic_exchange_n(ptr, NULL, __ATOMIC_SEQ_CST)
+    // Store desired if *ptr still holds expected; evaluates to whether it did
+    #define catzilla_atomic_compare_swap(ptr, expected, desired) \
+        __sync_bool_compare_and_swap(ptr, expected, desired)
+
 #endif
 
 #endif // PLATFORM_ATOMIC_H
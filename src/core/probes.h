@@ -0,0 +1,56 @@
+/*
+ * Catzilla USDT probes
+ *
+ * Static tracepoints on the request path, visible to bpftrace, perf and
+ * SystemTap as usdt:<library>:catzilla:<probe>. A probe compiles to one nop
+ * and a note in the binary telling a tracer where its arguments are. The
+ * arguments stay in registers or memory whether or not a tracer is
+ * attached, so they must be values already at hand, never computed for the
+ * probe.
+ * Built in when <sys/sdt.h> is found (systemtap-sdt-dev); otherwise the
+ * macros expand to nothing and their arguments are not evaluated.
+ *
+ * Probe                  Arguments
+ * request_start          conn
+ * request_parsed         conn, method, url, body_length
+ * route_start            conn
+ * route_done             conn, route_id (0 = none), status (200 matched, 404, 405)
+ * gil_wait               -
+ * gil_acquired           -
+ * gil_release            -
+ * response_queued        conn, status, bytes
+ * write_done             conn, status (uv error, 0 = written), responses
+ * response_cache_hit     conn, route_id
+ * response_cache_miss    conn, route_id
+ * cache_hit              key, key_length
+ * cache_miss             key, key_length
+ * task_enqueue           task_id, priority, delay_ms
+ * task_dequeue           task_id, priority, worker_id
+ * task_done              task_id, status (task_status_t)
+ *
+ * conn is the connection's client_context_t, the same pointer from the
+ * first probe of a request to its write_done. GIL probes fire on the thread
+ * that takes the GIL, between one request's route_done and response_queued.
+ * scripts/bpftrace/ has scripts built on them.
+ */
+
+#ifndef CATZILLA_PROBES_H
+#define CATZILLA_PROBES_H
+
+#ifdef CATZILLA_HAS_USDT
+#include <sys/sdt.h>
+
+#define CATZILLA_PROBE(name) DTRACE_PROBE(catzilla, name)
+#define CATZILLA_PROBE1(name, a) DTRACE_PROBE1(catzilla, name, a)
+#define CATZILLA_PROBE2(name, a, b) DTRACE_PROBE2(catzilla, name, a, b)
+#define CATZILLA_PROBE3(name, a, b, c) DTRACE_PROBE3(catzilla, name, a, b, c)
+#define CATZILLA_PROBE4(name, a, b, c, d) DTRACE_PROBE4(catzilla, name, a, b, c, d)
+#else
+#define CATZILLA_PROBE(name) ((void)0)
+#define CATZILLA_PROBE1(name, a) ((void)0)
+#define CATZILLA_PROBE2(name, a, b) ((void)0)
+#define CATZILLA_PROBE3(name, a, b, c) ((void)0)
+#define CATZILLA_PROBE4(name, a, b, c, d) ((void)0)
+#endif
+
+#endif // CATZILLA_PROBES_H
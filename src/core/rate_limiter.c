@@ -0,0 +1,439 @@
+/*
+ * Catzilla Rate Limiter - GCRA cells in a sharded open-addressing table
+ *
+ * A key owns a cell while its theoretical arrival time (TAT) lies in the
+ * future, i.e. while it has used part of its burst. A request is allowed
+ * when moving the TAT one emission interval ahead keeps it within the burst
+ * tolerance of now; the move is one CAS on the cell.
+ *
+ * The sweep and a key taking over a displaced cell race with checks on the
+ * cell. The worst case is one request counted against the wrong bucket,
+ * which only happens to keys whose bucket was full or nearly full anyway.
+ */
+
+#include "rate_limiter.h"
+#include "logging.h"
+#include "memory.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+void catzilla_route_set_rate_limit(catzilla_route_t* route, catzilla_rate_limiter_t* limiter) {
+    if (route) route->rate_limit = limiter;
+}
+
+#ifdef _WIN32
+
+// The limiter relies on C11 atomics and pthreads; routes are not limited on Windows
+
+catzilla_rate_limiter_t* catzilla_rate_limiter_create(const catzilla_rate_limit_config_t* config) {
+    (void)config;
+    LOG_SECURITY_WARN("Rate limiting is not supported on Windows");
+    return NULL;
+}
+
+void catzilla_rate_limiter_destroy(catzilla_rate_limiter_t* limiter) { (void)limiter; }
+
+const catzilla_rate_limit_config_t* catzilla_rate_limiter_get_config(const catzilla_rate_limiter_t* limiter) {
+    (void)limiter;
+    return NULL;
+}
+
+int catzilla_rate_limiter_check(catzilla_rate_limiter_t* limiter, const void* key, size_t key_len,
+                                catzilla_rate_limit_result_t* result) {
+    (void)limiter; (void)key; (void)key_len;
+    if (result) memset(result, 0, sizeof(*result));
+    return -1;
+}
+
+int catzilla_rate_limiter_check_at(catzilla_rate_limiter_t* limiter, const void* key, size_t key_len,
+                                   uint64_t now_ms, catzilla_rate_limit_result_t* result) {
+    (void)now_ms;
+    return catzilla_rate_limiter_check(limiter, key, key_len, result);
+}
+
+int catzilla_rate_limiter_sweep(catzilla_rate_limiter_t* limiter, uint64_t now_ms) {
+    (void)limiter; (void)now_ms;
+    return 0;
+}
+
+void catzilla_rate_limiter_get_stats(catzilla_rate_limiter_t* limiter, catzilla_rate_limit_stats_t* stats) {
+    (void)limiter;
+    if (stats) memset(stats, 0, sizeof(*stats));
+}
+
+#else
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include "timer_wheel.h"
+
+#define RATE_SHARD_BITS 6             // log2(CATZILLA_RATE_LIMIT_SHARDS)
+#define RATE_WINDOW_CELLS 4           // Cells probed per key: one cache line
+#define RATE_SWEEP_BUDGET 1024        // Windows a shard sweep visits per firing
+#define RATE_WHEEL_TICK_MS 10
+
+typedef struct rate_cell_s {
+    _Atomic uint64_t key;             // Key hash, 0 = free
+    _Atomic uint64_t tat;             // Theoretical arrival time, ns since creation
+} rate_cell_t;
+
+typedef struct rate_shard_s {
+    // Counters first, each shard on its own cache lines
+    _Alignas(64) _Atomic uint64_t allowed;
+    _Atomic uint64_t limited;
+    _Atomic uint64_t used;
+    _Atomic uint64_t evicted;
+    _Atomic uint64_t displaced;
+
+    rate_cell_t* cells;               // Windows of RATE_WINDOW_CELLS
+    size_t window_mask;               // Windows in the shard - 1
+
+    // Sweep state, only touched with the limiter's sweep_lock held
+    size_t sweep_cursor;
+    catzilla_timer_entry_t sweep_entry;
+    struct catzilla_rate_limiter_s* limiter;
+} rate_shard_t;
+
+struct catzilla_rate_limiter_s {
+    catzilla_rate_limit_config_t config;
+    uint64_t interval_ns;             // Emission interval: period / requests
+    uint64_t tolerance_ns;            // interval * burst
+    uint64_t start_ns;
+
+    void* memory;                     // Unaligned allocation behind the limiter
+    void* cell_memory;                // Unaligned allocation behind the shards' cells
+
+    pthread_mutex_t sweep_lock;
+    catzilla_timer_wheel_t wheel;     // One entry per shard
+    _Atomic uint64_t next_sweep_ms;
+    uint64_t sweep_now_ns;            // Time of the advance in progress
+    uint64_t sweep_delay_ms;          // Between two firings of one shard
+    int sweep_freed;
+
+    rate_shard_t shards[CATZILLA_RATE_LIMIT_SHARDS];
+};
+
+// ---------------------------------------------------------------------------
+// Hashing and time
+// ---------------------------------------------------------------------------
+
+static uint64_t hash_key(const void* key, size_t key_len) {
+    // FNV-1a with a murmur3 finalizer, so every bit of the result mixes
+    const unsigned char* bytes = key;
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < key_len; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash ? hash : 1;
+}
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static size_t round_up_pow2(size_t value) {
+    size_t result = 1;
+    while (result < value) result <<= 1;
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// Eviction
+// ---------------------------------------------------------------------------
+
+// Free the cells of up to RATE_SWEEP_BUDGET windows whose bucket is full again
+static int sweep_shard(rate_shard_t* shard, uint64_t now_ns) {
+    size_t windows = shard->window_mask + 1;
+    size_t budget = windows < RATE_SWEEP_BUDGET ? windows : RATE_SWEEP_BUDGET;
+    int freed = 0;
+
+    for (size_t n = 0; n < budget; n++) {
+        rate_cell_t* window = shard->cells + shard->sweep_cursor * RATE_WINDOW_CELLS;
+        shard->sweep_cursor = (shard->sweep_cursor + 1) & shard->window_mask;
+
+        for (int i = 0; i < RATE_WINDOW_CELLS; i++) {
+            uint64_t key = atomic_load_explicit(&window[i].key, memory_order_relaxed);
+            if (key == 0) continue;
+            if (atomic_load_explicit(&window[i].tat, memory_order_relaxed) > now_ns) continue;
+            if (atomic_compare_exchange_strong_explicit(&window[i].key, &key, 0,
+                                                        memory_order_acq_rel, memory_order_relaxed)) {
+                freed++;
+            }
+        }
+    }
+
+    if (freed > 0) {
+        atomic_fetch_sub_explicit(&shard->used, (uint64_t)freed, memory_order_relaxed);
+        atomic_fetch_add_explicit(&shard->evicted, (uint64_t)freed, memory_order_relaxed);
+    }
+    return freed;
+}
+
+static void on_sweep_timer(catzilla_timer_entry_t* entry) {
+    rate_shard_t* shard = entry->data;
+    catzilla_rate_limiter_t* limiter = shard->limiter;
+
+    limiter->sweep_freed += sweep_shard(shard, limiter->sweep_now_ns);
+    catzilla_timer_wheel_schedule(&limiter->wheel, entry, limiter->sweep_now_ns / 1000000ULL,
+                                  limiter->sweep_delay_ms);
+}
+
+// Caller holds sweep_lock
+static int advance_sweep(catzilla_rate_limiter_t* limiter, uint64_t now_ns) {
+    limiter->sweep_now_ns = now_ns;
+    limiter->sweep_freed = 0;
+    catzilla_timer_wheel_advance(&limiter->wheel, now_ns / 1000000ULL);
+    atomic_store_explicit(&limiter->next_sweep_ms, now_ns / 1000000ULL + RATE_WHEEL_TICK_MS,
+                          memory_order_relaxed);
+    return limiter->sweep_freed;
+}
+
+// Checks drive the wheel; whoever gets the lock first advances it
+static void maybe_sweep(catzilla_rate_limiter_t* limiter, uint64_t now_ns) {
+    if (now_ns / 1000000ULL < atomic_load_explicit(&limiter->next_sweep_ms, memory_order_relaxed)) {
+        return;
+    }
+    if (pthread_mutex_trylock(&limiter->sweep_lock) != 0) {
+        return;
+    }
+    advance_sweep(limiter, now_ns);
+    pthread_mutex_unlock(&limiter->sweep_lock);
+}
+
+// ---------------------------------------------------------------------------
+// Public API
+// ---------------------------------------------------------------------------
+
+catzilla_rate_limiter_t* catzilla_rate_limiter_create(const catzilla_rate_limit_config_t* config) {
+    if (!config || config->requests == 0 || config->period_ms == 0) {
+        LOG_SECURITY_ERROR("Rate limiter needs a request count and a period");
+        return NULL;
+    }
+    if (config->key_kind == CATZILLA_RATE_KEY_HEADER && config->key_header[0] == '\0') {
+        LOG_SECURITY_ERROR("Header-keyed rate limiter needs a header name");
+        return NULL;
+    }
+
+    // Shards start on a cache line so their counters never share one
+    void* memory = catzilla_calloc(1, sizeof(catzilla_rate_limiter_t) + 64);
+    if (!memory) return NULL;
+    catzilla_rate_limiter_t* limiter = (catzilla_rate_limiter_t*)(((uintptr_t)memory + 63) & ~(uintptr_t)63);
+    limiter->memory = memory;
+
+    limiter->config = *config;
+    limiter->config.key_header[CATZILLA_RATE_LIMIT_HEADER_MAX - 1] = '\0';
+    if (limiter->config.burst == 0) {
+        limiter->config.burst = config->requests;
+    }
+
+    size_t min_cells = (size_t)CATZILLA_RATE_LIMIT_SHARDS * RATE_WINDOW_CELLS;
+    size_t capacity = config->capacity ? config->capacity : CATZILLA_RATE_LIMIT_DEFAULT_CAPACITY;
+    capacity = round_up_pow2(capacity < min_cells ? min_cells : capacity);
+    limiter->config.capacity = capacity;
+
+    limiter->interval_ns = (uint64_t)config->period_ms * 1000000ULL / config->requests;
+    if (limiter->interval_ns == 0) limiter->interval_ns = 1;
+    limiter->tolerance_ns = limiter->interval_ns * limiter->config.burst;
+
+    // Cells start on a cache line so a window never straddles two
+    limiter->cell_memory = catzilla_calloc(1, capacity * sizeof(rate_cell_t) + 64);
+    if (!limiter->cell_memory) {
+        catzilla_free(memory);
+        return NULL;
+    }
+    uintptr_t aligned = ((uintptr_t)limiter->cell_memory + 63) & ~(uintptr_t)63;
+    rate_cell_t* cells = (rate_cell_t*)aligned;
+
+    pthread_mutex_init(&limiter->sweep_lock, NULL);
+    catzilla_timer_wheel_init(&limiter->wheel, 0, RATE_WHEEL_TICK_MS);
+    limiter->start_ns = monotonic_ns();
+
+    // Every shard is swept once per CATZILLA_RATE_LIMIT_SWEEP_MS, in slices
+    // of RATE_SWEEP_BUDGET windows, with the shards' firings spread out
+    size_t shard_cells = capacity / CATZILLA_RATE_LIMIT_SHARDS;
+    size_t shard_windows = shard_cells / RATE_WINDOW_CELLS;
+    uint64_t slices = (shard_windows + RATE_SWEEP_BUDGET - 1) / RATE_SWEEP_BUDGET;
+    limiter->sweep_delay_ms = CATZILLA_RATE_LIMIT_SWEEP_MS / slices;
+    if (limiter->sweep_delay_ms < RATE_WHEEL_TICK_MS) limiter->sweep_delay_ms = RATE_WHEEL_TICK_MS;
+
+    for (int i = 0; i < CATZILLA_RATE_LIMIT_SHARDS; i++) {
+        rate_shard_t* shard = &limiter->shards[i];
+        shard->cells = cells + (size_t)i * shard_cells;
+        shard->window_mask = shard_windows - 1;
+        shard->limiter = limiter;
+        catzilla_timer_entry_init(&shard->sweep_entry, on_sweep_timer, shard);
+        uint64_t offset = limiter->sweep_delay_ms * (uint64_t)(i + 1) / CATZILLA_RATE_LIMIT_SHARDS;
+        catzilla_timer_wheel_schedule(&limiter->wheel, &shard->sweep_entry, 0,
+                                      offset > 0 ? offset : 1);
+    }
+
+    LOG_SECURITY_DEBUG("Rate limiter: %u requests per %u ms, burst %u, %zu cells",
+                       config->requests, config->period_ms, limiter->config.burst, capacity);
+    return limiter;
+}
+
+void catzilla_rate_limiter_destroy(catzilla_rate_limiter_t* limiter) {
+    if (!limiter) return;
+
+    catzilla_timer_wheel_clear(&limiter->wheel, NULL);
+    pthread_mutex_destroy(&limiter->sweep_lock);
+    catzilla_free(limiter->cell_memory);
+    catzilla_free(limiter->memory);
+}
+
+const catzilla_rate_limit_config_t* catzilla_rate_limiter_get_config(const catzilla_rate_limiter_t* limiter) {
+    return limiter ? &limiter->config : NULL;
+}
+
+// Find the key's cell in its window, claiming a free or the most idle one
+static rate_cell_t* find_cell(rate_shard_t* shard, uint64_t hash) {
+    rate_cell_t* window = shard->cells + (hash & shard->window_mask) * RATE_WINDOW_CELLS;
+
+    for (int i = 0; i < RATE_WINDOW_CELLS; i++) {
+        if (atomic_load_explicit(&window[i].key, memory_order_acquire) == hash) {
+            return &window[i];
+        }
+    }
+
+    for (int i = 0; i < RATE_WINDOW_CELLS; i++) {
+        uint64_t expected = 0;
+        if (atomic_compare_exchange_strong_explicit(&window[i].key, &expected, hash,
+                                                    memory_order_acq_rel, memory_order_acquire)) {
+            atomic_fetch_add_explicit(&shard->used, 1, memory_order_relaxed);
+            return &window[i];
+        }
+        if (expected == hash) {
+            return &window[i];     // Claimed by a concurrent check of the same key
+        }
+    }
+
+    // Window full of keys still refilling: take the cell closest to full
+    int victim = 0;
+    uint64_t oldest = UINT64_MAX;
+    for (int i = 0; i < RATE_WINDOW_CELLS; i++) {
+        uint64_t tat = atomic_load_explicit(&window[i].tat, memory_order_relaxed);
+        if (tat < oldest) {
+            oldest = tat;
+            victim = i;
+        }
+    }
+    uint64_t previous = atomic_load_explicit(&window[victim].key, memory_order_relaxed);
+    if (previous == hash) {
+        return &window[victim];
+    }
+    if (!atomic_compare_exchange_strong_explicit(&window[victim].key, &previous, hash,
+                                                 memory_order_acq_rel, memory_order_relaxed)) {
+        return NULL;
+    }
+    atomic_store_explicit(&window[victim].tat, 0, memory_order_relaxed);
+    atomic_fetch_add_explicit(&shard->displaced, 1, memory_order_relaxed);
+    return &window[victim];
+}
+
+static int check_hash(catzilla_rate_limiter_t* limiter, uint64_t hash, uint64_t now_ns,
+                      catzilla_rate_limit_result_t* result) {
+    rate_shard_t* shard = &limiter->shards[hash >> (64 - RATE_SHARD_BITS)];
+    uint64_t interval = limiter->interval_ns;
+    uint64_t tolerance = limiter->tolerance_ns;
+
+    if (result) {
+        result->limit = limiter->config.burst;
+        result->remaining = 0;
+        result->retry_after_ms = 0;
+    }
+
+    // A lookup only loses a race to another key taking the cell over, and
+    // few keys contend for one window, so a handful of tries always suffices
+    for (int attempt = 0; attempt < 4; attempt++) {
+        rate_cell_t* cell = find_cell(shard, hash);
+        if (!cell) continue;
+
+        uint64_t tat = atomic_load_explicit(&cell->tat, memory_order_relaxed);
+        for (;;) {
+            uint64_t base = tat > now_ns ? tat : now_ns;
+            uint64_t new_tat = base + interval;
+
+            if (new_tat - now_ns > tolerance) {
+                atomic_fetch_add_explicit(&shard->limited, 1, memory_order_relaxed);
+                if (result) {
+                    uint64_t wait_ns = new_tat - tolerance - now_ns;
+                    result->retry_after_ms = (wait_ns + 999999ULL) / 1000000ULL;
+                }
+                return 1;
+            }
+
+            if (atomic_compare_exchange_weak_explicit(&cell->tat, &tat, new_tat,
+                                                      memory_order_acq_rel, memory_order_relaxed)) {
+                atomic_fetch_add_explicit(&shard->allowed, 1, memory_order_relaxed);
+                if (result) {
+                    result->remaining = (uint32_t)((tolerance - (new_tat - now_ns)) / interval);
+                }
+                return 0;
+            }
+            if (atomic_load_explicit(&cell->key, memory_order_acquire) != hash) {
+                break;             // Cell went to another key; look again
+            }
+        }
+    }
+
+    // Keep serving rather than refuse a client over a contended window
+    atomic_fetch_add_explicit(&shard->allowed, 1, memory_order_relaxed);
+    if (result) result->remaining = 0;
+    return 0;
+}
+
+int catzilla_rate_limiter_check_at(catzilla_rate_limiter_t* limiter, const void* key, size_t key_len,
+                                   uint64_t now_ms, catzilla_rate_limit_result_t* result) {
+    if (!limiter || (!key && key_len > 0)) return -1;
+
+    // Offset by one so that a TAT of 0 always means an unused cell
+    uint64_t now_ns = now_ms * 1000000ULL + 1;
+    maybe_sweep(limiter, now_ns);
+    return check_hash(limiter, hash_key(key, key_len), now_ns, result);
+}
+
+int catzilla_rate_limiter_check(catzilla_rate_limiter_t* limiter, const void* key, size_t key_len,
+                                catzilla_rate_limit_result_t* result) {
+    if (!limiter || (!key && key_len > 0)) return -1;
+
+    uint64_t now_ns = monotonic_ns() - limiter->start_ns + 1;
+    maybe_sweep(limiter, now_ns);
+    return check_hash(limiter, hash_key(key, key_len), now_ns, result);
+}
+
+int catzilla_rate_limiter_sweep(catzilla_rate_limiter_t* limiter, uint64_t now_ms) {
+    if (!limiter) return 0;
+
+    pthread_mutex_lock(&limiter->sweep_lock);
+    int freed = advance_sweep(limiter, now_ms * 1000000ULL + 1);
+    pthread_mutex_unlock(&limiter->sweep_lock);
+    return freed;
+}
+
+void catzilla_rate_limiter_get_stats(catzilla_rate_limiter_t* limiter, catzilla_rate_limit_stats_t* stats) {
+    if (!stats) return;
+    memset(stats, 0, sizeof(*stats));
+    if (!limiter) return;
+
+    for (int i = 0; i < CATZILLA_RATE_LIMIT_SHARDS; i++) {
+        rate_shard_t* shard = &limiter->shards[i];
+        stats->allowed += atomic_load_explicit(&shard->allowed, memory_order_relaxed);
+        stats->limited += atomic_load_explicit(&shard->limited, memory_order_relaxed);
+        stats->cells_used += atomic_load_explicit(&shard->used, memory_order_relaxed);
+        stats->evicted += atomic_load_explicit(&shard->evicted, memory_order_relaxed);
+        stats->displaced += atomic_load_explicit(&shard->displaced, memory_order_relaxed);
+    }
+    stats->capacity = limiter->config.capacity;
+}
+
+#endif // _WIN32
@@ -0,0 +1,135 @@
+/*
+ * Catzilla Rate Limiter - GCRA cells in a sharded open-addressing table
+ *
+ * Every key (client address, API key, route) hashes to one 64-byte window
+ * of four cells. A cell holds the key hash and its theoretical arrival time
+ * (GCRA, equivalent to a token bucket refilled continuously), both updated
+ * with compare-and-swap, so a check is a hash, one cache line and one CAS
+ * however many clients there are. A cell whose bucket is full again carries
+ * no state; a timer wheel walks the shards and frees such idle cells, and a
+ * full window gives up its most idle cell to a new key.
+ */
+
+#ifndef CATZILLA_RATE_LIMITER_H
+#define CATZILLA_RATE_LIMITER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "router.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct catzilla_rate_limiter_s catzilla_rate_limiter_t;
+
+#define CATZILLA_RATE_LIMIT_DEFAULT_CAPACITY (1 << 20)   // Cells, 16 bytes each
+#define CATZILLA_RATE_LIMIT_SHARDS 64
+#define CATZILLA_RATE_LIMIT_SWEEP_MS 1000                // Each shard is swept this often
+#define CATZILLA_RATE_LIMIT_HEADER_MAX 64
+
+// What a request is counted against
+typedef enum {
+    CATZILLA_RATE_KEY_CLIENT = 0,     // Client address
+    CATZILLA_RATE_KEY_HEADER = 1,     // A request header, e.g. an API key
+    CATZILLA_RATE_KEY_ROUTE = 2       // The route, shared by every client
+} catzilla_rate_key_kind_t;
+
+typedef struct catzilla_rate_limit_config_s {
+    uint32_t requests;                // Requests per period
+    uint32_t period_ms;
+    uint32_t burst;                   // Requests allowed back to back; 0 = requests
+    catzilla_rate_key_kind_t key_kind;
+    char key_header[CATZILLA_RATE_LIMIT_HEADER_MAX];  // For CATZILLA_RATE_KEY_HEADER
+    size_t capacity;                  // Cells; 0 = CATZILLA_RATE_LIMIT_DEFAULT_CAPACITY
+} catzilla_rate_limit_config_t;
+
+typedef struct catzilla_rate_limit_result_s {
+    uint32_t limit;                   // Burst size
+    uint32_t remaining;               // Requests still allowed right now
+    uint64_t retry_after_ms;          // Wait before the next request is allowed (0 if allowed)
+} catzilla_rate_limit_result_t;
+
+typedef struct catzilla_rate_limit_stats_s {
+    uint64_t allowed;
+    uint64_t limited;
+    uint64_t cells_used;              // Keys currently holding a cell
+    uint64_t evicted;                 // Idle cells freed by the sweep
+    uint64_t displaced;               // Cells taken over by a new key in a full window
+    uint64_t capacity;
+} catzilla_rate_limit_stats_t;
+
+/**
+ * Create a rate limiter
+ * @param config Limits; requests and period_ms must be set
+ * @return Rate limiter, or NULL on invalid config or allocation failure
+ *         (always NULL on Windows)
+ */
+catzilla_rate_limiter_t* catzilla_rate_limiter_create(const catzilla_rate_limit_config_t* config);
+
+/**
+ * Free a rate limiter; no check may be running
+ * @param limiter Rate limiter (may be NULL)
+ */
+void catzilla_rate_limiter_destroy(catzilla_rate_limiter_t* limiter);
+
+/**
+ * Get the configuration a limiter was created with
+ * @param limiter Rate limiter
+ * @return Configuration, with burst and capacity filled in
+ */
+const catzilla_rate_limit_config_t* catzilla_rate_limiter_get_config(const catzilla_rate_limiter_t* limiter);
+
+/**
+ * Count one request against a key. Safe to call from any thread.
+ * @param limiter Rate limiter
+ * @param key Key bytes
+ * @param key_len Key length
+ * @param result Receives the limit state of the key (may be NULL)
+ * @return 0 if the request is allowed, 1 if it is over the limit, -1 on invalid arguments
+ */
+int catzilla_rate_limiter_check(catzilla_rate_limiter_t* limiter, const void* key, size_t key_len,
+                                catzilla_rate_limit_result_t* result);
+
+/**
+ * catzilla_rate_limiter_check at a given time
+ * @param limiter Rate limiter
+ * @param key Key bytes
+ * @param key_len Key length
+ * @param now_ms Milliseconds since the limiter was created
+ * @param result Receives the limit state of the key (may be NULL)
+ * @return 0 if the request is allowed, 1 if it is over the limit, -1 on invalid arguments
+ */
+int catzilla_rate_limiter_check_at(catzilla_rate_limiter_t* limiter, const void* key, size_t key_len,
+                                   uint64_t now_ms, catzilla_rate_limit_result_t* result);
+
+/**
+ * Advance the eviction wheel to a given time, freeing idle cells of the
+ * shards that are due. Checks already do this as time passes.
+ * @param limiter Rate limiter
+ * @param now_ms Milliseconds since the limiter was created
+ * @return Number of cells freed
+ */
+int catzilla_rate_limiter_sweep(catzilla_rate_limiter_t* limiter, uint64_t now_ms);
+
+/**
+ * Get rate limiter statistics
+ * @param limiter Rate limiter
+ * @param stats Receives the statistics
+ */
+void catzilla_rate_limiter_get_stats(catzilla_rate_limiter_t* limiter, catzilla_rate_limit_stats_t* stats);
+
+/**
+ * Give a route its own limits instead of the default limiter's. Call before
+ * the router is shared; the limiter must outlive the route.
+ * @param route Route
+ * @param limiter Rate limiter, or NULL for the default
+ */
+void catzilla_route_set_rate_limit(catzilla_route_t* route, catzilla_rate_limiter_t* limiter);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CATZILLA_RATE_LIMITER_H
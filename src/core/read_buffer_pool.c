@@ -0,0 +1,91 @@
+#include "read_buffer_pool.h"
+#include "memory.h"
+#include "platform_compat.h"
+#include "platform_atomic.h"
+#include <string.h>
+
+// Each event loop runs on its own thread, so a thread-local freelist is a
+// per-loop pool that needs no locking
+typedef struct {
+    char* free_slabs[CATZILLA_READ_POOL_MAX_RETAINED];
+    int count;
+} read_slab_pool_t;
+
+static CATZILLA_THREAD_LOCAL read_slab_pool_t slab_pool;
+
+// Process-wide counters shared by all loops
+static catzilla_atomic_uint64_t stat_slab_hits = 0;
+static catzilla_atomic_uint64_t stat_slab_misses = 0;
+static catzilla_atomic_uint64_t stat_slab_releases = 0;
+static catzilla_atomic_uint64_t stat_slab_drops = 0;
+static catzilla_atomic_uint64_t stat_retained_bytes = 0;
+static catzilla_atomic_uint64_t stat_sticky_reads = 0;
+static catzilla_atomic_uint64_t stat_sticky_bytes = 0;
+
+char* catzilla_read_slab_acquire(void) {
+    if (slab_pool.count > 0) {
+        char* slab = slab_pool.free_slabs[--slab_pool.count];
+        catzilla_atomic_fetch_add(&stat_slab_hits, 1);
+        catzilla_atomic_fetch_sub(&stat_retained_bytes, CATZILLA_READ_SLAB_SIZE);
+        return slab;
+    }
+
+    catzilla_atomic_fetch_add(&stat_slab_misses, 1);
+    return catzilla_request_alloc(CATZILLA_READ_SLAB_SIZE);
+}
+
+void catzilla_read_slab_release(char* slab) {
+    if (!slab) return;
+
+    if (slab_pool.count < CATZILLA_READ_POOL_MAX_RETAINED) {
+        slab_pool.free_slabs[slab_pool.count++] = slab;
+        catzilla_atomic_fetch_add(&stat_slab_releases, 1);
+        catzilla_atomic_fetch_add(&stat_retained_bytes, CATZILLA_READ_SLAB_SIZE);
+        return;
+    }
+
+    // Bounded retention: beyond the cap the slab goes back to the allocator
+    catzilla_atomic_fetch_add(&stat_slab_drops, 1);
+    catzilla_request_free(slab);
+}
+
+void catzilla_read_pool_trim(void) {
+    while (slab_pool.count > 0) {
+        catzilla_request_free(slab_pool.free_slabs[--slab_pool.count]);
+        catzilla_atomic_fetch_sub(&stat_retained_bytes, CATZILLA_READ_SLAB_SIZE);
+    }
+}
+
+char* catzilla_sticky_buffer_alloc(void) {
+    char* buffer = catzilla_request_alloc(CATZILLA_STICKY_READ_BUFFER_SIZE);
+    if (buffer) {
+        catzilla_atomic_fetch_add(&stat_sticky_bytes, CATZILLA_STICKY_READ_BUFFER_SIZE);
+    }
+    return buffer;
+}
+
+void catzilla_sticky_buffer_free(char* buffer) {
+    if (!buffer) return;
+    catzilla_atomic_fetch_sub(&stat_sticky_bytes, CATZILLA_STICKY_READ_BUFFER_SIZE);
+    catzilla_request_free(buffer);
+}
+
+void catzilla_sticky_buffer_note_read(void) {
+    catzilla_atomic_fetch_add(&stat_sticky_reads, 1);
+}
+
+void catzilla_read_pool_get_stats(catzilla_read_pool_stats_t* stats) {
+    if (!stats) return;
+    memset(stats, 0, sizeof(*stats));
+
+    stats->slab_hits = catzilla_atomic_load(&stat_slab_hits);
+    stats->slab_misses = catzilla_atomic_load(&stat_slab_misses);
+    stats->slab_releases = catzilla_atomic_load(&stat_slab_releases);
+    stats->slab_drops = catzilla_atomic_load(&stat_slab_drops);
+    stats->retained_bytes = catzilla_atomic_load(&stat_retained_bytes);
+    stats->sticky_reads = catzilla_atomic_load(&stat_sticky_reads);
+    stats->sticky_bytes = catzilla_atomic_load(&stat_sticky_bytes);
+
+    uint64_t total = stats->slab_hits + stats->slab_misses;
+    stats->hit_rate = total > 0 ? (double)stats->slab_hits / (double)total : 0.0;
+}
@@ -0,0 +1,78 @@
+#ifndef CATZILLA_READ_BUFFER_POOL_H
+#define CATZILLA_READ_BUFFER_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Size of every pooled read slab (libuv suggests 64 KB per read)
+#define CATZILLA_READ_SLAB_SIZE (64 * 1024)
+
+// Free slabs kept per event loop thread before they go back to the allocator
+#define CATZILLA_READ_POOL_MAX_RETAINED 64
+
+// Per-connection buffer used once a keep-alive socket's reads turn out small
+#define CATZILLA_STICKY_READ_BUFFER_SIZE 2048
+
+/**
+ * Read buffer pool statistics, aggregated over all event loop threads
+ */
+typedef struct {
+    uint64_t slab_hits;            // Slabs served from a pool freelist
+    uint64_t slab_misses;          // Slabs that had to be allocated
+    uint64_t slab_releases;        // Slabs returned to a pool freelist
+    uint64_t slab_drops;           // Slabs freed because the pool was full
+    uint64_t retained_bytes;       // Bytes currently held by pool freelists
+    uint64_t sticky_reads;         // Reads served from a connection's sticky buffer
+    uint64_t sticky_bytes;         // Bytes held by live sticky buffers
+    double hit_rate;               // slab_hits / (slab_hits + slab_misses)
+} catzilla_read_pool_stats_t;
+
+/**
+ * Take a CATZILLA_READ_SLAB_SIZE buffer from the calling thread's pool
+ * @return Buffer, or NULL on allocation failure
+ */
+char* catzilla_read_slab_acquire(void);
+
+/**
+ * Return a slab to the calling thread's pool (freed when the pool is full)
+ * @param slab Buffer from catzilla_read_slab_acquire (NULL is ignored)
+ */
+void catzilla_read_slab_release(char* slab);
+
+/**
+ * Free every slab retained by the calling thread's pool
+ */
+void catzilla_read_pool_trim(void);
+
+/**
+ * Allocate a per-connection sticky read buffer
+ * @return Buffer of CATZILLA_STICKY_READ_BUFFER_SIZE bytes, or NULL
+ */
+char* catzilla_sticky_buffer_alloc(void);
+
+/**
+ * Free a sticky read buffer
+ * @param buffer Buffer from catzilla_sticky_buffer_alloc (NULL is ignored)
+ */
+void catzilla_sticky_buffer_free(char* buffer);
+
+/**
+ * Count a read served from a sticky buffer
+ */
+void catzilla_sticky_buffer_note_read(void);
+
+/**
+ * Get read buffer pool statistics
+ * @param stats Pointer to stats structure to fill
+ */
+void catzilla_read_pool_get_stats(catzilla_read_pool_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CATZILLA_READ_BUFFER_POOL_H
@@ -0,0 +1,953 @@
+/*
+ * Catzilla Redis Client - non-blocking RESP client on a libuv loop
+ *
+ * Each pooled connection owns an output buffer of encoded commands and a
+ * ring of callbacks waiting for replies. Commands only append to the output
+ * buffer; a prepare handle writes every buffer out right before the loop
+ * polls, so all commands of one iteration go out in one write per
+ * connection. Replies are parsed from the connection's input buffer as they
+ * arrive and handed to the callback at the head of its ring.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "redis_client.h"
+#include "logging.h"
+
+#define REDIS_INITIAL_BACKOFF_MS 100
+#define REDIS_READ_CHUNK 16384
+#define REDIS_MAX_LINE (64 * 1024)
+#define REDIS_MAX_NESTING 8
+
+typedef enum {
+    REDIS_CONN_DOWN = 0,
+    REDIS_CONN_RESOLVING,
+    REDIS_CONN_CONNECTING,
+    REDIS_CONN_READY,
+    REDIS_CONN_CLOSING
+} redis_conn_state_t;
+
+typedef enum {
+    PENDING_REPLY = 0,  // Plain command: callback gets the reply
+    PENDING_HANDSHAKE,  // AUTH or SELECT sent on connect
+    PENDING_TTL,        // PTTL half of a GET: passes its value to the next entry
+    PENDING_VALUE       // GET half: get_callback gets value and TTL
+} redis_pending_kind_t;
+
+typedef struct {
+    redis_pending_kind_t kind;
+    catzilla_redis_callback_t callback;
+    catzilla_redis_get_callback_t get_callback;
+    void* data;
+    int64_t ttl_ms;
+    uint64_t queued_at;
+} redis_pending_t;
+
+typedef struct redis_conn_s {
+    catzilla_redis_t* client;
+    uv_tcp_t tcp;
+    uv_getaddrinfo_t resolver;
+    uv_connect_t connect_req;
+    redis_conn_state_t state;
+    bool tcp_open;
+    bool resolving;
+    bool ever_connected;
+    uint64_t state_since;
+    uint64_t retry_at;
+    uint32_t backoff_ms;
+
+    // Encoded commands not written yet
+    char* out;
+    size_t out_len;
+    size_t out_cap;
+
+    // Received bytes not parsed yet
+    char* in;
+    size_t in_len;
+    size_t in_cap;
+
+    // Replies outstanding, oldest at head
+    redis_pending_t* pending;
+    size_t pending_head;
+    size_t pending_count;
+    size_t pending_cap;
+} redis_conn_t;
+
+struct catzilla_redis_s {
+    uv_loop_t* loop;
+    uv_thread_t thread;
+    uv_prepare_t flush_handle;
+    uv_timer_t tick;
+
+    char host[256];
+    char port[8];
+    char* user;
+    char* password;
+    int db;
+
+    int pool_size;
+    int max_pending;
+    uint32_t timeout_ms;
+    int next_conn;
+    redis_conn_t conns[CATZILLA_REDIS_MAX_POOL_SIZE];
+
+    bool closing;
+    int open_handles;  // Handles and resolver requests not finished yet
+    catzilla_redis_stats_t stats;
+};
+
+typedef struct {
+    uv_write_t req;
+    uv_buf_t buf;
+} redis_write_t;
+
+static void start_connect(redis_conn_t* conn);
+static void reset_connection(redis_conn_t* conn);
+static void on_flush(uv_prepare_t* handle);
+
+// ============================================================================
+// RESP parsing
+// ============================================================================
+
+static bool parse_integer(const char* s, size_t len, int64_t* out) {
+    bool negative = len > 0 && s[0] == '-';
+    size_t i = negative ? 1 : 0;
+    if (i == len || len - i > 18) return false;
+
+    int64_t value = 0;
+    for (; i < len; i++) {
+        if (s[i] < '0' || s[i] > '9') return false;
+        value = value * 10 + (s[i] - '0');
+    }
+    *out = negative ? -value : value;
+    return true;
+}
+
+// Offset of the CR ending the first line, -1 if the line is not complete
+static long find_line_end(const char* data, size_t len) {
+    size_t limit = len < REDIS_MAX_LINE ? len : REDIS_MAX_LINE;
+    const char* cr = limit > 1 ? memchr(data + 1, '\r', limit - 1) : NULL;
+    while (cr) {
+        size_t offset = (size_t)(cr - data);
+        if (offset + 1 >= len) return -1;
+        if (cr[1] == '\n') return (long)offset;
+        cr = memchr(cr + 1, '\r', limit - offset - 1);
+    }
+    return len >= REDIS_MAX_LINE ? -2 : -1;
+}
+
+static long parse_reply(const char* data, size_t len, catzilla_redis_reply_t* reply, int depth) {
+    if (len < 3) return 0;
+    long eol = find_line_end(data, len);
+    if (eol == -1) return 0;
+    if (eol < 0) return -1;
+
+    const char* line = data + 1;
+    size_t line_len = (size_t)eol - 1;
+    size_t header = (size_t)eol + 2;
+    memset(reply, 0, sizeof(*reply));
+
+    switch (data[0]) {
+    case '+':
+    case '-':
+        reply->type = data[0] == '+' ? CATZILLA_REDIS_REPLY_STATUS : CATZILLA_REDIS_REPLY_ERROR;
+        reply->str = line;
+        reply->len = line_len;
+        return (long)header;
+
+    case ':':
+        reply->type = CATZILLA_REDIS_REPLY_INTEGER;
+        return parse_integer(line, line_len, &reply->integer) ? (long)header : -1;
+
+    case '$': {
+        int64_t size;
+        if (!parse_integer(line, line_len, &size) || size < -1) return -1;
+        if (size == -1) {
+            reply->type = CATZILLA_REDIS_REPLY_NIL;
+            return (long)header;
+        }
+        size_t total = header + (size_t)size + 2;
+        if (len < total) return 0;
+        if (data[total - 2] != '\r' || data[total - 1] != '\n') return -1;
+        reply->type = CATZILLA_REDIS_REPLY_BULK;
+        reply->str = data + header;
+        reply->len = (size_t)size;
+        return (long)total;
+    }
+
+    case '*': {
+        int64_t count;
+        if (!parse_integer(line, line_len, &count) || count < -1) return -1;
+        if (count == -1) {
+            reply->type = CATZILLA_REDIS_REPLY_NIL;
+            return (long)header;
+        }
+        if (depth >= REDIS_MAX_NESTING) return -1;
+
+        size_t offset = header;
+        for (int64_t i = 0; i < count; i++) {
+            catzilla_redis_reply_t element;
+            long used = parse_reply(data + offset, len - offset, &element, depth + 1);
+            if (used <= 0) return used;
+            offset += (size_t)used;
+        }
+        memset(reply, 0, sizeof(*reply));
+        reply->type = CATZILLA_REDIS_REPLY_ARRAY;
+        reply->integer = count;
+        return (long)offset;
+    }
+
+    default:
+        return -1;
+    }
+}
+
+long catzilla_redis_parse_reply(const char* data, size_t len, catzilla_redis_reply_t* reply) {
+    if (!data || !reply) return -1;
+    return parse_reply(data, len, reply, 0);
+}
+
+// ============================================================================
+// URL parsing
+// ============================================================================
+
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Percent-decoded copy of s[0, len), NULL when empty
+static char* decode_component(const char* s, size_t len) {
+    if (len == 0) return NULL;
+    char* out = malloc(len + 1);
+    if (!out) return NULL;
+
+    size_t n = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (s[i] == '%' && i + 2 < len && hex_value(s[i + 1]) >= 0 && hex_value(s[i + 2]) >= 0) {
+            out[n++] = (char)(hex_value(s[i + 1]) * 16 + hex_value(s[i + 2]));
+            i += 2;
+        } else {
+            out[n++] = s[i];
+        }
+    }
+    out[n] = '\0';
+    return out;
+}
+
+// Split a URL into the client's host, port, credentials and database
+static int parse_url(const char* url, catzilla_redis_t* client) {
+    const char* prefix = "redis://";
+    size_t prefix_len = strlen(prefix);
+    if (!url || strncmp(url, prefix, prefix_len) != 0) return -1;
+
+    const char* authority = url + prefix_len;
+    const char* path = strchr(authority, '/');
+    const char* authority_end = path ? path : authority + strlen(authority);
+
+    // Credentials end at the last '@' of the authority
+    const char* at = NULL;
+    for (const char* p = authority; p < authority_end; p++) {
+        if (*p == '@') at = p;
+    }
+    if (at) {
+        const char* colon = memchr(authority, ':', (size_t)(at - authority));
+        if (colon) {
+            client->user = decode_component(authority, (size_t)(colon - authority));
+            client->password = decode_component(colon + 1, (size_t)(at - colon - 1));
+        }
+        authority = at + 1;
+    }
+
+    const char* host = authority;
+    const char* host_end;
+    const char* port = NULL;
+    if (*host == '[') {
+        host++;
+        host_end = memchr(host, ']', (size_t)(authority_end - host));
+        if (!host_end) return -1;
+        if (host_end + 1 < authority_end) {
+            if (host_end[1] != ':') return -1;
+            port = host_end + 2;
+        }
+    } else {
+        host_end = memchr(host, ':', (size_t)(authority_end - host));
+        if (host_end) {
+            port = host_end + 1;
+        } else {
+            host_end = authority_end;
+        }
+    }
+
+    size_t host_len = (size_t)(host_end - host);
+    if (host_len == 0 || host_len >= sizeof(client->host)) return -1;
+    memcpy(client->host, host, host_len);
+    client->host[host_len] = '\0';
+
+    long port_number = CATZILLA_REDIS_DEFAULT_PORT;
+    if (port) {
+        int64_t value;
+        if (!parse_integer(port, (size_t)(authority_end - port), &value) || value < 1 || value > 65535) {
+            return -1;
+        }
+        port_number = (long)value;
+    }
+    snprintf(client->port, sizeof(client->port), "%ld", port_number);
+
+    client->db = 0;
+    if (path && path[1] != '\0') {
+        int64_t value;
+        if (!parse_integer(path + 1, strlen(path + 1), &value) || value < 0 || value > 1 << 20) {
+            return -1;
+        }
+        client->db = (int)value;
+    }
+    return 0;
+}
+
+bool catzilla_redis_url_valid(const char* url) {
+    catzilla_redis_t probe;
+    memset(&probe, 0, sizeof(probe));
+    bool valid = parse_url(url, &probe) == 0;
+    free(probe.user);
+    free(probe.password);
+    return valid;
+}
+
+// ============================================================================
+// Connection buffers
+// ============================================================================
+
+static int reserve_output(redis_conn_t* conn, size_t extra) {
+    if (conn->out_len + extra <= conn->out_cap) return 0;
+    size_t cap = conn->out_cap ? conn->out_cap : 4096;
+    while (cap < conn->out_len + extra) cap *= 2;
+    char* out = realloc(conn->out, cap);
+    if (!out) return -1;
+    conn->out = out;
+    conn->out_cap = cap;
+    return 0;
+}
+
+// Append "*argc\r\n" and one "$len\r\n<bytes>\r\n" per argument
+static int encode_command(redis_conn_t* conn, int argc, const char** argv, const size_t* argv_len) {
+    size_t size = 16;
+    for (int i = 0; i < argc; i++) size += argv_len[i] + 24;
+    if (reserve_output(conn, size) != 0) return -1;
+
+    char* cursor = conn->out + conn->out_len;
+    cursor += sprintf(cursor, "*%d\r\n", argc);
+    for (int i = 0; i < argc; i++) {
+        cursor += sprintf(cursor, "$%zu\r\n", argv_len[i]);
+        memcpy(cursor, argv[i], argv_len[i]);
+        cursor += argv_len[i];
+        *cursor++ = '\r';
+        *cursor++ = '\n';
+    }
+    conn->out_len = (size_t)(cursor - conn->out);
+    return 0;
+}
+
+static int reserve_pending(redis_conn_t* conn, size_t extra) {
+    if (conn->pending_count + extra <= conn->pending_cap) return 0;
+    size_t cap = conn->pending_cap ? conn->pending_cap * 2 : 64;
+    while (cap < conn->pending_count + extra) cap *= 2;
+    redis_pending_t* ring = malloc(cap * sizeof(*ring));
+    if (!ring) return -1;
+    for (size_t i = 0; i < conn->pending_count; i++) {
+        ring[i] = conn->pending[(conn->pending_head + i) % conn->pending_cap];
+    }
+    free(conn->pending);
+    conn->pending = ring;
+    conn->pending_cap = cap;
+    conn->pending_head = 0;
+    return 0;
+}
+
+static void push_pending(redis_conn_t* conn, const redis_pending_t* entry) {
+    conn->pending[(conn->pending_head + conn->pending_count) % conn->pending_cap] = *entry;
+    conn->pending_count++;
+}
+
+static redis_pending_t* peek_pending(redis_conn_t* conn) {
+    return conn->pending_count ? &conn->pending[conn->pending_head] : NULL;
+}
+
+static void pop_pending(redis_conn_t* conn) {
+    conn->pending_head = (conn->pending_head + 1) % conn->pending_cap;
+    conn->pending_count--;
+}
+
+static void schedule_flush(catzilla_redis_t* client) {
+    if (!client->closing && !uv_is_active((uv_handle_t*)&client->flush_handle)) {
+        uv_prepare_start(&client->flush_handle, on_flush);
+    }
+}
+
+// ============================================================================
+// Reply dispatch
+// ============================================================================
+
+static void fail_pending(catzilla_redis_t* client, redis_pending_t* entry) {
+    if (entry->kind == PENDING_TTL || entry->kind == PENDING_HANDSHAKE) return;
+    client->stats.failed++;
+    if (entry->kind == PENDING_VALUE) {
+        entry->get_callback(entry->data, false, NULL, 0, 0);
+    } else if (entry->callback) {
+        entry->callback(entry->data, NULL);
+    }
+}
+
+// Hand one reply to the oldest outstanding command
+static void dispatch_reply(redis_conn_t* conn, const catzilla_redis_reply_t* reply) {
+    catzilla_redis_t* client = conn->client;
+    redis_pending_t entry = *peek_pending(conn);
+    pop_pending(conn);
+    client->stats.replies++;
+
+    switch (entry.kind) {
+    case PENDING_HANDSHAKE:
+        if (reply->type == CATZILLA_REDIS_REPLY_ERROR) {
+            LOG_CACHE_ERROR("Redis %s:%s refused the connection setup: %.*s",
+                            client->host, client->port, (int)reply->len, reply->str);
+            reset_connection(conn);
+        }
+        break;
+
+    case PENDING_TTL: {
+        // The GET queued right behind it gets the lifetime
+        redis_pending_t* value = peek_pending(conn);
+        if (value && value->kind == PENDING_VALUE) {
+            value->ttl_ms = reply->type == CATZILLA_REDIS_REPLY_INTEGER ? reply->integer : -1;
+        }
+        break;
+    }
+
+    case PENDING_VALUE:
+        if (reply->type == CATZILLA_REDIS_REPLY_BULK) {
+            entry.get_callback(entry.data, true, reply->str, reply->len, entry.ttl_ms);
+        } else {
+            entry.get_callback(entry.data, reply->type != CATZILLA_REDIS_REPLY_ERROR, NULL, 0, 0);
+        }
+        break;
+
+    case PENDING_REPLY:
+        if (entry.callback) entry.callback(entry.data, reply);
+        break;
+    }
+}
+
+static void process_input(redis_conn_t* conn) {
+    size_t offset = 0;
+    while (offset < conn->in_len && conn->state == REDIS_CONN_READY) {
+        if (conn->pending_count == 0) {
+            LOG_CACHE_ERROR("Redis %s:%s sent a reply nobody asked for", conn->client->host, conn->client->port);
+            reset_connection(conn);
+            return;
+        }
+
+        catzilla_redis_reply_t reply;
+        long used = catzilla_redis_parse_reply(conn->in + offset, conn->in_len - offset, &reply);
+        if (used == 0) break;
+        if (used < 0) {
+            LOG_CACHE_ERROR("Redis %s:%s sent a malformed reply", conn->client->host, conn->client->port);
+            reset_connection(conn);
+            return;
+        }
+        dispatch_reply(conn, &reply);
+        offset += (size_t)used;
+    }
+
+    if (conn->state != REDIS_CONN_READY) return;
+    if (offset > 0) {
+        memmove(conn->in, conn->in + offset, conn->in_len - offset);
+        conn->in_len -= offset;
+    }
+}
+
+// ============================================================================
+// Connection lifecycle
+// ============================================================================
+
+static void release_handle(catzilla_redis_t* client) {
+    if (--client->open_handles > 0 || !client->closing) return;
+
+    for (int i = 0; i < client->pool_size; i++) {
+        redis_conn_t* conn = &client->conns[i];
+        free(conn->out);
+        free(conn->in);
+        free(conn->pending);
+    }
+    free(client->user);
+    free(client->password);
+    free(client);
+}
+
+static void on_client_handle_closed(uv_handle_t* handle) {
+    release_handle((catzilla_redis_t*)handle->data);
+}
+
+static void mark_down(redis_conn_t* conn) {
+    conn->state = REDIS_CONN_DOWN;
+    conn->retry_at = uv_now(conn->client->loop) + conn->backoff_ms;
+    conn->backoff_ms = conn->backoff_ms * 2 < CATZILLA_REDIS_RECONNECT_MAX_MS ?
+        conn->backoff_ms * 2 : CATZILLA_REDIS_RECONNECT_MAX_MS;
+}
+
+static void on_tcp_closed(uv_handle_t* handle) {
+    redis_conn_t* conn = (redis_conn_t*)handle->data;
+    catzilla_redis_t* client = conn->client;
+    conn->tcp_open = false;
+    if (!client->closing) {
+        mark_down(conn);
+    }
+    release_handle(client);
+}
+
+// Drop the socket and fail everything queued on it
+static void reset_connection(redis_conn_t* conn) {
+    catzilla_redis_t* client = conn->client;
+    if (conn->state == REDIS_CONN_CLOSING || conn->state == REDIS_CONN_DOWN) return;
+
+    if (conn->state == REDIS_CONN_RESOLVING) {
+        // The resolver callback sees the state and stops there
+        conn->state = REDIS_CONN_CLOSING;
+    } else if (conn->tcp_open) {
+        conn->state = REDIS_CONN_CLOSING;
+        uv_close((uv_handle_t*)&conn->tcp, on_tcp_closed);
+    } else {
+        mark_down(conn);
+    }
+    conn->out_len = 0;
+    conn->in_len = 0;
+
+    // Callbacks may queue new commands; this connection takes none now
+    size_t head = conn->pending_head;
+    size_t count = conn->pending_count;
+    conn->pending_head = 0;
+    conn->pending_count = 0;
+    for (size_t i = 0; i < count; i++) {
+        redis_pending_t entry = conn->pending[(head + i) % conn->pending_cap];
+        fail_pending(client, &entry);
+    }
+}
+
+static void queue_handshake(redis_conn_t* conn) {
+    catzilla_redis_t* client = conn->client;
+    redis_pending_t entry = { PENDING_HANDSHAKE, NULL, NULL, NULL, 0, uv_now(client->loop) };
+
+    if (client->password) {
+        // AUTH [user] password
+        const char* argv[3] = { "AUTH", client->user, client->password };
+        size_t argv_len[3] = { 4, client->user ? strlen(client->user) : 0, strlen(client->password) };
+        int argc = 3;
+        if (!client->user) {
+            argv[1] = argv[2];
+            argv_len[1] = argv_len[2];
+            argc = 2;
+        }
+        if (reserve_pending(conn, 1) == 0 && encode_command(conn, argc, argv, argv_len) == 0) {
+            push_pending(conn, &entry);
+        }
+    }
+    if (client->db != 0) {
+        char db[16];
+        int db_len = snprintf(db, sizeof(db), "%d", client->db);
+        const char* argv[2] = { "SELECT", db };
+        size_t argv_len[2] = { 6, (size_t)db_len };
+        if (reserve_pending(conn, 1) == 0 && encode_command(conn, 2, argv, argv_len) == 0) {
+            push_pending(conn, &entry);
+        }
+    }
+}
+
+static void alloc_input(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf) {
+    (void)suggested_size;
+    redis_conn_t* conn = (redis_conn_t*)handle->data;
+    if (conn->in_cap - conn->in_len < REDIS_READ_CHUNK / 4) {
+        size_t cap = conn->in_cap ? conn->in_cap * 2 : REDIS_READ_CHUNK;
+        char* in = realloc(conn->in, cap);
+        if (!in) {
+            *buf = uv_buf_init(NULL, 0);
+            return;
+        }
+        conn->in = in;
+        conn->in_cap = cap;
+    }
+    *buf = uv_buf_init(conn->in + conn->in_len, (unsigned int)(conn->in_cap - conn->in_len));
+}
+
+static void on_input(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
+    (void)buf;
+    redis_conn_t* conn = (redis_conn_t*)stream->data;
+    if (nread < 0) {
+        LOG_CACHE_WARN("Redis %s:%s connection lost: %s",
+                       conn->client->host, conn->client->port, uv_strerror((int)nread));
+        reset_connection(conn);
+        return;
+    }
+    conn->in_len += (size_t)nread;
+    process_input(conn);
+}
+
+static void on_connect(uv_connect_t* req, int status) {
+    redis_conn_t* conn = (redis_conn_t*)req->data;
+    catzilla_redis_t* client = conn->client;
+    if (conn->state != REDIS_CONN_CONNECTING) return;
+
+    if (status < 0) {
+        LOG_CACHE_WARN("Cannot connect to Redis %s:%s: %s", client->host, client->port, uv_strerror(status));
+        reset_connection(conn);
+        return;
+    }
+
+    conn->state = REDIS_CONN_READY;
+    conn->state_since = uv_now(client->loop);
+    conn->backoff_ms = REDIS_INITIAL_BACKOFF_MS;
+    if (conn->ever_connected) client->stats.reconnects++;
+    conn->ever_connected = true;
+    uv_read_start((uv_stream_t*)&conn->tcp, alloc_input, on_input);
+    if (conn->out_len > 0) schedule_flush(client);
+    LOG_CACHE_DEBUG("Connected to Redis %s:%s", client->host, client->port);
+}
+
+static void connect_address(redis_conn_t* conn, const struct sockaddr* addr) {
+    catzilla_redis_t* client = conn->client;
+    if (uv_tcp_init(client->loop, &conn->tcp) != 0) {
+        mark_down(conn);
+        return;
+    }
+    conn->tcp.data = conn;
+    conn->tcp_open = true;
+    client->open_handles++;
+    uv_tcp_nodelay(&conn->tcp, 1);
+
+    // Commands may queue from here on; the handshake goes first
+    conn->state = REDIS_CONN_CONNECTING;
+    conn->state_since = uv_now(client->loop);
+    queue_handshake(conn);
+
+    conn->connect_req.data = conn;
+    int rc = uv_tcp_connect(&conn->connect_req, &conn->tcp, addr, on_connect);
+    if (rc != 0) {
+        LOG_CACHE_WARN("Cannot connect to Redis %s:%s: %s", client->host, client->port, uv_strerror(rc));
+        reset_connection(conn);
+    }
+}
+
+static void on_resolved(uv_getaddrinfo_t* req, int status, struct addrinfo* result) {
+    redis_conn_t* conn = (redis_conn_t*)req->data;
+    catzilla_redis_t* client = conn->client;
+    conn->resolving = false;
+
+    if (client->closing || conn->state != REDIS_CONN_RESOLVING) {
+        if (!client->closing) mark_down(conn);
+    } else if (status < 0 || !result) {
+        LOG_CACHE_WARN("Cannot resolve Redis host %s: %s", client->host, uv_strerror(status));
+        mark_down(conn);
+    } else {
+        connect_address(conn, result->ai_addr);
+    }
+    if (result) uv_freeaddrinfo(result);
+    release_handle(client);
+}
+
+static void start_connect(redis_conn_t* conn) {
+    catzilla_redis_t* client = conn->client;
+    conn->state = REDIS_CONN_RESOLVING;
+    conn->state_since = uv_now(client->loop);
+
+    // Numeric addresses skip the resolver
+    struct sockaddr_storage addr;
+    if (uv_ip4_addr(client->host, atoi(client->port), (struct sockaddr_in*)&addr) == 0 ||
+        uv_ip6_addr(client->host, atoi(client->port), (struct sockaddr_in6*)&addr) == 0) {
+        connect_address(conn, (const struct sockaddr*)&addr);
+        return;
+    }
+
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    conn->resolver.data = conn;
+    int rc = uv_getaddrinfo(client->loop, &conn->resolver, on_resolved, client->host, client->port, &hints);
+    if (rc != 0) {
+        LOG_CACHE_WARN("Cannot resolve Redis host %s: %s", client->host, uv_strerror(rc));
+        mark_down(conn);
+        return;
+    }
+    conn->resolving = true;
+    client->open_handles++;
+}
+
+// ============================================================================
+// Flushing and timeouts
+// ============================================================================
+
+static void on_write_done(uv_write_t* req, int status) {
+    redis_write_t* write = (redis_write_t*)req;
+    redis_conn_t* conn = (redis_conn_t*)req->handle->data;
+    free(write->buf.base);
+    free(write);
+    if (status < 0 && conn->state == REDIS_CONN_READY) {
+        LOG_CACHE_WARN("Redis %s:%s write failed: %s", conn->client->host, conn->client->port, uv_strerror(status));
+        reset_connection(conn);
+    }
+}
+
+static void flush_connection(redis_conn_t* conn) {
+    catzilla_redis_t* client = conn->client;
+    uv_buf_t buf = uv_buf_init(conn->out, (unsigned int)conn->out_len);
+    int written = uv_try_write((uv_stream_t*)&conn->tcp, &buf, 1);
+    if (written < 0 && written != UV_EAGAIN && written != UV_ENOSYS) {
+        LOG_CACHE_WARN("Redis %s:%s write failed: %s", client->host, client->port, uv_strerror(written));
+        reset_connection(conn);
+        return;
+    }
+    client->stats.flushes++;
+    size_t done = written > 0 ? (size_t)written : 0;
+    if (done == conn->out_len) {
+        conn->out_len = 0;
+        return;
+    }
+
+    // The rest goes out with a write that owns the buffer
+    redis_write_t* write = malloc(sizeof(*write));
+    if (!write) {
+        reset_connection(conn);
+        return;
+    }
+    if (done > 0) memmove(conn->out, conn->out + done, conn->out_len - done);
+    write->buf = uv_buf_init(conn->out, (unsigned int)(conn->out_len - done));
+    conn->out = NULL;
+    conn->out_len = 0;
+    conn->out_cap = 0;
+
+    int rc = uv_write(&write->req, (uv_stream_t*)&conn->tcp, &write->buf, 1, on_write_done);
+    if (rc != 0) {
+        free(write->buf.base);
+        free(write);
+        reset_connection(conn);
+    }
+}
+
+// Runs right before the loop polls: everything queued this iteration goes out
+static void on_flush(uv_prepare_t* handle) {
+    catzilla_redis_t* client = (catzilla_redis_t*)handle->data;
+    uv_prepare_stop(handle);
+    for (int i = 0; i < client->pool_size; i++) {
+        redis_conn_t* conn = &client->conns[i];
+        if (conn->state == REDIS_CONN_READY && conn->out_len > 0) {
+            flush_connection(conn);
+        }
+    }
+}
+
+static void on_tick(uv_timer_t* handle) {
+    catzilla_redis_t* client = (catzilla_redis_t*)handle->data;
+    uint64_t now = uv_now(client->loop);
+    // Connecting may take a few command timeouts before it counts as stalled
+    uint64_t connect_timeout = client->timeout_ms * 4 > 1000 ? client->timeout_ms * 4 : 1000;
+
+    for (int i = 0; i < client->pool_size; i++) {
+        redis_conn_t* conn = &client->conns[i];
+        redis_pending_t* oldest = peek_pending(conn);
+        if (conn->state == REDIS_CONN_READY && oldest && now - oldest->queued_at > client->timeout_ms) {
+            LOG_CACHE_WARN("Redis %s:%s did not answer within %ums; reconnecting",
+                           client->host, client->port, client->timeout_ms);
+            client->stats.timeouts++;
+            reset_connection(conn);
+        } else if (conn->state == REDIS_CONN_CONNECTING && now - conn->state_since > connect_timeout) {
+            client->stats.timeouts++;
+            reset_connection(conn);
+        } else if (conn->state == REDIS_CONN_DOWN && now >= conn->retry_at) {
+            start_connect(conn);
+        }
+    }
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+catzilla_redis_t* catzilla_redis_create(uv_loop_t* loop, const char* url,
+                                        const catzilla_redis_config_t* config) {
+    if (!loop || !url) return NULL;
+
+    catzilla_redis_t* client = calloc(1, sizeof(*client));
+    if (!client) return NULL;
+    if (parse_url(url, client) != 0) {
+        LOG_CACHE_ERROR("Invalid Redis URL (expected redis://[[user]:password@]host[:port][/db])");
+        free(client->user);
+        free(client->password);
+        free(client);
+        return NULL;
+    }
+
+    int pool_size = config && config->pool_size > 0 ? config->pool_size : CATZILLA_REDIS_POOL_SIZE;
+    client->pool_size = pool_size < CATZILLA_REDIS_MAX_POOL_SIZE ? pool_size : CATZILLA_REDIS_MAX_POOL_SIZE;
+    client->max_pending = config && config->max_pending > 0 ? config->max_pending : CATZILLA_REDIS_MAX_PENDING;
+    client->timeout_ms = config && config->command_timeout_ms > 0 ?
+        config->command_timeout_ms : CATZILLA_REDIS_COMMAND_TIMEOUT_MS;
+    client->loop = loop;
+    client->thread = uv_thread_self();
+
+    uv_prepare_init(loop, &client->flush_handle);
+    client->flush_handle.data = client;
+    uv_timer_init(loop, &client->tick);
+    client->tick.data = client;
+    client->open_handles = 2;
+
+    // Retries and timeouts never keep the loop alive on their own
+    uint64_t period = client->timeout_ms / 2 < 100 ? client->timeout_ms / 2 : 100;
+    if (period < 10) period = 10;
+    uv_timer_start(&client->tick, on_tick, period, period);
+    uv_unref((uv_handle_t*)&client->tick);
+
+    for (int i = 0; i < client->pool_size; i++) {
+        redis_conn_t* conn = &client->conns[i];
+        conn->client = client;
+        conn->backoff_ms = REDIS_INITIAL_BACKOFF_MS;
+        start_connect(conn);
+    }
+    return client;
+}
+
+void catzilla_redis_close(catzilla_redis_t* client) {
+    if (!client || client->closing) return;
+    client->closing = true;
+
+    uv_prepare_stop(&client->flush_handle);
+    uv_close((uv_handle_t*)&client->flush_handle, on_client_handle_closed);
+    uv_timer_stop(&client->tick);
+    uv_close((uv_handle_t*)&client->tick, on_client_handle_closed);
+
+    for (int i = 0; i < client->pool_size; i++) {
+        redis_conn_t* conn = &client->conns[i];
+        reset_connection(conn);
+        if (conn->resolving) {
+            uv_cancel((uv_req_t*)&conn->resolver);
+        }
+    }
+}
+
+// Connection with the fewest replies outstanding; ready ones before
+// connecting ones, none while all are down
+static redis_conn_t* pick_connection(catzilla_redis_t* client, size_t slots) {
+    redis_conn_t* best = NULL;
+    size_t best_score = 0;
+    for (int i = 0; i < client->pool_size; i++) {
+        redis_conn_t* conn = &client->conns[(client->next_conn + i) % client->pool_size];
+        if (conn->state != REDIS_CONN_READY && conn->state != REDIS_CONN_CONNECTING) continue;
+        if (conn->pending_count + slots > (size_t)client->max_pending) continue;
+
+        size_t score = conn->pending_count + (conn->state == REDIS_CONN_READY ? 0 : (size_t)client->max_pending);
+        if (!best || score < best_score) {
+            best = conn;
+            best_score = score;
+        }
+    }
+    client->next_conn = (client->next_conn + 1) % client->pool_size;
+    return best;
+}
+
+static redis_conn_t* reserve_command(catzilla_redis_t* client, size_t slots) {
+    if (!client || client->closing) return NULL;
+    redis_conn_t* conn = pick_connection(client, slots);
+    if (!conn || reserve_pending(conn, slots) != 0) {
+        client->stats.rejected++;
+        return NULL;
+    }
+    return conn;
+}
+
+static int queue_command(catzilla_redis_t* client, redis_conn_t* conn, int argc, const char** argv,
+                         const size_t* argv_len, const redis_pending_t* entry) {
+    if (encode_command(conn, argc, argv, argv_len) != 0) {
+        client->stats.rejected++;
+        return -1;
+    }
+    push_pending(conn, entry);
+    client->stats.commands++;
+    schedule_flush(client);
+    return 0;
+}
+
+int catzilla_redis_command(catzilla_redis_t* client, int argc, const char** argv,
+                           const size_t* argv_len, catzilla_redis_callback_t callback, void* data) {
+    if (argc <= 0 || !argv || !argv_len) return -1;
+    redis_conn_t* conn = reserve_command(client, 1);
+    if (!conn) return -1;
+
+    redis_pending_t entry = { PENDING_REPLY, callback, NULL, data, 0, uv_now(client->loop) };
+    return queue_command(client, conn, argc, argv, argv_len, &entry);
+}
+
+int catzilla_redis_get(catzilla_redis_t* client, const char* key, size_t key_len,
+                       catzilla_redis_get_callback_t callback, void* data) {
+    if (!key || !callback) return -1;
+    redis_conn_t* conn = reserve_command(client, 2);
+    if (!conn) return -1;
+
+    // PTTL first: its small reply is kept until the value arrives, so the
+    // value can be handed over straight from the read buffer
+    const char* ttl_argv[2] = { "PTTL", key };
+    size_t ttl_len[2] = { 4, key_len };
+    const char* get_argv[2] = { "GET", key };
+    size_t get_len[2] = { 3, key_len };
+    size_t mark = conn->out_len;
+    if (encode_command(conn, 2, ttl_argv, ttl_len) != 0 || encode_command(conn, 2, get_argv, get_len) != 0) {
+        conn->out_len = mark;
+        client->stats.rejected++;
+        return -1;
+    }
+
+    uint64_t now = uv_now(client->loop);
+    redis_pending_t ttl_entry = { PENDING_TTL, NULL, NULL, NULL, 0, now };
+    redis_pending_t value_entry = { PENDING_VALUE, NULL, callback, data, -1, now };
+    push_pending(conn, &ttl_entry);
+    push_pending(conn, &value_entry);
+    client->stats.commands += 2;
+    schedule_flush(client);
+    return 0;
+}
+
+int catzilla_redis_set(catzilla_redis_t* client, const char* key, size_t key_len,
+                       const void* value, size_t size, uint32_t ttl_seconds) {
+    if (!key || (!value && size > 0)) return -1;
+    redis_conn_t* conn = reserve_command(client, 1);
+    if (!conn) return -1;
+
+    char ttl[16];
+    int ttl_len = snprintf(ttl, sizeof(ttl), "%u", ttl_seconds);
+    const char* argv[5] = { "SET", key, value ? (const char*)value : "", "EX", ttl };
+    size_t argv_len[5] = { 3, key_len, size, 2, (size_t)ttl_len };
+    redis_pending_t entry = { PENDING_REPLY, NULL, NULL, NULL, 0, uv_now(client->loop) };
+    return queue_command(client, conn, ttl_seconds > 0 ? 5 : 3, argv, argv_len, &entry);
+}
+
+int catzilla_redis_del(catzilla_redis_t* client, const char* key, size_t key_len) {
+    const char* argv[2] = { "DEL", key };
+    size_t argv_len[2] = { 3, key_len };
+    return key ? catzilla_redis_command(client, 2, argv, argv_len, NULL, NULL) : -1;
+}
+
+bool catzilla_redis_on_loop_thread(const catzilla_redis_t* client) {
+    uv_thread_t self = uv_thread_self();
+    return client && uv_thread_equal(&client->thread, &self);
+}
+
+void catzilla_redis_get_stats(const catzilla_redis_t* client, catzilla_redis_stats_t* stats) {
+    if (!stats) return;
+    memset(stats, 0, sizeof(*stats));
+    if (!client) return;
+
+    *stats = client->stats;
+    for (int i = 0; i < client->pool_size; i++) {
+        if (client->conns[i].state == REDIS_CONN_READY) stats->connected++;
+    }
+}
@@ -0,0 +1,187 @@
+/*
+ * Catzilla Redis Client - non-blocking RESP client on a libuv loop
+ *
+ * One client belongs to one event loop and is only used from that loop's
+ * thread. It keeps a small pool of connections; a command goes to the
+ * connection with the fewest replies outstanding. Commands issued during a
+ * loop iteration are buffered and written together right before the loop
+ * polls again, so requests handled in the same tick share one write per
+ * connection and Redis sees them pipelined. Replies are matched to commands
+ * in order. A connection that fails or stalls past the command timeout is
+ * reset: everything queued on it fails, and it reconnects with backoff.
+ * Commands never wait for a connection that is down; they fail right away.
+ */
+
+#ifndef CATZILLA_REDIS_CLIENT_H
+#define CATZILLA_REDIS_CLIENT_H
+
+#include <uv.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct catzilla_redis_s catzilla_redis_t;
+
+#define CATZILLA_REDIS_DEFAULT_PORT 6379
+#define CATZILLA_REDIS_POOL_SIZE 2
+#define CATZILLA_REDIS_MAX_POOL_SIZE 16
+#define CATZILLA_REDIS_MAX_PENDING 4096
+#define CATZILLA_REDIS_COMMAND_TIMEOUT_MS 250
+#define CATZILLA_REDIS_RECONNECT_MAX_MS 5000
+
+// Client configuration; zero fields take the defaults above
+typedef struct catzilla_redis_config_s {
+    int pool_size;                // Connections per loop
+    int max_pending;              // Replies outstanding per connection before commands fail
+    uint32_t command_timeout_ms;  // Reset a connection whose oldest reply is this late
+} catzilla_redis_config_t;
+
+typedef enum {
+    CATZILLA_REDIS_REPLY_STATUS = 0,  // +OK
+    CATZILLA_REDIS_REPLY_ERROR,       // -ERR ...
+    CATZILLA_REDIS_REPLY_INTEGER,     // :42
+    CATZILLA_REDIS_REPLY_BULK,        // $3 foo
+    CATZILLA_REDIS_REPLY_NIL,         // $-1 or *-1
+    CATZILLA_REDIS_REPLY_ARRAY        // *n (elements are skipped)
+} catzilla_redis_reply_type_t;
+
+/**
+ * A parsed reply. str points into the client's read buffer and is valid only
+ * during the callback that receives it.
+ */
+typedef struct {
+    catzilla_redis_reply_type_t type;
+    const char* str;              // Status, error and bulk payloads
+    size_t len;
+    int64_t integer;              // Integer value, or element count of an array
+} catzilla_redis_reply_t;
+
+/**
+ * Reply callback. reply is NULL when the command failed without a reply
+ * (connection lost, timed out, or client closed).
+ */
+typedef void (*catzilla_redis_callback_t)(void* data, const catzilla_redis_reply_t* reply);
+
+/**
+ * GET callback. value is NULL when the key is missing or the lookup failed
+ * (ok tells the two apart). ttl_ms is the key's remaining lifetime, -1 when
+ * it never expires.
+ */
+typedef void (*catzilla_redis_get_callback_t)(void* data, bool ok, const void* value,
+                                              size_t size, int64_t ttl_ms);
+
+typedef struct catzilla_redis_stats_s {
+    uint64_t commands;            // Commands queued
+    uint64_t replies;             // Replies received
+    uint64_t failed;              // Commands that failed without a reply
+    uint64_t rejected;            // Commands refused (no connection, queue full)
+    uint64_t flushes;             // Writes of buffered commands
+    uint64_t timeouts;            // Connections reset for a late reply
+    uint64_t reconnects;          // Connections established after the first
+    int connected;                // Connections ready right now
+} catzilla_redis_stats_t;
+
+/**
+ * Parse one RESP reply from the front of a buffer
+ * @param data Buffer start
+ * @param len Bytes available
+ * @param reply Receives the reply (pointers into data)
+ * @return Bytes the reply takes, 0 if it is not complete yet, -1 on a protocol error
+ */
+long catzilla_redis_parse_reply(const char* data, size_t len, catzilla_redis_reply_t* reply);
+
+/**
+ * Create a client for a loop and start connecting its pool
+ * @param loop Loop the client runs on; every call must come from its thread
+ * @param url redis://[[user]:password@]host[:port][/db]
+ * @param config Configuration, or NULL for the defaults
+ * @return Client, or NULL if the URL is invalid or memory runs out
+ */
+catzilla_redis_t* catzilla_redis_create(uv_loop_t* loop, const char* url,
+                                        const catzilla_redis_config_t* config);
+
+/**
+ * Fail every outstanding command and close the connections. The client frees
+ * itself once the loop has run the close callbacks, so call this before the
+ * loop's handles are walked and closed.
+ * @param client Client (may be NULL)
+ */
+void catzilla_redis_close(catzilla_redis_t* client);
+
+/**
+ * Check a URL without connecting
+ * @param url Redis URL
+ * @return true if catzilla_redis_create would accept it
+ */
+bool catzilla_redis_url_valid(const char* url);
+
+/**
+ * Queue a command
+ * @param client Client
+ * @param argc Argument count
+ * @param argv Arguments (binary safe)
+ * @param argv_len Argument lengths
+ * @param callback Reply callback (NULL to ignore the reply)
+ * @param data Passed to the callback
+ * @return 0 if queued (the callback runs later), -1 if refused (it never runs)
+ */
+int catzilla_redis_command(catzilla_redis_t* client, int argc, const char** argv,
+                           const size_t* argv_len, catzilla_redis_callback_t callback, void* data);
+
+/**
+ * Queue a GET together with a PTTL for the same key
+ * @param client Client
+ * @param key Key
+ * @param key_len Key length
+ * @param callback Called once with the value and its remaining lifetime
+ * @param data Passed to the callback
+ * @return 0 if queued, -1 if refused (the callback never runs)
+ */
+int catzilla_redis_get(catzilla_redis_t* client, const char* key, size_t key_len,
+                       catzilla_redis_get_callback_t callback, void* data);
+
+/**
+ * Queue a SET, replies ignored
+ * @param client Client
+ * @param key Key
+ * @param key_len Key length
+ * @param value Value bytes
+ * @param size Value size
+ * @param ttl_seconds Lifetime (0 = never expires)
+ * @return 0 if queued, -1 if refused
+ */
+int catzilla_redis_set(catzilla_redis_t* client, const char* key, size_t key_len,
+                       const void* value, size_t size, uint32_t ttl_seconds);
+
+/**
+ * Queue a DEL, reply ignored
+ * @param client Client
+ * @param key Key
+ * @param key_len Key length
+ * @return 0 if queued, -1 if refused
+ */
+int catzilla_redis_del(catzilla_redis_t* client, const char* key, size_t key_len);
+
+/**
+ * Check whether the calling thread runs the client's loop
+ * @param client Client
+ * @return true on the loop's thread
+ */
+bool catzilla_redis_on_loop_thread(const catzilla_redis_t* client);
+
+/**
+ * Get client statistics
+ * @param client Client
+ * @param stats Receives the statistics
+ */
+void catzilla_redis_get_stats(const catzilla_redis_t* client, catzilla_redis_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CATZILLA_REDIS_CLIENT_H
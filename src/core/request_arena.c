@@ -0,0 +1,151 @@
+#include "request_arena.h"
+#include "memory.h"
+#include "platform_compat.h"
+#include "platform_atomic.h"
+#include <string.h>
+
+#define ARENA_ALIGN 16
+#define ARENA_ROUND(size) (((size) + (ARENA_ALIGN - 1)) & ~(size_t)(ARENA_ALIGN - 1))
+
+typedef struct catzilla_arena_block_s {
+    struct catzilla_arena_block_s* next;
+} catzilla_arena_block_t;
+
+typedef struct catzilla_arena_large_s {
+    struct catzilla_arena_large_s* next;
+} catzilla_arena_large_t;
+
+// Headers are padded so the memory after them keeps the arena alignment
+#define BLOCK_HEADER ARENA_ROUND(sizeof(catzilla_arena_block_t))
+#define LARGE_HEADER ARENA_ROUND(sizeof(catzilla_arena_large_t))
+#define BLOCK_CAPACITY (CATZILLA_ARENA_BLOCK_SIZE - BLOCK_HEADER)
+
+// Requests are reset on the thread that finishes them, which is usually
+// the loop thread that started them, so blocks stay per thread unlocked
+typedef struct {
+    catzilla_arena_block_t* free_blocks[CATZILLA_ARENA_POOL_MAX_RETAINED];
+    int count;
+} arena_block_pool_t;
+
+static CATZILLA_THREAD_LOCAL arena_block_pool_t block_pool;
+
+// Process-wide counters shared by all threads
+static catzilla_atomic_uint64_t stat_resets = 0;
+static catzilla_atomic_uint64_t stat_bytes = 0;
+static catzilla_atomic_uint64_t stat_peak_bytes = 0;
+static catzilla_atomic_uint64_t stat_large_allocations = 0;
+static catzilla_atomic_uint64_t stat_block_hits = 0;
+static catzilla_atomic_uint64_t stat_block_misses = 0;
+static catzilla_atomic_uint64_t stat_retained_bytes = 0;
+
+static catzilla_arena_block_t* block_acquire(void) {
+    if (block_pool.count > 0) {
+        catzilla_atomic_fetch_add(&stat_block_hits, 1);
+        catzilla_atomic_fetch_sub(&stat_retained_bytes, CATZILLA_ARENA_BLOCK_SIZE);
+        return block_pool.free_blocks[--block_pool.count];
+    }
+
+    catzilla_atomic_fetch_add(&stat_block_misses, 1);
+    return catzilla_request_alloc(CATZILLA_ARENA_BLOCK_SIZE);
+}
+
+static void block_release(catzilla_arena_block_t* block) {
+    if (block_pool.count < CATZILLA_ARENA_POOL_MAX_RETAINED) {
+        block_pool.free_blocks[block_pool.count++] = block;
+        catzilla_atomic_fetch_add(&stat_retained_bytes, CATZILLA_ARENA_BLOCK_SIZE);
+        return;
+    }
+    catzilla_request_free(block);
+}
+
+static void* large_alloc(catzilla_request_arena_t* arena, size_t size) {
+    if (size > SIZE_MAX - LARGE_HEADER) return NULL;
+
+    catzilla_arena_large_t* large = catzilla_request_alloc(LARGE_HEADER + size);
+    if (!large) return NULL;
+    large->next = arena->large;
+    arena->large = large;
+    catzilla_atomic_fetch_add(&stat_large_allocations, 1);
+    return (char*)large + LARGE_HEADER;
+}
+
+void* catzilla_arena_alloc(catzilla_request_arena_t* arena, size_t size) {
+    if (!arena) return NULL;
+    if (size == 0) size = 1;
+
+    void* memory;
+    if (size > CATZILLA_ARENA_LARGE_THRESHOLD) {
+        memory = large_alloc(arena, size);
+    } else {
+        size_t rounded = ARENA_ROUND(size);
+        if (!arena->blocks || arena->offset + rounded > BLOCK_CAPACITY) {
+            catzilla_arena_block_t* block = block_acquire();
+            if (!block) return NULL;
+            block->next = arena->blocks;
+            arena->blocks = block;
+            arena->offset = 0;
+        }
+        memory = (char*)arena->blocks + BLOCK_HEADER + arena->offset;
+        arena->offset += rounded;
+    }
+
+    if (memory) arena->bytes += size;
+    return memory;
+}
+
+char* catzilla_arena_strndup(catzilla_request_arena_t* arena, const char* src, size_t length) {
+    if (!src || length == SIZE_MAX) return NULL;
+
+    char* copy = catzilla_arena_alloc(arena, length + 1);
+    if (!copy) return NULL;
+    memcpy(copy, src, length);
+    copy[length] = '\0';
+    return copy;
+}
+
+void catzilla_arena_reset(catzilla_request_arena_t* arena) {
+    if (!arena) return;
+
+    while (arena->blocks) {
+        catzilla_arena_block_t* next = arena->blocks->next;
+        block_release(arena->blocks);
+        arena->blocks = next;
+    }
+    while (arena->large) {
+        catzilla_arena_large_t* next = arena->large->next;
+        catzilla_request_free(arena->large);
+        arena->large = next;
+    }
+
+    if (arena->bytes > 0) {
+        catzilla_atomic_fetch_add(&stat_resets, 1);
+        catzilla_atomic_fetch_add(&stat_bytes, arena->bytes);
+        // Racing resets may lose an update; the peak is only a gauge
+        if (arena->bytes > catzilla_atomic_load(&stat_peak_bytes)) {
+            catzilla_atomic_store(&stat_peak_bytes, arena->bytes);
+        }
+    }
+    arena->offset = 0;
+    arena->bytes = 0;
+}
+
+void catzilla_arena_pool_trim(void) {
+    while (block_pool.count > 0) {
+        catzilla_request_free(block_pool.free_blocks[--block_pool.count]);
+        catzilla_atomic_fetch_sub(&stat_retained_bytes, CATZILLA_ARENA_BLOCK_SIZE);
+    }
+}
+
+void catzilla_arena_get_stats(catzilla_arena_stats_t* stats) {
+    if (!stats) return;
+    memset(stats, 0, sizeof(*stats));
+
+    stats->resets = catzilla_atomic_load(&stat_resets);
+    stats->bytes = catzilla_atomic_load(&stat_bytes);
+    stats->peak_bytes = catzilla_atomic_load(&stat_peak_bytes);
+    stats->large_allocations = catzilla_atomic_load(&stat_large_allocations);
+    stats->block_hits = catzilla_atomic_load(&stat_block_hits);
+    stats->block_misses = catzilla_atomic_load(&stat_block_misses);
+    stats->retained_bytes = catzilla_atomic_load(&stat_retained_bytes);
+    stats->bytes_per_request = stats->resets > 0 ? (double)stats->bytes / (double)stats->resets : 0.0;
+}
@@ -0,0 +1,88 @@
+#ifndef CATZILLA_REQUEST_ARENA_H
+#define CATZILLA_REQUEST_ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Size of every arena block, header included
+#define CATZILLA_ARENA_BLOCK_SIZE (4 * 1024)
+
+// Allocations above this size bypass the blocks and go to the request heap
+#define CATZILLA_ARENA_LARGE_THRESHOLD (1024)
+
+// Free blocks kept per thread before they go back to the allocator
+#define CATZILLA_ARENA_POOL_MAX_RETAINED 64
+
+struct catzilla_arena_block_s;
+struct catzilla_arena_large_s;
+
+/**
+ * Bump allocator for data that lives exactly as long as one request.
+ * Nothing is freed on its own; a reset returns everything at once. A
+ * zeroed arena is empty and ready to use.
+ */
+typedef struct catzilla_request_arena_s {
+    struct catzilla_arena_block_s* blocks;  // Current block first
+    struct catzilla_arena_large_s* large;   // Allocations above the threshold
+    size_t offset;                          // Bump offset in the current block
+    size_t bytes;                           // Bytes handed out since the last reset
+} catzilla_request_arena_t;
+
+/**
+ * Request arena statistics, aggregated over all threads
+ */
+typedef struct {
+    uint64_t resets;               // Arenas reset after handing out memory
+    uint64_t bytes;                // Bytes handed out by those arenas
+    uint64_t peak_bytes;           // Most bytes one arena handed out before a reset
+    uint64_t large_allocations;    // Allocations sent to the request heap
+    uint64_t block_hits;           // Blocks served from a pool freelist
+    uint64_t block_misses;         // Blocks that had to be allocated
+    uint64_t retained_bytes;       // Bytes currently held by pool freelists
+    double bytes_per_request;      // bytes / resets
+} catzilla_arena_stats_t;
+
+/**
+ * Allocate from an arena, aligned for any type
+ * @param arena Request arena
+ * @param size Bytes to allocate
+ * @return Memory valid until the next reset, or NULL on allocation failure
+ */
+void* catzilla_arena_alloc(catzilla_request_arena_t* arena, size_t size);
+
+/**
+ * Copy a string into an arena
+ * @param arena Request arena
+ * @param src Bytes to copy
+ * @param length Number of bytes; a terminator is added
+ * @return Copy valid until the next reset, or NULL on allocation failure
+ */
+char* catzilla_arena_strndup(catzilla_request_arena_t* arena, const char* src, size_t length);
+
+/**
+ * Release everything an arena handed out; blocks go to the calling
+ * thread's pool and the arena is empty again
+ * @param arena Request arena
+ */
+void catzilla_arena_reset(catzilla_request_arena_t* arena);
+
+/**
+ * Free every block retained by the calling thread's pool
+ */
+void catzilla_arena_pool_trim(void);
+
+/**
+ * Get request arena statistics
+ * @param stats Pointer to stats structure to fill
+ */
+void catzilla_arena_get_stats(catzilla_arena_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CATZILLA_REQUEST_ARENA_H
@@ -0,0 +1,427 @@
+#include "request_object.h"
+
+#include <string.h>
+#include <stdint.h>
+
+typedef struct {
+    PyObject_HEAD
+    catzilla_request_t* request;
+    PyObject* client;
+    const catzilla_route_t* route;
+    bool matched;
+    int status_code;
+    long route_id;
+    bool has_allowed_methods;
+    catzilla_route_match_t allowed;  // Methods of a 405; the Allow list is built on first access
+    // Materialised on first access
+    PyObject* headers;
+    PyObject* query_params;
+    PyObject* path_params;
+    PyObject* form;
+} catzilla_request_object_t;
+
+PyObject* catzilla_request_object_new(catzilla_request_t* request,
+                                      PyObject* client,
+                                      const catzilla_route_match_t* match) {
+    catzilla_request_object_t* self = PyObject_New(catzilla_request_object_t, &catzilla_request_object_type);
+    if (!self) {
+        catzilla_request_destroy(request);
+        return NULL;
+    }
+
+    self->request = request;
+    self->client = client;
+    Py_XINCREF(client);
+    // Created while the route is found or held; the object may outlive both
+    self->route = match ? match->route : NULL;
+    catzilla_router_hold_route(self->route);
+    self->matched = self->route != NULL;
+    self->status_code = match ? match->status_code : 404;
+    self->route_id = self->matched ? (long)(uintptr_t)match->route->user_data : 0;
+    self->has_allowed_methods = match && match->has_allowed_methods;
+    if (self->has_allowed_methods) {
+        self->allowed = *match;
+    }
+    self->headers = NULL;
+    self->query_params = NULL;
+    self->path_params = NULL;
+    self->form = NULL;
+    return (PyObject*)self;
+}
+
+static void route_py_cache_free(catzilla_route_py_cache_t* cache) {
+    if (!cache) return;
+    Py_XDECREF(cache->method);
+    Py_XDECREF(cache->path);
+    Py_XDECREF(cache->route_id);
+    Py_XDECREF(cache->route_info);
+    for (int i = 0; i < cache->param_count; i++) {
+        Py_XDECREF(cache->param_names[i]);
+    }
+    Py_XDECREF(cache->uuid_type);
+    PyMem_Free(cache);
+}
+
+int catzilla_route_py_cache_attach(catzilla_route_t* route, PyObject* route_info) {
+    if (!route) {
+        PyErr_SetString(PyExc_ValueError, "Route is NULL");
+        return -1;
+    }
+
+    catzilla_route_py_cache_t* cache = PyMem_Calloc(1, sizeof(catzilla_route_py_cache_t));
+    if (!cache) {
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    cache->method = PyUnicode_InternFromString(route->method);
+    cache->path = PyUnicode_InternFromString(route->path);
+    cache->route_id = PyLong_FromLong((long)(uintptr_t)route->user_data);
+    cache->route_info = route_info ? route_info : Py_None;
+    Py_INCREF(cache->route_info);
+    if (!cache->method || !cache->path || !cache->route_id) {
+        route_py_cache_free(cache);
+        return -1;
+    }
+
+    for (int i = 0; i < route->param_count && i < CATZILLA_MAX_PATH_PARAMS; i++) {
+        cache->param_names[i] = PyUnicode_InternFromString(route->param_names[i]);
+        if (!cache->param_names[i]) {
+            route_py_cache_free(cache);
+            return -1;
+        }
+        cache->param_count++;
+
+        // Resolved once here, so typed uuid parameters cost no import per request
+        if (route->param_constraints && route->param_constraints[i].type == CATZILLA_PARAM_UUID &&
+            !cache->uuid_type) {
+            PyObject* uuid_module = PyImport_ImportModule("uuid");
+            cache->uuid_type = uuid_module ? PyObject_GetAttrString(uuid_module, "UUID") : NULL;
+            Py_XDECREF(uuid_module);
+            if (!cache->uuid_type) {
+                route_py_cache_free(cache);
+                return -1;
+            }
+        }
+    }
+
+    route_py_cache_free(route->py_cache);
+    route->py_cache = cache;
+    return 0;
+}
+
+PyObject* catzilla_path_param_to_python(const catzilla_route_t* route, int index,
+                                        const char* value, size_t length) {
+    if (!route || !route->param_constraints || index < 0 || index >= route->param_count) {
+        return PyUnicode_FromStringAndSize(value, (Py_ssize_t)length);
+    }
+
+    const catzilla_param_constraint_t* constraint = &route->param_constraints[index];
+    if (constraint->type == CATZILLA_PARAM_INT) {
+        // The router accepted the value, so it parses and fits
+        int64_t number = 0;
+        if (catzilla_router_param_accepts(constraint, value, length, &number)) {
+            return PyLong_FromLongLong((long long)number);
+        }
+    } else if (constraint->type == CATZILLA_PARAM_UUID) {
+        const catzilla_route_py_cache_t* cache = route->py_cache;
+        PyObject* uuid_type = cache ? cache->uuid_type : NULL;
+        if (uuid_type) {
+            Py_INCREF(uuid_type);
+        } else {
+            PyObject* uuid_module = PyImport_ImportModule("uuid");
+            uuid_type = uuid_module ? PyObject_GetAttrString(uuid_module, "UUID") : NULL;
+            Py_XDECREF(uuid_module);
+            if (!uuid_type) return NULL;
+        }
+        PyObject* text = PyUnicode_FromStringAndSize(value, (Py_ssize_t)length);
+        PyObject* result = text ? PyObject_CallOneArg(uuid_type, text) : NULL;
+        Py_XDECREF(text);
+        Py_DECREF(uuid_type);
+        return result;
+    }
+    return PyUnicode_FromStringAndSize(value, (Py_ssize_t)length);
+}
+
+void catzilla_route_py_cache_release(catzilla_route_t* route) {
+    if (route && route->py_cache) {
+        route_py_cache_free(route->py_cache);
+        route->py_cache = NULL;
+    }
+}
+
+void catzilla_router_release_py_caches(catzilla_router_t* router) {
+    if (!router || !router->routes) return;
+    for (int i = 0; i < router->route_count; i++) {
+        catzilla_route_py_cache_release(router->routes[i]);
+    }
+    // Removed routes that were still in use keep their cache until now
+    for (catzilla_route_t* route = router->retired_routes; route; route = route->next_retired) {
+        catzilla_route_py_cache_release(route);
+    }
+}
+
+PyObject* catzilla_route_py_method(const catzilla_route_t* route, const char* method) {
+    const catzilla_route_py_cache_t* cache = route ? route->py_cache : NULL;
+    if (cache && strcmp(route->method, method) == 0) {
+        Py_INCREF(cache->method);
+        return cache->method;
+    }
+    return PyUnicode_FromString(method);
+}
+
+catzilla_request_t* catzilla_request_from_object(PyObject* object) {
+    if (!object) return NULL;
+    if (PyObject_TypeCheck(object, &catzilla_request_object_type)) {
+        return ((catzilla_request_object_t*)object)->request;
+    }
+    if (PyCapsule_IsValid(object, "catzilla.request")) {
+        return (catzilla_request_t*)PyCapsule_GetPointer(object, "catzilla.request");
+    }
+    return NULL;
+}
+
+static void request_object_dealloc(catzilla_request_object_t* self) {
+    Py_XDECREF(self->client);
+    Py_XDECREF(self->headers);
+    Py_XDECREF(self->query_params);
+    Py_XDECREF(self->path_params);
+    Py_XDECREF(self->form);
+    catzilla_request_destroy(self->request);
+    catzilla_router_release_route(self->route);
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+// Build a str -> str dict from parallel key/value arrays
+static PyObject* string_pairs_to_dict(char* const* keys, char* const* values, int count) {
+    PyObject* dict = PyDict_New();
+    if (!dict) return NULL;
+
+    for (int i = 0; i < count; i++) {
+        if (!keys[i] || !values[i]) continue;
+        PyObject* value = PyUnicode_FromString(values[i]);
+        if (!value || PyDict_SetItemString(dict, keys[i], value) < 0) {
+            Py_XDECREF(value);
+            Py_DECREF(dict);
+            return NULL;
+        }
+        Py_DECREF(value);
+    }
+    return dict;
+}
+
+static PyObject* request_object_get_method(catzilla_request_object_t* self, void* closure) {
+    (void)closure;
+    return catzilla_route_py_method(self->route, self->request->method);
+}
+
+static PyObject* request_object_get_path(catzilla_request_object_t* self, void* closure) {
+    (void)closure;
+    return PyUnicode_FromString(self->request->path);
+}
+
+static PyObject* request_object_get_client(catzilla_request_object_t* self, void* closure) {
+    (void)closure;
+    PyObject* client = self->client ? self->client : Py_None;
+    Py_INCREF(client);
+    return client;
+}
+
+static PyObject* request_object_get_matched(catzilla_request_object_t* self, void* closure) {
+    (void)closure;
+    return PyBool_FromLong(self->matched);
+}
+
+static PyObject* request_object_get_status_code(catzilla_request_object_t* self, void* closure) {
+    (void)closure;
+    return PyLong_FromLong(self->status_code);
+}
+
+static PyObject* request_object_get_route_id(catzilla_request_object_t* self, void* closure) {
+    (void)closure;
+    if (!self->matched) Py_RETURN_NONE;
+    const catzilla_route_py_cache_t* cache = self->route->py_cache;
+    if (cache) {
+        Py_INCREF(cache->route_id);
+        return cache->route_id;
+    }
+    return PyLong_FromLong(self->route_id);
+}
+
+static PyObject* request_object_get_route(catzilla_request_object_t* self, void* closure) {
+    (void)closure;
+    const catzilla_route_py_cache_t* cache = self->route ? self->route->py_cache : NULL;
+    PyObject* route_info = cache ? cache->route_info : Py_None;
+    Py_INCREF(route_info);
+    return route_info;
+}
+
+static PyObject* request_object_get_route_path(catzilla_request_object_t* self, void* closure) {
+    (void)closure;
+    if (!self->matched) Py_RETURN_NONE;
+    const catzilla_route_py_cache_t* cache = self->route->py_cache;
+    if (cache) {
+        Py_INCREF(cache->path);
+        return cache->path;
+    }
+    return PyUnicode_FromString(self->route->path);
+}
+
+static PyObject* request_object_get_allowed_methods(catzilla_request_object_t* self, void* closure) {
+    (void)closure;
+    if (!self->has_allowed_methods) Py_RETURN_NONE;
+    char allowed[256];
+    catzilla_router_match_allowed_methods(&self->allowed, allowed, sizeof(allowed));
+    return PyUnicode_FromString(allowed);
+}
+
+static PyObject* request_object_get_content_type(catzilla_request_object_t* self, void* closure) {
+    (void)closure;
+    return PyUnicode_FromString(catzilla_get_content_type_str(self->request));
+}
+
+static PyObject* request_object_get_headers(catzilla_request_object_t* self, void* closure) {
+    (void)closure;
+    if (!self->headers) {
+        const catzilla_header_set_t* set = &self->request->headers;
+        PyObject* headers = PyDict_New();
+        if (!headers) return NULL;
+
+        for (int i = 0; i < set->count; i++) {
+            const catzilla_header_t* header = &set->entries[i];
+            const char* name = catzilla_header_name(set, header);
+            char lowered[256];
+            size_t length = header->name_length < sizeof(lowered) - 1 ? header->name_length : sizeof(lowered) - 1;
+            for (size_t j = 0; j < length; j++) {
+                char c = name[j];
+                lowered[j] = (c >= 'A' && c <= 'Z') ? (char)(c + ('a' - 'A')) : c;
+            }
+            lowered[length] = '\0';
+
+            PyObject* value = PyUnicode_FromStringAndSize(catzilla_header_value(set, header),
+                                                          (Py_ssize_t)header->value_length);
+            if (!value || PyDict_SetItemString(headers, lowered, value) < 0) {
+                Py_XDECREF(value);
+                Py_DECREF(headers);
+                return NULL;
+            }
+            Py_DECREF(value);
+        }
+        self->headers = headers;
+    }
+    Py_INCREF(self->headers);
+    return self->headers;
+}
+
+static PyObject* request_object_get_query_params(catzilla_request_object_t* self, void* closure) {
+    (void)closure;
+    if (!self->query_params) {
+        catzilla_parse_query(self->request);
+        self->query_params = string_pairs_to_dict(self->request->query.names,
+                                                  self->request->query.values,
+                                                  self->request->query.count);
+        if (!self->query_params) return NULL;
+    }
+    Py_INCREF(self->query_params);
+    return self->query_params;
+}
+
+static PyObject* request_object_get_path_params(catzilla_request_object_t* self, void* closure) {
+    (void)closure;
+    if (!self->path_params) {
+        const catzilla_route_py_cache_t* cache = self->route ? self->route->py_cache : NULL;
+        PyObject* params = PyDict_New();
+        if (!params) return NULL;
+
+        for (int i = 0; i < self->request->path_param_count; i++) {
+            const catzilla_route_param_slice_t* param = &self->request->path_params[i];
+            PyObject* value = catzilla_path_param_to_python(self->route, i,
+                                                            self->request->path + param->offset,
+                                                            param->length);
+            if (!value) {
+                Py_DECREF(params);
+                return NULL;
+            }
+
+            // Parameter names come from the route, so their keys are prebuilt
+            int rc;
+            if (cache && i < cache->param_count) {
+                rc = PyDict_SetItem(params, cache->param_names[i], value);
+            } else {
+                rc = PyDict_SetItemString(params, self->request->path_param_names[i], value);
+            }
+            Py_DECREF(value);
+            if (rc < 0) {
+                Py_DECREF(params);
+                return NULL;
+            }
+        }
+        self->path_params = params;
+    }
+    Py_INCREF(self->path_params);
+    return self->path_params;
+}
+
+// header(name) - single header lookup without building the headers dict
+static PyObject* request_object_header(catzilla_request_object_t* self, PyObject* args) {
+    const char* name;
+    if (!PyArg_ParseTuple(args, "s", &name))
+        return NULL;
+
+    size_t length = 0;
+    const char* value = catzilla_header_set_get(&self->request->headers, name, &length);
+    if (!value) Py_RETURN_NONE;
+    return PyUnicode_FromStringAndSize(value, (Py_ssize_t)length);
+}
+
+// form() - URL-encoded form fields, parsed on first call
+static PyObject* request_object_form(catzilla_request_object_t* self, PyObject* noargs) {
+    (void)noargs;
+    if (!self->form) {
+        catzilla_request_t* request = self->request;
+        if (request->content_type != CONTENT_TYPE_FORM || catzilla_parse_form(request) != 0) {
+            self->form = PyDict_New();
+        } else {
+            self->form = string_pairs_to_dict(request->form.names, request->form.values,
+                                              request->form.count);
+        }
+        if (!self->form) return NULL;
+    }
+    Py_INCREF(self->form);
+    return self->form;
+}
+
+static PyGetSetDef request_object_getsets[] = {
+    {"method", (getter)request_object_get_method, NULL, "HTTP method", NULL},
+    {"path", (getter)request_object_get_path, NULL, "Request target including the query string", NULL},
+    {"client", (getter)request_object_get_client, NULL, "Client capsule", NULL},
+    {"matched", (getter)request_object_get_matched, NULL, "Whether the router matched a route", NULL},
+    {"status_code", (getter)request_object_get_status_code, NULL, "Router status (200, 404 or 405)", NULL},
+    {"route_id", (getter)request_object_get_route_id, NULL, "Id of the matched route, or None", NULL},
+    {"route", (getter)request_object_get_route, NULL, "Python route object registered with the matched route, or None", NULL},
+    {"route_path", (getter)request_object_get_route_path, NULL, "Path template of the matched route, or None", NULL},
+    {"allowed_methods", (getter)request_object_get_allowed_methods, NULL, "Methods allowed on a 405, or None", NULL},
+    {"content_type", (getter)request_object_get_content_type, NULL, "Body content type", NULL},
+    {"headers", (getter)request_object_get_headers, NULL, "Headers with lowercase names", NULL},
+    {"query_params", (getter)request_object_get_query_params, NULL, "Decoded query parameters", NULL},
+    {"path_params", (getter)request_object_get_path_params, NULL, "Path parameters of the matched route", NULL},
+    {NULL}  // Sentinel
+};
+
+static PyMethodDef request_object_methods[] = {
+    {"header", (PyCFunction)request_object_header, METH_VARARGS, "Get one header by name (any case)"},
+    {"form", (PyCFunction)request_object_form, METH_NOARGS, "URL-encoded form fields"},
+    {NULL}  // Sentinel
+};
+
+PyTypeObject catzilla_request_object_type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "catzilla._catzilla.NativeRequest",
+    .tp_doc = "Request handed to handlers by the C server",
+    .tp_basicsize = sizeof(catzilla_request_object_t),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_dealloc = (destructor)request_object_dealloc,
+    .tp_getset = request_object_getsets,
+    .tp_methods = request_object_methods,
+};
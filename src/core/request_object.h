@@ -0,0 +1,90 @@
+#ifndef CATZILLA_REQUEST_OBJECT_H
+#define CATZILLA_REQUEST_OBJECT_H
+
+#include <Python.h>
+#include "server.h"
+#include "router.h"
+
+// Python view of one request, handed to the request callback in place of a
+// plain capsule plus a route match dict. Headers, query parameters, path
+// parameters, JSON and form data stay in the C request until first accessed
+// from Python; each materialised value is cached on the object.
+
+extern PyTypeObject catzilla_request_object_type;
+
+/**
+ * Python objects that stay constant for a registered route, built once so
+ * dispatch only creates objects for per-request values
+ */
+typedef struct catzilla_route_py_cache_s {
+    PyObject* method;        // Interned route method
+    PyObject* path;          // Interned path template
+    PyObject* route_id;      // User data id as int
+    PyObject* route_info;    // Python-side route object (handler and its metadata)
+    PyObject* param_names[CATZILLA_MAX_PATH_PARAMS];  // Interned parameter names
+    int param_count;
+    PyObject* uuid_type;     // uuid.UUID when a parameter is typed uuid, else NULL
+} catzilla_route_py_cache_t;
+
+/**
+ * Build the Python object cache of a route, replacing any previous one
+ * @param route Registered route
+ * @param route_info Object handed out as the request's route attribute
+ * @return 0 on success, -1 with an exception set
+ */
+int catzilla_route_py_cache_attach(catzilla_route_t* route, PyObject* route_info);
+
+/**
+ * Release the Python object cache of one route. Needs the GIL; installed as
+ * the release_route hook of the server's router.
+ * @param route Route (may be NULL)
+ */
+void catzilla_route_py_cache_release(catzilla_route_t* route);
+
+/**
+ * Release the Python object cache of every route in a router. Needs the GIL;
+ * call before the router is cleaned up.
+ */
+void catzilla_router_release_py_caches(catzilla_router_t* router);
+
+/**
+ * Get a request method as a Python string, reusing the route's interned
+ * method when it is the one requested
+ * @param route Matched route (may be NULL)
+ * @param method Request method
+ * @return New reference, or NULL with an exception set
+ */
+PyObject* catzilla_route_py_method(const catzilla_route_t* route, const char* method);
+
+/**
+ * Convert a path parameter value to the Python type of its route parameter:
+ * int for {name:int}, uuid.UUID for {name:uuid}, str otherwise
+ * @param route Matched route (may be NULL = str)
+ * @param index Parameter index, in path order
+ * @param value Raw value (not NUL-terminated)
+ * @param length Length of the value
+ * @return New reference, or NULL with an exception set
+ */
+PyObject* catzilla_path_param_to_python(const catzilla_route_t* route, int index,
+                                        const char* value, size_t length);
+
+/**
+ * Wrap a request for Python
+ * @param request Request to wrap; ownership moves to the object, and it is
+ *                destroyed right away if the object cannot be created
+ * @param client Client capsule exposed as the client attribute (may be NULL)
+ * @param match Router result for the request (may be NULL = not matched)
+ * @return New reference, or NULL with an exception set
+ */
+PyObject* catzilla_request_object_new(catzilla_request_t* request,
+                                      PyObject* client,
+                                      const catzilla_route_match_t* match);
+
+/**
+ * Get the C request behind a request object or a "catzilla.request" capsule
+ * @param object Request object or capsule
+ * @return Request, or NULL (without an exception) for any other object
+ */
+catzilla_request_t* catzilla_request_from_object(PyObject* object);
+
+#endif // CATZILLA_REQUEST_OBJECT_H
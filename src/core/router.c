@@ -6,71 +6,136 @@
 #include <string.h>
 #include <stdio.h>
 #include <ctype.h>
+#include <errno.h>
 // pthread.h is now included in platform_compat.h
 
 // Project headers
 #include "router.h"
 #include "server.h"
+#include "middleware.h"
 #include "logging.h"
 #include "windows_compat.h"
 #include "memory.h"
+#include "platform_atomic.h"
+
+
+// Arena blocks backing the radix tree; freed together with the router
+#define CATZILLA_ROUTER_ARENA_BLOCK_SIZE (16 * 1024)
+
+typedef struct catzilla_router_arena_block_s {
+    struct catzilla_router_arena_block_s* next;
+    size_t used;
+    size_t size;
+    char data[];
+} catzilla_router_arena_block_t;
+
+// Lookup epochs. A thread reading a shared router (one lookup, or a read
+// section around several and what is done with their routes) publishes the
+// epoch it started in, in its slot, until it is done; a snapshot or route
+// retired in epoch E can go once every busy slot shows a later epoch. A slot
+// is given back when its thread exits. Threads that find every slot taken
+// are counted instead, and nothing is freed while any of them reads.
+static catzilla_atomic_uint64_t catzilla_router_epoch = 1;
+static catzilla_atomic_uint64_t catzilla_router_reader_epochs[CATZILLA_ROUTER_MAX_READERS];  // 0 = idle
+static catzilla_atomic_uint64_t catzilla_router_reader_claimed[CATZILLA_ROUTER_MAX_READERS];
+static catzilla_atomic_uint64_t catzilla_router_unslotted_readers;
+static CATZILLA_THREAD_LOCAL int catzilla_router_reader_slot = -1;  // -2 = none left
+static CATZILLA_THREAD_LOCAL int catzilla_router_read_depth;        // Nested read sections
 
 // Internal helper functions
-static catzilla_route_node_t* catzilla_router_create_node(catzilla_router_t* router);
-static void catzilla_router_free_node(catzilla_router_t* router, catzilla_route_node_t* node);
+static void* catzilla_router_arena_alloc(catzilla_router_snapshot_t* snapshot, size_t size);
+static catzilla_route_node_t* catzilla_router_create_node(catzilla_router_snapshot_t* snapshot,
+                                                          const char* label, size_t label_len);
 static int catzilla_router_split_path(const char* path, char segments[][CATZILLA_PATH_SEGMENT_MAX], int max_segments);
 static bool catzilla_router_is_param_segment(const char* segment);
-static void catzilla_router_extract_param_name(const char* segment, char* param_name);
-static int catzilla_router_add_to_trie(catzilla_router_t* router, catzilla_route_t* route,
-                                       char segments[][CATZILLA_PATH_SEGMENT_MAX], int segment_count);
-static int catzilla_router_match_recursive(catzilla_router_t* router, const char* method,
-                                          char segments[][CATZILLA_PATH_SEGMENT_MAX], int segment_count,
-                                          int current_segment, catzilla_route_node_t* node,
+static catzilla_route_node_t* catzilla_router_find_param_child(const catzilla_route_node_t* node,
+                                                                const catzilla_param_constraint_t* constraint);
+static int catzilla_router_add_to_trie(catzilla_router_snapshot_t* snapshot, catzilla_route_t* route,
+                                       char segments[][CATZILLA_PATH_SEGMENT_MAX], int segment_count,
+                                       bool rebuilding);
+static int catzilla_router_match_node(const catzilla_route_node_t* node, const char* rest,
+                                      catzilla_http_method_t method_id, const char* method,
+                                      catzilla_route_match_t* match);
+static void catzilla_router_build_allowed_methods(const catzilla_route_match_t* match, char* output, size_t output_size);
+static int catzilla_router_static_insert(catzilla_router_snapshot_t* snapshot, const char* path, size_t path_len,
+                                         catzilla_route_node_t* node);
+static int catzilla_router_match_terminal(const catzilla_route_node_t* node,
+                                          catzilla_http_method_t method_id, const char* method,
                                           catzilla_route_match_t* match);
-static void catzilla_router_build_allowed_methods(catzilla_route_node_t* node);
+static void catzilla_router_rebase_params(const char* path, catzilla_route_match_t* match);
+static uint32_t catzilla_router_attach_route(catzilla_router_t* router, catzilla_route_t* route,
+                                             char segments[][CATZILLA_PATH_SEGMENT_MAX], int segment_count);
+
+static const char* const catzilla_router_method_names[CATZILLA_HTTP_METHOD_COUNT] = {
+    "GET", "HEAD", "POST", "PUT", "DELETE", "PATCH", "OPTIONS", "TRACE", "CONNECT"
+};
+
+// Empty lookup tables: just the root, which stands for "/"
+static catzilla_router_snapshot_t* catzilla_router_snapshot_new(void) {
+    catzilla_router_snapshot_t* snapshot = catzilla_cache_alloc(sizeof(catzilla_router_snapshot_t));
+    if (!snapshot) return NULL;
+    memset(snapshot, 0, sizeof(*snapshot));
+
+    snapshot->root = catzilla_router_create_node(snapshot, "", 0);
+    if (!snapshot->root) {
+        catzilla_cache_free(snapshot);
+        return NULL;
+    }
+    return snapshot;
+}
+
+static void catzilla_router_snapshot_free(catzilla_router_snapshot_t* snapshot) {
+    if (!snapshot) return;
+    catzilla_cache_free(snapshot->static_table);
+
+    // Every node, label and child array lives in the arena
+    catzilla_router_arena_block_t* block = snapshot->arena;
+    while (block) {
+        catzilla_router_arena_block_t* next = block->next;
+        catzilla_cache_free(block);
+        block = next;
+    }
+    catzilla_cache_free(snapshot);
+}
+
+static void catzilla_router_free_route(catzilla_route_t* route) {
+    if (!route) return;
+
+    // Free parameter names
+    if (route->param_names) {
+        for (int j = 0; j < route->param_count; j++) {
+            catzilla_cache_free(route->param_names[j]);
+        }
+        catzilla_cache_free(route->param_names);
+    }
+    catzilla_cache_free(route->param_constraints);
+
+    // Free per-route middleware chain
+    if (route->middleware_chain) {
+        catzilla_route_middleware_cleanup(route->middleware_chain);
+        catzilla_cache_free(route->middleware_chain);
+    }
+
+    catzilla_cache_free(route);
+}
 
 int catzilla_router_init(catzilla_router_t* router) {
     if (!router) return -1;
 
     memset(router, 0, sizeof(catzilla_router_t));
+    pthread_mutex_init(&router->write_lock, NULL);
 
-    // Initialize root node using optimized memory allocation
-    router->root = catzilla_cache_alloc(sizeof(catzilla_route_node_t));
-    if (!router->root) return -1;
-    memset(router->root, 0, sizeof(catzilla_route_node_t));
-
-    // Initialize root node arrays
-    router->root->child_capacity = 4;
-    router->root->children = catzilla_cache_alloc(sizeof(catzilla_route_node_t*) * router->root->child_capacity);
-    router->root->child_segments = catzilla_cache_alloc(sizeof(char*) * router->root->child_capacity);
-    router->root->handler_capacity = 4;
-    router->root->handlers = catzilla_cache_alloc(sizeof(catzilla_route_t*) * router->root->handler_capacity);
-    router->root->methods = catzilla_cache_alloc(sizeof(char*) * router->root->handler_capacity);
-
-    if (!router->root->children || !router->root->child_segments ||
-        !router->root->handlers || !router->root->methods) {
-        catzilla_cache_free(router->root->children);
-        catzilla_cache_free(router->root->child_segments);
-        free(router->root->handlers);
-        free(router->root->methods);
-        free(router->root);
+    router->snapshot = catzilla_router_snapshot_new();
+    if (!router->snapshot) {
+        catzilla_router_cleanup(router);
         return -1;
     }
 
-    router->root->child_count = 0;
-    router->root->handler_count = 0;
-    router->root->has_handlers = false;
-    router->root->allowed_methods[0] = '\0';
-
     // Initialize routes array
     router->route_capacity = 64;
     router->routes = catzilla_cache_alloc(sizeof(catzilla_route_t*) * router->route_capacity);
     if (!router->routes) {
-        catzilla_cache_free(router->root->children);
-        catzilla_cache_free(router->root->child_segments);
-        catzilla_cache_free(router->root->handlers);
-        catzilla_cache_free(router->root->methods);
-        catzilla_cache_free(router->root);
+        catzilla_router_cleanup(router);
         return -1;
     }
 
@@ -86,98 +151,65 @@ void catzilla_router_cleanup(catzilla_router_t* router) {
 
     LOG_ROUTER_DEBUG("Starting router cleanup");
 
-    // Free all routes
+    // No lookup may run any more, so every snapshot and route can go
     for (int i = 0; i < router->route_count; i++) {
-        if (router->routes[i]) {
-            // Free parameter names
-            if (router->routes[i]->param_names) {
-                for (int j = 0; j < router->routes[i]->param_count; j++) {
-                    catzilla_cache_free(router->routes[i]->param_names[j]);
-                }
-                catzilla_cache_free(router->routes[i]->param_names);
-            }
-
-            // Free per-route middleware chain
-            if (router->routes[i]->middleware_chain) {
-                catzilla_cache_free(router->routes[i]->middleware_chain->middleware_functions);
-                catzilla_cache_free(router->routes[i]->middleware_chain->middleware_priorities);
-                catzilla_cache_free(router->routes[i]->middleware_chain->middleware_flags);
-                catzilla_cache_free(router->routes[i]->middleware_chain);
-            }
-
-            catzilla_cache_free(router->routes[i]);
-        }
+        catzilla_router_free_route(router->routes[i]);
     }
     catzilla_cache_free(router->routes);
+    while (router->retired_routes) {
+        catzilla_route_t* next = router->retired_routes->next_retired;
+        catzilla_router_free_route(router->retired_routes);
+        router->retired_routes = next;
+    }
 
-    // Free the trie structure (this handles all trie-related memory)
-    if (router->root) {
-        catzilla_router_free_node(router, router->root);
+    catzilla_router_snapshot_free(router->snapshot);
+    while (router->retired) {
+        catzilla_router_snapshot_t* next = router->retired->next_retired;
+        catzilla_router_snapshot_free(router->retired);
+        router->retired = next;
     }
 
+    pthread_mutex_destroy(&router->write_lock);
     memset(router, 0, sizeof(catzilla_router_t));
     LOG_ROUTER_DEBUG("Router cleanup completed");
 }
 
-static catzilla_route_node_t* catzilla_router_create_node(catzilla_router_t* router) {
-    catzilla_route_node_t* node = catzilla_cache_alloc(sizeof(catzilla_route_node_t));
-    if (!node) return NULL;
-
-    memset(node, 0, sizeof(catzilla_route_node_t));
-
-    // Initialize children arrays
-    node->child_capacity = 4;
-    node->children = catzilla_cache_alloc(sizeof(catzilla_route_node_t*) * node->child_capacity);
-    node->child_segments = catzilla_cache_alloc(sizeof(char*) * node->child_capacity);
-
-    // Initialize handlers arrays
-    node->handler_capacity = 4;
-    node->handlers = catzilla_cache_alloc(sizeof(catzilla_route_t*) * node->handler_capacity);
-    node->methods = catzilla_cache_alloc(sizeof(char*) * node->handler_capacity);
-
-    if (!node->children || !node->child_segments || !node->handlers || !node->methods) {
-        catzilla_cache_free(node->children);
-        catzilla_cache_free(node->child_segments);
-        catzilla_cache_free(node->handlers);
-        catzilla_cache_free(node->methods);
-        catzilla_cache_free(node);
-        return NULL;
+// Bump-allocate zeroed memory from a snapshot's arena
+static void* catzilla_router_arena_alloc(catzilla_router_snapshot_t* snapshot, size_t size) {
+    size = (size + 7) & ~(size_t)7;
+
+    catzilla_router_arena_block_t* block = snapshot->arena;
+    if (!block || block->size - block->used < size) {
+        size_t block_size = size > CATZILLA_ROUTER_ARENA_BLOCK_SIZE ? size : CATZILLA_ROUTER_ARENA_BLOCK_SIZE;
+        block = catzilla_cache_alloc(sizeof(catzilla_router_arena_block_t) + block_size);
+        if (!block) return NULL;
+        block->next = snapshot->arena;
+        block->used = 0;
+        block->size = block_size;
+        snapshot->arena = block;
     }
 
-    node->child_count = 0;
-    node->handler_count = 0;
-    node->has_handlers = false;
-    node->allowed_methods[0] = '\0';
-
-    return node;
+    void* ptr = block->data + block->used;
+    block->used += size;
+    memset(ptr, 0, size);
+    return ptr;
 }
 
-static void catzilla_router_free_node(catzilla_router_t* router, catzilla_route_node_t* node) {
-    if (!node) return;
-
-    // Free children recursively
-    for (int i = 0; i < node->child_count; i++) {
-        if (node->children[i]) {
-            catzilla_router_free_node(router, node->children[i]);
-        }
-        catzilla_cache_free(node->child_segments[i]);
-    }
+static catzilla_route_node_t* catzilla_router_create_node(catzilla_router_snapshot_t* snapshot,
+                                                          const char* label, size_t label_len) {
+    if (label_len > UINT16_MAX) return NULL;
 
-    // Free parameter child
-    if (node->param_child) {
-        catzilla_router_free_node(router, node->param_child);
-    }
+    catzilla_route_node_t* node = catzilla_router_arena_alloc(snapshot, sizeof(catzilla_route_node_t));
+    if (!node) return NULL;
 
-    // Free method strings
-    for (int i = 0; i < node->handler_count; i++) {
-        catzilla_cache_free(node->methods[i]);
-    }
+    char* label_copy = catzilla_router_arena_alloc(snapshot, label_len + 1);
+    if (!label_copy) return NULL;
+    memcpy(label_copy, label, label_len);
+    label_copy[label_len] = '\0';
 
-    catzilla_cache_free(node->children);
-    catzilla_cache_free(node->child_segments);
-    catzilla_cache_free(node->handlers);
-    catzilla_cache_free(node->methods);
-    catzilla_cache_free(node);
+    node->label = label_copy;
+    node->label_len = (uint16_t)label_len;
+    return node;
 }
 
 static int catzilla_router_split_path(const char* path, char segments[][CATZILLA_PATH_SEGMENT_MAX], int max_segments) {
@@ -229,51 +261,181 @@ static bool catzilla_router_is_param_segment(const char* segment) {
     return len > 2 && segment[0] == '{' && segment[len-1] == '}';
 }
 
-static void catzilla_router_extract_param_name(const char* segment, char* param_name) {
-    if (!segment || !param_name || !catzilla_router_is_param_segment(segment)) {
-        param_name[0] = '\0';
-        return;
+// Parse an optional int64 bound; an empty one leaves has_value unset
+static int catzilla_router_parse_bound(const char* start, const char* end, bool* has_value, int64_t* value) {
+    while (start < end && *start == ' ') start++;
+    while (end > start && end[-1] == ' ') end--;
+    *has_value = false;
+    if (start == end) return 0;
+
+    char buffer[24];
+    if ((size_t)(end - start) >= sizeof(buffer)) return -1;
+    memcpy(buffer, start, end - start);
+    buffer[end - start] = '\0';
+
+    char* parsed_end = NULL;
+    errno = 0;
+    long long parsed = strtoll(buffer, &parsed_end, 10);
+    if (errno != 0 || *parsed_end != '\0') return -1;
+    *has_value = true;
+    *value = parsed;
+    return 0;
+}
+
+int catzilla_router_parse_param_segment(const char* segment, char* name,
+                                        catzilla_param_constraint_t* constraint) {
+    if (!segment || !name || !constraint || !catzilla_router_is_param_segment(segment)) return -1;
+
+    memset(constraint, 0, sizeof(*constraint));
+    const char* body = segment + 1;
+    const char* end = segment + strlen(segment) - 1;  // Closing brace
+    const char* colon = memchr(body, ':', end - body);
+    const char* name_end = colon ? colon : end;
+
+    size_t name_len = name_end - body;
+    if (name_len == 0 || name_len >= CATZILLA_PARAM_NAME_MAX) return -1;
+    memcpy(name, body, name_len);
+    name[name_len] = '\0';
+    if (!colon) return 0;
+
+    // Type, then optional "(min,max)"
+    const char* type = colon + 1;
+    const char* paren = memchr(type, '(', end - type);
+    size_t type_len = (paren ? paren : end) - type;
+    if (type_len == 3 && strncmp(type, "str", 3) == 0) {
+        constraint->type = CATZILLA_PARAM_STR;
+    } else if (type_len == 3 && strncmp(type, "int", 3) == 0) {
+        constraint->type = CATZILLA_PARAM_INT;
+    } else if (type_len == 4 && strncmp(type, "uuid", 4) == 0) {
+        constraint->type = CATZILLA_PARAM_UUID;
+    } else if (type_len == 4 && strncmp(type, "path", 4) == 0) {
+        constraint->type = CATZILLA_PARAM_PATH;
+    } else {
+        return -1;
+    }
+    if (!paren) return 0;
+
+    const char* close = end - 1;
+    if (close <= paren || *close != ')') return -1;
+    const char* comma = memchr(paren + 1, ',', close - paren - 1);
+    if (!comma) return -1;
+    if (catzilla_router_parse_bound(paren + 1, comma, &constraint->has_min, &constraint->min) != 0 ||
+        catzilla_router_parse_bound(comma + 1, close, &constraint->has_max, &constraint->max) != 0) {
+        return -1;
     }
+    if (constraint->has_min && constraint->has_max && constraint->min > constraint->max) return -1;
+    return 0;
+}
 
-    int len = strlen(segment);
-    strncpy(param_name, segment + 1, len - 2);
-    param_name[len - 2] = '\0';
+static bool catzilla_router_is_hex(char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
 }
 
-static void catzilla_router_build_allowed_methods(catzilla_route_node_t* node) {
-    if (!node) return;
+bool catzilla_router_param_accepts(const catzilla_param_constraint_t* constraint,
+                                   const char* value, size_t length, int64_t* int_value) {
+    if (!constraint || !value || length == 0) return false;
+
+    int64_t measured = (int64_t)length;
+    switch (constraint->type) {
+        case CATZILLA_PARAM_INT: {
+            size_t i = value[0] == '-' ? 1 : 0;
+            if (i == length) return false;
+            uint64_t magnitude = 0;
+            uint64_t limit = i ? (uint64_t)INT64_MAX + 1 : (uint64_t)INT64_MAX;
+            for (; i < length; i++) {
+                if (value[i] < '0' || value[i] > '9') return false;
+                uint64_t digit = (uint64_t)(value[i] - '0');
+                if (magnitude > (limit - digit) / 10) return false;
+                magnitude = magnitude * 10 + digit;
+            }
+            measured = value[0] == '-' ? (int64_t)(0 - magnitude) : (int64_t)magnitude;
+            if (int_value) *int_value = measured;
+            break;
+        }
+        case CATZILLA_PARAM_UUID:
+            if (length != 36) return false;
+            for (size_t i = 0; i < length; i++) {
+                bool dash = i == 8 || i == 13 || i == 18 || i == 23;
+                if (dash ? value[i] != '-' : !catzilla_router_is_hex(value[i])) return false;
+            }
+            break;
+        case CATZILLA_PARAM_STR:
+        case CATZILLA_PARAM_PATH:
+            break;
+    }
 
-    node->allowed_methods[0] = '\0';
-    bool has_get = false;
-    bool has_head = false;
+    if (constraint->has_min && measured < constraint->min) return false;
+    if (constraint->has_max && measured > constraint->max) return false;
+    return true;
+}
 
-    // First pass: build allowed methods and check for GET/HEAD
-    for (int i = 0; i < node->handler_count; i++) {
-        if (i > 0) {
-            strcat(node->allowed_methods, ", ");
-        }
-        strcat(node->allowed_methods, node->methods[i]);
+catzilla_http_method_t catzilla_router_method_id(const char* method) {
+    if (!method) return CATZILLA_HTTP_OTHER;
+
+    switch (method[0]) {
+        case 'G': return strcmp(method, "GET") == 0 ? CATZILLA_HTTP_GET : CATZILLA_HTTP_OTHER;
+        case 'H': return strcmp(method, "HEAD") == 0 ? CATZILLA_HTTP_HEAD : CATZILLA_HTTP_OTHER;
+        case 'P':
+            if (strcmp(method, "POST") == 0) return CATZILLA_HTTP_POST;
+            if (strcmp(method, "PUT") == 0) return CATZILLA_HTTP_PUT;
+            if (strcmp(method, "PATCH") == 0) return CATZILLA_HTTP_PATCH;
+            return CATZILLA_HTTP_OTHER;
+        case 'D': return strcmp(method, "DELETE") == 0 ? CATZILLA_HTTP_DELETE : CATZILLA_HTTP_OTHER;
+        case 'O': return strcmp(method, "OPTIONS") == 0 ? CATZILLA_HTTP_OPTIONS : CATZILLA_HTTP_OTHER;
+        case 'T': return strcmp(method, "TRACE") == 0 ? CATZILLA_HTTP_TRACE : CATZILLA_HTTP_OTHER;
+        case 'C': return strcmp(method, "CONNECT") == 0 ? CATZILLA_HTTP_CONNECT : CATZILLA_HTTP_OTHER;
+        default: return CATZILLA_HTTP_OTHER;
+    }
+}
 
-        if (strcmp(node->methods[i], "GET") == 0) {
-            has_get = true;
-        }
-        if (strcmp(node->methods[i], "HEAD") == 0) {
-            has_head = true;
-        }
+static bool catzilla_router_node_has_handlers(const catzilla_route_node_t* node) {
+    return node->method_mask != 0 || node->other_count > 0;
+}
+
+// Try order of parameter types: those that accept fewer values come first
+static int catzilla_router_param_rank(catzilla_param_type_t type) {
+    switch (type) {
+        case CATZILLA_PARAM_INT: return 0;
+        case CATZILLA_PARAM_UUID: return 1;
+        case CATZILLA_PARAM_STR: return 2;
+        case CATZILLA_PARAM_PATH: return 3;
     }
+    return 2;
+}
 
-    // Auto-HEAD: If we have GET but not explicit HEAD, add HEAD to allowed methods
-    if (has_get && !has_head) {
-        if (node->handler_count > 0) {
-            strcat(node->allowed_methods, ", ");
+static catzilla_route_node_t* catzilla_router_find_param_child(const catzilla_route_node_t* node,
+                                                                const catzilla_param_constraint_t* constraint) {
+    for (catzilla_route_node_t* child = node->param_child; child; child = child->next_param) {
+        const catzilla_param_constraint_t* other = &child->constraint;
+        if (other->type == constraint->type &&
+            other->has_min == constraint->has_min && (!other->has_min || other->min == constraint->min) &&
+            other->has_max == constraint->has_max && (!other->has_max || other->max == constraint->max)) {
+            return child;
         }
-        strcat(node->allowed_methods, "HEAD");
     }
+    return NULL;
+}
 
-    node->has_handlers = (node->handler_count > 0);
+// Comma-separated methods of a 405 match, with the implicit HEAD of a GET
+// route already in the mask
+static void catzilla_router_build_allowed_methods(const catzilla_route_match_t* match, char* output, size_t output_size) {
+    size_t used = 0;
+    output[0] = '\0';
+
+    for (int i = 0; i < CATZILLA_HTTP_METHOD_COUNT + match->allowed_other_count; i++) {
+        const char* name;
+        if (i < CATZILLA_HTTP_METHOD_COUNT) {
+            if (!(match->allowed_mask & (1u << i))) continue;
+            name = catzilla_router_method_names[i];
+        } else {
+            name = match->allowed_other[i - CATZILLA_HTTP_METHOD_COUNT]->method;
+        }
+        int written = snprintf(output + used, output_size - used, "%s%s", used > 0 ? ", " : "", name);
+        if (written < 0 || (size_t)written >= output_size - used) break;
+        used += (size_t)written;
+    }
 
-    // Debug: Print what allowed methods we built
-    LOG_ROUTER_DEBUG("Built allowed methods: '%s' (handler_count=%d)", node->allowed_methods, node->handler_count);
+    LOG_ROUTER_DEBUG("Built allowed methods: '%s'", output);
 }
 
 uint32_t catzilla_router_add_route(catzilla_router_t* router,
@@ -287,6 +449,35 @@ uint32_t catzilla_router_add_route(catzilla_router_t* router,
                                                     user_data, overwrite, NULL, 0, NULL);
 }
 
+int catzilla_router_set_global_middleware(catzilla_router_t* router,
+                                          const catzilla_middleware_chain_t* chain) {
+    if (!router) return -1;
+
+    router->global_middleware = chain;
+    bool has_global = chain && chain->middleware_count > 0;
+
+    for (int i = 0; i < router->route_count; i++) {
+        catzilla_route_t* route = router->routes[i];
+        if (!route->middleware_chain) {
+            if (!has_global) continue;
+            route->middleware_chain = catzilla_cache_alloc(sizeof(catzilla_route_middleware_t));
+            if (!route->middleware_chain ||
+                catzilla_route_middleware_init(route->middleware_chain, 0) != 0) {
+                catzilla_cache_free(route->middleware_chain);
+                route->middleware_chain = NULL;
+                LOG_ROUTER_ERROR("Failed to allocate middleware for route %s %s", route->method, route->path);
+                return -1;
+            }
+        }
+        if (catzilla_route_middleware_compile(route->middleware_chain, chain) != 0) {
+            LOG_ROUTER_ERROR("Failed to compile middleware for route %s %s", route->method, route->path);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
 uint32_t catzilla_router_add_route_with_middleware(catzilla_router_t* router,
                                                    const char* method,
                                                    const char* path,
@@ -340,55 +531,50 @@ uint32_t catzilla_router_add_route_with_middleware(catzilla_router_t* router,
     route->handler = handler;
     route->user_data = user_data;
     route->overwrite = overwrite;
-    route->id = router->next_route_id++;
 
     // Debug: Print what we're storing
-    LOG_ROUTER_DEBUG("Storing route: method='%s', path='%s', id=%u", route->method, route->path, route->id);
+    LOG_ROUTER_DEBUG("Storing route: method='%s', path='%s'", route->method, route->path);
 
-    // Initialize per-route middleware chain
+    // Per-route middleware, flattened with the global chain into one pipeline
     route->middleware_chain = NULL;
-    if (middleware_count > 0 && middleware_functions) {
+    bool has_global = router->global_middleware && router->global_middleware->middleware_count > 0;
+    if ((middleware_count > 0 && middleware_functions) || has_global) {
         route->middleware_chain = catzilla_cache_alloc(sizeof(catzilla_route_middleware_t));
-        if (route->middleware_chain) {
-            route->middleware_chain->middleware_capacity = middleware_count + 4; // Room for growth
-            route->middleware_chain->middleware_functions = catzilla_cache_alloc(
-                sizeof(void*) * route->middleware_chain->middleware_capacity);
-            route->middleware_chain->middleware_priorities = catzilla_cache_alloc(
-                sizeof(uint32_t) * route->middleware_chain->middleware_capacity);
-            route->middleware_chain->middleware_flags = catzilla_cache_alloc(
-                sizeof(uint32_t) * route->middleware_chain->middleware_capacity);
-
-            if (route->middleware_chain->middleware_functions &&
-                route->middleware_chain->middleware_priorities &&
-                route->middleware_chain->middleware_flags) {
-
-                // Copy middleware functions and priorities
-                route->middleware_chain->middleware_count = middleware_count;
-                memcpy(route->middleware_chain->middleware_functions, middleware_functions,
-                       sizeof(void*) * middleware_count);
-
-                if (middleware_priorities) {
-                    memcpy(route->middleware_chain->middleware_priorities, middleware_priorities,
-                           sizeof(uint32_t) * middleware_count);
-                } else {
-                    // Default priorities (1000, 1001, 1002, ...)
-                    for (int i = 0; i < middleware_count; i++) {
-                        route->middleware_chain->middleware_priorities[i] = 1000 + i;
-                    }
-                }
+        int capacity = middleware_functions ? middleware_count : 0;
+        if (!route->middleware_chain ||
+            catzilla_route_middleware_init(route->middleware_chain, capacity) != 0) {
+            LOG_ROUTER_ERROR("Failed to allocate middleware for route %s %s", norm_method, norm_path);
+            catzilla_cache_free(route->middleware_chain);
+            catzilla_cache_free(route);
+            return 0;
+        }
 
-                // Default flags (PRE_ROUTE)
-                for (int i = 0; i < middleware_count; i++) {
-                    route->middleware_chain->middleware_flags[i] = 1; // CATZILLA_MIDDLEWARE_PRE_ROUTE
-                }
-            } else {
-                // Cleanup on allocation failure
-                catzilla_cache_free(route->middleware_chain->middleware_functions);
-                catzilla_cache_free(route->middleware_chain->middleware_priorities);
-                catzilla_cache_free(route->middleware_chain->middleware_flags);
-                catzilla_cache_free(route->middleware_chain);
-                route->middleware_chain = NULL;
+        catzilla_route_middleware_t* chain = route->middleware_chain;
+        for (int i = 0; middleware_functions && i < middleware_count; i++) {
+            // Default priorities (1000, 1001, 1002, ...); middleware runs before the handler
+            chain->entries[i].fn = (catzilla_middleware_fn_t)middleware_functions[i];
+            chain->entries[i].priority = middleware_priorities ? middleware_priorities[i] : 1000 + (uint32_t)i;
+            chain->entries[i].phases = CATZILLA_MIDDLEWARE_PRE_ROUTE;
+            chain->middleware_count++;
+        }
+
+        // Stable sort by priority, keeping registration order on ties
+        for (int i = 1; i < chain->middleware_count; i++) {
+            catzilla_middleware_step_t entry = chain->entries[i];
+            int j = i;
+            while (j > 0 && chain->entries[j - 1].priority > entry.priority) {
+                chain->entries[j] = chain->entries[j - 1];
+                j--;
             }
+            chain->entries[j] = entry;
+        }
+
+        if (catzilla_route_middleware_compile(chain, router->global_middleware) != 0) {
+            LOG_ROUTER_ERROR("Failed to compile middleware for route %s %s", norm_method, norm_path);
+            catzilla_route_middleware_cleanup(chain);
+            catzilla_cache_free(chain);
+            catzilla_cache_free(route);
+            return 0;
         }
     }
 
@@ -402,7 +588,10 @@ uint32_t catzilla_router_add_route_with_middleware(catzilla_router_t* router,
 
     if (route->param_count > 0) {
         route->param_names = catzilla_cache_alloc(sizeof(char*) * route->param_count);
-        if (!route->param_names) {
+        route->param_constraints = catzilla_cache_alloc(sizeof(catzilla_param_constraint_t) * route->param_count);
+        if (!route->param_names || !route->param_constraints) {
+            catzilla_cache_free(route->param_names);
+            catzilla_cache_free(route->param_constraints);
             catzilla_cache_free(route);
             return 0;
         }
@@ -411,15 +600,24 @@ uint32_t catzilla_router_add_route_with_middleware(catzilla_router_t* router,
         for (int i = 0; i < segment_count; i++) {
             if (catzilla_router_is_param_segment(segments[i])) {
                 char param_name[CATZILLA_PARAM_NAME_MAX];
-                catzilla_router_extract_param_name(segments[i], param_name);
+                catzilla_param_constraint_t* constraint = &route->param_constraints[param_idx];
+                bool valid = catzilla_router_parse_param_segment(segments[i], param_name, constraint) == 0;
+                // A path parameter swallows the rest, so nothing may follow it
+                if (valid && constraint->type == CATZILLA_PARAM_PATH && i != segment_count - 1) {
+                    valid = false;
+                }
+                if (!valid) {
+                    LOG_ROUTER_ERROR("Invalid path parameter '%s' in %s", segments[i], norm_path);
+                }
 
-                route->param_names[param_idx] = catzilla_cache_alloc(strlen(param_name) + 1);
+                route->param_names[param_idx] = valid ? catzilla_cache_alloc(strlen(param_name) + 1) : NULL;
                 if (!route->param_names[param_idx]) {
                     // Cleanup on error
                     for (int j = 0; j < param_idx; j++) {
                         catzilla_cache_free(route->param_names[j]);
                     }
                     catzilla_cache_free(route->param_names);
+                    catzilla_cache_free(route->param_constraints);
                     catzilla_cache_free(route);
                     return 0;
                 }
@@ -429,155 +627,541 @@ uint32_t catzilla_router_add_route_with_middleware(catzilla_router_t* router,
         }
     }
 
-    // Add to trie
-    if (catzilla_router_add_to_trie(router, route, segments, segment_count) != 0) {
-        // Cleanup on error
-        if (route->param_names) {
-            for (int i = 0; i < route->param_count; i++) {
-                catzilla_cache_free(route->param_names[i]);
-            }
-            catzilla_cache_free(route->param_names);
-        }
-        catzilla_cache_free(route);
+    pthread_mutex_lock(&router->write_lock);
+    uint32_t route_id = catzilla_router_attach_route(router, route, segments, segment_count);
+    pthread_mutex_unlock(&router->write_lock);
+
+    if (route_id == 0) {
+        catzilla_router_free_route(route);
         return 0;
     }
+    LOG_ROUTER_DEBUG("Route added successfully with ID %u", route_id);
+    return route_id;
+}
 
-    // Add to routes array
+// Append a route to the routes array
+static int catzilla_router_track_route(catzilla_router_t* router, catzilla_route_t* route) {
     if (router->route_count >= router->route_capacity) {
         int new_capacity = router->route_capacity * 2;
         catzilla_route_t** new_routes = catzilla_cache_realloc(router->routes, sizeof(catzilla_route_t*) * new_capacity);
         if (!new_routes) {
             LOG_ROUTER_ERROR("Failed to expand routes array");
-            return route->id; // Route was added to trie, just can't track it
+            return -1;
         }
         router->routes = new_routes;
         router->route_capacity = new_capacity;
     }
 
     router->routes[router->route_count++] = route;
+    return 0;
+}
 
-    LOG_ROUTER_DEBUG("Route added successfully with ID %u", route->id);
-    return route->id;
+// Build lookup tables holding every route in the routes array
+static catzilla_router_snapshot_t* catzilla_router_build_snapshot(catzilla_router_t* router) {
+    catzilla_router_snapshot_t* snapshot = catzilla_router_snapshot_new();
+    if (!snapshot) return NULL;
+
+    char segments[CATZILLA_MAX_PATH_SEGMENTS][CATZILLA_PATH_SEGMENT_MAX];
+    for (int i = 0; i < router->route_count; i++) {
+        catzilla_route_t* route = router->routes[i];
+        int segment_count = catzilla_router_split_path(route->path, segments, CATZILLA_MAX_PATH_SEGMENTS);
+        if (segment_count < 0 ||
+            catzilla_router_add_to_trie(snapshot, route, segments, segment_count, true) != 0) {
+            catzilla_router_snapshot_free(snapshot);
+            return NULL;
+        }
+    }
+    return snapshot;
 }
 
-static int catzilla_router_add_to_trie(catzilla_router_t* router, catzilla_route_t* route,
-                                       char segments[][CATZILLA_PATH_SEGMENT_MAX], int segment_count) {
-    catzilla_route_node_t* current = router->root;
+// Give a thread's slot back; it may still be marked busy if the thread
+// exited inside a read section
+static void catzilla_router_release_slot(int slot) {
+    catzilla_atomic_store_seq(&catzilla_router_reader_epochs[slot], 0);
+    catzilla_atomic_store_seq(&catzilla_router_reader_claimed[slot], 0);
+}
 
-    for (int i = 0; i < segment_count; i++) {
-        bool is_param = catzilla_router_is_param_segment(segments[i]);
+#ifdef _WIN32
+static DWORD catzilla_router_slot_key = FLS_OUT_OF_INDEXES;
+static INIT_ONCE catzilla_router_slot_key_once = INIT_ONCE_STATIC_INIT;
 
-        if (is_param) {
-            // Dynamic parameter segment
-            if (!current->param_child) {
-                current->param_child = catzilla_router_create_node(router);
-                if (!current->param_child) return -1;
+static void WINAPI catzilla_router_on_thread_exit(void* value) {
+    if (value) catzilla_router_release_slot((int)(intptr_t)value - 1);
+}
 
-                catzilla_router_extract_param_name(segments[i], current->param_name);
-            }
-            current = current->param_child;
+static BOOL CALLBACK catzilla_router_create_slot_key(PINIT_ONCE once, void* param, void** context) {
+    (void)once;
+    (void)param;
+    (void)context;
+    catzilla_router_slot_key = FlsAlloc(catzilla_router_on_thread_exit);
+    return TRUE;
+}
+
+// Release the slot when the calling thread exits; kept for good if that
+// cannot be arranged
+static void catzilla_router_release_slot_at_exit(int slot) {
+    InitOnceExecuteOnce(&catzilla_router_slot_key_once, catzilla_router_create_slot_key, NULL, NULL);
+    if (catzilla_router_slot_key != FLS_OUT_OF_INDEXES) {
+        FlsSetValue(catzilla_router_slot_key, (void*)(intptr_t)(slot + 1));
+    }
+}
+#else
+static pthread_key_t catzilla_router_slot_key;
+static bool catzilla_router_slot_key_ready;
+static pthread_once_t catzilla_router_slot_key_once = PTHREAD_ONCE_INIT;
+
+static void catzilla_router_on_thread_exit(void* value) {
+    if (value) catzilla_router_release_slot((int)(intptr_t)value - 1);
+}
+
+static void catzilla_router_create_slot_key(void) {
+    catzilla_router_slot_key_ready = pthread_key_create(&catzilla_router_slot_key,
+                                                        catzilla_router_on_thread_exit) == 0;
+}
+
+// Release the slot when the calling thread exits; kept for good if that
+// cannot be arranged
+static void catzilla_router_release_slot_at_exit(int slot) {
+    pthread_once(&catzilla_router_slot_key_once, catzilla_router_create_slot_key);
+    if (catzilla_router_slot_key_ready) {
+        pthread_setspecific(catzilla_router_slot_key, (void*)(intptr_t)(slot + 1));
+    }
+}
+#endif
+
+// The calling thread's slot, claimed on its first read; -2 when none is free
+static int catzilla_router_claim_slot(void) {
+    if (catzilla_router_reader_slot != -1) return catzilla_router_reader_slot;
+
+    int slot = -2;
+    for (int i = 0; i < CATZILLA_ROUTER_MAX_READERS; i++) {
+        if (catzilla_atomic_load_seq(&catzilla_router_reader_claimed[i]) == 0 &&
+            catzilla_atomic_compare_swap(&catzilla_router_reader_claimed[i], 0, 1)) {
+            slot = i;
+            break;
+        }
+    }
+    if (slot >= 0) catzilla_router_release_slot_at_exit(slot);
+    catzilla_router_reader_slot = slot;
+    return slot;
+}
+
+void catzilla_router_read_begin(void) {
+    if (catzilla_router_read_depth++ > 0) return;
+
+    int slot = catzilla_router_claim_slot();
+    if (slot >= 0) {
+        catzilla_atomic_store_seq(&catzilla_router_reader_epochs[slot],
+                                  catzilla_atomic_load_seq(&catzilla_router_epoch));
+    } else {
+        catzilla_atomic_fetch_add(&catzilla_router_unslotted_readers, 1);
+    }
+}
+
+void catzilla_router_read_end(void) {
+    if (catzilla_router_read_depth <= 0 || --catzilla_router_read_depth > 0) return;
+
+    int slot = catzilla_router_reader_slot;
+    if (slot >= 0) {
+        catzilla_atomic_store_seq(&catzilla_router_reader_epochs[slot], 0);
+    } else {
+        catzilla_atomic_fetch_sub(&catzilla_router_unslotted_readers, 1);
+    }
+}
+
+// A hold changes no field a reader uses, so const routes can be held
+void catzilla_router_hold_route(const catzilla_route_t* route) {
+    if (route) catzilla_atomic_fetch_add(&((catzilla_route_t*)route)->holds, 1);
+}
+
+void catzilla_router_release_route(const catzilla_route_t* route) {
+    if (route) catzilla_atomic_fetch_sub(&((catzilla_route_t*)route)->holds, 1);
+}
+
+// Free the replaced snapshots and removed routes no reader can still use; holds write_lock
+static int catzilla_router_reclaim_locked(catzilla_router_t* router) {
+    uint64_t oldest = UINT64_MAX;
+    if (catzilla_atomic_load_seq(&catzilla_router_unslotted_readers) > 0) {
+        oldest = 0;
+    } else {
+        for (int i = 0; i < CATZILLA_ROUTER_MAX_READERS; i++) {
+            uint64_t epoch = catzilla_atomic_load_seq(&catzilla_router_reader_epochs[i]);
+            if (epoch != 0 && epoch < oldest) oldest = epoch;
+        }
+    }
+
+    int waiting = 0;
+    catzilla_router_snapshot_t** link = &router->retired;
+    while (*link) {
+        catzilla_router_snapshot_t* snapshot = *link;
+        if (snapshot->retired_epoch < oldest) {
+            *link = snapshot->next_retired;
+            catzilla_router_snapshot_free(snapshot);
         } else {
-            // Static segment
-            catzilla_route_node_t* child = NULL;
-
-            // Find existing child
-            for (int j = 0; j < current->child_count; j++) {
-                if (strcmp(current->child_segments[j], segments[i]) == 0) {
-                    child = current->children[j];
-                    break;
-                }
-            }
+            link = &snapshot->next_retired;
+            waiting++;
+        }
+    }
 
-            if (!child) {
-                // Create new child
-                child = catzilla_router_create_node(router);
-                if (!child) return -1;
+    // A hold is taken while its thread still reads, so a route whose epoch
+    // has passed and that shows no hold has none coming
+    catzilla_route_t** route_link = &router->retired_routes;
+    while (*route_link) {
+        catzilla_route_t* route = *route_link;
+        if (route->retired_epoch < oldest && catzilla_atomic_load_seq(&route->holds) == 0) {
+            *route_link = route->next_retired;
+            if (router->release_route) router->release_route(route);
+            catzilla_router_free_route(route);
+        } else {
+            route_link = &route->next_retired;
+            waiting++;
+        }
+    }
+    return waiting;
+}
 
-                // Expand children arrays if needed
-                if (current->child_count >= current->child_capacity) {
-                    int new_capacity = current->child_capacity * 2;
+// Replace the published snapshot with one built from the routes array; holds write_lock
+static int catzilla_router_republish(catzilla_router_t* router) {
+    catzilla_router_snapshot_t* next = catzilla_router_build_snapshot(router);
+    if (!next) return -1;
 
-                    catzilla_route_node_t** new_children = catzilla_cache_realloc(current->children,
-                                                                  sizeof(catzilla_route_node_t*) * new_capacity);
-                    char** new_segments = catzilla_cache_realloc(current->child_segments,
-                                                 sizeof(char*) * new_capacity);
+    catzilla_router_snapshot_t* previous = router->snapshot;
+    catzilla_atomic_store_seq(&router->snapshot, next);
 
-                    if (!new_children || !new_segments) {
-                        catzilla_cache_free(new_children);
-                        catzilla_cache_free(new_segments);
-                        catzilla_router_free_node(router, child);
-                        return -1;
-                    }
+    // Lookups that start from here on see the new snapshot
+    previous->retired_epoch = catzilla_atomic_fetch_add(&catzilla_router_epoch, 1);
+    previous->next_retired = router->retired;
+    router->retired = previous;
+    catzilla_router_reclaim_locked(router);
+    return 0;
+}
 
-                    current->children = new_children;
-                    current->child_segments = new_segments;
-                    current->child_capacity = new_capacity;
-                }
+// Give a new route its ID and enter it into the lookup tables; holds write_lock.
+// Returns the route ID, or 0 if the route was not added.
+static uint32_t catzilla_router_attach_route(catzilla_router_t* router, catzilla_route_t* route,
+                                             char segments[][CATZILLA_PATH_SEGMENT_MAX], int segment_count) {
+    route->id = router->next_route_id++;
 
-                // Add child
-                current->children[current->child_count] = child;
-                current->child_segments[current->child_count] = catzilla_cache_alloc(strlen(segments[i]) + 1);
-                if (!current->child_segments[current->child_count]) {
-                    catzilla_router_free_node(router, child);
-                    return -1;
-                }
-                strcpy(current->child_segments[current->child_count], segments[i]);
-                current->child_count++;
+    if (!router->shared) {
+        if (catzilla_router_add_to_trie(router->snapshot, route, segments, segment_count, false) != 0) {
+            return 0;
+        }
+        if (catzilla_router_track_route(router, route) != 0) {
+            return route->id; // Route was added to trie, just can't track it
+        }
+        return route->id;
+    }
+
+    if (catzilla_router_track_route(router, route) != 0) return 0;
+    if (catzilla_router_republish(router) != 0) {
+        router->route_count--;
+        return 0;
+    }
+    return route->id;
+}
+
+void catzilla_router_share(catzilla_router_t* router) {
+    if (!router) return;
+    pthread_mutex_lock(&router->write_lock);
+    router->shared = true;
+    pthread_mutex_unlock(&router->write_lock);
+}
+
+int catzilla_router_reclaim(catzilla_router_t* router) {
+    if (!router) return 0;
+    pthread_mutex_lock(&router->write_lock);
+    int waiting = catzilla_router_reclaim_locked(router);
+    pthread_mutex_unlock(&router->write_lock);
+    return waiting;
+}
+
+size_t catzilla_router_memory_usage(catzilla_router_t* router) {
+    if (!router) return 0;
+    pthread_mutex_lock(&router->write_lock);
+
+    size_t bytes = sizeof(catzilla_route_t*) * router->route_capacity;
+    catzilla_router_snapshot_t* snapshot = router->snapshot;
+    if (snapshot) {
+        bytes += sizeof(*snapshot) + sizeof(catzilla_router_static_entry_t) * snapshot->static_capacity;
+        for (catzilla_router_arena_block_t* block = snapshot->arena; block; block = block->next) {
+            bytes += sizeof(*block) + block->size;
+        }
+    }
+    for (int i = 0; i < router->route_count; i++) {
+        catzilla_route_t* route = router->routes[i];
+        bytes += sizeof(*route);
+        if (route->param_names) {
+            bytes += (sizeof(char*) + sizeof(catzilla_param_constraint_t)) * route->param_count;
+            for (int j = 0; j < route->param_count; j++) {
+                if (route->param_names[j]) bytes += strlen(route->param_names[j]) + 1;
             }
+        }
+    }
 
-            current = child;
+    pthread_mutex_unlock(&router->write_lock);
+    return bytes;
+}
+
+// Insert a static child, keeping children sorted by the first byte of their label
+static int catzilla_router_insert_child(catzilla_router_snapshot_t* snapshot, catzilla_route_node_t* node,
+                                        catzilla_route_node_t* child) {
+    if (node->child_count == node->child_capacity) {
+        if (node->child_capacity >= UINT16_MAX / 2) return -1;
+        uint16_t capacity = node->child_capacity ? node->child_capacity * 2 : 4;
+        uint8_t* first = catzilla_router_arena_alloc(snapshot, capacity);
+        catzilla_route_node_t** children = catzilla_router_arena_alloc(snapshot, sizeof(*children) * capacity);
+        if (!first || !children) return -1;
+
+        // The old arrays stay in the arena until the router is freed
+        if (node->child_count > 0) {
+            memcpy(first, node->child_first, node->child_count);
+            memcpy(children, node->children, sizeof(*children) * node->child_count);
         }
+        node->child_first = first;
+        node->children = children;
+        node->child_capacity = capacity;
     }
 
-    // Add handler to the final node
-    // Check for existing method
-    for (int i = 0; i < current->handler_count; i++) {
-        if (strcmp(current->methods[i], route->method) == 0) {
-            if (!route->overwrite) {
-                LOG_ROUTER_WARN("Route conflict: %s %s overwrites existing route",
-                       route->method, route->path);
+    uint8_t key = (uint8_t)child->label[0];
+    int position = node->child_count;
+    while (position > 0 && node->child_first[position - 1] > key) {
+        node->child_first[position] = node->child_first[position - 1];
+        node->children[position] = node->children[position - 1];
+        position--;
+    }
+    node->child_first[position] = key;
+    node->children[position] = child;
+    node->child_count++;
+    return 0;
+}
+
+// Length of the first segment of a label or path remainder
+static size_t catzilla_router_segment_len(const char* text, size_t length) {
+    const char* slash = memchr(text, '/', length);
+    return slash ? (size_t)(slash - text) : length;
+}
+
+// Static child whose label starts with the given segment
+static int catzilla_router_find_child(const catzilla_route_node_t* node, const char* segment, size_t segment_len) {
+    uint8_t key = (uint8_t)segment[0];
+    for (int i = 0; i < node->child_count; i++) {
+        if (node->child_first[i] < key) continue;
+        if (node->child_first[i] > key) break;
+
+        const catzilla_route_node_t* child = node->children[i];
+        if (catzilla_router_segment_len(child->label, child->label_len) == segment_len &&
+            memcmp(child->label, segment, segment_len) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// FNV-1a; never 0, which marks an empty slot
+static uint32_t catzilla_router_hash_path(const char* path, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (uint8_t)path[i];
+        hash *= 16777619u;
+    }
+    return hash ? hash : 1;
+}
+
+static const catzilla_route_node_t* catzilla_router_static_lookup(const catzilla_router_snapshot_t* snapshot,
+                                                                  const char* path, size_t length) {
+    if (snapshot->static_count == 0) return NULL;
+
+    uint32_t hash = catzilla_router_hash_path(path, length);
+    uint32_t mask = snapshot->static_capacity - 1;
+    for (uint32_t slot = hash & mask;; slot = (slot + 1) & mask) {
+        const catzilla_router_static_entry_t* entry = &snapshot->static_table[slot];
+        if (entry->hash == 0) return NULL;
+        if (entry->hash == hash && entry->path_len == length &&
+            memcmp(entry->path, path, length) == 0) {
+            return entry->node;
+        }
+    }
+}
+
+static void catzilla_router_static_place(catzilla_router_static_entry_t* table, uint32_t capacity,
+                                         const catzilla_router_static_entry_t* entry) {
+    uint32_t mask = capacity - 1;
+    uint32_t slot = entry->hash & mask;
+    while (table[slot].hash != 0) slot = (slot + 1) & mask;
+    table[slot] = *entry;
+}
+
+// Map a static path to its node; the table doubles to stay at most half full
+static int catzilla_router_static_insert(catzilla_router_snapshot_t* snapshot, const char* path, size_t path_len,
+                                         catzilla_route_node_t* node) {
+    if (catzilla_router_static_lookup(snapshot, path, path_len)) return 0;
+
+    if ((snapshot->static_count + 1) * 2 > snapshot->static_capacity) {
+        uint32_t capacity = snapshot->static_capacity ? snapshot->static_capacity * 2 : 64;
+        catzilla_router_static_entry_t* table = catzilla_cache_alloc(sizeof(*table) * capacity);
+        if (!table) return -1;
+        memset(table, 0, sizeof(*table) * capacity);
+        for (uint32_t i = 0; i < snapshot->static_capacity; i++) {
+            if (snapshot->static_table[i].hash != 0) {
+                catzilla_router_static_place(table, capacity, &snapshot->static_table[i]);
             }
-            // Replace existing handler
-            current->handlers[i] = route;
-            catzilla_router_build_allowed_methods(current);
-            return 0;
         }
+        catzilla_cache_free(snapshot->static_table);
+        snapshot->static_table = table;
+        snapshot->static_capacity = capacity;
     }
 
-    // Expand handlers arrays if needed
-    if (current->handler_count >= current->handler_capacity) {
-        int new_capacity = current->handler_capacity * 2;
+    char* key = catzilla_router_arena_alloc(snapshot, path_len + 1);
+    if (!key) return -1;
+    memcpy(key, path, path_len);
+    key[path_len] = '\0';
+
+    catzilla_router_static_entry_t entry = {
+        catzilla_router_hash_path(path, path_len), (uint16_t)path_len, key, node
+    };
+    catzilla_router_static_place(snapshot->static_table, snapshot->static_capacity, &entry);
+    snapshot->static_count++;
+    return 0;
+}
+
+// Enter a route into a snapshot's tables. A rebuild replays routes that were
+// reported when first added, so it stays quiet about replaced handlers.
+static int catzilla_router_add_to_trie(catzilla_router_snapshot_t* snapshot, catzilla_route_t* route,
+                                       char segments[][CATZILLA_PATH_SEGMENT_MAX], int segment_count,
+                                       bool rebuilding) {
+    catzilla_route_node_t* current = snapshot->root;
+    bool is_static = true;
+    int param_index = 0;
+    int i = 0;
+
+    while (i < segment_count) {
+        if (catzilla_router_is_param_segment(segments[i])) {
+            // Routes share a parameter node when type and bounds agree; names
+            // are per route
+            is_static = false;
+            const catzilla_param_constraint_t* constraint = &route->param_constraints[param_index++];
+            catzilla_route_node_t* child = catzilla_router_find_param_child(current, constraint);
+            if (!child) {
+                child = catzilla_router_create_node(snapshot, "", 0);
+                if (!child) return -1;
+                child->constraint = *constraint;
+
+                // Keep the list ordered by type: narrower types get the first try
+                catzilla_route_node_t** link = &current->param_child;
+                int rank = catzilla_router_param_rank(constraint->type);
+                while (*link && catzilla_router_param_rank((*link)->constraint.type) <= rank) {
+                    link = &(*link)->next_param;
+                }
+                child->next_param = *link;
+                *link = child;
+            }
+            current = child;
+            i++;
+            continue;
+        }
 
-        catzilla_route_t** new_handlers = catzilla_cache_realloc(current->handlers,
-                                                 sizeof(catzilla_route_t*) * new_capacity);
-        char** new_methods = catzilla_cache_realloc(current->methods,
-                                    sizeof(char*) * new_capacity);
+        size_t segment_len = strlen(segments[i]);
+        int index = catzilla_router_find_child(current, segments[i], segment_len);
+        if (index < 0) {
+            // New edge: merge the run of static segments up to the next parameter
+            char label[CATZILLA_PATH_MAX];
+            size_t label_len = 0;
+            while (i < segment_count && !catzilla_router_is_param_segment(segments[i])) {
+                size_t len = strlen(segments[i]);
+                if (label_len + len + 1 >= sizeof(label)) return -1;
+                if (label_len > 0) label[label_len++] = '/';
+                memcpy(label + label_len, segments[i], len);
+                label_len += len;
+                i++;
+            }
 
-        if (!new_handlers || !new_methods) {
-            catzilla_cache_free(new_handlers);
-            catzilla_cache_free(new_methods);
-            return -1;
+            catzilla_route_node_t* child = catzilla_router_create_node(snapshot, label, label_len);
+            if (!child || catzilla_router_insert_child(snapshot, current, child) != 0) return -1;
+            current = child;
+            continue;
+        }
+
+        // Walk the existing edge as far as the route's segments agree with it
+        catzilla_route_node_t* child = current->children[index];
+        size_t offset = 0;
+        while (i < segment_count && offset < child->label_len &&
+               !catzilla_router_is_param_segment(segments[i])) {
+            size_t len = strlen(segments[i]);
+            const char* label_segment = child->label + offset;
+            size_t label_segment_len = catzilla_router_segment_len(label_segment, child->label_len - offset);
+            if (len != label_segment_len || memcmp(label_segment, segments[i], len) != 0) break;
+            offset += len;
+            if (offset < child->label_len) offset++;  // Separator
+            i++;
         }
 
-        current->handlers = new_handlers;
-        current->methods = new_methods;
-        current->handler_capacity = new_capacity;
+        if (offset < child->label_len) {
+            // Split the edge: a new node takes the shared leading segments
+            size_t prefix_len = offset - 1;
+            catzilla_route_node_t* prefix = catzilla_router_create_node(snapshot, child->label, prefix_len);
+            if (!prefix) return -1;
+
+            child->label += offset;
+            child->label_len -= (uint16_t)offset;
+            if (catzilla_router_insert_child(snapshot, prefix, child) != 0) return -1;
+            current->children[index] = prefix;  // Same first segment, same slot
+            child = prefix;
+        }
+        current = child;
     }
 
-    // Add new handler
-    current->handlers[current->handler_count] = route;
-    current->methods[current->handler_count] = catzilla_cache_alloc(strlen(route->method) + 1);
-    if (!current->methods[current->handler_count]) {
-        return -1;
+    // Paths without parameters also go into the static table
+    if (is_static) {
+        char key[CATZILLA_PATH_MAX];
+        size_t key_len = 0;
+        for (int j = 0; j < segment_count; j++) {
+            size_t len = strlen(segments[j]);
+            if (key_len + len + 1 >= sizeof(key)) return -1;
+            if (key_len > 0) key[key_len++] = '/';
+            memcpy(key + key_len, segments[j], len);
+            key_len += len;
+        }
+        if (catzilla_router_static_insert(snapshot, key, key_len, current) != 0) return -1;
     }
-    strcpy(current->methods[current->handler_count], route->method);
-    current->handler_count++;
 
-    // Debug: Print what we stored in trie
-    LOG_ROUTER_DEBUG("Stored in trie: method='%s', path='%s', handler_count=%d",
-                     current->methods[current->handler_count - 1], route->path, current->handler_count);
+    // Add handler to the final node
+    catzilla_http_method_t method_id = catzilla_router_method_id(route->method);
+    catzilla_route_t** slot = NULL;
+    if (method_id != CATZILLA_HTTP_OTHER) {
+        if (current->method_mask & (1u << method_id)) slot = &current->handlers[method_id];
+    } else {
+        for (int j = 0; j < current->other_count; j++) {
+            if (strcmp(current->other_handlers[j]->method, route->method) == 0) {
+                slot = &current->other_handlers[j];
+                break;
+            }
+        }
+    }
 
-    catzilla_router_build_allowed_methods(current);
+    if (slot) {
+        if (!route->overwrite && !rebuilding) {
+            LOG_ROUTER_WARN("Route conflict: %s %s overwrites existing route",
+                   route->method, route->path);
+        }
+        // Replace existing handler
+        *slot = route;
+        return 0;
+    }
+
+    if (method_id != CATZILLA_HTTP_OTHER) {
+        current->handlers[method_id] = route;
+        current->method_mask |= (uint16_t)(1u << method_id);
+    } else {
+        catzilla_route_t** others = catzilla_router_arena_alloc(snapshot, sizeof(*others) * (current->other_count + 1));
+        if (!others) return -1;
+        if (current->other_count > 0) {
+            memcpy(others, current->other_handlers, sizeof(*others) * current->other_count);
+        }
+        others[current->other_count++] = route;
+        current->other_handlers = others;
+    }
+
+    LOG_ROUTER_DEBUG("Stored in tree: method='%s', path='%s'", route->method, route->path);
     return 0;
 }
 
@@ -588,97 +1172,207 @@ int catzilla_router_match(catzilla_router_t* router,
     if (!router || !method || !path || !match) return -1;
 
     // Initialize match result
-    memset(match, 0, sizeof(catzilla_route_match_t));
+    match->route = NULL;
+    match->path = path;
+    match->param_count = 0;
+    match->allowed_mask = 0;
+    match->allowed_other_count = 0;
+    match->has_allowed_methods = false;
     match->status_code = 404; // Default to not found
 
     // Normalize inputs
     char norm_method[CATZILLA_METHOD_MAX];
-    char norm_path[CATZILLA_PATH_MAX];
-
-    if (catzilla_router_normalize_method(method, norm_method, sizeof(norm_method)) != 0 ||
-        catzilla_router_normalize_path(path, norm_path, sizeof(norm_path)) != 0) {
+    if (catzilla_router_normalize_method(method, norm_method, sizeof(norm_method)) != 0) {
         return -1;
     }
 
-    // Split path into segments
-    char segments[CATZILLA_MAX_PATH_SEGMENTS][CATZILLA_PATH_SEGMENT_MAX];
-    int segment_count = catzilla_router_split_path(norm_path, segments, CATZILLA_MAX_PATH_SEGMENTS);
-    if (segment_count < 0) return -1;
-
-    // Match against trie
-    return catzilla_router_match_recursive(router, norm_method, segments, segment_count,
-                                          0, router->root, match);
-}
+    // Collapse repeated slashes and drop the leading and trailing one, so the
+    // remainder reads "seg/seg" like the edge labels
+    char rest[CATZILLA_PATH_MAX];
+    size_t length = 0;
+    size_t skipped = 0;
+    for (const char* p = path; *p; p++) {
+        if (*p == '/' && (length == 0 || rest[length - 1] == '/')) {
+            skipped++;
+            continue;
+        }
+        if (length + 1 >= sizeof(rest)) return -1;
+        rest[length++] = *p;
+    }
+    if (length > 0 && rest[length - 1] == '/') length--;
+    rest[length] = '\0';
+
+    catzilla_http_method_t method_id = catzilla_router_method_id(norm_method);
+
+    // On a shared router the snapshot may be replaced at any time; it stays
+    // allocated while this thread reads
+    bool shared = router->shared;
+    if (shared) catzilla_router_read_begin();
+    const catzilla_router_snapshot_t* snapshot = catzilla_atomic_load_seq(&router->snapshot);
+
+    // Parameters are recorded as offsets into rest while the tree is walked,
+    // then moved onto the caller's path
+    match->path = rest;
+
+    // Static paths: one hash and one compare. The tree would reach the same
+    // node first, since static edges take precedence over parameters.
+    int result;
+    const catzilla_route_node_t* node = catzilla_router_static_lookup(snapshot, rest, length);
+    if (node && catzilla_router_node_has_handlers(node)) {
+        result = catzilla_router_match_terminal(node, method_id, norm_method, match);
+    } else {
+        result = catzilla_router_match_node(snapshot->root, rest, method_id, norm_method, match);
+    }
 
-static int catzilla_router_match_recursive(catzilla_router_t* router, const char* method,
-                                          char segments[][CATZILLA_PATH_SEGMENT_MAX], int segment_count,
-                                          int current_segment, catzilla_route_node_t* node,
-                                          catzilla_route_match_t* match) {
-    if (current_segment == segment_count) {
-        // Reached end of path
-        if (node->has_handlers) {
-            // Check for exact method match
-            for (int i = 0; i < node->handler_count; i++) {
-                if (strcmp(node->methods[i], method) == 0) {
-                    match->route = node->handlers[i];
-                    match->status_code = 200;
-                    return 0; // Successful match
-                }
-            }
+    // Nothing in the match points into the snapshot; the route stays valid
+    // until the caller's own read section ends, if it is in one
+    if (shared) catzilla_router_read_end();
 
-            // Auto-HEAD: If HEAD request didn't find explicit HEAD handler, try GET
-            if (strcmp(method, "HEAD") == 0) {
-                for (int i = 0; i < node->handler_count; i++) {
-                    if (strcmp(node->methods[i], "GET") == 0) {
-                        match->route = node->handlers[i];
-                        match->status_code = 200;
-                        return 0; // Successful HEAD->GET fallback
-                    }
-                }
+    match->path = path;
+    if (match->param_count > 0) {
+        if (skipped == (path[0] == '/' ? 1u : 0u)) {
+            // Only a leading slash was dropped, the usual case
+            for (int i = 0; i < match->param_count; i++) {
+                match->params[i].offset += (uint16_t)skipped;
             }
+        } else {
+            catzilla_router_rebase_params(path, match);
+        }
+    }
+    return result;
+}
 
-            // Path exists but method not allowed
-            strcpy(match->allowed_methods, node->allowed_methods);
-            match->has_allowed_methods = true;
-            match->status_code = 405; // Method not allowed
-            return -1;
+// Map parameter slices in the normalized path back onto the original path,
+// replaying the slash collapsing of catzilla_router_match. A path parameter
+// may span collapsed slashes, so both ends are mapped.
+static void catzilla_router_rebase_params(const char* path, catzilla_route_match_t* match) {
+    size_t normalized = 0;
+    char last = '\0';
+    int next = 0;
+    bool in_value = false;
+    size_t start = 0;
+    for (size_t i = 0; path[i] && next < match->param_count; i++) {
+        if (path[i] == '/' && (normalized == 0 || last == '/')) continue;
+
+        catzilla_route_param_slice_t* param = &match->params[next];
+        if (!in_value && normalized == param->offset) {
+            start = i;
+            in_value = true;
+        }
+        if (in_value && normalized == (size_t)param->offset + param->length - 1) {
+            param->offset = (uint16_t)start;
+            param->length = (uint16_t)(i + 1 - start);
+            in_value = false;
+            next++;
         }
+        last = path[i];
+        normalized++;
+    }
+}
 
-        // Path doesn't exist
+// Pick the handler of a node the whole path matched
+static int catzilla_router_match_terminal(const catzilla_route_node_t* node,
+                                          catzilla_http_method_t method_id, const char* method,
+                                          catzilla_route_match_t* match) {
+    if (!catzilla_router_node_has_handlers(node)) {
         match->status_code = 404;
         return -1;
     }
 
-    const char* current_seg = segments[current_segment];
-
-    // Try static children first
-    for (int i = 0; i < node->child_count; i++) {
-        if (strcmp(node->child_segments[i], current_seg) == 0) {
-            int result = catzilla_router_match_recursive(router, method, segments, segment_count,
-                                                        current_segment + 1, node->children[i], match);
-            if (result == 0 || match->has_allowed_methods) {
-                return result;
+    catzilla_route_t* route = NULL;
+    if (method_id != CATZILLA_HTTP_OTHER) {
+        route = node->handlers[method_id];
+    } else {
+        for (int i = 0; i < node->other_count; i++) {
+            if (strcmp(node->other_handlers[i]->method, method) == 0) {
+                route = node->other_handlers[i];
+                break;
             }
         }
     }
 
-    // Try parameter child
-    if (node->param_child) {
+    // Auto-HEAD: a HEAD request without an explicit HEAD handler uses GET
+    if (!route && method_id == CATZILLA_HTTP_HEAD) {
+        route = node->handlers[CATZILLA_HTTP_GET];
+    }
+
+    if (route) {
+        match->route = route;
+        match->status_code = 200;
+        return 0;
+    }
+
+    // Path exists but method not allowed
+    match->allowed_mask = node->method_mask;
+    if (match->allowed_mask & (1u << CATZILLA_HTTP_GET)) {
+        match->allowed_mask |= 1u << CATZILLA_HTTP_HEAD;
+    }
+    for (int i = 0; i < node->other_count && i < CATZILLA_ROUTER_ALLOWED_OTHER_MAX; i++) {
+        match->allowed_other[match->allowed_other_count++] = node->other_handlers[i];
+    }
+    match->has_allowed_methods = true;
+    match->status_code = 405;
+    return -1;
+}
+
+static int catzilla_router_match_node(const catzilla_route_node_t* node, const char* rest,
+                                      catzilla_http_method_t method_id, const char* method,
+                                      catzilla_route_match_t* match) {
+    if (*rest == '\0') {
+        // Reached end of path
+        return catzilla_router_match_terminal(node, method_id, method, match);
+    }
+
+    // Try static children first; at most one label starts with this segment
+    uint8_t key = (uint8_t)rest[0];
+    int low = 0;
+    int high = node->child_count;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (node->child_first[mid] < key) low = mid + 1; else high = mid;
+    }
+    for (int i = low; i < node->child_count && node->child_first[i] == key; i++) {
+        const catzilla_route_node_t* child = node->children[i];
+        if (strncmp(rest, child->label, child->label_len) != 0) continue;
+
+        char next = rest[child->label_len];
+        if (next != '\0' && next != '/') continue;
+
+        int result = catzilla_router_match_node(child, rest + child->label_len + (next == '/'),
+                                                method_id, method, match);
+        if (result == 0 || match->has_allowed_methods) {
+            return result;
+        }
+        break;
+    }
+
+    // Try parameter children, most specific first; a value a constraint
+    // rejects moves on to the next one
+    const char* end = strchr(rest, '/');
+    size_t segment_length = end ? (size_t)(end - rest) : strlen(rest);
+    for (const catzilla_route_node_t* child = node->param_child; child; child = child->next_param) {
+        bool whole_rest = child->constraint.type == CATZILLA_PARAM_PATH;
+        size_t value_len = whole_rest ? strlen(rest) : segment_length;
+        if (!whole_rest && value_len >= CATZILLA_PATH_SEGMENT_MAX) continue;
+        if (!catzilla_router_param_accepts(&child->constraint, rest, value_len, NULL)) continue;
+
         // Store parameter value
-        if (match->param_count < CATZILLA_MAX_PATH_PARAMS) {
-            strcpy(match->params[match->param_count].name, node->param_name);
-            strcpy(match->params[match->param_count].value, current_seg);
-            match->param_count++;
+        bool stored = match->param_count < CATZILLA_MAX_PATH_PARAMS;
+        if (stored) {
+            catzilla_route_param_slice_t* param = &match->params[match->param_count++];
+            param->offset = (uint16_t)(rest - match->path);
+            param->length = (uint16_t)value_len;
         }
 
-        int result = catzilla_router_match_recursive(router, method, segments, segment_count,
-                                                    current_segment + 1, node->param_child, match);
+        const char* next = rest + value_len;
+        int result = catzilla_router_match_node(child, *next == '/' ? next + 1 : next,
+                                                method_id, method, match);
         if (result == 0 || match->has_allowed_methods) {
             return result;
         }
 
         // Backtrack parameter if no match
-        if (match->param_count > 0) {
+        if (stored) {
             match->param_count--;
         }
     }
@@ -686,24 +1380,62 @@ static int catzilla_router_match_recursive(catzilla_router_t* router, const char
     return -1; // No match found
 }
 
-const char* catzilla_router_get_param(const catzilla_route_match_t* match, const char* param_name) {
-    if (!match || !param_name) return NULL;
+const char* catzilla_router_match_param_name(const catzilla_route_match_t* match, int index) {
+    if (!match || !match->route || index < 0 || index >= match->param_count ||
+        index >= match->route->param_count) {
+        return NULL;
+    }
+    return match->route->param_names[index];
+}
+
+const char* catzilla_router_match_param_value(const catzilla_route_match_t* match, int index,
+                                              size_t* length) {
+    if (!match || !match->path || index < 0 || index >= match->param_count) return NULL;
+    if (length) *length = match->params[index].length;
+    return match->path + match->params[index].offset;
+}
+
+int catzilla_router_match_param_copy(const catzilla_route_match_t* match, int index,
+                                     char* output, size_t output_size) {
+    size_t length = 0;
+    const char* value = catzilla_router_match_param_value(match, index, &length);
+    if (!value || !output || length >= output_size) return -1;
+    memcpy(output, value, length);
+    output[length] = '\0';
+    return (int)length;
+}
+
+size_t catzilla_router_match_allowed_methods(const catzilla_route_match_t* match,
+                                             char* output, size_t output_size) {
+    if (!output || output_size == 0) return 0;
+    output[0] = '\0';
+    if (!match || !match->has_allowed_methods) return 0;
+    catzilla_router_build_allowed_methods(match, output, output_size);
+    return strlen(output);
+}
+
+int catzilla_router_get_param(const catzilla_route_match_t* match, const char* param_name,
+                              char* output, size_t output_size) {
+    if (!match || !param_name) return -1;
 
     for (int i = 0; i < match->param_count; i++) {
-        if (strcmp(match->params[i].name, param_name) == 0) {
-            return match->params[i].value;
+        const char* name = catzilla_router_match_param_name(match, i);
+        if (name && strcmp(name, param_name) == 0) {
+            return catzilla_router_match_param_copy(match, i, output, output_size);
         }
     }
-    return NULL;
+    return -1;
 }
 
 int catzilla_router_get_routes(catzilla_router_t* router, catzilla_route_t** routes, int max_routes) {
     if (!router || !routes || max_routes <= 0) return 0;
 
+    pthread_mutex_lock(&router->write_lock);
     int count = router->route_count < max_routes ? router->route_count : max_routes;
     for (int i = 0; i < count; i++) {
         routes[i] = router->routes[i];
     }
+    pthread_mutex_unlock(&router->write_lock);
 
     return count;
 }
@@ -745,6 +1477,30 @@ int catzilla_router_normalize_path(const char* path, char* output, size_t output
     return 0;
 }
 
+uint32_t catzilla_router_find_route(catzilla_router_t* router, const char* method, const char* path) {
+    if (!router || !method || !path) return 0;
+
+    // Routes are stored normalized
+    char norm_method[CATZILLA_METHOD_MAX];
+    char norm_path[CATZILLA_PATH_MAX];
+    if (catzilla_router_normalize_method(method, norm_method, sizeof(norm_method)) != 0 ||
+        catzilla_router_normalize_path(path, norm_path, sizeof(norm_path)) != 0) {
+        return 0;
+    }
+
+    uint32_t route_id = 0;
+    pthread_mutex_lock(&router->write_lock);
+    for (int i = router->route_count - 1; i >= 0; i--) {
+        catzilla_route_t* route = router->routes[i];
+        if (strcmp(route->method, norm_method) == 0 && strcmp(route->path, norm_path) == 0) {
+            route_id = route->id;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&router->write_lock);
+    return route_id;
+}
+
 bool catzilla_router_has_route(catzilla_router_t* router, const char* method, const char* path) {
     if (!router || !method || !path) return false;
 
@@ -752,13 +1508,71 @@ bool catzilla_router_has_route(catzilla_router_t* router, const char* method, co
     return catzilla_router_match(router, method, path, &match) == 0;
 }
 
+// Clear the handler slot a route occupies, if it still owns it
+static void catzilla_router_unlink_route(catzilla_router_t* router, catzilla_route_t* route) {
+    char segments[CATZILLA_MAX_PATH_SEGMENTS][CATZILLA_PATH_SEGMENT_MAX];
+    int segment_count = catzilla_router_split_path(route->path, segments, CATZILLA_MAX_PATH_SEGMENTS);
+    if (segment_count < 0) return;
+
+    // Follow the route's own pattern: parameters take the parameter child
+    catzilla_route_node_t* node = router->snapshot->root;
+    int i = 0;
+    while (node && i < segment_count) {
+        if (catzilla_router_is_param_segment(segments[i])) {
+            char name[CATZILLA_PARAM_NAME_MAX];
+            catzilla_param_constraint_t constraint;
+            if (catzilla_router_parse_param_segment(segments[i], name, &constraint) != 0) return;
+            node = catzilla_router_find_param_child(node, &constraint);
+            i++;
+            continue;
+        }
+
+        int index = catzilla_router_find_child(node, segments[i], strlen(segments[i]));
+        if (index < 0) return;
+        node = node->children[index];
+
+        // Consume the segments the edge label holds
+        size_t offset = 0;
+        while (offset < node->label_len) {
+            if (i >= segment_count) return;
+            size_t len = strlen(segments[i]);
+            const char* label_segment = node->label + offset;
+            if (catzilla_router_segment_len(label_segment, node->label_len - offset) != len ||
+                memcmp(label_segment, segments[i], len) != 0) return;
+            offset += len + 1;
+            i++;
+        }
+    }
+    if (!node) return;
+
+    catzilla_http_method_t method_id = catzilla_router_method_id(route->method);
+    if (method_id != CATZILLA_HTTP_OTHER) {
+        if (node->handlers[method_id] == route) {
+            node->handlers[method_id] = NULL;
+            node->method_mask &= (uint16_t)~(1u << method_id);
+        }
+        return;
+    }
+    for (int j = 0; j < node->other_count; j++) {
+        if (node->other_handlers[j] == route) {
+            node->other_handlers[j] = node->other_handlers[--node->other_count];
+            return;
+        }
+    }
+}
+
 int catzilla_router_remove_route(catzilla_router_t* router, uint32_t route_id) {
     if (!router || route_id == 0) return -1;
 
+    pthread_mutex_lock(&router->write_lock);
+
     // Find route in array
     for (int i = 0; i < router->route_count; i++) {
         if (router->routes[i] && router->routes[i]->id == route_id) {
             catzilla_route_t* route = router->routes[i];
+            if (!router->shared) {
+                catzilla_router_unlink_route(router, route);
+            }
 
             // Remove from array (shift remaining routes)
             for (int j = i; j < router->route_count - 1; j++) {
@@ -766,31 +1580,33 @@ int catzilla_router_remove_route(catzilla_router_t* router, uint32_t route_id) {
             }
             router->route_count--;
 
-            // Free route memory
-            if (route->param_names) {
-                for (int j = 0; j < route->param_count; j++) {
-                    catzilla_cache_free(route->param_names[j]);
+            if (router->shared) {
+                if (catzilla_router_republish(router) != 0) {
+                    // Put it back at its place; the published tables still hold it
+                    for (int j = router->route_count; j > i; j--) {
+                        router->routes[j] = router->routes[j - 1];
+                    }
+                    router->routes[i] = route;
+                    router->route_count++;
+                    pthread_mutex_unlock(&router->write_lock);
+                    return -1;
                 }
-                catzilla_cache_free(route->param_names);
-            }
-
-            // Free per-route middleware chain
-            if (route->middleware_chain) {
-                catzilla_cache_free(route->middleware_chain->middleware_functions);
-                catzilla_cache_free(route->middleware_chain->middleware_priorities);
-                catzilla_cache_free(route->middleware_chain->middleware_flags);
-                catzilla_cache_free(route->middleware_chain);
+                // In-flight requests may still use the route; it goes once
+                // no reader or hold can
+                route->retired_epoch = catzilla_atomic_fetch_add(&catzilla_router_epoch, 1);
+                route->next_retired = router->retired_routes;
+                router->retired_routes = route;
+                catzilla_router_reclaim_locked(router);
+            } else {
+                // Emptied nodes stay in the tree; they match as 404 like any
+                // node without handlers
+                catzilla_router_free_route(route);
             }
-
-            catzilla_cache_free(route);
-
-            // Note: We don't remove from trie for performance reasons
-            // The trie will still contain the route but it won't be found
-            // during matching since we nullify the reference
-
+            pthread_mutex_unlock(&router->write_lock);
             return 0;
         }
     }
 
+    pthread_mutex_unlock(&router->write_lock);
     return -1; // Route not found
 }
@@ -4,20 +4,25 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include "platform_compat.h"
+#include "platform_atomic.h"
 
 #define CATZILLA_MAX_PATH_SEGMENTS 32
 #define CATZILLA_MAX_PATH_PARAMS 16
-#define CATZILLA_ROUTER_MAX_ROUTES 1000
 #define CATZILLA_PARAM_NAME_MAX 64
 #define CATZILLA_PATH_SEGMENT_MAX 128
 #define CATZILLA_PATH_MAX 256
 #define CATZILLA_METHOD_MAX 32
+#define CATZILLA_ROUTER_ALLOWED_OTHER_MAX 4   // Extension methods kept for one Allow list
+#define CATZILLA_ROUTER_MAX_READERS 128      // Threads with a lock-free lookup slot
 
 // Forward declarations
 typedef struct catzilla_route_s catzilla_route_t;
 typedef struct catzilla_router_s catzilla_router_t;
 typedef struct catzilla_route_node_s catzilla_route_node_t;
 typedef struct catzilla_route_match_s catzilla_route_match_t;
+struct catzilla_middleware_context_s;
+struct catzilla_middleware_chain_s;
 
 /**
  * Route parameter structure for dynamic path segments
@@ -28,53 +33,164 @@ typedef struct catzilla_route_param_s {
 } catzilla_route_param_t;
 
 /**
- * Route match result
+ * Path parameter value as a slice of the matched path; the bytes are left
+ * as they arrived (not percent-decoded, not NUL-terminated)
+ */
+typedef struct catzilla_route_param_slice_s {
+    uint16_t offset;                  // Start of the value in the matched path
+    uint16_t length;                  // Length of the value in bytes
+} catzilla_route_param_slice_t;
+
+/**
+ * Route match result. Parameter values point into the path given to
+ * catzilla_router_match, so the match is only valid while that string is;
+ * parameter names are read from the matched route.
  */
 struct catzilla_route_match_s {
     catzilla_route_t* route;                          // Matched route or NULL
-    catzilla_route_param_t params[CATZILLA_MAX_PATH_PARAMS]; // Path parameters
+    const char* path;                                 // Path the parameter slices point into
+    // Methods of the path on a 405: a bit per catzilla_http_method_t plus the
+    // routes of extension methods, kept apart from the tree so the match
+    // stays valid after the snapshot it came from is replaced
+    const catzilla_route_t* allowed_other[CATZILLA_ROUTER_ALLOWED_OTHER_MAX];
+    catzilla_route_param_slice_t params[CATZILLA_MAX_PATH_PARAMS]; // Path parameters
     int param_count;                                  // Number of path parameters
-    char allowed_methods[256];                        // Comma-separated allowed methods
-    bool has_allowed_methods;                         // Whether path exists but method mismatched
     int status_code;                                  // Suggested HTTP status code
+    uint16_t allowed_mask;
+    uint8_t allowed_other_count;
+    bool has_allowed_methods;                         // Whether path exists but method mismatched
 };
 
 /**
- * Route node in the trie structure
+ * HTTP methods with a handler slot in every route node. Other methods
+ * (extension methods such as PURGE) are kept in a short per-node list.
+ */
+typedef enum {
+    CATZILLA_HTTP_GET = 0,
+    CATZILLA_HTTP_HEAD,
+    CATZILLA_HTTP_POST,
+    CATZILLA_HTTP_PUT,
+    CATZILLA_HTTP_DELETE,
+    CATZILLA_HTTP_PATCH,
+    CATZILLA_HTTP_OPTIONS,
+    CATZILLA_HTTP_TRACE,
+    CATZILLA_HTTP_CONNECT,
+    CATZILLA_HTTP_METHOD_COUNT,
+    CATZILLA_HTTP_OTHER = CATZILLA_HTTP_METHOD_COUNT
+} catzilla_http_method_t;
+
+/**
+ * Type of a path parameter, written as {name:type} in a route path
+ */
+typedef enum {
+    CATZILLA_PARAM_STR = 0,           // Any one segment ({name} or {name:str})
+    CATZILLA_PARAM_INT,               // Decimal integer with optional '-', fits in int64
+    CATZILLA_PARAM_UUID,              // 8-4-4-4-12 hex digits
+    CATZILLA_PARAM_PATH               // Rest of the path, slashes included; last segment only
+} catzilla_param_type_t;
+
+/**
+ * Constraint of a path parameter. Bounds are written after the type, either
+ * side optional: {id:int(1,1000)}, {slug:str(3,)}. They limit the value of an
+ * int and the length of the other types.
+ */
+typedef struct catzilla_param_constraint_s {
+    catzilla_param_type_t type;
+    bool has_min;
+    bool has_max;
+    int64_t min;
+    int64_t max;
+} catzilla_param_constraint_t;
+
+/**
+ * Node of the compressed radix tree. A static edge label holds one or more
+ * '/'-joined path segments: chains of nodes without handlers, parameter child
+ * or siblings are merged into one edge. Nodes, labels and child arrays live in
+ * the router's arena.
  */
 struct catzilla_route_node_s {
-    // Static path segment children
+    const char* label;                // Static segments leading here ("" for the root)
+    uint16_t label_len;
+    uint16_t child_count;
+    uint16_t child_capacity;
+    uint16_t method_mask;             // Bit (1 << catzilla_http_method_t) per handler slot in use
+
+    // Static children, sorted by the first byte of their label; child_first
+    // keeps those bytes next to each other for the lookup
+    uint8_t* child_first;
     struct catzilla_route_node_s** children;
-    char** child_segments;
-    int child_count;
-    int child_capacity;
 
-    // Dynamic parameter child
+    // Parameter children, most specific type first; each is tried in turn
+    // until one accepts the segment and the rest of the path matches
     struct catzilla_route_node_s* param_child;
-    char param_name[CATZILLA_PARAM_NAME_MAX];
-
-    // Route handlers for this node (one per HTTP method)
-    catzilla_route_t** handlers;
-    char** methods;
-    int handler_count;
-    int handler_capacity;
+    struct catzilla_route_node_s* next_param;      // Sibling in the parent's list
+    catzilla_param_constraint_t constraint;         // For parameter nodes
 
-    // All allowed methods for this path (for 405 responses)
-    char allowed_methods[256];
-    bool has_handlers;
+    catzilla_route_t* handlers[CATZILLA_HTTP_METHOD_COUNT];
+    catzilla_route_t** other_handlers;  // Routes of methods outside the enum
+    int other_count;
 };
 
 /**
- * Per-route middleware chain for zero-allocation execution
+ * Slot of the static route table: a path without parameters and the node
+ * holding its handlers
+ */
+typedef struct catzilla_router_static_entry_s {
+    uint32_t hash;                    // 0 = empty slot
+    uint16_t path_len;
+    const char* path;                 // Normalized, without the leading '/'
+    catzilla_route_node_t* node;
+} catzilla_router_static_entry_t;
+
+/**
+ * Middleware function tagged with its priority and the phases it runs in
+ */
+typedef struct catzilla_middleware_step_s {
+    int (*fn)(struct catzilla_middleware_context_s* ctx);
+    uint32_t priority;                // Execution order (lower = earlier)
+    uint32_t phases;                  // CATZILLA_MIDDLEWARE_PRE_ROUTE / POST_ROUTE bits
+} catzilla_middleware_step_t;
+
+/**
+ * Middleware of one route. The route's own middleware is kept in priority
+ * order; at registration it is merged with the router's global middleware
+ * into one flat pipeline, so a request only walks the steps of each phase.
  */
 typedef struct catzilla_route_middleware_s {
-    void** middleware_functions;       // Array of C-compiled middleware functions
-    int middleware_count;             // Number of middleware functions
-    int middleware_capacity;          // Current capacity
-    uint32_t* middleware_priorities;  // Execution priorities (sorted)
-    uint32_t* middleware_flags;       // Per-middleware execution flags
+    catzilla_middleware_step_t* entries;  // The route's own middleware (sorted)
+    int middleware_count;             // Number of entries
+    int middleware_capacity;          // Current capacity of entries
+
+    // Compiled pipeline: pre-route steps, then post-route steps
+    catzilla_middleware_step_t* steps;
+    int pre_count;
+    int post_count;
+    uint32_t phases;                  // Phases with at least one step
+    const struct catzilla_middleware_chain_s* global;  // Merged into steps
 } catzilla_route_middleware_t;
 
+/**
+ * How a route receives its request body
+ */
+typedef enum {
+    CATZILLA_BODY_BUFFERED = 0,   // Whole body collected in memory (default)
+    CATZILLA_BODY_STREAM = 1,     // Chunks handed to the route's chunk handler as they arrive
+    CATZILLA_BODY_SPOOL = 2       // Buffered, spilled to a temp file above a threshold
+} catzilla_body_mode_t;
+
+#define CATZILLA_CACHE_VARY_MAX 8
+
+/**
+ * Response caching of a route. Responses are keyed by method, path and the
+ * selected parts of the request, and served before the GIL is taken.
+ */
+typedef struct catzilla_route_cache_policy_s {
+    uint32_t ttl_seconds;
+    bool vary_query;                  // Query string is part of the key
+    int vary_header_count;
+    char vary_headers[CATZILLA_CACHE_VARY_MAX][CATZILLA_PARAM_NAME_MAX];  // Request headers in the key
+} catzilla_route_cache_policy_t;
+
 /**
  * Route definition
  */
@@ -86,23 +202,92 @@ struct catzilla_route_s {
 
     // Route metadata
     char** param_names;               // Parameter names for dynamic segments
+    catzilla_param_constraint_t* param_constraints;  // Type and bounds of each parameter
     int param_count;                  // Number of parameters
     bool overwrite;                   // Whether this route can overwrite existing ones
     uint32_t id;                      // Unique route ID
 
     // Per-route middleware (NEW!)
     catzilla_route_middleware_t* middleware_chain;  // Per-route middleware
+
+    // Request body handling
+    catzilla_body_mode_t body_mode;
+    uint64_t max_body_size;           // 0 = server default
+    size_t body_spool_threshold;      // 0 = server default (CATZILLA_BODY_SPOOL only)
+    void* body_chunk_handler;         // catzilla_body_chunk_fn (CATZILLA_BODY_STREAM only)
+    void* body_chunk_user_data;
+
+    // Answered in C without entering Python (catzilla_native_route_t, server.c)
+    void* native;
+
+    // Response caching, NULL when the route's responses are not cached
+    catzilla_route_cache_policy_t* cache_policy;
+
+    // Own limits for the rate limit middleware (catzilla_rate_limiter_t,
+    // owned by the caller), NULL to use the default limiter
+    void* rate_limit;
+
+    // Python objects prebuilt at registration (catzilla_route_py_cache_t,
+    // owned and released by the Python binding)
+    void* py_cache;
+
+    // Removal from a shared router; see catzilla_router_s
+    catzilla_route_t* next_retired;
+    uint64_t retired_epoch;           // Lookup epoch when it was removed
+    catzilla_atomic_uint64_t holds;   // catzilla_router_hold_route minus releases
 };
 
 /**
- * Advanced router with trie-based routing
+ * Lookup tables of a router: the radix tree and the static path table.
+ * Lookups only ever read a snapshot. Once the router is shared, a change
+ * builds a new snapshot, publishes it with one pointer store and frees the
+ * old one when no lookup that might still read it is running.
+ */
+typedef struct catzilla_router_snapshot_s {
+    catzilla_route_node_t* root;      // Root of the radix tree
+    struct catzilla_router_arena_block_s* arena;  // Backing memory of every node
+
+    // Paths without parameters, checked before the tree walk (open addressing,
+    // at most half full)
+    catzilla_router_static_entry_t* static_table;
+    uint32_t static_capacity;         // Power of two, 0 = no static routes yet
+    uint32_t static_count;
+
+    uint64_t retired_epoch;           // Lookup epoch when it was replaced
+    struct catzilla_router_snapshot_s* next_retired;
+} catzilla_router_snapshot_t;
+
+/**
+ * Advanced router with radix-tree routing; the number of routes is bounded
+ * only by memory.
+ *
+ * Until catzilla_router_share is called, routes are added to the snapshot in
+ * place and the router belongs to one thread. After it, lookups may run on
+ * any thread without a lock, and route changes are serialised by write_lock
+ * and published as new snapshots. A route removed from a shared router stays
+ * allocated until no read section that might have found it is running and
+ * no hold on it is left, and is freed by a later change or
+ * catzilla_router_reclaim.
  */
 struct catzilla_router_s {
-    catzilla_route_node_t* root;      // Root of the routing trie
+    catzilla_router_snapshot_t* snapshot;  // Published tables (atomic pointer)
     catzilla_route_t** routes;        // Array of all routes for introspection
     int route_count;                  // Number of registered routes
     int route_capacity;               // Current capacity of routes array
     uint32_t next_route_id;           // Next route ID to assign
+
+    bool shared;                      // Lookups may run concurrently with changes
+    pthread_mutex_t write_lock;       // Held by changes and route listing
+    catzilla_router_snapshot_t* retired;      // Replaced, waiting for a grace period
+    catzilla_route_t* retired_routes;         // Removed while shared
+
+    // Called before a removed route is freed, for what a binding attached to
+    // it (NULL = nothing). Runs inside route changes and
+    // catzilla_router_reclaim, so whatever it needs must be held for those.
+    void (*release_route)(catzilla_route_t* route);
+
+    // Merged by priority into every route's middleware pipeline
+    const struct catzilla_middleware_chain_s* global_middleware;
 };
 
 /**
@@ -159,7 +344,20 @@ uint32_t catzilla_router_add_route(catzilla_router_t* router,
                                    bool overwrite);
 
 /**
- * Match a request against registered routes
+ * Set the middleware run for every route and recompile the pipeline of each
+ * route registered so far; routes added later are compiled with it. Call
+ * before the router is shared.
+ * @param router Pointer to router structure
+ * @param chain Global middleware chain, or NULL to remove it
+ * @return 0 on success, -1 on failure
+ */
+int catzilla_router_set_global_middleware(catzilla_router_t* router,
+                                          const struct catzilla_middleware_chain_s* chain);
+
+/**
+ * Match a request against registered routes. On a shared router the matched
+ * route may be removed as soon as this returns; use it inside a read section
+ * (catzilla_router_read_begin) or hold it.
  * @param router Pointer to router structure
  * @param method HTTP method
  * @param path Request path
@@ -171,6 +369,60 @@ int catzilla_router_match(catzilla_router_t* router,
                          const char* path,
                          catzilla_route_match_t* match);
 
+/**
+ * Let lookups run on other threads while routes change. From here on every
+ * add or remove rebuilds the lookup tables and publishes them atomically.
+ * Call on the owning thread before lookups start elsewhere.
+ * @param router Pointer to router structure
+ */
+void catzilla_router_share(catzilla_router_t* router);
+
+/**
+ * Free replaced snapshots and removed routes that no reader can still use.
+ * Changes do this on their own; call it to reclaim memory when changes stop.
+ * @param router Pointer to router structure
+ * @return Number of snapshots and routes still waiting
+ */
+int catzilla_router_reclaim(catzilla_router_t* router);
+
+/**
+ * Start a read section on the calling thread: routes found by lookups on a
+ * shared router stay allocated until the section ends, even if they are
+ * removed meanwhile. Sections nest, and must end on the thread that began
+ * them. Route changes made inside one do not block, but what they retire
+ * waits for the section.
+ */
+void catzilla_router_read_begin(void);
+
+/**
+ * End the calling thread's innermost read section
+ */
+void catzilla_router_read_end(void);
+
+/**
+ * Keep a route allocated past the read section it was found in, for work
+ * that finishes later or on another thread. Call inside that read section,
+ * or while already holding the route.
+ * @param route Route from a lookup (NULL is ignored)
+ */
+void catzilla_router_hold_route(const catzilla_route_t* route);
+
+/**
+ * Drop a hold; a removed route is freed by a later change or
+ * catzilla_router_reclaim once no hold is left. Any thread may call this.
+ * @param route Held route (NULL is ignored)
+ */
+void catzilla_router_release_route(const catzilla_route_t* route);
+
+/**
+ * Bytes held by the router for routing: the published snapshot (tree arena
+ * and static table), the routes array and each route with its parameter
+ * metadata. Middleware chains and binding caches are not counted.
+ * @param router Pointer to router structure
+ * @return Bytes allocated, 0 for NULL
+ */
+size_t catzilla_router_memory_usage(catzilla_router_t* router);
+
 /**
  * Get all registered routes for introspection
  * @param router Pointer to router structure
@@ -190,6 +442,15 @@ int catzilla_router_get_routes(catzilla_router_t* router,
  */
 int catzilla_router_remove_route(catzilla_router_t* router, uint32_t route_id);
 
+/**
+ * Find the route registered for a method and path pattern
+ * @param router Pointer to router structure
+ * @param method HTTP method
+ * @param path Path pattern as registered (e.g. "/users/{id:int}")
+ * @return ID of the latest such route, or 0 if there is none
+ */
+uint32_t catzilla_router_find_route(catzilla_router_t* router, const char* method, const char* path);
+
 /**
  * Check if a route exists for the given method and path
  * @param router Pointer to router structure
@@ -215,13 +476,85 @@ int catzilla_router_parse_params(const char* path_pattern,
                                 int max_params);
 
 /**
- * Get a route parameter value by name
+ * Copy a route parameter value by name
  * @param match Route match result
  * @param param_name Parameter name
- * @return Parameter value or NULL if not found
+ * @param output Output buffer for the NUL-terminated value
+ * @param output_size Size of the output buffer
+ * @return Length of the value, or -1 if not found or it does not fit
+ */
+int catzilla_router_get_param(const catzilla_route_match_t* match,
+                              const char* param_name,
+                              char* output,
+                              size_t output_size);
+
+/**
+ * Get the name of a path parameter of a match
+ * @param match Route match result
+ * @param index Parameter index, in path order
+ * @return Name from the matched route, or NULL if out of range
+ */
+const char* catzilla_router_match_param_name(const catzilla_route_match_t* match, int index);
+
+/**
+ * Get the raw value of a path parameter of a match, without copying it
+ * @param match Route match result
+ * @param index Parameter index, in path order
+ * @param length Output for the value length
+ * @return Start of the value in the matched path (not NUL-terminated), or
+ *         NULL if out of range
+ */
+const char* catzilla_router_match_param_value(const catzilla_route_match_t* match, int index,
+                                              size_t* length);
+
+/**
+ * Copy a path parameter value of a match into a NUL-terminated buffer
+ * @param match Route match result
+ * @param index Parameter index, in path order
+ * @param output Output buffer
+ * @param output_size Size of the output buffer
+ * @return Length of the value, or -1 if out of range or it does not fit
+ */
+int catzilla_router_match_param_copy(const catzilla_route_match_t* match, int index,
+                                     char* output, size_t output_size);
+
+/**
+ * Write the methods allowed on the path of a 405 match, comma-separated
+ * @param match Route match result
+ * @param output Output buffer
+ * @param output_size Size of the output buffer
+ * @return Length written, or 0 when the match carries no allowed methods
+ */
+size_t catzilla_router_match_allowed_methods(const catzilla_route_match_t* match,
+                                             char* output, size_t output_size);
+
+/**
+ * Parse a path parameter segment such as "{id}" or "{id:int(1,100)}"
+ * @param segment Path segment, braces included
+ * @param name Output for the parameter name (CATZILLA_PARAM_NAME_MAX bytes)
+ * @param constraint Output for the type and bounds
+ * @return 0 on success, -1 if the segment is not a valid parameter
+ */
+int catzilla_router_parse_param_segment(const char* segment, char* name,
+                                        catzilla_param_constraint_t* constraint);
+
+/**
+ * Check a raw parameter value against a constraint
+ * @param constraint Parameter constraint
+ * @param value Start of the value (not NUL-terminated)
+ * @param length Length of the value
+ * @param int_value Output for the parsed integer of an int parameter (may be NULL)
+ * @return true if the value is accepted
+ */
+bool catzilla_router_param_accepts(const catzilla_param_constraint_t* constraint,
+                                   const char* value, size_t length, int64_t* int_value);
+
+/**
+ * Map an HTTP method to its handler slot
+ * @param method Uppercase method name
+ * @return Slot of the method, or CATZILLA_HTTP_OTHER for any other method
  */
-const char* catzilla_router_get_param(const catzilla_route_match_t* match,
-                                     const char* param_name);
+catzilla_http_method_t catzilla_router_method_id(const char* method);
 
 /**
  * Normalize HTTP method (uppercase)
@@ -9,6 +9,12 @@
 #endif
 #include <stdio.h>
 #include <signal.h>
+#include <time.h>
+#ifndef _WIN32
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#endif
 
 // Project headers
 #include "server.h"
@@ -19,19 +25,89 @@
 #include "windows_compat.h"
 #include "memory.h"
 #include "upload_parser.h"
+#include "upload_stream_buffer.h"
 #include "streaming.h"
+#include "http_response.h"
+#include "read_buffer_pool.h"
+#include "http2.h"
+#include "tls.h"
+#include "timer_wheel.h"
+#include "request_object.h"
+#include "cache_engine.h"
+#include "http_cache.h"
+#include "disk_cache.h"
+#include "redis_client.h"
+#include "clamd_client.h"
+#include "sse_hub.h"
+#include "platform_atomic.h"
+#include "compression.h"
+#include "metrics.h"
+#include "probes.h"
+#include "handoff.h"
 
 // Python headers (after system headers to avoid conflicts)
 #include <Python.h>
 #include <yyjson.h>
 
-typedef struct {
+// Bodies at least this large are written from the caller's buffer instead of
+// being copied next to the headers
+#define CATZILLA_ZEROCOPY_MIN_BODY 4096
+
+// Response header lines carried over into one HTTP/2 HEADERS frame
+#define CATZILLA_H2_MAX_RESPONSE_HEADERS 32
+
+typedef struct write_req_s {
     uv_write_t req;
-    uv_buf_t buf;
+    uv_buf_t bufs[2];         // [0] header block (plus copied small body), [1] pinned body
+    unsigned int nbufs;
+    catzilla_body_release_fn body_release;  // Unpins bufs[1] after the write completes
+    void* body_owner;
     bool keep_alive;  // Track if connection should be kept alive
+    bool completes_deferred;  // Response to a deferred request; resumes parsing once written
+    struct write_req_s* next; // Link in the per-connection cork queue
+    catzilla_latency_sample_t latency;  // Request timed up to its write phase (route NULL = none)
 } write_req_t;
 
+// Several corked responses flushed with one vectored uv_write
+typedef struct {
+    uv_write_t req;
+    write_req_t* head;
+    unsigned int nbufs;
+    uv_buf_t bufs[];
+} write_batch_t;
+
+// Ciphertext written on behalf of a caller's uv_write_t; the caller's callback
+// runs with its own request once the ciphertext is out
 typedef struct {
+    uv_write_t req;
+    uv_write_t* user_req;  // NULL for handshake records
+    uv_write_cb user_cb;
+    uv_buf_t buf;
+} tls_write_t;
+
+// Where a connection is between requests; selects which timeout applies
+typedef enum {
+    CONN_PHASE_AWAITING,   // Accepted, no request bytes yet
+    CONN_PHASE_HEADERS,    // Reading request headers
+    CONN_PHASE_BODY,       // Reading a request body
+    CONN_PHASE_HANDLER,    // Request dispatched; the handler has no deadline
+    CONN_PHASE_IDLE,       // Keep-alive between requests
+    CONN_PHASE_STREAMING,  // A streaming response owns the socket
+    CONN_PHASE_WEBSOCKET   // Upgraded; frames are parsed by the WebSocket session
+} conn_phase_t;
+
+typedef enum {
+    CONN_TIMEOUT_NONE,
+    CONN_TIMEOUT_HEADER,
+    CONN_TIMEOUT_BODY,
+    CONN_TIMEOUT_KEEPALIVE,
+    CONN_TIMEOUT_WRITE,
+    CONN_TIMEOUT_WS_PING,   // WebSocket idle long enough to ping
+    CONN_TIMEOUT_WS_PONG,   // Ping sent; the peer must answer
+    CONN_TIMEOUT_WS_CLOSE   // Closing handshake started; the peer must answer
+} conn_timeout_kind_t;
+
+typedef struct client_context_s {
     llhttp_t parser;
     uv_tcp_t client;
     catzilla_server_t* server;
@@ -41,35 +117,149 @@ typedef struct {
     size_t body_length;
     size_t body_size;
     content_type_t content_type;  // Keep this aligned with 4-byte boundary
-    char* content_type_header;  // Store full Content-Type header value
-    bool parsing_content_type;
     bool keep_alive;  // Track if client wants keep-alive
-    bool parsing_connection;  // Track if we're parsing Connection header
     bool has_connection_header;  // Track if Connection header was sent
     bool read_paused;  // Track paused reads for deferred async responses
     bool deferred_response_pending;  // Track a deferred response using this request state
-    // Header storage for all headers
-    catzilla_header_t headers[CATZILLA_MAX_HEADERS];
-    int header_count;
-    char* current_header_name;  // Buffer for header name being parsed
-    size_t current_header_name_len;
+    // Request body policy, resolved from the matched route when headers complete
+    catzilla_body_mode_t body_mode;
+    uint64_t body_limit;  // 0 = unlimited
+    uint64_t body_received;
+    uint64_t expected_body_length;  // Content-Length, 0 when unknown
+    size_t body_spool_threshold;
+    catzilla_body_chunk_fn body_chunk_handler;
+    void* body_chunk_user_data;
+    bool body_rejected;  // 413 sent; the connection closes once it is written
+    bool body_paused;  // Stream handler asked for backpressure
+    bool spooling;
+    int spool_fd;
+    upload_stream_buffer_t* spool_buffer;
+    char spool_path[64];
+    // multipart/form-data on buffered routes is parsed as it arrives instead
+    // of being buffered; files past the spool threshold go to temp files
+    multipart_parser_t* multipart;
+    // Virus scans of the body's file parts, streamed to clamd while they
+    // arrive; a complete request waits, parsed and paused, until all answered
+    struct upload_scan_s* upload_scans;
+    bool upload_scan_wait;
+    // All headers of the current request live in one data block that the
+    // connection keeps across requests; entries are (offset, length) slices
+    catzilla_header_set_t headers;
+    char remote_addr[INET6_ADDRSTRLEN];  // Peer IP, filled once on accept
+    // HTTP/1.1 pipelining: responses produced while parsing one read are corked
+    // and flushed together; a deferred response pauses the parser and keeps the
+    // unparsed remainder of the read until it has been written. A Python batch
+    // keeps its connections corked until the batch ends (batch_cork_next).
+    bool corked;
+    bool batch_corked;
+    struct client_context_s* batch_cork_next;
+    write_req_t* cork_head;
+    write_req_t* cork_tail;
+    unsigned int cork_nbufs;
+    char* pending_input;
+    size_t pending_input_len;
+    // Reads use pooled slabs; once a keep-alive socket's reads are small it
+    // switches to its own small sticky buffer instead of pinning a slab
+    char* sticky_buffer;
+    bool sticky_in_use;
+    bool prefer_sticky_buffer;
+    // HTTP/2 connections hand every parsed stream to the same dispatch path as
+    // HTTP/1.1; h2_stream_id names the stream the current response belongs to
+    bool protocol_detected;
+    bool h2_goaway_queued;
+    catzilla_h2_session_t* h2;
+    uint32_t h2_stream_id;
+    // One timer wheel entry per connection, re-armed as the phase changes
+    catzilla_timer_entry_t timeout_entry;
+    conn_phase_t phase;
+    conn_timeout_kind_t timeout_kind;
+    unsigned int writes_in_flight;  // uv_write requests not yet completed
+    // TLS connections decrypt reads into the parser and encrypt writes until
+    // the kernel takes over sending (kTLS)
+    catzilla_tls_session_t* tls;
+    bool tls_established;
+    // Set on a response cache miss; the handler's response is stored under it
+    char* response_cache_key;
+    uint32_t response_cache_ttl;
+    // Redis lookup for a local response cache miss; the request is parsed and
+    // paused like a queued one until it answers
+    struct response_cache_lookup_s* cache_lookup;
+    // Set while the connection's event-stream response follows an SSE hub
+    catzilla_sse_subscriber_t* sse_subscriber;
+    // Upgraded connections: the session parses frames, websocket_handle is
+    // what the open hook returned
+    catzilla_ws_session_t* websocket;
+    void* websocket_handle;
+    bool websocket_close_queued;  // The final close frame closes the socket once written
+    // Completed request waiting for the loop's next Python batch; the parser
+    // stays paused and later input is kept in pending_input until it ran
+    bool dispatch_queued;
+    catzilla_route_match_t* dispatch_match;  // Kept across requests once allocated
+    catzilla_route_t* dispatch_route;  // Hold on dispatch_match's route, released with the context
+    struct client_context_s* dispatch_next;
+    // Latency of the current request until its response is queued, when
+    // the server records route histograms; the write request carries it on
+    catzilla_latency_sample_t latency;
+    // Access log: start of the current request and the route it matched;
+    // pending until its response is queued
+    uint64_t access_started_ns;
+    uint32_t access_route_id;
+    bool access_pending;
+    // Link in the accepting loop's list of open connections, which a drain
+    // after a listener handoff walks
+    struct client_context_s* loop_next;
+    struct client_context_s** loop_pprev;
+    struct client_context_s* next_free;  // Link in the per-loop context pool
     char _padding[0];  // Add padding to ensure proper alignment
 } client_context_t;
 
+#if !defined(_WIN32) && defined(SO_REUSEPORT)
+#define CATZILLA_HAS_REUSEPORT 1
+#endif
+
+// One extra event loop in SO_REUSEPORT worker mode. The main loop (server->loop)
+// keeps the signal handlers; each worker runs its own listener on its own thread.
+typedef struct catzilla_server_worker_s {
+    catzilla_server_t* server;
+    int index;
+    uv_loop_t loop;
+    uv_tcp_t listener;
+    uv_async_t stop_async;   // Wakes the worker loop from catzilla_server_stop
+    uv_timer_t date_timer;   // Refreshes this thread's cached Date header
+    uv_timer_t timeout_timer;  // Ticks this loop's connection timer wheel
+    uv_thread_t thread;
+    bool loop_initialized;
+    bool thread_started;
+} catzilla_server_worker_t;
+
+// Loop driving the current thread, used by code that must stay on the owning loop
+static CATZILLA_THREAD_LOCAL uv_loop_t* current_loop = NULL;
+
 // Forward declarations
 static void on_connection(uv_stream_t* server, int status);
 static void alloc_buffer(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf);
 static void on_read(uv_stream_t* client, ssize_t nread, const uv_buf_t* buf);
 static void on_close(uv_handle_t* handle);
 static void after_write(uv_write_t* req, int status);
+static void after_batch_write(uv_write_t* req, int status);
+static void flush_corked_writes(client_context_t* ctx);
+static void resume_deferred_client(client_context_t* ctx);
+static void submit_write_req(client_context_t* context, uv_stream_t* client, write_req_t* req);
+static void release_write_req(write_req_t* wr);
+static void send_http2_response(client_context_t* context, int status_code, const char* headers, const char* body, size_t body_len);
+static void discard_request_body(client_context_t* context);
+static void cancel_upload_scans(client_context_t* ctx);
+static void resume_after_upload_scans(client_context_t* ctx);
+static int route_request(client_context_t* context);
+static int answer_request(client_context_t* context);
 static void signal_handler(uv_signal_t* handle, int signum);
+static void update_connection_timer(client_context_t* ctx, bool progress);
+static void accept_client(uv_stream_t* listener);
 static int on_message_complete(llhttp_t* parser);
 static void send_response_with_connection(uv_stream_t* client, int status_code, const char* headers, const char* body, size_t body_len, bool keep_alive);
-static void request_capsule_destructor(PyObject* capsule);
+static void send_response_buffers(uv_stream_t* client, int status_code, const char* headers, const char* body, size_t body_len, bool keep_alive, catzilla_body_release_fn release, void* owner);
 int parse_query_params(catzilla_request_t* request, const char* query_string);
-void url_decode(const char* src, char* dst);
-static void url_decode_segment(const char* src, size_t length, char* dst);
-static PyObject* create_python_route_match_info(const catzilla_route_match_t* match, int match_result);
+static void populate_path_params(catzilla_request_t* request, const catzilla_route_match_t* match);
 
 // Add a new function to get client context from client handle
 static client_context_t* get_client_context(uv_stream_t* client) {
@@ -103,1546 +293,5448 @@ static bool headers_include_field(const char* headers, const char* field_name) {
     return false;
 }
 
-static void reset_client_request_state(client_context_t* context) {
-    if (!context) {
-        return;
-    }
+// Value of a field in a formatted header block, without leading whitespace
+static const char* headers_field_value(const char* headers, const char* field_name, size_t* length_out) {
+    size_t field_name_len = strlen(field_name);
+    const char* cursor = headers;
 
-    if (context->current_header_name) {
-        catzilla_cache_free(context->current_header_name);
-        context->current_header_name = NULL;
-    }
-    context->current_header_name_len = 0;
+    while (cursor && *cursor) {
+        const char* line_end = strstr(cursor, "\r\n");
+        size_t line_len = line_end ? (size_t)(line_end - cursor) : strlen(cursor);
 
-    if (context->content_type_header) {
-        catzilla_cache_free(context->content_type_header);
-        context->content_type_header = NULL;
+        if (line_len > field_name_len && strncasecmp(cursor, field_name, field_name_len) == 0 && cursor[field_name_len] == ':') {
+            const char* value = cursor + field_name_len + 1;
+            while (*value == ' ' || *value == '\t') value++;
+            *length_out = line_len - (size_t)(value - cursor);
+            return value;
+        }
+
+        cursor = line_end ? line_end + 2 : NULL;
     }
 
-    for (int i = 0; i < context->header_count; i++) {
-        if (context->headers[i].name) {
-            catzilla_cache_free(context->headers[i].name);
-            context->headers[i].name = NULL;
-        }
-        if (context->headers[i].value) {
-            catzilla_cache_free(context->headers[i].value);
-            context->headers[i].value = NULL;
-        }
+    *length_out = 0;
+    return NULL;
+}
+
+static void reset_client_request_state(client_context_t* context) {
+    if (!context) {
+        return;
     }
 
-    context->header_count = 0;
-    context->parsing_content_type = false;
-    context->parsing_connection = false;
+    catzilla_header_set_reset(&context->headers);
     context->has_connection_header = false;
     context->content_type = CONTENT_TYPE_NONE;
     context->deferred_response_pending = false;
+    catzilla_request_free(context->response_cache_key);
+    context->response_cache_key = NULL;
+    context->latency.route = NULL;  // Requests answered without a queued response are not timed
+    if (context->phase != CONN_PHASE_STREAMING && context->phase != CONN_PHASE_WEBSOCKET) {
+        context->phase = CONN_PHASE_IDLE;
+    }
 }
 
 // Global reference to the active server for signal handling
 static catzilla_server_t* active_server = NULL;
 
-static int on_message_begin(llhttp_t* parser) {
-    client_context_t* context = (client_context_t*)parser->data;
-    context->url[0] = '\0';
-    context->method[0] = '\0';
-    catzilla_request_free(context->body);
-    context->body = NULL;
-    context->body_length = 0;
-    context->body_size = 0;
-    context->parsing_content_type = false;
-    context->content_type = CONTENT_TYPE_NONE;  // Reset content type at start of message
-    LOG_HTTP_DEBUG("Message begin: content type reset to NONE (type=%d)", (int)context->content_type);
-    return 0;
-}
-
-static int on_url(llhttp_t* parser, const char* at, size_t length) {
-    client_context_t* context = (client_context_t*)parser->data;
-
-    // Store the full URL including query string
-    if (length >= CATZILLA_PATH_MAX) length = CATZILLA_PATH_MAX - 1;
-    memcpy(context->url, at, length);
-    context->url[length] = '\0';
-    LOG_HTTP_DEBUG("Received full URL: %s", context->url);
-    return 0;
-}
+// Installed once by the Python extension; upgrades are refused without them
+static catzilla_websocket_hooks_t websocket_hooks;
 
-static int on_header_field(llhttp_t* parser, const char* at, size_t length) {
-    client_context_t* context = (client_context_t*)parser->data;
-    context->parsing_content_type = false;  // Reset flags by default
-    context->parsing_connection = false;
-
-    // Store the header name for later use in on_header_value
-    if (context->current_header_name) {
-        catzilla_cache_free(context->current_header_name);
-    }
-    context->current_header_name = catzilla_cache_alloc(length + 1);
-    if (context->current_header_name) {
-        memcpy(context->current_header_name, at, length);
-        context->current_header_name[length] = '\0';
-        context->current_header_name_len = length;
-    }
-
-    // Check for specific headers that need special handling
-    if (length == 12 && strncasecmp(at, "Content-Type", 12) == 0) {
-        LOG_HTTP_DEBUG("Found Content-Type header");
-        context->parsing_content_type = true;
-    } else if (length == 10 && strncasecmp(at, "Connection", 10) == 0) {
-        LOG_HTTP_DEBUG("Found Connection header");
-        context->parsing_connection = true;
-        context->has_connection_header = true;
-    }
-    return 0;
-}
+// Called as each loop shuts down, before its remaining handles are closed
+static catzilla_loop_exit_fn loop_exit_hook;
 
-static int on_header_value(llhttp_t* parser, const char* at, size_t length) {
-    client_context_t* context = (client_context_t*)parser->data;
-    if (context->parsing_content_type) {
-        LOG_HTTP_DEBUG("Processing Content-Type header: '%.*s'", (int)length, at);
-
-        // Store the full Content-Type header value for multipart boundary extraction
-        if (context->content_type_header) {
-            catzilla_cache_free(context->content_type_header);
-        }
-        context->content_type_header = catzilla_cache_alloc(length + 1);
-        if (context->content_type_header) {
-            memcpy(context->content_type_header, at, length);
-            context->content_type_header[length] = '\0';
-            LOG_HTTP_DEBUG("Stored full Content-Type header: %s", context->content_type_header);
-        }
-
-        // Store content type for later use in JSON/form parsing
-        content_type_t new_type = CONTENT_TYPE_NONE;
-
-        if (length >= 16 && strncasecmp(at, "application/json", 16) == 0) {
-            new_type = CONTENT_TYPE_JSON;
-        } else if (length >= 33 && strncasecmp(at, "application/x-www-form-urlencoded", 33) == 0) {
-            new_type = CONTENT_TYPE_FORM;
-        } else if (length >= 19 && strncasecmp(at, "multipart/form-data", 19) == 0) {
-            new_type = CONTENT_TYPE_MULTIPART;
-        }
-
-        // Validate and set the content type
-        if (new_type >= CONTENT_TYPE_NONE && new_type <= CONTENT_TYPE_MULTIPART) {
-            context->content_type = new_type;
-            LOG_HTTP_DEBUG("Content-Type set to: %s (type=%d)",
-                new_type == CONTENT_TYPE_JSON ? "application/json" :
-                new_type == CONTENT_TYPE_FORM ? "application/x-www-form-urlencoded" :
-                new_type == CONTENT_TYPE_MULTIPART ? "multipart/form-data" : "none",
-                (int)context->content_type);
+// Per-loop freelist of closed connection contexts. Each loop runs on its own
+// thread, so the freelist is thread-local and needs no locking.
+typedef struct {
+    client_context_t* head;
+    int count;
+} client_context_pool_t;
+
+static CATZILLA_THREAD_LOCAL client_context_pool_t context_pool;
+
+// Process-wide connection counters shared by all loops
+static catzilla_atomic_uint64_t stat_connections_accepted = 0;
+static catzilla_atomic_uint64_t stat_accept_errors = 0;
+static catzilla_atomic_uint64_t stat_active_connections = 0;
+static catzilla_atomic_uint64_t stat_context_pool_hits = 0;
+static catzilla_atomic_uint64_t stat_context_pool_misses = 0;
+static catzilla_atomic_uint64_t stat_context_pool_drops = 0;
+static catzilla_atomic_uint64_t stat_context_pooled = 0;
+static catzilla_atomic_uint64_t stat_header_timeouts = 0;
+static catzilla_atomic_uint64_t stat_body_timeouts = 0;
+static catzilla_atomic_uint64_t stat_keepalive_timeouts = 0;
+static catzilla_atomic_uint64_t stat_write_timeouts = 0;
+static catzilla_atomic_uint64_t stat_accept_pauses = 0;
+static catzilla_atomic_uint64_t stat_accept_resumes = 0;
+static catzilla_atomic_uint64_t stat_tls_handshakes = 0;
+static catzilla_atomic_uint64_t stat_tls_resumptions = 0;
+static catzilla_atomic_uint64_t stat_tls_handshake_failures = 0;
+static catzilla_atomic_uint64_t stat_ktls_offloads = 0;
+static catzilla_atomic_uint64_t stat_native_responses = 0;
+static catzilla_atomic_uint64_t stat_response_cache_hits = 0;
+static catzilla_atomic_uint64_t stat_response_cache_misses = 0;
+static catzilla_atomic_uint64_t stat_response_cache_stores = 0;
+static catzilla_atomic_uint64_t stat_response_cache_remote_hits = 0;
+static catzilla_atomic_uint64_t stat_response_cache_not_modified = 0;
+static catzilla_atomic_uint64_t stat_python_batches = 0;
+static catzilla_atomic_uint64_t stat_python_batched_requests = 0;
+static catzilla_atomic_uint64_t stat_python_batch_largest = 0;
+static catzilla_atomic_uint64_t stat_python_batch_budget_stops = 0;
+static catzilla_atomic_uint64_t stat_corked_flushes = 0;
+static catzilla_atomic_uint64_t stat_corked_responses = 0;
+static catzilla_atomic_uint64_t stat_memory_pressure_level = 0;
+static catzilla_atomic_uint64_t stat_memory_pressure_events = 0;
+static catzilla_atomic_uint64_t stat_memory_shrinks = 0;
+static catzilla_atomic_uint64_t stat_memory_rss = 0;
+static catzilla_atomic_uint64_t stat_pressure_rejections = 0;
+
+// Bumped by the memory governor; each loop trims its own pools when it sees
+// a new value, since thread-local pools can only be emptied by their thread
+static catzilla_atomic_uint64_t memory_trim_generation = 0;
+static CATZILLA_THREAD_LOCAL uint64_t loop_trim_generation = 0;
+
+// Set once the listeners were handed to a successor; every loop then drains
+// on its next timeout tick
+static catzilla_atomic_uint64_t server_draining = 0;
+
+// Per-loop connection timeouts and accept pausing. Connections never leave
+// the loop that accepted them, so none of this needs locking.
+typedef struct {
+    catzilla_timer_wheel_t wheel;
+    bool running;
+    uv_stream_t* paused_listener;  // Listener holding a connection until capacity frees up
+    uv_tcp_t* listener;            // This loop's listener, until a handoff drains the loop
+    client_context_t* open;        // Connections accepted by this loop
+} loop_connections_t;
+
+static CATZILLA_THREAD_LOCAL loop_connections_t loop_connections;
+
+// Per-loop queue of requests waiting for the GIL. The check handle runs right
+// after the loop's I/O phase; the idle handle keeps the next poll from
+// blocking while a batch left requests behind.
+typedef struct {
+    uv_check_t check;
+    uv_idle_t idle;
+    bool running;
+    client_context_t* head;
+    client_context_t* tail;
+} loop_dispatch_t;
+
+static CATZILLA_THREAD_LOCAL loop_dispatch_t loop_dispatch;
+
+// Per-loop clamd client, when uploads are virus scanned
+static CATZILLA_THREAD_LOCAL catzilla_clamd_t* loop_clamd;
+
+static int start_python_dispatch(uv_loop_t* loop);
+static void stop_python_dispatch(void);
+static int queue_python_request(client_context_t* ctx, const catzilla_route_match_t* match);
+static void unqueue_python_request(client_context_t* ctx);
+static void on_python_dispatch(uv_check_t* handle);
+static void free_client_context(client_context_t* ctx);
+static void cancel_remote_cache_lookup(client_context_t* ctx);
+
+// Take a context ready for a new connection; pooled ones keep their parser
+static client_context_t* acquire_client_context(catzilla_server_t* server) {
+    client_context_t* ctx = context_pool.head;
+    if (ctx) {
+        context_pool.head = ctx->next_free;
+        context_pool.count--;
+        ctx->next_free = NULL;
+        catzilla_atomic_fetch_add(&stat_context_pool_hits, 1);
+        catzilla_atomic_fetch_sub(&stat_context_pooled, 1);
+
+        if (ctx->server == server) {
+            llhttp_reset(&ctx->parser);
         } else {
-            context->content_type = CONTENT_TYPE_NONE;
-            LOG_HTTP_DEBUG("Invalid content type, defaulting to NONE");
+            ctx->server = server;
+            llhttp_init(&ctx->parser, HTTP_REQUEST, &server->parser_settings);
         }
+        ctx->parser.data = ctx;
+        return ctx;
+    }
 
-        context->parsing_content_type = false;
-    } else if (context->parsing_connection) {
-        LOG_HTTP_DEBUG("Processing Connection header: '%.*s'", (int)length, at);
+    catzilla_atomic_fetch_add(&stat_context_pool_misses, 1);
+    ctx = catzilla_cache_alloc(sizeof(*ctx));
+    if (!ctx) return NULL;
 
-        // Check for keep-alive
-        if (length >= 10 && strncasecmp(at, "keep-alive", 10) == 0) {
-            context->keep_alive = true;
-            LOG_HTTP_DEBUG("Connection: keep-alive detected");
-        } else {
-            context->keep_alive = false;
-            LOG_HTTP_DEBUG("Connection: close or other");
-        }
+    // Initialize all fields to zero/NULL
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->spool_fd = -1;
+    ctx->server = server;
+    ctx->content_type = CONTENT_TYPE_NONE;  // Explicitly set to NONE
+    ctx->keep_alive = false;  // Default to close connection (HTTP/1.0 behavior)
+    llhttp_init(&ctx->parser, HTTP_REQUEST, &server->parser_settings);
+    ctx->parser.data = ctx;
+    return ctx;
+}
 
-        context->parsing_connection = false;
+// Release per-connection allocations and park the context for reuse
+static void release_client_context(client_context_t* ctx) {
+    unqueue_python_request(ctx);
+    cancel_remote_cache_lookup(ctx);
+    catzilla_sse_unsubscribe(ctx->sse_subscriber);
+    ctx->sse_subscriber = NULL;
+    if (ctx->websocket) {
+        if (ctx->websocket_handle && websocket_hooks.closed) {
+            const char* reason = NULL;
+            size_t reason_length = 0;
+            int code = catzilla_ws_session_close_code(ctx->websocket, &reason, &reason_length);
+            websocket_hooks.closed(ctx->websocket_handle, code, reason, reason_length);
+        }
+        catzilla_ws_session_free(ctx->websocket);
+        ctx->websocket = NULL;
+        ctx->websocket_handle = NULL;
+        ctx->websocket_close_queued = false;
     }
+    reset_client_request_state(ctx);
+    catzilla_router_release_route(ctx->dispatch_route);
+    ctx->dispatch_route = NULL;
+
+    discard_request_body(ctx);
+    ctx->body_rejected = false;
+    catzilla_request_free(ctx->pending_input);
+    ctx->pending_input = NULL;
+    ctx->pending_input_len = 0;
+    catzilla_sticky_buffer_free(ctx->sticky_buffer);
+    ctx->sticky_buffer = NULL;
+    ctx->sticky_in_use = false;
+    ctx->prefer_sticky_buffer = false;
+    catzilla_h2_session_free(ctx->h2);
+    ctx->h2 = NULL;
+    ctx->h2_stream_id = 0;
+    ctx->h2_goaway_queued = false;
+    ctx->protocol_detected = false;
+    catzilla_timer_wheel_cancel(&loop_connections.wheel, &ctx->timeout_entry);
+    ctx->timeout_kind = CONN_TIMEOUT_NONE;
+    ctx->writes_in_flight = 0;
+    ctx->latency.route = NULL;
+    catzilla_tls_session_free(ctx->tls);
+    ctx->tls = NULL;
+    ctx->tls_established = false;
 
-    // Store ALL headers in the headers array for later access from Python
-    if (context->current_header_name && context->header_count < CATZILLA_MAX_HEADERS) {
-        catzilla_header_t* header = &context->headers[context->header_count];
+    ctx->url[0] = '\0';
+    ctx->method[0] = '\0';
+    ctx->keep_alive = false;
+    ctx->read_paused = false;
+    ctx->corked = false;
+    ctx->batch_corked = false;
+    ctx->batch_cork_next = NULL;
+    ctx->cork_head = NULL;
+    ctx->cork_tail = NULL;
+    ctx->cork_nbufs = 0;
+
+    int limit = ctx->server ? ctx->server->context_pool_limit : 0;
+    if (context_pool.count < limit) {
+        ctx->next_free = context_pool.head;
+        context_pool.head = ctx;
+        context_pool.count++;
+        catzilla_atomic_fetch_add(&stat_context_pooled, 1);
+        return;
+    }
 
-        // Allocate and copy header name
-        header->name = catzilla_cache_alloc(context->current_header_name_len + 1);
-        if (header->name) {
-            strcpy(header->name, context->current_header_name);
-        }
+    catzilla_atomic_fetch_add(&stat_context_pool_drops, 1);
+    free_client_context(ctx);
+}
 
-        // Allocate and copy header value
-        header->value = catzilla_cache_alloc(length + 1);
-        if (header->value) {
-            memcpy(header->value, at, length);
-            header->value[length] = '\0';
-        }
+static void free_client_context(client_context_t* ctx) {
+    catzilla_header_set_free(&ctx->headers);
+    catzilla_router_release_route(ctx->dispatch_route);
+    catzilla_cache_free(ctx->dispatch_match);
+    catzilla_cache_free(ctx);
+}
 
-        // Only increment if both allocations succeeded
-        if (header->name && header->value) {
-            context->header_count++;
-            LOG_HTTP_DEBUG("Stored header: %s = %s", header->name, header->value);
-        } else {
-            // Clean up failed allocation
-            if (header->name) {
-                catzilla_cache_free(header->name);
-                header->name = NULL;
-            }
-            if (header->value) {
-                catzilla_cache_free(header->value);
-                header->value = NULL;
-            }
-        }
+// Free every context parked in the calling thread's pool
+static void trim_client_context_pool(void) {
+    while (context_pool.head) {
+        client_context_t* ctx = context_pool.head;
+        context_pool.head = ctx->next_free;
+        free_client_context(ctx);
+        catzilla_atomic_fetch_sub(&stat_context_pooled, 1);
     }
+    context_pool.count = 0;
+}
 
+int catzilla_server_set_context_pool_limit(catzilla_server_t* server, int limit) {
+    if (!server || limit < 0) return -1;
+    server->context_pool_limit = limit;
     return 0;
 }
 
-static int on_headers_complete(llhttp_t* parser) {
-    client_context_t* context = (client_context_t*)parser->data;
-    const char* method = llhttp_method_name(parser->method);
-    size_t method_len = strlen(method);
-    if (method_len >= CATZILLA_METHOD_MAX) method_len = CATZILLA_METHOD_MAX - 1;
-    memcpy(context->method, method, method_len);
-    context->method[method_len] = '\0';
+int catzilla_server_set_python_batching(catzilla_server_t* server, int batch_size, uint64_t budget_us) {
+    if (!server || batch_size < 1) return -1;
+    server->python_batch_size = batch_size;
+    server->python_batch_budget_us = budget_us;
+    return 0;
+}
 
-    // HTTP/1.1 defaults to keep-alive if no Connection header was specified
-    if (!context->has_connection_header && llhttp_get_http_major(parser) == 1 && llhttp_get_http_minor(parser) == 1) {
-        context->keep_alive = true;
-        LOG_HTTP_DEBUG("HTTP/1.1 defaulting to keep-alive");
-    }
+int catzilla_server_set_max_body_size(catzilla_server_t* server, uint64_t max_body_size) {
+    if (!server) return -1;
+    server->max_body_size = max_body_size;
+    return 0;
+}
 
+int catzilla_server_set_http2(catzilla_server_t* server, bool enabled) {
+    if (!server) return -1;
+    server->http2_enabled = enabled;
     return 0;
 }
 
-static int on_body(llhttp_t* parser, const char* at, size_t length) {
-    client_context_t* context = (client_context_t*)parser->data;
-    if (context->body == NULL) {
-        context->body_size = length > 1024 ? length : 1024;
-        context->body = catzilla_request_alloc(context->body_size + 1);
-        if (!context->body) return -1;
-        context->body_length = 0;
-    } else if (context->body_length + length > context->body_size) {
-        // Calculate new size to accommodate current chunk + some extra space
-        size_t required_size = context->body_length + length;
-        size_t new_size = context->body_size * 2;
+int catzilla_server_set_compression(catzilla_server_t* server, const catzilla_compression_config_t* config) {
+    if (!server || !config) return -1;
+    if (config->gzip_level < 1 || config->gzip_level > 9 ||
+        config->br_quality < 0 || config->br_quality > 11 ||
+        config->zstd_level < 1 || config->zstd_level > 22) {
+        return -1;
+    }
+    server->compression = *config;
+    return 0;
+}
 
-        // Ensure new_size is at least large enough for the required size
-        while (new_size < required_size) {
-            new_size *= 2;
-        }
+int catzilla_server_set_timeouts(catzilla_server_t* server, uint64_t header_ms, uint64_t body_ms,
+                                 uint64_t keepalive_ms, uint64_t write_ms) {
+    if (!server) return -1;
+    server->header_timeout = header_ms;
+    server->body_timeout = body_ms;
+    server->keepalive_timeout = keepalive_ms;
+    server->write_timeout = write_ms;
+    return 0;
+}
 
-        char* new_body = catzilla_request_realloc(context->body, new_size + 1);
-        if (!new_body) return -1;
-        context->body = new_body;
-        context->body_size = new_size;
-        LOG_HTTP_DEBUG("Reallocated body buffer: %zu bytes -> %zu bytes", context->body_length, new_size);
+int catzilla_server_set_max_connections(catzilla_server_t* server, uint64_t max_connections,
+                                        uint64_t low_water) {
+    if (!server) return -1;
+    if (low_water == 0 || low_water > max_connections) {
+        low_water = max_connections - max_connections / 10;
     }
-    memcpy(context->body + context->body_length, at, length);
-    context->body_length += length;
-    context->body[context->body_length] = '\0';
-    LOG_HTTP_DEBUG("Received body chunk: %zu bytes (total: %zu bytes)", length, context->body_length);
+    server->max_connections = max_connections;
+    server->connections_low_water = low_water;
     return 0;
 }
 
-// Function to check if body parsing will fail due to unsupported content type
-static bool should_return_415(client_context_t* context) {
-    // Only return 415 if we have a body and the content type is unsupported
-    if (!context->body || context->body_length == 0) {
-        return false;  // No body, no problem
-    }
+int catzilla_server_set_tls(catzilla_server_t* server, const char* cert_file, const char* key_file,
+                            bool enable_ktls) {
+    if (!server || !cert_file || !key_file) return -1;
+    catzilla_tls_context_t* context = catzilla_tls_context_create(cert_file, key_file, enable_ktls);
+    if (!context) return -1;
 
-    // For POST/PUT/PATCH requests with body, we expect a supported content type
-    if (strcmp(context->method, "POST") == 0 ||
-        strcmp(context->method, "PUT") == 0 ||
-        strcmp(context->method, "PATCH") == 0) {
+    catzilla_tls_context_free(server->tls_context);
+    server->tls_context = context;
+    LOG_SERVER_INFO("TLS enabled with certificate %s%s", cert_file, enable_ktls ? " (kTLS offload)" : "");
+    return 0;
+}
 
-        // If we have a body but no recognizable content type, return 415
-        if (context->content_type == CONTENT_TYPE_NONE) {
-            LOG_HTTP_DEBUG("Request has body but unsupported content type");
-            return true;
+static catzilla_route_t* find_registered_route(catzilla_server_t* server, const char* method, const char* path) {
+    for (int i = 0; i < server->router.route_count; i++) {
+        catzilla_route_t* route = server->router.routes[i];
+        if (route && strcmp(route->method, method) == 0 && strcmp(route->path, path) == 0) {
+            return route;
         }
     }
+    return NULL;
+}
 
-    return false;
+static void apply_route_body_policy(catzilla_server_t* server, catzilla_route_t* route,
+                                    catzilla_body_mode_t mode, uint64_t max_body_size,
+                                    size_t spool_threshold) {
+    bool was_default = route->body_mode == CATZILLA_BODY_BUFFERED && route->max_body_size == 0;
+    route->body_mode = mode;
+    route->max_body_size = max_body_size;
+    route->body_spool_threshold = spool_threshold;
+    bool is_default = mode == CATZILLA_BODY_BUFFERED && max_body_size == 0;
+
+    if (was_default && !is_default) server->body_route_count++;
+    if (!was_default && is_default) server->body_route_count--;
 }
 
-// Function to populate request with path parameters from route match
-static void populate_path_params(catzilla_request_t* request, const catzilla_route_match_t* match) {
-    if (!request || !match) return;
+int catzilla_server_set_route_body_mode(catzilla_server_t* server,
+                                       const char* method,
+                                       const char* path,
+                                       catzilla_body_mode_t mode,
+                                       uint64_t max_body_size,
+                                       size_t spool_threshold) {
+    if (!server || !method || !path) return -1;
+    if (mode != CATZILLA_BODY_BUFFERED && mode != CATZILLA_BODY_SPOOL) return -1;
 
-    // Clear existing path parameters
-    request->path_param_count = 0;
-    request->has_path_params = false;
+    catzilla_route_t* route = find_registered_route(server, method, path);
+    if (!route) {
+        LOG_SERVER_ERROR("Cannot set body mode: no route %s %s", method, path);
+        return -1;
+    }
 
-    // Copy path parameters from match
-    for (int i = 0; i < match->param_count && i < CATZILLA_MAX_PATH_PARAMS; i++) {
-        strncpy(request->path_params[i].name, match->params[i].name, CATZILLA_PARAM_NAME_MAX - 1);
-        request->path_params[i].name[CATZILLA_PARAM_NAME_MAX - 1] = '\0';
+    route->body_chunk_handler = NULL;
+    route->body_chunk_user_data = NULL;
+    apply_route_body_policy(server, route, mode, max_body_size, spool_threshold);
+    return 0;
+}
 
-        strncpy(request->path_params[i].value, match->params[i].value, CATZILLA_PATH_SEGMENT_MAX - 1);
-        request->path_params[i].value[CATZILLA_PATH_SEGMENT_MAX - 1] = '\0';
+int catzilla_server_set_route_body_stream(catzilla_server_t* server,
+                                         const char* method,
+                                         const char* path,
+                                         catzilla_body_chunk_fn handler,
+                                         void* user_data) {
+    if (!server || !method || !path || !handler) return -1;
 
-        request->path_param_count++;
+    catzilla_route_t* route = find_registered_route(server, method, path);
+    if (!route) {
+        LOG_SERVER_ERROR("Cannot stream body: no route %s %s", method, path);
+        return -1;
     }
 
-    if (request->path_param_count > 0) {
-        request->has_path_params = true;
-        LOG_HTTP_DEBUG("Populated %d path parameters in request", request->path_param_count);
-    }
+    route->body_chunk_handler = (void*)handler;
+    route->body_chunk_user_data = user_data;
+    apply_route_body_policy(server, route, CATZILLA_BODY_STREAM, route->max_body_size, 0);
+    return 0;
 }
 
-// Universal Python route handler for advanced router
-void catzilla_python_route_handler(uv_stream_t* client) {
-    // This handler should never be called directly since Python routes
-    // are handled via py_request_callback in on_message_complete
-    LOG_SERVER_ERROR("catzilla_python_route_handler called directly - this should not happen");
-    const char* body = "500 Internal Server Error";
-    catzilla_send_response(client, 500, "text/plain", body, strlen(body));
+// One immutable version of a native route's response. Every write in flight
+// holds a reference, so a replaced version lives until its last write is done.
+typedef struct {
+    int status_code;
+    char* headers;
+    char* body;
+    size_t body_len;
+    catzilla_atomic_uint64_t refs;
+} catzilla_native_response_t;
+
+typedef struct {
+    uv_rwlock_t lock;                     // Guards swapping response against readers
+    catzilla_native_response_t* response; // Current version (precomputed routes)
+    catzilla_native_handler_fn handler;   // C callback (callback routes)
+    void* user_data;
+} catzilla_native_route_t;
+
+static void native_response_unref(catzilla_native_response_t* response) {
+    if (!response) return;
+    if (catzilla_atomic_fetch_sub(&response->refs, 1) == 1) {
+        catzilla_cache_free(response->headers);
+        catzilla_cache_free(response->body);
+        catzilla_cache_free(response);
+    }
 }
 
-// Capsule destructor for proper request memory management
-static void request_capsule_destructor(PyObject* capsule) {
-    catzilla_request_t* request = PyCapsule_GetPointer(capsule, "catzilla.request");
-    if (request) {
-        if (request->json_doc) yyjson_doc_free(request->json_doc);
+static void release_native_response_body(void* owner, const char* body, size_t body_len) {
+    (void)body;
+    (void)body_len;
+    native_response_unref((catzilla_native_response_t*)owner);
+}
 
-        for (int i = 0; i < request->query_param_count; i++) {
-            if (request->query_params[i]) {
-                catzilla_request_free(request->query_params[i]);
-                request->query_params[i] = NULL;
-            }
-            if (request->query_values[i]) {
-                catzilla_request_free(request->query_values[i]);
-                request->query_values[i] = NULL;
-            }
-        }
+// Read the route's current version in one go: either a referenced response,
+// or (NULL) the handler and its user_data
+static catzilla_native_response_t* native_response_acquire(catzilla_native_route_t* native,
+                                                           catzilla_native_handler_fn* handler,
+                                                           void** user_data) {
+    uv_rwlock_rdlock(&native->lock);
+    catzilla_native_response_t* response = native->response;
+    if (response) {
+        catzilla_atomic_fetch_add(&response->refs, 1);
+    }
+    *handler = native->handler;
+    *user_data = native->user_data;
+    uv_rwlock_rdunlock(&native->lock);
+    return response;
+}
 
-        for (int i = 0; i < request->form_field_count; i++) {
-            if (request->form_fields[i]) {
-                catzilla_request_free(request->form_fields[i]);
-                request->form_fields[i] = NULL;
-            }
-            if (request->form_values[i]) {
-                catzilla_request_free(request->form_values[i]);
-                request->form_values[i] = NULL;
-            }
-        }
+// Find the native route state of method + path, registering the route and
+// its state on first use. NULL if the path belongs to a non-native route.
+static catzilla_native_route_t* get_native_route(catzilla_server_t* server, const char* method, const char* path) {
+    char norm_method[CATZILLA_METHOD_MAX];
+    char norm_path[CATZILLA_PATH_MAX];
+    if (catzilla_router_normalize_method(method, norm_method, sizeof(norm_method)) != 0 ||
+        catzilla_router_normalize_path(path, norm_path, sizeof(norm_path)) != 0) {
+        return NULL;
+    }
 
-        // Clean up copied headers
-        for (int i = 0; i < request->header_count; i++) {
-            if (request->headers[i].name) {
-                catzilla_cache_free(request->headers[i].name);
-                request->headers[i].name = NULL;
-            }
-            if (request->headers[i].value) {
-                catzilla_cache_free(request->headers[i].value);
-                request->headers[i].value = NULL;
-            }
+    catzilla_route_t* route = find_registered_route(server, norm_method, norm_path);
+    if (route) {
+        if (!route->native) {
+            LOG_SERVER_ERROR("Cannot serve %s %s natively: a handler route is registered", norm_method, norm_path);
         }
+        return route->native;
+    }
 
-        // Clean up uploaded files
-        if (request->has_files) {
-            for (int i = 0; i < request->file_count; i++) {
-                if (request->files[i]) {
-                    catzilla_upload_file_unref(request->files[i]);
-                    request->files[i] = NULL;
-                }
-            }
-        }
-        catzilla_request_free(request->body);
-        catzilla_request_free(request);
+    // route->native is attached after the route is published, so a lookup
+    // running in between would take it for a Python route
+    if (server->is_running) {
+        LOG_SERVER_ERROR("Native route %s %s must be registered before the server starts", norm_method, norm_path);
+        return NULL;
     }
-}
 
-// Python callback helper
-static PyObject* create_python_route_match_info(const catzilla_route_match_t* match, int match_result) {
-    PyObject* match_dict = NULL;
-    PyObject* path_params = NULL;
-    PyObject* matched_obj = NULL;
-    PyObject* status_code_obj = NULL;
-    bool matched = (match_result == 0 && match && match->route != NULL);
-    int status_code = 404;
-
-    if (match) {
-        status_code = match->status_code;
-    }
-
-    match_dict = PyDict_New();
-    path_params = PyDict_New();
-    matched_obj = PyBool_FromLong(matched ? 1 : 0);
-    status_code_obj = PyLong_FromLong(status_code);
-    if (!match_dict || !path_params || !matched_obj || !status_code_obj) {
-        Py_XDECREF(match_dict);
-        Py_XDECREF(path_params);
-        Py_XDECREF(matched_obj);
-        Py_XDECREF(status_code_obj);
+    catzilla_native_route_t* native = catzilla_cache_alloc(sizeof(*native));
+    if (!native) return NULL;
+    memset(native, 0, sizeof(*native));
+    if (uv_rwlock_init(&native->lock) != 0) {
+        catzilla_cache_free(native);
         return NULL;
     }
 
-    if (PyDict_SetItemString(match_dict, "matched", matched_obj) < 0 ||
-        PyDict_SetItemString(match_dict, "status_code", status_code_obj) < 0 ||
-        PyDict_SetItemString(match_dict, "path_params", path_params) < 0) {
-        Py_DECREF(match_dict);
-        Py_DECREF(path_params);
-        Py_DECREF(matched_obj);
-        Py_DECREF(status_code_obj);
+    // The router wants a non-NULL handler; dispatch goes by route->native
+    if (catzilla_router_add_route(&server->router, norm_method, norm_path, native, NULL, false) == 0 ||
+        !(route = find_registered_route(server, norm_method, norm_path))) {
+        LOG_SERVER_ERROR("Failed to register native route %s %s", norm_method, norm_path);
+        uv_rwlock_destroy(&native->lock);
+        catzilla_cache_free(native);
         return NULL;
     }
-    Py_DECREF(path_params);
-    Py_DECREF(matched_obj);
-    Py_DECREF(status_code_obj);
+    route->native = native;
+    LOG_ROUTER_DEBUG("Registered native route %s %s", norm_method, norm_path);
+    return native;
+}
 
-    if (matched && match && match->route) {
-        long route_id = (long)(uintptr_t)match->route->user_data;
-        PyObject* route_id_obj = PyLong_FromLong(route_id);
-        if (!route_id_obj || PyDict_SetItemString(match_dict, "route_id", route_id_obj) < 0) {
-            Py_XDECREF(route_id_obj);
-            Py_DECREF(match_dict);
-            return NULL;
-        }
-        Py_DECREF(route_id_obj);
+int catzilla_server_set_native_response(catzilla_server_t* server,
+                                        const char* method,
+                                        const char* path,
+                                        int status_code,
+                                        const char* headers,
+                                        const char* body,
+                                        size_t body_len) {
+    if (!server || !method || !path || (!body && body_len > 0)) return -1;
+    if (status_code < 100 || status_code > 999) return -1;
 
-        for (int i = 0; i < match->param_count; i++) {
-            PyObject* param_value = PyUnicode_FromString(match->params[i].value);
-            if (!param_value) {
-                Py_DECREF(match_dict);
-                return NULL;
-            }
-            if (PyDict_SetItemString(path_params, match->params[i].name, param_value) < 0) {
-                Py_DECREF(param_value);
-                Py_DECREF(match_dict);
-                return NULL;
-            }
-            Py_DECREF(param_value);
-        }
+    catzilla_native_response_t* response = catzilla_cache_alloc(sizeof(*response));
+    if (!response) return -1;
+    memset(response, 0, sizeof(*response));
+    response->status_code = status_code;
+    response->refs = 1;  // Held by the route
+
+    size_t headers_len = headers ? strlen(headers) : 0;
+    response->headers = catzilla_cache_alloc(headers_len + 1);
+    response->body = catzilla_cache_alloc(body_len > 0 ? body_len : 1);
+    if (!response->headers || !response->body) {
+        native_response_unref(response);
+        return -1;
+    }
+    if (headers_len > 0) memcpy(response->headers, headers, headers_len);
+    response->headers[headers_len] = '\0';
+    if (body_len > 0) memcpy(response->body, body, body_len);
+    response->body_len = body_len;
+
+    catzilla_native_route_t* native = get_native_route(server, method, path);
+    if (!native) {
+        native_response_unref(response);
+        return -1;
     }
 
-    if (match && match->has_allowed_methods) {
-        PyObject* allowed_methods_obj = PyUnicode_FromString(match->allowed_methods);
-        if (!allowed_methods_obj || PyDict_SetItemString(match_dict, "allowed_methods", allowed_methods_obj) < 0) {
-            Py_XDECREF(allowed_methods_obj);
-            Py_DECREF(match_dict);
-            return NULL;
-        }
-        Py_DECREF(allowed_methods_obj);
-    } else {
-        if (PyDict_SetItemString(match_dict, "allowed_methods", Py_None) < 0) {
-            Py_DECREF(match_dict);
-            return NULL;
-        }
+    uv_rwlock_wrlock(&native->lock);
+    catzilla_native_response_t* previous = native->response;
+    native->response = response;
+    native->handler = NULL;
+    native->user_data = NULL;
+    uv_rwlock_wrunlock(&native->lock);
+
+    native_response_unref(previous);
+    return 0;
+}
+
+int catzilla_server_set_native_handler(catzilla_server_t* server,
+                                       const char* method,
+                                       const char* path,
+                                       catzilla_native_handler_fn handler,
+                                       void* user_data) {
+    if (!server || !method || !path || !handler) return -1;
+    if (server->is_running) {
+        LOG_SERVER_ERROR("Native handlers must be set before the server starts");
+        return -1;
     }
 
-    return match_dict;
+    catzilla_native_route_t* native = get_native_route(server, method, path);
+    if (!native) return -1;
+
+    uv_rwlock_wrlock(&native->lock);
+    catzilla_native_response_t* previous = native->response;
+    native->response = NULL;
+    native->handler = handler;
+    native->user_data = user_data;
+    uv_rwlock_wrunlock(&native->lock);
+
+    native_response_unref(previous);
+    return 0;
 }
 
-PyObject* handle_request_in_server(PyObject* callback,
-    PyObject* client_capsule,
-    const char* method,
-    const char* path,
-    const char* body,
-    size_t body_length,
-    client_context_t* client_ctx,
-    PyObject* route_match_info)
-{
-    if (!callback || !PyCallable_Check(callback)) {
-        PyErr_SetString(PyExc_TypeError, "Callback is not callable");
-        return NULL;
+static void release_heap_profile(void* owner, const char* body, size_t body_len) {
+    (void)body;
+    (void)body_len;
+    catzilla_response_free(owner);
+}
+
+// Dump the sampled heap to a temp file and send it back as it is
+static int serve_heap_profile(uv_stream_t* client, const catzilla_request_t* request, void* user_data) {
+    (void)request;
+    (void)user_data;
+
+    char path[64];
+    int fd = catzilla_stream_create_temp_file(path, sizeof(path));
+    if (fd < 0) return -1;
+    close(fd);
+
+    if (catzilla_memory_profiler_dump(path) != 0) {
+        unlink(path);
+        bool available = catzilla_memory_profiler_available();
+        const char* body = available
+            ? "409 Conflict: the allocation profiler has not been started"
+            : "501 Not Implemented: jemalloc heap profiling is not available in this build";
+        catzilla_send_response(client, available ? 409 : 501, "text/plain", body, strlen(body));
+        return 0;
     }
 
-    // Create a request structure
-    catzilla_request_t* request = catzilla_request_alloc(sizeof(catzilla_request_t));
-    if (!request) {
-        PyErr_NoMemory();
-        return NULL;
+    FILE* file = fopen(path, "rb");
+    unlink(path);
+    if (!file) return -1;
+    char* profile = NULL;
+    long size = -1;
+    if (fseek(file, 0, SEEK_END) == 0 && (size = ftell(file)) >= 0 && fseek(file, 0, SEEK_SET) == 0) {
+        profile = catzilla_response_alloc((size_t)size + 1);
     }
-    memset(request, 0, sizeof(catzilla_request_t));
+    if (!profile || fread(profile, 1, (size_t)size, file) != (size_t)size) {
+        fclose(file);
+        catzilla_response_free(profile);
+        return -1;
+    }
+    fclose(file);
 
-    // Copy data into request
-    strncpy(request->method, method, CATZILLA_METHOD_MAX-1);
-    request->method[CATZILLA_METHOD_MAX-1] = '\0';
-    strncpy(request->path, path, CATZILLA_PATH_MAX-1);
-    request->path[CATZILLA_PATH_MAX-1] = '\0';
+    catzilla_send_response_zerocopy(client, 200,
+                                    "Content-Type: application/octet-stream\r\n"
+                                    "Content-Disposition: attachment; filename=\"heap.prof\"\r\n"
+                                    "Cache-Control: no-store\r\n",
+                                    profile, (size_t)size, release_heap_profile, profile);
+    return 0;
+}
 
-    // Copy headers from context if available
-    if (client_ctx && client_ctx->header_count > 0) {
-        request->header_count = client_ctx->header_count < CATZILLA_MAX_HEADERS ?
-                               client_ctx->header_count : CATZILLA_MAX_HEADERS;
-
-        for (int i = 0; i < request->header_count; i++) {
-            if (client_ctx->headers[i].name) {
-                size_t name_len = strlen(client_ctx->headers[i].name);
-                request->headers[i].name = catzilla_cache_alloc(name_len + 1);
-                if (request->headers[i].name) {
-                    strcpy(request->headers[i].name, client_ctx->headers[i].name);
-                }
-            }
+int catzilla_server_set_heap_profile_endpoint(catzilla_server_t* server, const char* path) {
+    if (!server || !path) return -1;
+    return catzilla_server_set_native_handler(server, "GET", path, serve_heap_profile, NULL);
+}
 
-            if (client_ctx->headers[i].value) {
-                size_t value_len = strlen(client_ctx->headers[i].value);
-                request->headers[i].value = catzilla_cache_alloc(value_len + 1);
-                if (request->headers[i].value) {
-                    strcpy(request->headers[i].value, client_ctx->headers[i].value);
-                }
-            }
-        }
-        LOG_HTTP_DEBUG("Copied %d headers from context to request", request->header_count);
+typedef struct {
+    const char* name;
+    const char* type;
+    const char* help;
+    double value;
+} exposed_metric_t;
+
+static void write_metrics(catzilla_metrics_text_t* text, const exposed_metric_t* metrics, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        catzilla_metrics_write_value(text, metrics[i].name, metrics[i].type, metrics[i].help, metrics[i].value);
     }
+}
 
-    // Copy data into request
-    strncpy(request->method, method, CATZILLA_METHOD_MAX-1);
-    request->method[CATZILLA_METHOD_MAX-1] = '\0';
-    strncpy(request->path, path, CATZILLA_PATH_MAX-1);
-    request->path[CATZILLA_PATH_MAX-1] = '\0';
-
-    // Parse query parameters if present
-    const char* query = strchr(path, '?');
-    if (query) {
-        query++; // Skip the '?' character
-        LOG_HTTP_DEBUG("About to call parse_query_params with query: %s", query);
-        if (parse_query_params(request, query) == 0) {
-            LOG_HTTP_DEBUG("Successfully parsed query parameters");
-            LOG_HTTP_DEBUG("Request now has %d query params", request->query_param_count);
-            for (int i = 0; i < request->query_param_count; i++) {
-                LOG_HTTP_DEBUG("  Param %d: %s=%s (ptrs: %p/%p)", i,
-                    request->query_params[i], request->query_values[i],
-                    request->query_params[i], request->query_values[i]);
-            }
-            LOG_HTTP_DEBUG("Query parameter parsing completed successfully");
-        } else {
-            LOG_HTTP_DEBUG("Failed to parse query parameters");
-        }
-        LOG_HTTP_DEBUG("After query parameter section, continuing...");
+static void write_server_metrics(catzilla_metrics_text_t* text, catzilla_server_t* server) {
+    catzilla_connection_stats_t conn;
+    catzilla_server_get_connection_stats(&conn);
+    const exposed_metric_t connection_metrics[] = {
+        {"catzilla_connections_accepted_total", "counter", "Accepted connections", conn.connections_accepted},
+        {"catzilla_accept_errors_total", "counter", "Failed accepts", conn.accept_errors},
+        {"catzilla_connections_active", "gauge", "Open client connections", conn.active_connections},
+        {"catzilla_header_timeouts_total", "counter", "Connections closed waiting for headers", conn.header_timeouts},
+        {"catzilla_body_timeouts_total", "counter", "Connections closed waiting for a body", conn.body_timeouts},
+        {"catzilla_keepalive_timeouts_total", "counter", "Idle keep-alive connections closed", conn.keepalive_timeouts},
+        {"catzilla_write_timeouts_total", "counter", "Connections closed with responses not drained", conn.write_timeouts},
+        {"catzilla_accept_pauses_total", "counter", "Times accepting stopped at max_connections", conn.accept_pauses},
+        {"catzilla_tls_handshakes_total", "counter", "Completed TLS handshakes", conn.tls_handshakes},
+        {"catzilla_tls_resumptions_total", "counter", "TLS handshakes resuming a session", conn.tls_resumptions},
+        {"catzilla_tls_handshake_failures_total", "counter", "Failed TLS handshakes", conn.tls_handshake_failures},
+        {"catzilla_native_responses_total", "counter", "Requests answered by native routes", conn.native_responses},
+        {"catzilla_response_cache_hits_total", "counter", "Requests answered from the response cache", conn.response_cache_hits},
+        {"catzilla_response_cache_misses_total", "counter", "Cacheable requests sent to the handler", conn.response_cache_misses},
+        {"catzilla_response_cache_stores_total", "counter", "Responses stored in the cache", conn.response_cache_stores},
+        {"catzilla_response_cache_not_modified_total", "counter", "Conditional requests answered with 304", conn.response_cache_not_modified},
+        {"catzilla_python_batches_total", "counter", "GIL acquisitions dispatching queued requests", conn.python_batches},
+        {"catzilla_python_batched_requests_total", "counter", "Requests dispatched by those batches", conn.python_batched_requests},
+        {"catzilla_python_batch_budget_stops_total", "counter", "Batches cut short by their time budget", conn.python_batch_budget_stops},
+        {"catzilla_corked_flushes_total", "counter", "Writes carrying several pipelined responses", conn.corked_flushes},
+        {"catzilla_corked_responses_total", "counter", "Responses carried by those writes", conn.corked_responses},
+        {"catzilla_memory_pressure_level", "gauge", "Memory pressure level of the last check", conn.memory_pressure_level},
+        {"catzilla_memory_shrinks_total", "counter", "Checks that shrank caches and pools", conn.memory_shrinks},
+        {"catzilla_pressure_rejections_total", "counter", "Uploads refused under memory pressure", conn.pressure_rejections},
+    };
+    write_metrics(text, connection_metrics, sizeof(connection_metrics) / sizeof(connection_metrics[0]));
+
+    catzilla_read_pool_stats_t reads;
+    catzilla_read_pool_get_stats(&reads);
+    catzilla_arena_stats_t arenas;
+    catzilla_arena_get_stats(&arenas);
+    catzilla_compression_stats_t compression;
+    catzilla_compression_get_stats(&compression);
+    catzilla_memory_stats_t memory;
+    catzilla_memory_get_stats(&memory);
+    const exposed_metric_t pool_metrics[] = {
+        {"catzilla_read_slab_hits_total", "counter", "Read slabs served from a pool", reads.slab_hits},
+        {"catzilla_read_slab_misses_total", "counter", "Read slabs allocated", reads.slab_misses},
+        {"catzilla_read_pool_retained_bytes", "gauge", "Bytes held by read slab pools", reads.retained_bytes},
+        {"catzilla_request_arena_resets_total", "counter", "Request arenas reset", arenas.resets},
+        {"catzilla_request_arena_bytes_total", "counter", "Bytes handed out by request arenas", arenas.bytes},
+        {"catzilla_request_arena_retained_bytes", "gauge", "Bytes held by request arena pools", arenas.retained_bytes},
+        {"catzilla_compressed_responses_total", "counter", "Responses sent compressed",
+         (double)(compression.gzip.responses + compression.br.responses + compression.zstd.responses)},
+        {"catzilla_compression_input_bytes_total", "counter", "Bytes given to compressors",
+         (double)(compression.gzip.bytes_in + compression.br.bytes_in + compression.zstd.bytes_in)},
+        {"catzilla_compression_output_bytes_total", "counter", "Bytes compressors produced",
+         (double)(compression.gzip.bytes_out + compression.br.bytes_out + compression.zstd.bytes_out)},
+        {"catzilla_compression_cpu_seconds_total", "counter", "CPU time spent compressing",
+         (double)(compression.gzip.cpu_ns + compression.br.cpu_ns + compression.zstd.cpu_ns) / 1e9},
+        {"catzilla_memory_allocated_bytes", "gauge", "Bytes allocated", (double)memory.allocated},
+        {"catzilla_memory_resident_bytes", "gauge", "Resident bytes", (double)memory.resident},
+    };
+    write_metrics(text, pool_metrics, sizeof(pool_metrics) / sizeof(pool_metrics[0]));
+
+    if (server->response_cache) {
+        cache_statistics_t cache = catzilla_cache_get_stats(server->response_cache->memory_cache);
+        const exposed_metric_t cache_metrics[] = {
+            {"catzilla_response_cache_entries", "gauge", "Responses held in memory", (double)cache.size},
+            {"catzilla_response_cache_evictions_total", "counter", "Responses evicted from memory", cache.evictions},
+            {"catzilla_response_cache_memory_bytes", "gauge", "Bytes held by cached responses", cache.memory_usage},
+        };
+        write_metrics(text, cache_metrics, sizeof(cache_metrics) / sizeof(cache_metrics[0]));
     }
 
-    if (body && body_length > 0) {
-        request->body = catzilla_request_alloc(body_length + 1);
-        if (request->body) {
-            memcpy(request->body, body, body_length);
-            request->body[body_length] = '\0';
-            request->body_length = body_length;
-        } else {
-            PyErr_NoMemory();
-            catzilla_request_free(request);
-            return NULL;
-        }
+    uint64_t static_requests = 0, static_bytes = 0, static_hits = 0, static_misses = 0;
+    for (catzilla_server_mount_t* mount = server->static_mounts; mount; mount = mount->next) {
+        catzilla_static_server_t* files = mount->static_server;
+        if (!files) continue;
+        static_requests += catzilla_atomic_load(&files->requests_served);
+        static_bytes += catzilla_atomic_load(&files->bytes_served);
+        static_hits += catzilla_atomic_load(&files->cache_hits);
+        static_misses += catzilla_atomic_load(&files->cache_misses);
+    }
+    if (server->static_mounts) {
+        const exposed_metric_t static_metrics[] = {
+            {"catzilla_static_requests_total", "counter", "Static file requests served", static_requests},
+            {"catzilla_static_bytes_total", "counter", "Static file bytes served", static_bytes},
+            {"catzilla_static_cache_hits_total", "counter", "Static files served from the hot cache", static_hits},
+            {"catzilla_static_cache_misses_total", "counter", "Static files read from disk", static_misses},
+        };
+        write_metrics(text, static_metrics, sizeof(static_metrics) / sizeof(static_metrics[0]));
     }
 
-    // Get the client context using our new helper function
-    uv_stream_t* client = (uv_stream_t*)PyCapsule_GetPointer(client_capsule, "catzilla.client");
-    client_context_t* context = get_client_context(client);
+    if (server->access_log) {
+        catzilla_access_log_stats_t access;
+        catzilla_access_log_get_stats(server->access_log, &access);
+        const exposed_metric_t access_metrics[] = {
+            {"catzilla_access_log_written_total", "counter", "Access log records written", access.written},
+            {"catzilla_access_log_dropped_total", "counter", "Access log records dropped on a full ring", access.dropped},
+            {"catzilla_access_log_write_errors_total", "counter", "Access log batches the file did not take", access.write_errors},
+        };
+        write_metrics(text, access_metrics, sizeof(access_metrics) / sizeof(access_metrics[0]));
+    }
 
-    if (context) {
-        LOG_HTTP_DEBUG("Found client context, current content type: %d", (int)context->content_type);
+    catzilla_metrics_write_latency(text);
+    catzilla_metrics_write_counters(text);
+}
 
-        // Copy content type directly
-        request->content_type = context->content_type;
-        LOG_HTTP_DEBUG("Set request content_type from context: %d (%s)",
-            (int)request->content_type,
-            request->content_type == CONTENT_TYPE_JSON ? "application/json" :
-            request->content_type == CONTENT_TYPE_FORM ? "application/x-www-form-urlencoded" : "none");
+static void release_metrics_text(void* owner, const char* body, size_t body_len) {
+    (void)body;
+    (void)body_len;
+    free(owner);
+}
 
-        // Pre-parse based on content type
-        if (request->content_type == CONTENT_TYPE_JSON) {
-            LOG_HTTP_DEBUG("Pre-parsing JSON content");
-            if (catzilla_parse_json(request) == 0) {
-                LOG_HTTP_DEBUG("JSON parsing successful");
-            } else {
-                LOG_HTTP_DEBUG("JSON parsing failed");
-            }
-        } else if (request->content_type == CONTENT_TYPE_FORM) {
-            LOG_HTTP_DEBUG("Parsing form data");
-            if (catzilla_parse_form(request) == 0) {
-                LOG_HTTP_DEBUG("Form parsing successful");
-            } else {
-                LOG_HTTP_DEBUG("Form parsing failed");
-            }
-        } else if (request->content_type == CONTENT_TYPE_MULTIPART) {
-            LOG_HTTP_DEBUG("Pre-parsing multipart content");
-            // Pass the context for boundary extraction
-            if (catzilla_parse_multipart_with_context(request, context) == 0) {
-                LOG_HTTP_DEBUG("Multipart parsing successful");
-            } else {
-                LOG_HTTP_DEBUG("Multipart parsing failed");
-            }
-        } else {
-            LOG_HTTP_DEBUG("Unknown content type: %d", request->content_type);
-        }
-    } else {
-        LOG_HTTP_DEBUG("No client context found, using NONE content type");
-        request->content_type = CONTENT_TYPE_NONE;
+// Prometheus scrape: every subsystem's counters and the latency histograms,
+// gathered on the loop thread without the GIL
+static int serve_metrics(uv_stream_t* client, const catzilla_request_t* request, void* user_data) {
+    (void)request;
+    catzilla_metrics_text_t text;
+    catzilla_metrics_text_init(&text);
+    write_server_metrics(&text, (catzilla_server_t*)user_data);
+    if (text.failed || !text.data) {
+        catzilla_metrics_text_free(&text);
+        return -1;
     }
 
-    // Create request capsule with destructor
-    PyObject* request_capsule = PyCapsule_New(request, "catzilla.request", request_capsule_destructor);
-    if (!request_capsule) {
-        if (request->json_doc) yyjson_doc_free(request->json_doc);
-        catzilla_request_free(request->body);
-        catzilla_request_free(request);
-        return NULL;
-    }
+    catzilla_send_response_zerocopy(client, 200,
+                                    "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                                    "Cache-Control: no-store\r\n",
+                                    text.data, text.length, release_metrics_text, text.data);
+    return 0;
+}
 
-    // Build arguments tuple: (client_capsule, method, path, body, request_capsule, route_match_info)
-    // For multipart/form-data, we don't need the raw body in Python since files are handled separately
-    const char* body_for_python;
-    if (request->content_type == CONTENT_TYPE_MULTIPART) {
-        // For multipart, use empty string since files are accessed via get_files()
-        body_for_python = "";
-    } else {
-        // For other content types, use the body as string (safe for text data)
-        body_for_python = body ? body : "";
-    }
-    PyObject* args = Py_BuildValue(
-        "(OsssOO)",
-        client_capsule,
-        method,
-        path,
-        body_for_python,
-        request_capsule,
-        route_match_info ? route_match_info : Py_None
-    );
-    if (!args) {
-        Py_DECREF(request_capsule);  // This will call the destructor to free request memory
-        return NULL;
-    }
+int catzilla_server_set_metrics_endpoint(catzilla_server_t* server, const char* path) {
+    if (!server || !path) return -1;
+    if (catzilla_server_set_native_handler(server, "GET", path, serve_metrics, server) != 0) return -1;
+    server->latency_metrics = true;
+    return 0;
+}
 
-    // Call the Python function
-    PyObject* result = PyObject_CallObject(callback, args);
-    Py_DECREF(args);
-    Py_DECREF(request_capsule);
+int catzilla_server_set_latency_metrics(catzilla_server_t* server, bool enabled) {
+    if (!server || server->is_running) return -1;
+    server->latency_metrics = enabled;
+    return 0;
+}
 
-    if (!result) {
-        PyErr_Print();
-        return NULL;
-    }
-    return result;
+int catzilla_server_set_access_log(catzilla_server_t* server,
+                                   const char* path,
+                                   const catzilla_access_log_config_t* config,
+                                   double sample_rate) {
+    if (!server || server->is_running) return -1;
+    catzilla_access_log_t* log = catzilla_access_log_open(path, config);
+    if (!log) return -1;
+    catzilla_access_log_set_sample_rate(log, sample_rate);
+    catzilla_access_log_close(server->access_log);
+    server->access_log = log;
+    return 0;
 }
 
-int catzilla_parse_json(catzilla_request_t* request) {
-    if (!request || !request->body || request->body_length == 0) {
-        LOG_HTTP_DEBUG("JSON parse failed: no request, body, or zero length");
+int catzilla_server_set_route_access_log_sample(catzilla_server_t* server,
+                                                const char* method,
+                                                const char* path,
+                                                double sample_rate) {
+    if (!server || !method || !path || !server->access_log || server->is_running) return -1;
+    catzilla_route_t* route = find_registered_route(server, method, path);
+    if (!route) {
+        LOG_SERVER_ERROR("Cannot sample the access log: no route %s %s", method, path);
         return -1;
     }
+    return catzilla_access_log_set_route_sample_rate(server->access_log, route->id, sample_rate);
+}
 
-    // Check if already parsed
-    if (request->is_json_parsed) {
-        LOG_HTTP_DEBUG("JSON already parsed");
-        return 0;
+static void release_one_route_state(catzilla_route_t* route) {
+    if (route->cache_policy) {
+        catzilla_cache_free(route->cache_policy);
+        route->cache_policy = NULL;
     }
-
-    // Check content type - allow parsing if it's JSON type
-    if (request->content_type != CONTENT_TYPE_JSON) {
-        LOG_HTTP_DEBUG("JSON parse failed: wrong content type (%d)", request->content_type);
-        return -1;
+    catzilla_native_route_t* native = route->native;
+    if (native) {
+        native_response_unref(native->response);
+        uv_rwlock_destroy(&native->lock);
+        catzilla_cache_free(native);
+        route->native = NULL;
     }
+}
 
-    LOG_HTTP_DEBUG("Parsing JSON body: '%s'", request->body);
-
-    // Initialize JSON fields
-    if (request->json_doc) {
-        yyjson_doc_free(request->json_doc);
+// Free the state routes carry beyond the router's own (native responses,
+// cache policies), including routes removed while serving
+static void release_route_state(catzilla_server_t* server) {
+    for (int i = 0; i < server->router.route_count; i++) {
+        if (server->router.routes[i]) release_one_route_state(server->router.routes[i]);
     }
-    request->json_doc = NULL;
-    request->json_root = NULL;
+    for (catzilla_route_t* route = server->router.retired_routes; route; route = route->next_retired) {
+        release_one_route_state(route);
+    }
+}
 
-    // Parse JSON using yyjson
-    yyjson_read_flag flg = YYJSON_READ_NOFLAG;
-    yyjson_read_err err;
-    request->json_doc = yyjson_read_opts(request->body, request->body_length, flg, NULL, &err);
+// Answer a native route on the loop thread; never touches Python
+static void serve_native_route(client_context_t* context, const catzilla_route_match_t* match, const char* path) {
+    catzilla_native_route_t* native = match->route->native;
+    uv_stream_t* client = (uv_stream_t*)&context->client;
+    catzilla_atomic_fetch_add(&stat_native_responses, 1);
 
-    if (!request->json_doc) {
-        LOG_HTTP_DEBUG("JSON parse error: %s at position %zu", err.msg, err.pos);
-        request->is_json_parsed = true;  // Mark as parsed even if failed
-        return -1;
+    catzilla_native_handler_fn handler;
+    void* user_data;
+    catzilla_native_response_t* response = native_response_acquire(native, &handler, &user_data);
+    if (!response && handler) {
+        catzilla_request_t request;
+        memset(&request, 0, sizeof(request));
+        strncpy(request.method, context->method, CATZILLA_METHOD_MAX - 1);
+        strncpy(request.path, path, CATZILLA_PATH_MAX - 1);
+        request.body = context->body;
+        request.body_length = context->body_length;
+        request.content_type = context->content_type;
+        request.headers = context->headers;
+        request.remote_addr = context->remote_addr[0] ? context->remote_addr : NULL;
+        populate_path_params(&request, match);
+
+        if (handler(client, &request, user_data) != 0) {
+            send_response_with_connection(client, 500, "text/plain", "500 Internal Server Error",
+                                          strlen("500 Internal Server Error"), context->keep_alive);
+        }
+        catzilla_arena_reset(&request.arena);
+        return;
     }
 
-    request->json_root = yyjson_doc_get_root(request->json_doc);
-    if (!request->json_root) {
-        LOG_HTTP_DEBUG("JSON parse error: no root object");
-        yyjson_doc_free(request->json_doc);
-        request->json_doc = NULL;
-        request->is_json_parsed = true;  // Mark as parsed even if failed
-        return -1;
+    if (!response) {
+        send_response_with_connection(client, 500, "text/plain", "500 Internal Server Error",
+                                      strlen("500 Internal Server Error"), context->keep_alive);
+        return;
     }
+    catzilla_send_response_zerocopy(client, response->status_code, response->headers,
+                                    response->body, response->body_len,
+                                    release_native_response_body, response);
+}
 
-    LOG_HTTP_DEBUG("JSON parsed successfully");
-    request->is_json_parsed = true;
+#define CATZILLA_RESPONSE_CACHE_CAPACITY 10000
+
+static int ensure_response_cache(catzilla_server_t* server) {
+    if (server->response_cache) return 0;
+    cache_config_t config = { CATZILLA_RESPONSE_CACHE_CAPACITY, 0, 0, 3600, 100 * 1024 * 1024, false, false, CACHE_CODEC_NONE, 0, 0, CACHE_EVICTION_CLOCK };
+    server->response_cache = multi_cache_create(&config, NULL, NULL);
+    if (!server->response_cache) return -1;
+    // Every route brings its own TTL; no tier shortens it
+    server->response_cache->memory_ttl = 0;
+    server->response_cache->redis_ttl = 0;
+    server->response_cache->disk_ttl = 0;
     return 0;
 }
 
-int catzilla_parse_form(catzilla_request_t* request) {
-    if (!request || !request->body || request->body_length == 0) {
-        LOG_HTTP_DEBUG("Form parse failed: no request, body, or zero length");
+int catzilla_server_set_route_cache(catzilla_server_t* server,
+                                    const char* method,
+                                    const char* path,
+                                    uint32_t ttl_seconds,
+                                    bool vary_query,
+                                    const char* vary_headers) {
+    if (!server || !method || !path) return -1;
+
+    catzilla_route_t* route = find_registered_route(server, method, path);
+    if (!route) {
+        LOG_SERVER_ERROR("Cannot cache responses: no route %s %s", method, path);
         return -1;
     }
 
-    // Check if already parsed
-    if (request->is_form_parsed) {
-        LOG_HTTP_DEBUG("Form data already parsed");
+    if (ttl_seconds == 0) {
+        catzilla_cache_free(route->cache_policy);
+        route->cache_policy = NULL;
         return 0;
     }
 
-    // Check content type - allow parsing if it's form type
-    if (request->content_type != CONTENT_TYPE_FORM) {
-        LOG_HTTP_DEBUG("Form parse failed: wrong content type (%d)", request->content_type);
-        return -1;
+    catzilla_route_cache_policy_t policy;
+    memset(&policy, 0, sizeof(policy));
+    policy.ttl_seconds = ttl_seconds;
+    policy.vary_query = vary_query;
+
+    // Split "Accept-Language, X-Tenant" into trimmed names
+    const char* cursor = vary_headers;
+    while (cursor && *cursor) {
+        while (*cursor == ' ' || *cursor == ',') cursor++;
+        const char* end = cursor;
+        while (*end && *end != ',') end++;
+        const char* last = end;
+        while (last > cursor && last[-1] == ' ') last--;
+        size_t length = (size_t)(last - cursor);
+        if (length > 0) {
+            if (policy.vary_header_count == CATZILLA_CACHE_VARY_MAX || length >= CATZILLA_PARAM_NAME_MAX) {
+                LOG_SERVER_ERROR("Cannot cache responses: too many or too long vary headers");
+                return -1;
+            }
+            memcpy(policy.vary_headers[policy.vary_header_count], cursor, length);
+            policy.vary_headers[policy.vary_header_count][length] = '\0';
+            policy.vary_header_count++;
+        }
+        cursor = end;
     }
 
-    LOG_HTTP_DEBUG("Parsing form data: '%s'", request->body);
+    if (ensure_response_cache(server) != 0) return -1;
+    if (!route->cache_policy) {
+        route->cache_policy = catzilla_cache_alloc(sizeof(catzilla_route_cache_policy_t));
+        if (!route->cache_policy) return -1;
+    }
+    *route->cache_policy = policy;
+    return 0;
+}
 
-    // Initialize form fields
-    request->form_field_count = 0;
-    for (int i = 0; i < CATZILLA_MAX_FORM_FIELDS; i++) {
-        request->form_fields[i] = NULL;
-        request->form_values[i] = NULL;
+int catzilla_server_set_response_cache_disk(catzilla_server_t* server,
+                                            const char* directory,
+                                            uint64_t max_bytes) {
+    if (!server || !directory || ensure_response_cache(server) != 0) return -1;
+    catzilla_disk_cache_config_t config = {0};
+    config.max_bytes = max_bytes;
+    if (multi_cache_attach_disk(server->response_cache, directory, &config) != 0) {
+        LOG_SERVER_ERROR("Cannot use %s for the response cache disk tier", directory);
+        return -1;
     }
+    return 0;
+}
 
-    // Parse form data
-    char* body = strdup(request->body);  // Create a copy we can modify
-    if (!body) {
-        LOG_HTTP_DEBUG("Form parse error: memory allocation failed");
-        request->is_form_parsed = true;  // Mark as parsed even if failed
+int catzilla_server_set_response_cache_redis(catzilla_server_t* server,
+                                             const char* url,
+                                             const char* key_prefix,
+                                             int pool_size) {
+    if (!server || !url || ensure_response_cache(server) != 0) return -1;
+    if (server->is_running) {
+        LOG_SERVER_ERROR("The response cache Redis tier must be set before the server starts");
+        return -1;
+    }
+    catzilla_redis_config_t config = {0};
+    config.pool_size = pool_size;
+    if (multi_cache_enable_redis(server->response_cache, url, key_prefix, &config) != 0) {
+        LOG_SERVER_ERROR("Cannot use Redis for the response cache");
         return -1;
     }
+    return 0;
+}
 
-    char* token;
-    char* rest = body;
+// Each loop talks to Redis through its own client
+static void attach_response_cache_redis(catzilla_server_t* server, uv_loop_t* loop) {
+    if (server->response_cache && server->response_cache->redis_enabled &&
+        multi_cache_attach_redis_loop(server->response_cache, loop) != 0) {
+        LOG_SERVER_WARN("Response cache Redis tier unavailable on this loop");
+    }
+}
 
-    while ((token = strtok_r(rest, "&", &rest))) {
-        if (!token) break;  // Safety check
+static void detach_response_cache_redis(catzilla_server_t* server) {
+    if (server->response_cache) {
+        multi_cache_detach_redis_loop(server->response_cache);
+    }
+}
 
-        char* key = token;
-        char* value = strchr(token, '=');
+int catzilla_server_set_clamd(catzilla_server_t* server, const char* address, int pool_size) {
+    if (!server || !address) return -1;
+    if (server->is_running) {
+        LOG_SERVER_ERROR("clamd must be set before the server starts");
+        return -1;
+    }
+    if (!catzilla_clamd_address_valid(address)) {
+        LOG_SERVER_ERROR("Invalid clamd address: %s", address);
+        return -1;
+    }
+    char* copy = strdup(address);
+    if (!copy) return -1;
+    free(server->clamd_address);
+    server->clamd_address = copy;
+    server->clamd_pool_size = pool_size;
+    return 0;
+}
 
-        if (value) {
-            *value = '\0';  // Split key=value
-            value++;
+int catzilla_server_set_upload_options(catzilla_server_t* server, unsigned digests, bool direct_io) {
+    if (!server || (digests & ~(CATZILLA_DIGEST_SHA256 | CATZILLA_DIGEST_CRC32C))) return -1;
+    server->upload_digests = digests;
+    server->upload_direct_io = direct_io;
+    return 0;
+}
 
-            // Check for empty key or value
-            if (!key || strlen(key) == 0) {
-                LOG_HTTP_DEBUG("Form parse warning: empty key found");
-                continue;
-            }
+// Each loop streams uploads to clamd through its own client
+static void attach_clamd(catzilla_server_t* server, uv_loop_t* loop) {
+    if (!server->clamd_address) return;
+    catzilla_clamd_config_t config = {0};
+    config.pool_size = server->clamd_pool_size;
+    loop_clamd = catzilla_clamd_create(loop, server->clamd_address, &config);
+    if (!loop_clamd) {
+        LOG_SERVER_WARN("Upload virus scanning unavailable on this loop");
+    }
+}
 
-            // URL decode key and value
-            char* decoded_key = catzilla_request_alloc(strlen(key) + 1);
-            char* decoded_value = catzilla_request_alloc(strlen(value) + 1);
+static void detach_clamd(void) {
+    catzilla_clamd_close(loop_clamd);
+    loop_clamd = NULL;
+}
 
-            if (!decoded_key || !decoded_value) {
-                catzilla_request_free(decoded_key);
-                catzilla_request_free(decoded_value);
-                free(body);  // Use regular free for strdup
-                LOG_HTTP_DEBUG("Form parse error: memory allocation failed");
-                request->is_form_parsed = true;  // Mark as parsed even if failed
-                return -1;
-            }
+int catzilla_server_set_cache_snapshot(catzilla_server_t* server, const char* directory) {
+    if (!server || !directory || !*directory) return -1;
+    if (server->is_running) {
+        LOG_SERVER_ERROR("The cache snapshot directory must be set before the server starts");
+        return -1;
+    }
+    if (mkdir(directory, 0755) != 0 && errno != EEXIST) {
+        LOG_SERVER_ERROR("Cannot create cache snapshot directory %s: %s", directory, strerror(errno));
+        return -1;
+    }
+    char* copy = strdup(directory);
+    if (!copy) return -1;
+    free(server->cache_snapshot_dir);
+    server->cache_snapshot_dir = copy;
+    return 0;
+}
 
-            // Simple URL decode (can be enhanced)
-            url_decode(key, decoded_key);
-            url_decode(value, decoded_value);
+int catzilla_server_set_handoff(catzilla_server_t* server, const char* socket_path,
+                                uint64_t drain_timeout_ms) {
+    if (!server || !socket_path || !*socket_path) return -1;
+    if (server->is_running) {
+        LOG_SERVER_ERROR("The handoff socket must be set before the server starts");
+        return -1;
+    }
+#ifdef _WIN32
+    (void)drain_timeout_ms;
+    LOG_SERVER_ERROR("Listener handoff is not supported on Windows");
+    return -1;
+#else
+    char* copy = strdup(socket_path);
+    if (!copy) return -1;
+    free(server->handoff_path);
+    server->handoff_path = copy;
+    server->drain_timeout_ms = drain_timeout_ms;
+    return 0;
+#endif
+}
 
-            LOG_HTTP_DEBUG("Form field: %s = %s", decoded_key, decoded_value);
+// Snapshot file of the response cache (mount NULL) or of a mount's file cache
+static bool cache_snapshot_path(const catzilla_server_t* server, const catzilla_server_mount_t* mount,
+                                char* out, size_t out_size) {
+    int length = mount
+        ? snprintf(out, out_size, "%s/static-%08x.snapshot", server->cache_snapshot_dir,
+                   catzilla_cache_hash_key(mount->mount_path, strlen(mount->mount_path)))
+        : snprintf(out, out_size, "%s/response-cache.snapshot", server->cache_snapshot_dir);
+    return length > 0 && (size_t)length < out_size;
+}
 
-            if (request->form_field_count < CATZILLA_MAX_FORM_FIELDS) {
-                request->form_fields[request->form_field_count] = decoded_key;
-                request->form_values[request->form_field_count] = decoded_value;
-                request->form_field_count++;
-            } else {
-                LOG_HTTP_DEBUG("Form parse warning: maximum field count reached");
-                catzilla_request_free(decoded_key);
-                catzilla_request_free(decoded_value);
-                break;
-            }
-        } else {
-            LOG_HTTP_DEBUG("Form parse warning: field without '=' found: %s", token);
+// Runs before the loops start; a missing snapshot is a cold start
+static void load_cache_snapshots(catzilla_server_t* server) {
+    if (!server->cache_snapshot_dir) return;
+    char path[CATZILLA_PATH_MAX];
+    if (server->response_cache && cache_snapshot_path(server, NULL, path, sizeof(path))) {
+        catzilla_cache_load_snapshot(server->response_cache->memory_cache, path);
+    }
+    for (catzilla_server_mount_t* mount = server->static_mounts; mount; mount = mount->next) {
+        hot_cache_t* cache = mount->static_server ? mount->static_server->cache : NULL;
+        if (cache && cache_snapshot_path(server, mount, path, sizeof(path))) {
+            catzilla_static_cache_load_snapshot(cache, path, mount->directory_path);
         }
     }
-
-    free(body);  // Use regular free for strdup
-    LOG_HTTP_DEBUG("Form parsed successfully with %d fields", request->form_field_count);
-    request->is_form_parsed = true;
-    return 0;
 }
 
-int catzilla_parse_multipart(catzilla_request_t* request) {
-    if (!request || !request->body || request->body_length == 0) {
-        LOG_HTTP_DEBUG("Multipart parse failed: no request, body, or zero length");
-        return -1;
+// Runs once every loop has stopped
+static void save_cache_snapshots(catzilla_server_t* server) {
+    if (!server->cache_snapshot_dir) return;
+    char path[CATZILLA_PATH_MAX];
+    if (server->response_cache && cache_snapshot_path(server, NULL, path, sizeof(path)) &&
+        catzilla_cache_save_snapshot(server->response_cache->memory_cache, path) != 0) {
+        LOG_SERVER_WARN("Response cache snapshot not saved");
+    }
+    for (catzilla_server_mount_t* mount = server->static_mounts; mount; mount = mount->next) {
+        hot_cache_t* cache = mount->static_server ? mount->static_server->cache : NULL;
+        if (cache && cache_snapshot_path(server, mount, path, sizeof(path)) &&
+            catzilla_static_cache_save_snapshot(cache, path) != 0) {
+            LOG_SERVER_WARN("Static file cache snapshot for %s not saved", mount->mount_path);
+        }
     }
+}
 
-    // Check content type - only parse if it's multipart type
-    if (request->content_type != CONTENT_TYPE_MULTIPART) {
-        LOG_HTTP_DEBUG("Multipart parse failed: wrong content type (%d)", request->content_type);
+int catzilla_server_set_memory_budget(catzilla_server_t* server, uint64_t budget_bytes,
+                                      uint64_t interval_ms, uint64_t upload_limit) {
+    if (!server) return -1;
+    if (server->is_running) {
+        LOG_SERVER_ERROR("The memory budget must be set before the server starts");
         return -1;
     }
+    server->memory_budget = budget_bytes;
+    server->memory_check_interval_ms = interval_ms > 0 ? interval_ms : CATZILLA_DEFAULT_MEMORY_CHECK_INTERVAL_MS;
+    server->pressure_upload_limit = upload_limit > 0 ? upload_limit : CATZILLA_DEFAULT_PRESSURE_UPLOAD_LIMIT;
+    return 0;
+}
 
-    LOG_HTTP_DEBUG("Parsing multipart data: %zu bytes", request->body_length);
+catzilla_memory_pressure_t catzilla_server_memory_pressure(void) {
+    return (catzilla_memory_pressure_t)catzilla_atomic_load(&stat_memory_pressure_level);
+}
 
-    // Initialize multipart parser - allocate on heap to avoid stack issues
-    multipart_parser_t* parser = catzilla_request_alloc(sizeof(multipart_parser_t));
-    if (!parser) {
-        LOG_HTTP_DEBUG("Failed to allocate multipart parser");
-        return -1;
+// Free the pooled buffers and contexts of the calling loop
+static void trim_loop_pools(void) {
+    catzilla_read_pool_trim();
+    catzilla_arena_pool_trim();
+    catzilla_compression_trim();
+    catzilla_di_instance_pool_trim();
+    trim_client_context_pool();
+}
+
+// Called from each loop's timeout tick
+static void trim_pools_if_asked(void) {
+    uint64_t generation = catzilla_atomic_load(&memory_trim_generation);
+    if (generation != loop_trim_generation) {
+        loop_trim_generation = generation;
+        trim_loop_pools();
     }
-    memset(parser, 0, sizeof(multipart_parser_t));
+}
 
-    // For now, we need the content-type header to extract boundary
-    // This is a simplified implementation - in practice, we'd need access to the full Content-Type header
-    // to extract the boundary parameter
-    const char* dummy_content_type = "multipart/form-data; boundary=----WebKitFormBoundary7MA4YWxkTrZu0gW";
+// What the governor shrinks, in priority order: the response cache goes
+// first, the per-loop pools and the allocator's free pages last
+enum {
+    PRESSURE_TIER_RESPONSE_CACHE,
+    PRESSURE_TIER_STATIC_CACHES,
+    PRESSURE_TIER_POOLS,
+    PRESSURE_TIER_COUNT
+};
+
+// Shrink one tier to the share of its configured size that a level keeps.
+// Targets come from the configured sizes, not the current ones, so a tier
+// shrunk again for the same level stays where it is.
+static void shrink_tier(catzilla_server_t* server, int tier, catzilla_memory_pressure_t level) {
+    size_t keep = level == CATZILLA_MEMORY_PRESSURE_HARD ? 50 : 75;
+
+    switch (tier) {
+        case PRESSURE_TIER_RESPONSE_CACHE:
+            if (server->response_cache && server->response_cache->memory_cache) {
+                catzilla_cache_t* cache = server->response_cache->memory_cache;
+                if (server->response_cache_capacity == 0) server->response_cache_capacity = cache->capacity;
+                size_t target = server->response_cache_capacity * keep / 100;
+                if (target < CATZILLA_CACHE_MIN_SHARD_CAPACITY) target = CATZILLA_CACHE_MIN_SHARD_CAPACITY;
+                if (target < cache->capacity) catzilla_cache_resize(cache, target);
+            }
+            break;
+        case PRESSURE_TIER_STATIC_CACHES:
+            for (catzilla_server_mount_t* mount = server->static_mounts; mount; mount = mount->next) {
+                catzilla_static_server_t* static_server = mount->static_server;
+                if (static_server && static_server->cache) {
+                    size_t limit = (size_t)static_server->config.cache_size_mb * 1024 * 1024;
+                    catzilla_static_cache_set_limit(static_server->cache, limit / 100 * keep);
+                }
+            }
+            break;
+        case PRESSURE_TIER_POOLS:
+            // Worker loops trim theirs on their next tick
+            catzilla_atomic_fetch_add(&memory_trim_generation, 1);
+            loop_trim_generation = catzilla_atomic_load(&memory_trim_generation);
+            trim_loop_pools();
+            catzilla_memory_release_unused(level == CATZILLA_MEMORY_PRESSURE_HARD);
+            break;
+        default:
+            break;
+    }
+}
 
-    if (catzilla_multipart_parse_init(parser, dummy_content_type) != 0) {
-        LOG_HTTP_DEBUG("Failed to initialize multipart parser");
-        catzilla_request_free(parser);
-        return -1;
+// Give the caches their configured sizes back
+static void restore_after_pressure(catzilla_server_t* server) {
+    if (server->response_cache && server->response_cache_capacity > 0) {
+        catzilla_cache_resize(server->response_cache->memory_cache, server->response_cache_capacity);
+        server->response_cache_capacity = 0;
+    }
+    for (catzilla_server_mount_t* mount = server->static_mounts; mount; mount = mount->next) {
+        catzilla_static_server_t* static_server = mount->static_server;
+        if (static_server && static_server->cache) {
+            catzilla_static_cache_set_limit(static_server->cache,
+                                            (size_t)static_server->config.cache_size_mb * 1024 * 1024);
+        }
     }
+    server->pressure_level = CATZILLA_MEMORY_PRESSURE_NONE;
+    server->pressure_tier = 0;
+}
 
-    // Parse the multipart data
-    int parse_result = catzilla_multipart_parse_chunk(parser, request->body, request->body_length);
-    if (parse_result != 0) {
-        LOG_HTTP_DEBUG("Failed to parse multipart data (error: %d)", parse_result);
-        catzilla_multipart_parser_cleanup(parser);
-        catzilla_request_free(parser);
-        return -1;
+static void on_memory_check(uv_timer_t* timer) {
+    catzilla_server_t* server = (catzilla_server_t*)timer->data;
+    size_t rss = catzilla_memory_get_rss();
+    if (rss == 0) return;  // Nothing to go by on this platform
+    catzilla_atomic_store(&stat_memory_rss, rss);
+
+    catzilla_memory_pressure_t previous = catzilla_server_memory_pressure();
+    catzilla_memory_pressure_t level;
+    bool easing = false;
+    if (rss >= server->memory_budget) {
+        level = CATZILLA_MEMORY_PRESSURE_HARD;
+    } else if (rss >= server->memory_budget / 100 * CATZILLA_MEMORY_SOFT_PERCENT) {
+        level = CATZILLA_MEMORY_PRESSURE_SOFT;
+    } else if (rss < server->memory_budget / 100 * CATZILLA_MEMORY_CLEAR_PERCENT) {
+        level = CATZILLA_MEMORY_PRESSURE_NONE;
+    } else {
+        // Between the marks pressure eases to soft but does not clear
+        level = previous == CATZILLA_MEMORY_PRESSURE_NONE ? previous : CATZILLA_MEMORY_PRESSURE_SOFT;
+        easing = true;
+    }
+    catzilla_atomic_store(&stat_memory_pressure_level, level);
+
+    if (level > previous) {
+        catzilla_atomic_fetch_add(&stat_memory_pressure_events, 1);
+        LOG_SERVER_WARN("Memory pressure %s: %zu MB resident of a %llu MB budget",
+                        level == CATZILLA_MEMORY_PRESSURE_HARD ? "hard" : "soft", rss >> 20,
+                        (unsigned long long)(server->memory_budget >> 20));
+    } else if (level == CATZILLA_MEMORY_PRESSURE_NONE && previous != CATZILLA_MEMORY_PRESSURE_NONE) {
+        LOG_SERVER_INFO("Memory pressure cleared: %zu MB resident", rss >> 20);
+        restore_after_pressure(server);
     }
 
-    parse_result = catzilla_multipart_parse_complete(parser);
-    if (parse_result != 0) {
-        LOG_HTTP_DEBUG("Failed to complete multipart parsing (error: %d)", parse_result);
-        catzilla_multipart_parser_cleanup(parser);
-        catzilla_request_free(parser);
-        return -1;
+    if (level == CATZILLA_MEMORY_PRESSURE_NONE) return;
+
+    // A higher level than the tiers were shrunk for starts over from the
+    // first tier with smaller targets; otherwise the next tier is shrunk
+    // while the level's mark is still passed, until none is left
+    if (level > server->pressure_level) {
+        server->pressure_level = level;
+        server->pressure_tier = 0;
+    } else if (level < server->pressure_level || easing) {
+        return;
     }
+    if (server->pressure_tier >= PRESSURE_TIER_COUNT) return;
+    shrink_tier(server, server->pressure_tier++, level);
+    catzilla_atomic_fetch_add(&stat_memory_shrinks, 1);
+}
 
-    LOG_HTTP_DEBUG("Multipart parsing completed, found %zu files", parser->files_count);
+static int start_memory_governor(catzilla_server_t* server) {
+    catzilla_atomic_store(&stat_memory_pressure_level, CATZILLA_MEMORY_PRESSURE_NONE);
+    if (server->memory_budget == 0) return 0;
 
-    // Store the parsed files in the request structure
-    request->file_count = 0;
-    request->has_files = false;
+    int rc = uv_timer_init(server->loop, &server->memory_timer);
+    if (rc) return rc;
+    server->memory_timer.data = server;
+    rc = uv_timer_start(&server->memory_timer, on_memory_check,
+                        server->memory_check_interval_ms, server->memory_check_interval_ms);
+    if (rc) return rc;
 
-    if (parser->files && parser->files_count > 0) {
-        size_t files_to_copy = parser->files_count;
-        if (files_to_copy > CATZILLA_MAX_FILES) {
-            files_to_copy = CATZILLA_MAX_FILES;
-            LOG_HTTP_DEBUG("Warning: truncating files from %zu to %d", parser->files_count, CATZILLA_MAX_FILES);
-        }
+    // The check alone must not keep the loop running
+    uv_unref((uv_handle_t*)&server->memory_timer);
+    return 0;
+}
 
-        for (size_t i = 0; i < files_to_copy; i++) {
-            if (parser->files[i]) {
-                request->files[i] = parser->files[i];
-                // Increase reference count since we're storing it in the request
-                catzilla_upload_file_ref(parser->files[i]);
-                request->file_count++;
+// Under hard pressure bodies above the limit are refused before they are read
+static bool refuse_under_pressure(const client_context_t* context, uint64_t body_bytes) {
+    return catzilla_server_memory_pressure() == CATZILLA_MEMORY_PRESSURE_HARD &&
+           body_bytes > context->server->pressure_upload_limit;
+}
 
-                LOG_HTTP_DEBUG("File %zu: filename=%s, size=%llu, temp_path=%s",
-                              i,
-                              parser->files[i]->filename ? parser->files[i]->filename : "unknown",
-                              (unsigned long long)parser->files[i]->size,
-                              parser->files[i]->temp_file_path ? parser->files[i]->temp_file_path : "none");
-            }
-        }
+void catzilla_server_clear_response_cache(catzilla_server_t* server) {
+    if (server && server->response_cache) {
+        multi_cache_clear(server->response_cache);
+    }
+}
 
-        if (request->file_count > 0) {
-            request->has_files = true;
-            LOG_HTTP_DEBUG("Stored %d files in request", request->file_count);
+// Longest response cache key: catzilla_cache_generate_key plus a variant suffix
+#define RESPONSE_CACHE_KEY_MAX (CATZILLA_METHOD_MAX + 2 * CATZILLA_PATH_MAX + 16 + \
+                                CATZILLA_HTTP_CACHE_VARIANT_SUFFIX_LEN)
+
+static void release_cached_response(void* owner, const char* body, size_t body_len) {
+    (void)body;
+    (void)body_len;
+    catzilla_response_free(owner);
+}
+
+typedef enum {
+    RESPONSE_CACHE_MISS = 0,
+    RESPONSE_CACHE_HIT,
+    RESPONSE_CACHE_PENDING  // Redis was asked; the request waits for its answer
+} response_cache_outcome_t;
+
+// Redis lookup owned by the cache until it answers; context is cleared when
+// the connection closes first
+typedef struct response_cache_lookup_s {
+    client_context_t* context;
+    bool variant;             // Asking for a variant key; a variants entry is not followed again
+    char key[RESPONSE_CACHE_KEY_MAX];
+} response_cache_lookup_t;
+
+static void on_remote_cached_response(void* data, const void* value, size_t size);
+static int keep_dispatch_match(client_context_t* ctx, const catzilla_route_match_t* match);
+
+// Answer a request whose preconditions hold with a 304 built from the entry
+static bool send_not_modified(client_context_t* context, const catzilla_cached_view_t* view) {
+    size_t capacity = view->headers_len + 48;
+    char* headers = catzilla_response_alloc(capacity);
+    if (!headers) return false;
+    if (catzilla_http_cache_not_modified_headers(view, headers, capacity) == 0) {
+        catzilla_response_free(headers);
+        return false;
+    }
+    send_response_buffers((uv_stream_t*)&context->client, 304, headers, NULL, 0,
+                          context->keep_alive, NULL, NULL);
+    catzilla_response_free(headers);
+    catzilla_atomic_fetch_add(&stat_response_cache_not_modified, 1);
+    return true;
+}
+
+// Write a stored response, or a 304 when the request's preconditions hold;
+// takes ownership of the entry. False if it is malformed or not a response.
+static bool send_cached_entry(client_context_t* context, char* entry, size_t size) {
+    catzilla_cached_view_t view;
+    if (entry && catzilla_http_cache_decode(entry, size, &view) && view.kind == CATZILLA_CACHED_RESPONSE) {
+        if (catzilla_http_cache_not_modified(&view, &context->headers) && send_not_modified(context, &view)) {
+            catzilla_response_free(entry);
+            return true;
         }
-    } else {
-        LOG_HTTP_DEBUG("No files found in multipart data");
+        send_response_buffers((uv_stream_t*)&context->client, view.status_code,
+                              view.headers, view.body, view.body_len,
+                              context->keep_alive, release_cached_response, entry);
+        return true;
     }
+    catzilla_response_free(entry);
+    return false;
+}
 
-    // Clean up
-    catzilla_multipart_parser_cleanup(parser);
-    catzilla_request_free(parser);
-    return 0;
+// Turn a base key into the key of the variant a request wants, if the entry
+// stored under the base key lists Vary names. False for any other entry.
+static bool follow_variants(client_context_t* context, const char* entry, size_t size, char* key) {
+    catzilla_cached_view_t view;
+    if (!entry || !catzilla_http_cache_decode(entry, size, &view) || view.kind != CATZILLA_CACHED_VARIANTS) {
+        return false;
+    }
+    uint32_t hash = catzilla_http_cache_variant_hash(view.headers, view.headers_len, &context->headers);
+    catzilla_http_cache_variant_key(key, hash);
+    return true;
 }
 
-// Enhanced multipart parsing with context for boundary extraction
-int catzilla_parse_multipart_with_context(catzilla_request_t* request, void* context_ptr) {
-    client_context_t* context = (client_context_t*)context_ptr;
-    if (!request || !request->body || request->body_length == 0) {
-        LOG_HTTP_DEBUG("Multipart parse failed: no request, body, or zero length");
+// Ask Redis after the local tiers missed. The route match is kept for the
+// handler, which runs if Redis misses too.
+static int start_remote_cache_lookup(client_context_t* context, const catzilla_route_match_t* match,
+                                     const char* key, bool variant) {
+    multi_cache_t* cache = context->server->response_cache;
+    if (!cache->redis_enabled || keep_dispatch_match(context, match) != 0) return -1;
+
+    response_cache_lookup_t* lookup = catzilla_cache_alloc(sizeof(*lookup));
+    if (!lookup) return -1;
+    lookup->context = context;
+    lookup->variant = variant;
+    snprintf(lookup->key, sizeof(lookup->key), "%s", key);
+    if (multi_cache_fetch_remote(cache, lookup->key, on_remote_cached_response, lookup) != 0) {
+        catzilla_cache_free(lookup);
         return -1;
     }
+    context->cache_lookup = lookup;
+    return 0;
+}
 
-    // Check content type - only parse if it's multipart type
-    if (request->content_type != CONTENT_TYPE_MULTIPART) {
-        LOG_HTTP_DEBUG("Multipart parse failed: wrong content type (%d)", request->content_type);
-        return -1;
+static void cancel_remote_cache_lookup(client_context_t* ctx) {
+    if (ctx->cache_lookup) {
+        ctx->cache_lookup->context = NULL;
+        ctx->cache_lookup = NULL;
     }
+}
 
-    LOG_HTTP_DEBUG("Parsing multipart data: %zu bytes", request->body_length);
+// Look the request up in the response cache. Writes the response (or a 304)
+// on a hit; on a miss remembers the key so the handler's response is stored.
+// A miss in the local tiers of a Python route goes on to Redis without
+// blocking.
+static response_cache_outcome_t serve_cached_response(catzilla_server_t* server, client_context_t* context,
+                                                      const catzilla_route_match_t* match, const char* path) {
+    const catzilla_route_cache_policy_t* policy = match->route->cache_policy;
+    if (!server->response_cache || context->h2 || strcmp(context->method, "GET") != 0) {
+        return RESPONSE_CACHE_MISS;
+    }
 
-    // Initialize multipart parser - allocate on heap to avoid stack issues
-    multipart_parser_t* parser = catzilla_request_alloc(sizeof(multipart_parser_t));
-    if (!parser) {
-        LOG_HTTP_DEBUG("Failed to allocate multipart parser");
-        return -1;
+    uint32_t headers_hash = 0;
+    for (int i = 0; i < policy->vary_header_count; i++) {
+        size_t length = 0;
+        const char* value = catzilla_header_set_get(&context->headers, policy->vary_headers[i], &length);
+        // Absent and empty headers must not collide
+        uint32_t value_hash = value ? catzilla_cache_hash_key(value, length) : 0x9e3779b9u;
+        headers_hash = headers_hash * 31u + value_hash;
     }
-    memset(parser, 0, sizeof(multipart_parser_t));
 
-    // Use the real Content-Type header from context if available
-    const char* content_type_header = NULL;
-    if (context && context->content_type_header) {
-        content_type_header = context->content_type_header;
-        LOG_HTTP_DEBUG("Using real Content-Type header: %s", content_type_header);
-    } else {
-        // Fallback to dummy header
-        content_type_header = "multipart/form-data; boundary=----WebKitFormBoundary7MA4YWxkTrZu0gW";
-        LOG_HTTP_DEBUG("Using fallback Content-Type header: %s", content_type_header);
+    const char* query = NULL;
+    if (policy->vary_query) {
+        query = strchr(context->url, '?');
+        if (query) query++;
     }
 
-    if (catzilla_multipart_parse_init(parser, content_type_header) != 0) {
-        LOG_HTTP_DEBUG("Failed to initialize multipart parser");
-        catzilla_request_free(parser);
-        return -1;
+    char key[RESPONSE_CACHE_KEY_MAX];
+    if (catzilla_cache_generate_key(context->method, path, query, headers_hash, key,
+                                    sizeof(key) - CATZILLA_HTTP_CACHE_VARIANT_SUFFIX_LEN) < 0) {
+        return RESPONSE_CACHE_MISS;
+    }
+    size_t key_len = strlen(key);
+
+    // Responses with Vary sit under a variant key the base key points to
+    size_t size = 0;
+    char* entry = multi_cache_get_copy(server->response_cache, key, catzilla_response_alloc, &size);
+    bool variant = follow_variants(context, entry, size, key);
+    if (variant) {
+        catzilla_response_free(entry);
+        entry = multi_cache_get_copy(server->response_cache, key, catzilla_response_alloc, &size);
+    }
+    if (entry && send_cached_entry(context, entry, size)) {
+        catzilla_atomic_fetch_add(&stat_response_cache_hits, 1);
+        CATZILLA_PROBE2(response_cache_hit, context, context->access_route_id);
+        return RESPONSE_CACHE_HIT;
     }
 
-    // Parse the multipart data
-    int parse_result = catzilla_multipart_parse_chunk(parser, request->body, request->body_length);
-    if (parse_result != 0) {
-        LOG_HTTP_DEBUG("Failed to parse multipart data (error: %d)", parse_result);
-        catzilla_multipart_parser_cleanup(parser);
-        catzilla_request_free(parser);
-        return -1;
+    // The handler's response is stored from the base key: its own Vary
+    // decides the variant
+    catzilla_request_free(context->response_cache_key);
+    context->response_cache_key = catzilla_request_alloc(key_len + 1);
+    if (context->response_cache_key) {
+        memcpy(context->response_cache_key, key, key_len);
+        context->response_cache_key[key_len] = '\0';
+        context->response_cache_ttl = policy->ttl_seconds;
     }
 
-    parse_result = catzilla_multipart_parse_complete(parser);
-    if (parse_result != 0) {
-        LOG_HTTP_DEBUG("Failed to complete multipart parsing (error: %d)", parse_result);
-        catzilla_multipart_parser_cleanup(parser);
-        catzilla_request_free(parser);
-        return -1;
+    if (server->py_request_callback && start_remote_cache_lookup(context, match, key, variant) == 0) {
+        return RESPONSE_CACHE_PENDING;
     }
+    catzilla_atomic_fetch_add(&stat_response_cache_misses, 1);
+    CATZILLA_PROBE2(response_cache_miss, context, context->access_route_id);
+    return RESPONSE_CACHE_MISS;
+}
 
-    LOG_HTTP_DEBUG("Multipart parsing completed, found %zu files", parser->files_count);
+// Store the first response to a cache miss under the key remembered for it,
+// as the handler's Cache-Control and Vary allow. Returns the entry, whose
+// header block carries the validators the response goes out with, or NULL
+// when the response is not stored.
+static char* store_cached_response(client_context_t* context, int status_code, const char* headers,
+                                   const char* body, size_t body_len, size_t* size_out) {
+    char* key = context->response_cache_key;
+    context->response_cache_key = NULL;
+
+    multi_cache_t* cache = context->server->response_cache;
+    uint32_t ttl = cache && status_code == 200 ?
+        catzilla_http_cache_ttl(headers, context->response_cache_ttl) : 0;
+    char* entry = ttl > 0 ?
+        catzilla_http_cache_encode(status_code, headers, body, body_len, (int64_t)time(NULL), size_out) : NULL;
+    if (!entry) {
+        catzilla_request_free(key);
+        return NULL;
+    }
 
-    // Store the parsed files in the request structure
-    request->file_count = 0;
-    request->has_files = false;
+    char variant_key[RESPONSE_CACHE_KEY_MAX];
+    const char* stored_key = key;
+    char names[CATZILLA_HTTP_CACHE_VARY_LEN_MAX];
+    int names_len = catzilla_http_cache_vary_names(headers, names, sizeof(names));
+    if (names_len > 0 && strlen(key) + CATZILLA_HTTP_CACHE_VARIANT_SUFFIX_LEN < sizeof(variant_key)) {
+        size_t variants_size = 0;
+        char* variants = catzilla_http_cache_encode_variants(names, (size_t)names_len, &variants_size);
+        if (variants) {
+            multi_cache_set(cache, key, variants, variants_size, ttl);
+            catzilla_response_free(variants);
+        }
+        memcpy(variant_key, key, strlen(key) + 1);
+        catzilla_http_cache_variant_key(variant_key,
+            catzilla_http_cache_variant_hash(names, (size_t)names_len, &context->headers));
+        stored_key = variant_key;
+    }
+    if (multi_cache_set(cache, stored_key, entry, *size_out, ttl) == 0) {
+        catzilla_atomic_fetch_add(&stat_response_cache_stores, 1);
+    }
+    catzilla_request_free(key);
+    return entry;
+}
 
-    if (parser->files && parser->files_count > 0) {
-        size_t files_to_copy = parser->files_count;
-        if (files_to_copy > CATZILLA_MAX_FILES) {
-            files_to_copy = CATZILLA_MAX_FILES;
-            LOG_HTTP_DEBUG("Warning: truncating files from %zu to %d", parser->files_count, CATZILLA_MAX_FILES);
+void catzilla_server_get_connection_stats(catzilla_connection_stats_t* stats) {
+    if (!stats) return;
+    memset(stats, 0, sizeof(*stats));
+
+    stats->connections_accepted = catzilla_atomic_load(&stat_connections_accepted);
+    stats->accept_errors = catzilla_atomic_load(&stat_accept_errors);
+    stats->active_connections = catzilla_atomic_load(&stat_active_connections);
+    stats->context_pool_hits = catzilla_atomic_load(&stat_context_pool_hits);
+    stats->context_pool_misses = catzilla_atomic_load(&stat_context_pool_misses);
+    stats->context_pool_drops = catzilla_atomic_load(&stat_context_pool_drops);
+    stats->pooled_contexts = catzilla_atomic_load(&stat_context_pooled);
+    stats->header_timeouts = catzilla_atomic_load(&stat_header_timeouts);
+    stats->body_timeouts = catzilla_atomic_load(&stat_body_timeouts);
+    stats->keepalive_timeouts = catzilla_atomic_load(&stat_keepalive_timeouts);
+    stats->write_timeouts = catzilla_atomic_load(&stat_write_timeouts);
+    stats->accept_pauses = catzilla_atomic_load(&stat_accept_pauses);
+    stats->accept_resumes = catzilla_atomic_load(&stat_accept_resumes);
+    stats->tls_handshakes = catzilla_atomic_load(&stat_tls_handshakes);
+    stats->tls_resumptions = catzilla_atomic_load(&stat_tls_resumptions);
+    stats->tls_handshake_failures = catzilla_atomic_load(&stat_tls_handshake_failures);
+    stats->ktls_offloads = catzilla_atomic_load(&stat_ktls_offloads);
+    stats->native_responses = catzilla_atomic_load(&stat_native_responses);
+    stats->response_cache_hits = catzilla_atomic_load(&stat_response_cache_hits);
+    stats->response_cache_misses = catzilla_atomic_load(&stat_response_cache_misses);
+    stats->response_cache_stores = catzilla_atomic_load(&stat_response_cache_stores);
+    stats->response_cache_remote_hits = catzilla_atomic_load(&stat_response_cache_remote_hits);
+    stats->response_cache_not_modified = catzilla_atomic_load(&stat_response_cache_not_modified);
+    stats->python_batches = catzilla_atomic_load(&stat_python_batches);
+    stats->python_batched_requests = catzilla_atomic_load(&stat_python_batched_requests);
+    stats->python_batch_largest = catzilla_atomic_load(&stat_python_batch_largest);
+    stats->python_batch_budget_stops = catzilla_atomic_load(&stat_python_batch_budget_stops);
+    stats->corked_flushes = catzilla_atomic_load(&stat_corked_flushes);
+    stats->corked_responses = catzilla_atomic_load(&stat_corked_responses);
+    stats->memory_pressure_level = catzilla_atomic_load(&stat_memory_pressure_level);
+    stats->memory_pressure_events = catzilla_atomic_load(&stat_memory_pressure_events);
+    stats->memory_shrinks = catzilla_atomic_load(&stat_memory_shrinks);
+    stats->memory_rss = catzilla_atomic_load(&stat_memory_rss);
+    stats->pressure_rejections = catzilla_atomic_load(&stat_pressure_rejections);
+}
+
+// Pick the deadline for the connection's current phase. Header deadlines run
+// from the first byte of a request; body, keep-alive and write deadlines
+// restart whenever data moves.
+static void update_connection_timer(client_context_t* ctx, bool progress) {
+    if (!loop_connections.running || uv_is_closing((uv_handle_t*)&ctx->client)) return;
+
+    catzilla_server_t* server = ctx->server;
+    conn_timeout_kind_t kind = CONN_TIMEOUT_NONE;
+    uint64_t timeout_ms = 0;
+
+    if (ctx->writes_in_flight > 0) {
+        kind = CONN_TIMEOUT_WRITE;
+        timeout_ms = server->write_timeout;
+    } else {
+        switch (ctx->phase) {
+            case CONN_PHASE_AWAITING:
+            case CONN_PHASE_HEADERS:
+                kind = CONN_TIMEOUT_HEADER;
+                timeout_ms = server->header_timeout;
+                break;
+            case CONN_PHASE_BODY:
+                // A stream handler applying backpressure is not a slow client
+                if (!ctx->body_paused) {
+                    kind = CONN_TIMEOUT_BODY;
+                    timeout_ms = server->body_timeout;
+                }
+                break;
+            case CONN_PHASE_IDLE:
+                kind = CONN_TIMEOUT_KEEPALIVE;
+                timeout_ms = server->keepalive_timeout;
+                break;
+            case CONN_PHASE_WEBSOCKET:
+                // Quiet sockets are pinged; anything received counts as the answer
+                if (catzilla_ws_session_state(ctx->websocket) != CATZILLA_WS_OPEN) {
+                    kind = CONN_TIMEOUT_WS_CLOSE;
+                    timeout_ms = CATZILLA_WS_CLOSE_TIMEOUT_MS;
+                } else if (ctx->timeout_kind == CONN_TIMEOUT_WS_PONG && !progress) {
+                    kind = CONN_TIMEOUT_WS_PONG;
+                    timeout_ms = server->websocket.pong_timeout_ms;
+                } else {
+                    kind = CONN_TIMEOUT_WS_PING;
+                    timeout_ms = server->websocket.ping_interval_ms;
+                }
+                break;
+            default:
+                break;
         }
+    }
 
-        for (size_t i = 0; i < files_to_copy; i++) {
-            if (parser->files[i]) {
-                request->files[i] = parser->files[i];
-                // Increase reference count since we're storing it in the request
-                catzilla_upload_file_ref(parser->files[i]);
-                request->file_count++;
+    if (kind == CONN_TIMEOUT_NONE || timeout_ms == 0) {
+        catzilla_timer_wheel_cancel(&loop_connections.wheel, &ctx->timeout_entry);
+        ctx->timeout_kind = CONN_TIMEOUT_NONE;
+        return;
+    }
 
-                LOG_HTTP_DEBUG("File %zu: filename=%s, size=%llu, temp_path=%s",
-                              i,
-                              parser->files[i]->filename ? parser->files[i]->filename : "unknown",
-                              (unsigned long long)parser->files[i]->size,
-                              parser->files[i]->temp_file_path ? parser->files[i]->temp_file_path : "none");
+    if (kind == ctx->timeout_kind && catzilla_timer_entry_pending(&ctx->timeout_entry) &&
+        (!progress || kind == CONN_TIMEOUT_HEADER || kind == CONN_TIMEOUT_WS_CLOSE)) {
+        return;
+    }
+
+    ctx->timeout_kind = kind;
+    catzilla_timer_wheel_schedule(&loop_connections.wheel, &ctx->timeout_entry,
+                                  uv_now(ctx->client.loop), timeout_ms);
+}
+
+static void on_connection_timeout(catzilla_timer_entry_t* entry) {
+    client_context_t* ctx = (client_context_t*)entry->data;
+    uv_stream_t* client = (uv_stream_t*)&ctx->client;
+    if (uv_is_closing((uv_handle_t*)client)) return;
+
+    // A request that started but stalled is told why before the close
+    bool send_408 = false;
+    switch (ctx->timeout_kind) {
+        case CONN_TIMEOUT_HEADER:
+            catzilla_atomic_fetch_add(&stat_header_timeouts, 1);
+            send_408 = ctx->phase == CONN_PHASE_HEADERS;
+            LOG_SERVER_DEBUG("Closing connection: request headers timed out");
+            break;
+        case CONN_TIMEOUT_BODY:
+            catzilla_atomic_fetch_add(&stat_body_timeouts, 1);
+            send_408 = true;
+            LOG_SERVER_DEBUG("Closing connection: request body timed out");
+            break;
+        case CONN_TIMEOUT_KEEPALIVE:
+            catzilla_atomic_fetch_add(&stat_keepalive_timeouts, 1);
+            LOG_SERVER_DEBUG("Closing idle keep-alive connection");
+            break;
+        case CONN_TIMEOUT_WRITE:
+            catzilla_atomic_fetch_add(&stat_write_timeouts, 1);
+            LOG_SERVER_DEBUG("Closing connection: response write timed out");
+            break;
+        case CONN_TIMEOUT_WS_PING:
+            if (catzilla_ws_session_ping(ctx->websocket, NULL, 0) == 0) {
+                if (!uv_is_closing((uv_handle_t*)client)) {
+                    ctx->timeout_kind = CONN_TIMEOUT_WS_PONG;
+                    update_connection_timer(ctx, false);
+                }
+                return;
             }
-        }
+            LOG_SERVER_DEBUG("Closing WebSocket: ping could not be sent");
+            break;
+        case CONN_TIMEOUT_WS_PONG:
+            LOG_SERVER_DEBUG("Closing WebSocket: ping was not answered");
+            break;
+        case CONN_TIMEOUT_WS_CLOSE:
+            LOG_SERVER_DEBUG("Closing WebSocket: closing handshake timed out");
+            break;
+        default:
+            break;
+    }
+    ctx->timeout_kind = CONN_TIMEOUT_NONE;
 
-        if (request->file_count > 0) {
-            request->has_files = true;
-            LOG_HTTP_DEBUG("Stored %d files in request", request->file_count);
-        }
-    } else {
-        LOG_HTTP_DEBUG("No files found in multipart data");
+    if (!send_408 || ctx->h2) {
+        if (!uv_is_closing((uv_handle_t*)client)) uv_close((uv_handle_t*)client, on_close);
+        return;
     }
 
-    // Clean up
-    catzilla_multipart_parser_cleanup(parser);
-    catzilla_request_free(parser);
-    return 0;
+    // Nothing more is parsed; after_write closes once the 408 is out, and the
+    // write deadline covers a peer that stopped reading
+    if (!ctx->read_paused) {
+        uv_read_stop(client);
+        ctx->read_paused = true;
+    }
+    ctx->body_rejected = true;
+    ctx->keep_alive = false;
+    ctx->phase = CONN_PHASE_HANDLER;
+    const char* body = "408 Request Timeout";
+    send_response_with_connection(client, 408, "text/plain", body, strlen(body), false);
+    update_connection_timer(ctx, false);
 }
 
-yyjson_val* catzilla_get_json(catzilla_request_t* request) {
-    if (!request->is_json_parsed) {
-        if (catzilla_parse_json(request) != 0) {
-            return NULL;
-        }
+// Accept pending connections again once enough of them have closed
+static void resume_accepting(void) {
+    uv_stream_t* listener = loop_connections.paused_listener;
+    if (!listener) return;
+
+    catzilla_server_t* server = (catzilla_server_t*)listener->data;
+    if (server->max_connections > 0 &&
+        catzilla_atomic_load(&stat_active_connections) >= server->connections_low_water) {
+        return;
     }
-    return request->json_root;
+
+    loop_connections.paused_listener = NULL;
+    if (uv_is_closing((uv_handle_t*)listener)) return;
+
+    catzilla_atomic_fetch_add(&stat_accept_resumes, 1);
+    LOG_SERVER_DEBUG("Connection count below low-water mark, accepting again");
+    accept_client(listener);
 }
 
-const char* catzilla_get_form_field(catzilla_request_t* request, const char* field) {
-    if (!request->is_form_parsed) {
-        if (catzilla_parse_form(request) != 0) {
-            return NULL;
+// After a handoff: stop accepting, close idle connections and ask WebSocket
+// clients to reconnect. Busy connections close once their response, sent
+// with Connection: close, is written.
+static void drain_loop_connections(void) {
+    uv_tcp_t* listener = loop_connections.listener;
+    if (listener) {
+        loop_connections.listener = NULL;
+        loop_connections.paused_listener = NULL;
+        if (!uv_is_closing((uv_handle_t*)listener)) {
+            uv_close((uv_handle_t*)listener, NULL);
         }
     }
 
-    for (int i = 0; i < request->form_field_count; i++) {
-        if (strcmp(request->form_fields[i], field) == 0) {
-            return request->form_values[i];
+    // Close callbacks run later, so the list stays intact while it is walked
+    for (client_context_t* ctx = loop_connections.open; ctx; ctx = ctx->loop_next) {
+        uv_handle_t* client = (uv_handle_t*)&ctx->client;
+        if (uv_is_closing(client) || ctx->writes_in_flight > 0) continue;
+
+        if (ctx->phase == CONN_PHASE_IDLE && !ctx->dispatch_queued && !ctx->deferred_response_pending &&
+            (!ctx->h2 || catzilla_h2_session_open_streams(ctx->h2) == 0)) {
+            uv_close(client, on_close);
+        } else if (ctx->phase == CONN_PHASE_WEBSOCKET &&
+                   catzilla_ws_session_state(ctx->websocket) == CATZILLA_WS_OPEN) {
+            static const char reason[] = "server restarting";
+            if (catzilla_ws_session_close(ctx->websocket, CATZILLA_WS_CLOSE_GOING_AWAY,
+                                          reason, sizeof(reason) - 1) == 0) {
+                update_connection_timer(ctx, false);
+            }
         }
     }
-    return NULL;
 }
 
-// Get the content type as a string
-const char* catzilla_get_content_type_str(catzilla_request_t* request) {
-    if (!request) {
-        LOG_HTTP_DEBUG("get_content_type_str: NULL request");
-        return "";
+static void on_timeout_tick(uv_timer_t* timer) {
+    catzilla_timer_wheel_advance(&loop_connections.wheel, uv_now(timer->loop));
+    trim_pools_if_asked();
+
+    if (catzilla_atomic_load(&server_draining)) {
+        drain_loop_connections();
     }
 
-    content_type_t type = request->content_type;
-    LOG_HTTP_DEBUG("get_content_type_str: type=%d", (int)type);
+    // Connections closing on other loops free capacity without waking this one
+    resume_accepting();
+}
 
-    switch (type) {
-        case CONTENT_TYPE_JSON:
-            LOG_HTTP_DEBUG("get_content_type_str: returning application/json");
-            return "application/json";
-        case CONTENT_TYPE_FORM:
-            LOG_HTTP_DEBUG("get_content_type_str: returning application/x-www-form-urlencoded");
-            return "application/x-www-form-urlencoded";
-        case CONTENT_TYPE_MULTIPART:
-            LOG_HTTP_DEBUG("get_content_type_str: returning multipart/form-data");
-            return "multipart/form-data";
-        case CONTENT_TYPE_NONE:
-        default:
-            LOG_HTTP_DEBUG("get_content_type_str: returning text/plain");
-            return "text/plain";
+static int start_connection_timers(uv_loop_t* loop, uv_timer_t* timer, uv_tcp_t* listener) {
+    catzilla_timer_wheel_init(&loop_connections.wheel, uv_now(loop), CATZILLA_TIMEOUT_TICK_MS);
+    loop_connections.paused_listener = NULL;
+    loop_connections.listener = listener;
+
+    int rc = uv_timer_init(loop, timer);
+    if (rc) return rc;
+
+    rc = uv_timer_start(timer, on_timeout_tick, CATZILLA_TIMEOUT_TICK_MS, CATZILLA_TIMEOUT_TICK_MS);
+    if (rc) return rc;
+
+    // The tick alone must not keep the loop running
+    uv_unref((uv_handle_t*)timer);
+    loop_connections.running = true;
+    return 0;
+}
+
+static void stop_connection_timers(void) {
+    loop_connections.running = false;
+    loop_connections.paused_listener = NULL;
+    loop_connections.listener = NULL;
+}
+
+// Remove the previous request's body, including any temp file it was spooled to
+static void discard_request_body(client_context_t* context) {
+    catzilla_request_free(context->body);
+    context->body = NULL;
+    context->body_length = 0;
+    context->body_size = 0;
+    context->body_received = 0;
+    context->expected_body_length = 0;
+    context->body_paused = false;
+
+    if (context->spool_buffer) {
+        catzilla_stream_buffer_cleanup(context->spool_buffer);
+        context->spool_buffer = NULL;
+    }
+    if (context->spooling) {
+        if (context->spool_fd >= 0) {
+            close(context->spool_fd);
+        }
+        unlink(context->spool_path);
+        context->spool_path[0] = '\0';
+        context->spool_fd = -1;
+        context->spooling = false;
+    }
+    if (context->upload_scans) {
+        cancel_upload_scans(context);
+    }
+    if (context->multipart) {
+        catzilla_multipart_parser_cleanup(context->multipart);
+        catzilla_request_free(context->multipart);
+        context->multipart = NULL;
+    }
+}
+
+// Pick the body policy of the route this request will be dispatched to
+static void resolve_body_policy(client_context_t* context) {
+    catzilla_server_t* server = context->server;
+
+    context->body_mode = CATZILLA_BODY_BUFFERED;
+    context->body_limit = server->max_body_size;
+    context->body_spool_threshold = server->body_spool_threshold;
+    context->body_chunk_handler = NULL;
+    context->body_chunk_user_data = NULL;
+
+    // Only pay for a router lookup when some route overrides the defaults
+    if (server->body_route_count == 0) return;
+
+    char path[CATZILLA_PATH_MAX];
+    size_t path_length = strcspn(context->url, "?");
+    if (path_length >= CATZILLA_PATH_MAX) path_length = CATZILLA_PATH_MAX - 1;
+    memcpy(path, context->url, path_length);
+    path[path_length] = '\0';
+
+    catzilla_route_match_t match;
+    if (catzilla_router_match(&server->router, context->method, path, &match) != 0 || !match.route) {
+        return;
+    }
+
+    catzilla_route_t* route = match.route;
+    context->body_mode = route->body_mode;
+    if (route->max_body_size > 0) context->body_limit = route->max_body_size;
+    if (route->body_spool_threshold > 0) context->body_spool_threshold = route->body_spool_threshold;
+    context->body_chunk_handler = (catzilla_body_chunk_fn)route->body_chunk_handler;
+    context->body_chunk_user_data = route->body_chunk_user_data;
+}
+
+// Answer 413 and close: the rest of the body is never read
+static int reject_oversized_body(client_context_t* context) {
+    LOG_HTTP_DEBUG("Rejecting request body above %llu bytes", (unsigned long long)context->body_limit);
+
+    const char* body = "413 Payload Too Large";
+    context->body_rejected = true;
+    context->keep_alive = false;
+    send_response_with_connection((uv_stream_t*)&context->client, 413, "text/plain",
+                                  body, strlen(body), false);
+    if (!context->read_paused) {
+        uv_read_stop((uv_stream_t*)&context->client);
+        context->read_paused = true;
+    }
+    return HPE_PAUSED;
+}
+
+// Answer 503 and close while memory is short; the client may retry later
+static int reject_under_pressure(client_context_t* context) {
+    LOG_HTTP_DEBUG("Refusing a request body under memory pressure");
+    catzilla_atomic_fetch_add(&stat_pressure_rejections, 1);
+
+    const char* body = "503 Service Unavailable: memory pressure";
+    context->body_rejected = true;
+    context->keep_alive = false;
+    send_response_with_connection((uv_stream_t*)&context->client, 503,
+                                  "Content-Type: text/plain\r\nRetry-After: 1\r\n",
+                                  body, strlen(body), false);
+    if (!context->read_paused) {
+        uv_read_stop((uv_stream_t*)&context->client);
+        context->read_paused = true;
+    }
+    return HPE_PAUSED;
+}
+
+static int on_message_begin(llhttp_t* parser) {
+    client_context_t* context = (client_context_t*)parser->data;
+    CATZILLA_PROBE1(request_start, context);
+    context->phase = CONN_PHASE_HEADERS;
+    context->url[0] = '\0';
+    context->method[0] = '\0';
+    discard_request_body(context);
+    context->body_rejected = false;
+    catzilla_header_set_reset(&context->headers);  // Pipelined requests reuse the block
+    context->has_connection_header = false;
+    context->content_type = CONTENT_TYPE_NONE;  // Reset content type at start of message
+    context->access_pending = context->server->access_log != NULL;
+    if (context->access_pending) {
+        context->access_started_ns = uv_hrtime();
+        context->access_route_id = CATZILLA_ACCESS_LOG_NO_ROUTE;
+    }
+    LOG_HTTP_DEBUG("Message begin: content type reset to NONE (type=%d)", (int)context->content_type);
+    return 0;
+}
+
+static int on_url(llhttp_t* parser, const char* at, size_t length) {
+    client_context_t* context = (client_context_t*)parser->data;
+
+    // Store the full URL including query string
+    if (length >= CATZILLA_PATH_MAX) length = CATZILLA_PATH_MAX - 1;
+    memcpy(context->url, at, length);
+    context->url[length] = '\0';
+    LOG_HTTP_DEBUG("Received full URL: %s", context->url);
+    return 0;
+}
+
+static int on_header_field(llhttp_t* parser, const char* at, size_t length) {
+    client_context_t* context = (client_context_t*)parser->data;
+
+    // Names may arrive in pieces when they span reads; the set stitches them
+    if (catzilla_header_set_append_name(&context->headers, at, length) != 0) {
+        LOG_HTTP_ERROR("Request headers exceed %d bytes", CATZILLA_HEADER_DATA_MAX);
+        return -1;
+    }
+    return 0;
+}
+
+static int on_header_value(llhttp_t* parser, const char* at, size_t length) {
+    client_context_t* context = (client_context_t*)parser->data;
+
+    if (catzilla_header_set_append_value(&context->headers, at, length) != 0) {
+        LOG_HTTP_ERROR("Request headers exceed %d bytes", CATZILLA_HEADER_DATA_MAX);
+        return -1;
+    }
+    return 0;
+}
+
+static content_type_t classify_content_type(const char* value, size_t length) {
+    if (length >= 16 && strncasecmp(value, "application/json", 16) == 0) {
+        return CONTENT_TYPE_JSON;
+    } else if (length >= 33 && strncasecmp(value, "application/x-www-form-urlencoded", 33) == 0) {
+        return CONTENT_TYPE_FORM;
+    } else if (length >= 19 && strncasecmp(value, "multipart/form-data", 19) == 0) {
+        return CONTENT_TYPE_MULTIPART;
+    }
+    return CONTENT_TYPE_NONE;
+}
+
+static int on_header_value_complete(llhttp_t* parser) {
+    client_context_t* context = (client_context_t*)parser->data;
+    catzilla_header_set_t* headers = &context->headers;
+
+    int index = catzilla_header_set_commit(headers);
+    if (index < 0) {
+        return 0;
+    }
+
+    const catzilla_header_t* header = &headers->entries[index];
+    const char* value = catzilla_header_value(headers, header);
+    size_t length = header->value_length;
+    LOG_HTTP_DEBUG("Stored header: %s = %s", catzilla_header_name(headers, header), value);
+
+    // Only the first occurrence owns the well-known slot
+    if (headers->known[CATZILLA_HDR_CONTENT_TYPE] == index + 1) {
+        content_type_t new_type = classify_content_type(value, length);
+
+        context->content_type = new_type;
+        LOG_HTTP_DEBUG("Content-Type set to: %s (type=%d)",
+            new_type == CONTENT_TYPE_JSON ? "application/json" :
+            new_type == CONTENT_TYPE_FORM ? "application/x-www-form-urlencoded" :
+            new_type == CONTENT_TYPE_MULTIPART ? "multipart/form-data" : "none",
+            (int)context->content_type);
+    } else if (headers->known[CATZILLA_HDR_CONNECTION] == index + 1) {
+        context->has_connection_header = true;
+
+        // Check for keep-alive
+        if (length >= 10 && strncasecmp(value, "keep-alive", 10) == 0) {
+            context->keep_alive = true;
+            LOG_HTTP_DEBUG("Connection: keep-alive detected");
+        } else {
+            context->keep_alive = false;
+            LOG_HTTP_DEBUG("Connection: close or other");
+        }
+    }
+
+    return 0;
+}
+
+// One file part on its way to clamd. It stays in its request's list until
+// the verdict arrives or the body is discarded.
+typedef struct upload_scan_s {
+    struct upload_scan_s* next;
+    client_context_t* context;
+    catzilla_upload_file_t* file;
+    catzilla_clamd_scan_t* scan;
+    bool streaming;  // The part's data is still arriving
+} upload_scan_t;
+
+static void unlink_upload_scan(client_context_t* ctx, upload_scan_t* entry) {
+    for (upload_scan_t** link = &ctx->upload_scans; *link; link = &(*link)->next) {
+        if (*link == entry) {
+            *link = entry->next;
+            break;
+        }
+    }
+    catzilla_request_free(entry);
+}
+
+static upload_scan_t* find_upload_scan(client_context_t* ctx, catzilla_upload_file_t* file) {
+    for (upload_scan_t* entry = ctx->upload_scans; entry; entry = entry->next) {
+        if (entry->file == file && entry->streaming) return entry;
+    }
+    return NULL;
+}
+
+// Files fail closed: without a verdict the file carries an error
+static void fail_upload_scan(client_context_t* ctx, upload_scan_t* entry, const char* reason) {
+    char message[CATZILLA_CLAMD_SIGNATURE_MAX + 32];
+    snprintf(message, sizeof(message), "Virus scan failed: %s", reason);
+    catzilla_upload_set_error(entry->file, CATZILLA_UPLOAD_ERROR_NETWORK, message);
+    unlink_upload_scan(ctx, entry);
+}
+
+static void on_upload_scanned(void* data, const catzilla_clamd_result_t* result) {
+    upload_scan_t* entry = data;
+    client_context_t* ctx = entry->context;
+
+    if (result->verdict == CATZILLA_CLAMD_ERROR) {
+        fail_upload_scan(ctx, entry, result->signature);
+    } else {
+        entry->file->virus_scanned = true;
+        if (result->verdict == CATZILLA_CLAMD_INFECTED) {
+            char message[CATZILLA_CLAMD_SIGNATURE_MAX + 32];
+            snprintf(message, sizeof(message), "Virus detected: %s", result->signature);
+            catzilla_upload_set_error(entry->file, CATZILLA_UPLOAD_ERROR_VIRUS_DETECTED, message);
+        }
+        unlink_upload_scan(ctx, entry);
+    }
+
+    if (ctx->upload_scan_wait && !ctx->upload_scans) {
+        resume_after_upload_scans(ctx);
+    }
+}
+
+static void on_upload_file_start(multipart_parser_t* parser, catzilla_upload_file_t* file) {
+    client_context_t* ctx = parser->user_data;
+    if (!file->filename) return;  // Form fields are not scanned
+
+    upload_scan_t* entry = catzilla_request_alloc(sizeof(*entry));
+    if (!entry) {
+        catzilla_upload_set_error(file, CATZILLA_UPLOAD_ERROR_MEMORY, "Virus scan failed: out of memory");
+        return;
+    }
+    entry->context = ctx;
+    entry->file = file;
+    entry->streaming = true;
+    entry->scan = catzilla_clamd_scan_start(loop_clamd, on_upload_scanned, entry);
+    if (!entry->scan) {
+        catzilla_request_free(entry);
+        catzilla_upload_set_error(file, CATZILLA_UPLOAD_ERROR_NETWORK, "Virus scan failed: clamd unreachable");
+        return;
+    }
+    entry->next = ctx->upload_scans;
+    ctx->upload_scans = entry;
+}
+
+static void on_upload_file_data(multipart_parser_t* parser, catzilla_upload_file_t* file,
+                                const char* data, size_t len) {
+    client_context_t* ctx = parser->user_data;
+    upload_scan_t* entry = find_upload_scan(ctx, file);
+    if (entry && catzilla_clamd_scan_write(entry->scan, data, len) != 0) {
+        // The client canceled the scan
+        fail_upload_scan(ctx, entry, "clamd is not keeping up");
+    }
+}
+
+static void on_upload_file_end(multipart_parser_t* parser, catzilla_upload_file_t* file) {
+    client_context_t* ctx = parser->user_data;
+    upload_scan_t* entry = find_upload_scan(ctx, file);
+    if (!entry) return;
+    entry->streaming = false;
+    if (catzilla_clamd_scan_finish(entry->scan) != 0) {
+        fail_upload_scan(ctx, entry, "clamd write failed");
+    }
+}
+
+// Parts the body ended in the middle of never get a verdict
+static void end_streaming_upload_scans(client_context_t* ctx) {
+    upload_scan_t* entry = ctx->upload_scans;
+    while (entry) {
+        upload_scan_t* next = entry->next;
+        if (entry->streaming) {
+            catzilla_clamd_scan_cancel(entry->scan);
+            fail_upload_scan(ctx, entry, "upload incomplete");
+        }
+        entry = next;
+    }
+}
+
+static void cancel_upload_scans(client_context_t* ctx) {
+    while (ctx->upload_scans) {
+        upload_scan_t* entry = ctx->upload_scans;
+        ctx->upload_scans = entry->next;
+        catzilla_clamd_scan_cancel(entry->scan);
+        catzilla_request_free(entry);
+    }
+    ctx->upload_scan_wait = false;
+}
+
+// Set up incremental multipart parsing; without a usable boundary the body
+// is buffered and parsed whole as before
+static void start_multipart_body(client_context_t* context) {
+    const char* content_type = catzilla_header_set_get_known(&context->headers, CATZILLA_HDR_CONTENT_TYPE, NULL);
+    if (!content_type) return;
+
+    multipart_parser_t* multipart = catzilla_request_alloc(sizeof(*multipart));
+    if (!multipart) return;
+    if (catzilla_multipart_parse_init(multipart, content_type) != 0) {
+        catzilla_multipart_parser_cleanup(multipart);
+        catzilla_request_free(multipart);
+        return;
+    }
+    multipart->spill_threshold = context->body_spool_threshold;
+    multipart->body_length = context->expected_body_length;
+    multipart->direct_io = context->server->upload_direct_io;
+    multipart->digest_algorithms = context->server->upload_digests;
+    if (loop_clamd) {
+        multipart->user_data = context;
+        multipart->on_file_start = on_upload_file_start;
+        multipart->on_file_data = on_upload_file_data;
+        multipart->on_file_end = on_upload_file_end;
+    }
+    context->multipart = multipart;
+}
+
+// Malformed multipart input is not a transport error: the handler runs with
+// no files, as it did when the buffered body failed to parse
+static void feed_multipart_body(client_context_t* context, const char* at, size_t length) {
+    multipart_parser_t* multipart = context->multipart;
+    if (multipart->state == MULTIPART_STATE_ERROR || multipart->state == MULTIPART_STATE_END) return;
+    if (catzilla_multipart_parse_chunk(multipart, at, length) != 0) {
+        LOG_HTTP_DEBUG("Multipart parsing failed after %llu body bytes",
+                       (unsigned long long)context->body_received);
+    }
+}
+
+static int on_headers_complete(llhttp_t* parser) {
+    client_context_t* context = (client_context_t*)parser->data;
+    const char* method = llhttp_method_name(parser->method);
+    size_t method_len = strlen(method);
+    if (method_len >= CATZILLA_METHOD_MAX) method_len = CATZILLA_METHOD_MAX - 1;
+    memcpy(context->method, method, method_len);
+    context->method[method_len] = '\0';
+
+    // HTTP/1.1 defaults to keep-alive if no Connection header was specified
+    if (!context->has_connection_header && llhttp_get_http_major(parser) == 1 && llhttp_get_http_minor(parser) == 1) {
+        context->keep_alive = true;
+        LOG_HTTP_DEBUG("HTTP/1.1 defaulting to keep-alive");
+    }
+
+    resolve_body_policy(context);
+    context->phase = CONN_PHASE_BODY;
+
+    context->expected_body_length = 0;
+    if (parser->flags & F_CONTENT_LENGTH) {
+        // Reject before anything is allocated for the body
+        if (context->body_limit > 0 && parser->content_length > context->body_limit) {
+            return reject_oversized_body(context);
+        }
+        if (refuse_under_pressure(context, parser->content_length)) {
+            return reject_under_pressure(context);
+        }
+        context->expected_body_length = parser->content_length;
+    }
+
+    if (context->content_type == CONTENT_TYPE_MULTIPART && context->body_mode == CATZILLA_BODY_BUFFERED) {
+        start_multipart_body(context);
+    }
+
+    return 0;
+}
+
+static int append_body_buffered(client_context_t* context, const char* at, size_t length) {
+    if (context->body == NULL) {
+        // A known Content-Length sizes the buffer once instead of doubling
+        size_t initial = length > 1024 ? length : 1024;
+        if (context->expected_body_length > initial && context->expected_body_length <= SIZE_MAX - 1 &&
+            (context->body_mode != CATZILLA_BODY_SPOOL ||
+             context->expected_body_length <= context->body_spool_threshold)) {
+            initial = (size_t)context->expected_body_length;
+        }
+        context->body_size = initial;
+        context->body = catzilla_request_alloc(context->body_size + 1);
+        if (!context->body) return -1;
+        context->body_length = 0;
+    } else if (context->body_length + length > context->body_size) {
+        // Calculate new size to accommodate current chunk + some extra space
+        size_t required_size = context->body_length + length;
+        size_t new_size = context->body_size * 2;
+
+        // Ensure new_size is at least large enough for the required size
+        while (new_size < required_size) {
+            new_size *= 2;
+        }
+
+        char* new_body = catzilla_request_realloc(context->body, new_size + 1);
+        if (!new_body) return -1;
+        context->body = new_body;
+        context->body_size = new_size;
+        LOG_HTTP_DEBUG("Reallocated body buffer: %zu bytes -> %zu bytes", context->body_length, new_size);
+    }
+    memcpy(context->body + context->body_length, at, length);
+    context->body_length += length;
+    context->body[context->body_length] = '\0';
+    LOG_HTTP_DEBUG("Received body chunk: %zu bytes (total: %zu bytes)", length, context->body_length);
+    return 0;
+}
+
+// Copy into the spool buffer, writing it out to the temp file whenever it fills
+static int spool_write(client_context_t* context, const char* at, size_t length) {
+    upload_stream_buffer_t* buffer = context->spool_buffer;
+    while (length > 0) {
+        if (buffer->position == buffer->capacity) {
+            if (catzilla_stream_buffer_write_to_file(buffer, context->spool_fd) != 0) return -1;
+            buffer->position = 0;
+        }
+        size_t space = buffer->capacity - buffer->position;
+        size_t chunk = length < space ? length : space;
+        if (catzilla_stream_buffer_append(buffer, at, chunk) != 0) return -1;
+        at += chunk;
+        length -= chunk;
+    }
+    return 0;
+}
+
+static int append_body_spooled(client_context_t* context, const char* at, size_t length) {
+    if (!context->spooling) {
+        if (context->body_length + length <= context->body_spool_threshold) {
+            return append_body_buffered(context, at, length);
+        }
+
+        // Crossing the threshold: move what is buffered so far to a temp file
+        context->spool_buffer = catzilla_stream_buffer_create(CATZILLA_BODY_SPOOL_BUFFER_SIZE);
+        if (!context->spool_buffer) return -1;
+        int fd = catzilla_stream_create_temp_file(context->spool_path, sizeof(context->spool_path));
+        if (fd < 0) {
+            catzilla_stream_buffer_cleanup(context->spool_buffer);
+            context->spool_buffer = NULL;
+            return -1;
+        }
+        context->spool_fd = fd;
+        context->spooling = true;
+        LOG_HTTP_DEBUG("Spooling request body to %s", context->spool_path);
+
+        if (context->body_length > 0 && spool_write(context, context->body, context->body_length) != 0) {
+            return -1;
+        }
+        catzilla_request_free(context->body);
+        context->body = NULL;
+        context->body_length = 0;
+        context->body_size = 0;
+    }
+    return spool_write(context, at, length);
+}
+
+static int on_body(llhttp_t* parser, const char* at, size_t length) {
+    client_context_t* context = (client_context_t*)parser->data;
+
+    // Chunked bodies have no Content-Length to check up front
+    context->body_received += length;
+    if (context->body_limit > 0 && context->body_received > context->body_limit) {
+        return reject_oversized_body(context);
+    }
+    if (context->expected_body_length == 0 && refuse_under_pressure(context, context->body_received)) {
+        return reject_under_pressure(context);
+    }
+
+    switch (context->body_mode) {
+    case CATZILLA_BODY_STREAM: {
+        if (!context->body_chunk_handler) return 0;
+        int rc = context->body_chunk_handler((uv_stream_t*)&context->client, at, length,
+                                             context->body_chunk_user_data);
+        if (rc < 0) return -1;
+        if (rc == CATZILLA_BODY_PAUSE) {
+            // Backpressure: stop reading until the handler resumes the body
+            context->body_paused = true;
+            if (!context->read_paused) {
+                uv_read_stop((uv_stream_t*)&context->client);
+                context->read_paused = true;
+            }
+            return HPE_PAUSED;
+        }
+        return 0;
+    }
+    case CATZILLA_BODY_SPOOL:
+        return append_body_spooled(context, at, length);
+    default:
+        if (context->multipart) {
+            feed_multipart_body(context, at, length);
+            return 0;
+        }
+        return append_body_buffered(context, at, length);
+    }
+}
+
+// Flush a spooled body and signal the end of a streamed one
+static int finish_request_body(client_context_t* context) {
+    if (context->body_mode == CATZILLA_BODY_STREAM && context->body_chunk_handler) {
+        return context->body_chunk_handler((uv_stream_t*)&context->client, NULL, 0,
+                                           context->body_chunk_user_data) < 0 ? -1 : 0;
+    }
+
+    if (context->spooling && context->spool_fd >= 0) {
+        int rc = catzilla_stream_buffer_write_to_file(context->spool_buffer, context->spool_fd);
+        close(context->spool_fd);
+        context->spool_fd = -1;
+        catzilla_stream_buffer_cleanup(context->spool_buffer);
+        context->spool_buffer = NULL;
+        if (rc != 0) return -1;
+        LOG_HTTP_DEBUG("Spooled %llu body bytes to %s",
+                       (unsigned long long)context->body_received, context->spool_path);
+    }
+
+    if (context->multipart && context->multipart->state != MULTIPART_STATE_ERROR &&
+        catzilla_multipart_parse_complete(context->multipart) != 0) {
+        LOG_HTTP_DEBUG("Multipart parsing failed at the end of the body");
+    }
+    if (context->upload_scans) {
+        end_streaming_upload_scans(context);
+    }
+    return 0;
+}
+
+// Function to check if body parsing will fail due to unsupported content type
+static bool should_return_415(client_context_t* context) {
+    // Only return 415 if we have a body and the content type is unsupported
+    if (!context->body || context->body_length == 0) {
+        return false;  // No body, no problem
+    }
+
+    // Spooled and streamed routes take raw bodies of any type
+    if (context->body_mode != CATZILLA_BODY_BUFFERED) {
+        return false;
+    }
+
+    // For POST/PUT/PATCH requests with body, we expect a supported content type
+    if (strcmp(context->method, "POST") == 0 ||
+        strcmp(context->method, "PUT") == 0 ||
+        strcmp(context->method, "PATCH") == 0) {
+
+        // If we have a body but no recognizable content type, return 415
+        if (context->content_type == CONTENT_TYPE_NONE) {
+            LOG_HTTP_DEBUG("Request has body but unsupported content type");
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Function to populate request with path parameters from route match
+static void populate_path_params(catzilla_request_t* request, const catzilla_route_match_t* match) {
+    if (!request || !match) return;
+
+    // Clear existing path parameters
+    request->path_param_count = 0;
+    request->has_path_params = false;
+    request->path_param_names = match->route ? match->route->param_names : NULL;
+    if (!request->path_param_names) return;
+
+    // The request path and the matched path start alike, so the slices carry
+    // over unchanged; values are copied out only when read
+    size_t path_length = strlen(request->path);
+    int count = match->param_count;
+    if (count > match->route->param_count) count = match->route->param_count;
+    for (int i = 0; i < count; i++) {
+        const catzilla_route_param_slice_t* param = &match->params[i];
+        if ((size_t)param->offset + param->length > path_length) break;
+        request->path_params[request->path_param_count++] = *param;
+    }
+
+    if (request->path_param_count > 0) {
+        request->has_path_params = true;
+        LOG_HTTP_DEBUG("Populated %d path parameters in request", request->path_param_count);
+    }
+}
+
+// Universal Python route handler for advanced router
+void catzilla_python_route_handler(uv_stream_t* client) {
+    // This handler should never be called directly since Python routes
+    // are handled via py_request_callback in on_message_complete
+    LOG_SERVER_ERROR("catzilla_python_route_handler called directly - this should not happen");
+    const char* body = "500 Internal Server Error";
+    catzilla_send_response(client, 500, "text/plain", body, strlen(body));
+}
+
+// Capsule destructor for proper request memory management
+void catzilla_request_destroy(catzilla_request_t* request) {
+    if (request) {
+        if (request->json_doc) yyjson_doc_free(request->json_doc);
+
+        // Clean up copied headers
+        catzilla_header_set_free(&request->headers);
+
+        // Clean up uploaded files
+        if (request->has_files) {
+            for (int i = 0; i < request->file_count; i++) {
+                if (request->files[i]) {
+                    catzilla_upload_file_unref(request->files[i]);
+                    request->files[i] = NULL;
+                }
+            }
+        }
+
+        // Query, form and body strings all live in the arena
+        catzilla_arena_reset(&request->arena);
+        catzilla_request_free(request);
+    }
+}
+
+// Give the request a reference to each parsed part (up to CATZILLA_MAX_FILES)
+static void store_multipart_files(catzilla_request_t* request, multipart_parser_t* parser) {
+    request->file_count = 0;
+    request->has_files = false;
+
+    if (parser->files && parser->files_count > 0) {
+        size_t files_to_copy = parser->files_count;
+        if (files_to_copy > CATZILLA_MAX_FILES) {
+            files_to_copy = CATZILLA_MAX_FILES;
+            LOG_HTTP_DEBUG("Warning: truncating files from %zu to %d", parser->files_count, CATZILLA_MAX_FILES);
+        }
+
+        for (size_t i = 0; i < files_to_copy; i++) {
+            if (parser->files[i]) {
+                request->files[i] = parser->files[i];
+                // Increase reference count since we're storing it in the request
+                catzilla_upload_file_ref(parser->files[i]);
+                request->file_count++;
+
+                LOG_HTTP_DEBUG("File %zu: filename=%s, size=%llu, temp_path=%s",
+                              i,
+                              parser->files[i]->filename ? parser->files[i]->filename : "unknown",
+                              (unsigned long long)parser->files[i]->size,
+                              parser->files[i]->temp_file_path ? parser->files[i]->temp_file_path : "none");
+            }
+        }
+
+        if (request->file_count > 0) {
+            request->has_files = true;
+            LOG_HTTP_DEBUG("Stored %d files in request", request->file_count);
+        }
+    } else {
+        LOG_HTTP_DEBUG("No files found in multipart data");
+    }
+}
+
+// Python callback helper
+PyObject* handle_request_in_server(PyObject* callback,
+    PyObject* client_capsule,
+    const char* method,
+    const char* path,
+    const char* body,
+    size_t body_length,
+    client_context_t* client_ctx,
+    const catzilla_route_match_t* route_match)
+{
+    if (!callback || !PyCallable_Check(callback)) {
+        PyErr_SetString(PyExc_TypeError, "Callback is not callable");
+        return NULL;
+    }
+
+    // Create a request structure
+    catzilla_request_t* request = catzilla_request_alloc(sizeof(catzilla_request_t));
+    if (!request) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+    memset(request, 0, sizeof(catzilla_request_t));
+
+    // Copy data into request
+    strncpy(request->method, method, CATZILLA_METHOD_MAX-1);
+    request->method[CATZILLA_METHOD_MAX-1] = '\0';
+    strncpy(request->path, path, CATZILLA_PATH_MAX-1);
+    request->path[CATZILLA_PATH_MAX-1] = '\0';
+
+    // Copy headers from context if available
+    // (one copy of the data block; the slices and slots carry over as is)
+    if (client_ctx && client_ctx->headers.count > 0) {
+        if (catzilla_header_set_copy(&request->headers, &client_ctx->headers) == 0) {
+            LOG_HTTP_DEBUG("Copied %d headers from context to request", request->headers.count);
+        } else {
+            LOG_HTTP_ERROR("Failed to copy request headers");
+        }
+    }
+
+    // Keep the raw query string; it is decoded on first lookup
+    const char* query = strchr(path, '?');
+    if (query && query[1] != '\0') {
+        request->query_string = catzilla_arena_strndup(&request->arena, query + 1, strlen(query + 1));
+    }
+
+    populate_path_params(request, route_match);
+
+    // A spooled body stays on disk; the handler gets the temp file path
+    if (client_ctx && client_ctx->spooling) {
+        request->body_file = catzilla_arena_strndup(&request->arena, client_ctx->spool_path,
+                                                    strlen(client_ctx->spool_path));
+        if (request->body_file) {
+            request->body_file_size = client_ctx->body_received;
+        }
+    }
+
+    if (body && body_length > 0) {
+        request->body = catzilla_arena_strndup(&request->arena, body, body_length);
+        if (request->body) {
+            request->body_length = body_length;
+        } else {
+            PyErr_NoMemory();
+            catzilla_request_destroy(request);
+            return NULL;
+        }
+    }
+
+    // Get the client context using our new helper function
+    uv_stream_t* client = (uv_stream_t*)PyCapsule_GetPointer(client_capsule, "catzilla.client");
+    client_context_t* context = get_client_context(client);
+
+    if (context) {
+        LOG_HTTP_DEBUG("Found client context, current content type: %d", (int)context->content_type);
+
+        // Copy content type directly
+        request->content_type = context->content_type;
+        LOG_HTTP_DEBUG("Set request content_type from context: %d (%s)",
+            (int)request->content_type,
+            request->content_type == CONTENT_TYPE_JSON ? "application/json" :
+            request->content_type == CONTENT_TYPE_FORM ? "application/x-www-form-urlencoded" : "none");
+
+        // JSON and form bodies are parsed when Python first asks for them;
+        // multipart needs the connection's boundary, so it is parsed here
+        if (request->content_type == CONTENT_TYPE_MULTIPART && context->multipart) {
+            // Parsed while the body arrived
+            if (context->multipart->state == MULTIPART_STATE_END) {
+                store_multipart_files(request, context->multipart);
+            } else {
+                LOG_HTTP_DEBUG("Multipart parsing failed");
+            }
+        } else if (request->content_type == CONTENT_TYPE_MULTIPART) {
+            LOG_HTTP_DEBUG("Pre-parsing multipart content");
+            // Pass the context for boundary extraction
+            if (catzilla_parse_multipart_with_context(request, context) == 0) {
+                LOG_HTTP_DEBUG("Multipart parsing successful");
+            } else {
+                LOG_HTTP_DEBUG("Multipart parsing failed");
+            }
+        }
+    } else {
+        LOG_HTTP_DEBUG("No client context found, using NONE content type");
+        request->content_type = CONTENT_TYPE_NONE;
+    }
+
+    // The request object owns the request from here on
+    PyObject* request_object = catzilla_request_object_new(request, client_capsule, route_match);
+    if (!request_object) {
+        return NULL;
+    }
+
+    // Build arguments tuple: (client_capsule, method, path, body, request, route_match).
+    // The request object carries the route match as well.
+    // For multipart/form-data, we don't need the raw body in Python since files are handled separately
+    const char* body_for_python;
+    if (request->content_type == CONTENT_TYPE_MULTIPART) {
+        // For multipart, use empty string since files are accessed via get_files()
+        body_for_python = "";
+    } else {
+        // For other content types, use the body as string (safe for text data)
+        body_for_python = body ? body : "";
+    }
+    PyObject* method_object = catzilla_route_py_method(route_match ? route_match->route : NULL, method);
+    if (!method_object) {
+        Py_DECREF(request_object);
+        return NULL;
+    }
+    PyObject* args = Py_BuildValue(
+        "(ONssOO)",
+        client_capsule,
+        method_object,
+        path,
+        body_for_python,
+        request_object,
+        request_object
+    );
+    if (!args) {
+        Py_DECREF(request_object);  // Frees the request
+        return NULL;
+    }
+
+    // Call the Python function
+    PyObject* result = PyObject_CallObject(callback, args);
+    Py_DECREF(args);
+    Py_DECREF(request_object);
+
+    if (!result) {
+        PyErr_Print();
+        return NULL;
+    }
+    return result;
+}
+
+int catzilla_parse_json(catzilla_request_t* request) {
+    if (!request || !request->body || request->body_length == 0) {
+        LOG_HTTP_DEBUG("JSON parse failed: no request, body, or zero length");
+        return -1;
+    }
+
+    // Check if already parsed
+    if (request->is_json_parsed) {
+        LOG_HTTP_DEBUG("JSON already parsed");
+        return 0;
+    }
+
+    // Check content type - allow parsing if it's JSON type
+    if (request->content_type != CONTENT_TYPE_JSON) {
+        LOG_HTTP_DEBUG("JSON parse failed: wrong content type (%d)", request->content_type);
+        return -1;
+    }
+
+    LOG_HTTP_DEBUG("Parsing JSON body: '%s'", request->body);
+
+    // Initialize JSON fields
+    if (request->json_doc) {
+        yyjson_doc_free(request->json_doc);
+    }
+    request->json_doc = NULL;
+    request->json_root = NULL;
+
+    // Parse JSON using yyjson
+    yyjson_read_flag flg = YYJSON_READ_NOFLAG;
+    yyjson_read_err err;
+    request->json_doc = yyjson_read_opts(request->body, request->body_length, flg, NULL, &err);
+
+    if (!request->json_doc) {
+        LOG_HTTP_DEBUG("JSON parse error: %s at position %zu", err.msg, err.pos);
+        request->is_json_parsed = true;  // Mark as parsed even if failed
+        return -1;
+    }
+
+    request->json_root = yyjson_doc_get_root(request->json_doc);
+    if (!request->json_root) {
+        LOG_HTTP_DEBUG("JSON parse error: no root object");
+        yyjson_doc_free(request->json_doc);
+        request->json_doc = NULL;
+        request->is_json_parsed = true;  // Mark as parsed even if failed
+        return -1;
+    }
+
+    LOG_HTTP_DEBUG("JSON parsed successfully");
+    request->is_json_parsed = true;
+    return 0;
+}
+
+int catzilla_parse_form(catzilla_request_t* request) {
+    if (!request || !request->body || request->body_length == 0) {
+        LOG_HTTP_DEBUG("Form parse failed: no request, body, or zero length");
+        return -1;
+    }
+
+    // Check if already parsed
+    if (request->is_form_parsed) {
+        LOG_HTTP_DEBUG("Form data already parsed");
+        return 0;
+    }
+
+    // Check content type - allow parsing if it's form type
+    if (request->content_type != CONTENT_TYPE_FORM) {
+        LOG_HTTP_DEBUG("Form parse failed: wrong content type (%d)", request->content_type);
+        return -1;
+    }
+
+    LOG_HTTP_DEBUG("Parsing form data: %zu bytes", request->body_length);
+
+    // The body is copied once and decoded in place; fields with an empty name are dropped
+    request->is_form_parsed = true;  // Marked even on failure so it is not retried
+    if (catzilla_urlencoded_parse(&request->arena, request->body, request->body_length,
+                                  true, &request->form) != 0) {
+        LOG_HTTP_DEBUG("Form parse error: memory allocation failed");
+        return -1;
+    }
+
+    LOG_HTTP_DEBUG("Form parsed successfully with %d fields", request->form.count);
+    return 0;
+}
+
+int catzilla_parse_multipart(catzilla_request_t* request) {
+    if (!request || !request->body || request->body_length == 0) {
+        LOG_HTTP_DEBUG("Multipart parse failed: no request, body, or zero length");
+        return -1;
+    }
+
+    // Check content type - only parse if it's multipart type
+    if (request->content_type != CONTENT_TYPE_MULTIPART) {
+        LOG_HTTP_DEBUG("Multipart parse failed: wrong content type (%d)", request->content_type);
+        return -1;
+    }
+
+    LOG_HTTP_DEBUG("Parsing multipart data: %zu bytes", request->body_length);
+
+    // Initialize multipart parser - allocate on heap to avoid stack issues
+    multipart_parser_t* parser = catzilla_request_alloc(sizeof(multipart_parser_t));
+    if (!parser) {
+        LOG_HTTP_DEBUG("Failed to allocate multipart parser");
+        return -1;
+    }
+    memset(parser, 0, sizeof(multipart_parser_t));
+
+    // For now, we need the content-type header to extract boundary
+    // This is a simplified implementation - in practice, we'd need access to the full Content-Type header
+    // to extract the boundary parameter
+    const char* dummy_content_type = "multipart/form-data; boundary=----WebKitFormBoundary7MA4YWxkTrZu0gW";
+
+    if (catzilla_multipart_parse_init(parser, dummy_content_type) != 0) {
+        LOG_HTTP_DEBUG("Failed to initialize multipart parser");
+        catzilla_request_free(parser);
+        return -1;
+    }
+
+    // Parse the multipart data
+    int parse_result = catzilla_multipart_parse_chunk(parser, request->body, request->body_length);
+    if (parse_result != 0) {
+        LOG_HTTP_DEBUG("Failed to parse multipart data (error: %d)", parse_result);
+        catzilla_multipart_parser_cleanup(parser);
+        catzilla_request_free(parser);
+        return -1;
+    }
+
+    parse_result = catzilla_multipart_parse_complete(parser);
+    if (parse_result != 0) {
+        LOG_HTTP_DEBUG("Failed to complete multipart parsing (error: %d)", parse_result);
+        catzilla_multipart_parser_cleanup(parser);
+        catzilla_request_free(parser);
+        return -1;
+    }
+
+    LOG_HTTP_DEBUG("Multipart parsing completed, found %zu files", parser->files_count);
+
+    store_multipart_files(request, parser);
+
+    // Clean up
+    catzilla_multipart_parser_cleanup(parser);
+    catzilla_request_free(parser);
+    return 0;
+}
+
+// Enhanced multipart parsing with context for boundary extraction
+int catzilla_parse_multipart_with_context(catzilla_request_t* request, void* context_ptr) {
+    client_context_t* context = (client_context_t*)context_ptr;
+    if (!request || !request->body || request->body_length == 0) {
+        LOG_HTTP_DEBUG("Multipart parse failed: no request, body, or zero length");
+        return -1;
+    }
+
+    // Check content type - only parse if it's multipart type
+    if (request->content_type != CONTENT_TYPE_MULTIPART) {
+        LOG_HTTP_DEBUG("Multipart parse failed: wrong content type (%d)", request->content_type);
+        return -1;
+    }
+
+    LOG_HTTP_DEBUG("Parsing multipart data: %zu bytes", request->body_length);
+
+    // Initialize multipart parser - allocate on heap to avoid stack issues
+    multipart_parser_t* parser = catzilla_request_alloc(sizeof(multipart_parser_t));
+    if (!parser) {
+        LOG_HTTP_DEBUG("Failed to allocate multipart parser");
+        return -1;
+    }
+    memset(parser, 0, sizeof(multipart_parser_t));
+
+    // Use the real Content-Type header from context if available
+    const catzilla_header_set_t* headers = context ? &context->headers : &request->headers;
+    const char* content_type_header = catzilla_header_set_get_known(headers, CATZILLA_HDR_CONTENT_TYPE, NULL);
+    if (content_type_header) {
+        LOG_HTTP_DEBUG("Using real Content-Type header: %s", content_type_header);
+    } else {
+        // Fallback to dummy header
+        content_type_header = "multipart/form-data; boundary=----WebKitFormBoundary7MA4YWxkTrZu0gW";
+        LOG_HTTP_DEBUG("Using fallback Content-Type header: %s", content_type_header);
+    }
+
+    if (catzilla_multipart_parse_init(parser, content_type_header) != 0) {
+        LOG_HTTP_DEBUG("Failed to initialize multipart parser");
+        catzilla_request_free(parser);
+        return -1;
+    }
+
+    // Parse the multipart data
+    int parse_result = catzilla_multipart_parse_chunk(parser, request->body, request->body_length);
+    if (parse_result != 0) {
+        LOG_HTTP_DEBUG("Failed to parse multipart data (error: %d)", parse_result);
+        catzilla_multipart_parser_cleanup(parser);
+        catzilla_request_free(parser);
+        return -1;
+    }
+
+    parse_result = catzilla_multipart_parse_complete(parser);
+    if (parse_result != 0) {
+        LOG_HTTP_DEBUG("Failed to complete multipart parsing (error: %d)", parse_result);
+        catzilla_multipart_parser_cleanup(parser);
+        catzilla_request_free(parser);
+        return -1;
+    }
+
+    LOG_HTTP_DEBUG("Multipart parsing completed, found %zu files", parser->files_count);
+
+    store_multipart_files(request, parser);
+
+    // Clean up
+    catzilla_multipart_parser_cleanup(parser);
+    catzilla_request_free(parser);
+    return 0;
+}
+
+yyjson_val* catzilla_get_json(catzilla_request_t* request) {
+    if (!request->is_json_parsed) {
+        if (catzilla_parse_json(request) != 0) {
+            return NULL;
+        }
+    }
+    return request->json_root;
+}
+
+const char* catzilla_get_form_field(catzilla_request_t* request, const char* field) {
+    if (!request->is_form_parsed) {
+        if (catzilla_parse_form(request) != 0) {
+            return NULL;
+        }
+    }
+
+    return catzilla_param_table_get(&request->form, field);
+}
+
+// Get the content type as a string
+const char* catzilla_get_content_type_str(catzilla_request_t* request) {
+    if (!request) {
+        LOG_HTTP_DEBUG("get_content_type_str: NULL request");
+        return "";
+    }
+
+    content_type_t type = request->content_type;
+    LOG_HTTP_DEBUG("get_content_type_str: type=%d", (int)type);
+
+    switch (type) {
+        case CONTENT_TYPE_JSON:
+            LOG_HTTP_DEBUG("get_content_type_str: returning application/json");
+            return "application/json";
+        case CONTENT_TYPE_FORM:
+            LOG_HTTP_DEBUG("get_content_type_str: returning application/x-www-form-urlencoded");
+            return "application/x-www-form-urlencoded";
+        case CONTENT_TYPE_MULTIPART:
+            LOG_HTTP_DEBUG("get_content_type_str: returning multipart/form-data");
+            return "multipart/form-data";
+        case CONTENT_TYPE_NONE:
+        default:
+            LOG_HTTP_DEBUG("get_content_type_str: returning text/plain");
+            return "text/plain";
+    }
+}
+
+// Helper function for URL decoding
+void url_decode(const char* src, char* dst) {
+    catzilla_url_decode(src, strlen(src), dst);
+}
+
+int catzilla_server_init(catzilla_server_t* server) {
+    memset(server, 0, sizeof(*server));
+    server->loop = uv_default_loop();
+    if (!server->loop) return -1;
+
+    int rc = uv_tcp_init(server->loop, &server->server);
+    if (rc) return rc;
+    server->server.data = server;
+
+    // Initialize signal handler
+    rc = uv_signal_init(server->loop, &server->sig_handle);
+    if (rc) return rc;
+    server->sig_handle.data = server;
+
+    // Initialize SIGTERM handler
+    rc = uv_signal_init(server->loop, &server->sigterm_handle);
+    if (rc) return rc;
+    server->sigterm_handle.data = server;
+
+    // Initialize advanced router
+    rc = catzilla_router_init(&server->router);
+    if (rc) {
+        LOG_SERVER_ERROR("Failed to initialize advanced router");
+        return rc;
+    }
+    rc = catzilla_router_init(&server->websocket_router);
+    if (rc) {
+        LOG_SERVER_ERROR("Failed to initialize WebSocket router");
+        return rc;
+    }
+
+    llhttp_settings_init(&server->parser_settings);
+    server->parser_settings.on_message_begin  = on_message_begin;
+    server->parser_settings.on_url            = on_url;
+    server->parser_settings.on_header_field   = on_header_field;
+    server->parser_settings.on_header_value   = on_header_value;
+    server->parser_settings.on_header_value_complete = on_header_value_complete;
+    server->parser_settings.on_headers_complete = on_headers_complete;
+    server->parser_settings.on_body           = on_body;
+    server->parser_settings.on_message_complete = on_message_complete;
+
+    server->route_count = 0;
+    server->is_running = false;
+    server->worker_count = 1;
+    server->active_worker_count = 0;
+    server->workers = NULL;
+    server->context_pool_limit = CATZILLA_DEFAULT_CONTEXT_POOL_LIMIT;
+    server->python_batch_size = CATZILLA_DEFAULT_PYTHON_BATCH_SIZE;
+    server->python_batch_budget_us = CATZILLA_DEFAULT_PYTHON_BATCH_BUDGET_US;
+    server->max_body_size = 0;
+    server->body_spool_threshold = CATZILLA_DEFAULT_BODY_SPOOL_THRESHOLD;
+    server->body_route_count = 0;
+    server->memory_budget = 0;
+    server->memory_check_interval_ms = CATZILLA_DEFAULT_MEMORY_CHECK_INTERVAL_MS;
+    server->pressure_upload_limit = CATZILLA_DEFAULT_PRESSURE_UPLOAD_LIMIT;
+    server->response_cache_capacity = 0;
+    server->header_timeout = CATZILLA_DEFAULT_HEADER_TIMEOUT_MS;
+    server->body_timeout = CATZILLA_DEFAULT_BODY_TIMEOUT_MS;
+    server->keepalive_timeout = CATZILLA_DEFAULT_KEEPALIVE_TIMEOUT_MS;
+    server->write_timeout = CATZILLA_DEFAULT_WRITE_TIMEOUT_MS;
+    server->websocket_route_count = 0;
+    catzilla_websocket_options_init(&server->websocket);
+    server->max_connections = 0;
+    server->connections_low_water = 0;
+    catzilla_compression_config_init(&server->compression);
+    server->compression.enabled = false;
+    server->tls_context = NULL;
+    server->handoff_fd = -1;
+    server->py_request_callback = NULL;
+
+    // Initialize static file mounts
+    server->static_mounts = NULL;
+    server->static_mount_count = 0;
+
+    // Set global reference for signal handling
+    active_server = server;
+
+    LOG_SERVER_INFO("Server initialized with advanced routing system");
+    return 0;
+}
+
+void signal_handler(uv_signal_t* handle, int signum) {
+    catzilla_server_t* server = (catzilla_server_t*)handle->data;
+
+    LOG_SERVER_INFO("Signal %d received, initiating graceful shutdown...", signum);
+
+    if (server && server->is_running) {
+        catzilla_server_stop(server);
+    }
+}
+
+void catzilla_server_cleanup(catzilla_server_t* server) {
+    server->is_running = false;
+
+    // Clean up advanced router
+    release_route_state(server);
+    catzilla_router_cleanup(&server->router);
+    catzilla_router_cleanup(&server->websocket_router);
+    if (server->response_cache) {
+        multi_cache_destroy(server->response_cache);
+        server->response_cache = NULL;
+    }
+    free(server->cache_snapshot_dir);
+    server->cache_snapshot_dir = NULL;
+    free(server->handoff_path);
+    server->handoff_path = NULL;
+    free(server->clamd_address);
+    server->clamd_address = NULL;
+
+    uv_close((uv_handle_t*)&server->server, NULL);
+    uv_close((uv_handle_t*)&server->sig_handle, NULL);
+    uv_close((uv_handle_t*)&server->sigterm_handle, NULL);
+    uv_run(server->loop, UV_RUN_DEFAULT);
+    catzilla_tls_context_free(server->tls_context);
+    server->tls_context = NULL;
+    // Loops are gone; what their rings still hold is written now
+    catzilla_access_log_close(server->access_log);
+    server->access_log = NULL;
+    active_server = NULL;
+}
+
+uv_loop_t* catzilla_server_current_loop(void) {
+    return current_loop;
+}
+
+int catzilla_server_set_worker_count(catzilla_server_t* server, int workers) {
+    if (!server || workers < 0 || workers > CATZILLA_MAX_WORKERS) return -1;
+    if (server->is_running) {
+        LOG_SERVER_WARN("Cannot change worker count while the server is running");
+        return -1;
+    }
+    server->worker_count = workers;
+    return 0;
+}
+
+static int resolve_worker_count(const catzilla_server_t* server) {
+    int loops = server->worker_count;
+    if (loops <= 0) {
+        uv_cpu_info_t* cpus = NULL;
+        int cpu_count = 0;
+        loops = 1;
+        if (uv_cpu_info(&cpus, &cpu_count) == 0) {
+            loops = cpu_count;
+            uv_free_cpu_info(cpus, cpu_count);
+        }
+    }
+    if (loops < 1) loops = 1;
+    if (loops > CATZILLA_MAX_WORKERS) loops = CATZILLA_MAX_WORKERS;
+    return loops;
+}
+
+// Bind a listener, optionally with SO_REUSEPORT so several loops can share the port
+static int bind_listener(uv_tcp_t* handle, const struct sockaddr* addr, bool reuseport) {
+#ifdef CATZILLA_HAS_REUSEPORT
+    if (reuseport) {
+        int fd = socket(addr->sa_family, SOCK_STREAM, 0);
+        if (fd < 0) return uv_translate_sys_error(errno);
+
+        int on = 1;
+        if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) != 0) {
+            int err = errno;
+            close(fd);
+            return uv_translate_sys_error(err);
+        }
+
+        int rc = uv_tcp_open(handle, (uv_os_sock_t)fd);
+        if (rc) {
+            close(fd);
+            return rc;
+        }
+    }
+#else
+    (void)reuseport;
+#endif
+    return uv_tcp_bind(handle, addr, 0);
+}
+
+// Serve on a listening socket inherited from the server this one replaces
+static int adopt_listener(uv_tcp_t* handle, int fd) {
+    int rc = uv_tcp_open(handle, (uv_os_sock_t)fd);
+    if (rc) close(fd);
+    return rc;
+}
+
+static void close_inherited(const int* fds, int count) {
+    for (int i = 0; i < count; i++) close(fds[i]);
+}
+
+#ifndef _WIN32
+// Whether an inherited socket is a TCP listener on the address asked for
+static bool listener_matches(int fd, const struct sockaddr* addr) {
+    struct sockaddr_storage bound;
+    socklen_t length = sizeof(bound);
+    int type = 0;
+    socklen_t type_length = sizeof(type);
+    if (getsockname(fd, (struct sockaddr*)&bound, &length) != 0 || bound.ss_family != addr->sa_family ||
+        getsockopt(fd, SOL_SOCKET, SO_TYPE, &type, &type_length) != 0 || type != SOCK_STREAM) {
+        return false;
+    }
+    if (addr->sa_family == AF_INET) {
+        const struct sockaddr_in* have = (const struct sockaddr_in*)&bound;
+        const struct sockaddr_in* want = (const struct sockaddr_in*)addr;
+        return have->sin_port == want->sin_port && have->sin_addr.s_addr == want->sin_addr.s_addr;
+    }
+    if (addr->sa_family == AF_INET6) {
+        const struct sockaddr_in6* have = (const struct sockaddr_in6*)&bound;
+        const struct sockaddr_in6* want = (const struct sockaddr_in6*)addr;
+        return have->sin6_port == want->sin6_port &&
+               memcmp(&have->sin6_addr, &want->sin6_addr, sizeof(want->sin6_addr)) == 0;
+    }
+    return false;
+}
+#endif
+
+// Listening sockets of the server this one replaces, when one offers them on
+// the handoff socket; sockets bound to another address are closed
+static int take_over_listeners(catzilla_server_t* server, const struct sockaddr* addr, int* fds) {
+#ifdef _WIN32
+    (void)server; (void)addr; (void)fds;
+    return 0;
+#else
+    if (!server->handoff_path) return 0;
+
+    int count = catzilla_handoff_request(server->handoff_path, fds, CATZILLA_MAX_WORKERS,
+                                         CATZILLA_HANDOFF_TIMEOUT_MS);
+    if (count <= 0) return 0;  // Nothing to take over: bind as usual
+
+    int kept = 0;
+    for (int i = 0; i < count; i++) {
+        if (listener_matches(fds[i], addr)) {
+            fds[kept++] = fds[i];
+        } else {
+            close(fds[i]);
+        }
+    }
+    if (kept < count) {
+        LOG_SERVER_WARN("Closed %d inherited listener(s) bound to another address", count - kept);
+    }
+    if (kept > 0) {
+        LOG_SERVER_INFO("Took over %d listening socket%s from the previous server", kept, kept > 1 ? "s" : "");
+    }
+    return kept;
+#endif
+}
+
+static void on_handoff_poll_closed(uv_handle_t* handle) {
+    catzilla_server_t* server = (catzilla_server_t*)handle->data;
+    catzilla_handoff_close(server->handoff_fd, server->handoff_path, server->handoff_inode);
+    server->handoff_fd = -1;
+}
+
+// Stop once every connection closed or the drain timeout passed
+static void on_drain_tick(uv_timer_t* timer) {
+    catzilla_server_t* server = (catzilla_server_t*)timer->data;
+    uint64_t open = catzilla_atomic_load(&stat_active_connections);
+    bool expired = server->drain_timeout_ms > 0 && uv_now(timer->loop) >= server->drain_deadline;
+    if (open > 0 && !expired) return;
+
+    if (open > 0) {
+        LOG_SERVER_WARN("Drain timeout reached with %llu connection(s) open", (unsigned long long)open);
+    } else {
+        LOG_SERVER_INFO("All connections drained");
+    }
+    catzilla_server_stop(server);
+}
+
+static void begin_drain(catzilla_server_t* server) {
+    server->handed_off = true;
+    catzilla_atomic_store(&server_draining, 1);
+    uv_close((uv_handle_t*)&server->handoff_poll, on_handoff_poll_closed);
+
+    LOG_SERVER_INFO("Listeners handed to the new server, draining %llu connection(s)",
+                    (unsigned long long)catzilla_atomic_load(&stat_active_connections));
+    server->drain_deadline = uv_now(server->loop) + server->drain_timeout_ms;
+    server->drain_timer.data = server;
+    if (uv_timer_init(server->loop, &server->drain_timer) != 0 ||
+        uv_timer_start(&server->drain_timer, on_drain_tick, CATZILLA_TIMEOUT_TICK_MS,
+                       CATZILLA_TIMEOUT_TICK_MS) != 0) {
+        LOG_SERVER_WARN("Drain timer unavailable, stopping without draining");
+        catzilla_server_stop(server);
+    }
+}
+
+// A successor asks for the listeners: write the cache snapshots it is about
+// to load, send it every loop's listener and drain once it holds them
+static void on_handoff_request(uv_poll_t* handle, int status, int events) {
+    (void)events;
+    catzilla_server_t* server = (catzilla_server_t*)handle->data;
+    if (status < 0 || !server->is_running || server->handed_off) return;
+
+    int peer = catzilla_handoff_accept(server->handoff_fd);
+    if (peer < 0) return;
+
+    // The main listener goes first; the successor's main loop takes it
+    int fds[CATZILLA_HANDOFF_MAX_FDS];
+    int count = 0;
+    uv_os_fd_t fd;
+    if (uv_fileno((uv_handle_t*)&server->server, &fd) == 0) {
+        fds[count++] = (int)(intptr_t)fd;
+    }
+    for (int i = 0; i < server->active_worker_count && count < CATZILLA_HANDOFF_MAX_FDS; i++) {
+        if (uv_fileno((uv_handle_t*)&server->workers[i].listener, &fd) == 0) {
+            fds[count++] = (int)(intptr_t)fd;
+        }
+    }
+
+    save_cache_snapshots(server);
+    if (catzilla_handoff_send(peer, fds, count, CATZILLA_HANDOFF_ACK_TIMEOUT_MS) != 0) return;
+    begin_drain(server);
+}
+
+// Bind the handoff socket the next reload takes the listeners over through
+static void start_handoff_socket(catzilla_server_t* server) {
+    if (!server->handoff_path) return;
+
+    server->handoff_fd = catzilla_handoff_listen(server->handoff_path, &server->handoff_inode);
+    if (server->handoff_fd < 0) {
+        LOG_SERVER_WARN("Reloads cannot take over the listeners of this server");
+        return;
+    }
+    server->handoff_poll.data = server;
+    if (uv_poll_init(server->loop, &server->handoff_poll, server->handoff_fd) != 0 ||
+        uv_poll_start(&server->handoff_poll, UV_READABLE, on_handoff_request) != 0) {
+        LOG_SERVER_WARN("Reloads cannot take over the listeners of this server");
+        catzilla_handoff_close(server->handoff_fd, server->handoff_path, server->handoff_inode);
+        server->handoff_fd = -1;
+        return;
+    }
+    // Waiting for a successor must not keep the loop running
+    uv_unref((uv_handle_t*)&server->handoff_poll);
+    LOG_SERVER_INFO("Reloads take over the listeners through %s", server->handoff_path);
+}
+
+static void close_walk_cb(uv_handle_t* handle, void* arg) {
+    (void)arg;
+    if (!uv_is_closing(handle)) {
+        uv_close(handle, NULL);
+    }
+}
+
+static void on_worker_stop(uv_async_t* handle) {
+    uv_stop(handle->loop);
+}
+
+static void worker_thread_main(void* arg) {
+    catzilla_server_worker_t* worker = (catzilla_server_worker_t*)arg;
+    current_loop = &worker->loop;
+
+    if (catzilla_date_cache_start(&worker->loop, &worker->date_timer) != 0) {
+        LOG_SERVER_WARN("Worker loop %d: Date header refresh timer unavailable", worker->index);
+    }
+    if (start_connection_timers(&worker->loop, &worker->timeout_timer, &worker->listener) != 0) {
+        LOG_SERVER_WARN("Worker loop %d: connection timeouts unavailable", worker->index);
+    }
+    if (start_python_dispatch(&worker->loop) != 0) {
+        LOG_SERVER_WARN("Worker loop %d: Python requests dispatched without batching", worker->index);
+    }
+    attach_response_cache_redis(worker->server, &worker->loop);
+    attach_clamd(worker->server, &worker->loop);
+    if (catzilla_sse_attach_loop(&worker->loop) != 0) {
+        LOG_SERVER_WARN("Worker loop %d: SSE hubs unavailable", worker->index);
+    }
+
+    LOG_SERVER_DEBUG("Worker loop %d running", worker->index);
+    uv_run(&worker->loop, UV_RUN_DEFAULT);
+    catzilla_date_cache_stop();
+    stop_connection_timers();
+    stop_python_dispatch();
+    detach_response_cache_redis(worker->server);
+    detach_clamd();
+    catzilla_sse_detach_loop(&worker->loop);
+    if (loop_exit_hook) loop_exit_hook(&worker->loop);
+
+    // Close the listener, stop handle and any open connections on this loop
+    uv_walk(&worker->loop, close_walk_cb, NULL);
+    uv_run(&worker->loop, UV_RUN_DEFAULT);
+    if (uv_loop_close(&worker->loop) != 0) {
+        LOG_SERVER_WARN("Worker loop %d close returned busy", worker->index);
+    }
+    catzilla_read_pool_trim();
+    catzilla_compression_trim();
+    catzilla_di_instance_pool_trim();
+    trim_client_context_pool();
+    catzilla_static_uring_shutdown();
+    catzilla_perf_thread_close();
+    current_loop = NULL;
+}
+
+static void stop_worker_loops(catzilla_server_t* server, int count) {
+    if (!server->workers) return;
+
+    for (int i = 0; i < count; i++) {
+        catzilla_server_worker_t* worker = &server->workers[i];
+        if (worker->thread_started) {
+            uv_async_send(&worker->stop_async);
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        catzilla_server_worker_t* worker = &server->workers[i];
+        if (worker->thread_started) {
+            uv_thread_join(&worker->thread);
+        } else if (worker->loop_initialized) {
+            // Never started: tear the loop down on this thread
+            uv_walk(&worker->loop, close_walk_cb, NULL);
+            uv_run(&worker->loop, UV_RUN_DEFAULT);
+            uv_loop_close(&worker->loop);
+        }
+    }
+
+    catzilla_cache_free(server->workers);
+    server->workers = NULL;
+    server->active_worker_count = 0;
+}
+
+static int start_worker_loops(catzilla_server_t* server, const struct sockaddr* addr, int count,
+                              const int* inherited, int inherited_count) {
+    server->workers = catzilla_cache_alloc(sizeof(catzilla_server_worker_t) * count);
+    if (!server->workers) {
+        close_inherited(inherited, inherited_count);
+        return UV_ENOMEM;
+    }
+    memset(server->workers, 0, sizeof(catzilla_server_worker_t) * count);
+
+    int rc = 0;
+    int adopted = 0;  // Inherited sockets already handed to a listener
+    int i;
+    for (i = 0; i < count; i++) {
+        catzilla_server_worker_t* worker = &server->workers[i];
+        worker->server = server;
+        worker->index = i + 1;
+
+        rc = uv_loop_init(&worker->loop);
+        if (rc) break;
+        worker->loop_initialized = true;
+
+        rc = uv_tcp_init(&worker->loop, &worker->listener);
+        if (rc) break;
+        worker->listener.data = server;
+
+        if (i < inherited_count) {
+            adopted = i + 1;
+            rc = adopt_listener(&worker->listener, inherited[i]);
+        } else {
+            rc = bind_listener(&worker->listener, addr, true);
+        }
+        if (rc) break;
+
+        rc = uv_listen((uv_stream_t*)&worker->listener, 4096, on_connection);
+        if (rc) break;
+
+        rc = uv_async_init(&worker->loop, &worker->stop_async, on_worker_stop);
+        if (rc) break;
+        worker->stop_async.data = worker;
+
+        rc = uv_thread_create(&worker->thread, worker_thread_main, worker);
+        if (rc) break;
+        worker->thread_started = true;
+    }
+
+    if (rc) {
+        LOG_SERVER_ERROR("Failed to start worker loop %d: %s", i + 1, uv_strerror(rc));
+        if (adopted < inherited_count) {
+            close_inherited(inherited + adopted, inherited_count - adopted);
+        }
+        stop_worker_loops(server, i + 1);
+        return rc;
+    }
+
+    server->active_worker_count = count;
+    return 0;
+}
+
+int catzilla_server_listen(catzilla_server_t* server, const char* host, int port) {
+    // Fallback to default host if NULL or empty
+    const char* bind_host = (host != NULL && strlen(host) > 0) ? host : "0.0.0.0";
+
+    int rc;
+#ifdef _WIN32
+    const char* effective_bind_host = (strcmp(bind_host, "0.0.0.0") == 0) ? "::" : bind_host;
+#else
+    const char* effective_bind_host = bind_host;
+#endif
+
+    struct sockaddr_storage addr;
+    memset(&addr, 0, sizeof(addr));
+    if (strchr(effective_bind_host, ':') != NULL) {
+        rc = uv_ip6_addr(effective_bind_host, port, (struct sockaddr_in6*)&addr);
+    } else {
+        rc = uv_ip4_addr(effective_bind_host, port, (struct sockaddr_in*)&addr);
+    }
+    if (rc) {
+        LOG_SERVER_ERROR("Failed to resolve %s:%d: %s", effective_bind_host, port, uv_strerror(rc));
+        return rc;
+    }
+
+    int loops = resolve_worker_count(server);
+    catzilla_atomic_store(&server_draining, 0);
+    server->handed_off = false;
+
+    // A reload serves on the listeners of the server it replaces. Connections
+    // wait in each socket's own accept queue, so every one gets a loop.
+    int inherited[CATZILLA_HANDOFF_MAX_FDS];
+    int inherited_count = take_over_listeners(server, (const struct sockaddr*)&addr, inherited);
+    if (inherited_count > loops) {
+        LOG_SERVER_INFO("Running %d event loops, one per inherited listener", inherited_count);
+        loops = inherited_count;
+    }
+#ifndef CATZILLA_HAS_REUSEPORT
+    if (loops > 1) {
+        LOG_SERVER_WARN("SO_REUSEPORT is not available on this platform, using a single event loop");
+        loops = 1;
+    }
+#endif
+    if (inherited_count > loops) {
+        close_inherited(inherited + loops, inherited_count - loops);
+        inherited_count = loops;
+    }
+
+    // With a handoff socket the next server may run more loops than this one,
+    // binding its extra listeners next to the inherited ones
+    if (inherited_count > 0) {
+        rc = adopt_listener(&server->server, inherited[0]);
+    } else {
+        rc = bind_listener(&server->server, (const struct sockaddr*)&addr,
+                           loops > 1 || server->handoff_path != NULL);
+    }
+    if (rc) {
+        LOG_SERVER_ERROR("Bind %s:%d: %s", effective_bind_host, port, uv_strerror(rc));
+        if (inherited_count > 1) close_inherited(inherited + 1, inherited_count - 1);
+        return rc;
+    }
+    rc = uv_listen((uv_stream_t*)&server->server, 4096, on_connection);
+    if (rc) {
+        LOG_SERVER_ERROR("Listen %s:%d: %s", effective_bind_host, port, uv_strerror(rc));
+        if (inherited_count > 1) close_inherited(inherited + 1, inherited_count - 1);
+        return rc;
+    }
+
+    // Set up signal handler for graceful shutdown
+    rc = uv_signal_start(&server->sig_handle, signal_handler, SIGINT);
+    if (rc) {
+        LOG_SERVER_ERROR("Failed to set up SIGINT handler: %s", uv_strerror(rc));
+        return rc;
+    }
+
+    // Also handle SIGTERM for proper shutdown (initialized in catzilla_server_init)
+    rc = uv_signal_start(&server->sigterm_handle, signal_handler, SIGTERM);
+    if (rc) {
+        LOG_SERVER_ERROR("Failed to set up SIGTERM handler: %s", uv_strerror(rc));
+        return rc;
+    }
+
+    // Caches are warmed before any loop can look them up
+    load_cache_snapshots(server);
+
+    // From here lookups may run on several loops while routes change, so
+    // changes go through published snapshots
+    catzilla_router_share(&server->router);
+    catzilla_router_share(&server->websocket_router);
+
+    // Extra loops share the port via SO_REUSEPORT and the router
+    if (loops > 1) {
+        rc = start_worker_loops(server, (const struct sockaddr*)&addr, loops - 1,
+                                inherited + 1, inherited_count > 1 ? inherited_count - 1 : 0);
+        if (rc) {
+            return rc;
+        }
+    }
+    start_handoff_socket(server);
+
+    LOG_SERVER_INFO("Catzilla server listening on %s:%d (%d event loop%s)",
+                    bind_host, port, loops, loops > 1 ? "s" : "");
+    LOG_SERVER_INFO("Press Ctrl+C to stop the server");
+
+    // Date header is formatted once per second instead of per response
+    if (catzilla_date_cache_start(server->loop, &server->date_timer) != 0) {
+        LOG_SERVER_WARN("Date header refresh timer unavailable, formatting on demand");
+    }
+    if (start_connection_timers(server->loop, &server->timeout_timer, &server->server) != 0) {
+        LOG_SERVER_WARN("Connection timeout timer unavailable, timeouts disabled");
+    }
+    if (start_python_dispatch(server->loop) != 0) {
+        LOG_SERVER_WARN("Python requests dispatched without batching");
+    }
+    if (start_memory_governor(server) != 0) {
+        LOG_SERVER_WARN("Memory governor timer unavailable, the memory budget is not enforced");
+    }
+    attach_response_cache_redis(server, server->loop);
+    attach_clamd(server, server->loop);
+    if (catzilla_sse_attach_loop(server->loop) != 0) {
+        LOG_SERVER_WARN("SSE hubs unavailable");
+    }
+
+    server->is_running = true;
+    current_loop = server->loop;
+    rc = uv_run(server->loop, UV_RUN_DEFAULT);
+    current_loop = NULL;
+    catzilla_date_cache_stop();
+    stop_connection_timers();
+    stop_python_dispatch();
+    detach_response_cache_redis(server);
+    detach_clamd();
+    catzilla_sse_detach_loop(server->loop);
+    if (loop_exit_hook) loop_exit_hook(server->loop);
+    return rc;
+}
+
+
+void catzilla_server_stop(catzilla_server_t* server) {
+    if (!server->is_running) return;
+
+    LOG_SERVER_INFO("Stopping Catzilla server...");
+    server->is_running = false;
+
+    // Stop and join the worker loops before tearing down the main loop
+    if (server->active_worker_count > 0) {
+        stop_worker_loops(server, server->active_worker_count);
+        LOG_SERVER_INFO("Stopped worker loops...");
+    }
+
+    //  Stop the loop so the outer uv_run in listen() will exit
+    uv_stop(server->loop);
+
+    // Stop both signal handlers but don't close them yet
+    uv_signal_stop(&server->sig_handle);
+    uv_signal_stop(&server->sigterm_handle);
+    LOG_SERVER_INFO("Stopped signal handlers...");
+
+    // Lookups still waiting for Redis end with their connections; the
+    // client's handles close with their own callbacks
+    stop_python_dispatch();
+    detach_response_cache_redis(server);
+    detach_clamd();
+    catzilla_sse_detach_loop(server->loop);
+    if (loop_exit_hook) loop_exit_hook(server->loop);
+
+    // Walk and close all active handles
+    // This will include server->server and server->sig_handle
+    uv_walk(server->loop, close_walk_cb, NULL);
+    LOG_SERVER_INFO("Closing all active handles...");
+
+    // Run the loop so that each close callback fires
+    uv_run(server->loop, UV_RUN_DEFAULT);
+
+    // 5) Finally, close the loop itself
+    if (uv_loop_close(server->loop) != 0) {
+        LOG_SERVER_WARN("uv_loop_close returned busy");
+    }
+
+    // Release read slabs, compression buffers, pooled DI instances,
+    // connection contexts and the io_uring ring held by the main loop
+    catzilla_read_pool_trim();
+    catzilla_compression_trim();
+    catzilla_di_instance_pool_trim();
+    trim_client_context_pool();
+    catzilla_static_uring_shutdown();
+
+    // A handoff socket without a successor is removed
+    if (server->handoff_fd >= 0) {
+        catzilla_handoff_close(server->handoff_fd, server->handoff_path, server->handoff_inode);
+        server->handoff_fd = -1;
+    }
+
+    // Nothing serves requests any more; the caches can be written as they are.
+    // After a handoff they were written for the successor, which owns them now.
+    if (!server->handed_off) {
+        save_cache_snapshots(server);
+    }
+
+    LOG_SERVER_INFO("Server stopped");
+}
+
+int catzilla_server_add_route(catzilla_server_t* server,
+                             const char* method,
+                             const char* path,
+                             void* handler,
+                             void* user_data) {
+    if (!server || !method || !path) return -1;
+
+    // Check for route conflicts and warn
+    catzilla_server_check_route_conflicts(server, method, path);
+
+    // Add to advanced router first
+    uint32_t route_id = catzilla_router_add_route(&server->router, method, path, handler, user_data, false);
+    if (route_id > 0) {
+        LOG_ROUTER_DEBUG("Added route to advanced router: %s %s (ID: %u)", method, path, route_id);
+        return 0;  // Success
+    }
+
+    // Fallback to legacy route table if advanced router fails
+    if (server->route_count >= CATZILLA_MAX_ROUTES) {
+        LOG_SERVER_ERROR("Maximum legacy routes reached (%d)", CATZILLA_MAX_ROUTES);
+        return -1;
+    }
+
+    catzilla_route_t* route = &server->routes[server->route_count++];
+    strncpy(route->method, method, CATZILLA_METHOD_MAX-1);
+    route->method[CATZILLA_METHOD_MAX-1] = '\0';
+    strncpy(route->path, path, CATZILLA_PATH_MAX-1);
+    route->path[CATZILLA_PATH_MAX-1] = '\0';
+    route->handler = handler;
+    route->user_data = user_data;
+
+    LOG_ROUTER_DEBUG("Added route to legacy table: %s %s", method, path);
+    return 0;
+}
+
+int catzilla_server_remove_route(catzilla_server_t* server, const char* method, const char* path) {
+    if (!server || !method || !path) return -1;
+
+    uint32_t route_id = catzilla_router_find_route(&server->router, method, path);
+    if (route_id == 0 || catzilla_router_remove_route(&server->router, route_id) != 0) return -1;
+    LOG_ROUTER_DEBUG("Removed route %s %s (ID: %u)", method, path, route_id);
+    return 0;
+}
+
+void catzilla_server_set_request_callback(catzilla_server_t* server, void* callback) {
+    server->py_request_callback = callback;
+}
+
+// Internal function that adds Connection headers based on client context
+static void send_response_with_connection(uv_stream_t* client,
+                                        int status_code,
+                                        const char* headers,
+                                        const char* body,
+                                        size_t body_len,
+                                        bool keep_alive) {
+    // Caller keeps ownership of body, so it is always copied
+    send_response_buffers(client, status_code, headers, body, body_len, keep_alive, NULL, NULL);
+}
+
+static void release_body(catzilla_body_release_fn release, void* owner, const char* body, size_t body_len) {
+    if (release) {
+        release(owner, body, body_len);
+    }
+}
+
+static void release_compressed_body(void* owner, const char* body, size_t body_len) {
+    (void)body;
+    (void)body_len;
+    catzilla_compress_buffer_release(owner);
+}
+
+// Compress a response body for the client when the server has compression
+// on, the media type is worth it and the result is smaller. Returns the
+// compressed body and the headers to send with it (response-allocated).
+static catzilla_compress_buffer_t* compress_response(client_context_t* context, int status_code,
+                                                     const char* headers, const char* body,
+                                                     size_t body_len, char** headers_out) {
+    const catzilla_compression_config_t* config = &context->server->compression;
+    if (!body || body_len < config->min_size) return NULL;
+    if (status_code < 200 || status_code == 204 || status_code == 206 || status_code == 304) return NULL;
+
+    const char* accept_encoding = catzilla_header_set_get_known(&context->headers, CATZILLA_HDR_ACCEPT_ENCODING, NULL);
+    if (!accept_encoding) return NULL;
+
+    bool headers_are_formatted = headers && strchr(headers, ':') != NULL;
+    const char* content_type = headers;
+    size_t content_type_len = headers ? strlen(headers) : 0;
+    if (headers_are_formatted) {
+        // The handler already chose the representation
+        if (headers_include_field(headers, "Content-Encoding") ||
+            headers_include_field(headers, "Content-Length") ||
+            headers_include_field(headers, "Content-Range")) {
+            return NULL;
+        }
+        size_t cache_control_len;
+        const char* cache_control = headers_field_value(headers, "Cache-Control", &cache_control_len);
+        for (size_t i = 0; cache_control && i + 12 <= cache_control_len; i++) {
+            if (strncasecmp(cache_control + i, "no-transform", 12) == 0) return NULL;
+        }
+        content_type = headers_field_value(headers, "Content-Type", &content_type_len);
+    }
+    if (!catzilla_compression_type_compressible(content_type, content_type_len)) return NULL;
+
+    int encoding = catzilla_compression_negotiate(config, accept_encoding, body_len);
+    if (encoding == CATZILLA_ENCODING_IDENTITY) return NULL;
+
+    catzilla_compress_buffer_t* compressed = NULL;
+    if (catzilla_compress(encoding, catzilla_compression_level(config, encoding), body, body_len,
+                          &compressed) != 0) {
+        return NULL;
+    }
+
+    const char* name = catzilla_compression_encoding_name(encoding);
+    size_t headers_len = headers ? strlen(headers) : 0;
+    size_t size = headers_len + strlen(name) + 96;
+    char* encoded = catzilla_response_alloc(size);
+    if (!encoded) {
+        catzilla_compress_buffer_release(compressed);
+        return NULL;
+    }
+    if (headers_are_formatted) {
+        snprintf(encoded, size, "%sContent-Encoding: %s\r\nVary: Accept-Encoding\r\n", headers, name);
+    } else {
+        snprintf(encoded, size, "Content-Type: %s\r\nContent-Encoding: %s\r\nVary: Accept-Encoding\r\n",
+                 headers ? headers : "text/plain", name);
+    }
+    *headers_out = encoded;
+    return compressed;
+}
+
+int catzilla_server_stream_encoding(uv_stream_t* client, const char* content_type, int* level) {
+    client_context_t* context = get_client_context(client);
+    if (!context || !context->server || context->h2 || !content_type) return CATZILLA_ENCODING_IDENTITY;
+
+    const catzilla_compression_config_t* config = &context->server->compression;
+    if (!catzilla_compression_type_compressible(content_type, strlen(content_type))) {
+        return CATZILLA_ENCODING_IDENTITY;
+    }
+    const char* accept_encoding = catzilla_header_set_get_known(&context->headers, CATZILLA_HDR_ACCEPT_ENCODING, NULL);
+    int encoding = catzilla_compression_negotiate(config, accept_encoding, SIZE_MAX);
+    if (level) *level = catzilla_compression_level(config, encoding);
+    return encoding;
+}
+
+// Hand the request's record to the access log; the first response a request
+// queues is the one logged
+static void log_access(client_context_t* context, int status_code, uint64_t bytes) {
+    context->access_pending = false;
+    catzilla_access_log_t* log = context->server->access_log;
+    if (!log || context->h2 || !catzilla_access_log_sampled(log, context->access_route_id)) return;
+
+    catzilla_access_record_t record;
+    record.started_ns = context->access_started_ns;
+    record.duration_ns = uv_hrtime() - context->access_started_ns;
+    record.bytes = bytes;
+    record.route_id = context->access_route_id;
+    record.status = (uint16_t)status_code;
+    record.http_major = context->parser.http_major;
+    record.http_minor = context->parser.http_minor;
+    snprintf(record.method, sizeof(record.method), "%s", context->method);
+    memcpy(record.remote_addr, context->remote_addr, sizeof(record.remote_addr));
+    snprintf(record.target, sizeof(record.target), "%s", context->url);
+    catzilla_access_log_append(log, &record);
+}
+
+// Build the header block and write it together with the body in one uv_write.
+// With a release callback, large bodies go out as a second uv_buf_t without
+// being copied and stay pinned until after_write; otherwise they are copied.
+static void send_response_buffers(uv_stream_t* client,
+                                  int status_code,
+                                  const char* headers,
+                                  const char* body,
+                                  size_t body_len,
+                                  bool keep_alive,
+                                  catzilla_body_release_fn release,
+                                  void* owner) {
+    client_context_t* context = get_client_context(client);
+    char* stored = NULL;
+    char* encoded_headers = NULL;
+    if (context && context->response_cache_key) {
+        // The response goes out with the validators its cached copy carries
+        size_t stored_size = 0;
+        stored = store_cached_response(context, status_code, headers, body, body_len, &stored_size);
+        catzilla_cached_view_t view;
+        if (stored && catzilla_http_cache_decode(stored, stored_size, &view)) {
+            if (catzilla_http_cache_not_modified(&view, &context->headers) &&
+                send_not_modified(context, &view)) {
+                catzilla_response_free(stored);
+                release_body(release, owner, body, body_len);
+                return;
+            }
+            headers = view.headers;
+        }
+    }
+    if (context && context->server && context->server->compression.enabled) {
+        // The cache keeps the identity body; each client gets its own coding
+        catzilla_compress_buffer_t* compressed = compress_response(context, status_code, headers, body,
+                                                                   body_len, &encoded_headers);
+        if (compressed) {
+            release_body(release, owner, body, body_len);
+            headers = encoded_headers;
+            body = compressed->data;
+            body_len = compressed->length;
+            release = release_compressed_body;
+            owner = compressed;
+        }
+    }
+    if (context && context->h2) {
+        // HTTP/2 frames are built by the session, which copies the body
+        send_http2_response(context, status_code, headers, body, body_len);
+        catzilla_response_free(encoded_headers);
+        catzilla_response_free(stored);
+        release_body(release, owner, body, body_len);
+        return;
+    }
+
+    // A draining server closes each connection after its current response
+    if (keep_alive && catzilla_atomic_load(&server_draining)) {
+        keep_alive = false;
+        if (context) context->keep_alive = false;
+    }
+
+    bool zero_copy = release != NULL && body_len >= CATZILLA_ZEROCOPY_MIN_BODY;
+    size_t copied_body_len = zero_copy ? 0 : body_len;
+
+    write_req_t* req = catzilla_response_alloc(sizeof(*req));
+    if (!req) {
+        catzilla_response_free(encoded_headers);
+        catzilla_response_free(stored);
+        release_body(release, owner, body, body_len);
+        return;
+    }
+
+    // Store keep_alive info in the request for after_write callback
+    req->keep_alive = keep_alive;
+    req->body_release = NULL;
+    req->body_owner = NULL;
+    req->nbufs = 1;
+    req->completes_deferred = false;
+    req->next = NULL;
+    req->latency.route = NULL;
+    if (context && context->latency.route) {
+        // The handler phase ends as its response is queued; the write phase
+        // ends when the socket took all of it
+        uint64_t now = uv_hrtime();
+        req->latency = context->latency;
+        req->latency.durations_ns[CATZILLA_LATENCY_HANDLER] = now - context->latency.mark_ns;
+        req->latency.mark_ns = now;
+        if (req->latency.counted) {
+            catzilla_perf_reading_t end;
+            req->latency.counted = catzilla_perf_read(&end) &&
+                                   catzilla_perf_elapsed(&context->latency.counters, &end, &req->latency.counters);
+        }
+        context->latency.route = NULL;
+    }
+
+    // Status line comes preformatted from the static table
+    size_t status_line_len = 0;
+    const char* status_line = catzilla_http_status_line(status_code, &status_line_len);
+    char custom_status_line[64];
+    if (!status_line) {
+        status_line_len = (size_t)snprintf(custom_status_line, sizeof(custom_status_line),
+                                           "HTTP/1.1 %d Unknown\r\n", status_code);
+        status_line = custom_status_line;
+    }
+
+    bool headers_are_formatted = headers && strchr(headers, ':') != NULL;
+    bool has_content_length = headers_are_formatted && headers_include_field(headers, "Content-Length");
+    bool has_date = headers_are_formatted && headers_include_field(headers, "Date");
+
+    static const char connection_keep_alive[] = "Connection: keep-alive\r\n";
+    static const char connection_close[] = "Connection: close\r\n";
+    const char* connection_header = keep_alive ? connection_keep_alive : connection_close;
+    size_t connection_header_len = keep_alive ?
+        sizeof(connection_keep_alive) - 1 : sizeof(connection_close) - 1;
+
+    char content_length_digits[CATZILLA_U64_DIGITS_MAX];
+    size_t content_length_digits_len = has_content_length ? 0 :
+        catzilla_u64toa((uint64_t)body_len, content_length_digits);
+
+    // Calculate exact header block size; every piece is a known length
+    size_t headers_len = headers ? strlen(headers) : 0;
+    size_t total_header_len = status_line_len + connection_header_len + 2;  // + "\r\n" separator
+    if (headers_len > 0) {
+        total_header_len += headers_are_formatted ?
+            headers_len : (sizeof("Content-Type: \r\n") - 1) + headers_len;
+    }
+    if (!has_content_length) {
+        total_header_len += (sizeof("Content-Length: \r\n") - 1) + content_length_digits_len;
+    }
+    if (!has_date) {
+        total_header_len += CATZILLA_DATE_HEADER_LEN;
+    }
+
+    size_t buffer_len = total_header_len + copied_body_len;
+    char* response = catzilla_response_alloc(buffer_len);
+    if (!response) {
+        catzilla_response_free(req);
+        catzilla_response_free(encoded_headers);
+        catzilla_response_free(stored);
+        release_body(release, owner, body, body_len);
+        return;
+    }
+
+    // Build the response
+    size_t offset = 0;
+    memcpy(response + offset, status_line, status_line_len);
+    offset += status_line_len;
+
+    if (headers_len > 0) {
+        if (headers_are_formatted) {
+            memcpy(response + offset, headers, headers_len);
+            offset += headers_len;
+        } else {
+            memcpy(response + offset, "Content-Type: ", 14);
+            offset += 14;
+            memcpy(response + offset, headers, headers_len);
+            offset += headers_len;
+            memcpy(response + offset, "\r\n", 2);
+            offset += 2;
+        }
+    }
+
+    // Add Connection header
+    memcpy(response + offset, connection_header, connection_header_len);
+    offset += connection_header_len;
+
+    if (!has_content_length) {
+        // Add Content-Length header so keep-alive clients can detect response completion.
+        memcpy(response + offset, "Content-Length: ", 16);
+        offset += 16;
+        memcpy(response + offset, content_length_digits, content_length_digits_len);
+        offset += content_length_digits_len;
+        memcpy(response + offset, "\r\n", 2);
+        offset += 2;
+    }
+
+    if (!has_date) {
+        memcpy(response + offset, catzilla_date_header(), CATZILLA_DATE_HEADER_LEN);
+        offset += CATZILLA_DATE_HEADER_LEN;
+    }
+
+    // Add separator between headers and body
+    memcpy(response + offset, "\r\n", 2);
+    offset += 2;
+    catzilla_response_free(encoded_headers);
+    catzilla_response_free(stored);
+
+    req->bufs[0] = uv_buf_init(response, buffer_len);
+
+    if (zero_copy) {
+        // Body is pinned by its owner until after_write releases it
+        req->bufs[1] = uv_buf_init((char*)body, body_len);
+        req->nbufs = 2;
+        req->body_release = release;
+        req->body_owner = owner;
+    } else {
+        if (copied_body_len > 0) {
+            memcpy(response + offset, body, copied_body_len);
+        }
+        // Small body was copied, so the owner can let go right away
+        release_body(release, owner, body, body_len);
+    }
+
+    if (context && context->deferred_response_pending) {
+        req->completes_deferred = true;
+    }
+    if (context && context->access_pending) {
+        log_access(context, status_code, buffer_len + (zero_copy ? body_len : 0));
+    }
+    CATZILLA_PROBE3(response_queued, context, status_code, buffer_len + (zero_copy ? body_len : 0));
+
+    submit_write_req(context, client, req);
+}
+
+// Write a response now, or queue it behind earlier pipelined responses while
+// a read is being parsed
+static void submit_write_req(client_context_t* context, uv_stream_t* client, write_req_t* req) {
+    if (context && context->corked) {
+        req->next = NULL;
+        if (context->cork_tail) {
+            context->cork_tail->next = req;
+        } else {
+            context->cork_head = req;
+        }
+        context->cork_tail = req;
+        context->cork_nbufs += req->nbufs;
+        return;
+    }
+
+    int rc = catzilla_server_write(&req->req, client, req->bufs, req->nbufs, after_write);
+    if (rc) {
+        LOG_SERVER_DEBUG("uv_write failed: %s", uv_strerror(rc));
+        release_write_req(req);
+    } else if (context) {
+        context->writes_in_flight++;
+        update_connection_timer(context, false);
+    }
+}
+
+void catzilla_send_response_zerocopy(uv_stream_t* client,
+                                     int status_code,
+                                     const char* headers,
+                                     const char* body,
+                                     size_t body_len,
+                                     catzilla_body_release_fn release,
+                                     void* owner) {
+    client_context_t* context = get_client_context(client);
+    bool keep_alive = context ? context->keep_alive : false;
+
+    // Streaming markers are small and handled by the copying path
+    if (body != NULL && body_len >= 24 && catzilla_is_streaming_response(body, body_len)) {
+        catzilla_send_response(client, status_code, headers, body, body_len);
+        release_body(release, owner, body, body_len);
+        return;
+    }
+
+    send_response_buffers(client, status_code, headers, body, body_len, keep_alive, release, owner);
+}
+
+void catzilla_send_response(uv_stream_t* client,
+                           int status_code,
+                           const char* headers,
+                           const char* body,
+                           size_t body_len) {
+    // Get client context to determine keep-alive setting
+    client_context_t* context = get_client_context(client);
+    bool keep_alive = context ? context->keep_alive : false;
+
+    // Check if this is a streaming response
+    if (body != NULL && body_len >= 24 && catzilla_is_streaming_response(body, body_len)) {
+        if (context && context->h2) {
+            // Streaming writes raw chunked HTTP/1.1 to the socket
+            const char* error = "500 Internal Server Error: Streaming responses are not supported over HTTP/2";
+            send_response_with_connection(client, 500, "text/plain", error, strlen(error), keep_alive);
+            return;
+        }
+
+        // Extract the streaming ID to connect to the Python StreamingResponse
+        const char* streaming_id = catzilla_extract_streaming_id(body, body_len);
+
+        if (streaming_id) {
+            // Streaming writes bypass the cork queue, so earlier responses go first
+            if (context) {
+                flush_corked_writes(context);
+            }
+
+            // The connect function was installed at import; it writes the
+            // response head and streams the body
+            catzilla_stream_connect_fn connect = catzilla_stream_get_connect();
+            PyGILState_STATE gstate = PyGILState_Ensure();
+            if (!connect || connect(client, streaming_id) != 0) {
+                PyErr_Clear();
+                // Closed when the failure came after the response head
+                if (!uv_is_closing((uv_handle_t*)client)) {
+                    send_response_with_connection(client, 500, "text/plain",
+                                                 "500 Internal Server Error: Streaming connection failed",
+                                                 strlen("500 Internal Server Error: Streaming connection failed"),
+                                                 keep_alive);
+                }
+            } else if (context && !uv_is_closing((uv_handle_t*)client)) {
+                context->phase = CONN_PHASE_STREAMING;
+                update_connection_timer(context, false);
+            }
+            PyGILState_Release(gstate);
+
+            free((void*)streaming_id);  // Free the allocated ID string
+        } else {
+            // Fallback to regular response if streaming ID extraction fails
+            send_response_with_connection(client, 500, "text/plain",
+                                         "500 Internal Server Error: Invalid streaming response",
+                                         strlen("500 Internal Server Error: Invalid streaming response"),
+                                         keep_alive);
+        }
+    } else {
+        // Regular, non-streaming response
+        send_response_with_connection(client, status_code, headers, body, body_len, keep_alive);
+    }
+}
+
+// Record the peer IP for request.remote_addr (empty when it cannot be read)
+static void store_peer_address(client_context_t* ctx) {
+    struct sockaddr_storage peer;
+    int len = sizeof(peer);
+    ctx->remote_addr[0] = '\0';
+    if (uv_tcp_getpeername(&ctx->client, (struct sockaddr*)&peer, &len) != 0) {
+        return;
+    }
+    if (peer.ss_family == AF_INET) {
+        uv_ip4_name((const struct sockaddr_in*)&peer, ctx->remote_addr, sizeof(ctx->remote_addr));
+    } else if (peer.ss_family == AF_INET6) {
+        uv_ip6_name((const struct sockaddr_in6*)&peer, ctx->remote_addr, sizeof(ctx->remote_addr));
+    }
+}
+
+static void on_connection(uv_stream_t* server, int status) {
+    if (status < 0) {
+        LOG_SERVER_DEBUG("Connection error: %s", uv_strerror(status));
+        return;
+    }
+    LOG_SERVER_DEBUG("New connection received");
+    catzilla_server_t* srv = server->data;
+
+    // At the limit the connection stays in the backlog: libuv stops polling a
+    // listener until its pending connection is accepted
+    if (srv->max_connections > 0 &&
+        catzilla_atomic_load(&stat_active_connections) >= srv->max_connections) {
+        if (!loop_connections.paused_listener) {
+            loop_connections.paused_listener = server;
+            catzilla_atomic_fetch_add(&stat_accept_pauses, 1);
+            LOG_SERVER_DEBUG("Connection limit %llu reached, pausing accept",
+                             (unsigned long long)srv->max_connections);
+        }
+        return;
+    }
+
+    accept_client(server);
+}
+
+static void accept_client(uv_stream_t* server) {
+    catzilla_server_t* srv = server->data;
+
+    client_context_t* ctx = acquire_client_context(srv);
+    if (!ctx) {
+        catzilla_atomic_fetch_add(&stat_accept_errors, 1);
+        return;
+    }
+
+    LOG_SERVER_DEBUG("Initialized client context with content_type=%d", (int)ctx->content_type);
+
+    // Accept onto the loop that owns the listener (main or worker loop)
+    if (uv_tcp_init(server->loop, &ctx->client) != 0) {
+        catzilla_atomic_fetch_add(&stat_accept_errors, 1);
+        release_client_context(ctx);
+        return;
+    }
+    ctx->client.data = ctx;
+    catzilla_atomic_fetch_add(&stat_active_connections, 1);
+    ctx->loop_pprev = &loop_connections.open;
+    ctx->loop_next = loop_connections.open;
+    if (ctx->loop_next) ctx->loop_next->loop_pprev = &ctx->loop_next;
+    loop_connections.open = ctx;
+
+    if (uv_accept(server, (uv_stream_t*)&ctx->client) != 0) {
+        catzilla_atomic_fetch_add(&stat_accept_errors, 1);
+        uv_close((uv_handle_t*)&ctx->client, on_close);
+        return;
+    }
+    catzilla_atomic_fetch_add(&stat_connections_accepted, 1);
+    store_peer_address(ctx);
+
+    if (srv->tls_context) {
+        uv_os_fd_t fd;
+        int sock = uv_fileno((uv_handle_t*)&ctx->client, &fd) == 0 ? (int)(intptr_t)fd : -1;
+        ctx->tls = catzilla_tls_session_create(srv->tls_context, sock, srv->http2_enabled);
+        if (!ctx->tls) {
+            catzilla_atomic_fetch_add(&stat_accept_errors, 1);
+            uv_close((uv_handle_t*)&ctx->client, on_close);
+            return;
+        }
+    }
+    uv_read_start((uv_stream_t*)&ctx->client, alloc_buffer, on_read);
+
+    catzilla_timer_entry_init(&ctx->timeout_entry, on_connection_timeout, ctx);
+    ctx->phase = CONN_PHASE_AWAITING;
+    update_connection_timer(ctx, false);
+}
+
+static void alloc_buffer(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf) {
+    (void)suggested_size;
+    client_context_t* ctx = handle->data;
+
+    if (ctx && ctx->prefer_sticky_buffer && !ctx->sticky_in_use) {
+        if (!ctx->sticky_buffer) {
+            ctx->sticky_buffer = catzilla_sticky_buffer_alloc();
+        }
+        if (ctx->sticky_buffer) {
+            ctx->sticky_in_use = true;
+            *buf = uv_buf_init(ctx->sticky_buffer, CATZILLA_STICKY_READ_BUFFER_SIZE);
+            return;
+        }
+    }
+
+    buf->base = catzilla_read_slab_acquire();
+    buf->len  = buf->base ? CATZILLA_READ_SLAB_SIZE : 0;
+}
+
+static void release_read_buffer(client_context_t* ctx, const uv_buf_t* buf, ssize_t nread) {
+    if (!buf->base) return;
+
+    if (ctx && buf->base == ctx->sticky_buffer) {
+        ctx->sticky_in_use = false;
+        if (nread > 0) {
+            catzilla_sticky_buffer_note_read();
+        }
+        // A full sticky buffer means a burst; go back to slabs
+        if (nread >= (ssize_t)CATZILLA_STICKY_READ_BUFFER_SIZE) {
+            ctx->prefer_sticky_buffer = false;
+        }
+        return;
+    }
+
+    catzilla_read_slab_release(buf->base);
+    if (ctx && nread > 0 && nread < (ssize_t)CATZILLA_STICKY_READ_BUFFER_SIZE) {
+        ctx->prefer_sticky_buffer = true;
+    }
+}
+
+// Keep the unparsed tail of a read while a deferred response pauses the parser
+static void save_pending_input(client_context_t* ctx, const char* data, size_t len) {
+    char* saved = NULL;
+    if (len > 0) {
+        saved = catzilla_request_alloc(len);
+        if (saved) {
+            memcpy(saved, data, len);
+        } else {
+            LOG_SERVER_ERROR("Dropping %zu pipelined bytes: out of memory", len);
+            len = 0;
+        }
+    }
+    ctx->pending_input = saved;
+    ctx->pending_input_len = len;
+}
+
+// Add input that arrived while the parser waits to the kept tail
+static void append_pending_input(client_context_t* ctx, const char* data, size_t len) {
+    if (!ctx->pending_input) {
+        save_pending_input(ctx, data, len);
+        return;
+    }
+    char* joined = catzilla_request_alloc(ctx->pending_input_len + len);
+    if (!joined) {
+        LOG_SERVER_ERROR("Dropping %zu pipelined bytes: out of memory", len);
+        return;
+    }
+    memcpy(joined, ctx->pending_input, ctx->pending_input_len);
+    memcpy(joined + ctx->pending_input_len, data, len);
+    catzilla_request_free(ctx->pending_input);
+    ctx->pending_input = joined;
+    ctx->pending_input_len += len;
+}
+
+static bool is_http2_connection_header(const char* name, size_t length) {
+    // Connection-specific fields are not allowed in HTTP/2 (RFC 9113 8.2.2)
+    return (length == 10 && strncasecmp(name, "connection", 10) == 0) ||
+           (length == 10 && strncasecmp(name, "keep-alive", 10) == 0) ||
+           (length == 16 && strncasecmp(name, "proxy-connection", 16) == 0) ||
+           (length == 17 && strncasecmp(name, "transfer-encoding", 17) == 0) ||
+           (length == 7 && strncasecmp(name, "upgrade", 7) == 0);
+}
+
+// Translate an HTTP/1.1 style header block into HEADERS for the current stream
+static void send_http2_response(client_context_t* context,
+                                int status_code,
+                                const char* headers,
+                                const char* body,
+                                size_t body_len) {
+    catzilla_h2_header_t fields[CATZILLA_H2_MAX_RESPONSE_HEADERS];
+    int count = 0;
+    bool has_content_length = false;
+    bool has_date = false;
+
+    if (headers && strchr(headers, ':') != NULL) {
+        const char* cursor = headers;
+        while (*cursor && count < CATZILLA_H2_MAX_RESPONSE_HEADERS - 2) {
+            const char* line_end = strstr(cursor, "\r\n");
+            size_t line_len = line_end ? (size_t)(line_end - cursor) : strlen(cursor);
+            const char* colon = memchr(cursor, ':', line_len);
+
+            if (colon && colon > cursor) {
+                size_t name_len = (size_t)(colon - cursor);
+                const char* value = colon + 1;
+                while (value < cursor + line_len && (*value == ' ' || *value == '\t')) value++;
+
+                if (!is_http2_connection_header(cursor, name_len)) {
+                    has_content_length |= name_len == 14 && strncasecmp(cursor, "content-length", 14) == 0;
+                    has_date |= name_len == 4 && strncasecmp(cursor, "date", 4) == 0;
+                    fields[count].name = cursor;
+                    fields[count].name_length = name_len;
+                    fields[count].value = value;
+                    fields[count].value_length = (size_t)(cursor + line_len - value);
+                    count++;
+                }
+            }
+
+            if (!line_end) break;
+            cursor = line_end + 2;
+        }
+    } else if (headers && headers[0]) {
+        fields[count++] = (catzilla_h2_header_t){ "content-type", 12, headers, strlen(headers) };
+    }
+
+    char content_length_digits[CATZILLA_U64_DIGITS_MAX];
+    if (!has_content_length) {
+        size_t digits = catzilla_u64toa((uint64_t)body_len, content_length_digits);
+        fields[count++] = (catzilla_h2_header_t){ "content-length", 14, content_length_digits, digits };
+    }
+    if (!has_date) {
+        // "Date: " + value + "\r\n" from the per-thread cache
+        const char* date = catzilla_date_header();
+        fields[count++] = (catzilla_h2_header_t){ "date", 4, date + 6, CATZILLA_DATE_HEADER_LEN - 8 };
+    }
+
+    bool completes_deferred = context->deferred_response_pending;
+    if (catzilla_h2_submit_response(context->h2, context->h2_stream_id, status_code,
+                                    fields, count, body, body_len) != 0) {
+        LOG_SERVER_DEBUG("HTTP/2 stream %u is gone; dropping response", context->h2_stream_id);
+    }
+
+    // The session keeps stream order itself, so the next stream can be
+    // dispatched as soon as the response is queued
+    if (completes_deferred) {
+        resume_deferred_client(context);
+    }
+}
+
+static int send_http2_output(void* user_data, const char* data, size_t length, bool close_after) {
+    client_context_t* ctx = (client_context_t*)user_data;
+    uv_stream_t* client = (uv_stream_t*)&ctx->client;
+    if (uv_is_closing((uv_handle_t*)client)) return -1;
+
+    write_req_t* req = catzilla_response_alloc(sizeof(*req));
+    char* copy = catzilla_response_alloc(length);
+    if (!req || !copy) {
+        catzilla_response_free(req);
+        catzilla_response_free(copy);
+        return -1;
+    }
+    memcpy(copy, data, length);
+
+    memset(req, 0, sizeof(*req));
+    req->keep_alive = !close_after;  // GOAWAY closes the connection once written
+    req->nbufs = 1;
+    req->bufs[0] = uv_buf_init(copy, length);
+    if (close_after) {
+        ctx->h2_goaway_queued = true;
+    }
+
+    submit_write_req(ctx, client, req);
+    return 0;
+}
+
+// Run one complete HTTP/2 request through the HTTP/1.1 dispatch path
+static int dispatch_http2_request(void* user_data, catzilla_h2_request_t* request) {
+    client_context_t* ctx = (client_context_t*)user_data;
+
+    discard_request_body(ctx);
+    ctx->body_rejected = false;
+    if (catzilla_header_set_copy(&ctx->headers, request->headers) != 0) {
+        catzilla_header_set_reset(&ctx->headers);
+    }
+
+    size_t method_len = strlen(request->method);
+    if (method_len >= CATZILLA_METHOD_MAX) method_len = CATZILLA_METHOD_MAX - 1;
+    memcpy(ctx->method, request->method, method_len);
+    ctx->method[method_len] = '\0';
+
+    size_t url_len = strlen(request->path);
+    if (url_len >= CATZILLA_PATH_MAX) url_len = CATZILLA_PATH_MAX - 1;
+    memcpy(ctx->url, request->path, url_len);
+    ctx->url[url_len] = '\0';
+
+    size_t content_type_len = 0;
+    const char* content_type = catzilla_header_set_get_known(&ctx->headers, CATZILLA_HDR_CONTENT_TYPE,
+                                                             &content_type_len);
+    ctx->content_type = content_type ? classify_content_type(content_type, content_type_len) : CONTENT_TYPE_NONE;
+    ctx->has_connection_header = false;
+    ctx->keep_alive = true;
+
+    // The session buffered the whole body; take it over
+    ctx->body = request->body;
+    ctx->body_length = request->body_length;
+    ctx->body_size = request->body_length;
+    ctx->body_received = request->body_length;
+    request->body = NULL;
+
+    // Spooled and streamed routes receive the buffered body over HTTP/2
+    resolve_body_policy(ctx);
+    ctx->body_mode = CATZILLA_BODY_BUFFERED;
+    ctx->body_chunk_handler = NULL;
+    ctx->body_chunk_user_data = NULL;
+
+    ctx->h2_stream_id = request->stream_id;
+    if (ctx->body_limit > 0 && ctx->body_length > ctx->body_limit) {
+        const char* body = "413 Payload Too Large";
+        send_response_with_connection((uv_stream_t*)&ctx->client, 413, "text/plain", body, strlen(body), true);
+        reset_client_request_state(ctx);
+        return CATZILLA_H2_DISPATCH_DONE;
+    }
+
+    return on_message_complete(&ctx->parser) == HPE_PAUSED ?
+        CATZILLA_H2_DISPATCH_DEFERRED : CATZILLA_H2_DISPATCH_DONE;
+}
+
+static void process_http2_input(client_context_t* ctx, const char* data, size_t len) {
+    // Streams carry their own requests; between them the connection is idle
+    if (ctx->phase == CONN_PHASE_AWAITING) {
+        ctx->phase = CONN_PHASE_IDLE;
+    }
+
+    // Inside a Python batch the batch flushes
+    bool outer_cork = ctx->corked;
+    ctx->corked = true;
+    int rc = catzilla_h2_session_receive(ctx->h2, data, len);
+    ctx->corked = outer_cork;
+    if (!outer_cork) flush_corked_writes(ctx);
+
+    // A queued GOAWAY closes the connection after it is written
+    if (rc != 0 && !ctx->h2_goaway_queued && !uv_is_closing((uv_handle_t*)&ctx->client)) {
+        uv_close((uv_handle_t*)&ctx->client, on_close);
+    }
+}
+
+static void start_http2_session(client_context_t* ctx) {
+    ctx->h2 = catzilla_h2_session_create(dispatch_http2_request, send_http2_output, ctx,
+                                         ctx->server->max_body_size);
+    if (!ctx->h2) {
+        LOG_SERVER_ERROR("Failed to create HTTP/2 session");
+    } else {
+        LOG_SERVER_DEBUG("Connection speaks HTTP/2");
+    }
+}
+
+// Prior-knowledge h2c: the connection's first bytes decide the protocol. The
+// preface is recognized once its first four bytes have arrived.
+static void detect_client_protocol(client_context_t* ctx, const char* data, size_t len) {
+    ctx->protocol_detected = true;
+    if (!ctx->server->http2_enabled || !catzilla_h2_is_preface(data, len)) return;
+    start_http2_session(ctx);
+}
+
+// Whether a comma-separated header value lists token, ignoring case
+static bool header_has_token(const char* value, size_t length, const char* token) {
+    size_t token_length = strlen(token);
+    size_t i = 0;
+    while (i < length) {
+        while (i < length && (value[i] == ' ' || value[i] == '\t' || value[i] == ',')) i++;
+        size_t start = i;
+        while (i < length && value[i] != ',') i++;
+        size_t end = i;
+        while (end > start && (value[end - 1] == ' ' || value[end - 1] == '\t')) end--;
+        if (end - start == token_length && strncasecmp(value + start, token, token_length) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void on_websocket_message(void* user_data, int opcode, char* data, size_t length) {
+    client_context_t* ctx = (client_context_t*)user_data;
+    if (ctx->websocket_handle && websocket_hooks.message) {
+        websocket_hooks.message(ctx->websocket_handle, opcode == CATZILLA_WS_OP_TEXT, data, length);
+    }
+}
+
+// Frames skip the cork queue: what the socket takes is written from the
+// caller's buffers, the rest is copied. The final close frame goes through
+// the response path, which closes the connection once it is written.
+static int send_websocket_output(void* user_data, const char* header, size_t header_length,
+                                 const char* payload, size_t payload_length, bool close_after) {
+    client_context_t* ctx = (client_context_t*)user_data;
+    uv_stream_t* client = (uv_stream_t*)&ctx->client;
+    if (uv_is_closing((uv_handle_t*)client)) return -1;
+
+    if (close_after) {
+        write_req_t* req = catzilla_response_alloc(sizeof(*req));
+        char* copy = catzilla_response_alloc(header_length + payload_length);
+        if (!req || !copy) {
+            catzilla_response_free(req);
+            catzilla_response_free(copy);
+            return -1;
+        }
+        memcpy(copy, header, header_length);
+        if (payload_length > 0) memcpy(copy + header_length, payload, payload_length);
+
+        memset(req, 0, sizeof(*req));
+        req->keep_alive = false;
+        req->nbufs = 1;
+        req->bufs[0] = uv_buf_init(copy, header_length + payload_length);
+        ctx->websocket_close_queued = true;
+        submit_write_req(ctx, client, req);
+        return 0;
+    }
+
+    uv_buf_t bufs[2];
+    bufs[0] = uv_buf_init((char*)header, header_length);
+    bufs[1] = uv_buf_init((char*)payload, payload_length);
+    if (catzilla_stream_send(client, bufs, 2) != CATZILLA_STREAM_OK) {
+        uv_close((uv_handle_t*)client, on_close);
+        return -1;
+    }
+
+    // A client that stops reading is dropped instead of buffering without bound
+    size_t max_queue = ctx->server->websocket.max_queue;
+    size_t queued = uv_stream_get_write_queue_size(client);
+    if (max_queue > 0 && queued > max_queue) {
+        LOG_SERVER_WARN("Dropping WebSocket client with %zu bytes unsent", queued);
+        uv_close((uv_handle_t*)client, on_close);
+        return -1;
     }
+    return 0;
 }
 
-// Helper function for URL decoding
-void url_decode(const char* src, char* dst) {
-    char a, b;
-    while (*src) {
-        if (*src == '%' && (a = src[1]) && (b = src[2]) && isxdigit(a) && isxdigit(b)) {
-            if (a >= 'a') a -= 'a'-'A';
-            if (a >= 'A') a -= ('A' - 10);
-            else a -= '0';
-            if (b >= 'a') b -= 'a'-'A';
-            if (b >= 'A') b -= ('A' - 10);
-            else b -= '0';
-            *dst++ = 16 * a + b;
-            src += 3;
-        } else if (*src == '+') {
-            *dst++ = ' ';
-            src++;
-        } else {
-            *dst++ = *src++;
+// Frames are unmasked in place; every input buffer belongs to the connection
+static void process_websocket_input(client_context_t* ctx, char* data, size_t len) {
+    if (catzilla_ws_session_receive(ctx->websocket, data, len) == 0) return;
+
+    uv_stream_t* client = (uv_stream_t*)&ctx->client;
+    if (ctx->websocket_close_queued) {
+        // Our last close frame closes the socket once it is written
+        if (!ctx->read_paused) {
+            uv_read_stop(client);
+            ctx->read_paused = true;
         }
+    } else if (!uv_is_closing((uv_handle_t*)client)) {
+        uv_close((uv_handle_t*)client, on_close);
     }
-    *dst = '\0';
 }
 
-static void url_decode_segment(const char* src, size_t length, char* dst) {
-    const char* end = src + length;
+static void refuse_websocket(client_context_t* ctx, int status_code, const char* headers, const char* body) {
+    ctx->keep_alive = false;
+    send_response_with_connection((uv_stream_t*)&ctx->client, status_code, headers, body, strlen(body), false);
+    reset_client_request_state(ctx);
+}
 
-    while (src < end) {
-        char a, b;
+// Answer a GET that asks to upgrade. Returns -1 when no WebSocket route
+// matches or the upgrade is to another protocol, so HTTP routing goes on.
+static int upgrade_websocket(client_context_t* ctx, const char* path, const char* query_string) {
+    catzilla_server_t* server = ctx->server;
+    uv_stream_t* client = (uv_stream_t*)&ctx->client;
 
-        if (
-            *src == '%' && (src + 2) < end &&
-            isxdigit((unsigned char)src[1]) &&
-            isxdigit((unsigned char)src[2])
-        ) {
-            a = src[1];
-            b = src[2];
+    size_t upgrade_length = 0;
+    const char* upgrade = catzilla_header_set_get_known(&ctx->headers, CATZILLA_HDR_UPGRADE, &upgrade_length);
+    if (!upgrade || !header_has_token(upgrade, upgrade_length, "websocket")) return -1;
 
-            if (a >= 'a') a -= 'a' - 'A';
-            if (a >= 'A') a -= ('A' - 10);
-            else a -= '0';
-            if (b >= 'a') b -= 'a' - 'A';
-            if (b >= 'A') b -= ('A' - 10);
-            else b -= '0';
+    catzilla_route_match_t match;
+    memset(&match, 0, sizeof(match));
+    if (catzilla_router_match(&server->websocket_router, "GET", path, &match) != 0 || !match.route) {
+        return -1;
+    }
 
-            *dst++ = (char)(16 * a + b);
-            src += 3;
-            continue;
-        }
+    size_t version_length = 0;
+    const char* version = catzilla_header_set_get(&ctx->headers, "sec-websocket-version", &version_length);
+    if (!version || version_length != 2 || memcmp(version, "13", 2) != 0) {
+        refuse_websocket(ctx, 426, "Content-Type: text/plain\r\nSec-WebSocket-Version: 13\r\n",
+                         "426 Upgrade Required");
+        return 0;
+    }
 
-        if (*src == '+') {
-            *dst++ = ' ';
-        } else {
-            *dst++ = *src;
+    size_t key_length = 0;
+    const char* key = catzilla_header_set_get_known(&ctx->headers, CATZILLA_HDR_SEC_WEBSOCKET_KEY, &key_length);
+    if (!key || !catzilla_ws_key_valid(key, key_length)) {
+        refuse_websocket(ctx, 400, "text/plain", "400 Bad Request");
+        return 0;
+    }
+    if (!websocket_hooks.open) {
+        LOG_SERVER_ERROR("WebSocket route %s matched, but no WebSocket hooks are installed", path);
+        refuse_websocket(ctx, 500, "text/plain", "500 Internal Server Error");
+        return 0;
+    }
+
+    catzilla_ws_deflate_params_t deflate;
+    memset(&deflate, 0, sizeof(deflate));
+    char extension[128];
+    extension[0] = '\0';
+    if (server->websocket.deflate) {
+        size_t offers_length = 0;
+        const char* offers = catzilla_header_set_get(&ctx->headers, "sec-websocket-extensions", &offers_length);
+        if (offers) {
+            catzilla_ws_negotiate_deflate(offers, offers_length, &deflate, extension, sizeof(extension));
         }
+    }
+
+    ctx->websocket = catzilla_ws_session_create(on_websocket_message, send_websocket_output, ctx,
+                                                server->websocket.max_message_size,
+                                                deflate.enabled ? &deflate : NULL);
+    if (!ctx->websocket) {
+        LOG_SERVER_ERROR("Failed to create WebSocket session");
+        refuse_websocket(ctx, 500, "text/plain", "500 Internal Server Error");
+        return 0;
+    }
 
-        src++;
+    char accept[CATZILLA_WS_ACCEPT_LEN + 1];
+    catzilla_ws_accept_key(key, key_length, accept);
+    char head[320];
+    int head_length = snprintf(head, sizeof(head),
+                               "HTTP/1.1 101 Switching Protocols\r\n"
+                               "Upgrade: websocket\r\n"
+                               "Connection: Upgrade\r\n"
+                               "Sec-WebSocket-Accept: %s\r\n"
+                               "%s%s%s\r\n",
+                               accept,
+                               extension[0] ? "Sec-WebSocket-Extensions: " : "",
+                               extension,
+                               extension[0] ? "\r\n" : "");
+
+    // Frames bypass the cork queue, so earlier pipelined responses go first
+    flush_corked_writes(ctx);
+    uv_buf_t buf = uv_buf_init(head, (unsigned int)head_length);
+    ctx->phase = CONN_PHASE_WEBSOCKET;
+    if (catzilla_stream_send(client, &buf, 1) != CATZILLA_STREAM_OK) {
+        uv_close((uv_handle_t*)client, on_close);
+        return 0;
+    }
+    LOG_SERVER_DEBUG("Upgraded %s to WebSocket%s", path, deflate.enabled ? " with permessage-deflate" : "");
+
+    catzilla_websocket_request_t request;
+    request.path = path;
+    request.query_string = query_string;
+    request.match = &match;
+    request.headers = &ctx->headers;
+    request.remote_addr = ctx->remote_addr[0] ? ctx->remote_addr : NULL;
+    ctx->websocket_handle = websocket_hooks.open(client, match.route->handler, &request);
+    if (!ctx->websocket_handle && !uv_is_closing((uv_handle_t*)client)) {
+        catzilla_ws_session_close(ctx->websocket, CATZILLA_WS_CLOSE_INTERNAL_ERROR, NULL, 0);
     }
 
-    *dst = '\0';
+    reset_client_request_state(ctx);
+    update_connection_timer(ctx, false);
+    return 0;
 }
 
-int catzilla_server_init(catzilla_server_t* server) {
-    memset(server, 0, sizeof(*server));
-    server->loop = uv_default_loop();
-    if (!server->loop) return -1;
+// Parse as many pipelined requests as the data holds, corking their responses
+// into one vectored write
+static void process_client_input(client_context_t* ctx, const char* data, size_t len) {
+    uv_stream_t* client = (uv_stream_t*)&ctx->client;
 
-    int rc = uv_tcp_init(server->loop, &server->server);
-    if (rc) return rc;
-    server->server.data = server;
+    if (!ctx->protocol_detected) {
+        detect_client_protocol(ctx, data, len);
+    }
+    if (ctx->h2) {
+        process_http2_input(ctx, data, len);
+        return;
+    }
+    if (ctx->websocket) {
+        process_websocket_input(ctx, (char*)data, len);
+        return;
+    }
+    if (ctx->dispatch_queued || ctx->cache_lookup || ctx->upload_scan_wait) {
+        // The parser waits for the queued request's response
+        append_pending_input(ctx, data, len);
+        return;
+    }
 
-    // Initialize signal handler
-    rc = uv_signal_init(server->loop, &server->sig_handle);
-    if (rc) return rc;
-    server->sig_handle.data = server;
+    // Inside a Python batch the batch flushes
+    bool outer_cork = ctx->corked;
+    ctx->corked = true;
+    llhttp_errno_t err = llhttp_execute(&ctx->parser, data, len);
+    while (err == HPE_PAUSED_UPGRADE) {
+        const char* stop = llhttp_get_error_pos(&ctx->parser);
+        size_t consumed = (stop && stop >= data && stop <= data + len) ? (size_t)(stop - data) : len;
+        data += consumed;
+        len -= consumed;
+        if (ctx->websocket) break;
+        // The upgrade was not taken; what follows is the next request
+        llhttp_resume_after_upgrade(&ctx->parser);
+        err = len > 0 ? llhttp_execute(&ctx->parser, data, len) : HPE_OK;
+    }
+    ctx->corked = outer_cork;
 
-    // Initialize SIGTERM handler
-    rc = uv_signal_init(server->loop, &server->sigterm_handle);
-    if (rc) return rc;
-    server->sigterm_handle.data = server;
+    if (ctx->websocket) {
+        // Frames sent right behind the handshake are already the session's
+        flush_corked_writes(ctx);
+        if (len > 0 && !uv_is_closing((uv_handle_t*)client)) {
+            process_websocket_input(ctx, (char*)data, len);
+        }
+        return;
+    }
 
-    // Initialize advanced router
-    rc = catzilla_router_init(&server->router);
-    if (rc) {
-        LOG_SERVER_ERROR("Failed to initialize advanced router");
-        return rc;
+    if (err == HPE_PAUSED) {
+        // A deferred response must be written before the next request is parsed;
+        // a rejected body is never parsed again
+        if (!ctx->body_rejected) {
+            const char* stop = llhttp_get_error_pos(&ctx->parser);
+            size_t consumed = (stop && stop >= data && stop <= data + len) ? (size_t)(stop - data) : len;
+            save_pending_input(ctx, data + consumed, len - consumed);
+        }
+        if (!outer_cork) flush_corked_writes(ctx);
+        return;
     }
 
-    llhttp_settings_init(&server->parser_settings);
-    server->parser_settings.on_message_begin  = on_message_begin;
-    server->parser_settings.on_url            = on_url;
-    server->parser_settings.on_header_field   = on_header_field;
-    server->parser_settings.on_header_value   = on_header_value;
-    server->parser_settings.on_headers_complete = on_headers_complete;
-    server->parser_settings.on_body           = on_body;
-    server->parser_settings.on_message_complete = on_message_complete;
+    if (!outer_cork || err != HPE_OK) {
+        // The 400 below is written before the close
+        ctx->corked = false;
+        flush_corked_writes(ctx);
+    }
 
-    server->route_count = 0;
-    server->is_running = false;
-    server->py_request_callback = NULL;
+    if (err != HPE_OK) {
+        LOG_SERVER_ERROR("HTTP parsing error: %s", llhttp_errno_name(err));
+        catzilla_send_response(client, 400, "text/plain", "400 Bad Request", strlen("400 Bad Request"));
+        uv_close((uv_handle_t*)client, on_close);
+    }
+}
 
-    // Initialize static file mounts
-    server->static_mounts = NULL;
-    server->static_mount_count = 0;
+static void after_tls_write(uv_write_t* req, int status) {
+    tls_write_t* tw = (tls_write_t*)req;
+    uv_write_t* user_req = tw->user_req;
+    uv_write_cb user_cb = tw->user_cb;
 
-    // Set global reference for signal handling
-    active_server = server;
+    catzilla_response_free(tw->buf.base);
+    if (user_req) {
+        user_req->handle = req->handle;
+    }
+    catzilla_response_free(tw);
+    if (user_req && user_cb) {
+        user_cb(user_req, status);
+    }
+}
 
-    LOG_SERVER_INFO("Server initialized with advanced routing system");
-    return 0;
+// Queue ciphertext taken from the session; owns data from here on
+static int write_tls_output(uv_stream_t* stream, char* data, size_t length,
+                            uv_write_t* user_req, uv_write_cb user_cb) {
+    tls_write_t* tw = catzilla_response_alloc(sizeof(*tw));
+    if (!tw) {
+        catzilla_response_free(data);
+        return UV_ENOMEM;
+    }
+    tw->user_req = user_req;
+    tw->user_cb = user_cb;
+    tw->buf = uv_buf_init(data, (unsigned int)length);
+
+    int rc = uv_write(&tw->req, stream, &tw->buf, 1, after_tls_write);
+    if (rc) {
+        catzilla_response_free(data);
+        catzilla_response_free(tw);
+    }
+    return rc;
 }
 
-void signal_handler(uv_signal_t* handle, int signum) {
-    catzilla_server_t* server = (catzilla_server_t*)handle->data;
+// Send handshake records and alerts the session produced
+static void flush_tls_output(client_context_t* ctx) {
+    size_t length;
+    char* data;
+    while ((data = catzilla_tls_session_take_output(ctx->tls, &length)) != NULL) {
+        write_tls_output((uv_stream_t*)&ctx->client, data, length, NULL, NULL);
+    }
+}
 
-    LOG_SERVER_INFO("Signal %d received, initiating graceful shutdown...", signum);
+int catzilla_server_write(uv_write_t* req, uv_stream_t* stream, const uv_buf_t bufs[],
+                          unsigned int nbufs, uv_write_cb cb) {
+    // Only a connection's own handle points back at its context
+    client_context_t* ctx = stream ? (client_context_t*)stream->data : NULL;
+    if (!ctx || (uv_stream_t*)&ctx->client != stream || !ctx->tls ||
+        catzilla_tls_session_ktls_active(ctx->tls)) {
+        return uv_write(req, stream, bufs, nbufs, cb);
+    }
+    if (!ctx->tls_established) return UV_ENOTCONN;
 
-    if (server && server->is_running) {
-        catzilla_server_stop(server);
+    size_t total = 0;
+    for (unsigned int i = 0; i < nbufs; i++) {
+        if (catzilla_tls_session_write(ctx->tls, bufs[i].base, bufs[i].len) != 0) return UV_EPROTO;
+        total += bufs[i].len;
     }
+
+    size_t length;
+    char* data = catzilla_tls_session_take_output(ctx->tls, &length);
+    if (!data) {
+        return total == 0 ? uv_write(req, stream, bufs, nbufs, cb) : UV_ENOMEM;
+    }
+    return write_tls_output(stream, data, length, req, cb);
 }
 
-void catzilla_server_cleanup(catzilla_server_t* server) {
-    server->is_running = false;
+// The handshake finished: pick the protocol ALPN agreed on and, where the
+// kernel supports it, hand sending to kTLS
+static void establish_tls(client_context_t* ctx) {
+    uv_stream_t* client = (uv_stream_t*)&ctx->client;
+    ctx->tls_established = true;
+    catzilla_atomic_fetch_add(&stat_tls_handshakes, 1);
+    if (catzilla_tls_session_resumed(ctx->tls)) {
+        catzilla_atomic_fetch_add(&stat_tls_resumptions, 1);
+    }
 
-    // Clean up advanced router
-    catzilla_router_cleanup(&server->router);
+    switch (catzilla_tls_session_protocol(ctx->tls)) {
+        case CATZILLA_TLS_ALPN_H2:
+            ctx->protocol_detected = true;
+            start_http2_session(ctx);
+            break;
+        case CATZILLA_TLS_ALPN_HTTP1:
+            ctx->protocol_detected = true;
+            break;
+        default:
+            break;  // No ALPN: recognize the h2 preface as over cleartext
+    }
 
-    uv_close((uv_handle_t*)&server->server, NULL);
-    uv_close((uv_handle_t*)&server->sig_handle, NULL);
-    uv_close((uv_handle_t*)&server->sigterm_handle, NULL);
-    uv_run(server->loop, UV_RUN_DEFAULT);
-    active_server = NULL;
+    size_t length;
+    char* data = catzilla_tls_session_take_output(ctx->tls, &length);
+    if (catzilla_tls_session_can_offload(ctx->tls) && uv_stream_get_write_queue_size(client) == 0) {
+        // The kernel continues the record sequence, so the session tickets
+        // written just now must be in the socket before it takes over
+        size_t written = 0;
+        if (data) {
+            uv_buf_t buf = uv_buf_init(data, (unsigned int)length);
+            int n = uv_try_write(client, &buf, 1);
+            written = n > 0 ? (size_t)n : 0;
+        }
+        if (written == length) {
+            catzilla_response_free(data);
+            data = NULL;
+            if (catzilla_tls_session_enable_ktls(ctx->tls) == 0) {
+                catzilla_atomic_fetch_add(&stat_ktls_offloads, 1);
+                LOG_SERVER_DEBUG("kTLS offload active");
+            }
+        } else if (written > 0) {
+            char* rest = catzilla_response_alloc(length - written);
+            if (rest) {
+                memcpy(rest, data + written, length - written);
+            }
+            catzilla_response_free(data);
+            data = rest;
+            length -= written;
+            if (!rest) {
+                uv_close((uv_handle_t*)client, on_close);
+                return;
+            }
+        }
+    }
+    if (data) {
+        write_tls_output(client, data, length, NULL, NULL);
+    }
 }
 
-int catzilla_server_listen(catzilla_server_t* server, const char* host, int port) {
-    // Fallback to default host if NULL or empty
-    const char* bind_host = (host != NULL && strlen(host) > 0) ? host : "0.0.0.0";
+// Decrypt what the session holds and parse it; a paused parser leaves the
+// rest inside the session until reading resumes
+static void drain_tls_input(client_context_t* ctx) {
+    uv_handle_t* handle = (uv_handle_t*)&ctx->client;
+    char* plain = NULL;
 
-    int rc;
-#ifdef _WIN32
-    const char* effective_bind_host = (strcmp(bind_host, "0.0.0.0") == 0) ? "::" : bind_host;
-#else
-    const char* effective_bind_host = bind_host;
-#endif
+    while (!ctx->read_paused && !uv_is_closing(handle)) {
+        if (!plain && !(plain = catzilla_read_slab_acquire())) break;
 
-    if (strchr(effective_bind_host, ':') != NULL) {
-        struct sockaddr_in6 addr6;
-        rc = uv_ip6_addr(effective_bind_host, port, &addr6);
-        if (rc) {
-            LOG_SERVER_ERROR("Failed to resolve %s:%d: %s", effective_bind_host, port, uv_strerror(rc));
-            return rc;
+        ssize_t n = catzilla_tls_session_read(ctx->tls, plain, CATZILLA_READ_SLAB_SIZE);
+        if (n == 0) break;
+        if (n < 0) {
+            flush_tls_output(ctx);
+            uv_close(handle, on_close);
+            break;
         }
-        rc = uv_tcp_bind(&server->server, (const struct sockaddr*)&addr6, 0);
+        process_client_input(ctx, plain, (size_t)n);
+    }
+    if (plain) {
+        catzilla_read_slab_release(plain);
+    }
+}
+
+static void process_tls_input(client_context_t* ctx, const char* data, size_t len) {
+    int rc = catzilla_tls_session_feed(ctx->tls, data, len);
+    if (rc == 0 && !ctx->tls_established && catzilla_tls_session_handshake_done(ctx->tls)) {
+        establish_tls(ctx);
     } else {
-        struct sockaddr_in addr4;
-        rc = uv_ip4_addr(effective_bind_host, port, &addr4);
-        if (rc) {
-            LOG_SERVER_ERROR("Failed to resolve %s:%d: %s", effective_bind_host, port, uv_strerror(rc));
-            return rc;
+        flush_tls_output(ctx);
+    }
+
+    uv_handle_t* handle = (uv_handle_t*)&ctx->client;
+    if (rc != 0) {
+        if (!ctx->tls_established) {
+            catzilla_atomic_fetch_add(&stat_tls_handshake_failures, 1);
         }
-        rc = uv_tcp_bind(&server->server, (const struct sockaddr*)&addr4, 0);
+        if (!uv_is_closing(handle)) uv_close(handle, on_close);
+        return;
     }
-    if (rc) {
-        LOG_SERVER_ERROR("Bind %s:%d: %s", effective_bind_host, port, uv_strerror(rc));
-        return rc;
+    drain_tls_input(ctx);
+}
+
+static void on_read(uv_stream_t* client, ssize_t nread, const uv_buf_t* buf) {
+    client_context_t* ctx = client->data;
+    if (nread > 0) {
+        if (ctx->tls) {
+            process_tls_input(ctx, buf->base, (size_t)nread);
+        } else {
+            process_client_input(ctx, buf->base, (size_t)nread);
+        }
+        update_connection_timer(ctx, true);
+    } else if (nread < 0 && nread != UV_EOF) {
+        LOG_SERVER_ERROR("Read error: %s", uv_strerror(nread));
     }
-    rc = uv_listen((uv_stream_t*)&server->server, 4096, on_connection);
-    if (rc) {
-        LOG_SERVER_ERROR("Listen %s:%d: %s", effective_bind_host, port, uv_strerror(rc));
-        return rc;
+    release_read_buffer(ctx, buf, nread);
+    if (nread < 0 && !uv_is_closing((uv_handle_t*)client)) uv_close((uv_handle_t*)client, on_close);
+}
+
+static void resume_deferred_client(client_context_t* ctx) {
+    if (!ctx || !ctx->deferred_response_pending) return;
+
+    reset_client_request_state(ctx);
+    if (uv_is_closing((uv_handle_t*)&ctx->client)) return;
+
+    if (ctx->h2) {
+        // Streams that completed meanwhile were held back by the session
+        catzilla_h2_session_resume(ctx->h2);
+    } else {
+        // Parse pipelined requests that arrived behind the deferred one
+        llhttp_resume(&ctx->parser);
+    }
+    if (!ctx->h2 && ctx->pending_input) {
+        char* input = ctx->pending_input;
+        size_t input_len = ctx->pending_input_len;
+        ctx->pending_input = NULL;
+        ctx->pending_input_len = 0;
+        process_client_input(ctx, input, input_len);
+        catzilla_request_free(input);
     }
 
-    // Set up signal handler for graceful shutdown
-    rc = uv_signal_start(&server->sig_handle, signal_handler, SIGINT);
-    if (rc) {
-        LOG_SERVER_ERROR("Failed to set up SIGINT handler: %s", uv_strerror(rc));
-        return rc;
+    if (!ctx->deferred_response_pending && ctx->read_paused &&
+        !uv_is_closing((uv_handle_t*)&ctx->client)) {
+        ctx->read_paused = false;
+        uv_read_start((uv_stream_t*)&ctx->client, alloc_buffer, on_read);
+        if (ctx->tls) drain_tls_input(ctx);
     }
+    update_connection_timer(ctx, false);
+}
 
-    // Also handle SIGTERM for proper shutdown
-    uv_signal_t* sigterm_handle = &server->sigterm_handle;
-    rc = uv_signal_init(server->loop, sigterm_handle);
-    if (rc) {
-        LOG_SERVER_ERROR("Failed to initialize SIGTERM handler: %s", uv_strerror(rc));
-        return rc;
+void catzilla_server_resume_body(uv_stream_t* client) {
+    if (!client || uv_is_closing((uv_handle_t*)client)) return;
+    client_context_t* ctx = get_client_context(client);
+    if (!ctx || !ctx->body_paused) return;
+
+    ctx->body_paused = false;
+    llhttp_resume(&ctx->parser);
+    if (ctx->pending_input) {
+        char* input = ctx->pending_input;
+        size_t input_len = ctx->pending_input_len;
+        ctx->pending_input = NULL;
+        ctx->pending_input_len = 0;
+        process_client_input(ctx, input, input_len);
+        catzilla_request_free(input);
     }
-    sigterm_handle->data = server;
 
-    rc = uv_signal_start(sigterm_handle, signal_handler, SIGTERM);
-    if (rc) {
-        LOG_SERVER_ERROR("Failed to set up SIGTERM handler: %s", uv_strerror(rc));
-        return rc;
+    if (!ctx->body_paused && !ctx->deferred_response_pending && !ctx->body_rejected &&
+        ctx->read_paused && !uv_is_closing((uv_handle_t*)client)) {
+        ctx->read_paused = false;
+        uv_read_start(client, alloc_buffer, on_read);
+        if (ctx->tls) drain_tls_input(ctx);
     }
+    update_connection_timer(ctx, true);
+}
 
-    LOG_SERVER_INFO("Catzilla server listening on %s:%d", bind_host, port);
-    LOG_SERVER_INFO("Press Ctrl+C to stop the server");
+void catzilla_server_response_complete(uv_stream_t* client) {
+    if (!client || uv_is_closing((uv_handle_t*)client)) return;
+    resume_deferred_client(get_client_context(client));
+}
 
-    server->is_running = true;
-    return uv_run(server->loop, UV_RUN_DEFAULT);
+bool catzilla_server_can_write_raw(uv_stream_t* client) {
+    client_context_t* ctx = get_client_context(client);
+    if (!ctx || (uv_stream_t*)&ctx->client != client) return true;
+    if (ctx->h2) return false;
+    return !ctx->tls || catzilla_tls_session_ktls_active(ctx->tls);
 }
 
+void catzilla_server_abort_response(uv_stream_t* client) {
+    client_context_t* ctx = get_client_context(client);
+    if (!ctx || (uv_stream_t*)&ctx->client != client || uv_is_closing((uv_handle_t*)client)) return;
+    uv_close((uv_handle_t*)client, on_close);
+}
 
-void catzilla_server_stop(catzilla_server_t* server) {
-    if (!server->is_running) return;
+// The hub dropped a subscriber that fell behind; its stream cannot continue
+static void on_sse_subscriber_dropped(uv_stream_t* client, void* data) {
+    client_context_t* ctx = data;
+    ctx->sse_subscriber = NULL;
+    if (!uv_is_closing((uv_handle_t*)client)) {
+        uv_close((uv_handle_t*)client, on_close);
+    }
+}
 
-    LOG_SERVER_INFO("Stopping Catzilla server...");
-    server->is_running = false;
+int catzilla_server_subscribe_events(uv_stream_t* client, catzilla_sse_hub_t* hub) {
+    client_context_t* ctx = get_client_context(client);
+    if (!ctx || (uv_stream_t*)&ctx->client != client || ctx->h2 || ctx->sse_subscriber ||
+        uv_is_closing((uv_handle_t*)client)) {
+        return -1;
+    }
+    ctx->sse_subscriber = catzilla_sse_subscribe(hub, client, on_sse_subscriber_dropped, ctx);
+    return ctx->sse_subscriber ? 0 : -1;
+}
 
-    //  Stop the loop so the outer uv_run in listen() will exit
-    uv_stop(server->loop);
+void catzilla_server_set_websocket_hooks(const catzilla_websocket_hooks_t* hooks) {
+    if (hooks) {
+        websocket_hooks = *hooks;
+    } else {
+        memset(&websocket_hooks, 0, sizeof(websocket_hooks));
+    }
+}
 
-    // Stop both signal handlers but don't close them yet
-    uv_signal_stop(&server->sig_handle);
-    uv_signal_stop(&server->sigterm_handle);
-    LOG_SERVER_INFO("Stopped signal handlers...");
+void catzilla_server_set_loop_exit_hook(catzilla_loop_exit_fn hook) {
+    loop_exit_hook = hook;
+}
 
-    // Walk and close all active handles
-    // This will include server->server and server->sig_handle
-    uv_walk(server->loop, (uv_walk_cb)uv_close, NULL);
-    LOG_SERVER_INFO("Closing all active handles...");
+void catzilla_websocket_options_init(catzilla_websocket_options_t* options) {
+    if (!options) return;
+    options->ping_interval_ms = CATZILLA_WS_DEFAULT_PING_INTERVAL_MS;
+    options->pong_timeout_ms = CATZILLA_WS_DEFAULT_PONG_TIMEOUT_MS;
+    options->max_message_size = CATZILLA_WS_DEFAULT_MAX_MESSAGE;
+    options->max_queue = CATZILLA_WS_DEFAULT_MAX_QUEUE;
+    options->deflate = true;
+}
 
-    // Run the loop so that each close callback fires
-    uv_run(server->loop, UV_RUN_DEFAULT);
+int catzilla_server_set_websocket_options(catzilla_server_t* server, const catzilla_websocket_options_t* options) {
+    if (!server || !options) return -1;
+    server->websocket = *options;
+    return 0;
+}
 
-    // 5) Finally, close the loop itself
-    if (uv_loop_close(server->loop) != 0) {
-        LOG_SERVER_WARN("uv_loop_close returned busy");
+int catzilla_server_add_websocket_route(catzilla_server_t* server, const char* path, void* handler) {
+    if (!server || !path) return -1;
+
+    uint32_t route_id = catzilla_router_add_route(&server->websocket_router, "GET", path, handler, NULL, false);
+    if (route_id == 0) {
+        LOG_ROUTER_ERROR("Failed to add WebSocket route %s", path);
+        return -1;
     }
+    server->websocket_route_count++;
+    LOG_ROUTER_DEBUG("Added WebSocket route %s (ID: %u)", path, route_id);
+    return 0;
+}
 
-    LOG_SERVER_INFO("Server stopped");
+// Context of an upgraded connection that can still send
+static client_context_t* get_websocket_context(uv_stream_t* client) {
+    client_context_t* ctx = get_client_context(client);
+    if (!ctx || (uv_stream_t*)&ctx->client != client || !ctx->websocket ||
+        uv_is_closing((uv_handle_t*)client)) {
+        return NULL;
+    }
+    return ctx;
 }
 
-int catzilla_server_add_route(catzilla_server_t* server,
-                             const char* method,
-                             const char* path,
-                             void* handler,
-                             void* user_data) {
-    if (!server || !method || !path) return -1;
+int catzilla_server_websocket_send(uv_stream_t* client, bool text, const char* data, size_t length) {
+    client_context_t* ctx = get_websocket_context(client);
+    if (!ctx) return -1;
+    return catzilla_ws_session_send(ctx->websocket, text ? CATZILLA_WS_OP_TEXT : CATZILLA_WS_OP_BINARY,
+                                    data, length);
+}
 
-    // Check for route conflicts and warn
-    catzilla_server_check_route_conflicts(server, method, path);
+int catzilla_server_websocket_close(uv_stream_t* client, int code, const char* reason, size_t length) {
+    client_context_t* ctx = get_websocket_context(client);
+    if (!ctx || catzilla_ws_session_close(ctx->websocket, code, reason, length) != 0) return -1;
+    update_connection_timer(ctx, false);
+    return 0;
+}
 
-    // Add to advanced router first
-    uint32_t route_id = catzilla_router_add_route(&server->router, method, path, handler, user_data, false);
-    if (route_id > 0) {
-        LOG_ROUTER_DEBUG("Added route to advanced router: %s %s (ID: %u)", method, path, route_id);
-        return 0;  // Success
+size_t catzilla_server_websocket_buffered(uv_stream_t* client) {
+    return client ? uv_stream_get_write_queue_size(client) : 0;
+}
+
+static void on_close(uv_handle_t* handle) {
+    client_context_t* ctx = handle->data;
+    if (ctx) {
+        catzilla_atomic_fetch_sub(&stat_active_connections, 1);
+        if (ctx->loop_pprev) {
+            *ctx->loop_pprev = ctx->loop_next;
+            if (ctx->loop_next) ctx->loop_next->loop_pprev = ctx->loop_pprev;
+            ctx->loop_pprev = NULL;
+            ctx->loop_next = NULL;
+        }
+        release_client_context(ctx);
+        resume_accepting();
     }
+}
 
-    // Fallback to legacy route table if advanced router fails
-    if (server->route_count >= CATZILLA_MAX_ROUTES) {
-        LOG_SERVER_ERROR("Maximum legacy routes reached (%d)", CATZILLA_MAX_ROUTES);
-        return -1;
+static void release_write_req(write_req_t* wr) {
+    if (wr->nbufs > 1) {
+        release_body(wr->body_release, wr->body_owner, wr->bufs[1].base, wr->bufs[1].len);
+    }
+    catzilla_response_free(wr->bufs[0].base);
+    catzilla_response_free(wr);
+}
+
+static void finish_response_writes(uv_stream_t* handle, bool close_connection, bool resume_deferred) {
+    if (!handle || uv_is_closing((uv_handle_t*)handle)) return;
+
+    client_context_t* ctx = (client_context_t*)handle->data;
+    if (ctx && ctx->writes_in_flight > 0) {
+        ctx->writes_in_flight--;
+    }
+
+    // Only close connection if keep_alive is false
+    if (close_connection) {
+        LOG_SERVER_DEBUG("Closing connection (keep_alive=false)");
+        uv_close((uv_handle_t*)handle, on_close);
+    } else if (resume_deferred) {
+        // Request state of a deferred response is released only now
+        resume_deferred_client(ctx);
+    } else if (ctx) {
+        update_connection_timer(ctx, true);
     }
+}
 
-    catzilla_route_t* route = &server->routes[server->route_count++];
-    strncpy(route->method, method, CATZILLA_METHOD_MAX-1);
-    route->method[CATZILLA_METHOD_MAX-1] = '\0';
-    strncpy(route->path, path, CATZILLA_PATH_MAX-1);
-    route->path[CATZILLA_PATH_MAX-1] = '\0';
-    route->handler = handler;
-    route->user_data = user_data;
+// Record a timed request once its response is written
+static void record_write_latency(write_req_t* wr, uint64_t now) {
+    if (!wr->latency.route) return;
+    wr->latency.durations_ns[CATZILLA_LATENCY_WRITE] = now - wr->latency.mark_ns;
+    catzilla_metrics_record(&wr->latency);
+}
 
-    LOG_ROUTER_DEBUG("Added route to legacy table: %s %s", method, path);
-    return 0;
+static void after_write(uv_write_t* req, int status) {
+    if (status < 0) LOG_SERVER_DEBUG("Write error: %s", uv_strerror(status));
+
+    write_req_t* wr = (write_req_t*)req;
+    bool close_connection = !wr->keep_alive;
+    bool resume_deferred = wr->completes_deferred;
+
+    if (status == 0) record_write_latency(wr, uv_hrtime());
+    CATZILLA_PROBE3(write_done, req->handle->data, status, 1);
+    release_write_req(wr);
+    finish_response_writes(req->handle, close_connection, resume_deferred);
 }
 
-void catzilla_server_set_request_callback(catzilla_server_t* server, void* callback) {
-    server->py_request_callback = callback;
+static void after_batch_write(uv_write_t* req, int status) {
+    if (status < 0) LOG_SERVER_DEBUG("Batched write error: %s", uv_strerror(status));
+
+    write_batch_t* batch = (write_batch_t*)req;
+    bool close_connection = false;
+    bool resume_deferred = false;
+
+    uint64_t written_at = status == 0 ? uv_hrtime() : 0;
+    write_req_t* wr = batch->head;
+    unsigned int responses = 0;
+    while (wr) {
+        write_req_t* next = wr->next;
+        close_connection |= !wr->keep_alive;
+        resume_deferred |= wr->completes_deferred;
+        if (status == 0) record_write_latency(wr, written_at);
+        release_write_req(wr);
+        responses++;
+        wr = next;
+    }
+    CATZILLA_PROBE3(write_done, req->handle->data, status, responses);
+
+    uv_stream_t* handle = req->handle;
+    catzilla_response_free(batch);
+    finish_response_writes(handle, close_connection, resume_deferred);
 }
 
-// Internal function that adds Connection headers based on client context
-static void send_response_with_connection(uv_stream_t* client,
-                                        int status_code,
-                                        const char* headers,
-                                        const char* body,
-                                        size_t body_len,
-                                        bool keep_alive) {
-    write_req_t* req = catzilla_response_alloc(sizeof(*req));
-    if (!req) return;
+// Write all responses corked during one read, in request order
+static void flush_corked_writes(client_context_t* ctx) {
+    write_req_t* head = ctx->cork_head;
+    if (!head) return;
 
-    // Store keep_alive info in the request for after_write callback
-    req->keep_alive = keep_alive;
+    unsigned int nbufs = ctx->cork_nbufs;
+    ctx->cork_head = NULL;
+    ctx->cork_tail = NULL;
+    ctx->cork_nbufs = 0;
 
-    const char* status_text;
-    switch (status_code) {
-        case 200: status_text="OK";break;
-        case 201: status_text="Created";break;
-        case 204: status_text="No Content";break;
-        case 400: status_text="Bad Request";break;
-        case 404: status_text="Not Found";break;
-        case 405: status_text="Method Not Allowed";break;
-        case 415: status_text="Unsupported Media Type";break;
-        case 500: status_text="Internal Server Error";break;
-        default:  status_text="Unknown";break;
+    uv_stream_t* client = (uv_stream_t*)&ctx->client;
+
+    write_batch_t* batch = NULL;
+    if (head->next) {
+        batch = catzilla_response_alloc(sizeof(write_batch_t) + sizeof(uv_buf_t) * nbufs);
     }
 
-    bool headers_are_formatted = headers && strchr(headers, ':') != NULL;
-    bool has_content_length = headers_are_formatted && headers_include_field(headers, "Content-Length");
+    if (!batch) {
+        // Single response, or no memory for a batch: write each one on its own
+        while (head) {
+            write_req_t* next = head->next;
+            int rc = catzilla_server_write(&head->req, client, head->bufs, head->nbufs, after_write);
+            if (rc) {
+                LOG_SERVER_DEBUG("uv_write failed: %s", uv_strerror(rc));
+                release_write_req(head);
+            } else {
+                ctx->writes_in_flight++;
+            }
+            head = next;
+        }
+        update_connection_timer(ctx, false);
+        return;
+    }
 
-    // Calculate required buffer size including Connection and Content-Length headers
-    size_t status_line_len = snprintf(NULL, 0, "HTTP/1.1 %d %s\r\n", status_code, status_text);
-    size_t headers_len = headers ? strlen(headers) : 0;
-    size_t connection_header_len = keep_alive ?
-        strlen("Connection: keep-alive\r\n") :
-        strlen("Connection: close\r\n");
-    size_t content_type_header_len = (!headers_are_formatted && headers_len > 0) ?
-        snprintf(NULL, 0, "Content-Type: %s\r\n", headers) : 0;
-    size_t content_length_header_len = has_content_length ? 0 :
-        snprintf(NULL, 0, "Content-Length: %zu\r\n", body_len);
-    size_t separator_len = 2; // "\r\n" to separate headers from body
-    size_t total_header_len = status_line_len + connection_header_len + separator_len + content_type_header_len + content_length_header_len;
-    if (headers_are_formatted) {
-        total_header_len += headers_len;
+    batch->head = head;
+    batch->nbufs = 0;
+    uint64_t responses = 0;
+    for (write_req_t* wr = head; wr; wr = wr->next) {
+        responses++;
+        for (unsigned int i = 0; i < wr->nbufs; i++) {
+            batch->bufs[batch->nbufs++] = wr->bufs[i];
+        }
     }
 
-    char* response = catzilla_response_alloc(total_header_len + body_len);
-    if (!response) { catzilla_response_free(req); return; }
+    LOG_SERVER_DEBUG("Flushing %u pipelined response buffers in one write", batch->nbufs);
+    int rc = catzilla_server_write(&batch->req, client, batch->bufs, batch->nbufs, after_batch_write);
+    if (rc) {
+        LOG_SERVER_DEBUG("Batched uv_write failed: %s", uv_strerror(rc));
+        write_req_t* wr = head;
+        while (wr) {
+            write_req_t* next = wr->next;
+            release_write_req(wr);
+            wr = next;
+        }
+        catzilla_response_free(batch);
+        return;
+    }
+    catzilla_atomic_fetch_add(&stat_corked_flushes, 1);
+    catzilla_atomic_fetch_add(&stat_corked_responses, responses);
+    ctx->writes_in_flight++;
+    update_connection_timer(ctx, false);
+}
 
-    // Build the response
-    int offset = 0;
-    offset += snprintf(response + offset, total_header_len + body_len - offset,
-                      "HTTP/1.1 %d %s\r\n", status_code, status_text);
+// Sampled requests read the loop's hardware counters here and again as the
+// handler starts; native routes start their handler right away
+static void begin_request_latency(client_context_t* context, const catzilla_route_t* route) {
+    context->latency.route = catzilla_metrics_route(route->id, route->method, route->path);
+    memset(context->latency.durations_ns, 0, sizeof(context->latency.durations_ns));
+    context->latency.counted = catzilla_perf_sample_due() && catzilla_perf_read(&context->latency.counters);
+    context->latency.mark_ns = uv_hrtime();
+}
 
-    if (headers_len > 0) {
-        if (headers_are_formatted) {
-            memcpy(response + offset, headers, headers_len);
-            offset += headers_len;
-        } else {
-            offset += snprintf(response + offset, total_header_len + body_len - offset,
-                              "Content-Type: %s\r\n", headers);
-        }
+// Take the GIL, measuring the wait when route latency is recorded
+static PyGILState_STATE acquire_gil_timed(catzilla_server_t* server, uint64_t* wait_ns) {
+    CATZILLA_PROBE(gil_wait);
+    if (!server->latency_metrics) {
+        *wait_ns = 0;
+        PyGILState_STATE gstate = PyGILState_Ensure();
+        CATZILLA_PROBE(gil_acquired);
+        return gstate;
     }
+    uint64_t requested = uv_hrtime();
+    PyGILState_STATE gstate = PyGILState_Ensure();
+    *wait_ns = uv_hrtime() - requested;
+    CATZILLA_PROBE(gil_acquired);
+    return gstate;
+}
 
-    // Add Connection header
-    const char* connection_header = keep_alive ? "Connection: keep-alive\r\n" : "Connection: close\r\n";
-    memcpy(response + offset, connection_header, connection_header_len);
-    offset += connection_header_len;
+static void release_gil(PyGILState_STATE gstate) {
+    CATZILLA_PROBE(gil_release);
+    PyGILState_Release(gstate);
+}
 
-    if (!has_content_length) {
-        // Add Content-Length header so keep-alive clients can detect response completion.
-        offset += snprintf(response + offset, total_header_len + body_len - offset,
-                          "Content-Length: %zu\r\n", body_len);
+// Run the Python callback for a completed request; needs the GIL.
+// Returns true when the handler writes its response later.
+static bool dispatch_python_request(client_context_t* context, const catzilla_route_match_t* match,
+                                    uint64_t gil_wait_ns) {
+    catzilla_server_t* server = context->server;
+
+    // Time since the route matched splits into the dispatch queue and the
+    // GIL wait; the handler phase starts now
+    if (context->latency.route) {
+        uint64_t now = uv_hrtime();
+        uint64_t waited = now - context->latency.mark_ns;
+        if (gil_wait_ns > waited) gil_wait_ns = waited;
+        context->latency.durations_ns[CATZILLA_LATENCY_QUEUE] = waited - gil_wait_ns;
+        context->latency.durations_ns[CATZILLA_LATENCY_GIL] = gil_wait_ns;
+        context->latency.mark_ns = now;
+        if (context->latency.counted) context->latency.counted = catzilla_perf_read(&context->latency.counters);
     }
+    PyObject* client_capsule = PyCapsule_New((void*)&context->client, "catzilla.client", NULL);
+    bool deferred_response = false;
 
-    // Add separator between headers and body
-    memcpy(response + offset, "\r\n", 2);
-    offset += 2;
+    if (!client_capsule) {
+        PyErr_Print();
+        send_response_with_connection((uv_stream_t*)&context->client, 500, "text/plain", "500 Internal Server Error", strlen("500 Internal Server Error"), context->keep_alive);
+    } else {
+        PyObject* result = handle_request_in_server(
+            server->py_request_callback,
+            client_capsule,
+            context->method,
+            context->url,
+            context->body ? context->body : "",  // Handle NULL body case
+            context->body_length,
+            context,
+            match
+        );
+        deferred_response = (result == Py_True);
+        Py_XDECREF(result);
+        Py_DECREF(client_capsule);
+    }
+    return deferred_response;
+}
 
-    // Add body
-    if (body_len > 0) {
-        memcpy(response + offset, body, body_len);
+static int complete_python_request(client_context_t* context, bool deferred_response) {
+    if (deferred_response) {
+        // Pause parsing so later pipelined responses cannot overtake this one
+        context->deferred_response_pending = true;
+        if (!context->read_paused) {
+            uv_read_stop((uv_stream_t*)&context->client);
+            context->read_paused = true;
+        }
+        return HPE_PAUSED;
     }
+    reset_client_request_state(context);
+    return 0;
+}
 
-    req->buf = uv_buf_init(response, total_header_len + body_len);
-    uv_write(&req->req, client, &req->buf, 1, after_write);
+static void on_python_dispatch_idle(uv_idle_t* handle) {
+    (void)handle;  // Only keeps the poll phase from blocking
 }
 
-void catzilla_send_response(uv_stream_t* client,
-                           int status_code,
-                           const char* headers,
-                           const char* body,
-                           size_t body_len) {
-    // Get client context to determine keep-alive setting
-    client_context_t* context = get_client_context(client);
-    bool keep_alive = context ? context->keep_alive : false;
+static int start_python_dispatch(uv_loop_t* loop) {
+    loop_dispatch.head = NULL;
+    loop_dispatch.tail = NULL;
 
-    // Check if this is a streaming response
-    if (body != NULL && body_len >= 24 && catzilla_is_streaming_response(body, body_len)) {
-        // Extract the streaming ID to connect to the Python StreamingResponse
-        const char* streaming_id = catzilla_extract_streaming_id(body, body_len);
+    int rc = uv_check_init(loop, &loop_dispatch.check);
+    if (rc) return rc;
+    rc = uv_idle_init(loop, &loop_dispatch.idle);
+    if (rc) return rc;
 
-        if (streaming_id) {
-            // Connect to the Python StreamingResponse via the C extension
-            // This will start the streaming process immediately
-            PyGILState_STATE gstate = PyGILState_Ensure();
+    // Neither handle may keep the loop running on its own
+    uv_unref((uv_handle_t*)&loop_dispatch.check);
+    uv_unref((uv_handle_t*)&loop_dispatch.idle);
+    loop_dispatch.running = true;
+    return 0;
+}
 
-            PyObject* streaming_module = PyImport_ImportModule("catzilla._catzilla._streaming");
-            if (streaming_module) {
-                PyObject* connect_func = PyObject_GetAttrString(streaming_module, "connect_streaming_response");
-                if (connect_func) {
-                    // Create a client capsule
-                    PyObject* client_capsule = PyCapsule_New(client, "catzilla.client", NULL);
-                    if (client_capsule) {
-                        // Call the connect function
-                        PyObject* args = Py_BuildValue("(Os)", client_capsule, streaming_id);
-                        if (args) {
-                            PyObject* result = PyObject_CallObject(connect_func, args);
-                            if (!result) {
-                                // Handle error - fall back to regular response
-                                PyErr_Clear();
-                                send_response_with_connection(client, 500, "text/plain",
-                                                             "500 Internal Server Error: Streaming connection failed",
-                                                             strlen("500 Internal Server Error: Streaming connection failed"),
-                                                             keep_alive);
-                            } else {
-                                Py_DECREF(result);
-                                // Streaming has started successfully, headers already sent by connect function
-                            }
-                            Py_DECREF(args);
-                        }
-                        Py_DECREF(client_capsule);
-                    }
-                    Py_DECREF(connect_func);
-                }
-                Py_DECREF(streaming_module);
-            }
+static void stop_python_dispatch(void) {
+    // Requests still queued are dropped with their connections
+    loop_dispatch.running = false;
+}
 
-            PyGILState_Release(gstate);
-            free((void*)streaming_id);  // Free the allocated ID string
-        } else {
-            // Fallback to regular response if streaming ID extraction fails
-            send_response_with_connection(client, 500, "text/plain",
-                                         "500 Internal Server Error: Invalid streaming response",
-                                         strlen("500 Internal Server Error: Invalid streaming response"),
-                                         keep_alive);
-        }
-    } else {
-        // Regular, non-streaming response
-        send_response_with_connection(client, status_code, headers, body, body_len, keep_alive);
+// Copy a route match into the context so the request can run after
+// on_message_complete returned
+static int keep_dispatch_match(client_context_t* ctx, const catzilla_route_match_t* match) {
+    if (!ctx->dispatch_match) {
+        ctx->dispatch_match = catzilla_cache_alloc(sizeof(catzilla_route_match_t));
+        if (!ctx->dispatch_match) return -1;
+    }
+    if (ctx->dispatch_match != match) {
+        memcpy(ctx->dispatch_match, match, sizeof(*match));
     }
+    // Removing the route must not free it before the request ran
+    catzilla_route_t* previous = ctx->dispatch_route;
+    ctx->dispatch_route = match->route;
+    catzilla_router_hold_route(ctx->dispatch_route);
+    catzilla_router_release_route(previous);
+    // The match pointed at a stack copy of the path; the URL starts with the
+    // same bytes and outlives the queue
+    ctx->dispatch_match->path = ctx->url;
+    return 0;
 }
 
-static void on_connection(uv_stream_t* server, int status) {
-    if (status < 0) {
-        LOG_SERVER_DEBUG("Connection error: %s", uv_strerror(status));
-        return;
-    }
-    LOG_SERVER_DEBUG("New connection received");
-    catzilla_server_t* srv = server->data;
+static int queue_python_request(client_context_t* ctx, const catzilla_route_match_t* match) {
+    if (!loop_dispatch.running) return -1;
+    if (keep_dispatch_match(ctx, match) != 0) return -1;
 
-    client_context_t* ctx = catzilla_cache_alloc(sizeof(*ctx));
-    if (!ctx) return;
+    ctx->dispatch_queued = true;
+    ctx->dispatch_next = NULL;
+    if (loop_dispatch.tail) {
+        loop_dispatch.tail->dispatch_next = ctx;
+    } else {
+        loop_dispatch.head = ctx;
+    }
+    loop_dispatch.tail = ctx;
 
-    // Initialize all fields to zero/NULL
-    memset(ctx, 0, sizeof(*ctx));
-    ctx->server = srv;
-    ctx->content_type = CONTENT_TYPE_NONE;  // Explicitly set to NONE
-    ctx->parsing_content_type = false;
-    ctx->parsing_connection = false;
-    ctx->has_connection_header = false;
-    ctx->keep_alive = false;  // Default to close connection (HTTP/1.0 behavior)
-    ctx->read_paused = false;
-    ctx->deferred_response_pending = false;
-    ctx->body = NULL;
-    ctx->body_length = 0;
-    ctx->body_size = 0;
-    ctx->url[0] = '\0';
-    ctx->method[0] = '\0';
+    if (!uv_is_active((uv_handle_t*)&loop_dispatch.check)) {
+        uv_check_start(&loop_dispatch.check, on_python_dispatch);
+    }
+    return 0;
+}
 
-    LOG_SERVER_DEBUG("Initialized client context with content_type=%d", (int)ctx->content_type);
+// Drop a closing connection's request from the queue
+static void unqueue_python_request(client_context_t* ctx) {
+    if (!ctx->dispatch_queued) return;
+    ctx->dispatch_queued = false;
 
-    if (uv_tcp_init(srv->loop, &ctx->client) != 0) {
-        catzilla_cache_free(ctx);
-        return;
+    client_context_t* prev = NULL;
+    for (client_context_t* it = loop_dispatch.head; it; prev = it, it = it->dispatch_next) {
+        if (it != ctx) continue;
+        if (prev) {
+            prev->dispatch_next = ctx->dispatch_next;
+        } else {
+            loop_dispatch.head = ctx->dispatch_next;
+        }
+        if (loop_dispatch.tail == ctx) loop_dispatch.tail = prev;
+        break;
     }
-    ctx->client.data = ctx;
-    llhttp_init(&ctx->parser, HTTP_REQUEST, &srv->parser_settings);
-    ctx->parser.data = ctx;
+    ctx->dispatch_next = NULL;
+}
 
-    if (uv_accept(server, (uv_stream_t*)&ctx->client) != 0) {
-        uv_close((uv_handle_t*)&ctx->client, on_close);
-        return;
+// Parse what arrived while the parser was paused on a request
+static void resume_client_parsing(client_context_t* ctx) {
+    if (uv_is_closing((uv_handle_t*)&ctx->client)) return;
+
+    llhttp_resume(&ctx->parser);
+    if (ctx->pending_input) {
+        char* input = ctx->pending_input;
+        size_t input_len = ctx->pending_input_len;
+        ctx->pending_input = NULL;
+        ctx->pending_input_len = 0;
+        process_client_input(ctx, input, input_len);
+        catzilla_request_free(input);
     }
-    uv_read_start((uv_stream_t*)&ctx->client, alloc_buffer, on_read);
+    update_connection_timer(ctx, false);
 }
 
-static void alloc_buffer(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf) {
-    buf->base = catzilla_request_alloc(suggested_size);
-    buf->len  = buf->base ? suggested_size : 0;
+// Parse what arrived behind a request whose handler returned in a batch
+static void resume_batched_client(client_context_t* ctx, bool deferred_response) {
+    if (complete_python_request(ctx, deferred_response) == HPE_PAUSED) return;
+    resume_client_parsing(ctx);
 }
 
-static void on_read(uv_stream_t* client, ssize_t nread, const uv_buf_t* buf) {
-    client_context_t* ctx = client->data;
-    if (nread > 0) {
-        llhttp_errno_t err = llhttp_execute(&ctx->parser, buf->base, nread);
-        if (err != HPE_OK) {
-            LOG_SERVER_ERROR("HTTP parsing error: %s", llhttp_errno_name(err));
-            catzilla_send_response(client, 400, "text/plain", "400 Bad Request", strlen("400 Bad Request"));
-            uv_close((uv_handle_t*)client, on_close);
-        }
-    } else if (nread < 0 && nread != UV_EOF) {
-        LOG_SERVER_ERROR("Read error: %s", uv_strerror(nread));
-    }
-    catzilla_request_free(buf->base);
-    if (nread < 0) uv_close((uv_handle_t*)client, on_close);
+// Every file of a parked request has its verdict: route it now
+static void resume_after_upload_scans(client_context_t* ctx) {
+    ctx->upload_scan_wait = false;
+    if (!loop_dispatch.running) return;  // The loop is shutting down
+    if (uv_is_closing((uv_handle_t*)&ctx->client)) return;
+    if (route_request(ctx) == HPE_PAUSED) return;
+    resume_client_parsing(ctx);
 }
 
-static void on_close(uv_handle_t* handle) {
-    client_context_t* ctx = handle->data;
-    if (ctx) {
-        catzilla_request_free(ctx->body);
-        if (ctx->content_type_header) {
-            catzilla_cache_free(ctx->content_type_header);
-        }
+// Dispatch the requests queued during the I/O phase under one GIL hold
+static void on_python_dispatch(uv_check_t* handle) {
+    client_context_t* first = loop_dispatch.head;
+    if (!first) {
+        uv_check_stop(handle);
+        uv_idle_stop(&loop_dispatch.idle);
+        return;
+    }
 
-        // Clean up current header name buffer
-        if (ctx->current_header_name) {
-            catzilla_cache_free(ctx->current_header_name);
+    int limit = first->server->python_batch_size;
+    uint64_t budget_ns = first->server->python_batch_budget_us * 1000;
+    uint64_t started = budget_ns ? uv_hrtime() : 0;
+    uint64_t count = 0;
+    bool budget_stop = false;
+
+    // Responses stay corked until the batch ends, so requests pipelined in
+    // one read still go out in one vectored write per connection
+    client_context_t* corked = NULL;
+
+    uint64_t gil_wait_ns = 0;
+    PyGILState_STATE gstate = acquire_gil_timed(first->server, &gil_wait_ns);
+    while (loop_dispatch.head && count < (uint64_t)limit) {
+        client_context_t* ctx = loop_dispatch.head;
+        loop_dispatch.head = ctx->dispatch_next;
+        if (!loop_dispatch.head) loop_dispatch.tail = NULL;
+        ctx->dispatch_queued = false;
+        ctx->dispatch_next = NULL;
+
+        if (!ctx->batch_corked) {
+            ctx->batch_corked = true;
+            ctx->corked = true;
+            ctx->batch_cork_next = corked;
+            corked = ctx;
         }
 
-        // Clean up all stored headers
-        for (int i = 0; i < ctx->header_count; i++) {
-            if (ctx->headers[i].name) {
-                catzilla_cache_free(ctx->headers[i].name);
-            }
-            if (ctx->headers[i].value) {
-                catzilla_cache_free(ctx->headers[i].value);
-            }
+        bool deferred_response = dispatch_python_request(ctx, ctx->dispatch_match, gil_wait_ns);
+        count++;
+
+        // Parsing what the connection pipelined behind this request queues
+        // its next one, so pipelined requests share the batch. Connections
+        // close only from the close phase, so the context is still valid.
+        resume_batched_client(ctx, deferred_response);
+
+        if (budget_ns && loop_dispatch.head && uv_hrtime() - started >= budget_ns) {
+            budget_stop = true;
+            break;
         }
+    }
+    while (corked) {
+        client_context_t* ctx = corked;
+        corked = ctx->batch_cork_next;
+        ctx->batch_cork_next = NULL;
+        ctx->batch_corked = false;
+        ctx->corked = false;
+        flush_corked_writes(ctx);
+    }
+    release_gil(gstate);
+
+    catzilla_atomic_fetch_add(&stat_python_batches, 1);
+    catzilla_atomic_fetch_add(&stat_python_batched_requests, count);
+    if (budget_stop) catzilla_atomic_fetch_add(&stat_python_batch_budget_stops, 1);
+    // Racy across loops; only ever raises the value
+    if (count > catzilla_atomic_load(&stat_python_batch_largest)) {
+        catzilla_atomic_store(&stat_python_batch_largest, count);
+    }
 
-        catzilla_cache_free(ctx);
+    if (loop_dispatch.head) {
+        uv_idle_start(&loop_dispatch.idle, on_python_dispatch_idle);
+    } else {
+        uv_idle_stop(&loop_dispatch.idle);
+        uv_check_stop(handle);
     }
 }
 
-static void after_write(uv_write_t* req, int status) {
-    if (status < 0) LOG_SERVER_DEBUG("Write error: %s", uv_strerror(status));
-
-    write_req_t* wr = (write_req_t*)req;
-    client_context_t* context = req->handle ? (client_context_t*)req->handle->data : NULL;
+// Redis answered a lookup started by serve_cached_response: write its
+// response, or run the handler as for any other miss
+static void on_remote_cached_response(void* data, const void* value, size_t size) {
+    response_cache_lookup_t* lookup = data;
+    client_context_t* ctx = lookup->context;
+    if (!ctx || uv_is_closing((uv_handle_t*)&ctx->client)) {
+        // The connection closed meanwhile
+        if (ctx) ctx->cache_lookup = NULL;
+        catzilla_cache_free(lookup);
+        return;
+    }
 
-    // Only close connection if keep_alive is false
-    if (!wr->keep_alive) {
-        LOG_SERVER_DEBUG("Closing connection (keep_alive=false)");
-        uv_close((uv_handle_t*)req->handle, on_close);
-    } else {
-        LOG_SERVER_DEBUG("Keeping connection alive (keep_alive=true)");
-        if (context) {
-            reset_client_request_state(context);
-            if (context->read_paused) {
-                context->read_paused = false;
-                uv_read_start((uv_stream_t*)&context->client, alloc_buffer, on_read);
+    // The base key listed Vary names: ask again for the variant this request wants
+    if (value && !lookup->variant && follow_variants(ctx, value, size, lookup->key)) {
+        lookup->variant = true;
+        if (multi_cache_fetch_remote(ctx->server->response_cache, lookup->key,
+                                     on_remote_cached_response, lookup) == 0) {
+            return;
+        }
+        value = NULL;
+    }
+    ctx->cache_lookup = NULL;
+    catzilla_cache_free(lookup);
+
+    if (value) {
+        char* entry = catzilla_response_alloc(size > 0 ? size : 1);
+        if (entry) {
+            memcpy(entry, value, size);
+            // Already stored; the handler's response is not coming
+            catzilla_request_free(ctx->response_cache_key);
+            ctx->response_cache_key = NULL;
+            if (send_cached_entry(ctx, entry, size)) {
+                catzilla_atomic_fetch_add(&stat_response_cache_hits, 1);
+                catzilla_atomic_fetch_add(&stat_response_cache_remote_hits, 1);
+                CATZILLA_PROBE2(response_cache_hit, ctx, ctx->access_route_id);
+                resume_batched_client(ctx, false);
+                return;
             }
         }
     }
 
-    catzilla_response_free(wr->buf.base);
-    catzilla_response_free(wr);
+    catzilla_atomic_fetch_add(&stat_response_cache_misses, 1);
+    CATZILLA_PROBE2(response_cache_miss, ctx, ctx->access_route_id);
+    if (!loop_dispatch.running) return;  // The loop is shutting down
+    if (ctx->server->python_batch_size > 1 && queue_python_request(ctx, ctx->dispatch_match) == 0) {
+        return;
+    }
+    uint64_t gil_wait_ns = 0;
+    PyGILState_STATE gstate = acquire_gil_timed(ctx->server, &gil_wait_ns);
+    bool deferred_response = dispatch_python_request(ctx, ctx->dispatch_match, gil_wait_ns);
+    release_gil(gstate);
+    resume_batched_client(ctx, deferred_response);
 }
 
 static int on_message_complete(llhttp_t* parser) {
     client_context_t* context = (client_context_t*)parser->data;
-    catzilla_server_t* server = context->server;
+    context->phase = CONN_PHASE_HANDLER;
+    CATZILLA_PROBE4(request_parsed, context, context->method, context->url, context->body_length);
 
     LOG_HTTP_DEBUG("HTTP message complete");
     LOG_SERVER_INFO("Received request: Method=%s, URL=%s", context->method, context->url);
 
+    if (finish_request_body(context) != 0) {
+        const char* body = "500 Internal Server Error: Failed to store request body";
+        send_response_with_connection((uv_stream_t*)&context->client, 500, "text/plain", body, strlen(body), false);
+        reset_client_request_state(context);
+        return 0;
+    }
+
+    // Uploads still being scanned hold the request until every verdict is in
+    if (context->upload_scans) {
+        context->upload_scan_wait = true;
+        return HPE_PAUSED;
+    }
+    return route_request(context);
+}
+
+// Answer a complete request. Routes it finds stay allocated until it
+// returns, even if they are removed meanwhile; work that outlives the call
+// holds its route.
+static int route_request(client_context_t* context) {
+    catzilla_router_read_begin();
+    int rc = answer_request(context);
+    catzilla_router_read_end();
+    return rc;
+}
+
+// Static files, the response cache, then handlers
+static int answer_request(client_context_t* context) {
+    catzilla_server_t* server = context->server;
+
     // Extract path from URL (remove query string)
     char path[CATZILLA_PATH_MAX];
     char* query_start = strchr(context->url, '?');
@@ -1667,8 +5759,17 @@ static int on_message_complete(llhttp_t* parser) {
         return 0;
     }
 
+    // WebSocket handshakes are answered before HTTP routes; other upgrades
+    // and unmatched paths go on as plain requests
+    if (server->websocket_route_count > 0 && !context->h2 && llhttp_get_upgrade(&context->parser) &&
+        strcmp(context->method, "GET") == 0 &&
+        upgrade_websocket(context, path, query_start ? query_start + 1 : NULL) == 0) {
+        return 0;
+    }
+
     // 🔥 STATIC FILE CHECK FIRST (before Python callback and router)
-    if (server->static_mount_count > 0) {
+    // Static files are written straight to the socket, so HTTP/2 streams skip them
+    if (server->static_mount_count > 0 && !context->h2) {
         catzilla_server_mount_t* static_mount = NULL;
         char relative_path[CATZILLA_PATH_MAX];
 
@@ -1686,6 +5787,11 @@ static int on_message_complete(llhttp_t* parser) {
             strncpy(request.path, path, CATZILLA_PATH_MAX - 1);
             request.body = context->body;
             request.body_length = context->body_length;
+            // Borrowed for the call (Range); the static server copies what it keeps
+            request.headers = context->headers;
+
+            // Static responses are written outside the cork queue
+            flush_corked_writes(context);
 
             // ⚡ Handle static file - bypass Python and router entirely
             // Need to pass client stream correctly
@@ -1694,8 +5800,13 @@ static int on_message_complete(llhttp_t* parser) {
                                                                (uv_stream_t*)&context->client);
             if (result == 0) {
                 LOG_STATIC_INFO("Static file served successfully");
-                reset_client_request_state(context);
-                return 0;  // Static file handled successfully
+                // Hold later pipelined requests until the file response is written
+                context->deferred_response_pending = true;
+                if (!context->read_paused) {
+                    uv_read_stop((uv_stream_t*)&context->client);
+                    context->read_paused = true;
+                }
+                return HPE_PAUSED;
             } else {
                 LOG_STATIC_WARN("Static file serving failed with code: %d", result);
             }
@@ -1703,55 +5814,56 @@ static int on_message_complete(llhttp_t* parser) {
         }
     }
 
+    catzilla_route_match_t route_match;
+    memset(&route_match, 0, sizeof(route_match));
+    route_match.status_code = 404;
+    CATZILLA_PROBE1(route_start, context);
+    catzilla_router_match(&server->router, context->method, path, &route_match);
+    CATZILLA_PROBE3(route_done, context, route_match.route ? route_match.route->id : 0, route_match.status_code);
+
+    // Timed from here: native routes go straight to their handler phase.
+    // HTTP/2 streams share one context, so only HTTP/1.1 requests are timed.
+    context->latency.route = NULL;
+    if (server->latency_metrics && route_match.route && !context->h2) {
+        begin_request_latency(context, route_match.route);
+    }
+    if (route_match.route) {
+        context->access_route_id = route_match.route->id;
+    }
+
+    // Native routes answer from C, without the GIL
+    if (route_match.route && route_match.route->native) {
+        serve_native_route(context, &route_match, path);
+        reset_client_request_state(context);
+        return 0;
+    }
+
+    // Cached responses are written before any Python object is created
+    if (route_match.route && route_match.route->cache_policy) {
+        response_cache_outcome_t outcome = serve_cached_response(server, context, &route_match, path);
+        if (outcome == RESPONSE_CACHE_HIT) {
+            reset_client_request_state(context);
+            return 0;
+        }
+        if (outcome == RESPONSE_CACHE_PENDING) {
+            return HPE_PAUSED;
+        }
+    }
+
     // 1) If Python callback is set, hand off to Python and return
     if (server->py_request_callback != NULL) {
-        PyGILState_STATE gstate = PyGILState_Ensure();
-        PyObject* client_capsule = PyCapsule_New((void*)&context->client, "catzilla.client", NULL);
-        PyObject* route_match_info = NULL;
-        catzilla_route_match_t route_match;
-        bool deferred_response = false;
-
-        memset(&route_match, 0, sizeof(route_match));
-        route_match.status_code = 404;
-        catzilla_router_match(&server->router, context->method, path, &route_match);
-        route_match_info = create_python_route_match_info(&route_match, route_match.route ? 0 : -1);
-
-        if (!client_capsule) {
-            Py_XDECREF(route_match_info);
-            PyErr_Print();
-            send_response_with_connection((uv_stream_t*)&context->client, 500, "text/plain", "500 Internal Server Error", strlen("500 Internal Server Error"), context->keep_alive);
-        } else if (!route_match_info) {
-            PyErr_Print();
-            Py_DECREF(client_capsule);
-            send_response_with_connection((uv_stream_t*)&context->client, 500, "text/plain", "500 Internal Server Error", strlen("500 Internal Server Error"), context->keep_alive);
-        } else {
-            PyObject* result = handle_request_in_server(
-                server->py_request_callback,
-                client_capsule,
-                context->method,
-                context->url,
-                context->body ? context->body : "",  // Handle NULL body case
-                context->body_length,
-                context,
-                route_match_info
-            );
-            deferred_response = (result == Py_True);
-            Py_XDECREF(result);
-            Py_DECREF(route_match_info);
-            Py_DECREF(client_capsule);
-        }
-        PyGILState_Release(gstate);
-
-        if (deferred_response) {
-            context->deferred_response_pending = true;
-            if (!context->read_paused) {
-                uv_read_stop((uv_stream_t*)&context->client);
-                context->read_paused = true;
-            }
-        } else {
-            reset_client_request_state(context);
+        // HTTP/1.1 requests wait for the loop's next batch; the parser stays
+        // paused until their handler ran
+        if (server->python_batch_size > 1 && !context->h2 &&
+            queue_python_request(context, &route_match) == 0) {
+            return HPE_PAUSED;
         }
-        return 0;
+
+        uint64_t gil_wait_ns = 0;
+        PyGILState_STATE gstate = acquire_gil_timed(server, &gil_wait_ns);
+        bool deferred_response = dispatch_python_request(context, &route_match, gil_wait_ns);
+        release_gil(gstate);
+        return complete_python_request(context, deferred_response);
     }
 
     // 2) Advanced router dispatch
@@ -1764,8 +5876,10 @@ static int on_message_complete(llhttp_t* parser) {
 
         // Log path parameters
         for (int i = 0; i < match.param_count; i++) {
-            LOG_ROUTER_DEBUG("Path param: %s = %s",
-                   match.params[i].name, match.params[i].value);
+            size_t value_len = 0;
+            const char* value = catzilla_router_match_param_value(&match, i, &value_len);
+            LOG_ROUTER_DEBUG("Path param: %s = %.*s",
+                   catzilla_router_match_param_name(&match, i), (int)value_len, value);
         }
 
         // Create request structure and populate path parameters
@@ -1775,34 +5889,32 @@ static int on_message_complete(llhttp_t* parser) {
         strncpy(request.path, path, CATZILLA_PATH_MAX - 1);
         request.body = context->body;
         request.body_length = context->body_length;
+        request.body_file = context->spooling ? context->spool_path : NULL;
+        request.body_file_size = context->spooling ? context->body_received : 0;
         request.content_type = context->content_type;
+        // Borrowed for the middleware; the connection owns both
+        request.headers = context->headers;
+        request.remote_addr = context->remote_addr[0] ? context->remote_addr : NULL;
 
         LOG_HTTP_DEBUG("Created request: body_length=%zu, context->body_length=%zu",
                       request.body_length, context->body_length);
 
         populate_path_params(&request, &match);
 
-        // Execute per-route middleware if present
+        // Run the route's compiled middleware pipeline; routes without
+        // middleware skip it on the phase mask alone
         bool should_execute_handler = true;
-        if (match.route->middleware_chain != NULL && match.route->middleware_chain->middleware_count > 0) {
-            // Create middleware context for per-route execution
-            catzilla_middleware_context_t middleware_ctx;
-            memset(&middleware_ctx, 0, sizeof(middleware_ctx));
-
-            // Initialize middleware context
-            middleware_ctx.request = &request;
-            middleware_ctx.route_match = &match;
-            middleware_ctx.should_continue = true;
-            middleware_ctx.should_skip_route = false;
-            middleware_ctx.current_middleware_index = 0;
-            middleware_ctx.execution_start_time = catzilla_middleware_get_timestamp();
-
-            // Execute per-route middleware chain
-            int middleware_result = catzilla_middleware_execute_per_route(
-                match.route->middleware_chain,
-                &middleware_ctx,
-                NULL  // TODO: Pass DI container if available
-            );
+        catzilla_route_middleware_t* route_middleware = match.route->middleware_chain;
+        catzilla_middleware_context_t* middleware_ctx = NULL;
+        if (route_middleware != NULL && route_middleware->phases != 0) {
+            // Context comes from the request arena and is released with it
+            middleware_ctx = catzilla_middleware_context_create(
+                &request, &match, route_middleware->pre_count + route_middleware->post_count);
+
+            int middleware_result = middleware_ctx ?
+                catzilla_middleware_execute_per_route(route_middleware, middleware_ctx,
+                                                      NULL  // TODO: Pass DI container if available
+                                                      ) : -1;
 
             // Check middleware execution results
             if (middleware_result != 0) {
@@ -1811,18 +5923,19 @@ static int on_message_complete(llhttp_t* parser) {
                 send_response_with_connection((uv_stream_t*)&context->client, 500, "text/plain",
                                            error_body, strlen(error_body), context->keep_alive);
                 should_execute_handler = false;
-            } else if (middleware_ctx.should_skip_route) {
+                middleware_ctx = NULL;
+            } else if (middleware_ctx->should_skip_route) {
                 // Middleware requested to skip route execution
                 should_execute_handler = false;
 
                 // If middleware set a custom response, use it
-                if (middleware_ctx.response_status > 0) {
-                    const char* response_body = middleware_ctx.response_body ?
-                                              middleware_ctx.response_body : "";
-                    const char* content_type = middleware_ctx.response_content_type ?
-                                             middleware_ctx.response_content_type : "text/plain";
+                if (middleware_ctx->response_status > 0) {
+                    const char* response_body = middleware_ctx->response_body ?
+                                              middleware_ctx->response_body : "";
+                    const char* content_type = middleware_ctx->response_content_type ?
+                                             middleware_ctx->response_content_type : "text/plain";
                     send_response_with_connection((uv_stream_t*)&context->client,
-                                               middleware_ctx.response_status, content_type,
+                                               middleware_ctx->response_status, content_type,
                                                response_body, strlen(response_body), context->keep_alive);
                 } else {
                     // Default response when route is skipped
@@ -1844,47 +5957,30 @@ static int on_message_complete(llhttp_t* parser) {
                 send_response_with_connection((uv_stream_t*)&context->client, 500, "text/plain", body, strlen(body), context->keep_alive);
             }
         }
+
+        // Post-route middleware sees the request after the response went out
+        if (middleware_ctx != NULL && (route_middleware->phases & CATZILLA_MIDDLEWARE_POST_ROUTE)) {
+            catzilla_middleware_execute_post_route(route_middleware, middleware_ctx);
+        }
+        catzilla_arena_reset(&request.arena);
     } else {
         // Handle different error cases based on status code suggestion
         if (match.status_code == 405 && match.has_allowed_methods) {
             // Method not allowed - path exists but method is wrong
+            char allowed[256];
+            catzilla_router_match_allowed_methods(&match, allowed, sizeof(allowed));
             char response_body[512];
             snprintf(response_body, sizeof(response_body),
-                    "405 Method Not Allowed. Allowed methods: %s", match.allowed_methods);
+                    "405 Method Not Allowed. Allowed methods: %s", allowed);
 
             // Send 405 response with Allow header
-            char headers[1024];
-            const char* connection_header = context->keep_alive ? "keep-alive" : "close";
+            char headers[512];
             snprintf(headers, sizeof(headers),
-                    "HTTP/1.1 405 Method Not Allowed\r\n"
                     "Content-Type: text/plain\r\n"
-                    "Content-Length: %zu\r\n"
-                    "Allow: %s\r\n"
-                    "Connection: %s\r\n\r\n",
-                    strlen(response_body), match.allowed_methods, connection_header);
-
-            // Send headers and body
-            write_req_t* write_req = catzilla_response_alloc(sizeof(write_req_t));
-            if (write_req) {
-                write_req->keep_alive = context->keep_alive;  // Set keep_alive flag
-                size_t total_length = strlen(headers) + strlen(response_body);
-                char* response = catzilla_response_alloc(total_length + 1);
-                if (response) {
-                    strcpy(response, headers);
-                    strcat(response, response_body);
-
-                    write_req->buf = uv_buf_init(response, total_length);
-                    uv_write((uv_write_t*)write_req, (uv_stream_t*)&context->client,
-                            &write_req->buf, 1, after_write);
-                } else {
-                    catzilla_response_free(write_req);
-                    send_response_with_connection((uv_stream_t*)&context->client, 500, "text/plain",
-                                         "500 Internal Server Error", strlen("500 Internal Server Error"), context->keep_alive);
-                }
-            } else {
-                send_response_with_connection((uv_stream_t*)&context->client, 500, "text/plain",
-                                     "500 Internal Server Error", strlen("500 Internal Server Error"), context->keep_alive);
-            }
+                    "Allow: %s\r\n",
+                    allowed);
+            send_response_with_connection((uv_stream_t*)&context->client, 405, headers,
+                                          response_body, strlen(response_body), context->keep_alive);
         } else {
             // 404 Not Found - no route matched
             const char* body = "404 Not Found";
@@ -1925,80 +6021,47 @@ static int on_message_complete(llhttp_t* parser) {
 int parse_query_params(catzilla_request_t* request, const char* query_string) {
     if (!request || !query_string) return -1;
 
-    // Initialize query parameters
-    request->query_param_count = 0;
-    request->has_query_params = false;
-    for (int i = 0; i < CATZILLA_MAX_QUERY_PARAMS; i++) {
-        request->query_params[i] = NULL;
-        request->query_values[i] = NULL;
-    }
-
     LOG_HTTP_DEBUG("Parsing query string: %s", query_string);
 
-    const char* cursor = query_string;
-
-    while (*cursor && request->query_param_count < CATZILLA_MAX_QUERY_PARAMS) {
-        const char* key_start = cursor;
-        const char* key_end = cursor;
-        const char* value_start = NULL;
-        const char* value_end = NULL;
-
-        while (*cursor && *cursor != '&' && *cursor != '=') {
-            cursor++;
-        }
-        key_end = cursor;
-
-        if (*cursor == '=') {
-            cursor++;
-            value_start = cursor;
-            while (*cursor && *cursor != '&') {
-                cursor++;
-            }
-            value_end = cursor;
-        }
-
-        if (value_start) {
-            size_t key_length = (size_t)(key_end - key_start);
-            size_t value_length = (size_t)(value_end - value_start);
-
-            char* decoded_key = catzilla_request_alloc(key_length + 1);
-            char* decoded_value = catzilla_request_alloc(value_length + 1);
-
-            if (!decoded_key || !decoded_value) {
-                catzilla_request_free(decoded_key);
-                catzilla_request_free(decoded_value);
-                return -1;
-            }
-
-            url_decode_segment(key_start, key_length, decoded_key);
-            url_decode_segment(value_start, value_length, decoded_value);
-
-            request->query_params[request->query_param_count] = decoded_key;
-            request->query_values[request->query_param_count] = decoded_value;
-            request->query_param_count++;
-            request->has_query_params = true;
-        }
-
-        if (*cursor == '&') {
-            cursor++;
-        }
+    request->query.count = 0;
+    if (catzilla_urlencoded_parse(&request->arena, query_string, strlen(query_string),
+                                  false, &request->query) != 0) {
+        return -1;
     }
 
-    LOG_HTTP_DEBUG("Exited while loop successfully");
-    LOG_HTTP_DEBUG("Query parsing complete with %d parameters", request->query_param_count);
-    LOG_HTTP_DEBUG("parse_query_params function returning 0 (success)");
+    LOG_HTTP_DEBUG("Query parsing complete with %d parameters", request->query.count);
     return 0;
 }
 
+int catzilla_parse_query(catzilla_request_t* request) {
+    if (!request) return -1;
+    if (request->is_query_parsed) return 0;
+
+    request->is_query_parsed = true;
+    if (!request->query_string) return 0;
+    return parse_query_params(request, request->query_string);
+}
+
 const char* catzilla_get_query_param(catzilla_request_t* request, const char* param) {
-    if (!request || !request->has_query_params || !param) return NULL;
+    if (!request || !param) return NULL;
+    catzilla_parse_query(request);
+    return catzilla_param_table_get(&request->query, param);
+}
 
-    for (int i = 0; i < request->query_param_count; i++) {
-        if (strcmp(request->query_params[i], param) == 0) {
-            return request->query_values[i];
-        }
+int catzilla_get_path_param(catzilla_request_t* request, const char* param,
+                            char* output, size_t output_size) {
+    if (!request || !param || !output || !request->has_path_params) return -1;
+
+    for (int i = 0; i < request->path_param_count; i++) {
+        if (strcmp(request->path_param_names[i], param) != 0) continue;
+
+        const catzilla_route_param_slice_t* slice = &request->path_params[i];
+        if (slice->length >= output_size) return -1;
+        memcpy(output, request->path + slice->offset, slice->length);
+        output[slice->length] = '\0';
+        return slice->length;
     }
-    return NULL;
+    return -1;
 }
 
 // Route introspection and debugging functions
@@ -2074,8 +6137,9 @@ int catzilla_server_get_route_info(catzilla_server_t* server,
                                    size_t buffer_size) {
     if (!server || !method || !path || !match_info || buffer_size == 0) return -1;
 
-    // Try advanced router first
+    // Try advanced router first; the route is read after the lookup
     catzilla_route_match_t match;
+    catzilla_router_read_begin();
     int result = catzilla_router_match(&server->router, method, path, &match);
 
     if (result == 0 && match.route != NULL) {
@@ -2090,19 +6154,28 @@ int catzilla_server_get_route_info(catzilla_server_t* server,
 
         // Add parameter details
         for (int i = 0; i < match.param_count && written < buffer_size - 1; i++) {
+            const char* name = catzilla_router_match_param_name(&match, i);
+            size_t value_len = 0;
+            const char* value = catzilla_router_match_param_value(&match, i, &value_len);
             int param_written = snprintf(match_info + written, buffer_size - written,
-                "  %s = %s\n", match.params[i].name, match.params[i].value);
+                "  %s = %.*s\n", name ? name : "?", (int)value_len, value);
             if (param_written > 0) written += param_written;
         }
 
+        catzilla_router_read_end();
         return 0;
-    } else if (match.status_code == 405 && match.has_allowed_methods) {
+    }
+    catzilla_router_read_end();
+
+    if (match.status_code == 405 && match.has_allowed_methods) {
         // Method not allowed
+        char allowed[256];
+        catzilla_router_match_allowed_methods(&match, allowed, sizeof(allowed));
         snprintf(match_info, buffer_size,
             "NO_MATCH: Method Not Allowed (405)\n"
             "Path exists but method '%s' not allowed\n"
             "Allowed methods: %s\n",
-            method, match.allowed_methods);
+            method, allowed);
         return 0;
     }
 
@@ -2,11 +2,20 @@
 #define CATZILLA_SERVER_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <uv.h>
 #include <llhttp.h>
 #include <yyjson.h>
 #include "router.h"
 #include "upload_parser.h"
+#include "http_headers.h"
+#include "request_arena.h"
+#include "urlencoded.h"
+#include "tls.h"
+#include "compression.h"
+#include "sse_hub.h"
+#include "websocket.h"
+#include "access_log.h"
 
 // Forward declaration for streaming support
 typedef struct catzilla_stream_context_s catzilla_stream_context_t;
@@ -23,10 +32,42 @@ catzilla_stream_context_t* catzilla_stream_create(uv_stream_t* client, size_t bu
 #define CATZILLA_MAX_ROUTES 100
 #define CATZILLA_PATH_MAX 256
 #define CATZILLA_METHOD_MAX 32
-#define CATZILLA_MAX_HEADERS 50
-#define CATZILLA_MAX_FORM_FIELDS 50
-#define CATZILLA_MAX_QUERY_PARAMS 50
 #define CATZILLA_MAX_FILES 20
+#define CATZILLA_MAX_WORKERS 64
+#define CATZILLA_DEFAULT_CONTEXT_POOL_LIMIT 256
+#define CATZILLA_DEFAULT_BODY_SPOOL_THRESHOLD (1024 * 1024)
+#define CATZILLA_BODY_SPOOL_BUFFER_SIZE (64 * 1024)
+
+// Connection timeouts in milliseconds (0 disables one); checked by a single
+// timer wheel per loop with CATZILLA_TIMEOUT_TICK_MS resolution
+#define CATZILLA_DEFAULT_HEADER_TIMEOUT_MS 30000
+#define CATZILLA_DEFAULT_BODY_TIMEOUT_MS 60000
+#define CATZILLA_DEFAULT_KEEPALIVE_TIMEOUT_MS 15000
+#define CATZILLA_DEFAULT_WRITE_TIMEOUT_MS 60000
+#define CATZILLA_TIMEOUT_TICK_MS 100
+
+// Python requests that complete during one I/O phase are dispatched together
+// under a single GIL hold, at most this many and for at most this long
+#define CATZILLA_DEFAULT_PYTHON_BATCH_SIZE 32
+#define CATZILLA_DEFAULT_PYTHON_BATCH_BUDGET_US 2000
+
+// Memory governor: resident memory is sampled this often against the
+// budget; caches shrink from the soft mark on, large uploads are refused
+// from the hard mark (the budget itself) on, and pressure clears below the
+// clear mark. Marks are percentages of the budget.
+#define CATZILLA_DEFAULT_MEMORY_CHECK_INTERVAL_MS 1000
+#define CATZILLA_MEMORY_SOFT_PERCENT 85
+#define CATZILLA_MEMORY_CLEAR_PERCENT 75
+#define CATZILLA_DEFAULT_PRESSURE_UPLOAD_LIMIT (1024 * 1024)
+
+typedef enum {
+    CATZILLA_MEMORY_PRESSURE_NONE = 0,
+    CATZILLA_MEMORY_PRESSURE_SOFT = 1,   // Caches and pools shrink, one tier per check
+    CATZILLA_MEMORY_PRESSURE_HARD = 2    // Also purge the allocator and refuse large uploads
+} catzilla_memory_pressure_t;
+
+// Returned by a catzilla_body_chunk_fn to stop reading until catzilla_server_resume_body
+#define CATZILLA_BODY_PAUSE 1
 
 // Forward declaration
 struct catzilla_server_s;
@@ -38,50 +79,62 @@ typedef enum {
     CONTENT_TYPE_MULTIPART = 3
 } content_type_t;
 
-typedef struct catzilla_header_s {
-    char* name;
-    char* value;
-} catzilla_header_t;
-
 typedef struct catzilla_request_s {
     char method[CATZILLA_METHOD_MAX];
     char path[CATZILLA_PATH_MAX];
     char* body;
     size_t body_length;
+    char* body_file;           // Temp file holding a spooled body (NULL when buffered)
+    uint64_t body_file_size;
     content_type_t content_type;
-    catzilla_header_t headers[CATZILLA_MAX_HEADERS];
-    int header_count;
+    catzilla_header_set_t headers;  // Single data block plus well-known slots
+    const char* remote_addr;   // Client IP address, owned by the connection (may be NULL)
     yyjson_doc* json_doc;  // Parsed JSON document
     yyjson_val* json_root; // Root value of JSON document
     bool is_json_parsed;
-    char* form_fields[CATZILLA_MAX_FORM_FIELDS];
-    char* form_values[CATZILLA_MAX_FORM_FIELDS];
-    int form_field_count;
+    catzilla_param_table_t form;   // Urlencoded body fields, parsed on first lookup
     bool is_form_parsed;
     // Query parameter support
-    char* query_params[CATZILLA_MAX_QUERY_PARAMS];
-    char* query_values[CATZILLA_MAX_QUERY_PARAMS];
-    int query_param_count;
-    bool has_query_params;
-    // Path parameter support
-    catzilla_route_param_t path_params[CATZILLA_MAX_PATH_PARAMS];
+    char* query_string;        // Raw query after '?', parsed on first lookup
+    catzilla_param_table_t query;
+    bool is_query_parsed;
+    // Path parameters: slices of path, named by the matched route
+    catzilla_route_param_slice_t path_params[CATZILLA_MAX_PATH_PARAMS];
+    char* const* path_param_names;
     int path_param_count;
     bool has_path_params;
     // File upload support
     catzilla_upload_file_t* files[CATZILLA_MAX_FILES];
     int file_count;
     bool has_files;
+    // Query string, decoded query and form strings and the body copy;
+    // released in one step when the request is destroyed
+    catzilla_request_arena_t arena;
 } catzilla_request_t;
 
+// How upgraded WebSocket connections are kept alive and bounded
+typedef struct {
+    uint64_t ping_interval_ms;  // Idle time before the server pings (0 = never)
+    uint64_t pong_timeout_ms;   // Time a ping has to be answered (0 = no limit)
+    size_t max_message_size;    // Largest message after decompression (0 = unlimited)
+    size_t max_queue;           // Unsent bytes before a client is dropped (0 = unlimited)
+    bool deflate;               // Accept permessage-deflate offers
+} catzilla_websocket_options_t;
+
 // Forward declaration for static file mounts
 struct catzilla_server_mount;
 
+// Forward declaration for SO_REUSEPORT worker loops (defined in server.c)
+struct catzilla_server_worker_s;
+
 typedef struct catzilla_server_s {
     // libuv
     uv_loop_t* loop;
     uv_tcp_t server;
     uv_signal_t sig_handle;  // For SIGINT handling
     uv_signal_t sigterm_handle;  // For SIGTERM handling
+    uv_timer_t date_timer;  // Refreshes the cached Date header once per second
+    uv_timer_t timeout_timer;  // Drives the main loop's connection timeouts
 
     // HTTP parser
     llhttp_settings_t parser_settings;
@@ -100,6 +153,95 @@ typedef struct catzilla_server_s {
     // State
     bool is_running;
 
+    // Multi-loop worker mode (SO_REUSEPORT)
+    int worker_count;                              // Requested loops: 0 = one per CPU, 1 = single loop
+    int active_worker_count;                       // Extra worker loops currently running
+    struct catzilla_server_worker_s* workers;      // Worker loops beyond the main loop
+
+    // Closed connection contexts kept per loop for reuse (high-water mark)
+    int context_pool_limit;
+
+    // Requests per GIL hold (1 = dispatch each request as it completes) and
+    // time budget of one batch in microseconds (0 = size bound only)
+    int python_batch_size;
+    uint64_t python_batch_budget_us;
+
+    // Request body limits; routes may override them (see catzilla_body_mode_t)
+    uint64_t max_body_size;          // 0 = unlimited
+    size_t body_spool_threshold;
+    int body_route_count;            // Routes with a non-default body policy
+
+    // Memory governor (memory_budget 0 = off); runs on the main loop
+    uint64_t memory_budget;              // Resident memory budget in bytes
+    uint64_t memory_check_interval_ms;
+    uint64_t pressure_upload_limit;      // Bodies above this get 503 under hard pressure
+    uv_timer_t memory_timer;
+    size_t response_cache_capacity;      // Capacity to restore once pressure clears (0 = not shrunk)
+    catzilla_memory_pressure_t pressure_level;  // Level the caches and pools are shrunk for
+    int pressure_tier;                   // Tiers shrunk so far for pressure_level
+
+    // Accept prior-knowledge HTTP/2 (h2c) next to HTTP/1.1 on the same port
+    bool http2_enabled;
+
+    // Dynamic response compression, negotiated per request (off by default)
+    catzilla_compression_config_t compression;
+
+    // Connection timeouts in milliseconds (0 = none)
+    uint64_t header_timeout;     // First byte of a request to the end of its headers
+    uint64_t body_timeout;       // Between reads of a request body
+    uint64_t keepalive_timeout;  // Idle connection between requests
+    uint64_t write_timeout;      // Response bytes queued but not drained
+
+    // Accepting pauses at max_connections open sockets (0 = unlimited) and
+    // resumes once fewer than connections_low_water remain
+    uint64_t max_connections;
+    uint64_t connections_low_water;
+
+    // TLS termination for every connection when set; shared by all loops
+    catzilla_tls_context_t* tls_context;
+
+    // Responses of routes with a cache policy, shared by all loops; L1 in
+    // memory, plus a disk tier when one is configured
+    struct multi_cache* response_cache;
+
+    // Directory the response and static file caches are saved to on stop
+    // and restored from on listen, NULL when warm restarts are off
+    char* cache_snapshot_dir;
+
+    // Unix socket a reload takes the listeners over through (handoff.h),
+    // NULL when off; after a handoff the server drains for at most
+    // drain_timeout_ms (0 = until every connection closed) and stops
+    char* handoff_path;
+    uint64_t drain_timeout_ms;
+    int handoff_fd;                  // -1 while no handoff socket is bound
+    uint64_t handoff_inode;
+    uv_poll_t handoff_poll;
+    uv_timer_t drain_timer;
+    uint64_t drain_deadline;         // uv_now of the main loop
+    bool handed_off;
+
+    // clamd socket uploaded files are streamed to while they arrive (NULL =
+    // no scanning); each loop keeps its own pool of connections
+    char* clamd_address;
+    int clamd_pool_size;
+
+    // How multipart file parts are received: digests computed from the
+    // chunks (CATZILLA_DIGEST_*) and direct I/O for parts spilled to disk
+    unsigned upload_digests;
+    bool upload_direct_io;
+
+    // WebSocket routes live in their own router, matched only for upgrade
+    // requests, so they never show up in 405 answers of plain routes
+    catzilla_router_t websocket_router;
+    int websocket_route_count;
+    catzilla_websocket_options_t websocket;
+
+    // Routes record queue, GIL, handler and write time histograms (metrics.h)
+    bool latency_metrics;
+
+    // Responses are appended to this log's per-loop rings (NULL = off)
+    catzilla_access_log_t* access_log;
+
     // Python request callback
     void* py_request_callback;
 } catzilla_server_t;
@@ -160,7 +302,21 @@ yyjson_val* catzilla_get_json(catzilla_request_t* request);
 const char* catzilla_get_form_field(catzilla_request_t* request, const char* field);
 
 /**
- * Get query parameter value
+ * Parse the request's query string once; later calls return right away
+ * @param request Pointer to request structure
+ * @return 0 on success, error code on failure
+ */
+int catzilla_parse_query(catzilla_request_t* request);
+
+/**
+ * Release a request built for the Python callback and everything it owns
+ * (headers, parsed body data, uploaded files)
+ * @param request Request from catzilla_request_alloc, may be NULL
+ */
+void catzilla_request_destroy(catzilla_request_t* request);
+
+/**
+ * Get query parameter value (parses the query string on first use)
  * @param request Pointer to request structure
  * @param param Parameter name to look up
  * @return Parameter value or NULL if not found
@@ -168,12 +324,15 @@ const char* catzilla_get_form_field(catzilla_request_t* request, const char* fie
 const char* catzilla_get_query_param(catzilla_request_t* request, const char* param);
 
 /**
- * Get path parameter value
+ * Copy a path parameter value
  * @param request Pointer to request structure
  * @param param Parameter name to look up
- * @return Parameter value or NULL if not found
+ * @param output Output buffer for the NUL-terminated value
+ * @param output_size Size of the output buffer
+ * @return Length of the value, or -1 if not found or it does not fit
  */
-const char* catzilla_get_path_param(catzilla_request_t* request, const char* param);
+int catzilla_get_path_param(catzilla_request_t* request, const char* param,
+                            char* output, size_t output_size);
 
 /**
  * Start listening on the given address
@@ -184,6 +343,472 @@ const char* catzilla_get_path_param(catzilla_request_t* request, const char* par
  */
 int catzilla_server_listen(catzilla_server_t* server, const char* host, int port);
 
+/**
+ * Set the number of event loops used by catzilla_server_listen.
+ * With more than one loop, every loop binds its own SO_REUSEPORT listener
+ * and the kernel spreads accepted connections across them. All loops share
+ * the server's router read-only, so routes must be registered before listen.
+ * @param server Pointer to server structure
+ * @param workers Number of loops (0 = one per CPU, 1 = single loop, max CATZILLA_MAX_WORKERS)
+ * @return 0 on success, -1 on invalid arguments or if the server is running
+ */
+int catzilla_server_set_worker_count(catzilla_server_t* server, int workers);
+
+/**
+ * Connection accept and context pool counters, aggregated over all loops
+ */
+typedef struct {
+    uint64_t connections_accepted;   // Successful accepts
+    uint64_t accept_errors;          // Failed accepts or context allocations
+    uint64_t active_connections;     // Currently open client handles
+    uint64_t context_pool_hits;      // Connections served by a pooled context
+    uint64_t context_pool_misses;    // Connections that allocated a new context
+    uint64_t context_pool_drops;     // Contexts freed because a pool was full
+    uint64_t pooled_contexts;        // Contexts currently parked in pools
+    uint64_t header_timeouts;        // Connections closed waiting for request headers
+    uint64_t body_timeouts;          // Connections closed waiting for request body data
+    uint64_t keepalive_timeouts;     // Idle keep-alive connections closed
+    uint64_t write_timeouts;         // Connections closed with responses not drained
+    uint64_t accept_pauses;          // Times a loop stopped accepting at max_connections
+    uint64_t accept_resumes;         // Times a loop started accepting again
+    uint64_t tls_handshakes;         // Completed TLS handshakes
+    uint64_t tls_resumptions;        // Handshakes that resumed an earlier session
+    uint64_t tls_handshake_failures; // Connections closed during a failed handshake
+    uint64_t ktls_offloads;          // Connections whose sends the kernel encrypts
+    uint64_t native_responses;       // Requests answered by native routes, without Python
+    uint64_t response_cache_hits;    // Requests answered from the response cache
+    uint64_t response_cache_misses;  // Cacheable requests that went to the handler
+    uint64_t response_cache_stores;  // Handler responses stored in the cache
+    uint64_t response_cache_remote_hits;  // Hits that came from Redis after a local miss
+    uint64_t response_cache_not_modified;  // Conditional requests answered with 304
+    uint64_t python_batches;         // GIL acquisitions dispatching queued requests
+    uint64_t python_batched_requests;  // Requests dispatched by those batches
+    uint64_t python_batch_largest;   // Most requests dispatched under one GIL hold
+    uint64_t python_batch_budget_stops;  // Batches cut short by the time budget
+    uint64_t corked_flushes;         // Vectored writes carrying several pipelined responses
+    uint64_t corked_responses;       // Responses carried by those writes
+    uint64_t memory_pressure_level;  // catzilla_memory_pressure_t of the last check
+    uint64_t memory_pressure_events; // Times pressure rose to a higher level
+    uint64_t memory_shrinks;         // Checks that shrank a cache or pool tier
+    uint64_t memory_rss;             // Resident bytes at the last check
+    uint64_t pressure_rejections;    // Uploads refused under hard pressure
+} catzilla_connection_stats_t;
+
+/**
+ * Set how many closed connection contexts each loop keeps for reuse
+ * @param server Pointer to server structure
+ * @param limit Per-loop high-water mark (0 disables pooling)
+ * @return 0 on success, -1 on invalid arguments
+ */
+int catzilla_server_set_context_pool_limit(catzilla_server_t* server, int limit);
+
+/**
+ * Configure how Python requests are batched. Requests that complete while a
+ * loop handles I/O are queued and dispatched after the I/O phase under one
+ * GIL hold. HTTP/2 streams are always dispatched as they complete.
+ * @param server Pointer to server structure
+ * @param batch_size Requests per GIL hold (1 disables batching)
+ * @param budget_us Time budget of one batch in microseconds (0 = no time bound)
+ * @return 0 on success, -1 on invalid arguments
+ */
+int catzilla_server_set_python_batching(catzilla_server_t* server, int batch_size, uint64_t budget_us);
+
+/**
+ * Keep resident memory under a budget. Once it passes
+ * CATZILLA_MEMORY_SOFT_PERCENT of the budget, each check shrinks one more
+ * tier to 75% of its configured size: the response cache, then the static
+ * hot caches, then the per-loop buffer pools along with the allocator's free
+ * pages. At the budget itself the tiers are stepped through again down to
+ * 50%, the allocator is purged and bodies above upload_limit get 503. The
+ * caches get their configured sizes back once pressure clears.
+ * @param server Pointer to server structure
+ * @param budget_bytes Resident memory budget (0 = governor off)
+ * @param interval_ms Time between checks (0 = CATZILLA_DEFAULT_MEMORY_CHECK_INTERVAL_MS)
+ * @param upload_limit Largest body accepted under hard pressure (0 = CATZILLA_DEFAULT_PRESSURE_UPLOAD_LIMIT)
+ * @return 0 on success, -1 on invalid arguments or if the server is running
+ */
+int catzilla_server_set_memory_budget(catzilla_server_t* server, uint64_t budget_bytes,
+                                      uint64_t interval_ms, uint64_t upload_limit);
+
+/**
+ * @return Memory pressure level seen by the last governor check
+ */
+catzilla_memory_pressure_t catzilla_server_memory_pressure(void);
+
+/**
+ * Receives a streamed request body chunk (CATZILLA_BODY_STREAM routes).
+ * Called once more with data == NULL and len == 0 when the body is complete,
+ * right before the route handler runs.
+ * @param client Client connection
+ * @param data Chunk bytes, valid only during the call
+ * @param len Chunk length
+ * @param user_data Pointer given to catzilla_server_set_route_body_stream
+ * @return 0 to continue, CATZILLA_BODY_PAUSE to stop reading, negative to abort
+ */
+typedef int (*catzilla_body_chunk_fn)(uv_stream_t* client, const char* data, size_t len, void* user_data);
+
+/**
+ * Set the default request body limit. Requests announcing a larger
+ * Content-Length get 413 before any body allocation; chunked bodies get 413
+ * as soon as they cross the limit. The connection is closed after the 413.
+ * @param server Pointer to server structure
+ * @param max_body_size Limit in bytes (0 = unlimited)
+ * @return 0 on success, -1 on invalid arguments
+ */
+int catzilla_server_set_max_body_size(catzilla_server_t* server, uint64_t max_body_size);
+
+/**
+ * Enable HTTP/2 over cleartext with prior knowledge. Connections that open
+ * with the HTTP/2 preface are served by an HTTP/2 session whose streams are
+ * dispatched to the same router and request callback; all others keep using
+ * HTTP/1.1.
+ * @param server Pointer to server structure
+ * @param enabled Whether the preface is recognized
+ * @return 0 on success, -1 on invalid arguments
+ */
+int catzilla_server_set_http2(catzilla_server_t* server, bool enabled);
+
+/**
+ * Configure response compression. Responses of compressible media types at
+ * least min_size long are sent gzip, br or zstd encoded when the client
+ * accepts one and its build support is present; streamed responses are
+ * compressed chunk by chunk. Handlers that set Content-Encoding or
+ * Content-Length themselves are left alone.
+ * @param server Pointer to server structure
+ * @param config Compression settings (catzilla_compression_config_init for defaults)
+ * @return 0 on success, -1 on invalid arguments
+ */
+int catzilla_server_set_compression(catzilla_server_t* server, const catzilla_compression_config_t* config);
+
+/**
+ * Negotiate the coding of a streamed response with the client's request
+ * @param client Client stream
+ * @param content_type Content type of the stream
+ * @param level Receives the level of the coding
+ * @return CATZILLA_ENCODING_*, CATZILLA_ENCODING_IDENTITY when not compressed
+ */
+int catzilla_server_stream_encoding(uv_stream_t* client, const char* content_type, int* level);
+
+/**
+ * Set connection timeouts. A request whose headers or body stall gets 408
+ * before the connection is closed; idle and undrained connections are closed.
+ * @param server Pointer to server structure
+ * @param header_ms Limit for receiving a request's headers (0 = none)
+ * @param body_ms Limit between two reads of a request body (0 = none)
+ * @param keepalive_ms Idle time allowed between requests (0 = none)
+ * @param write_ms Limit for writing queued response bytes (0 = none)
+ * @return 0 on success, -1 on invalid arguments
+ */
+int catzilla_server_set_timeouts(catzilla_server_t* server, uint64_t header_ms, uint64_t body_ms,
+                                 uint64_t keepalive_ms, uint64_t write_ms);
+
+/**
+ * Limit open client connections over all loops. At the limit, loops leave new
+ * connections in the listen backlog until the count falls below low_water.
+ * @param server Pointer to server structure
+ * @param max_connections Limit (0 = unlimited)
+ * @param low_water Resume threshold (0 = 90% of max_connections)
+ * @return 0 on success, -1 on invalid arguments
+ */
+int catzilla_server_set_max_connections(catzilla_server_t* server, uint64_t max_connections,
+                                        uint64_t low_water);
+
+/**
+ * Terminate TLS on every connection. ALPN selects h2 when HTTP/2 is enabled and
+ * http/1.1 otherwise. On Linux, TLS 1.3 connections hand sending to kernel TLS
+ * after the handshake so zero-copy writes stay zero-copy.
+ * @param server Pointer to server structure
+ * @param cert_file PEM certificate chain
+ * @param key_file PEM private key
+ * @param enable_ktls Try kernel TLS offload
+ * @return 0 on success, -1 if the files cannot be used or TLS is not built in
+ */
+int catzilla_server_set_tls(catzilla_server_t* server, const char* cert_file, const char* key_file,
+                            bool enable_ktls);
+
+/**
+ * Write to a client connection, encrypting first when the connection runs TLS
+ * in userspace. Use instead of uv_write for every client stream; cb receives req.
+ * @return 0 on success, or a libuv error code
+ */
+int catzilla_server_write(uv_write_t* req, uv_stream_t* stream, const uv_buf_t bufs[],
+                          unsigned int nbufs, uv_write_cb cb);
+
+/**
+ * Set how a registered route receives its body
+ * @param server Pointer to server structure
+ * @param method HTTP method the route was registered with
+ * @param path Path pattern the route was registered with
+ * @param mode CATZILLA_BODY_BUFFERED or CATZILLA_BODY_SPOOL
+ * @param max_body_size Route limit in bytes (0 = server default)
+ * @param spool_threshold Bytes kept in memory before spilling to a temp file (0 = server default)
+ * @return 0 on success, -1 if the route does not exist or arguments are invalid
+ */
+int catzilla_server_set_route_body_mode(catzilla_server_t* server,
+                                       const char* method,
+                                       const char* path,
+                                       catzilla_body_mode_t mode,
+                                       uint64_t max_body_size,
+                                       size_t spool_threshold);
+
+/**
+ * Stream a registered route's body to a chunk handler instead of buffering it
+ * @param server Pointer to server structure
+ * @param method HTTP method the route was registered with
+ * @param path Path pattern the route was registered with
+ * @param handler Chunk handler
+ * @param user_data Pointer passed to handler
+ * @return 0 on success, -1 if the route does not exist or arguments are invalid
+ */
+int catzilla_server_set_route_body_stream(catzilla_server_t* server,
+                                         const char* method,
+                                         const char* path,
+                                         catzilla_body_chunk_fn handler,
+                                         void* user_data);
+
+/**
+ * Cache a registered route's responses in C. Lookups happen right after
+ * routing, before the GIL is taken; a hit is written without entering Python.
+ * Only GET requests and 200 responses without Set-Cookie are cached, and
+ * HTTP/2 streams bypass the cache.
+ * @param server Pointer to server structure
+ * @param method HTTP method the route was registered with
+ * @param path Path pattern the route was registered with
+ * @param ttl_seconds Lifetime of a cached response (0 stops caching the route)
+ * @param vary_query Whether the query string is part of the key
+ * @param vary_headers Comma-separated request headers that are part of the key (may be NULL)
+ * @return 0 on success, -1 if the route does not exist or arguments are invalid
+ */
+int catzilla_server_set_route_cache(catzilla_server_t* server,
+                                    const char* method,
+                                    const char* path,
+                                    uint32_t ttl_seconds,
+                                    bool vary_query,
+                                    const char* vary_headers);
+
+/**
+ * Keep cached responses in a memory-mapped disk tier as well, so they
+ * survive eviction from memory; an entry found only on disk is served from
+ * there and promoted back to memory. Call before listen.
+ * @param server Pointer to server structure
+ * @param directory Directory for the segment files (created if missing)
+ * @param max_bytes Disk space to use (0 = default)
+ * @return 0 on success, -1 on failure or if a disk tier is already set
+ */
+int catzilla_server_set_response_cache_disk(catzilla_server_t* server,
+                                            const char* directory,
+                                            uint64_t max_bytes);
+
+/**
+ * Share cached responses with other nodes through Redis. Each event loop
+ * gets its own pool of non-blocking connections; a request that misses
+ * locally waits for Redis without holding up its loop, and goes to the
+ * handler if Redis misses or is unreachable. Call before listen.
+ * @param server Pointer to server structure
+ * @param url redis://[[user]:password@]host[:port][/db]
+ * @param key_prefix Prepended to every key in Redis (NULL = "catzilla:")
+ * @param pool_size Connections per loop (0 = default)
+ * @return 0 on success, -1 on an invalid URL, a running server, or if a
+ *         Redis tier is already set
+ */
+int catzilla_server_set_response_cache_redis(catzilla_server_t* server,
+                                             const char* url,
+                                             const char* key_prefix,
+                                             int pool_size);
+
+/**
+ * Scan uploaded files with clamd. File parts of multipart bodies on
+ * buffered routes are streamed to clamd with INSTREAM while they are
+ * received, over a pool of connections per loop; the handler runs once
+ * every file has a verdict. Each file gets virus_scanned, and infected
+ * files (or files no verdict came back for) get an error. Call before listen.
+ * @param server Pointer to server structure
+ * @param address "unix:/path", "/path", "tcp://host[:port]" or "host[:port]"
+ * @param pool_size Connections per loop (0 = default)
+ * @return 0 on success, -1 on an invalid address or a running server
+ */
+int catzilla_server_set_clamd(catzilla_server_t* server, const char* address, int pool_size);
+
+/**
+ * Configure how file parts of multipart bodies are received. Digests are
+ * computed from each chunk as it is parsed, so files are never read back
+ * to checksum them. Parts spilled to disk get their space preallocated
+ * from Content-Length; with direct I/O they bypass the page cache, written
+ * by a helper thread from two aligned buffers.
+ * @param server Pointer to server structure
+ * @param digests CATZILLA_DIGEST_SHA256 and/or CATZILLA_DIGEST_CRC32C, or 0
+ * @param direct_io Write spilled parts with O_DIRECT where the file system allows
+ * @return 0 on success, -1 on unknown digest flags
+ */
+int catzilla_server_set_upload_options(catzilla_server_t* server, unsigned digests, bool direct_io);
+
+/**
+ * Save the response cache and every mount's static file cache to snapshot
+ * files in a directory on catzilla_server_stop, and restore them on
+ * listen. Entries keep the TTL they had left and are restored lazily, one
+ * bucket at a time as keys are first used, so startup does not wait for
+ * the files. Call before listen. Not available on Windows.
+ * @param server Pointer to server structure
+ * @param directory Directory for the snapshot files (created if missing)
+ * @return 0 on success, -1 on failure or if the server is running
+ */
+int catzilla_server_set_cache_snapshot(catzilla_server_t* server, const char* directory);
+
+/**
+ * Let a reload take over the listening sockets without closing them. On
+ * listen the server first asks a server running on socket_path for its
+ * listeners and serves on those instead of binding; then it binds
+ * socket_path itself for the next reload. Once its listeners are handed
+ * over it writes its cache snapshots, stops accepting, answers with
+ * Connection: close, closes idle connections and stops when the last one
+ * closed or drain_timeout_ms passed. Call before listen. Not available on
+ * Windows.
+ * @param server Pointer to server structure
+ * @param socket_path Unix socket path shared by the old and the new process
+ * @param drain_timeout_ms Longest drain after a handoff (0 = no limit)
+ * @return 0 on success, -1 on failure or if the server is running
+ */
+int catzilla_server_set_handoff(catzilla_server_t* server, const char* socket_path,
+                                uint64_t drain_timeout_ms);
+
+/**
+ * Drop every cached response held by this node (entries in Redis expire on
+ * their TTL)
+ * @param server Pointer to server structure
+ */
+void catzilla_server_clear_response_cache(catzilla_server_t* server);
+
+/**
+ * Produces the response of a native route in C, on the loop thread and
+ * without the GIL. The handler sends the response itself, e.g. with
+ * catzilla_send_response.
+ * @param client Client connection
+ * @param request Method, path, body and path parameters; valid only during the call
+ * @param user_data Pointer given to catzilla_server_set_native_handler
+ * @return 0 once a response was sent, non-zero to have the server answer 500
+ */
+typedef int (*catzilla_native_handler_fn)(uv_stream_t* client, const catzilla_request_t* request, void* user_data);
+
+/**
+ * Serve a precomputed response for a route straight from the C dispatch
+ * path. Registers the route on first use (before listen, like any route);
+ * calling it again for the same route swaps the response atomically and is
+ * safe while the server runs. Responses in flight keep the old version.
+ * @param server Pointer to server structure
+ * @param method HTTP method
+ * @param path Path pattern
+ * @param status_code HTTP status code
+ * @param headers Content type or preformatted header lines (may be NULL)
+ * @param body Response body, copied
+ * @param body_len Length of body in bytes
+ * @return 0 on success, -1 on invalid arguments, allocation failure, if the
+ *         path is already taken by a non-native route, or for a new route
+ *         once the server is running
+ */
+int catzilla_server_set_native_response(catzilla_server_t* server,
+                                        const char* method,
+                                        const char* path,
+                                        int status_code,
+                                        const char* headers,
+                                        const char* body,
+                                        size_t body_len);
+
+/**
+ * Serve a route from a C callback instead of Python. Registers the route on
+ * first use; must be called before listen.
+ * @param server Pointer to server structure
+ * @param method HTTP method
+ * @param path Path pattern
+ * @param handler Response callback
+ * @param user_data Pointer passed to handler
+ * @return 0 on success, -1 on invalid arguments, allocation failure, if the
+ *         path is already taken by a non-native route, or once the server is
+ *         running
+ */
+int catzilla_server_set_native_handler(catzilla_server_t* server,
+                                       const char* method,
+                                       const char* path,
+                                       catzilla_native_handler_fn handler,
+                                       void* user_data);
+
+/**
+ * Answer GET requests for a path with the current heap profile
+ * (catzilla_memory_profiler_dump), served natively on the loop thread. It
+ * answers 409 until the profiler was started, and 501 without jemalloc prof.
+ * @param server Pointer to server structure
+ * @param path Route path, e.g. "/debug/pprof/heap"
+ * @return 0 on success, -1 on invalid arguments or if the route cannot be added
+ */
+int catzilla_server_set_heap_profile_endpoint(catzilla_server_t* server, const char* path);
+
+/**
+ * Answer GET requests for a path with Prometheus text exposition: the
+ * connection, cache, pool, compression, memory and static file counters,
+ * and the per-route latency histograms, which this turns on. Served
+ * natively on the loop thread, so scrapes never wait for the GIL.
+ * @param server Pointer to server structure
+ * @param path Route path, e.g. "/metrics"
+ * @return 0 on success, -1 on invalid arguments or if the route cannot be added
+ */
+int catzilla_server_set_metrics_endpoint(catzilla_server_t* server, const char* path);
+
+/**
+ * Record per-route latency histograms of HTTP/1.1 requests: dispatch
+ * queue, GIL wait, handler and response write (catzilla_metrics_snapshot)
+ * @param server Pointer to server structure
+ * @param enabled Whether to record
+ * @return 0 on success, -1 on invalid arguments or if the server is running
+ */
+int catzilla_server_set_latency_metrics(catzilla_server_t* server, bool enabled);
+
+/**
+ * Log every HTTP/1.1 response to a file. The loop only copies a record into
+ * a ring of its own; a writer thread formats and writes batches, and
+ * records that find the ring full are dropped and counted. Call before
+ * listen; replaces a log set earlier.
+ * @param server Pointer to server structure
+ * @param path File to append to; NULL or "-" for stdout
+ * @param config Format, ring size and flush interval (NULL = JSON lines, defaults)
+ * @param sample_rate Share of requests logged, 0 to 1, for routes without their own
+ * @return 0 on success, -1 if the file cannot be opened or the server is running
+ */
+int catzilla_server_set_access_log(catzilla_server_t* server,
+                                   const char* path,
+                                   const catzilla_access_log_config_t* config,
+                                   double sample_rate);
+
+/**
+ * Log a share of a registered route's requests, overriding the access
+ * log's sample rate. Call after catzilla_server_set_access_log, before listen.
+ * @param server Pointer to server structure
+ * @param method HTTP method the route was registered with
+ * @param path Path pattern the route was registered with
+ * @param sample_rate 0 (none) to 1 (all)
+ * @return 0 on success, -1 without an access log, route or while running
+ */
+int catzilla_server_set_route_access_log_sample(catzilla_server_t* server,
+                                                const char* method,
+                                                const char* path,
+                                                double sample_rate);
+
+/**
+ * Resume reading a streamed body after its chunk handler returned CATZILLA_BODY_PAUSE
+ * @param client Client connection
+ */
+void catzilla_server_resume_body(uv_stream_t* client);
+
+/**
+ * Get connection accept and context pool counters
+ * @param stats Pointer to stats structure to fill
+ */
+void catzilla_server_get_connection_stats(catzilla_connection_stats_t* stats);
+
+/**
+ * Get the event loop driving the calling thread
+ * @return The worker or main loop for server threads, NULL for other threads
+ */
+uv_loop_t* catzilla_server_current_loop(void);
+
 /**
  * Stop the server
  * @param server Pointer to server structure
@@ -205,6 +830,15 @@ int catzilla_server_add_route(catzilla_server_t* server,
                              void* handler,
                              void* user_data);
 
+/**
+ * Remove a route from the advanced router; safe while the server is serving
+ * @param server Pointer to server structure
+ * @param method HTTP method of the route
+ * @param path Path pattern the route was added with
+ * @return 0 on success, -1 if no such route exists
+ */
+int catzilla_server_remove_route(catzilla_server_t* server, const char* method, const char* path);
+
 /**
  * Set the Python request callback
  * @param server Pointer to server structure
@@ -226,6 +860,174 @@ void catzilla_send_response(uv_stream_t* client,
                            const char* body,
                            size_t body_len);
 
+/**
+ * Callback that unpins a response body once its write has completed
+ * @param owner Owner pointer passed to catzilla_send_response_zerocopy
+ * @param body Body buffer that was written
+ * @param body_len Length of body in bytes
+ */
+typedef void (*catzilla_body_release_fn)(void* owner, const char* body, size_t body_len);
+
+/**
+ * Send an HTTP response without copying large bodies.
+ * The header block and body are written as separate buffers in one uv_write;
+ * the body must stay valid until release(owner, ...) is called. Small bodies
+ * are copied and released immediately. release may be called before return.
+ * @param client Client connection
+ * @param status_code HTTP status code
+ * @param content_type Content type or preformatted header lines
+ * @param body Response body content
+ * @param body_len Length of body in bytes
+ * @param release Callback invoked once the body is no longer referenced
+ * @param owner Opaque pointer passed to release
+ */
+void catzilla_send_response_zerocopy(uv_stream_t* client,
+                                     int status_code,
+                                     const char* content_type,
+                                     const char* body,
+                                     size_t body_len,
+                                     catzilla_body_release_fn release,
+                                     void* owner);
+
+/**
+ * Notify the server that a response written outside catzilla_send_response
+ * (e.g. the static file server) has completed, so a connection paused for it
+ * can parse its next pipelined request. No-op if nothing is pending.
+ * @param client Client connection
+ */
+void catzilla_server_response_complete(uv_stream_t* client);
+
+/**
+ * Check whether a response body may be written to the connection's socket
+ * directly (sendfile): true unless TLS runs in userspace or the connection
+ * speaks HTTP/2. Streams that are not server connections are raw sockets.
+ * @param client Client connection
+ * @return true if the socket takes plaintext response bytes
+ */
+bool catzilla_server_can_write_raw(uv_stream_t* client);
+
+/**
+ * Close a connection whose response was cut short after its head was sent,
+ * since there is no way left to frame the rest. No-op for other streams.
+ * @param client Client connection
+ */
+void catzilla_server_abort_response(uv_stream_t* client);
+
+/**
+ * Follow an SSE hub on a connection whose text/event-stream response head
+ * is being written; events published to the hub become chunks of its body.
+ * A subscriber the hub drops for falling behind is disconnected.
+ * @param client Client connection, on its loop thread
+ * @param hub Hub to follow
+ * @return 0 on success, -1 for HTTP/2 or other streams, or if it already
+ *         follows a hub or the loop has no hubs
+ */
+int catzilla_server_subscribe_events(uv_stream_t* client, catzilla_sse_hub_t* hub);
+
+/**
+ * The upgrade request a WebSocket route accepted, valid during the open hook
+ */
+typedef struct {
+    const char* path;
+    const char* query_string;             // After '?', NULL without one
+    const catzilla_route_match_t* match;  // Path parameters
+    const catzilla_header_set_t* headers;
+    const char* remote_addr;              // May be NULL
+} catzilla_websocket_request_t;
+
+/**
+ * Hooks WebSocket connections are handed to. The Python extension installs
+ * them once at import. All run on the connection's loop without the GIL.
+ */
+typedef struct {
+    /**
+     * The handshake was answered with 101
+     * @param client Client connection
+     * @param handler Handler the matched route was added with
+     * @return Handle passed to the other hooks, or NULL to close with 1011
+     */
+    void* (*open)(uv_stream_t* client, void* handler, const catzilla_websocket_request_t* request);
+    /** A complete message; text messages are valid UTF-8 */
+    void (*message)(void* handle, bool text, const char* data, size_t length);
+    /**
+     * The connection closed; called once for every handle open returned
+     * @param code Close code the peer sent, or CATZILLA_WS_CLOSE_ABNORMAL
+     */
+    void (*closed)(void* handle, int code, const char* reason, size_t length);
+} catzilla_websocket_hooks_t;
+
+/**
+ * Install the WebSocket hooks
+ * @param hooks Hooks, copied (NULL = WebSocket routes refuse upgrades)
+ */
+void catzilla_server_set_websocket_hooks(const catzilla_websocket_hooks_t* hooks);
+
+/**
+ * Called on a loop's own thread as it shuts down, before its remaining
+ * handles are closed, so handles owned outside the server can be closed
+ * with their own callbacks
+ * @param loop Loop shutting down
+ */
+typedef void (*catzilla_loop_exit_fn)(uv_loop_t* loop);
+
+/**
+ * Install the loop exit hook
+ * @param hook Hook (NULL = none)
+ */
+void catzilla_server_set_loop_exit_hook(catzilla_loop_exit_fn hook);
+
+/**
+ * Accept WebSocket upgrades on a path. Register before listen, like other routes.
+ * @param server Pointer to server structure
+ * @param path Path pattern, with parameters as for catzilla_server_add_route
+ * @param handler Passed to the open hook
+ * @return 0 on success, -1 if the path is taken or on invalid arguments
+ */
+int catzilla_server_add_websocket_route(catzilla_server_t* server, const char* path, void* handler);
+
+/**
+ * Set how WebSocket connections are kept alive and bounded
+ * @param server Pointer to server structure
+ * @param options Options (catzilla_websocket_options_init for defaults)
+ * @return 0 on success, -1 on invalid arguments
+ */
+int catzilla_server_set_websocket_options(catzilla_server_t* server, const catzilla_websocket_options_t* options);
+
+/**
+ * Fill options with the defaults: CATZILLA_WS_DEFAULT_* limits, deflate on
+ * @param options Options to fill
+ */
+void catzilla_websocket_options_init(catzilla_websocket_options_t* options);
+
+/**
+ * Send a message on an upgraded connection. What the socket takes at once
+ * is written from data directly; a client whose unsent bytes pass the
+ * max_queue option is disconnected.
+ * @param client Client connection, on its loop thread
+ * @param text Text (true) or binary message
+ * @param data Payload
+ * @param length Payload length
+ * @return 0 on success, -1 if the connection is not a WebSocket or is closing
+ */
+int catzilla_server_websocket_send(uv_stream_t* client, bool text, const char* data, size_t length);
+
+/**
+ * Start the closing handshake; the connection closes when the peer answers
+ * or after CATZILLA_WS_CLOSE_TIMEOUT_MS
+ * @param client Client connection, on its loop thread
+ * @param code Close code (0 = none)
+ * @param reason UTF-8 reason (may be NULL)
+ * @param length Reason length
+ * @return 0 on success, -1 if the connection is not a WebSocket or already closing
+ */
+int catzilla_server_websocket_close(uv_stream_t* client, int code, const char* reason, size_t length);
+
+/**
+ * @param client Client connection
+ * @return Bytes queued for the connection but not yet written
+ */
+size_t catzilla_server_websocket_buffered(uv_stream_t* client);
+
 // Get content type as string
 const char* catzilla_get_content_type_str(catzilla_request_t* request);
 
@@ -51,6 +51,7 @@ int catzilla_server_collect_stats(void* server_ptr, catzilla_server_stats_t* sta
 
         // Get route count from advanced router
         stats->route_count = catzilla_server_get_route_count(server);
+        stats->worker_count = server->active_worker_count + 1;
 
         // Set debug mode based on some heuristic or global flag
         // For now, we'll assume debug mode if not explicitly set to production
@@ -58,9 +59,31 @@ int catzilla_server_collect_stats(void* server_ptr, catzilla_server_stats_t* sta
         stats->debug_mode = true;  // Default to debug, Python will override
     }
 
+    catzilla_server_stats_update_connections(stats);
+
     return 0;
 }
 
+void catzilla_server_stats_update_connections(catzilla_server_stats_t* stats) {
+    if (!stats) return;
+
+    catzilla_connection_stats_t conn;
+    catzilla_server_get_connection_stats(&conn);
+
+    stats->connections_accepted = conn.connections_accepted;
+    stats->active_connections = conn.active_connections;
+    stats->context_pool_hits = conn.context_pool_hits;
+    stats->context_pool_misses = conn.context_pool_misses;
+
+    uint64_t now = (uint64_t)time(NULL);
+    uint64_t uptime = now > stats->start_time ? now - stats->start_time : 0;
+    stats->accept_rate = uptime > 0 ? (double)conn.connections_accepted / (double)uptime : 0.0;
+
+    uint64_t lookups = conn.context_pool_hits + conn.context_pool_misses;
+    stats->context_pool_hit_rate = lookups > 0 ?
+        (double)conn.context_pool_hits / (double)lookups : 0.0;
+}
+
 void catzilla_server_stats_set_route_count(catzilla_server_stats_t* stats, int route_count) {
     if (stats) {
         stats->route_count = route_count;
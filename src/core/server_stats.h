@@ -31,6 +31,14 @@ typedef struct {
     bool auto_validation;      // Whether auto-validation is enabled
     bool background_tasks;     // Whether background task system is enabled
     char allocator_name[32];   // Current memory allocator name
+
+    // Connection accept and context pool counters
+    uint64_t connections_accepted;  // Successful accepts since start
+    uint64_t active_connections;    // Currently open client connections
+    uint64_t context_pool_hits;     // Accepts served by a pooled client context
+    uint64_t context_pool_misses;   // Accepts that allocated a new client context
+    double accept_rate;             // Accepts per second since start_time
+    double context_pool_hit_rate;   // hits / (hits + misses)
 } catzilla_server_stats_t;
 
 /**
@@ -63,6 +71,12 @@ void catzilla_server_stats_set_route_count(catzilla_server_stats_t* stats, int r
  */
 void catzilla_server_stats_set_bind_info(catzilla_server_stats_t* stats, const char* host, int port);
 
+/**
+ * Refresh connection accept and context pool counters in statistics
+ * @param stats Pointer to stats structure
+ */
+void catzilla_server_stats_update_connections(catzilla_server_stats_t* stats);
+
 /**
  * Check if jemalloc is available and active
  * @return true if jemalloc is active, false otherwise
@@ -0,0 +1,442 @@
+#include "sse_hub.h"
+#include "server.h"
+#include "logging.h"
+#include "platform_atomic.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// One published event: the whole HTTP chunk, written as-is by every subscriber
+typedef struct {
+    catzilla_atomic_uint64_t refs;
+    size_t length;
+    char bytes[];
+} sse_event_t;
+
+struct catzilla_sse_hub_s {
+    catzilla_atomic_uint64_t refs;
+    size_t queue_limit;
+    catzilla_atomic_uint64_t subscribers;
+    catzilla_atomic_uint64_t published;
+    catzilla_atomic_uint64_t delivered;
+    catzilla_atomic_uint64_t dropped;
+};
+
+// An event waiting in a loop's inbox
+typedef struct sse_delivery_s {
+    catzilla_sse_hub_t* hub;
+    sse_event_t* event;
+    struct sse_delivery_s* next;
+} sse_delivery_t;
+
+// The subscribers of one hub on one loop
+typedef struct sse_channel_s {
+    catzilla_sse_hub_t* hub;
+    catzilla_sse_subscriber_t* head;
+    struct sse_channel_s* next;
+} sse_channel_t;
+
+typedef struct sse_loop_s {
+    uv_loop_t* loop;
+    uv_async_t wake;
+    uv_mutex_t lock;             // Guards the inbox; the rest is the loop's own
+    sse_delivery_t* inbox_head;
+    sse_delivery_t* inbox_tail;
+    sse_channel_t* channels;
+    struct sse_loop_s* next;
+} sse_loop_t;
+
+struct catzilla_sse_subscriber_s {
+    sse_loop_t* owner;
+    sse_channel_t* channel;
+    uv_stream_t* client;
+    catzilla_sse_drop_fn drop;
+    void* data;
+    catzilla_sse_subscriber_t* prev;
+    catzilla_sse_subscriber_t* next;
+};
+
+// A write of an event the socket did not take at once; it keeps the event
+typedef struct {
+    uv_write_t req;
+    sse_event_t* event;
+} sse_write_t;
+
+// Attached loops, walked by publishers
+static uv_once_t loops_once = UV_ONCE_INIT;
+static uv_mutex_t loops_lock;
+static sse_loop_t* loops;
+
+static void init_loops_lock(void) {
+    uv_mutex_init(&loops_lock);
+}
+
+static void event_release(sse_event_t* event) {
+    if (catzilla_atomic_fetch_sub(&event->refs, 1) == 1) {
+        free(event);
+    }
+}
+
+static void hub_retain(catzilla_sse_hub_t* hub) {
+    catzilla_atomic_fetch_add(&hub->refs, 1);
+}
+
+void catzilla_sse_hub_release(catzilla_sse_hub_t* hub) {
+    if (hub && catzilla_atomic_fetch_sub(&hub->refs, 1) == 1) {
+        free(hub);
+    }
+}
+
+catzilla_sse_hub_t* catzilla_sse_hub_create(size_t queue_limit) {
+    catzilla_sse_hub_t* hub = calloc(1, sizeof(*hub));
+    if (!hub) return NULL;
+    hub->refs = 1;
+    hub->queue_limit = queue_limit ? queue_limit : CATZILLA_SSE_DEFAULT_QUEUE_LIMIT;
+    return hub;
+}
+
+void catzilla_sse_hub_get_stats(catzilla_sse_hub_t* hub, catzilla_sse_hub_stats_t* stats) {
+    if (!stats) return;
+    memset(stats, 0, sizeof(*stats));
+    if (!hub) return;
+    stats->subscribers = catzilla_atomic_load(&hub->subscribers);
+    stats->published = catzilla_atomic_load(&hub->published);
+    stats->delivered = catzilla_atomic_load(&hub->delivered);
+    stats->dropped = catzilla_atomic_load(&hub->dropped);
+}
+
+// ================================
+// SUBSCRIBERS
+// ================================
+
+static sse_loop_t* find_loop(uv_loop_t* loop) {
+    uv_once(&loops_once, init_loops_lock);
+    uv_mutex_lock(&loops_lock);
+    sse_loop_t* state = loops;
+    while (state && state->loop != loop) state = state->next;
+    uv_mutex_unlock(&loops_lock);
+    return state;
+}
+
+static sse_channel_t* find_channel(sse_loop_t* state, catzilla_sse_hub_t* hub) {
+    for (sse_channel_t* channel = state->channels; channel; channel = channel->next) {
+        if (channel->hub == hub) return channel;
+    }
+    return NULL;
+}
+
+catzilla_sse_subscriber_t* catzilla_sse_subscribe(catzilla_sse_hub_t* hub, uv_stream_t* client,
+                                                  catzilla_sse_drop_fn drop, void* data) {
+    if (!hub || !client) return NULL;
+    sse_loop_t* state = find_loop(client->loop);
+    if (!state) return NULL;
+
+    sse_channel_t* channel = find_channel(state, hub);
+    if (!channel) {
+        channel = calloc(1, sizeof(*channel));
+        if (!channel) return NULL;
+        hub_retain(hub);
+        channel->hub = hub;
+        channel->next = state->channels;
+        state->channels = channel;
+    }
+
+    catzilla_sse_subscriber_t* subscriber = calloc(1, sizeof(*subscriber));
+    if (!subscriber) {
+        if (!channel->head) {
+            state->channels = channel->next;
+            catzilla_sse_hub_release(hub);
+            free(channel);
+        }
+        return NULL;
+    }
+    subscriber->owner = state;
+    subscriber->channel = channel;
+    subscriber->client = client;
+    subscriber->drop = drop;
+    subscriber->data = data;
+    subscriber->next = channel->head;
+    if (channel->head) channel->head->prev = subscriber;
+    channel->head = subscriber;
+    catzilla_atomic_fetch_add(&hub->subscribers, 1);
+    return subscriber;
+}
+
+// Unlink and free a subscriber, and its channel once empty
+static void remove_subscriber(catzilla_sse_subscriber_t* subscriber) {
+    sse_channel_t* channel = subscriber->channel;
+    if (subscriber->prev) subscriber->prev->next = subscriber->next;
+    else channel->head = subscriber->next;
+    if (subscriber->next) subscriber->next->prev = subscriber->prev;
+    catzilla_atomic_fetch_sub(&channel->hub->subscribers, 1);
+
+    if (!channel->head) {
+        sse_loop_t* state = subscriber->owner;
+        for (sse_channel_t** link = &state->channels; *link; link = &(*link)->next) {
+            if (*link == channel) {
+                *link = channel->next;
+                break;
+            }
+        }
+        catzilla_sse_hub_release(channel->hub);
+        free(channel);
+    }
+    free(subscriber);
+}
+
+void catzilla_sse_unsubscribe(catzilla_sse_subscriber_t* subscriber) {
+    if (subscriber) remove_subscriber(subscriber);
+}
+
+static void drop_subscriber(catzilla_sse_subscriber_t* subscriber) {
+    uv_stream_t* client = subscriber->client;
+    catzilla_sse_drop_fn drop = subscriber->drop;
+    void* data = subscriber->data;
+    remove_subscriber(subscriber);
+    if (drop) drop(client, data);
+}
+
+// ================================
+// DELIVERY
+// ================================
+
+static void on_event_written(uv_write_t* req, int status) {
+    sse_write_t* write = (sse_write_t*)req;
+    if (status < 0) LOG_STREAM_DEBUG("SSE write error: %s", uv_strerror(status));
+    event_release(write->event);
+    free(write);
+}
+
+// Write the event to one subscriber; bytes the socket takes now need no request
+static void deliver(catzilla_sse_subscriber_t* subscriber, sse_event_t* event) {
+    catzilla_sse_hub_t* hub = subscriber->channel->hub;
+    uv_stream_t* client = subscriber->client;
+    if (uv_is_closing((uv_handle_t*)client)) return;
+
+    if (uv_stream_get_write_queue_size(client) > hub->queue_limit) {
+        catzilla_atomic_fetch_add(&hub->dropped, 1);
+        LOG_STREAM_DEBUG("Dropping SSE subscriber with %zu bytes unsent",
+                         uv_stream_get_write_queue_size(client));
+        drop_subscriber(subscriber);
+        return;
+    }
+
+    uv_buf_t buf = uv_buf_init(event->bytes, (unsigned int)event->length);
+    if (catzilla_server_can_write_raw(client)) {
+        int written = uv_try_write(client, &buf, 1);
+        if (written == (int)buf.len) {
+            catzilla_atomic_fetch_add(&hub->delivered, 1);
+            return;
+        }
+        if (written > 0) {
+            buf.base += written;
+            buf.len -= (unsigned int)written;
+        } else if (written != UV_EAGAIN) {
+            // The connection is failing; its close unsubscribes it
+            return;
+        }
+    }
+
+    sse_write_t* write = malloc(sizeof(*write));
+    if (!write) return;
+    write->event = event;
+    catzilla_atomic_fetch_add(&event->refs, 1);
+    if (catzilla_server_write(&write->req, client, &buf, 1, on_event_written) != 0) {
+        event_release(event);
+        free(write);
+        return;
+    }
+    catzilla_atomic_fetch_add(&hub->delivered, 1);
+}
+
+static void free_deliveries(sse_delivery_t* delivery) {
+    while (delivery) {
+        sse_delivery_t* next = delivery->next;
+        event_release(delivery->event);
+        catzilla_sse_hub_release(delivery->hub);
+        free(delivery);
+        delivery = next;
+    }
+}
+
+static void on_wake(uv_async_t* handle) {
+    sse_loop_t* state = handle->data;
+
+    uv_mutex_lock(&state->lock);
+    sse_delivery_t* delivery = state->inbox_head;
+    state->inbox_head = state->inbox_tail = NULL;
+    uv_mutex_unlock(&state->lock);
+
+    for (sse_delivery_t* item = delivery; item; item = item->next) {
+        sse_channel_t* channel = find_channel(state, item->hub);
+        if (!channel) continue;
+        // A drop can free the channel with its last subscriber
+        catzilla_sse_subscriber_t* subscriber = channel->head;
+        while (subscriber) {
+            catzilla_sse_subscriber_t* next = subscriber->next;
+            deliver(subscriber, item->event);
+            subscriber = next;
+        }
+    }
+    free_deliveries(delivery);
+}
+
+// ================================
+// PUBLISHING
+// ================================
+
+static bool has_line_break(const char* text) {
+    return text && strpbrk(text, "\r\n") != NULL;
+}
+
+// Data lines end at CR, LF or CRLF; each becomes its own "data:" field
+static size_t next_line(const char* data, size_t len, size_t pos, size_t* next) {
+    size_t end = pos;
+    while (end < len && data[end] != '\n' && data[end] != '\r') end++;
+    *next = end;
+    if (end < len) {
+        *next = end + 1;
+        if (data[end] == '\r' && end + 1 < len && data[end + 1] == '\n') *next = end + 2;
+    }
+    return end - pos;
+}
+
+// Lay the event out as "<size>\r\n" + fields + "\n\r\n"; out is NULL to measure
+static size_t format_event(char* out, const char* event, const char* id,
+                           const char* data, size_t len) {
+    size_t size = 0;
+#define EMIT(bytes, count) do { if (out) memcpy(out + size, (bytes), (count)); size += (count); } while (0)
+    if (id) {
+        EMIT("id: ", 4);
+        EMIT(id, strlen(id));
+        EMIT("\n", 1);
+    }
+    if (event) {
+        EMIT("event: ", 7);
+        EMIT(event, strlen(event));
+        EMIT("\n", 1);
+    }
+    size_t pos = 0;
+    do {
+        size_t next;
+        size_t line = next_line(data, len, pos, &next);
+        EMIT("data: ", 6);
+        EMIT(data + pos, line);
+        EMIT("\n", 1);
+        pos = next;
+    } while (pos < len);
+    EMIT("\n", 1);
+#undef EMIT
+    return size;
+}
+
+static sse_event_t* build_event(const char* event, const char* id, const char* data, size_t len) {
+    size_t payload = format_event(NULL, event, id, data, len);
+    char chunk_header[24];
+    int header_len = snprintf(chunk_header, sizeof(chunk_header), "%zx\r\n", payload);
+
+    sse_event_t* built = malloc(sizeof(*built) + (size_t)header_len + payload + 2);
+    if (!built) return NULL;
+    built->refs = 1;
+    memcpy(built->bytes, chunk_header, (size_t)header_len);
+    format_event(built->bytes + header_len, event, id, data, len);
+    memcpy(built->bytes + header_len + payload, "\r\n", 2);
+    built->length = (size_t)header_len + payload + 2;
+    return built;
+}
+
+int catzilla_sse_publish(catzilla_sse_hub_t* hub, const char* event, const char* id,
+                         const char* data, size_t len) {
+    if (!hub || (!data && len > 0) || has_line_break(event) || has_line_break(id)) return -1;
+    sse_event_t* built = build_event(event, id, data ? data : "", len);
+    if (!built) return -1;
+    catzilla_atomic_fetch_add(&hub->published, 1);
+
+    int rc = 0;
+    uv_once(&loops_once, init_loops_lock);
+    uv_mutex_lock(&loops_lock);
+    for (sse_loop_t* state = loops; state; state = state->next) {
+        sse_delivery_t* delivery = malloc(sizeof(*delivery));
+        if (!delivery) {
+            rc = -1;
+            break;
+        }
+        hub_retain(hub);
+        catzilla_atomic_fetch_add(&built->refs, 1);
+        delivery->hub = hub;
+        delivery->event = built;
+        delivery->next = NULL;
+
+        uv_mutex_lock(&state->lock);
+        if (state->inbox_tail) state->inbox_tail->next = delivery;
+        else state->inbox_head = delivery;
+        state->inbox_tail = delivery;
+        uv_mutex_unlock(&state->lock);
+        uv_async_send(&state->wake);
+    }
+    uv_mutex_unlock(&loops_lock);
+
+    event_release(built);
+    return rc;
+}
+
+// ================================
+// LOOPS
+// ================================
+
+int catzilla_sse_attach_loop(uv_loop_t* loop) {
+    if (!loop) return -1;
+    if (find_loop(loop)) return 0;
+
+    sse_loop_t* state = calloc(1, sizeof(*state));
+    if (!state) return -1;
+    state->loop = loop;
+    if (uv_mutex_init(&state->lock) != 0) {
+        free(state);
+        return -1;
+    }
+    if (uv_async_init(loop, &state->wake, on_wake) != 0) {
+        uv_mutex_destroy(&state->lock);
+        free(state);
+        return -1;
+    }
+    state->wake.data = state;
+    // Only subscribers keep the loop busy, not the hub
+    uv_unref((uv_handle_t*)&state->wake);
+
+    uv_mutex_lock(&loops_lock);
+    state->next = loops;
+    loops = state;
+    uv_mutex_unlock(&loops_lock);
+    return 0;
+}
+
+static void on_wake_closed(uv_handle_t* handle) {
+    sse_loop_t* state = handle->data;
+    uv_mutex_destroy(&state->lock);
+    free(state);
+}
+
+void catzilla_sse_detach_loop(uv_loop_t* loop) {
+    uv_once(&loops_once, init_loops_lock);
+    uv_mutex_lock(&loops_lock);
+    sse_loop_t* state = NULL;
+    for (sse_loop_t** link = &loops; *link; link = &(*link)->next) {
+        if ((*link)->loop == loop) {
+            state = *link;
+            *link = state->next;
+            break;
+        }
+    }
+    uv_mutex_unlock(&loops_lock);
+    if (!state) return;
+
+    // Publishers no longer see the loop, so the inbox only shrinks now
+    free_deliveries(state->inbox_head);
+    state->inbox_head = state->inbox_tail = NULL;
+    while (state->channels) {
+        drop_subscriber(state->channels->head);
+    }
+    uv_close((uv_handle_t*)&state->wake, on_wake_closed);
+}
@@ -0,0 +1,117 @@
+/*
+ * Catzilla SSE hub - fans published server-sent events out to subscribers
+ *
+ * A hub is a channel connections subscribe to with a text/event-stream
+ * response. Publishing formats the event once, HTTP chunk framing
+ * included, into a refcounted buffer; every subscribed connection writes
+ * that same buffer. Publishers may run on any thread: each event loop that
+ * was attached has an inbox the event is queued in, and the loop writes it
+ * to its own subscribers when its async handle wakes it. A subscriber whose
+ * unsent bytes exceed the hub's queue limit is too slow to keep up and is
+ * dropped, so one stalled client cannot pin the events of a whole stream.
+ */
+
+#ifndef CATZILLA_SSE_HUB_H
+#define CATZILLA_SSE_HUB_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <uv.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct catzilla_sse_hub_s catzilla_sse_hub_t;
+typedef struct catzilla_sse_subscriber_s catzilla_sse_subscriber_t;
+
+#define CATZILLA_SSE_DEFAULT_QUEUE_LIMIT (256 * 1024)  // Unsent bytes per subscriber
+
+/**
+ * Called on the subscriber's loop when the hub dropped it, because it fell
+ * behind or its loop was detached. The subscriber is already freed and must
+ * not be unsubscribed; the callback closes the connection.
+ */
+typedef void (*catzilla_sse_drop_fn)(uv_stream_t* client, void* data);
+
+typedef struct {
+    uint64_t subscribers;  // Currently subscribed
+    uint64_t published;    // Events published
+    uint64_t delivered;    // Event writes to subscribers
+    uint64_t dropped;      // Subscribers dropped for falling behind
+} catzilla_sse_hub_stats_t;
+
+/**
+ * Let a loop's connections subscribe to hubs. Call on the loop's thread
+ * before it runs.
+ * @param loop Event loop
+ * @return 0 on success, -1 on failure
+ */
+int catzilla_sse_attach_loop(uv_loop_t* loop);
+
+/**
+ * Drop the loop's subscribers and discard events still queued for it. Call
+ * on the loop's thread; the loop must run once more to close its handle.
+ * No-op if the loop is not attached.
+ * @param loop Event loop
+ */
+void catzilla_sse_detach_loop(uv_loop_t* loop);
+
+/**
+ * Create a hub
+ * @param queue_limit Unsent bytes a subscriber may have before it is
+ *                    dropped (0 = CATZILLA_SSE_DEFAULT_QUEUE_LIMIT)
+ * @return Hub holding one reference, or NULL when memory runs out
+ */
+catzilla_sse_hub_t* catzilla_sse_hub_create(size_t queue_limit);
+
+/**
+ * Release the creator's reference. Subscribers keep the hub alive until
+ * they leave; no more events can be published.
+ * @param hub Hub (may be NULL)
+ */
+void catzilla_sse_hub_release(catzilla_sse_hub_t* hub);
+
+/**
+ * Subscribe a connection whose text/event-stream response head was or is
+ * about to be written. Call on the connection's loop thread.
+ * @param hub Hub
+ * @param client Client connection on an attached loop
+ * @param drop Called if the hub drops the subscriber
+ * @param data Passed to drop
+ * @return Subscriber, or NULL if the loop is not attached or memory ran out
+ */
+catzilla_sse_subscriber_t* catzilla_sse_subscribe(catzilla_sse_hub_t* hub, uv_stream_t* client,
+                                                  catzilla_sse_drop_fn drop, void* data);
+
+/**
+ * Remove a subscriber, e.g. when its connection closes. Call on its loop
+ * thread. Writes already queued still complete.
+ * @param subscriber Subscriber (may be NULL)
+ */
+void catzilla_sse_unsubscribe(catzilla_sse_subscriber_t* subscriber);
+
+/**
+ * Publish an event to every subscriber of the hub. Safe from any thread;
+ * subscribers receive it when their loop next runs.
+ * @param hub Hub
+ * @param event Event type (NULL = the default "message")
+ * @param id Event ID clients resume from (NULL = none)
+ * @param data Event data; line breaks split it over several data lines
+ * @param len Length of data
+ * @return 0 on success, -1 if event or id contain a line break or memory ran out
+ */
+int catzilla_sse_publish(catzilla_sse_hub_t* hub, const char* event, const char* id,
+                         const char* data, size_t len);
+
+/**
+ * @param hub Hub
+ * @param stats Receives the hub's counters
+ */
+void catzilla_sse_hub_get_stats(catzilla_sse_hub_t* hub, catzilla_sse_hub_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CATZILLA_SSE_HUB_H
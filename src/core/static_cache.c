@@ -1,12 +1,30 @@
 #include "static_server.h"
+#include "platform_compat.h"
 #include "memory.h"
+#include "cache_snapshot.h"
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
-
-// Forward declaration for internal function
-static void catzilla_static_cache_remove_unlocked(hot_cache_t* cache, const char* file_path);
+#include <sys/stat.h>
+
+// Lookup epochs, as in the router. A lookup publishes the epoch it started
+// in, in its thread's slot, until it has its reference; an entry or table
+// removed in epoch E can go once every busy slot shows a later epoch.
+// Threads past the last slot take write_lock for their lookups instead.
+static catzilla_atomic_uint64_t cache_epoch = 1;
+static catzilla_atomic_uint64_t cache_reader_epochs[STATIC_CACHE_MAX_READERS];  // 0 = idle
+static catzilla_atomic_uint64_t cache_reader_slots;  // Slots handed out
+static CATZILLA_THREAD_LOCAL int cache_reader_slot = -1;  // -2 = none left
+
+// Marks a slot whose entry was removed; probes go on past it
+static char cache_tombstone;
+#define TOMBSTONE ((hot_cache_entry_t*)&cache_tombstone)
+
+// Forward declarations for internal functions
+static int cache_insert(hot_cache_t* cache, const char* file_path, void* content, size_t size,
+                        void* gzipped, size_t gzipped_size, time_t mtime, time_t expires_at,
+                        bool restoring);
 
 // Hash function for file paths
 static uint32_t hash_path(const char* path) {
@@ -15,44 +33,150 @@ static uint32_t hash_path(const char* path) {
     while ((c = *path++)) {
         hash = ((hash << 5) + hash) + c;
     }
-    return hash % STATIC_CACHE_HASH_BUCKETS;
+    return hash;
 }
 
-// LRU list management
-static void lru_add_to_head(hot_cache_t* cache, hot_cache_entry_t* entry) {
-    entry->lru_next = cache->lru_head;
-    entry->lru_prev = NULL;
+static hot_cache_table_t* table_create(uint32_t capacity) {
+    size_t size = sizeof(hot_cache_table_t) + (size_t)capacity * sizeof(hot_cache_entry_t*);
+    hot_cache_table_t* table = catzilla_static_alloc(size);
+    if (!table) return NULL;
+    memset(table, 0, size);
+    table->capacity = capacity;
+    return table;
+}
 
-    if (cache->lru_head) {
-        cache->lru_head->lru_prev = entry;
+// Find a path; index_out receives its slot
+static hot_cache_entry_t* table_find(hot_cache_table_t* table, uint32_t hash, const char* file_path,
+                                     uint32_t* index_out) {
+    uint32_t mask = table->capacity - 1;
+    for (uint32_t i = hash & mask, probes = 0; probes < table->capacity; i = (i + 1) & mask, probes++) {
+        hot_cache_entry_t* entry = catzilla_atomic_load_seq(&table->slots[i]);
+        if (!entry) return NULL;
+        if (entry != TOMBSTONE && entry->hash == hash && strcmp(entry->file_path, file_path) == 0) {
+            if (index_out) *index_out = i;
+            return entry;
+        }
     }
+    return NULL;
+}
 
-    cache->lru_head = entry;
+// Publish an entry in the first free slot of its probe sequence; holds write_lock
+static void table_place(hot_cache_table_t* table, hot_cache_entry_t* entry) {
+    uint32_t mask = table->capacity - 1;
+    uint32_t i = entry->hash & mask;
+    while (table->slots[i] && table->slots[i] != TOMBSTONE) {
+        i = (i + 1) & mask;
+    }
+    if (!table->slots[i]) table->used++;
+    catzilla_atomic_store_seq(&table->slots[i], entry);
+}
 
-    if (!cache->lru_tail) {
-        cache->lru_tail = entry;
+static void free_entry(hot_cache_entry_t* entry) {
+    catzilla_free(entry->file_content);
+    if (entry->compressed_content) {
+        catzilla_free(entry->compressed_content);
     }
+    catzilla_free(entry->file_path);
+    catzilla_free(entry);
 }
 
-static void lru_remove(hot_cache_t* cache, hot_cache_entry_t* entry) {
-    if (entry->lru_prev) {
-        entry->lru_prev->lru_next = entry->lru_next;
-    } else {
-        cache->lru_head = entry->lru_next;
+// Free what no running lookup can still reach; holds write_lock. Removed
+// entries only lose the table's reference here: one still used by a
+// request is freed by its last release.
+static void reclaim_locked(hot_cache_t* cache) {
+    if (!cache->retired_entries && !cache->retired_tables) return;
+
+    uint64_t slots = catzilla_atomic_load_seq(&cache_reader_slots);
+    if (slots > STATIC_CACHE_MAX_READERS) slots = STATIC_CACHE_MAX_READERS;
+
+    uint64_t oldest = UINT64_MAX;
+    for (uint64_t i = 0; i < slots; i++) {
+        uint64_t epoch = catzilla_atomic_load_seq(&cache_reader_epochs[i]);
+        if (epoch != 0 && epoch < oldest) oldest = epoch;
     }
 
-    if (entry->lru_next) {
-        entry->lru_next->lru_prev = entry->lru_prev;
-    } else {
-        cache->lru_tail = entry->lru_prev;
+    hot_cache_entry_t** link = &cache->retired_entries;
+    while (*link) {
+        hot_cache_entry_t* entry = *link;
+        if (entry->retired_epoch < oldest) {
+            *link = entry->next_retired;
+            if (catzilla_atomic_fetch_sub(&entry->refs, 1) == 1) {
+                free_entry(entry);
+            }
+        } else {
+            link = &entry->next_retired;
+        }
+    }
+
+    hot_cache_table_t** table_link = &cache->retired_tables;
+    while (*table_link) {
+        hot_cache_table_t* table = *table_link;
+        if (table->retired_epoch < oldest) {
+            *table_link = table->next_retired;
+            catzilla_free(table);
+        } else {
+            table_link = &table->next_retired;
+        }
     }
+}
+
+// Take the entry in a slot out of the table; holds write_lock
+static void unlink_slot(hot_cache_t* cache, hot_cache_table_t* table, uint32_t index) {
+    hot_cache_entry_t* entry = table->slots[index];
+    catzilla_atomic_store_seq(&table->slots[index], TOMBSTONE);
 
-    entry->lru_prev = entry->lru_next = NULL;
+    cache->current_memory_usage -= entry->memory;
+    cache->total_entries--;
+
+    // Lookups that start from here on cannot find it
+    entry->retired_epoch = catzilla_atomic_fetch_add(&cache_epoch, 1);
+    entry->next_retired = cache->retired_entries;
+    cache->retired_entries = entry;
 }
 
-static void lru_move_to_head(hot_cache_t* cache, hot_cache_entry_t* entry) {
-    lru_remove(cache, entry);
-    lru_add_to_head(cache, entry);
+// Evict the entry under the clock hand that has not been looked up since
+// the hand last passed; holds write_lock
+static bool evict_one(hot_cache_t* cache) {
+    hot_cache_table_t* table = cache->table;
+    if (cache->total_entries == 0) return false;
+
+    // Two turns clear every referenced bit, so one entry is always found
+    for (uint32_t turns = 0; turns < 2 * table->capacity; turns++) {
+        uint32_t i = cache->clock_hand++ & (table->capacity - 1);
+        hot_cache_entry_t* entry = table->slots[i];
+        if (!entry || entry == TOMBSTONE) continue;
+        if (catzilla_atomic_load_relaxed(&entry->referenced)) {
+            catzilla_atomic_store_relaxed(&entry->referenced, 0);
+            continue;
+        }
+        unlink_slot(cache, table, i);
+        catzilla_atomic_fetch_add(&cache->evictions, 1);
+        return true;
+    }
+    return false;
+}
+
+// Make room for one more entry, copying the live entries into a table sized
+// for them once tombstones and entries fill half the slots; holds write_lock
+static int reserve_slot(hot_cache_t* cache) {
+    hot_cache_table_t* table = cache->table;
+    if ((table->used + 1) * 2 <= table->capacity) return 0;
+
+    uint32_t capacity = STATIC_CACHE_MIN_SLOTS;
+    while (capacity < (cache->total_entries + 1) * 4) capacity *= 2;
+
+    hot_cache_table_t* next = table_create(capacity);
+    if (!next) return -1;
+    for (uint32_t i = 0; i < table->capacity; i++) {
+        hot_cache_entry_t* entry = table->slots[i];
+        if (entry && entry != TOMBSTONE) table_place(next, entry);
+    }
+
+    catzilla_atomic_store_seq(&cache->table, next);
+    table->retired_epoch = catzilla_atomic_fetch_add(&cache_epoch, 1);
+    table->next_retired = cache->retired_tables;
+    cache->retired_tables = table;
+    return 0;
 }
 
 int catzilla_static_cache_init(hot_cache_t* cache, size_t max_memory) {
@@ -63,264 +187,339 @@ int catzilla_static_cache_init(hot_cache_t* cache, size_t max_memory) {
     cache->max_memory_bytes = max_memory;
     cache->current_memory_usage = 0;
     cache->total_entries = 0;
-    cache->lru_head = NULL;
-    cache->lru_tail = NULL;
 
-    // Initialize hash table buckets
-    for (int i = 0; i < STATIC_CACHE_HASH_BUCKETS; i++) {
-        cache->buckets[i] = NULL;
-    }
+    cache->table = table_create(STATIC_CACHE_MIN_SLOTS);
+    if (!cache->table) return -1;
 
     // Initialize atomic counters
     catzilla_atomic_store(&cache->cache_hits, 0);
     catzilla_atomic_store(&cache->cache_misses, 0);
     catzilla_atomic_store(&cache->evictions, 0);
 
-    // Initialize read-write lock
-    int result = uv_rwlock_init(&cache->cache_lock);
+    // Serialises changes; lookups never take it unless out of reader slots
+    int result = uv_mutex_init(&cache->write_lock);
     if (result != 0) {
+        catzilla_free(cache->table);
+        cache->table = NULL;
         return result;
     }
 
     return 0;
 }
 
-hot_cache_entry_t* catzilla_static_cache_get(hot_cache_t* cache, const char* file_path) {
-    if (!cache || !file_path) return NULL;
-
-    uint32_t hash = hash_path(file_path);
-    time_t now = time(NULL);
+// Insert one snapshot record unless its file changed after it was cached
+static void restore_entry(void* data, const catzilla_snapshot_record_t* record,
+                          const char* key, const void* value) {
+    hot_cache_t* cache = data;
+    if (record->stored_size == 0 || record->stored_size > STATIC_CACHE_MAX_FILE_SIZE ||
+        record->stored_size != record->value_size) {
+        return;
+    }
 
-    uv_rwlock_rdlock(&cache->cache_lock);
+    char full_path[CATZILLA_PATH_MAX];
+    struct stat st;
+    if (snprintf(full_path, sizeof(full_path), "%s/%s", cache->snapshot_root, key) >= (int)sizeof(full_path) ||
+        stat(full_path, &st) != 0 || (uint64_t)st.st_size != record->stored_size ||
+        (int64_t)st.st_mtime > record->mtime) {
+        return;
+    }
 
-    hot_cache_entry_t* entry = cache->buckets[hash];
-    while (entry) {
-        if (strcmp(entry->file_path, file_path) == 0) {
-            // Check if entry has expired
-            if (entry->expires_at > 0 && entry->expires_at < now) {
-                uv_rwlock_rdunlock(&cache->cache_lock);
+    void* content = catzilla_static_alloc((size_t)record->stored_size);
+    if (!content) return;
+    memcpy(content, value, (size_t)record->stored_size);
+
+    time_t expires_at = time(NULL) + (time_t)(record->expires_us / 1000000);
+    uv_mutex_lock(&cache->write_lock);
+    int rc = cache_insert(cache, key, content, (size_t)record->stored_size, NULL, 0,
+                          (time_t)record->mtime, expires_at, true);
+    uv_mutex_unlock(&cache->write_lock);
+    if (rc != 0) {
+        catzilla_free(content);
+    }
+}
 
-                // Upgrade to write lock to remove expired entry
-                uv_rwlock_wrlock(&cache->cache_lock);
-                catzilla_static_cache_remove_unlocked(cache, file_path);
-                uv_rwlock_wrunlock(&cache->cache_lock);
-                return NULL;
-            }
+// Restore the snapshot bucket of a path before it is first used; must be
+// called without the cache lock held
+static void snapshot_fault(hot_cache_t* cache, uint32_t hash) {
+    if (catzilla_snapshot_pending(cache->snapshot)) {
+        catzilla_snapshot_restore(cache->snapshot, hash, restore_entry, cache);
+    }
+}
 
-            // Update access time and move to head of LRU
-            entry->last_accessed = now;
-            entry->access_count++;
+hot_cache_entry_t* catzilla_static_cache_get(hot_cache_t* cache, const char* file_path) {
+    if (!cache || !file_path) return NULL;
 
-            uv_rwlock_rdunlock(&cache->cache_lock);
+    uint32_t hash = hash_path(file_path);
+    time_t now = time(NULL);
+    snapshot_fault(cache, hash);
+
+    // The table and its entries stay allocated while this thread's slot
+    // shows the epoch the lookup began in
+    int slot = cache_reader_slot;
+    if (slot == -1) {
+        uint64_t claimed = catzilla_atomic_fetch_add(&cache_reader_slots, 1);
+        slot = claimed < STATIC_CACHE_MAX_READERS ? (int)claimed : -2;
+        cache_reader_slot = slot;
+    }
+    if (slot >= 0) {
+        catzilla_atomic_store_seq(&cache_reader_epochs[slot], catzilla_atomic_load_seq(&cache_epoch));
+    } else {
+        uv_mutex_lock(&cache->write_lock);
+    }
 
-            // Upgrade to write lock for LRU update
-            uv_rwlock_wrlock(&cache->cache_lock);
-            lru_move_to_head(cache, entry);
-            uv_rwlock_wrunlock(&cache->cache_lock);
+    hot_cache_table_t* table = catzilla_atomic_load_seq(&cache->table);
+    hot_cache_entry_t* entry = table_find(table, hash, file_path, NULL);
 
-            return entry;
+    // Expired entries are left for the cleanup timer or the next put
+    if (entry && entry->expires_at > 0 && entry->expires_at < now) {
+        entry = NULL;
+    }
+    if (entry) {
+        catzilla_atomic_fetch_add(&entry->refs, 1);
+        if (!catzilla_atomic_load_relaxed(&entry->referenced)) {
+            catzilla_atomic_store_relaxed(&entry->referenced, 1);
         }
-        entry = entry->next;
     }
 
-    uv_rwlock_rdunlock(&cache->cache_lock);
-    return NULL;
+    if (slot >= 0) {
+        catzilla_atomic_store_seq(&cache_reader_epochs[slot], 0);
+    } else {
+        uv_mutex_unlock(&cache->write_lock);
+    }
+    return entry;
 }
 
-int catzilla_static_cache_put(hot_cache_t* cache, const char* file_path,
-                              void* content, size_t size, time_t mtime) {
-    if (!cache || !file_path || !content || size == 0) return -1;
-
-    // Don't cache files that are too large
-    if (size > STATIC_CACHE_MAX_FILE_SIZE) return -1;
+void catzilla_static_cache_release(hot_cache_t* cache, hot_cache_entry_t* entry) {
+    (void)cache;
+    if (entry && catzilla_atomic_fetch_sub(&entry->refs, 1) == 1) {
+        free_entry(entry);
+    }
+}
 
-    uv_rwlock_wrlock(&cache->cache_lock);
+// Insert under the write lock; a restored entry never replaces a cached one
+static int cache_insert(hot_cache_t* cache, const char* file_path, void* content, size_t size,
+                        void* gzipped, size_t gzipped_size, time_t mtime, time_t expires_at,
+                        bool restoring) {
+    uint32_t hash = hash_path(file_path);
+    uint32_t index;
+    if (table_find(cache->table, hash, file_path, &index)) {
+        if (restoring) return -1;
+        unlink_slot(cache, cache->table, index);
+    }
 
     // Check if we need to evict entries to make space
-    size_t required_memory = size + strlen(file_path) + 1 + sizeof(hot_cache_entry_t);
-    while (cache->current_memory_usage + required_memory > cache->max_memory_bytes &&
-           cache->lru_tail) {
-        // Evict least recently used entry
-        hot_cache_entry_t* victim = cache->lru_tail;
-        catzilla_static_cache_remove_unlocked(cache, victim->file_path);
-        catzilla_atomic_fetch_add(&cache->evictions, 1);
+    size_t required_memory = size + strlen(file_path) + 1 + sizeof(hot_cache_entry_t) +
+                             (gzipped ? gzipped_size : 0);
+    while (cache->current_memory_usage + required_memory > cache->max_memory_bytes) {
+        if (!evict_one(cache)) break;
+    }
+    if (reserve_slot(cache) != 0) {
+        reclaim_locked(cache);
+        return -1;
     }
 
     // Create new entry
     hot_cache_entry_t* entry = catzilla_static_alloc(sizeof(hot_cache_entry_t));
     if (!entry) {
-        uv_rwlock_wrunlock(&cache->cache_lock);
+        reclaim_locked(cache);
         return -1;
     }
+    memset(entry, 0, sizeof(hot_cache_entry_t));
 
     // Allocate and copy file path
     entry->file_path = catzilla_static_alloc(strlen(file_path) + 1);
     if (!entry->file_path) {
         catzilla_free(entry);
-        uv_rwlock_wrunlock(&cache->cache_lock);
+        reclaim_locked(cache);
         return -1;
     }
     strcpy(entry->file_path, file_path);
 
     // Set entry data
+    entry->hash = hash;
     entry->file_content = content;  // Take ownership of content
     entry->content_size = size;
-    entry->last_accessed = time(NULL);
-    entry->expires_at = entry->last_accessed + STATIC_CACHE_DEFAULT_TTL;
+    entry->expires_at = expires_at;
     entry->file_mtime = mtime;
-    entry->access_count = 1;
-    entry->is_compressed = false;
-    entry->compressed_content = NULL;
-    entry->compressed_size = 0;
+    entry->is_compressed = gzipped != NULL;
+    entry->compressed_content = gzipped;
+    entry->compressed_size = gzipped ? gzipped_size : 0;
+    entry->memory = required_memory;
+    entry->refs = 1;  // The table's reference
 
     // Generate ETag hash
-    entry->etag_hash = hash_path(file_path) ^ (uint64_t)mtime ^ (uint64_t)size;
-
-    // Add to hash table
-    uint32_t hash = hash_path(file_path);
-    entry->next = cache->buckets[hash];
-    cache->buckets[hash] = entry;
+    entry->etag_hash = hash ^ (uint64_t)mtime ^ (uint64_t)size;
 
-    // Add to LRU list at head
-    lru_add_to_head(cache, entry);
+    // Publish it
+    table_place(cache->table, entry);
 
     // Update cache statistics
     cache->current_memory_usage += required_memory;
     cache->total_entries++;
-
-    uv_rwlock_wrunlock(&cache->cache_lock);
+    reclaim_locked(cache);
     return 0;
 }
 
-static void catzilla_static_cache_remove_unlocked(hot_cache_t* cache, const char* file_path) {
-    if (!cache || !file_path) return;
+int catzilla_static_cache_put(hot_cache_t* cache, const char* file_path,
+                              void* content, size_t size, time_t mtime) {
+    return catzilla_static_cache_put_variant(cache, file_path, content, size, mtime, NULL, 0);
+}
 
-    uint32_t hash = hash_path(file_path);
-    hot_cache_entry_t* entry = cache->buckets[hash];
-    hot_cache_entry_t* prev = NULL;
-
-    while (entry) {
-        if (strcmp(entry->file_path, file_path) == 0) {
-            // Remove from hash table
-            if (prev) {
-                prev->next = entry->next;
-            } else {
-                cache->buckets[hash] = entry->next;
-            }
+int catzilla_static_cache_put_variant(hot_cache_t* cache, const char* file_path,
+                                      void* content, size_t size, time_t mtime,
+                                      void* gzipped, size_t gzipped_size) {
+    if (!cache || !file_path || !content || size == 0) return -1;
 
-            // Remove from LRU list
-            lru_remove(cache, entry);
+    // Don't cache files that are too large
+    if (size > STATIC_CACHE_MAX_FILE_SIZE) return -1;
 
-            // Update memory usage
-            size_t entry_memory = entry->content_size + strlen(entry->file_path) + 1 +
-                                 sizeof(hot_cache_entry_t);
-            if (entry->compressed_content) {
-                entry_memory += entry->compressed_size;
-            }
-            cache->current_memory_usage -= entry_memory;
-            cache->total_entries--;
+    snapshot_fault(cache, hash_path(file_path));
 
-            // Free entry memory
-            catzilla_free(entry->file_content);
-            if (entry->compressed_content) {
-                catzilla_free(entry->compressed_content);
-            }
-            catzilla_free(entry->file_path);
-            catzilla_free(entry);
-            return;
-        }
-        prev = entry;
-        entry = entry->next;
-    }
+    uv_mutex_lock(&cache->write_lock);
+    int rc = cache_insert(cache, file_path, content, size, gzipped, gzipped_size, mtime,
+                          time(NULL) + STATIC_CACHE_DEFAULT_TTL, false);
+    uv_mutex_unlock(&cache->write_lock);
+    return rc;
 }
 
 void catzilla_static_cache_remove(hot_cache_t* cache, const char* file_path) {
     if (!cache || !file_path) return;
 
-    uv_rwlock_wrlock(&cache->cache_lock);
-    catzilla_static_cache_remove_unlocked(cache, file_path);
-    uv_rwlock_wrunlock(&cache->cache_lock);
+    uint32_t hash = hash_path(file_path);
+    snapshot_fault(cache, hash);
+
+    uv_mutex_lock(&cache->write_lock);
+    uint32_t index;
+    if (table_find(cache->table, hash, file_path, &index)) {
+        unlink_slot(cache, cache->table, index);
+    }
+    reclaim_locked(cache);
+    uv_mutex_unlock(&cache->write_lock);
+}
+
+size_t catzilla_static_cache_set_limit(hot_cache_t* cache, size_t max_memory) {
+    if (!cache) return 0;
+
+    uv_mutex_lock(&cache->write_lock);
+    cache->max_memory_bytes = max_memory;
+    size_t evicted = 0;
+    while (cache->current_memory_usage > max_memory && evict_one(cache)) {
+        evicted++;
+    }
+    reclaim_locked(cache);
+    uv_mutex_unlock(&cache->write_lock);
+    return evicted;
 }
 
 void catzilla_static_cache_cleanup(hot_cache_t* cache) {
     if (!cache) return;
 
-    uv_rwlock_wrlock(&cache->cache_lock);
+    uv_mutex_lock(&cache->write_lock);
 
     time_t now = time(NULL);
 
-    // Check all buckets for expired entries
-    for (int i = 0; i < STATIC_CACHE_HASH_BUCKETS; i++) {
-        hot_cache_entry_t* entry = cache->buckets[i];
-        hot_cache_entry_t* prev = NULL;
-
-        while (entry) {
-            hot_cache_entry_t* next = entry->next;
-
-            if (entry->expires_at > 0 && entry->expires_at < now) {
-                // Entry has expired, remove it
-                if (prev) {
-                    prev->next = next;
-                } else {
-                    cache->buckets[i] = next;
-                }
-
-                // Remove from LRU list
-                lru_remove(cache, entry);
-
-                // Update memory usage
-                size_t entry_memory = entry->content_size + strlen(entry->file_path) + 1 +
-                                     sizeof(hot_cache_entry_t);
-                if (entry->compressed_content) {
-                    entry_memory += entry->compressed_size;
-                }
-                cache->current_memory_usage -= entry_memory;
-                cache->total_entries--;
-
-                // Free entry memory
-                catzilla_free(entry->file_content);
-                if (entry->compressed_content) {
-                    catzilla_free(entry->compressed_content);
-                }
-                catzilla_free(entry->file_path);
-                catzilla_free(entry);
-            } else {
-                prev = entry;
-            }
-
-            entry = next;
+    // Check all slots for expired entries
+    hot_cache_table_t* table = cache->table;
+    for (uint32_t i = 0; i < table->capacity; i++) {
+        hot_cache_entry_t* entry = table->slots[i];
+        if (entry && entry != TOMBSTONE && entry->expires_at > 0 && entry->expires_at < now) {
+            unlink_slot(cache, table, i);
         }
     }
 
-    uv_rwlock_wrunlock(&cache->cache_lock);
+    // Also frees what earlier changes left waiting for a grace period
+    reclaim_locked(cache);
+    uv_mutex_unlock(&cache->write_lock);
 }
 
 void catzilla_static_cache_destroy(hot_cache_t* cache) {
-    if (!cache) return;
+    if (!cache || !cache->table) return;
 
     // Remove all entries
-    for (int i = 0; i < STATIC_CACHE_HASH_BUCKETS; i++) {
-        hot_cache_entry_t* entry = cache->buckets[i];
-        while (entry) {
-            hot_cache_entry_t* next = entry->next;
-
-            catzilla_free(entry->file_content);
-            if (entry->compressed_content) {
-                catzilla_free(entry->compressed_content);
-            }
-            catzilla_free(entry->file_path);
-            catzilla_free(entry);
+    hot_cache_table_t* table = cache->table;
+    for (uint32_t i = 0; i < table->capacity; i++) {
+        hot_cache_entry_t* entry = table->slots[i];
+        if (entry && entry != TOMBSTONE) free_entry(entry);
+    }
+    catzilla_free(table);
+    cache->table = NULL;
 
-            entry = next;
-        }
-        cache->buckets[i] = NULL;
+    while (cache->retired_entries) {
+        hot_cache_entry_t* entry = cache->retired_entries;
+        cache->retired_entries = entry->next_retired;
+        free_entry(entry);
+    }
+    while (cache->retired_tables) {
+        hot_cache_table_t* retired = cache->retired_tables;
+        cache->retired_tables = retired->next_retired;
+        catzilla_free(retired);
     }
 
     // Destroy lock
-    uv_rwlock_destroy(&cache->cache_lock);
+    uv_mutex_destroy(&cache->write_lock);
+    catzilla_snapshot_close(cache->snapshot);
+    cache->snapshot = NULL;
+    catzilla_free(cache->snapshot_root);
+    cache->snapshot_root = NULL;
 
-    cache->lru_head = NULL;
-    cache->lru_tail = NULL;
     cache->current_memory_usage = 0;
     cache->total_entries = 0;
 }
+
+int catzilla_static_cache_save_snapshot(hot_cache_t* cache, const char* path) {
+    if (!cache || !path) return -1;
+
+    if (catzilla_snapshot_pending(cache->snapshot)) {
+        catzilla_snapshot_restore_next(cache->snapshot, SIZE_MAX, restore_entry, cache);
+    }
+
+    catzilla_snapshot_writer_t* writer = catzilla_snapshot_writer_open(path, CATZILLA_SNAPSHOT_KIND_STATIC,
+                                                                      STATIC_CACHE_SNAPSHOT_BUCKETS);
+    if (!writer) return -1;
+
+    int rc = 0;
+    time_t now = time(NULL);
+    uv_mutex_lock(&cache->write_lock);
+    hot_cache_table_t* table = cache->table;
+    for (uint32_t i = 0; i < table->capacity && rc == 0; i++) {
+        hot_cache_entry_t* entry = table->slots[i];
+        if (!entry || entry == TOMBSTONE) continue;
+        if (entry->expires_at > 0 && entry->expires_at <= now) continue;
+        catzilla_snapshot_record_t record = {0};
+        record.hash = entry->hash;
+        record.key_len = (uint32_t)strlen(entry->file_path);
+        record.value_size = entry->content_size;
+        record.stored_size = entry->content_size;
+        record.expires_us = (int64_t)(entry->expires_at - now) * 1000000;
+        record.fresh_us = record.expires_us;
+        record.mtime = (int64_t)entry->file_mtime;
+        rc = catzilla_snapshot_writer_add(writer, &record, entry->file_path, entry->file_content);
+    }
+    uv_mutex_unlock(&cache->write_lock);
+
+    if (rc != 0) {
+        catzilla_snapshot_writer_abort(writer);
+        return -1;
+    }
+    return catzilla_snapshot_writer_commit(writer);
+}
+
+int catzilla_static_cache_load_snapshot(hot_cache_t* cache, const char* path,
+                                        const char* root_directory) {
+    if (!cache || !path || !root_directory || catzilla_snapshot_pending(cache->snapshot)) return -1;
+
+    char* root = catzilla_static_alloc(strlen(root_directory) + 1);
+    if (!root) return -1;
+    strcpy(root, root_directory);
+
+    catzilla_snapshot_t* snapshot = catzilla_snapshot_open(path, CATZILLA_SNAPSHOT_KIND_STATIC);
+    if (!snapshot) {
+        catzilla_free(root);
+        return -1;
+    }
+    catzilla_snapshot_close(cache->snapshot);
+    catzilla_free(cache->snapshot_root);
+    cache->snapshot = snapshot;
+    cache->snapshot_root = root;
+    return 0;
+}
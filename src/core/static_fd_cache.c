@@ -0,0 +1,284 @@
+#include "static_server.h"
+#include "http_response.h"
+#include "memory.h"
+#include "logging.h"
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+#include <sys/stat.h>
+#ifndef _WIN32
+#include <unistd.h>
+#else
+#include <io.h>
+#define close _close
+#endif
+
+static uint32_t hash_path(const char* path) {
+    uint32_t hash = 5381;
+    int c;
+    while ((c = *path++)) {
+        hash = ((hash << 5) + hash) + c;
+    }
+    return hash;
+}
+
+static void lru_add_to_head(static_fd_cache_t* cache, static_fd_entry_t* entry) {
+    entry->lru_prev = NULL;
+    entry->lru_next = cache->lru_head;
+    if (cache->lru_head) cache->lru_head->lru_prev = entry;
+    cache->lru_head = entry;
+    if (!cache->lru_tail) cache->lru_tail = entry;
+}
+
+static void lru_remove(static_fd_cache_t* cache, static_fd_entry_t* entry) {
+    if (entry->lru_prev) {
+        entry->lru_prev->lru_next = entry->lru_next;
+    } else {
+        cache->lru_head = entry->lru_next;
+    }
+    if (entry->lru_next) {
+        entry->lru_next->lru_prev = entry->lru_prev;
+    } else {
+        cache->lru_tail = entry->lru_prev;
+    }
+    entry->lru_prev = entry->lru_next = NULL;
+}
+
+static void free_entry(static_fd_entry_t* entry) {
+    if (entry->fd >= 0) close(entry->fd);
+    catzilla_free(entry->path);
+    catzilla_free(entry);
+}
+
+// Take an entry out of the table under the lock; it is closed now, or by
+// the last request still using it
+static void unlink_entry(static_fd_cache_t* cache, static_fd_entry_t* entry) {
+    static_fd_entry_t** link = &cache->buckets[entry->hash % STATIC_FD_CACHE_BUCKETS];
+    while (*link && *link != entry) link = &(*link)->next;
+    if (*link) *link = entry->next;
+    lru_remove(cache, entry);
+    cache->entry_count--;
+
+    if (entry->refs > 0) {
+        entry->stale = true;
+    } else {
+        free_entry(entry);
+    }
+}
+
+int catzilla_static_fd_cache_init(static_fd_cache_t* cache, uint32_t max_entries) {
+    if (!cache || max_entries == 0) return -1;
+
+    memset(cache, 0, sizeof(static_fd_cache_t));
+    cache->max_entries = max_entries;
+    catzilla_atomic_store(&cache->hits, 0);
+    catzilla_atomic_store(&cache->misses, 0);
+    catzilla_atomic_store(&cache->invalidations, 0);
+    return uv_mutex_init(&cache->lock) == 0 ? 0 : -1;
+}
+
+static void on_watch_event(uv_fs_event_t* handle, const char* filename, int events, int status) {
+    (void)events;
+    static_fd_cache_t* cache = (static_fd_cache_t*)handle->data;
+
+    if (status < 0 || !filename) {
+        // Nothing says what changed, so nothing can be trusted
+        catzilla_static_fd_cache_invalidate(cache, cache->watch_root);
+        return;
+    }
+
+    char path[CATZILLA_PATH_MAX];
+    if (snprintf(path, sizeof(path), "%s/%s", cache->watch_root, filename) >= (int)sizeof(path)) {
+        catzilla_static_fd_cache_invalidate(cache, cache->watch_root);
+        return;
+    }
+    catzilla_static_fd_cache_invalidate(cache, path);
+}
+
+int catzilla_static_fd_cache_watch(static_fd_cache_t* cache, uv_loop_t* loop, const char* directory) {
+    if (!cache || !loop || !directory) return UV_EINVAL;
+    if (cache->watching) return 0;
+
+    size_t length = strlen(directory);
+    cache->watch_root = catzilla_static_alloc(length + 1);
+    if (!cache->watch_root) return UV_ENOMEM;
+    memcpy(cache->watch_root, directory, length + 1);
+
+    int rc = uv_fs_event_init(loop, &cache->watch);
+    if (rc != 0) return rc;
+    cache->watch.data = cache;
+
+    // Recursive on macOS and Windows; Linux reports only the directory's own entries
+    rc = uv_fs_event_start(&cache->watch, on_watch_event, directory, UV_FS_EVENT_RECURSIVE);
+    if (rc != 0) {
+        LOG_STATIC_WARN("Cannot watch %s (%s), open files are rechecked every %ds",
+                        directory, uv_strerror(rc), STATIC_FD_CACHE_TTL);
+        uv_close((uv_handle_t*)&cache->watch, NULL);
+        return rc;
+    }
+
+    // The watch must not keep a loop alive on its own
+    uv_unref((uv_handle_t*)&cache->watch);
+    cache->watching = true;
+    return 0;
+}
+
+// Check an entry against the file on disk, under the lock
+static bool entry_current(static_fd_entry_t* entry, time_t now) {
+    if (now - entry->checked_at < STATIC_FD_CACHE_TTL) return true;
+
+    uv_fs_t req;
+    bool same = uv_fs_stat(NULL, &req, entry->path, NULL) == 0 &&
+                req.statbuf.st_ino == entry->inode &&
+                (size_t)req.statbuf.st_size == entry->size &&
+                (time_t)req.statbuf.st_mtim.tv_sec == entry->mtime;
+    uv_fs_req_cleanup(&req);
+    if (same) entry->checked_at = now;
+    return same;
+}
+
+static_fd_entry_t* catzilla_static_fd_cache_acquire(static_fd_cache_t* cache, const char* path) {
+    if (!cache || !path) return NULL;
+
+    uint32_t hash = hash_path(path);
+    time_t now = time(NULL);
+
+    uv_mutex_lock(&cache->lock);
+    static_fd_entry_t* entry = cache->buckets[hash % STATIC_FD_CACHE_BUCKETS];
+    while (entry && (entry->hash != hash || strcmp(entry->path, path) != 0)) {
+        entry = entry->next;
+    }
+
+    if (entry && !entry_current(entry, now)) {
+        unlink_entry(cache, entry);
+        catzilla_atomic_fetch_add(&cache->invalidations, 1);
+        entry = NULL;
+    }
+    if (entry) {
+        entry->refs++;
+        lru_remove(cache, entry);
+        lru_add_to_head(cache, entry);
+    }
+    uv_mutex_unlock(&cache->lock);
+
+    catzilla_atomic_fetch_add(entry ? &cache->hits : &cache->misses, 1);
+    return entry;
+}
+
+static_fd_entry_t* catzilla_static_fd_cache_insert(static_fd_cache_t* cache, const char* path,
+                                                   int fd, const uv_stat_t* stat) {
+    if (!cache || !path || fd < 0 || !stat) return NULL;
+
+    static_fd_entry_t* entry = catzilla_static_alloc(sizeof(static_fd_entry_t));
+    if (!entry) return NULL;
+    memset(entry, 0, sizeof(static_fd_entry_t));
+
+    size_t length = strlen(path);
+    entry->path = catzilla_static_alloc(length + 1);
+    if (!entry->path) {
+        catzilla_free(entry);
+        return NULL;
+    }
+    memcpy(entry->path, path, length + 1);
+
+    entry->hash = hash_path(path);
+    entry->fd = fd;
+    entry->size = (size_t)stat->st_size;
+    entry->mtime = (time_t)stat->st_mtim.tv_sec;
+    entry->inode = stat->st_ino;
+    entry->checked_at = time(NULL);
+    entry->refs = 1;
+
+    // Validators are formatted once here instead of for every response
+    char* etag = catzilla_static_generate_etag(path, entry->mtime, entry->size);
+    if (etag) {
+        strncpy(entry->etag, etag, STATIC_MAX_ETAG_LEN - 1);
+        catzilla_static_free(etag);
+    }
+    catzilla_http_date_format((int64_t)entry->mtime, entry->last_modified);
+
+    uv_mutex_lock(&cache->lock);
+    uint32_t bucket = entry->hash % STATIC_FD_CACHE_BUCKETS;
+
+    // A request that raced this one may have opened the same file
+    for (static_fd_entry_t* other = cache->buckets[bucket]; other; other = other->next) {
+        if (other->hash == entry->hash && strcmp(other->path, path) == 0) {
+            unlink_entry(cache, other);
+            break;
+        }
+    }
+    while (cache->entry_count >= cache->max_entries && cache->lru_tail) {
+        unlink_entry(cache, cache->lru_tail);
+    }
+
+    entry->next = cache->buckets[bucket];
+    cache->buckets[bucket] = entry;
+    lru_add_to_head(cache, entry);
+    cache->entry_count++;
+    uv_mutex_unlock(&cache->lock);
+    return entry;
+}
+
+void catzilla_static_fd_cache_release(static_fd_cache_t* cache, static_fd_entry_t* entry) {
+    if (!cache || !entry) return;
+
+    uv_mutex_lock(&cache->lock);
+    bool drop = --entry->refs == 0 && entry->stale;
+    uv_mutex_unlock(&cache->lock);
+    if (drop) free_entry(entry);
+}
+
+void catzilla_static_fd_cache_invalidate(static_fd_cache_t* cache, const char* path) {
+    if (!cache || !path) return;
+
+    size_t length = strlen(path);
+    uint32_t dropped = 0;
+
+    uv_mutex_lock(&cache->lock);
+    for (int i = 0; i < STATIC_FD_CACHE_BUCKETS; i++) {
+        static_fd_entry_t* entry = cache->buckets[i];
+        while (entry) {
+            static_fd_entry_t* next = entry->next;
+            // The path itself, or anything under it when it is a directory
+            if (strncmp(entry->path, path, length) == 0 &&
+                (entry->path[length] == '\0' || entry->path[length] == '/')) {
+                unlink_entry(cache, entry);
+                dropped++;
+            }
+            entry = next;
+        }
+    }
+    uv_mutex_unlock(&cache->lock);
+
+    if (dropped > 0) {
+        catzilla_atomic_fetch_add(&cache->invalidations, dropped);
+        LOG_STATIC_DEBUG("fd cache dropped %u entries under %s", dropped, path);
+    }
+}
+
+static void on_watch_closed(uv_handle_t* handle) {
+    catzilla_free(handle->data);
+}
+
+void catzilla_static_fd_cache_destroy(static_fd_cache_t* cache) {
+    if (!cache) return;
+
+    uv_mutex_lock(&cache->lock);
+    for (int i = 0; i < STATIC_FD_CACHE_BUCKETS; i++) {
+        static_fd_entry_t* entry = cache->buckets[i];
+        while (entry) {
+            static_fd_entry_t* next = entry->next;
+            unlink_entry(cache, entry);
+            entry = next;
+        }
+    }
+    uv_mutex_unlock(&cache->lock);
+    uv_mutex_destroy(&cache->lock);
+    catzilla_free(cache->watch_root);
+
+    if (cache->watching && !uv_is_closing((uv_handle_t*)&cache->watch)) {
+        uv_close((uv_handle_t*)&cache->watch, on_watch_closed);
+        return;
+    }
+    catzilla_free(cache);
+}
@@ -1,26 +1,11 @@
 #include "static_server.h"
 #include "memory.h"
 #include "logging.h"  // Add logging header
+#include "http_response.h"
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
 
-// HTTP status text mapping
-static const char* get_status_text(int status_code) {
-    switch (status_code) {
-        case 200: return "OK";
-        case 206: return "Partial Content";
-        case 304: return "Not Modified";
-        case 400: return "Bad Request";
-        case 403: return "Forbidden";
-        case 404: return "Not Found";
-        case 413: return "Payload Too Large";
-        case 416: return "Range Not Satisfiable";
-        case 500: return "Internal Server Error";
-        default: return "Unknown";
-    }
-}
-
 // Build HTTP response headers
 static char* build_http_response(int status_code,
                                 static_http_headers_t* headers,
@@ -29,7 +14,7 @@ static char* build_http_response(int status_code,
                                 size_t* total_len_out) {
     char status_line[128];
     snprintf(status_line, sizeof(status_line), "HTTP/1.1 %d %s\r\n",
-             status_code, get_status_text(status_code));
+             status_code, catzilla_http_status_text(status_code));
 
     // Calculate approximate header size
     size_t header_size = strlen(status_line) + 512; // Conservative estimate
@@ -44,17 +29,31 @@ static char* build_http_response(int status_code,
     // Add status line
     offset += snprintf(response + offset, total_size - offset, "%s", status_line);
 
+    // Add cached Date header
+    memcpy(response + offset, catzilla_date_header(), CATZILLA_DATE_HEADER_LEN);
+    offset += CATZILLA_DATE_HEADER_LEN;
+
     // Add content type
     if (headers && headers->content_type[0]) {
         offset += snprintf(response + offset, total_size - offset,
                           "Content-Type: %s\r\n", headers->content_type);
     }
 
-    // Add content length
-    if (headers && headers->content_length[0]) {
+    // Add content coding, and which request header chose it
+    if (headers && headers->content_encoding[0]) {
+        offset += snprintf(response + offset, total_size - offset,
+                          "Content-Encoding: %s\r\n", headers->content_encoding);
+    }
+    if (headers && headers->vary[0]) {
+        offset += snprintf(response + offset, total_size - offset,
+                          "Vary: %s\r\n", headers->vary);
+    }
+
+    // Add content length; a 304 has none, it describes the stored response
+    if (status_code != 304 && headers && headers->content_length[0]) {
         offset += snprintf(response + offset, total_size - offset,
                           "Content-Length: %s\r\n", headers->content_length);
-    } else {
+    } else if (status_code != 304) {
         offset += snprintf(response + offset, total_size - offset,
                           "Content-Length: %zu\r\n", body_len);
     }
@@ -123,12 +122,23 @@ static char* build_http_response(int status_code,
     return response;
 }
 
+char* catzilla_static_build_response_head(int status_code,
+                                          static_http_headers_t* headers,
+                                          size_t* length_out) {
+    if (!headers || !length_out) return NULL;
+    return build_http_response(status_code, headers, NULL, 0, length_out);
+}
+
 // Write callback for libuv
 static void on_write_complete(uv_write_t* req, int status) {
+    uv_stream_t* client = req->handle;
     if (req->data) {
         catzilla_response_free(req->data);  // Free response buffer
     }
     catzilla_response_free(req);  // Free write request
+
+    // Let the connection continue with pipelined requests
+    catzilla_server_response_complete(client);
 }
 
 int catzilla_static_send_file_response(uv_stream_t* client,
@@ -188,7 +198,34 @@ int catzilla_static_send_file_response(uv_stream_t* client,
     write_req->data = response;  // Store response buffer for cleanup
 
     uv_buf_t buf = uv_buf_init(response, response_len);
-    int result = uv_write(write_req, client, &buf, 1, on_write_complete);
+    int result = catzilla_server_write(write_req, client, &buf, 1, on_write_complete);
+
+    if (result != 0) {
+        catzilla_response_free(response);
+        catzilla_response_free(write_req);
+        return result;
+    }
+
+    return 0;
+}
+
+int catzilla_static_send_not_modified(uv_stream_t* client, static_http_headers_t* headers) {
+    if (!client || !headers) return -1;
+
+    size_t response_len;
+    char* response = build_http_response(304, headers, NULL, 0, &response_len);
+    if (!response) return -1;
+
+    uv_write_t* write_req = catzilla_response_alloc(sizeof(uv_write_t));
+    if (!write_req) {
+        catzilla_response_free(response);
+        return -1;
+    }
+
+    write_req->data = response;  // Store response buffer for cleanup
+
+    uv_buf_t buf = uv_buf_init(response, response_len);
+    int result = catzilla_server_write(write_req, client, &buf, 1, on_write_complete);
 
     if (result != 0) {
         catzilla_response_free(response);
@@ -204,7 +241,7 @@ int catzilla_static_send_error_response(uv_stream_t* client,
                                         const char* message) {
     if (!client) return -1;
 
-    const char* default_message = get_status_text(status_code);
+    const char* default_message = catzilla_http_status_text(status_code);
     if (!message) message = default_message;
 
     // Create simple HTML error page
@@ -243,7 +280,7 @@ int catzilla_static_send_error_response(uv_stream_t* client,
     write_req->data = response;  // Store response buffer for cleanup
 
     uv_buf_t buf = uv_buf_init(response, response_len);
-    int result = uv_write(write_req, client, &buf, 1, on_write_complete);
+    int result = catzilla_server_write(write_req, client, &buf, 1, on_write_complete);
 
     if (result != 0) {
         catzilla_response_free(response);
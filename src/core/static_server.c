@@ -2,27 +2,53 @@
 #include "platform_compat.h"
 #include "memory.h"
 #include "logging.h"
+#include "http_cache.h"
+#include "http_response.h"
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/stat.h>
 #ifndef _WIN32
 #include <unistd.h>
+#include <fcntl.h>
 #endif
 #include <errno.h>
 
+// Bodies of large files go from the page cache to the socket with sendfile(2)
+#if defined(__linux__)
+#include <sys/sendfile.h>
+#define STATIC_HAS_SENDFILE 1
+#elif defined(__APPLE__)
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#define STATIC_HAS_SENDFILE 1
+#endif
+
 // Forward declarations for internal functions
 static void on_file_stat(uv_fs_t* req);
 static void on_file_open(uv_fs_t* req);
 static void on_file_fstat(uv_fs_t* req);
 static void on_file_read(uv_fs_t* req);
-static void on_sendfile_complete(uv_fs_t* req);
+static void read_whole_file(static_file_context_t* ctx, size_t file_size);
+static void serve_open_file(static_file_context_t* ctx, size_t file_size, time_t mtime);
+static void release_file(static_file_context_t* ctx);
+static bool answer_not_modified(static_file_context_t* ctx, time_t mtime, size_t file_size);
+#ifdef STATIC_HAS_SENDFILE
+static void start_sendfile(static_file_context_t* ctx, size_t file_size);
+static void on_sendfile_complete(uv_work_t* req, int status);
+#endif
+static void on_uring_file_loaded(void* user_data, catzilla_static_uring_result_t* result);
+static int start_file_load(static_file_context_t* ctx);
+static int start_file_stat(static_file_context_t* ctx);
+static void use_index_file(static_file_context_t* ctx, const char* index_path);
+static void use_precompressed_sibling(static_file_context_t* ctx);
+static void send_loaded_file(static_file_context_t* ctx, void* file_data, size_t bytes_read);
 static void cache_cleanup_timer_cb(uv_timer_t* timer);
-static uint32_t hash_path(const char* path);
 static int catzilla_static_serve_cached_file(static_file_context_t* ctx);
+static uv_loop_t* static_ctx_loop(static_file_context_t* ctx);
 
 // External function declarations
-extern void catzilla_static_cache_remove_unlocked(hot_cache_t* cache, const char* file_path);
 extern int catzilla_static_send_cached_response(uv_stream_t* client, hot_cache_entry_t* cache_entry);
 
 // Default MIME type mappings
@@ -70,6 +96,7 @@ int catzilla_static_server_init(catzilla_static_server_t* server,
     catzilla_atomic_store(&server->cache_hits, 0);
     catzilla_atomic_store(&server->cache_misses, 0);
     catzilla_atomic_store(&server->sendfile_operations, 0);
+    catzilla_atomic_store(&server->uring_operations, 0);
 
     // Initialize cache if enabled
     if (config->enable_hot_cache) {
@@ -97,6 +124,20 @@ int catzilla_static_server_init(catzilla_static_server_t* server,
         server->cache = NULL;
     }
 
+    // Open files are kept for the requests the hot cache does not answer
+    server->fd_cache = NULL;
+    if (config->enable_fd_cache) {
+        server->fd_cache = catzilla_static_alloc(sizeof(static_fd_cache_t));
+        if (server->fd_cache &&
+            catzilla_static_fd_cache_init(server->fd_cache, STATIC_FD_CACHE_MAX_ENTRIES) != 0) {
+            catzilla_free(server->fd_cache);
+            server->fd_cache = NULL;
+        }
+        if (!server->fd_cache) {
+            LOG_STATIC_WARN("fd cache unavailable, files are opened for every request");
+        }
+    }
+
     // Initialize security configuration
     server->security = catzilla_static_alloc(sizeof(static_security_config_t));
     if (!server->security) {
@@ -104,6 +145,7 @@ int catzilla_static_server_init(catzilla_static_server_t* server,
             catzilla_static_cache_cleanup(server->cache);
             catzilla_free(server->cache);
         }
+        catzilla_static_fd_cache_destroy(server->fd_cache);
         return -1;
     }
 
@@ -125,10 +167,16 @@ void catzilla_static_server_cleanup(catzilla_static_server_t* server) {
     if (server->cache) {
         uv_timer_stop(&server->cache_cleanup_timer);
         uv_close((uv_handle_t*)&server->cache_cleanup_timer, NULL);
-        catzilla_static_cache_cleanup(server->cache);
+        catzilla_static_cache_destroy(server->cache);
         catzilla_free(server->cache);
     }
 
+    // Closes the files still held; the cache itself is freed by the call
+    if (server->fd_cache) {
+        catzilla_static_fd_cache_destroy(server->fd_cache);
+        server->fd_cache = NULL;
+    }
+
     // Cleanup security config
     if (server->security) {
         catzilla_free(server->security);
@@ -188,6 +236,12 @@ int catzilla_server_mount_static(catzilla_server_t* server,
         return -1;
     }
 
+    // Files changing under the mount drop their open descriptors
+    if (mount->static_server->fd_cache) {
+        catzilla_static_fd_cache_watch(mount->static_server->fd_cache, config->loop,
+                                       mount->directory_path);
+    }
+
     // Add to server's mount list (we need to add static_mounts to server structure)
     mount->next = server->static_mounts;
     server->static_mounts = mount;
@@ -267,6 +321,17 @@ int catzilla_static_serve_file_async(catzilla_server_t* server,
     ctx->file_size = 0;         // Initialize file size
     ctx->is_head_request = (strcmp(request->method, "HEAD") == 0);
     ctx->is_range_request = false;
+    ctx->serving_index = false;
+    ctx->range_header[0] = '\0';
+    ctx->sendfile_ok = false;
+    ctx->socket_fd = -1;
+    ctx->socket_poll_active = false;
+    ctx->head = NULL;
+    catzilla_compression_parse_accept_encoding(NULL, &ctx->accept_encoding);
+    ctx->content_encoding = 0;
+    ctx->if_none_match[0] = '\0';
+    ctx->fd_entry = NULL;
+    ctx->file_mtime = 0;
 
     // Copy relative path
     strncpy(ctx->relative_path, relative_path, CATZILLA_PATH_MAX - 1);
@@ -301,8 +366,7 @@ int catzilla_static_serve_file_async(catzilla_server_t* server,
     }
 
     // Start async file operations
-    ctx->fs_req.data = ctx;
-    return uv_fs_stat(server->loop, &ctx->fs_req, ctx->full_file_path, on_file_stat);
+    return start_file_load(ctx);
 }
 
 int catzilla_static_serve_file_with_client(catzilla_server_t* server,
@@ -336,6 +400,17 @@ int catzilla_static_serve_file_with_client(catzilla_server_t* server,
     ctx->file_size = 0;         // Initialize file size
     ctx->is_head_request = (strcmp(request->method, "HEAD") == 0);
     ctx->is_range_request = false;
+    ctx->serving_index = false;
+    ctx->range_header[0] = '\0';
+    ctx->sendfile_ok = false;
+    ctx->socket_fd = -1;
+    ctx->socket_poll_active = false;
+    ctx->head = NULL;
+    catzilla_compression_parse_accept_encoding(NULL, &ctx->accept_encoding);
+    ctx->content_encoding = 0;
+    ctx->if_none_match[0] = '\0';
+    ctx->fd_entry = NULL;
+    ctx->file_mtime = 0;
 
     // Copy relative path
     strncpy(ctx->relative_path, relative_path, CATZILLA_PATH_MAX - 1);
@@ -357,8 +432,38 @@ int catzilla_static_serve_file_with_client(catzilla_server_t* server,
 
     LOG_STATIC_DEBUG("Path validation passed for: '%s'", ctx->full_file_path);
 
-    // Check cache first if enabled
-    if (mount->static_server->cache) {
+#ifdef STATIC_HAS_SENDFILE
+    // Bodies go from the file to the socket unless TLS has to encrypt them here
+    ctx->sendfile_ok = mount->static_server->config.use_sendfile &&
+                       catzilla_server_can_write_raw(client);
+#endif
+    if (mount->static_server->config.enable_range_requests) {
+        size_t range_len = 0;
+        const char* range = catzilla_header_set_get_known(&request->headers, CATZILLA_HDR_RANGE,
+                                                          &range_len);
+        if (range && range_len < sizeof(ctx->range_header)) {
+            memcpy(ctx->range_header, range, range_len);
+            ctx->range_header[range_len] = '\0';
+        }
+    }
+    if (mount->static_server->config.enable_compression) {
+        catzilla_compression_parse_accept_encoding(
+            catzilla_header_set_get_known(&request->headers, CATZILLA_HDR_ACCEPT_ENCODING, NULL),
+            &ctx->accept_encoding);
+    }
+    if (mount->static_server->config.enable_etags) {
+        size_t inm_len = 0;
+        const char* inm = catzilla_header_set_get_known(&request->headers, CATZILLA_HDR_IF_NONE_MATCH,
+                                                        &inm_len);
+        if (inm && inm_len < sizeof(ctx->if_none_match)) {
+            memcpy(ctx->if_none_match, inm, inm_len);
+            ctx->if_none_match[inm_len] = '\0';
+        }
+    }
+
+    // Check cache first if enabled; cached files are always sent whole, so
+    // ranges that can be sent from the file skip it
+    if (mount->static_server->cache && !(ctx->sendfile_ok && ctx->range_header[0])) {
         LOG_STATIC_DEBUG("Checking cache for file: '%s'", ctx->relative_path);
         ctx->cache_entry = catzilla_static_cache_get(mount->static_server->cache,
                                                      ctx->relative_path);
@@ -376,11 +481,7 @@ int catzilla_static_serve_file_with_client(catzilla_server_t* server,
     }
 
     // Start async file operations
-    LOG_STATIC_DEBUG("Starting async file stat for: '%s'", ctx->full_file_path);
-    ctx->fs_req.data = ctx;
-    int result = uv_fs_stat(server->loop, &ctx->fs_req, ctx->full_file_path, on_file_stat);
-    LOG_STATIC_DEBUG("uv_fs_stat returned: %d", result);
-    return result;
+    return start_file_load(ctx);
 }
 
 // Static file serving function (synchronous version for compatibility)
@@ -410,6 +511,203 @@ int catzilla_static_serve_file_from_context(static_file_context_t* ctx) {
 
 // Internal callback functions
 
+// File operations run on the loop owning the client connection, which in
+// SO_REUSEPORT worker mode is not necessarily the loop the mount was created on
+static uv_loop_t* static_ctx_loop(static_file_context_t* ctx) {
+    return ctx->client ? ctx->client->loop : ctx->mount->static_server->loop;
+}
+
+// Load the file through io_uring when the mount asks for it and the kernel
+// allows it, otherwise through the libuv threadpool
+static int start_file_load(static_file_context_t* ctx) {
+    catzilla_static_server_t* static_server = ctx->mount->static_server;
+    use_precompressed_sibling(ctx);
+
+    // A file kept open is served without stat, open or fstat
+    if (static_server->fd_cache) {
+        static_fd_entry_t* entry = catzilla_static_fd_cache_acquire(static_server->fd_cache,
+                                                                    ctx->full_file_path);
+        if (entry) {
+            ctx->fd_entry = entry;
+            ctx->file_descriptor = entry->fd;
+            serve_open_file(ctx, entry->size, entry->mtime);
+            return 0;
+        }
+    }
+
+    // Ranges sent from the file never need it loaded
+    if (static_server->config.use_io_uring && !(ctx->sendfile_ok && ctx->range_header[0])) {
+        // Files big enough for sendfile come back as UV_EFBIG and take the stat path
+        size_t max_size = static_server->security->max_file_size;
+        if (ctx->sendfile_ok && (max_size == 0 || max_size >= STATIC_SENDFILE_MIN_SIZE)) {
+            max_size = STATIC_SENDFILE_MIN_SIZE - 1;
+        }
+        int rc = catzilla_static_uring_read_file(static_ctx_loop(ctx), ctx->full_file_path,
+                                                 max_size, on_uring_file_loaded, ctx);
+        if (rc == 0) return 0;
+        LOG_STATIC_DEBUG("io_uring read not queued (%s), using uv_fs", uv_strerror(rc));
+    }
+
+    return start_file_stat(ctx);
+}
+
+static int start_file_stat(static_file_context_t* ctx) {
+    LOG_STATIC_DEBUG("Starting async file stat for: '%s'", ctx->full_file_path);
+    ctx->fs_req.data = ctx;
+    int result = uv_fs_stat(static_ctx_loop(ctx), &ctx->fs_req, ctx->full_file_path, on_file_stat);
+    LOG_STATIC_DEBUG("uv_fs_stat returned: %d", result);
+    return result;
+}
+
+// Continue a directory request with the directory's index file
+static void use_index_file(static_file_context_t* ctx, const char* index_path) {
+    strncpy(ctx->full_file_path, index_path, CATZILLA_PATH_MAX - 1);
+    ctx->full_file_path[CATZILLA_PATH_MAX - 1] = '\0';
+
+    snprintf(ctx->relative_path, CATZILLA_PATH_MAX, "%s/index.html",
+            strcmp(ctx->relative_path, "/") == 0 ? "" : ctx->relative_path);
+    ctx->serving_index = true;
+}
+
+static const char* encoding_name(int encoding) {
+    return encoding == STATIC_ENCODING_BR ? "br" : "gzip";
+}
+
+// Pick one of the codings a file can be sent in, by the same policy as
+// dynamic responses. Nothing has to be compressed per request here, so br
+// is preferred at every size.
+static int select_encoding(static_file_context_t* ctx, int candidates, size_t size) {
+    return catzilla_compression_select(&ctx->accept_encoding, candidates, size, SIZE_MAX);
+}
+
+// Vary on Accept-Encoding wherever the encoding served depends on it
+static bool response_varies(static_file_context_t* ctx, const char* relative_path) {
+    return ctx->mount->static_server->config.enable_compression &&
+           catzilla_static_is_compressible(relative_path);
+}
+
+// Content type of the file being sent; a precompressed sibling has the type
+// of the file it encodes
+static const char* ctx_content_type(static_file_context_t* ctx) {
+    return catzilla_static_get_content_type(ctx->content_encoding ? ctx->relative_path
+                                                                  : ctx->full_file_path);
+}
+
+// Send file.br or file.gz instead of the file when the client accepts that
+// coding and the sibling is not older than the file; of several, the one
+// negotiated wins. Ranges are always served from the file itself.
+static void use_precompressed_sibling(static_file_context_t* ctx) {
+    static const struct {
+        int encoding;
+        const char* suffix;
+    } siblings[] = {
+        {STATIC_ENCODING_BR, ".br"},
+        {STATIC_ENCODING_GZIP, ".gz"},
+    };
+    const int all_siblings = STATIC_ENCODING_BR | STATIC_ENCODING_GZIP;
+
+    if (ctx->content_encoding || ctx->range_header[0] ||
+        select_encoding(ctx, all_siblings, 0) == CATZILLA_ENCODING_IDENTITY ||
+        !catzilla_static_is_compressible(ctx->relative_path)) {
+        return;
+    }
+
+    uv_fs_t stat_req;
+    if (uv_fs_stat(NULL, &stat_req, ctx->full_file_path, NULL) != 0 ||
+        !S_ISREG(stat_req.statbuf.st_mode)) {
+        uv_fs_req_cleanup(&stat_req);
+        return;
+    }
+    long file_mtime = stat_req.statbuf.st_mtim.tv_sec;
+    size_t file_size = (size_t)stat_req.statbuf.st_size;
+    uv_fs_req_cleanup(&stat_req);
+
+    int usable = 0;
+    char sibling_paths[sizeof(siblings) / sizeof(siblings[0])][CATZILLA_PATH_MAX];
+    for (size_t i = 0; i < sizeof(siblings) / sizeof(siblings[0]); i++) {
+        if (select_encoding(ctx, siblings[i].encoding, file_size) == CATZILLA_ENCODING_IDENTITY) continue;
+
+        if (snprintf(sibling_paths[i], sizeof(sibling_paths[i]), "%s%s", ctx->full_file_path,
+                     siblings[i].suffix) >= (int)sizeof(sibling_paths[i])) {
+            continue;
+        }
+        if (uv_fs_stat(NULL, &stat_req, sibling_paths[i], NULL) == 0 &&
+            S_ISREG(stat_req.statbuf.st_mode) && stat_req.statbuf.st_mtim.tv_sec >= file_mtime) {
+            usable |= siblings[i].encoding;
+        }
+        uv_fs_req_cleanup(&stat_req);
+    }
+
+    int encoding = select_encoding(ctx, usable, file_size);
+    for (size_t i = 0; i < sizeof(siblings) / sizeof(siblings[0]); i++) {
+        if (siblings[i].encoding != encoding) continue;
+        LOG_STATIC_DEBUG("Serving precompressed sibling: %s", sibling_paths[i]);
+        memcpy(ctx->full_file_path, sibling_paths[i], sizeof(sibling_paths[i]));
+        ctx->content_encoding = encoding;
+        return;
+    }
+}
+
+static void on_uring_file_loaded(void* user_data, catzilla_static_uring_result_t* result) {
+    static_file_context_t* ctx = (static_file_context_t*)user_data;
+
+    if (result->status == UV_EISDIR && !ctx->serving_index) {
+        char index_path[CATZILLA_PATH_MAX];
+        snprintf(index_path, sizeof(index_path), "%s/index.html", ctx->full_file_path);
+        LOG_STATIC_DEBUG("Path is a directory, trying index file: %s", index_path);
+        use_index_file(ctx, index_path);
+        if (start_file_load(ctx) != 0) {
+            catzilla_static_send_error_response(ctx->client, 500, "Internal Server Error");
+            catzilla_static_free(ctx);
+        }
+        return;
+    }
+
+    if (result->status == UV_EFBIG && ctx->sendfile_ok) {
+        // Too big to buffer: stat and open it for sendfile instead
+        if (start_file_stat(ctx) != 0) {
+            catzilla_static_send_error_response(ctx->client, 500, "Internal Server Error");
+            catzilla_static_free(ctx);
+        }
+        return;
+    }
+
+    if (result->status != 0) {
+        LOG_STATIC_WARN("io_uring file load failed: %s (%s)",
+                        ctx->full_file_path, uv_strerror(result->status));
+        if (ctx->serving_index && (result->status == UV_ENOENT || result->status == UV_EISDIR)) {
+            // Directory without an index file
+            catzilla_static_send_error_response(ctx->client, 403, "Forbidden");
+        } else if (result->status == UV_ENOENT || result->status == UV_ENOTDIR) {
+            catzilla_static_send_error_response(ctx->client, 404, "Not Found");
+        } else if (result->status == UV_EFBIG) {
+            catzilla_static_send_error_response(ctx->client, 413, "Payload Too Large");
+        } else {
+            catzilla_static_send_error_response(ctx->client, 500, "Internal Server Error");
+        }
+        catzilla_static_free(ctx);
+        return;
+    }
+
+    if (!catzilla_static_check_extension(ctx->full_file_path,
+                                         ctx->mount->static_server->security)) {
+        LOG_STATIC_WARN("Extension not allowed for file: %s", ctx->full_file_path);
+        catzilla_static_send_error_response(ctx->client, 403, "Forbidden");
+        catzilla_static_free(result->data);
+        catzilla_static_free(ctx);
+        return;
+    }
+
+    catzilla_atomic_fetch_add(&ctx->mount->static_server->uring_operations, 1);
+    ctx->file_mtime = result->mtime;
+    if (ctx->if_none_match[0] && answer_not_modified(ctx, result->mtime, result->size)) {
+        catzilla_static_free(result->data);
+        catzilla_static_free(ctx);
+        return;
+    }
+    send_loaded_file(ctx, result->data, result->size);
+}
+
 static void on_file_stat(uv_fs_t* req) {
     static_file_context_t* ctx = (static_file_context_t*)req->data;
 
@@ -457,19 +755,14 @@ static void on_file_stat(uv_fs_t* req) {
 
         uv_fs_req_cleanup(&index_stat_req);
 
-        // Update context to point to index.html
-        strncpy(ctx->full_file_path, index_path, CATZILLA_PATH_MAX - 1);
-        ctx->full_file_path[CATZILLA_PATH_MAX - 1] = '\0';
-
-        // Update relative path too
-        snprintf(ctx->relative_path, CATZILLA_PATH_MAX, "%s/index.html",
-                strcmp(ctx->relative_path, "/") == 0 ? "" : ctx->relative_path);
+        // Update context (and relative path) to point to index.html
+        use_index_file(ctx, index_path);
 
         uv_fs_req_cleanup(req);
 
         // Start fresh stat for index.html
         LOG_STATIC_DEBUG("Starting stat for index file: %s", ctx->full_file_path);
-        int stat_result = uv_fs_stat(ctx->mount->static_server->loop, &ctx->fs_req,
+        int stat_result = uv_fs_stat(static_ctx_loop(ctx), &ctx->fs_req,
                                     ctx->full_file_path, on_file_stat);
         LOG_STATIC_DEBUG("uv_fs_stat for index returned: %d", stat_result);
         return;
@@ -503,7 +796,7 @@ static void on_file_stat(uv_fs_t* req) {
 
     // Open file for reading
     LOG_STATIC_DEBUG("Starting async file open for: %s", ctx->full_file_path);
-    int open_result = uv_fs_open(ctx->mount->static_server->loop, &ctx->fs_req,
+    int open_result = uv_fs_open(static_ctx_loop(ctx), &ctx->fs_req,
                                 ctx->full_file_path, O_RDONLY, 0, on_file_open);
     LOG_STATIC_DEBUG("uv_fs_open returned: %d", open_result);
 }
@@ -531,7 +824,7 @@ static void on_file_open(uv_fs_t* req) {
 
     // Get file size for reading
     LOG_STATIC_DEBUG("Starting file fstat for fd=%d", ctx->file_descriptor);
-    int fstat_result = uv_fs_fstat(ctx->mount->static_server->loop, &ctx->fs_req,
+    int fstat_result = uv_fs_fstat(static_ctx_loop(ctx), &ctx->fs_req,
                                    ctx->file_descriptor, on_file_fstat);
     LOG_STATIC_DEBUG("uv_fs_fstat returned: %d", fstat_result);
 }
@@ -553,11 +846,116 @@ static void on_file_fstat(uv_fs_t* req) {
 
     uv_stat_t* stat = &req->statbuf;
     size_t file_size = stat->st_size;
+    time_t mtime = (time_t)stat->st_mtim.tv_sec;
     LOG_STATIC_DEBUG("File fstat success: file_size=%zu, fd=%d",
                      file_size, ctx->file_descriptor);
 
+    // The next request for the file finds it open
+    if (ctx->mount->static_server->fd_cache) {
+        ctx->fd_entry = catzilla_static_fd_cache_insert(ctx->mount->static_server->fd_cache,
+                                                        ctx->full_file_path,
+                                                        ctx->file_descriptor, stat);
+    }
+
     uv_fs_req_cleanup(req);
 
+    serve_open_file(ctx, file_size, mtime);
+}
+
+// Answer from an open file: 304 when the client holds the current version,
+// otherwise the body through sendfile when it can go there, or read into memory
+static void serve_open_file(static_file_context_t* ctx, size_t file_size, time_t mtime) {
+    ctx->file_mtime = mtime;
+    if (ctx->if_none_match[0] && answer_not_modified(ctx, mtime, file_size)) {
+        release_file(ctx);
+        catzilla_static_free(ctx);
+        return;
+    }
+
+#ifdef STATIC_HAS_SENDFILE
+    if (ctx->sendfile_ok && (file_size >= STATIC_SENDFILE_MIN_SIZE || ctx->range_header[0])) {
+        start_sendfile(ctx, file_size);
+        return;
+    }
+#endif
+
+    read_whole_file(ctx, file_size);
+}
+
+// Give the descriptor back to the fd cache, or close it
+static void release_file(static_file_context_t* ctx) {
+    if (ctx->fd_entry) {
+        catzilla_static_fd_cache_release(ctx->mount->static_server->fd_cache, ctx->fd_entry);
+        ctx->fd_entry = NULL;
+    } else if (ctx->file_descriptor >= 0) {
+        uv_fs_t close_req;
+        uv_fs_close(NULL, &close_req, ctx->file_descriptor, NULL);
+        uv_fs_req_cleanup(&close_req);
+    }
+    ctx->file_descriptor = -1;
+}
+
+// ETag and Last-Modified of the file being served; kept open, it has them
+// formatted already
+static void set_validators(static_file_context_t* ctx, time_t mtime, size_t file_size,
+                           static_http_headers_t* headers) {
+    static_server_config_t* config = &ctx->mount->static_server->config;
+    static_fd_entry_t* entry = ctx->fd_entry;
+
+    if (config->enable_etags) {
+        if (entry) {
+            strcpy(headers->etag, entry->etag);
+        } else {
+            char* etag = catzilla_static_generate_etag(ctx->full_file_path, mtime, file_size);
+            if (etag) {
+                strncpy(headers->etag, etag, STATIC_MAX_ETAG_LEN - 1);
+                catzilla_static_free(etag);
+            }
+        }
+    }
+    if (config->enable_last_modified) {
+        if (entry) {
+            strcpy(headers->last_modified, entry->last_modified);
+        } else {
+            catzilla_http_date_format((int64_t)mtime, headers->last_modified);
+        }
+    }
+}
+
+static bool if_none_match_hits(static_file_context_t* ctx, const char* etag) {
+    char quoted[STATIC_MAX_ETAG_LEN + 8];
+    int len = snprintf(quoted, sizeof(quoted), "\"%s\"", etag);
+    return catzilla_http_etag_matches(ctx->if_none_match, strlen(ctx->if_none_match),
+                                      quoted, (size_t)len);
+}
+
+// Send 304 if If-None-Match holds the file's ETag, or that of its gzip variant
+static bool answer_not_modified(static_file_context_t* ctx, time_t mtime, size_t file_size) {
+    static_http_headers_t headers;
+    memset(&headers, 0, sizeof(headers));
+    set_validators(ctx, mtime, file_size, &headers);
+    if (!headers.etag[0]) return false;
+
+    bool varies = response_varies(ctx, ctx->relative_path);
+    if (!if_none_match_hits(ctx, headers.etag)) {
+        if (!varies) return false;
+        size_t len = strlen(headers.etag);
+        snprintf(headers.etag + len, STATIC_MAX_ETAG_LEN - len, "-gzip");
+        if (!if_none_match_hits(ctx, headers.etag)) return false;
+    }
+    if (varies) {
+        strcpy(headers.vary, "Accept-Encoding");
+    }
+
+    LOG_STATIC_DEBUG("Not modified: %s", ctx->full_file_path);
+    if (catzilla_static_send_not_modified(ctx->client, &headers) == 0) {
+        catzilla_atomic_fetch_add(&ctx->mount->static_server->requests_served, 1);
+    }
+    return true;
+}
+
+// Read the whole file into memory, to be sent (and cached) from there
+static void read_whole_file(static_file_context_t* ctx, size_t file_size) {
     // Allocate buffer for file content and store in context
     LOG_STATIC_DEBUG("Allocating buffer for file content: %zu bytes", file_size);
     void* buffer = catzilla_static_alloc(file_size);
@@ -582,7 +980,7 @@ static void on_file_fstat(uv_fs_t* req) {
 
     // Initialize the read request and set context
     ctx->read_req.data = ctx;
-    int read_result = uv_fs_read(ctx->mount->static_server->loop, &ctx->read_req,
+    int read_result = uv_fs_read(static_ctx_loop(ctx), &ctx->read_req,
                                 ctx->file_descriptor, &buf, 1, 0, on_file_read);
     LOG_STATIC_DEBUG("uv_fs_read returned: %d", read_result);
 }
@@ -597,6 +995,8 @@ static void on_file_read(uv_fs_t* req) {
         LOG_STATIC_ERROR("File read failed: error=%d, fd=%d",
                         (int)req->result, ctx->file_descriptor);
         catzilla_static_send_error_response(ctx->client, 500, "Internal Server Error");
+        release_file(ctx);
+        catzilla_static_free(ctx->file_buffer);
         catzilla_static_free(ctx);
         uv_fs_req_cleanup(req);
         return;
@@ -617,6 +1017,10 @@ static void on_file_read(uv_fs_t* req) {
         LOG_STATIC_ERROR("File read size mismatch: expected=%zu, actual=%zu",
                         expected_size, bytes_read);
         catzilla_static_send_error_response(ctx->client, 500, "Internal Server Error");
+        // The file changed size under an open descriptor
+        catzilla_static_fd_cache_invalidate(ctx->mount->static_server->fd_cache,
+                                            ctx->full_file_path);
+        release_file(ctx);
         catzilla_static_free(file_data);
         catzilla_static_free(ctx);
         uv_fs_req_cleanup(req);
@@ -630,9 +1034,8 @@ static void on_file_read(uv_fs_t* req) {
     // Close the file descriptor
     uv_fs_req_cleanup(req);
 
-    LOG_STATIC_DEBUG("About to close file descriptor: %d", ctx->file_descriptor);
-    uv_fs_close(ctx->mount->static_server->loop, &ctx->fs_req,
-                ctx->file_descriptor, NULL);
+    LOG_STATIC_DEBUG("About to release file descriptor: %d", ctx->file_descriptor);
+    release_file(ctx);
 
     // Validate buffer and data
     if (!file_data) {
@@ -645,59 +1048,325 @@ static void on_file_read(uv_fs_t* req) {
     LOG_STATIC_DEBUG("File data validation passed, buffer=%p, size=%zu",
                      file_data, bytes_read);
 
+    send_loaded_file(ctx, file_data, bytes_read);
+}
+
+// Answer with a file loaded into memory, then cache or free the buffer.
+// Compressible files are gzipped once as they enter the cache, and the gzip
+// variant is kept next to the file for every request that accepts it.
+static void send_loaded_file(static_file_context_t* ctx, void* file_data, size_t bytes_read) {
+    catzilla_static_server_t* static_server = ctx->mount->static_server;
+
     // Get MIME type
-    const char* mime_type = catzilla_static_get_content_type(ctx->full_file_path);
+    const char* mime_type = ctx_content_type(ctx);
     LOG_STATIC_DEBUG("MIME type determined: %s", mime_type ? mime_type : "NULL");
 
+    // Precompressed siblings are not cached under the file's key
+    bool cacheable = static_server->cache && !ctx->content_encoding &&
+                     bytes_read <= STATIC_CACHE_MAX_FILE_SIZE;
+    bool varies = response_varies(ctx, ctx->relative_path);
+    void* gzipped = NULL;
+    size_t gzipped_size = 0;
+    if (cacheable && varies && bytes_read >= static_server->config.compression_min_size) {
+        int level = static_server->config.compression_level;
+        // Not worth its memory unless it saves a tenth
+        size_t capacity = bytes_read - bytes_read / 10;
+        gzipped = catzilla_static_alloc(capacity);
+        if (gzipped) {
+            gzipped_size = catzilla_compress_into(CATZILLA_ENCODING_GZIP,
+                                                  (level >= 1 && level <= 9) ? level : 6,
+                                                  file_data, bytes_read, gzipped, capacity);
+            if (gzipped_size == 0) {
+                catzilla_static_free(gzipped);
+                gzipped = NULL;
+            }
+        }
+    }
+    bool send_gzipped = gzipped &&
+                        select_encoding(ctx, STATIC_ENCODING_GZIP, bytes_read) == STATIC_ENCODING_GZIP;
+    void* body = send_gzipped ? gzipped : file_data;
+    size_t body_size = send_gzipped ? gzipped_size : bytes_read;
+
     // Build HTTP headers
     static_http_headers_t headers;
     memset(&headers, 0, sizeof(headers));
     strncpy(headers.content_type, mime_type, STATIC_MAX_MIME_TYPE_LEN - 1);
-    snprintf(headers.content_length, sizeof(headers.content_length), "%zu", bytes_read);
+    snprintf(headers.content_length, sizeof(headers.content_length), "%zu", body_size);
+    if (send_gzipped || ctx->content_encoding) {
+        strcpy(headers.content_encoding,
+               encoding_name(send_gzipped ? STATIC_ENCODING_GZIP : ctx->content_encoding));
+    }
+    if (varies) {
+        strcpy(headers.vary, "Accept-Encoding");
+    }
 
     // Add cache headers if enabled
-    if (ctx->mount->static_server->config.enable_etags) {
-        char* etag = catzilla_static_generate_etag(ctx->full_file_path,
-                                                   time(NULL),  // Use current time for now
-                                                   bytes_read);
-        if (etag) {
-            strncpy(headers.etag, etag, STATIC_MAX_ETAG_LEN - 1);
-            catzilla_static_free(etag);
-        }
+    set_validators(ctx, ctx->file_mtime, bytes_read, &headers);
+    if (send_gzipped && headers.etag[0]) {
+        size_t etag_len = strlen(headers.etag);
+        snprintf(headers.etag + etag_len, STATIC_MAX_ETAG_LEN - etag_len, "-gzip");
     }
 
     LOG_STATIC_DEBUG("Sending file response: client=%p, bytes=%zu, mime=%s",
-                     ctx->client, bytes_read, mime_type);
+                     ctx->client, body_size, mime_type);
 
     // Send response
-    int result = catzilla_static_send_file_response(ctx->client, file_data, bytes_read,
+    int result = catzilla_static_send_file_response(ctx->client, body, body_size,
                                                     mime_type, &headers);
 
     LOG_STATIC_DEBUG("File response send result: %d", result);
 
     // Update statistics
     if (result == 0) {
-        catzilla_atomic_fetch_add(&ctx->mount->static_server->requests_served, 1);
-        catzilla_atomic_fetch_add(&ctx->mount->static_server->bytes_served, bytes_read);
+        catzilla_atomic_fetch_add(&static_server->requests_served, 1);
+        catzilla_atomic_fetch_add(&static_server->bytes_served, body_size);
         LOG_STATIC_DEBUG("Statistics updated successfully");
     }
 
-    // Cache file if enabled and appropriate size
-    if (ctx->mount->static_server->cache &&
-        bytes_read <= STATIC_CACHE_MAX_FILE_SIZE) {
-        LOG_STATIC_DEBUG("Adding file to cache: %zu bytes", bytes_read);
-        catzilla_static_cache_put(ctx->mount->static_server->cache,
-                                  ctx->relative_path, file_data, bytes_read,
-                                  time(NULL));
-    } else {
+    if (cacheable) {
+        LOG_STATIC_DEBUG("Adding file to cache: %zu bytes (gzip variant: %zu)",
+                         bytes_read, gzipped_size);
+        if (catzilla_static_cache_put_variant(static_server->cache, ctx->relative_path,
+                                              file_data, bytes_read, ctx->file_mtime,
+                                              gzipped, gzipped_size) == 0) {
+            file_data = NULL;
+            gzipped = NULL;
+        }
+    }
+    if (file_data) {
         LOG_STATIC_DEBUG("Freeing file data buffer (not cached)");
         catzilla_static_free(file_data);  // Use matching free function
     }
+    if (gzipped) {
+        catzilla_static_free(gzipped);
+    }
 
     LOG_STATIC_DEBUG("Cleaning up file context");
     catzilla_static_free(ctx);  // Use matching free function
 }
 
+#ifdef STATIC_HAS_SENDFILE
+// sendfile path: the head goes through catzilla_server_write like any other
+// response, then the body is handed from the file to the socket in chunks on
+// the threadpool. A full socket buffer (EAGAIN) parks the transfer on a poll
+// of the socket until it drains, so a slow client holds no memory. The
+// syscall is made directly: uv_fs_sendfile may fall back to copying through
+// a buffer and blocking a threadpool thread on the socket.
+
+static void send_next_chunk(static_file_context_t* ctx);
+
+static void on_socket_poll_closed(uv_handle_t* handle) {
+    static_file_context_t* ctx = (static_file_context_t*)handle->data;
+    close(ctx->socket_fd);
+    catzilla_static_free(ctx);
+}
+
+// Close the file and the socket duplicate; a response cut short leaves the
+// connection unusable, so it is closed too
+static void finish_sendfile(static_file_context_t* ctx, bool ok) {
+    catzilla_static_server_t* static_server = ctx->mount->static_server;
+
+    if (ctx->head) {
+        catzilla_response_free(ctx->head);
+        ctx->head = NULL;
+    }
+    release_file(ctx);
+
+    if (ok) {
+        size_t sent = ctx->send_offset - (ctx->is_range_request ? ctx->range_start : 0);
+        catzilla_atomic_fetch_add(&static_server->requests_served, 1);
+        catzilla_atomic_fetch_add(&static_server->bytes_served, sent);
+        if (sent > 0) catzilla_atomic_fetch_add(&static_server->sendfile_operations, 1);
+        catzilla_server_response_complete(ctx->client);
+    } else {
+        catzilla_server_abort_response(ctx->client);
+    }
+
+    if (ctx->socket_poll_active) {
+        uv_close((uv_handle_t*)&ctx->socket_poll, on_socket_poll_closed);
+        return;
+    }
+    if (ctx->socket_fd >= 0) close(ctx->socket_fd);
+    catzilla_static_free(ctx);
+}
+
+static void on_socket_writable(uv_poll_t* handle, int status, int events) {
+    (void)events;
+    static_file_context_t* ctx = (static_file_context_t*)handle->data;
+    uv_poll_stop(handle);
+    if (status < 0) {
+        LOG_STATIC_WARN("Socket poll failed while sending %s: %s",
+                        ctx->full_file_path, uv_strerror(status));
+        finish_sendfile(ctx, false);
+        return;
+    }
+    send_next_chunk(ctx);
+}
+
+static void wait_for_socket(static_file_context_t* ctx) {
+    if (!ctx->socket_poll_active) {
+        if (uv_poll_init_socket(static_ctx_loop(ctx), &ctx->socket_poll, ctx->socket_fd) != 0) {
+            finish_sendfile(ctx, false);
+            return;
+        }
+        ctx->socket_poll.data = ctx;
+        ctx->socket_poll_active = true;
+    }
+    if (uv_poll_start(&ctx->socket_poll, UV_WRITABLE, on_socket_writable) != 0) {
+        finish_sendfile(ctx, false);
+    }
+}
+
+// Threadpool: one sendfile call for the next chunk, never blocking on the socket
+static void send_chunk_work(uv_work_t* req) {
+    static_file_context_t* ctx = (static_file_context_t*)req->data;
+    size_t length = ctx->send_end - ctx->send_offset;
+    if (length > STATIC_SENDFILE_CHUNK_SIZE) length = STATIC_SENDFILE_CHUNK_SIZE;
+
+#if defined(__linux__)
+    off_t offset = (off_t)ctx->send_offset;
+    ssize_t sent = sendfile(ctx->socket_fd, ctx->file_descriptor, &offset, length);
+    ctx->send_result = sent >= 0 ? sent : uv_translate_sys_error(errno);
+#else
+    off_t sent = (off_t)length;
+    int rc = sendfile(ctx->file_descriptor, ctx->socket_fd, (off_t)ctx->send_offset, &sent, NULL, 0);
+    // A partial send reports EAGAIN along with the bytes it did send
+    ctx->send_result = (rc == 0 || sent > 0) ? (ssize_t)sent : uv_translate_sys_error(errno);
+#endif
+}
+
+static void send_next_chunk(static_file_context_t* ctx) {
+    if (ctx->send_offset >= ctx->send_end) {
+        finish_sendfile(ctx, true);
+        return;
+    }
+
+    ctx->send_req.data = ctx;
+    if (uv_queue_work(static_ctx_loop(ctx), &ctx->send_req, send_chunk_work,
+                      on_sendfile_complete) != 0) {
+        finish_sendfile(ctx, false);
+    }
+}
+
+static void on_sendfile_complete(uv_work_t* req, int status) {
+    static_file_context_t* ctx = (static_file_context_t*)req->data;
+    ssize_t result = status < 0 ? status : ctx->send_result;
+
+    if (result > 0) {
+        ctx->send_offset += (size_t)result;
+        send_next_chunk(ctx);
+    } else if (result == UV_EAGAIN) {
+        wait_for_socket(ctx);
+    } else {
+        // 0 means the file was truncated under us
+        LOG_STATIC_WARN("sendfile failed for %s: %s", ctx->full_file_path,
+                        result == 0 ? "unexpected end of file" : uv_strerror((int)result));
+        if (result == 0) {
+            catzilla_static_fd_cache_invalidate(ctx->mount->static_server->fd_cache,
+                                                ctx->full_file_path);
+        }
+        finish_sendfile(ctx, false);
+    }
+}
+
+static void on_sendfile_head_written(uv_write_t* req, int status) {
+    static_file_context_t* ctx = (static_file_context_t*)req->data;
+    catzilla_response_free(ctx->head);
+    ctx->head = NULL;
+
+    if (status < 0) {
+        LOG_STATIC_WARN("Response head write failed for %s: %s",
+                        ctx->full_file_path, uv_strerror(status));
+        finish_sendfile(ctx, false);
+        return;
+    }
+    send_next_chunk(ctx);
+}
+
+// Answer 200, 206 for a single satisfiable range, or 416 past the end of
+// the file; any other Range header is ignored and the whole file sent
+static int select_range(static_file_context_t* ctx, size_t file_size,
+                        static_http_headers_t* headers) {
+    ctx->send_offset = 0;
+    ctx->send_end = file_size;
+    if (!ctx->range_header[0] || strchr(ctx->range_header, ',')) return 200;
+
+    size_t start, end;
+    if (catzilla_static_parse_range_header(ctx->range_header, file_size, &start, &end) == 0) {
+        ctx->is_range_request = true;
+        ctx->range_start = start;
+        ctx->range_end = end;
+        ctx->send_offset = start;
+        ctx->send_end = end + 1;
+        snprintf(headers->content_range, sizeof(headers->content_range),
+                 "bytes %zu-%zu/%zu", start, end, file_size);
+        return 206;
+    }
+
+    const char* spec = ctx->range_header + 6;
+    if (strncmp(ctx->range_header, "bytes=", 6) == 0 && *spec >= '0' && *spec <= '9' &&
+        strtoull(spec, NULL, 10) >= file_size) {
+        ctx->send_end = 0;
+        snprintf(headers->content_range, sizeof(headers->content_range), "bytes */%zu", file_size);
+        return 416;
+    }
+    return 200;
+}
+
+// Send an open file without reading it into memory
+static void start_sendfile(static_file_context_t* ctx, size_t file_size) {
+    uv_os_fd_t socket_fd;
+    // The body goes to a duplicate so it has a poll watcher of its own
+    if (uv_fileno((uv_handle_t*)ctx->client, &socket_fd) != 0 ||
+        (ctx->socket_fd = fcntl(socket_fd, F_DUPFD_CLOEXEC, 0)) < 0) {
+        LOG_STATIC_DEBUG("No socket to sendfile to, reading %s instead", ctx->full_file_path);
+        ctx->socket_fd = -1;
+        read_whole_file(ctx, file_size);
+        return;
+    }
+
+    static_http_headers_t headers;
+    memset(&headers, 0, sizeof(headers));
+    const char* mime_type = ctx_content_type(ctx);
+    strncpy(headers.content_type, mime_type, STATIC_MAX_MIME_TYPE_LEN - 1);
+    strcpy(headers.accept_ranges, "bytes");
+    if (ctx->content_encoding) {
+        strcpy(headers.content_encoding, encoding_name(ctx->content_encoding));
+    }
+    if (response_varies(ctx, ctx->relative_path)) {
+        strcpy(headers.vary, "Accept-Encoding");
+    }
+
+    int status = select_range(ctx, file_size, &headers);
+    snprintf(headers.content_length, sizeof(headers.content_length), "%zu",
+             ctx->send_end - ctx->send_offset);
+    if (status == 416) headers.content_type[0] = '\0';
+
+    if (status != 416) {
+        set_validators(ctx, ctx->file_mtime, file_size, &headers);
+    }
+
+    // HEAD gets the same head and no body
+    if (ctx->is_head_request) ctx->send_end = ctx->send_offset;
+
+    size_t head_len = 0;
+    ctx->head = catzilla_static_build_response_head(status, &headers, &head_len);
+    if (!ctx->head) {
+        finish_sendfile(ctx, false);
+        return;
+    }
+
+    LOG_STATIC_DEBUG("Sending %s with sendfile: status=%d, bytes=%zu",
+                     ctx->full_file_path, status, ctx->send_end - ctx->send_offset);
+
+    ctx->head_req.data = ctx;
+    uv_buf_t buf = uv_buf_init(ctx->head, (unsigned int)head_len);
+    if (catzilla_server_write(&ctx->head_req, ctx->client, &buf, 1, on_sendfile_head_written) != 0) {
+        finish_sendfile(ctx, false);
+    }
+}
+#endif
+
 static void cache_cleanup_timer_cb(uv_timer_t* timer) {
     catzilla_static_server_t* server = (catzilla_static_server_t*)timer->data;
     if (server && server->cache) {
@@ -705,32 +1374,45 @@ static void cache_cleanup_timer_cb(uv_timer_t* timer) {
     }
 }
 
-// Hash function for file paths
-static uint32_t hash_path(const char* path) {
-    uint32_t hash = 5381;
-    int c;
-    while ((c = *path++)) {
-        hash = ((hash << 5) + hash) + c;
-    }
-    return hash % STATIC_CACHE_HASH_BUCKETS;
-}
-
 static int catzilla_static_serve_cached_file(static_file_context_t* ctx) {
     if (!ctx || !ctx->cache_entry) return -1;
 
+    if (ctx->if_none_match[0] &&
+        answer_not_modified(ctx, ctx->cache_entry->file_mtime, ctx->cache_entry->content_size)) {
+        catzilla_static_cache_release(ctx->mount->static_server->cache, ctx->cache_entry);
+        catzilla_static_free(ctx);
+        return 0;
+    }
+
     // Get MIME type from file path
     const char* mime_type = catzilla_static_get_content_type(ctx->cache_entry->file_path);
 
+    // The gzip variant goes to clients that accept it
+    hot_cache_entry_t* entry = ctx->cache_entry;
+    bool send_gzipped = entry->is_compressed &&
+                        select_encoding(ctx, STATIC_ENCODING_GZIP, entry->content_size) ==
+                            STATIC_ENCODING_GZIP;
+    void* body = send_gzipped ? entry->compressed_content : entry->file_content;
+    size_t body_size = send_gzipped ? entry->compressed_size : entry->content_size;
+
     // Build headers for cached response
     static_http_headers_t headers;
     memset(&headers, 0, sizeof(headers));
     strncpy(headers.content_type, mime_type, STATIC_MAX_MIME_TYPE_LEN - 1);
-    snprintf(headers.content_length, sizeof(headers.content_length),
-             "%zu", ctx->cache_entry->content_size);
+    snprintf(headers.content_length, sizeof(headers.content_length), "%zu", body_size);
+    if (send_gzipped) {
+        strcpy(headers.content_encoding, "gzip");
+    }
+    if (response_varies(ctx, entry->file_path)) {
+        strcpy(headers.vary, "Accept-Encoding");
+    }
 
-    // Generate ETag from cached data
-    snprintf(headers.etag, STATIC_MAX_ETAG_LEN, "%lx",
-             (unsigned long)ctx->cache_entry->etag_hash);
+    // Same validators as a response read from the file
+    set_validators(ctx, entry->file_mtime, entry->content_size, &headers);
+    if (send_gzipped && headers.etag[0]) {
+        size_t etag_len = strlen(headers.etag);
+        snprintf(headers.etag + etag_len, STATIC_MAX_ETAG_LEN - etag_len, "-gzip");
+    }
 
     // Add cache control
     strcpy(headers.cache_control, "public, max-age=3600");
@@ -742,17 +1424,17 @@ static int catzilla_static_serve_cached_file(static_file_context_t* ctx) {
     strcpy(headers.accept_ranges, "bytes");
 
     // Send response
-    int result = catzilla_static_send_file_response(ctx->client,
-                                                    ctx->cache_entry->file_content,
-                                                    ctx->cache_entry->content_size,
+    int result = catzilla_static_send_file_response(ctx->client, body, body_size,
                                                     mime_type, &headers);
 
     // Update statistics
     if (result == 0) {
         catzilla_atomic_fetch_add(&ctx->mount->static_server->requests_served, 1);
-        catzilla_atomic_fetch_add(&ctx->mount->static_server->bytes_served, ctx->cache_entry->content_size);
+        catzilla_atomic_fetch_add(&ctx->mount->static_server->bytes_served, body_size);
     }
 
+    // The response holds its own copy of the body
+    catzilla_static_cache_release(ctx->mount->static_server->cache, entry);
     catzilla_static_free(ctx);
     return result;
 }
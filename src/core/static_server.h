@@ -9,6 +9,7 @@
 #include "server.h"
 #include "memory.h"
 #include "platform_atomic.h"
+#include "compression.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -22,14 +23,29 @@ typedef struct static_file_context static_file_context_t;
 typedef struct catzilla_static_response catzilla_static_response_t;
 typedef struct hot_cache hot_cache_t;
 typedef struct hot_cache_entry hot_cache_entry_t;
+typedef struct hot_cache_table hot_cache_table_t;
+typedef struct static_fd_cache static_fd_cache_t;
+typedef struct static_fd_entry static_fd_entry_t;
 
 // Configuration and limits
-#define STATIC_CACHE_HASH_BUCKETS 1024
+#define STATIC_CACHE_MIN_SLOTS 1024                   // Initial hot cache table size (power of two)
+#define STATIC_CACHE_SNAPSHOT_BUCKETS 1024            // Index buckets of a hot cache snapshot
+#define STATIC_CACHE_MAX_READERS 128                  // Threads with a lock-free hot cache lookup slot
 #define STATIC_CACHE_DEFAULT_TTL 3600
 #define STATIC_CACHE_MAX_FILE_SIZE (10 * 1024 * 1024)  // 10MB max per file
 #define STATIC_MAX_MIME_TYPE_LEN 128
 #define STATIC_MAX_ETAG_LEN 64
 #define STATIC_MAX_HEADER_LEN 256
+#define STATIC_SENDFILE_MIN_SIZE (256 * 1024)      // Smaller files are read into memory (and the hot cache)
+#define STATIC_SENDFILE_CHUNK_SIZE (1024 * 1024)   // Most bytes handed to one sendfile call
+
+#define STATIC_FD_CACHE_BUCKETS 256
+#define STATIC_FD_CACHE_MAX_ENTRIES 256             // Open files kept per mount
+#define STATIC_FD_CACHE_TTL 5                       // Seconds before an entry is checked with stat again
+
+// Content codings of the static server, negotiated like dynamic responses
+#define STATIC_ENCODING_GZIP CATZILLA_ENCODING_GZIP
+#define STATIC_ENCODING_BR CATZILLA_ENCODING_BR
 
 // Static server configuration
 typedef struct static_server_config {
@@ -41,9 +57,11 @@ typedef struct static_server_config {
     uv_loop_t* loop;                     // Shared event loop with main server
     int fs_thread_pool_size;             // Thread pool size for file operations
     bool use_sendfile;                   // Enable zero-copy sendfile
+    bool use_io_uring;                   // Load files through io_uring where the kernel allows it
 
     // Performance settings
     bool enable_hot_cache;               // Cache frequently accessed files
+    bool enable_fd_cache;                // Keep files open with their metadata (static_fd_cache_t)
     size_t cache_size_mb;               // Hot cache size (default: 100MB)
     int cache_ttl_seconds;              // Cache TTL (default: 3600)
 
@@ -75,6 +93,8 @@ typedef struct static_http_headers {
     char cache_control[128];     // Cache directives
     char accept_ranges[16];      // "bytes" for range support
     char content_range[64];      // For range requests
+    char content_encoding[16];   // "br" or "gzip" for an encoded body
+    char vary[32];               // "Accept-Encoding" where the body depends on it
 
     // Security headers
     char x_content_type_options[16];  // "nosniff"
@@ -119,34 +139,55 @@ typedef struct static_security_config {
     char** blocked_patterns;     // Blocked filename patterns
 } static_security_config_t;
 
-// Cache entry structure
+// Cache entry structure. Entries never change once published; lookups
+// take a reference, and a removed entry is freed when the lookups that might
+// still see it are over and the last reference is released.
 typedef struct hot_cache_entry {
     char* file_path;              // Key (relative path)
+    uint32_t hash;                // Hash of file_path
     void* file_content;           // File data
     size_t content_size;          // File size in bytes
-    time_t last_accessed;         // For LRU eviction
     time_t expires_at;            // TTL expiration
     time_t file_mtime;            // File modification time
     uint64_t etag_hash;           // For HTTP ETag generation
-    uint32_t access_count;        // Access frequency tracking
     bool is_compressed;           // Has compressed version
-    void* compressed_content;     // Gzipped content
+    void* compressed_content;     // Gzipped content, owned by the entry
     size_t compressed_size;       // Compressed size
-    struct hot_cache_entry* next; // Hash collision chain
-    struct hot_cache_entry* lru_prev; // LRU doubly-linked list
-    struct hot_cache_entry* lru_next;
+    size_t memory;                // Bytes charged to the cache
+    catzilla_atomic_uint8_t referenced; // Set by lookups, cleared by the eviction clock (relaxed)
+    catzilla_atomic_uint64_t refs; // Lookups holding it, plus one while it is in the table
+    uint64_t retired_epoch;       // Lookup epoch when it was removed
+    struct hot_cache_entry* next_retired;
 } hot_cache_entry_t;
 
-// Hot cache structure
+// Open-addressing table of entries (at most half full); replaced by a
+// larger copy as the cache grows
+typedef struct hot_cache_table {
+    uint32_t capacity;            // Slots, a power of two
+    uint32_t used;                // Slots holding an entry or a tombstone
+    uint64_t retired_epoch;       // Lookup epoch when it was replaced
+    struct hot_cache_table* next_retired;
+    hot_cache_entry_t* slots[];   // Entry, NULL, or a tombstone left by a removal
+} hot_cache_table_t;
+
+// Hot cache structure, shared by every loop serving the mount. Lookups read
+// the published table without a lock; changes are serialised by write_lock.
+// Eviction is approximate LRU: a clock hand sweeps the table and takes the
+// first entry not looked up since the hand last passed it.
 typedef struct hot_cache {
-    hot_cache_entry_t* buckets[STATIC_CACHE_HASH_BUCKETS];
-    hot_cache_entry_t* lru_head;  // Most recently used
-    hot_cache_entry_t* lru_tail;  // Least recently used
+    hot_cache_table_t* table;     // Published table (atomic pointer)
+    uint32_t clock_hand;          // Next slot the eviction clock looks at
     size_t max_memory_bytes;      // Memory limit
     size_t current_memory_usage;  // Current usage
     uint32_t total_entries;       // Entry count
-    uv_rwlock_t cache_lock;       // Thread safety
-    uv_timer_t cleanup_timer;     // TTL cleanup timer
+    uv_mutex_t write_lock;        // Held by changes
+    hot_cache_table_t* retired_tables;   // Replaced, waiting for a grace period
+    hot_cache_entry_t* retired_entries;  // Removed, waiting for a grace period
+
+    // Warm start: snapshot whose buckets are restored on first use, and
+    // the directory its paths are checked against
+    struct catzilla_snapshot_s* snapshot;
+    char* snapshot_root;
 
     // Statistics
     catzilla_atomic_uint64_t cache_hits;
@@ -154,6 +195,45 @@ typedef struct hot_cache {
     catzilla_atomic_uint64_t evictions;
 } hot_cache_t;
 
+// Open file with the metadata a response needs, shared by the requests using it
+typedef struct static_fd_entry {
+    char* path;                   // Key (full file path)
+    uint32_t hash;
+    int fd;                       // Read-only descriptor owned by the entry
+    size_t size;
+    time_t mtime;
+    uint64_t inode;               // Identifies the file a revalidating stat finds
+    time_t checked_at;            // Last time the entry was known to match the file
+    char etag[STATIC_MAX_ETAG_LEN];
+    char last_modified[32];       // HTTP date of mtime
+    uint32_t refs;                // Requests using fd; the cache holds none
+    bool stale;                   // Dropped from the table, closed at the last release
+    struct static_fd_entry* next; // Hash collision chain
+    struct static_fd_entry* lru_prev;
+    struct static_fd_entry* lru_next;
+} static_fd_entry_t;
+
+// Open file descriptor and stat cache. A fs event watch on the mount drops
+// entries as their files change; changes it cannot see (files in
+// subdirectories on Linux) are caught by a stat once an entry is
+// STATIC_FD_CACHE_TTL seconds old.
+typedef struct static_fd_cache {
+    static_fd_entry_t* buckets[STATIC_FD_CACHE_BUCKETS];
+    static_fd_entry_t* lru_head;  // Most recently used
+    static_fd_entry_t* lru_tail;
+    uint32_t entry_count;
+    uint32_t max_entries;
+    uv_mutex_t lock;              // Lookups come from every worker loop
+    uv_fs_event_t watch;
+    bool watching;
+    char* watch_root;             // Directory the watch reports names under
+
+    // Statistics
+    catzilla_atomic_uint64_t hits;
+    catzilla_atomic_uint64_t misses;
+    catzilla_atomic_uint64_t invalidations;
+} static_fd_cache_t;
+
 // File context for serving
 typedef struct static_file_context {
     catzilla_request_t* request;
@@ -173,6 +253,26 @@ typedef struct static_file_context {
     size_t range_end;                     // Range request end
     bool is_range_request;                // Range request flag
     uint64_t start_time;                  // Request start time
+    bool serving_index;                   // Directory request resolved to its index file
+    char range_header[STATIC_MAX_HEADER_LEN]; // Range request header ("" if none)
+    catzilla_accept_encoding_t accept_encoding; // Accept-Encoding request header, parsed
+    char if_none_match[STATIC_MAX_HEADER_LEN]; // If-None-Match request header ("" if none)
+    static_fd_entry_t* fd_entry;          // Cached open file in use, if any
+    time_t file_mtime;                    // Modification time of the file being sent
+    int content_encoding;                 // STATIC_ENCODING_* of a precompressed sibling being sent
+    bool sendfile_ok;                     // Body may go straight to the socket
+
+    // sendfile path: the head is written through the server, then the body
+    // goes from the file to a duplicate of the socket in chunks
+    uv_write_t head_req;
+    char* head;
+    uv_work_t send_req;                   // One sendfile call on the threadpool
+    ssize_t send_result;                  // Bytes it sent, or a libuv error code
+    uv_poll_t socket_poll;                // Waits for socket_fd to drain after EAGAIN
+    bool socket_poll_active;
+    int socket_fd;
+    size_t send_offset;                   // Next file byte to send
+    size_t send_end;                      // One past the last byte to send
 } static_file_context_t;
 
 // Server mount structure
@@ -193,6 +293,7 @@ typedef struct catzilla_static_server {
 
     // Hot file cache
     hot_cache_t* cache;                 // LRU cache with hash table
+    static_fd_cache_t* fd_cache;        // Open files of uncached requests (NULL if disabled)
 
     // Security context
     static_security_config_t* security; // Security configuration
@@ -203,6 +304,7 @@ typedef struct catzilla_static_server {
     catzilla_atomic_uint64_t cache_hits;
     catzilla_atomic_uint64_t cache_misses;
     catzilla_atomic_uint64_t sendfile_operations;
+    catzilla_atomic_uint64_t uring_operations;   // Files loaded through io_uring
 } catzilla_static_server_t;
 
 // Core API functions
@@ -260,14 +362,198 @@ int catzilla_static_send_error_response(uv_stream_t* client,
                                         int status_code,
                                         const char* message);
 
+/**
+ * Answer 304 Not Modified
+ * @param client Client stream
+ * @param headers Validators and Vary of the response the client holds
+ * @return 0 on success, -1 or a libuv error code on failure
+ */
+int catzilla_static_send_not_modified(uv_stream_t* client, static_http_headers_t* headers);
+
+/**
+ * Build a response head alone, for a body sent separately (sendfile)
+ * @param status_code HTTP status
+ * @param headers Headers; content_length gives the body size
+ * @param length_out Receives the head length
+ * @return Head allocated with catzilla_response_alloc, or NULL
+ */
+char* catzilla_static_build_response_head(int status_code,
+                                          static_http_headers_t* headers,
+                                          size_t* length_out);
+
 // Cache management
 int catzilla_static_cache_init(hot_cache_t* cache, size_t max_memory);
+
+/**
+ * Look up a cached file; safe on any thread, and takes no lock
+ * @param cache Hot cache
+ * @param file_path Relative path used as the key
+ * @return Entry with a reference taken, to be given back with
+ *         catzilla_static_cache_release, or NULL
+ */
 hot_cache_entry_t* catzilla_static_cache_get(hot_cache_t* cache, const char* file_path);
+
+/**
+ * Give back a reference from catzilla_static_cache_get
+ * @param cache Hot cache
+ * @param entry Entry (may be NULL)
+ */
+void catzilla_static_cache_release(hot_cache_t* cache, hot_cache_entry_t* entry);
+
 int catzilla_static_cache_put(hot_cache_t* cache, const char* file_path,
                               void* content, size_t size, time_t mtime);
+
+/**
+ * Cache a file together with its gzip variant
+ * @param cache Hot cache
+ * @param file_path Relative path used as the key
+ * @param content File contents; the cache takes ownership on success
+ * @param size Content size
+ * @param mtime File modification time
+ * @param gzipped Gzip encoding of the contents, owned by the cache on success (may be NULL)
+ * @param gzipped_size Size of the gzip variant
+ * @return 0 on success, -1 on failure (nothing is taken over)
+ */
+int catzilla_static_cache_put_variant(hot_cache_t* cache, const char* file_path,
+                                      void* content, size_t size, time_t mtime,
+                                      void* gzipped, size_t gzipped_size);
 void catzilla_static_cache_remove(hot_cache_t* cache, const char* file_path);
 void catzilla_static_cache_cleanup(hot_cache_t* cache);
 
+/**
+ * Change the memory limit, evicting entries until the cache fits it
+ * @param cache Hot cache
+ * @param max_memory New limit in bytes
+ * @return Entries evicted
+ */
+size_t catzilla_static_cache_set_limit(hot_cache_t* cache, size_t max_memory);
+
+/**
+ * Free every entry and table; nothing may use the cache any more
+ * @param cache Hot cache
+ */
+void catzilla_static_cache_destroy(hot_cache_t* cache);
+
+// Open file cache (static_fd_cache.c)
+
+/**
+ * Initialize an empty fd cache
+ * @param cache Cache
+ * @param max_entries Most files kept open
+ * @return 0 on success, -1 on failure
+ */
+int catzilla_static_fd_cache_init(static_fd_cache_t* cache, uint32_t max_entries);
+
+/**
+ * Drop entries as files under a directory change; call on the loop that
+ * runs the watch. Without a working watch only the TTL applies.
+ * @param cache Cache
+ * @param loop Loop receiving the fs events
+ * @param directory Mounted directory, as file paths start with it
+ * @return 0 if watching, or a libuv error code
+ */
+int catzilla_static_fd_cache_watch(static_fd_cache_t* cache, uv_loop_t* loop, const char* directory);
+
+/**
+ * Find an open file; an entry older than the TTL is checked with stat first
+ * @param cache Cache
+ * @param path Full file path
+ * @return Entry with a reference taken, or NULL
+ */
+static_fd_entry_t* catzilla_static_fd_cache_acquire(static_fd_cache_t* cache, const char* path);
+
+/**
+ * Keep a file that was just opened and checked
+ * @param cache Cache
+ * @param path Full file path
+ * @param fd Descriptor; owned by the cache on success
+ * @param stat Its fstat result
+ * @return Entry with a reference taken, or NULL (the caller keeps fd)
+ */
+static_fd_entry_t* catzilla_static_fd_cache_insert(static_fd_cache_t* cache, const char* path,
+                                                   int fd, const uv_stat_t* stat);
+
+/**
+ * Give back a reference from acquire or insert
+ * @param cache Cache
+ * @param entry Entry
+ */
+void catzilla_static_fd_cache_release(static_fd_cache_t* cache, static_fd_entry_t* entry);
+
+/**
+ * Drop the entries for a path and everything under it
+ * @param cache Cache
+ * @param path Full path of a file or directory
+ */
+void catzilla_static_fd_cache_invalidate(static_fd_cache_t* cache, const char* path);
+
+/**
+ * Close every file not in use and stop the watch; entries still in use are
+ * closed at their last release
+ * @param cache Cache, freed by the watch's close callback when watching
+ */
+void catzilla_static_fd_cache_destroy(static_fd_cache_t* cache);
+
+/**
+ * Write the cached files to a snapshot file (cache_snapshot.h)
+ * @param cache Hot cache
+ * @param path Snapshot file, replaced atomically
+ * @return 0 on success, -1 on failure (always on Windows)
+ */
+int catzilla_static_cache_save_snapshot(hot_cache_t* cache, const char* path);
+
+/**
+ * Map a snapshot for a warm start; each file's bucket is restored the first
+ * time a path in it is looked up. A file is skipped if it changed on disk
+ * after it was cached, or if its TTL ran out meanwhile.
+ * @param cache Hot cache, before requests use it
+ * @param path Snapshot file written by catzilla_static_cache_save_snapshot
+ * @param root_directory Directory the cached relative paths are under
+ * @return 0 on success, -1 if the file is missing or malformed
+ */
+int catzilla_static_cache_load_snapshot(hot_cache_t* cache, const char* path,
+                                        const char* root_directory);
+
+// io_uring file backend (Linux builds with CATZILLA_HAS_IO_URING)
+
+/**
+ * Outcome of catzilla_static_uring_read_file
+ */
+typedef struct {
+    int status;      // 0, or a libuv error code (UV_EISDIR for directories, UV_EFBIG above max_size)
+    void* data;      // catzilla_static_alloc'd contents on success; the callback owns it
+    size_t size;
+    time_t mtime;
+} catzilla_static_uring_result_t;
+
+typedef void (*catzilla_static_uring_cb)(void* user_data, catzilla_static_uring_result_t* result);
+
+/**
+ * Check whether the calling thread can use io_uring, setting up its ring on
+ * first use. The ring belongs to the first loop it was used with.
+ * @param loop Loop of the calling thread
+ * @return true if file reads can go through io_uring
+ */
+bool catzilla_static_uring_available(uv_loop_t* loop);
+
+/**
+ * Load a whole file: statx and openat are submitted together, then the read
+ * and close. Submissions are batched per loop iteration.
+ * @param loop Loop of the calling thread
+ * @param path File to read
+ * @param max_size Largest file accepted (0 = unlimited)
+ * @param callback Called once on the loop thread with the result
+ * @param user_data Passed to callback
+ * @return 0 if queued, or a libuv error code when the caller should use uv_fs_* instead
+ */
+int catzilla_static_uring_read_file(uv_loop_t* loop, const char* path, size_t max_size,
+                                    catzilla_static_uring_cb callback, void* user_data);
+
+/**
+ * Release the calling thread's ring after its loop was closed
+ */
+void catzilla_static_uring_shutdown(void);
+
 // Security functions
 bool catzilla_static_validate_path(const char* requested_path, const char* base_dir);
 bool catzilla_static_check_extension(const char* filename, static_security_config_t* config);
@@ -277,6 +563,7 @@ const char* catzilla_static_get_content_type(const char* file_path);
 char* catzilla_static_generate_etag(const char* file_path, time_t last_modified, size_t file_size);
 int catzilla_static_parse_range_header(const char* range_header, size_t file_size,
                                        size_t* start_out, size_t* end_out);
+bool catzilla_static_is_compressible(const char* file_path);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,470 @@
+#include "platform_compat.h"
+#include "static_server.h"
+#include "logging.h"
+#include <string.h>
+
+// io_uring file backend for the static server. Each loop thread owns one ring
+// whose fd is watched with a uv_poll_t; SQEs queued during a loop iteration
+// are submitted together from a uv_prepare_t right before the loop polls. A
+// file costs two submissions: statx + openat, then read + close hard-linked,
+// instead of four threadpool round-trips through uv_fs_*.
+
+#if defined(CATZILLA_HAS_IO_URING) && defined(__linux__)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+#define STATIC_URING_ENTRIES 256
+
+// Low bits of the CQE user_data name the operation of a request
+#define URING_OP_STATX 0
+#define URING_OP_OPEN 1
+#define URING_OP_READ 2
+#define URING_OP_CLOSE 3
+#define URING_OP_MASK 3
+
+typedef struct {
+    bool ready;
+    bool unsupported;           // Setup failed once on this thread; stay on libuv
+    int fd;
+    uv_loop_t* loop;
+    uv_poll_t poll;
+    uv_prepare_t prepare;
+    bool prepare_active;
+    uint64_t in_flight;         // Requests not yet completed
+
+    void* sq_ring;
+    size_t sq_ring_size;
+    void* cq_ring;
+    size_t cq_ring_size;
+    struct io_uring_sqe* sqes;
+    size_t sqes_size;
+    unsigned* sq_head;
+    unsigned* sq_tail;
+    unsigned* sq_array;
+    unsigned sq_mask;
+    unsigned sq_entries;
+    unsigned sq_local_tail;     // SQEs filled in, published on submit
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned cq_mask;
+    struct io_uring_cqe* cqes;
+} static_uring_t;
+
+static CATZILLA_THREAD_LOCAL static_uring_t uring;
+
+typedef struct {
+    catzilla_static_uring_cb callback;
+    void* user_data;
+    size_t max_size;
+    char path[CATZILLA_PATH_MAX];
+    struct statx statx_buf;
+    int fd;
+    int stat_result;
+    int open_result;
+    int read_result;
+    int close_result;
+    int outstanding;            // CQEs still expected for the current step
+    void* buffer;
+    size_t size;
+} static_uring_read_t;
+
+static void on_uring_prepare(uv_prepare_t* handle);
+static void on_uring_poll(uv_poll_t* handle, int status, int events);
+
+static int sys_io_uring_setup(unsigned entries, struct io_uring_params* params) {
+    return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+static int sys_io_uring_register(int fd, unsigned opcode, void* arg, unsigned nr_args) {
+    return (int)syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+static void uring_unmap(void) {
+    if (uring.sqes && uring.sqes != MAP_FAILED) munmap(uring.sqes, uring.sqes_size);
+    if (uring.cq_ring && uring.cq_ring != MAP_FAILED && uring.cq_ring != uring.sq_ring) {
+        munmap(uring.cq_ring, uring.cq_ring_size);
+    }
+    if (uring.sq_ring && uring.sq_ring != MAP_FAILED) munmap(uring.sq_ring, uring.sq_ring_size);
+    if (uring.fd >= 0) close(uring.fd);
+    uring.sqes = NULL;
+    uring.sq_ring = NULL;
+    uring.cq_ring = NULL;
+    uring.fd = -1;
+}
+
+// Every opcode of the request chain must be known to the running kernel
+static bool uring_supports_file_ops(void) {
+    size_t probe_size = sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op);
+    struct io_uring_probe* probe = catzilla_static_alloc(probe_size);
+    if (!probe) return false;
+    memset(probe, 0, probe_size);
+
+    bool supported = false;
+    if (sys_io_uring_register(uring.fd, IORING_REGISTER_PROBE, probe, 256) == 0) {
+        static const int needed[] = { IORING_OP_STATX, IORING_OP_OPENAT, IORING_OP_READ, IORING_OP_CLOSE };
+        supported = true;
+        for (size_t i = 0; i < sizeof(needed) / sizeof(needed[0]); i++) {
+            if (needed[i] > probe->last_op || !(probe->ops[needed[i]].flags & IO_URING_OP_SUPPORTED)) {
+                supported = false;
+            }
+        }
+    }
+    catzilla_static_free(probe);
+    return supported;
+}
+
+static int uring_setup(uv_loop_t* loop) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    memset(&uring, 0, sizeof(uring));
+    uring.fd = -1;
+
+    int fd = sys_io_uring_setup(STATIC_URING_ENTRIES, &params);
+    if (fd < 0) return -errno;
+    uring.fd = fd;
+
+    // Both rings share one mapping on kernels with IORING_FEAT_SINGLE_MMAP
+    uring.sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    uring.cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap && uring.cq_ring_size > uring.sq_ring_size) {
+        uring.sq_ring_size = uring.cq_ring_size;
+    }
+
+    uring.sq_ring = mmap(NULL, uring.sq_ring_size, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (uring.sq_ring == MAP_FAILED) {
+        int err = -errno;
+        uring_unmap();
+        return err;
+    }
+
+    if (single_mmap) {
+        uring.cq_ring = uring.sq_ring;
+    } else {
+        uring.cq_ring = mmap(NULL, uring.cq_ring_size, PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (uring.cq_ring == MAP_FAILED) {
+            int err = -errno;
+            uring_unmap();
+            return err;
+        }
+    }
+
+    uring.sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    uring.sqes = mmap(NULL, uring.sqes_size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (uring.sqes == MAP_FAILED) {
+        int err = -errno;
+        uring_unmap();
+        return err;
+    }
+
+    char* sq = (char*)uring.sq_ring;
+    char* cq = (char*)uring.cq_ring;
+    uring.sq_head = (unsigned*)(sq + params.sq_off.head);
+    uring.sq_tail = (unsigned*)(sq + params.sq_off.tail);
+    uring.sq_array = (unsigned*)(sq + params.sq_off.array);
+    uring.sq_mask = *(unsigned*)(sq + params.sq_off.ring_mask);
+    uring.sq_entries = *(unsigned*)(sq + params.sq_off.ring_entries);
+    uring.sq_local_tail = *uring.sq_tail;
+    uring.cq_head = (unsigned*)(cq + params.cq_off.head);
+    uring.cq_tail = (unsigned*)(cq + params.cq_off.tail);
+    uring.cq_mask = *(unsigned*)(cq + params.cq_off.ring_mask);
+    uring.cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+
+    if (!uring_supports_file_ops()) {
+        uring_unmap();
+        return UV_ENOSYS;
+    }
+
+    // The ring fd turns readable when completions are waiting
+    int rc = uv_poll_init(loop, &uring.poll, fd);
+    if (rc == 0) {
+        rc = uv_poll_start(&uring.poll, UV_READABLE, on_uring_poll);
+        if (rc != 0) uv_close((uv_handle_t*)&uring.poll, NULL);
+    }
+    if (rc != 0) {
+        uring_unmap();
+        return rc;
+    }
+    uv_unref((uv_handle_t*)&uring.poll);
+
+    uv_prepare_init(loop, &uring.prepare);
+    uv_unref((uv_handle_t*)&uring.prepare);
+
+    uring.loop = loop;
+    uring.ready = true;
+    return 0;
+}
+
+static unsigned uring_sq_space(void) {
+    unsigned head = __atomic_load_n(uring.sq_head, __ATOMIC_ACQUIRE);
+    return uring.sq_entries - (uring.sq_local_tail - head);
+}
+
+static struct io_uring_sqe* uring_get_sqe(void) {
+    unsigned index = uring.sq_local_tail & uring.sq_mask;
+    struct io_uring_sqe* sqe = &uring.sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    uring.sq_array[index] = index;
+    uring.sq_local_tail++;
+    return sqe;
+}
+
+// Publish queued SQEs and hand them to the kernel in one system call
+static void uring_submit(void) {
+    __atomic_store_n(uring.sq_tail, uring.sq_local_tail, __ATOMIC_RELEASE);
+    unsigned pending = uring.sq_local_tail - __atomic_load_n(uring.sq_head, __ATOMIC_ACQUIRE);
+    while (pending > 0) {
+        int submitted = sys_io_uring_enter(uring.fd, pending, 0, 0);
+        if (submitted < 0) {
+            if (errno == EINTR) continue;
+            // EAGAIN/EBUSY: the kernel is short on resources; retry next iteration
+            LOG_STATIC_DEBUG("io_uring_enter failed: %s", strerror(errno));
+            return;
+        }
+        pending -= (unsigned)submitted < pending ? (unsigned)submitted : pending;
+    }
+}
+
+static void uring_schedule_submit(void) {
+    if (!uring.prepare_active) {
+        uv_prepare_start(&uring.prepare, on_uring_prepare);
+        uring.prepare_active = true;
+    }
+}
+
+static void on_uring_prepare(uv_prepare_t* handle) {
+    (void)handle;
+    uring_submit();
+    if (uring.sq_local_tail == __atomic_load_n(uring.sq_head, __ATOMIC_ACQUIRE)) {
+        uv_prepare_stop(&uring.prepare);
+        uring.prepare_active = false;
+    }
+}
+
+// In-flight requests keep the loop alive like any other pending I/O
+static void uring_request_started(void) {
+    if (uring.in_flight++ == 0) uv_ref((uv_handle_t*)&uring.poll);
+}
+
+static void uring_request_finished(void) {
+    if (--uring.in_flight == 0) uv_unref((uv_handle_t*)&uring.poll);
+}
+
+static void complete_request(static_uring_read_t* req, int status) {
+    catzilla_static_uring_result_t result;
+    memset(&result, 0, sizeof(result));
+    result.status = status;
+    if (status == 0) {
+        result.data = req->buffer;
+        result.size = req->size;
+        result.mtime = (time_t)req->statx_buf.stx_mtime.tv_sec;
+        req->buffer = NULL;
+    }
+
+    catzilla_static_free(req->buffer);
+    catzilla_static_uring_cb callback = req->callback;
+    void* user_data = req->user_data;
+    catzilla_static_free(req);
+    uring_request_finished();
+
+    callback(user_data, &result);
+}
+
+// statx and openat are both back: read the whole file, closing it after
+static void start_read(static_uring_read_t* req) {
+    if (req->stat_result < 0 || req->open_result < 0) {
+        if (req->open_result >= 0) close(req->open_result);
+        complete_request(req, req->stat_result < 0 ? req->stat_result : req->open_result);
+        return;
+    }
+
+    req->fd = req->open_result;
+    int status = 0;
+    if (S_ISDIR(req->statx_buf.stx_mode)) {
+        status = UV_EISDIR;
+    } else if (req->max_size > 0 && req->statx_buf.stx_size > req->max_size) {
+        status = UV_EFBIG;
+    } else if (uring_sq_space() < 2) {
+        uring_submit();
+        if (uring_sq_space() < 2) status = UV_EAGAIN;
+    }
+
+    if (status == 0) {
+        req->size = (size_t)req->statx_buf.stx_size;
+        req->buffer = catzilla_static_alloc(req->size > 0 ? req->size : 1);
+        if (!req->buffer) status = UV_ENOMEM;
+    }
+    if (status != 0) {
+        // Closing a descriptor that was never read does not block
+        close(req->fd);
+        complete_request(req, status);
+        return;
+    }
+
+    // A hard link runs the close even when the read comes back short
+    struct io_uring_sqe* sqe = uring_get_sqe();
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = req->fd;
+    sqe->addr = (uint64_t)(uintptr_t)req->buffer;
+    sqe->len = (unsigned)req->size;
+    sqe->off = 0;
+    sqe->flags = IOSQE_IO_HARDLINK;
+    sqe->user_data = (uint64_t)(uintptr_t)req | URING_OP_READ;
+
+    sqe = uring_get_sqe();
+    sqe->opcode = IORING_OP_CLOSE;
+    sqe->fd = req->fd;
+    sqe->user_data = (uint64_t)(uintptr_t)req | URING_OP_CLOSE;
+
+    req->outstanding = 2;
+    uring_schedule_submit();
+}
+
+static void handle_completion(uint64_t user_data, int res) {
+    static_uring_read_t* req = (static_uring_read_t*)(uintptr_t)(user_data & ~(uint64_t)URING_OP_MASK);
+    switch ((int)(user_data & URING_OP_MASK)) {
+        case URING_OP_STATX: req->stat_result = res; break;
+        case URING_OP_OPEN: req->open_result = res; break;
+        case URING_OP_READ: req->read_result = res; break;
+        case URING_OP_CLOSE: req->close_result = res; break;
+    }
+
+    if (--req->outstanding > 0) return;
+
+    if ((user_data & URING_OP_MASK) <= URING_OP_OPEN) {
+        start_read(req);
+        return;
+    }
+
+    int status = 0;
+    if (req->read_result < 0) {
+        status = req->read_result;
+    } else if ((size_t)req->read_result != req->size) {
+        // The file changed size between statx and read
+        status = UV_EIO;
+    }
+    complete_request(req, status);
+}
+
+static void on_uring_poll(uv_poll_t* handle, int status, int events) {
+    (void)handle;
+    (void)events;
+    if (status < 0) return;
+
+    unsigned head = *uring.cq_head;
+    for (;;) {
+        unsigned tail = __atomic_load_n(uring.cq_tail, __ATOMIC_ACQUIRE);
+        if (head == tail) break;
+
+        struct io_uring_cqe* cqe = &uring.cqes[head & uring.cq_mask];
+        uint64_t user_data = cqe->user_data;
+        int res = cqe->res;
+        head++;
+        __atomic_store_n(uring.cq_head, head, __ATOMIC_RELEASE);
+
+        handle_completion(user_data, res);
+    }
+}
+
+bool catzilla_static_uring_available(uv_loop_t* loop) {
+    if (!loop) return false;
+    if (uring.ready) return uring.loop == loop;
+    if (uring.unsupported) return false;
+
+    int rc = uring_setup(loop);
+    if (rc != 0) {
+        LOG_STATIC_INFO("io_uring unavailable (%s), static files use the libuv threadpool",
+                        uv_strerror(rc));
+        uring.unsupported = true;
+        return false;
+    }
+    LOG_STATIC_DEBUG("io_uring static file backend ready (fd=%d)", uring.fd);
+    return true;
+}
+
+int catzilla_static_uring_read_file(uv_loop_t* loop, const char* path, size_t max_size,
+                                    catzilla_static_uring_cb callback, void* user_data) {
+    if (!path || !callback) return UV_EINVAL;
+    if (strlen(path) >= CATZILLA_PATH_MAX) return UV_ENAMETOOLONG;
+    if (!catzilla_static_uring_available(loop)) return UV_ENOSYS;
+    if (uring_sq_space() < 2) {
+        uring_submit();
+        if (uring_sq_space() < 2) return UV_EAGAIN;
+    }
+
+    static_uring_read_t* req = catzilla_static_alloc(sizeof(*req));
+    if (!req) return UV_ENOMEM;
+    memset(req, 0, sizeof(*req));
+    req->callback = callback;
+    req->user_data = user_data;
+    req->max_size = max_size;
+    req->fd = -1;
+    strcpy(req->path, path);
+
+    struct io_uring_sqe* sqe = uring_get_sqe();
+    sqe->opcode = IORING_OP_STATX;
+    sqe->fd = AT_FDCWD;
+    sqe->addr = (uint64_t)(uintptr_t)req->path;
+    sqe->len = STATX_TYPE | STATX_MODE | STATX_SIZE | STATX_MTIME;
+    sqe->off = (uint64_t)(uintptr_t)&req->statx_buf;
+    sqe->user_data = (uint64_t)(uintptr_t)req | URING_OP_STATX;
+
+    sqe = uring_get_sqe();
+    sqe->opcode = IORING_OP_OPENAT;
+    sqe->fd = AT_FDCWD;
+    sqe->addr = (uint64_t)(uintptr_t)req->path;
+    sqe->open_flags = O_RDONLY | O_CLOEXEC;
+    sqe->user_data = (uint64_t)(uintptr_t)req | URING_OP_OPEN;
+
+    req->outstanding = 2;
+    uring_request_started();
+    uring_schedule_submit();
+    return 0;
+}
+
+void catzilla_static_uring_shutdown(void) {
+    if (!uring.ready) return;
+
+    // The loop's handle walk closed the poll and prepare handles already
+    if (!uv_is_closing((uv_handle_t*)&uring.poll)) uv_close((uv_handle_t*)&uring.poll, NULL);
+    if (!uv_is_closing((uv_handle_t*)&uring.prepare)) uv_close((uv_handle_t*)&uring.prepare, NULL);
+    uring_unmap();
+    uring.ready = false;
+    uring.loop = NULL;
+    uring.in_flight = 0;
+    uring.prepare_active = false;
+}
+
+#else  // !CATZILLA_HAS_IO_URING
+
+bool catzilla_static_uring_available(uv_loop_t* loop) {
+    (void)loop;
+    return false;
+}
+
+int catzilla_static_uring_read_file(uv_loop_t* loop, const char* path, size_t max_size,
+                                    catzilla_static_uring_cb callback, void* user_data) {
+    (void)loop;
+    (void)path;
+    (void)max_size;
+    (void)callback;
+    (void)user_data;
+    return UV_ENOSYS;
+}
+
+void catzilla_static_uring_shutdown(void) {
+}
+
+#endif
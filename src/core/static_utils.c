@@ -7,6 +7,7 @@
 #include <sys/stat.h>
 #ifndef _WIN32
 #include <unistd.h>
+#include <strings.h>
 #endif
 #include <limits.h>
 
@@ -1,5 +1,6 @@
 #include "streaming.h"
 #include "server.h"
+#include "memory.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -27,7 +28,18 @@ static catzilla_streaming_stats_t g_streaming_stats = {0};
 // INTERNAL HELPER FUNCTIONS
 // ================================
 
+// A write that owns its buffers until it completes: a compressed chunk or
+// the header block
+typedef struct {
+    uv_write_t req;                      // req.data points at the stream
+    catzilla_compress_buffer_t* body;
+    char* headers;
+    char chunk_header[24];
+} stream_chunk_write_t;
+
 static void on_stream_write_complete(uv_write_t* req, int status);
+static void on_compressed_write_complete(uv_write_t* req, int status);
+static int stream_write_compressed(catzilla_stream_context_t* ctx, const char* data, size_t len, bool finish);
 static void stream_process_ring_buffer(catzilla_stream_context_t* ctx);
 static size_t stream_ring_buffer_available_write(catzilla_stream_context_t* ctx);
 static size_t stream_ring_buffer_available_read(catzilla_stream_context_t* ctx);
@@ -120,6 +132,7 @@ void catzilla_stream_destroy(catzilla_stream_context_t* ctx) {
     if (ctx->error_message) {
         free(ctx->error_message);
     }
+    catzilla_compressor_destroy(ctx->compressor);
 
     // Update global statistics
     atomic_fetch_sub(&g_streaming_stats.active_streams, 1);
@@ -204,11 +217,16 @@ int catzilla_stream_finish(catzilla_stream_context_t* ctx) {
     // Send any remaining data in ring buffer
     stream_process_ring_buffer(ctx);
 
+    // The compressor's trailer goes out as the last data chunk
+    if (ctx->compressor && stream_write_compressed(ctx, NULL, 0, true) != CATZILLA_STREAM_OK) {
+        return CATZILLA_STREAM_ERROR;
+    }
+
     // Send final chunk (empty chunk indicates end)
     const char* final_chunk = "0\r\n\r\n";  // HTTP chunked encoding terminator
 
     uv_buf_t buf = uv_buf_init((char*)final_chunk, strlen(final_chunk));
-    int result = uv_write(&ctx->write_req, ctx->client_handle, &buf, 1,
+    int result = catzilla_server_write(&ctx->write_req, ctx->client_handle, &buf, 1,
                          on_stream_write_complete);
 
     if (result != 0) {
@@ -283,6 +301,175 @@ const char* catzilla_extract_streaming_id(const char* body, size_t body_len) {
     return streaming_id;
 }
 
+static catzilla_stream_connect_fn g_stream_connect = NULL;
+
+void catzilla_stream_set_connect(catzilla_stream_connect_fn connect) {
+    g_stream_connect = connect;
+}
+
+catzilla_stream_connect_fn catzilla_stream_get_connect(void) {
+    return g_stream_connect;
+}
+
+// The bytes of a send the socket did not take at once
+typedef struct {
+    uv_write_t req;
+    char data[];
+} stream_copy_write_t;
+
+static void on_copy_write_complete(uv_write_t* req, int status) {
+    if (status < 0) {
+        atomic_fetch_add(&g_streaming_stats.connection_errors, 1);
+    }
+    catzilla_response_free(req);
+}
+
+int catzilla_stream_send(uv_stream_t* client, const uv_buf_t bufs[], unsigned int nbufs) {
+    if (!client || (!bufs && nbufs > 0)) {
+        return CATZILLA_STREAM_EINVAL;
+    }
+
+    size_t total = 0;
+    for (unsigned int i = 0; i < nbufs; i++) {
+        total += bufs[i].len;
+    }
+    if (total == 0) {
+        return CATZILLA_STREAM_OK;
+    }
+
+    // uv_try_write refuses while writes are queued, so order is kept
+    size_t sent = 0;
+    if (catzilla_server_can_write_raw(client)) {
+        int written = uv_try_write(client, bufs, nbufs);
+        if (written >= 0) {
+            sent = (size_t)written;
+        } else if (written != UV_EAGAIN) {
+            return CATZILLA_STREAM_ERROR;
+        }
+        if (sent == total) {
+            return CATZILLA_STREAM_OK;
+        }
+    }
+
+    stream_copy_write_t* write = catzilla_response_alloc(sizeof(*write) + total - sent);
+    if (!write) {
+        return CATZILLA_STREAM_ENOMEM;
+    }
+    size_t skip = sent;
+    size_t offset = 0;
+    for (unsigned int i = 0; i < nbufs; i++) {
+        if (skip >= bufs[i].len) {
+            skip -= bufs[i].len;
+            continue;
+        }
+        memcpy(write->data + offset, bufs[i].base + skip, bufs[i].len - skip);
+        offset += bufs[i].len - skip;
+        skip = 0;
+    }
+
+    uv_buf_t rest = uv_buf_init(write->data, (unsigned int)offset);
+    if (catzilla_server_write(&write->req, client, &rest, 1, on_copy_write_complete) != 0) {
+        catzilla_response_free(write);
+        return CATZILLA_STREAM_ERROR;
+    }
+    return CATZILLA_STREAM_OK;
+}
+
+int catzilla_stream_send_chunk(uv_stream_t* client, const char* data, size_t len) {
+    if (!client || (!data && len > 0)) {
+        return CATZILLA_STREAM_EINVAL;
+    }
+    if (len == 0) {
+        return CATZILLA_STREAM_OK;
+    }
+
+    char chunk_header[24];
+    int header_len = snprintf(chunk_header, sizeof(chunk_header), "%zx\r\n", len);
+    uv_buf_t buffers[3];
+    buffers[0] = uv_buf_init(chunk_header, (unsigned int)header_len);
+    buffers[1] = uv_buf_init((char*)data, (unsigned int)len);
+    buffers[2] = uv_buf_init("\r\n", 2);
+
+    int result = catzilla_stream_send(client, buffers, 3);
+    if (result == CATZILLA_STREAM_OK) {
+        atomic_fetch_add(&g_streaming_stats.total_bytes_streamed, len);
+    }
+    return result;
+}
+
+int catzilla_stream_send_last_chunk(uv_stream_t* client) {
+    uv_buf_t buf = uv_buf_init("0\r\n\r\n", 5);
+    return catzilla_stream_send(client, &buf, 1);
+}
+
+int catzilla_stream_set_compression(catzilla_stream_context_t* ctx, int encoding, int level) {
+    if (!ctx || ctx->headers_sent || ctx->compressor) {
+        return CATZILLA_STREAM_EINVAL;
+    }
+
+    ctx->compressor = catzilla_compressor_create(encoding, level);
+    if (!ctx->compressor) {
+        return CATZILLA_STREAM_ERROR;
+    }
+    ctx->encoding = encoding;
+    return CATZILLA_STREAM_OK;
+}
+
+int catzilla_stream_send_headers(catzilla_stream_context_t* ctx, int status_code,
+                                 const char* content_type) {
+    if (!ctx || !content_type || ctx->headers_sent) {
+        return CATZILLA_STREAM_EINVAL;
+    }
+
+    char encoding_headers[80] = "";
+    if (ctx->compressor) {
+        snprintf(encoding_headers, sizeof(encoding_headers),
+                 "Content-Encoding: %s\r\nVary: Accept-Encoding\r\n",
+                 catzilla_compression_encoding_name(ctx->encoding));
+    }
+
+    // Kept until the write completes, like the chunk buffers
+    char* response_headers = catzilla_response_alloc(1024);
+    if (!response_headers) {
+        return CATZILLA_STREAM_ENOMEM;
+    }
+    int len = snprintf(response_headers, 1024,
+                       "HTTP/1.1 %d OK\r\n"
+                       "Content-Type: %s\r\n"
+                       "%s"
+                       "Transfer-Encoding: chunked\r\n"
+                       "Cache-Control: no-cache\r\n"
+                       "Connection: keep-alive\r\n"
+                       "\r\n",
+                       status_code, content_type, encoding_headers);
+    if (len < 0 || len >= 1024) {
+        catzilla_response_free(response_headers);
+        return CATZILLA_STREAM_EINVAL;
+    }
+
+    stream_chunk_write_t* write = catzilla_response_alloc(sizeof(*write));
+    if (!write) {
+        catzilla_response_free(response_headers);
+        return CATZILLA_STREAM_ENOMEM;
+    }
+    write->req.data = ctx;
+    write->body = NULL;
+    write->headers = response_headers;
+    atomic_fetch_add(&ctx->pending_writes, 1);
+
+    uv_buf_t buf = uv_buf_init(response_headers, (unsigned int)len);
+    if (catzilla_server_write(&write->req, ctx->client_handle, &buf, 1, on_compressed_write_complete) != 0) {
+        atomic_fetch_sub(&ctx->pending_writes, 1);
+        catzilla_response_free(response_headers);
+        catzilla_response_free(write);
+        return CATZILLA_STREAM_ERROR;
+    }
+
+    ctx->headers_sent = true;
+    ctx->status_code = status_code;
+    return CATZILLA_STREAM_OK;
+}
+
 int catzilla_send_streaming_response(uv_stream_t* client,
                                     int status_code,
                                     const char* content_type,
@@ -304,7 +491,7 @@ int catzilla_send_streaming_response(uv_stream_t* client,
 
     // Send headers immediately
     uv_buf_t buf = uv_buf_init(response_headers, strlen(response_headers));
-    int result = uv_write(NULL, client, &buf, 1, NULL);
+    int result = catzilla_server_write(NULL, client, &buf, 1, NULL);
 
     if (result != 0) {
         return CATZILLA_STREAM_ERROR;
@@ -421,6 +608,11 @@ static void stream_process_ring_buffer(catzilla_stream_context_t* ctx) {
         return;
     }
 
+    if (ctx->compressor) {
+        stream_write_compressed(ctx, temp_buffer, actual_read, false);
+        return;
+    }
+
     // Format as HTTP chunked encoding
     char chunk_header[32];
     snprintf(chunk_header, sizeof(chunk_header), "%zx\r\n", actual_read);
@@ -435,7 +627,7 @@ static void stream_process_ring_buffer(catzilla_stream_context_t* ctx) {
     atomic_fetch_add(&ctx->pending_writes, 1);
 
     // Send via libuv
-    result = uv_write(&ctx->write_req, ctx->client_handle, buffers, 3,
+    result = catzilla_server_write(&ctx->write_req, ctx->client_handle, buffers, 3,
                      on_stream_write_complete);
 
     if (result != 0) {
@@ -445,6 +637,54 @@ static void stream_process_ring_buffer(catzilla_stream_context_t* ctx) {
     }
 }
 
+// Compress a chunk (or the end of the stream) and send what came out as
+// one HTTP chunk; the compressor flushes, so the client can decode it now
+static int stream_write_compressed(catzilla_stream_context_t* ctx, const char* data, size_t len, bool finish) {
+    catzilla_compress_buffer_t* out = NULL;
+    if (catzilla_compressor_write(ctx->compressor, data, len, finish, &out) != 0) {
+        ctx->error_code = CATZILLA_STREAM_ERROR;
+        return CATZILLA_STREAM_ERROR;
+    }
+    if (!out) {
+        return CATZILLA_STREAM_OK;
+    }
+
+    stream_chunk_write_t* write = catzilla_response_alloc(sizeof(*write));
+    if (!write) {
+        catzilla_compress_buffer_release(out);
+        return CATZILLA_STREAM_ENOMEM;
+    }
+    write->req.data = ctx;
+    write->body = out;
+    write->headers = NULL;
+    int header_len = snprintf(write->chunk_header, sizeof(write->chunk_header), "%zx\r\n", out->length);
+
+    uv_buf_t buffers[3];
+    buffers[0] = uv_buf_init(write->chunk_header, (unsigned int)header_len);
+    buffers[1] = uv_buf_init(out->data, (unsigned int)out->length);
+    buffers[2] = uv_buf_init("\r\n", 2);
+
+    atomic_fetch_add(&ctx->pending_writes, 1);
+    int result = catzilla_server_write(&write->req, ctx->client_handle, buffers, 3,
+                                       on_compressed_write_complete);
+    if (result != 0) {
+        atomic_fetch_sub(&ctx->pending_writes, 1);
+        ctx->error_code = result;
+        catzilla_compress_buffer_release(out);
+        catzilla_response_free(write);
+        return CATZILLA_STREAM_ERROR;
+    }
+    return CATZILLA_STREAM_OK;
+}
+
+static void on_compressed_write_complete(uv_write_t* req, int status) {
+    stream_chunk_write_t* write = (stream_chunk_write_t*)req;
+    catzilla_compress_buffer_release(write->body);
+    catzilla_response_free(write->headers);
+    on_stream_write_complete(req, status);
+    catzilla_response_free(write);
+}
+
 static void on_stream_write_complete(uv_write_t* req, int status) {
     catzilla_stream_context_t* ctx = (catzilla_stream_context_t*)req->data;
     if (!ctx) {
@@ -6,6 +6,7 @@
 #include <stddef.h>
 #include <time.h>
 #include <uv.h>
+#include "compression.h"
 
 // Platform-specific includes
 #ifdef _WIN32
@@ -178,6 +179,10 @@ typedef struct catzilla_stream_context_s {
     char* content_type;
     int status_code;
 
+    // Content coding of the body; each chunk is compressed and flushed
+    catzilla_compressor_t* compressor;
+    int encoding;                        // CATZILLA_ENCODING_*
+
     // Error handling
     int error_code;
     char* error_message;
@@ -276,6 +281,74 @@ bool catzilla_is_streaming_response(const char* body, size_t body_len);
  */
 const char* catzilla_extract_streaming_id(const char* body, size_t body_len);
 
+/**
+ * Connects a client to the StreamingResponse registered under the ID of its
+ * marker body and streams it. Called on the client's loop with the GIL held.
+ * @return 0 on success, -1 with a Python exception set
+ */
+typedef int (*catzilla_stream_connect_fn)(uv_stream_t* client, const char* streaming_id);
+
+/**
+ * Install the connect function marker responses are handed to. The Python
+ * extension installs it once at import, so sending a streamed response does
+ * not look it up again.
+ * @param connect Connect function (NULL = streaming unavailable)
+ */
+void catzilla_stream_set_connect(catzilla_stream_connect_fn connect);
+
+/**
+ * @return The installed connect function, or NULL
+ */
+catzilla_stream_connect_fn catzilla_stream_get_connect(void);
+
+/**
+ * Write bytes to a client. What the socket takes at once is written from
+ * the caller's buffers with one writev; only the rest is copied and queued.
+ * @param client Client stream
+ * @param bufs Buffers, needed only until the call returns
+ * @param nbufs Number of buffers
+ * @return 0 on success, error code on failure
+ */
+int catzilla_stream_send(uv_stream_t* client, const uv_buf_t bufs[], unsigned int nbufs);
+
+/**
+ * Write one HTTP/1.1 chunk: size line, data and CRLF go out together
+ * through catzilla_stream_send
+ * @param client Client stream
+ * @param data Chunk data
+ * @param len Length of data; an empty chunk writes nothing, since it would
+ *            end the body
+ * @return 0 on success, error code on failure
+ */
+int catzilla_stream_send_chunk(uv_stream_t* client, const char* data, size_t len);
+
+/**
+ * Write the last chunk, ending a chunked body
+ * @param client Client stream
+ * @return 0 on success, error code on failure
+ */
+int catzilla_stream_send_last_chunk(uv_stream_t* client);
+
+/**
+ * Compress the stream's body; call before its headers are sent
+ * @param ctx Stream context
+ * @param encoding CATZILLA_ENCODING_GZIP, _BR or _ZSTD
+ * @param level Level or quality
+ * @return 0 on success, error code on failure
+ */
+int catzilla_stream_set_compression(catzilla_stream_context_t* ctx, int encoding, int level);
+
+/**
+ * Send the stream's response headers, with Content-Encoding when the
+ * stream is compressed
+ * @param ctx Stream context
+ * @param status_code HTTP status code
+ * @param content_type Content-Type header
+ * @return 0 on success, error code on failure
+ */
+int catzilla_stream_send_headers(catzilla_stream_context_t* ctx, int status_code,
+                                 const char* content_type);
+
 /**
  * Send streaming response headers
  * @param client libuv client handle
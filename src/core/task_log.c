@@ -0,0 +1,848 @@
+/*
+ * Catzilla Task Log - durable write-ahead log for background tasks
+ *
+ * Segment files hold records back to back: a header, then the task payload
+ * for task records. Each header carries a CRC-32 of itself and the payload,
+ * so a scan stops cleanly at an append the crash cut short. Every open
+ * starts a new segment for appends, which keeps the old ones sealed.
+ *
+ * A completion record always lands in the same or a later segment than its
+ * task record, so dropping segments from the oldest end never brings a
+ * completed task back. Pending tasks copied forward by compaction keep
+ * their ID; if both copies survive a crash the later one wins.
+ */
+
+#include "task_log.h"
+#include "logging.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+
+// The log needs POSIX file I/O and threads; durable tasks are not available on Windows
+
+catzilla_task_log_t* catzilla_task_log_open(const char* directory,
+                                            const catzilla_task_log_config_t* config) {
+    (void)directory;
+    (void)config;
+    LOG_TASK_WARN("Durable task log is not supported on Windows");
+    return NULL;
+}
+
+void catzilla_task_log_close(catzilla_task_log_t* log) { (void)log; }
+
+int catzilla_task_log_append(catzilla_task_log_t* log, const void* payload, size_t size,
+                             bool durable, uint64_t* entry_id) {
+    (void)log; (void)payload; (void)size; (void)durable;
+    if (entry_id) *entry_id = 0;
+    return -1;
+}
+
+int catzilla_task_log_complete(catzilla_task_log_t* log, uint64_t entry_id) {
+    (void)log; (void)entry_id;
+    return -1;
+}
+
+int catzilla_task_log_replay(catzilla_task_log_t* log, catzilla_task_log_replay_fn fn, void* context) {
+    (void)log; (void)fn; (void)context;
+    return -1;
+}
+
+int catzilla_task_log_sync(catzilla_task_log_t* log) {
+    (void)log;
+    return -1;
+}
+
+int catzilla_task_log_compact(catzilla_task_log_t* log) {
+    (void)log;
+    return 0;
+}
+
+void catzilla_task_log_get_stats(catzilla_task_log_t* log, catzilla_task_log_stats_t* stats) {
+    (void)log;
+    if (stats) memset(stats, 0, sizeof(*stats));
+}
+
+#else
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <time.h>
+#include <unistd.h>
+
+#define LOG_RECORD_MAGIC 0x31515a43u  // "CZQ1"
+#define LOG_RECORD_TASK 1u
+#define LOG_RECORD_DONE 2u
+#define LOG_COMPACT_INTERVAL_MS 1000
+
+typedef struct {
+    uint32_t magic;
+    uint32_t type;
+    uint64_t entry_id;
+    uint32_t payload_len;
+    uint32_t crc;                 // Of the header with crc = 0, then the payload
+} task_log_record_t;
+
+typedef struct task_log_segment_s {
+    uint32_t id;
+    int fd;
+    uint64_t size;                // Bytes of valid records
+    uint64_t pending_bytes;       // Bytes of task records still pending
+    uint64_t pending_count;
+    bool dirty;                   // Written since the last fsync
+    char path[PATH_MAX];
+} task_log_segment_t;
+
+typedef struct task_log_entry_s {
+    struct task_log_entry_s* next;    // Hash chain
+    struct task_log_entry_s* older;   // Append order
+    struct task_log_entry_s* newer;
+    uint64_t id;
+    task_log_segment_t* segment;
+    uint64_t offset;              // Record offset in the segment
+    uint32_t size;                // Payload size
+} task_log_entry_t;
+
+struct catzilla_task_log_s {
+    char directory[PATH_MAX];
+    catzilla_task_log_config_t config;
+
+    // Segments, pending index and sequence numbers
+    pthread_mutex_t lock;
+    pthread_cond_t synced;
+    task_log_segment_t** segments;    // Oldest first
+    size_t segment_count;
+    size_t segment_capacity;
+    task_log_segment_t* active;       // Takes appends; NULL until the first one
+    uint32_t next_segment_id;
+    uint64_t next_entry_id;
+    uint64_t disk_bytes;
+    task_log_entry_t** buckets;
+    size_t bucket_count;
+    size_t entry_count;
+    task_log_entry_t* oldest;
+    task_log_entry_t* newest;
+    uint64_t written_seq;             // Records written
+    uint64_t synced_seq;              // Records known to be on disk
+    bool sync_failed;
+
+    // Held across fsyncs and segment retirement, so an fd is never
+    // closed under a running fsync; taken before lock
+    pthread_mutex_t sync_lock;
+
+    uint64_t appended;
+    uint64_t completed;
+    uint64_t replayed;
+    uint64_t syncs;
+    uint64_t compactions;
+    uint64_t moved;
+
+    // Group commit and compaction thread
+    pthread_t thread;
+    pthread_mutex_t wake_lock;
+    pthread_cond_t wake;
+    bool thread_started;
+    bool stopping;
+};
+
+// ---------------------------------------------------------------------------
+// Records
+// ---------------------------------------------------------------------------
+
+static uint32_t crc_table[256];
+static pthread_once_t crc_once = PTHREAD_ONCE_INIT;
+
+static void crc_init(void) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++) c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+        crc_table[i] = c;
+    }
+}
+
+static uint32_t crc_update(uint32_t crc, const void* data, size_t size) {
+    const unsigned char* p = data;
+    crc = ~crc;
+    while (size--) crc = crc_table[(crc ^ *p++) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+static uint32_t record_crc(const task_log_record_t* header, const void* payload) {
+    task_log_record_t copy = *header;
+    copy.crc = 0;
+    uint32_t crc = crc_update(0, &copy, sizeof(copy));
+    return header->payload_len ? crc_update(crc, payload, header->payload_len) : crc;
+}
+
+static uint64_t record_size(uint32_t payload_len) {
+    return sizeof(task_log_record_t) + payload_len;
+}
+
+static int read_full(int fd, void* buffer, size_t size, uint64_t offset) {
+    char* p = buffer;
+    while (size > 0) {
+        ssize_t n = pread(fd, p, size, (off_t)offset);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        p += n;
+        size -= (size_t)n;
+        offset += (uint64_t)n;
+    }
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// Segments
+// ---------------------------------------------------------------------------
+
+static void sync_directory(catzilla_task_log_t* log) {
+    int fd = open(log->directory, O_RDONLY);
+    if (fd < 0) return;
+    fsync(fd);
+    close(fd);
+}
+
+static task_log_segment_t* segment_open(catzilla_task_log_t* log, uint32_t id, bool create) {
+    task_log_segment_t* segment = calloc(1, sizeof(*segment));
+    if (!segment) return NULL;
+    segment->id = id;
+    snprintf(segment->path, sizeof(segment->path), "%s/wal-%08u.czq", log->directory, id);
+
+    segment->fd = open(segment->path, create ? (O_RDWR | O_CREAT | O_EXCL) : O_RDWR, 0600);
+    if (segment->fd < 0) {
+        LOG_TASK_ERROR("Cannot open task log segment %s: %s", segment->path, strerror(errno));
+        free(segment);
+        return NULL;
+    }
+    // The new file's directory entry must be durable before its records are
+    if (create) sync_directory(log);
+    return segment;
+}
+
+static int segment_list_append(catzilla_task_log_t* log, task_log_segment_t* segment) {
+    if (log->segment_count == log->segment_capacity) {
+        size_t capacity = log->segment_capacity ? log->segment_capacity * 2 : 16;
+        task_log_segment_t** segments = realloc(log->segments, sizeof(*segments) * capacity);
+        if (!segments) return -1;
+        log->segments = segments;
+        log->segment_capacity = capacity;
+    }
+    log->segments[log->segment_count++] = segment;
+    return 0;
+}
+
+// Drop the oldest segment; holds sync_lock and lock
+static void segment_retire_oldest(catzilla_task_log_t* log) {
+    task_log_segment_t* segment = log->segments[0];
+    memmove(&log->segments[0], &log->segments[1], sizeof(*log->segments) * (log->segment_count - 1));
+    log->segment_count--;
+    log->disk_bytes -= segment->size;
+    unlink(segment->path);
+    close(segment->fd);
+    free(segment);
+}
+
+// Start a new active segment; holds lock
+static int segment_roll(catzilla_task_log_t* log) {
+    task_log_segment_t* segment = segment_open(log, log->next_segment_id, true);
+    if (!segment) return -1;
+    if (segment_list_append(log, segment) != 0) {
+        unlink(segment->path);
+        close(segment->fd);
+        free(segment);
+        return -1;
+    }
+    log->next_segment_id++;
+    log->active = segment;
+    return 0;
+}
+
+// Write one record at the end of the active segment; holds lock
+static int write_record(catzilla_task_log_t* log, uint32_t type, uint64_t entry_id,
+                        const void* payload, uint32_t size, uint64_t* offset_out) {
+    uint64_t need = record_size(size);
+    if (!log->active || (log->active->size > 0 && log->active->size + need > log->config.segment_size)) {
+        if (segment_roll(log) != 0) return -1;
+    }
+    task_log_segment_t* segment = log->active;
+
+    task_log_record_t header = { LOG_RECORD_MAGIC, type, entry_id, size, 0 };
+    header.crc = record_crc(&header, payload);
+
+    struct iovec parts[2] = {
+        { &header, sizeof(header) },
+        { (void*)payload, size },
+    };
+    int count = size ? 2 : 1;
+    size_t left = (size_t)need;
+    uint64_t offset = segment->size;
+    while (left > 0) {
+        ssize_t n = pwritev(segment->fd, parts, count, (off_t)offset);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            LOG_TASK_ERROR("Cannot write task log segment %s: %s", segment->path, strerror(errno));
+            // Cut the partial record so later appends follow valid ones
+            if (ftruncate(segment->fd, (off_t)segment->size) != 0) {
+                log->active = NULL;
+            }
+            return -1;
+        }
+        left -= (size_t)n;
+        offset += (uint64_t)n;
+        // Skip what was written in the iovecs
+        size_t done = (size_t)n;
+        for (int i = 0; i < count && done > 0; i++) {
+            size_t take = done < parts[i].iov_len ? done : parts[i].iov_len;
+            parts[i].iov_base = (char*)parts[i].iov_base + take;
+            parts[i].iov_len -= take;
+            done -= take;
+        }
+    }
+
+    *offset_out = segment->size;
+    segment->size += need;
+    segment->dirty = true;
+    log->disk_bytes += need;
+    log->written_seq++;
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// Pending index
+// ---------------------------------------------------------------------------
+
+static task_log_entry_t* index_find(catzilla_task_log_t* log, uint64_t id) {
+    for (task_log_entry_t* entry = log->buckets[id % log->bucket_count]; entry; entry = entry->next) {
+        if (entry->id == id) return entry;
+    }
+    return NULL;
+}
+
+static void index_grow(catzilla_task_log_t* log) {
+    size_t bucket_count = log->bucket_count * 2;
+    task_log_entry_t** buckets = calloc(bucket_count, sizeof(*buckets));
+    if (!buckets) return;  // Longer chains, still correct
+    for (size_t i = 0; i < log->bucket_count; i++) {
+        task_log_entry_t* entry = log->buckets[i];
+        while (entry) {
+            task_log_entry_t* next = entry->next;
+            entry->next = buckets[entry->id % bucket_count];
+            buckets[entry->id % bucket_count] = entry;
+            entry = next;
+        }
+    }
+    free(log->buckets);
+    log->buckets = buckets;
+    log->bucket_count = bucket_count;
+}
+
+static void entry_place(task_log_entry_t* entry, task_log_segment_t* segment, uint64_t offset) {
+    entry->segment = segment;
+    entry->offset = offset;
+    segment->pending_count++;
+    segment->pending_bytes += record_size(entry->size);
+}
+
+static void entry_unplace(task_log_entry_t* entry) {
+    entry->segment->pending_count--;
+    entry->segment->pending_bytes -= record_size(entry->size);
+}
+
+static int index_add(catzilla_task_log_t* log, uint64_t id, uint32_t size,
+                     task_log_segment_t* segment, uint64_t offset) {
+    task_log_entry_t* entry = calloc(1, sizeof(*entry));
+    if (!entry) return -1;
+    entry->id = id;
+    entry->size = size;
+    entry_place(entry, segment, offset);
+
+    entry->next = log->buckets[id % log->bucket_count];
+    log->buckets[id % log->bucket_count] = entry;
+    entry->older = log->newest;
+    if (log->newest) log->newest->newer = entry;
+    else log->oldest = entry;
+    log->newest = entry;
+    if (++log->entry_count > log->bucket_count) index_grow(log);
+    return 0;
+}
+
+static void index_remove(catzilla_task_log_t* log, task_log_entry_t* entry) {
+    task_log_entry_t** link = &log->buckets[entry->id % log->bucket_count];
+    while (*link != entry) link = &(*link)->next;
+    *link = entry->next;
+
+    if (entry->older) entry->older->newer = entry->newer;
+    else log->oldest = entry->newer;
+    if (entry->newer) entry->newer->older = entry->older;
+    else log->newest = entry->older;
+
+    entry_unplace(entry);
+    log->entry_count--;
+    free(entry);
+}
+
+static int compare_entry_ids(const void* a, const void* b) {
+    uint64_t x = (*(task_log_entry_t* const*)a)->id, y = (*(task_log_entry_t* const*)b)->id;
+    return x < y ? -1 : x > y;
+}
+
+// Tasks copied forward are found out of order on open; put them back in ID order
+static void index_sort(catzilla_task_log_t* log) {
+    if (log->entry_count < 2) return;
+    task_log_entry_t** order = malloc(sizeof(*order) * log->entry_count);
+    if (!order) return;
+
+    size_t count = 0;
+    for (task_log_entry_t* entry = log->oldest; entry; entry = entry->newer) order[count++] = entry;
+    qsort(order, count, sizeof(*order), compare_entry_ids);
+    for (size_t i = 0; i < count; i++) {
+        order[i]->older = i > 0 ? order[i - 1] : NULL;
+        order[i]->newer = i + 1 < count ? order[i + 1] : NULL;
+    }
+    log->oldest = order[0];
+    log->newest = order[count - 1];
+    free(order);
+}
+
+// ---------------------------------------------------------------------------
+// Group commit
+// ---------------------------------------------------------------------------
+
+// fsync every segment written since the last pass and publish what is durable
+static int flush_once(catzilla_task_log_t* log) {
+    pthread_mutex_lock(&log->sync_lock);
+    pthread_mutex_lock(&log->lock);
+    uint64_t target = log->written_seq;
+    if (target == log->synced_seq) {
+        pthread_mutex_unlock(&log->lock);
+        pthread_mutex_unlock(&log->sync_lock);
+        return log->sync_failed ? -1 : 0;
+    }
+
+    int fds[16];
+    int count = 0;
+    bool more = false;
+    for (size_t i = 0; i < log->segment_count; i++) {
+        task_log_segment_t* segment = log->segments[i];
+        if (!segment->dirty) continue;
+        if (count == 16) {
+            more = true;
+            break;
+        }
+        segment->dirty = false;
+        fds[count++] = segment->fd;
+    }
+    pthread_mutex_unlock(&log->lock);
+
+    // Appends carry on while the disk catches up
+    int rc = 0;
+    for (int i = 0; i < count; i++) {
+        if (fdatasync(fds[i]) != 0) rc = -1;
+    }
+
+    pthread_mutex_lock(&log->lock);
+    log->syncs++;
+    if (rc != 0) {
+        LOG_TASK_ERROR("Task log fsync failed in %s: %s", log->directory, strerror(errno));
+        log->sync_failed = true;
+    } else if (!more && target > log->synced_seq) {
+        log->synced_seq = target;
+    }
+    pthread_cond_broadcast(&log->synced);
+    pthread_mutex_unlock(&log->lock);
+    pthread_mutex_unlock(&log->sync_lock);
+
+    // Extremely many dirty segments take more than one pass
+    return more && rc == 0 ? flush_once(log) : rc;
+}
+
+// ---------------------------------------------------------------------------
+// Compaction
+// ---------------------------------------------------------------------------
+
+static int compact_pass(catzilla_task_log_t* log) {
+    int dropped = 0;
+    char* buffer = NULL;
+    size_t buffer_size = 0;
+
+    pthread_mutex_lock(&log->sync_lock);
+    pthread_mutex_lock(&log->lock);
+    while (log->segment_count > 0 && log->segments[0] != log->active) {
+        task_log_segment_t* oldest = log->segments[0];
+
+        if (oldest->pending_count > 0) {
+            if (oldest->pending_bytes * 4 > oldest->size || log->sync_failed) break;
+
+            // Copy its pending tasks forward, then make the copies durable
+            bool moved_all = true;
+            for (task_log_entry_t* entry = log->oldest; entry && oldest->pending_count > 0; entry = entry->newer) {
+                if (entry->segment != oldest) continue;
+                if (entry->size > buffer_size) {
+                    char* grown = realloc(buffer, entry->size);
+                    if (!grown) {
+                        moved_all = false;
+                        break;
+                    }
+                    buffer = grown;
+                    buffer_size = entry->size;
+                }
+                uint64_t offset = 0;
+                if (read_full(oldest->fd, buffer, entry->size, entry->offset + sizeof(task_log_record_t)) != 0 ||
+                    write_record(log, LOG_RECORD_TASK, entry->id, buffer, entry->size, &offset) != 0) {
+                    moved_all = false;
+                    break;
+                }
+                entry_unplace(entry);
+                entry_place(entry, log->active, offset);
+                log->moved++;
+            }
+            if (!moved_all || fdatasync(log->active->fd) != 0) break;
+        }
+
+        segment_retire_oldest(log);
+        log->compactions++;
+        dropped++;
+    }
+    pthread_mutex_unlock(&log->lock);
+    pthread_mutex_unlock(&log->sync_lock);
+
+    free(buffer);
+    return dropped;
+}
+
+static void* flusher_thread(void* arg) {
+    catzilla_task_log_t* log = arg;
+    uint64_t since_compact_ms = 0;
+
+    pthread_mutex_lock(&log->wake_lock);
+    while (!log->stopping) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        uint64_t nanos = (uint64_t)deadline.tv_nsec + (uint64_t)log->config.sync_interval_ms * 1000000ULL;
+        deadline.tv_sec += (time_t)(nanos / 1000000000ULL);
+        deadline.tv_nsec = (long)(nanos % 1000000000ULL);
+        pthread_cond_timedwait(&log->wake, &log->wake_lock, &deadline);
+        if (log->stopping) break;
+        pthread_mutex_unlock(&log->wake_lock);
+
+        flush_once(log);
+        since_compact_ms += log->config.sync_interval_ms;
+        if (since_compact_ms >= LOG_COMPACT_INTERVAL_MS) {
+            since_compact_ms = 0;
+            compact_pass(log);
+        }
+
+        pthread_mutex_lock(&log->wake_lock);
+    }
+    pthread_mutex_unlock(&log->wake_lock);
+    return NULL;
+}
+
+// ---------------------------------------------------------------------------
+// Open and close
+// ---------------------------------------------------------------------------
+
+static int compare_ids(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+// Replay a segment's records into the pending index
+static void scan_segment(catzilla_task_log_t* log, task_log_segment_t* segment, off_t file_size) {
+    char* buffer = NULL;
+    size_t buffer_size = 0;
+    uint64_t offset = 0;
+
+    while (offset + sizeof(task_log_record_t) <= (uint64_t)file_size) {
+        task_log_record_t header;
+        if (read_full(segment->fd, &header, sizeof(header), offset) != 0) break;
+        if (header.magic != LOG_RECORD_MAGIC || header.payload_len > CATZILLA_TASK_LOG_MAX_PAYLOAD ||
+            record_size(header.payload_len) > (uint64_t)file_size - offset) {
+            break;
+        }
+        if (header.payload_len > buffer_size) {
+            char* grown = realloc(buffer, header.payload_len);
+            if (!grown) break;
+            buffer = grown;
+            buffer_size = header.payload_len;
+        }
+        if (header.payload_len &&
+            read_full(segment->fd, buffer, header.payload_len, offset + sizeof(header)) != 0) {
+            break;
+        }
+        if (record_crc(&header, buffer) != header.crc) break;
+
+        task_log_entry_t* entry = index_find(log, header.entry_id);
+        if (header.type == LOG_RECORD_TASK) {
+            if (entry) {
+                // Copied forward by a compaction that did not finish
+                entry_unplace(entry);
+                entry_place(entry, segment, offset);
+            } else {
+                index_add(log, header.entry_id, header.payload_len, segment, offset);
+            }
+        } else if (header.type == LOG_RECORD_DONE && entry) {
+            index_remove(log, entry);
+        }
+        if (header.entry_id >= log->next_entry_id) log->next_entry_id = header.entry_id + 1;
+        offset += record_size(header.payload_len);
+    }
+
+    if (offset < (uint64_t)file_size) {
+        LOG_TASK_WARN("Task log segment %s ends in %llu unreadable bytes", segment->path,
+                      (unsigned long long)((uint64_t)file_size - offset));
+    }
+    segment->size = offset;
+    free(buffer);
+}
+
+static int load_segments(catzilla_task_log_t* log) {
+    DIR* dir = opendir(log->directory);
+    if (!dir) return -1;
+
+    uint32_t* ids = NULL;
+    size_t count = 0, capacity = 0;
+    struct dirent* item;
+    while ((item = readdir(dir)) != NULL) {
+        unsigned id = 0;
+        char tail = 0;
+        if (sscanf(item->d_name, "wal-%8u.cz%c", &id, &tail) != 2 || tail != 'q') continue;
+        if (count == capacity) {
+            capacity = capacity ? capacity * 2 : 16;
+            uint32_t* grown = realloc(ids, sizeof(*ids) * capacity);
+            if (!grown) break;
+            ids = grown;
+        }
+        ids[count++] = id;
+    }
+    closedir(dir);
+    if (count > 0) qsort(ids, count, sizeof(*ids), compare_ids);
+
+    for (size_t i = 0; i < count; i++) {
+        if (ids[i] >= log->next_segment_id) log->next_segment_id = ids[i] + 1;
+        task_log_segment_t* segment = segment_open(log, ids[i], false);
+        if (!segment) continue;
+        struct stat st;
+        if (fstat(segment->fd, &st) != 0 || segment_list_append(log, segment) != 0) {
+            close(segment->fd);
+            free(segment);
+            continue;
+        }
+        scan_segment(log, segment, st.st_size);
+        log->disk_bytes += segment->size;
+    }
+    free(ids);
+    index_sort(log);
+    return 0;
+}
+
+catzilla_task_log_t* catzilla_task_log_open(const char* directory,
+                                            const catzilla_task_log_config_t* config) {
+    if (!directory || strlen(directory) + 32 >= PATH_MAX) return NULL;
+    pthread_once(&crc_once, crc_init);
+
+    catzilla_task_log_t* log = calloc(1, sizeof(*log));
+    if (!log) return NULL;
+    snprintf(log->directory, sizeof(log->directory), "%s", directory);
+    if (config) log->config = *config;
+    if (log->config.segment_size == 0) log->config.segment_size = CATZILLA_TASK_LOG_SEGMENT_SIZE;
+    if (log->config.sync_interval_ms == 0) log->config.sync_interval_ms = CATZILLA_TASK_LOG_SYNC_INTERVAL_MS;
+
+    if (mkdir(directory, 0700) != 0 && errno != EEXIST) {
+        LOG_TASK_ERROR("Cannot create task log directory %s: %s", directory, strerror(errno));
+        free(log);
+        return NULL;
+    }
+
+    log->bucket_count = 1024;
+    log->buckets = calloc(log->bucket_count, sizeof(*log->buckets));
+    if (!log->buckets) {
+        free(log);
+        return NULL;
+    }
+    log->next_entry_id = 1;
+    pthread_mutex_init(&log->lock, NULL);
+    pthread_cond_init(&log->synced, NULL);
+    pthread_mutex_init(&log->sync_lock, NULL);
+    pthread_mutex_init(&log->wake_lock, NULL);
+    pthread_cond_init(&log->wake, NULL);
+
+    if (load_segments(log) != 0) {
+        LOG_TASK_ERROR("Cannot read task log directory %s", directory);
+        catzilla_task_log_close(log);
+        return NULL;
+    }
+    log->replayed = log->entry_count;
+
+    if (!log->config.no_background) {
+        if (pthread_create(&log->thread, NULL, flusher_thread, log) == 0) {
+            log->thread_started = true;
+        } else {
+            LOG_TASK_WARN("Task log flusher did not start; durable appends sync on their own");
+        }
+    }
+
+    LOG_TASK_DEBUG("Task log at %s: %zu pending tasks in %zu segments",
+                   directory, log->entry_count, log->segment_count);
+    return log;
+}
+
+void catzilla_task_log_close(catzilla_task_log_t* log) {
+    if (!log) return;
+
+    if (log->thread_started) {
+        pthread_mutex_lock(&log->wake_lock);
+        log->stopping = true;
+        pthread_cond_signal(&log->wake);
+        pthread_mutex_unlock(&log->wake_lock);
+        pthread_join(log->thread, NULL);
+    }
+    flush_once(log);
+
+    task_log_entry_t* entry = log->oldest;
+    while (entry) {
+        task_log_entry_t* next = entry->newer;
+        free(entry);
+        entry = next;
+    }
+    for (size_t i = 0; i < log->segment_count; i++) {
+        close(log->segments[i]->fd);
+        free(log->segments[i]);
+    }
+    free(log->segments);
+    free(log->buckets);
+    pthread_mutex_destroy(&log->lock);
+    pthread_cond_destroy(&log->synced);
+    pthread_mutex_destroy(&log->sync_lock);
+    pthread_mutex_destroy(&log->wake_lock);
+    pthread_cond_destroy(&log->wake);
+    free(log);
+}
+
+// ---------------------------------------------------------------------------
+// Operations
+// ---------------------------------------------------------------------------
+
+int catzilla_task_log_append(catzilla_task_log_t* log, const void* payload, size_t size,
+                             bool durable, uint64_t* entry_id) {
+    if (entry_id) *entry_id = 0;
+    if (!log || (!payload && size > 0) || size > CATZILLA_TASK_LOG_MAX_PAYLOAD) return -1;
+
+    pthread_mutex_lock(&log->lock);
+    if (log->sync_failed) {
+        pthread_mutex_unlock(&log->lock);
+        return -1;
+    }
+    uint64_t id = log->next_entry_id;
+    uint64_t offset = 0;
+    if (write_record(log, LOG_RECORD_TASK, id, payload, (uint32_t)size, &offset) != 0 ||
+        index_add(log, id, (uint32_t)size, log->active, offset) != 0) {
+        pthread_mutex_unlock(&log->lock);
+        return -1;
+    }
+    log->next_entry_id++;
+    log->appended++;
+    uint64_t seq = log->written_seq;
+    pthread_mutex_unlock(&log->lock);
+
+    if (entry_id) *entry_id = id;
+    if (!durable) return 0;
+
+    // Without the flusher every durable append pays for its own fsync
+    if (!log->thread_started) return flush_once(log);
+
+    pthread_mutex_lock(&log->lock);
+    while (log->synced_seq < seq && !log->sync_failed) {
+        pthread_cond_wait(&log->synced, &log->lock);
+    }
+    int rc = log->synced_seq >= seq ? 0 : -1;
+    pthread_mutex_unlock(&log->lock);
+    return rc;
+}
+
+int catzilla_task_log_complete(catzilla_task_log_t* log, uint64_t entry_id) {
+    if (!log) return -1;
+
+    pthread_mutex_lock(&log->lock);
+    task_log_entry_t* entry = index_find(log, entry_id);
+    int rc = -1;
+    if (entry) {
+        uint64_t offset = 0;
+        rc = write_record(log, LOG_RECORD_DONE, entry_id, NULL, 0, &offset);
+        if (rc == 0) {
+            index_remove(log, entry);
+            log->completed++;
+        }
+    }
+    pthread_mutex_unlock(&log->lock);
+    return rc;
+}
+
+int catzilla_task_log_replay(catzilla_task_log_t* log, catzilla_task_log_replay_fn fn, void* context) {
+    if (!log || !fn) return -1;
+
+    char* buffer = NULL;
+    size_t buffer_size = 0;
+    int visited = 0;
+
+    pthread_mutex_lock(&log->lock);
+    for (task_log_entry_t* entry = log->oldest; entry; entry = entry->newer) {
+        if (entry->size > buffer_size) {
+            char* grown = realloc(buffer, entry->size);
+            if (!grown) {
+                visited = -1;
+                break;
+            }
+            buffer = grown;
+            buffer_size = entry->size;
+        }
+        if (entry->size && read_full(entry->segment->fd, buffer, entry->size,
+                                     entry->offset + sizeof(task_log_record_t)) != 0) {
+            visited = -1;
+            break;
+        }
+        fn(entry->id, buffer, entry->size, context);
+        visited++;
+    }
+    pthread_mutex_unlock(&log->lock);
+
+    free(buffer);
+    return visited;
+}
+
+int catzilla_task_log_sync(catzilla_task_log_t* log) {
+    if (!log) return -1;
+    return flush_once(log);
+}
+
+int catzilla_task_log_compact(catzilla_task_log_t* log) {
+    if (!log) return 0;
+    return compact_pass(log);
+}
+
+void catzilla_task_log_get_stats(catzilla_task_log_t* log, catzilla_task_log_stats_t* stats) {
+    if (!stats) return;
+    memset(stats, 0, sizeof(*stats));
+    if (!log) return;
+
+    pthread_mutex_lock(&log->lock);
+    stats->pending = log->entry_count;
+    stats->appended = log->appended;
+    stats->completed = log->completed;
+    stats->replayed = log->replayed;
+    stats->syncs = log->syncs;
+    stats->segments = log->segment_count;
+    stats->disk_bytes = log->disk_bytes;
+    stats->compactions = log->compactions;
+    stats->moved = log->moved;
+    pthread_mutex_unlock(&log->lock);
+}
+
+#endif // _WIN32
@@ -0,0 +1,134 @@
+/*
+ * Catzilla Task Log - durable write-ahead log for background tasks
+ *
+ * Tasks are appended to segment files in a directory before they are
+ * queued, and a completion record is appended once they have run. Appends
+ * go to the page cache at once; a flusher thread fsyncs every
+ * sync_interval_ms, so concurrent appends share one fsync (group commit).
+ * On open the segments are replayed and every task without a completion
+ * record is pending again, which gives at-least-once delivery. Compaction
+ * drops the oldest segments once their tasks are done, copying the few
+ * still pending forward first.
+ */
+
+#ifndef CATZILLA_TASK_LOG_H
+#define CATZILLA_TASK_LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct catzilla_task_log_s catzilla_task_log_t;
+
+#define CATZILLA_TASK_LOG_SEGMENT_SIZE (16 * 1024 * 1024)
+#define CATZILLA_TASK_LOG_SYNC_INTERVAL_MS 5
+#define CATZILLA_TASK_LOG_MAX_PAYLOAD (64 * 1024 * 1024)
+
+// Task log configuration; zero fields take the defaults above
+typedef struct catzilla_task_log_config_s {
+    size_t segment_size;          // Bytes before a new segment file is started
+    uint32_t sync_interval_ms;    // Group commit window
+    bool no_background;           // Sync and compact only when asked to
+} catzilla_task_log_config_t;
+
+typedef struct catzilla_task_log_stats_s {
+    uint64_t pending;             // Tasks appended and not completed
+    uint64_t appended;            // Task records appended since open
+    uint64_t completed;           // Completion records appended since open
+    uint64_t replayed;            // Tasks found pending on open
+    uint64_t syncs;               // fsync calls, each covering every append before it
+    uint64_t segments;
+    uint64_t disk_bytes;
+    uint64_t compactions;         // Segments dropped by compaction
+    uint64_t moved;               // Pending tasks copied forward by compaction
+} catzilla_task_log_stats_t;
+
+/**
+ * Called for each pending task, oldest first
+ * @param entry_id Task log ID, for catzilla_task_log_complete
+ * @param payload Task bytes, valid only during the call
+ * @param size Payload size
+ * @param context Caller context
+ */
+typedef void (*catzilla_task_log_replay_fn)(uint64_t entry_id, const void* payload,
+                                            size_t size, void* context);
+
+/**
+ * Open a task log in a directory, creating it if needed, and find the
+ * tasks left pending by the previous process
+ * @param directory Directory holding the segment files (one log per directory)
+ * @param config Configuration, or NULL for the defaults
+ * @return Task log, or NULL on failure (always NULL on Windows)
+ */
+catzilla_task_log_t* catzilla_task_log_open(const char* directory,
+                                            const catzilla_task_log_config_t* config);
+
+/**
+ * Sync outstanding appends, stop the flusher and free the log. The files
+ * stay on disk.
+ * @param log Task log (may be NULL)
+ */
+void catzilla_task_log_close(catzilla_task_log_t* log);
+
+/**
+ * Append a task
+ * @param log Task log
+ * @param payload Task bytes
+ * @param size Payload size
+ * @param durable Wait until the record is on disk
+ * @param entry_id Receives the task's log ID
+ * @return 0 on success, -1 on failure
+ */
+int catzilla_task_log_append(catzilla_task_log_t* log, const void* payload, size_t size,
+                             bool durable, uint64_t* entry_id);
+
+/**
+ * Record that a task has run. The record is synced with the next group
+ * commit; if it is lost the task runs again after a restart.
+ * @param log Task log
+ * @param entry_id ID from catzilla_task_log_append or the replay
+ * @return 0 on success, -1 if the task is not pending
+ */
+int catzilla_task_log_complete(catzilla_task_log_t* log, uint64_t entry_id);
+
+/**
+ * Call fn for every pending task, in append order
+ * @param log Task log
+ * @param fn Callback; it must not call back into the log
+ * @param context Passed to fn
+ * @return Number of tasks visited, or -1 on a read error
+ */
+int catzilla_task_log_replay(catzilla_task_log_t* log, catzilla_task_log_replay_fn fn, void* context);
+
+/**
+ * fsync every append so far
+ * @param log Task log
+ * @return 0 on success, -1 on failure
+ */
+int catzilla_task_log_sync(catzilla_task_log_t* log);
+
+/**
+ * Drop the oldest sealed segments: a segment goes once its tasks are done,
+ * or once at most a quarter of its bytes are pending tasks, which are
+ * copied to the active segment first
+ * @param log Task log
+ * @return Number of segments dropped
+ */
+int catzilla_task_log_compact(catzilla_task_log_t* log);
+
+/**
+ * Get task log statistics
+ * @param log Task log
+ * @param stats Receives the statistics
+ */
+void catzilla_task_log_get_stats(catzilla_task_log_t* log, catzilla_task_log_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CATZILLA_TASK_LOG_H
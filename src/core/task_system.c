@@ -1,5 +1,6 @@
 #include "task_system.h"
 #include "memory.h"
+#include "probes.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -119,26 +120,31 @@ uint64_t catzilla_task_add_c(
     return 0; // Stub - return invalid task ID
 }
 
+
 #else
 // Task system implementation - Unix/Linux/macOS only
+#include "platform_compat.h"
 #include <unistd.h>
 #include <errno.h>
 #include <sys/time.h>
 #include <assert.h>
 #include <pthread.h>
+#include <sched.h>
 
 // Platform-specific includes
 #ifdef __linux__
 #include <sys/syscall.h>
-#include <linux/futex.h>
 #endif
 
 // Atomic operation helpers
 #define ATOMIC_LOAD(ptr) atomic_load_explicit(ptr, memory_order_acquire)
 #define ATOMIC_STORE(ptr, val) atomic_store_explicit(ptr, val, memory_order_release)
-#define ATOMIC_CAS(ptr, expected, desired) \
-    atomic_compare_exchange_weak_explicit(ptr, expected, desired, \
-                                        memory_order_release, memory_order_relaxed)
+#define ATOMIC_RELAXED_ADD(ptr, val) atomic_fetch_add_explicit(ptr, val, memory_order_relaxed)
+
+#define DEQUE_MASK (TASK_DEQUE_CAPACITY - 1)
+
+// Worker running on the calling thread, NULL on producer threads
+static CATZILLA_THREAD_LOCAL worker_thread_t* current_worker = NULL;
 
 // Performance utilities
 static uint64_t get_nanoseconds(void) {
@@ -159,13 +165,34 @@ static uint64_t get_thread_id(void) {
 // LOCK-FREE QUEUE IMPLEMENTATION
 // ============================================================================
 
+struct lock_free_slot {
+    atomic_uint64_t sequence;            // Ring position this slot is ready for
+    catzilla_task_t* task;
+};
+
 lock_free_queue_t* catzilla_queue_create(const char* name, size_t max_size, catzilla_memory_type_t memory_type) {
+    if (max_size == 0 || max_size > (1ULL << 32)) return NULL;
+
     lock_free_queue_t* queue = catzilla_task_alloc(sizeof(lock_free_queue_t));
     if (!queue) return NULL;
+    memset(queue, 0, sizeof(lock_free_queue_t));
+
+    // The ring is a power of two; max_size still bounds how much it holds
+    uint64_t capacity = 2;
+    while (capacity < max_size) capacity <<= 1;
 
-    // Initialize atomic pointers to NULL
-    atomic_init(&queue->head, NULL);
-    atomic_init(&queue->tail, NULL);
+    queue->slots = catzilla_task_alloc(sizeof(struct lock_free_slot) * capacity);
+    if (!queue->slots) {
+        catzilla_task_free(queue);
+        return NULL;
+    }
+    for (uint64_t i = 0; i < capacity; i++) {
+        atomic_init(&queue->slots[i].sequence, i);
+        queue->slots[i].task = NULL;
+    }
+    queue->mask = capacity - 1;
+    atomic_init(&queue->enqueue_pos, 0);
+    atomic_init(&queue->dequeue_pos, 0);
     atomic_init(&queue->size, 0);
 
     queue->max_size = max_size;
@@ -177,7 +204,7 @@ lock_free_queue_t* catzilla_queue_create(const char* name, size_t max_size, catz
     atomic_init(&queue->contention_count, 0);
     atomic_init(&queue->overflow_count, 0);
 
-    strncpy(queue->name, name, sizeof(queue->name) - 1);
+    strncpy(queue->name, name ? name : "", sizeof(queue->name) - 1);
     queue->name[sizeof(queue->name) - 1] = '\0';
 
     return queue;
@@ -186,95 +213,73 @@ lock_free_queue_t* catzilla_queue_create(const char* name, size_t max_size, catz
 bool catzilla_queue_enqueue(lock_free_queue_t* queue, catzilla_task_t* task) {
     if (!queue || !task) return false;
 
-    // Check queue capacity
-    uint64_t current_size = ATOMIC_LOAD(&queue->size);
-    if (current_size >= queue->max_size) {
-        atomic_fetch_add(&queue->overflow_count, 1);
+    // Reserve room first so size never drops below what the ring holds;
+    // the seq_cst increment is also what parking workers check against
+    if (atomic_fetch_add(&queue->size, 1) >= queue->max_size) {
+        atomic_fetch_sub(&queue->size, 1);
+        ATOMIC_RELAXED_ADD(&queue->overflow_count, 1);
         return false;
     }
 
-    // Initialize task's next pointer
-    ATOMIC_STORE(&task->next, NULL);
-
-    // Michael & Scott lock-free queue algorithm
+    uint64_t pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);
+    struct lock_free_slot* slot;
     while (true) {
-        catzilla_task_t* tail = ATOMIC_LOAD(&queue->tail);
-        catzilla_task_t* head = ATOMIC_LOAD(&queue->head);
-
-        if (tail == NULL) {
-            // Empty queue case
-            catzilla_task_t* expected = NULL;
-            if (ATOMIC_CAS(&queue->head, &expected, task)) {
-                ATOMIC_STORE(&queue->tail, task);
-                atomic_fetch_add(&queue->size, 1);
-                atomic_fetch_add(&queue->enqueue_count, 1);
-                return true;
+        slot = &queue->slots[pos & queue->mask];
+        uint64_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        int64_t diff = (int64_t)(sequence - pos);
+
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&queue->enqueue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
             }
+            ATOMIC_RELAXED_ADD(&queue->contention_count, 1);
+        } else if (diff < 0) {
+            // Room is reserved, so a consumer has claimed this slot and is
+            // about to release it
+            ATOMIC_RELAXED_ADD(&queue->contention_count, 1);
+            sched_yield();
+            pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);
         } else {
-            // Non-empty queue case
-            catzilla_task_t* next = ATOMIC_LOAD(&tail->next);
-            if (tail == ATOMIC_LOAD(&queue->tail)) {  // tail hasn't changed
-                if (next == NULL) {
-                    // Try to link task at the end of the list
-                    if (ATOMIC_CAS(&tail->next, &next, task)) {
-                        // Enqueue is done, try to swing tail to the inserted node
-                        ATOMIC_CAS(&queue->tail, &tail, task);
-                        atomic_fetch_add(&queue->size, 1);
-                        atomic_fetch_add(&queue->enqueue_count, 1);
-                        return true;
-                    }
-                } else {
-                    // Tail is lagging, try to advance it
-                    ATOMIC_CAS(&queue->tail, &tail, next);
-                }
-            }
+            pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);
         }
-
-        // Brief pause to reduce contention
-        atomic_fetch_add(&queue->contention_count, 1);
-        sched_yield();
     }
+
+    slot->task = task;
+    atomic_store_explicit(&slot->sequence, pos + 1, memory_order_release);
+    ATOMIC_RELAXED_ADD(&queue->enqueue_count, 1);
+    return true;
 }
 
 catzilla_task_t* catzilla_queue_dequeue(lock_free_queue_t* queue) {
     if (!queue) return NULL;
 
+    uint64_t pos = atomic_load_explicit(&queue->dequeue_pos, memory_order_relaxed);
+    struct lock_free_slot* slot;
     while (true) {
-        catzilla_task_t* head = ATOMIC_LOAD(&queue->head);
-        catzilla_task_t* tail = ATOMIC_LOAD(&queue->tail);
-
-        if (head == NULL) {
-            // Empty queue
-            return NULL;
-        }
+        slot = &queue->slots[pos & queue->mask];
+        uint64_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        int64_t diff = (int64_t)(sequence - (pos + 1));
 
-        catzilla_task_t* next = ATOMIC_LOAD(&head->next);
-
-        if (head == ATOMIC_LOAD(&queue->head)) {  // head hasn't changed
-            if (head == tail) {
-                if (next == NULL) {
-                    // Queue is empty
-                    return NULL;
-                } else {
-                    // Tail is lagging, advance it
-                    ATOMIC_CAS(&queue->tail, &tail, next);
-                }
-            } else {
-                if (next != NULL) {
-                    // Try to swing head to the next node
-                    if (ATOMIC_CAS(&queue->head, &head, next)) {
-                        atomic_fetch_sub(&queue->size, 1);
-                        atomic_fetch_add(&queue->dequeue_count, 1);
-                        return head;
-                    }
-                }
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&queue->dequeue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
             }
+            ATOMIC_RELAXED_ADD(&queue->contention_count, 1);
+        } else if (diff < 0) {
+            // Empty, or the next producer has not published yet
+            return NULL;
+        } else {
+            pos = atomic_load_explicit(&queue->dequeue_pos, memory_order_relaxed);
         }
-
-        // Brief pause to reduce contention
-        atomic_fetch_add(&queue->contention_count, 1);
-        sched_yield();
     }
+
+    catzilla_task_t* task = slot->task;
+    atomic_store_explicit(&slot->sequence, pos + queue->mask + 1, memory_order_release);
+    atomic_fetch_sub(&queue->size, 1);
+    ATOMIC_RELAXED_ADD(&queue->dequeue_count, 1);
+    return task;
 }
 
 bool catzilla_queue_is_empty(lock_free_queue_t* queue) {
@@ -294,13 +299,87 @@ void catzilla_queue_destroy(lock_free_queue_t* queue) {
         catzilla_task_destroy(task);
     }
 
-    // Memory will be freed when arena is destroyed
+    catzilla_task_free(queue->slots);
+    catzilla_task_free(queue);
+}
+
+// ============================================================================
+// WORK-STEALING DEQUE (Chase-Lev, C11 orderings after Le et al. 2013)
+// ============================================================================
+
+static task_deque_t* deque_create(void) {
+    task_deque_t* deque = catzilla_task_alloc(sizeof(task_deque_t));
+    if (!deque) return NULL;
+
+    atomic_init(&deque->top, 0);
+    atomic_init(&deque->bottom, 0);
+    for (int i = 0; i < TASK_DEQUE_CAPACITY; i++) {
+        atomic_init(&deque->slots[i], NULL);
+    }
+    return deque;
+}
+
+static uint64_t deque_size(task_deque_t* deque) {
+    int_fast64_t size = atomic_load(&deque->bottom) - atomic_load(&deque->top);
+    return size > 0 ? (uint64_t)size : 0;
+}
+
+// Owner only
+static bool deque_push(task_deque_t* deque, catzilla_task_t* task) {
+    int_fast64_t bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    int_fast64_t top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    if (bottom - top >= TASK_DEQUE_CAPACITY) return false;
+
+    atomic_store_explicit(&deque->slots[bottom & DEQUE_MASK], task, memory_order_relaxed);
+    atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_release);
+    return true;
+}
+
+// Owner only: newest task first, so a worker keeps its cache warm
+static catzilla_task_t* deque_take(task_deque_t* deque) {
+    int_fast64_t bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&deque->bottom, bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    int_fast64_t top = atomic_load_explicit(&deque->top, memory_order_relaxed);
+
+    if (top > bottom) {
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+        return NULL;
+    }
+
+    catzilla_task_t* task = atomic_load_explicit(&deque->slots[bottom & DEQUE_MASK], memory_order_relaxed);
+    if (top == bottom) {
+        // Last task: thieves may be racing for it
+        if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1,
+                                                     memory_order_seq_cst, memory_order_relaxed)) {
+            task = NULL;
+        }
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+    }
+    return task;
+}
+
+// Any thread: oldest task first
+static catzilla_task_t* deque_steal(task_deque_t* deque) {
+    int_fast64_t top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    int_fast64_t bottom = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+    if (top >= bottom) return NULL;
+
+    catzilla_task_t* task = atomic_load_explicit(&deque->slots[top & DEQUE_MASK], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1,
+                                                 memory_order_seq_cst, memory_order_relaxed)) {
+        return NULL;  // Lost the race; the caller looks elsewhere
+    }
+    return task;
 }
 
 // ============================================================================
 // TASK MANAGEMENT
 // ============================================================================
 
+static void on_task_timer(catzilla_timer_entry_t* entry);
+
 catzilla_task_t* catzilla_task_create(
     task_priority_t priority,
     uint64_t delay_ms,
@@ -309,6 +388,7 @@ catzilla_task_t* catzilla_task_create(
 ) {
     catzilla_task_t* task = catzilla_task_alloc(sizeof(catzilla_task_t));
     if (!task) return NULL;
+    memset(task, 0, sizeof(catzilla_task_t));
 
     // Generate unique task ID (timestamp + random)
     static atomic_uint64_t task_counter = ATOMIC_VAR_INIT(0);
@@ -323,22 +403,13 @@ catzilla_task_t* catzilla_task_create(
     task->max_retries = max_retries;
     task->current_retries = 0;
     task->retry_backoff_factor = 2.0;
+    task->retry_delay_ms = TASK_RETRY_BASE_DELAY_MS;
+    catzilla_timer_entry_init(&task->timer, on_task_timer, task);
 
     task->memory_type = memory_type;
     task->arena_ptr = NULL;
     task->total_size = sizeof(catzilla_task_t);
 
-    task->result_data = NULL;
-    task->result_size = 0;
-    task->on_success = NULL;
-    task->on_failure = NULL;
-    task->on_retry = NULL;
-    task->callback_context = NULL;
-
-    task->execution_start = 0;
-    task->execution_end = 0;
-    task->memory_peak = 0;
-
     atomic_init(&task->next, NULL);
     atomic_init(&task->prev, NULL);
 
@@ -352,11 +423,15 @@ void catzilla_task_destroy(catzilla_task_t* task) {
     if (task->result_data) {
         catzilla_task_free(task->result_data);
     }
+    // C task data is copied in by catzilla_task_add_c
+    if (!task->is_python && task->c_task.c_data) {
+        catzilla_task_free(task->c_task.c_data);
+    }
 
-    // Task memory will be freed when appropriate
+    catzilla_task_free(task);
 }
 
-static void execute_c_task(catzilla_task_t* task) {
+static void execute_c_task(worker_thread_t* worker, catzilla_task_t* task) {
     if (!task || !task->c_task.c_func) return;
 
     task->execution_start = get_nanoseconds();
@@ -367,18 +442,428 @@ static void execute_c_task(catzilla_task_t* task) {
         task->result_size = 1024; // Default result buffer size
     }
 
-    task->result_data = catzilla_task_alloc(task->result_size);
+    // Results only live through the callbacks, so the worker's buffer
+    // serves them without an allocation per task
+    bool borrowed = task->result_size <= worker->buffer_size && worker->thread_local_buffer;
+    task->result_data = borrowed ? worker->thread_local_buffer : catzilla_task_alloc(task->result_size);
 
     // Execute the C function
+    worker->task_failed = false;
     task->c_task.c_func(task->c_task.c_data, task->result_data);
 
     task->execution_end = get_nanoseconds();
-    task->status = TASK_STATUS_COMPLETED;
+    task->status = worker->task_failed ? TASK_STATUS_FAILED : TASK_STATUS_COMPLETED;
 
     // Call success callback if provided
-    if (task->on_success) {
+    if (task->status == TASK_STATUS_COMPLETED && task->on_success) {
         task->on_success(task->result_data, task->callback_context);
     }
+
+    if (borrowed) {
+        task->result_data = NULL;
+    }
+}
+
+// ============================================================================
+// SCHEDULER
+// ============================================================================
+
+static void wake_workers(worker_pool_t* pool, bool all) {
+    // Pairs with the parked_workers increment in park_worker: either the
+    // parking worker sees the new task or this sees the parked worker
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load(&pool->parked_workers) == 0) return;
+
+    pthread_mutex_lock(&pool->pool_mutex);
+    if (all) {
+        pthread_cond_broadcast(&pool->work_available);
+    } else {
+        pthread_cond_signal(&pool->work_available);
+    }
+    pthread_mutex_unlock(&pool->pool_mutex);
+}
+
+static uint64_t next_random(worker_thread_t* worker) {
+    uint64_t x = worker->steal_seed;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    worker->steal_seed = x;
+    return x;
+}
+
+// Hold a task on the timer wheel for delay_ms; pool_mutex held
+static void schedule_timer(worker_pool_t* pool, catzilla_task_t* task, uint64_t delay_ms) {
+    uint64_t now_ms = get_nanoseconds() / 1000000ULL;
+    if (!catzilla_timer_entry_pending(&task->timer)) {
+        atomic_fetch_add(&pool->delayed_count, 1);
+    }
+    catzilla_timer_wheel_schedule(&pool->timers, &task->timer, now_ms, delay_ms);
+
+    // Timers never fire early, so this is a safe time to look again
+    uint64_t due = (now_ms + delay_ms) * 1000000ULL;
+    if (due < atomic_load(&pool->next_due)) {
+        atomic_store(&pool->next_due, due);
+    }
+}
+
+// Timer wheel callback, run under pool_mutex by the worker advancing the
+// wheel. Due tasks go onto that worker's deque for idle workers to steal.
+static void on_task_timer(catzilla_timer_entry_t* entry) {
+    catzilla_task_t* task = (catzilla_task_t*)entry->data;
+    worker_thread_t* self = current_worker;
+    worker_pool_t* pool = (worker_pool_t*)self->callback_context;
+    uint64_t now = get_nanoseconds();
+
+    // Delays longer than the wheel spans come around again until due
+    if (task->scheduled_at > now + TASK_TIMER_TICK_MS * 1000000ULL) {
+        catzilla_timer_wheel_schedule(&pool->timers, entry, now / 1000000ULL,
+                                      (task->scheduled_at - now) / 1000000ULL);
+        return;
+    }
+
+    atomic_fetch_sub(&pool->delayed_count, 1);
+    if (deque_push(self->deques[task->priority], task) ||
+        catzilla_queue_enqueue(pool->queues[task->priority], task)) {
+        return;
+    }
+
+    // Nowhere to put it yet; try again on the next tick
+    atomic_fetch_add(&pool->delayed_count, 1);
+    catzilla_timer_wheel_schedule(&pool->timers, entry, now / 1000000ULL, TASK_TIMER_TICK_MS);
+}
+
+// Fire due timers and work out when the wheel next needs a look
+static void advance_timers(worker_pool_t* pool) {
+    pthread_mutex_lock(&pool->pool_mutex);
+
+    uint64_t now_ms = get_nanoseconds() / 1000000ULL;
+    int fired = catzilla_timer_wheel_advance(&pool->timers, now_ms);
+    uint64_t wait_ms = catzilla_timer_wheel_next_expiry(&pool->timers, now_ms);
+    atomic_store(&pool->next_due, wait_ms == UINT64_MAX ? UINT64_MAX : (now_ms + wait_ms) * 1000000ULL);
+
+    if (fired > 1 && atomic_load(&pool->parked_workers) > 0) {
+        pthread_cond_broadcast(&pool->work_available);
+    }
+    pthread_mutex_unlock(&pool->pool_mutex);
+}
+
+// Put a task back on its injection queue; if that is full it waits on
+// the timer wheel for a tick
+static void requeue_task(worker_pool_t* pool, catzilla_task_t* task) {
+    if (catzilla_queue_enqueue(pool->queues[task->priority], task)) return;
+
+    task->scheduled_at = get_nanoseconds();
+    pthread_mutex_lock(&pool->pool_mutex);
+    schedule_timer(pool, task, 0);
+    pthread_mutex_unlock(&pool->pool_mutex);
+}
+
+// Exponential backoff with equal jitter: half the delay is fixed and half
+// random, so tasks that failed together do not retry together
+static uint64_t retry_backoff_ms(worker_thread_t* worker, const catzilla_task_t* task) {
+    double delay = (double)task->retry_delay_ms;
+    double factor = task->retry_backoff_factor > 1.0 ? task->retry_backoff_factor : 1.0;
+    for (int i = 1; i < task->current_retries && delay < TASK_RETRY_MAX_DELAY_MS; i++) {
+        delay *= factor;
+    }
+    if (delay > TASK_RETRY_MAX_DELAY_MS) delay = TASK_RETRY_MAX_DELAY_MS;
+
+    uint64_t full = (uint64_t)delay;
+    uint64_t half = full / 2;
+    return full - half + next_random(worker) % (half + 1);
+}
+
+// Schedule another attempt after a failure; false once retries run out
+static bool retry_task(worker_pool_t* pool, worker_thread_t* worker, catzilla_task_t* task) {
+    if (task->current_retries >= task->max_retries) {
+        if (task->on_failure) {
+            task->on_failure(NULL, task->callback_context);
+        }
+        atomic_fetch_add(&pool->engine->total_tasks_failed, 1);
+        return false;
+    }
+
+    task->current_retries++;
+    task->status = TASK_STATUS_RETRYING;
+    if (task->on_retry) {
+        task->on_retry(task->current_retries, task->callback_context);
+    }
+
+    uint64_t delay_ms = retry_backoff_ms(worker, task);
+    task->scheduled_at = get_nanoseconds() + delay_ms * 1000000ULL;
+    ATOMIC_RELAXED_ADD(&pool->retry_count, 1);
+    pthread_mutex_lock(&pool->pool_mutex);
+    schedule_timer(pool, task, delay_ms);
+    pthread_mutex_unlock(&pool->pool_mutex);
+    return true;
+}
+
+static catzilla_task_t* steal_task(worker_pool_t* pool, worker_thread_t* worker, int lane) {
+    int count = ATOMIC_LOAD(&pool->worker_count);
+    if (count < 2) return NULL;
+
+    // Random victim order keeps thieves from piling onto worker 0
+    int start = (int)(next_random(worker) % (uint64_t)count);
+    for (int i = 0; i < count; i++) {
+        worker_thread_t* victim = &pool->workers[(start + i) % count];
+        if (victim == worker) continue;
+
+        catzilla_task_t* task = deque_steal(victim->deques[lane]);
+        if (task) {
+            ATOMIC_RELAXED_ADD(&worker->steals, 1);
+            ATOMIC_RELAXED_ADD(&pool->steal_count, 1);
+            return task;
+        }
+    }
+    return NULL;
+}
+
+// Lanes are scanned in priority order; within a lane the worker's own
+// deque comes first, then the injection queue, then other workers
+static catzilla_task_t* find_task(worker_pool_t* pool, worker_thread_t* worker) {
+    uint64_t due = atomic_load_explicit(&pool->next_due, memory_order_relaxed);
+    if (due != UINT64_MAX && due <= get_nanoseconds()) {
+        advance_timers(pool);
+    }
+
+    for (int lane = 0; lane < TASK_PRIORITY_LANES; lane++) {
+        catzilla_task_t* task = deque_take(worker->deques[lane]);
+        if (task) return task;
+
+        task = catzilla_queue_dequeue(pool->queues[lane]);
+        if (task) {
+            // Stage a few more where idle workers can steal them
+            int staged = 0;
+            for (; staged < TASK_INJECTION_BATCH; staged++) {
+                catzilla_task_t* extra = catzilla_queue_dequeue(pool->queues[lane]);
+                if (!extra) break;
+                if (!deque_push(worker->deques[lane], extra)) {
+                    requeue_task(pool, extra);
+                    break;
+                }
+            }
+            if (staged > 0) wake_workers(pool, false);
+            return task;
+        }
+
+        task = steal_task(pool, worker, lane);
+        if (task) return task;
+    }
+    return NULL;
+}
+
+static bool pool_has_work(worker_pool_t* pool) {
+    for (int lane = 0; lane < TASK_PRIORITY_LANES; lane++) {
+        if (atomic_load(&pool->queues[lane]->size) > 0) return true;
+    }
+
+    int count = ATOMIC_LOAD(&pool->worker_count);
+    for (int i = 0; i < count; i++) {
+        for (int lane = 0; lane < TASK_PRIORITY_LANES; lane++) {
+            if (deque_size(pool->workers[i].deques[lane]) > 0) return true;
+        }
+    }
+    return atomic_load(&pool->next_due) <= get_nanoseconds();
+}
+
+static void park_worker(worker_pool_t* pool, worker_thread_t* worker) {
+    pthread_mutex_lock(&pool->pool_mutex);
+    atomic_fetch_add(&pool->parked_workers, 1);
+
+    // Recheck after announcing the park; producers signal under this lock
+    if (!pool_has_work(pool) && !ATOMIC_LOAD(&worker->should_stop)) {
+        uint64_t wait_ns = TASK_PARK_TIMEOUT_MS * 1000000ULL;
+        uint64_t due = atomic_load(&pool->next_due);
+        uint64_t now = get_nanoseconds();
+        if (due != UINT64_MAX && due > now && due - now < wait_ns) {
+            wait_ns = due - now;
+        }
+
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += (time_t)(wait_ns / 1000000000ULL);
+        deadline.tv_nsec += (long)(wait_ns % 1000000000ULL);
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec += 1;
+            deadline.tv_nsec -= 1000000000L;
+        }
+
+        ATOMIC_RELAXED_ADD(&pool->park_count, 1);
+        pthread_cond_timedwait(&pool->work_available, &pool->pool_mutex, &deadline);
+    }
+
+    atomic_fetch_sub(&pool->parked_workers, 1);
+    pthread_mutex_unlock(&pool->pool_mutex);
+}
+
+static void record_latency(worker_pool_t* pool, uint64_t duration_ns) {
+    int bucket = duration_ns > 0 ? 63 - __builtin_clzll(duration_ns) : 0;
+    if (bucket >= TASK_LATENCY_BUCKETS) bucket = TASK_LATENCY_BUCKETS - 1;
+    ATOMIC_RELAXED_ADD(&pool->latency_buckets[bucket], 1);
+}
+
+// Step the batch size toward what fits one time slice at the measured cost
+static void adapt_python_batch(task_engine_t* engine, int limit, uint64_t elapsed, int ran) {
+    uint64_t per_task = elapsed / (uint64_t)ran;
+    if (per_task == 0) per_task = 1;
+    uint64_t fit = engine->python_slice_ns / per_task;
+    int target = fit > TASK_PYTHON_MAX_BATCH ? TASK_PYTHON_MAX_BATCH : (fit < 1 ? 1 : (int)fit);
+
+    int diff = target - limit;
+    int step = diff / 4;
+    if (step == 0 && diff != 0) step = diff > 0 ? 1 : -1;
+    atomic_store_explicit(&engine->python_batch_size, limit + step, memory_order_relaxed);
+}
+
+// Run first and the ready Python tasks behind it in its lane in one runner
+// call, so they share a GIL hold
+static void run_python_batch(worker_pool_t* pool, worker_thread_t* worker, catzilla_task_t* first) {
+    task_engine_t* engine = pool->engine;
+    catzilla_task_t* batch[TASK_PYTHON_MAX_BATCH];
+    int limit = atomic_load_explicit(&engine->python_batch_size, memory_order_relaxed);
+    int lane = first->priority;
+    int count = 0;
+
+    batch[count++] = first;
+    while (count < limit) {
+        catzilla_task_t* next = deque_take(worker->deques[lane]);
+        if (!next) next = catzilla_queue_dequeue(pool->queues[lane]);
+        if (!next) break;
+        if (!next->is_python) {
+            // A C task ends the batch; it runs next
+            if (!deque_push(worker->deques[lane], next)) requeue_task(pool, next);
+            break;
+        }
+        batch[count++] = next;
+    }
+
+    atomic_store_explicit(&worker->current_task, first, memory_order_relaxed);
+    worker->task_start_time = get_nanoseconds();
+    for (int i = 0; i < count; i++) {
+        batch[i]->execution_start = worker->task_start_time;
+        batch[i]->status = TASK_STATUS_RUNNING;
+        CATZILLA_PROBE3(task_dequeue, batch[i]->task_id, batch[i]->priority, worker->worker_id);
+    }
+
+    int ran = engine->python_runner(batch, count, engine->python_slice_ns, engine->python_context);
+    if (ran < 1) ran = 1;
+    if (ran > count) ran = count;
+
+    uint64_t now = get_nanoseconds();
+    uint64_t elapsed = now - worker->task_start_time;
+    for (int i = 0; i < ran; i++) {
+        catzilla_task_t* task = batch[i];
+        task->execution_end = now;
+        record_latency(pool, elapsed / (uint64_t)ran);
+        CATZILLA_PROBE2(task_done, task->task_id, task->status);
+        if (task->status == TASK_STATUS_COMPLETED) {
+            atomic_fetch_add(&engine->total_tasks_completed, 1);
+            catzilla_task_destroy(task);
+        } else if (!retry_task(pool, worker, task)) {
+            task->status = TASK_STATUS_FAILED;
+            catzilla_task_destroy(task);
+        }
+    }
+    for (int i = ran; i < count; i++) {
+        batch[i]->status = TASK_STATUS_PENDING;
+        requeue_task(pool, batch[i]);
+    }
+
+    ATOMIC_RELAXED_ADD(&engine->python_batches, 1);
+    ATOMIC_RELAXED_ADD(&engine->python_batched_tasks, (uint64_t)ran);
+    if (ran < count) ATOMIC_RELAXED_ADD(&engine->python_slice_stops, 1);
+    adapt_python_batch(engine, limit, elapsed, ran);
+
+    ATOMIC_RELAXED_ADD(&worker->tasks_processed, (uint64_t)ran);
+    ATOMIC_RELAXED_ADD(&worker->total_execution_time, elapsed);
+    ATOMIC_RELAXED_ADD(&engine->total_execution_time, elapsed);
+    atomic_store_explicit(&worker->current_task, NULL, memory_order_relaxed);
+    worker->last_task_time = get_nanoseconds();
+}
+
+static void run_task(worker_pool_t* pool, worker_thread_t* worker, catzilla_task_t* task) {
+    task_engine_t* engine = pool->engine;
+    if (task->is_python) {
+        run_python_batch(pool, worker, task);
+        return;
+    }
+
+    atomic_store_explicit(&worker->current_task, task, memory_order_relaxed);
+    worker->task_start_time = get_nanoseconds();
+    CATZILLA_PROBE3(task_dequeue, task->task_id, task->priority, worker->worker_id);
+
+    bool finished = true;
+    if (task->c_task.c_func) {
+        execute_c_task(worker, task);
+        if (task->status == TASK_STATUS_COMPLETED) {
+            atomic_fetch_add(&engine->total_tasks_completed, 1);
+        } else {
+            finished = !retry_task(pool, worker, task);
+        }
+    } else {
+        // Nothing to run
+        task->status = TASK_STATUS_FAILED;
+        if (task->on_failure) {
+            task->on_failure(NULL, task->callback_context);
+        }
+        atomic_fetch_add(&engine->total_tasks_failed, 1);
+    }
+
+    uint64_t execution_time = get_nanoseconds() - worker->task_start_time;
+    ATOMIC_RELAXED_ADD(&worker->tasks_processed, 1);
+    ATOMIC_RELAXED_ADD(&worker->total_execution_time, execution_time);
+    ATOMIC_RELAXED_ADD(&engine->total_execution_time, execution_time);
+    record_latency(pool, execution_time);
+    CATZILLA_PROBE2(task_done, task->task_id, task->status);
+
+    atomic_store_explicit(&worker->current_task, NULL, memory_order_relaxed);
+    worker->last_task_time = get_nanoseconds();
+    if (finished) {
+        catzilla_task_destroy(task);
+    }
+}
+
+// Queue a task from any thread. Workers push onto their own deque, other
+// threads onto the injection queue for the task's lane.
+static bool submit_task(worker_pool_t* pool, catzilla_task_t* task) {
+    int lane = task->priority;
+
+    if (task->delay_ms > 0) {
+        pthread_mutex_lock(&pool->pool_mutex);
+        if (atomic_load(&pool->delayed_count) >= TASK_MAX_DELAYED_TASKS) {
+            pthread_mutex_unlock(&pool->pool_mutex);
+            return false;
+        }
+        schedule_timer(pool, task, task->delay_ms);
+        CATZILLA_PROBE3(task_enqueue, task->task_id, task->priority, task->delay_ms);
+        // A parked worker recomputes its timeout against the new due time
+        if (atomic_load(&pool->parked_workers) > 0) {
+            pthread_cond_signal(&pool->work_available);
+        }
+        pthread_mutex_unlock(&pool->pool_mutex);
+        return true;
+    }
+
+    worker_thread_t* self = current_worker;
+    // Fired before the task is published: a worker may finish and free it at once
+    CATZILLA_PROBE3(task_enqueue, task->task_id, task->priority, 0);
+    if (self && self->callback_context == pool && deque_push(self->deques[lane], task)) {
+        wake_workers(pool, false);
+        return true;
+    }
+
+    if (!catzilla_queue_enqueue(pool->queues[lane], task)) return false;
+    wake_workers(pool, false);
+    return true;
+}
+
+int catzilla_task_report_failure(void) {
+    worker_thread_t* self = current_worker;
+    if (!self || !atomic_load_explicit(&self->current_task, memory_order_relaxed)) return -1;
+
+    self->task_failed = true;
+    return 0;
 }
 
 // ============================================================================
@@ -402,87 +887,40 @@ static void* worker_thread_main(void* arg) {
     // Initialize thread-local memory management
     worker->local_memory_type = CATZILLA_MEMORY_TASK;
     worker->thread_local_buffer = catzilla_task_alloc(64 * 1024); // 64KB buffer
-    worker->buffer_size = 64 * 1024;
+    worker->buffer_size = worker->thread_local_buffer ? 64 * 1024 : 0;
 
+    current_worker = worker;
     ATOMIC_STORE(&worker->is_active, true);
 
     uint64_t idle_start = get_nanoseconds();
 
     while (!ATOMIC_LOAD(&worker->should_stop)) {
-        catzilla_task_t* task = NULL;
-        bool found_task = false;
-
-        // Check priority queues in order (critical -> high -> normal -> low)
-        for (int priority = 0; priority < 4; priority++) {
-            task = catzilla_queue_dequeue(pool->queues[priority]);
-            if (task) {
-                found_task = true;
-                break;
-            }
+        catzilla_task_t* task = find_task(pool, worker);
+        if (!task) {
+            park_worker(pool, worker);
+            continue;
         }
 
-        if (found_task) {
-            // Update idle time
-            uint64_t now = get_nanoseconds();
-            atomic_fetch_add(&worker->idle_time, now - idle_start);
-
-            // Execute task
-            worker->current_task = task;
-            worker->task_start_time = now;
-
-            // Check if task should be executed now
-            if (now >= task->scheduled_at) {
-                if (task->c_task.c_func) {
-                    execute_c_task(task);
-                } else {
-                    // TODO: Execute Python task
-                    task->status = TASK_STATUS_FAILED;
-                }
-
-                atomic_fetch_add(&worker->tasks_processed, 1);
-                uint64_t execution_time = get_nanoseconds() - worker->task_start_time;
-                atomic_fetch_add(&worker->total_execution_time, execution_time);
-            } else {
-                // Task is scheduled for future, put it back
-                catzilla_queue_enqueue(pool->queues[task->priority], task);
-            }
-
-            worker->current_task = NULL;
-            idle_start = get_nanoseconds();
-        } else {
-            // No tasks available, wait for work
-            pthread_mutex_lock(&pool->pool_mutex);
-
-            // Double-check for tasks while holding the lock
-            bool has_work = false;
-            for (int priority = 0; priority < 4; priority++) {
-                if (!catzilla_queue_is_empty(pool->queues[priority])) {
-                    has_work = true;
-                    break;
-                }
-            }
-
-            if (!has_work && !ATOMIC_LOAD(&worker->should_stop)) {
-                // Wait for work with timeout
-                struct timespec timeout;
-                clock_gettime(CLOCK_REALTIME, &timeout);
-                timeout.tv_nsec += 100000000; // 100ms timeout
-                if (timeout.tv_nsec >= 1000000000) {
-                    timeout.tv_sec += 1;
-                    timeout.tv_nsec -= 1000000000;
-                }
-
-                pthread_cond_timedwait(&pool->work_available, &pool->pool_mutex, &timeout);
-            }
+        atomic_fetch_add(&worker->idle_time, get_nanoseconds() - idle_start);
+        run_task(pool, worker, task);
+        idle_start = get_nanoseconds();
+    }
 
-            pthread_mutex_unlock(&pool->pool_mutex);
+    // Hand anything still in this worker's deques to the remaining workers
+    for (int lane = 0; lane < TASK_PRIORITY_LANES; lane++) {
+        catzilla_task_t* task;
+        while ((task = deque_take(worker->deques[lane])) != NULL) {
+            requeue_task(pool, task);
         }
     }
+    wake_workers(pool, true);
 
     // Cleanup
+    current_worker = NULL;
     ATOMIC_STORE(&worker->is_active, false);
     if (worker->thread_local_buffer) {
         catzilla_task_free(worker->thread_local_buffer);
+        worker->thread_local_buffer = NULL;
     }
 
     return NULL;
@@ -492,42 +930,199 @@ static void* worker_thread_main(void* arg) {
 // WORKER POOL MANAGEMENT
 // ============================================================================
 
+static bool start_worker(worker_pool_t* pool, int slot) {
+    worker_thread_t* worker = &pool->workers[slot];
+    worker->worker_id = slot;
+    atomic_store(&worker->is_active, false);
+    atomic_store(&worker->should_stop, false);
+    atomic_store(&worker->tasks_processed, 0);
+    atomic_store(&worker->total_execution_time, 0);
+    atomic_store(&worker->idle_time, 0);
+    atomic_store(&worker->steals, 0);
+    worker->steal_seed = (get_nanoseconds() ^ ((uint64_t)(slot + 1) * 0x9E3779B97F4A7C15ULL)) | 1;
+    worker->last_task_time = get_nanoseconds();
+    atomic_store(&worker->current_task, NULL);
+    worker->callback_context = pool;
+
+    return pthread_create(&worker->thread, NULL, worker_thread_main, worker) == 0;
+}
+
+// scale_mutex held
+static int scale_up_locked(worker_pool_t* pool, int additional_workers) {
+    int count = ATOMIC_LOAD(&pool->worker_count);
+    int started = 0;
+    while (started < additional_workers && count < pool->max_workers && start_worker(pool, count)) {
+        count++;
+        started++;
+        ATOMIC_STORE(&pool->worker_count, count);
+    }
+    if (started > 0) {
+        pool->last_scale_time = get_nanoseconds();
+    }
+    return started;
+}
+
+// Stop the newest workers until `keep` remain; scale_mutex held
+static int stop_workers_locked(worker_pool_t* pool, int keep) {
+    int count = ATOMIC_LOAD(&pool->worker_count);
+    int stopped = 0;
+    while (count > keep) {
+        worker_thread_t* worker = &pool->workers[count - 1];
+        ATOMIC_STORE(&worker->should_stop, true);
+
+        pthread_mutex_lock(&pool->pool_mutex);
+        pthread_cond_broadcast(&pool->work_available);
+        pthread_mutex_unlock(&pool->pool_mutex);
+
+        pthread_join(worker->thread, NULL);
+        count--;
+        stopped++;
+        ATOMIC_STORE(&pool->worker_count, count);
+    }
+    if (stopped > 0) {
+        pool->last_scale_time = get_nanoseconds();
+    }
+    return stopped;
+}
+
+int catzilla_worker_pool_scale_up(worker_pool_t* pool, int additional_workers) {
+    if (!pool || additional_workers < 0) return -1;
+
+    pthread_mutex_lock(&pool->scale_mutex);
+    int started = scale_up_locked(pool, additional_workers);
+    pthread_mutex_unlock(&pool->scale_mutex);
+    return started;
+}
+
+int catzilla_worker_pool_scale_down(worker_pool_t* pool, int workers_to_remove) {
+    if (!pool || workers_to_remove < 0) return -1;
+    // A worker cannot join itself
+    if (current_worker && current_worker->callback_context == pool) return -1;
+
+    pthread_mutex_lock(&pool->scale_mutex);
+    int count = ATOMIC_LOAD(&pool->worker_count);
+    int keep = count - workers_to_remove;
+    if (keep < pool->min_workers) keep = pool->min_workers;
+    int stopped = stop_workers_locked(pool, keep);
+    pthread_mutex_unlock(&pool->scale_mutex);
+    return stopped;
+}
+
+int catzilla_worker_pool_get_optimal_size(worker_pool_t* pool) {
+    if (!pool) return 0;
+
+    uint64_t queued = 0;
+    uint64_t capacity = 0;
+    for (int lane = 0; lane < TASK_PRIORITY_LANES; lane++) {
+        queued += catzilla_queue_size(pool->queues[lane]);
+        capacity += pool->queues[lane]->max_size;
+    }
+    double pressure = capacity > 0 ? (double)queued / (double)capacity : 0.0;
+    atomic_store(&pool->total_queue_size, queued);
+    atomic_store(&pool->queue_pressure, pressure);
+
+    int count = ATOMIC_LOAD(&pool->worker_count);
+    int optimal = count;
+    if (pressure * 100.0 > (double)pool->scale_up_threshold) {
+        optimal = count > 0 ? count * 2 : 1;
+    } else if (pressure * 100.0 < (double)pool->scale_down_threshold &&
+               atomic_load(&pool->parked_workers) > count / 2) {
+        optimal = count - 1;
+    }
+
+    if (optimal > pool->max_workers) optimal = pool->max_workers;
+    if (optimal < pool->min_workers) optimal = pool->min_workers;
+    return optimal;
+}
+
+// Grow the pool when a lane backs up; scaling down is left to explicit
+// calls since it joins threads
+static void maybe_scale_up(worker_pool_t* pool, int lane) {
+    lock_free_queue_t* queue = pool->queues[lane];
+    if (catzilla_queue_size(queue) * 100 <= queue->max_size * pool->scale_up_threshold) return;
+    if (pthread_mutex_trylock(&pool->scale_mutex) != 0) return;
+
+    uint64_t now = get_nanoseconds();
+    if (now - pool->last_scale_time >= pool->scale_cooldown_ms * 1000000ULL) {
+        int count = ATOMIC_LOAD(&pool->worker_count);
+        int optimal = catzilla_worker_pool_get_optimal_size(pool);
+        if (optimal > count) {
+            scale_up_locked(pool, optimal - count);
+        }
+        pool->last_scale_time = now;
+    }
+    pthread_mutex_unlock(&pool->scale_mutex);
+}
+
+static void worker_pool_destroy(worker_pool_t* pool);
+
 static worker_pool_t* worker_pool_create(
+    task_engine_t* engine,
     int initial_workers,
     int min_workers,
     int max_workers,
     size_t queue_size,
     catzilla_memory_type_t memory_type
 ) {
+    if (max_workers < 1 || min_workers < 0 || min_workers > max_workers) return NULL;
+    if (initial_workers > max_workers) initial_workers = max_workers;
+
     worker_pool_t* pool = catzilla_task_alloc(sizeof(worker_pool_t));
     if (!pool) return NULL;
+    memset(pool, 0, sizeof(worker_pool_t));
 
-    // Initialize worker array
-    pool->workers = catzilla_task_alloc(sizeof(worker_thread_t) * max_workers);
-    if (!pool->workers) {
-        return NULL;
+    // Initialize synchronization first so a partial pool can be destroyed
+    pthread_mutex_init(&pool->pool_mutex, NULL);
+    pthread_cond_init(&pool->work_available, NULL);
+    pthread_cond_init(&pool->worker_idle, NULL);
+    pthread_mutex_init(&pool->scale_mutex, NULL);
+    atomic_init(&pool->shutdown_requested, false);
+    atomic_init(&pool->parked_workers, 0);
+
+    pool->engine = engine;
+    catzilla_timer_wheel_init(&pool->timers, get_nanoseconds() / 1000000ULL, TASK_TIMER_TICK_MS);
+    atomic_init(&pool->delayed_count, 0);
+    atomic_init(&pool->next_due, UINT64_MAX);
+    atomic_init(&pool->retry_count, 0);
+    atomic_init(&pool->steal_count, 0);
+    atomic_init(&pool->park_count, 0);
+    for (int i = 0; i < TASK_LATENCY_BUCKETS; i++) {
+        atomic_init(&pool->latency_buckets[i], 0);
     }
 
     atomic_init(&pool->worker_count, 0);
     pool->max_workers = max_workers;
     pool->min_workers = min_workers;
 
+    // Every slot gets its deques up front: thieves may still look at a
+    // stopped worker's deques, so they live as long as the pool
+    pool->workers = catzilla_task_alloc(sizeof(worker_thread_t) * max_workers);
+    if (!pool->workers) {
+        worker_pool_destroy(pool);
+        return NULL;
+    }
+    memset(pool->workers, 0, sizeof(worker_thread_t) * max_workers);
+    for (int i = 0; i < max_workers; i++) {
+        for (int lane = 0; lane < TASK_PRIORITY_LANES; lane++) {
+            pool->workers[i].deques[lane] = deque_create();
+            if (!pool->workers[i].deques[lane]) {
+                worker_pool_destroy(pool);
+                return NULL;
+            }
+        }
+    }
+
     // Create priority queues
-    for (int i = 0; i < 4; i++) {
+    for (int i = 0; i < TASK_PRIORITY_LANES; i++) {
         char queue_name[32];
         snprintf(queue_name, sizeof(queue_name), "priority_%d", i);
         pool->queues[i] = catzilla_queue_create(queue_name, queue_size, memory_type);
         if (!pool->queues[i]) {
+            worker_pool_destroy(pool);
             return NULL;
         }
     }
 
-    // Initialize synchronization
-    pthread_mutex_init(&pool->pool_mutex, NULL);
-    pthread_cond_init(&pool->work_available, NULL);
-    pthread_cond_init(&pool->worker_idle, NULL);
-    atomic_init(&pool->shutdown_requested, false);
-
     // Initialize auto-scaling
     atomic_init(&pool->total_queue_size, 0);
     atomic_init(&pool->queue_pressure, 0.0);
@@ -545,54 +1140,54 @@ static worker_pool_t* worker_pool_create(
     pool->worker_memory_type = memory_type;
 
     // Start initial workers
-    for (int i = 0; i < initial_workers; i++) {
-        worker_thread_t* worker = &pool->workers[i];
-        worker->worker_id = i;
-        atomic_init(&worker->is_active, false);
-        atomic_init(&worker->should_stop, false);
-        atomic_init(&worker->tasks_processed, 0);
-        atomic_init(&worker->total_execution_time, 0);
-        atomic_init(&worker->idle_time, 0);
-        worker->last_task_time = get_nanoseconds();
-        worker->current_task = NULL;
-        worker->callback_context = pool;
-
-        if (pthread_create(&worker->thread, NULL, worker_thread_main, worker) == 0) {
-            atomic_fetch_add(&pool->worker_count, 1);
-        }
-    }
+    catzilla_worker_pool_scale_up(pool, initial_workers);
 
     return pool;
 }
 
+static void destroy_timer_task(catzilla_timer_entry_t* entry) {
+    catzilla_task_destroy((catzilla_task_t*)entry->data);
+}
+
 static void worker_pool_destroy(worker_pool_t* pool) {
     if (!pool) return;
 
     // Signal shutdown
     ATOMIC_STORE(&pool->shutdown_requested, true);
 
-    // Wake up all workers
-    pthread_mutex_lock(&pool->pool_mutex);
-    pthread_cond_broadcast(&pool->work_available);
-    pthread_mutex_unlock(&pool->pool_mutex);
-
-    // Stop all workers
-    int worker_count = ATOMIC_LOAD(&pool->worker_count);
-    for (int i = 0; i < worker_count; i++) {
-        worker_thread_t* worker = &pool->workers[i];
-        ATOMIC_STORE(&worker->should_stop, true);
-        pthread_join(worker->thread, NULL);
-    }
+    // Stop all workers; each hands its deques to the injection queues
+    pthread_mutex_lock(&pool->scale_mutex);
+    stop_workers_locked(pool, 0);
+    pthread_mutex_unlock(&pool->scale_mutex);
 
     // Destroy queues
-    for (int i = 0; i < 4; i++) {
+    for (int i = 0; i < TASK_PRIORITY_LANES; i++) {
         catzilla_queue_destroy(pool->queues[i]);
     }
 
+    catzilla_timer_wheel_clear(&pool->timers, destroy_timer_task);
+
+    if (pool->workers) {
+        for (int i = 0; i < pool->max_workers; i++) {
+            for (int lane = 0; lane < TASK_PRIORITY_LANES; lane++) {
+                task_deque_t* deque = pool->workers[i].deques[lane];
+                if (!deque) continue;
+                catzilla_task_t* task;
+                while ((task = deque_take(deque)) != NULL) {
+                    catzilla_task_destroy(task);
+                }
+                catzilla_task_free(deque);
+            }
+        }
+        catzilla_task_free(pool->workers);
+    }
+
     // Cleanup synchronization
     pthread_mutex_destroy(&pool->pool_mutex);
     pthread_cond_destroy(&pool->work_available);
     pthread_cond_destroy(&pool->worker_idle);
+    pthread_mutex_destroy(&pool->scale_mutex);
+    catzilla_task_free(pool);
 }
 
 // ============================================================================
@@ -610,23 +1205,13 @@ task_engine_t* catzilla_task_engine_create(
     // Create main task engine
     task_engine_t* engine = catzilla_task_alloc(sizeof(task_engine_t));
     if (!engine) return NULL;
+    memset(engine, 0, sizeof(task_engine_t));
 
     // Initialize memory types for different purposes
     engine->task_memory_type = CATZILLA_MEMORY_TASK;
     engine->result_memory_type = CATZILLA_MEMORY_TASK;
     engine->temp_memory_type = CATZILLA_MEMORY_TASK;
 
-    // Create worker pool
-    engine->pool = worker_pool_create(
-        initial_workers, min_workers, max_workers,
-        queue_size, CATZILLA_MEMORY_TASK
-    );
-
-    if (!engine->pool) {
-        catzilla_task_engine_destroy(engine);
-        return NULL;
-    }
-
     // Configure engine
     engine->enable_auto_scaling = enable_auto_scaling;
     engine->enable_performance_monitoring = true;
@@ -637,12 +1222,28 @@ task_engine_t* catzilla_task_engine_create(
     atomic_init(&engine->total_tasks_completed, 0);
     atomic_init(&engine->total_tasks_failed, 0);
     atomic_init(&engine->total_execution_time, 0);
+    atomic_init(&engine->python_batch_size, TASK_PYTHON_MAX_BATCH);
+    atomic_init(&engine->python_batches, 0);
+    atomic_init(&engine->python_batched_tasks, 0);
+    atomic_init(&engine->python_slice_stops, 0);
+    engine->python_slice_ns = TASK_PYTHON_DEFAULT_SLICE_US * 1000ULL;
     atomic_init(&engine->is_running, false);
 
     engine->start_time = get_nanoseconds();
     engine->compiled_tasks = NULL;
     engine->compiled_tasks_count = 0;
 
+    // Create worker pool
+    engine->pool = worker_pool_create(
+        engine, initial_workers, min_workers, max_workers,
+        queue_size, CATZILLA_MEMORY_TASK
+    );
+
+    if (!engine->pool) {
+        catzilla_task_free(engine);
+        return NULL;
+    }
+
     return engine;
 }
 
@@ -658,20 +1259,13 @@ int catzilla_task_engine_stop(task_engine_t* engine, bool wait_for_completion) {
 
     ATOMIC_STORE(&engine->is_running, false);
 
-    if (wait_for_completion) {
-        // Wait for all queues to be empty
-        bool all_empty = false;
-        while (!all_empty) {
-            all_empty = true;
-            for (int i = 0; i < 4; i++) {
-                if (!catzilla_queue_is_empty(engine->pool->queues[i])) {
-                    all_empty = false;
-                    break;
-                }
-            }
-            if (!all_empty) {
-                usleep(10000); // 10ms
-            }
+    if (wait_for_completion && engine->pool) {
+        // Queued tasks may sit in injection queues, deques or the delayed
+        // list, so wait on the counters rather than on any one queue
+        while (ATOMIC_LOAD(&engine->pool->worker_count) > 0 &&
+               ATOMIC_LOAD(&engine->total_tasks_completed) + ATOMIC_LOAD(&engine->total_tasks_failed) <
+                   ATOMIC_LOAD(&engine->total_tasks_queued)) {
+            usleep(1000); // 1ms
         }
     }
 
@@ -700,7 +1294,8 @@ uint64_t catzilla_task_add_c(
     uint64_t delay_ms,
     int max_retries
 ) {
-    if (!engine || !c_func) return 0;
+    if (!engine || !engine->pool || !c_func) return 0;
+    if ((int)priority < 0 || (int)priority >= TASK_PRIORITY_LANES) return 0;
 
     catzilla_task_t* task = catzilla_task_create(priority, delay_ms, max_retries, engine->task_memory_type);
     if (!task) return 0;
@@ -708,88 +1303,186 @@ uint64_t catzilla_task_add_c(
     // Copy task data
     if (data && data_size > 0) {
         task->c_task.c_data = catzilla_task_alloc(data_size);
-        if (task->c_task.c_data) {
-            memcpy(task->c_task.c_data, data, data_size);
-            task->c_task.data_size = data_size;
+        if (!task->c_task.c_data) {
+            catzilla_task_destroy(task);
+            return 0;
         }
-    } else {
-        task->c_task.c_data = NULL;
-        task->c_task.data_size = 0;
+        memcpy(task->c_task.c_data, data, data_size);
+        task->c_task.data_size = data_size;
     }
 
     task->c_task.c_func = c_func;
 
-    // Add to appropriate priority queue
-    if (catzilla_queue_enqueue(engine->pool->queues[priority], task)) {
-        atomic_fetch_add(&engine->total_tasks_queued, 1);
+    // Count before queueing so a fast worker never finishes ahead of the count
+    uint64_t task_id = task->task_id;
+    atomic_fetch_add(&engine->total_tasks_queued, 1);
+    if (submit_task(engine->pool, task)) {
+        if (engine->enable_auto_scaling) {
+            maybe_scale_up(engine->pool, priority);
+        }
+        return task_id;
+    }
+
+    // Failed to enqueue
+    atomic_fetch_sub(&engine->total_tasks_queued, 1);
+    catzilla_task_destroy(task);
+    return 0;
+}
+
+int catzilla_task_engine_set_python_runner(task_engine_t* engine, catzilla_python_batch_fn runner,
+                                           void* context, uint64_t slice_us) {
+    if (!engine || !runner || slice_us == 0) return -1;
+
+    engine->python_runner = runner;
+    engine->python_context = context;
+    engine->python_slice_ns = slice_us * 1000ULL;
+    return 0;
+}
+
+uint64_t catzilla_task_add_python(
+    task_engine_t* engine,
+    void* py_func,
+    void* py_args,
+    void* py_kwargs,
+    task_priority_t priority,
+    uint64_t delay_ms,
+    int max_retries
+) {
+    if (!engine || !engine->pool || !engine->python_runner || !py_func || !py_args) return 0;
+    if ((int)priority < 0 || (int)priority >= TASK_PRIORITY_LANES) return 0;
+
+    catzilla_task_t* task = catzilla_task_create(priority, delay_ms, max_retries, engine->task_memory_type);
+    if (!task) return 0;
 
-        // Signal workers
-        pthread_mutex_lock(&engine->pool->pool_mutex);
-        pthread_cond_broadcast(&engine->pool->work_available);
-        pthread_mutex_unlock(&engine->pool->pool_mutex);
+    task->is_python = true;
+    task->py_task.py_func = py_func;
+    task->py_task.py_args = py_args;
+    task->py_task.py_kwargs = py_kwargs;
 
-        return task->task_id;
+    uint64_t task_id = task->task_id;
+    atomic_fetch_add(&engine->total_tasks_queued, 1);
+    if (submit_task(engine->pool, task)) {
+        if (engine->enable_auto_scaling) {
+            maybe_scale_up(engine->pool, priority);
+        }
+        return task_id;
     }
 
-    // Failed to enqueue
+    // The caller keeps its references
+    atomic_fetch_sub(&engine->total_tasks_queued, 1);
     catzilla_task_destroy(task);
     return 0;
 }
 
+static double latency_percentile_ms(worker_pool_t* pool, double quantile) {
+    uint64_t counts[TASK_LATENCY_BUCKETS];
+    uint64_t total = 0;
+    for (int i = 0; i < TASK_LATENCY_BUCKETS; i++) {
+        counts[i] = atomic_load_explicit(&pool->latency_buckets[i], memory_order_relaxed);
+        total += counts[i];
+    }
+    if (total == 0) return 0.0;
+
+    // Report the bucket's upper bound, so the estimate never flatters
+    uint64_t target = (uint64_t)((double)total * quantile);
+    if (target == 0) target = 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < TASK_LATENCY_BUCKETS; i++) {
+        seen += counts[i];
+        if (seen >= target) {
+            return (double)(1ULL << (i + 1)) / 1000000.0;
+        }
+    }
+    return (double)(1ULL << TASK_LATENCY_BUCKETS) / 1000000.0;
+}
+
 task_engine_stats_t catzilla_task_engine_get_stats(task_engine_t* engine) {
     task_engine_stats_t stats = {0};
 
-    if (!engine) return stats;
+    if (!engine || !engine->pool) return stats;
+    worker_pool_t* pool = engine->pool;
 
-    // Queue metrics
-    stats.critical_queue_size = catzilla_queue_size(engine->pool->queues[0]);
-    stats.high_queue_size = catzilla_queue_size(engine->pool->queues[1]);
-    stats.normal_queue_size = catzilla_queue_size(engine->pool->queues[2]);
-    stats.low_queue_size = catzilla_queue_size(engine->pool->queues[3]);
-    stats.total_queued = stats.critical_queue_size + stats.high_queue_size +
-                        stats.normal_queue_size + stats.low_queue_size;
+    // Queue metrics: each lane's injection queue plus the workers' deques
+    uint64_t lane_sizes[TASK_PRIORITY_LANES];
+    uint64_t capacity = 0;
+    for (int lane = 0; lane < TASK_PRIORITY_LANES; lane++) {
+        lane_sizes[lane] = catzilla_queue_size(pool->queues[lane]);
+        capacity += pool->queues[lane]->max_size;
+    }
 
     // Worker metrics
     int active_workers = 0;
     int idle_workers = 0;
-    uint64_t total_tasks_processed = 0;
     uint64_t total_execution_time = 0;
+    uint64_t total_idle_time = 0;
 
-    int worker_count = ATOMIC_LOAD(&engine->pool->worker_count);
+    int worker_count = ATOMIC_LOAD(&pool->worker_count);
     for (int i = 0; i < worker_count; i++) {
-        worker_thread_t* worker = &engine->pool->workers[i];
+        worker_thread_t* worker = &pool->workers[i];
+        for (int lane = 0; lane < TASK_PRIORITY_LANES; lane++) {
+            lane_sizes[lane] += deque_size(worker->deques[lane]);
+        }
         if (ATOMIC_LOAD(&worker->is_active)) {
-            if (worker->current_task) {
+            if (atomic_load_explicit(&worker->current_task, memory_order_relaxed)) {
                 active_workers++;
             } else {
                 idle_workers++;
             }
-            total_tasks_processed += ATOMIC_LOAD(&worker->tasks_processed);
             total_execution_time += ATOMIC_LOAD(&worker->total_execution_time);
+            total_idle_time += ATOMIC_LOAD(&worker->idle_time);
         }
     }
 
+    stats.critical_queue_size = lane_sizes[TASK_PRIORITY_CRITICAL];
+    stats.high_queue_size = lane_sizes[TASK_PRIORITY_HIGH];
+    stats.normal_queue_size = lane_sizes[TASK_PRIORITY_NORMAL];
+    stats.low_queue_size = lane_sizes[TASK_PRIORITY_LOW];
+    stats.total_queued = stats.critical_queue_size + stats.high_queue_size +
+                        stats.normal_queue_size + stats.low_queue_size;
+    stats.queue_pressure = capacity > 0 ? (double)stats.total_queued / (double)capacity : 0.0;
+
     stats.active_workers = active_workers;
     stats.idle_workers = idle_workers;
     stats.total_workers = worker_count;
+    if (total_execution_time + total_idle_time > 0) {
+        stats.avg_worker_utilization = (double)total_execution_time /
+                                       (double)(total_execution_time + total_idle_time);
+    }
+    stats.worker_memory_usage = (uint64_t)worker_count * 64 * 1024;
 
     // Performance metrics
+    uint64_t completed = ATOMIC_LOAD(&engine->total_tasks_completed);
+    uint64_t failed = ATOMIC_LOAD(&engine->total_tasks_failed);
+    uint64_t processed = completed + failed;
     uint64_t uptime_ns = get_nanoseconds() - engine->start_time;
     if (uptime_ns > 0) {
-        stats.tasks_per_second = (total_tasks_processed * 1000000000ULL) / uptime_ns;
+        stats.tasks_per_second = (processed * 1000000000ULL) / uptime_ns;
     }
 
-    if (total_tasks_processed > 0) {
-        stats.avg_execution_time_ms = (double)total_execution_time / (total_tasks_processed * 1000000.0);
+    if (processed > 0) {
+        stats.avg_execution_time_ms = (double)ATOMIC_LOAD(&engine->total_execution_time) /
+                                      (processed * 1000000.0);
     }
+    stats.p95_execution_time_ms = latency_percentile_ms(pool, 0.95);
+    stats.p99_execution_time_ms = latency_percentile_ms(pool, 0.99);
+
+    // Scheduler metrics
+    stats.delayed_tasks = ATOMIC_LOAD(&pool->delayed_count);
+    stats.retry_count = ATOMIC_LOAD(&pool->retry_count);
+    stats.steal_count = ATOMIC_LOAD(&pool->steal_count);
+    stats.park_count = ATOMIC_LOAD(&pool->park_count);
+    stats.python_batch_size = atomic_load_explicit(&engine->python_batch_size, memory_order_relaxed);
+    stats.python_batches = ATOMIC_LOAD(&engine->python_batches);
+    stats.python_batched_tasks = ATOMIC_LOAD(&engine->python_batched_tasks);
+    stats.python_slice_stops = ATOMIC_LOAD(&engine->python_slice_stops);
 
     // Engine metrics
     stats.uptime_seconds = uptime_ns / 1000000000ULL;
-    stats.total_tasks_processed = ATOMIC_LOAD(&engine->total_tasks_completed);
-    stats.failed_tasks = ATOMIC_LOAD(&engine->total_tasks_failed);
+    stats.total_tasks_processed = completed;
+    stats.failed_tasks = failed;
 
-    if (stats.total_tasks_processed > 0) {
-        stats.error_rate = (double)stats.failed_tasks / stats.total_tasks_processed;
+    if (processed > 0) {
+        stats.error_rate = (double)failed / processed;
     }
 
     return stats;
@@ -6,6 +6,7 @@
 #include <time.h>
 #include "memory.h"
 #include "platform_atomic.h"
+#include "timer_wheel.h"
 
 #ifndef _WIN32
 #include <pthread.h>
@@ -44,16 +45,51 @@ typedef struct catzilla_task catzilla_task_t;
 #ifndef _WIN32
 // Full implementation for Unix/Linux/macOS
 typedef struct lock_free_queue lock_free_queue_t;
+typedef struct task_deque task_deque_t;
 typedef struct worker_thread worker_thread_t;
 typedef struct worker_pool worker_pool_t;
 typedef struct task_engine task_engine_t;
 
+// One lane per task_priority_t value
+#define TASK_PRIORITY_LANES 4
+
+// Slots in each worker's per-lane deque (power of two); a full deque
+// overflows into the pool's injection queue
+#define TASK_DEQUE_CAPACITY 256
+
+// Extra tasks a worker moves from an injection queue into its own deque,
+// where idle workers can steal them
+#define TASK_INJECTION_BATCH 4
+
+// Longest a parked worker sleeps before rechecking for work
+#define TASK_PARK_TIMEOUT_MS 100
+
+// Execution time histogram: bucket i counts tasks that ran for [2^i, 2^(i+1)) ns
+#define TASK_LATENCY_BUCKETS 40
+
+// Resolution of the delay and retry timer wheel
+#define TASK_TIMER_TICK_MS 1
+
+// Most delayed and retrying tasks a pool holds at once
+#define TASK_MAX_DELAYED_TASKS (1 << 24)
+
+// Retry backoff: the first retry waits about TASK_RETRY_BASE_DELAY_MS,
+// each later one retry_backoff_factor times longer, capped, with jitter
+#define TASK_RETRY_BASE_DELAY_MS 100
+#define TASK_RETRY_MAX_DELAY_MS 60000
+
+// Python tasks run in batches under one GIL hold. The batch size adapts
+// so a batch fills about one time slice, between 1 and this many tasks.
+#define TASK_PYTHON_MAX_BATCH 64
+#define TASK_PYTHON_DEFAULT_SLICE_US 2000
+
 // Task structure with zero-copy optimization
 struct catzilla_task {
     // Task identification and metadata
     uint64_t task_id;                    // Unique identifier
     task_priority_t priority;            // Task priority level
     task_status_t status;                // Current status
+    bool is_python;                      // py_task is set; runs through the Python runner
 
     // Execution context - union for memory efficiency
     union {
@@ -79,6 +115,8 @@ struct catzilla_task {
     int max_retries;                     // Maximum retry attempts
     int current_retries;                 // Current retry count
     double retry_backoff_factor;         // Exponential backoff factor
+    uint64_t retry_delay_ms;             // Backoff before the first retry
+    catzilla_timer_entry_t timer;        // Pending delay or retry backoff
 
     // Memory management with jemalloc optimization
     catzilla_memory_type_t memory_type;      // Memory allocation type for this task
@@ -99,14 +137,18 @@ struct catzilla_task {
     uint64_t memory_peak;                // Peak memory usage
 
     // Linked list for queue management
-    atomic_ptr_t next;                   // Next task in queue (atomic for lock-free)
+    atomic_ptr_t next;                   // Next task in the pool's delayed list
     atomic_ptr_t prev;                   // Previous task (for removal)
 };
 
-// Lock-free queue with atomic operations
+struct lock_free_slot;
+
+// Bounded lock-free MPMC queue (Vyukov ring with per-slot sequence numbers)
 struct lock_free_queue {
-    atomic_ptr_t head;                   // Queue head (atomic)
-    atomic_ptr_t tail;                   // Queue tail (atomic)
+    struct lock_free_slot* slots;        // Ring of capacity slots
+    uint64_t mask;                       // Capacity - 1, capacity is a power of two
+    atomic_uint64_t enqueue_pos;         // Next slot a producer claims
+    atomic_uint64_t dequeue_pos;         // Next slot a consumer claims
     atomic_uint64_t size;                // Current queue size
     uint64_t max_size;                   // Maximum capacity
 
@@ -123,6 +165,15 @@ struct lock_free_queue {
     char name[64];
 };
 
+// Chase-Lev deque: the owning worker pushes and takes at the bottom,
+// other workers steal from the top
+struct task_deque {
+    atomic_int_fast64_t top;             // Next slot a thief steals
+    char pad[64];                        // Keep thieves off the owner's line
+    atomic_int_fast64_t bottom;          // Next slot the owner pushes
+    atomic_ptr_t slots[TASK_DEQUE_CAPACITY];
+};
+
 // Worker thread with thread-local optimization
 struct worker_thread {
     pthread_t thread;                    // OS thread handle
@@ -133,6 +184,11 @@ struct worker_thread {
     // Context and memory management
     void* callback_context;              // Reference to parent pool
 
+    // Work-stealing deques, one per priority lane
+    task_deque_t* deques[TASK_PRIORITY_LANES];
+    uint64_t steal_seed;                 // xorshift state for victims and retry jitter
+    atomic_uint64_t steals;              // Tasks taken from other workers
+
     // Performance metrics
     atomic_uint64_t tasks_processed;     // Total tasks processed
     atomic_uint64_t total_execution_time; // Total execution time (ns)
@@ -145,8 +201,9 @@ struct worker_thread {
     size_t buffer_size;                  // Buffer size
 
     // Current task context
-    catzilla_task_t* current_task;       // Currently executing task
+    atomic_ptr_t current_task;           // Currently executing task
     uint64_t task_start_time;            // Current task start time
+    bool task_failed;                    // Set by catzilla_task_report_failure
 
     // Worker statistics
     double cpu_utilization;              // CPU usage percentage
@@ -161,14 +218,22 @@ struct worker_pool {
     int max_workers;                     // Maximum allowed workers
     int min_workers;                     // Minimum required workers
 
-    // Priority queues - one per priority level
-    lock_free_queue_t* queues[4];        // Priority-based queues
+    // Global injection queues, one per priority lane, for producers that
+    // are not workers (the event loop, Python threads)
+    lock_free_queue_t* queues[TASK_PRIORITY_LANES];
 
     // Synchronization primitives
-    pthread_mutex_t pool_mutex;          // Pool state protection
+    pthread_mutex_t pool_mutex;          // Parking and delayed list protection
     pthread_cond_t work_available;       // Work availability signal
     pthread_cond_t worker_idle;          // Worker idle signal
+    pthread_mutex_t scale_mutex;         // Serializes scale up/down
     atomic_bool shutdown_requested;      // Shutdown flag
+    atomic_int parked_workers;           // Workers waiting on work_available
+
+    // Delayed and retrying tasks, under pool_mutex
+    catzilla_timer_wheel_t timers;
+    atomic_uint64_t delayed_count;
+    atomic_uint64_t next_due;            // Earliest time a timer may fire (ns), UINT64_MAX if none
 
     // Auto-scaling metrics
     atomic_uint64_t total_queue_size;    // Combined queue size
@@ -184,10 +249,29 @@ struct worker_pool {
     atomic_double_t p95_response_time;   // 95th percentile response time
     atomic_double_t p99_response_time;   // 99th percentile response time
 
+    // Scheduler counters
+    atomic_uint64_t retry_count;         // Retries scheduled after a failure
+    atomic_uint64_t steal_count;         // Tasks stolen between workers
+    atomic_uint64_t park_count;          // Times a worker parked
+    atomic_uint64_t latency_buckets[TASK_LATENCY_BUCKETS];
+
     // Memory pool for workers
     catzilla_memory_type_t worker_memory_type; // Memory type for worker-related allocations
+
+    task_engine_t* engine;               // Owning engine, for its counters
 };
 
+/**
+ * Runs a batch of Python tasks under one GIL hold, in order, setting each
+ * one's status to TASK_STATUS_COMPLETED or TASK_STATUS_FAILED. Stops after
+ * the task that passes slice_ns, but always runs at least one. Drops the
+ * task's Python references once it will not run again: it completed, or
+ * it failed with current_retries >= max_retries.
+ * @return Number of tasks run; the engine requeues the rest
+ */
+typedef int (*catzilla_python_batch_fn)(catzilla_task_t** tasks, int count,
+                                        uint64_t slice_ns, void* context);
+
 // Main task engine
 struct task_engine {
     worker_pool_t* pool;                 // Worker pool
@@ -208,6 +292,15 @@ struct task_engine {
     atomic_uint64_t total_tasks_failed;  // Total failed tasks
     atomic_uint64_t total_execution_time; // Total execution time across all tasks
 
+    // Python task batching
+    catzilla_python_batch_fn python_runner;
+    void* python_context;
+    uint64_t python_slice_ns;            // Time slice of one batch
+    atomic_int python_batch_size;        // Current adaptive batch size
+    atomic_uint64_t python_batches;      // Runner calls, one GIL hold each
+    atomic_uint64_t python_batched_tasks; // Python tasks run by those calls
+    atomic_uint64_t python_slice_stops;  // Batches cut short by the time slice
+
     // Engine state
     atomic_bool is_running;              // Engine running state
     uint64_t start_time;                 // Engine start time
@@ -244,6 +337,25 @@ uint64_t catzilla_task_add_c(
     int max_retries
 );
 
+/**
+ * Set the function that runs Python tasks. Call before adding any.
+ * @param engine Task engine
+ * @param runner Batch runner, which holds the GIL while it runs
+ * @param context Passed to every runner call
+ * @param slice_us Time slice of one batch in microseconds
+ * @return 0 on success, -1 on invalid arguments
+ */
+int catzilla_task_engine_set_python_runner(task_engine_t* engine, catzilla_python_batch_fn runner,
+                                           void* context, uint64_t slice_us);
+
+/**
+ * Queue a Python callable. The engine takes over the caller's references
+ * on success and hands them to the runner.
+ * @param py_func Callable
+ * @param py_args Argument tuple
+ * @param py_kwargs Keyword dict or NULL
+ * @return Task ID, or 0 when no runner is set or the queue is full
+ */
 uint64_t catzilla_task_add_python(
     task_engine_t* engine,
     void* py_func,
@@ -254,6 +366,14 @@ uint64_t catzilla_task_add_python(
     int max_retries
 );
 
+/**
+ * Mark the C task running on this thread as failed. Called from inside the
+ * task function; the engine retries it with exponential backoff and jitter
+ * until max_retries runs out, then calls on_failure.
+ * @return 0 on success, -1 when not called from inside a task
+ */
+int catzilla_task_report_failure(void);
+
 bool catzilla_task_cancel(task_engine_t* engine, uint64_t task_id);
 task_status_t catzilla_task_get_status(task_engine_t* engine, uint64_t task_id);
 
@@ -298,6 +418,17 @@ typedef struct {
     uint64_t timeout_count;
     double error_rate;
 
+    // Scheduler metrics
+    uint64_t delayed_tasks;
+    uint64_t steal_count;
+    uint64_t park_count;
+
+    // Python task batching
+    int python_batch_size;
+    uint64_t python_batches;
+    uint64_t python_batched_tasks;
+    uint64_t python_slice_stops;
+
     // Engine metrics
     uint64_t uptime_seconds;
     uint64_t total_tasks_processed;
@@ -308,8 +439,29 @@ typedef struct {
 task_engine_stats_t catzilla_task_engine_get_stats(task_engine_t* engine);
 
 // Worker pool management
+
+/**
+ * Start more workers, up to max_workers
+ * @param pool Worker pool
+ * @param additional_workers Workers to add
+ * @return Number of workers started, or -1 on invalid arguments
+ */
 int catzilla_worker_pool_scale_up(worker_pool_t* pool, int additional_workers);
+
+/**
+ * Stop and join the newest workers, down to min_workers; their queued
+ * tasks move to the injection queues first. Must not be called from a worker.
+ * @param pool Worker pool
+ * @param workers_to_remove Workers to stop
+ * @return Number of workers stopped, or -1 on invalid arguments
+ */
 int catzilla_worker_pool_scale_down(worker_pool_t* pool, int workers_to_remove);
+
+/**
+ * Suggest a worker count from the current queue pressure
+ * @param pool Worker pool
+ * @return Worker count between min_workers and max_workers
+ */
 int catzilla_worker_pool_get_optimal_size(worker_pool_t* pool);
 
 // Queue operations
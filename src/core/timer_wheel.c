@@ -0,0 +1,188 @@
+#include "timer_wheel.h"
+#include <string.h>
+
+#define WHEEL_MASK (CATZILLA_TIMER_WHEEL_SLOTS - 1)
+#define WHEEL_MAX_DELTA ((1ull << (CATZILLA_TIMER_WHEEL_BITS * CATZILLA_TIMER_WHEEL_LEVELS)) - 1)
+
+void catzilla_timer_wheel_init(catzilla_timer_wheel_t* wheel, uint64_t now_ms, uint64_t tick_ms) {
+    if (!wheel) return;
+    memset(wheel, 0, sizeof(*wheel));
+    wheel->base_ms = now_ms;
+    wheel->tick_ms = tick_ms > 0 ? tick_ms : 1;
+}
+
+void catzilla_timer_entry_init(catzilla_timer_entry_t* entry, catzilla_timer_fn callback, void* data) {
+    if (!entry) return;
+    memset(entry, 0, sizeof(*entry));
+    entry->callback = callback;
+    entry->data = data;
+}
+
+static uint64_t wheel_tick_of(const catzilla_timer_wheel_t* wheel, uint64_t now_ms) {
+    return now_ms > wheel->base_ms ? (now_ms - wheel->base_ms) / wheel->tick_ms : 0;
+}
+
+static void wheel_link(catzilla_timer_entry_t** head, catzilla_timer_entry_t* entry) {
+    entry->next = *head;
+    if (*head) {
+        (*head)->pprev = &entry->next;
+    }
+    *head = entry;
+    entry->pprev = head;
+}
+
+static void wheel_unlink(catzilla_timer_entry_t* entry) {
+    *entry->pprev = entry->next;
+    if (entry->next) {
+        entry->next->pprev = entry->pprev;
+    }
+    entry->next = NULL;
+    entry->pprev = NULL;
+}
+
+// Place an entry in the level whose span holds its remaining delay
+static void wheel_insert(catzilla_timer_wheel_t* wheel, catzilla_timer_entry_t* entry) {
+    uint64_t delta = entry->expires - wheel->current;
+    if (delta > WHEEL_MAX_DELTA) {
+        delta = WHEEL_MAX_DELTA;
+        entry->expires = wheel->current + delta;
+    }
+    uint64_t expires = entry->expires;
+    int level = 0;
+    while (level < CATZILLA_TIMER_WHEEL_LEVELS - 1 &&
+           delta >= (1ull << (CATZILLA_TIMER_WHEEL_BITS * (level + 1)))) {
+        level++;
+    }
+
+    int slot = (int)((expires >> (CATZILLA_TIMER_WHEEL_BITS * level)) & WHEEL_MASK);
+    wheel_link(&wheel->slots[level][slot], entry);
+}
+
+void catzilla_timer_wheel_schedule(catzilla_timer_wheel_t* wheel, catzilla_timer_entry_t* entry,
+                                   uint64_t now_ms, uint64_t timeout_ms) {
+    if (!wheel || !entry) return;
+
+    if (entry->pprev) {
+        wheel_unlink(entry);
+    } else {
+        wheel->count++;
+    }
+
+    // Round up so a timer never fires early, and never lands in the past
+    uint64_t ticks = (timeout_ms + wheel->tick_ms - 1) / wheel->tick_ms;
+    if (ticks == 0) ticks = 1;
+    if (ticks > WHEEL_MAX_DELTA) ticks = WHEEL_MAX_DELTA;
+
+    entry->expires = wheel_tick_of(wheel, now_ms) + ticks;
+    if (entry->expires < wheel->current) {
+        entry->expires = wheel->current;
+    }
+    wheel_insert(wheel, entry);
+}
+
+void catzilla_timer_wheel_cancel(catzilla_timer_wheel_t* wheel, catzilla_timer_entry_t* entry) {
+    if (!wheel || !entry || !entry->pprev) return;
+    wheel_unlink(entry);
+    wheel->count--;
+}
+
+// Move one slot of a higher level down to the levels below it
+static void wheel_cascade(catzilla_timer_wheel_t* wheel, int level, int slot) {
+    catzilla_timer_entry_t* entry = wheel->slots[level][slot];
+    wheel->slots[level][slot] = NULL;
+
+    while (entry) {
+        catzilla_timer_entry_t* next = entry->next;
+        entry->next = NULL;
+        entry->pprev = NULL;
+        wheel_insert(wheel, entry);
+        entry = next;
+    }
+}
+
+int catzilla_timer_wheel_advance(catzilla_timer_wheel_t* wheel, uint64_t now_ms) {
+    if (!wheel) return 0;
+
+    uint64_t target = wheel_tick_of(wheel, now_ms);
+    int fired = 0;
+
+    while (wheel->current <= target) {
+        // Nothing scheduled: skip the idle stretch in one step
+        if (wheel->count == 0) {
+            wheel->current = target + 1;
+            break;
+        }
+
+        uint64_t tick = wheel->current;
+        int index = (int)(tick & WHEEL_MASK);
+
+        // Each time a level wraps, the next slot of the level above comes due
+        for (int level = 1; index == 0 && level < CATZILLA_TIMER_WHEEL_LEVELS; level++) {
+            index = (int)((tick >> (CATZILLA_TIMER_WHEEL_BITS * level)) & WHEEL_MASK);
+            wheel_cascade(wheel, level, index);
+        }
+
+        // Detach the due slot first: callbacks may schedule into it again
+        catzilla_timer_entry_t* entry = wheel->slots[0][tick & WHEEL_MASK];
+        wheel->slots[0][tick & WHEEL_MASK] = NULL;
+        if (entry) {
+            entry->pprev = &entry;
+        }
+        wheel->current = tick + 1;
+
+        while (entry) {
+            catzilla_timer_entry_t* due = entry;
+            entry = due->next;
+            if (entry) {
+                entry->pprev = &entry;
+            }
+            due->next = NULL;
+            due->pprev = NULL;
+            wheel->count--;
+            fired++;
+            if (due->callback) {
+                due->callback(due);
+            }
+        }
+    }
+
+    return fired;
+}
+
+uint64_t catzilla_timer_wheel_next_expiry(const catzilla_timer_wheel_t* wheel, uint64_t now_ms) {
+    if (!wheel || wheel->count == 0) return UINT64_MAX;
+
+    // Scan level 0 up to its next wrap, where upper levels cascade down
+    uint64_t tick = wheel->current;
+    uint64_t wrap = (tick & WHEEL_MASK) == 0 ? tick : (tick | WHEEL_MASK) + 1;
+    while (tick < wrap && !wheel->slots[0][tick & WHEEL_MASK]) {
+        tick++;
+    }
+
+    uint64_t due_ms = wheel->base_ms + tick * wheel->tick_ms;
+    return due_ms > now_ms ? due_ms - now_ms : 0;
+}
+
+int catzilla_timer_wheel_clear(catzilla_timer_wheel_t* wheel, catzilla_timer_fn fn) {
+    if (!wheel) return 0;
+
+    int removed = 0;
+    for (int level = 0; level < CATZILLA_TIMER_WHEEL_LEVELS; level++) {
+        for (int slot = 0; slot < CATZILLA_TIMER_WHEEL_SLOTS; slot++) {
+            catzilla_timer_entry_t* entry = wheel->slots[level][slot];
+            wheel->slots[level][slot] = NULL;
+            while (entry) {
+                catzilla_timer_entry_t* next = entry->next;
+                entry->next = NULL;
+                entry->pprev = NULL;
+                removed++;
+                if (fn) {
+                    fn(entry);
+                }
+                entry = next;
+            }
+        }
+    }
+    wheel->count = 0;
+    return removed;
+}
@@ -0,0 +1,118 @@
+#ifndef CATZILLA_TIMER_WHEEL_H
+#define CATZILLA_TIMER_WHEEL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Hierarchical timer wheel: CATZILLA_TIMER_WHEEL_LEVELS levels of 64 slots.
+// Level 0 holds timers due within 64 ticks; each level above covers 64 times
+// the span of the one below and is cascaded down as time reaches it.
+// Scheduling and cancelling are O(1), so a loop can keep one timeout per
+// connection without one libuv timer handle per socket.
+
+#define CATZILLA_TIMER_WHEEL_BITS 6
+#define CATZILLA_TIMER_WHEEL_SLOTS (1 << CATZILLA_TIMER_WHEEL_BITS)
+#define CATZILLA_TIMER_WHEEL_LEVELS 4
+
+typedef struct catzilla_timer_entry_s catzilla_timer_entry_t;
+
+/**
+ * Called when a timer expires. The entry is no longer scheduled and may be
+ * rescheduled or freed from inside the callback.
+ * @param entry Expired entry
+ */
+typedef void (*catzilla_timer_fn)(catzilla_timer_entry_t* entry);
+
+/**
+ * Intrusive timer, embedded in the object it times out
+ */
+struct catzilla_timer_entry_s {
+    catzilla_timer_entry_t* next;
+    catzilla_timer_entry_t** pprev;  // NULL when not scheduled
+    uint64_t expires;                // Tick the timer fires on
+    catzilla_timer_fn callback;
+    void* data;
+};
+
+typedef struct catzilla_timer_wheel_s {
+    catzilla_timer_entry_t* slots[CATZILLA_TIMER_WHEEL_LEVELS][CATZILLA_TIMER_WHEEL_SLOTS];
+    uint64_t current;      // Next tick to be processed
+    uint64_t base_ms;      // Clock value of tick 0
+    uint64_t tick_ms;
+    uint64_t count;        // Scheduled entries
+} catzilla_timer_wheel_t;
+
+/**
+ * Initialize an empty wheel
+ * @param wheel Wheel
+ * @param now_ms Current clock value (e.g. uv_now)
+ * @param tick_ms Resolution; timeouts are rounded up to whole ticks
+ */
+void catzilla_timer_wheel_init(catzilla_timer_wheel_t* wheel, uint64_t now_ms, uint64_t tick_ms);
+
+/**
+ * Prepare an entry for use
+ * @param entry Entry
+ * @param callback Expiry callback
+ * @param data User pointer
+ */
+void catzilla_timer_entry_init(catzilla_timer_entry_t* entry, catzilla_timer_fn callback, void* data);
+
+/**
+ * Schedule an entry, replacing any previous deadline
+ * @param wheel Wheel
+ * @param entry Entry
+ * @param now_ms Current clock value
+ * @param timeout_ms Delay; the longest delay the wheel holds is 64^4 ticks
+ */
+void catzilla_timer_wheel_schedule(catzilla_timer_wheel_t* wheel, catzilla_timer_entry_t* entry,
+                                   uint64_t now_ms, uint64_t timeout_ms);
+
+/**
+ * Remove an entry if it is scheduled
+ * @param wheel Wheel
+ * @param entry Entry
+ */
+void catzilla_timer_wheel_cancel(catzilla_timer_wheel_t* wheel, catzilla_timer_entry_t* entry);
+
+/**
+ * Fire every entry due at or before now
+ * @param wheel Wheel
+ * @param now_ms Current clock value
+ * @return Number of entries fired
+ */
+int catzilla_timer_wheel_advance(catzilla_timer_wheel_t* wheel, uint64_t now_ms);
+
+/**
+ * Lower bound on the time until the next entry fires. Entries on upper
+ * levels only come due when level 0 wraps, so the bound is never more than
+ * CATZILLA_TIMER_WHEEL_SLOTS ticks away while anything is scheduled.
+ * @param wheel Wheel
+ * @param now_ms Current clock value
+ * @return Milliseconds to wait before advancing, 0 if an entry may be due,
+ *         UINT64_MAX if nothing is scheduled
+ */
+uint64_t catzilla_timer_wheel_next_expiry(const catzilla_timer_wheel_t* wheel, uint64_t now_ms);
+
+/**
+ * Unschedule every entry without firing it
+ * @param wheel Wheel
+ * @param fn Called on each removed entry, may free it; NULL to only unlink
+ * @return Number of entries removed
+ */
+int catzilla_timer_wheel_clear(catzilla_timer_wheel_t* wheel, catzilla_timer_fn fn);
+
+static inline bool catzilla_timer_entry_pending(const catzilla_timer_entry_t* entry) {
+    return entry->pprev != NULL;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CATZILLA_TIMER_WHEEL_H
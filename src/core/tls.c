@@ -0,0 +1,623 @@
+#include "tls.h"
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "logging.h"
+#include "memory.h"
+
+#ifdef CATZILLA_HAS_TLS
+
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/kdf.h>
+#include <openssl/ssl.h>
+
+#if defined(__linux__) && defined(CATZILLA_HAS_KTLS)
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <linux/tls.h>
+#ifndef SOL_TLS
+#define SOL_TLS 282
+#endif
+#ifndef TCP_ULP
+#define TCP_ULP 31
+#endif
+#endif
+
+// Server-side session cache entries kept for TLS 1.2 resumption by ID
+#define CATZILLA_TLS_SESSION_CACHE_SIZE 20480
+
+#define TLS_RECORD_HEADER_LEN 5
+#define TLS_RECORD_APPLICATION_DATA 23
+#define TLS_MAX_SECRET_LEN 48
+
+struct catzilla_tls_context_s {
+    SSL_CTX* ssl_ctx;
+    bool enable_ktls;
+    volatile int ktls_refused;  // The kernel has no tls ULP; stop trying
+};
+
+struct catzilla_tls_session_s {
+    catzilla_tls_context_t* context;
+    SSL* ssl;
+    BIO* rbio;  // Ciphertext in
+    BIO* wbio;  // Ciphertext out
+    int fd;
+    bool offer_h2;
+    bool handshake_done;
+    bool failed;
+    bool ktls_active;
+    // kTLS needs the send sequence number of the application traffic secret:
+    // every record written after a TLS 1.3 handshake is counted
+    bool count_records;
+    uint64_t tx_seq;
+    unsigned char tx_secret[TLS_MAX_SECRET_LEN];
+    size_t tx_secret_len;
+};
+
+bool catzilla_tls_supported(void) {
+    return true;
+}
+
+static void log_ssl_errors(const char* what) {
+    unsigned long err = ERR_get_error();
+    if (err) {
+        char reason[256];
+        ERR_error_string_n(err, reason, sizeof(reason));
+        LOG_SERVER_DEBUG("%s: %s", what, reason);
+    }
+    ERR_clear_error();
+}
+
+static bool alpn_offered(const unsigned char* in, unsigned int inlen, const char* proto) {
+    size_t proto_len = strlen(proto);
+    unsigned int i = 0;
+    while (i < inlen) {
+        unsigned int len = in[i];
+        if (i + 1 + len > inlen) break;
+        if (len == proto_len && memcmp(in + i + 1, proto, len) == 0) return true;
+        i += 1 + len;
+    }
+    return false;
+}
+
+// Our preference wins: h2 when the server accepts it, then http/1.1
+static int select_alpn(SSL* ssl, const unsigned char** out, unsigned char* outlen,
+                       const unsigned char* in, unsigned int inlen, void* arg) {
+    (void)arg;
+    catzilla_tls_session_t* session = SSL_get_app_data(ssl);
+
+    if (session && session->offer_h2 && alpn_offered(in, inlen, "h2")) {
+        *out = (const unsigned char*)"h2";
+        *outlen = 2;
+        return SSL_TLSEXT_ERR_OK;
+    }
+    if (alpn_offered(in, inlen, "http/1.1")) {
+        *out = (const unsigned char*)"http/1.1";
+        *outlen = 8;
+        return SSL_TLSEXT_ERR_OK;
+    }
+    return SSL_TLSEXT_ERR_NOACK;
+}
+
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Keylog lines are the only public way to reach the TLS 1.3 traffic secrets;
+// the server's application secret is kept for kTLS and nothing is logged
+static void capture_traffic_secret(const SSL* ssl, const char* line) {
+    static const char label[] = "SERVER_TRAFFIC_SECRET_0 ";
+    catzilla_tls_session_t* session = SSL_get_app_data(ssl);
+    if (!session || strncmp(line, label, sizeof(label) - 1) != 0) return;
+
+    // "<label> <client random> <secret>"
+    const char* secret = strchr(line + sizeof(label) - 1, ' ');
+    if (!secret) return;
+    secret++;
+
+    size_t hex_len = strlen(secret);
+    if (hex_len % 2 != 0 || hex_len / 2 > sizeof(session->tx_secret)) return;
+    for (size_t i = 0; i < hex_len / 2; i++) {
+        int hi = hex_value(secret[2 * i]);
+        int lo = hex_value(secret[2 * i + 1]);
+        if (hi < 0 || lo < 0) {
+            session->tx_secret_len = 0;
+            return;
+        }
+        session->tx_secret[i] = (unsigned char)((hi << 4) | lo);
+    }
+    session->tx_secret_len = hex_len / 2;
+}
+
+catzilla_tls_context_t* catzilla_tls_context_create(const char* cert_file,
+                                                    const char* key_file,
+                                                    bool enable_ktls) {
+    if (!cert_file || !key_file) return NULL;
+
+    SSL_CTX* ssl_ctx = SSL_CTX_new(TLS_server_method());
+    if (!ssl_ctx) {
+        log_ssl_errors("SSL_CTX_new");
+        return NULL;
+    }
+
+    SSL_CTX_set_min_proto_version(ssl_ctx, TLS1_2_VERSION);
+    // Renegotiation would change keys behind the kernel's back
+    SSL_CTX_set_options(ssl_ctx, SSL_OP_NO_RENEGOTIATION | SSL_OP_CIPHER_SERVER_PREFERENCE);
+    // Idle keep-alive connections give their record buffers back
+    SSL_CTX_set_mode(ssl_ctx, SSL_MODE_RELEASE_BUFFERS);
+
+    if (SSL_CTX_use_certificate_chain_file(ssl_ctx, cert_file) != 1) {
+        LOG_SERVER_ERROR("Cannot load TLS certificate chain from %s", cert_file);
+        log_ssl_errors("certificate");
+        SSL_CTX_free(ssl_ctx);
+        return NULL;
+    }
+    if (SSL_CTX_use_PrivateKey_file(ssl_ctx, key_file, SSL_FILETYPE_PEM) != 1 ||
+        SSL_CTX_check_private_key(ssl_ctx) != 1) {
+        LOG_SERVER_ERROR("Cannot use TLS private key from %s", key_file);
+        log_ssl_errors("private key");
+        SSL_CTX_free(ssl_ctx);
+        return NULL;
+    }
+
+    // Resumption: TLS 1.3 and 1.2 tickets are on by default; the cache adds
+    // TLS 1.2 resumption by session ID
+    static const unsigned char session_id_context[] = "catzilla";
+    SSL_CTX_set_session_id_context(ssl_ctx, session_id_context, sizeof(session_id_context) - 1);
+    SSL_CTX_set_session_cache_mode(ssl_ctx, SSL_SESS_CACHE_SERVER);
+    SSL_CTX_sess_set_cache_size(ssl_ctx, CATZILLA_TLS_SESSION_CACHE_SIZE);
+
+    SSL_CTX_set_alpn_select_cb(ssl_ctx, select_alpn, NULL);
+    if (enable_ktls) {
+        SSL_CTX_set_keylog_callback(ssl_ctx, capture_traffic_secret);
+    }
+
+    catzilla_tls_context_t* context = catzilla_cache_alloc(sizeof(*context));
+    if (!context) {
+        SSL_CTX_free(ssl_ctx);
+        return NULL;
+    }
+    context->ssl_ctx = ssl_ctx;
+    context->enable_ktls = enable_ktls;
+    context->ktls_refused = 0;
+    return context;
+}
+
+void catzilla_tls_context_free(catzilla_tls_context_t* context) {
+    if (!context) return;
+    SSL_CTX_free(context->ssl_ctx);
+    catzilla_cache_free(context);
+}
+
+catzilla_tls_session_t* catzilla_tls_session_create(catzilla_tls_context_t* context,
+                                                    int fd,
+                                                    bool offer_h2) {
+    if (!context) return NULL;
+
+    catzilla_tls_session_t* session = catzilla_cache_alloc(sizeof(*session));
+    if (!session) return NULL;
+    memset(session, 0, sizeof(*session));
+    session->context = context;
+    session->fd = fd;
+    session->offer_h2 = offer_h2;
+
+    session->ssl = SSL_new(context->ssl_ctx);
+    session->rbio = BIO_new(BIO_s_mem());
+    session->wbio = BIO_new(BIO_s_mem());
+    if (!session->ssl || !session->rbio || !session->wbio) {
+        log_ssl_errors("SSL_new");
+        BIO_free(session->rbio);
+        BIO_free(session->wbio);
+        SSL_free(session->ssl);
+        catzilla_cache_free(session);
+        return NULL;
+    }
+
+    // An empty memory BIO means "try again", not end of file
+    BIO_set_mem_eof_return(session->rbio, -1);
+    SSL_set_bio(session->ssl, session->rbio, session->wbio);
+    SSL_set_app_data(session->ssl, session);
+    SSL_set_accept_state(session->ssl);
+    return session;
+}
+
+void catzilla_tls_session_free(catzilla_tls_session_t* session) {
+    if (!session) return;
+    // Connections usually end without close_notify; a session that did not
+    // fail stays in the cache for resumption
+    if (session->handshake_done && !session->failed) {
+        SSL_set_quiet_shutdown(session->ssl, 1);
+        SSL_shutdown(session->ssl);
+    }
+    SSL_free(session->ssl);  // Frees both BIOs
+    OPENSSL_cleanse(session->tx_secret, sizeof(session->tx_secret));
+    catzilla_cache_free(session);
+}
+
+int catzilla_tls_session_feed(catzilla_tls_session_t* session, const char* data, size_t length) {
+    if (!session || session->failed) return -1;
+
+    while (length > 0) {
+        int chunk = length > INT_MAX ? INT_MAX : (int)length;
+        if (BIO_write(session->rbio, data, chunk) != chunk) {
+            session->failed = true;
+            return -1;
+        }
+        data += chunk;
+        length -= (size_t)chunk;
+    }
+
+    if (session->handshake_done) return 0;
+
+    bool output_taken = BIO_ctrl_pending(session->wbio) == 0;
+    int rc = SSL_do_handshake(session->ssl);
+    if (rc == 1) {
+        session->handshake_done = true;
+        // A TLS 1.3 server's handshake ends on the client's Finished, so this
+        // call's output (the session tickets) is already protected by the
+        // application traffic secret
+        session->count_records = output_taken && SSL_version(session->ssl) == TLS1_3_VERSION;
+        LOG_SERVER_DEBUG("TLS handshake done: %s %s%s", SSL_get_version(session->ssl),
+                         SSL_get_cipher_name(session->ssl),
+                         SSL_session_reused(session->ssl) ? " (resumed)" : "");
+        return 0;
+    }
+
+    int err = SSL_get_error(session->ssl, rc);
+    if (err == SSL_ERROR_WANT_READ || err == SSL_ERROR_WANT_WRITE) return 0;
+
+    log_ssl_errors("TLS handshake failed");
+    session->failed = true;
+    return -1;
+}
+
+ssize_t catzilla_tls_session_read(catzilla_tls_session_t* session, char* buf, size_t capacity) {
+    if (!session || session->failed) return -1;
+    if (!session->handshake_done || capacity == 0) return 0;
+
+    int rc = SSL_read(session->ssl, buf, capacity > INT_MAX ? INT_MAX : (int)capacity);
+
+    // A post-handshake message answered by OpenSSL (KeyUpdate) would put
+    // records on the wire the kernel's sequence does not know about
+    if (session->ktls_active && BIO_ctrl_pending(session->wbio) > 0) {
+        LOG_SERVER_DEBUG("TLS session needs to write after kTLS offload");
+        session->failed = true;
+        return -1;
+    }
+    if (rc > 0) return rc;
+
+    int err = SSL_get_error(session->ssl, rc);
+    if (err == SSL_ERROR_WANT_READ) return 0;
+    if (err != SSL_ERROR_ZERO_RETURN) {
+        log_ssl_errors("TLS read failed");
+    }
+    session->failed = true;
+    return -1;
+}
+
+int catzilla_tls_session_write(catzilla_tls_session_t* session, const char* data, size_t length) {
+    if (!session || session->failed || !session->handshake_done || session->ktls_active) return -1;
+
+    while (length > 0) {
+        int chunk = length > INT_MAX ? INT_MAX : (int)length;
+        int rc = SSL_write(session->ssl, data, chunk);
+        if (rc <= 0) {
+            log_ssl_errors("TLS write failed");
+            session->failed = true;
+            return -1;
+        }
+        data += rc;
+        length -= (size_t)rc;
+    }
+    return 0;
+}
+
+static void count_application_records(catzilla_tls_session_t* session, const unsigned char* data,
+                                      size_t length) {
+    size_t offset = 0;
+    while (offset + TLS_RECORD_HEADER_LEN <= length) {
+        size_t record_len = ((size_t)data[offset + 3] << 8) | data[offset + 4];
+        if (data[offset] == TLS_RECORD_APPLICATION_DATA) {
+            session->tx_seq++;
+        }
+        offset += TLS_RECORD_HEADER_LEN + record_len;
+    }
+    // Output always ends on a record boundary; anything else breaks the count
+    if (offset != length) {
+        session->count_records = false;
+    }
+}
+
+char* catzilla_tls_session_take_output(catzilla_tls_session_t* session, size_t* length) {
+    *length = 0;
+    if (!session) return NULL;
+
+    size_t pending = BIO_ctrl_pending(session->wbio);
+    if (pending == 0) return NULL;
+
+    char* data = catzilla_response_alloc(pending);
+    if (!data) {
+        session->failed = true;
+        return NULL;
+    }
+    int n = BIO_read(session->wbio, data, pending > INT_MAX ? INT_MAX : (int)pending);
+    if (n <= 0) {
+        catzilla_response_free(data);
+        return NULL;
+    }
+
+    if (session->count_records) {
+        count_application_records(session, (const unsigned char*)data, (size_t)n);
+    }
+    *length = (size_t)n;
+    return data;
+}
+
+bool catzilla_tls_session_handshake_done(const catzilla_tls_session_t* session) {
+    return session && session->handshake_done;
+}
+
+bool catzilla_tls_session_resumed(const catzilla_tls_session_t* session) {
+    return session && session->handshake_done && SSL_session_reused(session->ssl);
+}
+
+catzilla_tls_alpn_t catzilla_tls_session_protocol(const catzilla_tls_session_t* session) {
+    if (!session) return CATZILLA_TLS_ALPN_NONE;
+
+    const unsigned char* proto = NULL;
+    unsigned int len = 0;
+    SSL_get0_alpn_selected(session->ssl, &proto, &len);
+    if (len == 2 && memcmp(proto, "h2", 2) == 0) return CATZILLA_TLS_ALPN_H2;
+    if (len == 8 && memcmp(proto, "http/1.1", 8) == 0) return CATZILLA_TLS_ALPN_HTTP1;
+    return CATZILLA_TLS_ALPN_NONE;
+}
+
+bool catzilla_tls_session_ktls_active(const catzilla_tls_session_t* session) {
+    return session && session->ktls_active;
+}
+
+#if defined(__linux__) && defined(CATZILLA_HAS_KTLS)
+
+// HKDF-Expand-Label with an empty context (RFC 8446 7.1)
+static int expand_label(const EVP_MD* md, const unsigned char* secret, size_t secret_len,
+                        const char* label, unsigned char* out, size_t out_len) {
+    unsigned char info[32];
+    size_t label_len = strlen(label);
+    info[0] = (unsigned char)(out_len >> 8);
+    info[1] = (unsigned char)out_len;
+    info[2] = (unsigned char)(6 + label_len);
+    memcpy(info + 3, "tls13 ", 6);
+    memcpy(info + 9, label, label_len);
+    info[9 + label_len] = 0;
+
+    EVP_PKEY_CTX* pctx = EVP_PKEY_CTX_new_id(EVP_PKEY_HKDF, NULL);
+    size_t derived = out_len;
+    int ok = pctx &&
+             EVP_PKEY_derive_init(pctx) > 0 &&
+             EVP_PKEY_CTX_hkdf_mode(pctx, EVP_PKEY_HKDEF_MODE_EXPAND_ONLY) > 0 &&
+             EVP_PKEY_CTX_set_hkdf_md(pctx, md) > 0 &&
+             EVP_PKEY_CTX_set1_hkdf_key(pctx, secret, (int)secret_len) > 0 &&
+             EVP_PKEY_CTX_add1_hkdf_info(pctx, info, (int)(10 + label_len)) > 0 &&
+             EVP_PKEY_derive(pctx, out, &derived) > 0 &&
+             derived == out_len;
+    EVP_PKEY_CTX_free(pctx);
+    return ok ? 0 : -1;
+}
+
+static void put_sequence(unsigned char out[8], uint64_t seq) {
+    for (int i = 7; i >= 0; i--) {
+        out[i] = (unsigned char)seq;
+        seq >>= 8;
+    }
+}
+
+static uint16_t kernel_cipher(const SSL* ssl) {
+    const SSL_CIPHER* cipher = SSL_get_current_cipher(ssl);
+    switch (cipher ? SSL_CIPHER_get_protocol_id(cipher) : 0) {
+        case 0x1301: return TLS_CIPHER_AES_GCM_128;
+        case 0x1302: return TLS_CIPHER_AES_GCM_256;
+#ifdef TLS_CIPHER_CHACHA20_POLY1305
+        case 0x1303: return TLS_CIPHER_CHACHA20_POLY1305;
+#endif
+        default: return 0;
+    }
+}
+
+bool catzilla_tls_session_can_offload(const catzilla_tls_session_t* session) {
+    return session && session->context->enable_ktls && !session->context->ktls_refused &&
+           session->fd >= 0 && session->handshake_done && !session->failed &&
+           !session->ktls_active && session->count_records && session->tx_secret_len > 0 &&
+           kernel_cipher(session->ssl) != 0;
+}
+
+int catzilla_tls_session_enable_ktls(catzilla_tls_session_t* session) {
+    if (!catzilla_tls_session_can_offload(session) || BIO_ctrl_pending(session->wbio) > 0) {
+        return -1;
+    }
+
+    uint16_t cipher = kernel_cipher(session->ssl);
+    const EVP_MD* md = cipher == TLS_CIPHER_AES_GCM_256 ? EVP_sha384() : EVP_sha256();
+    size_t key_len = cipher == TLS_CIPHER_AES_GCM_128 ? 16 : 32;
+    unsigned char key[32];
+    unsigned char iv[12];
+    if (expand_label(md, session->tx_secret, session->tx_secret_len, "key", key, key_len) != 0 ||
+        expand_label(md, session->tx_secret, session->tx_secret_len, "iv", iv, sizeof(iv)) != 0) {
+        log_ssl_errors("kTLS key derivation");
+        return -1;
+    }
+
+    union {
+        struct tls12_crypto_info_aes_gcm_128 aes128;
+        struct tls12_crypto_info_aes_gcm_256 aes256;
+#ifdef TLS_CIPHER_CHACHA20_POLY1305
+        struct tls12_crypto_info_chacha20_poly1305 chacha;
+#endif
+    } info;
+    socklen_t info_len;
+    memset(&info, 0, sizeof(info));
+
+    // The kernel takes the 12-byte IV as a 4-byte salt plus 8 bytes for GCM
+    if (cipher == TLS_CIPHER_AES_GCM_128) {
+        info.aes128.info.version = TLS_1_3_VERSION;
+        info.aes128.info.cipher_type = cipher;
+        memcpy(info.aes128.salt, iv, 4);
+        memcpy(info.aes128.iv, iv + 4, 8);
+        memcpy(info.aes128.key, key, 16);
+        put_sequence(info.aes128.rec_seq, session->tx_seq);
+        info_len = sizeof(info.aes128);
+    } else if (cipher == TLS_CIPHER_AES_GCM_256) {
+        info.aes256.info.version = TLS_1_3_VERSION;
+        info.aes256.info.cipher_type = cipher;
+        memcpy(info.aes256.salt, iv, 4);
+        memcpy(info.aes256.iv, iv + 4, 8);
+        memcpy(info.aes256.key, key, 32);
+        put_sequence(info.aes256.rec_seq, session->tx_seq);
+        info_len = sizeof(info.aes256);
+    } else {
+#ifdef TLS_CIPHER_CHACHA20_POLY1305
+        info.chacha.info.version = TLS_1_3_VERSION;
+        info.chacha.info.cipher_type = cipher;
+        memcpy(info.chacha.iv, iv, 12);
+        memcpy(info.chacha.key, key, 32);
+        put_sequence(info.chacha.rec_seq, session->tx_seq);
+        info_len = sizeof(info.chacha);
+#else
+        return -1;
+#endif
+    }
+    OPENSSL_cleanse(key, sizeof(key));
+    OPENSSL_cleanse(iv, sizeof(iv));
+
+    int rc = -1;
+    if (setsockopt(session->fd, SOL_TCP, TCP_ULP, "tls", sizeof("tls")) != 0) {
+        if (errno == ENOENT || errno == ENOPROTOOPT || errno == EOPNOTSUPP) {
+            LOG_SERVER_INFO("Kernel TLS is not available (%s); encrypting in userspace", strerror(errno));
+            session->context->ktls_refused = 1;
+        }
+    } else if (setsockopt(session->fd, SOL_TLS, TLS_TX, &info, info_len) != 0) {
+        // The ULP stays attached but without keys passes bytes through unchanged
+        LOG_SERVER_DEBUG("kTLS TX setup failed: %s", strerror(errno));
+    } else {
+        session->ktls_active = true;
+        session->count_records = false;
+        OPENSSL_cleanse(session->tx_secret, sizeof(session->tx_secret));
+        rc = 0;
+    }
+    OPENSSL_cleanse(&info, sizeof(info));
+    return rc;
+}
+
+#else  // No kernel TLS on this platform
+
+bool catzilla_tls_session_can_offload(const catzilla_tls_session_t* session) {
+    (void)session;
+    return false;
+}
+
+int catzilla_tls_session_enable_ktls(catzilla_tls_session_t* session) {
+    (void)session;
+    return -1;
+}
+
+#endif
+
+#else  // !CATZILLA_HAS_TLS
+
+bool catzilla_tls_supported(void) {
+    return false;
+}
+
+catzilla_tls_context_t* catzilla_tls_context_create(const char* cert_file,
+                                                    const char* key_file,
+                                                    bool enable_ktls) {
+    (void)cert_file;
+    (void)key_file;
+    (void)enable_ktls;
+    LOG_SERVER_ERROR("Catzilla was built without TLS support (OpenSSL not found)");
+    return NULL;
+}
+
+void catzilla_tls_context_free(catzilla_tls_context_t* context) {
+    (void)context;
+}
+
+catzilla_tls_session_t* catzilla_tls_session_create(catzilla_tls_context_t* context,
+                                                    int fd,
+                                                    bool offer_h2) {
+    (void)context;
+    (void)fd;
+    (void)offer_h2;
+    return NULL;
+}
+
+void catzilla_tls_session_free(catzilla_tls_session_t* session) {
+    (void)session;
+}
+
+int catzilla_tls_session_feed(catzilla_tls_session_t* session, const char* data, size_t length) {
+    (void)session;
+    (void)data;
+    (void)length;
+    return -1;
+}
+
+ssize_t catzilla_tls_session_read(catzilla_tls_session_t* session, char* buf, size_t capacity) {
+    (void)session;
+    (void)buf;
+    (void)capacity;
+    return -1;
+}
+
+int catzilla_tls_session_write(catzilla_tls_session_t* session, const char* data, size_t length) {
+    (void)session;
+    (void)data;
+    (void)length;
+    return -1;
+}
+
+char* catzilla_tls_session_take_output(catzilla_tls_session_t* session, size_t* length) {
+    (void)session;
+    *length = 0;
+    return NULL;
+}
+
+bool catzilla_tls_session_handshake_done(const catzilla_tls_session_t* session) {
+    (void)session;
+    return false;
+}
+
+bool catzilla_tls_session_resumed(const catzilla_tls_session_t* session) {
+    (void)session;
+    return false;
+}
+
+catzilla_tls_alpn_t catzilla_tls_session_protocol(const catzilla_tls_session_t* session) {
+    (void)session;
+    return CATZILLA_TLS_ALPN_NONE;
+}
+
+bool catzilla_tls_session_can_offload(const catzilla_tls_session_t* session) {
+    (void)session;
+    return false;
+}
+
+int catzilla_tls_session_enable_ktls(catzilla_tls_session_t* session) {
+    (void)session;
+    return -1;
+}
+
+bool catzilla_tls_session_ktls_active(const catzilla_tls_session_t* session) {
+    (void)session;
+    return false;
+}
+
+#endif  // CATZILLA_HAS_TLS
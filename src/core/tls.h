@@ -0,0 +1,121 @@
+#ifndef CATZILLA_TLS_H
+#define CATZILLA_TLS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "platform_compat.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// TLS termination over memory buffers, independent of the socket layer. The
+// server feeds received ciphertext in, reads plaintext out and writes whatever
+// output the session produces. On Linux, TLS 1.3 sessions can move their
+// record encryption into the kernel (kTLS) once the handshake is done; plain
+// writes to the socket are then encrypted by the kernel.
+
+// Protocols negotiated through ALPN
+typedef enum {
+    CATZILLA_TLS_ALPN_NONE = 0,  // Client offered no protocol we know
+    CATZILLA_TLS_ALPN_HTTP1,
+    CATZILLA_TLS_ALPN_H2
+} catzilla_tls_alpn_t;
+
+typedef struct catzilla_tls_context_s catzilla_tls_context_t;
+typedef struct catzilla_tls_session_s catzilla_tls_session_t;
+
+/**
+ * Whether catzilla was built with TLS support
+ */
+bool catzilla_tls_supported(void);
+
+/**
+ * Load a certificate chain and private key into a shared server context. The
+ * context keeps a session cache and issues session tickets for resumption.
+ * @param cert_file PEM certificate chain
+ * @param key_file PEM private key
+ * @param enable_ktls Offload TLS 1.3 record encryption to the kernel when possible
+ * @return Context, or NULL if the files cannot be used or TLS is not built in
+ */
+catzilla_tls_context_t* catzilla_tls_context_create(const char* cert_file,
+                                                    const char* key_file,
+                                                    bool enable_ktls);
+
+/**
+ * Free a context once no session uses it any more
+ */
+void catzilla_tls_context_free(catzilla_tls_context_t* context);
+
+/**
+ * Start the server side of a TLS connection
+ * @param context Shared server context
+ * @param fd Socket the session runs on, used for kTLS (-1 = never offload)
+ * @param offer_h2 Select h2 when the client offers it through ALPN
+ * @return Session, or NULL on allocation failure
+ */
+catzilla_tls_session_t* catzilla_tls_session_create(catzilla_tls_context_t* context,
+                                                    int fd,
+                                                    bool offer_h2);
+
+void catzilla_tls_session_free(catzilla_tls_session_t* session);
+
+/**
+ * Hand received ciphertext to the session and advance the handshake. Output
+ * produced on the way (handshake records, alerts) is left for
+ * catzilla_tls_session_take_output.
+ * @return 0 on success, -1 if the connection must be closed
+ */
+int catzilla_tls_session_feed(catzilla_tls_session_t* session, const char* data, size_t length);
+
+/**
+ * Decrypt buffered application data
+ * @return Plaintext bytes copied into buf, 0 if more ciphertext is needed, -1
+ *         once the peer closed the session or it failed
+ */
+ssize_t catzilla_tls_session_read(catzilla_tls_session_t* session, char* buf, size_t capacity);
+
+/**
+ * Encrypt application data; the records are left for
+ * catzilla_tls_session_take_output. Not used once the kernel encrypts.
+ * @return 0 on success, -1 if the session failed
+ */
+int catzilla_tls_session_write(catzilla_tls_session_t* session, const char* data, size_t length);
+
+/**
+ * Take the ciphertext waiting to be sent
+ * @param length Receives the number of bytes
+ * @return catzilla_response_alloc'd buffer the caller frees, or NULL if nothing is waiting
+ */
+char* catzilla_tls_session_take_output(catzilla_tls_session_t* session, size_t* length);
+
+bool catzilla_tls_session_handshake_done(const catzilla_tls_session_t* session);
+
+/**
+ * Whether the handshake resumed an earlier session
+ */
+bool catzilla_tls_session_resumed(const catzilla_tls_session_t* session);
+
+catzilla_tls_alpn_t catzilla_tls_session_protocol(const catzilla_tls_session_t* session);
+
+/**
+ * Whether the session may try kTLS: the context allows it, the kernel has not
+ * refused it before and a TLS 1.3 AES-GCM session was negotiated
+ */
+bool catzilla_tls_session_can_offload(const catzilla_tls_session_t* session);
+
+/**
+ * Move record encryption for sending into the kernel. Every byte taken from
+ * catzilla_tls_session_take_output must already be in the socket. Received
+ * data is still decrypted by the session.
+ * @return 0 once the kernel encrypts writes, -1 if the session stays in userspace
+ */
+int catzilla_tls_session_enable_ktls(catzilla_tls_session_t* session);
+
+bool catzilla_tls_session_ktls_active(const catzilla_tls_session_t* session);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CATZILLA_TLS_H
@@ -1,4 +1,5 @@
 #include "upload_clamav.h"
+#include "clamd_client.h"
 #include "logging.h"
 #include "platform_compat.h"
 #include <string.h>
@@ -31,6 +32,7 @@ typedef struct _stat stat_t;
 #include <sys/stat.h>
 #include <sys/socket.h>
 #include <sys/un.h>
+#include <sys/time.h>
 #include <sys/wait.h>
 #include <fcntl.h>
 
@@ -300,20 +302,30 @@ clamav_scan_result_t* catzilla_clamav_scan_file(const char* file_path) {
         result->file_size = st.st_size;
     }
 
-    char command[2048];
+    // Time the scan
+    uint64_t start_time = time(NULL);
+    int rc = CLAMAV_ERROR_DAEMON_NOT_RUNNING;
 
-    // Build scan command based on available tools
+#ifndef _WIN32
+    // The daemon gets the file over its socket, without a process per scan
     if (g_clamav_info.daemon_running && g_clamav_info.daemon_socket) {
-        // Use daemon client (fastest)
-#ifdef _WIN32
-        snprintf(command, sizeof(command),
-                "clamdscan --no-summary --infected --stdout \"%s\" 2>&1", file_path);
-#else
-        snprintf(command, sizeof(command),
-                "clamdscan --no-summary --infected --stdout '%s' 2>&1", file_path);
+        rc = catzilla_clamd_instream(g_clamav_info.daemon_socket, file_path, NULL, 0, result);
+        if (rc == CLAMAV_ERROR_CONNECTION_FAILED && g_clamav_info.binary_path) {
+            LOG_CLAMAV_WARN("clamd at %s unreachable, scanning with %s",
+                            g_clamav_info.daemon_socket, g_clamav_info.binary_path);
+        }
+    }
 #endif
-    } else if (g_clamav_info.binary_path) {
-        // Use direct scanner
+
+    if (rc == CLAMAV_ERROR_DAEMON_NOT_RUNNING || rc == CLAMAV_ERROR_CONNECTION_FAILED) {
+        if (!g_clamav_info.binary_path) {
+            result->is_error = true;
+            result->error_message = strdup("No ClamAV scanner available");
+            return result;
+        }
+
+        // Without a daemon the scanner binary runs once per file
+        char command[2048];
 #ifdef _WIN32
         snprintf(command, sizeof(command),
                 "\"%s\" --no-summary --infected --stdout \"%s\" 2>&1",
@@ -323,52 +335,44 @@ clamav_scan_result_t* catzilla_clamav_scan_file(const char* file_path) {
                 "'%s' --no-summary --infected --stdout '%s' 2>&1",
                 g_clamav_info.binary_path, file_path);
 #endif
-    } else {
-        result->is_error = true;
-        result->error_message = strdup("No ClamAV scanner available");
-        return result;
-    }
-
-    LOG_CLAMAV_DEBUG("ClamAV scan command: %s", command);
 
-    // Time the scan
-    uint64_t start_time = time(NULL);
+        LOG_CLAMAV_DEBUG("ClamAV scan command: %s", command);
 
-    // Execute scan with timeout
 #ifdef _WIN32
-    FILE* fp = _popen(command, "r");
+        FILE* fp = _popen(command, "r");
 #else
-    FILE* fp = popen(command, "r");
+        FILE* fp = popen(command, "r");
 #endif
-    if (!fp) {
-        result->is_error = true;
-        result->error_message = strdup("Failed to execute ClamAV");
-        return result;
-    }
+        if (!fp) {
+            result->is_error = true;
+            result->error_message = strdup("Failed to execute ClamAV");
+            return result;
+        }
 
-    // Read scan output
-    char output[1024] = {0};
-    size_t output_len = fread(output, 1, sizeof(output) - 1, fp);
-    output[output_len] = '\0';
+        // Read scan output
+        char output[1024] = {0};
+        size_t output_len = fread(output, 1, sizeof(output) - 1, fp);
+        output[output_len] = '\0';
 
 #ifdef _WIN32
-    int exit_code = _pclose(fp);
+        int exit_code = _pclose(fp);
 #else
-    int exit_code = pclose(fp);
+        int exit_code = pclose(fp);
 #endif
+        result->exit_code = exit_code;
+
+        // Parse results based on exit code and output
+        if (catzilla_clamav_parse_scan_response(output, result) != 0) {
+            LOG_CLAMAV_ERROR("Failed to parse ClamAV scan response");
+            result->is_error = true;
+            if (!result->error_message) {
+                result->error_message = strdup("Failed to parse scan response");
+            }
+        }
+    }
 
     uint64_t end_time = time(NULL);
     result->scan_time_seconds = (double)(end_time - start_time);
-    result->exit_code = exit_code;
-
-    // Parse results based on exit code and output
-    if (catzilla_clamav_parse_scan_response(output, result) != 0) {
-        LOG_CLAMAV_ERROR("Failed to parse ClamAV scan response");
-        result->is_error = true;
-        if (!result->error_message) {
-            result->error_message = strdup("Failed to parse scan response");
-        }
-    }
 
     // Add version info
     if (g_clamav_info.version) {
@@ -385,6 +389,143 @@ clamav_scan_result_t* catzilla_clamav_scan_file(const char* file_path) {
     return result;
 }
 
+#ifndef _WIN32
+static int clamd_send_all(int sock, const char* data, size_t len) {
+#ifdef MSG_NOSIGNAL
+    int flags = MSG_NOSIGNAL;
+#else
+    int flags = 0;
+#endif
+    while (len > 0) {
+        ssize_t sent = send(sock, data, len, flags);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        data += sent;
+        len -= (size_t)sent;
+    }
+    return 0;
+}
+
+static int clamd_send_chunk(int sock, const char* data, size_t len) {
+    unsigned char header[4] = {
+        (unsigned char)(len >> 24), (unsigned char)(len >> 16),
+        (unsigned char)(len >> 8), (unsigned char)len
+    };
+    if (clamd_send_all(sock, (const char*)header, sizeof(header)) != 0) return -1;
+    return len > 0 ? clamd_send_all(sock, data, len) : 0;
+}
+
+// Stream a file (or a buffer when file_path is NULL) to clamd with INSTREAM
+// and read its verdict into result
+int catzilla_clamd_instream(const char* socket_path, const char* file_path,
+                            const char* buffer, size_t buffer_size, clamav_scan_result_t* result) {
+    int fd = -1;
+    if (file_path && (fd = open(file_path, O_RDONLY)) < 0) {
+        result->is_error = true;
+        result->error_message = strdup(strerror(errno));
+        return CLAMAV_ERROR_FILE_NOT_FOUND;
+    }
+
+    int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, socket_path, sizeof(addr.sun_path) - 1);
+    if (sock < 0 || connect(sock, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        if (sock >= 0) close(sock);
+        if (fd >= 0) close(fd);
+        return CLAMAV_ERROR_CONNECTION_FAILED;
+    }
+
+    // clamd may take a while on big archives, but not forever
+    struct timeval timeout = { 60, 0 };
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    int rc = clamd_send_all(sock, "zINSTREAM", sizeof("zINSTREAM"));
+    if (rc == 0 && fd >= 0) {
+        char chunk[64 * 1024];
+        ssize_t n;
+        while (rc == 0 && (n = read(fd, chunk, sizeof(chunk))) != 0) {
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                rc = -1;
+                break;
+            }
+            rc = clamd_send_chunk(sock, chunk, (size_t)n);
+        }
+    } else if (rc == 0) {
+        for (size_t offset = 0; rc == 0 && offset < buffer_size; offset += 64 * 1024) {
+            size_t take = buffer_size - offset < 64 * 1024 ? buffer_size - offset : 64 * 1024;
+            rc = clamd_send_chunk(sock, buffer + offset, take);
+        }
+    }
+    if (fd >= 0) close(fd);
+    // clamd answers early (and stops reading) when a stream is too long
+    if (rc == 0) clamd_send_chunk(sock, NULL, 0);
+
+    char reply[512];
+    size_t reply_len = 0;
+    while (reply_len < sizeof(reply)) {
+        ssize_t n = recv(sock, reply + reply_len, sizeof(reply) - reply_len, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        reply_len += (size_t)n;
+        if (memchr(reply, '\0', reply_len)) break;
+    }
+    close(sock);
+
+    char* nul = memchr(reply, '\0', reply_len);
+    catzilla_clamd_result_t verdict;
+    memset(&verdict, 0, sizeof(verdict));
+    if (!nul || catzilla_clamd_parse_reply(reply, (size_t)(nul - reply), &verdict) != 0) {
+        result->is_error = true;
+        result->error_message = strdup(reply_len == 0 ? "No reply from clamd" : "Invalid reply from clamd");
+        return reply_len == 0 ? CLAMAV_ERROR_TIMEOUT : CLAMAV_ERROR_INVALID_RESPONSE;
+    }
+
+    result->exit_code = verdict.verdict == CATZILLA_CLAMD_CLEAN ? 0 :
+                        verdict.verdict == CATZILLA_CLAMD_INFECTED ? 1 : 2;
+    if (verdict.verdict == CATZILLA_CLAMD_INFECTED) {
+        result->is_infected = true;
+        result->threat_name = strdup(verdict.signature);
+    } else if (verdict.verdict == CATZILLA_CLAMD_ERROR) {
+        result->is_error = true;
+        result->error_message = strdup(verdict.signature);
+        return CLAMAV_ERROR_SCAN_FAILED;
+    }
+    return CLAMAV_ERROR_SUCCESS;
+}
+#endif
+
+int catzilla_clamav_scan_buffer(const char* buffer, size_t buffer_size, clamav_scan_result_t* result) {
+    if ((!buffer && buffer_size > 0) || !result) {
+        return CLAMAV_ERROR_MEMORY;
+    }
+    memset(result, 0, sizeof(*result));
+    result->file_size = buffer_size;
+
+#ifdef _WIN32
+    result->is_error = true;
+    return CLAMAV_ERROR_DAEMON_NOT_RUNNING;
+#else
+    if (!g_clamav_detected) {
+        catzilla_clamav_detect_system(&g_clamav_info);
+    }
+    if (!g_clamav_info.daemon_running || !g_clamav_info.daemon_socket) {
+        result->is_error = true;
+        return CLAMAV_ERROR_DAEMON_NOT_RUNNING;
+    }
+
+    time_t start_time = time(NULL);
+    int rc = catzilla_clamd_instream(g_clamav_info.daemon_socket, NULL, buffer, buffer_size, result);
+    result->scan_time_seconds = difftime(time(NULL), start_time);
+    catzilla_update_scan_stats(result);
+    return rc;
+#endif
+}
+
 // Parse ClamAV scan response
 static int catzilla_clamav_parse_scan_response(const char* response, clamav_scan_result_t* result) {
     if (!response || !result) {
@@ -75,7 +75,32 @@ bool catzilla_test_clamd_connection(const char* socket_path);
 bool catzilla_test_clamd_tcp_connection(const char* host, uint32_t port);
 
 // Scanning functions
+
+/**
+ * Scan bytes in memory through the clamd socket (INSTREAM); needs a running daemon
+ * @param buffer Data to scan
+ * @param buffer_size Length of buffer
+ * @param result Receives the verdict (threat_name and error_message are heap strings)
+ * @return CLAMAV_ERROR_SUCCESS, or a clamav_error_t when no verdict came back
+ */
 int catzilla_clamav_scan_buffer(const char* buffer, size_t buffer_size, clamav_scan_result_t* result);
+
+#ifndef _WIN32
+/**
+ * Stream a file or buffer to clamd with INSTREAM over its Unix socket and
+ * wait for the verdict. Blocking; the event loop uses clamd_client.h instead.
+ * @param socket_path clamd socket
+ * @param file_path File to scan, or NULL to scan buffer
+ * @param buffer Data to scan when file_path is NULL
+ * @param buffer_size Length of buffer
+ * @param result Receives the verdict
+ * @return CLAMAV_ERROR_SUCCESS, CLAMAV_ERROR_CONNECTION_FAILED if clamd is
+ *         unreachable, or another clamav_error_t
+ */
+int catzilla_clamd_instream(const char* socket_path, const char* file_path,
+                            const char* buffer, size_t buffer_size, clamav_scan_result_t* result);
+#endif
+
 int catzilla_clamav_scan_file_async(const char* file_path, void (*callback)(clamav_scan_result_t*));
 
 // Configuration functions
@@ -0,0 +1,417 @@
+#include "upload_digest.h"
+#include <string.h>
+#include <uv.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define DIGEST_X86 1
+#include <immintrin.h>
+#include <cpuid.h>
+#elif defined(__aarch64__) && (defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRC32))
+#include <arm_acle.h>
+#include <arm_neon.h>
+#endif
+
+static const uint32_t sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+typedef void (*sha256_blocks_fn)(uint32_t state[8], const uint8_t* data, size_t blocks);
+typedef uint32_t (*crc32c_fn)(uint32_t crc, const uint8_t* data, size_t len);
+
+// ============================================================================
+// Portable code
+// ============================================================================
+
+#define ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+static void sha256_blocks_portable(uint32_t state[8], const uint8_t* data, size_t blocks) {
+    uint32_t w[64];
+    while (blocks--) {
+        for (int i = 0; i < 16; i++) {
+            w[i] = (uint32_t)data[i * 4] << 24 | (uint32_t)data[i * 4 + 1] << 16 |
+                   (uint32_t)data[i * 4 + 2] << 8 | (uint32_t)data[i * 4 + 3];
+        }
+        for (int i = 16; i < 64; i++) {
+            uint32_t s0 = ROTR(w[i - 15], 7) ^ ROTR(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            uint32_t s1 = ROTR(w[i - 2], 17) ^ ROTR(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+        for (int i = 0; i < 64; i++) {
+            uint32_t t1 = h + (ROTR(e, 6) ^ ROTR(e, 11) ^ ROTR(e, 25)) + ((e & f) ^ (~e & g)) +
+                          sha256_k[i] + w[i];
+            uint32_t t2 = (ROTR(a, 2) ^ ROTR(a, 13) ^ ROTR(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+        data += 64;
+    }
+}
+
+// Slicing-by-8 over the reflected Castagnoli polynomial
+static uint32_t crc32c_table[8][256];
+
+static void build_crc32c_table(void) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0x82f63b78u & (0u - (crc & 1u)));
+        }
+        crc32c_table[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+        for (int slice = 1; slice < 8; slice++) {
+            uint32_t prev = crc32c_table[slice - 1][i];
+            crc32c_table[slice][i] = (prev >> 8) ^ crc32c_table[0][prev & 0xff];
+        }
+    }
+}
+
+static uint32_t crc32c_portable(uint32_t crc, const uint8_t* data, size_t len) {
+    while (len >= 8) {
+        uint32_t low = crc ^ ((uint32_t)data[0] | (uint32_t)data[1] << 8 |
+                              (uint32_t)data[2] << 16 | (uint32_t)data[3] << 24);
+        crc = crc32c_table[7][low & 0xff] ^ crc32c_table[6][(low >> 8) & 0xff] ^
+              crc32c_table[5][(low >> 16) & 0xff] ^ crc32c_table[4][low >> 24] ^
+              crc32c_table[3][data[4]] ^ crc32c_table[2][data[5]] ^
+              crc32c_table[1][data[6]] ^ crc32c_table[0][data[7]];
+        data += 8;
+        len -= 8;
+    }
+    while (len--) {
+        crc = (crc >> 8) ^ crc32c_table[0][(crc ^ *data++) & 0xff];
+    }
+    return crc;
+}
+
+// ============================================================================
+// x86: SHA-NI and SSE4.2, picked at run time
+// ============================================================================
+
+#ifdef DIGEST_X86
+
+__attribute__((target("sha,sse4.1")))
+static void sha256_blocks_shani(uint32_t state[8], const uint8_t* data, size_t blocks) {
+    const __m128i byte_swap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    // The rounds work on ABEF and CDGH
+    __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&state[0]), 0xB1);
+    __m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&state[4]), 0x1B);
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+
+    while (blocks--) {
+        __m128i abef = state0;
+        __m128i cdgh = state1;
+        __m128i w[4];
+        for (int i = 0; i < 4; i++) {
+            w[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + i * 16)), byte_swap);
+        }
+        // Four rounds per step; w[j & 3] holds the schedule words of step j
+#pragma GCC unroll 16
+        for (int j = 0; j < 16; j++) {
+            if (j >= 4) {
+                __m128i next = _mm_sha256msg1_epu32(w[j & 3], w[(j + 1) & 3]);
+                next = _mm_add_epi32(next, _mm_alignr_epi8(w[(j + 3) & 3], w[(j + 2) & 3], 4));
+                w[j & 3] = _mm_sha256msg2_epu32(next, w[(j + 3) & 3]);
+            }
+            __m128i msg = _mm_add_epi32(w[j & 3], _mm_loadu_si128((const __m128i*)&sha256_k[j * 4]));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0E));
+        }
+        state0 = _mm_add_epi32(state0, abef);
+        state1 = _mm_add_epi32(state1, cdgh);
+        data += 64;
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1B);
+    state1 = _mm_shuffle_epi32(state1, 0xB1);
+    _mm_storeu_si128((__m128i*)&state[0], _mm_blend_epi16(tmp, state1, 0xF0));
+    _mm_storeu_si128((__m128i*)&state[4], _mm_alignr_epi8(state1, tmp, 8));
+}
+
+__attribute__((target("sse4.2")))
+static uint32_t crc32c_sse42(uint32_t crc, const uint8_t* data, size_t len) {
+#ifdef __x86_64__
+    uint64_t crc64 = crc;
+    while (len >= 8) {
+        uint64_t word;
+        memcpy(&word, data, 8);
+        crc64 = _mm_crc32_u64(crc64, word);
+        data += 8;
+        len -= 8;
+    }
+    crc = (uint32_t)crc64;
+#endif
+    while (len >= 4) {
+        uint32_t word;
+        memcpy(&word, data, 4);
+        crc = _mm_crc32_u32(crc, word);
+        data += 4;
+        len -= 4;
+    }
+    while (len--) {
+        crc = _mm_crc32_u8(crc, *data++);
+    }
+    return crc;
+}
+
+static bool cpu_has_sha(void) {
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_SSE4_1) || !(ecx & bit_SSSE3)) {
+        return false;
+    }
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) return false;
+    return (ebx & (1u << 29)) != 0;
+}
+
+static bool cpu_has_sse42(void) {
+    unsigned eax, ebx, ecx, edx;
+    return __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_SSE4_2);
+}
+
+#endif // DIGEST_X86
+
+// ============================================================================
+// ARMv8: crypto and CRC extensions when the compiler targets them
+// ============================================================================
+
+#if defined(__aarch64__) && defined(__ARM_FEATURE_SHA2)
+
+static void sha256_blocks_armv8(uint32_t state[8], const uint8_t* data, size_t blocks) {
+    uint32x4_t state0 = vld1q_u32(&state[0]);
+    uint32x4_t state1 = vld1q_u32(&state[4]);
+
+    while (blocks--) {
+        uint32x4_t abcd = state0;
+        uint32x4_t efgh = state1;
+        uint32x4_t w[4];
+        for (int i = 0; i < 4; i++) {
+            w[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + i * 16)));
+        }
+        for (int j = 0; j < 16; j++) {
+            if (j >= 4) {
+                w[j & 3] = vsha256su1q_u32(vsha256su0q_u32(w[j & 3], w[(j + 1) & 3]),
+                                           w[(j + 2) & 3], w[(j + 3) & 3]);
+            }
+            uint32x4_t msg = vaddq_u32(w[j & 3], vld1q_u32(&sha256_k[j * 4]));
+            uint32x4_t previous = state0;
+            state0 = vsha256hq_u32(state0, state1, msg);
+            state1 = vsha256h2q_u32(state1, previous, msg);
+        }
+        state0 = vaddq_u32(state0, abcd);
+        state1 = vaddq_u32(state1, efgh);
+        data += 64;
+    }
+
+    vst1q_u32(&state[0], state0);
+    vst1q_u32(&state[4], state1);
+}
+
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+
+static uint32_t crc32c_armv8(uint32_t crc, const uint8_t* data, size_t len) {
+    while (len >= 8) {
+        uint64_t word;
+        memcpy(&word, data, 8);
+        crc = __crc32cd(crc, word);
+        data += 8;
+        len -= 8;
+    }
+    while (len--) {
+        crc = __crc32cb(crc, *data++);
+    }
+    return crc;
+}
+
+#endif
+
+// ============================================================================
+// Dispatch
+// ============================================================================
+
+static uv_once_t digest_once = UV_ONCE_INIT;
+static sha256_blocks_fn sha256_blocks_best = sha256_blocks_portable;
+static crc32c_fn crc32c_best = crc32c_portable;
+static const char* sha256_best_name = "portable";
+static const char* crc32c_best_name = "portable";
+static bool force_portable;
+
+static void init_digests(void) {
+    build_crc32c_table();
+#ifdef DIGEST_X86
+    if (cpu_has_sha()) {
+        sha256_blocks_best = sha256_blocks_shani;
+        sha256_best_name = "sha-ni";
+    }
+    if (cpu_has_sse42()) {
+        crc32c_best = crc32c_sse42;
+        crc32c_best_name = "sse4.2";
+    }
+#endif
+#if defined(__aarch64__) && defined(__ARM_FEATURE_SHA2)
+    sha256_blocks_best = sha256_blocks_armv8;
+    sha256_best_name = "armv8";
+#endif
+#if defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+    crc32c_best = crc32c_armv8;
+    crc32c_best_name = "armv8";
+#endif
+}
+
+static sha256_blocks_fn sha256_blocks(void) {
+    uv_once(&digest_once, init_digests);
+    return force_portable ? sha256_blocks_portable : sha256_blocks_best;
+}
+
+const char* catzilla_sha256_backend(void) {
+    uv_once(&digest_once, init_digests);
+    return force_portable ? "portable" : sha256_best_name;
+}
+
+const char* catzilla_crc32c_backend(void) {
+    uv_once(&digest_once, init_digests);
+    return force_portable ? "portable" : crc32c_best_name;
+}
+
+void catzilla_digest_use_portable(bool portable) {
+    force_portable = portable;
+}
+
+// ============================================================================
+// SHA-256
+// ============================================================================
+
+void catzilla_sha256_init(catzilla_sha256_t* ctx) {
+    static const uint32_t initial[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+    };
+    memcpy(ctx->state, initial, sizeof(initial));
+    ctx->length = 0;
+    ctx->block_len = 0;
+}
+
+void catzilla_sha256_update(catzilla_sha256_t* ctx, const void* data, size_t len) {
+    const uint8_t* p = data;
+    sha256_blocks_fn blocks = sha256_blocks();
+    ctx->length += len;
+
+    if (ctx->block_len > 0) {
+        size_t take = 64 - ctx->block_len;
+        if (take > len) take = len;
+        memcpy(ctx->block + ctx->block_len, p, take);
+        ctx->block_len += take;
+        p += take;
+        len -= take;
+        if (ctx->block_len < 64) return;
+        blocks(ctx->state, ctx->block, 1);
+        ctx->block_len = 0;
+    }
+
+    // Whole blocks straight from the caller's buffer
+    if (len >= 64) {
+        blocks(ctx->state, p, len / 64);
+        p += len & ~(size_t)63;
+        len &= 63;
+    }
+    memcpy(ctx->block, p, len);
+    ctx->block_len = len;
+}
+
+void catzilla_sha256_final(catzilla_sha256_t* ctx, uint8_t out[CATZILLA_SHA256_SIZE]) {
+    uint64_t bits = ctx->length * 8;
+    sha256_blocks_fn blocks = sha256_blocks();
+
+    ctx->block[ctx->block_len++] = 0x80;
+    if (ctx->block_len > 56) {
+        memset(ctx->block + ctx->block_len, 0, 64 - ctx->block_len);
+        blocks(ctx->state, ctx->block, 1);
+        ctx->block_len = 0;
+    }
+    memset(ctx->block + ctx->block_len, 0, 56 - ctx->block_len);
+    for (int i = 0; i < 8; i++) {
+        ctx->block[63 - i] = (uint8_t)(bits >> (i * 8));
+    }
+    blocks(ctx->state, ctx->block, 1);
+
+    for (int i = 0; i < 8; i++) {
+        out[i * 4] = (uint8_t)(ctx->state[i] >> 24);
+        out[i * 4 + 1] = (uint8_t)(ctx->state[i] >> 16);
+        out[i * 4 + 2] = (uint8_t)(ctx->state[i] >> 8);
+        out[i * 4 + 3] = (uint8_t)ctx->state[i];
+    }
+}
+
+// ============================================================================
+// CRC32C
+// ============================================================================
+
+uint32_t catzilla_crc32c(uint32_t crc, const void* data, size_t len) {
+    uv_once(&digest_once, init_digests);
+    crc32c_fn fn = force_portable ? crc32c_portable : crc32c_best;
+    return ~fn(~crc, data, len);
+}
+
+// ============================================================================
+// Upload digests
+// ============================================================================
+
+void catzilla_upload_digest_init(catzilla_upload_digest_t* digest, unsigned algorithms) {
+    memset(digest, 0, sizeof(*digest));
+    digest->algorithms = algorithms & (CATZILLA_DIGEST_SHA256 | CATZILLA_DIGEST_CRC32C);
+    if (digest->algorithms & CATZILLA_DIGEST_SHA256) {
+        catzilla_sha256_init(&digest->sha256_state);
+    }
+}
+
+void catzilla_upload_digest_update(catzilla_upload_digest_t* digest, const void* data, size_t len) {
+    if (digest->complete || len == 0) return;
+    if (digest->algorithms & CATZILLA_DIGEST_SHA256) {
+        catzilla_sha256_update(&digest->sha256_state, data, len);
+    }
+    if (digest->algorithms & CATZILLA_DIGEST_CRC32C) {
+        digest->crc32c = catzilla_crc32c(digest->crc32c, data, len);
+    }
+}
+
+void catzilla_upload_digest_final(catzilla_upload_digest_t* digest) {
+    if (digest->complete || !digest->algorithms) return;
+    if (digest->algorithms & CATZILLA_DIGEST_SHA256) {
+        catzilla_sha256_final(&digest->sha256_state, digest->sha256);
+    }
+    digest->complete = true;
+}
+
+void catzilla_digest_to_hex(const uint8_t* data, size_t len, char* out) {
+    static const char hex[] = "0123456789abcdef";
+    for (size_t i = 0; i < len; i++) {
+        out[i * 2] = hex[data[i] >> 4];
+        out[i * 2 + 1] = hex[data[i] & 0x0f];
+    }
+    out[len * 2] = '\0';
+}
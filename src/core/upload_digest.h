@@ -0,0 +1,92 @@
+/*
+ * Catzilla upload digests - SHA-256 and CRC32C computed while data arrives
+ *
+ * An upload's digests are updated with each chunk as the parser hands it
+ * over, so they are ready when the part ends and the file never has to be
+ * read back. SHA-256 uses the SHA extensions (x86 SHA-NI, checked at run
+ * time, or ARMv8 crypto when the compiler targets it) and CRC32C the CRC
+ * instructions (SSE4.2 or ARMv8 CRC); both fall back to portable code.
+ */
+
+#ifndef CATZILLA_UPLOAD_DIGEST_H
+#define CATZILLA_UPLOAD_DIGEST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Digests an upload can carry
+#define CATZILLA_DIGEST_SHA256 0x1u
+#define CATZILLA_DIGEST_CRC32C 0x2u
+
+#define CATZILLA_SHA256_SIZE 32
+
+typedef struct catzilla_sha256_s {
+    uint32_t state[8];
+    uint64_t length;              // Bytes hashed so far
+    uint8_t block[64];            // Start of the next block
+    size_t block_len;
+} catzilla_sha256_t;
+
+// Digests of one upload; algorithms is 0 when none are wanted
+typedef struct catzilla_upload_digest_s {
+    unsigned algorithms;          // CATZILLA_DIGEST_* being computed
+    bool complete;                // Final values below are set
+    catzilla_sha256_t sha256_state;
+    uint32_t crc32c;
+    uint8_t sha256[CATZILLA_SHA256_SIZE];
+} catzilla_upload_digest_t;
+
+void catzilla_sha256_init(catzilla_sha256_t* ctx);
+void catzilla_sha256_update(catzilla_sha256_t* ctx, const void* data, size_t len);
+void catzilla_sha256_final(catzilla_sha256_t* ctx, uint8_t out[CATZILLA_SHA256_SIZE]);
+
+/**
+ * Extend a CRC32C (Castagnoli)
+ * @param crc CRC of the data so far, 0 to start
+ * @param data Next bytes
+ * @param len Length of data
+ * @return CRC of everything so far
+ */
+uint32_t catzilla_crc32c(uint32_t crc, const void* data, size_t len);
+
+/**
+ * Start an upload's digests
+ * @param digest Digest state
+ * @param algorithms CATZILLA_DIGEST_* flags (0 computes nothing)
+ */
+void catzilla_upload_digest_init(catzilla_upload_digest_t* digest, unsigned algorithms);
+void catzilla_upload_digest_update(catzilla_upload_digest_t* digest, const void* data, size_t len);
+void catzilla_upload_digest_final(catzilla_upload_digest_t* digest);
+
+/**
+ * Format bytes as lowercase hex
+ * @param data Bytes
+ * @param len Length of data
+ * @param out Receives 2 * len characters and a NUL
+ */
+void catzilla_digest_to_hex(const uint8_t* data, size_t len, char* out);
+
+/**
+ * Instruction set extensions in use
+ * @return "sha-ni", "armv8" or "portable" for SHA-256; "sse4.2", "armv8" or
+ *         "portable" for CRC32C
+ */
+const char* catzilla_sha256_backend(void);
+const char* catzilla_crc32c_backend(void);
+
+/**
+ * Force the portable code, for tests and benchmarks comparing against it
+ * @param portable true to stop using the instruction set extensions
+ */
+void catzilla_digest_use_portable(bool portable);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CATZILLA_UPLOAD_DIGEST_H
@@ -9,6 +9,8 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <ctype.h>
+#include <errno.h>
+#include <limits.h>
 #include <time.h>
 
 // Platform-specific includes
@@ -59,11 +61,33 @@ static char* strcasestr(const char* haystack, const char* needle) {
 #define strncasecmp _strnicmp
 #endif
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CATZILLA_MULTIPART_SSE2 1
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(__GNUC__)
+#include <arm_neon.h>
+#define CATZILLA_MULTIPART_NEON 1
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+static inline unsigned first_set_bit(uint32_t bits) {
+    unsigned long index;
+    _BitScanForward(&index, bits);
+    return (unsigned)index;
+}
+#else
+static inline unsigned first_set_bit(uint32_t bits) {
+    return (unsigned)__builtin_ctz(bits);
+}
+#endif
+
 // Static function declarations
-static int parse_multipart_boundary(multipart_parser_t* parser, const char* data, size_t len);
-static int parse_multipart_headers(multipart_parser_t* parser, const char* data, size_t len);
-static int parse_multipart_data(multipart_parser_t* parser, const char* data, size_t len);
-static int find_boundary_in_buffer(const char* buffer, size_t len, const char* boundary, size_t boundary_len);
+static int parse_part_headers(multipart_parser_t* parser, const char* data, size_t len);
+static int parse_delimiter_end(multipart_parser_t* parser, const char* data, size_t len);
+static int scan_part_body(multipart_parser_t* parser, const char* data, size_t len);
+static int start_part(multipart_parser_t* parser, const char* headers);
+static int finish_part(multipart_parser_t* parser);
 static char* extract_header_value(const char* headers, const char* header_name);
 static void cleanup_upload_file_internal(catzilla_upload_file_t* file);
 
@@ -83,20 +107,34 @@ int catzilla_multipart_parse_init(multipart_parser_t* parser, const char* conten
 
     // Extract boundary from Content-Type header
     parser->boundary = catzilla_extract_boundary(content_type);
-    if (!parser->boundary) {
+    if (!parser->boundary || parser->boundary[0] == '\0') {
         LOG_PARSER_ERROR("Failed to extract boundary from Content-Type: %s", content_type);
+        free(parser->boundary);
+        parser->boundary = NULL;
         return -1;
     }
 
     parser->boundary_len = strlen(parser->boundary);
     LOG_PARSER_DEBUG("Extracted boundary: %s (length: %zu)", parser->boundary, parser->boundary_len);
 
-    // Initialize buffer for parsing
-    parser->buffer_size = 8192; // 8KB initial buffer
+    parser->delimiter_len = parser->boundary_len + 4;
+    parser->delimiter = malloc(parser->delimiter_len + 1);
+    if (!parser->delimiter) {
+        LOG_PARSER_ERROR("Failed to allocate multipart delimiter");
+        free(parser->boundary);
+        parser->boundary = NULL;
+        return -1;
+    }
+    memcpy(parser->delimiter, "\r\n--", 4);
+    memcpy(parser->delimiter + 4, parser->boundary, parser->boundary_len + 1);
+
+    // Initialize buffer for part headers
+    parser->buffer_size = 1024;
     parser->buffer = malloc(parser->buffer_size);
     if (!parser->buffer) {
         LOG_PARSER_ERROR("Failed to allocate parser buffer");
         free(parser->boundary);
+        free(parser->delimiter);
         return -1;
     }
 
@@ -106,6 +144,7 @@ int catzilla_multipart_parse_init(multipart_parser_t* parser, const char* conten
     if (!parser->files) {
         LOG_PARSER_ERROR("Failed to allocate files array");
         free(parser->boundary);
+        free(parser->delimiter);
         free(parser->buffer);
         return -1;
     }
@@ -120,6 +159,9 @@ int catzilla_multipart_parse_init(multipart_parser_t* parser, const char* conten
         LOG_MEMORY_WARN("Failed to initialize memory manager, using standard malloc");
     }
 
+    // The first delimiter may open the body without a line break before it,
+    // so the search starts as if a '\n' had just been seen
+    parser->match_len = 1;
     parser->state = MULTIPART_STATE_BOUNDARY;
     LOG_PARSER_INFO("Multipart parser initialized successfully");
     return 0;
@@ -137,62 +179,39 @@ int catzilla_multipart_parse_chunk(multipart_parser_t* parser, const char* data,
         return -1;
     }
 
-    // Ensure buffer has enough space
-    if (parser->buffer_pos + len > parser->buffer_size) {
-        size_t new_size = parser->buffer_size;
-        while (new_size < parser->buffer_pos + len) {
-            new_size *= 2;
-        }
-
-        char* new_buffer = realloc(parser->buffer, new_size);
-        if (!new_buffer) {
-            LOG_PARSER_ERROR("Failed to reallocate parser buffer to %zu bytes", new_size);
-            parser->state = MULTIPART_STATE_ERROR;
-            return -1;
-        }
-
-        parser->buffer = new_buffer;
-        parser->buffer_size = new_size;
-        LOG_PARSER_DEBUG("Reallocated parser buffer to %zu bytes", new_size);
-    }
-
-    // Copy data to buffer
-    memcpy(parser->buffer + parser->buffer_pos, data, len);
-    parser->buffer_pos += len;
+    parser->body_received += len;
 
-    // Process buffer based on current state
-    int result = 0;
-    while (parser->buffer_pos > 0 && parser->state != MULTIPART_STATE_ERROR && parser->state != MULTIPART_STATE_END) {
+    // Each state consumes what it can and leaves the rest to the next one
+    size_t pos = 0;
+    while (pos < len && parser->state != MULTIPART_STATE_ERROR && parser->state != MULTIPART_STATE_END) {
+        int consumed;
         switch (parser->state) {
             case MULTIPART_STATE_BOUNDARY:
-                result = parse_multipart_boundary(parser, parser->buffer, parser->buffer_pos);
+            case MULTIPART_STATE_DATA:
+                consumed = scan_part_body(parser, data + pos, len - pos);
                 break;
 
-            case MULTIPART_STATE_HEADERS:
-                result = parse_multipart_headers(parser, parser->buffer, parser->buffer_pos);
+            case MULTIPART_STATE_DELIMITER_END:
+                consumed = parse_delimiter_end(parser, data + pos, len - pos);
                 break;
 
-            case MULTIPART_STATE_DATA:
-                result = parse_multipart_data(parser, parser->buffer, parser->buffer_pos);
+            case MULTIPART_STATE_HEADERS:
+                consumed = parse_part_headers(parser, data + pos, len - pos);
                 break;
 
             default:
                 LOG_PARSER_ERROR("Unknown multipart parser state: %d", parser->state);
-                parser->state = MULTIPART_STATE_ERROR;
-                result = -1;
+                consumed = -1;
         }
 
-        if (result < 0) {
+        if (consumed < 0) {
             parser->state = MULTIPART_STATE_ERROR;
             break;
         }
-
-        if (result == 0) {
-            // Need more data
-            break;
-        }
+        pos += (size_t)consumed;
     }
 
+    // Anything after the closing delimiter is epilogue and ignored
     return (parser->state == MULTIPART_STATE_ERROR) ? -1 : 0;
 }
 
@@ -207,18 +226,29 @@ int catzilla_multipart_parse_complete(multipart_parser_t* parser) {
         return -1;
     }
 
-    // Finalize current file if any
+    // A body cut off before its closing delimiter keeps what arrived,
+    // including bytes held back as a possible delimiter
     if (parser->current_file) {
-        if (catzilla_upload_file_finalize(parser->current_file) != 0) {
-            LOG_PARSER_ERROR("Failed to finalize current upload file");
-            return -1;
+        if (parser->state == MULTIPART_STATE_DATA && (parser->match_len > 0 || parser->match_cr)) {
+            const char* held = parser->match_cr ? parser->delimiter : parser->delimiter + 1;
+            size_t held_len = parser->match_len + (parser->match_cr ? 1 : 0);
+            parser->match_len = 0;
+            parser->match_cr = false;
+            if (catzilla_upload_file_write_chunk(parser->current_file, held, held_len) != 0) {
+                LOG_PARSER_ERROR("Failed to write final chunk to upload file");
+                parser->state = MULTIPART_STATE_ERROR;
+                return -1;
+            }
         }
-
-        if (parser->on_file_end) {
-            parser->on_file_end(parser, parser->current_file);
+        if (parser->state != MULTIPART_STATE_END) {
+            LOG_PARSER_DEBUG("Multipart body ended without a closing delimiter");
         }
 
-        parser->current_file = NULL;
+        if (finish_part(parser) != 0) {
+            LOG_PARSER_ERROR("Failed to finalize current upload file");
+            parser->state = MULTIPART_STATE_ERROR;
+            return -1;
+        }
     }
 
     // Call completion callback
@@ -231,85 +261,262 @@ int catzilla_multipart_parse_complete(multipart_parser_t* parser) {
     return 0;
 }
 
-// Parse boundary state
-static int parse_multipart_boundary(multipart_parser_t* parser, const char* data, size_t len) {
-    // Look for the boundary
-    int boundary_pos = find_boundary_in_buffer(data, len, parser->boundary, parser->boundary_len);
+// Next '\n' followed by '-', or a '\n' that is the last byte
+static const char* find_delimiter_candidate(const char* p, const char* end) {
+#if defined(CATZILLA_MULTIPART_SSE2)
+    const __m128i lf = _mm_set1_epi8('\n');
+    const __m128i dash = _mm_set1_epi8('-');
+    while (end - p >= 17) {
+        __m128i first = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)p), lf);
+        __m128i second = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(p + 1)), dash);
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_and_si128(first, second));
+        if (mask) {
+            return p + first_set_bit(mask);
+        }
+        p += 16;
+    }
+#elif defined(CATZILLA_MULTIPART_NEON)
+    const uint8x16_t lf = vdupq_n_u8('\n');
+    const uint8x16_t dash = vdupq_n_u8('-');
+    while (end - p >= 17) {
+        uint8x16_t hits = vandq_u8(vceqq_u8(vld1q_u8((const uint8_t*)p), lf),
+                                   vceqq_u8(vld1q_u8((const uint8_t*)(p + 1)), dash));
+        // Narrow each byte to a nibble: 64 bits, 4 per input byte
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(hits), 4)), 0);
+        if (mask) {
+            return p + (__builtin_ctzll(mask) >> 2);
+        }
+        p += 16;
+    }
+#endif
+    while (p < end) {
+        const char* lf_at = memchr(p, '\n', (size_t)(end - p));
+        if (!lf_at) {
+            return end;
+        }
+        if (lf_at + 1 == end || lf_at[1] == '-') {
+            return lf_at;
+        }
+        p = lf_at + 1;
+    }
+    return end;
+}
+
+// Offset of the first "\n--boundary" in data, or of a prefix of it that runs
+// into the end of data (*partial set); len when there is neither
+static size_t find_delimiter(const char* needle, size_t needle_len, const char* data, size_t len,
+                             bool* partial) {
+    const char* p = data;
+    const char* end = data + len;
+    *partial = false;
+
+    for (;;) {
+        const char* hit = find_delimiter_candidate(p, end);
+        if (hit == end) {
+            return len;
+        }
+        size_t available = (size_t)(end - hit);
+        if (available >= needle_len) {
+            if (memcmp(hit, needle, needle_len) == 0) {
+                return (size_t)(hit - data);
+            }
+        } else if (memcmp(hit, needle, available) == 0) {
+            *partial = true;
+            return (size_t)(hit - data);
+        }
+        p = hit + 1;
+    }
+}
 
-    if (boundary_pos < 0) {
-        // Boundary not found, need more data
+// Hand part data to the current file; the preamble is dropped
+static int emit_part_data(multipart_parser_t* parser, const char* data, size_t len) {
+    catzilla_upload_file_t* file = parser->current_file;
+    if (len == 0 || parser->state != MULTIPART_STATE_DATA || !file) {
         return 0;
     }
 
-    // Found boundary, check if it's the end boundary
-    size_t total_boundary_len = 2 + parser->boundary_len; // "--" + boundary
-    if (boundary_pos + total_boundary_len + 2 < len) {
-        if (data[boundary_pos + total_boundary_len] == '-' &&
-            data[boundary_pos + total_boundary_len + 1] == '-') {
-            // End boundary found
-            parser->state = MULTIPART_STATE_END;
-            return 1;
+    // Upload parts past the threshold go to disk; form fields stay in memory
+    if (parser->spill_threshold > 0 && file->filename && file->temp_fd < 0 &&
+        file->bytes_received + len > parser->spill_threshold) {
+        // The part cannot outgrow what is left of the body
+        uint64_t rest = parser->body_length > parser->body_received ? parser->body_length - parser->body_received : 0;
+        file->expected_size = parser->body_length ? file->bytes_received + len + rest : 0;
+        if (catzilla_upload_file_spill(file) != 0) {
+            LOG_PARSER_ERROR("Failed to spill upload file to disk");
+            return -1;
         }
     }
 
-    // Regular boundary, move to headers
-    size_t consumed = boundary_pos + total_boundary_len;
-
-    // Skip CRLF after boundary
-    if (consumed + 1 < len && data[consumed] == '\r' && data[consumed + 1] == '\n') {
-        consumed += 2;
-    } else if (consumed < len && data[consumed] == '\n') {
-        consumed += 1;
+    if (catzilla_upload_file_write_chunk(file, data, len) != 0) {
+        LOG_PARSER_ERROR("Failed to write chunk to upload file");
+        return -1;
     }
 
-    // Move remaining data to beginning of buffer
-    if (consumed < len) {
-        memmove(parser->buffer, data + consumed, len - consumed);
-        parser->buffer_pos = len - consumed;
-    } else {
-        parser->buffer_pos = 0;
+    if (parser->on_file_data) {
+        parser->on_file_data(parser, file, data, len);
     }
+    return 0;
+}
 
-    parser->state = MULTIPART_STATE_HEADERS;
-    return 1;
+// Delimiter found: close the part it ends
+static int on_delimiter(multipart_parser_t* parser) {
+    if (parser->state == MULTIPART_STATE_DATA && finish_part(parser) != 0) {
+        return -1;
+    }
+    parser->match_len = 0;
+    parser->match_cr = false;
+    parser->delimiter_dashes = 0;
+    parser->state = MULTIPART_STATE_DELIMITER_END;
+    return 0;
 }
 
-// Parse headers state
-static int parse_multipart_headers(multipart_parser_t* parser, const char* data, size_t len) {
-    // Look for double CRLF (end of headers)
-    char* header_end = NULL;
-    size_t header_end_len = 0;
+// Preamble or part data up to the next delimiter
+static int scan_part_body(multipart_parser_t* parser, const char* data, size_t len) {
+    const char* needle = parser->delimiter + 1;  // "\n--boundary"
+    size_t needle_len = parser->delimiter_len - 1;
+
+    // Finish (or give up on) a delimiter the previous chunk ended inside
+    if (parser->match_len > 0 || parser->match_cr) {
+        size_t rest = needle_len - parser->match_len;
+        size_t compare = len < rest ? len : rest;
+        if (memcmp(data, needle + parser->match_len, compare) == 0) {
+            if (compare < rest) {
+                parser->match_len += compare;
+                return (int)len;
+            }
+            if (on_delimiter(parser) != 0) {
+                return -1;
+            }
+            return (int)compare;
+        }
 
-    for (size_t i = 0; i < len - 3; i++) {
-        if (data[i] == '\r' && data[i + 1] == '\n' &&
-            data[i + 2] == '\r' && data[i + 3] == '\n') {
-            header_end = (char*)(data + i);
-            header_end_len = 4;
-            break;
-        } else if (data[i] == '\n' && data[i + 1] == '\n') {
-            header_end = (char*)(data + i);
-            header_end_len = 2;
-            break;
+        // Not a delimiter after all: the held bytes were data
+        const char* held = parser->match_cr ? parser->delimiter : parser->delimiter + 1;
+        size_t held_len = parser->match_len + (parser->match_cr ? 1 : 0);
+        parser->match_len = 0;
+        parser->match_cr = false;
+        if (emit_part_data(parser, held, held_len) != 0) {
+            return -1;
         }
     }
 
-    if (!header_end) {
-        // Headers not complete, need more data
-        return 0;
+    // Keep chunks small enough that the size fits the int return
+    if (len > INT_MAX) {
+        len = INT_MAX;
+    }
+
+    bool partial;
+    size_t at = find_delimiter(needle, needle_len, data, len, &partial);
+    if (at == len) {
+        // A trailing '\r' could be the start of the next delimiter
+        if (data[len - 1] == '\r') {
+            parser->match_cr = true;
+            len--;
+        }
+        if (emit_part_data(parser, data, len) != 0) {
+            return -1;
+        }
+        return (int)(len + (parser->match_cr ? 1 : 0));
     }
 
-    // Extract headers
-    size_t headers_len = header_end - data;
-    char* headers = malloc(headers_len + 1);
-    if (!headers) {
-        LOG_PARSER_ERROR("Failed to allocate memory for headers");
+    bool cr = at > 0 && data[at - 1] == '\r';
+    if (emit_part_data(parser, data, cr ? at - 1 : at) != 0) {
         return -1;
     }
+    if (partial) {
+        parser->match_cr = cr;
+        parser->match_len = len - at;
+        return (int)len;
+    }
+    if (on_delimiter(parser) != 0) {
+        return -1;
+    }
+    return (int)(at + needle_len);
+}
 
-    memcpy(headers, data, headers_len);
-    headers[headers_len] = '\0';
+// After a delimiter: "--" closes the body, otherwise the line ends and the
+// next part's headers follow (transport padding is skipped)
+static int parse_delimiter_end(multipart_parser_t* parser, const char* data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        char c = data[i];
+        if (c == '-' && parser->delimiter_dashes < 2) {
+            if (++parser->delimiter_dashes == 2) {
+                parser->state = MULTIPART_STATE_END;
+                return (int)(i + 1);
+            }
+        } else if (parser->delimiter_dashes == 1) {
+            LOG_PARSER_ERROR("Malformed multipart delimiter");
+            return -1;
+        } else if (c == '\n') {
+            parser->buffer_pos = 0;
+            parser->header_line_start = true;
+            parser->state = MULTIPART_STATE_HEADERS;
+            return (int)(i + 1);
+        } else if (c != '\r' && c != ' ' && c != '\t') {
+            LOG_PARSER_ERROR("Unexpected byte after multipart delimiter");
+            return -1;
+        }
+    }
+    return (int)len;
+}
 
-    LOG_PARSER_DEBUG("Parsed headers (%zu bytes): %s", headers_len, headers);
+// Collect a part's headers up to the blank line that ends them
+static int parse_part_headers(multipart_parser_t* parser, const char* data, size_t len) {
+    size_t take = len;
+    bool complete = false;
+    for (size_t i = 0; i < len; i++) {
+        char c = data[i];
+        if (c == '\n') {
+            if (parser->header_line_start) {
+                take = i + 1;
+                complete = true;
+                break;
+            }
+            parser->header_line_start = true;
+        } else if (c != '\r') {
+            parser->header_line_start = false;
+        }
+    }
+
+    if (parser->buffer_pos + take > MULTIPART_MAX_HEADER_BYTES) {
+        LOG_PARSER_ERROR("Multipart part headers exceed %d bytes", MULTIPART_MAX_HEADER_BYTES);
+        return -1;
+    }
+    if (parser->buffer_pos + take + 1 > parser->buffer_size) {
+        size_t new_size = parser->buffer_size;
+        while (new_size < parser->buffer_pos + take + 1) {
+            new_size *= 2;
+        }
+        char* new_buffer = realloc(parser->buffer, new_size);
+        if (!new_buffer) {
+            LOG_PARSER_ERROR("Failed to reallocate parser buffer to %zu bytes", new_size);
+            return -1;
+        }
+        parser->buffer = new_buffer;
+        parser->buffer_size = new_size;
+    }
+    memcpy(parser->buffer + parser->buffer_pos, data, take);
+    parser->buffer_pos += take;
+
+    if (complete) {
+        parser->buffer[parser->buffer_pos] = '\0';
+        if (start_part(parser, parser->buffer) != 0) {
+            return -1;
+        }
+        parser->buffer_pos = 0;
+        parser->state = MULTIPART_STATE_DATA;
+    }
+    return (int)take;
+}
+
+// Create the file for a part from its headers
+static int start_part(multipart_parser_t* parser, const char* headers) {
+    LOG_PARSER_DEBUG("Parsed headers (%zu bytes): %s", strlen(headers), headers);
+
+    if (parser->files_count >= parser->max_files) {
+        LOG_PARSER_ERROR("Multipart body has more than %zu parts", parser->max_files);
+        return -1;
+    }
 
     // Parse Content-Disposition header for filename and field name
     char* content_disposition = extract_header_value(headers, "Content-Disposition");
@@ -329,15 +536,13 @@ static int parse_multipart_headers(multipart_parser_t* parser, const char* data,
         content_type = strdup("application/octet-stream"); // Default type
     }
 
-    free(headers);
-
     // Create new upload file
     parser->current_file = catzilla_upload_file_create(field_name, filename, content_type);
+    free(field_name);
+    free(filename);
+    free(content_type);
     if (!parser->current_file) {
         LOG_PARSER_ERROR("Failed to create upload file");
-        free(field_name);
-        free(filename);
-        free(content_type);
         return -1;
     }
 
@@ -350,9 +555,6 @@ static int parse_multipart_headers(multipart_parser_t* parser, const char* data,
             LOG_PARSER_ERROR("Failed to expand files array");
             catzilla_upload_file_cleanup(parser->current_file);
             parser->current_file = NULL;
-            free(field_name);
-            free(filename);
-            free(content_type);
             return -1;
         }
         parser->files = new_files;
@@ -361,118 +563,34 @@ static int parse_multipart_headers(multipart_parser_t* parser, const char* data,
 
     parser->files[parser->files_count++] = parser->current_file;
     catzilla_upload_file_ref(parser->current_file); // Add reference for array
+    parser->current_file->direct_io = parser->direct_io;
+    catzilla_upload_digest_init(&parser->current_file->digest, parser->digest_algorithms);
 
     // Call file start callback
     if (parser->on_file_start) {
         parser->on_file_start(parser, parser->current_file);
     }
-
-    // Move to data parsing state
-    size_t consumed = headers_len + header_end_len;
-    if (consumed < len) {
-        memmove(parser->buffer, data + consumed, len - consumed);
-        parser->buffer_pos = len - consumed;
-    } else {
-        parser->buffer_pos = 0;
-    }
-
-    parser->state = MULTIPART_STATE_DATA;
-
-    free(field_name);
-    free(filename);
-    free(content_type);
-    return 1;
+    return 0;
 }
 
-// Parse data state
-static int parse_multipart_data(multipart_parser_t* parser, const char* data, size_t len) {
-    if (!parser->current_file) {
-        LOG_PARSER_ERROR("No current file for data parsing");
-        return -1;
-    }
-
-    // Look for next boundary
-    int boundary_pos = find_boundary_in_buffer(data, len, parser->boundary, parser->boundary_len);
-
-    if (boundary_pos < 0) {
-        // No boundary found, all data belongs to current file
-        if (len > 0) {
-            int result = catzilla_upload_file_write_chunk(parser->current_file, data, len);
-            if (result != 0) {
-                LOG_PARSER_ERROR("Failed to write chunk to upload file");
-                return -1;
-            }
-
-            if (parser->on_file_data) {
-                parser->on_file_data(parser, parser->current_file, data, len);
-            }
-        }
-
-        parser->buffer_pos = 0; // All data consumed
-        return 0; // Need more data
-    }
-
-    // Found boundary, write data before boundary to current file
-    if (boundary_pos > 0) {
-        // Remove trailing CRLF before boundary
-        size_t data_len = boundary_pos;
-        if (data_len >= 2 && data[data_len - 2] == '\r' && data[data_len - 1] == '\n') {
-            data_len -= 2;
-        } else if (data_len >= 1 && data[data_len - 1] == '\n') {
-            data_len -= 1;
-        }
-
-        if (data_len > 0) {
-            int result = catzilla_upload_file_write_chunk(parser->current_file, data, data_len);
-            if (result != 0) {
-                LOG_PARSER_ERROR("Failed to write final chunk to upload file");
-                return -1;
-            }
-
-            if (parser->on_file_data) {
-                parser->on_file_data(parser, parser->current_file, data, data_len);
-            }
-        }
-    }
-
-    // Finalize current file
-    if (catzilla_upload_file_finalize(parser->current_file) != 0) {
-        LOG_PARSER_ERROR("Failed to finalize upload file");
-        return -1;
-    }
-
-    if (parser->on_file_end) {
-        parser->on_file_end(parser, parser->current_file);
+// Finalize the current file and drop the parser's reference to it
+static int finish_part(multipart_parser_t* parser) {
+    catzilla_upload_file_t* file = parser->current_file;
+    if (!file) {
+        return 0;
     }
-
     parser->current_file = NULL;
 
-    // Move remaining data to beginning of buffer
-    if (boundary_pos < len) {
-        memmove(parser->buffer, data + boundary_pos, len - boundary_pos);
-        parser->buffer_pos = len - boundary_pos;
-    } else {
-        parser->buffer_pos = 0;
-    }
-
-    parser->state = MULTIPART_STATE_BOUNDARY;
-    return 1;
-}
-
-// Find boundary in buffer
-static int find_boundary_in_buffer(const char* buffer, size_t len, const char* boundary, size_t boundary_len) {
-    if (len < boundary_len + 2) {
-        return -1; // Not enough data for boundary
-    }
-
-    for (size_t i = 0; i <= len - boundary_len - 2; i++) {
-        if (buffer[i] == '-' && buffer[i + 1] == '-' &&
-            memcmp(buffer + i + 2, boundary, boundary_len) == 0) {
-            return i;
-        }
+    int rc = catzilla_upload_file_finalize(file);
+    if (rc != 0) {
+        LOG_PARSER_ERROR("Failed to finalize upload file");
+    } else if (parser->on_file_end) {
+        parser->on_file_end(parser, file);
     }
 
-    return -1;
+    // The files array keeps its own reference
+    catzilla_upload_file_unref(file);
+    return rc;
 }
 
 // Extract header value
@@ -563,6 +681,7 @@ catzilla_upload_file_t* catzilla_upload_file_create(const char* field_name, cons
     file->state = UPLOAD_STATE_INITIALIZING;
     file->upload_start_time = catzilla_get_time_ns();
     file->ref_count = 1;
+    file->temp_fd = -1;
     file->buffer_size = 8192; // 8KB default buffer
 
     // Determine size class for memory optimization
@@ -594,8 +713,12 @@ int catzilla_upload_file_write_chunk(catzilla_upload_file_t* file, const char* d
         return -1;
     }
 
+    catzilla_upload_digest_update(&file->digest, data, len);
+
     // Update size and performance metrics
+    size_t offset = (size_t)file->bytes_received;
     file->bytes_received += len;
+    file->size = file->bytes_received;
     catzilla_atomic_increment(&file->chunks_processed);
 
     // Update size class based on current size
@@ -613,6 +736,15 @@ int catzilla_upload_file_write_chunk(catzilla_upload_file_t* file, const char* d
         file->upload_speed_mbps = mb_received / elapsed_seconds;
     }
 
+    // A spilled file goes through its sink to the temp file
+    if (file->temp_fd >= 0) {
+        if (catzilla_upload_sink_write(file->sink, data, len) != 0) {
+            catzilla_upload_set_error(file, CATZILLA_UPLOAD_ERROR_DISK_FULL, "Temp file write failed");
+            return -1;
+        }
+        return 0;
+    }
+
     // Check if this is a text file that should be null-terminated
     bool is_text_file = false;
     if (file->content_type) {
@@ -623,36 +755,18 @@ int catzilla_upload_file_write_chunk(catzilla_upload_file_t* file, const char* d
                        (strstr(file->content_type, "css") != NULL);
     }
 
-    // Store data in memory
-    if (!file->content) {
-        // First chunk - allocate initial buffer (extra byte only for text files)
-        size_t alloc_size = len + (is_text_file ? 1 : 0);
-        file->content = malloc(alloc_size);
-        if (!file->content) {
-            LOG_PARSER_ERROR("Failed to allocate memory for file content");
-            return -1;
-        }
-        memcpy(file->content, data, len);
-        if (is_text_file) {
-            file->content[len] = '\0';  // Null terminate only for text files
-        }
-    } else {
-        // Subsequent chunks - reallocate buffer (extra byte only for text files)
-        size_t alloc_size = file->bytes_received + len + (is_text_file ? 1 : 0);
-        char* new_content = realloc(file->content, alloc_size);
-        if (!new_content) {
-            LOG_PARSER_ERROR("Failed to reallocate memory for file content");
-            return -1;
-        }
-        file->content = new_content;
-        memcpy(file->content + file->bytes_received, data, len);
-        if (is_text_file) {
-            file->content[file->bytes_received + len] = '\0';  // Null terminate only for text files
-        }
+    // Store data in memory (extra byte only for text files)
+    size_t alloc_size = offset + len + (is_text_file ? 1 : 0);
+    char* new_content = realloc(file->content, alloc_size);
+    if (!new_content) {
+        LOG_PARSER_ERROR("Failed to allocate memory for file content");
+        return -1;
+    }
+    file->content = new_content;
+    memcpy(file->content + offset, data, len);
+    if (is_text_file) {
+        file->content[offset + len] = '\0';  // Null terminate only for text files
     }
-
-    // Update total size to include the new data
-    file->size = file->bytes_received + len;
 
     LOG_PARSER_DEBUG("Wrote %zu bytes to upload file (total: %" PRIu64 " bytes, speed: %.2f MB/s)",
               len, file->size, file->upload_speed_mbps);
@@ -660,6 +774,44 @@ int catzilla_upload_file_write_chunk(catzilla_upload_file_t* file, const char* d
     return 0;
 }
 
+// Move an upload to a temp file once it outgrows memory
+int catzilla_upload_file_spill(catzilla_upload_file_t* file) {
+    if (!file) {
+        return -1;
+    }
+    if (file->temp_fd >= 0) {
+        return 0;
+    }
+
+    char path[64];
+    int fd = catzilla_stream_create_temp_file(path, sizeof(path));
+    if (fd < 0) {
+        return -1;
+    }
+    file->sink = catzilla_upload_sink_create(fd, file->expected_size, file->direct_io);
+    if (!file->sink) {
+        close(fd);
+        unlink(path);
+        return -1;
+    }
+
+    free(file->temp_file_path);
+    file->temp_file_path = strdup(path);
+    file->temp_fd = fd;
+    file->owns_temp_file = true;
+    if (!file->temp_file_path ||
+        catzilla_upload_sink_write(file->sink, file->content, (size_t)file->bytes_received) != 0) {
+        catzilla_upload_set_error(file, CATZILLA_UPLOAD_ERROR_DISK_FULL, "Temp file write failed");
+        return -1;
+    }
+
+    free(file->content);
+    file->content = NULL;
+    LOG_PARSER_DEBUG("Spilled upload file %s to %s after %" PRIu64 " bytes",
+              file->filename ? file->filename : "unknown", path, file->bytes_received);
+    return 0;
+}
+
 // Finalize upload file
 int catzilla_upload_file_finalize(catzilla_upload_file_t* file) {
     if (!file) {
@@ -669,6 +821,21 @@ int catzilla_upload_file_finalize(catzilla_upload_file_t* file) {
     file->state = UPLOAD_STATE_COMPLETE;
     file->size = file->bytes_received;
 
+    catzilla_upload_digest_final(&file->digest);
+
+    // Flush and close a spilled file; readers open it by path
+    if (file->temp_fd >= 0) {
+        int rc = catzilla_upload_sink_finish(file->sink);
+        catzilla_upload_sink_free(file->sink);
+        file->sink = NULL;
+        close(file->temp_fd);
+        file->temp_fd = -1;
+        if (rc != 0) {
+            catzilla_upload_set_error(file, CATZILLA_UPLOAD_ERROR_DISK_FULL, "Temp file write failed");
+            return -1;
+        }
+    }
+
     LOG_PARSER_INFO("Finalized upload file: %s (%" PRIu64 " bytes, %.2f MB/s)",
              file->filename ? file->filename : "unknown",
              file->size, file->upload_speed_mbps);
@@ -688,6 +855,9 @@ void catzilla_multipart_parser_cleanup(multipart_parser_t* parser) {
         parser->boundary = NULL;
     }
 
+    free(parser->delimiter);
+    parser->delimiter = NULL;
+
     // Cleanup buffer
     if (parser->buffer) {
         free(parser->buffer);
@@ -750,6 +920,13 @@ static void cleanup_upload_file_internal(catzilla_upload_file_t* file) {
     free(file->content_type);
     free(file->content);
     free(file->error_message);
+    catzilla_upload_sink_free(file->sink);
+    if (file->temp_fd >= 0) {
+        close(file->temp_fd);
+    }
+    if (file->owns_temp_file && file->temp_file_path) {
+        unlink(file->temp_file_path);
+    }
     free(file->temp_file_path);
     free(file->streaming_buffer);
 
@@ -5,6 +5,9 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <uv.h>
+#include "upload_stream_buffer.h"
+#include "upload_digest.h"
+#include "upload_sink.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -26,6 +29,7 @@ typedef enum {
 // Streaming thresholds for memory optimization
 #define UPLOAD_STREAMING_THRESHOLD_BYTES (50 * 1024 * 1024)  // 50MB - stream to temp files above this
 #define UPLOAD_MEMORY_LIMIT_BYTES (1024 * 1024 * 1024)       // 1GB - absolute max file size
+#define MULTIPART_MAX_HEADER_BYTES (16 * 1024)               // Headers of one part
 
 // Error codes for file upload validation
 typedef enum {
@@ -73,6 +77,11 @@ typedef struct catzilla_upload_file_s {
     uv_stream_t* stream;
     uv_fs_t file_handle;
     char* temp_file_path;
+    bool owns_temp_file;     // Unlink temp_file_path when the file is freed
+    int temp_fd;             // Open while data is still being spilled, else -1
+    catzilla_upload_sink_t* sink;  // Writes temp_fd while it is open
+    uint64_t expected_size;  // Likely upper bound of the size, for preallocation; 0 unknown
+    bool direct_io;          // Spill with direct I/O
 
     // Performance tracking
     uint64_t upload_start_time;
@@ -92,6 +101,7 @@ typedef struct catzilla_upload_file_s {
     size_t allowed_types_count;
     bool validate_signature;
     bool virus_scan_enabled;
+    catzilla_upload_digest_t digest;  // Computed from the chunks as they arrive; complete once finalized
 
     // Error handling
     catzilla_upload_error_t error_code;
@@ -113,7 +123,8 @@ typedef enum {
     MULTIPART_STATE_HEADERS = 2,
     MULTIPART_STATE_DATA = 3,
     MULTIPART_STATE_END = 4,
-    MULTIPART_STATE_ERROR = 5
+    MULTIPART_STATE_ERROR = 5,
+    MULTIPART_STATE_DELIMITER_END = 6   // After a delimiter: "--" or the line end
 } multipart_state_t;
 
 // Multipart parser structure
@@ -123,7 +134,20 @@ typedef struct multipart_parser_s {
     char* boundary;
     size_t boundary_len;
 
-    // Current parsing position
+    // "\r\n--boundary"; the search looks for the part from '\n' on and
+    // drops a '\r' in front of it
+    char* delimiter;
+    size_t delimiter_len;
+
+    // Chunks are parsed as they arrive and never buffered whole. A delimiter
+    // that runs into the end of a chunk is remembered as the number of its
+    // bytes matched so far (and whether a '\r' came before them)
+    size_t match_len;
+    bool match_cr;
+    int delimiter_dashes;
+    bool header_line_start;
+
+    // Headers of the current part, collected up to MULTIPART_MAX_HEADER_BYTES
     char* buffer;
     size_t buffer_size;
     size_t buffer_pos;
@@ -139,6 +163,11 @@ typedef struct multipart_parser_s {
     // Parser configuration
     uint64_t max_total_size;
     size_t max_files;
+    uint64_t spill_threshold;  // File parts above this go to a temp file; 0 keeps them in memory
+    uint64_t body_length;      // Content-Length of the body, to preallocate spilled files; 0 unknown
+    uint64_t body_received;    // Body bytes fed so far
+    bool direct_io;            // Spill files with direct I/O
+    unsigned digest_algorithms;  // CATZILLA_DIGEST_* computed for file parts
 
     // Memory management
     upload_memory_manager_t* memory_manager;
@@ -149,10 +178,23 @@ typedef struct multipart_parser_s {
     void (*on_file_end)(multipart_parser_t* parser, catzilla_upload_file_t* file);
     void (*on_parse_complete)(multipart_parser_t* parser);
     void (*on_parse_error)(multipart_parser_t* parser, catzilla_upload_error_t error);
+    void* user_data;  // For the callbacks; the parser never touches it
 } multipart_parser_t;
 
 // Core parsing functions
 int catzilla_multipart_parse_init(multipart_parser_t* parser, const char* content_type);
+
+/**
+ * Feed the next piece of a multipart body. Pieces may be cut anywhere,
+ * including inside a delimiter or a part's headers; part data is handed to
+ * the current file as soon as it cannot be the start of a delimiter.
+ * Delimiters are found with a 16-byte SSE2/NEON scan for "\n-" followed by
+ * memcmp of the rest.
+ * @param parser Parser set up by catzilla_multipart_parse_init
+ * @param data Next bytes of the body
+ * @param len Length of data, at least 1
+ * @return 0 on success, -1 on malformed input or allocation failure
+ */
 int catzilla_multipart_parse_chunk(multipart_parser_t* parser, const char* data, size_t len);
 int catzilla_multipart_parse_complete(multipart_parser_t* parser);
 void catzilla_multipart_parser_cleanup(multipart_parser_t* parser);
@@ -161,6 +203,14 @@ void catzilla_multipart_parser_cleanup(multipart_parser_t* parser);
 catzilla_upload_file_t* catzilla_upload_file_create(const char* field_name, const char* filename, const char* content_type);
 int catzilla_upload_file_write_chunk(catzilla_upload_file_t* file, const char* data, size_t len);
 int catzilla_upload_file_finalize(catzilla_upload_file_t* file);
+
+/**
+ * Move a file's data to a temp file and send later chunks there through a
+ * write buffer. The file owns the temp file and unlinks it when freed.
+ * @param file File being received
+ * @return 0 on success (or if already spilled), -1 on I/O error
+ */
+int catzilla_upload_file_spill(catzilla_upload_file_t* file);
 void catzilla_upload_file_cleanup(catzilla_upload_file_t* file);
 
 // Reference counting
@@ -0,0 +1,296 @@
+#include "upload_sink.h"
+#include "logging.h"
+#include "platform_compat.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <uv.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#if (defined(__linux__) && defined(O_DIRECT)) || defined(__APPLE__)
+#define SINK_DIRECT_IO 1
+#endif
+
+struct catzilla_upload_sink_s {
+    int fd;
+    bool direct;                  // Writes bypass the page cache
+    uint64_t written;             // Bytes handed to the file (or the writer)
+    uint64_t reserved;            // Bytes preallocated
+    char* buffers[2];             // Direct I/O fills one while the other is written
+    int fill;                     // Buffer being filled
+    size_t capacity;
+    size_t used;                  // Bytes in buffers[fill]
+
+#ifdef SINK_DIRECT_IO
+    // Writer thread, started with the first full buffer
+    bool writer_started;
+    uv_thread_t writer;
+    uv_mutex_t lock;
+    uv_cond_t cond;
+    bool job;                     // A buffer is waiting or being written
+    const char* job_data;
+    size_t job_len;
+    uint64_t job_offset;
+    bool stop;
+    int error;                    // errno of the first failed write
+#endif
+};
+
+// Retry short writes until everything is on disk
+static int write_all(int fd, const char* data, size_t len) {
+    while (len > 0) {
+        ssize_t written = write(fd, data, len);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        data += written;
+        len -= (size_t)written;
+    }
+    return 0;
+}
+
+#ifdef SINK_DIRECT_IO
+
+static int pwrite_all(int fd, const char* data, size_t len, uint64_t offset) {
+    while (len > 0) {
+        ssize_t written = pwrite(fd, data, len, (off_t)offset);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+#ifdef __linux__
+            // Accepted at open but refused on write: go through the page cache
+            int flags = fcntl(fd, F_GETFL);
+            if (errno == EINVAL && flags >= 0 && (flags & O_DIRECT) &&
+                fcntl(fd, F_SETFL, flags & ~O_DIRECT) == 0) {
+                continue;
+            }
+#endif
+            return -1;
+        }
+        data += written;
+        len -= (size_t)written;
+        offset += (uint64_t)written;
+    }
+    return 0;
+}
+
+static void writer_main(void* arg) {
+    catzilla_upload_sink_t* sink = arg;
+    uv_mutex_lock(&sink->lock);
+    for (;;) {
+        while (!sink->job && !sink->stop) {
+            uv_cond_wait(&sink->cond, &sink->lock);
+        }
+        if (!sink->job) break;
+
+        const char* data = sink->job_data;
+        size_t len = sink->job_len;
+        uint64_t offset = sink->job_offset;
+        uv_mutex_unlock(&sink->lock);
+        int rc = pwrite_all(sink->fd, data, len, offset) == 0 ? 0 : errno;
+        uv_mutex_lock(&sink->lock);
+
+        if (rc != 0 && sink->error == 0) sink->error = rc;
+        sink->job = false;
+        uv_cond_broadcast(&sink->cond);
+    }
+    uv_mutex_unlock(&sink->lock);
+}
+
+// Wait until the writer is idle; the error of any earlier write is returned
+static int wait_for_writer(catzilla_upload_sink_t* sink) {
+    if (!sink->writer_started) return 0;
+    uv_mutex_lock(&sink->lock);
+    while (sink->job) {
+        uv_cond_wait(&sink->cond, &sink->lock);
+    }
+    int error = sink->error;
+    uv_mutex_unlock(&sink->lock);
+    if (error != 0) {
+        errno = error;
+        return -1;
+    }
+    return 0;
+}
+
+// Hand the filled buffer (len bytes, a multiple of the alignment) to the
+// writer and switch to the other one
+static int submit_buffer(catzilla_upload_sink_t* sink, size_t len) {
+    if (!sink->writer_started) {
+        if (uv_thread_create(&sink->writer, writer_main, sink) != 0) {
+            // No thread: write inline, still bypassing the page cache
+            if (pwrite_all(sink->fd, sink->buffers[sink->fill], len, sink->written) != 0) return -1;
+            sink->written += len;
+            sink->used = 0;
+            return 0;
+        }
+        sink->writer_started = true;
+    }
+    if (wait_for_writer(sink) != 0) return -1;
+
+    uv_mutex_lock(&sink->lock);
+    sink->job_data = sink->buffers[sink->fill];
+    sink->job_len = len;
+    sink->job_offset = sink->written;
+    sink->job = true;
+    uv_cond_broadcast(&sink->cond);
+    uv_mutex_unlock(&sink->lock);
+
+    sink->written += len;
+    sink->fill ^= 1;
+    sink->used = 0;
+    return 0;
+}
+
+static bool enable_direct_io(int fd) {
+#if defined(__APPLE__)
+    return fcntl(fd, F_NOCACHE, 1) == 0;
+#else
+    int flags = fcntl(fd, F_GETFL);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_DIRECT) == 0;
+#endif
+}
+
+#endif // SINK_DIRECT_IO
+
+catzilla_upload_sink_t* catzilla_upload_sink_create(int fd, uint64_t expected_size, bool direct_io) {
+    catzilla_upload_sink_t* sink = calloc(1, sizeof(*sink));
+    if (!sink) return NULL;
+    sink->fd = fd;
+
+#ifdef __linux__
+    if (expected_size >= CATZILLA_UPLOAD_SINK_PREALLOCATE_MIN &&
+        fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, (off_t)expected_size) == 0) {
+        sink->reserved = expected_size;
+    }
+#else
+    (void)expected_size;
+#endif
+
+#ifdef SINK_DIRECT_IO
+    if (direct_io) {
+        for (int i = 0; i < 2; i++) {
+            void* buffer = NULL;
+            if (posix_memalign(&buffer, CATZILLA_UPLOAD_SINK_ALIGN, CATZILLA_UPLOAD_SINK_DIRECT_BUFFER) != 0) {
+                sink->buffers[i] = NULL;
+                break;
+            }
+            sink->buffers[i] = buffer;
+        }
+        if (sink->buffers[0] && sink->buffers[1] && enable_direct_io(fd) &&
+            uv_mutex_init(&sink->lock) == 0) {
+            if (uv_cond_init(&sink->cond) == 0) {
+                sink->direct = true;
+                sink->capacity = CATZILLA_UPLOAD_SINK_DIRECT_BUFFER;
+                return sink;
+            }
+            uv_mutex_destroy(&sink->lock);
+        }
+        // Direct I/O is unavailable here: use the page cache
+        LOG_STREAM_DEBUG("Direct I/O unavailable for upload sink, using buffered writes");
+        free(sink->buffers[0]);
+        free(sink->buffers[1]);
+        sink->buffers[0] = sink->buffers[1] = NULL;
+    }
+#else
+    (void)direct_io;
+#endif
+
+    sink->buffers[0] = malloc(CATZILLA_UPLOAD_SINK_BUFFER);
+    if (!sink->buffers[0]) {
+        free(sink);
+        return NULL;
+    }
+    sink->capacity = CATZILLA_UPLOAD_SINK_BUFFER;
+    return sink;
+}
+
+// Write out the buffer being filled, which is full
+static int flush_full_buffer(catzilla_upload_sink_t* sink) {
+#ifdef SINK_DIRECT_IO
+    if (sink->direct) return submit_buffer(sink, sink->used);
+#endif
+    if (write_all(sink->fd, sink->buffers[0], sink->used) != 0) return -1;
+    sink->written += sink->used;
+    sink->used = 0;
+    return 0;
+}
+
+int catzilla_upload_sink_write(catzilla_upload_sink_t* sink, const char* data, size_t len) {
+    while (len > 0) {
+        if (sink->used == sink->capacity && flush_full_buffer(sink) != 0) return -1;
+        size_t space = sink->capacity - sink->used;
+        size_t chunk = len < space ? len : space;
+        memcpy(sink->buffers[sink->fill] + sink->used, data, chunk);
+        sink->used += chunk;
+        data += chunk;
+        len -= chunk;
+    }
+    return 0;
+}
+
+int catzilla_upload_sink_finish(catzilla_upload_sink_t* sink) {
+    uint64_t size = sink->written + sink->used;
+    bool truncate = sink->reserved > size;
+
+#ifdef SINK_DIRECT_IO
+    if (sink->direct) {
+        // The tail goes out padded to the alignment and is cut back below
+        size_t padded = (sink->used + CATZILLA_UPLOAD_SINK_ALIGN - 1) & ~(size_t)(CATZILLA_UPLOAD_SINK_ALIGN - 1);
+        if (padded > sink->used) {
+            memset(sink->buffers[sink->fill] + sink->used, 0, padded - sink->used);
+            truncate = true;
+        }
+        if (padded > 0 && submit_buffer(sink, padded) != 0) return -1;
+        if (wait_for_writer(sink) != 0) return -1;
+        sink->written = size;
+    } else
+#endif
+    if (sink->used > 0) {
+        if (write_all(sink->fd, sink->buffers[0], sink->used) != 0) return -1;
+        sink->written = size;
+        sink->used = 0;
+    }
+
+#ifndef _WIN32
+    if (truncate && ftruncate(sink->fd, (off_t)size) != 0) return -1;
+#else
+    (void)truncate;
+#endif
+    sink->reserved = 0;
+    return 0;
+}
+
+void catzilla_upload_sink_free(catzilla_upload_sink_t* sink) {
+    if (!sink) return;
+#ifdef SINK_DIRECT_IO
+    if (sink->writer_started) {
+        uv_mutex_lock(&sink->lock);
+        sink->stop = true;
+        uv_cond_broadcast(&sink->cond);
+        uv_mutex_unlock(&sink->lock);
+        uv_thread_join(&sink->writer);
+    }
+    if (sink->direct) {
+        uv_cond_destroy(&sink->cond);
+        uv_mutex_destroy(&sink->lock);
+    }
+#endif
+    free(sink->buffers[0]);
+    free(sink->buffers[1]);
+    free(sink);
+}
+
+bool catzilla_upload_sink_is_direct(const catzilla_upload_sink_t* sink) {
+    return sink && sink->direct;
+}
+
+uint64_t catzilla_upload_sink_size(const catzilla_upload_sink_t* sink) {
+    return sink ? sink->written + sink->used : 0;
+}
@@ -0,0 +1,82 @@
+/*
+ * Catzilla upload sink - writes an upload that spilled to its temp file
+ *
+ * Disk space for the rest of the body is reserved up front with fallocate,
+ * keeping the file size, so a large upload lands in few extents and runs
+ * out of space at the start rather than halfway; what was not used is
+ * released when the file ends. With direct I/O the data bypasses the page
+ * cache: it is gathered into two aligned buffers, and a writer thread
+ * writes one with O_DIRECT while the other fills. Without it, or where the
+ * file system refuses O_DIRECT, data goes through the page cache from one
+ * buffer. One sink is used from one thread.
+ */
+
+#ifndef CATZILLA_UPLOAD_SINK_H
+#define CATZILLA_UPLOAD_SINK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct catzilla_upload_sink_s catzilla_upload_sink_t;
+
+#define CATZILLA_UPLOAD_SINK_BUFFER (64 * 1024)            // Page cache writes
+#define CATZILLA_UPLOAD_SINK_DIRECT_BUFFER (1024 * 1024)   // Each of the two direct I/O buffers
+#define CATZILLA_UPLOAD_SINK_ALIGN 4096                    // Direct I/O offsets and lengths
+#define CATZILLA_UPLOAD_SINK_PREALLOCATE_MIN (1024 * 1024) // Smaller files are not preallocated
+
+/**
+ * Start writing a file
+ * @param fd Empty file open for writing; the sink writes from offset 0 and
+ *           does not close it
+ * @param expected_size Likely upper bound of the final size, used to
+ *                      preallocate (0 when unknown)
+ * @param direct_io Bypass the page cache where the file system allows it
+ * @return Sink, or NULL when memory runs out
+ */
+catzilla_upload_sink_t* catzilla_upload_sink_create(int fd, uint64_t expected_size, bool direct_io);
+
+/**
+ * Append data; it reaches the file when a buffer fills or on finish
+ * @param sink Sink
+ * @param data Bytes
+ * @param len Length of data
+ * @return 0 on success, -1 if a write failed (errno is set)
+ */
+int catzilla_upload_sink_write(catzilla_upload_sink_t* sink, const char* data, size_t len);
+
+/**
+ * Write what is buffered, wait for the writer, and cut the file to the
+ * bytes written, releasing unused preallocated space
+ * @param sink Sink
+ * @return 0 on success, -1 if a write failed (errno is set)
+ */
+int catzilla_upload_sink_finish(catzilla_upload_sink_t* sink);
+
+/**
+ * Free a sink, waiting for a write in flight. Data not finished is lost.
+ * @param sink Sink (may be NULL)
+ */
+void catzilla_upload_sink_free(catzilla_upload_sink_t* sink);
+
+/**
+ * @param sink Sink
+ * @return true if writes bypass the page cache
+ */
+bool catzilla_upload_sink_is_direct(const catzilla_upload_sink_t* sink);
+
+/**
+ * @param sink Sink
+ * @return Bytes written so far, including buffered ones
+ */
+uint64_t catzilla_upload_sink_size(const catzilla_upload_sink_t* sink);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CATZILLA_UPLOAD_SINK_H
@@ -457,15 +457,16 @@ int catzilla_stream_buffer_write_to_file(upload_stream_buffer_t* buffer, uv_file
         return 0;
     }
 
-    ssize_t written = write(file, buffer->data, buffer->position);
-    if (written < 0) {
-        LOG_STREAM_ERROR("Buffer write to file failed: %s", strerror(errno));
-        return -1;
-    }
-
-    if ((size_t)written != buffer->position) {
-        LOG_STREAM_WARN("Partial buffer write: %zd/%zu bytes", written, buffer->position);
-        // TODO: Handle partial writes
+    // Short writes are retried until the whole buffer is on disk
+    size_t done = 0;
+    while (done < buffer->position) {
+        ssize_t written = write(file, buffer->data + done, buffer->position - done);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            LOG_STREAM_ERROR("Buffer write to file failed: %s", strerror(errno));
+            return -1;
+        }
+        done += (size_t)written;
     }
 
     return 0;
@@ -6,6 +6,7 @@
 #include <stddef.h>
 #include <uv.h>
 #include "upload_parser.h"
+#include "upload_stream_buffer.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -13,7 +14,6 @@ extern "C" {
 
 // Forward declarations
 typedef struct catzilla_stream_context_s catzilla_stream_context_t;
-typedef struct upload_stream_buffer_s upload_stream_buffer_t;
 
 // Stream operation types
 typedef enum {
@@ -23,16 +23,6 @@ typedef enum {
     STREAM_OP_VALIDATE = 3
 } stream_operation_t;
 
-// Stream buffer for zero-copy operations
-typedef struct upload_stream_buffer_s {
-    char* data;
-    size_t size;
-    size_t capacity;
-    size_t position;
-    bool is_static;         // True if buffer should not be freed
-    upload_stream_buffer_t* next;
-} upload_stream_buffer_t;
-
 // Stream write context
 typedef struct catzilla_stream_context_s {
     // File operations
@@ -83,12 +73,6 @@ int catzilla_stream_write_buffer(catzilla_stream_context_t* ctx, upload_stream_b
 int catzilla_stream_flush_buffers(catzilla_stream_context_t* ctx);
 void catzilla_stream_close_file(catzilla_stream_context_t* ctx);
 
-// Buffer management
-upload_stream_buffer_t* catzilla_stream_buffer_create(size_t size);
-void catzilla_stream_buffer_cleanup(upload_stream_buffer_t* buffer);
-int catzilla_stream_buffer_append(upload_stream_buffer_t* buffer, const char* data, size_t len);
-int catzilla_stream_buffer_write_to_file(upload_stream_buffer_t* buffer, uv_file file);
-
 // Performance optimization
 void catzilla_stream_optimize_for_size(catzilla_stream_context_t* ctx, uint64_t expected_size);
 void catzilla_stream_enable_direct_io(catzilla_stream_context_t* ctx, bool enable);
@@ -114,7 +98,6 @@ void stream_write_after_work(uv_work_t* req, int status);
 // Utility functions
 size_t catzilla_upload_optimal_buffer_size(uint64_t file_size);
 bool catzilla_stream_should_use_direct_io(uint64_t file_size);
-int catzilla_stream_create_temp_file(char* template_path, size_t template_size);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,40 @@
+#ifndef CATZILLA_UPLOAD_STREAM_BUFFER_H
+#define CATZILLA_UPLOAD_STREAM_BUFFER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <uv.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Stream buffers and temp files from upload_stream.c, split out so code that
+// also includes streaming.h can use them without the stream context types
+
+typedef struct upload_stream_buffer_s upload_stream_buffer_t;
+
+// Stream buffer for zero-copy operations
+typedef struct upload_stream_buffer_s {
+    char* data;
+    size_t size;
+    size_t capacity;
+    size_t position;
+    bool is_static;         // True if buffer should not be freed
+    upload_stream_buffer_t* next;
+} upload_stream_buffer_t;
+
+// Buffer management
+upload_stream_buffer_t* catzilla_stream_buffer_create(size_t size);
+void catzilla_stream_buffer_cleanup(upload_stream_buffer_t* buffer);
+int catzilla_stream_buffer_append(upload_stream_buffer_t* buffer, const char* data, size_t len);
+int catzilla_stream_buffer_write_to_file(upload_stream_buffer_t* buffer, uv_file file);
+
+// Utility functions
+int catzilla_stream_create_temp_file(char* template_path, size_t template_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CATZILLA_UPLOAD_STREAM_BUFFER_H
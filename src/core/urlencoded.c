@@ -0,0 +1,218 @@
+#include "urlencoded.h"
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CATZILLA_URLENCODED_SSE2 1
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(__GNUC__)
+#include <arm_neon.h>
+#define CATZILLA_URLENCODED_NEON 1
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+static inline unsigned first_set_bit(uint32_t bits) {
+    unsigned long index;
+    _BitScanForward(&index, bits);
+    return (unsigned)index;
+}
+#else
+static inline unsigned first_set_bit(uint32_t bits) {
+    return (unsigned)__builtin_ctz(bits);
+}
+#endif
+
+// Bytes the decoder stops at: '&', '=', '%' and '+'
+static const uint8_t special_byte[256] = {
+    ['%'] = 1, ['&'] = 1, ['+'] = 1, ['='] = 1,
+};
+
+// Find the next byte that needs decoding or splits a pair
+static const char* find_special(const char* p, const char* end) {
+#if defined(CATZILLA_URLENCODED_SSE2)
+    const __m128i amp = _mm_set1_epi8('&');
+    const __m128i eq = _mm_set1_epi8('=');
+    const __m128i pct = _mm_set1_epi8('%');
+    const __m128i plus = _mm_set1_epi8('+');
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)p);
+        __m128i hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, amp), _mm_cmpeq_epi8(v, eq)),
+                                    _mm_or_si128(_mm_cmpeq_epi8(v, pct), _mm_cmpeq_epi8(v, plus)));
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(hits);
+        if (mask) {
+            return p + first_set_bit(mask);
+        }
+        p += 16;
+    }
+#elif defined(CATZILLA_URLENCODED_NEON)
+    const uint8x16_t amp = vdupq_n_u8('&');
+    const uint8x16_t eq = vdupq_n_u8('=');
+    const uint8x16_t pct = vdupq_n_u8('%');
+    const uint8x16_t plus = vdupq_n_u8('+');
+    while (end - p >= 16) {
+        uint8x16_t v = vld1q_u8((const uint8_t*)p);
+        uint8x16_t hits = vorrq_u8(vorrq_u8(vceqq_u8(v, amp), vceqq_u8(v, eq)),
+                                   vorrq_u8(vceqq_u8(v, pct), vceqq_u8(v, plus)));
+        // Narrow each byte to a nibble: 64 bits, 4 per input byte
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(hits), 4)), 0);
+        if (mask) {
+            return p + (__builtin_ctzll(mask) >> 2);
+        }
+        p += 16;
+    }
+#endif
+    while (p < end && !special_byte[(uint8_t)*p]) {
+        p++;
+    }
+    return p;
+}
+
+static inline int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    c |= 0x20;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+// Decode the escape at src (just after a '%'); returns the byte or -1
+static inline int decode_escape(const char* src, const char* end) {
+    if (end - src < 2) return -1;
+    int high = hex_value(src[0]);
+    int low = hex_value(src[1]);
+    if (high < 0 || low < 0) return -1;
+    return (high << 4) | low;
+}
+
+size_t catzilla_url_decode(const char* src, size_t length, char* dst) {
+    const char* end = src + length;
+    char* out = dst;
+
+    while (src < end) {
+        const char* stop = find_special(src, end);
+        size_t run = (size_t)(stop - src);
+        if (out != src) memmove(out, src, run);
+        out += run;
+        src = stop;
+        if (src == end) break;
+
+        char c = *src++;
+        if (c == '+') {
+            *out++ = ' ';
+        } else if (c == '%') {
+            int byte = decode_escape(src, end);
+            if (byte >= 0) {
+                *out++ = (char)byte;
+                src += 2;
+            } else {
+                *out++ = '%';
+            }
+        } else {
+            *out++ = c;
+        }
+    }
+    *out = '\0';
+    return (size_t)(out - dst);
+}
+
+static int table_append(catzilla_request_arena_t* arena, catzilla_param_table_t* table,
+                        char* name, char* value) {
+    if (table->count == table->capacity) {
+        if (table->capacity > INT_MAX / 2) return -1;
+        int capacity = table->capacity ? table->capacity * 2 : CATZILLA_PARAM_TABLE_INITIAL_CAPACITY;
+
+        // Both arrays in one allocation; the old ones stay in the arena
+        char** names = catzilla_arena_alloc(arena, sizeof(char*) * (size_t)capacity * 2);
+        if (!names) return -1;
+        char** values = names + capacity;
+        if (table->count > 0) {
+            memcpy(names, table->names, sizeof(char*) * (size_t)table->count);
+            memcpy(values, table->values, sizeof(char*) * (size_t)table->count);
+        }
+        table->names = names;
+        table->values = values;
+        table->capacity = capacity;
+    }
+
+    table->names[table->count] = name;
+    table->values[table->count] = value;
+    table->count++;
+    return 0;
+}
+
+static int finish_pair(catzilla_request_arena_t* arena, catzilla_param_table_t* table,
+                       char* name, char* value, bool skip_empty_names) {
+    if (!value) return 0;
+    if (skip_empty_names && name[0] == '\0') return 0;
+    return table_append(arena, table, name, value);
+}
+
+int catzilla_urlencoded_parse(catzilla_request_arena_t* arena, const char* data, size_t length,
+                              bool skip_empty_names, catzilla_param_table_t* table) {
+    if (!arena || !table || (!data && length > 0)) return -1;
+    if (length == 0) return 0;
+
+    char* buffer = catzilla_arena_strndup(arena, data, length);
+    if (!buffer) return -1;
+
+    // Decoding never grows the data, so it is written back over what was read
+    const char* read = buffer;
+    const char* end = buffer + length;
+    char* write = buffer;
+    char* name = buffer;
+    char* value = NULL;
+
+    for (;;) {
+        const char* stop = find_special(read, end);
+        size_t run = (size_t)(stop - read);
+        if (write != read) memmove(write, read, run);
+        write += run;
+        read = stop;
+        if (read == end) break;
+
+        char c = *read++;
+        switch (c) {
+            case '+':
+                *write++ = ' ';
+                break;
+            case '%': {
+                int byte = decode_escape(read, end);
+                if (byte >= 0) {
+                    *write++ = (char)byte;
+                    read += 2;
+                } else {
+                    *write++ = '%';
+                }
+                break;
+            }
+            case '=':
+                if (value) {
+                    *write++ = '=';   // Only the first '=' splits
+                } else {
+                    *write++ = '\0';
+                    value = write;
+                }
+                break;
+            default:  // '&'
+                *write++ = '\0';
+                if (finish_pair(arena, table, name, value, skip_empty_names) != 0) return -1;
+                name = write;
+                value = NULL;
+                break;
+        }
+    }
+
+    *write = '\0';
+    return finish_pair(arena, table, name, value, skip_empty_names);
+}
+
+const char* catzilla_param_table_get(const catzilla_param_table_t* table, const char* name) {
+    if (!table || !name) return NULL;
+    for (int i = 0; i < table->count; i++) {
+        if (strcmp(table->names[i], name) == 0) {
+            return table->values[i];
+        }
+    }
+    return NULL;
+}
@@ -0,0 +1,64 @@
+#ifndef CATZILLA_URLENCODED_H
+#define CATZILLA_URLENCODED_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "request_arena.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// First table allocation; the table doubles from there
+#define CATZILLA_PARAM_TABLE_INITIAL_CAPACITY 8
+
+/**
+ * Decoded name/value pairs of a query string or urlencoded form. The
+ * arrays and strings live in a request arena; a zeroed table is empty.
+ * Pairs keep their order, and repeated names appear once per occurrence.
+ */
+typedef struct {
+    char** names;
+    char** values;
+    int count;
+    int capacity;
+} catzilla_param_table_t;
+
+/**
+ * Parse application/x-www-form-urlencoded data (also used for query
+ * strings) into a table. The input is copied into the arena once and
+ * decoded in place: '+' becomes a space and valid %XX escapes their byte.
+ * Pairs without '=' are skipped. Separators and escapes are found 16 bytes
+ * at a time with SSE2 or NEON, so plain runs are moved as a block.
+ * @param arena Request arena that owns the result
+ * @param data Encoded data (need not be NUL-terminated)
+ * @param length Length of data in bytes
+ * @param skip_empty_names Also skip pairs whose name is empty
+ * @param table Table to append to
+ * @return 0 on success, -1 on allocation failure (pairs parsed so far are kept)
+ */
+int catzilla_urlencoded_parse(catzilla_request_arena_t* arena, const char* data, size_t length,
+                              bool skip_empty_names, catzilla_param_table_t* table);
+
+/**
+ * Look up the first value for a name
+ * @param table Parsed table
+ * @param name Name to look for
+ * @return Decoded value, or NULL if the name is not present
+ */
+const char* catzilla_param_table_get(const catzilla_param_table_t* table, const char* name);
+
+/**
+ * Decode one %XX / '+' encoded segment
+ * @param src Encoded bytes
+ * @param length Length of src in bytes
+ * @param dst Output with room for length + 1 bytes (may equal src)
+ * @return Decoded length; dst is NUL-terminated
+ */
+size_t catzilla_url_decode(const char* src, size_t length, char* dst);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CATZILLA_URLENCODED_H
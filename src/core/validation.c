@@ -7,6 +7,7 @@
 #include <stdio.h>
 #include <time.h>
 #include <assert.h>
+#include <limits.h>
 
 // Project headers
 #include "validation.h"
@@ -17,11 +18,24 @@
     #include "windows_compat.h"
 #else
     #include <regex.h>
+    #include <pthread.h>
+    #include "task_system.h"
 #endif
 
 // Global validation statistics
 static validation_stats_t g_validation_stats = {0};
 
+// Batches validate on several threads at once, so updates must be atomic
+static void record_validation(long ns) {
+#ifdef _WIN32
+    g_validation_stats.validations_performed++;
+    g_validation_stats.total_time_ns += ns;
+#else
+    __atomic_fetch_add(&g_validation_stats.validations_performed, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&g_validation_stats.total_time_ns, (unsigned long)ns, __ATOMIC_RELAXED);
+#endif
+}
+
 // ============================================================================
 // VALIDATOR CREATION FUNCTIONS
 // ============================================================================
@@ -62,6 +76,25 @@ validator_t* catzilla_create_float_validator(double min, double max, int has_min
     return validator;
 }
 
+// Compile a string validator's pattern to a DFA, or to a POSIX regex when it
+// uses something the DFA subset does not cover
+static int compile_string_pattern(validator_t* validator) {
+    validator->string_validator.compiled_pattern =
+        catzilla_pattern_compile(validator->string_validator.pattern);
+    if (validator->string_validator.compiled_pattern) return 0;
+
+    validator->string_validator.compiled_regex = catzilla_cache_alloc(sizeof(regex_t));
+    if (!validator->string_validator.compiled_regex) return -1;
+
+    if (regcomp(validator->string_validator.compiled_regex,
+                validator->string_validator.pattern, REG_EXTENDED) != 0) {
+        catzilla_cache_free(validator->string_validator.compiled_regex);
+        validator->string_validator.compiled_regex = NULL;
+        return -1;
+    }
+    return 0;
+}
+
 validator_t* catzilla_create_string_validator(int min_len, int max_len, const char* pattern) {
     validator_t* validator = catzilla_create_validator(TYPE_STRING);
     if (!validator) return NULL;
@@ -78,16 +111,10 @@ validator_t* catzilla_create_string_validator(int min_len, int max_len, const ch
             strcpy(validator->string_validator.pattern, pattern);
             validator->string_validator.has_pattern = 1;
 
-            // Compile regex for performance
-            validator->string_validator.compiled_regex = catzilla_cache_alloc(sizeof(regex_t));
-            if (validator->string_validator.compiled_regex) {
-                int result = regcomp(validator->string_validator.compiled_regex, pattern, REG_EXTENDED);
-                if (result != 0) {
-                    // Failed to compile regex, disable pattern matching
-                    catzilla_cache_free(validator->string_validator.compiled_regex);
-                    validator->string_validator.compiled_regex = NULL;
-                    validator->string_validator.has_pattern = 0;
-                }
+            // Compile pattern for performance
+            if (compile_string_pattern(validator) != 0) {
+                // Failed to compile pattern, disable pattern matching
+                validator->string_validator.has_pattern = 0;
             }
         }
     }
@@ -95,6 +122,12 @@ validator_t* catzilla_create_string_validator(int min_len, int max_len, const ch
     return validator;
 }
 
+int catzilla_set_string_format(validator_t* validator, catzilla_string_format_t format) {
+    if (!validator || validator->type != TYPE_STRING) return -1;
+    validator->string_validator.format = format;
+    return 0;
+}
+
 validator_t* catzilla_create_list_validator(validator_t* item_validator, int min_items, int max_items) {
     validator_t* validator = catzilla_create_validator(TYPE_LIST);
     if (!validator) return NULL;
@@ -125,6 +158,7 @@ void catzilla_free_validator(validator_t* validator) {
             if (validator->string_validator.pattern) {
                 catzilla_cache_free(validator->string_validator.pattern);
             }
+            catzilla_pattern_free(validator->string_validator.compiled_pattern);
             if (validator->string_validator.compiled_regex) {
                 regfree(validator->string_validator.compiled_regex);
                 catzilla_cache_free(validator->string_validator.compiled_regex);
@@ -284,24 +318,12 @@ int catzilla_compile_model_spec(model_spec_t* model) {
             // printf("[DEBUG] catzilla_compile_model_spec: Processing string validator for field %d\n", i);
             // fflush(stdout);
 
-            // Pre-compile string regex patterns for maximum performance
+            // Pre-compile string patterns for maximum performance
             if (field->validator->string_validator.has_pattern &&
+                !field->validator->string_validator.compiled_pattern &&
                 !field->validator->string_validator.compiled_regex) {
-                // printf("[DEBUG] catzilla_compile_model_spec: Compiling regex for field %d\n", i);
-                // fflush(stdout);
-
-                // Compile regex if not already done
-                field->validator->string_validator.compiled_regex = catzilla_cache_alloc(sizeof(regex_t));
-                if (field->validator->string_validator.compiled_regex) {
-                    int regex_result = regcomp(field->validator->string_validator.compiled_regex,
-                           field->validator->string_validator.pattern, REG_EXTENDED);
-                    if (regex_result != 0) {
-                        // printf("[DEBUG] catzilla_compile_model_spec: Regex compilation failed for field %d\n", i);
-                        // fflush(stdout);
-                        return -1;
-                    }
-                    // printf("[DEBUG] catzilla_compile_model_spec: Regex compilation successful for field %d\n", i);
-                    // fflush(stdout);
+                if (compile_string_pattern(field->validator) != 0) {
+                    return -1;
                 }
             }
         }
@@ -379,6 +401,38 @@ void catzilla_free_validation_context(validation_context_t* ctx) {
 // CORE VALIDATION FUNCTIONS
 // ============================================================================
 
+// Length, pattern and format rules of a string validator
+static validation_result_t validate_string_rules(validator_t* validator, const char* str, size_t len) {
+    if (validator->string_validator.has_min_len || validator->string_validator.has_max_len) {
+        // Compare characters, not bytes, like len() on the Python side
+        size_t chars = catzilla_utf8_length(str, len);
+        if ((validator->string_validator.has_min_len &&
+             chars < (size_t)validator->string_validator.min_len) ||
+            (validator->string_validator.has_max_len &&
+             chars > (size_t)validator->string_validator.max_len)) {
+            return VALIDATION_ERROR_LENGTH;
+        }
+    }
+
+    if (validator->string_validator.has_pattern) {
+        if (validator->string_validator.compiled_pattern) {
+            if (!catzilla_pattern_match(validator->string_validator.compiled_pattern, str, len)) {
+                return VALIDATION_ERROR_PATTERN;
+            }
+        } else if (validator->string_validator.compiled_regex &&
+                   regexec(validator->string_validator.compiled_regex, str, 0, NULL, 0) != 0) {
+            return VALIDATION_ERROR_PATTERN;
+        }
+    }
+
+    if (validator->string_validator.format != CATZILLA_STRING_FORMAT_NONE &&
+        !catzilla_string_format_match(validator->string_validator.format, str, len)) {
+        return VALIDATION_ERROR_PATTERN;
+    }
+
+    return VALIDATION_SUCCESS;
+}
+
 validation_result_t catzilla_validate_value(validator_t* validator, json_object_t* value,
                                            validation_context_t* ctx) {
     if (!validator || !value) return VALIDATION_ERROR_TYPE;
@@ -445,26 +499,7 @@ validation_result_t catzilla_validate_value(validator_t* validator, json_object_
                 break;
             }
 
-            int len = strlen(value->string_val);
-
-            if (validator->string_validator.has_min_len && len < validator->string_validator.min_len) {
-                result = VALIDATION_ERROR_LENGTH;
-                break;
-            }
-
-            if (validator->string_validator.has_max_len && len > validator->string_validator.max_len) {
-                result = VALIDATION_ERROR_LENGTH;
-                break;
-            }
-
-            if (validator->string_validator.has_pattern && validator->string_validator.compiled_regex) {
-                int match_result = regexec(validator->string_validator.compiled_regex,
-                                         value->string_val, 0, NULL, 0);
-                if (match_result != 0) {
-                    result = VALIDATION_ERROR_PATTERN;
-                    break;
-                }
-            }
+            result = validate_string_rules(validator, value->string_val, strlen(value->string_val));
             break;
 
         case TYPE_BOOL:
@@ -519,6 +554,7 @@ validation_result_t catzilla_validate_value(validator_t* validator, json_object_
             result = VALIDATION_ERROR_CUSTOM;
             if (custom_error && ctx) {
                 // Add custom error to context
+                custom_error->item_index = -1;
                 custom_error->next = ctx->errors;
                 ctx->errors = custom_error;
                 ctx->error_count++;
@@ -532,8 +568,7 @@ validation_complete:
     long ns = (end_time.tv_sec - start_time.tv_sec) * 1000000000L +
               (end_time.tv_nsec - start_time.tv_nsec);
 
-    g_validation_stats.validations_performed++;
-    g_validation_stats.total_time_ns += ns;
+    record_validation(ns);
 
     return result;
 }
@@ -693,6 +728,276 @@ validation_result_t catzilla_validate_model(model_spec_t* model, json_object_t*
     return VALIDATION_SUCCESS;
 }
 
+// ============================================================================
+// YYJSON VALIDATION FUNCTIONS
+// ============================================================================
+
+// Build the json_object_t a custom validator expects from a yyjson value
+static json_object_t* validation_json_from_yyjson(yyjson_val* value) {
+    switch (yyjson_get_type(value)) {
+        case YYJSON_TYPE_BOOL:
+            return catzilla_create_json_bool(yyjson_get_bool(value));
+        case YYJSON_TYPE_NUM:
+            if (yyjson_is_int(value)) return catzilla_create_json_int((long)yyjson_get_sint(value));
+            return catzilla_create_json_number(yyjson_get_real(value));
+        case YYJSON_TYPE_STR:
+            return catzilla_create_json_string(yyjson_get_str(value));
+        case YYJSON_TYPE_ARR: {
+            json_object_t* obj = catzilla_request_alloc(sizeof(json_object_t));
+            if (!obj) return NULL;
+            memset(obj, 0, sizeof(json_object_t));
+            obj->type = JSON_ARRAY;
+
+            size_t count = yyjson_arr_size(value);
+            if (count == 0) return obj;
+            obj->array_val.items = catzilla_request_alloc(sizeof(json_object_t*) * count);
+            if (!obj->array_val.items) {
+                catzilla_free_json_object(obj);
+                return NULL;
+            }
+
+            size_t idx, max;
+            yyjson_val* item;
+            yyjson_arr_foreach(value, idx, max, item) {
+                obj->array_val.items[idx] = validation_json_from_yyjson(item);
+                if (!obj->array_val.items[idx]) {
+                    catzilla_free_json_object(obj);
+                    return NULL;
+                }
+                obj->array_val.count++;
+            }
+            return obj;
+        }
+        case YYJSON_TYPE_OBJ: {
+            json_object_t* obj = catzilla_create_json_object();
+            if (!obj) return NULL;
+
+            size_t count = yyjson_obj_size(value);
+            if (count == 0) return obj;
+            obj->object_val.keys = catzilla_request_alloc(sizeof(char*) * count);
+            obj->object_val.values = catzilla_request_alloc(sizeof(json_object_t*) * count);
+            if (!obj->object_val.keys || !obj->object_val.values) {
+                catzilla_free_json_object(obj);
+                return NULL;
+            }
+
+            size_t idx, max;
+            yyjson_val *key, *item;
+            yyjson_obj_foreach(value, idx, max, key, item) {
+                size_t key_len = yyjson_get_len(key);
+                char* key_copy = catzilla_request_alloc(key_len + 1);
+                json_object_t* item_copy = validation_json_from_yyjson(item);
+                if (!key_copy || !item_copy) {
+                    if (key_copy) catzilla_request_free(key_copy);
+                    catzilla_free_json_object(item_copy);
+                    catzilla_free_json_object(obj);
+                    return NULL;
+                }
+                memcpy(key_copy, yyjson_get_str(key), key_len + 1);
+                obj->object_val.keys[idx] = key_copy;
+                obj->object_val.values[idx] = item_copy;
+                obj->object_val.count++;
+            }
+            return obj;
+        }
+        default:
+            return catzilla_create_json_null();
+    }
+}
+
+static validation_result_t validate_yyjson(validator_t* validator, yyjson_val* value,
+                                          validation_context_t* ctx) {
+    if (!validator || !value) return VALIDATION_ERROR_TYPE;
+
+    if (validator->type == TYPE_OPTIONAL) {
+        // NULL is valid for optional fields
+        if (yyjson_is_null(value)) return VALIDATION_SUCCESS;
+        return validate_yyjson(validator->optional_validator.inner_validator, value, ctx);
+    }
+
+    validation_result_t result = VALIDATION_SUCCESS;
+
+    switch (validator->type) {
+        case TYPE_INT: {
+            if (!yyjson_is_int(value)) {
+                result = VALIDATION_ERROR_TYPE;
+                break;
+            }
+
+            // Integers beyond long cannot meet any bound the validator can hold
+            if (yyjson_is_uint(value) && yyjson_get_uint(value) > (uint64_t)LONG_MAX) {
+                result = VALIDATION_ERROR_RANGE;
+                break;
+            }
+            long val = (long)yyjson_get_sint(value);
+
+            if ((validator->int_validator.has_min && val < validator->int_validator.min) ||
+                (validator->int_validator.has_max && val > validator->int_validator.max)) {
+                result = VALIDATION_ERROR_RANGE;
+            }
+            break;
+        }
+
+        case TYPE_FLOAT: {
+            if (!yyjson_is_num(value)) {
+                result = VALIDATION_ERROR_TYPE;
+                break;
+            }
+
+            double val = yyjson_get_num(value);
+
+            if ((validator->float_validator.has_min && val < validator->float_validator.min) ||
+                (validator->float_validator.has_max && val > validator->float_validator.max)) {
+                result = VALIDATION_ERROR_RANGE;
+            }
+            break;
+        }
+
+        case TYPE_STRING: {
+            if (!yyjson_is_str(value)) {
+                result = VALIDATION_ERROR_TYPE;
+                break;
+            }
+
+            // yyjson strings are NUL-terminated, so a regexec fallback can read them in place
+            result = validate_string_rules(validator, yyjson_get_str(value), yyjson_get_len(value));
+            break;
+        }
+
+        case TYPE_BOOL:
+            if (!yyjson_is_bool(value)) {
+                result = VALIDATION_ERROR_TYPE;
+            }
+            break;
+
+        case TYPE_LIST: {
+            if (!yyjson_is_arr(value)) {
+                result = VALIDATION_ERROR_TYPE;
+                break;
+            }
+
+            size_t count = yyjson_arr_size(value);
+
+            if ((validator->list_validator.has_min_items &&
+                 count < (size_t)validator->list_validator.min_items) ||
+                (validator->list_validator.has_max_items &&
+                 count > (size_t)validator->list_validator.max_items)) {
+                result = VALIDATION_ERROR_LENGTH;
+                break;
+            }
+
+            if (validator->list_validator.item_validator) {
+                size_t idx, max;
+                yyjson_val* item;
+                yyjson_arr_foreach(value, idx, max, item) {
+                    result = validate_yyjson(validator->list_validator.item_validator, item, ctx);
+                    if (result != VALIDATION_SUCCESS) break;
+                }
+            }
+            break;
+        }
+
+        default:
+            result = VALIDATION_ERROR_TYPE;
+            break;
+    }
+
+    // Custom validators take a json_object_t, so only they pay for a conversion
+    if (result == VALIDATION_SUCCESS && validator->custom_validator) {
+        json_object_t* converted = validation_json_from_yyjson(value);
+        if (!converted) return VALIDATION_ERROR_MEMORY;
+
+        validation_error_t* custom_error = NULL;
+        if (validator->custom_validator(converted, &custom_error) != 0) {
+            result = VALIDATION_ERROR_CUSTOM;
+            if (custom_error && ctx) {
+                custom_error->item_index = -1;
+                custom_error->next = ctx->errors;
+                ctx->errors = custom_error;
+                ctx->error_count++;
+            }
+        }
+        catzilla_free_json_object(converted);
+    }
+
+    return result;
+}
+
+validation_result_t catzilla_validate_value_yyjson(validator_t* validator, yyjson_val* value,
+                                                  validation_context_t* ctx) {
+    struct timespec start_time, end_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+    validation_result_t result = validate_yyjson(validator, value, ctx);
+
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    long ns = (end_time.tv_sec - start_time.tv_sec) * 1000000000L +
+              (end_time.tv_nsec - start_time.tv_nsec);
+
+    record_validation(ns);
+
+    return result;
+}
+
+validation_result_t catzilla_validate_model_yyjson(model_spec_t* model, yyjson_val* data,
+                                                  validation_context_t* ctx,
+                                                  catzilla_validation_emit_t emit, void* user_data) {
+    if (!model || !data || !ctx) return VALIDATION_ERROR_TYPE;
+
+    if (!yyjson_is_obj(data)) {
+        catzilla_add_validation_error(ctx, "", "Expected object for model validation", VALIDATION_ERROR_TYPE);
+        return VALIDATION_ERROR_TYPE;
+    }
+
+    // Bodies usually list fields in declaration order; the iterator resumes
+    // each lookup where the previous one matched, making those O(1)
+    yyjson_obj_iter iter;
+    yyjson_obj_iter_init(data, &iter);
+
+    validation_result_t overall_result = VALIDATION_SUCCESS;
+
+    for (int i = 0; i < model->fields_added; i++) {
+        field_spec_t* field = &model->fields[i];
+        if (!field->field_name) continue;
+
+        yyjson_val* field_value = yyjson_obj_iter_getn(&iter, field->field_name, strlen(field->field_name));
+
+        if (!field_value) {
+            if (field->required) {
+                char error_msg[256];
+                snprintf(error_msg, sizeof(error_msg), "Field '%s' is required", field->field_name);
+                catzilla_add_validation_error(ctx, field->field_name, error_msg, VALIDATION_ERROR_REQUIRED);
+                overall_result = VALIDATION_ERROR_REQUIRED;
+            } else if (overall_result == VALIDATION_SUCCESS && emit &&
+                       emit(user_data, field, NULL) != 0) {
+                return VALIDATION_ERROR_MEMORY;
+            }
+            continue;
+        }
+
+        // Optional field with explicit null value is valid
+        validation_result_t field_result = VALIDATION_SUCCESS;
+        if (field->required || !yyjson_is_null(field_value)) {
+            field_result = catzilla_validate_value_yyjson(field->validator, field_value, ctx);
+        }
+
+        if (field_result != VALIDATION_SUCCESS) {
+            char error_msg[256];
+            snprintf(error_msg, sizeof(error_msg), "Validation failed for field '%s'", field->field_name);
+            catzilla_add_validation_error(ctx, field->field_name, error_msg, field_result);
+            overall_result = field_result;
+            continue;
+        }
+
+        if (overall_result == VALIDATION_SUCCESS && emit &&
+            emit(user_data, field, field_value) != 0) {
+            return VALIDATION_ERROR_MEMORY;
+        }
+    }
+
+    return overall_result;
+}
+
 // ============================================================================
 // ERROR HANDLING FUNCTIONS
 // ============================================================================
@@ -715,6 +1020,7 @@ void catzilla_add_validation_error(validation_context_t* ctx, const char* field_
     }
 
     error->error_code = error_code;
+    error->item_index = -1;
     error->next = ctx->errors;
 
     ctx->errors = error;
@@ -783,6 +1089,298 @@ void catzilla_clear_validation_errors(validation_context_t* ctx) {
     ctx->error_count = 0;
 }
 
+// ============================================================================
+// BATCH VALIDATION
+// ============================================================================
+
+// Chunks per participating thread, so uneven items still balance out
+#define BATCH_CHUNKS_PER_THREAD 4
+
+#ifdef _WIN32
+// Batches never leave the calling thread here
+#define BATCH_LOAD(ptr) (*(ptr))
+#define BATCH_FETCH_ADD(ptr, val) ((*(ptr) += (val)) - (val))
+#else
+#define BATCH_LOAD(ptr) __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define BATCH_FETCH_ADD(ptr, val) __atomic_fetch_add(ptr, val, __ATOMIC_ACQ_REL)
+#endif
+
+// Errors of one chunk's items, in item order; a chunk is validated by one
+// thread, so this is that thread's context for it
+typedef struct {
+    validation_error_t* errors;
+    validation_error_t* tail;
+    int error_count;
+    int first_invalid;                   // -1 when every item was valid
+    validation_result_t first_result;
+} batch_chunk_t;
+
+typedef struct {
+    model_spec_t* model;
+    json_object_t** data;
+    json_object_t** results;
+    int count;
+    int chunk_size;
+    int chunk_count;
+    batch_chunk_t* chunks;
+    bool stop_on_first_error;
+
+    int next_chunk;                      // Next chunk to claim
+    int chunks_done;
+    int first_invalid;                   // Lowest invalid item seen, count when none
+    int refs;                            // Calling thread plus queued tasks
+#ifndef _WIN32
+    pthread_mutex_t lock;
+    pthread_cond_t done;
+#endif
+} batch_job_t;
+
+static void batch_note_invalid(batch_job_t* job, int index) {
+#ifdef _WIN32
+    if (index < job->first_invalid) job->first_invalid = index;
+#else
+    int seen = __atomic_load_n(&job->first_invalid, __ATOMIC_ACQUIRE);
+    while (index < seen &&
+           !__atomic_compare_exchange_n(&job->first_invalid, &seen, index, true,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+    }
+#endif
+}
+
+static void batch_run_chunk(batch_job_t* job, int chunk_index) {
+    batch_chunk_t* chunk = &job->chunks[chunk_index];
+    int start = chunk_index * job->chunk_size;
+    int end = job->count - start > job->chunk_size ? start + job->chunk_size : job->count;
+
+    for (int i = start; i < end; i++) {
+        // Every item before the first invalid one is checked, later ones need not be
+        if (job->stop_on_first_error && i > BATCH_LOAD(&job->first_invalid)) break;
+
+        validation_context_t item_ctx = {0};
+        validation_result_t result;
+        if (job->data[i]) {
+            result = catzilla_validate_model(job->model, job->data[i], &job->results[i], &item_ctx);
+        } else {
+            catzilla_add_validation_error(&item_ctx, "", "Expected object for model validation",
+                                          VALIDATION_ERROR_TYPE);
+            result = VALIDATION_ERROR_TYPE;
+        }
+        if (result == VALIDATION_SUCCESS) continue;
+
+        if (chunk->first_invalid < 0) {
+            chunk->first_invalid = i;
+            chunk->first_result = result;
+        }
+        if (job->stop_on_first_error) batch_note_invalid(job, i);
+
+        if (!item_ctx.errors) continue;
+        validation_error_t* last = item_ctx.errors;
+        for (validation_error_t* error = item_ctx.errors; error; error = error->next) {
+            error->item_index = i;
+            last = error;
+        }
+        if (chunk->tail) {
+            chunk->tail->next = item_ctx.errors;
+        } else {
+            chunk->errors = item_ctx.errors;
+        }
+        chunk->tail = last;
+        chunk->error_count += item_ctx.error_count;
+    }
+}
+
+// Claim and validate chunks until none are left
+static void batch_work(batch_job_t* job) {
+    for (;;) {
+        int chunk = BATCH_FETCH_ADD(&job->next_chunk, 1);
+        if (chunk >= job->chunk_count) return;
+
+        batch_run_chunk(job, chunk);
+        if (BATCH_FETCH_ADD(&job->chunks_done, 1) + 1 == job->chunk_count) {
+#ifndef _WIN32
+            pthread_mutex_lock(&job->lock);
+            pthread_cond_broadcast(&job->done);
+            pthread_mutex_unlock(&job->lock);
+#endif
+        }
+    }
+}
+
+static void batch_job_release(batch_job_t* job) {
+    if (BATCH_FETCH_ADD(&job->refs, -1) != 1) return;
+
+#ifndef _WIN32
+    pthread_mutex_destroy(&job->lock);
+    pthread_cond_destroy(&job->done);
+#endif
+    catzilla_free(job->chunks);
+    catzilla_free(job);
+}
+
+#ifndef _WIN32
+// Worker task; tasks that start after the last chunk was claimed just return
+static void batch_validate_task(void* data, void* result) {
+    (void)result;
+    batch_job_t* job = *(batch_job_t**)data;
+    batch_work(job);
+    batch_job_release(job);
+}
+#endif
+
+// Worker tasks to queue for a batch of count items
+static int batch_task_count(const validation_batch_options_t* options, int count) {
+#ifdef _WIN32
+    (void)options;
+    (void)count;
+    return 0;
+#else
+    if (!options || !options->engine || !options->engine->pool) return 0;
+    if (count < 2 * CATZILLA_BATCH_MIN_CHUNK) return 0;
+
+    int tasks = atomic_load(&options->engine->pool->worker_count);
+    if (options->max_workers > 0 && options->max_workers < tasks) tasks = options->max_workers;
+    // The calling thread takes a share too
+    int most = count / CATZILLA_BATCH_MIN_CHUNK - 1;
+    return tasks < most ? tasks : most;
+#endif
+}
+
+validation_result_t catzilla_batch_validate_with_options(model_spec_t* model, json_object_t** data_array,
+                                                        int count, json_object_t*** validated_array,
+                                                        validation_context_t* ctx,
+                                                        const validation_batch_options_t* options) {
+    if (!model || !validated_array || !ctx || count < 0 || (count > 0 && !data_array)) {
+        return VALIDATION_ERROR_TYPE;
+    }
+    *validated_array = NULL;
+
+    int tasks = batch_task_count(options, count);
+    int chunk_size = count > 0 ? count : 1;
+    if (tasks > 0) {
+        chunk_size = count / ((tasks + 1) * BATCH_CHUNKS_PER_THREAD);
+        if (chunk_size < CATZILLA_BATCH_MIN_CHUNK) chunk_size = CATZILLA_BATCH_MIN_CHUNK;
+    }
+    int chunk_count = (count + chunk_size - 1) / chunk_size;
+
+    json_object_t** results = catzilla_request_alloc(sizeof(json_object_t*) * (size_t)(count > 0 ? count : 1));
+    batch_job_t* job = catzilla_calloc(1, sizeof(batch_job_t));
+    batch_chunk_t* chunks = catzilla_calloc((size_t)(chunk_count > 0 ? chunk_count : 1), sizeof(batch_chunk_t));
+    if (!results || !job || !chunks) {
+        if (results) catzilla_request_free(results);
+        catzilla_free(job);
+        catzilla_free(chunks);
+        return VALIDATION_ERROR_MEMORY;
+    }
+    memset(results, 0, sizeof(json_object_t*) * (size_t)(count > 0 ? count : 1));
+    for (int c = 0; c < chunk_count; c++) chunks[c].first_invalid = -1;
+
+    job->model = model;
+    job->data = data_array;
+    job->results = results;
+    job->count = count;
+    job->chunk_size = chunk_size;
+    job->chunk_count = chunk_count;
+    job->chunks = chunks;
+    job->stop_on_first_error = options && options->stop_on_first_error;
+    job->first_invalid = count;
+    job->refs = 1;
+
+#ifndef _WIN32
+    pthread_mutex_init(&job->lock, NULL);
+    pthread_cond_init(&job->done, NULL);
+
+    for (int t = 0; t < tasks; t++) {
+        BATCH_FETCH_ADD(&job->refs, 1);
+        if (catzilla_task_add_c(options->engine, batch_validate_task, &job, sizeof(job),
+                                TASK_PRIORITY_HIGH, 0, 0) == 0) {
+            // Queue full, this thread validates what the tasks would have
+            BATCH_FETCH_ADD(&job->refs, -1);
+            break;
+        }
+    }
+#endif
+
+    batch_work(job);
+
+#ifndef _WIN32
+    // Only chunks that workers are validating right now can be outstanding
+    pthread_mutex_lock(&job->lock);
+    while (BATCH_LOAD(&job->chunks_done) < chunk_count) {
+        pthread_cond_wait(&job->done, &job->lock);
+    }
+    pthread_mutex_unlock(&job->lock);
+#endif
+
+    // Merge the chunks' errors in item order
+    validation_result_t overall_result = VALIDATION_SUCCESS;
+    int first_invalid = -1;
+    validation_error_t* head = NULL;
+    validation_error_t* tail = NULL;
+    int error_count = 0;
+
+    for (int c = 0; c < chunk_count; c++) {
+        if (chunks[c].first_invalid >= 0 && first_invalid < 0) {
+            first_invalid = chunks[c].first_invalid;
+            overall_result = chunks[c].first_result;
+        }
+
+        validation_error_t* error = chunks[c].errors;
+        while (error) {
+            validation_error_t* next = error->next;
+            if (job->stop_on_first_error && error->item_index > first_invalid) {
+                if (error->field_name) catzilla_request_free(error->field_name);
+                if (error->message) catzilla_request_free(error->message);
+                catzilla_request_free(error);
+            } else {
+                error->next = NULL;
+                if (tail) {
+                    tail->next = error;
+                } else {
+                    head = error;
+                }
+                tail = error;
+                error_count++;
+            }
+            error = next;
+        }
+    }
+
+    // Whether items after the first invalid one got validated depends on timing
+    if (job->stop_on_first_error && first_invalid >= 0) {
+        for (int i = first_invalid + 1; i < count; i++) {
+            if (results[i]) {
+                catzilla_free_json_object(results[i]);
+                results[i] = NULL;
+            }
+        }
+    }
+
+    if (tail) {
+        tail->next = ctx->errors;
+        ctx->errors = head;
+        ctx->error_count += error_count;
+    }
+
+    batch_job_release(job);
+    *validated_array = results;
+    return overall_result;
+}
+
+validation_result_t catzilla_batch_validate(model_spec_t* model, json_object_t** data_array,
+                                           int count, json_object_t*** validated_array,
+                                           validation_context_t* ctx) {
+    return catzilla_batch_validate_with_options(model, data_array, count, validated_array, ctx, NULL);
+}
+
+void catzilla_free_batch_results(json_object_t** validated_array, int count) {
+    if (!validated_array) return;
+
+    for (int i = 0; i < count; i++) {
+        if (validated_array[i]) catzilla_free_json_object(validated_array[i]);
+    }
+    catzilla_request_free(validated_array);
+}
+
 // ============================================================================
 // PERFORMANCE AND STATISTICS
 // ============================================================================
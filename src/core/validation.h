@@ -4,7 +4,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <yyjson.h>
 #include "memory.h"
+#include "pattern.h"
 
 // Platform-specific regex support
 #ifdef _WIN32
@@ -56,6 +58,7 @@ struct validation_error {
     char* field_name;
     char* message;
     validation_result_t error_code;
+    int item_index;  // Item of a batch, -1 outside catzilla_batch_validate
     struct validation_error* next;
 };
 
@@ -84,10 +87,12 @@ struct validator {
             int min_len;
             int max_len;
             char* pattern;
-            regex_t* compiled_regex;
+            catzilla_pattern_t* compiled_pattern;  // DFA, when the pattern fits the subset
+            regex_t* compiled_regex;               // POSIX fallback for the rest
             int has_min_len;
             int has_max_len;
             int has_pattern;
+            catzilla_string_format_t format;
         } string_validator;
 
         struct {
@@ -204,10 +209,20 @@ validator_t* catzilla_create_int_validator(long min, long max, int has_min, int
 validator_t* catzilla_create_float_validator(double min, double max, int has_min, int has_max);
 
 /**
- * Create string validator with length and pattern constraints
+ * Create string validator with length and pattern constraints. Lengths count
+ * UTF-8 characters; the pattern is compiled to a DFA when it fits the
+ * pattern engine's subset (see pattern.h) and to a POSIX regex otherwise.
  */
 validator_t* catzilla_create_string_validator(int min_len, int max_len, const char* pattern);
 
+/**
+ * Require strings to have a built-in format (email, UUID, datetime, URL, digits)
+ * @param validator String validator
+ * @param format Format, CATZILLA_STRING_FORMAT_NONE to drop the requirement
+ * @return 0 on success, -1 if validator is not a string validator
+ */
+int catzilla_set_string_format(validator_t* validator, catzilla_string_format_t format);
+
 /**
  * Create list validator with item type and size constraints
  */
@@ -272,6 +287,40 @@ validation_result_t catzilla_validate_model(model_spec_t* model, json_object_t*
                                            json_object_t** validated_data,
                                            validation_context_t* ctx);
 
+/**
+ * Receives each validated field of a catzilla_validate_model_yyjson() walk
+ * @param user_data Pointer passed to catzilla_validate_model_yyjson
+ * @param field Field specification
+ * @param value Field value, or NULL when an optional field is missing
+ * @return 0 to continue, non-zero to abort the walk
+ */
+typedef int (*catzilla_validation_emit_t)(void* user_data, const field_spec_t* field,
+                                          yyjson_val* value);
+
+/**
+ * Validate a single yyjson value against a validator
+ */
+validation_result_t catzilla_validate_value_yyjson(validator_t* validator, yyjson_val* value,
+                                                  validation_context_t* ctx);
+
+/**
+ * Validate a parsed yyjson document against a model without building a
+ * json_object_t tree. Fields are handed to emit in model order while no
+ * error has been found, so the caller can build its result in the same pass;
+ * once a field fails, the rest are still checked for errors but not emitted.
+ * A result built from emitted fields is only valid on VALIDATION_SUCCESS.
+ * @param model Model specification
+ * @param data Root value (must be an object)
+ * @param ctx Validation context collecting errors
+ * @param emit Field callback (may be NULL to validate only)
+ * @param user_data Passed to emit
+ * @return VALIDATION_SUCCESS, the last field error, or VALIDATION_ERROR_MEMORY
+ *         if emit aborted the walk
+ */
+validation_result_t catzilla_validate_model_yyjson(model_spec_t* model, yyjson_val* data,
+                                                  validation_context_t* ctx,
+                                                  catzilla_validation_emit_t emit, void* user_data);
+
 /**
  * Get validation errors as formatted string
  */
@@ -385,13 +434,57 @@ int catzilla_json_get_bool(json_object_t* obj, const char* key);
  */
 int catzilla_optimize_model_validation(model_spec_t* model);
 
+// Batches smaller than two chunks of this many items stay on the calling thread
+#define CATZILLA_BATCH_MIN_CHUNK 256
+
+struct task_engine;
+
+/**
+ * How catzilla_batch_validate_with_options spreads a batch
+ */
+typedef struct {
+    struct task_engine* engine;  // Engine whose workers share the batch, NULL for none
+    int max_workers;             // Worker tasks to queue at most, 0 for one per engine worker
+    bool stop_on_first_error;    // Stop every worker at the first invalid item
+} validation_batch_options_t;
+
 /**
- * Batch validate multiple models (for bulk operations)
+ * Batch validate multiple models (for bulk operations) on the calling thread
+ * @see catzilla_batch_validate_with_options
  */
 validation_result_t catzilla_batch_validate(model_spec_t* model, json_object_t** data_array,
                                            int count, json_object_t*** validated_array,
                                            validation_context_t* ctx);
 
+/**
+ * Batch validate multiple models, splitting the array across task engine
+ * workers. Workers claim chunks of items and validate each chunk into its own
+ * context; the calling thread validates chunks too, so the batch finishes even
+ * when every worker is busy.
+ * @param model Model to validate against
+ * @param data_array Items (a NULL item fails with VALIDATION_ERROR_TYPE)
+ * @param count Number of items
+ * @param validated_array Set to a new array of count validated items, NULL for
+ *        invalid ones; free it with catzilla_free_batch_results
+ * @param ctx Receives the errors ahead of any it already holds, ordered by
+ *        item_index. With stop_on_first_error only the first invalid item's
+ *        errors are kept and later items are left NULL, whatever the timing.
+ * @param options Workers and early exit, NULL to validate every item here
+ * @return VALIDATION_SUCCESS when every item is valid, otherwise the result of
+ *         the first invalid item, VALIDATION_ERROR_MEMORY if allocation fails
+ */
+validation_result_t catzilla_batch_validate_with_options(model_spec_t* model, json_object_t** data_array,
+                                                        int count, json_object_t*** validated_array,
+                                                        validation_context_t* ctx,
+                                                        const validation_batch_options_t* options);
+
+/**
+ * Free the array catzilla_batch_validate returned and its items
+ * @param validated_array Array (may be NULL)
+ * @param count Number of items
+ */
+void catzilla_free_batch_results(json_object_t** validated_array, int count);
+
 /**
  * Get validation performance statistics
  */
@@ -0,0 +1,939 @@
+#include "websocket.h"
+#include "memory.h"
+#include "logging.h"
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef CATZILLA_HAS_ZLIB
+#include <zlib.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CATZILLA_WS_SSE2 1
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(__GNUC__)
+#include <arm_neon.h>
+#define CATZILLA_WS_NEON 1
+#endif
+
+// Reassembly and (de)compression buffers larger than this are released once
+// their message is done, so idle connections do not pin big allocations
+#define WS_KEEP_BUFFER_SIZE (64 * 1024)
+
+struct catzilla_ws_session_s {
+    catzilla_ws_message_fn on_message;
+    catzilla_ws_send_fn send;
+    void* user_data;
+    size_t max_message_size;
+    catzilla_ws_state_t state;
+
+    // Frame being parsed: its header is collected first, even when it is
+    // split over reads
+    uint8_t header[CATZILLA_WS_MAX_FRAME_HEADER];
+    size_t header_length;
+    bool in_frame;
+    uint8_t opcode;
+    bool fin;
+    uint8_t mask[4];
+    uint64_t payload_length;
+    uint64_t payload_received;
+
+    // Text or binary message whose frames are being reassembled
+    bool in_message;
+    int message_opcode;
+    bool message_compressed;
+    char* message;
+    size_t message_length;
+    size_t message_capacity;
+
+    // Control frames are short and may arrive between fragments
+    char control[CATZILLA_WS_MAX_CONTROL_PAYLOAD];
+    size_t control_length;
+
+    int close_code;
+    char close_reason[CATZILLA_WS_MAX_CONTROL_PAYLOAD - 2];
+    size_t close_reason_length;
+
+    catzilla_ws_deflate_params_t deflate;
+#ifdef CATZILLA_HAS_ZLIB
+    // Created on first use: many connections never send a compressed message
+    bool inflater_ready;
+    bool deflater_ready;
+    z_stream inflater;
+    z_stream deflater;
+    char* inflated;
+    size_t inflated_capacity;
+    char* deflated;
+    size_t deflated_capacity;
+#endif
+};
+
+// ============================================================================
+// Handshake: SHA-1 and base64 for Sec-WebSocket-Accept
+// ============================================================================
+
+typedef struct {
+    uint32_t state[5];
+    uint8_t block[64];
+    size_t block_length;
+    uint64_t total;
+} sha1_ctx_t;
+
+static inline uint32_t rotl32(uint32_t x, int n) {
+    return (x << n) | (x >> (32 - n));
+}
+
+static void sha1_block(uint32_t state[5], const uint8_t* p) {
+    uint32_t w[80];
+    for (int i = 0; i < 16; i++) {
+        w[i] = ((uint32_t)p[4 * i] << 24) | ((uint32_t)p[4 * i + 1] << 16) |
+               ((uint32_t)p[4 * i + 2] << 8) | (uint32_t)p[4 * i + 3];
+    }
+    for (int i = 16; i < 80; i++) {
+        w[i] = rotl32(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+    for (int i = 0; i < 80; i++) {
+        uint32_t f, k;
+        if (i < 20) {
+            f = (b & c) | (~b & d);
+            k = 0x5a827999;
+        } else if (i < 40) {
+            f = b ^ c ^ d;
+            k = 0x6ed9eba1;
+        } else if (i < 60) {
+            f = (b & c) | (b & d) | (c & d);
+            k = 0x8f1bbcdc;
+        } else {
+            f = b ^ c ^ d;
+            k = 0xca62c1d6;
+        }
+        uint32_t t = rotl32(a, 5) + f + e + k + w[i];
+        e = d;
+        d = c;
+        c = rotl32(b, 30);
+        b = a;
+        a = t;
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+}
+
+static void sha1_init(sha1_ctx_t* ctx) {
+    ctx->state[0] = 0x67452301;
+    ctx->state[1] = 0xefcdab89;
+    ctx->state[2] = 0x98badcfe;
+    ctx->state[3] = 0x10325476;
+    ctx->state[4] = 0xc3d2e1f0;
+    ctx->block_length = 0;
+    ctx->total = 0;
+}
+
+static void sha1_update(sha1_ctx_t* ctx, const uint8_t* data, size_t length) {
+    ctx->total += length;
+    while (length > 0) {
+        size_t n = 64 - ctx->block_length;
+        if (n > length) n = length;
+        memcpy(ctx->block + ctx->block_length, data, n);
+        ctx->block_length += n;
+        data += n;
+        length -= n;
+        if (ctx->block_length == 64) {
+            sha1_block(ctx->state, ctx->block);
+            ctx->block_length = 0;
+        }
+    }
+}
+
+static void sha1_final(sha1_ctx_t* ctx, uint8_t digest[20]) {
+    uint64_t bits = ctx->total * 8;
+    uint8_t pad = 0x80;
+    sha1_update(ctx, &pad, 1);
+    pad = 0;
+    while (ctx->block_length != 56) {
+        sha1_update(ctx, &pad, 1);
+    }
+    uint8_t length_bytes[8];
+    for (int i = 0; i < 8; i++) {
+        length_bytes[i] = (uint8_t)(bits >> (56 - 8 * i));
+    }
+    sha1_update(ctx, length_bytes, 8);
+    for (int i = 0; i < 5; i++) {
+        digest[4 * i] = (uint8_t)(ctx->state[i] >> 24);
+        digest[4 * i + 1] = (uint8_t)(ctx->state[i] >> 16);
+        digest[4 * i + 2] = (uint8_t)(ctx->state[i] >> 8);
+        digest[4 * i + 3] = (uint8_t)ctx->state[i];
+    }
+}
+
+static const char base64_alphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+void catzilla_ws_accept_key(const char* key, size_t key_length, char accept[CATZILLA_WS_ACCEPT_LEN + 1]) {
+    sha1_ctx_t ctx;
+    uint8_t digest[20];
+    sha1_init(&ctx);
+    sha1_update(&ctx, (const uint8_t*)key, key_length);
+    sha1_update(&ctx, (const uint8_t*)CATZILLA_WS_GUID, sizeof(CATZILLA_WS_GUID) - 1);
+    sha1_final(&ctx, digest);
+
+    // 20 bytes: six full groups and one group of two bytes
+    char* out = accept;
+    for (int i = 0; i < 18; i += 3) {
+        uint32_t v = ((uint32_t)digest[i] << 16) | ((uint32_t)digest[i + 1] << 8) | digest[i + 2];
+        *out++ = base64_alphabet[(v >> 18) & 0x3f];
+        *out++ = base64_alphabet[(v >> 12) & 0x3f];
+        *out++ = base64_alphabet[(v >> 6) & 0x3f];
+        *out++ = base64_alphabet[v & 0x3f];
+    }
+    uint32_t v = ((uint32_t)digest[18] << 16) | ((uint32_t)digest[19] << 8);
+    *out++ = base64_alphabet[(v >> 18) & 0x3f];
+    *out++ = base64_alphabet[(v >> 12) & 0x3f];
+    *out++ = base64_alphabet[(v >> 6) & 0x3f];
+    *out++ = '=';
+    *out = '\0';
+}
+
+bool catzilla_ws_key_valid(const char* key, size_t key_length) {
+    // 16 bytes encode to 22 characters and two padding characters
+    if (!key || key_length != 24 || key[22] != '=' || key[23] != '=') return false;
+    for (size_t i = 0; i < 22; i++) {
+        if (!memchr(base64_alphabet, key[i], sizeof(base64_alphabet) - 1)) return false;
+    }
+    // The last character carries only two bits of the 16th byte
+    const char* last = memchr(base64_alphabet, key[21], sizeof(base64_alphabet) - 1);
+    return ((last - base64_alphabet) & 0x0f) == 0;
+}
+
+// ============================================================================
+// permessage-deflate negotiation (RFC 7692 7)
+// ============================================================================
+
+#ifdef CATZILLA_HAS_ZLIB
+static bool token_equals(const char* token, size_t length, const char* name) {
+    size_t name_length = strlen(name);
+    if (length != name_length) return false;
+    for (size_t i = 0; i < length; i++) {
+        char c = token[i];
+        if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+        if (c != name[i]) return false;
+    }
+    return true;
+}
+
+static void trim(const char** start, const char** end) {
+    while (*start < *end && (**start == ' ' || **start == '\t')) (*start)++;
+    while (*end > *start && ((*end)[-1] == ' ' || (*end)[-1] == '\t')) (*end)--;
+}
+
+// Window bits parameter value: 8-15, optionally quoted; -1 when invalid
+static int window_bits_value(const char* value, const char* end) {
+    if (end - value >= 2 && *value == '"' && end[-1] == '"') {
+        value++;
+        end--;
+    }
+    if (end - value < 1 || end - value > 2) return -1;
+    int bits = 0;
+    for (const char* p = value; p < end; p++) {
+        if (*p < '0' || *p > '9') return -1;
+        bits = bits * 10 + (*p - '0');
+    }
+    return (bits >= 8 && bits <= 15) ? bits : -1;
+}
+
+// One offer: "permessage-deflate; param; param=value"
+static bool accept_deflate_offer(const char* p, const char* end, catzilla_ws_deflate_params_t* params) {
+    memset(params, 0, sizeof(*params));
+    params->server_max_window_bits = 15;
+    bool seen_server_bits = false;
+    bool seen_client_bits = false;
+    bool first = true;
+
+    while (p <= end) {
+        const char* next = memchr(p, ';', (size_t)(end - p));
+        if (!next) next = end;
+        const char* start = p;
+        const char* stop = next;
+        trim(&start, &stop);
+
+        if (first) {
+            if (!token_equals(start, (size_t)(stop - start), "permessage-deflate")) return false;
+            first = false;
+        } else {
+            const char* eq = memchr(start, '=', (size_t)(stop - start));
+            const char* name_end = eq ? eq : stop;
+            const char* value = eq ? eq + 1 : stop;
+            trim(&start, &name_end);
+            trim(&value, &stop);
+            size_t name_length = (size_t)(name_end - start);
+
+            if (token_equals(start, name_length, "server_no_context_takeover")) {
+                if (eq || params->server_no_context_takeover) return false;
+                params->server_no_context_takeover = true;
+            } else if (token_equals(start, name_length, "client_no_context_takeover")) {
+                if (eq || params->client_no_context_takeover) return false;
+                params->client_no_context_takeover = true;
+            } else if (token_equals(start, name_length, "server_max_window_bits")) {
+                int bits = eq ? window_bits_value(value, stop) : -1;
+                // zlib cannot produce raw deflate with a 256 byte window
+                if (seen_server_bits || bits < 9) return false;
+                params->server_max_window_bits = bits;
+                seen_server_bits = true;
+            } else if (token_equals(start, name_length, "client_max_window_bits")) {
+                // Any window inflates with the largest one; not echoed
+                if (seen_client_bits || (eq && window_bits_value(value, stop) < 0)) return false;
+                seen_client_bits = true;
+            } else {
+                return false;
+            }
+        }
+        p = next + 1;
+    }
+    params->enabled = !first;
+    return params->enabled;
+}
+#endif
+
+bool catzilla_ws_negotiate_deflate(const char* offers, size_t length,
+                                   catzilla_ws_deflate_params_t* params,
+                                   char* response, size_t response_size) {
+    if (params) memset(params, 0, sizeof(*params));
+#ifdef CATZILLA_HAS_ZLIB
+    if (!offers || !params || !response || response_size == 0) return false;
+
+    const char* p = offers;
+    const char* end = offers + length;
+    while (p < end) {
+        const char* next = memchr(p, ',', (size_t)(end - p));
+        if (!next) next = end;
+        if (accept_deflate_offer(p, next, params)) {
+            char bits[32] = "";
+            if (params->server_max_window_bits < 15) {
+                snprintf(bits, sizeof(bits), "; server_max_window_bits=%d", params->server_max_window_bits);
+            }
+            int n = snprintf(response, response_size, "permessage-deflate%s%s%s",
+                             params->server_no_context_takeover ? "; server_no_context_takeover" : "",
+                             params->client_no_context_takeover ? "; client_no_context_takeover" : "",
+                             bits);
+            if (n > 0 && (size_t)n < response_size) return true;
+            break;
+        }
+        p = next + 1;
+    }
+    memset(params, 0, sizeof(*params));
+    response[0] = '\0';
+    return false;
+#else
+    (void)offers;
+    (void)length;
+    (void)response_size;
+    if (response && response_size > 0) response[0] = '\0';
+    return false;
+#endif
+}
+
+// ============================================================================
+// Unmasking and UTF-8 validation
+// ============================================================================
+
+void catzilla_ws_unmask(uint8_t* data, size_t length, const uint8_t mask[4], uint64_t offset) {
+    // The key repeats every four bytes, so sixteen of them rotated to the
+    // payload offset cover any aligned block
+    uint8_t key[16];
+    for (int i = 0; i < 16; i++) {
+        key[i] = mask[(offset + (uint64_t)i) & 3];
+    }
+
+    size_t i = 0;
+#if defined(CATZILLA_WS_SSE2)
+    const __m128i k = _mm_loadu_si128((const __m128i*)key);
+    for (; i + 64 <= length; i += 64) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(data + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(data + i + 16));
+        __m128i c = _mm_loadu_si128((const __m128i*)(data + i + 32));
+        __m128i d = _mm_loadu_si128((const __m128i*)(data + i + 48));
+        _mm_storeu_si128((__m128i*)(data + i), _mm_xor_si128(a, k));
+        _mm_storeu_si128((__m128i*)(data + i + 16), _mm_xor_si128(b, k));
+        _mm_storeu_si128((__m128i*)(data + i + 32), _mm_xor_si128(c, k));
+        _mm_storeu_si128((__m128i*)(data + i + 48), _mm_xor_si128(d, k));
+    }
+    for (; i + 16 <= length; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(data + i));
+        _mm_storeu_si128((__m128i*)(data + i), _mm_xor_si128(v, k));
+    }
+#elif defined(CATZILLA_WS_NEON)
+    const uint8x16_t k = vld1q_u8(key);
+    for (; i + 16 <= length; i += 16) {
+        vst1q_u8(data + i, veorq_u8(vld1q_u8(data + i), k));
+    }
+#endif
+    uint64_t k64;
+    memcpy(&k64, key, sizeof(k64));
+    for (; i + 8 <= length; i += 8) {
+        uint64_t v;
+        memcpy(&v, data + i, sizeof(v));
+        v ^= k64;
+        memcpy(data + i, &v, sizeof(v));
+    }
+    for (; i < length; i++) {
+        data[i] ^= key[i & 3];
+    }
+}
+
+// Skip the ASCII run at p
+static const uint8_t* skip_ascii(const uint8_t* p, const uint8_t* end) {
+#if defined(CATZILLA_WS_SSE2)
+    while (end - p >= 16) {
+        if (_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)p))) break;
+        p += 16;
+    }
+#elif defined(CATZILLA_WS_NEON)
+    while (end - p >= 16) {
+        uint64x2_t v = vreinterpretq_u64_u8(vld1q_u8(p));
+        if ((vgetq_lane_u64(v, 0) | vgetq_lane_u64(v, 1)) & 0x8080808080808080ULL) break;
+        p += 16;
+    }
+#endif
+    while (end - p >= 8) {
+        uint64_t v;
+        memcpy(&v, p, sizeof(v));
+        if (v & 0x8080808080808080ULL) break;
+        p += 8;
+    }
+    while (p < end && *p < 0x80) p++;
+    return p;
+}
+
+bool catzilla_ws_utf8_valid(const uint8_t* data, size_t length) {
+    const uint8_t* p = data;
+    const uint8_t* end = data + length;
+
+    while ((p = skip_ascii(p, end)) < end) {
+        uint8_t c = *p;
+        // Allowed range of the second byte narrows for E0, ED, F0 and F4
+        uint8_t low = 0x80, high = 0xbf;
+        int continuation;
+        if (c >= 0xc2 && c <= 0xdf) {
+            continuation = 1;
+        } else if (c >= 0xe0 && c <= 0xef) {
+            continuation = 2;
+            if (c == 0xe0) low = 0xa0;   // Overlong
+            if (c == 0xed) high = 0x9f;  // Surrogates
+        } else if (c >= 0xf0 && c <= 0xf4) {
+            continuation = 3;
+            if (c == 0xf0) low = 0x90;   // Overlong
+            if (c == 0xf4) high = 0x8f;  // Past U+10FFFF
+        } else {
+            return false;
+        }
+
+        if (end - p <= continuation) return false;
+        if (p[1] < low || p[1] > high) return false;
+        for (int i = 2; i <= continuation; i++) {
+            if ((p[i] & 0xc0) != 0x80) return false;
+        }
+        p += continuation + 1;
+    }
+    return true;
+}
+
+// ============================================================================
+// Session
+// ============================================================================
+
+catzilla_ws_session_t* catzilla_ws_session_create(catzilla_ws_message_fn on_message,
+                                                  catzilla_ws_send_fn send,
+                                                  void* user_data,
+                                                  size_t max_message_size,
+                                                  const catzilla_ws_deflate_params_t* deflate) {
+    if (!on_message || !send) return NULL;
+
+    catzilla_ws_session_t* session = catzilla_calloc(1, sizeof(*session));
+    if (!session) return NULL;
+    session->on_message = on_message;
+    session->send = send;
+    session->user_data = user_data;
+    session->max_message_size = max_message_size;
+    session->state = CATZILLA_WS_OPEN;
+    session->close_code = CATZILLA_WS_CLOSE_ABNORMAL;
+#ifdef CATZILLA_HAS_ZLIB
+    if (deflate && deflate->enabled) {
+        session->deflate = *deflate;
+    }
+#else
+    (void)deflate;
+#endif
+    return session;
+}
+
+void catzilla_ws_session_free(catzilla_ws_session_t* session) {
+    if (!session) return;
+#ifdef CATZILLA_HAS_ZLIB
+    if (session->inflater_ready) inflateEnd(&session->inflater);
+    if (session->deflater_ready) deflateEnd(&session->deflater);
+    catzilla_free(session->inflated);
+    catzilla_free(session->deflated);
+#endif
+    catzilla_free(session->message);
+    catzilla_free(session);
+}
+
+catzilla_ws_state_t catzilla_ws_session_state(const catzilla_ws_session_t* session) {
+    return session->state;
+}
+
+int catzilla_ws_session_close_code(const catzilla_ws_session_t* session, const char** reason, size_t* length) {
+    if (reason) *reason = session->close_reason;
+    if (length) *length = session->close_reason_length;
+    return session->close_code;
+}
+
+static size_t frame_header(uint8_t* header, int opcode, bool compressed, size_t length) {
+    header[0] = (uint8_t)(0x80 | (compressed ? 0x40 : 0) | opcode);
+    if (length < 126) {
+        header[1] = (uint8_t)length;
+        return 2;
+    }
+    if (length <= 0xffff) {
+        header[1] = 126;
+        header[2] = (uint8_t)(length >> 8);
+        header[3] = (uint8_t)length;
+        return 4;
+    }
+    header[1] = 127;
+    uint64_t wide = (uint64_t)length;
+    for (int i = 0; i < 8; i++) {
+        header[2 + i] = (uint8_t)(wide >> (56 - 8 * i));
+    }
+    return 10;
+}
+
+static int send_frame(catzilla_ws_session_t* session, int opcode, bool compressed,
+                      const char* payload, size_t length, bool close_after) {
+    uint8_t header[CATZILLA_WS_MAX_FRAME_HEADER];
+    size_t header_length = frame_header(header, opcode, compressed, length);
+    if (session->send(session->user_data, (const char*)header, header_length, payload, length, close_after) != 0) {
+        session->state = CATZILLA_WS_CLOSED;
+        return -1;
+    }
+    return 0;
+}
+
+static bool close_code_valid(int code) {
+    return (code >= 1000 && code <= 1003) || (code >= 1007 && code <= 1014) ||
+           (code >= 3000 && code <= 4999);
+}
+
+static int close_payload(char* payload, int code, const char* reason, size_t length) {
+    if (code == 0) return 0;
+    payload[0] = (char)(code >> 8);
+    payload[1] = (char)code;
+    if (!reason) length = 0;
+    if (length > CATZILLA_WS_MAX_CONTROL_PAYLOAD - 2) {
+        length = CATZILLA_WS_MAX_CONTROL_PAYLOAD - 2;
+        // Do not cut a character in half
+        while (length > 0 && ((uint8_t)reason[length] & 0xc0) == 0x80) length--;
+    }
+    if (length > 0) memcpy(payload + 2, reason, length);
+    return (int)(2 + length);
+}
+
+// Fail the connection: say why, then close once that is written
+static int fail_session(catzilla_ws_session_t* session, int code) {
+    LOG_HTTP_DEBUG("WebSocket failed with close code %d", code);
+    if (session->state == CATZILLA_WS_CLOSED) return -1;
+    bool announce = session->state == CATZILLA_WS_OPEN;
+    session->state = CATZILLA_WS_CLOSED;
+    session->close_code = code;
+    session->close_reason_length = 0;
+    if (announce) {
+        char payload[2];
+        close_payload(payload, code, NULL, 0);
+        uint8_t header[CATZILLA_WS_MAX_FRAME_HEADER];
+        size_t header_length = frame_header(header, CATZILLA_WS_OP_CLOSE, false, sizeof(payload));
+        session->send(session->user_data, (const char*)header, header_length, payload, sizeof(payload), true);
+    }
+    return -1;
+}
+
+static void release_large_buffer(char** buffer, size_t* capacity) {
+    if (*capacity > WS_KEEP_BUFFER_SIZE) {
+        catzilla_free(*buffer);
+        *buffer = NULL;
+        *capacity = 0;
+    }
+}
+
+static int grow_buffer(char** buffer, size_t* capacity, size_t needed) {
+    if (needed <= *capacity) return 0;
+    size_t grown = *capacity ? *capacity : 1024;
+    while (grown < needed) {
+        if (grown > SIZE_MAX / 2) {
+            grown = needed;
+            break;
+        }
+        grown *= 2;
+    }
+    char* data = catzilla_realloc(*buffer, grown);
+    if (!data) return -1;
+    *buffer = data;
+    *capacity = grown;
+    return 0;
+}
+
+#ifdef CATZILLA_HAS_ZLIB
+// Inflate one chunk of a message's compressed payload after what was
+// already produced; -1 = corrupt data, -2 = over the size limit or no memory
+static int inflate_chunk(catzilla_ws_session_t* session, const uint8_t* data, size_t length, size_t* produced) {
+    z_stream* z = &session->inflater;
+    z->next_in = (Bytef*)data;
+    z->avail_in = (uInt)length;
+
+    for (;;) {
+        if (*produced == session->inflated_capacity &&
+            grow_buffer(&session->inflated, &session->inflated_capacity, *produced + 1) != 0) {
+            return -2;
+        }
+        size_t space = session->inflated_capacity - *produced;
+        if (space > UINT_MAX) space = UINT_MAX;
+        z->next_out = (Bytef*)session->inflated + *produced;
+        z->avail_out = (uInt)space;
+        int rc = inflate(z, Z_SYNC_FLUSH);
+        *produced += space - z->avail_out;
+
+        if (session->max_message_size > 0 && *produced > session->max_message_size) return -2;
+        if (rc == Z_STREAM_END) {
+            // A final block ends the stream; the next message starts a new one
+            inflateReset(z);
+            if (z->avail_in == 0) return 0;
+            continue;
+        }
+        if (rc != Z_OK && rc != Z_BUF_ERROR) return -1;
+        if (z->avail_in == 0 && z->avail_out > 0) return 0;
+        if (rc == Z_BUF_ERROR && z->avail_out > 0) return -1;
+    }
+}
+
+static int inflate_message(catzilla_ws_session_t* session, const char* data, size_t length,
+                           char** out, size_t* out_length) {
+    if (!session->inflater_ready) {
+        memset(&session->inflater, 0, sizeof(session->inflater));
+        if (inflateInit2(&session->inflater, -MAX_WBITS) != Z_OK) return -2;
+        session->inflater_ready = true;
+    }
+
+    // The sender stripped the empty block that ends each message (RFC 7692 7.2.2)
+    static const uint8_t tail[4] = {0x00, 0x00, 0xff, 0xff};
+    size_t produced = 0;
+    while (length > 0) {
+        size_t chunk = length > UINT_MAX ? UINT_MAX : length;
+        int rc = inflate_chunk(session, (const uint8_t*)data, chunk, &produced);
+        if (rc != 0) return rc;
+        data += chunk;
+        length -= chunk;
+    }
+    int rc = inflate_chunk(session, tail, sizeof(tail), &produced);
+    if (rc != 0) return rc;
+
+    if (session->deflate.client_no_context_takeover) {
+        inflateReset(&session->inflater);
+    }
+    *out = session->inflated;
+    *out_length = produced;
+    return 0;
+}
+
+static int deflate_message(catzilla_ws_session_t* session, const char* data, size_t length,
+                           const char** out, size_t* out_length) {
+    if (!session->deflater_ready) {
+        memset(&session->deflater, 0, sizeof(session->deflater));
+        if (deflateInit2(&session->deflater, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                         -session->deflate.server_max_window_bits, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            return -1;
+        }
+        session->deflater_ready = true;
+    }
+    if (length > UINT_MAX) return -1;
+
+    z_stream* z = &session->deflater;
+    z->next_in = (Bytef*)data;
+    z->avail_in = (uInt)length;
+    size_t produced = 0;
+    if (grow_buffer(&session->deflated, &session->deflated_capacity, length / 2 + 64) != 0) return -1;
+
+    for (;;) {
+        size_t space = session->deflated_capacity - produced;
+        if (space > UINT_MAX) space = UINT_MAX;
+        z->next_out = (Bytef*)session->deflated + produced;
+        z->avail_out = (uInt)space;
+        if (deflate(z, Z_SYNC_FLUSH) == Z_STREAM_ERROR) return -1;
+        produced += space - z->avail_out;
+        if (z->avail_out > 0) break;
+        if (grow_buffer(&session->deflated, &session->deflated_capacity, produced + 1) != 0) return -1;
+    }
+
+    // Drop the sync flush's empty block; the receiver puts it back
+    if (produced >= 4 && memcmp(session->deflated + produced - 4, "\x00\x00\xff\xff", 4) == 0) {
+        produced -= 4;
+    }
+    if (session->deflate.server_no_context_takeover) {
+        deflateReset(z);
+    }
+    *out = session->deflated;
+    *out_length = produced;
+    return 0;
+}
+#endif
+
+static int deliver_message(catzilla_ws_session_t* session, char* data, size_t length) {
+    // After our close frame only the peer's close matters
+    if (session->state != CATZILLA_WS_OPEN) return 0;
+
+#ifdef CATZILLA_HAS_ZLIB
+    if (session->message_compressed) {
+        int rc = inflate_message(session, data, length, &data, &length);
+        if (rc != 0) {
+            return fail_session(session, rc == -1 ? CATZILLA_WS_CLOSE_INVALID_DATA : CATZILLA_WS_CLOSE_TOO_BIG);
+        }
+    }
+#endif
+
+    if (session->message_opcode == CATZILLA_WS_OP_TEXT &&
+        !catzilla_ws_utf8_valid((const uint8_t*)data, length)) {
+        return fail_session(session, CATZILLA_WS_CLOSE_INVALID_DATA);
+    }
+    session->on_message(session->user_data, session->message_opcode, data, length);
+
+#ifdef CATZILLA_HAS_ZLIB
+    release_large_buffer(&session->inflated, &session->inflated_capacity);
+#endif
+    return 0;
+}
+
+static int handle_control_frame(catzilla_ws_session_t* session) {
+    switch (session->opcode) {
+        case CATZILLA_WS_OP_PING:
+            if (session->state != CATZILLA_WS_OPEN) return 0;
+            return send_frame(session, CATZILLA_WS_OP_PONG, false, session->control, session->control_length, false);
+
+        case CATZILLA_WS_OP_PONG:
+            return 0;
+
+        case CATZILLA_WS_OP_CLOSE: {
+            size_t length = session->control_length;
+            int code = CATZILLA_WS_CLOSE_NO_STATUS;
+            if (length == 1) return fail_session(session, CATZILLA_WS_CLOSE_PROTOCOL_ERROR);
+            if (length >= 2) {
+                code = ((uint8_t)session->control[0] << 8) | (uint8_t)session->control[1];
+                if (!close_code_valid(code)) return fail_session(session, CATZILLA_WS_CLOSE_PROTOCOL_ERROR);
+                if (!catzilla_ws_utf8_valid((const uint8_t*)session->control + 2, length - 2)) {
+                    return fail_session(session, CATZILLA_WS_CLOSE_INVALID_DATA);
+                }
+                memcpy(session->close_reason, session->control + 2, length - 2);
+                session->close_reason_length = length - 2;
+            }
+            session->close_code = code;
+
+            bool answer = session->state == CATZILLA_WS_OPEN;
+            session->state = CATZILLA_WS_CLOSED;
+            if (answer) {
+                // Echo the code; the connection closes once the echo is out
+                char payload[2];
+                int payload_length = close_payload(payload, code == CATZILLA_WS_CLOSE_NO_STATUS ? 0 : code, NULL, 0);
+                uint8_t header[CATZILLA_WS_MAX_FRAME_HEADER];
+                size_t header_length = frame_header(header, CATZILLA_WS_OP_CLOSE, false, (size_t)payload_length);
+                session->send(session->user_data, (const char*)header, header_length,
+                              payload, (size_t)payload_length, true);
+            }
+            return -1;
+        }
+
+        default:
+            return fail_session(session, CATZILLA_WS_CLOSE_PROTOCOL_ERROR);
+    }
+}
+
+// The frame header is complete: check it and prepare for its payload
+static int start_frame(catzilla_ws_session_t* session) {
+    const uint8_t* h = session->header;
+    session->fin = (h[0] & 0x80) != 0;
+    bool rsv1 = (h[0] & 0x40) != 0;
+    session->opcode = h[0] & 0x0f;
+    if ((h[0] & 0x30) || !(h[1] & 0x80)) {
+        // Unknown extension bits, or an unmasked client frame
+        return fail_session(session, CATZILLA_WS_CLOSE_PROTOCOL_ERROR);
+    }
+
+    uint64_t length = h[1] & 0x7f;
+    size_t pos = 2;
+    if (length == 126) {
+        length = ((uint64_t)h[2] << 8) | h[3];
+        pos = 4;
+    } else if (length == 127) {
+        length = 0;
+        for (int i = 0; i < 8; i++) {
+            length = (length << 8) | h[2 + i];
+        }
+        pos = 10;
+        if (length >> 63) return fail_session(session, CATZILLA_WS_CLOSE_PROTOCOL_ERROR);
+    }
+    memcpy(session->mask, h + pos, 4);
+    session->payload_length = length;
+    session->payload_received = 0;
+    session->control_length = 0;
+
+    if (session->opcode >= 0x8) {
+        if (session->opcode > CATZILLA_WS_OP_PONG || !session->fin || rsv1 ||
+            length > CATZILLA_WS_MAX_CONTROL_PAYLOAD) {
+            return fail_session(session, CATZILLA_WS_CLOSE_PROTOCOL_ERROR);
+        }
+        return 0;
+    }
+
+    if (session->opcode == CATZILLA_WS_OP_CONTINUATION) {
+        // Only the first frame of a message may be marked compressed
+        if (!session->in_message || rsv1) return fail_session(session, CATZILLA_WS_CLOSE_PROTOCOL_ERROR);
+    } else if (session->opcode == CATZILLA_WS_OP_TEXT || session->opcode == CATZILLA_WS_OP_BINARY) {
+        if (session->in_message || (rsv1 && !session->deflate.enabled)) {
+            return fail_session(session, CATZILLA_WS_CLOSE_PROTOCOL_ERROR);
+        }
+        session->in_message = true;
+        session->message_opcode = session->opcode;
+        session->message_compressed = rsv1;
+        session->message_length = 0;
+    } else {
+        return fail_session(session, CATZILLA_WS_CLOSE_PROTOCOL_ERROR);
+    }
+
+    if (session->max_message_size > 0 &&
+        length > session->max_message_size - session->message_length) {
+        return fail_session(session, CATZILLA_WS_CLOSE_TOO_BIG);
+    }
+    return 0;
+}
+
+// The frame's payload is complete; direct is set when it was not copied
+static int finish_frame(catzilla_ws_session_t* session, char* direct, size_t direct_length) {
+    session->in_frame = false;
+    session->header_length = 0;
+
+    if (session->opcode >= 0x8) {
+        return handle_control_frame(session);
+    }
+    if (!session->fin) return 0;
+
+    session->in_message = false;
+    int rc;
+    if (direct) {
+        rc = deliver_message(session, direct, direct_length);
+    } else {
+        rc = deliver_message(session, session->message, session->message_length);
+    }
+    session->message_length = 0;
+    release_large_buffer(&session->message, &session->message_capacity);
+    return rc;
+}
+
+// Bytes of the frame header still missing once `have` of them are there
+static size_t header_missing(const uint8_t* header, size_t have) {
+    if (have < 2) return 2 - have;
+    uint8_t length = header[1] & 0x7f;
+    size_t total = 2 + (length == 126 ? 2 : length == 127 ? 8 : 0) + ((header[1] & 0x80) ? 4 : 0);
+    return total - have;
+}
+
+int catzilla_ws_session_receive(catzilla_ws_session_t* session, char* data, size_t length) {
+    if (session->state == CATZILLA_WS_CLOSED) return -1;
+
+    while (length > 0) {
+        if (!session->in_frame) {
+            size_t missing = header_missing(session->header, session->header_length);
+            size_t take = missing < length ? missing : length;
+            memcpy(session->header + session->header_length, data, take);
+            session->header_length += take;
+            data += take;
+            length -= take;
+            if (header_missing(session->header, session->header_length) > 0) continue;
+
+            if (start_frame(session) != 0) return -1;
+            session->in_frame = true;
+            if (session->payload_length == 0 && finish_frame(session, NULL, 0) != 0) return -1;
+            continue;
+        }
+
+        uint64_t remaining = session->payload_length - session->payload_received;
+        size_t take = remaining < length ? (size_t)remaining : length;
+        catzilla_ws_unmask((uint8_t*)data, take, session->mask, session->payload_received);
+
+        bool whole = session->payload_received == 0 && take == session->payload_length;
+        session->payload_received += take;
+        char* chunk = data;
+        data += take;
+        length -= take;
+
+        if (session->opcode >= 0x8) {
+            memcpy(session->control + session->control_length, chunk, take);
+            session->control_length += take;
+        } else if (whole && session->fin && session->message_length == 0) {
+            // The whole message is in this read: hand it over where it lies
+            if (finish_frame(session, chunk, take) != 0) return -1;
+            continue;
+        } else {
+            if (grow_buffer(&session->message, &session->message_capacity,
+                            session->message_length + take) != 0) {
+                return fail_session(session, CATZILLA_WS_CLOSE_TOO_BIG);
+            }
+            memcpy(session->message + session->message_length, chunk, take);
+            session->message_length += take;
+        }
+
+        if (session->payload_received == session->payload_length && finish_frame(session, NULL, 0) != 0) {
+            return -1;
+        }
+    }
+    return session->state == CATZILLA_WS_CLOSED ? -1 : 0;
+}
+
+int catzilla_ws_session_send(catzilla_ws_session_t* session, int opcode, const char* data, size_t length) {
+    if (!session || session->state != CATZILLA_WS_OPEN || (!data && length > 0) ||
+        (opcode != CATZILLA_WS_OP_TEXT && opcode != CATZILLA_WS_OP_BINARY)) {
+        return -1;
+    }
+
+#ifdef CATZILLA_HAS_ZLIB
+    if (session->deflate.enabled && length >= CATZILLA_WS_DEFLATE_MIN_SIZE) {
+        const char* compressed;
+        size_t compressed_length;
+        if (deflate_message(session, data, length, &compressed, &compressed_length) == 0) {
+            int rc = send_frame(session, opcode, true, compressed, compressed_length, false);
+            release_large_buffer(&session->deflated, &session->deflated_capacity);
+            return rc;
+        }
+        LOG_HTTP_WARN("WebSocket compression failed; sending uncompressed");
+    }
+#endif
+    return send_frame(session, opcode, false, data, length, false);
+}
+
+int catzilla_ws_session_ping(catzilla_ws_session_t* session, const char* data, size_t length) {
+    if (!session || session->state != CATZILLA_WS_OPEN || length > CATZILLA_WS_MAX_CONTROL_PAYLOAD ||
+        (!data && length > 0)) {
+        return -1;
+    }
+    return send_frame(session, CATZILLA_WS_OP_PING, false, data, length, false);
+}
+
+int catzilla_ws_session_close(catzilla_ws_session_t* session, int code, const char* reason, size_t length) {
+    if (!session || session->state != CATZILLA_WS_OPEN || (code != 0 && !close_code_valid(code))) {
+        return -1;
+    }
+    char payload[CATZILLA_WS_MAX_CONTROL_PAYLOAD];
+    int payload_length = close_payload(payload, code, reason, length);
+    session->state = CATZILLA_WS_CLOSING;
+    return send_frame(session, CATZILLA_WS_OP_CLOSE, false, payload, (size_t)payload_length, false);
+}
@@ -0,0 +1,221 @@
+#ifndef CATZILLA_WEBSOCKET_H
+#define CATZILLA_WEBSOCKET_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// WebSocket (RFC 6455) connection state, independent of the socket layer.
+// The server feeds received bytes in and gets messages and outgoing frames
+// back through callbacks. Client frames are unmasked in place in the read
+// buffer, so a message that arrives whole in one read reaches its callback
+// without being copied; fragmented messages and frames split over reads are
+// reassembled in a per-session buffer. permessage-deflate (RFC 7692) is
+// available when built with zlib.
+
+#define CATZILLA_WS_GUID "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+#define CATZILLA_WS_ACCEPT_LEN 28         // Base64 of a SHA-1 digest
+#define CATZILLA_WS_MAX_FRAME_HEADER 14   // 2 + 8 length bytes + 4 mask bytes
+#define CATZILLA_WS_MAX_CONTROL_PAYLOAD 125
+
+#define CATZILLA_WS_DEFAULT_MAX_MESSAGE (16 * 1024 * 1024)
+#define CATZILLA_WS_DEFAULT_MAX_QUEUE (1024 * 1024)  // Unsent bytes before a client is dropped
+#define CATZILLA_WS_DEFAULT_PING_INTERVAL_MS 30000
+#define CATZILLA_WS_DEFAULT_PONG_TIMEOUT_MS 10000
+#define CATZILLA_WS_CLOSE_TIMEOUT_MS 5000
+// Messages shorter than this are sent uncompressed even when deflate is on
+#define CATZILLA_WS_DEFLATE_MIN_SIZE 64
+
+// Opcodes (RFC 6455 5.2)
+#define CATZILLA_WS_OP_CONTINUATION 0x0
+#define CATZILLA_WS_OP_TEXT 0x1
+#define CATZILLA_WS_OP_BINARY 0x2
+#define CATZILLA_WS_OP_CLOSE 0x8
+#define CATZILLA_WS_OP_PING 0x9
+#define CATZILLA_WS_OP_PONG 0xA
+
+// Close codes (RFC 6455 7.4.1)
+#define CATZILLA_WS_CLOSE_NORMAL 1000
+#define CATZILLA_WS_CLOSE_GOING_AWAY 1001
+#define CATZILLA_WS_CLOSE_PROTOCOL_ERROR 1002
+#define CATZILLA_WS_CLOSE_UNSUPPORTED 1003
+#define CATZILLA_WS_CLOSE_NO_STATUS 1005   // Never sent: the close frame had no code
+#define CATZILLA_WS_CLOSE_ABNORMAL 1006    // Never sent: no close frame was received
+#define CATZILLA_WS_CLOSE_INVALID_DATA 1007
+#define CATZILLA_WS_CLOSE_POLICY 1008
+#define CATZILLA_WS_CLOSE_TOO_BIG 1009
+#define CATZILLA_WS_CLOSE_INTERNAL_ERROR 1011
+
+typedef enum {
+    CATZILLA_WS_OPEN,
+    CATZILLA_WS_CLOSING,  // Our close frame was sent; waiting for the peer's
+    CATZILLA_WS_CLOSED    // Handshake done or failed; nothing more is sent
+} catzilla_ws_state_t;
+
+/**
+ * permessage-deflate parameters agreed in the handshake
+ */
+typedef struct {
+    bool enabled;
+    bool server_no_context_takeover;  // Our compressor restarts every message
+    bool client_no_context_takeover;  // The client's does; so does our decompressor
+    int server_max_window_bits;       // Window we compress with (9-15)
+} catzilla_ws_deflate_params_t;
+
+typedef struct catzilla_ws_session_s catzilla_ws_session_t;
+
+/**
+ * Called once per complete text or binary message. Text messages were
+ * checked to be valid UTF-8.
+ * @param data Payload, writable and valid only during the call
+ * @param length Payload length
+ */
+typedef void (*catzilla_ws_message_fn)(void* user_data, int opcode, char* data, size_t length);
+
+/**
+ * Write one frame to the peer: header and payload go out in that order.
+ * Both buffers are needed only until the call returns.
+ * @param close_after Close the connection once the frame is written
+ * @return 0 on success, -1 if the connection is gone
+ */
+typedef int (*catzilla_ws_send_fn)(void* user_data, const char* header, size_t header_length,
+                                   const char* payload, size_t payload_length, bool close_after);
+
+/**
+ * Compute the Sec-WebSocket-Accept value for a handshake key
+ * @param key Sec-WebSocket-Key header value
+ * @param key_length Length of key
+ * @param accept Receives CATZILLA_WS_ACCEPT_LEN characters plus a NUL
+ */
+void catzilla_ws_accept_key(const char* key, size_t key_length, char accept[CATZILLA_WS_ACCEPT_LEN + 1]);
+
+/**
+ * @param key Sec-WebSocket-Key header value
+ * @param key_length Length of key
+ * @return Whether key is the base64 encoding of 16 bytes
+ */
+bool catzilla_ws_key_valid(const char* key, size_t key_length);
+
+/**
+ * Pick the first permessage-deflate offer of a Sec-WebSocket-Extensions
+ * header that can be accepted
+ * @param offers Header value
+ * @param length Length of offers
+ * @param params Receives the agreed parameters
+ * @param response Receives the extension to answer with, NUL-terminated
+ * @param response_size Size of response (128 bytes are enough)
+ * @return true if an offer was accepted; false otherwise, or without zlib
+ */
+bool catzilla_ws_negotiate_deflate(const char* offers, size_t length,
+                                   catzilla_ws_deflate_params_t* params,
+                                   char* response, size_t response_size);
+
+/**
+ * XOR data with a frame's masking key, 16 bytes at a time where SIMD is
+ * available
+ * @param data Bytes to unmask in place
+ * @param length Number of bytes
+ * @param mask Masking key
+ * @param offset Position of data[0] in the frame payload
+ */
+void catzilla_ws_unmask(uint8_t* data, size_t length, const uint8_t mask[4], uint64_t offset);
+
+/**
+ * Check UTF-8, skipping ASCII runs 16 bytes at a time. Overlong forms,
+ * surrogates and code points past U+10FFFF are rejected.
+ * @param data Bytes
+ * @param length Number of bytes
+ * @return Whether data is valid UTF-8
+ */
+bool catzilla_ws_utf8_valid(const uint8_t* data, size_t length);
+
+/**
+ * Create a session for a connection that completed the handshake
+ * @param on_message Called per message
+ * @param send Writes frames
+ * @param user_data Passed to both callbacks
+ * @param max_message_size Largest message accepted, after decompression; larger
+ *                         ones close the connection with 1009 (0 = unlimited)
+ * @param deflate Agreed permessage-deflate parameters (NULL = none)
+ * @return Session, or NULL when memory runs out
+ */
+catzilla_ws_session_t* catzilla_ws_session_create(catzilla_ws_message_fn on_message,
+                                                  catzilla_ws_send_fn send,
+                                                  void* user_data,
+                                                  size_t max_message_size,
+                                                  const catzilla_ws_deflate_params_t* deflate);
+
+/**
+ * Free a session
+ * @param session Session (NULL is ignored)
+ */
+void catzilla_ws_session_free(catzilla_ws_session_t* session);
+
+/**
+ * Feed received bytes. Pings are answered and the peer's close frame is
+ * echoed without involving the caller.
+ * @param session Session
+ * @param data Bytes read from the socket; unmasked in place
+ * @param length Number of bytes
+ * @return 0 to keep reading, -1 once the session is closed (a final close
+ *         frame is queued with close_after set, or the connection failed)
+ */
+int catzilla_ws_session_receive(catzilla_ws_session_t* session, char* data, size_t length);
+
+/**
+ * Send a text or binary message as one frame, compressed when deflate was
+ * agreed and the message is long enough
+ * @param session Session
+ * @param opcode CATZILLA_WS_OP_TEXT or CATZILLA_WS_OP_BINARY
+ * @param data Payload
+ * @param length Payload length
+ * @return 0 on success, -1 if the session is closing or the write failed
+ */
+int catzilla_ws_session_send(catzilla_ws_session_t* session, int opcode, const char* data, size_t length);
+
+/**
+ * Send a ping
+ * @param session Session
+ * @param data Payload (may be NULL)
+ * @param length At most CATZILLA_WS_MAX_CONTROL_PAYLOAD
+ * @return 0 on success, -1 on invalid arguments, if closing or the write failed
+ */
+int catzilla_ws_session_ping(catzilla_ws_session_t* session, const char* data, size_t length);
+
+/**
+ * Start the closing handshake. No more messages are sent; received ones are
+ * discarded until the peer answers with its close frame.
+ * @param session Session
+ * @param code Close code (0 = send no code)
+ * @param reason UTF-8 reason (may be NULL)
+ * @param length Reason length; cut to fit a control frame
+ * @return 0 on success, -1 if already closing or the write failed
+ */
+int catzilla_ws_session_close(catzilla_ws_session_t* session, int code, const char* reason, size_t length);
+
+/**
+ * @param session Session
+ * @return The session's state
+ */
+catzilla_ws_state_t catzilla_ws_session_state(const catzilla_ws_session_t* session);
+
+/**
+ * The close code the peer sent, or the one a protocol error failed the
+ * connection with
+ * @param session Session
+ * @param reason Receives the reason (not NUL-terminated; may be NULL)
+ * @param length Receives the reason length (may be NULL)
+ * @return Close code, CATZILLA_WS_CLOSE_NO_STATUS for a close frame without
+ *         one, or CATZILLA_WS_CLOSE_ABNORMAL if none was received
+ */
+int catzilla_ws_session_close_code(const catzilla_ws_session_t* session, const char** reason, size_t* length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CATZILLA_WEBSOCKET_H
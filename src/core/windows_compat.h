@@ -92,6 +92,10 @@
         #define unlink _unlink
     #endif
 
+    #ifndef close
+        #define close _close
+    #endif
+
     #ifndef getcwd
         #define getcwd _getcwd
     #endif
@@ -29,6 +29,8 @@
 #endif
 
 #include "async_bridge.h"
+#include "module_state.h"
+#include "../core/server.h"
 
 // For older Python versions that don't have PyCoroutine_Check
 #ifndef PyCoroutine_Check
@@ -37,7 +39,6 @@
 
 // Forward declarations
 typedef struct async_bridge_task_s async_bridge_task_t;
-typedef struct async_bridge_s async_bridge_t;
 
 // Task states for thread-safe state management
 typedef enum {
@@ -53,6 +54,7 @@ struct async_bridge_task_s {
     // libuv integration
     uv_async_t uv_async;           // libuv async handle for cross-thread communication
     uv_loop_t* uv_loop;           // Reference to main libuv loop
+    async_bridge_t* bridge;        // Bridge of the interpreter that started the task
 
     // Python objects (all access must be GIL-protected)
     PyObject* py_coroutine;        // The async handler coroutine
@@ -94,6 +96,7 @@ struct async_bridge_s {
     bool shutdown_requested;       // Shutdown flag
     bool loop_ready;               // Whether the asyncio loop is ready to accept work
     bool loop_initialization_complete; // Whether loop initialization has finished
+    bool thread_started;           // The asyncio thread starts with the first task
 
     // Task management
     async_bridge_task_t** active_tasks;  // Array of active tasks
@@ -106,22 +109,19 @@ struct async_bridge_s {
     uint64_t peak_concurrent_tasks;      // Peak concurrent task count
 };
 
-// Global bridge instance (singleton for simplicity)
-static async_bridge_t* g_async_bridge = NULL;
-static uv_once_t bridge_init_once = UV_ONCE_INIT;
-
 // ============================================================================
 // FORWARD DECLARATIONS
 // ============================================================================
 
 // Bridge lifecycle
-static void init_async_bridge_once(void);
+static async_bridge_t* async_bridge_create(void);
 static int async_bridge_init(async_bridge_t* bridge, uv_loop_t* main_loop);
 static void async_bridge_cleanup(async_bridge_t* bridge);
 static void asyncio_thread_main(void* arg);
+static int ensure_asyncio_thread(async_bridge_t* bridge);
 
 // Task management
-static async_bridge_task_t* async_task_create(PyObject* coroutine, PyObject* request);
+static async_bridge_task_t* async_task_create(async_bridge_t* bridge, PyObject* coroutine, PyObject* request);
 static void async_task_destroy(async_bridge_task_t* task);
 static void async_task_ref(async_bridge_task_t* task);
 static void async_task_unref(async_bridge_task_t* task);
@@ -160,22 +160,27 @@ static PyMethodDef coroutine_start_callback_method = {
 // ============================================================================
 
 /**
- * Initialize the async bridge system
- * This must be called once during Catzilla startup
+ * Initialize the async bridge of a module instance
+ * This must be called once during module initialization
  */
-int catzilla_async_bridge_init(uv_loop_t* main_loop) {
-    if (g_async_bridge != NULL) {
+int catzilla_async_bridge_init(catzilla_module_state_t* state, uv_loop_t* main_loop) {
+    if (state->async_bridge != NULL) {
         return 0; // Already initialized
     }
 
-    uv_once(&bridge_init_once, init_async_bridge_once);
-
-    if (g_async_bridge == NULL) {
+    async_bridge_t* bridge = async_bridge_create();
+    if (bridge == NULL) {
         log_async_error("Failed to initialize async bridge");
         return -1;
     }
 
-    return async_bridge_init(g_async_bridge, main_loop);
+    if (async_bridge_init(bridge, main_loop) != 0) {
+        async_bridge_cleanup(bridge);
+        free(bridge);
+        return -1;
+    }
+    state->async_bridge = bridge;
+    return 0;
 }
 
 /**
@@ -194,7 +199,10 @@ async_bridge_task_t* catzilla_execute_async_handler(
     void (*callback)(async_bridge_task_t* task, void* user_data),
     void* user_data
 ) {
-    if (!g_async_bridge || !g_async_bridge->is_running) {
+    catzilla_module_state_t* state = catzilla_get_module_state();
+    async_bridge_t* bridge = state ? catzilla_atomic_load_seq(&state->async_bridge) : NULL;
+    if (!bridge || !bridge->is_running) {
+        PyErr_Clear();
         log_async_error("Async bridge not initialized or not running");
         return NULL;
     }
@@ -204,8 +212,13 @@ async_bridge_task_t* catzilla_execute_async_handler(
         return NULL;
     }
 
+    if (ensure_asyncio_thread(bridge) != 0) {
+        log_async_error("Failed to start asyncio thread");
+        return NULL;
+    }
+
     // Create new task
-    async_bridge_task_t* task = async_task_create(coroutine, request);
+    async_bridge_task_t* task = async_task_create(bridge, coroutine, request);
     if (!task) {
         log_async_error("Failed to create async task");
         return NULL;
@@ -216,24 +229,24 @@ async_bridge_task_t* catzilla_execute_async_handler(
     task->user_data = user_data;
 
     // Check concurrent task limit
-    uv_mutex_lock(&g_async_bridge->bridge_mutex);
-    if (g_async_bridge->active_task_count >= g_async_bridge->max_concurrent_tasks) {
-        uv_mutex_unlock(&g_async_bridge->bridge_mutex);
+    uv_mutex_lock(&bridge->bridge_mutex);
+    if (bridge->active_task_count >= bridge->max_concurrent_tasks) {
+        uv_mutex_unlock(&bridge->bridge_mutex);
         log_async_error("Maximum concurrent tasks exceeded");
         async_task_destroy(task);
         return NULL;
     }
 
     // Add to active tasks
-    g_async_bridge->active_tasks[g_async_bridge->active_task_count] = task;
-    g_async_bridge->active_task_count++;
+    bridge->active_tasks[bridge->active_task_count] = task;
+    bridge->active_task_count++;
 
     // Update peak concurrent tasks
-    if (g_async_bridge->active_task_count > g_async_bridge->peak_concurrent_tasks) {
-        g_async_bridge->peak_concurrent_tasks = g_async_bridge->active_task_count;
+    if (bridge->active_task_count > bridge->peak_concurrent_tasks) {
+        bridge->peak_concurrent_tasks = bridge->active_task_count;
     }
 
-    uv_mutex_unlock(&g_async_bridge->bridge_mutex);
+    uv_mutex_unlock(&bridge->bridge_mutex);
 
     // Schedule coroutine execution in asyncio loop
     schedule_coroutine_completion(task);
@@ -304,22 +317,24 @@ uint64_t catzilla_async_task_get_duration(async_bridge_task_t* task) {
 }
 
 /**
- * Cleanup async bridge on shutdown
+ * Stop the asyncio thread of a module instance and free its bridge.
+ * Called with the GIL, while the interpreter can still run the thread.
  */
-void catzilla_async_bridge_shutdown(void) {
-    if (!g_async_bridge) {
+void catzilla_async_bridge_shutdown(catzilla_module_state_t* state) {
+    async_bridge_t* bridge = catzilla_atomic_take_ptr(&state->async_bridge);
+    if (!bridge) {
         return;
     }
 
-    uv_mutex_lock(&g_async_bridge->bridge_mutex);
-    g_async_bridge->shutdown_requested = true;
-    uv_mutex_unlock(&g_async_bridge->bridge_mutex);
+    uv_mutex_lock(&bridge->bridge_mutex);
+    bridge->shutdown_requested = true;
+    bool thread_started = bridge->thread_started;
+    uv_mutex_unlock(&bridge->bridge_mutex);
 
-    PyGILState_STATE gstate = PyGILState_Ensure();
-    if (g_async_bridge->asyncio_loop) {
-        PyObject* stop_method = PyObject_GetAttrString(g_async_bridge->asyncio_loop, "stop");
+    if (thread_started && bridge->asyncio_loop) {
+        PyObject* stop_method = PyObject_GetAttrString(bridge->asyncio_loop, "stop");
         PyObject* call_soon_threadsafe = PyObject_GetAttrString(
-            g_async_bridge->asyncio_loop,
+            bridge->asyncio_loop,
             "call_soon_threadsafe"
         );
 
@@ -330,57 +345,57 @@ void catzilla_async_bridge_shutdown(void) {
                 NULL
             );
             Py_XDECREF(stop_result);
-        } else {
-            PyErr_Clear();
         }
+        PyErr_Clear();
 
         Py_XDECREF(stop_method);
         Py_XDECREF(call_soon_threadsafe);
     }
-    PyGILState_Release(gstate);
 
-    // Wait for asyncio thread to shutdown
-    uv_thread_join(&g_async_bridge->asyncio_thread);
+    // Wait for asyncio thread to shutdown; it needs the GIL to get there
+    if (thread_started) {
+        Py_BEGIN_ALLOW_THREADS
+        uv_thread_join(&bridge->asyncio_thread);
+        Py_END_ALLOW_THREADS
+    }
 
-    async_bridge_cleanup(g_async_bridge);
-    free(g_async_bridge);
-    g_async_bridge = NULL;
+    async_bridge_cleanup(bridge);
+    free(bridge);
 }
 
 // ============================================================================
 // INTERNAL IMPLEMENTATION
 // ============================================================================
 
-static void init_async_bridge_once(void) {
-    g_async_bridge = calloc(1, sizeof(async_bridge_t));
-    if (!g_async_bridge) {
+static async_bridge_t* async_bridge_create(void) {
+    async_bridge_t* bridge = calloc(1, sizeof(async_bridge_t));
+    if (!bridge) {
         log_async_error("Failed to allocate async bridge");
-        return;
+        return NULL;
     }
 
     // Initialize mutex (libuv cross-platform)
-    if (uv_mutex_init(&g_async_bridge->bridge_mutex) != 0) {
-        free(g_async_bridge);
-        g_async_bridge = NULL;
+    if (uv_mutex_init(&bridge->bridge_mutex) != 0) {
+        free(bridge);
         log_async_error("Failed to initialize bridge mutex");
-        return;
+        return NULL;
     }
 
     // Initialize condition variable (libuv cross-platform)
-    if (uv_cond_init(&g_async_bridge->shutdown_cond) != 0) {
-        uv_mutex_destroy(&g_async_bridge->bridge_mutex);
-        free(g_async_bridge);
-        g_async_bridge = NULL;
+    if (uv_cond_init(&bridge->shutdown_cond) != 0) {
+        uv_mutex_destroy(&bridge->bridge_mutex);
+        free(bridge);
         log_async_error("Failed to initialize shutdown condition");
-        return;
+        return NULL;
     }
 
     // Set defaults
-    g_async_bridge->max_concurrent_tasks = 1000; // Configurable limit
-    g_async_bridge->is_running = false;
-    g_async_bridge->shutdown_requested = false;
-    g_async_bridge->loop_ready = false;
-    g_async_bridge->loop_initialization_complete = false;
+    bridge->max_concurrent_tasks = 1000; // Configurable limit
+    bridge->is_running = false;
+    bridge->shutdown_requested = false;
+    bridge->loop_ready = false;
+    bridge->loop_initialization_complete = false;
+    return bridge;
 }
 
 static int async_bridge_init(async_bridge_t* bridge, uv_loop_t* main_loop) {
@@ -390,13 +405,13 @@ static int async_bridge_init(async_bridge_t* bridge, uv_loop_t* main_loop) {
     // Store main loop reference
     bridge->main_loop = main_loop;
 
-    // Initialize Python/asyncio references (must be called with GIL held)
-    PyGILState_STATE gstate = PyGILState_Ensure();
+    // Initialize Python/asyncio references. Module init holds the GIL of
+    // its own interpreter, which PyGILState would not recognize in a
+    // sub-interpreter.
 
     // Import asyncio module
     bridge->asyncio_module = PyImport_ImportModule("asyncio");
     if (!bridge->asyncio_module) {
-        PyGILState_Release(gstate);
         log_async_error("Failed to import asyncio module");
         return -1;
     }
@@ -404,13 +419,10 @@ static int async_bridge_init(async_bridge_t* bridge, uv_loop_t* main_loop) {
     // Get Future class
     bridge->asyncio_future_class = PyObject_GetAttrString(bridge->asyncio_module, "Future");
     if (!bridge->asyncio_future_class) {
-        PyGILState_Release(gstate);
         log_async_error("Failed to get asyncio.Future class");
         return -1;
     }
 
-    PyGILState_Release(gstate);
-
     // Allocate active tasks array
     bridge->active_tasks = calloc(bridge->max_concurrent_tasks, sizeof(async_bridge_task_t*));
     if (!bridge->active_tasks) {
@@ -418,23 +430,43 @@ static int async_bridge_init(async_bridge_t* bridge, uv_loop_t* main_loop) {
         return -1;
     }
 
-    // Start asyncio thread (libuv cross-platform)
-    if (uv_thread_create(&bridge->asyncio_thread, asyncio_thread_main, bridge) != 0) {
-        log_async_error("Failed to create asyncio thread");
-        return -1;
-    }
-
+    // The asyncio thread is started by the first coroutine sent here: with
+    // handlers on the server's own loop, it may never be needed
     bridge->is_running = true;
 
     return 0;
 }
 
+// Start the asyncio thread once and wait until its loop accepts work. Called
+// with the GIL, which the new thread needs to create its loop.
+static int ensure_asyncio_thread(async_bridge_t* bridge) {
+    uv_mutex_lock(&bridge->bridge_mutex);
+    if (!bridge->thread_started) {
+        if (uv_thread_create(&bridge->asyncio_thread, asyncio_thread_main, bridge) != 0) {
+            uv_mutex_unlock(&bridge->bridge_mutex);
+            return -1;
+        }
+        bridge->thread_started = true;
+    }
+    bool ready = bridge->loop_initialization_complete;
+    uv_mutex_unlock(&bridge->bridge_mutex);
+
+    if (!ready) {
+        Py_BEGIN_ALLOW_THREADS
+        uv_mutex_lock(&bridge->bridge_mutex);
+        while (!bridge->loop_initialization_complete) {
+            uv_cond_wait(&bridge->shutdown_cond, &bridge->bridge_mutex);
+        }
+        uv_mutex_unlock(&bridge->bridge_mutex);
+        Py_END_ALLOW_THREADS
+    }
+    return bridge->loop_ready ? 0 : -1;
+}
+
+// Called with the GIL of the bridge's interpreter
 static void async_bridge_cleanup(async_bridge_t* bridge) {
     if (!bridge) return;
 
-    // Acquire GIL for cleanup
-    PyGILState_STATE gstate = PyGILState_Ensure();
-
     // Cleanup Python objects
     Py_XDECREF(bridge->asyncio_module);
     Py_XDECREF(bridge->asyncio_loop);
@@ -450,8 +482,6 @@ static void async_bridge_cleanup(async_bridge_t* bridge) {
     // Destroy synchronization primitives
     uv_mutex_destroy(&bridge->bridge_mutex);
     uv_cond_destroy(&bridge->shutdown_cond);
-
-    PyGILState_Release(gstate);
 }
 
 static void asyncio_thread_main(void* arg) {
@@ -471,7 +501,7 @@ static void asyncio_thread_main(void* arg) {
         uv_mutex_lock(&bridge->bridge_mutex);
         bridge->loop_ready = false;
         bridge->loop_initialization_complete = true;
-        uv_cond_signal(&bridge->shutdown_cond);
+        uv_cond_broadcast(&bridge->shutdown_cond);
         uv_mutex_unlock(&bridge->bridge_mutex);
         PyGILState_Release(gstate);
         return;
@@ -489,7 +519,7 @@ static void asyncio_thread_main(void* arg) {
     uv_mutex_lock(&bridge->bridge_mutex);
     bridge->loop_ready = true;
     bridge->loop_initialization_complete = true;
-    uv_cond_signal(&bridge->shutdown_cond);
+    uv_cond_broadcast(&bridge->shutdown_cond);
     uv_mutex_unlock(&bridge->bridge_mutex);
 
     // Run event loop until shutdown
@@ -502,7 +532,7 @@ static void asyncio_thread_main(void* arg) {
     PyGILState_Release(gstate);
 }
 
-static async_bridge_task_t* async_task_create(PyObject* coroutine, PyObject* request) {
+static async_bridge_task_t* async_task_create(async_bridge_t* bridge, PyObject* coroutine, PyObject* request) {
     async_bridge_task_t* task = calloc(1, sizeof(async_bridge_task_t));
     if (!task) {
         return NULL;
@@ -514,8 +544,13 @@ static async_bridge_task_t* async_task_create(PyObject* coroutine, PyObject* req
         return NULL;
     }
 
-    // Initialize libuv async handle
-    task->uv_loop = g_async_bridge->main_loop;
+    // Initialize libuv async handle on the loop serving this request, so the
+    // completion is delivered on the same loop as the client in worker mode
+    task->bridge = bridge;
+    task->uv_loop = catzilla_server_current_loop();
+    if (!task->uv_loop) {
+        task->uv_loop = bridge->main_loop;
+    }
     uv_async_init(task->uv_loop, &task->uv_async, on_async_completion);
     task->uv_async.data = task; // Store task reference in handle
 
@@ -603,18 +638,19 @@ static void on_async_completion(uv_async_t* handle) {
     }
 
     // Remove from active tasks
-    uv_mutex_lock(&g_async_bridge->bridge_mutex);
-    for (size_t i = 0; i < g_async_bridge->active_task_count; i++) {
-        if (g_async_bridge->active_tasks[i] == task) {
+    async_bridge_t* bridge = task->bridge;
+    uv_mutex_lock(&bridge->bridge_mutex);
+    for (size_t i = 0; i < bridge->active_task_count; i++) {
+        if (bridge->active_tasks[i] == task) {
             // Shift remaining tasks
-            memmove(&g_async_bridge->active_tasks[i],
-                    &g_async_bridge->active_tasks[i + 1],
-                    (g_async_bridge->active_task_count - i - 1) * sizeof(async_bridge_task_t*));
-            g_async_bridge->active_task_count--;
+            memmove(&bridge->active_tasks[i],
+                    &bridge->active_tasks[i + 1],
+                    (bridge->active_task_count - i - 1) * sizeof(async_bridge_task_t*));
+            bridge->active_task_count--;
             break;
         }
     }
-    uv_mutex_unlock(&g_async_bridge->bridge_mutex);
+    uv_mutex_unlock(&bridge->bridge_mutex);
 
     // Release reference (may destroy task)
     async_task_unref(task);
@@ -679,7 +715,7 @@ static PyObject* start_coroutine_on_loop(PyObject* self, PyObject* ignored) {
         Py_RETURN_NONE;
     }
 
-    PyObject* created_task = PyObject_CallMethod(g_async_bridge->asyncio_loop, "create_task", "O", task->py_coroutine);
+    PyObject* created_task = PyObject_CallMethod(task->bridge->asyncio_loop, "create_task", "O", task->py_coroutine);
     if (!created_task) {
         goto start_error;
     }
@@ -745,19 +781,20 @@ start_error:
 }
 
 static void schedule_coroutine_completion(async_bridge_task_t* task) {
+    async_bridge_t* bridge = task->bridge;
     PyGILState_STATE gstate = PyGILState_Ensure();
 
-    uv_mutex_lock(&g_async_bridge->bridge_mutex);
-    bool loop_ready = g_async_bridge->loop_ready;
-    uv_mutex_unlock(&g_async_bridge->bridge_mutex);
+    uv_mutex_lock(&bridge->bridge_mutex);
+    bool loop_ready = bridge->loop_ready;
+    uv_mutex_unlock(&bridge->bridge_mutex);
 
-    if (!loop_ready || !g_async_bridge->asyncio_loop) {
+    if (!loop_ready || !bridge->asyncio_loop) {
         PyErr_SetString(PyExc_RuntimeError, "Asyncio bridge loop is not ready");
         goto schedule_error;
     }
 
     PyObject* call_soon_threadsafe = PyObject_GetAttrString(
-        g_async_bridge->asyncio_loop,
+        bridge->asyncio_loop,
         "call_soon_threadsafe"
     );
     if (!call_soon_threadsafe) {
@@ -837,14 +874,427 @@ static const char* task_state_to_string(async_task_state_t state) {
     }
 }
 
-// Additional safety and cleanup functions would be implemented here...
+// ============================================================================
+// LOOP DRIVER: asyncio on the server's own libuv loop
+// ============================================================================
+//
+// catzilla.event_loop.CatzillaEventLoop is a SelectorEventLoop whose selector
+// is fed from here: sockets are watched with uv_poll, the next timer is a
+// uv_timer, and while callbacks are ready a uv_idle handle runs the loop's
+// tick without letting libuv block. Coroutines therefore run on the I/O
+// thread between reads, with no thread hop or GIL handoff.
+//
+// All handles are unreferenced: they never keep the server's loop alive. A
+// loop that shuts down closes the drivers still attached to it.
+
+typedef struct loop_driver_core_s loop_driver_core_t;
+typedef struct LoopDriver LoopDriver;
+
+typedef struct loop_driver_poll_s {
+    uv_poll_t handle;
+    loop_driver_core_t* core;
+    int fd;
+    int events;                       // Watched UV_READABLE | UV_WRITABLE
+    int ready;                        // Seen since the last take_events
+    bool queued;
+    struct loop_driver_poll_s* next_ready;
+    struct loop_driver_poll_s* prev;  // All of the core's watchers
+    struct loop_driver_poll_s* next;
+} loop_driver_poll_t;
+
+struct loop_driver_core_s {
+    uv_idle_t idle;
+    uv_timer_t timer;
+    uv_loop_t* loop;
+    LoopDriver* owner;                // NULL once the Python object is gone
+    PyObject* tick;                   // Returns the next timeout; NULL once closed
+    loop_driver_poll_t* polls;
+    loop_driver_poll_t* ready_head;
+    int open_handles;                 // The core is freed when both are closed
+    struct loop_driver_core_s* next_core;
+};
 
-/**
- * Cleanup the async bridge system.
- * Should be called during module shutdown.
- */
-void catzilla_async_bridge_cleanup(void) {
-    if (g_async_bridge) {
-        catzilla_async_bridge_shutdown();
+struct LoopDriver {
+    PyObject_HEAD
+    loop_driver_core_t* core;
+    PyObject* polls;                  // fd -> capsule of its loop_driver_poll_t
+};
+
+// Cores not yet closed, across all loops
+static loop_driver_core_t* loop_driver_cores = NULL;
+static uv_mutex_t loop_driver_mutex;
+static uv_once_t loop_driver_once = UV_ONCE_INIT;
+
+static void init_loop_driver_mutex(void) {
+    uv_mutex_init(&loop_driver_mutex);
+}
+
+#define LOOP_DRIVER_POLL_CAPSULE "catzilla.loop_driver_poll"
+
+static void on_driver_idle(uv_idle_t* handle);
+
+// Keep libuv polling without blocking until the tick reports nothing ready,
+// or sleep until the next timer
+static void arm_loop_driver(loop_driver_core_t* core, double timeout) {
+    if (timeout == 0.0) {
+        uv_timer_stop(&core->timer);
+        uv_idle_start(&core->idle, on_driver_idle);
+        return;
+    }
+    uv_idle_stop(&core->idle);
+    if (timeout > 0.0) {
+        uint64_t ms = (uint64_t)(timeout * 1000.0);
+        if ((double)ms < timeout * 1000.0) ms++;  // Never wake before the timer is due
+        uv_timer_start(&core->timer, (uv_timer_cb)on_driver_idle, ms, 0);
+    } else {
+        uv_timer_stop(&core->timer);
+    }
+}
+
+// Runs from the idle and timer handles
+static void on_driver_idle(uv_idle_t* handle) {
+    loop_driver_core_t* core = (loop_driver_core_t*)handle->data;
+    if (!core->tick) return;
+
+    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyObject* tick = core->tick;
+    Py_INCREF(tick);
+    PyObject* result = PyObject_CallNoArgs(tick);
+    Py_DECREF(tick);
+
+    double timeout = -1.0;
+    if (!result) {
+        PyErr_Print();
+    } else {
+        if (result != Py_None) {
+            timeout = PyFloat_AsDouble(result);
+            if (timeout == -1.0 && PyErr_Occurred()) {
+                PyErr_Print();
+            }
+        }
+        Py_DECREF(result);
+    }
+    PyGILState_Release(gstate);
+
+    // The tick may have closed the loop
+    if (core->tick) {
+        arm_loop_driver(core, timeout);
+    }
+}
+
+static void on_driver_poll(uv_poll_t* handle, int status, int events) {
+    loop_driver_poll_t* poll = (loop_driver_poll_t*)handle->data;
+    loop_driver_core_t* core = poll->core;
+
+    // An error (a reset socket) is reported to every watcher, which then
+    // finds it out from the socket itself
+    int ready = status < 0 ? poll->events : (events & poll->events);
+    if (!ready) return;
+
+    poll->ready |= ready;
+    if (!poll->queued) {
+        poll->queued = true;
+        poll->next_ready = core->ready_head;
+        core->ready_head = poll;
+    }
+    uv_idle_start(&core->idle, on_driver_idle);
+}
+
+static void unqueue_driver_poll(loop_driver_poll_t* poll) {
+    if (!poll->queued) return;
+    loop_driver_poll_t** link = &poll->core->ready_head;
+    while (*link && *link != poll) {
+        link = &(*link)->next_ready;
     }
+    if (*link) *link = poll->next_ready;
+    poll->queued = false;
+    poll->ready = 0;
+}
+
+static void on_driver_poll_closed(uv_handle_t* handle) {
+    free(handle->data);
+}
+
+static void on_driver_handle_closed(uv_handle_t* handle) {
+    loop_driver_core_t* core = (loop_driver_core_t*)handle->data;
+    if (--core->open_handles == 0) {
+        free(core);
+    }
+}
+
+static void close_driver_poll(loop_driver_poll_t* poll) {
+    loop_driver_core_t* core = poll->core;
+    unqueue_driver_poll(poll);
+    if (poll->prev) poll->prev->next = poll->next;
+    else core->polls = poll->next;
+    if (poll->next) poll->next->prev = poll->prev;
+    uv_close((uv_handle_t*)&poll->handle, on_driver_poll_closed);
+}
+
+// Close every handle of a core; its driver, if still alive, is left closed.
+// Needs the GIL and the core's loop thread.
+static void close_driver_core(loop_driver_core_t* core) {
+    uv_mutex_lock(&loop_driver_mutex);
+    loop_driver_core_t** link = &loop_driver_cores;
+    while (*link && *link != core) {
+        link = &(*link)->next_core;
+    }
+    if (*link) *link = core->next_core;
+    uv_mutex_unlock(&loop_driver_mutex);
+
+    if (core->owner) {
+        core->owner->core = NULL;
+        PyDict_Clear(core->owner->polls);
+        core->owner = NULL;
+    }
+    while (core->polls) {
+        close_driver_poll(core->polls);
+    }
+    Py_CLEAR(core->tick);
+    uv_close((uv_handle_t*)&core->idle, on_driver_handle_closed);
+    uv_close((uv_handle_t*)&core->timer, on_driver_handle_closed);
+}
+
+// Loop exit hook: close the drivers attached to a loop before the server
+// closes whatever handles remain
+static void detach_loop_drivers(uv_loop_t* loop) {
+    if (!Py_IsInitialized()) return;
+
+    PyGILState_STATE gstate = PyGILState_Ensure();
+    for (;;) {
+        uv_mutex_lock(&loop_driver_mutex);
+        loop_driver_core_t* core = loop_driver_cores;
+        while (core && core->loop != loop) {
+            core = core->next_core;
+        }
+        uv_mutex_unlock(&loop_driver_mutex);
+        if (!core) break;
+        close_driver_core(core);
+    }
+    PyGILState_Release(gstate);
+}
+
+static PyObject* LoopDriver_new(PyTypeObject* type, PyObject* args, PyObject* kwds) {
+    (void)kwds;
+    PyObject* tick;
+    if (!PyArg_ParseTuple(args, "O", &tick))
+        return NULL;
+    if (!PyCallable_Check(tick)) {
+        PyErr_SetString(PyExc_TypeError, "tick must be callable");
+        return NULL;
+    }
+
+    // Attached to the loop serving the calling thread
+    uv_loop_t* loop = catzilla_server_current_loop();
+    if (!loop) loop = uv_default_loop();
+
+    LoopDriver* self = (LoopDriver*)type->tp_alloc(type, 0);
+    if (!self) return NULL;
+    self->polls = PyDict_New();
+    self->core = calloc(1, sizeof(loop_driver_core_t));
+    if (!self->polls || !self->core) {
+        free(self->core);
+        self->core = NULL;
+        Py_DECREF(self);
+        return PyErr_NoMemory();
+    }
+
+    loop_driver_core_t* core = self->core;
+    uv_idle_init(loop, &core->idle);
+    uv_timer_init(loop, &core->timer);
+    core->idle.data = core;
+    core->timer.data = core;
+    uv_unref((uv_handle_t*)&core->idle);
+    uv_unref((uv_handle_t*)&core->timer);
+    core->open_handles = 2;
+    core->loop = loop;
+    core->owner = self;
+    Py_INCREF(tick);
+    core->tick = tick;
+
+    uv_mutex_lock(&loop_driver_mutex);
+    core->next_core = loop_driver_cores;
+    loop_driver_cores = core;
+    uv_mutex_unlock(&loop_driver_mutex);
+    return (PyObject*)self;
+}
+
+// Stop every watcher and release the handles; the tick is not called again
+static PyObject* LoopDriver_close(LoopDriver* self, PyObject* Py_UNUSED(ignored)) {
+    if (self->core) {
+        close_driver_core(self->core);
+    }
+    Py_RETURN_NONE;
+}
+
+static void LoopDriver_dealloc(LoopDriver* self) {
+    // A driver is closed by its event loop. One that was not may be freed on
+    // any thread, so its handles are left for its loop's exit to close.
+    if (self->core) {
+        self->core->owner = NULL;
+        Py_CLEAR(self->core->tick);
+    }
+    Py_XDECREF(self->polls);
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static PyObject* driver_closed_error(void) {
+    PyErr_SetString(PyExc_RuntimeError, "Loop driver is closed");
+    return NULL;
+}
+
+// poke() - run the tick soon, without waiting for I/O
+static PyObject* LoopDriver_poke(LoopDriver* self, PyObject* Py_UNUSED(ignored)) {
+    if (!self->core) return driver_closed_error();
+    uv_idle_start(&self->core->idle, on_driver_idle);
+    Py_RETURN_NONE;
+}
+
+// watch(fd, events) - watch a socket for selectors.EVENT_READ/EVENT_WRITE (0 = stop)
+static PyObject* LoopDriver_watch(LoopDriver* self, PyObject* args) {
+    int fd;
+    int events;
+    if (!PyArg_ParseTuple(args, "ii", &fd, &events))
+        return NULL;
+    if (!self->core) {
+        // close() already stopped every watcher
+        if (events == 0) Py_RETURN_NONE;
+        return driver_closed_error();
+    }
+
+    PyObject* key = PyLong_FromLong(fd);
+    if (!key) return NULL;
+    PyObject* capsule = PyDict_GetItemWithError(self->polls, key);
+    if (!capsule && PyErr_Occurred()) {
+        Py_DECREF(key);
+        return NULL;
+    }
+    loop_driver_poll_t* poll = capsule ? PyCapsule_GetPointer(capsule, LOOP_DRIVER_POLL_CAPSULE) : NULL;
+
+    int uv_events = ((events & 1) ? UV_READABLE : 0) | ((events & 2) ? UV_WRITABLE : 0);
+    if (uv_events == 0) {
+        if (poll) {
+            close_driver_poll(poll);
+            PyDict_DelItem(self->polls, key);
+        }
+        Py_DECREF(key);
+        Py_RETURN_NONE;
+    }
+
+    if (!poll) {
+        poll = calloc(1, sizeof(*poll));
+        if (!poll) {
+            Py_DECREF(key);
+            return PyErr_NoMemory();
+        }
+        int rc = uv_poll_init_socket(self->core->idle.loop, &poll->handle, (uv_os_sock_t)fd);
+        if (rc != 0) {
+            free(poll);
+            Py_DECREF(key);
+            PyErr_Format(PyExc_OSError, "Cannot watch fd %d: %s", fd, uv_strerror(rc));
+            return NULL;
+        }
+        poll->handle.data = poll;
+        poll->core = self->core;
+        poll->fd = fd;
+        uv_unref((uv_handle_t*)&poll->handle);
+        poll->next = self->core->polls;
+        if (poll->next) poll->next->prev = poll;
+        self->core->polls = poll;
+
+        capsule = PyCapsule_New(poll, LOOP_DRIVER_POLL_CAPSULE, NULL);
+        if (!capsule || PyDict_SetItem(self->polls, key, capsule) < 0) {
+            Py_XDECREF(capsule);
+            Py_DECREF(key);
+            close_driver_poll(poll);
+            return NULL;
+        }
+        Py_DECREF(capsule);
+    }
+    Py_DECREF(key);
+
+    // Readiness of events no longer watched is dropped
+    poll->events = uv_events;
+    poll->ready &= uv_events;
+    int rc = uv_poll_start(&poll->handle, uv_events, on_driver_poll);
+    if (rc != 0) {
+        PyErr_Format(PyExc_OSError, "Cannot watch fd %d: %s", fd, uv_strerror(rc));
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+// take_events() -> [(fd, events)] seen since the last call
+static PyObject* LoopDriver_take_events(LoopDriver* self, PyObject* Py_UNUSED(ignored)) {
+    PyObject* events = PyList_New(0);
+    if (!events || !self->core) return events;
+
+    loop_driver_poll_t* poll = self->core->ready_head;
+    self->core->ready_head = NULL;
+    while (poll) {
+        loop_driver_poll_t* next = poll->next_ready;
+        int mask = ((poll->ready & UV_READABLE) ? 1 : 0) | ((poll->ready & UV_WRITABLE) ? 2 : 0);
+        poll->queued = false;
+        poll->ready = 0;
+        poll->next_ready = NULL;
+
+        PyObject* item = mask ? Py_BuildValue("(ii)", poll->fd, mask) : NULL;
+        if (mask && (!item || PyList_Append(events, item) < 0)) {
+            Py_XDECREF(item);
+            Py_DECREF(events);
+            return NULL;
+        }
+        Py_XDECREF(item);
+        poll = next;
+    }
+    return events;
+}
+
+static PyMethodDef LoopDriver_methods[] = {
+    {"poke", (PyCFunction)LoopDriver_poke, METH_NOARGS,
+     "Run the tick on the next loop iteration"},
+    {"watch", (PyCFunction)LoopDriver_watch, METH_VARARGS,
+     "Watch a socket for EVENT_READ/EVENT_WRITE; 0 stops watching"},
+    {"take_events", (PyCFunction)LoopDriver_take_events, METH_NOARGS,
+     "Return (fd, events) pairs that became ready since the last call"},
+    {"close", (PyCFunction)LoopDriver_close, METH_NOARGS,
+     "Stop all watchers; must run on the loop thread"},
+    {NULL}  // Sentinel
+};
+
+static PyObject* LoopDriver_get_closed(LoopDriver* self, void* closure) {
+    (void)closure;
+    return PyBool_FromLong(self->core == NULL);
+}
+
+static PyGetSetDef LoopDriver_getset[] = {
+    {"closed", (getter)LoopDriver_get_closed, NULL,
+     "Whether close() ran or the loop the driver was attached to shut down", NULL},
+    {NULL}  // Sentinel
+};
+
+static PyTypeObject LoopDriverType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "catzilla._catzilla.LoopDriver",
+    .tp_doc = "Drives an asyncio event loop from the libuv loop of the calling thread",
+    .tp_basicsize = sizeof(LoopDriver),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = LoopDriver_new,
+    .tp_dealloc = (destructor)LoopDriver_dealloc,
+    .tp_methods = LoopDriver_methods,
+    .tp_getset = LoopDriver_getset,
+};
+
+int catzilla_loop_driver_register(PyObject* module) {
+    uv_once(&loop_driver_once, init_loop_driver_mutex);
+    if (PyType_Ready(&LoopDriverType) < 0)
+        return -1;
+    Py_INCREF(&LoopDriverType);
+    if (PyModule_AddObject(module, "LoopDriver", (PyObject*)&LoopDriverType) < 0) {
+        Py_DECREF(&LoopDriverType);
+        return -1;
+    }
+    catzilla_server_set_loop_exit_hook(detach_loop_drivers);
+    return 0;
 }
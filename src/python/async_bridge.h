@@ -12,6 +12,7 @@
 #include <uv.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include "module_state.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -38,22 +39,17 @@ typedef struct {
 // ============================================================================
 
 /**
- * Initialize the async bridge system.
+ * Initialize the async bridge of a module instance.
  * Must be called once during module initialization.
  *
- * @param main_loop The main libuv event loop (can be NULL to create default loop)
+ * @param state State of the module being initialized; receives the bridge
+ * @param main_loop The main libuv event loop
  * @return 0 on success, -1 on failure
  */
-int catzilla_async_bridge_init(uv_loop_t* main_loop);
+int catzilla_async_bridge_init(catzilla_module_state_t* state, uv_loop_t* main_loop);
 
 /**
- * Cleanup the async bridge system.
- * Should be called during module shutdown.
- */
-void catzilla_async_bridge_cleanup(void);
-
-/**
- * Execute an async Python handler
+ * Execute an async Python handler on the calling interpreter's bridge
  *
  * @param coroutine Python coroutine object (result of calling async def function)
  * @param request Request object to pass to the handler
@@ -110,10 +106,21 @@ int catzilla_async_bridge_get_stats(async_bridge_stats_t* stats);
 bool catzilla_is_coroutine(PyObject* obj);
 
 /**
- * Shutdown the async bridge system
- * Should be called during Catzilla shutdown
+ * Add the LoopDriver type, which runs catzilla.event_loop's asyncio loop on
+ * the libuv loop of the thread that creates it
+ *
+ * @param module Module to add the type to
+ * @return 0 on success, -1 with an exception set
+ */
+int catzilla_loop_driver_register(PyObject* module);
+
+/**
+ * Stop the asyncio thread of a module instance and free its bridge.
+ * Must be called with the GIL before the interpreter finalizes (atexit).
+ *
+ * @param state Module state holding the bridge
  */
-void catzilla_async_bridge_shutdown(void);
+void catzilla_async_bridge_shutdown(catzilla_module_state_t* state);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,527 @@
+/*
+ * Catzilla JSON Serializer - Python objects to JSON in one pass
+ *
+ * Handler results are walked once and written straight into a growable
+ * response arena buffer. The common types (str, int, float, bool, None, dict,
+ * list, tuple) are handled inline; the types handlers return from databases
+ * and models (datetime, UUID, Decimal, model_dump()) without costing a Python
+ * default= callback per value.
+ */
+
+#include <Python.h>
+#include <datetime.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "json_serializer.h"
+#include "module_state.h"
+#include "../core/memory.h"
+#include "../core/platform_compat.h"
+
+#define JSON_MIN_CAPACITY 256
+
+// Size of the last response produced on this thread; handlers tend to return
+// similar payloads, so the next buffer starts there instead of doubling up
+static CATZILLA_THREAD_LOCAL size_t json_size_hint = 0;
+
+// Buffer kept between catzilla_json_dumps calls on this thread
+static CATZILLA_THREAD_LOCAL catzilla_json_buffer_t json_scratch = { NULL, 0, 0 };
+
+// Bytes that cannot appear unescaped inside a JSON string
+static const uint8_t json_escape[256] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,   // '"'
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0,   // '\\'
+};
+
+static const char hex_digits[] = "0123456789abcdef";
+
+static int write_value(catzilla_json_buffer_t* buffer, PyObject* obj);
+
+// ============================================================================
+// BUFFER
+// ============================================================================
+
+static int buffer_reserve(catzilla_json_buffer_t* buffer, size_t extra) {
+    if (buffer->capacity - buffer->length >= extra) {
+        return 0;
+    }
+
+    size_t capacity = buffer->capacity;
+    if (capacity < JSON_MIN_CAPACITY) {
+        capacity = json_size_hint > JSON_MIN_CAPACITY ? json_size_hint : JSON_MIN_CAPACITY;
+    }
+    while (capacity - buffer->length < extra) {
+        if (capacity > SIZE_MAX / 2) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        capacity *= 2;
+    }
+
+    char* data = catzilla_response_realloc(buffer->data, capacity);
+    if (!data) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    buffer->data = data;
+    buffer->capacity = capacity;
+    return 0;
+}
+
+static inline int buffer_append(catzilla_json_buffer_t* buffer, const char* data, size_t length) {
+    if (buffer_reserve(buffer, length) != 0) {
+        return -1;
+    }
+    memcpy(buffer->data + buffer->length, data, length);
+    buffer->length += length;
+    return 0;
+}
+
+static inline int buffer_putc(catzilla_json_buffer_t* buffer, char c) {
+    if (buffer->length == buffer->capacity && buffer_reserve(buffer, 1) != 0) {
+        return -1;
+    }
+    buffer->data[buffer->length++] = c;
+    return 0;
+}
+
+#define buffer_literal(buffer, text) buffer_append((buffer), (text), sizeof(text) - 1)
+
+void catzilla_json_buffer_release(catzilla_json_buffer_t* buffer) {
+    if (!buffer) return;
+    catzilla_response_free(buffer->data);
+    buffer->data = NULL;
+    buffer->length = 0;
+    buffer->capacity = 0;
+}
+
+// ============================================================================
+// SCALARS
+// ============================================================================
+
+static int write_utf8_string(catzilla_json_buffer_t* buffer, const char* text, size_t length) {
+    // Room for the quotes and the unescaped bytes; escapes reserve as they go
+    if (buffer_reserve(buffer, length + 2) != 0) {
+        return -1;
+    }
+    buffer->data[buffer->length++] = '"';
+
+    const uint8_t* p = (const uint8_t*)text;
+    const uint8_t* end = p + length;
+    while (p < end) {
+        const uint8_t* run = p;
+        while (p < end && !json_escape[*p]) {
+            p++;
+        }
+        if (buffer_append(buffer, (const char*)run, (size_t)(p - run)) != 0) {
+            return -1;
+        }
+        if (p == end) {
+            break;
+        }
+
+        uint8_t c = *p++;
+        char escape[6] = { '\\', 0, 0, 0, 0, 0 };
+        size_t escape_length = 2;
+        switch (c) {
+            case '"':  escape[1] = '"'; break;
+            case '\\': escape[1] = '\\'; break;
+            case '\b': escape[1] = 'b'; break;
+            case '\f': escape[1] = 'f'; break;
+            case '\n': escape[1] = 'n'; break;
+            case '\r': escape[1] = 'r'; break;
+            case '\t': escape[1] = 't'; break;
+            default:
+                escape[1] = 'u';
+                escape[2] = '0';
+                escape[3] = '0';
+                escape[4] = hex_digits[c >> 4];
+                escape[5] = hex_digits[c & 0xF];
+                escape_length = 6;
+                break;
+        }
+        // Keep the closing quote's reservation intact
+        if (buffer_reserve(buffer, escape_length + (size_t)(end - p) + 1) != 0) {
+            return -1;
+        }
+        memcpy(buffer->data + buffer->length, escape, escape_length);
+        buffer->length += escape_length;
+    }
+
+    return buffer_putc(buffer, '"');
+}
+
+static int write_string(catzilla_json_buffer_t* buffer, PyObject* obj) {
+    Py_ssize_t length;
+    const char* text = PyUnicode_AsUTF8AndSize(obj, &length);
+    if (!text) {
+        return -1;
+    }
+    return write_utf8_string(buffer, text, (size_t)length);
+}
+
+// str(obj) written as a JSON string
+static int write_str_of(catzilla_json_buffer_t* buffer, PyObject* obj, const char* method) {
+    PyObject* text = method ? PyObject_CallMethod(obj, method, NULL) : PyObject_Str(obj);
+    if (!text) {
+        return -1;
+    }
+    int rc;
+    if (PyUnicode_Check(text)) {
+        rc = write_string(buffer, text);
+    } else {
+        PyErr_Format(PyExc_TypeError, "%s() returned %.200s, not str",
+                     method ? method : "__str__", Py_TYPE(text)->tp_name);
+        rc = -1;
+    }
+    Py_DECREF(text);
+    return rc;
+}
+
+static int write_long(catzilla_json_buffer_t* buffer, PyObject* obj) {
+    int overflow = 0;
+    long long value = PyLong_AsLongLongAndOverflow(obj, &overflow);
+    if (value == -1 && PyErr_Occurred()) {
+        return -1;
+    }
+
+    if (!overflow) {
+        char digits[24];
+        int length = snprintf(digits, sizeof(digits), "%lld", value);
+        return buffer_append(buffer, digits, (size_t)length);
+    }
+
+    // Arbitrary precision; int.__repr__ also ignores subclass overrides as json does
+    PyObject* text = PyLong_Type.tp_repr(obj);
+    if (!text) {
+        return -1;
+    }
+    Py_ssize_t length;
+    const char* digits = PyUnicode_AsUTF8AndSize(text, &length);
+    int rc = digits ? buffer_append(buffer, digits, (size_t)length) : -1;
+    Py_DECREF(text);
+    return rc;
+}
+
+static int write_double(catzilla_json_buffer_t* buffer, double value) {
+    if (isnan(value)) {
+        return buffer_literal(buffer, "NaN");
+    }
+    if (isinf(value)) {
+        return value > 0 ? buffer_literal(buffer, "Infinity") : buffer_literal(buffer, "-Infinity");
+    }
+
+    // Shortest repr, the same digits float.__repr__ gives
+    char* text = PyOS_double_to_string(value, 'r', 0, Py_DTSF_ADD_DOT_0, NULL);
+    if (!text) {
+        return -1;
+    }
+    int rc = buffer_append(buffer, text, strlen(text));
+    PyMem_Free(text);
+    return rc;
+}
+
+// Decimals are written as exact numbers rather than through float
+static int write_decimal(catzilla_json_buffer_t* buffer, PyObject* obj) {
+    PyObject* text = PyObject_Str(obj);
+    if (!text) {
+        return -1;
+    }
+    Py_ssize_t length;
+    const char* digits = PyUnicode_AsUTF8AndSize(text, &length);
+    int rc;
+    if (!digits) {
+        rc = -1;
+    } else if (strstr(digits, "Infinity")) {
+        rc = digits[0] == '-' ? buffer_literal(buffer, "-Infinity") : buffer_literal(buffer, "Infinity");
+    } else if (strstr(digits, "NaN")) {
+        rc = buffer_literal(buffer, "NaN");
+    } else {
+        rc = buffer_append(buffer, digits, (size_t)length);
+    }
+    Py_DECREF(text);
+    return rc;
+}
+
+// ============================================================================
+// CONTAINERS
+// ============================================================================
+
+static int write_key(catzilla_json_buffer_t* buffer, PyObject* key) {
+    if (PyUnicode_Check(key)) {
+        return write_string(buffer, key);
+    }
+    if (key == Py_True) {
+        return buffer_literal(buffer, "\"true\"");
+    }
+    if (key == Py_False) {
+        return buffer_literal(buffer, "\"false\"");
+    }
+    if (key == Py_None) {
+        return buffer_literal(buffer, "\"null\"");
+    }
+    if (PyLong_Check(key) || PyFloat_Check(key)) {
+        int rc = buffer_putc(buffer, '"');
+        if (rc == 0) {
+            rc = PyLong_Check(key) ? write_long(buffer, key) : write_double(buffer, PyFloat_AS_DOUBLE(key));
+        }
+        return rc == 0 ? buffer_putc(buffer, '"') : -1;
+    }
+
+    PyErr_Format(PyExc_TypeError, "keys must be str, int, float, bool or None, not %.100s",
+                 Py_TYPE(key)->tp_name);
+    return -1;
+}
+
+static int write_dict(catzilla_json_buffer_t* buffer, PyObject* obj) {
+    if (PyDict_GET_SIZE(obj) == 0) {
+        return buffer_literal(buffer, "{}");
+    }
+    if (buffer_putc(buffer, '{') != 0) {
+        return -1;
+    }
+
+    Py_ssize_t pos = 0;
+    PyObject* key;
+    PyObject* value;
+    bool first = true;
+    while (PyDict_Next(obj, &pos, &key, &value)) {
+        // Serializing a value can run Python code that mutates the dict
+        Py_INCREF(key);
+        Py_INCREF(value);
+        int rc = first ? 0 : buffer_putc(buffer, ',');
+        if (rc == 0) rc = write_key(buffer, key);
+        if (rc == 0) rc = buffer_putc(buffer, ':');
+        if (rc == 0) rc = write_value(buffer, value);
+        Py_DECREF(key);
+        Py_DECREF(value);
+        if (rc != 0) {
+            return -1;
+        }
+        first = false;
+    }
+
+    return buffer_putc(buffer, '}');
+}
+
+static int write_sequence(catzilla_json_buffer_t* buffer, PyObject* obj) {
+    bool is_list = PyList_Check(obj);
+    Py_ssize_t size = is_list ? PyList_GET_SIZE(obj) : PyTuple_GET_SIZE(obj);
+    if (size == 0) {
+        return buffer_literal(buffer, "[]");
+    }
+    if (buffer_putc(buffer, '[') != 0) {
+        return -1;
+    }
+
+    // Lists can shrink while their items are serialized, so re-read the size
+    for (Py_ssize_t i = 0; i < (is_list ? PyList_GET_SIZE(obj) : size); i++) {
+        PyObject* item = is_list ? PyList_GET_ITEM(obj, i) : PyTuple_GET_ITEM(obj, i);
+        Py_INCREF(item);
+        int rc = i == 0 ? 0 : buffer_putc(buffer, ',');
+        if (rc == 0) rc = write_value(buffer, item);
+        Py_DECREF(item);
+        if (rc != 0) {
+            return -1;
+        }
+    }
+
+    return buffer_putc(buffer, ']');
+}
+
+// ============================================================================
+// OTHER TYPES
+// ============================================================================
+
+static PyObject* import_type(const char* module_name, const char* type_name) {
+    PyObject* module = PyImport_ImportModule(module_name);
+    if (!module) {
+        PyErr_Clear();
+        return NULL;
+    }
+    PyObject* type = PyObject_GetAttrString(module, type_name);
+    Py_DECREF(module);
+    if (!type || !PyType_Check(type)) {
+        PyErr_Clear();
+        Py_XDECREF(type);
+        return NULL;
+    }
+    return type;
+}
+
+// Threads that race here each import the type; the first one published wins
+static void publish_type(PyObject** slot, PyObject* type) {
+    if (type && catzilla_atomic_publish_ptr(slot, type) != type) {
+        Py_DECREF(type);
+    }
+}
+
+static void load_optional_types(catzilla_module_state_t* state) {
+    if (catzilla_atomic_load_seq(&state->json_optional_types_loaded)) return;
+    publish_type(&state->json_uuid_type, import_type("uuid", "UUID"));
+    publish_type(&state->json_decimal_type, import_type("decimal", "Decimal"));
+    catzilla_atomic_store_seq(&state->json_optional_types_loaded, 1);
+}
+
+static int write_model(catzilla_json_buffer_t* buffer, PyObject* model_dump) {
+    PyObject* data = PyObject_CallObject(model_dump, NULL);
+    if (!data) {
+        return -1;
+    }
+    int rc = write_value(buffer, data);
+    Py_DECREF(data);
+    return rc;
+}
+
+static int write_other(catzilla_json_buffer_t* buffer, PyObject* obj) {
+    if (PyDateTimeAPI && (PyDateTime_Check(obj) || PyDate_Check(obj) || PyTime_Check(obj))) {
+        return write_str_of(buffer, obj, "isoformat");
+    }
+
+    catzilla_module_state_t* state = catzilla_get_module_state();
+    if (!state) {
+        return -1;
+    }
+    load_optional_types(state);
+    PyObject* uuid_type = catzilla_atomic_load_seq(&state->json_uuid_type);
+    if (uuid_type && PyObject_TypeCheck(obj, (PyTypeObject*)uuid_type)) {
+        return write_str_of(buffer, obj, NULL);
+    }
+    PyObject* decimal_type = catzilla_atomic_load_seq(&state->json_decimal_type);
+    if (decimal_type && PyObject_TypeCheck(obj, (PyTypeObject*)decimal_type)) {
+        return write_decimal(buffer, obj);
+    }
+
+    PyObject* model_dump = PyObject_GetAttr(obj, state->json_model_dump_name);
+    if (model_dump) {
+        int rc;
+        if (PyCallable_Check(model_dump)) {
+            rc = write_model(buffer, model_dump);
+        } else {
+            PyErr_Format(PyExc_TypeError, "Object of type %.100s is not JSON serializable",
+                         Py_TYPE(obj)->tp_name);
+            rc = -1;
+        }
+        Py_DECREF(model_dump);
+        return rc;
+    }
+    if (!PyErr_ExceptionMatches(PyExc_AttributeError)) {
+        return -1;
+    }
+    PyErr_Clear();
+
+    PyErr_Format(PyExc_TypeError, "Object of type %.100s is not JSON serializable",
+                 Py_TYPE(obj)->tp_name);
+    return -1;
+}
+
+// ============================================================================
+// ENTRY POINTS
+// ============================================================================
+
+static int write_value(catzilla_json_buffer_t* buffer, PyObject* obj) {
+    if (PyUnicode_Check(obj)) {
+        return write_string(buffer, obj);
+    }
+    if (obj == Py_None) {
+        return buffer_literal(buffer, "null");
+    }
+    if (obj == Py_True) {
+        return buffer_literal(buffer, "true");
+    }
+    if (obj == Py_False) {
+        return buffer_literal(buffer, "false");
+    }
+    if (PyLong_Check(obj)) {
+        return write_long(buffer, obj);
+    }
+    if (PyFloat_Check(obj)) {
+        return write_double(buffer, PyFloat_AS_DOUBLE(obj));
+    }
+
+    // Everything below can nest
+    if (Py_EnterRecursiveCall(" while encoding a JSON object")) {
+        return -1;
+    }
+    int rc;
+    if (PyDict_Check(obj)) {
+        rc = write_dict(buffer, obj);
+    } else if (PyList_Check(obj) || PyTuple_Check(obj)) {
+        rc = write_sequence(buffer, obj);
+    } else {
+        rc = write_other(buffer, obj);
+    }
+    Py_LeaveRecursiveCall();
+    return rc;
+}
+
+int catzilla_json_serializer_init(catzilla_module_state_t* state) {
+    if (!state->json_model_dump_name) {
+        state->json_model_dump_name = PyUnicode_InternFromString("model_dump");
+        if (!state->json_model_dump_name) {
+            return -1;
+        }
+    }
+    if (!PyDateTimeAPI) {
+        PyDateTime_IMPORT;
+        if (!PyDateTimeAPI) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int catzilla_json_serializer_traverse(catzilla_module_state_t* state, visitproc visit, void* arg) {
+    Py_VISIT(state->json_model_dump_name);
+    Py_VISIT(state->json_uuid_type);
+    Py_VISIT(state->json_decimal_type);
+    return 0;
+}
+
+void catzilla_json_serializer_clear(catzilla_module_state_t* state) {
+    Py_CLEAR(state->json_model_dump_name);
+    Py_CLEAR(state->json_uuid_type);
+    Py_CLEAR(state->json_decimal_type);
+    state->json_optional_types_loaded = 0;
+}
+
+int catzilla_json_serialize(PyObject* obj, catzilla_json_buffer_t* buffer) {
+    buffer->data = NULL;
+    buffer->length = 0;
+    buffer->capacity = 0;
+
+    if (write_value(buffer, obj) != 0) {
+        catzilla_json_buffer_release(buffer);
+        return -1;
+    }
+    json_size_hint = buffer->length;
+    return 0;
+}
+
+PyObject* catzilla_json_dumps(PyObject* obj) {
+    // Reentrant calls (a model_dump() that calls json_dumps) get their own buffer
+    catzilla_json_buffer_t buffer = json_scratch;
+    json_scratch.data = NULL;
+    json_scratch.capacity = 0;
+    buffer.length = 0;
+
+    PyObject* result = NULL;
+    if (write_value(&buffer, obj) == 0) {
+        result = PyBytes_FromStringAndSize(buffer.data ? buffer.data : "", (Py_ssize_t)buffer.length);
+    }
+
+    if (buffer.capacity <= CATZILLA_JSON_SCRATCH_MAX && !json_scratch.data) {
+        json_scratch = buffer;
+        json_scratch.length = 0;
+    } else {
+        catzilla_json_buffer_release(&buffer);
+    }
+    return result;
+}
@@ -0,0 +1,83 @@
+/*
+ * Catzilla JSON Serializer Header
+ *
+ * Serializes handler return values (dict, list, tuple, str, int, float, bool,
+ * None, datetime/date/time, UUID, Decimal and model instances) to compact
+ * UTF-8 JSON in one walk over the Python objects, without building a str or
+ * bytes object on the way. The output buffer comes from the response arena,
+ * so the send path can write it without a copy and free it without the GIL.
+ */
+
+#ifndef CATZILLA_JSON_SERIALIZER_H
+#define CATZILLA_JSON_SERIALIZER_H
+
+#include <Python.h>
+#include <stddef.h>
+#include "module_state.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Buffers larger than this are not kept for reuse by catzilla_json_dumps
+#define CATZILLA_JSON_SCRATCH_MAX (256 * 1024)
+
+typedef struct {
+    char* data;         // Response arena memory, not NUL-terminated
+    size_t length;
+    size_t capacity;
+} catzilla_json_buffer_t;
+
+/**
+ * Import the datetime C API and intern the names the serializer looks up.
+ * Call once from module initialization.
+ * @param state State of the module being initialized
+ * @return 0 on success, -1 with a Python exception set
+ */
+int catzilla_json_serializer_init(catzilla_module_state_t* state);
+
+/**
+ * Visit the serializer's objects in a module state (m_traverse)
+ * @param state Module state
+ * @param visit Visitor
+ * @param arg Visitor argument
+ * @return 0, or the first nonzero visitor result
+ */
+int catzilla_json_serializer_traverse(catzilla_module_state_t* state, visitproc visit, void* arg);
+
+/**
+ * Drop the serializer's objects from a module state (m_clear, m_free)
+ * @param state Module state
+ */
+void catzilla_json_serializer_clear(catzilla_module_state_t* state);
+
+/**
+ * Serialize a Python object as JSON into a new buffer. The output matches
+ * json.dumps(obj, separators=(",", ":"), ensure_ascii=False) for the types
+ * json supports; datetimes are written with isoformat(), UUIDs as strings,
+ * Decimals as exact numbers and objects with model_dump() as its result.
+ * Must be called with the GIL held.
+ * @param obj Object to serialize
+ * @param buffer Receives the output; release it with catzilla_json_buffer_release
+ * @return 0 on success, -1 with a Python exception set (buffer is then empty)
+ */
+int catzilla_json_serialize(PyObject* obj, catzilla_json_buffer_t* buffer);
+
+/**
+ * Free a buffer's memory; does not need the GIL
+ * @param buffer Buffer (may be empty)
+ */
+void catzilla_json_buffer_release(catzilla_json_buffer_t* buffer);
+
+/**
+ * Serialize a Python object to a bytes object, reusing a per-thread buffer
+ * @param obj Object to serialize
+ * @return New bytes object, NULL with a Python exception set
+ */
+PyObject* catzilla_json_dumps(PyObject* obj);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CATZILLA_JSON_SERIALIZER_H
@@ -14,6 +14,7 @@
 
 // Project headers
 #include "../core/server.h"           // Provides catzilla_server_t, catzilla_server_init, etc.
+#include "../core/request_object.h"   // Lazy request object handed to Python handlers
 #include "../core/logging.h"
 #include "../core/router.h"           // Provides catzilla_router_t, catzilla_router_match, etc.
 #include "../core/memory.h"           // Provides memory system functions
@@ -36,12 +37,21 @@
 #include <time.h>             // For time()
 #include <yyjson.h>
 #include "../core/cache_engine.h"
+#include "../core/read_buffer_pool.h"
+#include "../core/request_arena.h"
+#include "../core/task_system.h"
+#include "../core/task_log.h"
+#include "../core/platform_atomic.h"
+#include "../core/metrics.h"
 
 // Forward declarations for submodules
 PyObject* init_streaming(void);
+PyObject* init_websocket(void);
 
 // Include async bridge for hybrid sync/async execution
 #include "async_bridge.h"
+#include "json_serializer.h"
+#include "module_state.h"
 
 // Structure to hold Python callback and routing table
 typedef struct {
@@ -53,13 +63,40 @@ typedef struct {
 // MIDDLEWARE REGISTRATION SYSTEM
 // ============================================================================
 
-// Global middleware registry
-static PyObject *g_middleware_registry = NULL;  // Dict: middleware_id -> PyObject*
-static int g_next_middleware_id = 1;
+// Per-interpreter module state (module_state.h). Handlers of every
+// interpreter that imports the module reach their own registry and router
+// instead of C globals.
+static struct PyModuleDef catzilla_module;
 
-// Global router for module-level functions
-static catzilla_router_t global_router;
-static bool global_router_initialized = false;
+// State of the calling interpreter's module, or NULL with an exception set
+static catzilla_module_state_t* get_module_state(PyObject *module) {
+    if (!module) {
+        module = PyState_FindModule(&catzilla_module);
+    }
+    catzilla_module_state_t *state = module ? (catzilla_module_state_t*)PyModule_GetState(module) : NULL;
+    if (!state && !PyErr_Occurred()) {
+        PyErr_SetString(PyExc_RuntimeError, "catzilla._catzilla is not initialized in this interpreter");
+    }
+    return state;
+}
+
+catzilla_module_state_t* catzilla_get_module_state(void) {
+    return get_module_state(NULL);
+}
+
+// Router behind the module-level routing functions, created on first use
+static catzilla_router_t* get_module_router(PyObject *module) {
+    catzilla_module_state_t *state = get_module_state(module);
+    if (!state) return NULL;
+    if (!state->router_initialized) {
+        if (catzilla_router_init(&state->router) != 0) {
+            PyErr_SetString(PyExc_RuntimeError, "Failed to initialize global router");
+            return NULL;
+        }
+        state->router_initialized = true;
+    }
+    return &state->router;
+}
 
 // Middleware execution context
 typedef struct {
@@ -69,51 +106,76 @@ typedef struct {
 } middleware_context_t;
 
 // Initialize middleware registry
-static int init_middleware_registry(void) {
-    if (!g_middleware_registry) {
-        g_middleware_registry = PyDict_New();
-        if (!g_middleware_registry) {
+static int init_middleware_registry(catzilla_module_state_t *state) {
+    if (!state->middleware_registry) {
+        state->middleware_registry = PyDict_New();
+        if (!state->middleware_registry) {
             return -1;
         }
+        state->next_middleware_id = 1;
     }
     return 0;
 }
 
-// Cleanup middleware registry
-static void cleanup_middleware_registry(void) {
-    // Check if Python is still available and GIL can be acquired
-    if (Py_IsInitialized()) {
-        PyGILState_STATE gstate = PyGILState_Ensure();
-
-        // Safely clean up Python objects
-        if (g_middleware_registry) {
-            PyDict_Clear(g_middleware_registry);
-            Py_CLEAR(g_middleware_registry);
-        }
+static int catzilla_module_traverse(PyObject *module, visitproc visit, void *arg) {
+    catzilla_module_state_t *state = (catzilla_module_state_t*)PyModule_GetState(module);
+    if (state) {
+        Py_VISIT(state->middleware_registry);
+        Py_VISIT(state->streaming_registry_get);
+        Py_VISIT(state->streaming_registry_unregister);
+        return catzilla_json_serializer_traverse(state, visit, arg);
+    }
+    return 0;
+}
 
-        PyGILState_Release(gstate);
+static int catzilla_module_clear(PyObject *module) {
+    catzilla_module_state_t *state = (catzilla_module_state_t*)PyModule_GetState(module);
+    if (state) {
+        Py_CLEAR(state->middleware_registry);
+        Py_CLEAR(state->streaming_registry_get);
+        Py_CLEAR(state->streaming_registry_unregister);
+        catzilla_json_serializer_clear(state);
     }
+    return 0;
+}
 
-    // Reset static variables safely
-    g_middleware_registry = NULL;
-    g_next_middleware_id = 1;
+// Runs when the interpreter owning this module instance finalizes
+static void catzilla_module_free(void *module) {
+    catzilla_module_state_t *state = (catzilla_module_state_t*)PyModule_GetState((PyObject*)module);
+    if (!state) return;
+    Py_CLEAR(state->middleware_registry);
+    Py_CLEAR(state->streaming_registry_get);
+    Py_CLEAR(state->streaming_registry_unregister);
+    catzilla_json_serializer_clear(state);
+    if (state->router_initialized) {
+        catzilla_router_cleanup(&state->router);
+        state->router_initialized = false;
+    }
 }
 
-// Safe cleanup for module exit
-static void safe_module_cleanup(void) {
-    // Only do cleanup if Python interpreter is still active
-    if (Py_IsInitialized()) {
-        cleanup_middleware_registry();
+// atexit callback: stop this interpreter's asyncio thread while it can
+// still run, before finalization
+static PyObject* shutdown_async_bridge(PyObject *module, PyObject *Py_UNUSED(ignored)) {
+    catzilla_module_state_t *state = get_module_state(module);
+    if (!state) return NULL;
+    catzilla_async_bridge_shutdown(state);
+    Py_RETURN_NONE;
+}
 
-        // Cleanup global router if it was initialized
-        if (global_router_initialized) {
-            catzilla_router_cleanup(&global_router);
-            global_router_initialized = false;
-        }
+static PyMethodDef shutdown_async_bridge_def = {
+    "_shutdown_async_bridge", shutdown_async_bridge, METH_NOARGS, "Stop the asyncio bridge thread"
+};
 
-        // Cleanup async bridge system
-        catzilla_async_bridge_shutdown();
-    }
+static int register_async_bridge_shutdown(PyObject *module) {
+    PyObject *atexit = PyImport_ImportModule("atexit");
+    if (!atexit) return -1;
+    PyObject *callback = PyCFunction_New(&shutdown_async_bridge_def, module);
+    PyObject *result = callback ? PyObject_CallMethod(atexit, "register", "O", callback) : NULL;
+    Py_XDECREF(callback);
+    Py_DECREF(atexit);
+    if (!result) return -1;
+    Py_DECREF(result);
+    return 0;
 }
 
 // Register a Python middleware function and return its ID
@@ -130,12 +192,13 @@ static PyObject* register_middleware_function(PyObject *self, PyObject *args) {
     }
 
     // Initialize registry if needed
-    if (init_middleware_registry() < 0) {
+    catzilla_module_state_t *state = get_module_state(self);
+    if (!state || init_middleware_registry(state) < 0) {
         return NULL;
     }
 
     // Get next middleware ID
-    int middleware_id = g_next_middleware_id++;
+    int middleware_id = (int)catzilla_atomic_fetch_add(&state->next_middleware_id, 1);
     PyObject *id_obj = PyLong_FromLong(middleware_id);
     if (!id_obj) {
         return NULL;
@@ -143,7 +206,7 @@ static PyObject* register_middleware_function(PyObject *self, PyObject *args) {
 
     // Store middleware function in registry
     Py_INCREF(middleware_func);
-    if (PyDict_SetItem(g_middleware_registry, id_obj, middleware_func) < 0) {
+    if (PyDict_SetItem(state->middleware_registry, id_obj, middleware_func) < 0) {
         Py_DECREF(middleware_func);
         Py_DECREF(id_obj);
         return NULL;
@@ -162,7 +225,11 @@ static PyObject* execute_middleware_by_id(PyObject *self, PyObject *args) {
         return NULL;
     }
 
-    if (!g_middleware_registry) {
+    catzilla_module_state_t *state = get_module_state(self);
+    if (!state) {
+        return NULL;
+    }
+    if (!state->middleware_registry) {
         PyErr_SetString(PyExc_RuntimeError, "Middleware registry not initialized");
         return NULL;
     }
@@ -173,7 +240,7 @@ static PyObject* execute_middleware_by_id(PyObject *self, PyObject *args) {
         return NULL;
     }
 
-    PyObject *middleware_func = PyDict_GetItem(g_middleware_registry, id_obj);
+    PyObject *middleware_func = PyDict_GetItem(state->middleware_registry, id_obj);
     Py_DECREF(id_obj);
 
     if (!middleware_func) {
@@ -209,7 +276,9 @@ static int execute_python_middleware_bridge(int middleware_id, void* request_ctx
 
     int result = 0;  // Default: continue
 
-    if (!g_middleware_registry) {
+    catzilla_module_state_t *state = get_module_state(NULL);
+    if (!state || !state->middleware_registry) {
+        PyErr_Clear();
         PyGILState_Release(gstate);
         return -1;  // Error
     }
@@ -221,7 +290,7 @@ static int execute_python_middleware_bridge(int middleware_id, void* request_ctx
         return -1;
     }
 
-    PyObject *middleware_func = PyDict_GetItem(g_middleware_registry, id_obj);
+    PyObject *middleware_func = PyDict_GetItem(state->middleware_registry, id_obj);
     Py_DECREF(id_obj);
 
     if (!middleware_func) {
@@ -360,12 +429,19 @@ typedef struct {
     int hit;
 } CatzillaCacheResultObject;
 
+// Python TaskLog object
+typedef struct {
+    PyObject_HEAD
+    catzilla_task_log_t *log;
+} CatzillaTaskLogObject;
+
 // Forward declarations for type objects
 static PyTypeObject CatzillaValidatorType;
 static PyTypeObject CatzillaModelType;
 static PyTypeObject CatzillaServerType;
 static PyTypeObject CatzillaCacheType;
 static PyTypeObject CatzillaCacheResultType;
+static PyTypeObject CatzillaTaskLogType;
 
 // Deallocate
 static void CatzillaServer_dealloc(CatzillaServerObject *self)
@@ -376,6 +452,7 @@ static void CatzillaServer_dealloc(CatzillaServerObject *self)
         catzilla_cache_free(self->route_data);
     }
     catzilla_router_cleanup(&self->py_router);
+    catzilla_router_release_py_caches(&self->server.router);
     catzilla_server_cleanup(&self->server);
     Py_TYPE(self)->tp_free((PyObject*)self);
 }
@@ -420,6 +497,9 @@ static int CatzillaServer_init(CatzillaServerObject *self, PyObject *args, PyObj
         free(self->route_data);
         return -1;
     }
+    // Routes removed while serving take their Python objects with them;
+    // route changes run with the GIL held
+    self->server.router.release_route = catzilla_route_py_cache_release;
 
     // Initialize the Python-accessible C router
     if (catzilla_router_init(&self->py_router) != 0) {
@@ -433,12 +513,411 @@ static int CatzillaServer_init(CatzillaServerObject *self, PyObject *args, PyObj
 }
 
 // listen(port, host="0.0.0.0")
+static PyObject* CatzillaServer_set_context_pool_limit(CatzillaServerObject *self, PyObject *args)
+{
+    int limit;
+    if (!PyArg_ParseTuple(args, "i", &limit))
+        return NULL;
+
+    if (catzilla_server_set_context_pool_limit(&self->server, limit) != 0) {
+        PyErr_SetString(PyExc_ValueError, "Context pool limit must be >= 0");
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject* CatzillaServer_set_max_body_size(CatzillaServerObject *self, PyObject *args)
+{
+    unsigned long long max_body_size;
+    if (!PyArg_ParseTuple(args, "K", &max_body_size))
+        return NULL;
+
+    catzilla_server_set_max_body_size(&self->server, (uint64_t)max_body_size);
+    Py_RETURN_NONE;
+}
+
+static PyObject* CatzillaServer_set_http2(CatzillaServerObject *self, PyObject *args)
+{
+    int enabled;
+    if (!PyArg_ParseTuple(args, "p", &enabled))
+        return NULL;
+
+    catzilla_server_set_http2(&self->server, enabled != 0);
+    Py_RETURN_NONE;
+}
+
+// set_compression(enabled, min_size=1024, br_max_size=262144, gzip_level=6,
+//                 br_quality=4, zstd_level=3)
+static PyObject* CatzillaServer_set_compression(CatzillaServerObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"enabled", "min_size", "br_max_size", "gzip_level", "br_quality", "zstd_level", NULL};
+    catzilla_compression_config_t config;
+    catzilla_compression_config_init(&config);
+    int enabled;
+    unsigned long long min_size = config.min_size;
+    unsigned long long br_max_size = config.br_max_size;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "p|KKiii", kwlist, &enabled, &min_size, &br_max_size,
+                                     &config.gzip_level, &config.br_quality, &config.zstd_level))
+        return NULL;
+
+    config.enabled = enabled != 0;
+    config.min_size = (size_t)min_size;
+    config.br_max_size = (size_t)br_max_size;
+    if (catzilla_server_set_compression(&self->server, &config) != 0) {
+        PyErr_SetString(PyExc_ValueError, "Compression levels must be gzip 1-9, br 0-11 and zstd 1-22");
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+// set_timeouts(header_ms, body_ms, keepalive_ms, write_ms), 0 disables one
+static PyObject* CatzillaServer_set_timeouts(CatzillaServerObject *self, PyObject *args)
+{
+    unsigned long long header_ms, body_ms, keepalive_ms, write_ms;
+    if (!PyArg_ParseTuple(args, "KKKK", &header_ms, &body_ms, &keepalive_ms, &write_ms))
+        return NULL;
+
+    catzilla_server_set_timeouts(&self->server, (uint64_t)header_ms, (uint64_t)body_ms,
+                                 (uint64_t)keepalive_ms, (uint64_t)write_ms);
+    Py_RETURN_NONE;
+}
+
+// set_python_batching(batch_size, budget_us=2000)
+static PyObject* CatzillaServer_set_python_batching(CatzillaServerObject *self, PyObject *args)
+{
+    int batch_size;
+    unsigned long long budget_us = CATZILLA_DEFAULT_PYTHON_BATCH_BUDGET_US;
+    if (!PyArg_ParseTuple(args, "i|K", &batch_size, &budget_us))
+        return NULL;
+
+    if (catzilla_server_set_python_batching(&self->server, batch_size, (uint64_t)budget_us) != 0) {
+        PyErr_SetString(PyExc_ValueError, "Python batch size must be >= 1");
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+// set_memory_budget(budget_bytes, interval_ms=0, upload_limit=0), 0 picks the defaults
+static PyObject* CatzillaServer_set_memory_budget(CatzillaServerObject *self, PyObject *args)
+{
+    unsigned long long budget_bytes;
+    unsigned long long interval_ms = 0;
+    unsigned long long upload_limit = 0;
+    if (!PyArg_ParseTuple(args, "K|KK", &budget_bytes, &interval_ms, &upload_limit))
+        return NULL;
+
+    if (catzilla_server_set_memory_budget(&self->server, (uint64_t)budget_bytes,
+                                          (uint64_t)interval_ms, (uint64_t)upload_limit) != 0) {
+        PyErr_SetString(PyExc_RuntimeError, "The memory budget must be set before the server starts");
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+// set_heap_profile_endpoint(path)
+static PyObject* CatzillaServer_set_heap_profile_endpoint(CatzillaServerObject *self, PyObject *args)
+{
+    const char* path;
+    if (!PyArg_ParseTuple(args, "s", &path))
+        return NULL;
+
+    if (catzilla_server_set_heap_profile_endpoint(&self->server, path) != 0) {
+        PyErr_Format(PyExc_RuntimeError, "Cannot add the heap profile route %s", path);
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+// set_metrics_endpoint(path)
+static PyObject* CatzillaServer_set_metrics_endpoint(CatzillaServerObject *self, PyObject *args)
+{
+    const char* path;
+    if (!PyArg_ParseTuple(args, "s", &path))
+        return NULL;
+
+    if (catzilla_server_set_metrics_endpoint(&self->server, path) != 0) {
+        PyErr_Format(PyExc_RuntimeError, "Cannot add the metrics route %s", path);
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+// set_latency_metrics(enabled)
+static PyObject* CatzillaServer_set_latency_metrics(CatzillaServerObject *self, PyObject *args)
+{
+    int enabled;
+    if (!PyArg_ParseTuple(args, "p", &enabled))
+        return NULL;
+
+    if (catzilla_server_set_latency_metrics(&self->server, enabled != 0) != 0) {
+        PyErr_SetString(PyExc_RuntimeError, "Latency metrics cannot change while the server runs");
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+// set_max_connections(max_connections, low_water=0)
+static PyObject* CatzillaServer_set_max_connections(CatzillaServerObject *self, PyObject *args)
+{
+    unsigned long long max_connections;
+    unsigned long long low_water = 0;
+    if (!PyArg_ParseTuple(args, "K|K", &max_connections, &low_water))
+        return NULL;
+
+    catzilla_server_set_max_connections(&self->server, (uint64_t)max_connections, (uint64_t)low_water);
+    Py_RETURN_NONE;
+}
+
+// set_tls(cert_file, key_file, ktls=True)
+static PyObject* CatzillaServer_set_tls(CatzillaServerObject *self, PyObject *args)
+{
+    const char *cert_file, *key_file;
+    int ktls = 1;
+    if (!PyArg_ParseTuple(args, "ss|p", &cert_file, &key_file, &ktls))
+        return NULL;
+
+    if (!catzilla_tls_supported()) {
+        PyErr_SetString(PyExc_RuntimeError, "Catzilla was built without TLS support");
+        return NULL;
+    }
+    if (catzilla_server_set_tls(&self->server, cert_file, key_file, ktls != 0) != 0) {
+        PyErr_Format(PyExc_ValueError, "Cannot load TLS certificate '%s' and key '%s'", cert_file, key_file);
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+// set_route_body_mode(method, path, mode, max_body_size=0, spool_threshold=0)
+static PyObject* CatzillaServer_set_route_body_mode(CatzillaServerObject *self, PyObject *args)
+{
+    const char *method, *path, *mode_name;
+    unsigned long long max_body_size = 0;
+    Py_ssize_t spool_threshold = 0;
+    if (!PyArg_ParseTuple(args, "sss|Kn", &method, &path, &mode_name, &max_body_size, &spool_threshold))
+        return NULL;
+
+    catzilla_body_mode_t mode;
+    if (strcmp(mode_name, "buffered") == 0) {
+        mode = CATZILLA_BODY_BUFFERED;
+    } else if (strcmp(mode_name, "spool") == 0) {
+        mode = CATZILLA_BODY_SPOOL;
+    } else {
+        // Chunk streaming needs a C chunk handler, see catzilla_server_set_route_body_stream
+        PyErr_Format(PyExc_ValueError, "Unsupported body mode '%s' (expected 'buffered' or 'spool')", mode_name);
+        return NULL;
+    }
+    if (spool_threshold < 0) {
+        PyErr_SetString(PyExc_ValueError, "Spool threshold must be >= 0");
+        return NULL;
+    }
+
+    if (catzilla_server_set_route_body_mode(&self->server, method, path, mode,
+                                            (uint64_t)max_body_size, (size_t)spool_threshold) != 0) {
+        PyErr_Format(PyExc_KeyError, "No route registered for %s %s", method, path);
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+// set_native_response(method, path, body, status_code=200, headers=None)
+static PyObject* CatzillaServer_set_native_response(CatzillaServerObject *self, PyObject *args)
+{
+    const char *method, *path;
+    const char *body;
+    Py_ssize_t body_len;
+    int status_code = 200;
+    const char *headers = NULL;
+    if (!PyArg_ParseTuple(args, "sss#|iz", &method, &path, &body, &body_len, &status_code, &headers))
+        return NULL;
+
+    if (catzilla_server_set_native_response(&self->server, method, path, status_code,
+                                            headers, body, (size_t)body_len) != 0) {
+        PyErr_Format(PyExc_ValueError, "Cannot serve %s %s natively (handler route or invalid status)", method, path);
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+// set_response_cache_disk(directory, max_bytes=0)
+static PyObject* CatzillaServer_set_response_cache_disk(CatzillaServerObject *self, PyObject *args)
+{
+    const char *directory;
+    unsigned long long max_bytes = 0;
+    if (!PyArg_ParseTuple(args, "s|K", &directory, &max_bytes))
+        return NULL;
+    if (catzilla_server_set_response_cache_disk(&self->server, directory, (uint64_t)max_bytes) != 0) {
+        PyErr_Format(PyExc_RuntimeError, "Cannot use %s as the response cache disk tier", directory);
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+// set_cache_snapshot(directory)
+static PyObject* CatzillaServer_set_cache_snapshot(CatzillaServerObject *self, PyObject *args)
+{
+    const char *directory;
+    if (!PyArg_ParseTuple(args, "s", &directory))
+        return NULL;
+    if (catzilla_server_set_cache_snapshot(&self->server, directory) != 0) {
+        PyErr_Format(PyExc_RuntimeError, "Cannot keep cache snapshots in %s (server running or directory unusable)", directory);
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+// set_handoff(socket_path, drain_timeout_ms)
+static PyObject* CatzillaServer_set_handoff(CatzillaServerObject *self, PyObject *args)
+{
+    const char *socket_path;
+    unsigned long long drain_timeout_ms = 0;
+    if (!PyArg_ParseTuple(args, "s|K", &socket_path, &drain_timeout_ms))
+        return NULL;
+    if (catzilla_server_set_handoff(&self->server, socket_path, (uint64_t)drain_timeout_ms) != 0) {
+        PyErr_Format(PyExc_RuntimeError, "Cannot hand listeners over through %s (server running or not supported here)", socket_path);
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+// set_response_cache_redis(url, key_prefix=None, pool_size=0)
+static PyObject* CatzillaServer_set_response_cache_redis(CatzillaServerObject *self, PyObject *args)
+{
+    const char *url;
+    const char *key_prefix = NULL;
+    int pool_size = 0;
+    if (!PyArg_ParseTuple(args, "s|zi", &url, &key_prefix, &pool_size))
+        return NULL;
+    if (catzilla_server_set_response_cache_redis(&self->server, url, key_prefix, pool_size) != 0) {
+        PyErr_SetString(PyExc_RuntimeError, "Cannot use Redis for the response cache (invalid URL, server running, or already set)");
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+// set_clamd(address, pool_size=0)
+static PyObject* CatzillaServer_set_clamd(CatzillaServerObject *self, PyObject *args)
+{
+    const char *address;
+    int pool_size = 0;
+    if (!PyArg_ParseTuple(args, "s|i", &address, &pool_size))
+        return NULL;
+    if (catzilla_server_set_clamd(&self->server, address, pool_size) != 0) {
+        PyErr_SetString(PyExc_RuntimeError, "Cannot scan uploads with clamd (invalid address or server running)");
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+// set_upload_options(sha256=False, crc32c=False, direct_io=False)
+static PyObject* CatzillaServer_set_upload_options(CatzillaServerObject *self, PyObject *args)
+{
+    int sha256 = 0, crc32c = 0, direct_io = 0;
+    if (!PyArg_ParseTuple(args, "|ppp", &sha256, &crc32c, &direct_io))
+        return NULL;
+    unsigned digests = (sha256 ? CATZILLA_DIGEST_SHA256 : 0) | (crc32c ? CATZILLA_DIGEST_CRC32C : 0);
+    if (catzilla_server_set_upload_options(&self->server, digests, direct_io != 0) != 0) {
+        PyErr_SetString(PyExc_RuntimeError, "Cannot set upload options");
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+// set_route_cache(method, path, ttl, vary_query=True, vary_headers=None)
+static PyObject* CatzillaServer_set_route_cache(CatzillaServerObject *self, PyObject *args)
+{
+    const char *method, *path;
+    unsigned int ttl;
+    int vary_query = 1;
+    const char *vary_headers = NULL;
+    if (!PyArg_ParseTuple(args, "ssI|pz", &method, &path, &ttl, &vary_query, &vary_headers))
+        return NULL;
+
+    if (catzilla_server_set_route_cache(&self->server, method, path, (uint32_t)ttl,
+                                        vary_query != 0, vary_headers) != 0) {
+        PyErr_Format(PyExc_ValueError, "Cannot cache responses of %s %s (unknown route or invalid vary headers)", method, path);
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+// set_access_log(path=None, format="json", sample_rate=1.0, ring_records=0, flush_interval_ms=0)
+static PyObject* CatzillaServer_set_access_log(CatzillaServerObject *self, PyObject *args)
+{
+    const char *path = NULL;
+    const char *format = "json";
+    double sample_rate = 1.0;
+    unsigned int ring_records = 0;
+    unsigned int flush_interval_ms = 0;
+    if (!PyArg_ParseTuple(args, "|zsdII", &path, &format, &sample_rate, &ring_records, &flush_interval_ms))
+        return NULL;
+
+    catzilla_access_log_config_t config = {0};
+    if (strcmp(format, "json") == 0) {
+        config.format = CATZILLA_ACCESS_LOG_JSON;
+    } else if (strcmp(format, "clf") == 0) {
+        config.format = CATZILLA_ACCESS_LOG_CLF;
+    } else {
+        PyErr_Format(PyExc_ValueError, "Access log format must be 'json' or 'clf', not '%s'", format);
+        return NULL;
+    }
+    config.ring_records = ring_records;
+    config.flush_interval_ms = flush_interval_ms;
+
+    if (catzilla_server_set_access_log(&self->server, path, &config, sample_rate) != 0) {
+        PyErr_Format(PyExc_RuntimeError, "Cannot open the access log %s (or the server is running)",
+                     path ? path : "-");
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+// set_route_access_log_sample(method, path, sample_rate)
+static PyObject* CatzillaServer_set_route_access_log_sample(CatzillaServerObject *self, PyObject *args)
+{
+    const char *method, *path;
+    double sample_rate;
+    if (!PyArg_ParseTuple(args, "ssd", &method, &path, &sample_rate))
+        return NULL;
+
+    if (catzilla_server_set_route_access_log_sample(&self->server, method, path, sample_rate) != 0) {
+        PyErr_Format(PyExc_ValueError, "Cannot sample the access log of %s %s (no access log or unknown route)",
+                     method, path);
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject* CatzillaServer_get_access_log_stats(CatzillaServerObject *self, PyObject *Py_UNUSED(ignored))
+{
+    catzilla_access_log_stats_t stats;
+    catzilla_access_log_get_stats(self->server.access_log, &stats);
+    return Py_BuildValue("{s:O,s:K,s:K,s:K,s:K}",
+        "enabled", self->server.access_log ? Py_True : Py_False,
+        "written", (unsigned long long)stats.written,
+        "dropped", (unsigned long long)stats.dropped,
+        "write_errors", (unsigned long long)stats.write_errors,
+        "rings", (unsigned long long)stats.rings
+    );
+}
+
+static PyObject* CatzillaServer_clear_response_cache(CatzillaServerObject *self, PyObject *Py_UNUSED(ignored))
+{
+    catzilla_server_clear_response_cache(&self->server);
+    Py_RETURN_NONE;
+}
+
 static PyObject* CatzillaServer_listen(CatzillaServerObject *self, PyObject *args)
 {
     const char *host = "0.0.0.0";
     int port;
-    if (!PyArg_ParseTuple(args, "i|s", &port, &host))
+    int workers = 1;
+    if (!PyArg_ParseTuple(args, "i|si", &port, &host, &workers))
+        return NULL;
+
+    if (catzilla_server_set_worker_count(&self->server, workers) != 0) {
+        PyErr_Format(PyExc_ValueError, "workers must be between 0 and %d", CATZILLA_MAX_WORKERS);
         return NULL;
+    }
 
     int rc;
     Py_BEGIN_ALLOW_THREADS
@@ -451,42 +930,159 @@ static PyObject* CatzillaServer_listen(CatzillaServerObject *self, PyObject *arg
     Py_RETURN_NONE;
 }
 
-// add_route(method, path, handler)
+// Register one route with the C core, dispatching to the Python handler
+static int catzilla_python_add_route(CatzillaServerObject *self, const char *method, const char *path,
+                                     PyObject *handler, long route_id, PyObject *route_info)
+{
+    void* route_user_data = route_id > 0 ? (void*)(uintptr_t)route_id : (void*)handler;
+
+    // Replace previous callback
+    if (self->route_data->callback != handler) {
+        Py_XINCREF(handler);
+        Py_XDECREF(self->route_data->callback);
+        self->route_data->callback = handler;
+    }
+
+    // Store in routes dict
+    if (PyDict_SetItemString(self->route_data->routes, path, handler) < 0)
+        return -1;
+
+    // CRITICAL FIX: Register the Python callback with the C server
+    catzilla_server_set_request_callback(&self->server, self->route_data->callback);
+
+    // Register route with C core - use universal Python handler
+    if (catzilla_server_add_route(&self->server, method, path, catzilla_python_route_handler, route_user_data) != 0) {
+        PyErr_Format(PyExc_RuntimeError, "Failed to add route %s %s", method, path);
+        return -1;
+    }
+
+    // Prebuild the route's constant Python objects for dispatch
+    catzilla_router_t* router = &self->server.router;
+    for (int i = router->route_count - 1; i >= 0; i--) {
+        catzilla_route_t* route = router->routes[i];
+        if (route && route->user_data == route_user_data) {
+            if (catzilla_route_py_cache_attach(route, route_info) != 0)
+                return -1;
+            break;
+        }
+    }
+    return 0;
+}
+
+// add_route(method, path, handler, route_id=0, route_info=None)
 static PyObject* CatzillaServer_add_route(CatzillaServerObject *self, PyObject *args)
 {
     const char *method, *path;
     PyObject *handler;
     long route_id = 0;
-    void* route_user_data = NULL;
-    if (!PyArg_ParseTuple(args, "ssO|l", &method, &path, &handler, &route_id))
+    PyObject *route_info = NULL;
+    if (!PyArg_ParseTuple(args, "ssO|lO", &method, &path, &handler, &route_id, &route_info))
         return NULL;
     if (!PyCallable_Check(handler)) {
         PyErr_SetString(PyExc_TypeError, "Handler must be callable");
         return NULL;
     }
 
-    route_user_data = route_id > 0 ? (void*)(uintptr_t)route_id : (void*)handler;
+    if (catzilla_python_add_route(self, method, path, handler, route_id, route_info) != 0)
+        return NULL;
+    Py_RETURN_NONE;
+}
+
+// add_routes(handler, routes) - the whole route table in one call; routes is
+// a sequence of (method, path, route_id, route_info) tuples
+static PyObject* CatzillaServer_add_routes(CatzillaServerObject *self, PyObject *args)
+{
+    PyObject *handler, *routes;
+    if (!PyArg_ParseTuple(args, "OO", &handler, &routes))
+        return NULL;
+    if (!PyCallable_Check(handler)) {
+        PyErr_SetString(PyExc_TypeError, "Handler must be callable");
+        return NULL;
+    }
 
-    // Replace previous callback
-    Py_XINCREF(handler);
-    Py_XDECREF(self->route_data->callback);
-    self->route_data->callback = handler;
+    PyObject *sequence = PySequence_Fast(routes, "routes must be a sequence");
+    if (!sequence) return NULL;
+    Py_ssize_t count = PySequence_Fast_GET_SIZE(sequence);
+    for (Py_ssize_t i = 0; i < count; i++) {
+        const char *method, *path;
+        long route_id;
+        PyObject *route_info;
+        PyObject *entry = PySequence_Fast_GET_ITEM(sequence, i);
+        if (!PyTuple_Check(entry)) {
+            PyErr_SetString(PyExc_TypeError, "routes must hold (method, path, route_id, route_info) tuples");
+            Py_DECREF(sequence);
+            return NULL;
+        }
+        if (!PyArg_ParseTuple(entry, "sslO", &method, &path, &route_id, &route_info) ||
+            catzilla_python_add_route(self, method, path, handler, route_id, route_info) != 0) {
+            Py_DECREF(sequence);
+            return NULL;
+        }
+    }
+    Py_DECREF(sequence);
+    Py_RETURN_NONE;
+}
 
-    // Store in routes dict
-    if (PyDict_SetItemString(self->route_data->routes, path, handler) < 0)
+// add_websocket_route(path, handler) - handler(ws) runs once per upgraded connection
+static PyObject* CatzillaServer_add_websocket_route(CatzillaServerObject *self, PyObject *args)
+{
+    const char *path;
+    PyObject *handler;
+    if (!PyArg_ParseTuple(args, "sO", &path, &handler))
         return NULL;
+    if (!PyCallable_Check(handler)) {
+        PyErr_SetString(PyExc_TypeError, "Handler must be callable");
+        return NULL;
+    }
 
-    // CRITICAL FIX: Register the Python callback with the C server
-    catzilla_server_set_request_callback(&self->server, self->route_data->callback);
+    // The routes dict keeps the handler alive for the server's lifetime
+    PyObject *key = Py_BuildValue("(ss)", "websocket", path);
+    if (!key)
+        return NULL;
+    int rc = PyDict_SetItem(self->route_data->routes, key, handler);
+    Py_DECREF(key);
+    if (rc < 0)
+        return NULL;
 
-    // Register route with C core - use universal Python handler
-    if (catzilla_server_add_route(&self->server, method, path, catzilla_python_route_handler, route_user_data) != 0) {
-        PyErr_SetString(PyExc_RuntimeError, "Failed to add route");
+    if (catzilla_server_add_websocket_route(&self->server, path, handler) != 0) {
+        PyErr_Format(PyExc_ValueError, "Cannot add WebSocket route %s (duplicate or invalid path)", path);
         return NULL;
     }
     Py_RETURN_NONE;
 }
 
+// set_websocket_options(ping_interval_ms, pong_timeout_ms, max_message_size, max_queue, deflate)
+static PyObject* CatzillaServer_set_websocket_options(CatzillaServerObject *self, PyObject *args)
+{
+    unsigned long long ping_interval_ms, pong_timeout_ms, max_message_size, max_queue;
+    int deflate;
+    if (!PyArg_ParseTuple(args, "KKKKp", &ping_interval_ms, &pong_timeout_ms,
+                          &max_message_size, &max_queue, &deflate))
+        return NULL;
+
+    catzilla_websocket_options_t options;
+    options.ping_interval_ms = (uint64_t)ping_interval_ms;
+    options.pong_timeout_ms = (uint64_t)pong_timeout_ms;
+    options.max_message_size = (size_t)max_message_size;
+    options.max_queue = (size_t)max_queue;
+    options.deflate = deflate != 0;
+    catzilla_server_set_websocket_options(&self->server, &options);
+    Py_RETURN_NONE;
+}
+
+// remove_route(method, path) - Unregister a route; safe while serving
+static PyObject* CatzillaServer_remove_route(CatzillaServerObject *self, PyObject *args)
+{
+    const char *method, *path;
+    if (!PyArg_ParseTuple(args, "ss", &method, &path))
+        return NULL;
+    // Requests still using the route keep it (and its Python cache) until
+    // they finish; a later route change frees it
+    if (catzilla_server_remove_route(&self->server, method, path) != 0)
+        Py_RETURN_FALSE;
+    Py_RETURN_TRUE;
+}
+
 // stop()
 static PyObject* CatzillaServer_stop(CatzillaServerObject *self, PyObject *Py_UNUSED(ignored))
 {
@@ -548,9 +1144,13 @@ static PyObject* CatzillaServer_match_route(CatzillaServerObject *self, PyObject
             return NULL;
         }
         for (int i = 0; i < match.param_count; i++) {
-            PyObject *param_value_obj = PyUnicode_FromString(match.params[i].value);
+            const char *param_name = catzilla_router_match_param_name(&match, i);
+            if (!param_name) continue;
+            size_t param_len = 0;
+            const char *param_value = catzilla_router_match_param_value(&match, i, &param_len);
+            PyObject *param_value_obj = catzilla_path_param_to_python(match.route, i, param_value, param_len);
             if (!param_value_obj ||
-                PyDict_SetItemString(params_dict, match.params[i].name, param_value_obj) < 0) {
+                PyDict_SetItemString(params_dict, param_name, param_value_obj) < 0) {
                 Py_XDECREF(param_value_obj);
                 Py_DECREF(params_dict);
                 Py_DECREF(match_dict);
@@ -575,7 +1175,9 @@ static PyObject* CatzillaServer_match_route(CatzillaServerObject *self, PyObject
     }
 
     if (match.has_allowed_methods) {
-        PyObject *allowed_methods_obj = PyUnicode_FromString(match.allowed_methods);
+        char allowed_methods[256];
+        catzilla_router_match_allowed_methods(&match, allowed_methods, sizeof(allowed_methods));
+        PyObject *allowed_methods_obj = PyUnicode_FromString(allowed_methods);
         if (!allowed_methods_obj ||
             PyDict_SetItemString(match_dict, "allowed_methods", allowed_methods_obj) < 0) {
             Py_XDECREF(allowed_methods_obj);
@@ -730,7 +1332,7 @@ static PyObject* CatzillaServer_mount_static(CatzillaServerObject *self, PyObjec
         "mount_path", "directory", "index_file", "enable_hot_cache", "cache_size_mb",
         "cache_ttl_seconds", "enable_compression", "compression_level",
         "max_file_size", "enable_etags", "enable_range_requests",
-        "enable_directory_listing", "enable_hidden_files", NULL
+        "enable_directory_listing", "enable_hidden_files", "use_io_uring", NULL
     };
 
     // Default values
@@ -745,14 +1347,16 @@ static PyObject* CatzillaServer_mount_static(CatzillaServerObject *self, PyObjec
     int enable_range_requests = 1;
     int enable_directory_listing = 0;
     int enable_hidden_files = 0;
+    int use_io_uring = 0;
 
     // Parse arguments with keyword support
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "ss|siiiiiLiiii", kwlist,
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "ss|siiiiiLiiiip", kwlist,
                                      &mount_path, &directory, &index_file,
                                      &enable_hot_cache, &cache_size_mb, &cache_ttl_seconds,
                                      &enable_compression, &compression_level, &max_file_size,
                                      &enable_etags, &enable_range_requests,
-                                     &enable_directory_listing, &enable_hidden_files)) {
+                                     &enable_directory_listing, &enable_hidden_files,
+                                     &use_io_uring)) {
         return NULL;
     }
 
@@ -800,9 +1404,11 @@ static PyObject* CatzillaServer_mount_static(CatzillaServerObject *self, PyObjec
     config->loop = self->server.loop;
     config->fs_thread_pool_size = 4;
     config->use_sendfile = true;
+    config->use_io_uring = use_io_uring ? true : false;
 
     // Performance settings
     config->enable_hot_cache = enable_hot_cache ? true : false;
+    config->enable_fd_cache = true;
     config->cache_size_mb = cache_size_mb > 0 ? cache_size_mb : 100;
     config->cache_ttl_seconds = cache_ttl_seconds > 0 ? cache_ttl_seconds : 3600;
 
@@ -838,82 +1444,123 @@ static PyObject* CatzillaServer_mount_static(CatzillaServerObject *self, PyObjec
 }
 
 // send_response(client_capsule, status, headers, body)
+// Keeps a Python response body alive while libuv writes it without copying
+typedef struct {
+    PyObject* object;   // str owner (UTF-8 cache lives inside the str object)
+    Py_buffer view;     // bytes-like owner
+    bool has_view;
+} python_body_owner_t;
+
+static void release_python_body(void* owner, const char* body, size_t body_len) {
+    (void)body;
+    (void)body_len;
+    python_body_owner_t* body_owner = (python_body_owner_t*)owner;
+    if (!body_owner) return;
+
+    // after_write runs on the event loop without the GIL
+    PyGILState_STATE gstate = PyGILState_Ensure();
+    if (body_owner->has_view) {
+        PyBuffer_Release(&body_owner->view);
+    }
+    Py_XDECREF(body_owner->object);
+    PyGILState_Release(gstate);
+
+    catzilla_response_free(body_owner);
+}
+
 static PyObject* send_response(PyObject *self, PyObject *args)
 {
     PyObject *capsule;
     int status;
-    const char *headers, *body;
-    if (!PyArg_ParseTuple(args, "Oiss", &capsule, &status, &headers, &body))
+    const char *headers;
+    PyObject *body_obj;
+    if (!PyArg_ParseTuple(args, "OisO", &capsule, &status, &headers, &body_obj))
+        return NULL;
+
+    // Body may be str or any bytes-like object; both are written without a copy
+    const char *body;
+    Py_ssize_t body_len = 0;
+    python_body_owner_t* body_owner = catzilla_response_alloc(sizeof(python_body_owner_t));
+    if (!body_owner) {
+        return PyErr_NoMemory();
+    }
+    memset(body_owner, 0, sizeof(*body_owner));
+    if (PyUnicode_Check(body_obj)) {
+        body = PyUnicode_AsUTF8AndSize(body_obj, &body_len);
+        if (!body) {
+            catzilla_response_free(body_owner);
+            return NULL;
+        }
+        Py_INCREF(body_obj);
+        body_owner->object = body_obj;
+    } else if (PyObject_GetBuffer(body_obj, &body_owner->view, PyBUF_SIMPLE) == 0) {
+        body_owner->has_view = true;
+        body = (const char*)body_owner->view.buf;
+        body_len = body_owner->view.len;
+    } else {
+        catzilla_response_free(body_owner);
+        PyErr_SetString(PyExc_TypeError, "Response body must be str or bytes-like");
         return NULL;
+    }
 
     uv_stream_t *client = PyCapsule_GetPointer(capsule, "catzilla.client");
     if (!client) {
+        release_python_body(body_owner, body, (size_t)body_len);
         PyErr_SetString(PyExc_TypeError, "Invalid client capsule");
         return NULL;
     }
 
-    // Check if this is a streaming response
-    if (body && strncmp(body, "___CATZILLA_STREAMING___", 24) == 0) {
-        // Extract streaming ID from marker: ___CATZILLA_STREAMING___<uuid>___
-        const char* id_start = body + 24;  // Skip marker prefix
-        const char* id_end = strstr(id_start, "___");  // Find end marker
-
-        if (id_end) {
-            // Extract the streaming ID
-            size_t id_len = id_end - id_start;
-            char* streaming_id = malloc(id_len + 1);
-            if (!streaming_id) {
-                PyErr_SetString(PyExc_MemoryError, "Failed to allocate memory for streaming ID");
-                return NULL;
-            }
-
-            strncpy(streaming_id, id_start, id_len);
-            streaming_id[id_len] = '\0';
-
-            // Connect to streaming response via the streaming module
-            PyObject* catzilla_module = PyImport_ImportModule("catzilla._catzilla");
-            if (!catzilla_module) {
-                free(streaming_id);
-                return NULL;
-            }
-
-            PyObject* streaming_attr = PyObject_GetAttrString(catzilla_module, "_streaming");
-            if (!streaming_attr) {
-                Py_DECREF(catzilla_module);
-                free(streaming_id);
-                return NULL;
-            }
+    // Large bodies are written straight from the Python object and released
+    // in after_write; streaming markers are connected by the server
+    catzilla_send_response_zerocopy(client, status, headers, body, (size_t)body_len,
+                                    release_python_body, body_owner);
+    Py_RETURN_NONE;
+}
 
-            PyObject* connect_func = PyObject_GetAttrString(streaming_attr, "connect_streaming_response");
-            if (!connect_func) {
-                Py_DECREF(streaming_attr);
-                Py_DECREF(catzilla_module);
-                free(streaming_id);
-                return NULL;
-            }
+// json_dumps(obj) -> bytes
+static PyObject* json_dumps(PyObject *self, PyObject *obj)
+{
+    (void)self;
+    return catzilla_json_dumps(obj);
+}
 
-            // Call connect_streaming_response(client_capsule, streaming_id)
-            PyObject* id_str = PyUnicode_FromString(streaming_id);
-            PyObject* result = PyObject_CallFunctionObjArgs(connect_func, capsule, id_str, NULL);
+static void release_json_body(void* owner, const char* body, size_t body_len) {
+    (void)owner;
+    (void)body_len;
+    // Arena memory; no GIL needed
+    catzilla_response_free((void*)body);
+}
 
-            // Cleanup
-            free(streaming_id);
-            Py_DECREF(id_str);
-            Py_DECREF(connect_func);
-            Py_DECREF(streaming_attr);
-            Py_DECREF(catzilla_module);
+// send_json_response(client_capsule, status, headers, data)
+// Serializes data straight into the response buffer, then compresses and
+// writes it with the GIL released
+static PyObject* send_json_response(PyObject *self, PyObject *args)
+{
+    (void)self;
+    PyObject *capsule;
+    int status;
+    const char *headers;
+    PyObject *data;
+    if (!PyArg_ParseTuple(args, "OisO", &capsule, &status, &headers, &data))
+        return NULL;
 
-            if (!result) {
-                return NULL;
-            }
+    uv_stream_t *client = PyCapsule_GetPointer(capsule, "catzilla.client");
+    if (!client) {
+        PyErr_SetString(PyExc_TypeError, "Invalid client capsule");
+        return NULL;
+    }
 
-            Py_DECREF(result);
-            Py_RETURN_NONE;
-        }
+    catzilla_json_buffer_t buffer;
+    if (catzilla_json_serialize(data, &buffer) != 0) {
+        return NULL;
     }
 
-    // Regular response handling
-    catzilla_send_response(client, status, headers, body, strlen(body));
+    // The send path copies the header block, so only the body must outlive it
+    Py_BEGIN_ALLOW_THREADS
+    catzilla_send_response_zerocopy(client, status, headers, buffer.data ? buffer.data : "",
+                                    buffer.length, buffer.data ? release_json_body : NULL, NULL);
+    Py_END_ALLOW_THREADS
+
     Py_RETURN_NONE;
 }
 
@@ -1249,12 +1896,14 @@ static PyObject* create_int_validator(PyObject *self, PyObject *args, PyObject *
     return (PyObject*)validator_obj;
 }
 
-// Create string validator: StringValidator(min_len=None, max_len=None, pattern=None)
+// Create string validator: StringValidator(min_len=None, max_len=None, pattern=None, format=None)
 static PyObject* create_string_validator(PyObject *self, PyObject *args, PyObject *kwargs) {
-    static char *kwlist[] = {"min_len", "max_len", "pattern", NULL};
+    static char *kwlist[] = {"min_len", "max_len", "pattern", "format", NULL};
     PyObject *min_len_obj = NULL, *max_len_obj = NULL, *pattern_obj = NULL;
+    const char *format_name = NULL;
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|OOO", kwlist, &min_len_obj, &max_len_obj, &pattern_obj)) {
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|OOOz", kwlist, &min_len_obj, &max_len_obj, &pattern_obj,
+                                     &format_name)) {
         return NULL;
     }
 
@@ -1271,6 +1920,15 @@ static PyObject* create_string_validator(PyObject *self, PyObject *args, PyObjec
         pattern = PyUnicode_AsUTF8(pattern_obj);
     }
 
+    catzilla_string_format_t format = CATZILLA_STRING_FORMAT_NONE;
+    if (format_name) {
+        format = catzilla_string_format_from_name(format_name);
+        if (format == CATZILLA_STRING_FORMAT_NONE) {
+            PyErr_Format(PyExc_ValueError, "Unknown string format '%s'", format_name);
+            return NULL;
+        }
+    }
+
     CatzillaValidatorObject *validator_obj = (CatzillaValidatorObject*)CatzillaValidator_new(&CatzillaValidatorType, NULL, NULL);
     if (!validator_obj) return NULL;
 
@@ -1280,6 +1938,7 @@ static PyObject* create_string_validator(PyObject *self, PyObject *args, PyObjec
         PyErr_SetString(PyExc_RuntimeError, "Failed to create string validator");
         return NULL;
     }
+    catzilla_set_string_format(validator_obj->validator, format);
 
     return (PyObject*)validator_obj;
 }
@@ -1539,6 +2198,167 @@ static PyObject* CatzillaModel_validate(CatzillaModelObject *self, PyObject *arg
     }
 }
 
+// Store one validated field of a yyjson walk in the target dict
+static int model_emit_field(void* user_data, const field_spec_t* field, yyjson_val* value) {
+    PyObject *item;
+    if (value) {
+        item = yyjson_to_python(value);
+        if (!item) return -1;
+    } else {
+        item = Py_None;
+        Py_INCREF(item);
+    }
+    int rc = PyDict_SetItemString((PyObject*)user_data, field->field_name, item);
+    Py_DECREF(item);
+    return rc;
+}
+
+// Validate a request's JSON body: model.validate_request(request, target=None)
+// Walks the parsed yyjson document directly and fills target (or a new dict)
+// with the validated fields in the same pass. Returns None when the request
+// has no JSON body; on failure target may hold some fields already.
+static PyObject* CatzillaModel_validate_request(CatzillaModelObject *self, PyObject *args) {
+    PyObject *capsule;
+    PyObject *target = NULL;
+    if (!PyArg_ParseTuple(args, "O|O!", &capsule, &PyDict_Type, &target)) {
+        return NULL;
+    }
+
+    catzilla_request_t *request = catzilla_request_from_object(capsule);
+    if (!request) {
+        PyErr_SetString(PyExc_TypeError, "Invalid request capsule");
+        return NULL;
+    }
+
+    yyjson_val *root = catzilla_get_json(request);
+    if (!root) {
+        Py_RETURN_NONE;
+    }
+
+    if (target) {
+        Py_INCREF(target);
+    } else {
+        target = PyDict_New();
+        if (!target) return NULL;
+    }
+
+    catzilla_clear_validation_errors(self->context);
+
+    // The walk builds Python objects as it goes, so it keeps the GIL
+    validation_result_t result = catzilla_validate_model_yyjson(self->model, root, self->context,
+                                                                model_emit_field, target);
+    if (result == VALIDATION_SUCCESS) {
+        return target;
+    }
+    Py_DECREF(target);
+
+    if (PyErr_Occurred()) {
+        return NULL;
+    }
+
+    char *error_msg = catzilla_get_validation_errors(self->context);
+    PyErr_SetString(PyExc_ValueError, error_msg ? error_msg : "Model validation failed");
+    if (error_msg) {
+        catzilla_request_free(error_msg);
+    }
+    return NULL;
+}
+
+// Validate a list of dicts: model.validate_batch(items, stop_on_first_error=False)
+// Items are split across the background task engine's workers when it runs.
+// Returns (results, errors): a validated dict per item, None for invalid ones
+// (and, when stopping at the first error, for every item after it), and
+// (index, field, message) tuples in item order.
+static PyObject* CatzillaModel_validate_batch(CatzillaModelObject *self, PyObject *args, PyObject *kwargs) {
+    static char *kwlist[] = {"items", "stop_on_first_error", NULL};
+    PyObject *items;
+    int stop_on_first_error = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|p", kwlist, &items, &stop_on_first_error)) {
+        return NULL;
+    }
+#ifndef _WIN32
+    catzilla_module_state_t *state = get_module_state(NULL);
+    if (!state) return NULL;
+    task_engine_t *engine = catzilla_atomic_load_seq(&state->task_engine);
+#endif
+
+    PyObject *sequence = PySequence_Fast(items, "items must be a sequence");
+    if (!sequence) return NULL;
+    Py_ssize_t size = PySequence_Fast_GET_SIZE(sequence);
+    if (size > INT_MAX) {
+        Py_DECREF(sequence);
+        PyErr_SetString(PyExc_OverflowError, "Too many items in one batch");
+        return NULL;
+    }
+    int count = (int)size;
+
+    json_object_t **data = catzilla_calloc((size_t)(count > 0 ? count : 1), sizeof(json_object_t*));
+    if (!data) {
+        Py_DECREF(sequence);
+        return PyErr_NoMemory();
+    }
+    // Items that are not dicts stay NULL and fail as non-objects
+    for (int i = 0; i < count; i++) {
+        PyObject *item = PySequence_Fast_GET_ITEM(sequence, i);
+        if (PyDict_Check(item)) data[i] = python_to_json_object(item);
+    }
+    Py_DECREF(sequence);
+
+    validation_batch_options_t options = {0};
+    options.stop_on_first_error = stop_on_first_error;
+#ifndef _WIN32
+    options.engine = engine;
+#endif
+
+    validation_context_t *ctx = catzilla_create_validation_context();
+    json_object_t **validated = NULL;
+    if (ctx) {
+        Py_BEGIN_ALLOW_THREADS
+        catzilla_batch_validate_with_options(self->model, data, count, &validated, ctx, &options);
+        Py_END_ALLOW_THREADS
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (data[i]) catzilla_free_json_object(data[i]);
+    }
+    catzilla_free(data);
+
+    if (!validated) {
+        catzilla_free_validation_context(ctx);
+        return PyErr_NoMemory();
+    }
+
+    PyObject *results = PyList_New(count);
+    PyObject *errors = PyList_New(0);
+    bool failed = !results || !errors;
+
+    for (int i = 0; i < count && !failed; i++) {
+        PyObject *item = json_object_to_python(validated[i]);
+        if (!item) {
+            failed = true;
+            break;
+        }
+        PyList_SET_ITEM(results, i, item);
+    }
+    for (validation_error_t *error = ctx->errors; error && !failed; error = error->next) {
+        PyObject *entry = Py_BuildValue("(iss)", error->item_index,
+                                        error->field_name ? error->field_name : "",
+                                        error->message ? error->message : "");
+        if (!entry || PyList_Append(errors, entry) != 0) failed = true;
+        Py_XDECREF(entry);
+    }
+
+    catzilla_free_batch_results(validated, count);
+    catzilla_free_validation_context(ctx);
+
+    if (failed) {
+        Py_XDECREF(results);
+        Py_XDECREF(errors);
+        return NULL;
+    }
+    return Py_BuildValue("(NN)", results, errors);
+}
+
 // Get validation statistics
 static PyObject* get_validation_stats(PyObject *self, PyObject *args) {
     validation_stats_t *stats = catzilla_get_validation_stats();
@@ -1570,7 +2390,7 @@ static PyObject* parse_json(PyObject *self, PyObject *args) {
     if (!PyArg_ParseTuple(args, "O", &capsule))
         return NULL;
 
-    request = (catzilla_request_t*)PyCapsule_GetPointer(capsule, "catzilla.request");
+    request = catzilla_request_from_object(capsule);
     if (!request) {
         PyErr_SetString(PyExc_TypeError, "Invalid request capsule");
         return NULL;
@@ -1591,7 +2411,7 @@ static PyObject* parse_form(PyObject *self, PyObject *args) {
     if (!PyArg_ParseTuple(args, "O", &capsule))
         return NULL;
 
-    request = (catzilla_request_t*)PyCapsule_GetPointer(capsule, "catzilla.request");
+    request = catzilla_request_from_object(capsule);
     if (!request) {
         PyErr_SetString(PyExc_TypeError, "Invalid request capsule");
         return NULL;
@@ -1604,9 +2424,9 @@ static PyObject* parse_form(PyObject *self, PyObject *args) {
     PyObject* form_dict = PyDict_New();
     if (!form_dict) return NULL;
 
-    for (int i = 0; i < request->form_field_count; i++) {
-        PyObject* key = PyUnicode_FromString(request->form_fields[i]);
-        PyObject* value = PyUnicode_FromString(request->form_values[i]);
+    for (int i = 0; i < request->form.count; i++) {
+        PyObject* key = PyUnicode_FromString(request->form.names[i]);
+        PyObject* value = PyUnicode_FromString(request->form.values[i]);
         if (!key || !value) {
             Py_XDECREF(key);
             Py_XDECREF(value);
@@ -1629,7 +2449,7 @@ static PyObject* get_json(PyObject *self, PyObject *args) {
     if (!PyArg_ParseTuple(args, "O", &capsule))
         return NULL;
 
-    request = (catzilla_request_t*)PyCapsule_GetPointer(capsule, "catzilla.request");
+    request = catzilla_request_from_object(capsule);
     if (!request) {
         PyErr_SetString(PyExc_TypeError, "Invalid request capsule");
         return NULL;
@@ -1652,7 +2472,7 @@ static PyObject* get_form_field(PyObject *self, PyObject *args) {
     if (!PyArg_ParseTuple(args, "Os", &capsule, &field))
         return NULL;
 
-    request = (catzilla_request_t*)PyCapsule_GetPointer(capsule, "catzilla.request");
+    request = catzilla_request_from_object(capsule);
     if (!request) {
         PyErr_SetString(PyExc_TypeError, "Invalid request capsule");
         return NULL;
@@ -1675,17 +2495,17 @@ static PyObject* get_header(PyObject *self, PyObject *args) {
     if (!PyArg_ParseTuple(args, "Os", &capsule, &header_name))
         return NULL;
 
-    request = (catzilla_request_t*)PyCapsule_GetPointer(capsule, "catzilla.request");
+    request = catzilla_request_from_object(capsule);
     if (!request) {
         PyErr_SetString(PyExc_TypeError, "Invalid request capsule");
         return NULL;
     }
 
-    // Search through headers array (case-insensitive)
-    for (int i = 0; i < request->header_count; i++) {
-        if (request->headers[i].name && strcasecmp(request->headers[i].name, header_name) == 0) {
-            return PyUnicode_FromString(request->headers[i].value ? request->headers[i].value : "");
-        }
+    // Well-known names hit the slot table, others scan case-insensitively
+    size_t value_length = 0;
+    const char* value = catzilla_header_set_get(&request->headers, header_name, &value_length);
+    if (value) {
+        return PyUnicode_FromStringAndSize(value, (Py_ssize_t)value_length);
     }
 
     Py_RETURN_NONE;
@@ -1697,7 +2517,7 @@ static PyObject* get_content_type(PyObject* self, PyObject* args) {
     if (!PyArg_ParseTuple(args, "O", &capsule))
         return NULL;
 
-    catzilla_request_t* request = PyCapsule_GetPointer(capsule, "catzilla.request");
+    catzilla_request_t* request = catzilla_request_from_object(capsule);
     if (!request) {
         PyErr_SetString(PyExc_RuntimeError, "Invalid request capsule");
         return NULL;
@@ -1708,6 +2528,25 @@ static PyObject* get_content_type(PyObject* self, PyObject* args) {
     return PyUnicode_FromString(content_type);
 }
 
+// get_body_file(request_capsule) - temp file path of a spooled body, or None
+static PyObject* get_body_file(PyObject* self, PyObject* args) {
+    (void)self;
+    PyObject* capsule;
+    if (!PyArg_ParseTuple(args, "O", &capsule))
+        return NULL;
+
+    catzilla_request_t* request = catzilla_request_from_object(capsule);
+    if (!request) {
+        PyErr_SetString(PyExc_RuntimeError, "Invalid request capsule");
+        return NULL;
+    }
+
+    if (!request->body_file) {
+        Py_RETURN_NONE;
+    }
+    return Py_BuildValue("(sK)", request->body_file, (unsigned long long)request->body_file_size);
+}
+
 // get_query_param(request_capsule, param_name)
 static PyObject* get_query_param(PyObject *self, PyObject *args)
 {
@@ -1716,7 +2555,7 @@ static PyObject* get_query_param(PyObject *self, PyObject *args)
     if (!PyArg_ParseTuple(args, "Os", &capsule, &param))
         return NULL;
 
-    catzilla_request_t *request = PyCapsule_GetPointer(capsule, "catzilla.request");
+    catzilla_request_t *request = catzilla_request_from_object(capsule);
     if (!request) {
         PyErr_SetString(PyExc_TypeError, "Invalid request capsule");
         return NULL;
@@ -1736,20 +2575,22 @@ static PyObject* get_query_params(PyObject *self, PyObject *args)
     if (!PyArg_ParseTuple(args, "O", &capsule))
         return NULL;
 
-    catzilla_request_t *request = PyCapsule_GetPointer(capsule, "catzilla.request");
+    catzilla_request_t *request = catzilla_request_from_object(capsule);
     if (!request) {
         PyErr_SetString(PyExc_TypeError, "Invalid request capsule");
         return NULL;
     }
 
+    catzilla_parse_query(request);
+
     PyObject *query_params = PyDict_New();
     if (!query_params) {
         return NULL;
     }
 
-    for (int i = 0; i < request->query_param_count; i++) {
-        const char *key = request->query_params[i];
-        const char *value = request->query_values[i];
+    for (int i = 0; i < request->query.count; i++) {
+        const char *key = request->query.names[i];
+        const char *value = request->query.values[i];
 
         if (!key || !value) {
             continue;
@@ -1786,7 +2627,7 @@ static PyObject* get_files(PyObject *self, PyObject *args) {
     }
 
     LOG_DEBUG("Bridge", "Getting request from capsule");
-    request = (catzilla_request_t*)PyCapsule_GetPointer(capsule, "catzilla.request");
+    request = catzilla_request_from_object(capsule);
     if (!request) {
         LOG_DEBUG("Bridge", "Invalid request capsule");
         PyErr_SetString(PyExc_TypeError, "Invalid request capsule");
@@ -1931,6 +2772,34 @@ static PyObject* get_files(PyObject *self, PyObject *args) {
             // Add state
             PyDict_SetItemString(file_info, "state", PyLong_FromLong(file->state));
 
+            // Virus scan verdict, and why the file failed (infected, or no verdict)
+            PyDict_SetItemString(file_info, "virus_scanned", file->virus_scanned ? Py_True : Py_False);
+            if (file->error_message) {
+                PyObject* error = PyUnicode_FromString(file->error_message);
+                if (error) {
+                    PyDict_SetItemString(file_info, "error", error);
+                    Py_DECREF(error);
+                }
+            }
+
+            // Digests computed while the file arrived
+            if (file->digest.complete && (file->digest.algorithms & CATZILLA_DIGEST_SHA256)) {
+                char hex[CATZILLA_SHA256_SIZE * 2 + 1];
+                catzilla_digest_to_hex(file->digest.sha256, CATZILLA_SHA256_SIZE, hex);
+                PyObject* sha256 = PyUnicode_FromString(hex);
+                if (sha256) {
+                    PyDict_SetItemString(file_info, "sha256", sha256);
+                    Py_DECREF(sha256);
+                }
+            }
+            if (file->digest.complete && (file->digest.algorithms & CATZILLA_DIGEST_CRC32C)) {
+                PyObject* crc32c = PyLong_FromUnsignedLong(file->digest.crc32c);
+                if (crc32c) {
+                    PyDict_SetItemString(file_info, "crc32c", crc32c);
+                    Py_DECREF(crc32c);
+                }
+            }
+
             // Use field_name as key, fallback to filename, or file_N if neither
             const char* key = file->field_name;
             char default_key[32];
@@ -1957,17 +2826,13 @@ static PyObject* router_match(PyObject *self, PyObject *args)
     if (!PyArg_ParseTuple(args, "ss", &method, &path))
         return NULL;
 
-    // Initialize global router if needed
-    if (!global_router_initialized) {
-        if (catzilla_router_init(&global_router) != 0) {
-            PyErr_SetString(PyExc_RuntimeError, "Failed to initialize global router");
-            return NULL;
-        }
-        global_router_initialized = true;
+    catzilla_router_t *router = get_module_router(self);
+    if (!router) {
+        return NULL;
     }
 
     catzilla_route_match_t match;
-    int result = catzilla_router_match(&global_router, method, path, &match);
+    int result = catzilla_router_match(router, method, path, &match);
 
     // Create Python dict with match results
     PyObject *match_dict = PyDict_New();
@@ -2013,9 +2878,13 @@ static PyObject* router_match(PyObject *self, PyObject *args)
             return NULL;
         }
         for (int i = 0; i < match.param_count; i++) {
-            PyObject *param_value_obj = PyUnicode_FromString(match.params[i].value);
+            const char *param_name = catzilla_router_match_param_name(&match, i);
+            if (!param_name) continue;
+            size_t param_len = 0;
+            const char *param_value = catzilla_router_match_param_value(&match, i, &param_len);
+            PyObject *param_value_obj = catzilla_path_param_to_python(match.route, i, param_value, param_len);
             if (!param_value_obj ||
-                PyDict_SetItemString(params_dict, match.params[i].name, param_value_obj) < 0) {
+                PyDict_SetItemString(params_dict, param_name, param_value_obj) < 0) {
                 Py_XDECREF(param_value_obj);
                 Py_DECREF(params_dict);
                 Py_DECREF(match_dict);
@@ -2040,7 +2909,9 @@ static PyObject* router_match(PyObject *self, PyObject *args)
     }
 
     if (match.has_allowed_methods) {
-        PyObject *allowed_methods_obj = PyUnicode_FromString(match.allowed_methods);
+        char allowed_methods[256];
+        catzilla_router_match_allowed_methods(&match, allowed_methods, sizeof(allowed_methods));
+        PyObject *allowed_methods_obj = PyUnicode_FromString(allowed_methods);
         if (!allowed_methods_obj ||
             PyDict_SetItemString(match_dict, "allowed_methods", allowed_methods_obj) < 0) {
             Py_XDECREF(allowed_methods_obj);
@@ -2066,17 +2937,13 @@ static PyObject* router_add_route(PyObject *self, PyObject *args)
     if (!PyArg_ParseTuple(args, "ssl", &method, &path, &handler_id))
         return NULL;
 
-    // Initialize global router if needed
-    if (!global_router_initialized) {
-        if (catzilla_router_init(&global_router) != 0) {
-            PyErr_SetString(PyExc_RuntimeError, "Failed to initialize global router");
-            return NULL;
-        }
-        global_router_initialized = true;
+    catzilla_router_t *router = get_module_router(self);
+    if (!router) {
+        return NULL;
     }
 
     // Add route to global router
-    uint32_t route_id = catzilla_router_add_route(&global_router, method, path,
+    uint32_t route_id = catzilla_router_add_route(router, method, path,
                                                  (void*)(uintptr_t)handler_id, NULL, false);
 
     if (route_id == 0) {
@@ -2096,15 +2963,11 @@ static PyObject* router_add_route_with_middleware(PyObject *self, PyObject *args
     PyObject *priority_list = NULL;
 
     if (!PyArg_ParseTuple(args, "ssl|OO", &method, &path, &handler_id, &middleware_list, &priority_list))
-        return NULL;
-
-    // Initialize global router if needed
-    if (!global_router_initialized) {
-        if (catzilla_router_init(&global_router) != 0) {
-            PyErr_SetString(PyExc_RuntimeError, "Failed to initialize global router");
-            return NULL;
-        }
-        global_router_initialized = true;
+        return NULL;
+
+    catzilla_router_t *router = get_module_router(self);
+    if (!router) {
+        return NULL;
     }
 
     // Prepare middleware arrays
@@ -2156,7 +3019,7 @@ static PyObject* router_add_route_with_middleware(PyObject *self, PyObject *args
     }
 
     // Add route to global router with middleware
-    uint32_t route_id = catzilla_router_add_route_with_middleware(&global_router, method, path,
+    uint32_t route_id = catzilla_router_add_route_with_middleware(router, method, path,
                                                                   (void*)(uintptr_t)handler_id, NULL, false,
                                                                   middleware_functions, middleware_count, middleware_priorities);
 
@@ -2288,6 +3151,436 @@ static PyObject* get_memory_stats(PyObject *self, PyObject *args)
     );
 }
 
+static PyObject* get_read_buffer_stats(PyObject *self, PyObject *args)
+{
+    (void)self;
+    (void)args;
+    catzilla_read_pool_stats_t stats;
+    catzilla_read_pool_get_stats(&stats);
+
+    return Py_BuildValue("{s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:d,s:K,s:K}",
+        "slab_hits", (unsigned long long)stats.slab_hits,
+        "slab_misses", (unsigned long long)stats.slab_misses,
+        "slab_releases", (unsigned long long)stats.slab_releases,
+        "slab_drops", (unsigned long long)stats.slab_drops,
+        "retained_bytes", (unsigned long long)stats.retained_bytes,
+        "sticky_reads", (unsigned long long)stats.sticky_reads,
+        "sticky_bytes", (unsigned long long)stats.sticky_bytes,
+        "hit_rate", stats.hit_rate,
+        "slab_size", (unsigned long long)CATZILLA_READ_SLAB_SIZE,
+        "max_retained_slabs", (unsigned long long)CATZILLA_READ_POOL_MAX_RETAINED
+    );
+}
+
+// start_allocation_profiler(lg_sample=0), 0 picks the default sample rate
+static PyObject* start_allocation_profiler(PyObject *self, PyObject *args)
+{
+    (void)self;
+    unsigned int lg_sample = 0;
+    if (!PyArg_ParseTuple(args, "|I", &lg_sample))
+        return NULL;
+
+    if (catzilla_memory_profiler_start(lg_sample) != 0) {
+        PyErr_SetString(PyExc_RuntimeError, catzilla_memory_profiler_available()
+                        ? "Sample rate out of range (lg_sample must be at most 40)"
+                        : "jemalloc heap profiling is not available in this build");
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject* stop_allocation_profiler(PyObject *self, PyObject *args)
+{
+    (void)self;
+    (void)args;
+    catzilla_memory_profiler_stop();
+    Py_RETURN_NONE;
+}
+
+// dump_allocation_profile(path)
+static PyObject* dump_allocation_profile(PyObject *self, PyObject *args)
+{
+    (void)self;
+    const char* path;
+    if (!PyArg_ParseTuple(args, "s", &path))
+        return NULL;
+
+    int rc;
+    Py_BEGIN_ALLOW_THREADS
+    rc = catzilla_memory_profiler_dump(path);
+    Py_END_ALLOW_THREADS
+    if (rc != 0) {
+        PyErr_Format(PyExc_RuntimeError, "Cannot write a heap profile to %s", path);
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject* get_allocation_profiler_status(PyObject *self, PyObject *args)
+{
+    (void)self;
+    (void)args;
+    catzilla_profiler_status_t status;
+    catzilla_memory_profiler_get_status(&status);
+
+    return Py_BuildValue("{s:O,s:O,s:I,s:K}",
+        "available", status.available ? Py_True : Py_False,
+        "active", status.active ? Py_True : Py_False,
+        "lg_sample", status.lg_sample,
+        "dumps", (unsigned long long)status.dumps
+    );
+}
+
+static PyObject* get_request_arena_stats(PyObject *self, PyObject *args)
+{
+    (void)self;
+    (void)args;
+    catzilla_arena_stats_t stats;
+    catzilla_arena_get_stats(&stats);
+
+    return Py_BuildValue("{s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:d,s:K,s:K}",
+        "resets", (unsigned long long)stats.resets,
+        "bytes", (unsigned long long)stats.bytes,
+        "peak_bytes", (unsigned long long)stats.peak_bytes,
+        "large_allocations", (unsigned long long)stats.large_allocations,
+        "block_hits", (unsigned long long)stats.block_hits,
+        "block_misses", (unsigned long long)stats.block_misses,
+        "retained_bytes", (unsigned long long)stats.retained_bytes,
+        "bytes_per_request", stats.bytes_per_request,
+        "block_size", (unsigned long long)CATZILLA_ARENA_BLOCK_SIZE,
+        "large_threshold", (unsigned long long)CATZILLA_ARENA_LARGE_THRESHOLD
+    );
+}
+
+#ifndef _WIN32
+static void release_python_task(catzilla_task_t* task)
+{
+    Py_CLEAR(*(PyObject**)&task->py_task.py_func);
+    Py_CLEAR(*(PyObject**)&task->py_task.py_args);
+    Py_CLEAR(*(PyObject**)&task->py_task.py_kwargs);
+}
+
+// Runs on task engine workers; the whole batch shares one GIL hold
+static int run_python_task_batch(catzilla_task_t** tasks, int count, uint64_t slice_ns, void* context)
+{
+    (void)context;
+    uint64_t started = catzilla_get_nanoseconds();
+    int ran = 0;
+
+    PyGILState_STATE gstate = PyGILState_Ensure();
+    while (ran < count) {
+        catzilla_task_t* task = tasks[ran++];
+        PyObject* result = PyObject_Call((PyObject*)task->py_task.py_func,
+                                         (PyObject*)task->py_task.py_args,
+                                         (PyObject*)task->py_task.py_kwargs);
+        if (result) {
+            Py_DECREF(result);
+            task->status = TASK_STATUS_COMPLETED;
+        } else {
+            PyErr_WriteUnraisable((PyObject*)task->py_task.py_func);
+            task->status = TASK_STATUS_FAILED;
+        }
+        if (task->status == TASK_STATUS_COMPLETED || task->current_retries >= task->max_retries) {
+            release_python_task(task);
+        }
+        if (catzilla_get_nanoseconds() - started >= slice_ns) break;
+    }
+    PyGILState_Release(gstate);
+    return ran;
+}
+
+// start_task_engine(workers=2, min_workers=1, max_workers=0, queue_size=10000, slice_us=2000)
+static PyObject* start_task_engine(PyObject *self, PyObject *args)
+{
+    int workers = 2, min_workers = 1, max_workers = 0;
+    unsigned long long queue_size = 10000, slice_us = TASK_PYTHON_DEFAULT_SLICE_US;
+    if (!PyArg_ParseTuple(args, "|iiiKK", &workers, &min_workers, &max_workers, &queue_size, &slice_us)) {
+        return NULL;
+    }
+    catzilla_module_state_t *state = get_module_state(self);
+    if (!state) return NULL;
+    if (catzilla_atomic_load_seq(&state->task_engine)) {
+        PyErr_SetString(PyExc_RuntimeError, "Task engine is already running");
+        return NULL;
+    }
+    if (max_workers <= 0) max_workers = workers * 2;
+
+    task_engine_t* engine = catzilla_task_engine_create(workers, min_workers, max_workers,
+                                                        (size_t)queue_size, true, 0);
+    if (!engine) {
+        PyErr_SetString(PyExc_ValueError, "Invalid task engine configuration");
+        return NULL;
+    }
+    if (catzilla_task_engine_set_python_runner(engine, run_python_task_batch, NULL, slice_us) != 0) {
+        catzilla_task_engine_destroy(engine);
+        PyErr_SetString(PyExc_ValueError, "slice_us must be positive");
+        return NULL;
+    }
+    if (catzilla_atomic_publish_ptr(&state->task_engine, engine) != engine) {
+        // Another thread started one meanwhile
+        catzilla_task_engine_destroy(engine);
+        PyErr_SetString(PyExc_RuntimeError, "Task engine is already running");
+        return NULL;
+    }
+    catzilla_task_engine_start(engine);
+    Py_RETURN_NONE;
+}
+
+// add_python_task(func, args=(), kwargs=None, priority=2, delay_ms=0, max_retries=0)
+static PyObject* add_python_task(PyObject *self, PyObject *args)
+{
+    PyObject *func, *call_args = NULL, *call_kwargs = Py_None;
+    int priority = TASK_PRIORITY_NORMAL, max_retries = 0;
+    unsigned long long delay_ms = 0;
+    if (!PyArg_ParseTuple(args, "O|O!OiKi", &func, &PyTuple_Type, &call_args, &call_kwargs,
+                          &priority, &delay_ms, &max_retries)) {
+        return NULL;
+    }
+    catzilla_module_state_t *state = get_module_state(self);
+    if (!state) return NULL;
+    task_engine_t* engine = catzilla_atomic_load_seq(&state->task_engine);
+    if (!engine) {
+        PyErr_SetString(PyExc_RuntimeError, "Task engine is not running");
+        return NULL;
+    }
+    if (!PyCallable_Check(func) || (call_kwargs != Py_None && !PyDict_Check(call_kwargs))) {
+        PyErr_SetString(PyExc_TypeError, "Expected a callable, an argument tuple and a keyword dict");
+        return NULL;
+    }
+
+    PyObject* arg_tuple = call_args ? call_args : PyTuple_New(0);
+    if (!arg_tuple) return NULL;
+    if (call_args) Py_INCREF(arg_tuple);
+    PyObject* kwargs = call_kwargs == Py_None ? NULL : call_kwargs;
+    Py_XINCREF(kwargs);
+    Py_INCREF(func);
+
+    uint64_t task_id = catzilla_task_add_python(engine, func, arg_tuple, kwargs,
+                                                (task_priority_t)priority, delay_ms, max_retries);
+    if (task_id == 0) {
+        Py_DECREF(func);
+        Py_DECREF(arg_tuple);
+        Py_XDECREF(kwargs);
+        PyErr_SetString(PyExc_RuntimeError, "Task queue is full or priority is invalid");
+        return NULL;
+    }
+    return PyLong_FromUnsignedLongLong(task_id);
+}
+
+static PyObject* get_task_engine_stats(PyObject *self, PyObject *args)
+{
+    (void)args;
+    catzilla_module_state_t *state = get_module_state(self);
+    if (!state) return NULL;
+    task_engine_t* engine = catzilla_atomic_load_seq(&state->task_engine);
+    if (!engine) Py_RETURN_NONE;
+
+    task_engine_stats_t stats = catzilla_task_engine_get_stats(engine);
+    return Py_BuildValue("{s:K,s:i,s:i,s:K,s:d,s:d,s:d,s:K,s:K,s:K,s:K,s:K,s:i,s:K,s:K,s:K}",
+        "total_queued", (unsigned long long)stats.total_queued,
+        "active_workers", stats.active_workers,
+        "total_workers", stats.total_workers,
+        "tasks_per_second", (unsigned long long)stats.tasks_per_second,
+        "avg_execution_time_ms", stats.avg_execution_time_ms,
+        "p95_execution_time_ms", stats.p95_execution_time_ms,
+        "p99_execution_time_ms", stats.p99_execution_time_ms,
+        "total_tasks_processed", (unsigned long long)stats.total_tasks_processed,
+        "failed_tasks", (unsigned long long)stats.failed_tasks,
+        "retry_count", (unsigned long long)stats.retry_count,
+        "delayed_tasks", (unsigned long long)stats.delayed_tasks,
+        "steal_count", (unsigned long long)stats.steal_count,
+        "python_batch_size", stats.python_batch_size,
+        "python_batches", (unsigned long long)stats.python_batches,
+        "python_batched_tasks", (unsigned long long)stats.python_batched_tasks,
+        "python_slice_stops", (unsigned long long)stats.python_slice_stops
+    );
+}
+
+// stop_task_engine(wait=True)
+static PyObject* stop_task_engine(PyObject *self, PyObject *args)
+{
+    int wait = 1;
+    if (!PyArg_ParseTuple(args, "|p", &wait)) return NULL;
+    catzilla_module_state_t *state = get_module_state(self);
+    if (!state) return NULL;
+    task_engine_t* engine = catzilla_atomic_take_ptr(&state->task_engine);
+    if (!engine) Py_RETURN_NONE;
+
+    // Workers need the GIL to finish Python tasks
+    Py_BEGIN_ALLOW_THREADS
+    catzilla_task_engine_stop(engine, wait);
+    catzilla_task_engine_destroy(engine);
+    Py_END_ALLOW_THREADS
+    Py_RETURN_NONE;
+}
+#endif
+
+static PyObject* compression_encoding_stats(const catzilla_compress_encoding_stats_t* stats)
+{
+    return Py_BuildValue("{s:K,s:K,s:K,s:K,s:K}",
+        "responses", (unsigned long long)stats->responses,
+        "skipped", (unsigned long long)stats->skipped,
+        "bytes_in", (unsigned long long)stats->bytes_in,
+        "bytes_out", (unsigned long long)stats->bytes_out,
+        "cpu_ns", (unsigned long long)stats->cpu_ns
+    );
+}
+
+static PyObject* get_compression_stats(PyObject *self, PyObject *args)
+{
+    (void)self;
+    (void)args;
+    catzilla_compression_stats_t stats;
+    catzilla_compression_get_stats(&stats);
+
+    int available = catzilla_compression_available();
+    PyObject* encodings = PyList_New(0);
+    if (!encodings) return NULL;
+    const int codings[] = { CATZILLA_ENCODING_ZSTD, CATZILLA_ENCODING_BR, CATZILLA_ENCODING_GZIP };
+    for (int i = 0; i < 3; i++) {
+        if (!(available & codings[i])) continue;
+        PyObject* name = PyUnicode_FromString(catzilla_compression_encoding_name(codings[i]));
+        if (!name || PyList_Append(encodings, name) != 0) {
+            Py_XDECREF(name);
+            Py_DECREF(encodings);
+            return NULL;
+        }
+        Py_DECREF(name);
+    }
+
+    return Py_BuildValue("{s:N,s:N,s:N,s:N,s:K,s:K}",
+        "available", encodings,
+        "gzip", compression_encoding_stats(&stats.gzip),
+        "br", compression_encoding_stats(&stats.br),
+        "zstd", compression_encoding_stats(&stats.zstd),
+        "buffer_hits", (unsigned long long)stats.buffer_hits,
+        "buffer_misses", (unsigned long long)stats.buffer_misses
+    );
+}
+
+static PyObject* get_connection_stats(PyObject *self, PyObject *args)
+{
+    (void)self;
+    (void)args;
+    catzilla_connection_stats_t stats;
+    catzilla_server_get_connection_stats(&stats);
+
+    uint64_t lookups = stats.context_pool_hits + stats.context_pool_misses;
+    double hit_rate = lookups > 0 ? (double)stats.context_pool_hits / (double)lookups : 0.0;
+
+    return Py_BuildValue("{s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:d,s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K}",
+        "connections_accepted", (unsigned long long)stats.connections_accepted,
+        "accept_errors", (unsigned long long)stats.accept_errors,
+        "active_connections", (unsigned long long)stats.active_connections,
+        "context_pool_hits", (unsigned long long)stats.context_pool_hits,
+        "context_pool_misses", (unsigned long long)stats.context_pool_misses,
+        "context_pool_drops", (unsigned long long)stats.context_pool_drops,
+        "pooled_contexts", (unsigned long long)stats.pooled_contexts,
+        "context_pool_hit_rate", hit_rate,
+        "header_timeouts", (unsigned long long)stats.header_timeouts,
+        "body_timeouts", (unsigned long long)stats.body_timeouts,
+        "keepalive_timeouts", (unsigned long long)stats.keepalive_timeouts,
+        "write_timeouts", (unsigned long long)stats.write_timeouts,
+        "accept_pauses", (unsigned long long)stats.accept_pauses,
+        "accept_resumes", (unsigned long long)stats.accept_resumes,
+        "tls_handshakes", (unsigned long long)stats.tls_handshakes,
+        "tls_resumptions", (unsigned long long)stats.tls_resumptions,
+        "tls_handshake_failures", (unsigned long long)stats.tls_handshake_failures,
+        "ktls_offloads", (unsigned long long)stats.ktls_offloads,
+        "native_responses", (unsigned long long)stats.native_responses,
+        "response_cache_hits", (unsigned long long)stats.response_cache_hits,
+        "response_cache_misses", (unsigned long long)stats.response_cache_misses,
+        "response_cache_stores", (unsigned long long)stats.response_cache_stores,
+        "response_cache_remote_hits", (unsigned long long)stats.response_cache_remote_hits,
+        "response_cache_not_modified", (unsigned long long)stats.response_cache_not_modified,
+        "python_batches", (unsigned long long)stats.python_batches,
+        "python_batched_requests", (unsigned long long)stats.python_batched_requests,
+        "python_batch_largest", (unsigned long long)stats.python_batch_largest,
+        "python_batch_budget_stops", (unsigned long long)stats.python_batch_budget_stops,
+        "corked_flushes", (unsigned long long)stats.corked_flushes,
+        "corked_responses", (unsigned long long)stats.corked_responses,
+        "memory_pressure_level", (unsigned long long)stats.memory_pressure_level,
+        "memory_pressure_events", (unsigned long long)stats.memory_pressure_events,
+        "memory_shrinks", (unsigned long long)stats.memory_shrinks,
+        "memory_rss", (unsigned long long)stats.memory_rss,
+        "pressure_rejections", (unsigned long long)stats.pressure_rejections
+    );
+}
+
+static PyObject* latency_phase_dict(const catzilla_histogram_t* histogram)
+{
+    return Py_BuildValue("{s:K,s:d,s:d,s:d,s:d,s:d}",
+        "count", (unsigned long long)histogram->count,
+        "sum", (double)histogram->sum_ns / 1e9,
+        "max", (double)histogram->max_ns / 1e9,
+        "p50", (double)catzilla_histogram_percentile(histogram, 50.0) / 1e9,
+        "p90", (double)catzilla_histogram_percentile(histogram, 90.0) / 1e9,
+        "p99", (double)catzilla_histogram_percentile(histogram, 99.0) / 1e9
+    );
+}
+
+// Per-route latency merged over all loops, in seconds
+static PyObject* get_route_latency(PyObject *self, PyObject *args)
+{
+    (void)self;
+    (void)args;
+    size_t count = 0;
+    catzilla_route_metrics_t* routes = catzilla_metrics_snapshot(&count);
+    PyObject* result = PyList_New(0);
+    if (!result) {
+        catzilla_metrics_snapshot_free(routes);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        catzilla_route_metrics_t* route = &routes[i];
+        PyObject* queue = latency_phase_dict(&route->phases[CATZILLA_LATENCY_QUEUE]);
+        PyObject* gil = latency_phase_dict(&route->phases[CATZILLA_LATENCY_GIL]);
+        PyObject* handler = latency_phase_dict(&route->phases[CATZILLA_LATENCY_HANDLER]);
+        PyObject* write = latency_phase_dict(&route->phases[CATZILLA_LATENCY_WRITE]);
+        PyObject* entry = (queue && gil && handler && write)
+            ? Py_BuildValue("{s:s,s:s,s:O,s:O,s:O,s:O,s:{s:K,s:K,s:K,s:K}}",
+                            "method", route->method, "path", route->path,
+                            "queue", queue, "gil", gil, "handler", handler, "write", write,
+                            "counters",
+                            "counted", (unsigned long long)route->counted,
+                            "cycles", (unsigned long long)route->counters[CATZILLA_PERF_CYCLES],
+                            "instructions", (unsigned long long)route->counters[CATZILLA_PERF_INSTRUCTIONS],
+                            "cache_misses", (unsigned long long)route->counters[CATZILLA_PERF_CACHE_MISSES])
+            : NULL;
+        Py_XDECREF(queue);
+        Py_XDECREF(gil);
+        Py_XDECREF(handler);
+        Py_XDECREF(write);
+        if (!entry || PyList_Append(result, entry) < 0) {
+            Py_XDECREF(entry);
+            Py_DECREF(result);
+            catzilla_metrics_snapshot_free(routes);
+            return NULL;
+        }
+        Py_DECREF(entry);
+    }
+    catzilla_metrics_snapshot_free(routes);
+    return result;
+}
+
+// set_counter_sampling(one_in): measure one handler in one_in with the loop's
+// hardware counters (0 = off). Returns whether this thread can open them.
+static PyObject* set_counter_sampling(PyObject *self, PyObject *args)
+{
+    (void)self;
+    unsigned int one_in = 0;
+    if (!PyArg_ParseTuple(args, "I", &one_in)) {
+        return NULL;
+    }
+    if (one_in > 0 && !catzilla_perf_available()) {
+        catzilla_perf_set_sample_interval(0);
+        Py_RETURN_FALSE;
+    }
+    catzilla_perf_set_sample_interval(one_in);
+    Py_RETURN_TRUE;
+}
+
 // Parse multipart form data from request
 static PyObject* multipart_parse(PyObject *self, PyObject *args) {
     PyObject* manager_capsule = NULL;  // Not used for now, keep for compatibility
@@ -2325,9 +3618,9 @@ static PyObject* multipart_parse(PyObject *self, PyObject *args) {
 
     if (parse_result == 0) {
         // Extract form fields from parsed data
-        for (int i = 0; i < temp_request.form_field_count; i++) {
-            PyObject* key = PyUnicode_FromString(temp_request.form_fields[i]);
-            PyObject* value = PyUnicode_FromString(temp_request.form_values[i]);
+        for (int i = 0; i < temp_request.form.count; i++) {
+            PyObject* key = PyUnicode_FromString(temp_request.form.names[i]);
+            PyObject* value = PyUnicode_FromString(temp_request.form.values[i]);
             if (key && value) {
                 PyDict_SetItem(result_dict, key, value);
             }
@@ -2365,6 +3658,10 @@ static PyTypeObject CatzillaValidatorType = {
 // Model methods
 static PyMethodDef CatzillaModel_methods[] = {
     {"validate", (PyCFunction)CatzillaModel_validate, METH_VARARGS, "Validate data against model"},
+    {"validate_request", (PyCFunction)CatzillaModel_validate_request, METH_VARARGS,
+     "Validate a request's JSON body against the model, filling an optional target dict"},
+    {"validate_batch", (PyCFunction)(void(*)(void))CatzillaModel_validate_batch, METH_VARARGS | METH_KEYWORDS,
+     "Validate a list of dicts, on the task engine's workers when it runs; returns (results, errors)"},
     {NULL}
 };
 
@@ -2583,6 +3880,33 @@ static PyObject* CatzillaCache_exists(CatzillaCacheObject *self, PyObject *args)
     return PyBool_FromLong(exists);
 }
 
+// Cache save_snapshot method
+static PyObject* CatzillaCache_save_snapshot(CatzillaCacheObject *self, PyObject *args) {
+    const char *path;
+
+    if (!PyArg_ParseTuple(args, "s", &path)) {
+        return NULL;
+    }
+
+    int result;
+    Py_BEGIN_ALLOW_THREADS
+    result = catzilla_cache_save_snapshot(self->cache, path);
+    Py_END_ALLOW_THREADS
+    return PyBool_FromLong(result == 0);
+}
+
+// Cache load_snapshot method
+static PyObject* CatzillaCache_load_snapshot(CatzillaCacheObject *self, PyObject *args) {
+    const char *path;
+
+    if (!PyArg_ParseTuple(args, "s", &path)) {
+        return NULL;
+    }
+
+    int result = catzilla_cache_load_snapshot(self->cache, path);
+    return PyBool_FromLong(result == 0);
+}
+
 // Cache methods
 static PyMethodDef CatzillaCache_methods[] = {
     {"set", (PyCFunction)CatzillaCache_set, METH_VARARGS | METH_KEYWORDS, "Set a cache value"},
@@ -2591,6 +3915,8 @@ static PyMethodDef CatzillaCache_methods[] = {
     {"clear", (PyCFunction)CatzillaCache_clear, METH_NOARGS, "Clear all cache values"},
     {"get_stats", (PyCFunction)CatzillaCache_get_stats, METH_NOARGS, "Get cache statistics"},
     {"exists", (PyCFunction)CatzillaCache_exists, METH_VARARGS, "Check if key exists"},
+    {"save_snapshot", (PyCFunction)CatzillaCache_save_snapshot, METH_VARARGS, "Write live entries to a snapshot file"},
+    {"load_snapshot", (PyCFunction)CatzillaCache_load_snapshot, METH_VARARGS, "Restore entries from a snapshot file as keys are used"},
     {NULL}  // Sentinel
 };
 
@@ -2608,11 +3934,233 @@ static PyTypeObject CatzillaCacheType = {
     .tp_methods = CatzillaCache_methods,
 };
 
+static void CatzillaTaskLog_dealloc(CatzillaTaskLogObject *self) {
+    if (self->log) {
+        catzilla_task_log_t *log = self->log;
+        self->log = NULL;
+        Py_BEGIN_ALLOW_THREADS
+        catzilla_task_log_close(log);
+        Py_END_ALLOW_THREADS
+    }
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+// TaskLog(directory, segment_size=0, sync_interval_ms=0)
+static int CatzillaTaskLog_init(CatzillaTaskLogObject *self, PyObject *args, PyObject *kwds) {
+    const char *directory;
+    Py_ssize_t segment_size = 0;
+    unsigned int sync_interval_ms = 0;
+
+    static char *kwlist[] = {"directory", "segment_size", "sync_interval_ms", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "s|nI", kwlist, &directory, &segment_size, &sync_interval_ms)) {
+        return -1;
+    }
+    if (segment_size < 0) {
+        PyErr_SetString(PyExc_ValueError, "segment_size must not be negative");
+        return -1;
+    }
+
+    catzilla_task_log_config_t config = {0};
+    config.segment_size = (size_t)segment_size;
+    config.sync_interval_ms = sync_interval_ms;
+
+    catzilla_task_log_t *log;
+    Py_BEGIN_ALLOW_THREADS
+    log = catzilla_task_log_open(directory, &config);
+    Py_END_ALLOW_THREADS
+    if (!log) {
+        PyErr_Format(PyExc_OSError, "Cannot open task log in %s", directory);
+        return -1;
+    }
+    if (self->log) catzilla_task_log_close(self->log);
+    self->log = log;
+    return 0;
+}
+
+static bool task_log_ready(CatzillaTaskLogObject *self) {
+    if (self->log) return true;
+    PyErr_SetString(PyExc_RuntimeError, "Task log is closed");
+    return false;
+}
+
+// append(payload, durable=True) -> entry id
+static PyObject* CatzillaTaskLog_append(CatzillaTaskLogObject *self, PyObject *args, PyObject *kwds) {
+    Py_buffer payload;
+    int durable = 1;
+
+    static char *kwlist[] = {"payload", "durable", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "y*|p", kwlist, &payload, &durable)) {
+        return NULL;
+    }
+    if (!task_log_ready(self)) {
+        PyBuffer_Release(&payload);
+        return NULL;
+    }
+
+    uint64_t entry_id = 0;
+    int result;
+    // Durable appends wait for the group commit
+    Py_BEGIN_ALLOW_THREADS
+    result = catzilla_task_log_append(self->log, payload.buf, (size_t)payload.len, durable, &entry_id);
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&payload);
+
+    if (result != 0) {
+        PyErr_SetString(PyExc_OSError, "Failed to append to the task log");
+        return NULL;
+    }
+    return PyLong_FromUnsignedLongLong(entry_id);
+}
+
+static PyObject* CatzillaTaskLog_complete(CatzillaTaskLogObject *self, PyObject *args) {
+    unsigned long long entry_id;
+    if (!PyArg_ParseTuple(args, "K", &entry_id)) return NULL;
+    if (!task_log_ready(self)) return NULL;
+
+    return PyBool_FromLong(catzilla_task_log_complete(self->log, entry_id) == 0);
+}
+
+typedef struct {
+    PyObject *list;
+    bool failed;
+} task_log_pending_t;
+
+static void collect_pending_task(uint64_t entry_id, const void* payload, size_t size, void* context) {
+    task_log_pending_t *pending = context;
+    if (pending->failed) return;
+
+    PyObject *item = Py_BuildValue("(Ky#)", (unsigned long long)entry_id, (const char*)payload, (Py_ssize_t)size);
+    if (!item || PyList_Append(pending->list, item) != 0) pending->failed = true;
+    Py_XDECREF(item);
+}
+
+// pending() -> [(entry_id, payload), ...] oldest first
+static PyObject* CatzillaTaskLog_pending(CatzillaTaskLogObject *self, PyObject *args) {
+    (void)args;
+    if (!task_log_ready(self)) return NULL;
+
+    task_log_pending_t pending = { PyList_New(0), false };
+    if (!pending.list) return NULL;
+    if (catzilla_task_log_replay(self->log, collect_pending_task, &pending) < 0 && !pending.failed) {
+        PyErr_SetString(PyExc_OSError, "Failed to read the task log");
+        pending.failed = true;
+    }
+    if (pending.failed) {
+        Py_DECREF(pending.list);
+        return NULL;
+    }
+    return pending.list;
+}
+
+static PyObject* CatzillaTaskLog_sync(CatzillaTaskLogObject *self, PyObject *args) {
+    (void)args;
+    if (!task_log_ready(self)) return NULL;
+
+    int result;
+    Py_BEGIN_ALLOW_THREADS
+    result = catzilla_task_log_sync(self->log);
+    Py_END_ALLOW_THREADS
+    return PyBool_FromLong(result == 0);
+}
+
+static PyObject* CatzillaTaskLog_compact(CatzillaTaskLogObject *self, PyObject *args) {
+    (void)args;
+    if (!task_log_ready(self)) return NULL;
+
+    int dropped;
+    Py_BEGIN_ALLOW_THREADS
+    dropped = catzilla_task_log_compact(self->log);
+    Py_END_ALLOW_THREADS
+    return PyLong_FromLong(dropped);
+}
+
+static PyObject* CatzillaTaskLog_get_stats(CatzillaTaskLogObject *self, PyObject *args) {
+    (void)args;
+    catzilla_task_log_stats_t stats;
+    catzilla_task_log_get_stats(self->log, &stats);
+
+    return Py_BuildValue("{s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K}",
+                         "pending", (unsigned long long)stats.pending,
+                         "appended", (unsigned long long)stats.appended,
+                         "completed", (unsigned long long)stats.completed,
+                         "replayed", (unsigned long long)stats.replayed,
+                         "syncs", (unsigned long long)stats.syncs,
+                         "segments", (unsigned long long)stats.segments,
+                         "disk_bytes", (unsigned long long)stats.disk_bytes,
+                         "compactions", (unsigned long long)stats.compactions,
+                         "moved", (unsigned long long)stats.moved);
+}
+
+static PyObject* CatzillaTaskLog_close(CatzillaTaskLogObject *self, PyObject *args) {
+    (void)args;
+    if (self->log) {
+        catzilla_task_log_t *log = self->log;
+        self->log = NULL;
+        Py_BEGIN_ALLOW_THREADS
+        catzilla_task_log_close(log);
+        Py_END_ALLOW_THREADS
+    }
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef CatzillaTaskLog_methods[] = {
+    {"append", (PyCFunction)(void(*)(void))CatzillaTaskLog_append, METH_VARARGS | METH_KEYWORDS, "Append a task payload; durable waits for the group commit"},
+    {"complete", (PyCFunction)CatzillaTaskLog_complete, METH_VARARGS, "Record that a task has run"},
+    {"pending", (PyCFunction)CatzillaTaskLog_pending, METH_NOARGS, "List (entry_id, payload) of tasks not yet completed, oldest first"},
+    {"sync", (PyCFunction)CatzillaTaskLog_sync, METH_NOARGS, "fsync every append so far"},
+    {"compact", (PyCFunction)CatzillaTaskLog_compact, METH_NOARGS, "Drop old segments whose tasks are done"},
+    {"get_stats", (PyCFunction)CatzillaTaskLog_get_stats, METH_NOARGS, "Get task log statistics"},
+    {"close", (PyCFunction)CatzillaTaskLog_close, METH_NOARGS, "Sync and close the log"},
+    {NULL}  // Sentinel
+};
+
+static PyTypeObject CatzillaTaskLogType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "catzilla.TaskLog",
+    .tp_doc = "Durable write-ahead log for background tasks",
+    .tp_basicsize = sizeof(CatzillaTaskLogObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = PyType_GenericNew,
+    .tp_init = (initproc)CatzillaTaskLog_init,
+    .tp_dealloc = (destructor)CatzillaTaskLog_dealloc,
+    .tp_methods = CatzillaTaskLog_methods,
+};
+
 // Method tables and module definition
 static PyMethodDef CatzillaServer_methods[] = {
-    {"listen",    (PyCFunction)CatzillaServer_listen,   METH_VARARGS, "Start listening"},
+    {"listen",    (PyCFunction)CatzillaServer_listen,   METH_VARARGS, "Start listening (port, host, workers: 0 = one loop per CPU)"},
     {"add_route", (PyCFunction)CatzillaServer_add_route, METH_VARARGS, "Add HTTP route"},
+    {"add_routes", (PyCFunction)CatzillaServer_add_routes, METH_VARARGS, "Add HTTP routes from a sequence of (method, path, route_id, route_info) tuples, all dispatching to one handler"},
+    {"remove_route", (PyCFunction)CatzillaServer_remove_route, METH_VARARGS, "Remove an HTTP route; returns False if none matched"},
+    {"add_websocket_route", (PyCFunction)CatzillaServer_add_websocket_route, METH_VARARGS, "Accept WebSocket upgrades on a path; handler(ws) runs per connection"},
+    {"set_websocket_options", (PyCFunction)CatzillaServer_set_websocket_options, METH_VARARGS, "Set WebSocket ping interval and pong timeout (ms), message and send queue limits (bytes, 0 = unlimited) and deflate"},
     {"stop",      (PyCFunction)CatzillaServer_stop,      METH_NOARGS,  "Stop server"},
+    {"set_context_pool_limit", (PyCFunction)CatzillaServer_set_context_pool_limit, METH_VARARGS, "Set per-loop pooled connection context high-water mark"},
+    {"set_max_body_size", (PyCFunction)CatzillaServer_set_max_body_size, METH_VARARGS, "Set default request body limit in bytes (0 = unlimited)"},
+    {"set_http2", (PyCFunction)CatzillaServer_set_http2, METH_VARARGS, "Accept prior-knowledge HTTP/2 (h2c) connections"},
+    {"set_compression", (PyCFunction)(void(*)(void))CatzillaServer_set_compression, METH_VARARGS | METH_KEYWORDS, "Compress responses with gzip, br or zstd as clients accept them"},
+    {"set_timeouts", (PyCFunction)CatzillaServer_set_timeouts, METH_VARARGS, "Set header, body, keep-alive and write timeouts in milliseconds (0 = none)"},
+    {"set_max_connections", (PyCFunction)CatzillaServer_set_max_connections, METH_VARARGS, "Pause accepting at this many open connections (0 = unlimited)"},
+    {"set_python_batching", (PyCFunction)CatzillaServer_set_python_batching, METH_VARARGS, "Set requests per GIL hold (1 = no batching) and the batch time budget in microseconds"},
+    {"set_memory_budget", (PyCFunction)CatzillaServer_set_memory_budget, METH_VARARGS, "Set the resident memory budget in bytes, the check interval in ms and the upload limit under pressure"},
+    {"set_heap_profile_endpoint", (PyCFunction)CatzillaServer_set_heap_profile_endpoint, METH_VARARGS, "Serve the sampled heap profile at a GET path"},
+    {"set_metrics_endpoint", (PyCFunction)CatzillaServer_set_metrics_endpoint, METH_VARARGS, "Serve Prometheus metrics at a GET path and record route latency"},
+    {"set_latency_metrics", (PyCFunction)CatzillaServer_set_latency_metrics, METH_VARARGS, "Record per-route latency histograms"},
+    {"set_tls", (PyCFunction)CatzillaServer_set_tls, METH_VARARGS, "Terminate TLS with a PEM certificate chain and key, optionally offloading to kTLS"},
+    {"set_route_body_mode", (PyCFunction)CatzillaServer_set_route_body_mode, METH_VARARGS, "Set a route's body mode ('buffered' or 'spool') and limits"},
+    {"set_native_response", (PyCFunction)CatzillaServer_set_native_response, METH_VARARGS, "Serve a precomputed response for a route from C, replacing any previous one"},
+    {"set_route_cache", (PyCFunction)CatzillaServer_set_route_cache, METH_VARARGS, "Cache a route's responses in C (ttl 0 stops caching)"},
+    {"set_response_cache_disk", (PyCFunction)CatzillaServer_set_response_cache_disk, METH_VARARGS, "Also keep cached responses in memory-mapped segment files under a directory"},
+    {"set_response_cache_redis", (PyCFunction)CatzillaServer_set_response_cache_redis, METH_VARARGS, "Share cached responses with other nodes through Redis"},
+    {"set_clamd", (PyCFunction)CatzillaServer_set_clamd, METH_VARARGS, "Scan uploaded files with clamd while they are received"},
+    {"set_upload_options", (PyCFunction)CatzillaServer_set_upload_options, METH_VARARGS, "Digest uploaded files as they arrive and pick how spilled files are written"},
+    {"set_cache_snapshot", (PyCFunction)CatzillaServer_set_cache_snapshot, METH_VARARGS, "Save the response and static file caches to a directory on stop and restore them on listen"},
+    {"set_handoff", (PyCFunction)CatzillaServer_set_handoff, METH_VARARGS, "Take over the listeners of a running server on listen and hand them to the next one on reload"},
+    {"clear_response_cache", (PyCFunction)CatzillaServer_clear_response_cache, METH_NOARGS, "Drop every cached response"},
+    {"set_access_log", (PyCFunction)CatzillaServer_set_access_log, METH_VARARGS, "Log responses off the loop as JSON lines or CLF"},
+    {"set_route_access_log_sample", (PyCFunction)CatzillaServer_set_route_access_log_sample, METH_VARARGS, "Log a share of a route's requests"},
+    {"get_access_log_stats", (PyCFunction)CatzillaServer_get_access_log_stats, METH_NOARGS, "Get access log written and dropped counts"},
     {"match_route", (PyCFunction)CatzillaServer_match_route, METH_VARARGS, "Match route using C router"},
     {"add_c_route", (PyCFunction)CatzillaServer_add_c_route, METH_VARARGS, "Add route to C router"},
     {"add_c_route_with_middleware", (PyCFunction)CatzillaServer_add_c_route_with_middleware, METH_VARARGS, "Add route to C router with per-route middleware"},
@@ -2634,6 +4182,8 @@ static PyTypeObject CatzillaServerType = {
 
 static PyMethodDef module_methods[] = {
     {"send_response", send_response, METH_VARARGS, "Send HTTP response"},
+    {"send_json_response", send_json_response, METH_VARARGS, "Serialize data to JSON and send it as the response body"},
+    {"json_dumps", json_dumps, METH_O, "Serialize an object to compact UTF-8 JSON bytes"},
     {"schedule_async_response", schedule_async_response, METH_VARARGS, "Schedule a coroutine and deliver its response on completion"},
     {"parse_json", parse_json, METH_VARARGS, "Parse JSON from request"},
     {"get_json", get_json, METH_VARARGS, "Get parsed JSON from request"},
@@ -2643,6 +4193,7 @@ static PyMethodDef module_methods[] = {
     {"get_header", get_header, METH_VARARGS, "Get header value from request"},
     {"get_files", get_files, METH_VARARGS, "Get uploaded files from request"},
     {"get_content_type", get_content_type, METH_VARARGS, "Get content type from request"},
+    {"get_body_file", get_body_file, METH_VARARGS, "Get (path, size) of a spooled request body"},
     {"get_query_param", get_query_param, METH_VARARGS, "Get query parameter value"},
     {"get_query_params", get_query_params, METH_VARARGS, "Get all query parameters"},
     {"router_match", router_match, METH_VARARGS, "Match route using C router"},
@@ -2654,6 +4205,22 @@ static PyMethodDef module_methods[] = {
     {"get_current_allocator", get_current_allocator, METH_NOARGS, "Get current allocator type"},
     {"set_allocator", set_allocator, METH_VARARGS, "Set allocator type before initialization"},
     {"get_memory_stats", get_memory_stats, METH_NOARGS, "Get memory statistics"},
+    {"get_read_buffer_stats", get_read_buffer_stats, METH_NOARGS, "Get read buffer pool statistics"},
+    {"get_request_arena_stats", get_request_arena_stats, METH_NOARGS, "Get per-request arena statistics"},
+    {"start_allocation_profiler", start_allocation_profiler, METH_VARARGS, "Start sampling allocations with jemalloc prof (lg_sample = log2 bytes between samples)"},
+    {"stop_allocation_profiler", stop_allocation_profiler, METH_NOARGS, "Stop sampling allocations"},
+    {"dump_allocation_profile", dump_allocation_profile, METH_VARARGS, "Write the sampled heap profile (jeprof/pprof format) to a file"},
+    {"get_allocation_profiler_status", get_allocation_profiler_status, METH_NOARGS, "Get allocation profiler state"},
+    {"get_connection_stats", get_connection_stats, METH_NOARGS, "Get connection accept and context pool statistics"},
+    {"get_route_latency", get_route_latency, METH_NOARGS, "Get per-route queue, GIL, handler and write latency"},
+    {"set_counter_sampling", set_counter_sampling, METH_VARARGS, "Measure one handler in N with hardware counters"},
+    {"get_compression_stats", get_compression_stats, METH_NOARGS, "Get response compression statistics per coding"},
+#ifndef _WIN32
+    {"start_task_engine", start_task_engine, METH_VARARGS, "Start the background task engine for Python callables"},
+    {"add_python_task", add_python_task, METH_VARARGS, "Queue a Python callable on the background task engine"},
+    {"get_task_engine_stats", get_task_engine_stats, METH_NOARGS, "Get background task engine statistics"},
+    {"stop_task_engine", stop_task_engine, METH_VARARGS, "Stop the background task engine"},
+#endif
     {"init_memory_system", init_memory_system, METH_VARARGS, "Initialize memory system"},
     {"init_memory_with_allocator", init_memory_with_allocator, METH_VARARGS, "Initialize memory system with specific allocator"},
 
@@ -2678,10 +4245,12 @@ static struct PyModuleDef catzilla_module = {
     PyModuleDef_HEAD_INIT,
     "catzilla._catzilla",
     "Catzilla HTTP server module",
-    -1,
+    sizeof(catzilla_module_state_t),
     module_methods,
-    NULL, NULL, NULL,
-    NULL  // Module cleanup function (we'll handle cleanup manually)
+    NULL,
+    catzilla_module_traverse,
+    catzilla_module_clear,
+    catzilla_module_free
 };
 
 PyMODINIT_FUNC PyInit__catzilla(void)
@@ -2697,9 +4266,30 @@ PyMODINIT_FUNC PyInit__catzilla(void)
         return NULL;
     if (PyType_Ready(&CatzillaCacheResultType) < 0)
         return NULL;
+    if (PyType_Ready(&CatzillaTaskLogType) < 0)
+        return NULL;
+    if (PyType_Ready(&catzilla_request_object_type) < 0)
+        return NULL;
 
     PyObject *m = PyModule_Create(&catzilla_module);
     if (!m) return NULL;
+    catzilla_module_state_t *state = (catzilla_module_state_t*)PyModule_GetState(m);
+
+    if (catzilla_json_serializer_init(state) != 0) {
+        Py_DECREF(m);
+        return NULL;
+    }
+
+#ifdef Py_GIL_DISABLED
+    // Free-threaded builds: loops run handlers in parallel. The extension
+    // keeps its Python state in module state, publishing lazily filled
+    // fields atomically; the C core guards what the loops share (the router
+    // by epochs, caches and pools by locks or per loop).
+    if (PyUnstable_Module_SetGIL(m, Py_MOD_GIL_NOT_USED) < 0) {
+        Py_DECREF(m);
+        return NULL;
+    }
+#endif
 
     // Initialize streaming submodule
     PyObject* streaming_m = init_streaming();
@@ -2751,16 +4341,31 @@ PyMODINIT_FUNC PyInit__catzilla(void)
         return NULL;
     }
 
-    PyModule_AddStringConstant(m, "VERSION", "0.1.0");
+    // Add TaskLog type
+    Py_INCREF(&CatzillaTaskLogType);
+    if (PyModule_AddObject(m, "TaskLog", (PyObject*)&CatzillaTaskLogType) < 0) {
+        Py_DECREF(&CatzillaTaskLogType);
+        Py_DECREF(m);
+        return NULL;
+    }
 
-    // Initialize middleware registry
-    if (init_middleware_registry() < 0) {
+    // Add NativeRequest type
+    Py_INCREF(&catzilla_request_object_type);
+    if (PyModule_AddObject(m, "NativeRequest", (PyObject*)&catzilla_request_object_type) < 0) {
+        Py_DECREF(&catzilla_request_object_type);
         Py_DECREF(m);
         return NULL;
     }
 
-    // Register cleanup function
-    if (Py_AtExit(safe_module_cleanup) < 0) {
+    PyModule_AddStringConstant(m, "VERSION", "0.1.0");
+#ifdef Py_GIL_DISABLED
+    PyModule_AddIntConstant(m, "FREE_THREADED", 1);
+#else
+    PyModule_AddIntConstant(m, "FREE_THREADED", 0);
+#endif
+
+    // Initialize middleware registry
+    if (init_middleware_registry(state) < 0) {
         Py_DECREF(m);
         return NULL;
     }
@@ -2778,13 +4383,34 @@ PyMODINIT_FUNC PyInit__catzilla(void)
         LOG_WARN("Module", "Failed to initialize streaming module");
     }
 
+    // The WebSocket submodule installs the hooks upgraded connections use
+    PyObject* websocket_module = init_websocket();
+    if (websocket_module) {
+        if (PyModule_AddObject(m, "_websocket", websocket_module) < 0) {
+            Py_DECREF(websocket_module);
+            Py_DECREF(m);
+            return NULL;
+        }
+    } else {
+        LOG_WARN("Module", "Failed to initialize WebSocket module");
+    }
+
     // Initialize async bridge system for hybrid sync/async execution
-    if (catzilla_async_bridge_init(uv_default_loop()) < 0) {
+    if (catzilla_async_bridge_init(state, uv_default_loop()) < 0) {
         LOG_ERROR("Module", "Failed to initialize async bridge system");
         // Don't fail the module init - async support is optional
+    } else if (register_async_bridge_shutdown(m) < 0) {
+        Py_DECREF(m);
+        return NULL;
     } else {
         LOG_INFO("Module", "Async bridge system initialized successfully");
     }
 
+    // asyncio loop driven by the server's libuv loop (catzilla.event_loop)
+    if (catzilla_loop_driver_register(m) < 0) {
+        Py_DECREF(m);
+        return NULL;
+    }
+
     return m;
 }
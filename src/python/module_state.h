@@ -0,0 +1,64 @@
+/*
+ * Catzilla Module State Header
+ *
+ * Everything the extension keeps between calls lives in the state of the
+ * calling interpreter's catzilla._catzilla module rather than in C globals,
+ * so module.c, the JSON serializer, the streaming bridge and the async
+ * bridge never share Python objects across interpreters. Fields that are
+ * filled on first use are published atomically: on free-threaded builds
+ * several handler threads may get there at once.
+ */
+
+#ifndef CATZILLA_MODULE_STATE_H
+#define CATZILLA_MODULE_STATE_H
+
+#include <Python.h>
+#include <stdbool.h>
+#include "../core/router.h"
+#include "../core/task_system.h"
+#include "../core/platform_atomic.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct async_bridge_s async_bridge_t;
+
+typedef struct {
+    PyObject *middleware_registry;  // Dict: middleware_id -> PyObject*
+    catzilla_atomic_uint64_t next_middleware_id;
+    catzilla_router_t router;       // Router behind the module-level router_* functions
+    bool router_initialized;
+#ifndef _WIN32
+    // Background task engine for Python callables, started on demand;
+    // published and taken atomically
+    task_engine_t *task_engine;
+#endif
+
+    // JSON serializer (json_serializer.c). The optional types are imported
+    // on first use and published one by one before the loaded flag.
+    PyObject *json_model_dump_name;
+    PyObject *json_uuid_type;
+    PyObject *json_decimal_type;
+    catzilla_atomic_uint8_t json_optional_types_loaded;
+
+    // catzilla.streaming's registry (streaming.c), resolved on first use
+    PyObject *streaming_registry_get;
+    PyObject *streaming_registry_unregister;
+
+    // Bridge to the asyncio thread (async_bridge.c)
+    async_bridge_t *async_bridge;
+} catzilla_module_state_t;
+
+/**
+ * State of the calling interpreter's module. Needs an attached thread state;
+ * while the module initializes, use the state of the module being created.
+ * @return State, or NULL with an exception set
+ */
+catzilla_module_state_t* catzilla_get_module_state(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CATZILLA_MODULE_STATE_H
@@ -4,6 +4,10 @@
 #include <stdlib.h>
 #include "../core/streaming.h"
 #include "../core/server.h"
+#include "../core/sse_hub.h"
+#include "module_state.h"
+
+#define SSE_HUB_CAPSULE "catzilla.sse_hub"
 
 // Define the Python StreamingResponse object structure
 typedef struct {
@@ -286,112 +290,101 @@ static PyObject* py_create_streaming_response(PyObject* self, PyObject* args, Py
         Py_INCREF(on_close_callback);
     }
 
-    // Send initial headers with streaming marker
-    const char* streaming_marker = "___CATZILLA_STREAMING___";
+    // Compress the stream when the server and the client agree on a coding
     const char* content_type_str = PyUnicode_AsUTF8(content_type);
-    catzilla_send_streaming_response(client, status_code, content_type_str, streaming_marker);
+    int level = 0;
+    int encoding = catzilla_server_stream_encoding(client, content_type_str, &level);
+    if (encoding != CATZILLA_ENCODING_IDENTITY) {
+        catzilla_stream_set_compression(response->stream_ctx, encoding, level);
+    }
+
+    // Send initial headers
+    catzilla_stream_send_headers(response->stream_ctx, status_code, content_type_str);
 
     return response_obj;
 }
 
-// Create a streaming response connected to a client
-static PyObject* py_connect_streaming_response(PyObject* self, PyObject* args) {
-    PyObject* client_capsule;
-    const char* streaming_id;
-
-    if (!PyArg_ParseTuple(args, "Os", &client_capsule, &streaming_id))
-        return NULL;
-
-    // Check if client is a valid PyCapsule
-    if (!PyCapsule_CheckExact(client_capsule)) {
-        PyErr_SetString(PyExc_TypeError, "client must be a PyCapsule");
-        return NULL;
-    }
-
-    // Extract client handle from capsule
-    uv_stream_t* client = PyCapsule_GetPointer(client_capsule, "catzilla.client");
-    if (!client) {
-        PyErr_SetString(PyExc_ValueError, "Invalid client capsule");
-        return NULL;
-    }
-
-    // Find the Python StreamingResponse by ID
-    PyObject* catzilla_module = PyImport_ImportModule("catzilla.streaming");
-    if (!catzilla_module) {
-        return NULL;
+// Publish a registry callable unless a racing thread was first
+static void publish_registry_func(PyObject** slot, PyObject* func) {
+    if (catzilla_atomic_publish_ptr(slot, func) != func) {
+        Py_DECREF(func);
     }
+}
 
-    PyObject* get_func = PyObject_GetAttrString(catzilla_module, "_get_streaming_response");
-    if (!get_func) {
-        Py_DECREF(catzilla_module);
-        return NULL;
+// catzilla.streaming's registry, kept in the module state and resolved on
+// first use: the package imports this extension, so it cannot be imported
+// while the extension initializes. The unregister callable is published
+// last and tells that both are there.
+static int resolve_registry(catzilla_module_state_t* state) {
+    if (catzilla_atomic_load_seq(&state->streaming_registry_unregister)) {
+        return 0;
     }
-
-    PyObject* id_arg = PyUnicode_FromString(streaming_id);
-    if (!id_arg) {
-        Py_DECREF(get_func);
-        Py_DECREF(catzilla_module);
-        return NULL;
+    PyObject* module = PyImport_ImportModule("catzilla.streaming");
+    if (!module) {
+        return -1;
     }
-
-    PyObject* py_response = PyObject_CallFunctionObjArgs(get_func, id_arg, NULL);
-    Py_DECREF(id_arg);
-    Py_DECREF(get_func);
-    // Don't decref catzilla_module yet - we need it later
-
-    if (!py_response || py_response == Py_None) {
-        Py_XDECREF(py_response);
-        Py_DECREF(catzilla_module);
-        PyErr_SetString(PyExc_ValueError, "StreamingResponse not found for given ID");
-        return NULL;
+    PyObject* get_func = PyObject_GetAttrString(module, "_get_streaming_response");
+    PyObject* unregister_func = get_func ? PyObject_GetAttrString(module, "_unregister_streaming_response") : NULL;
+    Py_DECREF(module);
+    if (!unregister_func) {
+        Py_XDECREF(get_func);
+        return -1;
     }
+    publish_registry_func(&state->streaming_registry_get, get_func);
+    publish_registry_func(&state->streaming_registry_unregister, unregister_func);
+    return 0;
+}
 
-    // Get the content generator from the Python StreamingResponse
-    PyObject* content = PyObject_GetAttrString(py_response, "_content");
-    if (!content) {
-        Py_DECREF(py_response);
-        Py_DECREF(catzilla_module);
-        PyErr_SetString(PyExc_AttributeError, "StreamingResponse missing _content attribute");
-        return NULL;
+static void unregister_streaming_response(catzilla_module_state_t* state, PyObject* id_arg) {
+    PyObject* result = PyObject_CallFunctionObjArgs(state->streaming_registry_unregister, id_arg, NULL);
+    if (!result) {
+        PyErr_Clear();
     }
+    Py_XDECREF(result);
+}
 
-    // Get content type and status
+// Write the response head of a registered StreamingResponse
+static int send_streaming_head(uv_stream_t* client, PyObject* py_response) {
     PyObject* content_type = PyObject_GetAttrString(py_response, "_content_type");
-    PyObject* status_code = PyObject_GetAttrString(py_response, "_status_code");
-
-    if (!content_type || !status_code) {
-        Py_XDECREF(content);
+    PyObject* status_code = content_type ? PyObject_GetAttrString(py_response, "_status_code") : NULL;
+    if (!status_code) {
         Py_XDECREF(content_type);
-        Py_XDECREF(status_code);
-        Py_DECREF(py_response);
-        Py_DECREF(catzilla_module);
         PyErr_SetString(PyExc_AttributeError, "StreamingResponse missing required attributes");
-        return NULL;
+        return -1;
     }
 
-    int status = PyLong_AsLong(status_code);
+    int status = (int)PyLong_AsLong(status_code);
     const char* content_type_str = PyUnicode_AsUTF8(content_type);
+    Py_DECREF(status_code);
+    if (!content_type_str) {
+        Py_DECREF(content_type);
+        return -1;
+    }
 
     // Get headers from the StreamingResponse
     PyObject* headers_obj = PyObject_GetAttrString(py_response, "_headers");
+    if (!headers_obj) {
+        PyErr_Clear();
+    }
 
     // Check if custom headers already include Connection header
     bool has_connection_header = false;
     if (headers_obj && PyDict_Check(headers_obj)) {
         PyObject* connection_key = PyUnicode_FromString("connection");
         if (connection_key) {
-            has_connection_header = PyDict_Contains(headers_obj, connection_key);
+            has_connection_header = PyDict_Contains(headers_obj, connection_key) == 1;
             Py_DECREF(connection_key);
         }
     }
 
     // Build the response headers string
-    char response_headers[2048];  // Increased buffer size
+    char response_headers[2048];
     int offset = snprintf(response_headers, sizeof(response_headers),
         "HTTP/1.1 %d OK\r\n"
         "Content-Type: %s\r\n"
         "Transfer-Encoding: chunked\r\n",
         status, content_type_str);
+    Py_DECREF(content_type);
 
     // Add Connection header only if not already in custom headers
     if (!has_connection_header) {
@@ -409,67 +402,58 @@ static PyObject* py_connect_streaming_response(PyObject* self, PyObject* args) {
             const char* key_str = PyUnicode_AsUTF8(key);
             const char* value_str = PyUnicode_AsUTF8(value);
 
-            if (key_str && value_str && offset < sizeof(response_headers) - 100) {
+            if (key_str && value_str && offset < (int)sizeof(response_headers) - 100) {
                 offset += snprintf(response_headers + offset,
                                  sizeof(response_headers) - offset,
                                  "%s: %s\r\n", key_str, value_str);
             }
         }
+        PyErr_Clear();
     }
+    Py_XDECREF(headers_obj);
 
     // Add final CRLF to separate headers from body
-    if (offset < sizeof(response_headers) - 3) {
-        strcpy(response_headers + offset, "\r\n");
-        offset += 2;
+    if (offset > (int)sizeof(response_headers) - 3) {
+        offset = (int)sizeof(response_headers) - 3;
     }
+    memcpy(response_headers + offset, "\r\n", 2);
+    offset += 2;
 
-    // Clean up Python object reference
-    Py_XDECREF(headers_obj);
-
-    // Send response headers using uv_write
-    uv_buf_t header_buf = uv_buf_init(response_headers, offset);
-    uv_write_t* header_req = malloc(sizeof(uv_write_t));
-    if (header_req) {
-        uv_write(header_req, client, &header_buf, 1, NULL);  // Fire and forget for now
-    }
-
-    // Start streaming the content
-    PyObject* iterator = content;
-
-    // Check if content is callable, and call it if so
-    if (PyCallable_Check(iterator)) {
-        PyObject* iter_result = PyObject_CallObject(iterator, NULL);
-        if (!iter_result) {
-            Py_DECREF(content);
-            Py_DECREF(content_type);
-            Py_DECREF(status_code);
-            Py_DECREF(py_response);
-            Py_DECREF(catzilla_module);
-            return NULL;
-        }
-        iterator = iter_result;
-    } else {
-        Py_INCREF(iterator);
+    uv_buf_t header_buf = uv_buf_init(response_headers, (unsigned int)offset);
+    if (catzilla_stream_send(client, &header_buf, 1) != CATZILLA_STREAM_OK) {
+        PyErr_SetString(PyExc_IOError, "Failed to write streaming response headers");
+        return -1;
     }
+    return 0;
+}
 
-    // Get the iterator and stream chunks
-    PyObject* iter = PyObject_GetIter(iterator);
-    Py_DECREF(iterator);
+// Write each chunk the response's content yields, then the last chunk
+static int stream_content(uv_stream_t* client, PyObject* py_response) {
+    PyObject* content = PyObject_GetAttrString(py_response, "_content");
+    if (!content) {
+        PyErr_SetString(PyExc_AttributeError, "StreamingResponse missing _content attribute");
+        return -1;
+    }
 
-    if (!iter) {
+    // Content may be a callable producing the iterable
+    PyObject* iterable = content;
+    if (PyCallable_Check(content)) {
+        iterable = PyObject_CallObject(content, NULL);
         Py_DECREF(content);
-        Py_DECREF(content_type);
-        Py_DECREF(status_code);
-        Py_DECREF(py_response);
-        Py_DECREF(catzilla_module);
-        return NULL;
+        if (!iterable) {
+            return -1;
+        }
+    }
+    PyObject* iter = PyObject_GetIter(iterable);
+    Py_DECREF(iterable);
+    if (!iter) {
+        return -1;
     }
 
-    // Stream each chunk with HTTP chunked encoding
     PyObject* item;
     while ((item = PyIter_Next(iter)) != NULL) {
-        const char* data;
-        Py_ssize_t data_len;
+        const char* data = NULL;
+        Py_ssize_t data_len = 0;
 
         if (PyUnicode_Check(item)) {
             data = PyUnicode_AsUTF8AndSize(item, &data_len);
@@ -478,85 +462,219 @@ static PyObject* py_connect_streaming_response(PyObject* self, PyObject* args) {
         } else {
             Py_DECREF(item);
             Py_DECREF(iter);
-            Py_DECREF(content);
-            Py_DECREF(content_type);
-            Py_DECREF(status_code);
-            Py_DECREF(py_response);
-            Py_DECREF(catzilla_module);
             PyErr_SetString(PyExc_TypeError, "Iterator must yield strings or bytes");
-            return NULL;
-        }
-
-        if (data && data_len > 0) {
-            // Create chunk: size in hex + CRLF + data + CRLF
-            char* full_chunk = malloc(data_len + 64);  // Extra space for headers
-            if (full_chunk) {
-                int header_len = snprintf(full_chunk, 32, "%lx\r\n", (unsigned long)data_len);
-                memcpy(full_chunk + header_len, data, data_len);
-                memcpy(full_chunk + header_len + data_len, "\r\n", 2);
-
-                size_t total_len = header_len + data_len + 2;
-
-                // Send chunk using uv_write
-                uv_buf_t chunk_buf = uv_buf_init(full_chunk, total_len);
-                uv_write_t* chunk_req = malloc(sizeof(uv_write_t));
-                if (chunk_req) {
-                    chunk_req->data = full_chunk;  // Store pointer for cleanup
-                    uv_write(chunk_req, client, &chunk_buf, 1, NULL);  // Fire and forget for now
-                }
-            }
+            return -1;
         }
 
+        // Framing and data go out in one writev; only unsent bytes are copied
+        int result = data ? catzilla_stream_send_chunk(client, data, (size_t)data_len) : CATZILLA_STREAM_OK;
         Py_DECREF(item);
+        if (result != CATZILLA_STREAM_OK) {
+            Py_DECREF(iter);
+            PyErr_Format(PyExc_IOError, "Failed to write to stream: error code %d", result);
+            return -1;
+        }
     }
-
     Py_DECREF(iter);
 
     // Check for iteration error
     if (PyErr_Occurred()) {
-        Py_DECREF(content);
-        Py_DECREF(content_type);
-        Py_DECREF(status_code);
-        Py_DECREF(py_response);
-        Py_DECREF(catzilla_module);
-        return NULL;
+        return -1;
     }
 
-    // Send final chunk to end the stream
-    char* end_chunk = strdup("0\r\n\r\n");
-    if (end_chunk) {
-        uv_buf_t end_buf = uv_buf_init(end_chunk, 5);
-        uv_write_t* end_req = malloc(sizeof(uv_write_t));
-        if (end_req) {
-            end_req->data = end_chunk;
-            uv_write(end_req, client, &end_buf, 1, NULL);
-        }
+    if (catzilla_stream_send_last_chunk(client) != CATZILLA_STREAM_OK) {
+        PyErr_SetString(PyExc_IOError, "Failed to end streaming response");
+        return -1;
+    }
+    return 0;
+}
+
+// Responses of an EventHub carry the hub; the connection follows it
+// instead of iterating content
+static int follow_event_hub(uv_stream_t* client, PyObject* py_response, bool* followed) {
+    *followed = false;
+    PyObject* hub_capsule = PyObject_GetAttrString(py_response, "_sse_hub");
+    if (!hub_capsule) {
+        PyErr_Clear();
+        return 0;
+    }
+    if (hub_capsule == Py_None) {
+        Py_DECREF(hub_capsule);
+        return 0;
     }
 
-    // Cleanup
-    Py_DECREF(content);
-    Py_DECREF(content_type);
-    Py_DECREF(status_code);
+    catzilla_sse_hub_t* hub = PyCapsule_GetPointer(hub_capsule, SSE_HUB_CAPSULE);
+    if (!hub) {
+        Py_DECREF(hub_capsule);
+        return -1;
+    }
+    // No event can be written before the head: both run on this loop
+    int rc = catzilla_server_subscribe_events(client, hub);
+    Py_DECREF(hub_capsule);
+    if (rc != 0) {
+        PyErr_SetString(PyExc_RuntimeError, "Connection cannot follow an event hub");
+        return -1;
+    }
+    if (send_streaming_head(client, py_response) != 0) {
+        catzilla_server_abort_response(client);
+        return -1;
+    }
+    *followed = true;
+    return 0;
+}
+
+// Connect a client to the StreamingResponse registered under streaming_id;
+// installed as the server's connect function
+static int connect_streaming(uv_stream_t* client, const char* streaming_id) {
+    catzilla_module_state_t* state = catzilla_get_module_state();
+    if (!state || resolve_registry(state) != 0) {
+        return -1;
+    }
+
+    PyObject* id_arg = PyUnicode_FromString(streaming_id);
+    if (!id_arg) {
+        return -1;
+    }
+
+    PyObject* py_response = PyObject_CallFunctionObjArgs(state->streaming_registry_get, id_arg, NULL);
+    if (!py_response || py_response == Py_None) {
+        Py_XDECREF(py_response);
+        Py_DECREF(id_arg);
+        PyErr_SetString(PyExc_ValueError, "StreamingResponse not found for given ID");
+        return -1;
+    }
+
+    bool followed = false;
+    int rc = follow_event_hub(client, py_response, &followed);
+    if (rc == 0 && !followed) {
+        rc = send_streaming_head(client, py_response);
+        if (rc == 0) {
+            rc = stream_content(client, py_response);
+            if (rc != 0) {
+                // The head is out, so the body cannot turn into an error response
+                catzilla_server_abort_response(client);
+            }
+        }
+    }
     Py_DECREF(py_response);
 
-    // Unregister the streaming response
-    PyObject* unregister_func = PyObject_GetAttrString(catzilla_module, "_unregister_streaming_response");
-    if (unregister_func) {
-        PyObject* id_arg2 = PyUnicode_FromString(streaming_id);
-        PyObject_CallFunctionObjArgs(unregister_func, id_arg2, NULL);
-        Py_DECREF(id_arg2);
-        Py_DECREF(unregister_func);
+    // A failure keeps the registration for the error being raised
+    if (rc == 0) {
+        unregister_streaming_response(state, id_arg);
     }
-    Py_DECREF(catzilla_module);
+    Py_DECREF(id_arg);
+    return rc;
+}
 
+// Create a streaming response connected to a client
+static PyObject* py_connect_streaming_response(PyObject* self, PyObject* args) {
+    PyObject* client_capsule;
+    const char* streaming_id;
+
+    if (!PyArg_ParseTuple(args, "Os", &client_capsule, &streaming_id))
+        return NULL;
+
+    // Check if client is a valid PyCapsule
+    if (!PyCapsule_CheckExact(client_capsule)) {
+        PyErr_SetString(PyExc_TypeError, "client must be a PyCapsule");
+        return NULL;
+    }
+
+    // Extract client handle from capsule
+    uv_stream_t* client = PyCapsule_GetPointer(client_capsule, "catzilla.client");
+    if (!client) {
+        PyErr_SetString(PyExc_ValueError, "Invalid client capsule");
+        return NULL;
+    }
+
+    if (connect_streaming(client, streaming_id) != 0) {
+        return NULL;
+    }
     Py_RETURN_NONE;
 }
 
+static void sse_hub_capsule_destructor(PyObject* capsule) {
+    catzilla_sse_hub_release(PyCapsule_GetPointer(capsule, SSE_HUB_CAPSULE));
+}
+
+// sse_hub_create(queue_limit=0) -> hub capsule
+static PyObject* py_sse_hub_create(PyObject* self, PyObject* args) {
+    (void)self;
+    Py_ssize_t queue_limit = 0;
+    if (!PyArg_ParseTuple(args, "|n", &queue_limit))
+        return NULL;
+    if (queue_limit < 0) {
+        PyErr_SetString(PyExc_ValueError, "queue_limit must not be negative");
+        return NULL;
+    }
+
+    catzilla_sse_hub_t* hub = catzilla_sse_hub_create((size_t)queue_limit);
+    if (!hub) {
+        return PyErr_NoMemory();
+    }
+    PyObject* capsule = PyCapsule_New(hub, SSE_HUB_CAPSULE, sse_hub_capsule_destructor);
+    if (!capsule) {
+        catzilla_sse_hub_release(hub);
+    }
+    return capsule;
+}
+
+// sse_publish(hub, data, event=None, id=None)
+static PyObject* py_sse_publish(PyObject* self, PyObject* args, PyObject* kwds) {
+    (void)self;
+    static char* kwlist[] = {"hub", "data", "event", "id", NULL};
+    PyObject* hub_capsule;
+    const char* data;
+    Py_ssize_t data_len;
+    const char* event = NULL;
+    const char* id = NULL;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "Os#|zz", kwlist,
+                                     &hub_capsule, &data, &data_len, &event, &id))
+        return NULL;
+
+    catzilla_sse_hub_t* hub = PyCapsule_GetPointer(hub_capsule, SSE_HUB_CAPSULE);
+    if (!hub) {
+        return NULL;
+    }
+    if (catzilla_sse_publish(hub, event, id, data, (size_t)data_len) != 0) {
+        if ((event && strpbrk(event, "\r\n")) || (id && strpbrk(id, "\r\n"))) {
+            PyErr_SetString(PyExc_ValueError, "event and id must not contain line breaks");
+        } else {
+            PyErr_NoMemory();
+        }
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+// sse_hub_stats(hub) -> dict
+static PyObject* py_sse_hub_stats(PyObject* self, PyObject* hub_capsule) {
+    (void)self;
+    catzilla_sse_hub_t* hub = PyCapsule_GetPointer(hub_capsule, SSE_HUB_CAPSULE);
+    if (!hub) {
+        return NULL;
+    }
+    catzilla_sse_hub_stats_t stats;
+    catzilla_sse_hub_get_stats(hub, &stats);
+    return Py_BuildValue("{s:K,s:K,s:K,s:K}",
+                         "subscribers", (unsigned long long)stats.subscribers,
+                         "published", (unsigned long long)stats.published,
+                         "delivered", (unsigned long long)stats.delivered,
+                         "dropped", (unsigned long long)stats.dropped);
+}
+
 static PyMethodDef streaming_methods[] = {
     {"create_streaming_response", (PyCFunction)py_create_streaming_response,
      METH_VARARGS | METH_KEYWORDS, "Create a streaming response for a client"},
     {"connect_streaming_response", (PyCFunction)py_connect_streaming_response,
      METH_VARARGS, "Connect a streaming response to a client by ID"},
+    {"sse_hub_create", (PyCFunction)py_sse_hub_create,
+     METH_VARARGS, "Create an SSE hub"},
+    {"sse_publish", (PyCFunction)(void(*)(void))py_sse_publish,
+     METH_VARARGS | METH_KEYWORDS, "Publish an event to every subscriber of an SSE hub"},
+    {"sse_hub_stats", (PyCFunction)py_sse_hub_stats,
+     METH_O, "Counters of an SSE hub"},
     {NULL, NULL, 0, NULL}  // Sentinel
 };
 
@@ -580,6 +698,9 @@ PyObject* init_streaming(void) {
     if (module == NULL)
         return NULL;
 
+    // Marker responses are connected without looking this module up
+    catzilla_stream_set_connect(connect_streaming);
+
     // Add the StreamingResponse type to the module
     Py_INCREF(&StreamingResponseType);
     if (PyModule_AddObject(module, "StreamingResponse", (PyObject*)&StreamingResponseType) < 0) {
@@ -0,0 +1,344 @@
+#include <Python.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "../core/server.h"
+#include "../core/websocket.h"
+#include "../core/request_object.h"
+
+// Python side of an upgraded connection. The route's handler is called once
+// with the WebSocket and sets on_message/on_close; those run on the
+// connection's loop thread, which is also where send and close must be called.
+typedef struct {
+    PyObject_HEAD
+    uv_stream_t* client;  // NULL once the connection closed
+    PyObject* path;
+    PyObject* query_string;
+    PyObject* path_params;
+    PyObject* headers;
+    PyObject* remote_addr;
+    PyObject* on_message;
+    PyObject* on_close;
+    int close_code;
+} WebSocket;
+
+static void WebSocket_dealloc(WebSocket* self) {
+    Py_XDECREF(self->path);
+    Py_XDECREF(self->query_string);
+    Py_XDECREF(self->path_params);
+    Py_XDECREF(self->headers);
+    Py_XDECREF(self->remote_addr);
+    Py_XDECREF(self->on_message);
+    Py_XDECREF(self->on_close);
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+// send(data): str as a text message, bytes-like as binary
+static PyObject* WebSocket_send(WebSocket* self, PyObject* data) {
+    bool text = PyUnicode_Check(data);
+    const char* payload;
+    Py_ssize_t length;
+    Py_buffer view;
+    view.obj = NULL;
+
+    if (text) {
+        payload = PyUnicode_AsUTF8AndSize(data, &length);
+        if (!payload) return NULL;
+    } else {
+        if (PyObject_GetBuffer(data, &view, PyBUF_SIMPLE) < 0) {
+            PyErr_SetString(PyExc_TypeError, "send() takes str or a bytes-like object");
+            return NULL;
+        }
+        payload = view.buf;
+        length = view.len;
+    }
+
+    int rc = self->client ?
+        catzilla_server_websocket_send(self->client, text, payload, (size_t)length) : -1;
+    if (view.obj) PyBuffer_Release(&view);
+    if (rc != 0) {
+        PyErr_SetString(PyExc_ConnectionError, "WebSocket is closed");
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+// close(code=1000, reason="")
+static PyObject* WebSocket_close(WebSocket* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {"code", "reason", NULL};
+    int code = CATZILLA_WS_CLOSE_NORMAL;
+    const char* reason = "";
+    Py_ssize_t reason_length = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|is#", kwlist, &code, &reason, &reason_length))
+        return NULL;
+
+    if (code != 0 && (code < 1000 || code >= 5000 || code == CATZILLA_WS_CLOSE_NO_STATUS ||
+                      code == CATZILLA_WS_CLOSE_ABNORMAL)) {
+        PyErr_Format(PyExc_ValueError, "%d is not a close code that can be sent", code);
+        return NULL;
+    }
+    // Closing twice, or after the peer left, is not an error
+    if (self->client) {
+        catzilla_server_websocket_close(self->client, code, reason, (size_t)reason_length);
+    }
+    Py_RETURN_NONE;
+}
+
+// Handshake attributes, fixed once the WebSocket is created
+static PyObject* WebSocket_get_attribute(WebSocket* self, void* closure) {
+    PyObject* value = *(PyObject**)((char*)self + (size_t)closure);
+    Py_INCREF(value);
+    return value;
+}
+
+static PyObject* WebSocket_get_closed(WebSocket* self, void* closure) {
+    (void)closure;
+    return PyBool_FromLong(self->client == NULL);
+}
+
+static PyObject* WebSocket_get_close_code(WebSocket* self, void* closure) {
+    (void)closure;
+    if (self->client) Py_RETURN_NONE;
+    return PyLong_FromLong(self->close_code);
+}
+
+static PyObject* WebSocket_get_buffered_amount(WebSocket* self, void* closure) {
+    (void)closure;
+    return PyLong_FromSize_t(self->client ? catzilla_server_websocket_buffered(self->client) : 0);
+}
+
+static PyObject* WebSocket_get_callback(WebSocket* self, void* closure) {
+    PyObject* callback = closure ? self->on_close : self->on_message;
+    if (!callback) Py_RETURN_NONE;
+    Py_INCREF(callback);
+    return callback;
+}
+
+static int WebSocket_set_callback(WebSocket* self, PyObject* value, void* closure) {
+    if (value == Py_None) value = NULL;
+    if (value && !PyCallable_Check(value)) {
+        PyErr_SetString(PyExc_TypeError, "callback must be callable or None");
+        return -1;
+    }
+    PyObject** slot = closure ? &self->on_close : &self->on_message;
+    Py_XINCREF(value);
+    Py_XSETREF(*slot, value);
+    return 0;
+}
+
+static PyMethodDef WebSocket_methods[] = {
+    {"send", (PyCFunction)WebSocket_send, METH_O,
+     "Send str as a text message or bytes as a binary message"},
+    {"close", (PyCFunction)(void(*)(void))WebSocket_close, METH_VARARGS | METH_KEYWORDS,
+     "Start the closing handshake"},
+    {NULL}  // Sentinel
+};
+
+static PyGetSetDef WebSocket_getset[] = {
+    {"path", (getter)WebSocket_get_attribute, NULL, "Request path",
+     (void*)offsetof(WebSocket, path)},
+    {"query_string", (getter)WebSocket_get_attribute, NULL, "Query string, without the '?'",
+     (void*)offsetof(WebSocket, query_string)},
+    {"path_params", (getter)WebSocket_get_attribute, NULL, "Path parameters of the route",
+     (void*)offsetof(WebSocket, path_params)},
+    {"headers", (getter)WebSocket_get_attribute, NULL, "Handshake headers, names lowercased",
+     (void*)offsetof(WebSocket, headers)},
+    {"remote_addr", (getter)WebSocket_get_attribute, NULL, "Peer IP address, or None",
+     (void*)offsetof(WebSocket, remote_addr)},
+    {"on_message", (getter)WebSocket_get_callback, (setter)WebSocket_set_callback,
+     "Called with each message: str for text, bytes for binary", NULL},
+    {"on_close", (getter)WebSocket_get_callback, (setter)WebSocket_set_callback,
+     "Called with (code, reason) once the connection closed", (void*)1},
+    {"closed", (getter)WebSocket_get_closed, NULL, "Whether the connection closed", NULL},
+    {"close_code", (getter)WebSocket_get_close_code, NULL,
+     "Close code the peer sent (1006 if none), None while open", NULL},
+    {"buffered_amount", (getter)WebSocket_get_buffered_amount, NULL,
+     "Bytes queued for the peer but not yet written", NULL},
+    {NULL}  // Sentinel
+};
+
+static PyTypeObject WebSocketType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "catzilla.WebSocket",
+    .tp_doc = "Server side of a WebSocket connection",
+    .tp_basicsize = sizeof(WebSocket),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_dealloc = (destructor)WebSocket_dealloc,
+    .tp_methods = WebSocket_methods,
+    .tp_getset = WebSocket_getset,
+};
+
+static PyObject* headers_to_dict(const catzilla_header_set_t* set) {
+    PyObject* headers = PyDict_New();
+    if (!headers) return NULL;
+
+    for (int i = 0; i < set->count; i++) {
+        const catzilla_header_t* header = &set->entries[i];
+        const char* name = catzilla_header_name(set, header);
+        char lowered[256];
+        size_t length = header->name_length < sizeof(lowered) - 1 ? header->name_length : sizeof(lowered) - 1;
+        for (size_t j = 0; j < length; j++) {
+            char c = name[j];
+            lowered[j] = (c >= 'A' && c <= 'Z') ? (char)(c + ('a' - 'A')) : c;
+        }
+        lowered[length] = '\0';
+
+        PyObject* value = PyUnicode_FromStringAndSize(catzilla_header_value(set, header),
+                                                      (Py_ssize_t)header->value_length);
+        if (!value || PyDict_SetItemString(headers, lowered, value) < 0) {
+            Py_XDECREF(value);
+            Py_DECREF(headers);
+            return NULL;
+        }
+        Py_DECREF(value);
+    }
+    return headers;
+}
+
+static PyObject* path_params_to_dict(const catzilla_route_match_t* match) {
+    PyObject* params = PyDict_New();
+    if (!params) return NULL;
+
+    for (int i = 0; i < match->param_count; i++) {
+        const char* name = catzilla_router_match_param_name(match, i);
+        if (!name) continue;
+        size_t length = 0;
+        const char* value = catzilla_router_match_param_value(match, i, &length);
+        PyObject* value_obj = catzilla_path_param_to_python(match->route, i, value, length);
+        if (!value_obj || PyDict_SetItemString(params, name, value_obj) < 0) {
+            Py_XDECREF(value_obj);
+            Py_DECREF(params);
+            return NULL;
+        }
+        Py_DECREF(value_obj);
+    }
+    return params;
+}
+
+static WebSocket* websocket_new(uv_stream_t* client, const catzilla_websocket_request_t* request) {
+    WebSocket* self = PyObject_New(WebSocket, &WebSocketType);
+    if (!self) return NULL;
+
+    self->client = client;
+    self->on_message = NULL;
+    self->on_close = NULL;
+    self->close_code = CATZILLA_WS_CLOSE_ABNORMAL;
+    self->path = PyUnicode_FromString(request->path);
+    self->query_string = PyUnicode_FromString(request->query_string ? request->query_string : "");
+    self->path_params = path_params_to_dict(request->match);
+    self->headers = headers_to_dict(request->headers);
+    self->remote_addr = request->remote_addr ? PyUnicode_FromString(request->remote_addr) : (Py_INCREF(Py_None), Py_None);
+
+    if (!self->path || !self->query_string || !self->path_params || !self->headers || !self->remote_addr) {
+        self->client = NULL;
+        Py_DECREF(self);
+        return NULL;
+    }
+    return self;
+}
+
+// The handshake succeeded: build the WebSocket and give it to the route's
+// handler. The connection is kept even when the handler raised, so it can
+// be closed with a proper close frame.
+static void* websocket_open(uv_stream_t* client, void* handler, const catzilla_websocket_request_t* request) {
+    PyGILState_STATE gstate = PyGILState_Ensure();
+
+    WebSocket* self = websocket_new(client, request);
+    if (!self) {
+        PyErr_Print();
+        PyGILState_Release(gstate);
+        return NULL;
+    }
+
+    PyObject* result = PyObject_CallOneArg((PyObject*)handler, (PyObject*)self);
+    if (!result) {
+        PyErr_Print();
+        catzilla_server_websocket_close(client, CATZILLA_WS_CLOSE_INTERNAL_ERROR, NULL, 0);
+    }
+    Py_XDECREF(result);
+
+    PyGILState_Release(gstate);
+    return self;
+}
+
+static void websocket_message(void* handle, bool text, const char* data, size_t length) {
+    WebSocket* self = handle;
+    PyGILState_STATE gstate = PyGILState_Ensure();
+
+    if (self->on_message) {
+        PyObject* message = text ?
+            PyUnicode_DecodeUTF8(data, (Py_ssize_t)length, NULL) :
+            PyBytes_FromStringAndSize(data, (Py_ssize_t)length);
+        PyObject* result = message ? PyObject_CallOneArg(self->on_message, message) : NULL;
+        if (!result) {
+            PyErr_Print();
+            if (self->client) {
+                catzilla_server_websocket_close(self->client, CATZILLA_WS_CLOSE_INTERNAL_ERROR, NULL, 0);
+            }
+        }
+        Py_XDECREF(result);
+        Py_XDECREF(message);
+    }
+
+    PyGILState_Release(gstate);
+}
+
+// Drops the reference websocket_open handed to the server
+static void websocket_closed(void* handle, int code, const char* reason, size_t length) {
+    WebSocket* self = handle;
+    PyGILState_STATE gstate = PyGILState_Ensure();
+
+    self->client = NULL;
+    self->close_code = code;
+    if (self->on_close) {
+        PyObject* result = PyObject_CallFunction(self->on_close, "is#", code,
+                                                 reason ? reason : "", (Py_ssize_t)length);
+        if (!result) PyErr_Print();
+        Py_XDECREF(result);
+    }
+    Py_CLEAR(self->on_message);
+    Py_CLEAR(self->on_close);
+    Py_DECREF(self);
+
+    PyGILState_Release(gstate);
+}
+
+// Module initialization function
+PyObject* init_websocket(void) {
+    if (PyType_Ready(&WebSocketType) < 0)
+        return NULL;
+
+    static struct PyModuleDef moduledef = {
+        PyModuleDef_HEAD_INIT,
+        "catzilla._websocket",
+        "Catzilla WebSocket module",
+        -1,
+        NULL,
+        NULL,
+        NULL,
+        NULL,
+        NULL
+    };
+
+    PyObject* module = PyModule_Create(&moduledef);
+    if (module == NULL)
+        return NULL;
+
+    // Upgraded connections reach Python without looking this module up
+    static const catzilla_websocket_hooks_t hooks = {
+        websocket_open,
+        websocket_message,
+        websocket_closed,
+    };
+    catzilla_server_set_websocket_hooks(&hooks);
+
+    Py_INCREF(&WebSocketType);
+    if (PyModule_AddObject(module, "WebSocket", (PyObject*)&WebSocketType) < 0) {
+        Py_DECREF(&WebSocketType);
+        Py_DECREF(module);
+        return NULL;
+    }
+
+    return module;
+}
@@ -0,0 +1,189 @@
+// tests/c/test_access_log.c
+#include "unity.h"
+#include "access_log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <uv.h>
+
+static char log_path[256];
+
+void setUp(void) {
+    snprintf(log_path, sizeof(log_path), "/tmp/catzilla_access_log_%d.log", (int)uv_os_getpid());
+    remove(log_path);
+}
+
+void tearDown(void) {
+    remove(log_path);
+}
+
+static catzilla_access_record_t make_record(const char* method, const char* target, uint16_t status) {
+    catzilla_access_record_t record;
+    memset(&record, 0, sizeof(record));
+    record.started_ns = uv_hrtime();
+    record.duration_ns = 1250000;
+    record.bytes = 512;
+    record.route_id = 3;
+    record.status = status;
+    record.http_major = 1;
+    record.http_minor = 1;
+    strcpy(record.method, method);
+    strcpy(record.remote_addr, "10.0.0.7");
+    strcpy(record.target, target);
+    return record;
+}
+
+static size_t count_lines(void) {
+    FILE* file = fopen(log_path, "r");
+    if (!file) return 0;
+    size_t lines = 0;
+    int c;
+    while ((c = fgetc(file)) != EOF) {
+        if (c == '\n') lines++;
+    }
+    fclose(file);
+    return lines;
+}
+
+void test_format_json_and_clf() {
+    catzilla_access_record_t record = make_record("GET", "/say?q=\"hi\"\n", 200);
+    char line[2048];
+    // 2026-10-14 09:30:05.000250 UTC
+    uint64_t wall_us = 1791970205ULL * 1000000ULL + 250;
+
+    size_t length = catzilla_access_log_format_record(CATZILLA_ACCESS_LOG_JSON, &record, wall_us,
+                                                      line, sizeof(line));
+    TEST_ASSERT_TRUE(length > 0);
+    line[length] = '\0';
+    TEST_ASSERT_EQUAL_STRING("{\"time\":\"2026-10-14T09:30:05.000250Z\",\"remote\":\"10.0.0.7\","
+                             "\"method\":\"GET\",\"target\":\"/say?q=\\\"hi\\\"\\u000a\","
+                             "\"protocol\":\"HTTP/1.1\",\"route\":3,\"status\":200,\"bytes\":512,"
+                             "\"duration_ms\":1.250}\n", line);
+
+    length = catzilla_access_log_format_record(CATZILLA_ACCESS_LOG_CLF, &record, wall_us,
+                                               line, sizeof(line));
+    TEST_ASSERT_TRUE(length > 0);
+    line[length] = '\0';
+    TEST_ASSERT_EQUAL_STRING("10.0.0.7 - - [14/Oct/2026:09:30:05 +0000] "
+                             "\"GET /say?q=\\x22hi\\x22\\x0a HTTP/1.1\" 200 512\n", line);
+
+    // Leap day, no remote address
+    record.remote_addr[0] = '\0';
+    length = catzilla_access_log_format_record(CATZILLA_ACCESS_LOG_CLF, &record, 951868799ULL * 1000000ULL,
+                                               line, sizeof(line));
+    line[length] = '\0';
+    TEST_ASSERT_NOT_NULL(strstr(line, "- - - [29/Feb/2000:23:59:59 +0000]"));
+
+    // Too small a buffer writes nothing
+    TEST_ASSERT_EQUAL(0, catzilla_access_log_format_record(CATZILLA_ACCESS_LOG_JSON, &record, wall_us,
+                                                           line, 32));
+}
+
+void test_full_ring_drops_and_counts() {
+    catzilla_access_log_config_t config = {0};
+    config.ring_records = 4;
+    config.no_background = true;
+    catzilla_access_log_t* log = catzilla_access_log_open(log_path, &config);
+    TEST_ASSERT_NOT_NULL(log);
+
+    catzilla_access_record_t record = make_record("POST", "/items", 201);
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_TRUE(catzilla_access_log_append(log, &record));
+    }
+    TEST_ASSERT_FALSE(catzilla_access_log_append(log, &record));
+    TEST_ASSERT_FALSE(catzilla_access_log_append(log, &record));
+
+    TEST_ASSERT_EQUAL(4, catzilla_access_log_flush(log));
+    TEST_ASSERT_EQUAL(4, count_lines());
+
+    // Drained slots take records again
+    TEST_ASSERT_TRUE(catzilla_access_log_append(log, &record));
+    catzilla_access_log_stats_t stats;
+    catzilla_access_log_get_stats(log, &stats);
+    TEST_ASSERT_EQUAL_UINT64(4, stats.written);
+    TEST_ASSERT_EQUAL_UINT64(2, stats.dropped);
+    TEST_ASSERT_EQUAL_UINT64(1, stats.rings);
+
+    // Close writes what is still queued
+    catzilla_access_log_close(log);
+    TEST_ASSERT_EQUAL(5, count_lines());
+}
+
+void test_sampling_per_route() {
+    catzilla_access_log_config_t config = {0};
+    config.no_background = true;
+    catzilla_access_log_t* log = catzilla_access_log_open(log_path, &config);
+    TEST_ASSERT_NOT_NULL(log);
+
+    // Everything by default
+    TEST_ASSERT_TRUE(catzilla_access_log_sampled(log, CATZILLA_ACCESS_LOG_NO_ROUTE));
+
+    catzilla_access_log_set_sample_rate(log, 0.0);
+    TEST_ASSERT_EQUAL_INT(0, catzilla_access_log_set_route_sample_rate(log, 2, 1.0));
+    TEST_ASSERT_EQUAL_INT(0, catzilla_access_log_set_route_sample_rate(log, 500, 0.25));
+    TEST_ASSERT_FALSE(catzilla_access_log_sampled(log, 1));
+    TEST_ASSERT_TRUE(catzilla_access_log_sampled(log, 2));
+
+    int kept = 0;
+    for (int i = 0; i < 20000; i++) {
+        if (catzilla_access_log_sampled(log, 500)) kept++;
+    }
+    TEST_ASSERT_TRUE(kept > 4000 && kept < 6000);
+
+    catzilla_access_log_close(log);
+}
+
+typedef struct {
+    catzilla_access_log_t* log;
+    int appended;
+    int dropped;
+} producer_args_t;
+
+static void produce(void* arg) {
+    producer_args_t* args = arg;
+    catzilla_access_record_t record = make_record("GET", "/", 200);
+    for (int i = 0; i < 2000; i++) {
+        if (catzilla_access_log_append(args->log, &record)) {
+            args->appended++;
+        } else {
+            args->dropped++;
+        }
+        if (i % 100 == 0) uv_sleep(1);
+    }
+}
+
+void test_background_writer_drains_loops() {
+    catzilla_access_log_config_t config = {0};
+    config.ring_records = 64;
+    config.flush_interval_ms = 1;
+    catzilla_access_log_t* log = catzilla_access_log_open(log_path, &config);
+    TEST_ASSERT_NOT_NULL(log);
+
+    producer_args_t args[2] = {{log, 0, 0}, {log, 0, 0}};
+    uv_thread_t threads[2];
+    TEST_ASSERT_EQUAL_INT(0, uv_thread_create(&threads[0], produce, &args[0]));
+    TEST_ASSERT_EQUAL_INT(0, uv_thread_create(&threads[1], produce, &args[1]));
+    uv_thread_join(&threads[0]);
+    uv_thread_join(&threads[1]);
+
+    catzilla_access_log_stats_t stats;
+    catzilla_access_log_get_stats(log, &stats);
+    TEST_ASSERT_EQUAL_UINT64(2, stats.rings);
+    TEST_ASSERT_EQUAL_UINT64((uint64_t)(args[0].dropped + args[1].dropped), stats.dropped);
+    catzilla_access_log_close(log);
+
+    // Every record a ring took is in the file exactly once
+    TEST_ASSERT_EQUAL((size_t)(args[0].appended + args[1].appended), count_lines());
+    TEST_ASSERT_EQUAL(4000, args[0].appended + args[1].appended + args[0].dropped + args[1].dropped);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_format_json_and_clf);
+    RUN_TEST(test_full_ring_drops_and_counts);
+    RUN_TEST(test_sampling_per_route);
+    RUN_TEST(test_background_writer_drains_loops);
+
+    return UNITY_END();
+}
@@ -2,9 +2,24 @@
 #include "unity.h"
 #include "router.h"
 #include <string.h>
+#include <pthread.h>
+#include <sched.h>
 
 static catzilla_router_t router;
 
+// Copy of a parameter value, for the string assertions
+static const char* param_value(const catzilla_route_match_t* match, int index) {
+    static char value[CATZILLA_PATH_SEGMENT_MAX];
+    if (catzilla_router_match_param_copy(match, index, value, sizeof(value)) < 0) return NULL;
+    return value;
+}
+
+static const char* allowed_methods(const catzilla_route_match_t* match) {
+    static char allowed[256];
+    catzilla_router_match_allowed_methods(match, allowed, sizeof(allowed));
+    return allowed;
+}
+
 void setUp(void) {
     TEST_ASSERT_EQUAL(0, catzilla_router_init(&router));
 }
@@ -17,7 +32,7 @@ void tearDown(void) {
 void test_router_init_cleanup() {
     catzilla_router_t test_router;
     TEST_ASSERT_EQUAL(0, catzilla_router_init(&test_router));
-    TEST_ASSERT_NOT_NULL(test_router.root);
+    TEST_ASSERT_NOT_NULL(test_router.snapshot->root);
     TEST_ASSERT_EQUAL(0, test_router.route_count);
     catzilla_router_cleanup(&test_router);
 }
@@ -98,8 +113,8 @@ void test_match_dynamic_route() {
     TEST_ASSERT_EQUAL_STRING("/users/{user_id}", match.route->path);
     TEST_ASSERT_EQUAL_PTR(dummy_handler, match.route->handler);
     TEST_ASSERT_EQUAL(1, match.param_count);
-    TEST_ASSERT_EQUAL_STRING("user_id", match.params[0].name);
-    TEST_ASSERT_EQUAL_STRING("123", match.params[0].value);
+    TEST_ASSERT_EQUAL_STRING("user_id", catzilla_router_match_param_name(&match, 0));
+    TEST_ASSERT_EQUAL_STRING("123", param_value(&match, 0));
 }
 
 void test_match_multiple_parameters() {
@@ -112,10 +127,10 @@ void test_match_multiple_parameters() {
     TEST_ASSERT_EQUAL(0, result);
     TEST_ASSERT_NOT_NULL(match.route);
     TEST_ASSERT_EQUAL(2, match.param_count);
-    TEST_ASSERT_EQUAL_STRING("user_id", match.params[0].name);
-    TEST_ASSERT_EQUAL_STRING("456", match.params[0].value);
-    TEST_ASSERT_EQUAL_STRING("post_id", match.params[1].name);
-    TEST_ASSERT_EQUAL_STRING("789", match.params[1].value);
+    TEST_ASSERT_EQUAL_STRING("user_id", catzilla_router_match_param_name(&match, 0));
+    TEST_ASSERT_EQUAL_STRING("456", param_value(&match, 0));
+    TEST_ASSERT_EQUAL_STRING("post_id", catzilla_router_match_param_name(&match, 1));
+    TEST_ASSERT_EQUAL_STRING("789", param_value(&match, 1));
 }
 
 void test_no_match_wrong_path() {
@@ -215,6 +230,339 @@ void test_large_number_of_routes() {
     }
 }
 
+// Radix tree layout
+void test_compressed_edges_split_on_divergence() {
+    void* handler = (void*)0x12345;
+    TEST_ASSERT_NOT_EQUAL(0, catzilla_router_add_route(&router, "GET", "/api/v1/users", handler, NULL, false));
+    TEST_ASSERT_EQUAL(1, router.snapshot->root->child_count);
+    TEST_ASSERT_EQUAL_STRING("api/v1/users", router.snapshot->root->children[0]->label);
+
+    TEST_ASSERT_NOT_EQUAL(0, catzilla_router_add_route(&router, "GET", "/api/v1/orders", handler, NULL, false));
+    TEST_ASSERT_NOT_EQUAL(0, catzilla_router_add_route(&router, "GET", "/api", handler, NULL, false));
+    catzilla_route_node_t* api = router.snapshot->root->children[0];
+    TEST_ASSERT_EQUAL_STRING_LEN("api", api->label, api->label_len);
+    TEST_ASSERT_EQUAL(1, api->child_count);
+    TEST_ASSERT_EQUAL(2, api->children[0]->child_count);
+
+    catzilla_route_match_t match;
+    TEST_ASSERT_EQUAL(0, catzilla_router_match(&router, "GET", "/api/v1/orders", &match));
+    TEST_ASSERT_EQUAL_STRING("/api/v1/orders", match.route->path);
+    TEST_ASSERT_EQUAL(0, catzilla_router_match(&router, "GET", "/api", &match));
+    TEST_ASSERT_EQUAL_STRING("/api", match.route->path);
+    TEST_ASSERT_EQUAL(-1, catzilla_router_match(&router, "GET", "/api/v1", &match));
+    TEST_ASSERT_EQUAL(404, match.status_code);
+    TEST_ASSERT_EQUAL(-1, catzilla_router_match(&router, "GET", "/api/v1/usersx", &match));
+    TEST_ASSERT_EQUAL(0, catzilla_router_match(&router, "GET", "//api//v1/users/", &match));
+}
+
+void test_static_segments_take_precedence_over_params() {
+    void* handler = (void*)0x12345;
+    catzilla_router_add_route(&router, "GET", "/api/v1/users", handler, NULL, false);
+    catzilla_router_add_route(&router, "GET", "/api/{version}/items", handler, NULL, false);
+
+    catzilla_route_match_t match;
+    TEST_ASSERT_EQUAL(0, catzilla_router_match(&router, "GET", "/api/v1/users", &match));
+    TEST_ASSERT_EQUAL(0, match.param_count);
+
+    // The static edge does not lead to "items", so the parameter branch does
+    TEST_ASSERT_EQUAL(0, catzilla_router_match(&router, "GET", "/api/v1/items", &match));
+    TEST_ASSERT_EQUAL_STRING("/api/{version}/items", match.route->path);
+    TEST_ASSERT_EQUAL(1, match.param_count);
+    TEST_ASSERT_EQUAL_STRING("version", catzilla_router_match_param_name(&match, 0));
+    TEST_ASSERT_EQUAL_STRING("v1", param_value(&match, 0));
+}
+
+void test_method_slots_and_allowed_methods() {
+    void* handler = (void*)0x12345;
+    catzilla_router_add_route(&router, "GET", "/items", handler, NULL, false);
+    catzilla_router_add_route(&router, "POST", "/items", handler, NULL, false);
+    catzilla_router_add_route(&router, "PURGE", "/items", handler, NULL, false);
+
+    catzilla_route_match_t match;
+    TEST_ASSERT_EQUAL(0, catzilla_router_match(&router, "purge", "/items", &match));
+    TEST_ASSERT_EQUAL_STRING("PURGE", match.route->method);
+
+    // Auto-HEAD falls back to GET
+    TEST_ASSERT_EQUAL(0, catzilla_router_match(&router, "HEAD", "/items", &match));
+    TEST_ASSERT_EQUAL_STRING("GET", match.route->method);
+
+    TEST_ASSERT_EQUAL(-1, catzilla_router_match(&router, "DELETE", "/items", &match));
+    TEST_ASSERT_EQUAL(405, match.status_code);
+    TEST_ASSERT_TRUE(match.has_allowed_methods);
+    TEST_ASSERT_EQUAL_STRING("GET, HEAD, POST, PURGE", allowed_methods(&match));
+
+    TEST_ASSERT_EQUAL(CATZILLA_HTTP_PATCH, catzilla_router_method_id("PATCH"));
+    TEST_ASSERT_EQUAL(CATZILLA_HTTP_OTHER, catzilla_router_method_id("PURGE"));
+}
+
+void test_remove_route_clears_handler_slot() {
+    void* handler = (void*)0x12345;
+    uint32_t get_id = catzilla_router_add_route(&router, "GET", "/users/{id}/posts", handler, NULL, false);
+    catzilla_router_add_route(&router, "POST", "/users/{id}/posts", handler, NULL, false);
+
+    TEST_ASSERT_EQUAL(0, catzilla_router_remove_route(&router, get_id));
+
+    catzilla_route_match_t match;
+    TEST_ASSERT_EQUAL(-1, catzilla_router_match(&router, "GET", "/users/7/posts", &match));
+    TEST_ASSERT_EQUAL(405, match.status_code);
+    TEST_ASSERT_EQUAL_STRING("POST", allowed_methods(&match));
+    TEST_ASSERT_EQUAL(0, catzilla_router_match(&router, "POST", "/users/7/posts", &match));
+}
+
+void test_static_paths_use_exact_match_table() {
+    void* handler = (void*)0x12345;
+    catzilla_router_add_route(&router, "GET", "/health", handler, NULL, false);
+    catzilla_router_add_route(&router, "POST", "/health", handler, NULL, false);
+    catzilla_router_add_route(&router, "GET", "/", handler, NULL, false);
+    catzilla_router_add_route(&router, "GET", "/users/{id}", handler, NULL, false);
+    catzilla_router_add_route(&router, "GET", "/users/me", handler, NULL, false);
+
+    // One entry per path, whatever the number of methods; parameters stay out
+    TEST_ASSERT_EQUAL(3, router.snapshot->static_count);
+
+    catzilla_route_match_t match;
+    TEST_ASSERT_EQUAL(0, catzilla_router_match(&router, "GET", "/users/me", &match));
+    TEST_ASSERT_EQUAL_STRING("/users/me", match.route->path);
+    TEST_ASSERT_EQUAL(0, catzilla_router_match(&router, "GET", "/users/42", &match));
+    TEST_ASSERT_EQUAL_STRING("42", param_value(&match, 0));
+    TEST_ASSERT_EQUAL(0, catzilla_router_match(&router, "GET", "/", &match));
+    TEST_ASSERT_EQUAL_STRING("/", match.route->path);
+
+    TEST_ASSERT_EQUAL(-1, catzilla_router_match(&router, "DELETE", "/health/", &match));
+    TEST_ASSERT_EQUAL(405, match.status_code);
+    TEST_ASSERT_EQUAL_STRING("GET, HEAD, POST", allowed_methods(&match));
+
+    // A removed static route no longer shadows a parameter route
+    TEST_ASSERT_EQUAL(0, catzilla_router_match(&router, "GET", "/users/me", &match));
+    TEST_ASSERT_EQUAL(0, catzilla_router_remove_route(&router, match.route->id));
+    TEST_ASSERT_EQUAL(0, catzilla_router_match(&router, "GET", "/users/me", &match));
+    TEST_ASSERT_EQUAL_STRING("/users/{id}", match.route->path);
+}
+
+void test_route_count_is_not_capped() {
+    void* handler = (void*)0x12345;
+    for (int i = 0; i < 2500; i++) {
+        char path[64];
+        snprintf(path, sizeof(path), "/svc/%d/{id}/detail", i);
+        TEST_ASSERT_NOT_EQUAL(0, catzilla_router_add_route(&router, "GET", path, handler, NULL, false));
+    }
+    TEST_ASSERT_EQUAL(2500, router.route_count);
+    TEST_ASSERT_TRUE(catzilla_router_memory_usage(&router) > 2500 * sizeof(catzilla_route_t));
+
+    catzilla_route_match_t match;
+    TEST_ASSERT_EQUAL(0, catzilla_router_match(&router, "GET", "/svc/2499/abc/detail", &match));
+    TEST_ASSERT_EQUAL_STRING("/svc/2499/{id}/detail", match.route->path);
+    TEST_ASSERT_EQUAL_STRING("abc", param_value(&match, 0));
+}
+
+void test_params_are_slices_of_the_request_path() {
+    void* handler = (void*)0x12345;
+    catzilla_router_add_route(&router, "GET", "/users/{id}", handler, NULL, false);
+    catzilla_router_add_route(&router, "POST", "/users/{uid}/files/{name}", handler, NULL, false);
+    catzilla_router_add_route(&router, "GET", "/users/{id}/files/{name}", handler, NULL, false);
+
+    const char* path = "/users/42";
+    catzilla_route_match_t match;
+    TEST_ASSERT_EQUAL(0, catzilla_router_match(&router, "GET", path, &match));
+    size_t length = 0;
+    TEST_ASSERT_EQUAL_PTR(path + 7, catzilla_router_match_param_value(&match, 0, &length));
+    TEST_ASSERT_EQUAL(2, length);
+
+    // Offsets survive collapsed slashes
+    TEST_ASSERT_EQUAL(0, catzilla_router_match(&router, "GET", "//users///42//files/a.txt", &match));
+    TEST_ASSERT_EQUAL_STRING("42", param_value(&match, 0));
+    TEST_ASSERT_EQUAL_STRING("a.txt", param_value(&match, 1));
+
+    // Names come from the matched route, not from the first route of the node
+    TEST_ASSERT_EQUAL(0, catzilla_router_match(&router, "POST", "/users/7/files/b", &match));
+    TEST_ASSERT_EQUAL_STRING("uid", catzilla_router_match_param_name(&match, 0));
+    char value[8];
+    TEST_ASSERT_EQUAL(1, catzilla_router_get_param(&match, "name", value, sizeof(value)));
+    TEST_ASSERT_EQUAL_STRING("b", value);
+    TEST_ASSERT_EQUAL(-1, catzilla_router_get_param(&match, "id", value, sizeof(value)));
+
+    TEST_ASSERT_TRUE(sizeof(catzilla_route_match_t) <= 128);
+}
+
+void test_typed_params_disambiguate_and_fall_through() {
+    void* handler = (void*)0x12345;
+    catzilla_router_add_route(&router, "GET", "/items/{slug}", handler, NULL, false);
+    catzilla_router_add_route(&router, "GET", "/items/{id:int(1,1000)}", handler, NULL, false);
+    catzilla_router_add_route(&router, "GET", "/keys/{key:uuid}", handler, NULL, false);
+    catzilla_router_add_route(&router, "GET", "/files/{rest:path}", handler, NULL, false);
+    catzilla_router_add_route(&router, "GET", "/codes/{code:str(2,3)}", handler, NULL, false);
+
+    // Registered after the plain parameter, the int one is still tried first
+    catzilla_route_match_t match;
+    TEST_ASSERT_EQUAL(0, catzilla_router_match(&router, "GET", "/items/42", &match));
+    TEST_ASSERT_EQUAL_STRING("/items/{id:int(1,1000)}", match.route->path);
+    TEST_ASSERT_EQUAL(CATZILLA_PARAM_INT, match.route->param_constraints[0].type);
+
+    // Out of bounds or not a number: the next candidate takes it
+    TEST_ASSERT_EQUAL(0, catzilla_router_match(&router, "GET", "/items/5000", &match));
+    TEST_ASSERT_EQUAL_STRING("/items/{slug}", match.route->path);
+    TEST_ASSERT_EQUAL(0, catzilla_router_match(&router, "GET", "/items/-3", &match));
+    TEST_ASSERT_EQUAL_STRING("/items/{slug}", match.route->path);
+
+    TEST_ASSERT_EQUAL(0, catzilla_router_match(&router, "GET",
+                                               "/keys/123e4567-e89b-12d3-a456-426614174000", &match));
+    TEST_ASSERT_EQUAL(-1, catzilla_router_match(&router, "GET", "/keys/not-a-uuid", &match));
+    TEST_ASSERT_EQUAL(404, match.status_code);
+
+    TEST_ASSERT_EQUAL(0, catzilla_router_match(&router, "GET", "/files/a//b/c.txt", &match));
+    TEST_ASSERT_EQUAL_STRING("a//b/c.txt", param_value(&match, 0));
+
+    TEST_ASSERT_EQUAL(0, catzilla_router_match(&router, "GET", "/codes/abc", &match));
+    TEST_ASSERT_EQUAL(-1, catzilla_router_match(&router, "GET", "/codes/abcd", &match));
+
+    // Unknown types, bad bounds and a path parameter before the end are rejected
+    TEST_ASSERT_EQUAL(0, catzilla_router_add_route(&router, "GET", "/bad/{id:float}", handler, NULL, false));
+    TEST_ASSERT_EQUAL(0, catzilla_router_add_route(&router, "GET", "/bad/{id:int(9,1)}", handler, NULL, false));
+    TEST_ASSERT_EQUAL(0, catzilla_router_add_route(&router, "GET", "/bad/{p:path}/x", handler, NULL, false));
+
+    int64_t number = 0;
+    catzilla_param_constraint_t constraint = { CATZILLA_PARAM_INT, false, false, 0, 0 };
+    TEST_ASSERT_TRUE(catzilla_router_param_accepts(&constraint, "-9223372036854775808", 20, &number));
+    TEST_ASSERT_TRUE(number == INT64_MIN);
+    TEST_ASSERT_FALSE(catzilla_router_param_accepts(&constraint, "9223372036854775808", 19, NULL));
+}
+
+// Matches a route that is never touched while the main thread churns others
+static volatile int reader_stop;
+static void* match_stable_route(void* arg) {
+    (void)arg;
+    long misses = 0;
+    while (!reader_stop) {
+        catzilla_route_match_t match;
+        if (catzilla_router_match(&router, "GET", "/stable/9", &match) != 0 ||
+            strcmp(match.route->path, "/stable/{id}") != 0) {
+            misses++;
+        }
+    }
+    return (void*)misses;
+}
+
+void test_shared_router_publishes_snapshots() {
+    void* handler = (void*)0x12345;
+    catzilla_router_add_route(&router, "GET", "/stable/{id}", handler, NULL, false);
+    catzilla_router_add_route(&router, "PUT", "/flag", handler, NULL, false);
+    catzilla_router_share(&router);
+
+    pthread_t reader;
+    reader_stop = 0;
+    TEST_ASSERT_EQUAL(0, pthread_create(&reader, NULL, match_stable_route, NULL));
+    for (int i = 0; i < 200; i++) {
+        uint32_t id = catzilla_router_add_route(&router, "GET", "/flag", handler, NULL, false);
+        TEST_ASSERT_NOT_EQUAL(0, id);
+        TEST_ASSERT_EQUAL(0, catzilla_router_remove_route(&router, id));
+    }
+    reader_stop = 1;
+    void* misses = NULL;
+    pthread_join(reader, &misses);
+    TEST_ASSERT_EQUAL(0, (long)misses);
+
+    // No lookup is running, so every replaced snapshot can go
+    TEST_ASSERT_EQUAL(0, catzilla_router_reclaim(&router));
+    TEST_ASSERT_NULL(router.retired);
+    TEST_ASSERT_NULL(router.retired_routes);
+
+    // The 405 list survives the snapshot it was computed from
+    catzilla_route_match_t match;
+    TEST_ASSERT_EQUAL(-1, catzilla_router_match(&router, "GET", "/flag", &match));
+    TEST_ASSERT_EQUAL(405, match.status_code);
+    catzilla_router_add_route(&router, "DELETE", "/other", handler, NULL, false);
+    TEST_ASSERT_EQUAL_STRING("PUT", allowed_methods(&match));
+
+    TEST_ASSERT_EQUAL(0, catzilla_router_find_route(&router, "GET", "/flag"));
+    TEST_ASSERT_NOT_EQUAL(0, catzilla_router_find_route(&router, "put", "/flag/"));
+}
+
+// Counts the routes handed to the release hook
+static int released_routes;
+static void count_released_route(catzilla_route_t* route) {
+    (void)route;
+    released_routes++;
+}
+
+void test_removed_routes_wait_for_readers_and_holds() {
+    void* handler = (void*)0x12345;
+    catzilla_router_share(&router);
+    router.release_route = count_released_route;
+    released_routes = 0;
+
+    // A read section keeps what it found until it ends
+    uint32_t id = catzilla_router_add_route(&router, "GET", "/read/{id}", handler, NULL, false);
+    catzilla_router_read_begin();
+    catzilla_route_match_t match;
+    TEST_ASSERT_EQUAL(0, catzilla_router_match(&router, "GET", "/read/1", &match));
+    TEST_ASSERT_EQUAL(0, catzilla_router_remove_route(&router, id));
+    // The route and the snapshot it was found in
+    TEST_ASSERT_EQUAL(2, catzilla_router_reclaim(&router));
+    TEST_ASSERT_EQUAL_STRING("/read/{id}", match.route->path);
+    catzilla_router_read_end();
+    TEST_ASSERT_EQUAL(0, catzilla_router_reclaim(&router));
+    TEST_ASSERT_EQUAL(1, released_routes);
+
+    // A hold taken inside the section outlives it
+    id = catzilla_router_add_route(&router, "GET", "/held", handler, NULL, false);
+    catzilla_router_read_begin();
+    TEST_ASSERT_EQUAL(0, catzilla_router_match(&router, "GET", "/held", &match));
+    catzilla_router_hold_route(match.route);
+    catzilla_router_read_end();
+    TEST_ASSERT_EQUAL(0, catzilla_router_remove_route(&router, id));
+    TEST_ASSERT_EQUAL(1, catzilla_router_reclaim(&router));
+    TEST_ASSERT_EQUAL_STRING("/held", match.route->path);
+    catzilla_router_release_route(match.route);
+    TEST_ASSERT_EQUAL(0, catzilla_router_reclaim(&router));
+    TEST_ASSERT_EQUAL(2, released_routes);
+    TEST_ASSERT_NULL(router.retired_routes);
+}
+
+// One lookup, so the thread claims a reader slot before it exits
+static void* match_once(void* arg) {
+    (void)arg;
+    catzilla_route_match_t match;
+    return (void*)(long)catzilla_router_match(&router, "GET", "/stable/9", &match);
+}
+
+// Stays in a read section until told to stop
+static volatile int reader_started;
+static void* read_until_stopped(void* arg) {
+    (void)arg;
+    catzilla_router_read_begin();
+    reader_started = 1;
+    while (!reader_stop) sched_yield();
+    catzilla_router_read_end();
+    return NULL;
+}
+
+void test_reader_slots_are_released_when_threads_exit() {
+    void* handler = (void*)0x12345;
+    catzilla_router_add_route(&router, "GET", "/stable/{id}", handler, NULL, false);
+    catzilla_router_share(&router);
+
+    // More threads than slots: each exit frees its slot for the next one
+    for (int i = 0; i < CATZILLA_ROUTER_MAX_READERS * 2; i++) {
+        pthread_t reader;
+        TEST_ASSERT_EQUAL(0, pthread_create(&reader, NULL, match_once, NULL));
+        void* result = (void*)-1;
+        pthread_join(reader, &result);
+        TEST_ASSERT_EQUAL(0, (long)result);
+    }
+
+    // A slotless reader would hold up even removals older than its section
+    uint32_t id = catzilla_router_add_route(&router, "GET", "/gone", handler, NULL, false);
+    TEST_ASSERT_EQUAL(0, catzilla_router_remove_route(&router, id));
+    pthread_t reader;
+    reader_started = 0;
+    reader_stop = 0;
+    TEST_ASSERT_EQUAL(0, pthread_create(&reader, NULL, read_until_stopped, NULL));
+    while (!reader_started) sched_yield();
+    TEST_ASSERT_EQUAL(0, catzilla_router_reclaim(&router));
+    reader_stop = 1;
+    pthread_join(reader, NULL);
+}
+
 int main(void) {
     UNITY_BEGIN();
 
@@ -242,5 +590,18 @@ int main(void) {
     // Memory management
     RUN_TEST(test_large_number_of_routes);
 
+    // Radix tree layout
+    RUN_TEST(test_compressed_edges_split_on_divergence);
+    RUN_TEST(test_static_segments_take_precedence_over_params);
+    RUN_TEST(test_method_slots_and_allowed_methods);
+    RUN_TEST(test_remove_route_clears_handler_slot);
+    RUN_TEST(test_static_paths_use_exact_match_table);
+    RUN_TEST(test_route_count_is_not_capped);
+    RUN_TEST(test_params_are_slices_of_the_request_path);
+    RUN_TEST(test_typed_params_disambiguate_and_fall_through);
+    RUN_TEST(test_shared_router_publishes_snapshots);
+    RUN_TEST(test_removed_routes_wait_for_readers_and_holds);
+    RUN_TEST(test_reader_slots_are_released_when_threads_exit);
+
     return UNITY_END();
 }
@@ -2,6 +2,9 @@
 #include "unity.h"
 #include "cache_engine.h"
 #include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
 #ifndef _WIN32
 #include <unistd.h>
 #include <pthread.h>
@@ -168,6 +171,27 @@ void test_cache_binary_data() {
     TEST_ASSERT_EQUAL_MEMORY(binary_data, get_result.data, data_size);
 }
 
+void test_cache_get_copy() {
+    const char* key = "copy_test";
+    const char* value = "copied value";
+    size_t size = 0;
+
+    TEST_ASSERT_NULL(catzilla_cache_get_copy(test_cache, key, malloc, &size));
+    TEST_ASSERT_EQUAL(0, catzilla_cache_set(test_cache, key, value, strlen(value) + 1, 60));
+
+    char* copy = catzilla_cache_get_copy(test_cache, key, malloc, &size);
+    TEST_ASSERT_NOT_NULL(copy);
+    TEST_ASSERT_EQUAL(strlen(value) + 1, size);
+    TEST_ASSERT_EQUAL_STRING(value, copy);
+
+    // The copy outlives the entry
+    TEST_ASSERT_EQUAL(0, catzilla_cache_delete(test_cache, key));
+    TEST_ASSERT_EQUAL_STRING(value, copy);
+    free(copy);
+
+    TEST_ASSERT_NULL(catzilla_cache_get_copy(test_cache, key, malloc, &size));
+}
+
 void test_cache_edge_cases() {
     // Test empty key (should succeed - empty string is a valid key)
     int result = catzilla_cache_set(test_cache, "", "value", 6, 60);
@@ -188,6 +212,147 @@ void test_cache_edge_cases() {
     TEST_ASSERT_EQUAL(0, result);
 }
 
+void test_cache_clock_keeps_referenced_entries() {
+    cache_config_t config = { 64, 16, 1, 60, 1024, false, false, CACHE_CODEC_NONE, 0, 0, CACHE_EVICTION_CLOCK };
+    catzilla_cache_t* cache = catzilla_cache_create_with_config(&config);
+    TEST_ASSERT_NOT_NULL(cache);
+    TEST_ASSERT_EQUAL(1, cache->shard_count);
+
+    char key[32];
+    for (int i = 0; i < 64; i++) {
+        snprintf(key, sizeof(key), "key_%d", i);
+        TEST_ASSERT_EQUAL(0, catzilla_cache_set(cache, key, "v", 2, 60));
+    }
+    // The oldest entry is next in line for eviction, unless it was hit
+    TEST_ASSERT_TRUE(catzilla_cache_get(cache, "key_0").found);
+
+    for (int i = 64; i < 96; i++) {
+        snprintf(key, sizeof(key), "key_%d", i);
+        TEST_ASSERT_EQUAL(0, catzilla_cache_set(cache, key, "v", 2, 60));
+    }
+    TEST_ASSERT_TRUE(catzilla_cache_exists(cache, "key_0"));
+    TEST_ASSERT_FALSE(catzilla_cache_exists(cache, "key_1"));
+
+    cache_statistics_t stats = catzilla_cache_get_stats(cache);
+    TEST_ASSERT_EQUAL(64, stats.size);
+    TEST_ASSERT_EQUAL(32, stats.evictions);
+    catzilla_cache_destroy(cache);
+}
+
+void test_cache_tinylfu_keeps_hot_keys_through_a_scan() {
+    cache_eviction_policy_t policies[] = { CACHE_EVICTION_CLOCK, CACHE_EVICTION_TINYLFU };
+    int hot_left[2];
+    char key[32];
+
+    for (int p = 0; p < 2; p++) {
+        cache_config_t config = { 200, 0, 1, 60, 1024, false, false, CACHE_CODEC_NONE, 0, 0, policies[p] };
+        catzilla_cache_t* cache = catzilla_cache_create_with_config(&config);
+        TEST_ASSERT_NOT_NULL(cache);
+        TEST_ASSERT_EQUAL(policies[p], cache->eviction_policy);
+
+        // A hot set read many times, then a scan of keys read once each
+        for (int round = 0; round < 5; round++) {
+            for (int i = 0; i < 100; i++) {
+                snprintf(key, sizeof(key), "hot_%d", i);
+                if (!catzilla_cache_get(cache, key).found) {
+                    TEST_ASSERT_EQUAL(0, catzilla_cache_set(cache, key, "v", 2, 60));
+                }
+            }
+        }
+        for (int i = 0; i < 2000; i++) {
+            snprintf(key, sizeof(key), "scan_%d", i);
+            if (!catzilla_cache_get(cache, key).found) {
+                TEST_ASSERT_EQUAL(0, catzilla_cache_set(cache, key, "v", 2, 60));
+            }
+        }
+
+        hot_left[p] = 0;
+        for (int i = 0; i < 100; i++) {
+            snprintf(key, sizeof(key), "hot_%d", i);
+            if (catzilla_cache_exists(cache, key)) hot_left[p]++;
+        }
+        cache_statistics_t stats = catzilla_cache_get_stats(cache);
+        TEST_ASSERT_EQUAL(200, stats.size);
+        if (policies[p] == CACHE_EVICTION_TINYLFU) {
+            TEST_ASSERT_TRUE(stats.rejections > 0);
+        } else {
+            TEST_ASSERT_EQUAL(0, stats.rejections);
+        }
+        catzilla_cache_destroy(cache);
+    }
+
+    TEST_ASSERT_EQUAL(0, hot_left[0]);
+    TEST_ASSERT_TRUE(hot_left[1] >= 90);
+}
+
+void test_cache_tinylfu_resize() {
+    cache_config_t config = { 1000, 0, 2, 60, 1024, false, false, CACHE_CODEC_NONE, 0, 0, CACHE_EVICTION_TINYLFU };
+    catzilla_cache_t* cache = catzilla_cache_create_with_config(&config);
+    TEST_ASSERT_NOT_NULL(cache);
+
+    char key[32];
+    for (int i = 0; i < 1500; i++) {
+        snprintf(key, sizeof(key), "key_%d", i);
+        TEST_ASSERT_EQUAL(0, catzilla_cache_set(cache, key, "v", 2, 60));
+    }
+    TEST_ASSERT_EQUAL(1000, catzilla_cache_get_stats(cache).size);
+
+    TEST_ASSERT_EQUAL(0, catzilla_cache_resize(cache, 100));
+    TEST_ASSERT_EQUAL(100, catzilla_cache_get_stats(cache).size);
+    for (size_t i = 0; i < cache->shard_count; i++) {
+        cache_shard_t* shard = &cache->shards[i];
+        TEST_ASSERT_TRUE(shard->region_size[CACHE_REGION_WINDOW] <= shard->window_capacity);
+        TEST_ASSERT_TRUE(shard->region_size[CACHE_REGION_PROTECTED] <= shard->protected_capacity);
+        TEST_ASSERT_EQUAL(shard->size, shard->region_size[CACHE_REGION_MAIN] +
+                          shard->region_size[CACHE_REGION_WINDOW] +
+                          shard->region_size[CACHE_REGION_PROTECTED]);
+    }
+
+    catzilla_cache_clear(cache);
+    TEST_ASSERT_EQUAL(0, catzilla_cache_get_stats(cache).size);
+    TEST_ASSERT_EQUAL(0, catzilla_cache_set(cache, "after", "v", 2, 60));
+    TEST_ASSERT_TRUE(catzilla_cache_exists(cache, "after"));
+    catzilla_cache_destroy(cache);
+}
+
+void test_cache_shards_split_capacity_and_stats() {
+    catzilla_cache_t* cache = catzilla_cache_create(4096, 0);
+    TEST_ASSERT_NOT_NULL(cache);
+    TEST_ASSERT_EQUAL(CATZILLA_CACHE_MAX_SHARDS, cache->shard_count);
+
+    char key[32];
+    for (int i = 0; i < 5000; i++) {
+        snprintf(key, sizeof(key), "key_%d", i);
+        TEST_ASSERT_EQUAL(0, catzilla_cache_set(cache, key, "value", 6, 60));
+    }
+    size_t per_shard_total = 0;
+    for (size_t i = 0; i < cache->shard_count; i++) {
+        TEST_ASSERT_TRUE(cache->shards[i].size <= cache->shards[i].capacity);
+        per_shard_total += cache->shards[i].capacity;
+    }
+    TEST_ASSERT_EQUAL(4096, per_shard_total);
+
+    int found = 0;
+    for (int i = 0; i < 5000; i++) {
+        snprintf(key, sizeof(key), "key_%d", i);
+        found += catzilla_cache_get(cache, key).found ? 1 : 0;
+    }
+
+    // Counters of every shard add up
+    cache_statistics_t stats = catzilla_cache_get_stats(cache);
+    TEST_ASSERT_EQUAL(found, stats.hits);
+    TEST_ASSERT_EQUAL(5000 - found, stats.misses);
+    TEST_ASSERT_EQUAL(5000, stats.total_requests);
+    TEST_ASSERT_EQUAL(found, stats.size);
+    TEST_ASSERT_EQUAL(5000 - found, stats.evictions);
+
+    TEST_ASSERT_EQUAL(0, catzilla_cache_resize(cache, 1024));
+    TEST_ASSERT_TRUE(catzilla_cache_get_stats(cache).size <= 1024);
+    catzilla_cache_clear(cache);
+    TEST_ASSERT_EQUAL(0, catzilla_cache_memory_usage(cache));
+    catzilla_cache_destroy(cache);
+}
+
 // Thread test data structure
 typedef struct {
     catzilla_cache_t* cache;
@@ -266,6 +431,251 @@ void test_cache_thread_safety() {
 #endif
 }
 
+static void fill_json(char* buffer, size_t size) {
+    size_t used = 0;
+    int n = 0;
+    while (used + 48 < size) {
+        used += (size_t)snprintf(buffer + used, size - used, "{\"id\":%d,\"name\":\"item\",\"ok\":true},", n++);
+    }
+    memset(buffer + used, ' ', size - used);
+}
+
+void test_cache_compresses_large_values() {
+    cache_codec_t codecs[] = { CACHE_CODEC_LZ4, CACHE_CODEC_ZSTD };
+    for (size_t c = 0; c < sizeof(codecs) / sizeof(codecs[0]); c++) {
+        if (!catzilla_cache_codec_available(codecs[c])) continue;
+        cache_config_t config = { 16, 0, 1, 60, 1024 * 1024, true, false, codecs[c], 256, 0, CACHE_EVICTION_CLOCK };
+        catzilla_cache_t* cache = catzilla_cache_create_with_config(&config);
+        TEST_ASSERT_NOT_NULL(cache);
+        TEST_ASSERT_EQUAL(codecs[c], cache->codec);
+
+        static char json[16384];
+        fill_json(json, sizeof(json));
+        TEST_ASSERT_EQUAL(0, catzilla_cache_set(cache, "big", json, sizeof(json), 60));
+        TEST_ASSERT_EQUAL(0, catzilla_cache_set(cache, "small", "tiny", 5, 60));
+
+        cache_statistics_t stats = catzilla_cache_get_stats(cache);
+        TEST_ASSERT_EQUAL(1, stats.compressed_entries);
+        TEST_ASSERT_EQUAL(sizeof(json), stats.uncompressed_bytes);
+        TEST_ASSERT_TRUE(stats.compressed_bytes < sizeof(json) / 4);
+        // Memory usage counts what is held, not what was stored
+        TEST_ASSERT_TRUE(catzilla_cache_memory_usage(cache) < sizeof(json) / 2);
+
+        cache_result_t result = catzilla_cache_get(cache, "big");
+        TEST_ASSERT_TRUE(result.found);
+        TEST_ASSERT_EQUAL(sizeof(json), result.size);
+        TEST_ASSERT_EQUAL_MEMORY(json, result.data, sizeof(json));
+        result = catzilla_cache_get(cache, "small");
+        TEST_ASSERT_TRUE(result.found);
+        TEST_ASSERT_EQUAL_STRING("tiny", (const char*)result.data);
+
+        size_t size = 0;
+        char* copy = catzilla_cache_get_copy(cache, "big", malloc, &size);
+        TEST_ASSERT_NOT_NULL(copy);
+        TEST_ASSERT_EQUAL(sizeof(json), size);
+        TEST_ASSERT_EQUAL_MEMORY(json, copy, sizeof(json));
+        free(copy);
+
+        // Replacing with a value below the threshold drops the compressed bytes
+        TEST_ASSERT_EQUAL(0, catzilla_cache_set(cache, "big", "short", 6, 60));
+        stats = catzilla_cache_get_stats(cache);
+        TEST_ASSERT_EQUAL(0, stats.compressed_entries);
+        TEST_ASSERT_EQUAL(0, stats.compressed_bytes);
+        TEST_ASSERT_EQUAL(0, stats.uncompressed_bytes);
+        catzilla_cache_destroy(cache);
+    }
+    catzilla_cache_release_thread_buffers();
+}
+
+void test_cache_stores_incompressible_values_as_is() {
+    cache_config_t config = { 16, 0, 1, 60, 1024 * 1024, true, false, CACHE_CODEC_NONE, 0, 0, CACHE_EVICTION_CLOCK };
+    catzilla_cache_t* cache = catzilla_cache_create_with_config(&config);
+    TEST_ASSERT_NOT_NULL(cache);
+    TEST_ASSERT_EQUAL(CATZILLA_CACHE_COMPRESSION_THRESHOLD, cache->compression_threshold);
+
+    char noise[4096];
+    uint32_t state = 2463534242u;
+    for (size_t i = 0; i < sizeof(noise); i++) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        noise[i] = (char)state;
+    }
+    TEST_ASSERT_EQUAL(0, catzilla_cache_set(cache, "noise", noise, sizeof(noise), 60));
+    cache_statistics_t stats = catzilla_cache_get_stats(cache);
+    TEST_ASSERT_EQUAL(0, stats.compressed_entries);
+    TEST_ASSERT_TRUE(stats.memory_usage >= sizeof(noise));
+
+    cache_result_t result = catzilla_cache_get(cache, "noise");
+    TEST_ASSERT_TRUE(result.found);
+    TEST_ASSERT_EQUAL_MEMORY(noise, result.data, sizeof(noise));
+    catzilla_cache_destroy(cache);
+    catzilla_cache_release_thread_buffers();
+}
+
+void test_cache_lookup_coalesces_misses() {
+    cache_config_t config = { 64, 0, 1, 60, 1024, false, false, CACHE_CODEC_NONE, 0, 0, CACHE_EVICTION_CLOCK };
+    catzilla_cache_t* cache = catzilla_cache_create_with_config(&config);
+    TEST_ASSERT_NOT_NULL(cache);
+
+    // The first miss computes; the rest wait instead of computing too
+    cache_lookup_state_t state;
+    size_t size = 0;
+    TEST_ASSERT_NULL(catzilla_cache_lookup(cache, "report", malloc, &size, &state));
+    TEST_ASSERT_EQUAL(CACHE_LOOKUP_FILL, state);
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_NULL(catzilla_cache_lookup(cache, "report", malloc, &size, &state));
+        TEST_ASSERT_EQUAL(CACHE_LOOKUP_WAIT, state);
+    }
+
+    TEST_ASSERT_EQUAL(0, catzilla_cache_set(cache, "report", "done", 5, 60));
+    char* copy = catzilla_cache_lookup(cache, "report", malloc, &size, &state);
+    TEST_ASSERT_NOT_NULL(copy);
+    TEST_ASSERT_EQUAL(CACHE_LOOKUP_FRESH, state);
+    TEST_ASSERT_EQUAL_STRING("done", copy);
+    free(copy);
+
+    // An abandoned claim goes to the next caller
+    TEST_ASSERT_NULL(catzilla_cache_lookup(cache, "failing", malloc, &size, &state));
+    TEST_ASSERT_EQUAL(CACHE_LOOKUP_FILL, state);
+    TEST_ASSERT_EQUAL(0, catzilla_cache_abandon(cache, "failing"));
+    TEST_ASSERT_EQUAL(-1, catzilla_cache_abandon(cache, "failing"));
+    TEST_ASSERT_NULL(catzilla_cache_lookup(cache, "failing", malloc, &size, &state));
+    TEST_ASSERT_EQUAL(CACHE_LOOKUP_FILL, state);
+
+    cache_statistics_t stats = catzilla_cache_get_stats(cache);
+    TEST_ASSERT_EQUAL(3, stats.fills);
+    TEST_ASSERT_EQUAL(3, stats.coalesced);
+    TEST_ASSERT_EQUAL(1, stats.hits);
+    catzilla_cache_destroy(cache);
+}
+
+void test_cache_lookup_claims_lapse() {
+    cache_config_t config = { 64, 0, 1, 60, 1024, false, false, CACHE_CODEC_NONE, 0, 1, CACHE_EVICTION_CLOCK };
+    catzilla_cache_t* cache = catzilla_cache_create_with_config(&config);
+    TEST_ASSERT_NOT_NULL(cache);
+
+    cache_lookup_state_t state;
+    TEST_ASSERT_NULL(catzilla_cache_lookup(cache, "slow", malloc, NULL, &state));
+    TEST_ASSERT_EQUAL(CACHE_LOOKUP_FILL, state);
+#ifndef _WIN32
+    usleep(5000);
+#else
+    Sleep(5);
+#endif
+    // The first caller never finished; another one takes over
+    TEST_ASSERT_NULL(catzilla_cache_lookup(cache, "slow", malloc, NULL, &state));
+    TEST_ASSERT_EQUAL(CACHE_LOOKUP_FILL, state);
+    catzilla_cache_destroy(cache);
+}
+
+void test_cache_lookup_serves_stale_while_one_refreshes() {
+    const char* key = "swr_test";
+
+    TEST_ASSERT_EQUAL(0, catzilla_cache_set_ex(test_cache, key, "old", 4, 1, 60));
+    cache_lookup_state_t state;
+    size_t size = 0;
+    char* copy = catzilla_cache_lookup(test_cache, key, malloc, &size, &state);
+    TEST_ASSERT_EQUAL(CACHE_LOOKUP_FRESH, state);
+    free(copy);
+
+#ifndef _WIN32
+    sleep(2);
+#else
+    Sleep(2000);
+#endif
+
+    // Past the soft TTL: one caller refreshes, everyone gets the old value
+    copy = catzilla_cache_lookup(test_cache, key, malloc, &size, &state);
+    TEST_ASSERT_EQUAL(CACHE_LOOKUP_REFRESH, state);
+    TEST_ASSERT_EQUAL_STRING("old", copy);
+    free(copy);
+    copy = catzilla_cache_lookup(test_cache, key, malloc, &size, &state);
+    TEST_ASSERT_EQUAL(CACHE_LOOKUP_STALE, state);
+    TEST_ASSERT_EQUAL_STRING("old", copy);
+    free(copy);
+    TEST_ASSERT_TRUE(catzilla_cache_get(test_cache, key).found);
+
+    TEST_ASSERT_EQUAL(0, catzilla_cache_set_ex(test_cache, key, "new", 4, 60, 60));
+    copy = catzilla_cache_lookup(test_cache, key, malloc, &size, &state);
+    TEST_ASSERT_EQUAL(CACHE_LOOKUP_FRESH, state);
+    TEST_ASSERT_EQUAL_STRING("new", copy);
+    free(copy);
+
+    cache_statistics_t stats = catzilla_cache_get_stats(test_cache);
+    TEST_ASSERT_EQUAL(2, stats.stale_hits);
+    TEST_ASSERT_EQUAL(1, stats.refreshes);
+}
+
+#ifndef _WIN32
+static void snapshot_path(char* path, size_t size) {
+    snprintf(path, size, "/tmp/catzilla_cache_snapshot_test_%d", (int)getpid());
+}
+
+void test_cache_snapshot_restores_lazily() {
+    char path[128];
+    snapshot_path(path, sizeof(path));
+    char key[32], value[32];
+    for (int i = 0; i < 50; i++) {
+        snprintf(key, sizeof(key), "key%d", i);
+        snprintf(value, sizeof(value), "value%d", i);
+        TEST_ASSERT_EQUAL(0, catzilla_cache_set(test_cache, key, value, strlen(value) + 1, 60));
+    }
+    TEST_ASSERT_EQUAL(0, catzilla_cache_save_snapshot(test_cache, path));
+
+    catzilla_cache_t* warm = catzilla_cache_create(100, 25);
+    TEST_ASSERT_EQUAL(0, catzilla_cache_load_snapshot(warm, path));
+    TEST_ASSERT_EQUAL(0, catzilla_cache_get_stats(warm).size);
+
+    // Only the first key's bucket is read
+    cache_result_t result = catzilla_cache_get(warm, "key7");
+    TEST_ASSERT_TRUE(result.found);
+    TEST_ASSERT_EQUAL_STRING("value7", result.data);
+    cache_statistics_t stats = catzilla_cache_get_stats(warm);
+    TEST_ASSERT_TRUE(stats.size > 0 && stats.size < 50);
+
+    // Keys stored and deleted since the load win over the snapshot
+    TEST_ASSERT_EQUAL(0, catzilla_cache_set(warm, "key3", "newer", 6, 60));
+    catzilla_cache_delete(warm, "key4");
+    TEST_ASSERT_EQUAL(0, catzilla_cache_restore_pending(warm, SIZE_MAX));
+    TEST_ASSERT_EQUAL_STRING("newer", catzilla_cache_get(warm, "key3").data);
+    TEST_ASSERT_FALSE(catzilla_cache_exists(warm, "key4"));
+    TEST_ASSERT_TRUE(catzilla_cache_exists(warm, "key49"));
+    stats = catzilla_cache_get_stats(warm);
+    TEST_ASSERT_EQUAL(49, stats.size);
+    // A write restores its bucket before it replaces or deletes the key
+    TEST_ASSERT_EQUAL(50, stats.restored);
+
+    catzilla_cache_destroy(warm);
+    unlink(path);
+}
+
+void test_cache_snapshot_respects_remaining_ttl() {
+    char path[128];
+    snapshot_path(path, sizeof(path));
+    TEST_ASSERT_EQUAL(0, catzilla_cache_set(test_cache, "short", "a", 2, 1));
+    TEST_ASSERT_EQUAL(0, catzilla_cache_set(test_cache, "long", "b", 2, 60));
+    TEST_ASSERT_EQUAL(0, catzilla_cache_save_snapshot(test_cache, path));
+    sleep(2);
+
+    catzilla_cache_t* warm = catzilla_cache_create(100, 25);
+    TEST_ASSERT_EQUAL(0, catzilla_cache_load_snapshot(warm, path));
+    TEST_ASSERT_FALSE(catzilla_cache_get(warm, "short").found);
+    TEST_ASSERT_TRUE(catzilla_cache_get(warm, "long").found);
+    catzilla_cache_destroy(warm);
+
+    // A damaged file is refused
+    FILE* file = fopen(path, "r+b");
+    TEST_ASSERT_NOT_NULL(file);
+    fputc('X', file);
+    fclose(file);
+    warm = catzilla_cache_create(100, 25);
+    TEST_ASSERT_EQUAL(-1, catzilla_cache_load_snapshot(warm, path));
+    catzilla_cache_destroy(warm);
+    unlink(path);
+}
+#endif
+
 int main(void) {
     UNITY_BEGIN();
 
@@ -278,11 +688,27 @@ int main(void) {
     RUN_TEST(test_cache_statistics);
     RUN_TEST(test_cache_clear);
     RUN_TEST(test_cache_binary_data);
+    RUN_TEST(test_cache_get_copy);
     RUN_TEST(test_cache_edge_cases);
+    RUN_TEST(test_cache_clock_keeps_referenced_entries);
+    RUN_TEST(test_cache_tinylfu_keeps_hot_keys_through_a_scan);
+    RUN_TEST(test_cache_tinylfu_resize);
+    RUN_TEST(test_cache_shards_split_capacity_and_stats);
+    RUN_TEST(test_cache_compresses_large_values);
+    RUN_TEST(test_cache_stores_incompressible_values_as_is);
+    RUN_TEST(test_cache_lookup_coalesces_misses);
+    RUN_TEST(test_cache_lookup_claims_lapse);
+#ifndef _WIN32
+    RUN_TEST(test_cache_snapshot_restores_lazily);
+#endif
 
     // Advanced tests
     RUN_TEST(test_cache_ttl_expiration);
+    RUN_TEST(test_cache_lookup_serves_stale_while_one_refreshes);
     RUN_TEST(test_cache_thread_safety);
+#ifndef _WIN32
+    RUN_TEST(test_cache_snapshot_respects_remaining_ttl);
+#endif
 
     return UNITY_END();
 }
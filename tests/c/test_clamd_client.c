@@ -0,0 +1,480 @@
+// tests/c/test_clamd_client.c
+#include "unity.h"
+#include "clamd_client.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// ---------------------------------------------------------------------------
+// A fake clamd: IDSESSION, INSTREAM and END on a Unix or TCP listener.
+// Streams containing "EICAR" are infected.
+// ---------------------------------------------------------------------------
+
+typedef enum { FAKE_COMMAND, FAKE_LENGTH, FAKE_DATA } fake_state_t;
+
+typedef struct {
+    union {
+        uv_pipe_t pipe;
+        uv_tcp_t tcp;
+    } handle;
+    fake_state_t state;
+    char command[64];
+    size_t command_len;
+    unsigned char length[4];
+    size_t length_len;
+    uint32_t remaining;
+    char* stream;
+    size_t stream_len;
+    int next_id;
+} fake_conn_t;
+
+static uv_loop_t loop;
+static union {
+    uv_pipe_t pipe;
+    uv_tcp_t tcp;
+} fake_listener;
+static bool fake_tcp;
+static char socket_path[64];
+static int fake_port;
+static int fake_accepted;
+static int fake_sessions;
+static int fake_streams;
+static bool fake_silent;         // Never answer a stream
+static size_t fake_stream_limit; // Answer "size limit exceeded" past this
+
+static void fake_closed(uv_handle_t* handle) {
+    fake_conn_t* conn = handle->data;
+    free(conn->stream);
+    free(conn);
+}
+
+static void fake_reply(fake_conn_t* conn, const char* text) {
+    char reply[256];
+    int length = snprintf(reply, sizeof(reply), "%d: %s", conn->next_id++, text);
+    uv_buf_t buf = uv_buf_init(reply, (unsigned int)length + 1);
+    uv_try_write((uv_stream_t*)&conn->handle, &buf, 1);
+}
+
+static void fake_end_stream(fake_conn_t* conn) {
+    fake_streams++;
+    bool infected = false;
+    for (size_t i = 0; i + 5 <= conn->stream_len; i++) {
+        if (memcmp(conn->stream + i, "EICAR", 5) == 0) infected = true;
+    }
+    conn->stream_len = 0;
+    if (!fake_silent) {
+        fake_reply(conn, infected ? "stream: Eicar-Test-Signature FOUND" : "stream: OK");
+    }
+}
+
+static void fake_alloc(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf) {
+    (void)handle;
+    buf->base = malloc(suggested_size);
+    buf->len = buf->base ? suggested_size : 0;
+}
+
+static void fake_read(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
+    fake_conn_t* conn = stream->data;
+    if (nread < 0) {
+        free(buf->base);
+        if (!uv_is_closing((uv_handle_t*)stream)) uv_close((uv_handle_t*)stream, fake_closed);
+        return;
+    }
+
+    for (ssize_t i = 0; i < nread; i++) {
+        char c = buf->base[i];
+        switch (conn->state) {
+        case FAKE_COMMAND:
+            if (c != '\0') {
+                TEST_ASSERT_TRUE(conn->command_len < sizeof(conn->command) - 1);
+                conn->command[conn->command_len++] = c;
+                break;
+            }
+            conn->command[conn->command_len] = '\0';
+            conn->command_len = 0;
+            if (strcmp(conn->command, "zIDSESSION") == 0) {
+                fake_sessions++;
+            } else if (strcmp(conn->command, "zINSTREAM") == 0) {
+                conn->state = FAKE_LENGTH;
+            } else if (strcmp(conn->command, "zEND") == 0) {
+                uv_close((uv_handle_t*)stream, fake_closed);
+                free(buf->base);
+                return;
+            } else {
+                TEST_FAIL_MESSAGE("unexpected clamd command");
+            }
+            break;
+        case FAKE_LENGTH:
+            conn->length[conn->length_len++] = (unsigned char)c;
+            if (conn->length_len < 4) break;
+            conn->length_len = 0;
+            conn->remaining = (uint32_t)conn->length[0] << 24 | (uint32_t)conn->length[1] << 16 |
+                              (uint32_t)conn->length[2] << 8 | conn->length[3];
+            if (conn->remaining == 0) {
+                conn->state = FAKE_COMMAND;
+                fake_end_stream(conn);
+            } else {
+                conn->state = FAKE_DATA;
+            }
+            break;
+        case FAKE_DATA:
+            conn->stream = realloc(conn->stream, conn->stream_len + 1);
+            conn->stream[conn->stream_len++] = c;
+            if (fake_stream_limit && conn->stream_len > fake_stream_limit) {
+                // clamd answers and drops the session
+                fake_reply(conn, "INSTREAM size limit exceeded. ERROR");
+                uv_close((uv_handle_t*)stream, fake_closed);
+                free(buf->base);
+                return;
+            }
+            if (--conn->remaining == 0) conn->state = FAKE_LENGTH;
+            break;
+        }
+    }
+    free(buf->base);
+}
+
+static void fake_connection(uv_stream_t* server, int status) {
+    TEST_ASSERT_EQUAL(0, status);
+    fake_conn_t* conn = calloc(1, sizeof(*conn));
+    conn->next_id = 1;
+    if (fake_tcp) {
+        uv_tcp_init(&loop, &conn->handle.tcp);
+    } else {
+        uv_pipe_init(&loop, &conn->handle.pipe, 0);
+    }
+    conn->handle.tcp.data = conn;
+    TEST_ASSERT_EQUAL(0, uv_accept(server, (uv_stream_t*)&conn->handle));
+    fake_accepted++;
+    uv_read_start((uv_stream_t*)&conn->handle, fake_alloc, fake_read);
+}
+
+static void start_fake_clamd(bool tcp) {
+    fake_tcp = tcp;
+    if (tcp) {
+        struct sockaddr_in addr;
+        uv_ip4_addr("127.0.0.1", 0, &addr);
+        uv_tcp_init(&loop, &fake_listener.tcp);
+        TEST_ASSERT_EQUAL(0, uv_tcp_bind(&fake_listener.tcp, (const struct sockaddr*)&addr, 0));
+        struct sockaddr_in bound;
+        int length = sizeof(bound);
+        uv_tcp_getsockname(&fake_listener.tcp, (struct sockaddr*)&bound, &length);
+        fake_port = ntohs(bound.sin_port);
+    } else {
+        uv_pipe_init(&loop, &fake_listener.pipe, 0);
+        TEST_ASSERT_EQUAL(0, uv_pipe_bind(&fake_listener.pipe, socket_path));
+    }
+    TEST_ASSERT_EQUAL(0, uv_listen((uv_stream_t*)&fake_listener, 16, fake_connection));
+}
+
+static void close_walk(uv_handle_t* handle, void* arg) {
+    (void)arg;
+    if (!uv_is_closing(handle)) {
+        uv_close(handle, handle->data && handle != (uv_handle_t*)&fake_listener ? fake_closed : NULL);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    int calls;
+    catzilla_clamd_result_t result;
+} verdict_t;
+
+static void on_verdict(void* data, const catzilla_clamd_result_t* result) {
+    verdict_t* verdict = data;
+    verdict->calls++;
+    verdict->result = *result;
+}
+
+static void run_until(const int* counter, int target, uint64_t limit_ms) {
+    uint64_t until = uv_now(&loop) + limit_ms;
+    while (*counter < target && uv_now(&loop) < until) {
+        uv_run(&loop, UV_RUN_ONCE);
+    }
+}
+
+static catzilla_clamd_t* create_client(int pool_size, uint32_t timeout_ms, size_t max_buffered) {
+    catzilla_clamd_config_t config = { pool_size, timeout_ms, max_buffered };
+    char address[96];
+    if (fake_tcp) {
+        snprintf(address, sizeof(address), "tcp://127.0.0.1:%d", fake_port);
+    } else {
+        snprintf(address, sizeof(address), "unix:%s", socket_path);
+    }
+    catzilla_clamd_t* client = catzilla_clamd_create(&loop, address, &config);
+    TEST_ASSERT_NOT_NULL(client);
+    return client;
+}
+
+static void scan_text(catzilla_clamd_t* client, const char* text, verdict_t* verdict) {
+    catzilla_clamd_scan_t* scan = catzilla_clamd_scan_start(client, on_verdict, verdict);
+    TEST_ASSERT_NOT_NULL(scan);
+    // Split so the stream arrives as several chunks
+    size_t half = strlen(text) / 2;
+    TEST_ASSERT_EQUAL(0, catzilla_clamd_scan_write(scan, text, half));
+    TEST_ASSERT_EQUAL(0, catzilla_clamd_scan_write(scan, text + half, strlen(text) - half));
+    TEST_ASSERT_EQUAL(0, catzilla_clamd_scan_finish(scan));
+}
+
+void setUp(void) {
+    uv_loop_init(&loop);
+    snprintf(socket_path, sizeof(socket_path), "/tmp/catzilla_test_clamd_%d.sock", (int)getpid());
+    unlink(socket_path);
+    fake_accepted = 0;
+    fake_sessions = 0;
+    fake_streams = 0;
+    fake_silent = false;
+    fake_stream_limit = 0;
+}
+
+void tearDown(void) {
+    uv_walk(&loop, close_walk, NULL);
+    uv_run(&loop, UV_RUN_DEFAULT);
+    uv_loop_close(&loop);
+    unlink(socket_path);
+}
+
+void test_parse_reply() {
+    catzilla_clamd_result_t result;
+    TEST_ASSERT_EQUAL(0, catzilla_clamd_parse_reply("stream: OK", 10, &result));
+    TEST_ASSERT_EQUAL(CATZILLA_CLAMD_CLEAN, result.verdict);
+
+    const char* found = "12: stream: Win.Test.EICAR_HDB-1 FOUND\n";
+    TEST_ASSERT_EQUAL(0, catzilla_clamd_parse_reply(found, strlen(found), &result));
+    TEST_ASSERT_EQUAL(CATZILLA_CLAMD_INFECTED, result.verdict);
+    TEST_ASSERT_EQUAL_STRING("Win.Test.EICAR_HDB-1", result.signature);
+
+    const char* limit = "3: INSTREAM size limit exceeded. ERROR";
+    TEST_ASSERT_EQUAL(0, catzilla_clamd_parse_reply(limit, strlen(limit), &result));
+    TEST_ASSERT_EQUAL(CATZILLA_CLAMD_ERROR, result.verdict);
+    TEST_ASSERT_EQUAL_STRING("INSTREAM size limit exceeded.", result.signature);
+
+    TEST_ASSERT_EQUAL(-1, catzilla_clamd_parse_reply("1: PONG", 7, &result));
+    TEST_ASSERT_EQUAL(CATZILLA_CLAMD_ERROR, result.verdict);
+}
+
+void test_address_validation() {
+    TEST_ASSERT_TRUE(catzilla_clamd_address_valid("/var/run/clamav/clamd.ctl"));
+    TEST_ASSERT_TRUE(catzilla_clamd_address_valid("unix:/run/clamd.sock"));
+    TEST_ASSERT_TRUE(catzilla_clamd_address_valid("tcp://scanner.internal:3310"));
+    TEST_ASSERT_TRUE(catzilla_clamd_address_valid("127.0.0.1"));
+    TEST_ASSERT_TRUE(catzilla_clamd_address_valid("[::1]:3310"));
+    TEST_ASSERT_FALSE(catzilla_clamd_address_valid(""));
+    TEST_ASSERT_FALSE(catzilla_clamd_address_valid("unix:"));
+    TEST_ASSERT_FALSE(catzilla_clamd_address_valid("host:0"));
+    TEST_ASSERT_FALSE(catzilla_clamd_address_valid("host:99999"));
+    TEST_ASSERT_FALSE(catzilla_clamd_address_valid("host:33x"));
+}
+
+void test_clean_and_infected_share_a_session() {
+    start_fake_clamd(false);
+    catzilla_clamd_t* client = create_client(1, 0, 0);
+
+    verdict_t clean = {0};
+    scan_text(client, "just some harmless text", &clean);
+    run_until(&clean.calls, 1, 2000);
+    TEST_ASSERT_EQUAL(1, clean.calls);
+    TEST_ASSERT_EQUAL(CATZILLA_CLAMD_CLEAN, clean.result.verdict);
+    TEST_ASSERT_EQUAL(23, clean.result.bytes);
+
+    verdict_t infected = {0};
+    scan_text(client, "X5O!P%@AP[4\\PZX54(P^)7CC)7}$EICAR-STANDARD-ANTIVIRUS-TEST-FILE!", &infected);
+    run_until(&infected.calls, 1, 2000);
+    TEST_ASSERT_EQUAL(CATZILLA_CLAMD_INFECTED, infected.result.verdict);
+    TEST_ASSERT_EQUAL_STRING("Eicar-Test-Signature", infected.result.signature);
+
+    // Both went over one IDSESSION connection
+    TEST_ASSERT_EQUAL(1, fake_accepted);
+    TEST_ASSERT_EQUAL(1, fake_sessions);
+
+    catzilla_clamd_stats_t stats;
+    catzilla_clamd_get_stats(client, &stats);
+    TEST_ASSERT_EQUAL(2, stats.scans);
+    TEST_ASSERT_EQUAL(1, stats.clean);
+    TEST_ASSERT_EQUAL(1, stats.infected);
+    TEST_ASSERT_EQUAL(1, stats.connected);
+    catzilla_clamd_close(client);
+}
+
+void test_tcp_socket() {
+    start_fake_clamd(true);
+    catzilla_clamd_t* client = create_client(2, 0, 0);
+    verdict_t verdict = {0};
+    scan_text(client, "hello over tcp, EICAR", &verdict);
+    run_until(&verdict.calls, 1, 2000);
+    TEST_ASSERT_EQUAL(CATZILLA_CLAMD_INFECTED, verdict.result.verdict);
+    catzilla_clamd_close(client);
+}
+
+void test_scans_wait_for_a_free_connection() {
+    start_fake_clamd(false);
+    catzilla_clamd_t* client = create_client(2, 0, 0);
+
+    // Data is framed while the scans wait and goes out once they get a connection
+    verdict_t verdicts[5];
+    memset(verdicts, 0, sizeof(verdicts));
+    catzilla_clamd_scan_t* scans[5];
+    for (int i = 0; i < 5; i++) {
+        scans[i] = catzilla_clamd_scan_start(client, on_verdict, &verdicts[i]);
+        TEST_ASSERT_NOT_NULL(scans[i]);
+    }
+    catzilla_clamd_stats_t stats;
+    catzilla_clamd_get_stats(client, &stats);
+    TEST_ASSERT_EQUAL(3, stats.waiting);
+
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT_EQUAL(0, catzilla_clamd_scan_write(scans[i], i == 3 ? "EICAR" : "fine", i == 3 ? 5 : 4));
+        TEST_ASSERT_EQUAL(0, catzilla_clamd_scan_finish(scans[i]));
+    }
+
+    int done = 0;
+    uint64_t until = uv_now(&loop) + 2000;
+    while (done < 5 && uv_now(&loop) < until) {
+        uv_run(&loop, UV_RUN_ONCE);
+        done = 0;
+        for (int i = 0; i < 5; i++) done += verdicts[i].calls;
+    }
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT_EQUAL(1, verdicts[i].calls);
+        TEST_ASSERT_EQUAL(i == 3 ? CATZILLA_CLAMD_INFECTED : CATZILLA_CLAMD_CLEAN, verdicts[i].result.verdict);
+    }
+    TEST_ASSERT_EQUAL(2, fake_accepted);
+    catzilla_clamd_get_stats(client, &stats);
+    TEST_ASSERT_EQUAL(0, stats.waiting);
+    catzilla_clamd_close(client);
+}
+
+void test_canceled_scan_verdict_is_discarded() {
+    start_fake_clamd(false);
+    catzilla_clamd_t* client = create_client(1, 0, 0);
+
+    verdict_t canceled = {0};
+    catzilla_clamd_scan_t* scan = catzilla_clamd_scan_start(client, on_verdict, &canceled);
+    TEST_ASSERT_EQUAL(0, catzilla_clamd_scan_write(scan, "EICAR", 5));
+    catzilla_clamd_scan_cancel(scan);
+
+    // The next scan waits for the answer to the canceled one and gets its own
+    verdict_t next = {0};
+    scan_text(client, "clean data", &next);
+    run_until(&next.calls, 1, 2000);
+    TEST_ASSERT_EQUAL(0, canceled.calls);
+    TEST_ASSERT_EQUAL(1, next.calls);
+    TEST_ASSERT_EQUAL(CATZILLA_CLAMD_CLEAN, next.result.verdict);
+    TEST_ASSERT_EQUAL(2, fake_streams);
+
+    // A waiting scan can be canceled too
+    verdict_t busy = {0};
+    verdict_t waiting = {0};
+    catzilla_clamd_scan_t* first = catzilla_clamd_scan_start(client, on_verdict, &busy);
+    catzilla_clamd_scan_t* second = catzilla_clamd_scan_start(client, on_verdict, &waiting);
+    catzilla_clamd_scan_cancel(second);
+    TEST_ASSERT_EQUAL(0, catzilla_clamd_scan_finish(first));
+    run_until(&busy.calls, 1, 2000);
+    TEST_ASSERT_EQUAL(1, busy.calls);
+    TEST_ASSERT_EQUAL(0, waiting.calls);
+    catzilla_clamd_close(client);
+}
+
+void test_unreachable_clamd_fails_then_refuses() {
+    catzilla_clamd_t* client = create_client(1, 0, 0);
+
+    verdict_t verdict = {0};
+    catzilla_clamd_scan_t* scan = catzilla_clamd_scan_start(client, on_verdict, &verdict);
+    TEST_ASSERT_NOT_NULL(scan);
+    TEST_ASSERT_EQUAL(0, catzilla_clamd_scan_write(scan, "data", 4));
+    run_until(&verdict.calls, 1, 2000);
+    TEST_ASSERT_EQUAL(1, verdict.calls);
+    TEST_ASSERT_EQUAL(CATZILLA_CLAMD_ERROR, verdict.result.verdict);
+    TEST_ASSERT_EQUAL_STRING("clamd unreachable", verdict.result.signature);
+
+    // Backing off: refused right away
+    TEST_ASSERT_NULL(catzilla_clamd_scan_start(client, on_verdict, &verdict));
+    catzilla_clamd_stats_t stats;
+    catzilla_clamd_get_stats(client, &stats);
+    TEST_ASSERT_EQUAL(1, stats.rejected);
+    TEST_ASSERT_EQUAL(1, stats.errors);
+    catzilla_clamd_close(client);
+}
+
+void test_late_verdict_times_out() {
+    start_fake_clamd(false);
+    fake_silent = true;
+    catzilla_clamd_t* client = create_client(1, 50, 0);
+
+    verdict_t verdict = {0};
+    scan_text(client, "slow", &verdict);
+    run_until(&verdict.calls, 1, 2000);
+    TEST_ASSERT_EQUAL(1, verdict.calls);
+    TEST_ASSERT_EQUAL(CATZILLA_CLAMD_ERROR, verdict.result.verdict);
+    TEST_ASSERT_EQUAL_STRING("clamd timed out", verdict.result.signature);
+
+    catzilla_clamd_stats_t stats;
+    catzilla_clamd_get_stats(client, &stats);
+    TEST_ASSERT_EQUAL(1, stats.timeouts);
+    catzilla_clamd_close(client);
+}
+
+void test_refused_stream_and_full_backlog() {
+    start_fake_clamd(false);
+    fake_stream_limit = 8;
+    catzilla_clamd_t* client = create_client(1, 0, 64);
+
+    verdict_t refused = {0};
+    scan_text(client, "more than eight bytes", &refused);
+    run_until(&refused.calls, 1, 2000);
+    TEST_ASSERT_EQUAL(CATZILLA_CLAMD_ERROR, refused.result.verdict);
+    TEST_ASSERT_EQUAL_STRING("INSTREAM size limit exceeded.", refused.result.signature);
+
+    // The dropped session is replaced for the next scan
+    fake_stream_limit = 0;
+    verdict_t after = {0};
+    scan_text(client, "short", &after);
+    run_until(&after.calls, 1, 2000);
+    TEST_ASSERT_EQUAL(CATZILLA_CLAMD_CLEAN, after.result.verdict);
+    TEST_ASSERT_EQUAL(2, fake_accepted);
+
+    // More than max_buffered waiting to be written drops the scan
+    verdict_t dropped = {0};
+    catzilla_clamd_scan_t* scan = catzilla_clamd_scan_start(client, on_verdict, &dropped);
+    char big[128];
+    memset(big, 'a', sizeof(big));
+    TEST_ASSERT_EQUAL(-1, catzilla_clamd_scan_write(scan, big, sizeof(big)));
+    run_until(&dropped.calls, 1, 50);
+    TEST_ASSERT_EQUAL(0, dropped.calls);
+    catzilla_clamd_close(client);
+}
+
+void test_close_fails_outstanding_scans() {
+    start_fake_clamd(false);
+    fake_silent = true;
+    catzilla_clamd_t* client = create_client(1, 0, 0);
+
+    verdict_t streaming = {0};
+    verdict_t waiting = {0};
+    scan_text(client, "abc", &streaming);
+    scan_text(client, "def", &waiting);
+    uv_run(&loop, UV_RUN_NOWAIT);
+    catzilla_clamd_close(client);
+    TEST_ASSERT_EQUAL(1, streaming.calls);
+    TEST_ASSERT_EQUAL(1, waiting.calls);
+    TEST_ASSERT_EQUAL(CATZILLA_CLAMD_ERROR, waiting.result.verdict);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_parse_reply);
+    RUN_TEST(test_address_validation);
+    RUN_TEST(test_clean_and_infected_share_a_session);
+    RUN_TEST(test_tcp_socket);
+    RUN_TEST(test_scans_wait_for_a_free_connection);
+    RUN_TEST(test_canceled_scan_verdict_is_discarded);
+    RUN_TEST(test_unreachable_clamd_fails_then_refuses);
+    RUN_TEST(test_late_verdict_times_out);
+    RUN_TEST(test_refused_stream_and_full_backlog);
+    RUN_TEST(test_close_fails_outstanding_scans);
+
+    return UNITY_END();
+}
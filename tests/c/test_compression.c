@@ -0,0 +1,467 @@
+// tests/c/test_compression.c
+#include "unity.h"
+#include "compression.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef CATZILLA_HAS_ZLIB
+#include <zlib.h>
+#endif
+#ifdef CATZILLA_HAS_BROTLI
+#include <brotli/decode.h>
+#endif
+#ifdef CATZILLA_HAS_ZSTD
+#include <zstd.h>
+#endif
+
+static catzilla_compression_config_t config;
+
+// Repetitive JSON, the kind of body compression is for
+static char* make_json_body(size_t* size) {
+    size_t capacity = 64 * 1024;
+    char* body = malloc(capacity);
+    size_t length = 0;
+    length += (size_t)snprintf(body + length, capacity - length, "[");
+    for (int i = 0; length < capacity - 128; i++) {
+        length += (size_t)snprintf(body + length, capacity - length,
+                                   "%s{\"id\":%d,\"name\":\"item-%d\",\"active\":true}", i ? "," : "", i, i);
+    }
+    length += (size_t)snprintf(body + length, capacity - length, "]");
+    *size = length;
+    return body;
+}
+
+static void fill_random(unsigned char* data, size_t size) {
+    uint32_t x = 2463534242u;
+    for (size_t i = 0; i < size; i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        data[i] = (unsigned char)x;
+    }
+}
+
+void setUp(void) {
+    catzilla_compression_config_init(&config);
+}
+
+void tearDown(void) {
+    catzilla_compression_trim();
+}
+
+// ---------------------------------------------------------------------------
+// Negotiation
+// ---------------------------------------------------------------------------
+
+void test_negotiate_requires_accept_encoding_and_size() {
+    TEST_ASSERT_EQUAL(CATZILLA_ENCODING_IDENTITY, catzilla_compression_negotiate(&config, NULL, 4096));
+    TEST_ASSERT_EQUAL(CATZILLA_ENCODING_IDENTITY, catzilla_compression_negotiate(&config, "", 4096));
+    TEST_ASSERT_EQUAL(CATZILLA_ENCODING_IDENTITY, catzilla_compression_negotiate(&config, "identity", 4096));
+    TEST_ASSERT_EQUAL(CATZILLA_ENCODING_IDENTITY,
+                      catzilla_compression_negotiate(&config, "gzip", config.min_size - 1));
+
+    config.enabled = false;
+    TEST_ASSERT_EQUAL(CATZILLA_ENCODING_IDENTITY, catzilla_compression_negotiate(&config, "gzip", 4096));
+}
+
+void test_negotiate_honours_quality_values() {
+    int available = catzilla_compression_available();
+    if ((available & CATZILLA_ENCODING_GZIP) && (available & CATZILLA_ENCODING_BR)) {
+        TEST_ASSERT_EQUAL(CATZILLA_ENCODING_GZIP,
+                          catzilla_compression_negotiate(&config, "br;q=0.5, gzip;q=0.8", 4096));
+        TEST_ASSERT_EQUAL(CATZILLA_ENCODING_BR,
+                          catzilla_compression_negotiate(&config, "gzip;q=0.999, br", 4096));
+        // q=0 rules a coding out, even when it is the only one listed
+        TEST_ASSERT_EQUAL(CATZILLA_ENCODING_GZIP,
+                          catzilla_compression_negotiate(&config, "br;q=0, gzip", 4096));
+    }
+    if (available & CATZILLA_ENCODING_GZIP) {
+        TEST_ASSERT_EQUAL(CATZILLA_ENCODING_IDENTITY, catzilla_compression_negotiate(&config, "gzip;q=0", 4096));
+        TEST_ASSERT_EQUAL(CATZILLA_ENCODING_GZIP, catzilla_compression_negotiate(&config, "X-GZIP", 4096));
+        TEST_ASSERT_EQUAL(CATZILLA_ENCODING_GZIP,
+                          catzilla_compression_negotiate(&config, "deflate, gzip ; q=0.2", 4096));
+    }
+}
+
+void test_negotiate_prefers_by_body_size() {
+    int available = catzilla_compression_available();
+    const char* all = "gzip, deflate, br, zstd";
+
+    int small = catzilla_compression_negotiate(&config, all, 4096);
+    int large = catzilla_compression_negotiate(&config, all, config.br_max_size + 1);
+    int stream = catzilla_compression_negotiate(&config, all, SIZE_MAX);
+
+    if (available & CATZILLA_ENCODING_BR) {
+        TEST_ASSERT_EQUAL(CATZILLA_ENCODING_BR, small);
+    }
+    if (available & CATZILLA_ENCODING_ZSTD) {
+        TEST_ASSERT_EQUAL(CATZILLA_ENCODING_ZSTD, large);
+        TEST_ASSERT_EQUAL(CATZILLA_ENCODING_ZSTD, stream);
+    } else if (available & CATZILLA_ENCODING_GZIP) {
+        TEST_ASSERT_EQUAL(CATZILLA_ENCODING_GZIP, large);
+    }
+    if (available == 0) {
+        TEST_ASSERT_EQUAL(CATZILLA_ENCODING_IDENTITY, small);
+    }
+}
+
+void test_negotiate_wildcard() {
+    int available = catzilla_compression_available();
+    if (available == 0) {
+        TEST_IGNORE_MESSAGE("No content codings in this build");
+    }
+
+    TEST_ASSERT_NOT_EQUAL(CATZILLA_ENCODING_IDENTITY, catzilla_compression_negotiate(&config, "*", 4096));
+    TEST_ASSERT_EQUAL(CATZILLA_ENCODING_IDENTITY, catzilla_compression_negotiate(&config, "*;q=0", 4096));
+    if (available & CATZILLA_ENCODING_GZIP) {
+        // Listed codings override the wildcard
+        TEST_ASSERT_EQUAL(CATZILLA_ENCODING_GZIP,
+                          catzilla_compression_negotiate(&config, "*;q=0, gzip", 4096));
+    }
+}
+
+void test_select_from_candidates() {
+    catzilla_accept_encoding_t accept;
+    const int all = CATZILLA_ENCODING_GZIP | CATZILLA_ENCODING_BR | CATZILLA_ENCODING_ZSTD;
+
+    // Candidates need not be compiled in: precompressed files are only sent
+    catzilla_compression_parse_accept_encoding("gzip, br, zstd", &accept);
+    TEST_ASSERT_EQUAL(CATZILLA_ENCODING_BR, catzilla_compression_select(&accept, all, 4096, 1024 * 1024));
+    TEST_ASSERT_EQUAL(CATZILLA_ENCODING_ZSTD, catzilla_compression_select(&accept, all, 4096, 1024));
+    TEST_ASSERT_EQUAL(CATZILLA_ENCODING_BR, catzilla_compression_select(&accept, all, SIZE_MAX, SIZE_MAX));
+    TEST_ASSERT_EQUAL(CATZILLA_ENCODING_GZIP,
+                      catzilla_compression_select(&accept, CATZILLA_ENCODING_GZIP, 4096, SIZE_MAX));
+
+    catzilla_compression_parse_accept_encoding("br;q=0.2, gzip;q=0.9", &accept);
+    TEST_ASSERT_EQUAL(CATZILLA_ENCODING_GZIP, catzilla_compression_select(&accept, all, 4096, SIZE_MAX));
+    TEST_ASSERT_EQUAL(CATZILLA_ENCODING_BR,
+                      catzilla_compression_select(&accept, CATZILLA_ENCODING_BR, 4096, SIZE_MAX));
+    TEST_ASSERT_EQUAL(CATZILLA_ENCODING_IDENTITY,
+                      catzilla_compression_select(&accept, CATZILLA_ENCODING_ZSTD, 4096, SIZE_MAX));
+    TEST_ASSERT_EQUAL(CATZILLA_ENCODING_IDENTITY, catzilla_compression_select(&accept, 0, 4096, SIZE_MAX));
+}
+
+void test_type_compressible() {
+    TEST_ASSERT_TRUE(catzilla_compression_type_compressible("text/html; charset=utf-8", 24));
+    TEST_ASSERT_TRUE(catzilla_compression_type_compressible("application/json", 16));
+    TEST_ASSERT_TRUE(catzilla_compression_type_compressible("application/vnd.api+json", 24));
+    TEST_ASSERT_TRUE(catzilla_compression_type_compressible("image/svg+xml", 13));
+    TEST_ASSERT_FALSE(catzilla_compression_type_compressible("image/png", 9));
+    TEST_ASSERT_FALSE(catzilla_compression_type_compressible("application/zip", 15));
+    TEST_ASSERT_FALSE(catzilla_compression_type_compressible("application/octet-stream", 24));
+    TEST_ASSERT_FALSE(catzilla_compression_type_compressible(NULL, 0));
+}
+
+// ---------------------------------------------------------------------------
+// Whole bodies
+// ---------------------------------------------------------------------------
+
+void test_gzip_round_trip() {
+#ifdef CATZILLA_HAS_ZLIB
+    size_t size;
+    char* body = make_json_body(&size);
+    catzilla_compress_buffer_t* out = NULL;
+    TEST_ASSERT_EQUAL(0, catzilla_compress(CATZILLA_ENCODING_GZIP, config.gzip_level, body, size, &out));
+    TEST_ASSERT_NOT_NULL(out);
+    TEST_ASSERT_TRUE(out->length < size / 4);
+    TEST_ASSERT_EQUAL(0x1f, (unsigned char)out->data[0]);
+    TEST_ASSERT_EQUAL(0x8b, (unsigned char)out->data[1]);
+
+    char* decoded = malloc(size);
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    TEST_ASSERT_EQUAL(Z_OK, inflateInit2(&stream, 15 + 16));
+    stream.next_in = (Bytef*)out->data;
+    stream.avail_in = (uInt)out->length;
+    stream.next_out = (Bytef*)decoded;
+    stream.avail_out = (uInt)size;
+    TEST_ASSERT_EQUAL(Z_STREAM_END, inflate(&stream, Z_FINISH));
+    TEST_ASSERT_EQUAL(size, stream.total_out);
+    TEST_ASSERT_EQUAL_MEMORY(body, decoded, size);
+    inflateEnd(&stream);
+
+    free(decoded);
+    catzilla_compress_buffer_release(out);
+    free(body);
+#else
+    TEST_IGNORE_MESSAGE("Built without zlib");
+#endif
+}
+
+void test_brotli_round_trip() {
+#ifdef CATZILLA_HAS_BROTLI
+    size_t size;
+    char* body = make_json_body(&size);
+    catzilla_compress_buffer_t* out = NULL;
+    TEST_ASSERT_EQUAL(0, catzilla_compress(CATZILLA_ENCODING_BR, config.br_quality, body, size, &out));
+    TEST_ASSERT_NOT_NULL(out);
+    TEST_ASSERT_TRUE(out->length < size / 4);
+
+    char* decoded = malloc(size);
+    size_t decoded_size = size;
+    TEST_ASSERT_EQUAL(BROTLI_DECODER_RESULT_SUCCESS,
+                      BrotliDecoderDecompress(out->length, (const uint8_t*)out->data,
+                                              &decoded_size, (uint8_t*)decoded));
+    TEST_ASSERT_EQUAL(size, decoded_size);
+    TEST_ASSERT_EQUAL_MEMORY(body, decoded, size);
+
+    free(decoded);
+    catzilla_compress_buffer_release(out);
+    free(body);
+#else
+    TEST_IGNORE_MESSAGE("Built without Brotli");
+#endif
+}
+
+void test_zstd_round_trip() {
+#ifdef CATZILLA_HAS_ZSTD
+    size_t size;
+    char* body = make_json_body(&size);
+    catzilla_compress_buffer_t* out = NULL;
+    TEST_ASSERT_EQUAL(0, catzilla_compress(CATZILLA_ENCODING_ZSTD, config.zstd_level, body, size, &out));
+    TEST_ASSERT_NOT_NULL(out);
+    TEST_ASSERT_TRUE(out->length < size / 4);
+
+    char* decoded = malloc(size);
+    size_t decoded_size = ZSTD_decompress(decoded, size, out->data, out->length);
+    TEST_ASSERT_FALSE(ZSTD_isError(decoded_size));
+    TEST_ASSERT_EQUAL(size, decoded_size);
+    TEST_ASSERT_EQUAL_MEMORY(body, decoded, size);
+
+    free(decoded);
+    catzilla_compress_buffer_release(out);
+    free(body);
+#else
+    TEST_IGNORE_MESSAGE("Built without zstd");
+#endif
+}
+
+void test_incompressible_body_is_skipped() {
+    const int codings[] = { CATZILLA_ENCODING_GZIP, CATZILLA_ENCODING_BR, CATZILLA_ENCODING_ZSTD };
+    int available = catzilla_compression_available();
+    unsigned char noise[8192];
+    fill_random(noise, sizeof(noise));
+
+    for (int i = 0; i < 3; i++) {
+        int encoding = codings[i];
+        catzilla_compress_buffer_t* out = (catzilla_compress_buffer_t*)1;
+        if (!(available & encoding)) {
+            TEST_ASSERT_EQUAL(-1, catzilla_compress(encoding, 1, noise, sizeof(noise), &out));
+            continue;
+        }
+
+        catzilla_compression_stats_t before, after;
+        catzilla_compression_get_stats(&before);
+        TEST_ASSERT_EQUAL(1, catzilla_compress(encoding, catzilla_compression_level(&config, encoding),
+                                               noise, sizeof(noise), &out));
+        TEST_ASSERT_NULL(out);
+        catzilla_compression_get_stats(&after);
+
+        const catzilla_compress_encoding_stats_t* b = encoding == CATZILLA_ENCODING_GZIP ? &before.gzip :
+                                                      encoding == CATZILLA_ENCODING_BR ? &before.br : &before.zstd;
+        const catzilla_compress_encoding_stats_t* a = encoding == CATZILLA_ENCODING_GZIP ? &after.gzip :
+                                                      encoding == CATZILLA_ENCODING_BR ? &after.br : &after.zstd;
+        TEST_ASSERT_EQUAL(b->skipped + 1, a->skipped);
+        TEST_ASSERT_EQUAL(b->responses, a->responses);
+    }
+}
+
+void test_compress_rejects_bad_arguments() {
+    catzilla_compress_buffer_t* out = NULL;
+    TEST_ASSERT_EQUAL(-1, catzilla_compress(CATZILLA_ENCODING_GZIP, 6, NULL, 100, &out));
+    TEST_ASSERT_EQUAL(-1, catzilla_compress(CATZILLA_ENCODING_GZIP, 6, "x", 1, &out));
+    TEST_ASSERT_EQUAL(-1, catzilla_compress(CATZILLA_ENCODING_IDENTITY, 0, "hello world", 11, &out));
+    TEST_ASSERT_NULL(catzilla_compressor_create(CATZILLA_ENCODING_IDENTITY, 0));
+}
+
+// ---------------------------------------------------------------------------
+// Streams
+// ---------------------------------------------------------------------------
+
+void test_gzip_stream_chunks_decode_as_they_arrive() {
+#ifdef CATZILLA_HAS_ZLIB
+    catzilla_compressor_t* compressor = catzilla_compressor_create(CATZILLA_ENCODING_GZIP, config.gzip_level);
+    TEST_ASSERT_NOT_NULL(compressor);
+
+    z_stream inflater;
+    memset(&inflater, 0, sizeof(inflater));
+    TEST_ASSERT_EQUAL(Z_OK, inflateInit2(&inflater, 15 + 16));
+    char decoded[256];
+
+    for (int i = 0; i < 5; i++) {
+        char event[64];
+        int len = snprintf(event, sizeof(event), "data: {\"tick\":%d}\n\n", i);
+
+        catzilla_compress_buffer_t* out = NULL;
+        TEST_ASSERT_EQUAL(0, catzilla_compressor_write(compressor, event, (size_t)len, false, &out));
+        TEST_ASSERT_NOT_NULL(out);
+
+        // Everything written so far comes out before the stream ends
+        inflater.next_in = (Bytef*)out->data;
+        inflater.avail_in = (uInt)out->length;
+        inflater.next_out = (Bytef*)decoded;
+        inflater.avail_out = sizeof(decoded);
+        int rc = inflate(&inflater, Z_SYNC_FLUSH);
+        TEST_ASSERT_TRUE(rc == Z_OK || rc == Z_BUF_ERROR);
+        TEST_ASSERT_EQUAL(len, sizeof(decoded) - inflater.avail_out);
+        TEST_ASSERT_EQUAL_MEMORY(event, decoded, len);
+        catzilla_compress_buffer_release(out);
+    }
+
+    catzilla_compress_buffer_t* trailer = NULL;
+    TEST_ASSERT_EQUAL(0, catzilla_compressor_write(compressor, NULL, 0, true, &trailer));
+    TEST_ASSERT_NOT_NULL(trailer);
+    inflater.next_in = (Bytef*)trailer->data;
+    inflater.avail_in = (uInt)trailer->length;
+    inflater.next_out = (Bytef*)decoded;
+    inflater.avail_out = sizeof(decoded);
+    TEST_ASSERT_EQUAL(Z_STREAM_END, inflate(&inflater, Z_FINISH));
+    inflateEnd(&inflater);
+    catzilla_compress_buffer_release(trailer);
+
+    // Nothing may follow the end of the stream
+    catzilla_compress_buffer_t* out = NULL;
+    TEST_ASSERT_EQUAL(-1, catzilla_compressor_write(compressor, "late", 4, false, &out));
+    catzilla_compressor_destroy(compressor);
+#else
+    TEST_IGNORE_MESSAGE("Built without zlib");
+#endif
+}
+
+void test_zstd_stream_round_trip() {
+#ifdef CATZILLA_HAS_ZSTD
+    catzilla_compressor_t* compressor = catzilla_compressor_create(CATZILLA_ENCODING_ZSTD, config.zstd_level);
+    TEST_ASSERT_NOT_NULL(compressor);
+
+    size_t size;
+    char* body = make_json_body(&size);
+    char* encoded = malloc(size);
+    size_t encoded_len = 0;
+    for (size_t offset = 0; offset < size; offset += 4096) {
+        size_t chunk = size - offset < 4096 ? size - offset : 4096;
+        catzilla_compress_buffer_t* out = NULL;
+        TEST_ASSERT_EQUAL(0, catzilla_compressor_write(compressor, body + offset, chunk, false, &out));
+        TEST_ASSERT_NOT_NULL(out);
+        memcpy(encoded + encoded_len, out->data, out->length);
+        encoded_len += out->length;
+        catzilla_compress_buffer_release(out);
+    }
+    catzilla_compress_buffer_t* out = NULL;
+    TEST_ASSERT_EQUAL(0, catzilla_compressor_write(compressor, NULL, 0, true, &out));
+    TEST_ASSERT_NOT_NULL(out);
+    memcpy(encoded + encoded_len, out->data, out->length);
+    encoded_len += out->length;
+    catzilla_compress_buffer_release(out);
+    catzilla_compressor_destroy(compressor);
+
+    char* decoded = malloc(size);
+    ZSTD_DStream* dstream = ZSTD_createDStream();
+    ZSTD_inBuffer input = { encoded, encoded_len, 0 };
+    ZSTD_outBuffer output = { decoded, size, 0 };
+    size_t rc = ZSTD_decompressStream(dstream, &output, &input);
+    TEST_ASSERT_FALSE(ZSTD_isError(rc));
+    TEST_ASSERT_EQUAL(0, rc);
+    TEST_ASSERT_EQUAL(size, output.pos);
+    TEST_ASSERT_EQUAL_MEMORY(body, decoded, size);
+    ZSTD_freeDStream(dstream);
+
+    free(decoded);
+    free(encoded);
+    free(body);
+#else
+    TEST_IGNORE_MESSAGE("Built without zstd");
+#endif
+}
+
+// ---------------------------------------------------------------------------
+// Buffer pool
+// ---------------------------------------------------------------------------
+
+void test_buffers_are_reused() {
+    catzilla_compression_stats_t before, after;
+    catzilla_compression_get_stats(&before);
+
+    catzilla_compress_buffer_t* first = catzilla_compress_buffer_acquire(1000);
+    TEST_ASSERT_NOT_NULL(first);
+    TEST_ASSERT_EQUAL(CATZILLA_COMPRESS_BUFFER_MIN, first->capacity);
+    TEST_ASSERT_EQUAL(0, first->size_class);
+    first->length = 10;
+    catzilla_compress_buffer_release(first);
+
+    catzilla_compress_buffer_t* second = catzilla_compress_buffer_acquire(CATZILLA_COMPRESS_BUFFER_MIN);
+    TEST_ASSERT_EQUAL_PTR(first, second);
+    TEST_ASSERT_EQUAL(0, second->length);
+    catzilla_compress_buffer_release(second);
+
+    // Above the largest class: sized exactly and never pooled
+    size_t huge = ((size_t)CATZILLA_COMPRESS_BUFFER_MIN << (2 * CATZILLA_COMPRESS_BUFFER_CLASSES)) + 1;
+    catzilla_compress_buffer_t* oversized = catzilla_compress_buffer_acquire(huge);
+    TEST_ASSERT_NOT_NULL(oversized);
+    TEST_ASSERT_EQUAL(-1, oversized->size_class);
+    TEST_ASSERT_EQUAL(huge, oversized->capacity);
+    catzilla_compress_buffer_release(oversized);
+
+    catzilla_compression_get_stats(&after);
+    TEST_ASSERT_EQUAL(before.buffer_hits + 1, after.buffer_hits);
+    TEST_ASSERT_EQUAL(before.buffer_misses + 2, after.buffer_misses);
+}
+
+void test_stats_count_bytes_per_coding() {
+    int available = catzilla_compression_available();
+    if (!(available & CATZILLA_ENCODING_GZIP)) {
+        TEST_IGNORE_MESSAGE("Built without zlib");
+    }
+
+    size_t size;
+    char* body = make_json_body(&size);
+    catzilla_compression_stats_t before, after;
+    catzilla_compression_get_stats(&before);
+
+    catzilla_compress_buffer_t* out = NULL;
+    TEST_ASSERT_EQUAL(0, catzilla_compress(CATZILLA_ENCODING_GZIP, 1, body, size, &out));
+    size_t compressed = out->length;
+    catzilla_compress_buffer_release(out);
+
+    // The encoder kept from the first call is reset for the second, so it
+    // produces what a fresh one would
+    TEST_ASSERT_EQUAL(0, catzilla_compress(CATZILLA_ENCODING_GZIP, 9, body, size, &out));
+    size_t reused = out->length;
+    compressed += out->length;
+    catzilla_compress_buffer_release(out);
+
+    catzilla_compression_get_stats(&after);
+    TEST_ASSERT_EQUAL(before.gzip.responses + 2, after.gzip.responses);
+    TEST_ASSERT_EQUAL(before.gzip.bytes_in + 2 * size, after.gzip.bytes_in);
+    TEST_ASSERT_EQUAL(before.gzip.bytes_out + compressed, after.gzip.bytes_out);
+    TEST_ASSERT_EQUAL(before.br.responses, after.br.responses);
+
+    catzilla_compression_trim();
+    TEST_ASSERT_EQUAL(0, catzilla_compress(CATZILLA_ENCODING_GZIP, 9, body, size, &out));
+    TEST_ASSERT_EQUAL(reused, out->length);
+    catzilla_compress_buffer_release(out);
+    free(body);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_negotiate_requires_accept_encoding_and_size);
+    RUN_TEST(test_negotiate_honours_quality_values);
+    RUN_TEST(test_negotiate_prefers_by_body_size);
+    RUN_TEST(test_negotiate_wildcard);
+    RUN_TEST(test_select_from_candidates);
+    RUN_TEST(test_type_compressible);
+    RUN_TEST(test_gzip_round_trip);
+    RUN_TEST(test_brotli_round_trip);
+    RUN_TEST(test_zstd_round_trip);
+    RUN_TEST(test_incompressible_body_is_skipped);
+    RUN_TEST(test_compress_rejects_bad_arguments);
+    RUN_TEST(test_gzip_stream_chunks_decode_as_they_arrive);
+    RUN_TEST(test_zstd_stream_round_trip);
+    RUN_TEST(test_buffers_are_reused);
+    RUN_TEST(test_stats_count_bytes_per_coding);
+
+    return UNITY_END();
+}
@@ -0,0 +1,267 @@
+// tests/c/test_dependency_plan.c
+#include "unity.h"
+#include "dependency.h"
+#include "request_arena.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Every instance records which service made it and what it was given
+typedef struct {
+    const char* name;
+    int serial;
+    void* dependencies[CATZILLA_DI_MAX_DEPENDENCIES];
+    int dependency_count;
+} instance_t;
+
+#define MAX_INSTANCES 256
+static instance_t instances[MAX_INSTANCES];
+static int instance_count;
+static int fail_service;   // Serial after which the "flaky" factory fails
+
+static void* make_instance(void** dependencies, int dependency_count, void* user_data) {
+    if (instance_count >= MAX_INSTANCES) return NULL;
+    instance_t* instance = &instances[instance_count];
+    instance->name = user_data;
+    instance->serial = instance_count++;
+    instance->dependency_count = dependency_count;
+    for (int i = 0; i < dependency_count; i++) {
+        instance->dependencies[i] = dependencies[i];
+    }
+    return instance;
+}
+
+static void* make_flaky(void** dependencies, int dependency_count, void* user_data) {
+    if (fail_service) return NULL;
+    return make_instance(dependencies, dependency_count, user_data);
+}
+
+static catzilla_di_container_t container;
+static catzilla_request_arena_t arena;
+
+static void add(const char* name, catzilla_di_scope_type_t scope, const char** dependencies, int count) {
+    TEST_ASSERT_EQUAL(0, catzilla_di_register_service_c(&container, name, NULL, scope, make_instance,
+                                                        dependencies, count, (void*)name));
+}
+
+void setUp(void) {
+    instance_count = 0;
+    fail_service = 0;
+    memset(&arena, 0, sizeof(arena));
+    TEST_ASSERT_EQUAL(0, catzilla_di_container_init(&container, NULL));
+}
+
+void tearDown(void) {
+    catzilla_arena_reset(&arena);
+    catzilla_di_container_cleanup(&container);
+}
+
+// config (singleton) <- db (request) <- repo (request) -> logger (transient)
+static void register_app_services(void) {
+    const char* db_deps[] = { "config" };
+    const char* repo_deps[] = { "db", "logger" };
+    add("config", CATZILLA_DI_SCOPE_SINGLETON, NULL, 0);
+    add("logger", CATZILLA_DI_SCOPE_TRANSIENT, NULL, 0);
+    add("db", CATZILLA_DI_SCOPE_REQUEST, db_deps, 1);
+    add("repo", CATZILLA_DI_SCOPE_REQUEST, repo_deps, 2);
+}
+
+void test_plan_orders_dependencies_first() {
+    register_app_services();
+    const char* names[] = { "repo", "db" };
+    catzilla_di_plan_t* plan = catzilla_di_plan_compile(&container, names, 2);
+    TEST_ASSERT_NOT_NULL(plan);
+
+    // The singleton was created at compile time and only that
+    TEST_ASSERT_EQUAL(1, instance_count);
+    TEST_ASSERT_EQUAL(4, plan->slot_count);
+    TEST_ASSERT_EQUAL(3, plan->step_count);
+    TEST_ASSERT_EQUAL(2, plan->root_count);
+
+    // Every step's dependencies are singletons or earlier steps
+    bool ready[8] = { false };
+    for (int i = 0; i < plan->slot_count; i++) {
+        ready[i] = plan->singletons[i] != NULL;
+    }
+    for (int i = 0; i < plan->step_count; i++) {
+        for (int j = 0; j < plan->steps[i].dependency_count; j++) {
+            TEST_ASSERT_TRUE(ready[plan->steps[i].dependency_slots[j]]);
+        }
+        ready[plan->steps[i].slot] = true;
+    }
+    catzilla_di_plan_destroy(plan);
+}
+
+void test_plan_execution_wires_instances() {
+    register_app_services();
+    const char* names[] = { "repo", "db" };
+    catzilla_di_plan_t* plan = catzilla_di_plan_compile(&container, names, 2);
+    TEST_ASSERT_NOT_NULL(plan);
+    instance_t* config = &instances[0];
+
+    void* results[2];
+    TEST_ASSERT_EQUAL(0, catzilla_di_plan_execute(plan, &arena, results));
+    instance_t* repo = results[0];
+    instance_t* db = results[1];
+    TEST_ASSERT_EQUAL_STRING("repo", repo->name);
+    TEST_ASSERT_EQUAL_STRING("db", db->name);
+
+    // repo got the same db the route did, and db got the singleton
+    TEST_ASSERT_EQUAL(2, repo->dependency_count);
+    TEST_ASSERT_EQUAL_PTR(db, repo->dependencies[0]);
+    TEST_ASSERT_EQUAL_STRING("logger", ((instance_t*)repo->dependencies[1])->name);
+    TEST_ASSERT_EQUAL_PTR(config, db->dependencies[0]);
+
+    // A second request gets new request-scoped instances and the same singleton
+    void* again[2];
+    TEST_ASSERT_EQUAL(0, catzilla_di_plan_execute(plan, &arena, again));
+    TEST_ASSERT_TRUE(again[0] != results[0]);
+    TEST_ASSERT_TRUE(again[1] != results[1]);
+    TEST_ASSERT_EQUAL_PTR(config, ((instance_t*)again[1])->dependencies[0]);
+    TEST_ASSERT_EQUAL(7, instance_count);
+
+    catzilla_di_plan_destroy(plan);
+}
+
+void test_plan_shares_diamond_dependencies() {
+    const char* left_deps[] = { "base" };
+    const char* right_deps[] = { "base" };
+    const char* top_deps[] = { "left", "right" };
+    add("base", CATZILLA_DI_SCOPE_SCOPED, NULL, 0);
+    add("left", CATZILLA_DI_SCOPE_SCOPED, left_deps, 1);
+    add("right", CATZILLA_DI_SCOPE_SCOPED, right_deps, 1);
+    add("top", CATZILLA_DI_SCOPE_SCOPED, top_deps, 2);
+
+    const char* names[] = { "top" };
+    catzilla_di_plan_t* plan = catzilla_di_plan_compile(&container, names, 1);
+    TEST_ASSERT_NOT_NULL(plan);
+    TEST_ASSERT_EQUAL(4, plan->step_count);
+
+    void* top;
+    TEST_ASSERT_EQUAL(0, catzilla_di_plan_execute(plan, &arena, &top));
+    instance_t* left = ((instance_t*)top)->dependencies[0];
+    instance_t* right = ((instance_t*)top)->dependencies[1];
+    TEST_ASSERT_EQUAL_PTR(left->dependencies[0], right->dependencies[0]);
+    TEST_ASSERT_EQUAL(4, instance_count);
+    catzilla_di_plan_destroy(plan);
+}
+
+void test_plan_rejects_missing_and_circular_services() {
+    const char* a_deps[] = { "b" };
+    const char* b_deps[] = { "a" };
+    const char* c_deps[] = { "missing" };
+    add("a", CATZILLA_DI_SCOPE_REQUEST, a_deps, 1);
+    add("b", CATZILLA_DI_SCOPE_REQUEST, b_deps, 1);
+    add("c", CATZILLA_DI_SCOPE_REQUEST, c_deps, 1);
+
+    const char* circular[] = { "a" };
+    TEST_ASSERT_NULL(catzilla_di_plan_compile(&container, circular, 1));
+    const char* missing[] = { "c" };
+    TEST_ASSERT_NULL(catzilla_di_plan_compile(&container, missing, 1));
+    const char* unknown[] = { "nope" };
+    TEST_ASSERT_NULL(catzilla_di_plan_compile(&container, unknown, 1));
+    TEST_ASSERT_NULL(catzilla_di_plan_compile(&container, NULL, 1));
+    TEST_ASSERT_NULL(catzilla_di_plan_compile(&container, circular, 0));
+    TEST_ASSERT_EQUAL(0, instance_count);
+}
+
+void test_plan_goes_stale_on_registration_changes() {
+    register_app_services();
+    const char* names[] = { "repo" };
+    catzilla_di_plan_t* plan = catzilla_di_plan_compile(&container, names, 1);
+    TEST_ASSERT_NOT_NULL(plan);
+    TEST_ASSERT_TRUE(catzilla_di_plan_is_current(plan));
+
+    add("unrelated", CATZILLA_DI_SCOPE_TRANSIENT, NULL, 0);
+    TEST_ASSERT_FALSE(catzilla_di_plan_is_current(plan));
+    void* result;
+    TEST_ASSERT_EQUAL(-1, catzilla_di_plan_execute(plan, &arena, &result));
+    catzilla_di_plan_destroy(plan);
+
+    plan = catzilla_di_plan_compile(&container, names, 1);
+    TEST_ASSERT_NOT_NULL(plan);
+    catzilla_di_reset_caches(&container);
+    TEST_ASSERT_FALSE(catzilla_di_plan_is_current(plan));
+    catzilla_di_plan_destroy(plan);
+}
+
+void test_plan_resolves_through_parent_containers() {
+    add("config", CATZILLA_DI_SCOPE_SINGLETON, NULL, 0);
+
+    catzilla_di_container_t child;
+    TEST_ASSERT_EQUAL(0, catzilla_di_container_init(&child, &container));
+    const char* handler_deps[] = { "config" };
+    TEST_ASSERT_EQUAL(0, catzilla_di_register_service_c(&child, "handler", NULL, CATZILLA_DI_SCOPE_REQUEST,
+                                                        make_instance, handler_deps, 1, "handler"));
+
+    const char* names[] = { "handler" };
+    catzilla_di_plan_t* plan = catzilla_di_plan_compile(&child, names, 1);
+    TEST_ASSERT_NOT_NULL(plan);
+    void* handler;
+    TEST_ASSERT_EQUAL(0, catzilla_di_plan_execute(plan, &arena, &handler));
+    TEST_ASSERT_EQUAL_STRING("config", ((instance_t*)((instance_t*)handler)->dependencies[0])->name);
+
+    // A change in the parent makes the child's plan stale too
+    add("other", CATZILLA_DI_SCOPE_TRANSIENT, NULL, 0);
+    TEST_ASSERT_FALSE(catzilla_di_plan_is_current(plan));
+
+    catzilla_di_plan_destroy(plan);
+    catzilla_di_container_cleanup(&child);
+}
+
+void test_plan_reports_factory_failures() {
+    TEST_ASSERT_EQUAL(0, catzilla_di_register_service_c(&container, "flaky", NULL, CATZILLA_DI_SCOPE_REQUEST,
+                                                        make_flaky, NULL, 0, "flaky"));
+    const char* names[] = { "flaky" };
+    catzilla_di_plan_t* plan = catzilla_di_plan_compile(&container, names, 1);
+    TEST_ASSERT_NOT_NULL(plan);
+
+    void* result;
+    TEST_ASSERT_EQUAL(0, catzilla_di_plan_execute(plan, &arena, &result));
+    fail_service = 1;
+    TEST_ASSERT_EQUAL(-1, catzilla_di_plan_execute(plan, &arena, &result));
+    TEST_ASSERT_EQUAL(-1, catzilla_di_plan_execute(plan, NULL, &result));
+    catzilla_di_plan_destroy(plan);
+}
+
+void test_plan_cost_ignores_unrelated_services() {
+    char names[200][32];
+    for (int i = 0; i < 200; i++) {
+        snprintf(names[i], sizeof(names[i]), "service_%d", i);
+        add(names[i], CATZILLA_DI_SCOPE_REQUEST, NULL, 0);
+    }
+    const char* deps[] = { "service_199" };
+    add("handler", CATZILLA_DI_SCOPE_REQUEST, deps, 1);
+
+    const char* roots[] = { "handler" };
+    catzilla_di_plan_t* plan = catzilla_di_plan_compile(&container, roots, 1);
+    TEST_ASSERT_NOT_NULL(plan);
+    // Only what the route needs is planned
+    TEST_ASSERT_EQUAL(2, plan->slot_count);
+    TEST_ASSERT_EQUAL(2, plan->step_count);
+
+    catzilla_arena_stats_t before, after;
+    catzilla_arena_get_stats(&before);
+    catzilla_arena_reset(&arena);
+    void* handler;
+    TEST_ASSERT_EQUAL(0, catzilla_di_plan_execute(plan, &arena, &handler));
+    TEST_ASSERT_EQUAL(2 * sizeof(void*), arena.bytes);
+    catzilla_arena_get_stats(&after);
+    TEST_ASSERT_EQUAL(before.large_allocations, after.large_allocations);
+    catzilla_di_plan_destroy(plan);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_plan_orders_dependencies_first);
+    RUN_TEST(test_plan_execution_wires_instances);
+    RUN_TEST(test_plan_shares_diamond_dependencies);
+    RUN_TEST(test_plan_rejects_missing_and_circular_services);
+    RUN_TEST(test_plan_goes_stale_on_registration_changes);
+    RUN_TEST(test_plan_resolves_through_parent_containers);
+    RUN_TEST(test_plan_reports_factory_failures);
+    RUN_TEST(test_plan_cost_ignores_unrelated_services);
+
+    return UNITY_END();
+}
@@ -0,0 +1,237 @@
+// tests/c/test_dependency_pool.c
+#include "unity.h"
+#include "dependency.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    int uses;          // Requests served since creation
+    int resets;
+    bool broken;       // Reset refuses the instance
+    void* config;
+} session_t;
+
+static int created;
+static int destroyed;
+
+static void* make_config(void** dependencies, int dependency_count, void* user_data) {
+    static int config = 42;
+    return &config;
+}
+
+static void* make_session(void** dependencies, int dependency_count, void* user_data) {
+    session_t* session = calloc(1, sizeof(session_t));
+    session->config = dependency_count > 0 ? dependencies[0] : NULL;
+    created++;
+    return session;
+}
+
+static int reset_session(void* instance, void* user_data) {
+    session_t* session = instance;
+    if (session->broken) return -1;
+    session->resets++;
+    return 0;
+}
+
+static void destroy_session(void* instance, void* user_data) {
+    destroyed++;
+    free(instance);
+}
+
+static catzilla_di_container_t container;
+
+static session_t* serve_request(catzilla_di_context_t** out_context) {
+    catzilla_di_context_t* context = catzilla_di_create_context(&container);
+    TEST_ASSERT_NOT_NULL(context);
+    session_t* session = catzilla_di_resolve_service(&container, "session", context);
+    TEST_ASSERT_NOT_NULL(session);
+    session->uses++;
+    // Resolving again in the same request gives the same instance
+    TEST_ASSERT_EQUAL_PTR(session, catzilla_di_resolve_service(&container, "session", context));
+    if (out_context) {
+        *out_context = context;
+    } else {
+        catzilla_di_cleanup_context(context);
+    }
+    return session;
+}
+
+void setUp(void) {
+    created = 0;
+    destroyed = 0;
+    TEST_ASSERT_EQUAL(0, catzilla_di_container_init(&container, NULL));
+    const char* deps[] = { "config" };
+    TEST_ASSERT_EQUAL(0, catzilla_di_register_service_c(&container, "config", NULL, CATZILLA_DI_SCOPE_SINGLETON,
+                                                        make_config, NULL, 0, NULL));
+    TEST_ASSERT_EQUAL(0, catzilla_di_register_service_c(&container, "session", NULL, CATZILLA_DI_SCOPE_REQUEST,
+                                                        make_session, deps, 1, NULL));
+}
+
+void tearDown(void) {
+    catzilla_di_container_cleanup(&container);
+    catzilla_di_instance_pool_trim();
+}
+
+void test_lifecycle_requires_request_scope_and_singleton_dependencies() {
+    TEST_ASSERT_EQUAL(-1, catzilla_di_set_service_lifecycle(&container, "config", reset_session, NULL, 0));
+    TEST_ASSERT_EQUAL(-1, catzilla_di_set_service_lifecycle(&container, "missing", reset_session, NULL, 0));
+    TEST_ASSERT_EQUAL(-1, catzilla_di_set_service_lifecycle(&container, "session", reset_session, NULL,
+                                                            CATZILLA_DI_POOL_MAX_INSTANCES + 1));
+
+    // A pooled instance must not hold on to another request's instances
+    const char* deps[] = { "session" };
+    TEST_ASSERT_EQUAL(0, catzilla_di_register_service_c(&container, "repo", NULL, CATZILLA_DI_SCOPE_REQUEST,
+                                                        make_session, deps, 1, NULL));
+    TEST_ASSERT_EQUAL(-1, catzilla_di_set_service_lifecycle(&container, "repo", reset_session, NULL, 0));
+    // Destroy-only is fine
+    TEST_ASSERT_EQUAL(0, catzilla_di_set_service_lifecycle(&container, "repo", NULL, destroy_session, 0));
+    TEST_ASSERT_EQUAL(0, catzilla_di_set_service_lifecycle(&container, "session", reset_session,
+                                                           destroy_session, 4));
+}
+
+void test_instances_are_reset_and_reused() {
+    TEST_ASSERT_EQUAL(0, catzilla_di_set_service_lifecycle(&container, "session", reset_session,
+                                                           destroy_session, 4));
+    catzilla_di_instance_pool_stats_t before, after;
+    catzilla_di_get_instance_pool_stats(&before);
+
+    session_t* first = serve_request(NULL);
+    TEST_ASSERT_EQUAL(1, first->resets);
+    TEST_ASSERT_EQUAL_PTR(catzilla_di_resolve_service(&container, "config", NULL), first->config);
+
+    for (int i = 0; i < 9; i++) {
+        TEST_ASSERT_EQUAL_PTR(first, serve_request(NULL));
+    }
+    TEST_ASSERT_EQUAL(1, created);
+    TEST_ASSERT_EQUAL(10, first->uses);
+    TEST_ASSERT_EQUAL(10, first->resets);
+
+    catzilla_di_get_instance_pool_stats(&after);
+    TEST_ASSERT_EQUAL(before.created + 1, after.created);
+    TEST_ASSERT_EQUAL(before.reused + 9, after.reused);
+    TEST_ASSERT_EQUAL(before.returned + 10, after.returned);
+    TEST_ASSERT_EQUAL(before.outstanding, after.outstanding);
+
+    // Trimming destroys what the pool holds
+    catzilla_di_instance_pool_trim();
+    TEST_ASSERT_EQUAL(1, destroyed);
+}
+
+void test_pool_size_is_bounded() {
+    TEST_ASSERT_EQUAL(0, catzilla_di_set_service_lifecycle(&container, "session", reset_session,
+                                                           destroy_session, 2));
+
+    // Four concurrent requests need four instances; only two are kept
+    catzilla_di_context_t* contexts[4];
+    session_t* sessions[4];
+    for (int i = 0; i < 4; i++) {
+        sessions[i] = serve_request(&contexts[i]);
+    }
+    TEST_ASSERT_EQUAL(4, created);
+    for (int i = 0; i < 4; i++) {
+        catzilla_di_cleanup_context(contexts[i]);
+    }
+    TEST_ASSERT_EQUAL(2, destroyed);
+
+    // The next two requests together reuse both kept instances
+    serve_request(&contexts[0]);
+    serve_request(&contexts[1]);
+    TEST_ASSERT_EQUAL(4, created);
+    catzilla_di_cleanup_context(contexts[0]);
+    catzilla_di_cleanup_context(contexts[1]);
+    (void)sessions;
+}
+
+void test_failed_reset_destroys_the_instance() {
+    TEST_ASSERT_EQUAL(0, catzilla_di_set_service_lifecycle(&container, "session", reset_session,
+                                                           destroy_session, 4));
+    catzilla_di_context_t* context;
+    session_t* session = serve_request(&context);
+    session->broken = true;
+    catzilla_di_cleanup_context(context);
+    TEST_ASSERT_EQUAL(1, destroyed);
+
+    TEST_ASSERT_TRUE(serve_request(NULL) != NULL);
+    TEST_ASSERT_EQUAL(2, created);
+}
+
+void test_destroy_only_services_are_freed_per_request() {
+    TEST_ASSERT_EQUAL(0, catzilla_di_set_service_lifecycle(&container, "session", NULL, destroy_session, 0));
+    serve_request(NULL);
+    serve_request(NULL);
+    TEST_ASSERT_EQUAL(2, created);
+    TEST_ASSERT_EQUAL(2, destroyed);
+}
+
+void test_resolving_without_a_context_hands_ownership_to_the_caller() {
+    TEST_ASSERT_EQUAL(0, catzilla_di_set_service_lifecycle(&container, "session", reset_session,
+                                                           destroy_session, 4));
+    session_t* session = catzilla_di_resolve_service(&container, "session", NULL);
+    TEST_ASSERT_NOT_NULL(session);
+    TEST_ASSERT_EQUAL(0, destroyed);
+    TEST_ASSERT_EQUAL(0, session->resets);
+    free(session);
+}
+
+void test_unreturned_instances_are_reported_as_leaks() {
+    TEST_ASSERT_EQUAL(0, catzilla_di_set_service_lifecycle(&container, "session", reset_session,
+                                                           destroy_session, 4));
+    catzilla_di_context_t* context;
+    serve_request(&context);
+    TEST_ASSERT_EQUAL(1, catzilla_di_check_instance_leaks(&container));
+
+    catzilla_di_instance_pool_stats_t before, after;
+    catzilla_di_get_instance_pool_stats(&before);
+    catzilla_di_cleanup_context(context);
+    TEST_ASSERT_EQUAL(0, catzilla_di_check_instance_leaks(&container));
+    catzilla_di_get_instance_pool_stats(&after);
+    TEST_ASSERT_EQUAL(before.outstanding - 1, after.outstanding);
+    TEST_ASSERT_EQUAL(before.leaked, after.leaked);
+}
+
+static void* serve_on_own_thread(void* arg) {
+    serve_request(NULL);
+    serve_request(NULL);
+    catzilla_di_instance_pool_trim();
+    return NULL;
+}
+
+void test_each_thread_has_its_own_pool() {
+    TEST_ASSERT_EQUAL(0, catzilla_di_set_service_lifecycle(&container, "session", reset_session,
+                                                           destroy_session, 4));
+    session_t* mine = serve_request(NULL);
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, serve_on_own_thread, NULL);
+    pthread_join(thread, NULL);
+
+    // The other thread made and destroyed its own; this one's is still here
+    TEST_ASSERT_EQUAL(2, created);
+    TEST_ASSERT_EQUAL(1, destroyed);
+    TEST_ASSERT_EQUAL_PTR(mine, serve_request(NULL));
+}
+
+void test_unregistering_drops_pooled_instances() {
+    TEST_ASSERT_EQUAL(0, catzilla_di_set_service_lifecycle(&container, "session", reset_session,
+                                                           destroy_session, 4));
+    serve_request(NULL);
+    TEST_ASSERT_EQUAL(0, catzilla_di_unregister_service(&container, "session"));
+    TEST_ASSERT_EQUAL(1, destroyed);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_lifecycle_requires_request_scope_and_singleton_dependencies);
+    RUN_TEST(test_instances_are_reset_and_reused);
+    RUN_TEST(test_pool_size_is_bounded);
+    RUN_TEST(test_failed_reset_destroys_the_instance);
+    RUN_TEST(test_destroy_only_services_are_freed_per_request);
+    RUN_TEST(test_resolving_without_a_context_hands_ownership_to_the_caller);
+    RUN_TEST(test_unreturned_instances_are_reported_as_leaks);
+    RUN_TEST(test_each_thread_has_its_own_pool);
+    RUN_TEST(test_unregistering_drops_pooled_instances);
+
+    return UNITY_END();
+}
@@ -0,0 +1,218 @@
+// tests/c/test_disk_cache.c
+#include "unity.h"
+#include "disk_cache.h"
+#include "cache_engine.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#ifndef _WIN32
+#include <dirent.h>
+#include <unistd.h>
+#endif
+
+static char test_dir[256];
+
+static catzilla_disk_cache_t* open_cache(size_t segment_size, uint64_t max_bytes) {
+    catzilla_disk_cache_config_t config = {0};
+    config.segment_size = segment_size;
+    config.max_bytes = max_bytes;
+    config.no_background = true;
+    return catzilla_disk_cache_open(test_dir, &config);
+}
+
+static void remove_test_dir(void) {
+#ifndef _WIN32
+    DIR* dir = opendir(test_dir);
+    if (!dir) return;
+    struct dirent* item;
+    char path[512];
+    while ((item = readdir(dir)) != NULL) {
+        if (item->d_name[0] == '.') continue;
+        snprintf(path, sizeof(path), "%s/%s", test_dir, item->d_name);
+        unlink(path);
+    }
+    closedir(dir);
+    rmdir(test_dir);
+#endif
+}
+
+void setUp(void) {
+#ifndef _WIN32
+    snprintf(test_dir, sizeof(test_dir), "/tmp/catzilla_disk_cache_test_%d", (int)getpid());
+#endif
+    remove_test_dir();
+}
+
+void tearDown(void) {
+    remove_test_dir();
+}
+
+void test_disk_cache_put_get_without_copy() {
+#ifndef _WIN32
+    catzilla_disk_cache_t* cache = open_cache(0, 0);
+    TEST_ASSERT_NOT_NULL(cache);
+
+    TEST_ASSERT_EQUAL(0, catzilla_disk_cache_put(cache, "page:/home", "<html>home</html>", 17, 60));
+    catzilla_disk_ref_t ref;
+    TEST_ASSERT_TRUE(catzilla_disk_cache_get(cache, "page:/home", &ref));
+    TEST_ASSERT_EQUAL(17, ref.size);
+    TEST_ASSERT_EQUAL_MEMORY("<html>home</html>", ref.data, 17);
+
+    // A pinned value stays readable after the key is replaced and deleted
+    TEST_ASSERT_EQUAL(0, catzilla_disk_cache_put(cache, "page:/home", "new", 3, 60));
+    TEST_ASSERT_EQUAL(0, catzilla_disk_cache_delete(cache, "page:/home"));
+    TEST_ASSERT_EQUAL_MEMORY("<html>home</html>", ref.data, 17);
+    catzilla_disk_cache_release(cache, &ref);
+    TEST_ASSERT_NULL(ref.segment);
+
+    TEST_ASSERT_FALSE(catzilla_disk_cache_get(cache, "page:/home", &ref));
+    TEST_ASSERT_EQUAL(-1, catzilla_disk_cache_delete(cache, "page:/home"));
+    catzilla_disk_cache_close(cache);
+#endif
+}
+
+void test_disk_cache_survives_reopen() {
+#ifndef _WIN32
+    catzilla_disk_cache_t* cache = open_cache(0, 0);
+    TEST_ASSERT_NOT_NULL(cache);
+    TEST_ASSERT_EQUAL(0, catzilla_disk_cache_put(cache, "kept", "value-1", 7, 0));
+    TEST_ASSERT_EQUAL(0, catzilla_disk_cache_put(cache, "kept", "value-2", 7, 0));
+    TEST_ASSERT_EQUAL(0, catzilla_disk_cache_put(cache, "deleted", "gone", 4, 0));
+    TEST_ASSERT_EQUAL(0, catzilla_disk_cache_delete(cache, "deleted"));
+    catzilla_disk_cache_close(cache);
+
+    cache = open_cache(0, 0);
+    TEST_ASSERT_NOT_NULL(cache);
+    catzilla_disk_ref_t ref;
+    TEST_ASSERT_TRUE(catzilla_disk_cache_get(cache, "kept", &ref));
+    TEST_ASSERT_EQUAL_MEMORY("value-2", ref.data, 7);
+    catzilla_disk_cache_release(cache, &ref);
+    TEST_ASSERT_FALSE(catzilla_disk_cache_get(cache, "deleted", &ref));
+
+    catzilla_disk_cache_stats_t stats;
+    catzilla_disk_cache_get_stats(cache, &stats);
+    TEST_ASSERT_EQUAL(1, stats.entries);
+
+    // New appends go after the replayed records
+    TEST_ASSERT_EQUAL(0, catzilla_disk_cache_put(cache, "later", "x", 1, 0));
+    TEST_ASSERT_TRUE(catzilla_disk_cache_get(cache, "kept", &ref));
+    TEST_ASSERT_EQUAL_MEMORY("value-2", ref.data, 7);
+    catzilla_disk_cache_release(cache, &ref);
+    catzilla_disk_cache_close(cache);
+#endif
+}
+
+void test_disk_cache_compaction_moves_live_records() {
+#ifndef _WIN32
+    catzilla_disk_cache_t* cache = open_cache(4096, 0);
+    TEST_ASSERT_NOT_NULL(cache);
+
+    char value[200];
+    memset(value, 'v', sizeof(value));
+    char key[32];
+    for (int i = 0; i < 60; i++) {
+        snprintf(key, sizeof(key), "key_%d", i % 20);
+        value[0] = (char)('A' + i / 20);
+        TEST_ASSERT_EQUAL(0, catzilla_disk_cache_put(cache, key, value, sizeof(value), 0));
+    }
+
+    catzilla_disk_cache_stats_t before;
+    catzilla_disk_cache_get_stats(cache, &before);
+    TEST_ASSERT_EQUAL(20, before.entries);
+    TEST_ASSERT_TRUE(before.segments > 2);
+
+    // A reader holding an old record keeps its segment mapped
+    catzilla_disk_ref_t pinned;
+    TEST_ASSERT_TRUE(catzilla_disk_cache_get(cache, "key_0", &pinned));
+
+    TEST_ASSERT_TRUE(catzilla_disk_cache_compact(cache) > 0);
+    catzilla_disk_cache_stats_t after;
+    catzilla_disk_cache_get_stats(cache, &after);
+    TEST_ASSERT_EQUAL(20, after.entries);
+    TEST_ASSERT_TRUE(after.disk_bytes < before.disk_bytes);
+
+    for (int i = 0; i < 20; i++) {
+        snprintf(key, sizeof(key), "key_%d", i);
+        catzilla_disk_ref_t ref;
+        TEST_ASSERT_TRUE(catzilla_disk_cache_get(cache, key, &ref));
+        TEST_ASSERT_EQUAL('C', ((const char*)ref.data)[0]);
+        catzilla_disk_cache_release(cache, &ref);
+    }
+    TEST_ASSERT_EQUAL('C', ((const char*)pinned.data)[0]);
+    catzilla_disk_cache_release(cache, &pinned);
+    catzilla_disk_cache_close(cache);
+#endif
+}
+
+void test_disk_cache_drops_oldest_segments_over_limit() {
+#ifndef _WIN32
+    catzilla_disk_cache_t* cache = open_cache(4096, 4 * 4096);
+    TEST_ASSERT_NOT_NULL(cache);
+
+    char value[1000];
+    memset(value, 'x', sizeof(value));
+    char key[32];
+    for (int i = 0; i < 40; i++) {
+        snprintf(key, sizeof(key), "key_%d", i);
+        TEST_ASSERT_EQUAL(0, catzilla_disk_cache_put(cache, key, value, sizeof(value), 0));
+    }
+
+    catzilla_disk_cache_stats_t stats;
+    catzilla_disk_cache_get_stats(cache, &stats);
+    TEST_ASSERT_TRUE(stats.disk_bytes <= 4 * 4096);
+    TEST_ASSERT_TRUE(stats.evicted_segments > 0);
+
+    catzilla_disk_ref_t ref;
+    TEST_ASSERT_FALSE(catzilla_disk_cache_get(cache, "key_0", &ref));
+    TEST_ASSERT_TRUE(catzilla_disk_cache_get(cache, "key_39", &ref));
+    catzilla_disk_cache_release(cache, &ref);
+    catzilla_disk_cache_close(cache);
+#endif
+}
+
+void test_multi_cache_promotes_from_disk() {
+#ifndef _WIN32
+    cache_config_t config = { 4, 0, 1, 60, 1024 * 1024, false, false, CACHE_CODEC_NONE, 0, 0, CACHE_EVICTION_CLOCK };
+    multi_cache_t* cache = multi_cache_create(&config, NULL, test_dir);
+    TEST_ASSERT_NOT_NULL(cache);
+    TEST_ASSERT_TRUE(cache->disk_enabled);
+
+    char key[32];
+    for (int i = 0; i < 10; i++) {
+        snprintf(key, sizeof(key), "response_%d", i);
+        TEST_ASSERT_EQUAL(0, multi_cache_set(cache, key, key, strlen(key) + 1, 60));
+    }
+
+    // Evicted from the four-entry L1, still on disk
+    TEST_ASSERT_FALSE(catzilla_cache_exists(cache->memory_cache, "response_0"));
+    size_t size = 0;
+    char* copy = multi_cache_get_copy(cache, "response_0", malloc, &size);
+    TEST_ASSERT_NOT_NULL(copy);
+    TEST_ASSERT_EQUAL_STRING("response_0", copy);
+    free(copy);
+    TEST_ASSERT_TRUE(catzilla_cache_exists(cache->memory_cache, "response_0"));
+
+    cache_result_t result = multi_cache_get(cache, "response_1");
+    TEST_ASSERT_TRUE(result.found);
+    TEST_ASSERT_EQUAL_STRING("response_1", (const char*)result.data);
+
+    TEST_ASSERT_EQUAL(0, multi_cache_delete(cache, "response_1"));
+    TEST_ASSERT_FALSE(multi_cache_get(cache, "response_1").found);
+
+    multi_cache_clear(cache);
+    TEST_ASSERT_NULL(multi_cache_get_copy(cache, "response_2", malloc, &size));
+    multi_cache_destroy(cache);
+#endif
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_disk_cache_put_get_without_copy);
+    RUN_TEST(test_disk_cache_survives_reopen);
+    RUN_TEST(test_disk_cache_compaction_moves_live_records);
+    RUN_TEST(test_disk_cache_drops_oldest_segments_over_limit);
+    RUN_TEST(test_multi_cache_promotes_from_disk);
+
+    return UNITY_END();
+}
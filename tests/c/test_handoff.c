@@ -0,0 +1,242 @@
+// tests/c/test_handoff.c
+#include "unity.h"
+#include "handoff.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static char socket_path[64];
+
+void setUp(void) {
+    snprintf(socket_path, sizeof(socket_path), "/tmp/catzilla-handoff-%d.sock", (int)getpid());
+    unlink(socket_path);
+}
+
+void tearDown(void) {
+    unlink(socket_path);
+}
+
+// A TCP listener on an ephemeral loopback port
+static int tcp_listener(int* port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    TEST_ASSERT_EQUAL_INT(0, bind(fd, (struct sockaddr*)&addr, sizeof(addr)));
+    TEST_ASSERT_EQUAL_INT(0, listen(fd, 16));
+    *port = -1;
+    socklen_t length = sizeof(addr);
+    if (getsockname(fd, (struct sockaddr*)&addr, &length) == 0) *port = ntohs(addr.sin_port);
+    return fd;
+}
+
+static int bound_port(int fd) {
+    struct sockaddr_in addr;
+    socklen_t length = sizeof(addr);
+    if (getsockname(fd, (struct sockaddr*)&addr, &length) != 0) return -1;
+    return ntohs(addr.sin_port);
+}
+
+static bool path_exists(void) {
+    struct stat st;
+    return stat(socket_path, &st) == 0;
+}
+
+// The successor side, run on its own thread
+typedef struct {
+    int fds[CATZILLA_HANDOFF_MAX_FDS];
+    int max_fds;
+    int result;
+} successor_t;
+
+static void* run_successor(void* arg) {
+    successor_t* successor = (successor_t*)arg;
+    successor->result = catzilla_handoff_request(socket_path, successor->fds, successor->max_fds, 2000);
+    return NULL;
+}
+
+// Accept the successor once it connected
+static int accept_successor(int listen_fd) {
+    for (int attempt = 0; attempt < 2000; attempt++) {
+        int peer = catzilla_handoff_accept(listen_fd);
+        if (peer >= 0 || errno != EAGAIN) return peer;
+        usleep(1000);
+    }
+    return -1;
+}
+
+void test_missing_socket_means_cold_start(void) {
+    int fds[4];
+    TEST_ASSERT_EQUAL_INT(0, catzilla_handoff_request(socket_path, fds, 4, 100));
+}
+
+void test_stale_socket_file_is_removed(void) {
+    // Bound but closed: the file stays and nobody accepts on it
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, socket_path);
+    TEST_ASSERT_EQUAL_INT(0, bind(fd, (struct sockaddr*)&addr, sizeof(addr)));
+    close(fd);
+    TEST_ASSERT_TRUE(path_exists());
+
+    int fds[4];
+    TEST_ASSERT_EQUAL_INT(0, catzilla_handoff_request(socket_path, fds, 4, 100));
+    TEST_ASSERT_FALSE(path_exists());
+}
+
+void test_path_too_long_is_rejected(void) {
+    char path[256];
+    memset(path, 'a', sizeof(path) - 1);
+    path[sizeof(path) - 1] = '\0';
+    int fds[4];
+    uint64_t inode;
+    TEST_ASSERT_EQUAL_INT(-1, catzilla_handoff_request(path, fds, 4, 100));
+    TEST_ASSERT_EQUAL_INT(-1, catzilla_handoff_listen(path, &inode));
+}
+
+void test_accept_without_successor(void) {
+    uint64_t inode = 0;
+    int listen_fd = catzilla_handoff_listen(socket_path, &inode);
+    TEST_ASSERT_TRUE(listen_fd >= 0);
+    TEST_ASSERT_TRUE(inode != 0);
+
+    struct stat st;
+    TEST_ASSERT_EQUAL_INT(0, stat(socket_path, &st));
+    TEST_ASSERT_EQUAL_INT(S_IRUSR | S_IWUSR, st.st_mode & 0777);
+
+    TEST_ASSERT_EQUAL_INT(-1, catzilla_handoff_accept(listen_fd));
+    TEST_ASSERT_EQUAL_INT(EAGAIN, errno);
+
+    catzilla_handoff_close(listen_fd, socket_path, inode);
+    TEST_ASSERT_FALSE(path_exists());
+}
+
+void test_listeners_are_handed_over(void) {
+    int ports[2];
+    int listeners[2] = {tcp_listener(&ports[0]), tcp_listener(&ports[1])};
+
+    uint64_t inode;
+    int listen_fd = catzilla_handoff_listen(socket_path, &inode);
+    TEST_ASSERT_TRUE(listen_fd >= 0);
+
+    successor_t successor = {.max_fds = CATZILLA_HANDOFF_MAX_FDS, .result = -2};
+    pthread_t thread;
+    pthread_create(&thread, NULL, run_successor, &successor);
+
+    int peer = accept_successor(listen_fd);
+    TEST_ASSERT_TRUE(peer >= 0);
+    TEST_ASSERT_EQUAL_INT(0, catzilla_handoff_send(peer, listeners, 2, 2000));
+    pthread_join(thread, NULL);
+    catzilla_handoff_close(listen_fd, socket_path, inode);
+
+    TEST_ASSERT_EQUAL_INT(2, successor.result);
+    TEST_ASSERT_EQUAL_INT(ports[0], bound_port(successor.fds[0]));
+    TEST_ASSERT_EQUAL_INT(ports[1], bound_port(successor.fds[1]));
+
+    // The old server closes its copies; the port keeps accepting
+    close(listeners[0]);
+    close(listeners[1]);
+    int client = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)ports[0]);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    TEST_ASSERT_EQUAL_INT(0, connect(client, (struct sockaddr*)&addr, sizeof(addr)));
+    int accepted = accept(successor.fds[0], NULL, NULL);
+    TEST_ASSERT_TRUE(accepted >= 0);
+
+    close(accepted);
+    close(client);
+    close(successor.fds[0]);
+    close(successor.fds[1]);
+}
+
+void test_successor_that_never_answers(void) {
+    int port;
+    int listener = tcp_listener(&port);
+    uint64_t inode;
+    int listen_fd = catzilla_handoff_listen(socket_path, &inode);
+    TEST_ASSERT_TRUE(listen_fd >= 0);
+
+    // Connects and goes away before the sockets arrive
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, socket_path);
+    TEST_ASSERT_EQUAL_INT(0, connect(fd, (struct sockaddr*)&addr, sizeof(addr)));
+    close(fd);
+
+    int peer = accept_successor(listen_fd);
+    TEST_ASSERT_TRUE(peer >= 0);
+    TEST_ASSERT_EQUAL_INT(-1, catzilla_handoff_send(peer, &listener, 1, 200));
+
+    // The server still owns a working listener
+    TEST_ASSERT_EQUAL_INT(port, bound_port(listener));
+    catzilla_handoff_close(listen_fd, socket_path, inode);
+    close(listener);
+}
+
+void test_successor_refuses_too_many_sockets(void) {
+    int ports[3];
+    int listeners[3] = {tcp_listener(&ports[0]), tcp_listener(&ports[1]), tcp_listener(&ports[2])};
+    uint64_t inode;
+    int listen_fd = catzilla_handoff_listen(socket_path, &inode);
+    TEST_ASSERT_TRUE(listen_fd >= 0);
+
+    successor_t successor = {.max_fds = 2, .result = -2};
+    pthread_t thread;
+    pthread_create(&thread, NULL, run_successor, &successor);
+
+    int peer = accept_successor(listen_fd);
+    TEST_ASSERT_TRUE(peer >= 0);
+    TEST_ASSERT_EQUAL_INT(-1, catzilla_handoff_send(peer, listeners, 3, 2000));
+    pthread_join(thread, NULL);
+    TEST_ASSERT_EQUAL_INT(-1, successor.result);
+
+    catzilla_handoff_close(listen_fd, socket_path, inode);
+    for (int i = 0; i < 3; i++) close(listeners[i]);
+}
+
+void test_close_keeps_a_successors_socket(void) {
+    uint64_t old_inode;
+    int old_fd = catzilla_handoff_listen(socket_path, &old_inode);
+    TEST_ASSERT_TRUE(old_fd >= 0);
+
+    // The successor binds its own socket before the old server closes
+    uint64_t new_inode;
+    int new_fd = catzilla_handoff_listen(socket_path, &new_inode);
+    TEST_ASSERT_TRUE(new_fd >= 0);
+    TEST_ASSERT_TRUE(old_inode != new_inode);
+
+    catzilla_handoff_close(old_fd, socket_path, old_inode);
+    TEST_ASSERT_TRUE(path_exists());
+    catzilla_handoff_close(new_fd, socket_path, new_inode);
+    TEST_ASSERT_FALSE(path_exists());
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_missing_socket_means_cold_start);
+    RUN_TEST(test_stale_socket_file_is_removed);
+    RUN_TEST(test_path_too_long_is_rejected);
+    RUN_TEST(test_accept_without_successor);
+    RUN_TEST(test_listeners_are_handed_over);
+    RUN_TEST(test_successor_that_never_answers);
+    RUN_TEST(test_successor_refuses_too_many_sockets);
+    RUN_TEST(test_close_keeps_a_successors_socket);
+
+    return UNITY_END();
+}
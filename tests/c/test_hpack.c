@@ -0,0 +1,157 @@
+// tests/c/test_hpack.c
+#include "unity.h"
+#include "hpack.h"
+#include "memory.h"
+#include <string.h>
+#include <stdio.h>
+
+static catzilla_hpack_decoder_t decoder;
+static char decoded[1024];
+static size_t decoded_length;
+
+void setUp(void) {
+    catzilla_hpack_decoder_init(&decoder, CATZILLA_HPACK_DEFAULT_TABLE_SIZE);
+    decoded[0] = '\0';
+    decoded_length = 0;
+}
+
+void tearDown(void) {
+    catzilla_hpack_decoder_free(&decoder);
+}
+
+// Collect fields as "name: value\n" lines
+static int collect_field(void* user_data, const char* name, size_t name_length,
+                         const char* value, size_t value_length) {
+    (void)user_data;
+    int written = snprintf(decoded + decoded_length, sizeof(decoded) - decoded_length,
+                           "%.*s: %.*s\n", (int)name_length, name, (int)value_length, value);
+    decoded_length += (size_t)written;
+    return 0;
+}
+
+static int decode_hex(const char* hex) {
+    uint8_t block[256];
+    size_t length = 0;
+    for (size_t i = 0; hex[i] && hex[i + 1]; i += 2) {
+        unsigned int byte;
+        sscanf(hex + i, "%2x", &byte);
+        block[length++] = (uint8_t)byte;
+    }
+    decoded[0] = '\0';
+    decoded_length = 0;
+    return catzilla_hpack_decode(&decoder, block, length, collect_field, NULL);
+}
+
+void test_integer_decoding() {
+    // RFC 7541 C.1.2: 1337 with a 5-bit prefix
+    const uint8_t encoded[] = { 0x1f, 0x9a, 0x0a };
+    const uint8_t* pos = encoded;
+    uint32_t value = 0;
+    TEST_ASSERT_EQUAL(0, catzilla_hpack_decode_integer(&pos, encoded + sizeof(encoded), 5, &value));
+    TEST_ASSERT_EQUAL(1337, value);
+    TEST_ASSERT_EQUAL_PTR(encoded + sizeof(encoded), pos);
+
+    // Truncated continuation
+    pos = encoded;
+    TEST_ASSERT_EQUAL(-1, catzilla_hpack_decode_integer(&pos, encoded + 2, 5, &value));
+}
+
+void test_huffman_decoding() {
+    // "www.example.com" from RFC 7541 C.4.1
+    const uint8_t coded[] = { 0xf1, 0xe3, 0xc2, 0xe5, 0xf2, 0x3a, 0x6b, 0xa0, 0xab, 0x90, 0xf4, 0xff };
+    char out[32];
+    size_t length = 0;
+    TEST_ASSERT_EQUAL(0, catzilla_hpack_huffman_decode(coded, sizeof(coded), out, sizeof(out), &length));
+    TEST_ASSERT_EQUAL(15, length);
+    TEST_ASSERT_EQUAL_MEMORY("www.example.com", out, 15);
+
+    // A full byte of padding is invalid
+    const uint8_t padded[] = { 0xf1, 0xe3, 0xc2, 0xe5, 0xf2, 0x3a, 0x6b, 0xa0, 0xab, 0x90, 0xf4, 0xff, 0xff };
+    TEST_ASSERT_EQUAL(-1, catzilla_hpack_huffman_decode(padded, sizeof(padded), out, sizeof(out), &length));
+}
+
+void test_request_sequence_without_huffman() {
+    // RFC 7541 C.3
+    TEST_ASSERT_EQUAL(0, decode_hex("828684410f7777772e6578616d706c652e636f6d"));
+    TEST_ASSERT_EQUAL_STRING(":method: GET\n:scheme: http\n:path: /\n:authority: www.example.com\n", decoded);
+    TEST_ASSERT_EQUAL(57, decoder.size);
+
+    TEST_ASSERT_EQUAL(0, decode_hex("828684be58086e6f2d6361636865"));
+    TEST_ASSERT_EQUAL_STRING(":method: GET\n:scheme: http\n:path: /\n:authority: www.example.com\n"
+                             "cache-control: no-cache\n", decoded);
+    TEST_ASSERT_EQUAL(110, decoder.size);
+}
+
+void test_request_sequence_with_huffman() {
+    // RFC 7541 C.4
+    TEST_ASSERT_EQUAL(0, decode_hex("828684418cf1e3c2e5f23a6ba0ab90f4ff"));
+    TEST_ASSERT_EQUAL_STRING(":method: GET\n:scheme: http\n:path: /\n:authority: www.example.com\n", decoded);
+
+    TEST_ASSERT_EQUAL(0, decode_hex("828684be5886a8eb10649cbf"));
+    TEST_ASSERT_EQUAL_STRING(":method: GET\n:scheme: http\n:path: /\n:authority: www.example.com\n"
+                             "cache-control: no-cache\n", decoded);
+
+    TEST_ASSERT_EQUAL(0, decode_hex("828785bf408825a849e95ba97d7f8925a849e95bb8e8b4bf"));
+    TEST_ASSERT_EQUAL_STRING(":method: GET\n:scheme: https\n:path: /index.html\n:authority: www.example.com\n"
+                             "custom-key: custom-value\n", decoded);
+    TEST_ASSERT_EQUAL(3, decoder.count);
+    TEST_ASSERT_EQUAL(164, decoder.size);
+}
+
+void test_table_size_update_and_eviction() {
+    TEST_ASSERT_EQUAL(0, decode_hex("828684418cf1e3c2e5f23a6ba0ab90f4ff"));
+    TEST_ASSERT_EQUAL(1, decoder.count);
+
+    // Size update to 0 empties the table; the old index is then invalid
+    TEST_ASSERT_EQUAL(0, decode_hex("20"));
+    TEST_ASSERT_EQUAL(0, decoder.count);
+    TEST_ASSERT_EQUAL(0, decoder.size);
+    TEST_ASSERT_EQUAL(-1, decode_hex("be"));
+
+    // Updates above the advertised limit are a compression error
+    TEST_ASSERT_EQUAL(-1, decode_hex("3fe21f"));
+}
+
+void test_invalid_blocks() {
+    TEST_ASSERT_EQUAL(-1, decode_hex("80"));    // Index 0
+    TEST_ASSERT_EQUAL(-1, decode_hex("c0"));    // Dynamic index past the table
+    TEST_ASSERT_EQUAL(-1, decode_hex("410f77"));  // String runs past the block
+}
+
+void test_encoder_round_trip() {
+    uint8_t block[256];
+    size_t length = 0;
+    length += catzilla_hpack_encode_status(block + length, 200);
+    length += catzilla_hpack_encode_status(block + length, 418);
+    length += catzilla_hpack_encode_header(block + length, sizeof(block) - length,
+                                           "Content-Type", 12, "text/plain", 10);
+    length += catzilla_hpack_encode_header(block + length, sizeof(block) - length,
+                                           "X-Request-Id", 12, "abc", 3);
+    TEST_ASSERT_EQUAL(0x88, block[0]);
+
+    TEST_ASSERT_EQUAL(0, catzilla_hpack_decode(&decoder, block, length, collect_field, NULL));
+    TEST_ASSERT_EQUAL_STRING(":status: 200\n:status: 418\ncontent-type: text/plain\nx-request-id: abc\n", decoded);
+
+    // Literals without indexing leave the table alone
+    TEST_ASSERT_EQUAL(0, decoder.count);
+    TEST_ASSERT_EQUAL(0, catzilla_hpack_encode_header(block, 8, "X-Long", 6, "value", 5));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    // Primitives
+    RUN_TEST(test_integer_decoding);
+    RUN_TEST(test_huffman_decoding);
+
+    // RFC 7541 Appendix C vectors
+    RUN_TEST(test_request_sequence_without_huffman);
+    RUN_TEST(test_request_sequence_with_huffman);
+    RUN_TEST(test_table_size_update_and_eviction);
+    RUN_TEST(test_invalid_blocks);
+
+    // Encoder
+    RUN_TEST(test_encoder_round_trip);
+
+    return UNITY_END();
+}
@@ -0,0 +1,280 @@
+// tests/c/test_http2.c
+#include "unity.h"
+#include "http2.h"
+#include "memory.h"
+#include <string.h>
+
+static catzilla_h2_session_t* session;
+static uint8_t output[65536];
+static size_t output_length;
+static bool output_close;
+
+static int request_count;
+static char last_method[32];
+static char last_path[256];
+static char last_host[256];
+static char last_body[256];
+static bool defer_requests;
+static const char* response_body;
+
+typedef struct {
+    uint32_t length;
+    uint8_t type;
+    uint8_t flags;
+    uint32_t stream_id;
+    const uint8_t* payload;
+} frame_t;
+
+static int capture_output(void* user_data, const char* data, size_t length, bool close_after) {
+    (void)user_data;
+    memcpy(output + output_length, data, length);
+    output_length += length;
+    output_close |= close_after;
+    return 0;
+}
+
+static int handle_request(void* user_data, catzilla_h2_request_t* request) {
+    (void)user_data;
+    request_count++;
+    strcpy(last_method, request->method);
+    strcpy(last_path, request->path);
+    const char* host = catzilla_header_set_get_known(request->headers, CATZILLA_HDR_HOST, NULL);
+    strcpy(last_host, host ? host : "");
+    memcpy(last_body, request->body ? request->body : "", request->body_length);
+    last_body[request->body_length] = '\0';
+
+    if (defer_requests) {
+        return CATZILLA_H2_DISPATCH_DEFERRED;
+    }
+
+    catzilla_h2_header_t headers[] = { { "Content-Type", 12, "text/plain", 10 } };
+    catzilla_h2_submit_response(session, request->stream_id, 200, headers, 1,
+                                response_body, strlen(response_body));
+    return CATZILLA_H2_DISPATCH_DONE;
+}
+
+void setUp(void) {
+    output_length = 0;
+    output_close = false;
+    request_count = 0;
+    defer_requests = false;
+    response_body = "hello";
+    session = catzilla_h2_session_create(handle_request, capture_output, NULL, 64);
+}
+
+void tearDown(void) {
+    catzilla_h2_session_free(session);
+}
+
+static size_t put_frame(uint8_t* out, uint8_t type, uint8_t flags, uint32_t stream_id,
+                        const void* payload, size_t length) {
+    out[0] = (uint8_t)(length >> 16);
+    out[1] = (uint8_t)(length >> 8);
+    out[2] = (uint8_t)length;
+    out[3] = type;
+    out[4] = flags;
+    out[5] = (uint8_t)(stream_id >> 24);
+    out[6] = (uint8_t)(stream_id >> 16);
+    out[7] = (uint8_t)(stream_id >> 8);
+    out[8] = (uint8_t)stream_id;
+    if (length > 0) memcpy(out + 9, payload, length);
+    return 9 + length;
+}
+
+// GET / on www.example.com (RFC 7541 C.4.1) or the same request with POST
+static const uint8_t get_block[] = { 0x82, 0x86, 0x84, 0x41, 0x8c, 0xf1, 0xe3, 0xc2, 0xe5, 0xf2,
+                                     0x3a, 0x6b, 0xa0, 0xab, 0x90, 0xf4, 0xff };
+static const uint8_t post_block[] = { 0x83, 0x86, 0x84, 0x41, 0x8c, 0xf1, 0xe3, 0xc2, 0xe5, 0xf2,
+                                      0x3a, 0x6b, 0xa0, 0xab, 0x90, 0xf4, 0xff };
+
+static int receive_preface(const uint8_t* settings, size_t settings_length) {
+    uint8_t buffer[256];
+    memcpy(buffer, CATZILLA_H2_PREFACE, CATZILLA_H2_PREFACE_LEN);
+    size_t length = CATZILLA_H2_PREFACE_LEN;
+    length += put_frame(buffer + length, 0x4, 0, 0, settings, settings_length);
+    return catzilla_h2_session_receive(session, (const char*)buffer, length);
+}
+
+static int receive_frame(uint8_t type, uint8_t flags, uint32_t stream_id, const void* payload, size_t length) {
+    uint8_t buffer[512];
+    size_t total = put_frame(buffer, type, flags, stream_id, payload, length);
+    return catzilla_h2_session_receive(session, (const char*)buffer, total);
+}
+
+// Find the nth frame of a type in the captured output
+static bool find_frame(uint8_t type, int nth, frame_t* frame_out) {
+    size_t pos = 0;
+    while (pos + 9 <= output_length) {
+        frame_t frame;
+        frame.length = ((uint32_t)output[pos] << 16) | ((uint32_t)output[pos + 1] << 8) | output[pos + 2];
+        frame.type = output[pos + 3];
+        frame.flags = output[pos + 4];
+        frame.stream_id = ((uint32_t)output[pos + 5] << 24) | ((uint32_t)output[pos + 6] << 16) |
+                          ((uint32_t)output[pos + 7] << 8) | output[pos + 8];
+        frame.payload = output + pos + 9;
+        if (frame.type == type && nth-- == 0) {
+            *frame_out = frame;
+            return true;
+        }
+        pos += 9 + frame.length;
+    }
+    return false;
+}
+
+void test_preface_detection() {
+    TEST_ASSERT_TRUE(catzilla_h2_is_preface(CATZILLA_H2_PREFACE, CATZILLA_H2_PREFACE_LEN));
+    TEST_ASSERT_TRUE(catzilla_h2_is_preface("PRI * HTTP", 10));
+    TEST_ASSERT_FALSE(catzilla_h2_is_preface("POST / HTTP/1.1\r\n", 17));
+    TEST_ASSERT_FALSE(catzilla_h2_is_preface("PRI", 3));
+}
+
+void test_request_and_response() {
+    TEST_ASSERT_EQUAL(0, receive_preface(NULL, 0));
+
+    frame_t frame;
+    TEST_ASSERT_TRUE(find_frame(0x4, 0, &frame));   // Server SETTINGS
+    TEST_ASSERT_EQUAL(0, frame.flags);
+    TEST_ASSERT_TRUE(find_frame(0x4, 1, &frame));   // ACK of the client's
+    TEST_ASSERT_EQUAL(0x1, frame.flags);
+
+    TEST_ASSERT_EQUAL(0, receive_frame(0x1, 0x5, 1, get_block, sizeof(get_block)));
+    TEST_ASSERT_EQUAL(1, request_count);
+    TEST_ASSERT_EQUAL_STRING("GET", last_method);
+    TEST_ASSERT_EQUAL_STRING("/", last_path);
+    TEST_ASSERT_EQUAL_STRING("www.example.com", last_host);
+
+    TEST_ASSERT_TRUE(find_frame(0x1, 0, &frame));
+    TEST_ASSERT_EQUAL(1, frame.stream_id);
+    TEST_ASSERT_EQUAL(0x4, frame.flags);             // END_HEADERS, body follows
+    TEST_ASSERT_EQUAL(0x88, frame.payload[0]);       // :status 200 from the static table
+
+    TEST_ASSERT_TRUE(find_frame(0x0, 0, &frame));
+    TEST_ASSERT_EQUAL(1, frame.stream_id);
+    TEST_ASSERT_EQUAL(0x1, frame.flags);
+    TEST_ASSERT_EQUAL(5, frame.length);
+    TEST_ASSERT_EQUAL_MEMORY("hello", frame.payload, 5);
+    TEST_ASSERT_EQUAL(0, catzilla_h2_session_open_streams(session));
+}
+
+void test_request_split_across_reads() {
+    uint8_t buffer[256];
+    memcpy(buffer, CATZILLA_H2_PREFACE, CATZILLA_H2_PREFACE_LEN);
+    size_t length = CATZILLA_H2_PREFACE_LEN;
+    length += put_frame(buffer + length, 0x4, 0, 0, NULL, 0);
+    length += put_frame(buffer + length, 0x1, 0x4, 1, post_block, sizeof(post_block));
+    length += put_frame(buffer + length, 0x0, 0x1, 1, "a=1", 3);
+
+    // One byte at a time exercises the preface and partial-frame buffering
+    for (size_t i = 0; i < length; i++) {
+        TEST_ASSERT_EQUAL(0, catzilla_h2_session_receive(session, (const char*)buffer + i, 1));
+    }
+    TEST_ASSERT_EQUAL(1, request_count);
+    TEST_ASSERT_EQUAL_STRING("POST", last_method);
+    TEST_ASSERT_EQUAL_STRING("a=1", last_body);
+}
+
+void test_send_window_holds_body() {
+    // Peer SETTINGS_INITIAL_WINDOW_SIZE = 3
+    const uint8_t settings[] = { 0x00, 0x04, 0x00, 0x00, 0x00, 0x03 };
+    TEST_ASSERT_EQUAL(0, receive_preface(settings, sizeof(settings)));
+    TEST_ASSERT_EQUAL(0, receive_frame(0x1, 0x5, 1, get_block, sizeof(get_block)));
+
+    frame_t frame;
+    TEST_ASSERT_TRUE(find_frame(0x0, 0, &frame));
+    TEST_ASSERT_EQUAL(3, frame.length);
+    TEST_ASSERT_EQUAL(0, frame.flags);
+    TEST_ASSERT_FALSE(find_frame(0x0, 1, &frame));
+    TEST_ASSERT_EQUAL(1, catzilla_h2_session_open_streams(session));
+
+    const uint8_t increment[] = { 0x00, 0x00, 0x00, 0x10 };
+    TEST_ASSERT_EQUAL(0, receive_frame(0x8, 0, 1, increment, sizeof(increment)));
+    TEST_ASSERT_TRUE(find_frame(0x0, 1, &frame));
+    TEST_ASSERT_EQUAL(2, frame.length);
+    TEST_ASSERT_EQUAL(0x1, frame.flags);
+    TEST_ASSERT_EQUAL_MEMORY("lo", frame.payload, 2);
+    TEST_ASSERT_EQUAL(0, catzilla_h2_session_open_streams(session));
+}
+
+void test_deferred_response_holds_later_streams() {
+    defer_requests = true;
+    TEST_ASSERT_EQUAL(0, receive_preface(NULL, 0));
+    TEST_ASSERT_EQUAL(0, receive_frame(0x1, 0x5, 1, get_block, sizeof(get_block)));
+    TEST_ASSERT_EQUAL(0, receive_frame(0x1, 0x5, 3, get_block, sizeof(get_block)));
+    TEST_ASSERT_EQUAL(1, request_count);
+
+    defer_requests = false;
+    TEST_ASSERT_EQUAL(0, catzilla_h2_submit_response(session, 1, 204, NULL, 0, NULL, 0));
+    TEST_ASSERT_EQUAL(0, catzilla_h2_session_resume(session));
+    TEST_ASSERT_EQUAL(2, request_count);
+
+    frame_t frame;
+    TEST_ASSERT_TRUE(find_frame(0x1, 0, &frame));
+    TEST_ASSERT_EQUAL(1, frame.stream_id);
+    TEST_ASSERT_EQUAL(0x5, frame.flags);             // No body: END_STREAM on HEADERS
+    TEST_ASSERT_EQUAL(0x89, frame.payload[0]);
+    TEST_ASSERT_TRUE(find_frame(0x1, 1, &frame));
+    TEST_ASSERT_EQUAL(3, frame.stream_id);
+}
+
+void test_body_limit_answers_413() {
+    TEST_ASSERT_EQUAL(0, receive_preface(NULL, 0));
+    TEST_ASSERT_EQUAL(0, receive_frame(0x1, 0x4, 1, post_block, sizeof(post_block)));
+
+    char big[100];
+    memset(big, 'x', sizeof(big));
+    TEST_ASSERT_EQUAL(0, receive_frame(0x0, 0x1, 1, big, sizeof(big)));
+    TEST_ASSERT_EQUAL(0, request_count);
+
+    frame_t frame;
+    TEST_ASSERT_TRUE(find_frame(0x1, 0, &frame));
+    TEST_ASSERT_EQUAL(0x08, frame.payload[0]);       // Literal :status
+    TEST_ASSERT_EQUAL_MEMORY("413", frame.payload + 2, 3);
+    TEST_ASSERT_FALSE(output_close);
+}
+
+void test_ping_is_acknowledged() {
+    TEST_ASSERT_EQUAL(0, receive_preface(NULL, 0));
+    TEST_ASSERT_EQUAL(0, receive_frame(0x6, 0, 0, "12345678", 8));
+
+    frame_t frame;
+    TEST_ASSERT_TRUE(find_frame(0x6, 0, &frame));
+    TEST_ASSERT_EQUAL(0x1, frame.flags);
+    TEST_ASSERT_EQUAL_MEMORY("12345678", frame.payload, 8);
+}
+
+void test_protocol_errors_send_goaway() {
+    TEST_ASSERT_EQUAL(0, receive_preface(NULL, 0));
+
+    // HEADERS on an even (server-initiated) stream id
+    TEST_ASSERT_EQUAL(-1, receive_frame(0x1, 0x5, 2, get_block, sizeof(get_block)));
+    frame_t frame;
+    TEST_ASSERT_TRUE(find_frame(0x7, 0, &frame));
+    TEST_ASSERT_EQUAL(CATZILLA_H2_PROTOCOL_ERROR, frame.payload[7]);
+    TEST_ASSERT_TRUE(output_close);
+    TEST_ASSERT_EQUAL(-1, catzilla_h2_session_receive(session, "x", 1));
+}
+
+void test_bad_preface_is_rejected() {
+    TEST_ASSERT_EQUAL(-1, catzilla_h2_session_receive(session, "PRI * HTTP/1.1\r\n\r\nSM\r\n\r\n", 24));
+    TEST_ASSERT_TRUE(output_close);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_preface_detection);
+    RUN_TEST(test_request_and_response);
+    RUN_TEST(test_request_split_across_reads);
+
+    // Flow control and dispatch order
+    RUN_TEST(test_send_window_holds_body);
+    RUN_TEST(test_deferred_response_holds_later_streams);
+    RUN_TEST(test_body_limit_answers_413);
+
+    // Connection management
+    RUN_TEST(test_ping_is_acknowledged);
+    RUN_TEST(test_protocol_errors_send_goaway);
+    RUN_TEST(test_bad_preface_is_rejected);
+
+    return UNITY_END();
+}
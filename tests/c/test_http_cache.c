@@ -0,0 +1,228 @@
+// tests/c/test_http_cache.c
+#include "unity.h"
+#include "http_cache.h"
+#include "http_headers.h"
+#include "http_response.h"
+#include "memory.h"
+#include <string.h>
+
+static catzilla_header_set_t request;
+
+void setUp(void) {
+    catzilla_header_set_init(&request);
+}
+
+void tearDown(void) {
+    catzilla_header_set_free(&request);
+}
+
+static void add_header(catzilla_header_set_t* set, const char* name, const char* value) {
+    TEST_ASSERT_EQUAL(0, catzilla_header_set_append_name(set, name, strlen(name)));
+    if (value[0]) {
+        TEST_ASSERT_EQUAL(0, catzilla_header_set_append_value(set, value, strlen(value)));
+    }
+    catzilla_header_set_commit(set);
+}
+
+void test_cache_control_decides_storage_and_ttl() {
+    TEST_ASSERT_EQUAL(60, catzilla_http_cache_ttl(NULL, 60));
+    TEST_ASSERT_EQUAL(60, catzilla_http_cache_ttl("application/json", 60));
+    TEST_ASSERT_EQUAL(60, catzilla_http_cache_ttl("Content-Type: text/plain\r\n", 60));
+
+    TEST_ASSERT_EQUAL(0, catzilla_http_cache_ttl("Cache-Control: no-store\r\n", 60));
+    TEST_ASSERT_EQUAL(0, catzilla_http_cache_ttl("Cache-Control: public, no-cache\r\n", 60));
+    TEST_ASSERT_EQUAL(0, catzilla_http_cache_ttl("cache-control: Private\r\n", 60));
+    TEST_ASSERT_EQUAL(0, catzilla_http_cache_ttl("Cache-Control: max-age=0\r\n", 60));
+    TEST_ASSERT_EQUAL(300, catzilla_http_cache_ttl("Cache-Control: public, max-age=300\r\n", 60));
+    TEST_ASSERT_EQUAL(30, catzilla_http_cache_ttl("Cache-Control: max-age=300, s-maxage=\"30\"\r\n", 60));
+    TEST_ASSERT_EQUAL(60, catzilla_http_cache_ttl("Cache-Control: max-age=abc\r\n", 60));
+
+    TEST_ASSERT_EQUAL(0, catzilla_http_cache_ttl("Set-Cookie: a=b\r\n", 60));
+    TEST_ASSERT_EQUAL(0, catzilla_http_cache_ttl("Vary: Accept, *\r\n", 60));
+}
+
+void test_vary_names_are_normalized() {
+    char names[CATZILLA_HTTP_CACHE_VARY_LEN_MAX];
+    TEST_ASSERT_EQUAL(0, catzilla_http_cache_vary_names("Content-Type: text/plain\r\n", names, sizeof(names)));
+    TEST_ASSERT_EQUAL_STRING("", names);
+
+    int length = catzilla_http_cache_vary_names("Vary:  Accept-Encoding ,, Accept-Language\r\n",
+                                                names, sizeof(names));
+    TEST_ASSERT_EQUAL_STRING("accept-encoding,accept-language", names);
+    TEST_ASSERT_EQUAL((int)strlen(names), length);
+
+    TEST_ASSERT_EQUAL(-1, catzilla_http_cache_vary_names("Vary: *\r\n", names, sizeof(names)));
+    TEST_ASSERT_EQUAL(-1, catzilla_http_cache_vary_names("Vary: Accept-Encoding\r\n", names, 8));
+}
+
+void test_variant_hash_follows_accepted_codings() {
+    const char* names = "accept-encoding";
+    catzilla_header_set_t other;
+    catzilla_header_set_init(&other);
+
+    // Same codings, different spelling and order
+    add_header(&request, "Accept-Encoding", "gzip, deflate, br");
+    add_header(&other, "Accept-Encoding", "br;q=1.0, GZIP;q=0.8, deflate");
+    TEST_ASSERT_EQUAL(catzilla_http_cache_variant_hash(names, strlen(names), &request),
+                      catzilla_http_cache_variant_hash(names, strlen(names), &other));
+
+    // A refused coding is a different variant
+    catzilla_header_set_reset(&other);
+    add_header(&other, "Accept-Encoding", "gzip, deflate, br;q=0");
+    TEST_ASSERT_NOT_EQUAL(catzilla_http_cache_variant_hash(names, strlen(names), &request),
+                          catzilla_http_cache_variant_hash(names, strlen(names), &other));
+
+    // Absent and empty headers differ
+    catzilla_header_set_reset(&request);
+    catzilla_header_set_reset(&other);
+    add_header(&other, "Accept-Encoding", "");
+    TEST_ASSERT_NOT_EQUAL(catzilla_http_cache_variant_hash(names, strlen(names), &request),
+                          catzilla_http_cache_variant_hash(names, strlen(names), &other));
+
+    // Other headers hash their trimmed value
+    const char* language = "accept-language";
+    catzilla_header_set_reset(&request);
+    catzilla_header_set_reset(&other);
+    add_header(&request, "Accept-Language", "de");
+    add_header(&other, "Accept-Language", "fr");
+    TEST_ASSERT_NOT_EQUAL(catzilla_http_cache_variant_hash(language, strlen(language), &request),
+                          catzilla_http_cache_variant_hash(language, strlen(language), &other));
+
+    char key[64] = "GET:/products";
+    catzilla_http_cache_variant_key(key, 0xabcdef01u);
+    TEST_ASSERT_EQUAL_STRING("GET:/products#abcdef01", key);
+    catzilla_header_set_free(&other);
+}
+
+void test_etag_weak_comparison() {
+    char etag[CATZILLA_ETAG_MAX];
+    size_t length = catzilla_http_etag("hello", 5, etag);
+    TEST_ASSERT_EQUAL(18, length);
+    TEST_ASSERT_EQUAL('"', etag[0]);
+    TEST_ASSERT_EQUAL('"', etag[17]);
+
+    char other[CATZILLA_ETAG_MAX];
+    catzilla_http_etag("hellO", 5, other);
+    TEST_ASSERT_NOT_EQUAL(0, strcmp(etag, other));
+
+    const char* list = "\"a,b\", W/\"xyz\"";
+    TEST_ASSERT_TRUE(catzilla_http_etag_matches(list, strlen(list), "\"xyz\"", 5));
+    TEST_ASSERT_TRUE(catzilla_http_etag_matches(list, strlen(list), "\"a,b\"", 5));
+    TEST_ASSERT_FALSE(catzilla_http_etag_matches(list, strlen(list), "\"a\"", 3));
+    TEST_ASSERT_TRUE(catzilla_http_etag_matches("*", 1, "\"anything\"", 10));
+    TEST_ASSERT_FALSE(catzilla_http_etag_matches("xyz", 3, "\"xyz\"", 5));
+}
+
+void test_encode_adds_validators() {
+    size_t size = 0;
+    char* entry = catzilla_http_cache_encode(200, "text/html", "<p>hi</p>", 9, 784111777, &size);
+    TEST_ASSERT_NOT_NULL(entry);
+
+    catzilla_cached_view_t view;
+    TEST_ASSERT_TRUE(catzilla_http_cache_decode(entry, size, &view));
+    TEST_ASSERT_EQUAL(CATZILLA_CACHED_RESPONSE, view.kind);
+    TEST_ASSERT_EQUAL(200, view.status_code);
+    TEST_ASSERT_EQUAL(9, view.body_len);
+    TEST_ASSERT_EQUAL_STRING_LEN("<p>hi</p>", view.body, 9);
+    TEST_ASSERT_EQUAL(784111777, view.last_modified);
+
+    char etag[CATZILLA_ETAG_MAX];
+    catzilla_http_etag("<p>hi</p>", 9, etag);
+    TEST_ASSERT_EQUAL(strlen(etag), view.etag_len);
+    TEST_ASSERT_EQUAL_STRING_LEN(etag, view.etag, view.etag_len);
+
+    size_t length = 0;
+    const char* value = catzilla_header_block_get(view.headers, "content-type", &length);
+    TEST_ASSERT_EQUAL_STRING_LEN("text/html", value, length);
+    value = catzilla_header_block_get(view.headers, "Last-Modified", &length);
+    TEST_ASSERT_EQUAL_STRING_LEN("Sun, 06 Nov 1994 08:49:37 GMT", value, length);
+    catzilla_response_free(entry);
+
+    // Truncated and foreign entries do not decode
+    TEST_ASSERT_FALSE(catzilla_http_cache_decode("junk", 4, &view));
+}
+
+void test_encode_keeps_handler_validators() {
+    const char* headers = "Content-Type: text/plain\r\nDate: Mon, 01 Jan 2024 00:00:00 GMT\r\n"
+                          "ETag: W/\"v1\"\r\nLast-Modified: Mon, 01 Jan 2024 00:00:00 GMT\r\n";
+    size_t size = 0;
+    char* entry = catzilla_http_cache_encode(200, headers, "x", 1, 784111777, &size);
+    TEST_ASSERT_NOT_NULL(entry);
+
+    catzilla_cached_view_t view;
+    TEST_ASSERT_TRUE(catzilla_http_cache_decode(entry, size, &view));
+    TEST_ASSERT_EQUAL_STRING_LEN("W/\"v1\"", view.etag, view.etag_len);
+    TEST_ASSERT_EQUAL(1704067200, view.last_modified);
+    TEST_ASSERT_NULL(catzilla_header_block_get(view.headers, "Date", NULL));
+    TEST_ASSERT_NULL(strstr(view.headers, "ETag: \"")); // No second ETag
+    catzilla_response_free(entry);
+}
+
+void test_conditional_requests() {
+    const char* headers = "Content-Type: text/plain\r\nCache-Control: max-age=60\r\nVary: Accept-Encoding\r\n";
+    size_t size = 0;
+    char* entry = catzilla_http_cache_encode(200, headers, "body", 4, 1704067200, &size);
+    catzilla_cached_view_t view;
+    TEST_ASSERT_TRUE(catzilla_http_cache_decode(entry, size, &view));
+
+    TEST_ASSERT_FALSE(catzilla_http_cache_not_modified(&view, &request));
+
+    char etag[CATZILLA_ETAG_MAX];
+    memcpy(etag, view.etag, view.etag_len);
+    etag[view.etag_len] = '\0';
+    add_header(&request, "If-None-Match", etag);
+    TEST_ASSERT_TRUE(catzilla_http_cache_not_modified(&view, &request));
+
+    // If-None-Match wins over a matching If-Modified-Since
+    catzilla_header_set_reset(&request);
+    add_header(&request, "If-None-Match", "\"stale\"");
+    add_header(&request, "If-Modified-Since", "Mon, 01 Jan 2024 00:00:00 GMT");
+    TEST_ASSERT_FALSE(catzilla_http_cache_not_modified(&view, &request));
+
+    catzilla_header_set_reset(&request);
+    add_header(&request, "If-Modified-Since", "Mon, 01 Jan 2024 00:00:00 GMT");
+    TEST_ASSERT_TRUE(catzilla_http_cache_not_modified(&view, &request));
+    catzilla_header_set_reset(&request);
+    add_header(&request, "If-Modified-Since", "Sun, 31 Dec 2023 23:59:59 GMT");
+    TEST_ASSERT_FALSE(catzilla_http_cache_not_modified(&view, &request));
+
+    char out[512];
+    size_t length = catzilla_http_cache_not_modified_headers(&view, out, view.headers_len + 48);
+    TEST_ASSERT_EQUAL(strlen(out), length);
+    TEST_ASSERT_NOT_NULL(strstr(out, "ETag: \""));
+    TEST_ASSERT_NOT_NULL(strstr(out, "Cache-Control: max-age=60\r\n"));
+    TEST_ASSERT_NOT_NULL(strstr(out, "Vary: Accept-Encoding\r\n"));
+    TEST_ASSERT_NOT_NULL(strstr(out, "Last-Modified: Mon, 01 Jan 2024 00:00:00 GMT\r\n"));
+    TEST_ASSERT_NOT_NULL(strstr(out, "Content-Length: 4\r\n"));
+    TEST_ASSERT_NULL(strstr(out, "Content-Type"));
+    TEST_ASSERT_EQUAL(0, catzilla_http_cache_not_modified_headers(&view, out, 16));
+    catzilla_response_free(entry);
+}
+
+void test_variants_entry() {
+    size_t size = 0;
+    char* entry = catzilla_http_cache_encode_variants("accept-encoding", 15, &size);
+    TEST_ASSERT_NOT_NULL(entry);
+
+    catzilla_cached_view_t view;
+    TEST_ASSERT_TRUE(catzilla_http_cache_decode(entry, size, &view));
+    TEST_ASSERT_EQUAL(CATZILLA_CACHED_VARIANTS, view.kind);
+    TEST_ASSERT_EQUAL_STRING("accept-encoding", view.headers);
+    TEST_ASSERT_FALSE(catzilla_http_cache_not_modified(&view, &request));
+    catzilla_response_free(entry);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_cache_control_decides_storage_and_ttl);
+    RUN_TEST(test_vary_names_are_normalized);
+    RUN_TEST(test_variant_hash_follows_accepted_codings);
+    RUN_TEST(test_etag_weak_comparison);
+    RUN_TEST(test_encode_adds_validators);
+    RUN_TEST(test_encode_keeps_handler_validators);
+    RUN_TEST(test_conditional_requests);
+    RUN_TEST(test_variants_entry);
+
+    return UNITY_END();
+}
@@ -0,0 +1,143 @@
+// tests/c/test_http_headers.c
+#include "unity.h"
+#include "http_headers.h"
+#include "memory.h"
+#include <string.h>
+
+static catzilla_header_set_t set;
+
+void setUp(void) {
+    catzilla_header_set_init(&set);
+}
+
+void tearDown(void) {
+    catzilla_header_set_free(&set);
+}
+
+static void add_header(const char* name, const char* value) {
+    TEST_ASSERT_EQUAL(0, catzilla_header_set_append_name(&set, name, strlen(name)));
+    if (value[0]) {
+        TEST_ASSERT_EQUAL(0, catzilla_header_set_append_value(&set, value, strlen(value)));
+    }
+    catzilla_header_set_commit(&set);
+}
+
+void test_perfect_hash_resolves_every_known_header() {
+    for (int id = 0; id < CATZILLA_HDR_COUNT; id++) {
+        const char* name = catzilla_known_header_name(id);
+        TEST_ASSERT_NOT_NULL(name);
+        TEST_ASSERT_EQUAL(id, catzilla_known_header_lookup(name, strlen(name)));
+    }
+}
+
+void test_perfect_hash_is_case_insensitive() {
+    TEST_ASSERT_EQUAL(CATZILLA_HDR_CONTENT_TYPE, catzilla_known_header_lookup("Content-Type", 12));
+    TEST_ASSERT_EQUAL(CATZILLA_HDR_IF_NONE_MATCH, catzilla_known_header_lookup("IF-NONE-MATCH", 13));
+    TEST_ASSERT_EQUAL(CATZILLA_HDR_HOST, catzilla_known_header_lookup("hOsT", 4));
+}
+
+void test_perfect_hash_rejects_unknown_names() {
+    TEST_ASSERT_EQUAL(CATZILLA_HDR_UNKNOWN, catzilla_known_header_lookup("X-Custom", 8));
+    TEST_ASSERT_EQUAL(CATZILLA_HDR_UNKNOWN, catzilla_known_header_lookup("Hosts", 5));
+    TEST_ASSERT_EQUAL(CATZILLA_HDR_UNKNOWN, catzilla_known_header_lookup("Ho", 2));
+    TEST_ASSERT_EQUAL(CATZILLA_HDR_UNKNOWN, catzilla_known_header_lookup("Content-Typo", 12));
+}
+
+void test_known_and_custom_lookup() {
+    add_header("Host", "example.com");
+    add_header("X-Trace", "abc123");
+    add_header("Authorization", "Bearer t");
+
+    TEST_ASSERT_EQUAL(3, set.count);
+
+    size_t length = 0;
+    TEST_ASSERT_EQUAL_STRING("example.com", catzilla_header_set_get_known(&set, CATZILLA_HDR_HOST, &length));
+    TEST_ASSERT_EQUAL(11, length);
+    TEST_ASSERT_EQUAL_STRING("Bearer t", catzilla_header_set_get(&set, "authorization", NULL));
+    TEST_ASSERT_EQUAL_STRING("abc123", catzilla_header_set_get(&set, "x-trace", NULL));
+    TEST_ASSERT_NULL(catzilla_header_set_get(&set, "Cookie", NULL));
+    TEST_ASSERT_NULL(catzilla_header_set_get(&set, "X-Missing", NULL));
+
+    const catzilla_header_t* header = &set.entries[1];
+    TEST_ASSERT_EQUAL_STRING("X-Trace", catzilla_header_name(&set, header));
+    TEST_ASSERT_EQUAL_STRING("abc123", catzilla_header_value(&set, header));
+}
+
+void test_split_name_and_value_are_stitched() {
+    // The parser may hand over a header in several pieces across reads
+    TEST_ASSERT_EQUAL(0, catzilla_header_set_append_name(&set, "Conte", 5));
+    TEST_ASSERT_EQUAL(0, catzilla_header_set_append_name(&set, "nt-Type", 7));
+    TEST_ASSERT_EQUAL(0, catzilla_header_set_append_value(&set, "application/", 12));
+    TEST_ASSERT_EQUAL(0, catzilla_header_set_append_value(&set, "json", 4));
+    TEST_ASSERT_EQUAL(0, catzilla_header_set_commit(&set));
+
+    TEST_ASSERT_EQUAL_STRING("application/json",
+                             catzilla_header_set_get_known(&set, CATZILLA_HDR_CONTENT_TYPE, NULL));
+}
+
+void test_empty_value_and_first_occurrence() {
+    add_header("Cookie", "a=1");
+    add_header("Cookie", "b=2");
+    add_header("X-Empty", "");
+
+    TEST_ASSERT_EQUAL_STRING("a=1", catzilla_header_set_get_known(&set, CATZILLA_HDR_COOKIE, NULL));
+    TEST_ASSERT_EQUAL_STRING("", catzilla_header_set_get(&set, "X-Empty", NULL));
+}
+
+void test_entry_limit_and_reset() {
+    for (int i = 0; i < CATZILLA_MAX_HEADERS + 5; i++) {
+        add_header("X-Filler", "v");
+    }
+    TEST_ASSERT_EQUAL(CATZILLA_MAX_HEADERS, set.count);
+
+    char* data = set.data;
+    catzilla_header_set_reset(&set);
+    TEST_ASSERT_EQUAL(0, set.count);
+    TEST_ASSERT_NULL(catzilla_header_set_get(&set, "X-Filler", NULL));
+
+    // The data block is kept for the next request on the connection
+    add_header("Host", "reused");
+    TEST_ASSERT_EQUAL_PTR(data, set.data);
+    TEST_ASSERT_EQUAL_STRING("reused", catzilla_header_set_get_known(&set, CATZILLA_HDR_HOST, NULL));
+}
+
+void test_copy_is_independent() {
+    add_header("Accept-Encoding", "gzip");
+    add_header("X-Custom", "yes");
+
+    catzilla_header_set_t copy;
+    catzilla_header_set_init(&copy);
+    TEST_ASSERT_EQUAL(0, catzilla_header_set_copy(&copy, &set));
+    catzilla_header_set_reset(&set);
+    add_header("Accept-Encoding", "br");
+
+    TEST_ASSERT_EQUAL_STRING("gzip", catzilla_header_set_get_known(&copy, CATZILLA_HDR_ACCEPT_ENCODING, NULL));
+    TEST_ASSERT_EQUAL_STRING("yes", catzilla_header_set_get(&copy, "X-Custom", NULL));
+    catzilla_header_set_free(&copy);
+}
+
+void test_data_limit() {
+    static char big[CATZILLA_HEADER_DATA_MAX];
+    memset(big, 'a', sizeof(big));
+    TEST_ASSERT_EQUAL(0, catzilla_header_set_append_name(&set, "X-Big", 5));
+    TEST_ASSERT_EQUAL(-1, catzilla_header_set_append_value(&set, big, sizeof(big)));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    // Perfect hash
+    RUN_TEST(test_perfect_hash_resolves_every_known_header);
+    RUN_TEST(test_perfect_hash_is_case_insensitive);
+    RUN_TEST(test_perfect_hash_rejects_unknown_names);
+
+    // Header sets
+    RUN_TEST(test_known_and_custom_lookup);
+    RUN_TEST(test_split_name_and_value_are_stitched);
+    RUN_TEST(test_empty_value_and_first_occurrence);
+    RUN_TEST(test_entry_limit_and_reset);
+    RUN_TEST(test_copy_is_independent);
+    RUN_TEST(test_data_limit);
+
+    return UNITY_END();
+}
@@ -0,0 +1,110 @@
+// tests/c/test_http_response.c
+#include "unity.h"
+#include "http_response.h"
+#include <string.h>
+#include <stdint.h>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_status_line_common_codes() {
+    size_t len = 0;
+    const char* line = catzilla_http_status_line(200, &len);
+    TEST_ASSERT_EQUAL_STRING("HTTP/1.1 200 OK\r\n", line);
+    TEST_ASSERT_EQUAL(strlen(line), len);
+
+    line = catzilla_http_status_line(404, &len);
+    TEST_ASSERT_EQUAL_STRING("HTTP/1.1 404 Not Found\r\n", line);
+    TEST_ASSERT_EQUAL(strlen(line), len);
+}
+
+void test_status_line_extended_codes() {
+    TEST_ASSERT_EQUAL_STRING("HTTP/1.1 429 Too Many Requests\r\n", catzilla_http_status_line(429, NULL));
+    TEST_ASSERT_EQUAL_STRING("HTTP/1.1 503 Service Unavailable\r\n", catzilla_http_status_line(503, NULL));
+    TEST_ASSERT_EQUAL_STRING("HTTP/1.1 301 Moved Permanently\r\n", catzilla_http_status_line(301, NULL));
+}
+
+void test_status_line_unknown_code() {
+    size_t len = 99;
+    TEST_ASSERT_NULL(catzilla_http_status_line(799, &len));
+    TEST_ASSERT_EQUAL(0, len);
+    TEST_ASSERT_EQUAL_STRING("Unknown", catzilla_http_status_text(799));
+    TEST_ASSERT_EQUAL_STRING("Unprocessable Entity", catzilla_http_status_text(422));
+}
+
+void test_u64toa() {
+    char buf[CATZILLA_U64_DIGITS_MAX];
+    size_t len = catzilla_u64toa(0, buf);
+    TEST_ASSERT_EQUAL(1, len);
+    TEST_ASSERT_EQUAL_STRING_LEN("0", buf, 1);
+
+    len = catzilla_u64toa(7, buf);
+    TEST_ASSERT_EQUAL(1, len);
+    TEST_ASSERT_EQUAL_STRING_LEN("7", buf, 1);
+
+    len = catzilla_u64toa(1234567, buf);
+    TEST_ASSERT_EQUAL(7, len);
+    TEST_ASSERT_EQUAL_STRING_LEN("1234567", buf, 7);
+
+    len = catzilla_u64toa(UINT64_MAX, buf);
+    TEST_ASSERT_EQUAL(20, len);
+    TEST_ASSERT_EQUAL_STRING_LEN("18446744073709551615", buf, 20);
+}
+
+void test_date_header_format() {
+    const char* date = catzilla_date_header();
+    TEST_ASSERT_NOT_NULL(date);
+    TEST_ASSERT_EQUAL(CATZILLA_DATE_HEADER_LEN, strlen(date));
+    TEST_ASSERT_EQUAL_STRING_LEN("Date: ", date, 6);
+    TEST_ASSERT_EQUAL(',', date[9]);
+    TEST_ASSERT_EQUAL_STRING_LEN(" GMT\r\n", date + CATZILLA_DATE_HEADER_LEN - 6, 6);
+}
+
+void test_http_date_round_trip() {
+    char date[CATZILLA_HTTP_DATE_LEN + 1];
+    TEST_ASSERT_EQUAL(CATZILLA_HTTP_DATE_LEN, catzilla_http_date_format(784111777, date));
+    TEST_ASSERT_EQUAL_STRING("Sun, 06 Nov 1994 08:49:37 GMT", date);
+    TEST_ASSERT_EQUAL(784111777, catzilla_http_date_parse(date, strlen(date)));
+
+    // Leap day, and the first second of a year
+    TEST_ASSERT_EQUAL(951782400, catzilla_http_date_parse("Tue, 29 Feb 2000 00:00:00 GMT", 29));
+    TEST_ASSERT_EQUAL(1704067200, catzilla_http_date_parse("Mon, 01 Jan 2024 00:00:00 GMT", 29));
+
+    TEST_ASSERT_EQUAL(-1, catzilla_http_date_parse("Sunday, 06-Nov-94 08:49:37 GMT", 30));
+    TEST_ASSERT_EQUAL(-1, catzilla_http_date_parse("Sun, 06 Foo 1994 08:49:37 GMT", 29));
+    TEST_ASSERT_EQUAL(-1, catzilla_http_date_parse("Sun, 06 Nov 1994 08:49:37 UTC", 29));
+    TEST_ASSERT_EQUAL(-1, catzilla_http_date_parse(NULL, 0));
+}
+
+void test_date_cache_timer() {
+    uv_loop_t loop;
+    uv_timer_t timer;
+    TEST_ASSERT_EQUAL(0, uv_loop_init(&loop));
+    TEST_ASSERT_EQUAL(0, catzilla_date_cache_start(&loop, &timer));
+
+    // Timer is unref'd, so the loop has nothing keeping it alive
+    TEST_ASSERT_EQUAL(0, uv_run(&loop, UV_RUN_NOWAIT));
+    TEST_ASSERT_EQUAL(CATZILLA_DATE_HEADER_LEN, strlen(catzilla_date_header()));
+
+    catzilla_date_cache_stop();
+    uv_close((uv_handle_t*)&timer, NULL);
+    uv_run(&loop, UV_RUN_DEFAULT);
+    TEST_ASSERT_EQUAL(0, uv_loop_close(&loop));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    // Status lines
+    RUN_TEST(test_status_line_common_codes);
+    RUN_TEST(test_status_line_extended_codes);
+    RUN_TEST(test_status_line_unknown_code);
+
+    // Formatting helpers
+    RUN_TEST(test_u64toa);
+    RUN_TEST(test_date_header_format);
+    RUN_TEST(test_http_date_round_trip);
+    RUN_TEST(test_date_cache_timer);
+
+    return UNITY_END();
+}
@@ -1,5 +1,6 @@
 #include "unity.h"
 #include "memory.h"
+#include <stdio.h>
 #include <stdlib.h>
 #ifdef _WIN32
     #include <process.h>
@@ -135,6 +136,40 @@ void test_concurrent_operations(void) {
     }
 }
 
+void test_allocation_profiler_lifecycle(void) {
+    TEST_ASSERT_EQUAL(0, catzilla_memory_init());
+
+    catzilla_profiler_status_t status;
+    catzilla_memory_profiler_get_status(&status);
+    TEST_ASSERT_FALSE(status.active);
+
+    if (!status.available) {
+        // Builds without jemalloc prof refuse every operation
+        TEST_ASSERT_EQUAL(-1, catzilla_memory_profiler_start(0));
+        TEST_ASSERT_EQUAL(-1, catzilla_memory_profiler_dump("/tmp/catzilla_test.heap"));
+        catzilla_memory_profiler_stop();
+        return;
+    }
+
+    TEST_ASSERT_EQUAL(-1, catzilla_memory_profiler_start(41));
+    TEST_ASSERT_EQUAL(0, catzilla_memory_profiler_start(0));
+    catzilla_memory_profiler_get_status(&status);
+    TEST_ASSERT_TRUE(status.active);
+    TEST_ASSERT_EQUAL(CATZILLA_PROFILER_DEFAULT_LG_SAMPLE, status.lg_sample);
+
+    void* ptr = catzilla_request_alloc(1024 * 1024);
+    TEST_ASSERT_NOT_NULL(ptr);
+    catzilla_memory_profiler_stop();
+
+    // Samples taken before the stop can still be dumped
+    TEST_ASSERT_EQUAL(0, catzilla_memory_profiler_dump("/tmp/catzilla_test.heap"));
+    catzilla_memory_profiler_get_status(&status);
+    TEST_ASSERT_FALSE(status.active);
+    TEST_ASSERT_EQUAL(1, status.dumps);
+    catzilla_request_free(ptr);
+    remove("/tmp/catzilla_test.heap");
+}
+
 int main(void) {
     UNITY_BEGIN();
 
@@ -144,6 +179,7 @@ int main(void) {
     RUN_TEST(test_memory_stats);
     RUN_TEST(test_typed_allocations);
     RUN_TEST(test_concurrent_operations);
+    RUN_TEST(test_allocation_profiler_lifecycle);
 
     return UNITY_END();
 }
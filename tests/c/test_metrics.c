@@ -0,0 +1,215 @@
+// tests/c/test_metrics.c
+#include "unity.h"
+#include "metrics.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <uv.h>
+
+void setUp(void) {
+    catzilla_metrics_reset();
+}
+
+void tearDown(void) {
+    catzilla_metrics_reset();
+}
+
+static catzilla_latency_sample_t sample_of(catzilla_route_metrics_t* route, uint64_t queue_ns, uint64_t gil_ns,
+                                           uint64_t handler_ns, uint64_t write_ns) {
+    catzilla_latency_sample_t sample;
+    memset(&sample, 0, sizeof(sample));
+    sample.route = route;
+    sample.durations_ns[CATZILLA_LATENCY_QUEUE] = queue_ns;
+    sample.durations_ns[CATZILLA_LATENCY_GIL] = gil_ns;
+    sample.durations_ns[CATZILLA_LATENCY_HANDLER] = handler_ns;
+    sample.durations_ns[CATZILLA_LATENCY_WRITE] = write_ns;
+    return sample;
+}
+
+void test_buckets_cover_values_in_order() {
+    TEST_ASSERT_EQUAL(0, catzilla_histogram_bucket_index(0));
+    TEST_ASSERT_EQUAL(7, catzilla_histogram_bucket_index(7));
+    TEST_ASSERT_EQUAL(CATZILLA_HISTOGRAM_BUCKETS - 1, catzilla_histogram_bucket_index(CATZILLA_HISTOGRAM_MAX_US));
+    TEST_ASSERT_EQUAL(CATZILLA_HISTOGRAM_BUCKETS - 1, catzilla_histogram_bucket_index(UINT64_MAX));
+    TEST_ASSERT_EQUAL_UINT64(CATZILLA_HISTOGRAM_MAX_US, catzilla_histogram_bucket_upper(CATZILLA_HISTOGRAM_BUCKETS - 1));
+
+    // Each bucket's values run from just past the previous bucket to its upper bound
+    uint64_t lower = 0;
+    for (size_t i = 0; i < CATZILLA_HISTOGRAM_BUCKETS; i++) {
+        uint64_t upper = catzilla_histogram_bucket_upper(i);
+        TEST_ASSERT_TRUE(upper >= lower);
+        TEST_ASSERT_EQUAL(i, catzilla_histogram_bucket_index(lower));
+        TEST_ASSERT_EQUAL(i, catzilla_histogram_bucket_index(upper));
+        // Precision: a bucket is at most 1/8 of its lower bound wide
+        TEST_ASSERT_TRUE((upper - lower) * CATZILLA_HISTOGRAM_SUB_BUCKETS <= lower || upper == lower);
+        lower = upper + 1;
+    }
+}
+
+void test_percentiles_within_bucket_precision() {
+    catzilla_histogram_t histogram;
+    memset(&histogram, 0, sizeof(histogram));
+
+    // 1..1000 microseconds, once each
+    for (uint64_t us = 1; us <= 1000; us++) {
+        catzilla_histogram_record(&histogram, us * 1000);
+    }
+    TEST_ASSERT_EQUAL_UINT64(1000, histogram.count);
+    TEST_ASSERT_EQUAL_UINT64(1000000, histogram.max_ns);
+
+    uint64_t p50 = catzilla_histogram_percentile(&histogram, 50.0);
+    uint64_t p99 = catzilla_histogram_percentile(&histogram, 99.0);
+    TEST_ASSERT_TRUE(p50 >= 500000 && p50 <= 500000 + 500000 / 8 + 1000);
+    TEST_ASSERT_TRUE(p99 >= 990000 && p99 <= 1000000);
+    TEST_ASSERT_EQUAL_UINT64(1000000, catzilla_histogram_percentile(&histogram, 100.0));
+
+    catzilla_histogram_t empty;
+    memset(&empty, 0, sizeof(empty));
+    TEST_ASSERT_EQUAL_UINT64(0, catzilla_histogram_percentile(&empty, 99.0));
+}
+
+void test_route_histograms_are_kept_per_route() {
+    catzilla_route_metrics_t* users = catzilla_metrics_route(3, "GET", "/users/{id}");
+    TEST_ASSERT_NOT_NULL(users);
+    TEST_ASSERT_EQUAL_PTR(users, catzilla_metrics_route(3, "GET", "/ignored"));
+    TEST_ASSERT_EQUAL_STRING("/users/{id}", users->path);
+
+    // IDs past the initial table grow it without moving existing routes
+    catzilla_route_metrics_t* far = catzilla_metrics_route(100, "POST", "/far");
+    TEST_ASSERT_NOT_NULL(far);
+    TEST_ASSERT_EQUAL_PTR(users, catzilla_metrics_route(3, "GET", "/users/{id}"));
+
+    catzilla_latency_sample_t sample = sample_of(users, 1000, 2000, 30000, 4000);
+    catzilla_metrics_record(&sample);
+    catzilla_metrics_record(&sample);
+    catzilla_latency_sample_t untimed = sample_of(NULL, 1, 1, 1, 1);
+    catzilla_metrics_record(&untimed);
+
+    size_t count = 0;
+    catzilla_route_metrics_t* snapshot = catzilla_metrics_snapshot(&count);
+    TEST_ASSERT_EQUAL(2, count);
+    TEST_ASSERT_EQUAL_UINT32(3, snapshot[0].route_id);
+    TEST_ASSERT_EQUAL_UINT32(100, snapshot[1].route_id);
+    TEST_ASSERT_EQUAL_UINT64(2, snapshot[0].phases[CATZILLA_LATENCY_HANDLER].count);
+    TEST_ASSERT_EQUAL_UINT64(60000, snapshot[0].phases[CATZILLA_LATENCY_HANDLER].sum_ns);
+    TEST_ASSERT_EQUAL_UINT64(0, snapshot[1].phases[CATZILLA_LATENCY_WRITE].count);
+    catzilla_metrics_snapshot_free(snapshot);
+}
+
+typedef struct {
+    uint64_t handler_ns;
+    int requests;
+} loop_thread_args_t;
+
+static void record_on_own_loop(void* arg) {
+    loop_thread_args_t* args = arg;
+    catzilla_route_metrics_t* route = catzilla_metrics_route(1, "GET", "/");
+    for (int i = 0; i < args->requests; i++) {
+        catzilla_latency_sample_t sample = sample_of(route, 0, 0, args->handler_ns, 0);
+        catzilla_metrics_record(&sample);
+    }
+}
+
+void test_snapshot_merges_loops() {
+    loop_thread_args_t fast = {10000, 300};
+    loop_thread_args_t slow = {5000000, 100};
+    uv_thread_t threads[2];
+    TEST_ASSERT_EQUAL_INT(0, uv_thread_create(&threads[0], record_on_own_loop, &fast));
+    TEST_ASSERT_EQUAL_INT(0, uv_thread_create(&threads[1], record_on_own_loop, &slow));
+    uv_thread_join(&threads[0]);
+    uv_thread_join(&threads[1]);
+
+    size_t count = 0;
+    catzilla_route_metrics_t* snapshot = catzilla_metrics_snapshot(&count);
+    TEST_ASSERT_EQUAL(1, count);
+    catzilla_histogram_t* handler = &snapshot[0].phases[CATZILLA_LATENCY_HANDLER];
+    TEST_ASSERT_EQUAL_UINT64(400, handler->count);
+    TEST_ASSERT_EQUAL_UINT64(5000000, handler->max_ns);
+    TEST_ASSERT_TRUE(catzilla_histogram_percentile(handler, 50.0) < 20000);
+    TEST_ASSERT_TRUE(catzilla_histogram_percentile(handler, 90.0) >= 4000000);
+    catzilla_metrics_snapshot_free(snapshot);
+}
+
+void test_exposition_format() {
+    catzilla_route_metrics_t* route = catzilla_metrics_route(7, "GET", "/say/\"hi\"");
+    catzilla_latency_sample_t fast = sample_of(route, 20000, 1000, 40000, 2000000);
+    catzilla_latency_sample_t slow = sample_of(route, 20000, 1000, 400000000, 2000000);
+    catzilla_metrics_record(&fast);
+    catzilla_metrics_record(&slow);
+
+    catzilla_metrics_text_t text;
+    catzilla_metrics_text_init(&text);
+    catzilla_metrics_write_value(&text, "catzilla_up", "gauge", "Always 1", 1);
+    catzilla_metrics_write_latency(&text);
+    catzilla_metrics_append(&text, "%c", '\0');
+    TEST_ASSERT_FALSE(text.failed);
+
+    TEST_ASSERT_NOT_NULL(strstr(text.data, "# TYPE catzilla_up gauge\ncatzilla_up 1\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text.data, "# TYPE catzilla_request_phase_seconds histogram\n"));
+    const char* labels = "{method=\"GET\",route=\"/say/\\\"hi\\\"\",phase=\"handler\"";
+    char line[512];
+    snprintf(line, sizeof(line), "catzilla_request_phase_seconds_bucket%s,le=\"0.0001\"} 1\n", labels);
+    TEST_ASSERT_NOT_NULL(strstr(text.data, line));
+    snprintf(line, sizeof(line), "catzilla_request_phase_seconds_bucket%s,le=\"0.25\"} 1\n", labels);
+    TEST_ASSERT_NOT_NULL(strstr(text.data, line));
+    snprintf(line, sizeof(line), "catzilla_request_phase_seconds_bucket%s,le=\"0.5\"} 2\n", labels);
+    TEST_ASSERT_NOT_NULL(strstr(text.data, line));
+    snprintf(line, sizeof(line), "catzilla_request_phase_seconds_bucket%s,le=\"+Inf\"} 2\n", labels);
+    TEST_ASSERT_NOT_NULL(strstr(text.data, line));
+    snprintf(line, sizeof(line), "catzilla_request_phase_seconds_sum%s} 0.400040000\n", labels);
+    TEST_ASSERT_NOT_NULL(strstr(text.data, line));
+    snprintf(line, sizeof(line), "catzilla_request_phase_seconds_count%s} 2\n", labels);
+    TEST_ASSERT_NOT_NULL(strstr(text.data, line));
+
+    catzilla_metrics_text_free(&text);
+}
+
+void test_counter_totals_per_route() {
+    catzilla_metrics_text_t text;
+    catzilla_metrics_text_init(&text);
+    catzilla_route_metrics_t* route = catzilla_metrics_route(4, "GET", "/items");
+
+    // Nothing sampled yet: no counter series at all
+    catzilla_latency_sample_t plain = sample_of(route, 0, 0, 1000, 0);
+    catzilla_metrics_record(&plain);
+    catzilla_metrics_write_counters(&text);
+    TEST_ASSERT_EQUAL(0, text.length);
+
+    catzilla_latency_sample_t counted = sample_of(route, 0, 0, 1000, 0);
+    counted.counted = true;
+    counted.counters.values[CATZILLA_PERF_CYCLES] = 250000;
+    counted.counters.values[CATZILLA_PERF_INSTRUCTIONS] = 400000;
+    counted.counters.values[CATZILLA_PERF_CACHE_MISSES] = 120;
+    catzilla_metrics_record(&counted);
+    catzilla_metrics_record(&counted);
+
+    size_t count = 0;
+    catzilla_route_metrics_t* snapshot = catzilla_metrics_snapshot(&count);
+    TEST_ASSERT_EQUAL(1, count);
+    TEST_ASSERT_EQUAL_UINT64(2, snapshot[0].counted);
+    TEST_ASSERT_EQUAL_UINT64(500000, snapshot[0].counters[CATZILLA_PERF_CYCLES]);
+    TEST_ASSERT_EQUAL_UINT64(3, snapshot[0].phases[CATZILLA_LATENCY_HANDLER].count);
+    catzilla_metrics_snapshot_free(snapshot);
+
+    catzilla_metrics_write_counters(&text);
+    catzilla_metrics_append(&text, "%c", '\0');
+    TEST_ASSERT_NOT_NULL(strstr(text.data, "# TYPE catzilla_handler_cycles_total counter\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text.data, "catzilla_handler_counted_requests_total{method=\"GET\",route=\"/items\"} 2\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text.data, "catzilla_handler_cycles_total{method=\"GET\",route=\"/items\"} 500000\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text.data, "catzilla_handler_instructions_total{method=\"GET\",route=\"/items\"} 800000\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text.data, "catzilla_handler_cache_misses_total{method=\"GET\",route=\"/items\"} 240\n"));
+    catzilla_metrics_text_free(&text);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_buckets_cover_values_in_order);
+    RUN_TEST(test_percentiles_within_bucket_precision);
+    RUN_TEST(test_route_histograms_are_kept_per_route);
+    RUN_TEST(test_snapshot_merges_loops);
+    RUN_TEST(test_exposition_format);
+    RUN_TEST(test_counter_totals_per_route);
+
+    return UNITY_END();
+}
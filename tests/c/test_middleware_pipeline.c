@@ -0,0 +1,258 @@
+// tests/c/test_middleware_pipeline.c
+#include "unity.h"
+#include "middleware.h"
+#include "router.h"
+#include <string.h>
+#include <stdint.h>
+
+static catzilla_router_t router;
+static char call_log[128];
+
+static void log_call(const char* name) {
+    if (call_log[0]) strcat(call_log, ",");
+    strcat(call_log, name);
+}
+
+static int mw_global_auth(catzilla_middleware_context_t* ctx) { log_call("auth"); return CATZILLA_MIDDLEWARE_CONTINUE; }
+static int mw_global_log(catzilla_middleware_context_t* ctx) { log_call("log"); return CATZILLA_MIDDLEWARE_CONTINUE; }
+static int mw_route_cors(catzilla_middleware_context_t* ctx) { log_call("cors"); return CATZILLA_MIDDLEWARE_CONTINUE; }
+static int mw_route_block(catzilla_middleware_context_t* ctx) {
+    log_call("block");
+    catzilla_middleware_set_status(ctx, 403);
+    return CATZILLA_MIDDLEWARE_SKIP_ROUTE;
+}
+static int mw_post_fail(catzilla_middleware_context_t* ctx) { log_call("fail"); return CATZILLA_MIDDLEWARE_ERROR_CODE; }
+static int mw_require_token(catzilla_middleware_context_t* ctx) {
+    log_call("token");
+    if (!catzilla_middleware_get_header(ctx, "Authorization")) {
+        catzilla_middleware_set_error(ctx, 401, "Unauthorized");
+        return CATZILLA_MIDDLEWARE_ERROR_CODE;
+    }
+    return CATZILLA_MIDDLEWARE_CONTINUE;
+}
+static int mw_allow_origin(catzilla_middleware_context_t* ctx) {
+    log_call("origin");
+    return catzilla_middleware_set_header(ctx, "Access-Control-Allow-Origin", "*") == 0
+        ? CATZILLA_MIDDLEWARE_CONTINUE : CATZILLA_MIDDLEWARE_ERROR_CODE;
+}
+
+static int limited_requests;
+static int mw_limit_three(catzilla_middleware_context_t* ctx) {
+    if (++limited_requests > 3) {
+        catzilla_middleware_set_error(ctx, 429, "Too Many Requests");
+        return CATZILLA_MIDDLEWARE_SKIP_ROUTE;
+    }
+    return CATZILLA_MIDDLEWARE_CONTINUE;
+}
+
+static void dummy_handler(void) {}
+
+static catzilla_route_t* route_of(const char* method, const char* path) {
+    catzilla_route_match_t match;
+    TEST_ASSERT_EQUAL(0, catzilla_router_match(&router, method, path, &match));
+    return match.route;
+}
+
+static void add_header(catzilla_request_t* request, const char* name, const char* value) {
+    TEST_ASSERT_EQUAL(0, catzilla_header_set_append_name(&request->headers, name, strlen(name)));
+    TEST_ASSERT_EQUAL(0, catzilla_header_set_append_value(&request->headers, value, strlen(value)));
+    TEST_ASSERT_TRUE(catzilla_header_set_commit(&request->headers) >= 0);
+}
+
+void setUp(void) {
+    TEST_ASSERT_EQUAL(0, catzilla_router_init(&router));
+    call_log[0] = '\0';
+    limited_requests = 0;
+}
+
+void tearDown(void) {
+    catzilla_router_cleanup(&router);
+}
+
+void test_routes_without_middleware_have_no_pipeline() {
+    TEST_ASSERT_TRUE(catzilla_router_add_route(&router, "GET", "/plain", (void*)dummy_handler, NULL, false) > 0);
+    TEST_ASSERT_NULL(route_of("GET", "/plain")->middleware_chain);
+}
+
+void test_global_and_route_middleware_are_merged_by_priority() {
+    catzilla_middleware_chain_t* global = catzilla_middleware_create_chain();
+    TEST_ASSERT_NOT_NULL(global);
+    TEST_ASSERT_EQUAL(0, catzilla_middleware_register(global, mw_global_log, "log", 10,
+                                                      CATZILLA_MIDDLEWARE_PRE_ROUTE | CATZILLA_MIDDLEWARE_POST_ROUTE));
+    TEST_ASSERT_EQUAL(0, catzilla_middleware_register(global, mw_global_auth, "auth", 500,
+                                                      CATZILLA_MIDDLEWARE_PRE_ROUTE));
+
+    // Registered before the global chain: recompiled when it is set
+    void* route_mw[] = { (void*)mw_route_cors };
+    uint32_t priorities[] = { 100 };
+    TEST_ASSERT_TRUE(catzilla_router_add_route_with_middleware(&router, "GET", "/early", (void*)dummy_handler,
+                                                               NULL, false, route_mw, 1, priorities) > 0);
+    TEST_ASSERT_TRUE(catzilla_router_add_route(&router, "GET", "/bare", (void*)dummy_handler, NULL, false) > 0);
+    TEST_ASSERT_EQUAL(0, catzilla_router_set_global_middleware(&router, global));
+
+    catzilla_route_middleware_t* early = route_of("GET", "/early")->middleware_chain;
+    TEST_ASSERT_NOT_NULL(early);
+    TEST_ASSERT_EQUAL(3, early->pre_count);
+    TEST_ASSERT_EQUAL(1, early->post_count);
+    TEST_ASSERT_EQUAL(CATZILLA_MIDDLEWARE_PRE_ROUTE | CATZILLA_MIDDLEWARE_POST_ROUTE, early->phases);
+
+    catzilla_route_middleware_t* bare = route_of("GET", "/bare")->middleware_chain;
+    TEST_ASSERT_NOT_NULL(bare);
+    TEST_ASSERT_EQUAL(2, bare->pre_count);
+
+    catzilla_request_t request;
+    memset(&request, 0, sizeof(request));
+    catzilla_middleware_context_t* ctx = catzilla_middleware_context_create(&request, NULL, 4);
+    TEST_ASSERT_NOT_NULL(ctx);
+    TEST_ASSERT_EQUAL(0, catzilla_middleware_execute_per_route(early, ctx, NULL));
+    TEST_ASSERT_EQUAL(0, catzilla_middleware_execute_post_route(early, ctx));
+    TEST_ASSERT_EQUAL_STRING("log,cors,auth,log", call_log);
+
+    catzilla_arena_reset(&request.arena);
+    catzilla_router_set_global_middleware(&router, NULL);
+    catzilla_middleware_destroy_chain(global);
+}
+
+void test_skip_route_ends_the_pre_route_phase() {
+    void* route_mw[] = { (void*)mw_route_block, (void*)mw_route_cors };
+    TEST_ASSERT_TRUE(catzilla_router_add_route_with_middleware(&router, "POST", "/admin", (void*)dummy_handler,
+                                                               NULL, false, route_mw, 2, NULL) > 0);
+    catzilla_route_middleware_t* chain = route_of("POST", "/admin")->middleware_chain;
+    TEST_ASSERT_EQUAL(CATZILLA_MIDDLEWARE_PRE_ROUTE, chain->phases);
+
+    catzilla_request_t request;
+    memset(&request, 0, sizeof(request));
+    catzilla_middleware_context_t* ctx = catzilla_middleware_context_create(&request, NULL, 2);
+    TEST_ASSERT_EQUAL(0, catzilla_middleware_execute_per_route(chain, ctx, NULL));
+    TEST_ASSERT_TRUE(ctx->should_skip_route);
+    TEST_ASSERT_EQUAL(403, ctx->response_status);
+    TEST_ASSERT_EQUAL_STRING("block", call_log);
+
+    // No post-route steps: the phase is a no-op
+    TEST_ASSERT_EQUAL(0, catzilla_middleware_execute_post_route(chain, ctx));
+    catzilla_arena_reset(&request.arena);
+}
+
+void test_post_route_steps_all_run_after_an_error() {
+    catzilla_middleware_chain_t* global = catzilla_middleware_create_chain();
+    catzilla_middleware_register(global, mw_post_fail, "fail", 1, CATZILLA_MIDDLEWARE_POST_ROUTE);
+    catzilla_middleware_register(global, mw_global_log, "log", 2, CATZILLA_MIDDLEWARE_POST_ROUTE);
+    TEST_ASSERT_EQUAL(0, catzilla_router_set_global_middleware(&router, global));
+    TEST_ASSERT_TRUE(catzilla_router_add_route(&router, "GET", "/late", (void*)dummy_handler, NULL, false) > 0);
+
+    catzilla_route_middleware_t* chain = route_of("GET", "/late")->middleware_chain;
+    TEST_ASSERT_NOT_NULL(chain);
+    TEST_ASSERT_EQUAL(CATZILLA_MIDDLEWARE_POST_ROUTE, chain->phases);
+
+    catzilla_request_t request;
+    memset(&request, 0, sizeof(request));
+    catzilla_middleware_context_t* ctx = catzilla_middleware_context_create(&request, NULL, 2);
+    TEST_ASSERT_EQUAL(0, catzilla_middleware_execute_per_route(chain, ctx, NULL));
+    TEST_ASSERT_EQUAL(-1, catzilla_middleware_execute_post_route(chain, ctx));
+    TEST_ASSERT_EQUAL_STRING("fail,log", call_log);
+
+    catzilla_arena_reset(&request.arena);
+    catzilla_router_set_global_middleware(&router, NULL);
+    catzilla_middleware_destroy_chain(global);
+}
+
+void test_context_lives_in_the_request_arena() {
+    catzilla_request_t request;
+    memset(&request, 0, sizeof(request));
+
+    catzilla_middleware_context_t* ctx = catzilla_middleware_context_create(&request, NULL, 3);
+    TEST_ASSERT_NOT_NULL(ctx);
+    TEST_ASSERT_EQUAL_PTR(&request.arena, ctx->arena);
+    TEST_ASSERT_TRUE(ctx->should_continue);
+    TEST_ASSERT_NULL(ctx->response_headers);
+    TEST_ASSERT_NULL(ctx->middleware_data);
+    TEST_ASSERT_EQUAL(0, ctx->middleware_timings[2]);
+    // Small enough to stay in an arena block
+    TEST_ASSERT_TRUE(request.arena.bytes < CATZILLA_ARENA_LARGE_THRESHOLD);
+
+    TEST_ASSERT_EQUAL(0, catzilla_middleware_set_header(ctx, "X-Trace", "abc"));
+    TEST_ASSERT_EQUAL_STRING("X-Trace", ctx->response_headers[0].name);
+    int marker = 7;
+    catzilla_middleware_set_data(ctx, 5, &marker);
+    TEST_ASSERT_EQUAL_PTR(&marker, catzilla_middleware_get_data(ctx, 5));
+    TEST_ASSERT_NULL(catzilla_middleware_get_data(ctx, 6));
+    catzilla_middleware_set_error(ctx, 400, "bad input");
+    TEST_ASSERT_EQUAL_STRING("bad input", ctx->error_message);
+
+    catzilla_arena_reset(&request.arena);
+    TEST_ASSERT_NULL(catzilla_middleware_context_create(NULL, NULL, 0));
+}
+
+void test_pre_route_error_stops_the_chain() {
+    void* route_mw[] = { (void*)mw_require_token, (void*)mw_allow_origin };
+    TEST_ASSERT_TRUE(catzilla_router_add_route_with_middleware(&router, "GET", "/api/protected", (void*)dummy_handler,
+                                                               NULL, false, route_mw, 2, NULL) > 0);
+    catzilla_route_middleware_t* chain = route_of("GET", "/api/protected")->middleware_chain;
+
+    catzilla_request_t request;
+    memset(&request, 0, sizeof(request));
+    catzilla_header_set_init(&request.headers);
+    catzilla_middleware_context_t* ctx = catzilla_middleware_context_create(&request, NULL, 2);
+    TEST_ASSERT_EQUAL(-1, catzilla_middleware_execute_per_route(chain, ctx, NULL));
+    TEST_ASSERT_EQUAL(401, ctx->error_code);
+    TEST_ASSERT_EQUAL(401, ctx->response_status);
+    TEST_ASSERT_EQUAL_STRING("Unauthorized", ctx->error_message);
+    TEST_ASSERT_EQUAL(0, ctx->response_header_count);
+    TEST_ASSERT_EQUAL_STRING("token", call_log);
+    catzilla_arena_reset(&request.arena);
+
+    // With a token the rest of the chain runs and sets its header
+    call_log[0] = '\0';
+    add_header(&request, "Authorization", "Bearer test-token");
+    ctx = catzilla_middleware_context_create(&request, NULL, 2);
+    TEST_ASSERT_EQUAL(0, catzilla_middleware_execute_per_route(chain, ctx, NULL));
+    TEST_ASSERT_EQUAL(0, ctx->error_code);
+    TEST_ASSERT_EQUAL(1, ctx->response_header_count);
+    TEST_ASSERT_EQUAL_STRING("Access-Control-Allow-Origin", ctx->response_headers[0].name);
+    TEST_ASSERT_EQUAL_STRING("*", ctx->response_headers[0].value);
+    TEST_ASSERT_EQUAL_STRING("token,origin", call_log);
+
+    catzilla_arena_reset(&request.arena);
+    catzilla_header_set_free(&request.headers);
+}
+
+void test_limit_middleware_skips_the_route_once_exhausted() {
+    void* route_mw[] = { (void*)mw_limit_three, (void*)mw_route_cors };
+    TEST_ASSERT_TRUE(catzilla_router_add_route_with_middleware(&router, "GET", "/api/limited", (void*)dummy_handler,
+                                                               NULL, false, route_mw, 2, NULL) > 0);
+    catzilla_route_middleware_t* chain = route_of("GET", "/api/limited")->middleware_chain;
+
+    int served = 0;
+    int limited = 0;
+    for (int i = 0; i < 5; i++) {
+        catzilla_request_t request;
+        memset(&request, 0, sizeof(request));
+        catzilla_middleware_context_t* ctx = catzilla_middleware_context_create(&request, NULL, 2);
+        TEST_ASSERT_EQUAL(0, catzilla_middleware_execute_per_route(chain, ctx, NULL));
+        if (ctx->should_skip_route) {
+            TEST_ASSERT_EQUAL(429, ctx->response_status);
+            limited++;
+        } else {
+            served++;
+        }
+        catzilla_arena_reset(&request.arena);
+    }
+
+    TEST_ASSERT_EQUAL(3, served);
+    TEST_ASSERT_EQUAL(2, limited);
+    TEST_ASSERT_EQUAL_STRING("cors,cors,cors", call_log);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_routes_without_middleware_have_no_pipeline);
+    RUN_TEST(test_global_and_route_middleware_are_merged_by_priority);
+    RUN_TEST(test_skip_route_ends_the_pre_route_phase);
+    RUN_TEST(test_post_route_steps_all_run_after_an_error);
+    RUN_TEST(test_context_lives_in_the_request_arena);
+    RUN_TEST(test_pre_route_error_stops_the_chain);
+    RUN_TEST(test_limit_middleware_skips_the_route_once_exhausted);
+
+    return UNITY_END();
+}
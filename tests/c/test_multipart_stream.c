@@ -0,0 +1,296 @@
+// tests/c/test_multipart_stream.c
+#include "unity.h"
+#include "upload_parser.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define CONTENT_TYPE "multipart/form-data; boundary=XyZ"
+
+// File data that looks like the start of a delimiter in several places
+static const char tricky_data[] = "line\r\n--Xy\r\n-\n--XyA\r\r\n--xyz\r";
+#define TRICKY_LEN (sizeof(tricky_data) - 1)
+
+static multipart_parser_t parser;
+
+static size_t build_body(char* body, const char* eol) {
+    size_t length = (size_t)sprintf(body,
+        "preamble%s"
+        "--XyZ%s"
+        "Content-Disposition: form-data; name=\"title\"%s"
+        "%s"
+        "hello%s"
+        "--XyZ  %s"
+        "Content-Disposition: form-data; name=\"upload\"; filename=\"a.bin\"%s"
+        "Content-Type: application/octet-stream%s"
+        "%s",
+        eol, eol, eol, eol, eol, eol, eol, eol, eol);
+    memcpy(body + length, tricky_data, TRICKY_LEN);
+    length += TRICKY_LEN;
+    length += (size_t)sprintf(body + length, "%s--XyZ--%sepilogue --XyZ", eol, eol);
+    return length;
+}
+
+static void feed(const char* body, size_t length, size_t split) {
+    TEST_ASSERT_EQUAL(0, catzilla_multipart_parse_init(&parser, CONTENT_TYPE));
+    if (split > 0 && split < length) {
+        TEST_ASSERT_EQUAL(0, catzilla_multipart_parse_chunk(&parser, body, split));
+        TEST_ASSERT_EQUAL(0, catzilla_multipart_parse_chunk(&parser, body + split, length - split));
+    } else {
+        TEST_ASSERT_EQUAL(0, catzilla_multipart_parse_chunk(&parser, body, length));
+    }
+    TEST_ASSERT_EQUAL(0, catzilla_multipart_parse_complete(&parser));
+}
+
+static void assert_parts(size_t file_length) {
+    TEST_ASSERT_EQUAL(2, parser.files_count);
+    catzilla_upload_file_t* field = parser.files[0];
+    TEST_ASSERT_EQUAL_STRING("title", field->field_name);
+    TEST_ASSERT_NULL(field->filename);
+    TEST_ASSERT_EQUAL(5, field->size);
+    TEST_ASSERT_EQUAL_MEMORY("hello", field->content, 5);
+
+    catzilla_upload_file_t* file = parser.files[1];
+    TEST_ASSERT_EQUAL_STRING("upload", file->field_name);
+    TEST_ASSERT_EQUAL_STRING("a.bin", file->filename);
+    TEST_ASSERT_EQUAL_STRING("application/octet-stream", file->content_type);
+    TEST_ASSERT_EQUAL(file_length, file->size);
+    TEST_ASSERT_EQUAL_MEMORY(tricky_data, file->content, file_length);
+    TEST_ASSERT_EQUAL(UPLOAD_STATE_COMPLETE, file->state);
+}
+
+void setUp(void) {
+    memset(&parser, 0, sizeof(parser));
+}
+
+void tearDown(void) {
+    catzilla_multipart_parser_cleanup(&parser);
+}
+
+void test_whole_body() {
+    char body[1024];
+    size_t length = build_body(body, "\r\n");
+    feed(body, length, 0);
+    assert_parts(TRICKY_LEN);
+    TEST_ASSERT_EQUAL(MULTIPART_STATE_END, parser.state);
+}
+
+void test_every_split_offset() {
+    // Delimiters and headers cut at any byte must parse the same
+    char body[1024];
+    size_t length = build_body(body, "\r\n");
+    for (size_t split = 1; split < length; split++) {
+        feed(body, length, split);
+        assert_parts(TRICKY_LEN);
+        catzilla_multipart_parser_cleanup(&parser);
+    }
+}
+
+void test_one_byte_at_a_time() {
+    char body[1024];
+    size_t length = build_body(body, "\r\n");
+    TEST_ASSERT_EQUAL(0, catzilla_multipart_parse_init(&parser, CONTENT_TYPE));
+    for (size_t i = 0; i < length; i++) {
+        TEST_ASSERT_EQUAL(0, catzilla_multipart_parse_chunk(&parser, body + i, 1));
+    }
+    TEST_ASSERT_EQUAL(0, catzilla_multipart_parse_complete(&parser));
+    assert_parts(TRICKY_LEN);
+}
+
+void test_bare_lf_line_endings() {
+    char body[1024];
+    size_t length = build_body(body, "\n");
+    for (size_t split = 0; split < length; split += 7) {
+        feed(body, length, split);
+        // The data's last '\r' reads as the start of a CRLF delimiter
+        assert_parts(TRICKY_LEN - 1);
+        catzilla_multipart_parser_cleanup(&parser);
+    }
+}
+
+void test_large_file_spills_to_temp_file() {
+    // 256KB of data crossing the SIMD scan blocks, sent in uneven chunks
+    size_t data_length = 256 * 1024;
+    char* data = malloc(data_length);
+    for (size_t i = 0; i < data_length; i++) {
+        data[i] = (i % 97 == 0) ? '\n' : (i % 89 == 0) ? '-' : (char)('a' + i % 26);
+    }
+
+    const char* head = "--XyZ\r\nContent-Disposition: form-data; name=\"f\"; filename=\"big.txt\"\r\n\r\n";
+    const char* tail = "\r\n--XyZ--\r\n";
+    size_t length = strlen(head) + data_length + strlen(tail);
+    char* body = malloc(length);
+    memcpy(body, head, strlen(head));
+    memcpy(body + strlen(head), data, data_length);
+    memcpy(body + strlen(head) + data_length, tail, strlen(tail));
+
+    TEST_ASSERT_EQUAL(0, catzilla_multipart_parse_init(&parser, CONTENT_TYPE));
+    parser.spill_threshold = 4096;
+    size_t chunk = 1;
+    for (size_t pos = 0; pos < length; pos += chunk, chunk = chunk * 3 % 5000 + 1) {
+        size_t take = length - pos < chunk ? length - pos : chunk;
+        TEST_ASSERT_EQUAL(0, catzilla_multipart_parse_chunk(&parser, body + pos, take));
+    }
+    TEST_ASSERT_EQUAL(0, catzilla_multipart_parse_complete(&parser));
+
+    TEST_ASSERT_EQUAL(1, parser.files_count);
+    catzilla_upload_file_t* file = parser.files[0];
+    TEST_ASSERT_NULL(file->content);
+    TEST_ASSERT_NOT_NULL(file->temp_file_path);
+    TEST_ASSERT_EQUAL(data_length, file->size);
+
+    FILE* spilled = fopen(file->temp_file_path, "rb");
+    TEST_ASSERT_NOT_NULL(spilled);
+    char* read_back = malloc(data_length + 1);
+    TEST_ASSERT_EQUAL(data_length, fread(read_back, 1, data_length + 1, spilled));
+    fclose(spilled);
+    TEST_ASSERT_EQUAL_MEMORY(data, read_back, data_length);
+
+    // The temp file goes away with the last reference
+    char path[64];
+    strncpy(path, file->temp_file_path, sizeof(path) - 1);
+    path[sizeof(path) - 1] = '\0';
+    catzilla_multipart_parser_cleanup(&parser);
+    TEST_ASSERT_NOT_EQUAL(0, access(path, F_OK));
+
+    free(read_back);
+    free(body);
+    free(data);
+}
+
+void test_form_fields_stay_in_memory() {
+    const char* body = "--XyZ\r\nContent-Disposition: form-data; name=\"note\"\r\n\r\n"
+                       "0123456789abcdef\r\n--XyZ--";
+    TEST_ASSERT_EQUAL(0, catzilla_multipart_parse_init(&parser, CONTENT_TYPE));
+    parser.spill_threshold = 4;
+    TEST_ASSERT_EQUAL(0, catzilla_multipart_parse_chunk(&parser, body, strlen(body)));
+    TEST_ASSERT_EQUAL(0, catzilla_multipart_parse_complete(&parser));
+    TEST_ASSERT_EQUAL(1, parser.files_count);
+    TEST_ASSERT_NULL(parser.files[0]->temp_file_path);
+    TEST_ASSERT_EQUAL_MEMORY("0123456789abcdef", parser.files[0]->content, 16);
+}
+
+void test_missing_closing_delimiter_keeps_data() {
+    const char* body = "--XyZ\r\nContent-Disposition: form-data; name=\"x\"\r\n\r\ncut off\r\n--X";
+    TEST_ASSERT_EQUAL(0, catzilla_multipart_parse_init(&parser, CONTENT_TYPE));
+    TEST_ASSERT_EQUAL(0, catzilla_multipart_parse_chunk(&parser, body, strlen(body)));
+    TEST_ASSERT_EQUAL(0, catzilla_multipart_parse_complete(&parser));
+    TEST_ASSERT_EQUAL(1, parser.files_count);
+    TEST_ASSERT_EQUAL(strlen("cut off\r\n--X"), parser.files[0]->size);
+    TEST_ASSERT_EQUAL_MEMORY("cut off\r\n--X", parser.files[0]->content, parser.files[0]->size);
+}
+
+void test_malformed_input_is_rejected() {
+    TEST_ASSERT_EQUAL(0, catzilla_multipart_parse_init(&parser, CONTENT_TYPE));
+    TEST_ASSERT_EQUAL(-1, catzilla_multipart_parse_chunk(&parser, "--XyZ-x\r\n", 9));
+    TEST_ASSERT_EQUAL(-1, catzilla_multipart_parse_complete(&parser));
+    catzilla_multipart_parser_cleanup(&parser);
+
+    // Part headers are bounded
+    TEST_ASSERT_EQUAL(0, catzilla_multipart_parse_init(&parser, CONTENT_TYPE));
+    TEST_ASSERT_EQUAL(0, catzilla_multipart_parse_chunk(&parser, "--XyZ\r\n", 7));
+    char header[1024];
+    memset(header, 'h', sizeof(header));
+    int rc = 0;
+    for (int i = 0; i < 20 && rc == 0; i++) {
+        rc = catzilla_multipart_parse_chunk(&parser, header, sizeof(header));
+    }
+    TEST_ASSERT_EQUAL(-1, rc);
+    catzilla_multipart_parser_cleanup(&parser);
+
+    TEST_ASSERT_EQUAL(-1, catzilla_multipart_parse_init(&parser, "multipart/form-data"));
+}
+
+void test_digests_follow_the_chunks() {
+    char body[1024];
+    size_t length = build_body(body, "\r\n");
+    for (size_t split = 1; split < length; split += 5) {
+        TEST_ASSERT_EQUAL(0, catzilla_multipart_parse_init(&parser, CONTENT_TYPE));
+        parser.digest_algorithms = CATZILLA_DIGEST_SHA256 | CATZILLA_DIGEST_CRC32C;
+        TEST_ASSERT_EQUAL(0, catzilla_multipart_parse_chunk(&parser, body, split));
+        TEST_ASSERT_EQUAL(0, catzilla_multipart_parse_chunk(&parser, body + split, length - split));
+        TEST_ASSERT_EQUAL(0, catzilla_multipart_parse_complete(&parser));
+        assert_parts(TRICKY_LEN);
+
+        catzilla_upload_digest_t* digest = &parser.files[1]->digest;
+        TEST_ASSERT_TRUE(digest->complete);
+        TEST_ASSERT_EQUAL_HEX32(catzilla_crc32c(0, tricky_data, TRICKY_LEN), digest->crc32c);
+        catzilla_sha256_t sha;
+        uint8_t expected[CATZILLA_SHA256_SIZE];
+        catzilla_sha256_init(&sha);
+        catzilla_sha256_update(&sha, tricky_data, TRICKY_LEN);
+        catzilla_sha256_final(&sha, expected);
+        TEST_ASSERT_EQUAL_MEMORY(expected, digest->sha256, CATZILLA_SHA256_SIZE);
+        TEST_ASSERT_EQUAL_HEX32(catzilla_crc32c(0, "hello", 5), parser.files[0]->digest.crc32c);
+        catzilla_multipart_parser_cleanup(&parser);
+    }
+}
+
+void test_direct_io_spill_is_trimmed_to_size() {
+    // Not a multiple of the direct I/O alignment, and bigger than both buffers
+    size_t data_length = 3 * 1024 * 1024 + 1234;
+    char* data = malloc(data_length);
+    for (size_t i = 0; i < data_length; i++) {
+        data[i] = (char)('a' + (i * 7 + i / 4093) % 26);
+    }
+    const char* head = "--XyZ\r\nContent-Disposition: form-data; name=\"f\"; filename=\"big.bin\"\r\n\r\n";
+    const char* tail = "\r\n--XyZ--\r\n";
+    size_t length = strlen(head) + data_length + strlen(tail);
+    char* body = malloc(length);
+    memcpy(body, head, strlen(head));
+    memcpy(body + strlen(head), data, data_length);
+    memcpy(body + strlen(head) + data_length, tail, strlen(tail));
+
+    TEST_ASSERT_EQUAL(0, catzilla_multipart_parse_init(&parser, CONTENT_TYPE));
+    parser.spill_threshold = 4096;
+    parser.direct_io = true;
+    parser.body_length = length;
+    parser.digest_algorithms = CATZILLA_DIGEST_CRC32C;
+    for (size_t pos = 0; pos < length; pos += 65536) {
+        size_t take = length - pos < 65536 ? length - pos : 65536;
+        TEST_ASSERT_EQUAL(0, catzilla_multipart_parse_chunk(&parser, body + pos, take));
+    }
+    TEST_ASSERT_EQUAL(0, catzilla_multipart_parse_complete(&parser));
+
+    catzilla_upload_file_t* file = parser.files[0];
+    TEST_ASSERT_NOT_NULL(file->temp_file_path);
+    TEST_ASSERT_NULL(file->sink);
+    TEST_ASSERT_EQUAL(data_length, file->size);
+    TEST_ASSERT_EQUAL_HEX32(catzilla_crc32c(0, data, data_length), file->digest.crc32c);
+
+    // Alignment padding and unused preallocation are gone
+    struct stat st;
+    TEST_ASSERT_EQUAL(0, stat(file->temp_file_path, &st));
+    TEST_ASSERT_EQUAL(data_length, st.st_size);
+    TEST_ASSERT_TRUE((uint64_t)st.st_blocks * 512 < data_length + 1024 * 1024);
+
+    FILE* spilled = fopen(file->temp_file_path, "rb");
+    TEST_ASSERT_NOT_NULL(spilled);
+    char* read_back = malloc(data_length + 1);
+    TEST_ASSERT_EQUAL(data_length, fread(read_back, 1, data_length + 1, spilled));
+    fclose(spilled);
+    TEST_ASSERT_EQUAL_MEMORY(data, read_back, data_length);
+
+    free(read_back);
+    free(body);
+    free(data);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_whole_body);
+    RUN_TEST(test_every_split_offset);
+    RUN_TEST(test_one_byte_at_a_time);
+    RUN_TEST(test_bare_lf_line_endings);
+    RUN_TEST(test_large_file_spills_to_temp_file);
+    RUN_TEST(test_form_fields_stay_in_memory);
+    RUN_TEST(test_missing_closing_delimiter_keeps_data);
+    RUN_TEST(test_malformed_input_is_rejected);
+    RUN_TEST(test_digests_follow_the_chunks);
+    RUN_TEST(test_direct_io_spill_is_trimmed_to_size);
+
+    return UNITY_END();
+}
@@ -0,0 +1,298 @@
+// tests/c/test_pattern.c
+#include "unity.h"
+#include "pattern.h"
+#include "validation.h"
+#include "memory.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifndef _WIN32
+#include <regex.h>
+#endif
+
+void setUp(void) {
+    catzilla_memory_init();
+}
+
+void tearDown(void) {
+}
+
+static bool matches(const char* pattern_text, const char* str) {
+    catzilla_pattern_t* pattern = catzilla_pattern_compile(pattern_text);
+    TEST_ASSERT_NOT_NULL_MESSAGE(pattern, pattern_text);
+    bool result = catzilla_pattern_match(pattern, str, strlen(str));
+    catzilla_pattern_free(pattern);
+    return result;
+}
+
+static bool compiles(const char* pattern_text) {
+    catzilla_pattern_t* pattern = catzilla_pattern_compile(pattern_text);
+    catzilla_pattern_free(pattern);
+    return pattern != NULL;
+}
+
+void test_literals_search_unless_anchored(void) {
+    TEST_ASSERT_TRUE(matches("abc", "xxabcxx"));
+    TEST_ASSERT_FALSE(matches("abc", "abxc"));
+    TEST_ASSERT_TRUE(matches("^abc", "abcxx"));
+    TEST_ASSERT_FALSE(matches("^abc", "xabc"));
+    TEST_ASSERT_TRUE(matches("abc$", "xxabc"));
+    TEST_ASSERT_FALSE(matches("abc$", "abcx"));
+    TEST_ASSERT_TRUE(matches("^abc$", "abc"));
+    TEST_ASSERT_FALSE(matches("^abc$", "abcabc"));
+    TEST_ASSERT_TRUE(matches("^$", ""));
+    TEST_ASSERT_TRUE(matches("a\\$", "a$b"));
+}
+
+void test_classes_and_shorthands(void) {
+    TEST_ASSERT_TRUE(matches("^[a-c_]+$", "ab_c"));
+    TEST_ASSERT_FALSE(matches("^[a-c_]+$", "abd"));
+    TEST_ASSERT_TRUE(matches("^[^0-9]+$", "abc"));
+    TEST_ASSERT_FALSE(matches("^[^0-9]+$", "ab1"));
+    TEST_ASSERT_TRUE(matches("^[]a]+$", "]a]"));
+    TEST_ASSERT_TRUE(matches("^[a-]+$", "a-a"));
+    TEST_ASSERT_TRUE(matches("^[[:alpha:][:digit:]]+$", "abC9"));
+    TEST_ASSERT_FALSE(matches("^[[:alpha:]]+$", "ab9"));
+    TEST_ASSERT_TRUE(matches("^\\d{3}-\\w+\\s\\S$", "123-ab_9 x"));
+    TEST_ASSERT_FALSE(matches("^\\d{3}$", "12a"));
+    TEST_ASSERT_TRUE(matches("^\\D+$", "abc"));
+    TEST_ASSERT_TRUE(matches("^a\\.b$", "a.b"));
+    TEST_ASSERT_FALSE(matches("^a\\.b$", "axb"));
+}
+
+void test_groups_alternation_and_repetition(void) {
+    TEST_ASSERT_TRUE(matches("^(cat|dog)s?$", "cats"));
+    TEST_ASSERT_TRUE(matches("^(cat|dog)s?$", "dog"));
+    TEST_ASSERT_FALSE(matches("^(cat|dog)s?$", "cow"));
+    TEST_ASSERT_TRUE(matches("^(?:ab){2,3}$", "ababab"));
+    TEST_ASSERT_FALSE(matches("^(?:ab){2,3}$", "ab"));
+    TEST_ASSERT_FALSE(matches("^(?:ab){2,3}$", "abababab"));
+    TEST_ASSERT_TRUE(matches("^(?P<year>\\d{4})-\\d{2}$", "2024-06"));
+    TEST_ASSERT_TRUE(matches("^a{2,}$", "aaaa"));
+    TEST_ASSERT_FALSE(matches("^a{2,}$", "a"));
+    TEST_ASSERT_TRUE(matches("^a+?b*?$", "aab"));
+    TEST_ASSERT_TRUE(matches("cat|dog", "hotdog"));
+    TEST_ASSERT_TRUE(matches("^(a|)$", ""));
+}
+
+void test_dot_and_negated_classes_match_whole_utf8_characters(void) {
+    TEST_ASSERT_TRUE(matches("^.{3}$", "\xC3\xA9t\xC3\xA9"));
+    TEST_ASSERT_FALSE(matches("^.{2}$", "\xC3\xA9t\xC3\xA9"));
+    TEST_ASSERT_TRUE(matches("^[^a]$", "\xE2\x82\xAC"));
+    TEST_ASSERT_TRUE(matches("^\xC3\xA9+$", "\xC3\xA9\xC3\xA9"));
+    TEST_ASSERT_FALSE(matches("^\xC3\xA9+$", "\xC3\xA9\xA9"));
+}
+
+void test_unsupported_patterns_are_left_to_posix_regex(void) {
+    TEST_ASSERT_FALSE(compiles("(a)\\1"));          // Back-reference
+    TEST_ASSERT_FALSE(compiles("\\bword\\b"));      // Word boundary
+    TEST_ASSERT_FALSE(compiles("(?=a)b"));          // Lookahead
+    TEST_ASSERT_FALSE(compiles("^a|b"));            // Anchor binds to one branch
+    TEST_ASSERT_FALSE(compiles("a^b"));
+    TEST_ASSERT_FALSE(compiles("[\xC3\xA9]"));      // Non-ASCII class member
+    TEST_ASSERT_FALSE(compiles("a**"));
+    TEST_ASSERT_FALSE(compiles("a{3,2}"));
+    TEST_ASSERT_FALSE(compiles("a{1001}"));
+    TEST_ASSERT_FALSE(compiles("(ab"));
+    TEST_ASSERT_FALSE(compiles("[ab"));
+    // The DFA for (a|b)*a(a|b){n} doubles with n
+    TEST_ASSERT_FALSE(compiles("(a|b)*a(a|b){12}$"));
+    TEST_ASSERT_TRUE(compiles("(a|b)*a(a|b){4}$"));
+}
+
+void test_catastrophic_patterns_run_in_linear_time(void) {
+    catzilla_pattern_t* pattern = catzilla_pattern_compile("^(a+)+$");
+    TEST_ASSERT_NOT_NULL(pattern);
+
+    size_t length = 100000;
+    char* input = malloc(length + 2);
+    memset(input, 'a', length);
+    input[length] = 'b';
+    input[length + 1] = '\0';
+
+    clock_t start = clock();
+    TEST_ASSERT_FALSE(catzilla_pattern_match(pattern, input, length + 1));
+    TEST_ASSERT_TRUE(catzilla_pattern_match(pattern, input, length));
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    TEST_ASSERT_TRUE(seconds < 1.0);
+    TEST_ASSERT_TRUE(catzilla_pattern_state_count(pattern) < 8);
+
+    free(input);
+    catzilla_pattern_free(pattern);
+}
+
+void test_whole_string_classes_become_charset_checks(void) {
+    catzilla_pattern_t* digits = catzilla_pattern_compile("^[0-9]{4,40}$");
+    TEST_ASSERT_NOT_NULL(digits);
+    TEST_ASSERT_EQUAL(0, catzilla_pattern_state_count(digits));
+
+    // Long enough to go through the 16-byte blocks and the scalar tail
+    const char* ok = "0123456789012345678901234567890123";
+    TEST_ASSERT_TRUE(catzilla_pattern_match(digits, ok, strlen(ok)));
+    TEST_ASSERT_FALSE(catzilla_pattern_match(digits, "0123456789012345678901x3", 24));
+    TEST_ASSERT_FALSE(catzilla_pattern_match(digits, "01234567890123/5", 16));
+    TEST_ASSERT_FALSE(catzilla_pattern_match(digits, "012", 3));
+    catzilla_pattern_free(digits);
+
+    catzilla_pattern_t* slug = catzilla_pattern_compile("^[a-z0-9_]+$");
+    TEST_ASSERT_NOT_NULL(slug);
+    TEST_ASSERT_EQUAL(0, catzilla_pattern_state_count(slug));
+    TEST_ASSERT_TRUE(catzilla_pattern_match(slug, "user_42", 7));
+    TEST_ASSERT_FALSE(catzilla_pattern_match(slug, "User_42", 7));
+    TEST_ASSERT_FALSE(catzilla_pattern_match(slug, "", 0));
+    catzilla_pattern_free(slug);
+}
+
+#ifndef _WIN32
+// Everything the DFA accepts must agree with regexec on ASCII input
+void test_dfa_agrees_with_regexec(void) {
+    static const char* patterns[] = {
+        "ab*c", "^a(b|c)*d$", "x[a-c]{2,3}y", "^(ab|a)(bc|c)$", "(a|ab)(c|bcd)",
+        "^[^x]*x[^x]*$", "a?b?c?$", "^(a*b*)*c", "[[:digit:]]+\\.[[:digit:]]{2}$", "^.a.$",
+    };
+    static const char alphabet[] = "abcdxy.19";
+
+    srand(1234);
+    for (size_t p = 0; p < sizeof(patterns) / sizeof(patterns[0]); p++) {
+        catzilla_pattern_t* pattern = catzilla_pattern_compile(patterns[p]);
+        TEST_ASSERT_NOT_NULL_MESSAGE(pattern, patterns[p]);
+        regex_t regex;
+        TEST_ASSERT_EQUAL(0, regcomp(&regex, patterns[p], REG_EXTENDED | REG_NOSUB));
+
+        for (int i = 0; i < 2000; i++) {
+            char input[12];
+            int length = rand() % (int)sizeof(input);
+            for (int k = 0; k < length; k++) input[k] = alphabet[rand() % (sizeof(alphabet) - 1)];
+            input[length] = '\0';
+
+            bool expected = regexec(&regex, input, 0, NULL, 0) == 0;
+            if (catzilla_pattern_match(pattern, input, (size_t)length) != expected) {
+                char message[128];
+                snprintf(message, sizeof(message), "pattern %s on \"%s\"", patterns[p], input);
+                TEST_FAIL_MESSAGE(message);
+            }
+        }
+        regfree(&regex);
+        catzilla_pattern_free(pattern);
+    }
+}
+#endif
+
+void test_utf8_length(void) {
+    TEST_ASSERT_EQUAL(0, catzilla_utf8_length("", 0));
+    TEST_ASSERT_EQUAL(5, catzilla_utf8_length("hello", 5));
+
+    // 20 two-byte and 10 one-byte characters crosses block boundaries
+    char text[64];
+    size_t length = 0;
+    for (int i = 0; i < 20; i++) {
+        text[length++] = '\xC3';
+        text[length++] = '\xA9';
+    }
+    for (int i = 0; i < 10; i++) text[length++] = 'x';
+    TEST_ASSERT_EQUAL(30, catzilla_utf8_length(text, length));
+    TEST_ASSERT_EQUAL(1, catzilla_utf8_length("\xF0\x9F\x98\x80", 4));
+}
+
+void test_formats(void) {
+    TEST_ASSERT_EQUAL(CATZILLA_STRING_FORMAT_EMAIL, catzilla_string_format_from_name("email"));
+    TEST_ASSERT_EQUAL(CATZILLA_STRING_FORMAT_NONE, catzilla_string_format_from_name("phone"));
+    TEST_ASSERT_EQUAL_STRING("uuid", catzilla_string_format_name(CATZILLA_STRING_FORMAT_UUID));
+
+    #define FORMAT_OK(format, str) TEST_ASSERT_TRUE_MESSAGE(catzilla_string_format_match(format, str, strlen(str)), str)
+    #define FORMAT_BAD(format, str) TEST_ASSERT_FALSE_MESSAGE(catzilla_string_format_match(format, str, strlen(str)), str)
+
+    FORMAT_OK(CATZILLA_STRING_FORMAT_EMAIL, "jane.doe+tag@mail.example.com");
+    FORMAT_BAD(CATZILLA_STRING_FORMAT_EMAIL, "jane..doe@example.com");
+    FORMAT_BAD(CATZILLA_STRING_FORMAT_EMAIL, ".jane@example.com");
+    FORMAT_BAD(CATZILLA_STRING_FORMAT_EMAIL, "jane@localhost");
+    FORMAT_BAD(CATZILLA_STRING_FORMAT_EMAIL, "jane@-example.com");
+    FORMAT_BAD(CATZILLA_STRING_FORMAT_EMAIL, "jane@example..com");
+    FORMAT_BAD(CATZILLA_STRING_FORMAT_EMAIL, "jane doe@example.com");
+
+    FORMAT_OK(CATZILLA_STRING_FORMAT_UUID, "123e4567-e89b-12d3-A456-426614174000");
+    FORMAT_BAD(CATZILLA_STRING_FORMAT_UUID, "123e4567e89b12d3a456426614174000");
+    FORMAT_BAD(CATZILLA_STRING_FORMAT_UUID, "123e4567-e89b-12d3-a456-42661417400g");
+
+    FORMAT_OK(CATZILLA_STRING_FORMAT_DATETIME, "2024-02-29T23:59:59.123456Z");
+    FORMAT_OK(CATZILLA_STRING_FORMAT_DATETIME, "2024-06-01 08:30");
+    FORMAT_OK(CATZILLA_STRING_FORMAT_DATETIME, "2024-06-01T08:30:00+05:30");
+    FORMAT_BAD(CATZILLA_STRING_FORMAT_DATETIME, "2023-02-29T00:00:00");
+    FORMAT_BAD(CATZILLA_STRING_FORMAT_DATETIME, "2024-13-01T00:00:00");
+    FORMAT_BAD(CATZILLA_STRING_FORMAT_DATETIME, "2024-06-01T24:00:00");
+    FORMAT_BAD(CATZILLA_STRING_FORMAT_DATETIME, "2024-06-01");
+    FORMAT_BAD(CATZILLA_STRING_FORMAT_DATETIME, "2024-06-01T08:30:00+0530");
+
+    FORMAT_OK(CATZILLA_STRING_FORMAT_URL, "https://example.com");
+    FORMAT_OK(CATZILLA_STRING_FORMAT_URL, "http://user:pw@localhost:8080/a/b?q=1#top");
+    FORMAT_OK(CATZILLA_STRING_FORMAT_URL, "HTTPS://[::1]:443/");
+    FORMAT_BAD(CATZILLA_STRING_FORMAT_URL, "ftp://example.com");
+    FORMAT_BAD(CATZILLA_STRING_FORMAT_URL, "https://");
+    FORMAT_BAD(CATZILLA_STRING_FORMAT_URL, "https://example.com:99999/");
+    FORMAT_BAD(CATZILLA_STRING_FORMAT_URL, "https://exa mple.com/");
+    FORMAT_BAD(CATZILLA_STRING_FORMAT_URL, "https://example.com/a b");
+
+    FORMAT_OK(CATZILLA_STRING_FORMAT_DIGITS, "00123456789012345678");
+    FORMAT_BAD(CATZILLA_STRING_FORMAT_DIGITS, "");
+    FORMAT_BAD(CATZILLA_STRING_FORMAT_DIGITS, "12a");
+
+    #undef FORMAT_OK
+    #undef FORMAT_BAD
+}
+
+void test_string_validator_uses_the_pattern_engine(void) {
+    validator_t* validator = catzilla_create_string_validator(2, 4, "^[a-z\xC3\xA9]+$");
+    TEST_ASSERT_NOT_NULL(validator);
+    // Non-ASCII class members are left to POSIX regex
+    TEST_ASSERT_NULL(validator->string_validator.compiled_pattern);
+    catzilla_free_validator(validator);
+
+    validator = catzilla_create_string_validator(2, 4, "^\\w+$");
+    TEST_ASSERT_NOT_NULL(validator->string_validator.compiled_pattern);
+    TEST_ASSERT_NULL(validator->string_validator.compiled_regex);
+
+    json_object_t* value = catzilla_create_json_string("ab_1");
+    TEST_ASSERT_EQUAL(VALIDATION_SUCCESS, catzilla_validate_value(validator, value, NULL));
+    catzilla_free_json_object(value);
+
+    value = catzilla_create_json_string("ab-1");
+    TEST_ASSERT_EQUAL(VALIDATION_ERROR_PATTERN, catzilla_validate_value(validator, value, NULL));
+    catzilla_free_json_object(value);
+    catzilla_free_validator(validator);
+
+    // Lengths count characters: four two-byte characters fit max_len 4
+    validator = catzilla_create_string_validator(-1, 4, NULL);
+    value = catzilla_create_json_string("\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9");
+    TEST_ASSERT_EQUAL(VALIDATION_SUCCESS, catzilla_validate_value(validator, value, NULL));
+    catzilla_free_json_object(value);
+
+    TEST_ASSERT_EQUAL(0, catzilla_set_string_format(validator, CATZILLA_STRING_FORMAT_DIGITS));
+    value = catzilla_create_json_string("12a");
+    TEST_ASSERT_EQUAL(VALIDATION_ERROR_PATTERN, catzilla_validate_value(validator, value, NULL));
+    catzilla_free_json_object(value);
+    catzilla_free_validator(validator);
+
+    validator_t* int_validator = catzilla_create_int_validator(0, 1, 1, 1);
+    TEST_ASSERT_EQUAL(-1, catzilla_set_string_format(int_validator, CATZILLA_STRING_FORMAT_EMAIL));
+    catzilla_free_validator(int_validator);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_literals_search_unless_anchored);
+    RUN_TEST(test_classes_and_shorthands);
+    RUN_TEST(test_groups_alternation_and_repetition);
+    RUN_TEST(test_dot_and_negated_classes_match_whole_utf8_characters);
+    RUN_TEST(test_unsupported_patterns_are_left_to_posix_regex);
+    RUN_TEST(test_catastrophic_patterns_run_in_linear_time);
+    RUN_TEST(test_whole_string_classes_become_charset_checks);
+#ifndef _WIN32
+    RUN_TEST(test_dfa_agrees_with_regexec);
+#endif
+    RUN_TEST(test_utf8_length);
+    RUN_TEST(test_formats);
+    RUN_TEST(test_string_validator_uses_the_pattern_engine);
+
+    return UNITY_END();
+}
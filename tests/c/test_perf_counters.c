@@ -0,0 +1,106 @@
+// tests/c/test_perf_counters.c
+#include "unity.h"
+#include "perf_counters.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void setUp(void) {
+    catzilla_perf_thread_close();
+    catzilla_perf_set_sample_interval(0);
+}
+
+void tearDown(void) {
+    catzilla_perf_thread_close();
+    catzilla_perf_set_sample_interval(0);
+}
+
+void test_samples_one_in_interval() {
+    TEST_ASSERT_FALSE(catzilla_perf_sample_due());
+
+    catzilla_perf_set_sample_interval(4);
+    TEST_ASSERT_EQUAL_UINT32(4, catzilla_perf_sample_interval());
+    int sampled = 0;
+    for (int i = 1; i <= 12; i++) {
+        bool due = catzilla_perf_sample_due();
+        TEST_ASSERT_EQUAL(i % 4 == 0, due);
+        sampled += due;
+    }
+    TEST_ASSERT_EQUAL(3, sampled);
+
+    // A shorter interval takes effect at the next request
+    catzilla_perf_set_sample_interval(1);
+    TEST_ASSERT_TRUE(catzilla_perf_sample_due());
+    TEST_ASSERT_TRUE(catzilla_perf_sample_due());
+
+    catzilla_perf_set_sample_interval(0);
+    TEST_ASSERT_FALSE(catzilla_perf_sample_due());
+}
+
+void test_elapsed_needs_one_thread_and_no_multiplexing() {
+    int thread_a, thread_b;
+    catzilla_perf_reading_t start = {{1000, 5000, 10}, 100, 100, &thread_a};
+    catzilla_perf_reading_t end = {{4000, 12000, 13}, 350, 350, &thread_a};
+    catzilla_perf_reading_t delta;
+
+    TEST_ASSERT_TRUE(catzilla_perf_elapsed(&start, &end, &delta));
+    TEST_ASSERT_EQUAL_UINT64(3000, delta.values[CATZILLA_PERF_CYCLES]);
+    TEST_ASSERT_EQUAL_UINT64(7000, delta.values[CATZILLA_PERF_INSTRUCTIONS]);
+    TEST_ASSERT_EQUAL_UINT64(3, delta.values[CATZILLA_PERF_CACHE_MISSES]);
+    TEST_ASSERT_EQUAL_UINT64(250, delta.time_enabled);
+
+    // Off the PMU for part of the interval: the values would be estimates
+    end.time_running = 300;
+    TEST_ASSERT_FALSE(catzilla_perf_elapsed(&start, &end, &delta));
+
+    end.time_running = 350;
+    end.owner = &thread_b;
+    TEST_ASSERT_FALSE(catzilla_perf_elapsed(&start, &end, &delta));
+
+    start.owner = NULL;
+    end.owner = NULL;
+    TEST_ASSERT_FALSE(catzilla_perf_elapsed(&start, &end, &delta));
+}
+
+static volatile uint64_t sink;
+
+void test_read_measures_work_on_this_thread() {
+    if (!catzilla_perf_available()) {
+        TEST_IGNORE_MESSAGE("Hardware counters unavailable on this machine");
+    }
+
+    catzilla_perf_reading_t start, end, delta;
+    TEST_ASSERT_TRUE(catzilla_perf_read(&start));
+    for (uint64_t i = 0; i < 1000000; i++) {
+        sink += i * i;
+    }
+    TEST_ASSERT_TRUE(catzilla_perf_read(&end));
+
+    // Nothing else counts on this event group, so it is never multiplexed away
+    if (!catzilla_perf_elapsed(&start, &end, &delta)) {
+        TEST_IGNORE_MESSAGE("Counters were multiplexed with other perf users");
+    }
+    TEST_ASSERT_TRUE(delta.values[CATZILLA_PERF_CYCLES] > 100000);
+    TEST_ASSERT_TRUE(delta.values[CATZILLA_PERF_INSTRUCTIONS] > 1000000);
+}
+
+void test_unavailable_counters_stop_sampling() {
+    catzilla_perf_set_sample_interval(1);
+    bool available = catzilla_perf_available();
+
+    // Where the kernel refused the counters once, no request is ever sampled
+    TEST_ASSERT_EQUAL(available, catzilla_perf_sample_due());
+    catzilla_perf_reading_t reading;
+    TEST_ASSERT_EQUAL(available, catzilla_perf_read(&reading));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_samples_one_in_interval);
+    RUN_TEST(test_elapsed_needs_one_thread_and_no_multiplexing);
+    RUN_TEST(test_read_measures_work_on_this_thread);
+    RUN_TEST(test_unavailable_counters_stop_sampling);
+
+    return UNITY_END();
+}
@@ -0,0 +1,229 @@
+// tests/c/test_rate_limiter.c
+#include "unity.h"
+#include "rate_limiter.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+static catzilla_rate_limiter_t* make_limiter(uint32_t requests, uint32_t period_ms, uint32_t burst,
+                                             size_t capacity) {
+    catzilla_rate_limit_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.requests = requests;
+    config.period_ms = period_ms;
+    config.burst = burst;
+    config.capacity = capacity;
+    return catzilla_rate_limiter_create(&config);
+}
+
+static int check_key(catzilla_rate_limiter_t* limiter, const char* key, uint64_t now_ms,
+                     catzilla_rate_limit_result_t* result) {
+    return catzilla_rate_limiter_check_at(limiter, key, strlen(key), now_ms, result);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_invalid_config_is_rejected() {
+    TEST_ASSERT_NULL(catzilla_rate_limiter_create(NULL));
+    TEST_ASSERT_NULL(make_limiter(0, 1000, 0, 0));
+    TEST_ASSERT_NULL(make_limiter(10, 0, 0, 0));
+
+    catzilla_rate_limit_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.requests = 10;
+    config.period_ms = 1000;
+    config.key_kind = CATZILLA_RATE_KEY_HEADER;
+    TEST_ASSERT_NULL(catzilla_rate_limiter_create(&config));
+
+    strcpy(config.key_header, "X-API-Key");
+    catzilla_rate_limiter_t* limiter = catzilla_rate_limiter_create(&config);
+    TEST_ASSERT_NOT_NULL(limiter);
+    TEST_ASSERT_EQUAL_STRING("X-API-Key", catzilla_rate_limiter_get_config(limiter)->key_header);
+    TEST_ASSERT_EQUAL(10, catzilla_rate_limiter_get_config(limiter)->burst);
+    TEST_ASSERT_EQUAL(-1, catzilla_rate_limiter_check(limiter, NULL, 4, NULL));
+    catzilla_rate_limiter_destroy(limiter);
+}
+
+void test_burst_then_limited_then_refilled() {
+    // 10 per second: one request every 100 ms, bursts of 5
+    catzilla_rate_limiter_t* limiter = make_limiter(10, 1000, 5, 4096);
+    TEST_ASSERT_NOT_NULL(limiter);
+    catzilla_rate_limit_result_t result;
+
+    for (uint32_t i = 0; i < 5; i++) {
+        TEST_ASSERT_EQUAL(0, check_key(limiter, "10.0.0.1", 1000, &result));
+        TEST_ASSERT_EQUAL(5, result.limit);
+        TEST_ASSERT_EQUAL(4 - i, result.remaining);
+    }
+
+    TEST_ASSERT_EQUAL(1, check_key(limiter, "10.0.0.1", 1000, &result));
+    TEST_ASSERT_EQUAL(0, result.remaining);
+    TEST_ASSERT_EQUAL(100, result.retry_after_ms);
+
+    // One request's worth refills every 100 ms
+    TEST_ASSERT_EQUAL(1, check_key(limiter, "10.0.0.1", 1050, &result));
+    TEST_ASSERT_EQUAL(50, result.retry_after_ms);
+    TEST_ASSERT_EQUAL(0, check_key(limiter, "10.0.0.1", 1100, &result));
+    TEST_ASSERT_EQUAL(1, check_key(limiter, "10.0.0.1", 1100, &result));
+
+    // A long pause refills the bucket, but never beyond the burst
+    TEST_ASSERT_EQUAL(0, check_key(limiter, "10.0.0.1", 60000, &result));
+    TEST_ASSERT_EQUAL(4, result.remaining);
+
+    catzilla_rate_limit_stats_t stats;
+    catzilla_rate_limiter_get_stats(limiter, &stats);
+    TEST_ASSERT_EQUAL(7, stats.allowed);
+    TEST_ASSERT_EQUAL(3, stats.limited);
+    catzilla_rate_limiter_destroy(limiter);
+}
+
+void test_keys_are_limited_independently() {
+    catzilla_rate_limiter_t* limiter = make_limiter(2, 1000, 0, 4096);
+    TEST_ASSERT_NOT_NULL(limiter);
+
+    TEST_ASSERT_EQUAL(0, check_key(limiter, "alice", 10, NULL));
+    TEST_ASSERT_EQUAL(0, check_key(limiter, "alice", 10, NULL));
+    TEST_ASSERT_EQUAL(1, check_key(limiter, "alice", 10, NULL));
+
+    TEST_ASSERT_EQUAL(0, check_key(limiter, "bob", 10, NULL));
+    TEST_ASSERT_EQUAL(0, check_key(limiter, "bob", 10, NULL));
+    TEST_ASSERT_EQUAL(1, check_key(limiter, "bob", 10, NULL));
+
+    catzilla_rate_limit_stats_t stats;
+    catzilla_rate_limiter_get_stats(limiter, &stats);
+    TEST_ASSERT_EQUAL(2, stats.cells_used);
+    TEST_ASSERT_EQUAL(4096, stats.capacity);
+    catzilla_rate_limiter_destroy(limiter);
+}
+
+void test_sweep_frees_only_idle_cells() {
+    // One request per 10 s, bursts of 2
+    catzilla_rate_limiter_t* limiter = make_limiter(1, 10000, 2, 4096);
+    TEST_ASSERT_NOT_NULL(limiter);
+    catzilla_rate_limit_result_t result;
+    char key[32];
+
+    for (int i = 0; i < 50; i++) {
+        snprintf(key, sizeof(key), "192.168.0.%d", i);
+        TEST_ASSERT_EQUAL(0, check_key(limiter, key, 0, NULL));
+    }
+    catzilla_rate_limit_stats_t stats;
+    catzilla_rate_limiter_get_stats(limiter, &stats);
+    TEST_ASSERT_EQUAL(50, stats.cells_used);
+
+    // Still refilling: nothing to free
+    TEST_ASSERT_EQUAL(0, catzilla_rate_limiter_sweep(limiter, 5000));
+
+    // One key keeps sending; the rest are back to a full bucket
+    TEST_ASSERT_EQUAL(0, check_key(limiter, "192.168.0.0", 9000, NULL));
+    TEST_ASSERT_EQUAL(49, catzilla_rate_limiter_sweep(limiter, 12000));
+
+    catzilla_rate_limiter_get_stats(limiter, &stats);
+    TEST_ASSERT_EQUAL(1, stats.cells_used);
+    TEST_ASSERT_EQUAL(49, stats.evicted);
+
+    // The survivor kept its state; a freed key starts over
+    TEST_ASSERT_EQUAL(0, check_key(limiter, "192.168.0.0", 12000, &result));
+    TEST_ASSERT_EQUAL(0, result.remaining);
+    TEST_ASSERT_EQUAL(0, check_key(limiter, "192.168.0.1", 12000, &result));
+    TEST_ASSERT_EQUAL(1, result.remaining);
+    catzilla_rate_limiter_destroy(limiter);
+}
+
+void test_checks_drive_the_sweep() {
+    catzilla_rate_limiter_t* limiter = make_limiter(1, 100, 0, 4096);
+    TEST_ASSERT_NOT_NULL(limiter);
+
+    TEST_ASSERT_EQUAL(0, check_key(limiter, "idle", 0, NULL));
+    // Every shard fires within a sweep period of the next check
+    TEST_ASSERT_EQUAL(0, check_key(limiter, "busy", 3 * CATZILLA_RATE_LIMIT_SWEEP_MS, NULL));
+
+    catzilla_rate_limit_stats_t stats;
+    catzilla_rate_limiter_get_stats(limiter, &stats);
+    TEST_ASSERT_EQUAL(1, stats.evicted);
+    TEST_ASSERT_EQUAL(1, stats.cells_used);
+    catzilla_rate_limiter_destroy(limiter);
+}
+
+void test_full_table_displaces_most_idle_keys() {
+    // The smallest table: 256 cells
+    catzilla_rate_limiter_t* limiter = make_limiter(1, 60000, 0, 1);
+    TEST_ASSERT_NOT_NULL(limiter);
+    char key[32];
+
+    catzilla_rate_limit_stats_t stats;
+    catzilla_rate_limiter_get_stats(limiter, &stats);
+    TEST_ASSERT_EQUAL(256, stats.capacity);
+
+    for (int i = 0; i < 2000; i++) {
+        snprintf(key, sizeof(key), "client-%d", i);
+        TEST_ASSERT_EQUAL(0, check_key(limiter, key, (uint64_t)i, NULL));
+    }
+
+    catzilla_rate_limiter_get_stats(limiter, &stats);
+    TEST_ASSERT_TRUE(stats.cells_used <= 256);
+    TEST_ASSERT_TRUE(stats.displaced >= 2000 - 256);
+    TEST_ASSERT_EQUAL(2000, stats.allowed);
+
+    // The newest key kept its cell
+    TEST_ASSERT_EQUAL(1, check_key(limiter, "client-1999", 2000, NULL));
+    catzilla_rate_limiter_destroy(limiter);
+}
+
+// ---------------------------------------------------------------------------
+// Concurrency
+// ---------------------------------------------------------------------------
+
+#define RACE_THREADS 4
+#define RACE_CHECKS 2000
+
+static catzilla_rate_limiter_t* race_limiter;
+static int race_allowed[RACE_THREADS];
+
+static void* race_worker(void* arg) {
+    int id = (int)(intptr_t)arg;
+    for (int i = 0; i < RACE_CHECKS; i++) {
+        if (check_key(race_limiter, "shared", 1000, NULL) == 0) {
+            race_allowed[id]++;
+        }
+    }
+    return NULL;
+}
+
+void test_concurrent_checks_share_one_bucket() {
+    race_limiter = make_limiter(100, 1000, 0, 4096);
+    TEST_ASSERT_NOT_NULL(race_limiter);
+
+    pthread_t threads[RACE_THREADS];
+    for (int i = 0; i < RACE_THREADS; i++) {
+        race_allowed[i] = 0;
+        pthread_create(&threads[i], NULL, race_worker, (void*)(intptr_t)i);
+    }
+    int allowed = 0;
+    for (int i = 0; i < RACE_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+        allowed += race_allowed[i];
+    }
+
+    // Exactly one burst, whichever threads got it
+    TEST_ASSERT_EQUAL(100, allowed);
+    catzilla_rate_limit_stats_t stats;
+    catzilla_rate_limiter_get_stats(race_limiter, &stats);
+    TEST_ASSERT_EQUAL(RACE_THREADS * RACE_CHECKS - 100, stats.limited);
+    catzilla_rate_limiter_destroy(race_limiter);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_invalid_config_is_rejected);
+    RUN_TEST(test_burst_then_limited_then_refilled);
+    RUN_TEST(test_keys_are_limited_independently);
+    RUN_TEST(test_sweep_frees_only_idle_cells);
+    RUN_TEST(test_checks_drive_the_sweep);
+    RUN_TEST(test_full_table_displaces_most_idle_keys);
+    RUN_TEST(test_concurrent_checks_share_one_bucket);
+
+    return UNITY_END();
+}
@@ -0,0 +1,94 @@
+// tests/c/test_read_buffer_pool.c
+#include "unity.h"
+#include "read_buffer_pool.h"
+#include "memory.h"
+#include <string.h>
+
+void setUp(void) {
+    catzilla_read_pool_trim();
+}
+
+void tearDown(void) {
+    catzilla_read_pool_trim();
+}
+
+void test_slab_reuse_hits_pool() {
+    catzilla_read_pool_stats_t before, after;
+    catzilla_read_pool_get_stats(&before);
+
+    char* first = catzilla_read_slab_acquire();
+    TEST_ASSERT_NOT_NULL(first);
+    memset(first, 'x', CATZILLA_READ_SLAB_SIZE);
+    catzilla_read_slab_release(first);
+
+    char* second = catzilla_read_slab_acquire();
+    TEST_ASSERT_EQUAL_PTR(first, second);
+    catzilla_read_slab_release(second);
+
+    catzilla_read_pool_get_stats(&after);
+    TEST_ASSERT_EQUAL(before.slab_misses + 1, after.slab_misses);
+    TEST_ASSERT_EQUAL(before.slab_hits + 1, after.slab_hits);
+    TEST_ASSERT_EQUAL(before.retained_bytes + CATZILLA_READ_SLAB_SIZE, after.retained_bytes);
+}
+
+void test_retention_is_bounded() {
+    char* slabs[CATZILLA_READ_POOL_MAX_RETAINED + 4];
+    int count = CATZILLA_READ_POOL_MAX_RETAINED + 4;
+
+    for (int i = 0; i < count; i++) {
+        slabs[i] = catzilla_read_slab_acquire();
+        TEST_ASSERT_NOT_NULL(slabs[i]);
+    }
+
+    catzilla_read_pool_stats_t before, after;
+    catzilla_read_pool_get_stats(&before);
+    for (int i = 0; i < count; i++) {
+        catzilla_read_slab_release(slabs[i]);
+    }
+    catzilla_read_pool_get_stats(&after);
+
+    TEST_ASSERT_EQUAL(before.slab_drops + 4, after.slab_drops);
+    TEST_ASSERT_EQUAL((uint64_t)CATZILLA_READ_POOL_MAX_RETAINED * CATZILLA_READ_SLAB_SIZE,
+                      after.retained_bytes);
+
+    catzilla_read_pool_trim();
+    catzilla_read_pool_get_stats(&after);
+    TEST_ASSERT_EQUAL(0, after.retained_bytes);
+}
+
+void test_sticky_buffer_accounting() {
+    catzilla_read_pool_stats_t before, during, after;
+    catzilla_read_pool_get_stats(&before);
+
+    char* sticky = catzilla_sticky_buffer_alloc();
+    TEST_ASSERT_NOT_NULL(sticky);
+    catzilla_sticky_buffer_note_read();
+    catzilla_read_pool_get_stats(&during);
+    TEST_ASSERT_EQUAL(before.sticky_bytes + CATZILLA_STICKY_READ_BUFFER_SIZE, during.sticky_bytes);
+    TEST_ASSERT_EQUAL(before.sticky_reads + 1, during.sticky_reads);
+
+    catzilla_sticky_buffer_free(sticky);
+    catzilla_read_pool_get_stats(&after);
+    TEST_ASSERT_EQUAL(before.sticky_bytes, after.sticky_bytes);
+}
+
+void test_hit_rate() {
+    catzilla_read_slab_release(catzilla_read_slab_acquire());
+    catzilla_read_slab_release(catzilla_read_slab_acquire());
+
+    catzilla_read_pool_stats_t stats;
+    catzilla_read_pool_get_stats(&stats);
+    TEST_ASSERT_TRUE(stats.hit_rate > 0.0);
+    TEST_ASSERT_TRUE(stats.hit_rate <= 1.0);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_slab_reuse_hits_pool);
+    RUN_TEST(test_retention_is_bounded);
+    RUN_TEST(test_sticky_buffer_accounting);
+    RUN_TEST(test_hit_rate);
+
+    return UNITY_END();
+}
@@ -0,0 +1,544 @@
+// tests/c/test_redis_client.c
+#include "unity.h"
+#include "redis_client.h"
+#include "cache_engine.h"
+#include <uv.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// ============================================================================
+// A small in-process Redis speaking enough RESP for the client
+// ============================================================================
+
+#define FAKE_KEYS 128
+#define FAKE_MAX_VALUE 2048
+
+typedef struct {
+    char key[128];
+    char value[FAKE_MAX_VALUE];
+    size_t len;
+    int64_t ttl_ms;  // -1 = no expiry
+    bool used;
+} fake_entry_t;
+
+typedef struct {
+    uv_tcp_t listener;
+    int port;
+    bool silent;  // Read commands but never answer
+    int commands;
+    fake_entry_t entries[FAKE_KEYS];
+} fake_redis_t;
+
+typedef struct {
+    uv_tcp_t tcp;
+    fake_redis_t* redis;
+    char in[65536];
+    size_t in_len;
+} fake_conn_t;
+
+static uv_loop_t loop;
+static fake_redis_t fake;
+static fake_conn_t* fake_conns[64];
+static int fake_conn_count;
+
+static fake_entry_t* fake_find(const char* key, size_t len, bool create) {
+    fake_entry_t* unused = NULL;
+    for (int i = 0; i < FAKE_KEYS; i++) {
+        fake_entry_t* entry = &fake.entries[i];
+        if (entry->used && strlen(entry->key) == len && memcmp(entry->key, key, len) == 0) return entry;
+        if (!entry->used && !unused) unused = entry;
+    }
+    if (!create || !unused) return NULL;
+    memcpy(unused->key, key, len);
+    unused->key[len] = '\0';
+    unused->used = true;
+    return unused;
+}
+
+static void free_write(uv_write_t* req, int status) {
+    (void)status;
+    free(req->data);
+    free(req);
+}
+
+static void fake_reply(fake_conn_t* conn, const char* data, size_t len) {
+    uv_write_t* req = malloc(sizeof(*req));
+    char* copy = malloc(len);
+    memcpy(copy, data, len);
+    req->data = copy;
+    uv_buf_t buf = uv_buf_init(copy, (unsigned int)len);
+    uv_write(req, (uv_stream_t*)&conn->tcp, &buf, 1, free_write);
+}
+
+// Parse one "*n $len arg ..." command; returns bytes used or 0 if incomplete
+static size_t fake_parse(const char* data, size_t len, int* argc, const char** argv, size_t* argv_len) {
+    const char* end = data + len;
+    const char* p = data;
+    if (p >= end || *p != '*') return 0;
+    const char* line = memchr(p, '\n', (size_t)(end - p));
+    if (!line) return 0;
+    *argc = atoi(p + 1);
+    p = line + 1;
+    for (int i = 0; i < *argc; i++) {
+        line = p < end ? memchr(p, '\n', (size_t)(end - p)) : NULL;
+        if (!line) return 0;
+        size_t arg_len = (size_t)atol(p + 1);
+        p = line + 1;
+        if ((size_t)(end - p) < arg_len + 2) return 0;
+        argv[i] = p;
+        argv_len[i] = arg_len;
+        p += arg_len + 2;
+    }
+    return (size_t)(p - data);
+}
+
+static void fake_execute(fake_conn_t* conn, int argc, const char** argv, size_t* argv_len) {
+    char reply[FAKE_MAX_VALUE + 64];
+    fake.commands++;
+    if (fake.silent) return;
+
+    if (argc >= 3 && strncmp(argv[0], "SET", 3) == 0) {
+        fake_entry_t* entry = fake_find(argv[1], argv_len[1], true);
+        memcpy(entry->value, argv[2], argv_len[2]);
+        entry->len = argv_len[2];
+        entry->ttl_ms = argc == 5 ? atol(argv[4]) * 1000 : -1;
+        fake_reply(conn, "+OK\r\n", 5);
+    } else if (argc == 2 && strncmp(argv[0], "GET", 3) == 0) {
+        fake_entry_t* entry = fake_find(argv[1], argv_len[1], false);
+        if (!entry) {
+            fake_reply(conn, "$-1\r\n", 5);
+            return;
+        }
+        int n = snprintf(reply, sizeof(reply), "$%zu\r\n", entry->len);
+        memcpy(reply + n, entry->value, entry->len);
+        memcpy(reply + n + entry->len, "\r\n", 2);
+        fake_reply(conn, reply, n + entry->len + 2);
+    } else if (argc == 2 && strncmp(argv[0], "PTTL", 4) == 0) {
+        fake_entry_t* entry = fake_find(argv[1], argv_len[1], false);
+        int n = snprintf(reply, sizeof(reply), ":%lld\r\n", entry ? (long long)entry->ttl_ms : -2LL);
+        fake_reply(conn, reply, n);
+    } else if (argc == 2 && strncmp(argv[0], "DEL", 3) == 0) {
+        fake_entry_t* entry = fake_find(argv[1], argv_len[1], false);
+        if (entry) entry->used = false;
+        fake_reply(conn, entry ? ":1\r\n" : ":0\r\n", 4);
+    } else {
+        fake_reply(conn, "-ERR unknown command\r\n", 22);
+    }
+}
+
+static void fake_alloc(uv_handle_t* handle, size_t suggested, uv_buf_t* buf) {
+    (void)suggested;
+    fake_conn_t* conn = handle->data;
+    *buf = uv_buf_init(conn->in + conn->in_len, (unsigned int)(sizeof(conn->in) - conn->in_len));
+}
+
+static void fake_closed(uv_handle_t* handle) {
+    for (int i = 0; i < fake_conn_count; i++) {
+        if (fake_conns[i] == handle->data) fake_conns[i] = fake_conns[--fake_conn_count];
+    }
+    free(handle->data);
+}
+
+static void fake_read(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
+    (void)buf;
+    fake_conn_t* conn = stream->data;
+    if (nread < 0) {
+        uv_close((uv_handle_t*)stream, fake_closed);
+        return;
+    }
+    conn->in_len += (size_t)nread;
+
+    size_t offset = 0;
+    int argc;
+    const char* argv[8];
+    size_t argv_len[8];
+    size_t used;
+    while ((used = fake_parse(conn->in + offset, conn->in_len - offset, &argc, argv, argv_len)) > 0) {
+        fake_execute(conn, argc, argv, argv_len);
+        offset += used;
+    }
+    memmove(conn->in, conn->in + offset, conn->in_len - offset);
+    conn->in_len -= offset;
+}
+
+static void fake_accept(uv_stream_t* listener, int status) {
+    if (status < 0) return;
+    fake_conn_t* conn = calloc(1, sizeof(*conn));
+    conn->redis = &fake;
+    uv_tcp_init(&loop, &conn->tcp);
+    conn->tcp.data = conn;
+    fake_conns[fake_conn_count++] = conn;
+    if (uv_accept(listener, (uv_stream_t*)&conn->tcp) == 0) {
+        uv_read_start((uv_stream_t*)&conn->tcp, fake_alloc, fake_read);
+    } else {
+        uv_close((uv_handle_t*)&conn->tcp, fake_closed);
+    }
+}
+
+static void fake_start(void) {
+    memset(&fake, 0, sizeof(fake));
+    struct sockaddr_in addr;
+    uv_ip4_addr("127.0.0.1", 0, &addr);
+    uv_tcp_init(&loop, &fake.listener);
+    uv_tcp_bind(&fake.listener, (const struct sockaddr*)&addr, 0);
+    uv_listen((uv_stream_t*)&fake.listener, 16, fake_accept);
+
+    struct sockaddr_in bound;
+    int len = sizeof(bound);
+    uv_tcp_getsockname(&fake.listener, (struct sockaddr*)&bound, &len);
+    fake.port = ntohs(bound.sin_port);
+}
+
+static char* fake_url(char* buffer, size_t size) {
+    snprintf(buffer, size, "redis://127.0.0.1:%d", fake.port);
+    return buffer;
+}
+
+// ============================================================================
+// Loop helpers
+// ============================================================================
+
+static void on_wakeup(uv_timer_t* timer) {
+    (void)timer;
+}
+
+// Run the loop until *done becomes true or timeout_ms pass
+static bool run_until(volatile bool* done, uint64_t timeout_ms) {
+    uv_timer_t wakeup;
+    uv_timer_init(&loop, &wakeup);
+    uv_timer_start(&wakeup, on_wakeup, 5, 5);
+    uint64_t deadline = uv_now(&loop) + timeout_ms;
+    while (!*done && uv_now(&loop) < deadline) {
+        uv_run(&loop, UV_RUN_ONCE);
+    }
+    uv_close((uv_handle_t*)&wakeup, NULL);
+    uv_run(&loop, UV_RUN_NOWAIT);
+    return *done;
+}
+
+static void spin(uint64_t ms) {
+    bool never = false;
+    run_until(&never, ms);
+}
+
+static bool wait_connected(catzilla_redis_t* client, int connections) {
+    uv_timer_t wakeup;
+    uv_timer_init(&loop, &wakeup);
+    uv_timer_start(&wakeup, on_wakeup, 5, 5);
+    uint64_t deadline = uv_now(&loop) + 2000;
+    catzilla_redis_stats_t stats;
+    do {
+        uv_run(&loop, UV_RUN_ONCE);
+        catzilla_redis_get_stats(client, &stats);
+    } while (stats.connected < connections && uv_now(&loop) < deadline);
+    uv_close((uv_handle_t*)&wakeup, NULL);
+    uv_run(&loop, UV_RUN_NOWAIT);
+    return stats.connected >= connections;
+}
+
+static void close_walk(uv_handle_t* handle, void* arg) {
+    (void)arg;
+    if (uv_is_closing(handle)) return;
+    for (int i = 0; i < fake_conn_count; i++) {
+        if (handle == (uv_handle_t*)&fake_conns[i]->tcp) {
+            uv_close(handle, fake_closed);
+            return;
+        }
+    }
+    uv_close(handle, NULL);
+}
+
+void setUp(void) {
+    uv_loop_init(&loop);
+}
+
+void tearDown(void) {
+    uv_walk(&loop, close_walk, NULL);
+    uv_run(&loop, UV_RUN_DEFAULT);
+    uv_loop_close(&loop);
+}
+
+// ============================================================================
+// Callbacks
+// ============================================================================
+
+typedef struct {
+    int calls;
+    int failures;
+    int expected;
+    bool done;
+    char value[FAKE_MAX_VALUE];
+    size_t size;
+    int64_t ttl_ms;
+} get_result_t;
+
+static void on_get(void* data, bool ok, const void* value, size_t size, int64_t ttl_ms) {
+    get_result_t* result = data;
+    result->calls++;
+    if (!ok) result->failures++;
+    result->size = value ? size : 0;
+    if (value) memcpy(result->value, value, size);
+    result->ttl_ms = ttl_ms;
+    if (result->calls == result->expected) result->done = true;
+}
+
+static void on_fetch(void* data, const void* value, size_t size) {
+    get_result_t* result = data;
+    result->calls++;
+    result->size = value ? size : 0;
+    if (value) memcpy(result->value, value, size);
+    result->done = true;
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+void test_parse_reply_types() {
+    catzilla_redis_reply_t reply;
+
+    TEST_ASSERT_EQUAL(5, catzilla_redis_parse_reply("+OK\r\n", 5, &reply));
+    TEST_ASSERT_EQUAL(CATZILLA_REDIS_REPLY_STATUS, reply.type);
+    TEST_ASSERT_EQUAL(2, reply.len);
+
+    TEST_ASSERT_EQUAL(10, catzilla_redis_parse_reply("-ERR bad\r\n", 10, &reply));
+    TEST_ASSERT_EQUAL(CATZILLA_REDIS_REPLY_ERROR, reply.type);
+
+    TEST_ASSERT_EQUAL(6, catzilla_redis_parse_reply(":-42\r\n", 6, &reply));
+    TEST_ASSERT_EQUAL(CATZILLA_REDIS_REPLY_INTEGER, reply.type);
+    TEST_ASSERT_EQUAL(-42, reply.integer);
+
+    const char* bulk = "$5\r\nh\r\nlo\r\n";
+    TEST_ASSERT_EQUAL(11, catzilla_redis_parse_reply(bulk, 11, &reply));
+    TEST_ASSERT_EQUAL(CATZILLA_REDIS_REPLY_BULK, reply.type);
+    TEST_ASSERT_EQUAL_MEMORY("h\r\nlo", reply.str, 5);
+
+    TEST_ASSERT_EQUAL(5, catzilla_redis_parse_reply("$-1\r\n", 5, &reply));
+    TEST_ASSERT_EQUAL(CATZILLA_REDIS_REPLY_NIL, reply.type);
+
+    const char* array = "*2\r\n$1\r\na\r\n*1\r\n:1\r\n";
+    TEST_ASSERT_EQUAL((long)strlen(array), catzilla_redis_parse_reply(array, strlen(array), &reply));
+    TEST_ASSERT_EQUAL(CATZILLA_REDIS_REPLY_ARRAY, reply.type);
+    TEST_ASSERT_EQUAL(2, reply.integer);
+}
+
+void test_parse_reply_incomplete_and_malformed() {
+    catzilla_redis_reply_t reply;
+    const char* bulk = "$5\r\nhello\r\n";
+    // Every prefix is incomplete, not an error
+    for (size_t len = 0; len < strlen(bulk); len++) {
+        TEST_ASSERT_EQUAL(0, catzilla_redis_parse_reply(bulk, len, &reply));
+    }
+    TEST_ASSERT_EQUAL(0, catzilla_redis_parse_reply("*2\r\n:1\r\n", 8, &reply));
+
+    TEST_ASSERT_EQUAL(-1, catzilla_redis_parse_reply("?x\r\n", 4, &reply));
+    TEST_ASSERT_EQUAL(-1, catzilla_redis_parse_reply(":1x\r\n", 5, &reply));
+    TEST_ASSERT_EQUAL(-1, catzilla_redis_parse_reply("$2\r\nabcd\r\n", 10, &reply));
+    TEST_ASSERT_EQUAL(-1, catzilla_redis_parse_reply("$-5\r\n", 5, &reply));
+}
+
+void test_url_validation() {
+    TEST_ASSERT_TRUE(catzilla_redis_url_valid("redis://localhost"));
+    TEST_ASSERT_TRUE(catzilla_redis_url_valid("redis://127.0.0.1:6380/2"));
+    TEST_ASSERT_TRUE(catzilla_redis_url_valid("redis://:p%40ss@cache.internal:6379"));
+    TEST_ASSERT_TRUE(catzilla_redis_url_valid("redis://user:secret@[::1]:7000/0"));
+
+    TEST_ASSERT_FALSE(catzilla_redis_url_valid("http://localhost"));
+    TEST_ASSERT_FALSE(catzilla_redis_url_valid("redis://"));
+    TEST_ASSERT_FALSE(catzilla_redis_url_valid("redis://host:0"));
+    TEST_ASSERT_FALSE(catzilla_redis_url_valid("redis://host:99999"));
+    TEST_ASSERT_FALSE(catzilla_redis_url_valid("redis://host/db"));
+    TEST_ASSERT_FALSE(catzilla_redis_url_valid(NULL));
+}
+
+void test_commands_in_one_tick_share_a_write() {
+    fake_start();
+    char url[64];
+    catzilla_redis_config_t config = { 1, 0, 0 };
+    catzilla_redis_t* client = catzilla_redis_create(&loop, fake_url(url, sizeof(url)), &config);
+    TEST_ASSERT_NOT_NULL(client);
+    TEST_ASSERT_TRUE(wait_connected(client, 1));
+
+    char key[32];
+    char value[32];
+    for (int i = 0; i < 50; i++) {
+        snprintf(key, sizeof(key), "key_%d", i);
+        snprintf(value, sizeof(value), "value_%d", i);
+        TEST_ASSERT_EQUAL(0, catzilla_redis_set(client, key, strlen(key), value, strlen(value), 60));
+    }
+    get_result_t result;
+    memset(&result, 0, sizeof(result));
+    result.expected = 1;
+    TEST_ASSERT_EQUAL(0, catzilla_redis_get(client, "key_49", 6, on_get, &result));
+    TEST_ASSERT_TRUE(run_until(&result.done, 2000));
+
+    TEST_ASSERT_EQUAL(0, result.failures);
+    TEST_ASSERT_EQUAL_MEMORY("value_49", result.value, 8);
+    TEST_ASSERT_EQUAL(60000, result.ttl_ms);
+
+    catzilla_redis_stats_t stats;
+    catzilla_redis_get_stats(client, &stats);
+    TEST_ASSERT_EQUAL(52, stats.commands);
+    TEST_ASSERT_EQUAL(1, stats.flushes);
+    TEST_ASSERT_EQUAL(52, fake.commands);
+
+    // A missing key answers ok without a value
+    memset(&result, 0, sizeof(result));
+    result.expected = 1;
+    TEST_ASSERT_EQUAL(0, catzilla_redis_get(client, "absent", 6, on_get, &result));
+    TEST_ASSERT_TRUE(run_until(&result.done, 2000));
+    TEST_ASSERT_EQUAL(0, result.failures);
+    TEST_ASSERT_EQUAL(0, result.size);
+
+    catzilla_redis_close(client);
+}
+
+void test_commands_spread_over_the_pool() {
+    fake_start();
+    char url[64];
+    catzilla_redis_config_t config = { 3, 0, 0 };
+    catzilla_redis_t* client = catzilla_redis_create(&loop, fake_url(url, sizeof(url)), &config);
+    TEST_ASSERT_TRUE(wait_connected(client, 3));
+
+    TEST_ASSERT_EQUAL(0, catzilla_redis_set(client, "shared", 6, "v", 1, 0));
+    get_result_t result;
+    memset(&result, 0, sizeof(result));
+    result.expected = 30;
+    for (int i = 0; i < 30; i++) {
+        TEST_ASSERT_EQUAL(0, catzilla_redis_get(client, "shared", 6, on_get, &result));
+    }
+    TEST_ASSERT_TRUE(run_until(&result.done, 2000));
+    TEST_ASSERT_EQUAL(0, result.failures);
+    TEST_ASSERT_EQUAL(-1, result.ttl_ms);
+
+    // One write per connection for the whole batch
+    catzilla_redis_stats_t stats;
+    catzilla_redis_get_stats(client, &stats);
+    TEST_ASSERT_EQUAL(3, stats.flushes);
+    catzilla_redis_close(client);
+}
+
+void test_stalled_server_times_out() {
+    fake_start();
+    fake.silent = true;
+    char url[64];
+    catzilla_redis_config_t config = { 1, 0, 50 };
+    catzilla_redis_t* client = catzilla_redis_create(&loop, fake_url(url, sizeof(url)), &config);
+    TEST_ASSERT_TRUE(wait_connected(client, 1));
+
+    get_result_t result;
+    memset(&result, 0, sizeof(result));
+    result.expected = 2;
+    TEST_ASSERT_EQUAL(0, catzilla_redis_get(client, "a", 1, on_get, &result));
+    TEST_ASSERT_EQUAL(0, catzilla_redis_get(client, "b", 1, on_get, &result));
+    TEST_ASSERT_TRUE(run_until(&result.done, 2000));
+    TEST_ASSERT_EQUAL(2, result.failures);
+
+    catzilla_redis_stats_t stats;
+    catzilla_redis_get_stats(client, &stats);
+    TEST_ASSERT_EQUAL(1, stats.timeouts);
+    TEST_ASSERT_EQUAL(2, stats.failed);
+    catzilla_redis_close(client);
+}
+
+void test_unreachable_server_fails_without_waiting() {
+    fake_start();
+    char url[64];
+    fake_url(url, sizeof(url));
+    // Nothing listens there once the fake is gone
+    uv_close((uv_handle_t*)&fake.listener, NULL);
+    uv_run(&loop, UV_RUN_NOWAIT);
+
+    catzilla_redis_t* client = catzilla_redis_create(&loop, url, NULL);
+    TEST_ASSERT_NOT_NULL(client);
+
+    // Queued while connecting, failed once the connection is refused
+    get_result_t result;
+    memset(&result, 0, sizeof(result));
+    result.expected = 1;
+    TEST_ASSERT_EQUAL(0, catzilla_redis_get(client, "k", 1, on_get, &result));
+    TEST_ASSERT_TRUE(run_until(&result.done, 2000));
+    TEST_ASSERT_EQUAL(1, result.failures);
+
+    // While every connection is down, commands are refused right away
+    TEST_ASSERT_EQUAL(-1, catzilla_redis_get(client, "k", 1, on_get, &result));
+    TEST_ASSERT_EQUAL(-1, catzilla_redis_set(client, "k", 1, "v", 1, 0));
+    catzilla_redis_close(client);
+}
+
+void test_close_fails_outstanding_commands() {
+    fake_start();
+    fake.silent = true;
+    char url[64];
+    catzilla_redis_t* client = catzilla_redis_create(&loop, fake_url(url, sizeof(url)), NULL);
+    TEST_ASSERT_TRUE(wait_connected(client, 1));
+
+    get_result_t result;
+    memset(&result, 0, sizeof(result));
+    result.expected = 1;
+    TEST_ASSERT_EQUAL(0, catzilla_redis_get(client, "k", 1, on_get, &result));
+    catzilla_redis_close(client);
+    TEST_ASSERT_TRUE(result.done);
+    TEST_ASSERT_EQUAL(1, result.failures);
+}
+
+void test_multi_cache_fetches_remote_hits() {
+    fake_start();
+    char url[64];
+    cache_config_t config = { 16, 0, 1, 60, 1024 * 1024, false, false, CACHE_CODEC_NONE, 0, 0, CACHE_EVICTION_CLOCK };
+    multi_cache_t* cache = multi_cache_create(&config, fake_url(url, sizeof(url)), NULL);
+    TEST_ASSERT_NOT_NULL(cache);
+    TEST_ASSERT_TRUE(cache->redis_enabled);
+
+    // Without a client on this thread only the local tiers are used
+    get_result_t result;
+    memset(&result, 0, sizeof(result));
+    TEST_ASSERT_EQUAL(-1, multi_cache_fetch_remote(cache, "k", on_fetch, &result));
+
+    TEST_ASSERT_EQUAL(0, multi_cache_attach_redis_loop(cache, &loop));
+
+    // Queued while the client connects, sent with the next batch
+    TEST_ASSERT_EQUAL(0, multi_cache_set(cache, "page:/", "<html/>", 7, 30));
+    fake_entry_t* stored = NULL;
+    for (int i = 0; i < 200 && !stored; i++) {
+        spin(10);
+        stored = fake_find("catzilla:page:/", strlen("catzilla:page:/"), false);
+    }
+    TEST_ASSERT_NOT_NULL(stored);
+    TEST_ASSERT_EQUAL(30000, stored->ttl_ms);
+
+    // Another node's L1 would miss; Redis has it and L1 gets it back
+    TEST_ASSERT_EQUAL(0, catzilla_cache_delete(cache->memory_cache, "page:/"));
+    TEST_ASSERT_EQUAL(0, multi_cache_fetch_remote(cache, "page:/", on_fetch, &result));
+    TEST_ASSERT_TRUE(run_until(&result.done, 2000));
+    TEST_ASSERT_EQUAL(7, result.size);
+    TEST_ASSERT_EQUAL_MEMORY("<html/>", result.value, 7);
+    TEST_ASSERT_TRUE(catzilla_cache_exists(cache->memory_cache, "page:/"));
+
+    memset(&result, 0, sizeof(result));
+    TEST_ASSERT_EQUAL(0, multi_cache_fetch_remote(cache, "missing", on_fetch, &result));
+    TEST_ASSERT_TRUE(run_until(&result.done, 2000));
+    TEST_ASSERT_EQUAL(1, result.calls);
+    TEST_ASSERT_EQUAL(0, result.size);
+
+    multi_cache_detach_redis_loop(cache);
+    uv_run(&loop, UV_RUN_NOWAIT);
+    multi_cache_destroy(cache);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_parse_reply_types);
+    RUN_TEST(test_parse_reply_incomplete_and_malformed);
+    RUN_TEST(test_url_validation);
+    RUN_TEST(test_commands_in_one_tick_share_a_write);
+    RUN_TEST(test_commands_spread_over_the_pool);
+    RUN_TEST(test_stalled_server_times_out);
+    RUN_TEST(test_unreachable_server_fails_without_waiting);
+    RUN_TEST(test_close_fails_outstanding_commands);
+    RUN_TEST(test_multi_cache_fetches_remote_hits);
+
+    return UNITY_END();
+}
@@ -0,0 +1,154 @@
+// tests/c/test_request_arena.c
+#include "unity.h"
+#include "request_arena.h"
+#include "memory.h"
+#include <string.h>
+#include <stdint.h>
+
+void setUp(void) {
+    catzilla_arena_pool_trim();
+}
+
+void tearDown(void) {
+    catzilla_arena_pool_trim();
+}
+
+void test_allocations_are_aligned_and_distinct() {
+    catzilla_request_arena_t arena;
+    memset(&arena, 0, sizeof(arena));
+
+    char* first = catzilla_arena_alloc(&arena, 3);
+    char* second = catzilla_arena_alloc(&arena, 40);
+    TEST_ASSERT_NOT_NULL(first);
+    TEST_ASSERT_NOT_NULL(second);
+    TEST_ASSERT_EQUAL(0, (uintptr_t)first % 16);
+    TEST_ASSERT_EQUAL(0, (uintptr_t)second % 16);
+    TEST_ASSERT_TRUE(second >= first + 3);
+    memset(first, 'a', 3);
+    memset(second, 'b', 40);
+    TEST_ASSERT_EQUAL(43, arena.bytes);
+
+    char* copy = catzilla_arena_strndup(&arena, "name=value", 4);
+    TEST_ASSERT_EQUAL_STRING("name", copy);
+
+    catzilla_arena_reset(&arena);
+    TEST_ASSERT_NULL(arena.blocks);
+    TEST_ASSERT_EQUAL(0, arena.bytes);
+}
+
+void test_reset_recycles_blocks() {
+    catzilla_request_arena_t arena;
+    memset(&arena, 0, sizeof(arena));
+
+    void* first = catzilla_arena_alloc(&arena, 64);
+    TEST_ASSERT_NOT_NULL(first);
+    catzilla_arena_reset(&arena);
+
+    catzilla_arena_stats_t before, after;
+    catzilla_arena_get_stats(&before);
+    TEST_ASSERT_EQUAL(CATZILLA_ARENA_BLOCK_SIZE, before.retained_bytes);
+
+    // The next request bumps from the same block
+    void* second = catzilla_arena_alloc(&arena, 64);
+    TEST_ASSERT_EQUAL_PTR(first, second);
+    catzilla_arena_reset(&arena);
+
+    catzilla_arena_get_stats(&after);
+    TEST_ASSERT_EQUAL(before.block_hits + 1, after.block_hits);
+    TEST_ASSERT_EQUAL(before.block_misses, after.block_misses);
+    TEST_ASSERT_EQUAL(before.resets + 1, after.resets);
+    TEST_ASSERT_EQUAL(before.bytes + 64, after.bytes);
+}
+
+void test_block_overflow_chains_blocks() {
+    catzilla_request_arena_t arena;
+    memset(&arena, 0, sizeof(arena));
+
+    catzilla_arena_stats_t before, after;
+    catzilla_arena_get_stats(&before);
+
+    // More small allocations than one block holds
+    int count = CATZILLA_ARENA_BLOCK_SIZE / CATZILLA_ARENA_LARGE_THRESHOLD + 2;
+    for (int i = 0; i < count; i++) {
+        char* chunk = catzilla_arena_alloc(&arena, CATZILLA_ARENA_LARGE_THRESHOLD);
+        TEST_ASSERT_NOT_NULL(chunk);
+        memset(chunk, i, CATZILLA_ARENA_LARGE_THRESHOLD);
+    }
+    TEST_ASSERT_NULL(arena.large);
+
+    catzilla_arena_reset(&arena);
+    catzilla_arena_get_stats(&after);
+    TEST_ASSERT_EQUAL(before.block_misses + 2, after.block_misses);
+    TEST_ASSERT_EQUAL(before.large_allocations, after.large_allocations);
+    TEST_ASSERT_EQUAL(2 * CATZILLA_ARENA_BLOCK_SIZE, after.retained_bytes);
+}
+
+void test_large_allocations_bypass_blocks() {
+    catzilla_request_arena_t arena;
+    memset(&arena, 0, sizeof(arena));
+
+    catzilla_arena_stats_t before, after;
+    catzilla_arena_get_stats(&before);
+
+    size_t size = 64 * 1024;
+    char* body = catzilla_arena_alloc(&arena, size);
+    TEST_ASSERT_NOT_NULL(body);
+    TEST_ASSERT_EQUAL(0, (uintptr_t)body % 16);
+    memset(body, 'x', size);
+    TEST_ASSERT_NULL(arena.blocks);
+    TEST_ASSERT_NOT_NULL(arena.large);
+
+    catzilla_arena_reset(&arena);
+    TEST_ASSERT_NULL(arena.large);
+
+    catzilla_arena_get_stats(&after);
+    TEST_ASSERT_EQUAL(before.large_allocations + 1, after.large_allocations);
+    TEST_ASSERT_TRUE(after.peak_bytes >= size);
+    TEST_ASSERT_TRUE(after.bytes_per_request > 0.0);
+}
+
+void test_empty_reset_is_not_counted() {
+    catzilla_request_arena_t arena;
+    memset(&arena, 0, sizeof(arena));
+
+    catzilla_arena_stats_t before, after;
+    catzilla_arena_get_stats(&before);
+    catzilla_arena_reset(&arena);
+    catzilla_arena_get_stats(&after);
+    TEST_ASSERT_EQUAL(before.resets, after.resets);
+}
+
+void test_pool_retention_is_bounded() {
+    catzilla_request_arena_t arenas[CATZILLA_ARENA_POOL_MAX_RETAINED + 4];
+    int count = CATZILLA_ARENA_POOL_MAX_RETAINED + 4;
+
+    for (int i = 0; i < count; i++) {
+        memset(&arenas[i], 0, sizeof(arenas[i]));
+        TEST_ASSERT_NOT_NULL(catzilla_arena_alloc(&arenas[i], 8));
+    }
+    for (int i = 0; i < count; i++) {
+        catzilla_arena_reset(&arenas[i]);
+    }
+
+    catzilla_arena_stats_t stats;
+    catzilla_arena_get_stats(&stats);
+    TEST_ASSERT_EQUAL((uint64_t)CATZILLA_ARENA_POOL_MAX_RETAINED * CATZILLA_ARENA_BLOCK_SIZE,
+                      stats.retained_bytes);
+
+    catzilla_arena_pool_trim();
+    catzilla_arena_get_stats(&stats);
+    TEST_ASSERT_EQUAL(0, stats.retained_bytes);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_allocations_are_aligned_and_distinct);
+    RUN_TEST(test_reset_recycles_blocks);
+    RUN_TEST(test_block_overflow_chains_blocks);
+    RUN_TEST(test_large_allocations_bypass_blocks);
+    RUN_TEST(test_empty_reset_is_not_counted);
+    RUN_TEST(test_pool_retention_is_bounded);
+
+    return UNITY_END();
+}
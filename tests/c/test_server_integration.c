@@ -1,6 +1,7 @@
 // tests/c/test_server_integration.c
 #include "unity.h"
 #include "server.h"
+#include "memory.h"
 #include <string.h>
 
 static catzilla_server_t server;
@@ -23,7 +24,7 @@ void test_server_init_cleanup() {
     catzilla_server_t test_server;
     TEST_ASSERT_EQUAL(0, catzilla_server_init(&test_server));
     TEST_ASSERT_EQUAL(0, test_server.route_count);
-    TEST_ASSERT_NOT_NULL(test_server.router.root);
+    TEST_ASSERT_NOT_NULL(test_server.router.snapshot->root);
     catzilla_server_cleanup(&test_server);
 }
 
@@ -139,6 +140,250 @@ void test_complex_routing_patterns() {
     TEST_ASSERT_TRUE(catzilla_server_has_route(&server, "GET", "/api/v1/users/123/posts/456"));
 }
 
+void test_worker_count_configuration() {
+    // Single loop by default for backward compatibility
+    TEST_ASSERT_EQUAL(1, server.worker_count);
+    TEST_ASSERT_EQUAL(0, server.active_worker_count);
+    TEST_ASSERT_NULL(server.workers);
+
+    TEST_ASSERT_EQUAL(0, catzilla_server_set_worker_count(&server, 4));
+    TEST_ASSERT_EQUAL(4, server.worker_count);
+
+    // 0 means one loop per CPU
+    TEST_ASSERT_EQUAL(0, catzilla_server_set_worker_count(&server, 0));
+    TEST_ASSERT_EQUAL(0, server.worker_count);
+
+    // Out of range values are rejected
+    TEST_ASSERT_EQUAL(-1, catzilla_server_set_worker_count(&server, -1));
+    TEST_ASSERT_EQUAL(-1, catzilla_server_set_worker_count(&server, CATZILLA_MAX_WORKERS + 1));
+    TEST_ASSERT_EQUAL(-1, catzilla_server_set_worker_count(NULL, 2));
+
+    // No loop runs outside listen()
+    TEST_ASSERT_NULL(catzilla_server_current_loop());
+}
+
+void test_context_pool_configuration() {
+    TEST_ASSERT_EQUAL(CATZILLA_DEFAULT_CONTEXT_POOL_LIMIT, server.context_pool_limit);
+    TEST_ASSERT_EQUAL(0, catzilla_server_set_context_pool_limit(&server, 16));
+    TEST_ASSERT_EQUAL(16, server.context_pool_limit);
+    TEST_ASSERT_EQUAL(0, catzilla_server_set_context_pool_limit(&server, 0));
+    TEST_ASSERT_EQUAL(-1, catzilla_server_set_context_pool_limit(&server, -1));
+
+    // No connections have been accepted without listen()
+    catzilla_connection_stats_t stats;
+    catzilla_server_get_connection_stats(&stats);
+    TEST_ASSERT_EQUAL(0, stats.active_connections);
+    TEST_ASSERT_EQUAL(0, stats.pooled_contexts);
+}
+
+static int mock_chunk_handler(uv_stream_t* client, const char* data, size_t len, void* user_data) {
+    return 0;
+}
+
+void test_http2_configuration() {
+    // HTTP/2 is opt-in
+    TEST_ASSERT_FALSE(server.http2_enabled);
+    TEST_ASSERT_EQUAL(0, catzilla_server_set_http2(&server, true));
+    TEST_ASSERT_TRUE(server.http2_enabled);
+    TEST_ASSERT_EQUAL(-1, catzilla_server_set_http2(NULL, true));
+}
+
+void test_connection_limit_configuration() {
+    TEST_ASSERT_EQUAL(CATZILLA_DEFAULT_HEADER_TIMEOUT_MS, server.header_timeout);
+    TEST_ASSERT_EQUAL(CATZILLA_DEFAULT_KEEPALIVE_TIMEOUT_MS, server.keepalive_timeout);
+    TEST_ASSERT_EQUAL(0, catzilla_server_set_timeouts(&server, 1000, 2000, 0, 4000));
+    TEST_ASSERT_EQUAL(1000, server.header_timeout);
+    TEST_ASSERT_EQUAL(2000, server.body_timeout);
+    TEST_ASSERT_EQUAL(0, server.keepalive_timeout);
+    TEST_ASSERT_EQUAL(4000, server.write_timeout);
+
+    // The low-water mark defaults to 90% and never exceeds the limit
+    TEST_ASSERT_EQUAL(0, server.max_connections);
+    TEST_ASSERT_EQUAL(0, catzilla_server_set_max_connections(&server, 1000, 0));
+    TEST_ASSERT_EQUAL(900, server.connections_low_water);
+    TEST_ASSERT_EQUAL(0, catzilla_server_set_max_connections(&server, 1000, 5000));
+    TEST_ASSERT_EQUAL(900, server.connections_low_water);
+    TEST_ASSERT_EQUAL(0, catzilla_server_set_max_connections(&server, 1000, 500));
+    TEST_ASSERT_EQUAL(500, server.connections_low_water);
+    TEST_ASSERT_EQUAL(-1, catzilla_server_set_max_connections(NULL, 10, 0));
+}
+
+void test_tls_configuration() {
+    // Without usable files the server stays on plain TCP
+    TEST_ASSERT_NULL(server.tls_context);
+    TEST_ASSERT_EQUAL(-1, catzilla_server_set_tls(&server, "missing_cert.pem", "missing_key.pem", true));
+    TEST_ASSERT_NULL(server.tls_context);
+    TEST_ASSERT_EQUAL(-1, catzilla_server_set_tls(&server, NULL, "key.pem", true));
+    TEST_ASSERT_EQUAL(-1, catzilla_server_set_tls(NULL, "cert.pem", "key.pem", true));
+}
+
+static int mock_native_handler(uv_stream_t* client, const catzilla_request_t* request, void* user_data) {
+    return 0;
+}
+
+void test_native_route_configuration() {
+    const char* body = "{\"status\":\"ok\"}";
+    TEST_ASSERT_EQUAL(0, catzilla_server_set_native_response(&server, "GET", "/health", 200,
+                                                             "application/json", body, strlen(body)));
+    TEST_ASSERT_TRUE(catzilla_router_has_route(&server.router, "GET", "/health"));
+
+    // Setting it again replaces the response of the same route
+    TEST_ASSERT_EQUAL(0, catzilla_server_set_native_response(&server, "GET", "/health", 503,
+                                                             "text/plain", "down", 4));
+    catzilla_route_match_t match;
+    TEST_ASSERT_EQUAL(0, catzilla_router_match(&server.router, "GET", "/health", &match));
+    TEST_ASSERT_NOT_NULL(match.route->native);
+
+    TEST_ASSERT_EQUAL(0, catzilla_server_set_native_handler(&server, "GET", "/metrics",
+                                                            mock_native_handler, NULL));
+
+    // Handler routes cannot be turned native, and bad arguments are rejected
+    TEST_ASSERT_EQUAL(0, catzilla_server_add_route(&server, "GET", "/users", (void*)mock_handler, NULL));
+    TEST_ASSERT_EQUAL(-1, catzilla_server_set_native_response(&server, "GET", "/users", 200, NULL, "", 0));
+    TEST_ASSERT_EQUAL(-1, catzilla_server_set_native_response(&server, "GET", "/bad", 42, NULL, "", 0));
+    TEST_ASSERT_EQUAL(-1, catzilla_server_set_native_handler(&server, "GET", "/none", NULL, NULL));
+
+    // Once running, only the response of an existing route can change
+    server.is_running = true;
+    TEST_ASSERT_EQUAL(0, catzilla_server_set_native_response(&server, "GET", "/health", 200, NULL, "up", 2));
+    TEST_ASSERT_EQUAL(0, catzilla_server_set_native_response(&server, "GET", "/metrics", 200, NULL, "", 0));
+    TEST_ASSERT_EQUAL(-1, catzilla_server_set_native_response(&server, "GET", "/late", 200, NULL, "", 0));
+    TEST_ASSERT_FALSE(catzilla_router_has_route(&server.router, "GET", "/late"));
+    TEST_ASSERT_EQUAL(-1, catzilla_server_set_native_handler(&server, "GET", "/metrics",
+                                                             mock_native_handler, NULL));
+    server.is_running = false;
+}
+
+void test_python_batching_configuration() {
+    TEST_ASSERT_EQUAL(CATZILLA_DEFAULT_PYTHON_BATCH_SIZE, server.python_batch_size);
+    TEST_ASSERT_EQUAL(CATZILLA_DEFAULT_PYTHON_BATCH_BUDGET_US, server.python_batch_budget_us);
+
+    TEST_ASSERT_EQUAL(0, catzilla_server_set_python_batching(&server, 1, 0));
+    TEST_ASSERT_EQUAL(1, server.python_batch_size);
+    TEST_ASSERT_EQUAL(0, server.python_batch_budget_us);
+    TEST_ASSERT_EQUAL(0, catzilla_server_set_python_batching(&server, 64, 500));
+    TEST_ASSERT_EQUAL(64, server.python_batch_size);
+    TEST_ASSERT_EQUAL(500, server.python_batch_budget_us);
+
+    TEST_ASSERT_EQUAL(-1, catzilla_server_set_python_batching(&server, 0, 500));
+    TEST_ASSERT_EQUAL(64, server.python_batch_size);
+}
+
+void test_memory_budget_configuration() {
+    TEST_ASSERT_EQUAL(0, server.memory_budget);
+    TEST_ASSERT_EQUAL(CATZILLA_DEFAULT_MEMORY_CHECK_INTERVAL_MS, server.memory_check_interval_ms);
+    TEST_ASSERT_EQUAL(CATZILLA_DEFAULT_PRESSURE_UPLOAD_LIMIT, server.pressure_upload_limit);
+
+    TEST_ASSERT_EQUAL(0, catzilla_server_set_memory_budget(&server, 512ull << 20, 250, 4096));
+    TEST_ASSERT_EQUAL(512ull << 20, server.memory_budget);
+    TEST_ASSERT_EQUAL(250, server.memory_check_interval_ms);
+    TEST_ASSERT_EQUAL(4096, server.pressure_upload_limit);
+
+    // Zero picks the defaults
+    TEST_ASSERT_EQUAL(0, catzilla_server_set_memory_budget(&server, 1ull << 30, 0, 0));
+    TEST_ASSERT_EQUAL(CATZILLA_DEFAULT_MEMORY_CHECK_INTERVAL_MS, server.memory_check_interval_ms);
+    TEST_ASSERT_EQUAL(CATZILLA_DEFAULT_PRESSURE_UPLOAD_LIMIT, server.pressure_upload_limit);
+
+    server.is_running = true;
+    TEST_ASSERT_EQUAL(-1, catzilla_server_set_memory_budget(&server, 0, 0, 0));
+    server.is_running = false;
+    TEST_ASSERT_EQUAL(1ull << 30, server.memory_budget);
+
+    TEST_ASSERT_EQUAL(CATZILLA_MEMORY_PRESSURE_NONE, catzilla_server_memory_pressure());
+#ifdef __linux__
+    TEST_ASSERT_TRUE(catzilla_memory_get_rss() > 0);
+#endif
+}
+
+void test_route_cache_configuration() {
+    TEST_ASSERT_EQUAL(0, catzilla_server_add_route(&server, "GET", "/products", (void*)mock_handler, NULL));
+
+    // Unknown routes, and more vary headers than fit, are rejected
+    TEST_ASSERT_EQUAL(-1, catzilla_server_set_route_cache(&server, "GET", "/missing", 60, true, NULL));
+    TEST_ASSERT_EQUAL(-1, catzilla_server_set_route_cache(&server, "GET", "/products", 60, true,
+                                                          "a,b,c,d,e,f,g,h,i"));
+    TEST_ASSERT_NULL(server.response_cache);
+
+    TEST_ASSERT_EQUAL(0, catzilla_server_set_route_cache(&server, "GET", "/products", 60, false,
+                                                         " Accept-Language ,X-Tenant,"));
+    TEST_ASSERT_NOT_NULL(server.response_cache);
+
+    catzilla_route_match_t match;
+    TEST_ASSERT_EQUAL(0, catzilla_router_match(&server.router, "GET", "/products", &match));
+    catzilla_route_cache_policy_t* policy = match.route->cache_policy;
+    TEST_ASSERT_NOT_NULL(policy);
+    TEST_ASSERT_EQUAL(60, policy->ttl_seconds);
+    TEST_ASSERT_FALSE(policy->vary_query);
+    TEST_ASSERT_EQUAL(2, policy->vary_header_count);
+    TEST_ASSERT_EQUAL_STRING("Accept-Language", policy->vary_headers[0]);
+    TEST_ASSERT_EQUAL_STRING("X-Tenant", policy->vary_headers[1]);
+
+    // A zero TTL stops caching the route
+    TEST_ASSERT_EQUAL(0, catzilla_server_set_route_cache(&server, "GET", "/products", 0, true, NULL));
+    TEST_ASSERT_NULL(match.route->cache_policy);
+    catzilla_server_clear_response_cache(&server);
+}
+
+void test_cache_snapshot_configuration() {
+    TEST_ASSERT_NULL(server.cache_snapshot_dir);
+    TEST_ASSERT_EQUAL(-1, catzilla_server_set_cache_snapshot(&server, ""));
+    TEST_ASSERT_EQUAL(0, catzilla_server_set_cache_snapshot(&server, "/tmp"));
+    TEST_ASSERT_EQUAL_STRING("/tmp", server.cache_snapshot_dir);
+
+    server.is_running = true;
+    TEST_ASSERT_EQUAL(-1, catzilla_server_set_cache_snapshot(&server, "/var/tmp"));
+    server.is_running = false;
+    TEST_ASSERT_EQUAL_STRING("/tmp", server.cache_snapshot_dir);
+}
+
+void test_handoff_configuration() {
+    TEST_ASSERT_NULL(server.handoff_path);
+    TEST_ASSERT_EQUAL(-1, server.handoff_fd);
+    TEST_ASSERT_EQUAL(-1, catzilla_server_set_handoff(&server, "", 1000));
+    TEST_ASSERT_EQUAL(0, catzilla_server_set_handoff(&server, "/tmp/catzilla.sock", 5000));
+    TEST_ASSERT_EQUAL_STRING("/tmp/catzilla.sock", server.handoff_path);
+    TEST_ASSERT_EQUAL(5000, server.drain_timeout_ms);
+
+    server.is_running = true;
+    TEST_ASSERT_EQUAL(-1, catzilla_server_set_handoff(&server, "/tmp/other.sock", 0));
+    server.is_running = false;
+    TEST_ASSERT_EQUAL_STRING("/tmp/catzilla.sock", server.handoff_path);
+}
+
+void test_body_limit_configuration() {
+    TEST_ASSERT_EQUAL(0, server.max_body_size);
+    TEST_ASSERT_EQUAL(CATZILLA_DEFAULT_BODY_SPOOL_THRESHOLD, server.body_spool_threshold);
+    TEST_ASSERT_EQUAL(0, catzilla_server_set_max_body_size(&server, 1024));
+    TEST_ASSERT_EQUAL(1024, server.max_body_size);
+
+    TEST_ASSERT_EQUAL(0, catzilla_server_add_route(&server, "POST", "/upload", (void*)mock_handler, NULL));
+    TEST_ASSERT_EQUAL(0, catzilla_server_add_route(&server, "POST", "/ingest", (void*)mock_handler, NULL));
+
+    // Unknown routes and stream mode without a handler are rejected
+    TEST_ASSERT_EQUAL(-1, catzilla_server_set_route_body_mode(&server, "POST", "/missing",
+                                                              CATZILLA_BODY_SPOOL, 0, 0));
+    TEST_ASSERT_EQUAL(-1, catzilla_server_set_route_body_mode(&server, "POST", "/upload",
+                                                              CATZILLA_BODY_STREAM, 0, 0));
+    TEST_ASSERT_EQUAL(0, server.body_route_count);
+
+    TEST_ASSERT_EQUAL(0, catzilla_server_set_route_body_mode(&server, "POST", "/upload",
+                                                             CATZILLA_BODY_SPOOL, 4096, 512));
+    TEST_ASSERT_EQUAL(0, catzilla_server_set_route_body_stream(&server, "POST", "/ingest",
+                                                               mock_chunk_handler, NULL));
+    TEST_ASSERT_EQUAL(2, server.body_route_count);
+
+    catzilla_route_match_t match;
+    TEST_ASSERT_EQUAL(0, catzilla_router_match(&server.router, "POST", "/upload", &match));
+    TEST_ASSERT_EQUAL(CATZILLA_BODY_SPOOL, match.route->body_mode);
+    TEST_ASSERT_EQUAL(4096, match.route->max_body_size);
+    TEST_ASSERT_EQUAL(512, match.route->body_spool_threshold);
+
+    // Back to defaults drops the route from the per-request lookup
+    TEST_ASSERT_EQUAL(0, catzilla_server_set_route_body_mode(&server, "POST", "/upload",
+                                                             CATZILLA_BODY_BUFFERED, 0, 0));
+    TEST_ASSERT_EQUAL(1, server.body_route_count);
+}
+
 int main(void) {
     UNITY_BEGIN();
 
@@ -159,5 +404,23 @@ int main(void) {
     RUN_TEST(test_route_parameter_validation);
     RUN_TEST(test_complex_routing_patterns);
 
+    // Multi-loop worker mode
+    RUN_TEST(test_worker_count_configuration);
+
+    // Connection context pool
+    RUN_TEST(test_context_pool_configuration);
+
+    // Request body policies
+    RUN_TEST(test_body_limit_configuration);
+    RUN_TEST(test_http2_configuration);
+    RUN_TEST(test_connection_limit_configuration);
+    RUN_TEST(test_tls_configuration);
+    RUN_TEST(test_native_route_configuration);
+    RUN_TEST(test_route_cache_configuration);
+    RUN_TEST(test_cache_snapshot_configuration);
+    RUN_TEST(test_handoff_configuration);
+    RUN_TEST(test_python_batching_configuration);
+    RUN_TEST(test_memory_budget_configuration);
+
     return UNITY_END();
 }
@@ -0,0 +1,285 @@
+// tests/c/test_sse_hub.c
+#include "unity.h"
+#include "sse_hub.h"
+#include "streaming.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// A subscriber connection: the loop writes to pipe, the test reads peer
+typedef struct {
+    uv_pipe_t pipe;
+    int peer;
+    char received[1 << 16];
+    size_t received_len;
+    bool dropped;
+    bool closed;
+} test_conn_t;
+
+static uv_loop_t loop;
+static uv_timer_t keepalive;  // The hub's handle does not keep the loop running
+
+static void on_keepalive(uv_timer_t* timer) {
+    (void)timer;
+}
+
+static void open_conn(test_conn_t* conn) {
+    int fds[2];
+    memset(conn, 0, sizeof(*conn));
+    TEST_ASSERT_EQUAL_INT(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+    TEST_ASSERT_EQUAL_INT(0, uv_pipe_init(&loop, &conn->pipe, 0));
+    TEST_ASSERT_EQUAL_INT(0, uv_pipe_open(&conn->pipe, fds[0]));
+    conn->pipe.data = NULL;  // Not a server connection
+    conn->peer = fds[1];
+    fcntl(conn->peer, F_SETFL, fcntl(conn->peer, F_GETFL) | O_NONBLOCK);
+}
+
+static void on_conn_closed(uv_handle_t* handle) {
+    test_conn_t* conn = (test_conn_t*)handle;
+    conn->closed = true;
+}
+
+static void close_conn(test_conn_t* conn) {
+    if (!uv_is_closing((uv_handle_t*)&conn->pipe)) {
+        uv_close((uv_handle_t*)&conn->pipe, on_conn_closed);
+    }
+    while (!conn->closed) uv_run(&loop, UV_RUN_NOWAIT);
+    close(conn->peer);
+}
+
+static void on_dropped(uv_stream_t* client, void* data) {
+    test_conn_t* conn = data;
+    conn->dropped = true;
+    uv_close((uv_handle_t*)client, on_conn_closed);
+}
+
+// Run the loop and collect what reached the peer, until want bytes arrived
+static void pump(test_conn_t* conn, size_t want) {
+    for (int i = 0; i < 2000 && conn->received_len < want; i++) {
+        uv_run(&loop, UV_RUN_NOWAIT);
+        ssize_t n = read(conn->peer, conn->received + conn->received_len,
+                         sizeof(conn->received) - conn->received_len);
+        if (n < 0 && errno == EAGAIN) usleep(500);
+        if (n > 0) conn->received_len += (size_t)n;
+    }
+}
+
+static void expect_chunk(test_conn_t* conn, const char* payload) {
+    char expected[512];
+    int len = snprintf(expected, sizeof(expected), "%zx\r\n%s\r\n", strlen(payload), payload);
+    pump(conn, (size_t)len);
+    TEST_ASSERT_EQUAL_UINT((unsigned)len, (unsigned)conn->received_len);
+    TEST_ASSERT_EQUAL_MEMORY(expected, conn->received, (size_t)len);
+    conn->received_len = 0;
+}
+
+void setUp(void) {
+    uv_loop_init(&loop);
+    uv_timer_init(&loop, &keepalive);
+    uv_timer_start(&keepalive, on_keepalive, 60000, 0);
+    TEST_ASSERT_EQUAL_INT(0, catzilla_sse_attach_loop(&loop));
+}
+
+void tearDown(void) {
+    catzilla_sse_detach_loop(&loop);
+    uv_close((uv_handle_t*)&keepalive, NULL);
+    uv_run(&loop, UV_RUN_DEFAULT);
+    uv_loop_close(&loop);
+}
+
+void test_publish_fans_out_one_event() {
+    catzilla_sse_hub_t* hub = catzilla_sse_hub_create(0);
+    test_conn_t a, b;
+    open_conn(&a);
+    open_conn(&b);
+    catzilla_sse_subscriber_t* sa = catzilla_sse_subscribe(hub, (uv_stream_t*)&a.pipe, on_dropped, &a);
+    catzilla_sse_subscriber_t* sb = catzilla_sse_subscribe(hub, (uv_stream_t*)&b.pipe, on_dropped, &b);
+    TEST_ASSERT_NOT_NULL(sa);
+    TEST_ASSERT_NOT_NULL(sb);
+
+    TEST_ASSERT_EQUAL_INT(0, catzilla_sse_publish(hub, "tick", "7", "a\nb\r\nc", 6));
+    expect_chunk(&a, "id: 7\nevent: tick\ndata: a\ndata: b\ndata: c\n\n");
+    expect_chunk(&b, "id: 7\nevent: tick\ndata: a\ndata: b\ndata: c\n\n");
+
+    TEST_ASSERT_EQUAL_INT(0, catzilla_sse_publish(hub, NULL, NULL, "", 0));
+    expect_chunk(&a, "data: \n\n");
+    expect_chunk(&b, "data: \n\n");
+
+    catzilla_sse_hub_stats_t stats;
+    catzilla_sse_hub_get_stats(hub, &stats);
+    TEST_ASSERT_EQUAL_UINT(2, (unsigned)stats.subscribers);
+    TEST_ASSERT_EQUAL_UINT(2, (unsigned)stats.published);
+    TEST_ASSERT_EQUAL_UINT(4, (unsigned)stats.delivered);
+
+    // Only subscribers of the hub receive its events
+    catzilla_sse_unsubscribe(sb);
+    TEST_ASSERT_EQUAL_INT(0, catzilla_sse_publish(hub, NULL, NULL, "x", 1));
+    expect_chunk(&a, "data: x\n\n");
+    pump(&b, 1);
+    TEST_ASSERT_EQUAL_UINT(0, (unsigned)b.received_len);
+
+    catzilla_sse_unsubscribe(sa);
+    catzilla_sse_hub_release(hub);
+    close_conn(&a);
+    close_conn(&b);
+}
+
+void test_line_breaks_rejected_in_fields() {
+    catzilla_sse_hub_t* hub = catzilla_sse_hub_create(0);
+    TEST_ASSERT_EQUAL_INT(-1, catzilla_sse_publish(hub, "a\nb", NULL, "x", 1));
+    TEST_ASSERT_EQUAL_INT(-1, catzilla_sse_publish(hub, NULL, "1\r", "x", 1));
+    catzilla_sse_hub_stats_t stats;
+    catzilla_sse_hub_get_stats(hub, &stats);
+    TEST_ASSERT_EQUAL_UINT(0, (unsigned)stats.published);
+    catzilla_sse_hub_release(hub);
+}
+
+void test_slow_subscriber_dropped() {
+    catzilla_sse_hub_t* hub = catzilla_sse_hub_create(4096);
+    test_conn_t slow, fast;
+    open_conn(&slow);
+    open_conn(&fast);
+    catzilla_sse_subscribe(hub, (uv_stream_t*)&slow.pipe, on_dropped, &slow);
+    catzilla_sse_subscriber_t* fast_sub = catzilla_sse_subscribe(hub, (uv_stream_t*)&fast.pipe, on_dropped, &fast);
+
+    // The slow peer never reads, so its socket fills and writes queue up
+    size_t size = 16 * 1024;
+    char* data = malloc(size);
+    memset(data, 'x', size);
+    size_t event_size = 6 + strlen("data: ") + size + 2 + 2;  // "4006\r\n" ... "\r\n"
+    for (int i = 0; i < 200 && !slow.dropped; i++) {
+        TEST_ASSERT_EQUAL_INT(0, catzilla_sse_publish(hub, NULL, NULL, data, size));
+        pump(&fast, event_size);
+        TEST_ASSERT_EQUAL_UINT((unsigned)event_size, (unsigned)fast.received_len);
+        fast.received_len = 0;
+    }
+    free(data);
+    TEST_ASSERT_TRUE(slow.dropped);
+    TEST_ASSERT_FALSE(fast.dropped);
+
+    catzilla_sse_hub_stats_t stats;
+    catzilla_sse_hub_get_stats(hub, &stats);
+    TEST_ASSERT_EQUAL_UINT(1, (unsigned)stats.subscribers);
+    TEST_ASSERT_EQUAL_UINT(1, (unsigned)stats.dropped);
+
+    // The hub outlives its creator's reference while it has subscribers
+    catzilla_sse_hub_release(hub);
+    catzilla_sse_unsubscribe(fast_sub);
+    close_conn(&slow);
+    close_conn(&fast);
+}
+
+static void publish_from_thread(void* arg) {
+    catzilla_sse_publish(arg, "remote", NULL, "hello", 5);
+}
+
+void test_publish_from_another_thread() {
+    catzilla_sse_hub_t* hub = catzilla_sse_hub_create(0);
+    test_conn_t conn;
+    open_conn(&conn);
+    catzilla_sse_subscriber_t* sub = catzilla_sse_subscribe(hub, (uv_stream_t*)&conn.pipe, on_dropped, &conn);
+
+    uv_thread_t thread;
+    TEST_ASSERT_EQUAL_INT(0, uv_thread_create(&thread, publish_from_thread, hub));
+    uv_thread_join(&thread);
+    expect_chunk(&conn, "event: remote\ndata: hello\n\n");
+
+    catzilla_sse_unsubscribe(sub);
+    catzilla_sse_hub_release(hub);
+    close_conn(&conn);
+}
+
+void test_detach_drops_subscribers() {
+    catzilla_sse_hub_t* hub = catzilla_sse_hub_create(0);
+    test_conn_t conn;
+    open_conn(&conn);
+    catzilla_sse_subscribe(hub, (uv_stream_t*)&conn.pipe, on_dropped, &conn);
+    TEST_ASSERT_EQUAL_INT(0, catzilla_sse_publish(hub, NULL, NULL, "pending", 7));
+
+    // Queued events are discarded with the loop's subscribers
+    catzilla_sse_detach_loop(&loop);
+    TEST_ASSERT_TRUE(conn.dropped);
+    catzilla_sse_hub_stats_t stats;
+    catzilla_sse_hub_get_stats(hub, &stats);
+    TEST_ASSERT_EQUAL_UINT(0, (unsigned)stats.subscribers);
+
+    // A detached loop has no hubs to subscribe to
+    test_conn_t late;
+    open_conn(&late);
+    TEST_ASSERT_NULL(catzilla_sse_subscribe(hub, (uv_stream_t*)&late.pipe, on_dropped, &late));
+
+    catzilla_sse_hub_release(hub);
+    close_conn(&conn);
+    close_conn(&late);
+}
+
+void test_chunk_writer_framing() {
+    test_conn_t conn;
+    open_conn(&conn);
+    uv_stream_t* client = (uv_stream_t*)&conn.pipe;
+
+    TEST_ASSERT_EQUAL_INT(CATZILLA_STREAM_OK, catzilla_stream_send_chunk(client, "hello", 5));
+    TEST_ASSERT_EQUAL_INT(CATZILLA_STREAM_OK, catzilla_stream_send_chunk(client, "", 0));
+    TEST_ASSERT_EQUAL_INT(CATZILLA_STREAM_OK, catzilla_stream_send_last_chunk(client));
+    pump(&conn, 15);
+    TEST_ASSERT_EQUAL_UINT(15, (unsigned)conn.received_len);
+    TEST_ASSERT_EQUAL_MEMORY("5\r\nhello\r\n0\r\n\r\n", conn.received, 15);
+    close_conn(&conn);
+}
+
+void test_chunk_writer_copies_what_the_socket_refused() {
+    test_conn_t conn;
+    open_conn(&conn);
+    uv_stream_t* client = (uv_stream_t*)&conn.pipe;
+
+    // Larger than the socket buffer: the rest is queued from a copy, and the
+    // caller's buffer is reused at once
+    size_t size = 4 * 1024 * 1024;
+    char* data = malloc(size);
+    for (size_t i = 0; i < size; i++) data[i] = (char)('a' + i % 26);
+    TEST_ASSERT_EQUAL_INT(CATZILLA_STREAM_OK, catzilla_stream_send_chunk(client, data, size));
+    TEST_ASSERT_TRUE(uv_stream_get_write_queue_size(client) > 0);
+    char* expected = malloc(size);
+    memcpy(expected, data, size);
+    memset(data, 0, size);
+    TEST_ASSERT_EQUAL_INT(CATZILLA_STREAM_OK, catzilla_stream_send_chunk(client, "tail", 4));
+
+    char header[24];
+    int header_len = snprintf(header, sizeof(header), "%zx\r\n", size);
+    size_t total = (size_t)header_len + size + 2 + 9;
+    char* received = malloc(total);
+    size_t received_len = 0;
+    for (int i = 0; i < 20000 && received_len < total; i++) {
+        uv_run(&loop, UV_RUN_NOWAIT);
+        ssize_t n = read(conn.peer, received + received_len, total - received_len);
+        if (n > 0) received_len += (size_t)n;
+        else usleep(100);
+    }
+    TEST_ASSERT_EQUAL_UINT((unsigned)total, (unsigned)received_len);
+    TEST_ASSERT_EQUAL_MEMORY(header, received, (size_t)header_len);
+    TEST_ASSERT_EQUAL_MEMORY(expected, received + header_len, size);
+    TEST_ASSERT_EQUAL_MEMORY("\r\n4\r\ntail\r\n", received + header_len + size, 11);
+
+    free(data);
+    free(expected);
+    free(received);
+    close_conn(&conn);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_publish_fans_out_one_event);
+    RUN_TEST(test_line_breaks_rejected_in_fields);
+    RUN_TEST(test_slow_subscriber_dropped);
+    RUN_TEST(test_publish_from_another_thread);
+    RUN_TEST(test_detach_drops_subscribers);
+    RUN_TEST(test_chunk_writer_framing);
+    RUN_TEST(test_chunk_writer_copies_what_the_socket_refused);
+
+    return UNITY_END();
+}
@@ -6,10 +6,13 @@
 #endif
 #include <sys/stat.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <time.h>
 #include <uv.h>
 #include <assert.h>
 #include "../../src/core/static_server.h"
 #include "../../src/core/memory.h"
+#include "../../src/core/http_response.h"
 
 // Test framework macros
 #define TEST_ASSERT(condition, message) \
@@ -295,6 +298,7 @@ static void test_cache_operations() {
     TEST_ASSERT(entry->content_size == strlen(test_content), "Cached content size should match");
     TEST_ASSERT(entry->file_mtime == file_stat.st_mtime, "Cached mtime should match");
     // Note: MIME type is not stored in cache, generated on demand
+    catzilla_static_cache_release(test_server.cache, entry);
 
     TEST_END("cache_operations");
 }
@@ -392,6 +396,638 @@ static void test_performance_monitoring() {
     TEST_END("performance_monitoring");
 }
 
+static void close_walk_cb(uv_handle_t* handle, void* arg) {
+    (void)arg;
+    if (!uv_is_closing(handle)) uv_close(handle, NULL);
+}
+
+static catzilla_static_uring_result_t uring_results[4];
+static int uring_result_count = 0;
+
+static void record_uring_result(void* user_data, catzilla_static_uring_result_t* result) {
+    (void)user_data;
+    if (uring_result_count < 4) {
+        uring_results[uring_result_count] = *result;
+    } else {
+        catzilla_static_free(result->data);
+    }
+    uring_result_count++;
+}
+
+static void test_uring_file_loading() {
+    TEST_START("uring_file_loading");
+
+    if (!catzilla_static_uring_available(test_loop)) {
+        printf("io_uring not available here, skipping\n");
+        int rc = catzilla_static_uring_read_file(test_loop, test_css_file, 0, record_uring_result, NULL);
+        TEST_ASSERT(rc != 0, "Reads must be refused so callers fall back to uv_fs");
+        TEST_END("uring_file_loading");
+        return;
+    }
+
+    // Several requests queued in one iteration share a submission
+    TEST_ASSERT(catzilla_static_uring_read_file(test_loop, test_css_file, 0, record_uring_result, NULL) == 0,
+                "File read should be queued");
+    TEST_ASSERT(catzilla_static_uring_read_file(test_loop, "/tmp/catzilla_static_test/missing.txt", 0,
+                                                record_uring_result, NULL) == 0,
+                "Missing file read should be queued");
+    TEST_ASSERT(catzilla_static_uring_read_file(test_loop, test_dir, 0, record_uring_result, NULL) == 0,
+                "Directory read should be queued");
+    TEST_ASSERT(catzilla_static_uring_read_file(test_loop, test_html_file, 16, record_uring_result, NULL) == 0,
+                "Oversized file read should be queued");
+
+    // The cache cleanup timer keeps the loop alive, so run only until done
+    while (uring_result_count < 4 && uv_run(test_loop, UV_RUN_ONCE) != 0) {
+    }
+    TEST_ASSERT(uring_result_count == 4, "Every request should complete");
+
+    // Completion order is up to the kernel; each result is identified by its status
+    bool seen_file = false, seen_missing = false, seen_dir = false, seen_big = false;
+    const char* css = "body { background-color: #f0f0f0; font-family: Arial, sans-serif; }";
+    for (int i = 0; i < 4; i++) {
+        catzilla_static_uring_result_t* result = &uring_results[i];
+        if (result->status == 0) {
+            seen_file = result->size == strlen(css) && memcmp(result->data, css, result->size) == 0;
+            catzilla_static_free(result->data);
+        } else if (result->status == UV_ENOENT) {
+            seen_missing = result->data == NULL;
+        } else if (result->status == UV_EISDIR) {
+            seen_dir = true;
+        } else if (result->status == UV_EFBIG) {
+            seen_big = true;
+        }
+    }
+    TEST_ASSERT(seen_file, "File contents should be loaded");
+    TEST_ASSERT(seen_missing, "Missing files should report UV_ENOENT");
+    TEST_ASSERT(seen_dir, "Directories should report UV_EISDIR");
+    TEST_ASSERT(seen_big, "Files above max_size should report UV_EFBIG");
+
+    TEST_END("uring_file_loading");
+}
+
+// Cached files survive a restart through a snapshot unless they change on disk
+static void test_cache_snapshot() {
+    TEST_START("cache_snapshot");
+
+    const char* snapshot = "/tmp/catzilla_static_test.snapshot";
+    const char* html = "<!DOCTYPE html>\n<html><head><title>Test</title></head><body><h1>Test HTML</h1></body></html>";
+    size_t size = strlen(html);
+
+    hot_cache_t cold;
+    TEST_ASSERT(catzilla_static_cache_init(&cold, 1024 * 1024) == 0, "Cache init should succeed");
+    char* content = catzilla_static_alloc(size);
+    memcpy(content, html, size);
+    TEST_ASSERT(catzilla_static_cache_put(&cold, "index.html", content, size, time(NULL)) == 0,
+                "Cache put should succeed");
+    TEST_ASSERT(catzilla_static_cache_save_snapshot(&cold, snapshot) == 0, "Snapshot should be written");
+    catzilla_static_cache_destroy(&cold);
+
+    hot_cache_t warm;
+    catzilla_static_cache_init(&warm, 1024 * 1024);
+    TEST_ASSERT(catzilla_static_cache_load_snapshot(&warm, snapshot, test_dir) == 0, "Snapshot should load");
+    TEST_ASSERT(warm.total_entries == 0, "Nothing is restored before a lookup");
+    hot_cache_entry_t* entry = catzilla_static_cache_get(&warm, "index.html");
+    TEST_ASSERT(entry != NULL && entry->content_size == size &&
+                memcmp(entry->file_content, html, size) == 0, "Lookup should restore the file");
+    catzilla_static_cache_release(&warm, entry);
+    catzilla_static_cache_destroy(&warm);
+
+    // A file touched after it was cached is read again instead
+    struct timespec times[2] = {{0, UTIME_OMIT}, {time(NULL) + 60, 0}};
+    TEST_ASSERT(utimensat(AT_FDCWD, test_html_file, times, 0) == 0, "mtime should be updated");
+    catzilla_static_cache_init(&warm, 1024 * 1024);
+    TEST_ASSERT(catzilla_static_cache_load_snapshot(&warm, snapshot, test_dir) == 0, "Snapshot should load");
+    TEST_ASSERT(catzilla_static_cache_get(&warm, "index.html") == NULL, "Changed file should not be restored");
+    catzilla_static_cache_destroy(&warm);
+    unlink(snapshot);
+
+    TEST_END("cache_snapshot");
+}
+
+static void test_cache_set_limit() {
+    TEST_START("cache_set_limit");
+
+    hot_cache_t cache;
+    TEST_ASSERT(catzilla_static_cache_init(&cache, 1024 * 1024) == 0, "Cache init should succeed");
+    for (int i = 0; i < 16; i++) {
+        char key[32];
+        snprintf(key, sizeof(key), "/chunk-%d.bin", i);
+        char* content = catzilla_static_alloc(4096);
+        memset(content, 'a' + i, 4096);
+        TEST_ASSERT(catzilla_static_cache_put(&cache, key, content, 4096, time(NULL)) == 0,
+                    "Cache put should succeed");
+    }
+    size_t full = cache.current_memory_usage;
+
+    // Halving the limit evicts until the cache fits, and later puts respect it
+    size_t evicted = catzilla_static_cache_set_limit(&cache, full / 2);
+    TEST_ASSERT(evicted > 0 && cache.current_memory_usage <= full / 2, "Shrinking should evict");
+    TEST_ASSERT(cache.total_entries == 16 - evicted, "Evicted entries should be gone");
+    char* content = catzilla_static_alloc(4096);
+    memset(content, 'z', 4096);
+    TEST_ASSERT(catzilla_static_cache_put(&cache, "/late.bin", content, 4096, time(NULL)) == 0,
+                "Cache put should succeed");
+    TEST_ASSERT(cache.current_memory_usage <= full / 2, "Puts should stay under the new limit");
+
+    TEST_ASSERT(catzilla_static_cache_set_limit(&cache, 1024 * 1024) == 0, "Growing should not evict");
+    catzilla_static_cache_destroy(&cache);
+
+    TEST_END("cache_set_limit");
+}
+
+#define CONCURRENT_KEYS 2000
+#define CONCURRENT_VALUE_SIZE 256
+
+typedef struct {
+    hot_cache_t* cache;
+    volatile int* stop;
+    uint64_t hits;
+    uint64_t bad;
+} cache_reader_t;
+
+static void concurrent_key(char* key, int i) {
+    snprintf(key, 32, "/asset-%d.css", i);
+}
+
+// Lookups on other threads race puts, removals, evictions and table growth
+static void cache_reader_thread(void* arg) {
+    cache_reader_t* reader = (cache_reader_t*)arg;
+    char key[32];
+    for (unsigned i = 0; !*reader->stop; i = i * 1103515245 + 12345) {
+        concurrent_key(key, (int)((i >> 8) % CONCURRENT_KEYS));
+        hot_cache_entry_t* entry = catzilla_static_cache_get(reader->cache, key);
+        if (!entry) continue;
+        reader->hits++;
+        if (entry->content_size != CONCURRENT_VALUE_SIZE ||
+            strncmp(entry->file_content, key, strlen(key)) != 0) {
+            reader->bad++;
+        }
+        catzilla_static_cache_release(reader->cache, entry);
+    }
+}
+
+static void test_cache_concurrent_lookups() {
+    TEST_START("cache_concurrent_lookups");
+
+    hot_cache_t cache;
+    TEST_ASSERT(catzilla_static_cache_init(&cache, 512 * 1024) == 0, "Cache init should succeed");
+
+    volatile int stop = 0;
+    cache_reader_t readers[4];
+    uv_thread_t threads[4];
+    for (int i = 0; i < 4; i++) {
+        readers[i] = (cache_reader_t){&cache, &stop, 0, 0};
+        TEST_ASSERT(uv_thread_create(&threads[i], cache_reader_thread, &readers[i]) == 0,
+                    "Reader thread should start");
+    }
+
+    char key[32];
+    for (int round = 0; round < 5; round++) {
+        for (int i = 0; i < CONCURRENT_KEYS; i++) {
+            concurrent_key(key, i);
+            char* content = catzilla_static_alloc(CONCURRENT_VALUE_SIZE);
+            memset(content, 'x', CONCURRENT_VALUE_SIZE);
+            memcpy(content, key, strlen(key));
+            if (catzilla_static_cache_put(&cache, key, content, CONCURRENT_VALUE_SIZE, 0) != 0) {
+                catzilla_free(content);
+            }
+            if (i % 7 == 0) {
+                concurrent_key(key, (i * 13) % CONCURRENT_KEYS);
+                catzilla_static_cache_remove(&cache, key);
+            }
+        }
+    }
+
+    stop = 1;
+    uint64_t hits = 0, bad = 0;
+    for (int i = 0; i < 4; i++) {
+        uv_thread_join(&threads[i]);
+        hits += readers[i].hits;
+        bad += readers[i].bad;
+    }
+    printf("%llu concurrent hits\n", (unsigned long long)hits);
+    TEST_ASSERT(bad == 0, "Lookups should only ever see whole entries");
+    TEST_ASSERT(cache.table->capacity > STATIC_CACHE_MIN_SLOTS, "Table should have grown");
+    TEST_ASSERT(catzilla_atomic_load(&cache.evictions) > 0, "Memory limit should evict");
+    TEST_ASSERT(cache.current_memory_usage <= cache.max_memory_bytes, "Memory limit should hold");
+
+    catzilla_static_cache_cleanup(&cache);
+    TEST_ASSERT(cache.retired_entries == NULL && cache.retired_tables == NULL,
+                "Nothing should wait once lookups are over");
+    catzilla_static_cache_destroy(&cache);
+
+    TEST_END("cache_concurrent_lookups");
+}
+
+// Loopback connection whose accepted end the static server writes to
+typedef struct {
+    uv_tcp_t listener;
+    uv_tcp_t client;
+    uv_tcp_t server_side;
+    bool accepted;
+    char* received;
+    size_t received_size;
+    size_t received_capacity;
+} sendfile_peer_t;
+
+static void on_peer_connection(uv_stream_t* listener, int status) {
+    sendfile_peer_t* peer = (sendfile_peer_t*)listener->data;
+    if (status != 0) return;
+    uv_tcp_init(test_loop, &peer->server_side);
+    peer->server_side.data = NULL;  // Not a server connection: written to directly
+    if (uv_accept(listener, (uv_stream_t*)&peer->server_side) == 0) {
+        // A small send buffer makes sendfile hit EAGAIN and wait for the reader
+        int size = 16 * 1024;
+        uv_send_buffer_size((uv_handle_t*)&peer->server_side, &size);
+        peer->accepted = true;
+    }
+}
+
+static void on_peer_connect(uv_connect_t* req, int status) {
+    (void)req;
+    (void)status;
+}
+
+static void alloc_peer_buffer(uv_handle_t* handle, size_t suggested, uv_buf_t* buf) {
+    (void)handle;
+    buf->base = malloc(suggested);
+    buf->len = suggested;
+}
+
+static void on_peer_read(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
+    sendfile_peer_t* peer = (sendfile_peer_t*)stream->data;
+    if (nread > 0) {
+        if (peer->received_size + nread > peer->received_capacity) {
+            peer->received_capacity = (peer->received_size + nread) * 2;
+            peer->received = realloc(peer->received, peer->received_capacity);
+        }
+        memcpy(peer->received + peer->received_size, buf->base, nread);
+        peer->received_size += nread;
+    }
+    free(buf->base);
+}
+
+// Run the loop until a whole response (head plus Content-Length bytes, or
+// a 304 head) is in
+static const char* read_peer_response(sendfile_peer_t* peer, size_t* body_len_out) {
+    peer->received_size = 0;
+    uv_read_start((uv_stream_t*)&peer->client, alloc_peer_buffer, on_peer_read);
+    for (int i = 0; i < 100000; i++) {
+        if (peer->received_size > 0) {
+            peer->received[peer->received_size < peer->received_capacity ?
+                           peer->received_size : peer->received_capacity - 1] = '\0';
+            char* end = strstr(peer->received, "\r\n\r\n");
+            char* length = strstr(peer->received, "Content-Length: ");
+            bool bodiless = strncmp(peer->received, "HTTP/1.1 304", 12) == 0;
+            if (end && (length || bodiless)) {
+                size_t body_len = length ? strtoul(length + 16, NULL, 10) : 0;
+                size_t head_len = (size_t)(end + 4 - peer->received);
+                if (peer->received_size >= head_len + body_len) {
+                    uv_read_stop((uv_stream_t*)&peer->client);
+                    *body_len_out = body_len;
+                    return end + 4;
+                }
+            }
+        }
+        uv_run(test_loop, UV_RUN_ONCE);
+    }
+    return NULL;
+}
+
+static int serve_peer(sendfile_peer_t* peer, catzilla_server_mount_t* mount, const char* path,
+                      const char* header_name, const char* header_value) {
+    static catzilla_server_t server;
+    catzilla_request_t request;
+    memset(&request, 0, sizeof(request));
+    strcpy(request.method, "GET");
+    strcpy(request.path, path);
+    catzilla_header_set_init(&request.headers);
+    if (header_value) {
+        catzilla_header_set_append_name(&request.headers, header_name, strlen(header_name));
+        catzilla_header_set_append_value(&request.headers, header_value, strlen(header_value));
+        catzilla_header_set_commit(&request.headers);
+    }
+    int rc = catzilla_static_serve_file_with_client(&server, &request, mount, path,
+                                                    (uv_stream_t*)&peer->server_side);
+    catzilla_header_set_free(&request.headers);
+    return rc;
+}
+
+static void open_peer(sendfile_peer_t* peer) {
+    memset(peer, 0, sizeof(*peer));
+    struct sockaddr_in addr;
+    uv_ip4_addr("127.0.0.1", 0, &addr);
+    uv_tcp_init(test_loop, &peer->listener);
+    peer->listener.data = peer;
+    TEST_ASSERT(uv_tcp_bind(&peer->listener, (const struct sockaddr*)&addr, 0) == 0 &&
+                uv_listen((uv_stream_t*)&peer->listener, 1, on_peer_connection) == 0,
+                "Listener should start");
+    int addr_len = sizeof(addr);
+    uv_tcp_getsockname(&peer->listener, (struct sockaddr*)&addr, &addr_len);
+
+    static uv_connect_t connect_req;
+    uv_tcp_init(test_loop, &peer->client);
+    peer->client.data = peer;
+    uv_tcp_connect(&connect_req, &peer->client, (const struct sockaddr*)&addr, on_peer_connect);
+    while (!peer->accepted) uv_run(test_loop, UV_RUN_ONCE);
+    int receive_size = 16 * 1024;
+    uv_recv_buffer_size((uv_handle_t*)&peer->client, &receive_size);
+}
+
+static void close_peer(sendfile_peer_t* peer) {
+    uv_close((uv_handle_t*)&peer->client, NULL);
+    uv_close((uv_handle_t*)&peer->server_side, NULL);
+    uv_close((uv_handle_t*)&peer->listener, NULL);
+    uv_run(test_loop, UV_RUN_NOWAIT);
+    free(peer->received);
+}
+
+static void init_test_mount(catzilla_server_mount_t* mount) {
+    memset(mount, 0, sizeof(*mount));
+    strcpy(mount->mount_path, "/static");
+    strcpy(mount->directory_path, test_dir);
+    mount->static_server = &test_server;
+}
+
+// Large files and ranges go from the file to the socket without a buffer
+static void test_sendfile_ranges() {
+    TEST_START("sendfile_ranges");
+
+    const char* big_file = "/tmp/catzilla_static_test/big.bin";
+    size_t size = 2 * STATIC_SENDFILE_MIN_SIZE + 123;
+    unsigned char* content = malloc(size);
+    for (size_t i = 0; i < size; i++) content[i] = (unsigned char)(i % 251);
+    FILE* f = fopen(big_file, "wb");
+    TEST_ASSERT(f && fwrite(content, 1, size, f) == size, "Large file should be written");
+    fclose(f);
+
+    sendfile_peer_t peer;
+    open_peer(&peer);
+    catzilla_server_mount_t mount;
+    init_test_mount(&mount);
+    test_server.config.use_sendfile = true;
+    uint64_t sendfiles = catzilla_atomic_load(&test_server.sendfile_operations);
+
+    size_t body_len = 0;
+    TEST_ASSERT(serve_peer(&peer, &mount, "/big.bin", "Range", NULL) == 0, "Large file should be served");
+    // Nobody reads for a while, so sending has to wait for the socket to drain
+    for (int i = 0; i < 50; i++) {
+        uv_run(test_loop, UV_RUN_NOWAIT);
+        usleep(1000);
+    }
+    const char* body = read_peer_response(&peer, &body_len);
+    TEST_ASSERT(body && strncmp(peer.received, "HTTP/1.1 200", 12) == 0, "Whole file should get 200");
+    TEST_ASSERT(body_len == size && memcmp(body, content, size) == 0, "Whole file should arrive intact");
+    TEST_ASSERT(catzilla_atomic_load(&test_server.sendfile_operations) == sendfiles + 1,
+                "File should be sent with sendfile");
+    TEST_ASSERT(catzilla_static_cache_get(test_server.cache, "/big.bin") == NULL,
+                "Files sent with sendfile should not be cached");
+
+    TEST_ASSERT(serve_peer(&peer, &mount, "/big.bin", "Range", "bytes=1000-1999") == 0, "Range should be served");
+    body = read_peer_response(&peer, &body_len);
+    TEST_ASSERT(body && strncmp(peer.received, "HTTP/1.1 206", 12) == 0, "Range should get 206");
+    char expected_range[64];
+    snprintf(expected_range, sizeof(expected_range), "Content-Range: bytes 1000-1999/%zu", size);
+    TEST_ASSERT(strstr(peer.received, expected_range) != NULL, "Content-Range should name the range");
+    TEST_ASSERT(body_len == 1000 && memcmp(body, content + 1000, 1000) == 0,
+                "Range bytes should arrive intact");
+
+    TEST_ASSERT(serve_peer(&peer, &mount, "/big.bin", "Range", "bytes=-10") == 0, "Suffix range should be served");
+    body = read_peer_response(&peer, &body_len);
+    TEST_ASSERT(body && body_len == 10 && memcmp(body, content + size - 10, 10) == 0,
+                "Suffix range should be the last bytes");
+
+    char past_end[64];
+    snprintf(past_end, sizeof(past_end), "bytes=%zu-", size);
+    TEST_ASSERT(serve_peer(&peer, &mount, "/big.bin", "Range", past_end) == 0, "Unsatisfiable range should be answered");
+    body = read_peer_response(&peer, &body_len);
+    TEST_ASSERT(body && strncmp(peer.received, "HTTP/1.1 416", 12) == 0 && body_len == 0,
+                "Range past the end should get 416");
+
+    test_server.config.use_sendfile = false;
+    close_peer(&peer);
+    free(content);
+    unlink(big_file);
+
+    TEST_END("sendfile_ranges");
+}
+
+static void test_accept_encoding_parsing() {
+    TEST_START("accept_encoding_parsing");
+
+    const int both = STATIC_ENCODING_GZIP | STATIC_ENCODING_BR;
+    catzilla_accept_encoding_t accept;
+
+    catzilla_compression_parse_accept_encoding(NULL, &accept);
+    TEST_ASSERT(catzilla_compression_select(&accept, both, 0, SIZE_MAX) == CATZILLA_ENCODING_IDENTITY,
+                "No header should accept nothing");
+    catzilla_compression_parse_accept_encoding("gzip, deflate, br", &accept);
+    TEST_ASSERT(catzilla_compression_select(&accept, both, 0, SIZE_MAX) == STATIC_ENCODING_BR,
+                "br should win between equal quality values");
+    catzilla_compression_parse_accept_encoding("br;q=0.5, gzip;q=0.8", &accept);
+    TEST_ASSERT(catzilla_compression_select(&accept, both, 0, SIZE_MAX) == STATIC_ENCODING_GZIP,
+                "A higher quality value should win over br");
+    catzilla_compression_parse_accept_encoding("br;q=0, gzip;q=0.8", &accept);
+    TEST_ASSERT(catzilla_compression_select(&accept, STATIC_ENCODING_BR, 0, SIZE_MAX) ==
+                CATZILLA_ENCODING_IDENTITY, "q=0 should refuse a coding");
+    catzilla_compression_parse_accept_encoding("*;q=0.5, gzip;q=0", &accept);
+    TEST_ASSERT(catzilla_compression_select(&accept, both, 0, SIZE_MAX) == STATIC_ENCODING_BR,
+                "A wildcard should cover codings not listed");
+    catzilla_compression_parse_accept_encoding("identity", &accept);
+    TEST_ASSERT(catzilla_compression_select(&accept, both, 0, SIZE_MAX) == CATZILLA_ENCODING_IDENTITY,
+                "identity should accept nothing");
+    catzilla_compression_parse_accept_encoding("GZIP", &accept);
+    TEST_ASSERT(catzilla_compression_select(&accept, both, 0, SIZE_MAX) == STATIC_ENCODING_GZIP,
+                "Coding names should be case-insensitive");
+
+    TEST_END("accept_encoding_parsing");
+}
+
+// Precompressed siblings win over the file; without one, the gzip variant
+// made on cache insert is served to clients that accept it
+static void test_precompressed_variants() {
+    TEST_START("precompressed_variants");
+
+    const char* bundle = "/tmp/catzilla_static_test/bundle.js";
+    const char* bundle_br = "/tmp/catzilla_static_test/bundle.js.br";
+    const char* br_bytes = "not really brotli";
+    FILE* f = fopen(bundle, "w");
+    for (int i = 0; i < 200; i++) fprintf(f, "console.log('line %d of a compressible bundle');\n", i);
+    fclose(f);
+    f = fopen(bundle_br, "w");
+    fputs(br_bytes, f);
+    fclose(f);
+
+    sendfile_peer_t peer;
+    open_peer(&peer);
+    catzilla_server_mount_t mount;
+    init_test_mount(&mount);
+
+    size_t body_len = 0;
+    TEST_ASSERT(serve_peer(&peer, &mount, "/bundle.js", "Accept-Encoding", "gzip, br") == 0,
+                "Bundle should be served");
+    const char* body = read_peer_response(&peer, &body_len);
+    TEST_ASSERT(body && strstr(peer.received, "Content-Encoding: br\r\n") != NULL,
+                "A br sibling should be chosen");
+    TEST_ASSERT(strstr(peer.received, "Vary: Accept-Encoding\r\n") != NULL, "Response should vary");
+    TEST_ASSERT(strstr(peer.received, "Content-Type: application/javascript") != NULL,
+                "Type should be the bundle's");
+    TEST_ASSERT(body_len == strlen(br_bytes) && memcmp(body, br_bytes, body_len) == 0,
+                "Sibling bytes should be sent");
+    TEST_ASSERT(catzilla_static_cache_get(test_server.cache, "/bundle.js") == NULL,
+                "Siblings should not be cached under the file");
+
+    // A stale sibling is ignored
+    struct timespec times[2] = {{0, UTIME_OMIT}, {time(NULL) - 3600, 0}};
+    utimensat(AT_FDCWD, bundle_br, times, 0);
+    TEST_ASSERT(serve_peer(&peer, &mount, "/bundle.js", "Accept-Encoding", "br") == 0,
+                "Bundle should be served");
+    body = read_peer_response(&peer, &body_len);
+    TEST_ASSERT(body && strstr(peer.received, "Content-Encoding") == NULL,
+                "An older sibling should not be used");
+
+    hot_cache_entry_t* entry = catzilla_static_cache_get(test_server.cache, "/bundle.js");
+    TEST_ASSERT(entry != NULL, "The bundle should be cached");
+    if (entry->is_compressed) {
+        TEST_ASSERT(entry->compressed_size < entry->content_size, "The gzip variant should be smaller");
+        TEST_ASSERT(serve_peer(&peer, &mount, "/bundle.js", "Accept-Encoding", "gzip") == 0,
+                    "Bundle should be served");
+        body = read_peer_response(&peer, &body_len);
+        TEST_ASSERT(body && strstr(peer.received, "Content-Encoding: gzip\r\n") != NULL &&
+                    body_len == entry->compressed_size &&
+                    memcmp(body, entry->compressed_content, body_len) == 0,
+                    "The cached gzip variant should be sent");
+    } else {
+        printf("Built without zlib, no gzip variant to check\n");
+    }
+    TEST_ASSERT(serve_peer(&peer, &mount, "/bundle.js", NULL, NULL) == 0, "Bundle should be served");
+    body = read_peer_response(&peer, &body_len);
+    TEST_ASSERT(body && strstr(peer.received, "Content-Encoding") == NULL &&
+                body_len == entry->content_size, "Clients without Accept-Encoding get the file");
+
+    close_peer(&peer);
+    catzilla_static_cache_release(test_server.cache, entry);
+    catzilla_static_cache_remove(test_server.cache, "/bundle.js");
+    unlink(bundle);
+    unlink(bundle_br);
+
+    TEST_END("precompressed_variants");
+}
+
+static void write_test_file(const char* path, const char* content) {
+    FILE* f = fopen(path, "w");
+    TEST_ASSERT(f && fputs(content, f) >= 0, "Test file should be written");
+    fclose(f);
+}
+
+static static_fd_entry_t* insert_test_file(static_fd_cache_t* cache, const char* path) {
+    uv_fs_t req;
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    TEST_ASSERT(fd >= 0 && uv_fs_fstat(NULL, &req, fd, NULL) == 0, "Test file should open");
+    static_fd_entry_t* entry = catzilla_static_fd_cache_insert(cache, path, fd, &req.statbuf);
+    uv_fs_req_cleanup(&req);
+    TEST_ASSERT(entry != NULL, "Open file should be cached");
+    return entry;
+}
+
+// Open files are reused until the file changes, seen by the watch or the TTL
+static void test_fd_cache() {
+    TEST_START("fd_cache");
+
+    const char* path = "/tmp/catzilla_static_test/kept_open.txt";
+    write_test_file(path, "first version");
+
+    static_fd_cache_t* cache = catzilla_static_alloc(sizeof(static_fd_cache_t));
+    TEST_ASSERT(catzilla_static_fd_cache_init(cache, 2) == 0, "fd cache should initialize");
+    bool watching = catzilla_static_fd_cache_watch(cache, test_loop, test_dir) == 0;
+
+    static_fd_entry_t* entry = insert_test_file(cache, path);
+    TEST_ASSERT(entry->size == strlen("first version"), "Entry should hold the size");
+    TEST_ASSERT(entry->etag[0] && strlen(entry->last_modified) == CATZILLA_HTTP_DATE_LEN,
+                "Entry should hold formatted validators");
+    catzilla_static_fd_cache_release(cache, entry);
+    TEST_ASSERT(catzilla_static_fd_cache_acquire(cache, path) == entry, "Same path should hit");
+    catzilla_static_fd_cache_release(cache, entry);
+
+    // Past the TTL an unchanged file is kept after a stat
+    entry->checked_at -= STATIC_FD_CACHE_TTL;
+    TEST_ASSERT(catzilla_static_fd_cache_acquire(cache, path) == entry,
+                "Unchanged file should survive revalidation");
+    catzilla_static_fd_cache_release(cache, entry);
+
+    // The loop has not run, so only the TTL can notice this change
+    write_test_file(path, "second, longer version");
+    entry->checked_at -= STATIC_FD_CACHE_TTL;
+    TEST_ASSERT(catzilla_static_fd_cache_acquire(cache, path) == NULL,
+                "Changed file should fail revalidation");
+
+    // Entries in use stay open until released
+    entry = insert_test_file(cache, path);
+    int fd = entry->fd;
+    catzilla_static_fd_cache_invalidate(cache, test_dir);
+    char buffer[8];
+    TEST_ASSERT(pread(fd, buffer, 6, 0) == 6 && memcmp(buffer, "second", 6) == 0,
+                "Invalidated entry should stay readable while in use");
+    TEST_ASSERT(catzilla_static_fd_cache_acquire(cache, path) == NULL, "Invalidated path should miss");
+    catzilla_static_fd_cache_release(cache, entry);
+
+    if (watching) {
+        catzilla_static_fd_cache_release(cache, insert_test_file(cache, path));
+        uint64_t invalidations = catzilla_atomic_load(&cache->invalidations);
+        uv_run(test_loop, UV_RUN_NOWAIT);  // Nothing pending before the change
+        write_test_file(path, "third version");
+        for (int i = 0; i < 1000 && catzilla_atomic_load(&cache->invalidations) == invalidations; i++) {
+            uv_run(test_loop, UV_RUN_NOWAIT);
+            usleep(1000);
+        }
+        TEST_ASSERT(catzilla_static_fd_cache_acquire(cache, path) == NULL,
+                    "A change seen by the watch should drop the entry");
+    } else {
+        printf("No fs event watch here, TTL only\n");
+    }
+
+    // Requests reuse the open file and answer revalidations with 304
+    sendfile_peer_t peer;
+    open_peer(&peer);
+    catzilla_server_mount_t mount;
+    init_test_mount(&mount);
+    hot_cache_t* hot_cache = test_server.cache;
+    test_server.cache = NULL;
+    test_server.fd_cache = cache;
+
+    size_t body_len = 0;
+    TEST_ASSERT(serve_peer(&peer, &mount, "/kept_open.txt", NULL, NULL) == 0, "File should be served");
+    const char* body = read_peer_response(&peer, &body_len);
+    TEST_ASSERT(body && body_len == strlen("third version"), "File should be sent whole");
+    char* etag = strstr(peer.received, "ETag: ");
+    TEST_ASSERT(etag != NULL, "Response should carry an ETag");
+    char etag_value[STATIC_MAX_ETAG_LEN + 2] = {0};
+    memcpy(etag_value, etag + 6, strcspn(etag + 6, "\r"));
+
+    uint64_t hits = catzilla_atomic_load(&cache->hits);
+    TEST_ASSERT(serve_peer(&peer, &mount, "/kept_open.txt", "If-None-Match", etag_value) == 0,
+                "Revalidation should be served");
+    read_peer_response(&peer, &body_len);
+    TEST_ASSERT(strncmp(peer.received, "HTTP/1.1 304", 12) == 0, "Current ETag should get 304");
+    TEST_ASSERT(strstr(peer.received, "Content-Length") == NULL, "304 should have no length");
+    TEST_ASSERT(catzilla_atomic_load(&cache->hits) == hits + 1, "304 should come from the open file");
+
+    TEST_ASSERT(serve_peer(&peer, &mount, "/kept_open.txt", "If-None-Match", "\"other\"") == 0,
+                "Request should be served");
+    body = read_peer_response(&peer, &body_len);
+    TEST_ASSERT(body && strncmp(peer.received, "HTTP/1.1 200", 12) == 0 &&
+                memcmp(body, "third version", body_len) == 0, "Another ETag should get the file");
+
+    close_peer(&peer);
+    test_server.cache = hot_cache;
+    test_server.fd_cache = NULL;
+    catzilla_static_fd_cache_destroy(cache);
+    uv_run(test_loop, UV_RUN_NOWAIT);
+    unlink(path);
+
+    TEST_END("fd_cache");
+}
+
 // Unity requires these functions
 void setUp(void) {
     // Test setup code
@@ -426,9 +1062,21 @@ int main() {
     test_path_validation();
     test_etag_generation();
     test_cache_operations();
+    test_cache_snapshot();
+    test_cache_set_limit();
+    test_cache_concurrent_lookups();
     test_error_responses();
     test_performance_monitoring();
     test_file_serving();  // This one uses the event loop
+    test_uring_file_loading();
+    test_accept_encoding_parsing();
+#if defined(__linux__) || defined(__APPLE__)
+    test_sendfile_ranges();
+#endif
+#ifndef _WIN32
+    test_precompressed_variants();
+    test_fd_cache();
+#endif
 
     // Cleanup
     if (test_server.cache) {
@@ -441,7 +1089,11 @@ int main() {
 
     cleanup_test_environment();
 
+    // Closing the ring's handles lets the loop close cleanly
+    uv_walk(test_loop, close_walk_cb, NULL);
+    uv_run(test_loop, UV_RUN_DEFAULT);
     uv_loop_close(test_loop);
+    catzilla_static_uring_shutdown();
     catzilla_free(test_loop);
     catzilla_memory_cleanup();
 
@@ -0,0 +1,388 @@
+// tests/c/test_task_engine.c
+#include "unity.h"
+#include "task_system.h"
+#include <stdatomic.h>
+#include <string.h>
+#include <unistd.h>
+
+static atomic_int run_count;
+static atomic_int gate_open;
+static atomic_int order_index;
+static atomic_int spawn_failures;
+static atomic_int runner_calls;
+static int order[64];
+
+void setUp(void) {
+    atomic_store(&run_count, 0);
+    atomic_store(&gate_open, 0);
+    atomic_store(&order_index, 0);
+    atomic_store(&spawn_failures, 0);
+    atomic_store(&runner_calls, 0);
+    memset(order, 0, sizeof(order));
+}
+
+void tearDown(void) {
+}
+
+static void count_task(void* data, void* result) {
+    (void)data;
+    (void)result;
+    atomic_fetch_add(&run_count, 1);
+}
+
+static void gate_task(void* data, void* result) {
+    (void)data;
+    (void)result;
+    while (!atomic_load(&gate_open)) usleep(100);
+}
+
+static void record_task(void* data, void* result) {
+    (void)result;
+    int slot = atomic_fetch_add(&order_index, 1);
+    if (slot < 64) order[slot] = *(int*)data;
+}
+
+static void sleepy_task(void* data, void* result) {
+    (void)data;
+    (void)result;
+    usleep(500);
+    atomic_fetch_add(&run_count, 1);
+}
+
+// Submits its children from a worker, so they land on that worker's deque
+static void spawn_task(void* data, void* result) {
+    (void)result;
+    task_engine_t* engine = *(task_engine_t**)data;
+    for (int i = 0; i < 200; i++) {
+        if (catzilla_task_add_c(engine, sleepy_task, NULL, 0, TASK_PRIORITY_NORMAL, 0, 0) == 0) {
+            atomic_fetch_add(&spawn_failures, 1);
+        }
+    }
+}
+
+// Fails until it has run *data times
+static void flaky_task(void* data, void* result) {
+    (void)result;
+    int runs = atomic_fetch_add(&run_count, 1) + 1;
+    if (runs < *(int*)data) {
+        catzilla_task_report_failure();
+    }
+}
+
+// Stands in for the GIL-holding runner; py_args points at the per-task cost in us
+static int fake_python_runner(catzilla_task_t** tasks, int count, uint64_t slice_ns, void* context) {
+    (void)context;
+    atomic_fetch_add(&runner_calls, 1);
+    uint64_t started = catzilla_get_nanoseconds();
+    int ran = 0;
+    while (ran < count) {
+        catzilla_task_t* task = tasks[ran++];
+        int cost_us = *(int*)task->py_task.py_args;
+        if (cost_us > 0) usleep(cost_us);
+        atomic_fetch_add(&run_count, 1);
+        task->status = TASK_STATUS_COMPLETED;
+        if (catzilla_get_nanoseconds() - started >= slice_ns) break;
+    }
+    return ran;
+}
+
+static uint64_t now_ms(void) {
+    return catzilla_get_nanoseconds() / 1000000ULL;
+}
+
+void test_queue_is_bounded_fifo() {
+    lock_free_queue_t* queue = catzilla_queue_create("test", 3, CATZILLA_MEMORY_TASK);
+    TEST_ASSERT_NOT_NULL(queue);
+
+    catzilla_task_t* tasks[4];
+    for (int i = 0; i < 4; i++) {
+        tasks[i] = catzilla_task_create(TASK_PRIORITY_NORMAL, 0, 0, CATZILLA_MEMORY_TASK);
+        TEST_ASSERT_NOT_NULL(tasks[i]);
+    }
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_TRUE(catzilla_queue_enqueue(queue, tasks[i]));
+    }
+    TEST_ASSERT_FALSE(catzilla_queue_enqueue(queue, tasks[3]));
+    TEST_ASSERT_EQUAL(1, atomic_load(&queue->overflow_count));
+    TEST_ASSERT_EQUAL(3, catzilla_queue_size(queue));
+
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL_PTR(tasks[i], catzilla_queue_dequeue(queue));
+    }
+    TEST_ASSERT_NULL(catzilla_queue_dequeue(queue));
+    TEST_ASSERT_TRUE(catzilla_queue_is_empty(queue));
+
+    // The ring wraps around cleanly
+    TEST_ASSERT_TRUE(catzilla_queue_enqueue(queue, tasks[3]));
+    TEST_ASSERT_EQUAL_PTR(tasks[3], catzilla_queue_dequeue(queue));
+
+    for (int i = 0; i < 4; i++) {
+        catzilla_task_destroy(tasks[i]);
+    }
+    catzilla_queue_destroy(queue);
+}
+
+void test_every_task_runs_once() {
+    task_engine_t* engine = catzilla_task_engine_create(4, 1, 4, 4096, false, 0);
+    TEST_ASSERT_NOT_NULL(engine);
+    TEST_ASSERT_EQUAL(0, catzilla_task_engine_start(engine));
+
+    for (int i = 0; i < 3000; i++) {
+        TEST_ASSERT_NOT_EQUAL(0, catzilla_task_add_c(engine, count_task, NULL, 0,
+                                                    (task_priority_t)(i % 4), 0, 0));
+    }
+    TEST_ASSERT_EQUAL(0, catzilla_task_engine_stop(engine, true));
+    TEST_ASSERT_EQUAL(3000, atomic_load(&run_count));
+
+    task_engine_stats_t stats = catzilla_task_engine_get_stats(engine);
+    TEST_ASSERT_EQUAL(3000, stats.total_tasks_processed);
+    TEST_ASSERT_EQUAL(0, stats.failed_tasks);
+    TEST_ASSERT_EQUAL(0, stats.total_queued);
+    TEST_ASSERT_EQUAL(4, stats.total_workers);
+    TEST_ASSERT_TRUE(stats.p99_execution_time_ms >= stats.p95_execution_time_ms);
+    TEST_ASSERT_TRUE(stats.p95_execution_time_ms > 0.0);
+
+    catzilla_task_engine_destroy(engine);
+}
+
+void test_higher_priority_lanes_run_first() {
+    task_engine_t* engine = catzilla_task_engine_create(1, 1, 1, 64, false, 0);
+    TEST_ASSERT_NOT_NULL(engine);
+
+    // Hold the only worker while both lanes fill
+    TEST_ASSERT_NOT_EQUAL(0, catzilla_task_add_c(engine, gate_task, NULL, 0,
+                                                TASK_PRIORITY_NORMAL, 0, 0));
+    usleep(20000);
+
+    int low = TASK_PRIORITY_LOW, critical = TASK_PRIORITY_CRITICAL;
+    for (int i = 0; i < 5; i++) {
+        catzilla_task_add_c(engine, record_task, &low, sizeof(int), TASK_PRIORITY_LOW, 0, 0);
+    }
+    for (int i = 0; i < 5; i++) {
+        catzilla_task_add_c(engine, record_task, &critical, sizeof(int), TASK_PRIORITY_CRITICAL, 0, 0);
+    }
+
+    task_engine_stats_t stats = catzilla_task_engine_get_stats(engine);
+    TEST_ASSERT_EQUAL(5, stats.low_queue_size);
+    TEST_ASSERT_EQUAL(5, stats.critical_queue_size);
+
+    atomic_store(&gate_open, 1);
+    catzilla_task_engine_stop(engine, true);
+
+    TEST_ASSERT_EQUAL(10, atomic_load(&order_index));
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT_EQUAL(TASK_PRIORITY_CRITICAL, order[i]);
+        TEST_ASSERT_EQUAL(TASK_PRIORITY_LOW, order[i + 5]);
+    }
+    catzilla_task_engine_destroy(engine);
+}
+
+void test_delayed_tasks_wait_until_due() {
+    task_engine_t* engine = catzilla_task_engine_create(2, 1, 2, 64, false, 0);
+    TEST_ASSERT_NOT_NULL(engine);
+
+    uint64_t start = now_ms();
+    TEST_ASSERT_NOT_EQUAL(0, catzilla_task_add_c(engine, count_task, NULL, 0,
+                                                TASK_PRIORITY_HIGH, 50, 0));
+    task_engine_stats_t stats = catzilla_task_engine_get_stats(engine);
+    TEST_ASSERT_EQUAL(1, stats.delayed_tasks);
+    TEST_ASSERT_EQUAL(0, atomic_load(&run_count));
+
+    catzilla_task_engine_stop(engine, true);
+    TEST_ASSERT_EQUAL(1, atomic_load(&run_count));
+    TEST_ASSERT_TRUE(now_ms() - start >= 50);
+    // Parked workers wake for the due time rather than the park timeout
+    TEST_ASSERT_TRUE(now_ms() - start < 50 + TASK_PARK_TIMEOUT_MS);
+
+    stats = catzilla_task_engine_get_stats(engine);
+    TEST_ASSERT_EQUAL(0, stats.delayed_tasks);
+    catzilla_task_engine_destroy(engine);
+}
+
+void test_many_delayed_tasks_all_fire() {
+    task_engine_t* engine = catzilla_task_engine_create(4, 1, 4, 64, false, 0);
+    TEST_ASSERT_NOT_NULL(engine);
+
+    // Far more timers than any injection queue holds
+    for (int i = 0; i < 10000; i++) {
+        TEST_ASSERT_NOT_EQUAL(0, catzilla_task_add_c(engine, count_task, NULL, 0,
+                                                    (task_priority_t)(i % 4), 1 + i % 80, 0));
+    }
+    TEST_ASSERT_TRUE(catzilla_task_engine_get_stats(engine).delayed_tasks > 0);
+
+    catzilla_task_engine_stop(engine, true);
+    TEST_ASSERT_EQUAL(10000, atomic_load(&run_count));
+    TEST_ASSERT_EQUAL(0, catzilla_task_engine_get_stats(engine).delayed_tasks);
+    catzilla_task_engine_destroy(engine);
+}
+
+void test_failed_tasks_retry_with_backoff() {
+    task_engine_t* engine = catzilla_task_engine_create(2, 1, 2, 64, false, 0);
+    TEST_ASSERT_NOT_NULL(engine);
+
+    int succeed_on = 3;
+    uint64_t start = now_ms();
+    TEST_ASSERT_NOT_EQUAL(0, catzilla_task_add_c(engine, flaky_task, &succeed_on, sizeof(int),
+                                                TASK_PRIORITY_NORMAL, 0, 3));
+    catzilla_task_engine_stop(engine, true);
+    TEST_ASSERT_EQUAL(3, atomic_load(&run_count));
+    // Jitter keeps at least half of each backoff
+    TEST_ASSERT_TRUE(now_ms() - start >= TASK_RETRY_BASE_DELAY_MS / 2 + TASK_RETRY_BASE_DELAY_MS);
+
+    task_engine_stats_t stats = catzilla_task_engine_get_stats(engine);
+    TEST_ASSERT_EQUAL(2, stats.retry_count);
+    TEST_ASSERT_EQUAL(0, stats.failed_tasks);
+    TEST_ASSERT_EQUAL(1, stats.total_tasks_processed);
+    TEST_ASSERT_EQUAL(0, stats.delayed_tasks);
+    catzilla_task_engine_destroy(engine);
+}
+
+void test_retries_run_out() {
+    task_engine_t* engine = catzilla_task_engine_create(1, 1, 1, 64, false, 0);
+    TEST_ASSERT_NOT_NULL(engine);
+
+    int never = 1000;
+    TEST_ASSERT_NOT_EQUAL(0, catzilla_task_add_c(engine, flaky_task, &never, sizeof(int),
+                                                TASK_PRIORITY_NORMAL, 0, 2));
+    catzilla_task_engine_stop(engine, true);
+    TEST_ASSERT_EQUAL(3, atomic_load(&run_count));
+
+    task_engine_stats_t stats = catzilla_task_engine_get_stats(engine);
+    TEST_ASSERT_EQUAL(2, stats.retry_count);
+    TEST_ASSERT_EQUAL(1, stats.failed_tasks);
+    TEST_ASSERT_EQUAL(0, stats.total_tasks_processed);
+
+    // Only a running task can report failure
+    TEST_ASSERT_EQUAL(-1, catzilla_task_report_failure());
+    catzilla_task_engine_destroy(engine);
+}
+
+void test_python_tasks_share_runner_calls() {
+    task_engine_t* engine = catzilla_task_engine_create(1, 1, 1, 1024, false, 0);
+    TEST_ASSERT_NOT_NULL(engine);
+    TEST_ASSERT_EQUAL(0, catzilla_task_engine_set_python_runner(engine, fake_python_runner, NULL,
+                                                                TASK_PYTHON_DEFAULT_SLICE_US));
+
+    // Hold the only worker so the Python tasks pile up
+    TEST_ASSERT_NOT_EQUAL(0, catzilla_task_add_c(engine, gate_task, NULL, 0,
+                                                TASK_PRIORITY_NORMAL, 0, 0));
+    static int free_task = 0;
+    int callable = 1;
+    for (int i = 0; i < 640; i++) {
+        TEST_ASSERT_NOT_EQUAL(0, catzilla_task_add_python(engine, &callable, &free_task, NULL,
+                                                         TASK_PRIORITY_NORMAL, 0, 0));
+    }
+    atomic_store(&gate_open, 1);
+    catzilla_task_engine_stop(engine, true);
+
+    TEST_ASSERT_EQUAL(640, atomic_load(&run_count));
+    TEST_ASSERT_TRUE(atomic_load(&runner_calls) <= 640 / 16);
+
+    task_engine_stats_t stats = catzilla_task_engine_get_stats(engine);
+    TEST_ASSERT_EQUAL(atomic_load(&runner_calls), stats.python_batches);
+    TEST_ASSERT_EQUAL(640, stats.python_batched_tasks);
+    TEST_ASSERT_EQUAL(641, stats.total_tasks_processed);
+    catzilla_task_engine_destroy(engine);
+}
+
+void test_python_batches_shrink_to_the_slice() {
+    task_engine_t* engine = catzilla_task_engine_create(1, 1, 1, 1024, false, 0);
+    TEST_ASSERT_NOT_NULL(engine);
+    TEST_ASSERT_EQUAL(0, catzilla_task_engine_set_python_runner(engine, fake_python_runner, NULL, 2000));
+
+    TEST_ASSERT_NOT_EQUAL(0, catzilla_task_add_c(engine, gate_task, NULL, 0,
+                                                TASK_PRIORITY_NORMAL, 0, 0));
+    static int slow_task = 1000;
+    int callable = 1;
+    for (int i = 0; i < 60; i++) {
+        TEST_ASSERT_NOT_EQUAL(0, catzilla_task_add_python(engine, &callable, &slow_task, NULL,
+                                                         TASK_PRIORITY_NORMAL, 0, 0));
+    }
+    atomic_store(&gate_open, 1);
+    catzilla_task_engine_stop(engine, true);
+    TEST_ASSERT_EQUAL(60, atomic_load(&run_count));
+
+    // Tasks costing 1 ms or more fit one or two to a 2 ms slice
+    task_engine_stats_t stats = catzilla_task_engine_get_stats(engine);
+    TEST_ASSERT_TRUE(stats.python_slice_stops > 0);
+    TEST_ASSERT_TRUE(stats.python_batch_size <= 4);
+    TEST_ASSERT_EQUAL(60, stats.python_batched_tasks);
+    catzilla_task_engine_destroy(engine);
+}
+
+void test_idle_workers_steal_spawned_tasks() {
+    task_engine_t* engine = catzilla_task_engine_create(4, 1, 4, 1024, false, 0);
+    TEST_ASSERT_NOT_NULL(engine);
+
+    TEST_ASSERT_NOT_EQUAL(0, catzilla_task_add_c(engine, spawn_task, &engine, sizeof(engine),
+                                                TASK_PRIORITY_NORMAL, 0, 0));
+    catzilla_task_engine_stop(engine, true);
+    TEST_ASSERT_EQUAL(0, atomic_load(&spawn_failures));
+    TEST_ASSERT_EQUAL(200, atomic_load(&run_count));
+
+    task_engine_stats_t stats = catzilla_task_engine_get_stats(engine);
+    TEST_ASSERT_TRUE(stats.steal_count > 0);
+    TEST_ASSERT_EQUAL(201, stats.total_tasks_processed);
+    catzilla_task_engine_destroy(engine);
+}
+
+void test_pool_scales_within_limits() {
+    task_engine_t* engine = catzilla_task_engine_create(1, 1, 4, 256, false, 0);
+    TEST_ASSERT_NOT_NULL(engine);
+    worker_pool_t* pool = engine->pool;
+
+    TEST_ASSERT_EQUAL(2, catzilla_worker_pool_scale_up(pool, 2));
+    TEST_ASSERT_EQUAL(1, catzilla_worker_pool_scale_up(pool, 5));
+    TEST_ASSERT_EQUAL(4, catzilla_task_engine_get_stats(engine).total_workers);
+
+    for (int i = 0; i < 100; i++) {
+        TEST_ASSERT_NOT_EQUAL(0, catzilla_task_add_c(engine, count_task, NULL, 0,
+                                                    TASK_PRIORITY_NORMAL, 0, 0));
+    }
+
+    // Shrinking stops at min_workers and keeps queued work
+    TEST_ASSERT_EQUAL(3, catzilla_worker_pool_scale_down(pool, 10));
+    TEST_ASSERT_EQUAL(1, catzilla_task_engine_get_stats(engine).total_workers);
+    TEST_ASSERT_EQUAL(-1, catzilla_worker_pool_scale_down(pool, -1));
+
+    catzilla_task_engine_stop(engine, true);
+    TEST_ASSERT_EQUAL(100, atomic_load(&run_count));
+    int optimal = catzilla_worker_pool_get_optimal_size(pool);
+    TEST_ASSERT_TRUE(optimal >= 1 && optimal <= 4);
+    catzilla_task_engine_destroy(engine);
+}
+
+void test_invalid_submissions_are_rejected() {
+    task_engine_t* engine = catzilla_task_engine_create(1, 1, 1, 64, false, 0);
+    TEST_ASSERT_NOT_NULL(engine);
+
+    TEST_ASSERT_EQUAL(0, catzilla_task_add_c(engine, NULL, NULL, 0, TASK_PRIORITY_NORMAL, 0, 0));
+    TEST_ASSERT_EQUAL(0, catzilla_task_add_c(engine, count_task, NULL, 0, (task_priority_t)7, 0, 0));
+    TEST_ASSERT_NULL(catzilla_task_engine_create(1, 2, 1, 64, false, 0));
+
+    // Python tasks need a runner
+    int callable = 1, args = 0;
+    TEST_ASSERT_EQUAL(0, catzilla_task_add_python(engine, &callable, &args, NULL, TASK_PRIORITY_NORMAL, 0, 0));
+    TEST_ASSERT_EQUAL(-1, catzilla_task_engine_set_python_runner(engine, NULL, NULL, 2000));
+
+    catzilla_task_engine_destroy(engine);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_queue_is_bounded_fifo);
+    RUN_TEST(test_every_task_runs_once);
+    RUN_TEST(test_higher_priority_lanes_run_first);
+    RUN_TEST(test_delayed_tasks_wait_until_due);
+    RUN_TEST(test_many_delayed_tasks_all_fire);
+    RUN_TEST(test_failed_tasks_retry_with_backoff);
+    RUN_TEST(test_retries_run_out);
+    RUN_TEST(test_python_tasks_share_runner_calls);
+    RUN_TEST(test_python_batches_shrink_to_the_slice);
+    RUN_TEST(test_idle_workers_steal_spawned_tasks);
+    RUN_TEST(test_pool_scales_within_limits);
+    RUN_TEST(test_invalid_submissions_are_rejected);
+
+    return UNITY_END();
+}
@@ -0,0 +1,230 @@
+// tests/c/test_task_log.c
+#include "unity.h"
+#include "task_log.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#ifndef _WIN32
+#include <dirent.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+static char test_dir[256];
+
+typedef struct {
+    int count;
+    uint64_t ids[64];
+    char payloads[64][32];
+} replay_capture_t;
+
+static catzilla_task_log_t* open_log(size_t segment_size, bool background) {
+    catzilla_task_log_config_t config = {0};
+    config.segment_size = segment_size;
+    config.no_background = !background;
+    return catzilla_task_log_open(test_dir, &config);
+}
+
+static void remove_test_dir(void) {
+#ifndef _WIN32
+    DIR* dir = opendir(test_dir);
+    if (!dir) return;
+    struct dirent* item;
+    char path[512];
+    while ((item = readdir(dir)) != NULL) {
+        if (item->d_name[0] == '.') continue;
+        snprintf(path, sizeof(path), "%s/%s", test_dir, item->d_name);
+        unlink(path);
+    }
+    closedir(dir);
+    rmdir(test_dir);
+#endif
+}
+
+static void capture(uint64_t entry_id, const void* payload, size_t size, void* context) {
+    replay_capture_t* out = context;
+    if (out->count >= 64) return;
+    out->ids[out->count] = entry_id;
+    size_t n = size < 31 ? size : 31;
+    memcpy(out->payloads[out->count], payload, n);
+    out->payloads[out->count][n] = '\0';
+    out->count++;
+}
+
+void setUp(void) {
+#ifndef _WIN32
+    snprintf(test_dir, sizeof(test_dir), "/tmp/catzilla_task_log_test_%d", (int)getpid());
+#endif
+    remove_test_dir();
+}
+
+void tearDown(void) {
+    remove_test_dir();
+}
+
+void test_pending_tasks_survive_reopen() {
+#ifndef _WIN32
+    catzilla_task_log_t* log = open_log(0, false);
+    TEST_ASSERT_NOT_NULL(log);
+
+    uint64_t first, second, third;
+    TEST_ASSERT_EQUAL(0, catzilla_task_log_append(log, "warm:/home", 10, true, &first));
+    TEST_ASSERT_EQUAL(0, catzilla_task_log_append(log, "audit:42", 8, true, &second));
+    TEST_ASSERT_EQUAL(0, catzilla_task_log_append(log, "mail:7", 6, true, &third));
+    TEST_ASSERT_TRUE(first < second && second < third);
+    TEST_ASSERT_EQUAL(0, catzilla_task_log_complete(log, second));
+    TEST_ASSERT_EQUAL(-1, catzilla_task_log_complete(log, second));
+    catzilla_task_log_close(log);
+
+    log = open_log(0, false);
+    TEST_ASSERT_NOT_NULL(log);
+    catzilla_task_log_stats_t stats;
+    catzilla_task_log_get_stats(log, &stats);
+    TEST_ASSERT_EQUAL(2, stats.replayed);
+    TEST_ASSERT_EQUAL(2, stats.pending);
+
+    replay_capture_t seen = {0};
+    TEST_ASSERT_EQUAL(2, catzilla_task_log_replay(log, capture, &seen));
+    TEST_ASSERT_EQUAL(first, seen.ids[0]);
+    TEST_ASSERT_EQUAL_STRING("warm:/home", seen.payloads[0]);
+    TEST_ASSERT_EQUAL(third, seen.ids[1]);
+    TEST_ASSERT_EQUAL_STRING("mail:7", seen.payloads[1]);
+
+    // IDs keep growing across restarts
+    uint64_t fourth;
+    TEST_ASSERT_EQUAL(0, catzilla_task_log_append(log, "x", 1, false, &fourth));
+    TEST_ASSERT_TRUE(fourth > third);
+    catzilla_task_log_close(log);
+#endif
+}
+
+void test_torn_append_is_ignored() {
+#ifndef _WIN32
+    catzilla_task_log_t* log = open_log(0, false);
+    TEST_ASSERT_NOT_NULL(log);
+    uint64_t id;
+    TEST_ASSERT_EQUAL(0, catzilla_task_log_append(log, "kept", 4, true, &id));
+    catzilla_task_log_close(log);
+
+    // A crash mid-append leaves a partial record behind the good one
+    char path[512];
+    snprintf(path, sizeof(path), "%s/wal-00000000.czq", test_dir);
+    int fd = open(path, O_WRONLY | O_APPEND);
+    TEST_ASSERT_TRUE(fd >= 0);
+    const char torn[] = "CZQ1\x01\0\0\0garbage";
+    TEST_ASSERT_EQUAL(sizeof(torn), write(fd, torn, sizeof(torn)));
+    close(fd);
+
+    log = open_log(0, false);
+    TEST_ASSERT_NOT_NULL(log);
+    replay_capture_t seen = {0};
+    TEST_ASSERT_EQUAL(1, catzilla_task_log_replay(log, capture, &seen));
+    TEST_ASSERT_EQUAL_STRING("kept", seen.payloads[0]);
+    catzilla_task_log_close(log);
+#endif
+}
+
+void test_compaction_drops_done_segments() {
+#ifndef _WIN32
+    // Room for about three records per segment
+    catzilla_task_log_t* log = open_log(200, false);
+    TEST_ASSERT_NOT_NULL(log);
+
+    uint64_t ids[30];
+    char payload[40];
+    for (int i = 0; i < 30; i++) {
+        int n = snprintf(payload, sizeof(payload), "task-%02d-padding-padding", i);
+        TEST_ASSERT_EQUAL(0, catzilla_task_log_append(log, payload, (size_t)n, false, &ids[i]));
+    }
+    // Everything but the first task finishes
+    for (int i = 1; i < 30; i++) {
+        TEST_ASSERT_EQUAL(0, catzilla_task_log_complete(log, ids[i]));
+    }
+    TEST_ASSERT_EQUAL(0, catzilla_task_log_sync(log));
+
+    catzilla_task_log_stats_t before, after;
+    catzilla_task_log_get_stats(log, &before);
+    TEST_ASSERT_TRUE(before.segments > 5);
+
+    TEST_ASSERT_TRUE(catzilla_task_log_compact(log) > 0);
+    catzilla_task_log_get_stats(log, &after);
+    TEST_ASSERT_TRUE(after.segments < before.segments);
+    TEST_ASSERT_EQUAL(1, after.moved);
+    TEST_ASSERT_EQUAL(1, after.pending);
+    catzilla_task_log_close(log);
+
+    // The straggler was copied forward and keeps its ID
+    log = open_log(200, false);
+    TEST_ASSERT_NOT_NULL(log);
+    replay_capture_t seen = {0};
+    TEST_ASSERT_EQUAL(1, catzilla_task_log_replay(log, capture, &seen));
+    TEST_ASSERT_EQUAL(ids[0], seen.ids[0]);
+    TEST_ASSERT_EQUAL_STRING("task-00-padding-padding", seen.payloads[0]);
+    catzilla_task_log_close(log);
+#endif
+}
+
+#ifndef _WIN32
+static void* durable_appender(void* arg) {
+    catzilla_task_log_t* log = arg;
+    for (int i = 0; i < 200; i++) {
+        uint64_t id;
+        if (catzilla_task_log_append(log, "durable", 7, true, &id) != 0) return (void*)1;
+    }
+    return NULL;
+}
+#endif
+
+void test_group_commit_shares_fsyncs() {
+#ifndef _WIN32
+    catzilla_task_log_t* log = open_log(0, true);
+    TEST_ASSERT_NOT_NULL(log);
+
+    pthread_t threads[4];
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL(0, pthread_create(&threads[i], NULL, durable_appender, log));
+    }
+    for (int i = 0; i < 4; i++) {
+        void* failed = NULL;
+        pthread_join(threads[i], &failed);
+        TEST_ASSERT_NULL(failed);
+    }
+
+    catzilla_task_log_stats_t stats;
+    catzilla_task_log_get_stats(log, &stats);
+    TEST_ASSERT_EQUAL(800, stats.appended);
+    TEST_ASSERT_EQUAL(800, stats.pending);
+    TEST_ASSERT_TRUE(stats.syncs < stats.appended);
+    catzilla_task_log_close(log);
+#endif
+}
+
+void test_invalid_arguments_are_rejected() {
+#ifndef _WIN32
+    uint64_t id = 99;
+    TEST_ASSERT_EQUAL(-1, catzilla_task_log_append(NULL, "x", 1, false, &id));
+    TEST_ASSERT_EQUAL(0, id);
+    TEST_ASSERT_EQUAL(-1, catzilla_task_log_complete(NULL, 1));
+    TEST_ASSERT_NULL(catzilla_task_log_open(NULL, NULL));
+
+    catzilla_task_log_t* log = open_log(0, false);
+    TEST_ASSERT_NOT_NULL(log);
+    TEST_ASSERT_EQUAL(-1, catzilla_task_log_append(log, NULL, 4, false, &id));
+    TEST_ASSERT_EQUAL(-1, catzilla_task_log_complete(log, 12345));
+    TEST_ASSERT_EQUAL(0, catzilla_task_log_replay(log, capture, &(replay_capture_t){0}));
+    catzilla_task_log_close(log);
+#endif
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_pending_tasks_survive_reopen);
+    RUN_TEST(test_torn_append_is_ignored);
+    RUN_TEST(test_compaction_drops_done_segments);
+    RUN_TEST(test_group_commit_shares_fsyncs);
+    RUN_TEST(test_invalid_arguments_are_rejected);
+
+    return UNITY_END();
+}
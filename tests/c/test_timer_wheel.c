@@ -0,0 +1,254 @@
+// tests/c/test_timer_wheel.c
+#include "unity.h"
+#include "timer_wheel.h"
+#include <string.h>
+
+#define TICK_MS 100
+
+static catzilla_timer_wheel_t wheel;
+static uint64_t fired_at[16];
+static int fired_count;
+static uint64_t clock_ms;
+
+void setUp(void) {
+    catzilla_timer_wheel_init(&wheel, 1000, TICK_MS);
+    memset(fired_at, 0, sizeof(fired_at));
+    fired_count = 0;
+    clock_ms = 1000;
+}
+
+void tearDown(void) {
+}
+
+static void record_fire(catzilla_timer_entry_t* entry) {
+    (void)entry;
+    if (fired_count < 16) {
+        fired_at[fired_count] = clock_ms;
+    }
+    fired_count++;
+}
+
+// Move the clock forward one tick at a time, as the loop timer does
+static void run_until(uint64_t until_ms) {
+    while (clock_ms < until_ms) {
+        clock_ms += TICK_MS;
+        catzilla_timer_wheel_advance(&wheel, clock_ms);
+    }
+}
+
+void test_fires_after_timeout(void) {
+    catzilla_timer_entry_t entry;
+    catzilla_timer_entry_init(&entry, record_fire, NULL);
+
+    catzilla_timer_wheel_schedule(&wheel, &entry, clock_ms, 350);
+    TEST_ASSERT_TRUE(catzilla_timer_entry_pending(&entry));
+
+    run_until(1300);
+    TEST_ASSERT_EQUAL(0, fired_count);
+
+    run_until(1400);
+    TEST_ASSERT_EQUAL(1, fired_count);
+    TEST_ASSERT_FALSE(catzilla_timer_entry_pending(&entry));
+    TEST_ASSERT_EQUAL(0, wheel.count);
+}
+
+void test_zero_timeout_waits_one_tick(void) {
+    catzilla_timer_entry_t entry;
+    catzilla_timer_entry_init(&entry, record_fire, NULL);
+
+    catzilla_timer_wheel_schedule(&wheel, &entry, clock_ms, 0);
+    TEST_ASSERT_EQUAL(0, catzilla_timer_wheel_advance(&wheel, clock_ms));
+    TEST_ASSERT_EQUAL(1, catzilla_timer_wheel_advance(&wheel, clock_ms + TICK_MS));
+}
+
+void test_cancel_and_reschedule(void) {
+    catzilla_timer_entry_t first, second;
+    catzilla_timer_entry_init(&first, record_fire, NULL);
+    catzilla_timer_entry_init(&second, record_fire, NULL);
+
+    catzilla_timer_wheel_schedule(&wheel, &first, clock_ms, 500);
+    catzilla_timer_wheel_schedule(&wheel, &second, clock_ms, 500);
+    catzilla_timer_wheel_cancel(&wheel, &first);
+    catzilla_timer_wheel_cancel(&wheel, &first);
+    TEST_ASSERT_FALSE(catzilla_timer_entry_pending(&first));
+    TEST_ASSERT_EQUAL(1, wheel.count);
+
+    // Rescheduling replaces the deadline instead of adding a second one
+    run_until(1300);
+    catzilla_timer_wheel_schedule(&wheel, &second, clock_ms, 1000);
+    catzilla_timer_wheel_schedule(&wheel, &second, clock_ms, 1000);
+    TEST_ASSERT_EQUAL(1, wheel.count);
+
+    run_until(2200);
+    TEST_ASSERT_EQUAL(0, fired_count);
+    run_until(2300);
+    TEST_ASSERT_EQUAL(1, fired_count);
+    TEST_ASSERT_EQUAL(2300, fired_at[0]);
+}
+
+void test_cascades_through_levels(void) {
+    // One timer per level; every one must fire on its own tick
+    static const uint64_t timeouts[] = {
+        100ull * 10,            // level 0
+        100ull * 100,           // level 1
+        100ull * 5000,          // level 2
+        100ull * 300000,        // level 3
+    };
+    catzilla_timer_entry_t entries[4];
+    for (int i = 0; i < 4; i++) {
+        catzilla_timer_entry_init(&entries[i], record_fire, NULL);
+        catzilla_timer_wheel_schedule(&wheel, &entries[i], clock_ms, timeouts[i]);
+    }
+
+    // Start mid-slot so cascading does not line up with tick 0
+    uint64_t start = clock_ms;
+    for (int i = 0; i < 4; i++) {
+        run_until(start + timeouts[i] - TICK_MS);
+        TEST_ASSERT_EQUAL(i, fired_count);
+        run_until(start + timeouts[i]);
+        TEST_ASSERT_EQUAL(i + 1, fired_count);
+        TEST_ASSERT_EQUAL(start + timeouts[i], fired_at[i]);
+    }
+    TEST_ASSERT_EQUAL(0, wheel.count);
+}
+
+void test_large_clock_jump(void) {
+    catzilla_timer_entry_t near, far;
+    catzilla_timer_entry_init(&near, record_fire, NULL);
+    catzilla_timer_entry_init(&far, record_fire, NULL);
+
+    run_until(1700);
+    catzilla_timer_wheel_schedule(&wheel, &near, clock_ms, 200);
+    catzilla_timer_wheel_schedule(&wheel, &far, clock_ms, 100 * 7000);
+
+    // A stalled loop catches up in a single advance
+    TEST_ASSERT_EQUAL(1, catzilla_timer_wheel_advance(&wheel, clock_ms + 100 * 6999));
+    TEST_ASSERT_EQUAL(1, catzilla_timer_wheel_advance(&wheel, clock_ms + 100 * 7000));
+
+    // An empty wheel skips idle time without walking it
+    TEST_ASSERT_EQUAL(0, catzilla_timer_wheel_advance(&wheel, clock_ms + 100ull * 1000000));
+    catzilla_timer_wheel_schedule(&wheel, &near, clock_ms + 100ull * 1000000, 100);
+    TEST_ASSERT_EQUAL(1, catzilla_timer_wheel_advance(&wheel, clock_ms + 100ull * 1000001));
+}
+
+static catzilla_timer_wheel_t* callback_wheel;
+static catzilla_timer_entry_t* callback_victim;
+
+static void cancel_victim(catzilla_timer_entry_t* entry) {
+    (void)entry;
+    fired_count++;
+    catzilla_timer_wheel_cancel(callback_wheel, callback_victim);
+}
+
+static void reschedule_self(catzilla_timer_entry_t* entry) {
+    fired_count++;
+    if (fired_count < 3) {
+        catzilla_timer_wheel_schedule(callback_wheel, entry, clock_ms, TICK_MS);
+    }
+}
+
+void test_callbacks_may_modify_wheel(void) {
+    catzilla_timer_entry_t killer, victim;
+    catzilla_timer_entry_init(&killer, cancel_victim, NULL);
+    catzilla_timer_entry_init(&victim, record_fire, NULL);
+    callback_wheel = &wheel;
+    callback_victim = &victim;
+
+    // Both share a slot; the one firing first cancels the other
+    catzilla_timer_wheel_schedule(&wheel, &victim, clock_ms, 200);
+    catzilla_timer_wheel_schedule(&wheel, &killer, clock_ms, 200);
+    run_until(1200);
+    TEST_ASSERT_EQUAL(1, fired_count);
+    TEST_ASSERT_EQUAL(0, wheel.count);
+
+    fired_count = 0;
+    catzilla_timer_entry_t repeating;
+    catzilla_timer_entry_init(&repeating, reschedule_self, NULL);
+    catzilla_timer_wheel_schedule(&wheel, &repeating, clock_ms, TICK_MS);
+    run_until(clock_ms + 10 * TICK_MS);
+    TEST_ASSERT_EQUAL(3, fired_count);
+    TEST_ASSERT_FALSE(catzilla_timer_entry_pending(&repeating));
+}
+
+void test_many_entries(void) {
+    static catzilla_timer_entry_t entries[1000];
+    for (int i = 0; i < 1000; i++) {
+        catzilla_timer_entry_init(&entries[i], record_fire, NULL);
+        catzilla_timer_wheel_schedule(&wheel, &entries[i], clock_ms, (uint64_t)(i + 1) * TICK_MS);
+    }
+    TEST_ASSERT_EQUAL(1000, wheel.count);
+
+    for (int i = 0; i < 1000; i += 2) {
+        catzilla_timer_wheel_cancel(&wheel, &entries[i]);
+    }
+    run_until(clock_ms + 1000 * TICK_MS);
+    TEST_ASSERT_EQUAL(500, fired_count);
+    TEST_ASSERT_EQUAL(0, wheel.count);
+}
+
+void test_next_expiry_bounds_the_wait(void) {
+    TEST_ASSERT_EQUAL_UINT64(UINT64_MAX, catzilla_timer_wheel_next_expiry(&wheel, clock_ms));
+
+    catzilla_timer_entry_t soon, later;
+    catzilla_timer_entry_init(&soon, record_fire, NULL);
+    catzilla_timer_entry_init(&later, record_fire, NULL);
+
+    catzilla_timer_wheel_schedule(&wheel, &later, clock_ms, 1000 * TICK_MS);
+    // Tick 0 is where upper levels cascade, so it may be due right away
+    TEST_ASSERT_EQUAL_UINT64(0, catzilla_timer_wheel_next_expiry(&wheel, clock_ms));
+    catzilla_timer_wheel_advance(&wheel, clock_ms);
+
+    // With only an upper-level entry, the bound is the next level 0 wrap
+    TEST_ASSERT_EQUAL_UINT64(64 * TICK_MS, catzilla_timer_wheel_next_expiry(&wheel, clock_ms));
+
+    catzilla_timer_wheel_schedule(&wheel, &soon, clock_ms, 350);
+    TEST_ASSERT_EQUAL_UINT64(400, catzilla_timer_wheel_next_expiry(&wheel, clock_ms));
+    TEST_ASSERT_EQUAL_UINT64(50, catzilla_timer_wheel_next_expiry(&wheel, clock_ms + 350));
+
+    run_until(1400);
+    TEST_ASSERT_EQUAL(1, fired_count);
+    TEST_ASSERT_EQUAL_UINT64(6400 - 400, catzilla_timer_wheel_next_expiry(&wheel, clock_ms));
+}
+
+static int cleared_count;
+
+static void count_cleared(catzilla_timer_entry_t* entry) {
+    (void)entry;
+    cleared_count++;
+}
+
+void test_clear_removes_every_level(void) {
+    catzilla_timer_entry_t entries[3];
+    uint64_t timeouts[3] = {TICK_MS, 100 * TICK_MS, 10000 * TICK_MS};
+    for (int i = 0; i < 3; i++) {
+        catzilla_timer_entry_init(&entries[i], record_fire, NULL);
+        catzilla_timer_wheel_schedule(&wheel, &entries[i], clock_ms, timeouts[i]);
+    }
+
+    cleared_count = 0;
+    TEST_ASSERT_EQUAL(3, catzilla_timer_wheel_clear(&wheel, count_cleared));
+    TEST_ASSERT_EQUAL(3, cleared_count);
+    TEST_ASSERT_EQUAL(0, wheel.count);
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_FALSE(catzilla_timer_entry_pending(&entries[i]));
+    }
+
+    run_until(clock_ms + 200 * TICK_MS);
+    TEST_ASSERT_EQUAL(0, fired_count);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_fires_after_timeout);
+    RUN_TEST(test_zero_timeout_waits_one_tick);
+    RUN_TEST(test_cancel_and_reschedule);
+    RUN_TEST(test_cascades_through_levels);
+    RUN_TEST(test_large_clock_jump);
+    RUN_TEST(test_callbacks_may_modify_wheel);
+    RUN_TEST(test_many_entries);
+    RUN_TEST(test_next_expiry_bounds_the_wait);
+    RUN_TEST(test_clear_removes_every_level);
+
+    return UNITY_END();
+}
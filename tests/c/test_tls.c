@@ -0,0 +1,308 @@
+// tests/c/test_tls.c
+#include "unity.h"
+#include "tls.h"
+#include "memory.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef CATZILLA_HAS_TLS
+
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#define TEST_CERT_FILE "catzilla_test_tls_cert.pem"
+#define TEST_KEY_FILE "catzilla_test_tls_key.pem"
+
+static catzilla_tls_context_t* context;
+static catzilla_tls_session_t* session;
+static SSL_CTX* client_ctx;
+
+typedef struct {
+    SSL* ssl;
+    BIO* rbio;
+    BIO* wbio;
+} test_client_t;
+
+static test_client_t client;
+
+// Self-signed P-256 certificate, written next to the test binary
+static void write_test_certificate(void) {
+    EVP_PKEY* key = EVP_EC_gen("P-256");
+    X509* cert = X509_new();
+    ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+    X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+    X509_gmtime_adj(X509_getm_notAfter(cert), 3600);
+    X509_set_pubkey(cert, key);
+    X509_NAME* name = X509_get_subject_name(cert);
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, (const unsigned char*)"localhost", -1, -1, 0);
+    X509_set_issuer_name(cert, name);
+    X509_sign(cert, key, EVP_sha256());
+
+    FILE* f = fopen(TEST_CERT_FILE, "w");
+    PEM_write_X509(f, cert);
+    fclose(f);
+    f = fopen(TEST_KEY_FILE, "w");
+    PEM_write_PrivateKey(f, key, NULL, NULL, 0, NULL, NULL);
+    fclose(f);
+
+    X509_free(cert);
+    EVP_PKEY_free(key);
+}
+
+static void client_start(const unsigned char* alpn, unsigned int alpn_len, SSL_SESSION* resume) {
+    client.ssl = SSL_new(client_ctx);
+    client.rbio = BIO_new(BIO_s_mem());
+    client.wbio = BIO_new(BIO_s_mem());
+    BIO_set_mem_eof_return(client.rbio, -1);
+    SSL_set_bio(client.ssl, client.rbio, client.wbio);
+    SSL_set_connect_state(client.ssl);
+    if (alpn) SSL_set_alpn_protos(client.ssl, alpn, alpn_len);
+    if (resume) SSL_set_session(client.ssl, resume);
+}
+
+static void client_stop(void) {
+    SSL_free(client.ssl);
+    memset(&client, 0, sizeof(client));
+}
+
+static int client_to_server(void) {
+    char buf[16384];
+    int n;
+    int rc = 0;
+    while ((n = BIO_read(client.wbio, buf, sizeof(buf))) > 0) {
+        rc |= catzilla_tls_session_feed(session, buf, (size_t)n);
+    }
+    return rc;
+}
+
+static void server_to_client(void) {
+    size_t length;
+    char* data;
+    while ((data = catzilla_tls_session_take_output(session, &length)) != NULL) {
+        BIO_write(client.rbio, data, (int)length);
+        catzilla_response_free(data);
+    }
+}
+
+static bool run_handshake(void) {
+    for (int round = 0; round < 8; round++) {
+        SSL_do_handshake(client.ssl);
+        if (client_to_server() != 0) return false;
+        server_to_client();
+        if (SSL_is_init_finished(client.ssl) && catzilla_tls_session_handshake_done(session)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Send a request, answer it and read the answer; the client picks up the
+// session tickets on the way
+static void exchange(const char* request, const char* response) {
+    char buf[256];
+    TEST_ASSERT_EQUAL((int)strlen(request), SSL_write(client.ssl, request, (int)strlen(request)));
+    TEST_ASSERT_EQUAL(0, client_to_server());
+
+    ssize_t n = catzilla_tls_session_read(session, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL((ssize_t)strlen(request), n);
+    TEST_ASSERT_EQUAL_MEMORY(request, buf, (size_t)n);
+    TEST_ASSERT_EQUAL(0, catzilla_tls_session_read(session, buf, sizeof(buf)));
+
+    TEST_ASSERT_EQUAL(0, catzilla_tls_session_write(session, response, strlen(response)));
+    server_to_client();
+    int got = SSL_read(client.ssl, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL((int)strlen(response), got);
+    TEST_ASSERT_EQUAL_MEMORY(response, buf, (size_t)got);
+}
+
+void setUp(void) {
+    session = NULL;
+}
+
+void tearDown(void) {
+    if (session) catzilla_tls_session_free(session);
+    session = NULL;
+    if (client.ssl) client_stop();
+}
+
+void test_context_rejects_missing_files() {
+    TEST_ASSERT_NULL(catzilla_tls_context_create("missing_cert.pem", "missing_key.pem", false));
+    TEST_ASSERT_NULL(catzilla_tls_context_create(TEST_CERT_FILE, NULL, false));
+}
+
+void test_handshake_selects_h2() {
+    static const unsigned char alpn[] = "\x02h2\x08http/1.1";
+    session = catzilla_tls_session_create(context, -1, true);
+    TEST_ASSERT_NOT_NULL(session);
+    client_start(alpn, sizeof(alpn) - 1, NULL);
+
+    TEST_ASSERT_TRUE(run_handshake());
+    TEST_ASSERT_EQUAL(CATZILLA_TLS_ALPN_H2, catzilla_tls_session_protocol(session));
+    TEST_ASSERT_FALSE(catzilla_tls_session_resumed(session));
+    exchange("PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n", "ok");
+}
+
+void test_handshake_falls_back_to_http1() {
+    static const unsigned char alpn[] = "\x02h2\x08http/1.1";
+    session = catzilla_tls_session_create(context, -1, false);
+    client_start(alpn, sizeof(alpn) - 1, NULL);
+
+    TEST_ASSERT_TRUE(run_handshake());
+    TEST_ASSERT_EQUAL(CATZILLA_TLS_ALPN_HTTP1, catzilla_tls_session_protocol(session));
+    exchange("GET / HTTP/1.1\r\nHost: a\r\n\r\n", "HTTP/1.1 200 OK\r\n\r\n");
+}
+
+void test_handshake_without_alpn() {
+    session = catzilla_tls_session_create(context, -1, true);
+    client_start(NULL, 0, NULL);
+
+    TEST_ASSERT_TRUE(run_handshake());
+    TEST_ASSERT_EQUAL(CATZILLA_TLS_ALPN_NONE, catzilla_tls_session_protocol(session));
+}
+
+void test_session_resumption() {
+    session = catzilla_tls_session_create(context, -1, false);
+    client_start(NULL, 0, NULL);
+    TEST_ASSERT_TRUE(run_handshake());
+    exchange("first", "one");
+    SSL_SESSION* saved = SSL_get1_session(client.ssl);
+    TEST_ASSERT_NOT_NULL(saved);
+    SSL_shutdown(client.ssl);
+    client_stop();
+    catzilla_tls_session_free(session);
+
+    session = catzilla_tls_session_create(context, -1, false);
+    client_start(NULL, 0, saved);
+    TEST_ASSERT_TRUE(run_handshake());
+    TEST_ASSERT_TRUE(catzilla_tls_session_resumed(session));
+    TEST_ASSERT_TRUE(SSL_session_reused(client.ssl));
+    exchange("second", "two");
+    SSL_SESSION_free(saved);
+}
+
+void test_garbage_fails_handshake() {
+    session = catzilla_tls_session_create(context, -1, false);
+    const char garbage[] = "GET / HTTP/1.1\r\nHost: a\r\n\r\n";
+    TEST_ASSERT_EQUAL(-1, catzilla_tls_session_feed(session, garbage, sizeof(garbage) - 1));
+    TEST_ASSERT_FALSE(catzilla_tls_session_handshake_done(session));
+    TEST_ASSERT_EQUAL(-1, catzilla_tls_session_read(session, (char[8]){0}, 8));
+}
+
+void test_peer_close_ends_reads() {
+    session = catzilla_tls_session_create(context, -1, false);
+    client_start(NULL, 0, NULL);
+    TEST_ASSERT_TRUE(run_handshake());
+
+    SSL_shutdown(client.ssl);
+    client_to_server();
+    char buf[16];
+    TEST_ASSERT_EQUAL(-1, catzilla_tls_session_read(session, buf, sizeof(buf)));
+}
+
+#ifndef _WIN32
+// Over a real TCP socket the session either hands sending to the kernel, whose
+// records the client must decrypt, or stays in userspace where kTLS is missing
+void test_ktls_offload_or_userspace_fallback() {
+    catzilla_tls_context_t* ktls_context = catzilla_tls_context_create(TEST_CERT_FILE, TEST_KEY_FILE, true);
+    TEST_ASSERT_NOT_NULL(ktls_context);
+
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addr_len = sizeof(addr);
+    TEST_ASSERT_EQUAL(0, bind(listener, (struct sockaddr*)&addr, sizeof(addr)));
+    TEST_ASSERT_EQUAL(0, listen(listener, 1));
+    getsockname(listener, (struct sockaddr*)&addr, &addr_len);
+    int client_fd = socket(AF_INET, SOCK_STREAM, 0);
+    TEST_ASSERT_EQUAL(0, connect(client_fd, (struct sockaddr*)&addr, sizeof(addr)));
+    int server_fd = accept(listener, NULL, NULL);
+    TEST_ASSERT_TRUE(server_fd >= 0);
+
+    session = catzilla_tls_session_create(ktls_context, server_fd, false);
+    client_start(NULL, 0, NULL);
+    TEST_ASSERT_TRUE(run_handshake());
+    exchange("ping", "pong");
+
+    char buf[256];
+    const char message[] = "written by the kernel";
+    if (catzilla_tls_session_enable_ktls(session) == 0) {
+        TEST_ASSERT_TRUE(catzilla_tls_session_ktls_active(session));
+        TEST_ASSERT_EQUAL((ssize_t)(sizeof(message) - 1), send(server_fd, message, sizeof(message) - 1, 0));
+        ssize_t n = recv(client_fd, buf, sizeof(buf), 0);
+        TEST_ASSERT_TRUE(n > 0);
+        BIO_write(client.rbio, buf, (int)n);
+        int got = SSL_read(client.ssl, buf, sizeof(buf));
+        TEST_ASSERT_EQUAL((int)(sizeof(message) - 1), got);
+        TEST_ASSERT_EQUAL_MEMORY(message, buf, (size_t)got);
+        TEST_ASSERT_EQUAL(-1, catzilla_tls_session_write(session, message, sizeof(message) - 1));
+    } else {
+        TEST_ASSERT_FALSE(catzilla_tls_session_ktls_active(session));
+        exchange("still", "userspace");
+    }
+
+    // Received records are decrypted by the session either way
+    exchange("after", "ok");
+
+    catzilla_tls_session_free(session);
+    session = NULL;
+    close(server_fd);
+    close(client_fd);
+    close(listener);
+    catzilla_tls_context_free(ktls_context);
+}
+#endif
+
+int main(void) {
+    write_test_certificate();
+    context = catzilla_tls_context_create(TEST_CERT_FILE, TEST_KEY_FILE, false);
+    client_ctx = SSL_CTX_new(TLS_client_method());
+
+    UNITY_BEGIN();
+
+    RUN_TEST(test_context_rejects_missing_files);
+    RUN_TEST(test_handshake_selects_h2);
+    RUN_TEST(test_handshake_falls_back_to_http1);
+    RUN_TEST(test_handshake_without_alpn);
+    RUN_TEST(test_session_resumption);
+    RUN_TEST(test_garbage_fails_handshake);
+    RUN_TEST(test_peer_close_ends_reads);
+#ifndef _WIN32
+    RUN_TEST(test_ktls_offload_or_userspace_fallback);
+#endif
+
+    int failures = UNITY_END();
+    SSL_CTX_free(client_ctx);
+    catzilla_tls_context_free(context);
+    remove(TEST_CERT_FILE);
+    remove(TEST_KEY_FILE);
+    return failures;
+}
+
+#else  // !CATZILLA_HAS_TLS
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_tls_is_unavailable() {
+    TEST_ASSERT_FALSE(catzilla_tls_supported());
+    TEST_ASSERT_NULL(catzilla_tls_context_create("cert.pem", "key.pem", false));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_tls_is_unavailable);
+    return UNITY_END();
+}
+
+#endif
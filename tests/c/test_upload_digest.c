@@ -0,0 +1,144 @@
+// tests/c/test_upload_digest.c
+#include "unity.h"
+#include "upload_digest.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void sha256_hex(const void* data, size_t len, char out[65]) {
+    catzilla_sha256_t ctx;
+    uint8_t digest[CATZILLA_SHA256_SIZE];
+    catzilla_sha256_init(&ctx);
+    catzilla_sha256_update(&ctx, data, len);
+    catzilla_sha256_final(&ctx, digest);
+    catzilla_digest_to_hex(digest, sizeof(digest), out);
+}
+
+// Random-looking bytes, the same every run
+static unsigned char* make_data(size_t len) {
+    unsigned char* data = malloc(len);
+    uint32_t x = 2463534242u;
+    for (size_t i = 0; i < len; i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        data[i] = (unsigned char)x;
+    }
+    return data;
+}
+
+static void check_known_answers(void) {
+    char hex[65];
+    sha256_hex("", 0, hex);
+    TEST_ASSERT_EQUAL_STRING("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855", hex);
+    sha256_hex("abc", 3, hex);
+    TEST_ASSERT_EQUAL_STRING("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad", hex);
+    const char* two_blocks = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+    sha256_hex(two_blocks, strlen(two_blocks), hex);
+    TEST_ASSERT_EQUAL_STRING("248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1", hex);
+
+    char* million = malloc(1000000);
+    memset(million, 'a', 1000000);
+    sha256_hex(million, 1000000, hex);
+    TEST_ASSERT_EQUAL_STRING("cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0", hex);
+    free(million);
+
+    TEST_ASSERT_EQUAL_HEX32(0x00000000, catzilla_crc32c(0, "", 0));
+    TEST_ASSERT_EQUAL_HEX32(0xE3069283, catzilla_crc32c(0, "123456789", 9));
+    unsigned char zeros[32] = {0};
+    TEST_ASSERT_EQUAL_HEX32(0x8A9136AA, catzilla_crc32c(0, zeros, sizeof(zeros)));
+}
+
+void setUp(void) {
+    catzilla_digest_use_portable(false);
+}
+
+void tearDown(void) {
+    catzilla_digest_use_portable(false);
+}
+
+void test_known_answers() {
+    check_known_answers();
+}
+
+void test_known_answers_portable() {
+    catzilla_digest_use_portable(true);
+    TEST_ASSERT_EQUAL_STRING("portable", catzilla_sha256_backend());
+    TEST_ASSERT_EQUAL_STRING("portable", catzilla_crc32c_backend());
+    check_known_answers();
+}
+
+void test_backends_agree() {
+    size_t len = 100003;
+    unsigned char* data = make_data(len);
+    for (size_t offset = 0; offset < 9; offset++) {
+        char fast[65], portable[65];
+        sha256_hex(data + offset, len - offset, fast);
+        uint32_t fast_crc = catzilla_crc32c(0, data + offset, len - offset);
+
+        catzilla_digest_use_portable(true);
+        sha256_hex(data + offset, len - offset, portable);
+        uint32_t portable_crc = catzilla_crc32c(0, data + offset, len - offset);
+        catzilla_digest_use_portable(false);
+
+        TEST_ASSERT_EQUAL_STRING(portable, fast);
+        TEST_ASSERT_EQUAL_HEX32(portable_crc, fast_crc);
+    }
+    free(data);
+}
+
+void test_chunked_updates_match_one_shot() {
+    size_t len = 70000;
+    unsigned char* data = make_data(len);
+    catzilla_upload_digest_t whole;
+    catzilla_upload_digest_init(&whole, CATZILLA_DIGEST_SHA256 | CATZILLA_DIGEST_CRC32C);
+    catzilla_upload_digest_update(&whole, data, len);
+    catzilla_upload_digest_final(&whole);
+    TEST_ASSERT_TRUE(whole.complete);
+
+    // Chunk sizes around the block size and odd lengths
+    catzilla_upload_digest_t chunked;
+    catzilla_upload_digest_init(&chunked, CATZILLA_DIGEST_SHA256 | CATZILLA_DIGEST_CRC32C);
+    size_t chunk = 1;
+    for (size_t pos = 0; pos < len; pos += chunk, chunk = chunk * 7 % 131 + 1) {
+        size_t take = len - pos < chunk ? len - pos : chunk;
+        catzilla_upload_digest_update(&chunked, data + pos, take);
+    }
+    catzilla_upload_digest_final(&chunked);
+
+    TEST_ASSERT_EQUAL_MEMORY(whole.sha256, chunked.sha256, CATZILLA_SHA256_SIZE);
+    TEST_ASSERT_EQUAL_HEX32(whole.crc32c, chunked.crc32c);
+
+    // Data after the final digest is ignored
+    catzilla_upload_digest_update(&chunked, "more", 4);
+    TEST_ASSERT_EQUAL_HEX32(whole.crc32c, chunked.crc32c);
+    free(data);
+}
+
+void test_only_requested_algorithms() {
+    catzilla_upload_digest_t digest;
+    catzilla_upload_digest_init(&digest, CATZILLA_DIGEST_CRC32C);
+    catzilla_upload_digest_update(&digest, "123456789", 9);
+    catzilla_upload_digest_final(&digest);
+    TEST_ASSERT_EQUAL_HEX32(0xE3069283, digest.crc32c);
+    uint8_t zeros[CATZILLA_SHA256_SIZE] = {0};
+    TEST_ASSERT_EQUAL_MEMORY(zeros, digest.sha256, CATZILLA_SHA256_SIZE);
+
+    catzilla_upload_digest_init(&digest, 0);
+    catzilla_upload_digest_update(&digest, "x", 1);
+    catzilla_upload_digest_final(&digest);
+    TEST_ASSERT_FALSE(digest.complete);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    printf("SHA-256: %s, CRC32C: %s\n", catzilla_sha256_backend(), catzilla_crc32c_backend());
+    RUN_TEST(test_known_answers);
+    RUN_TEST(test_known_answers_portable);
+    RUN_TEST(test_backends_agree);
+    RUN_TEST(test_chunked_updates_match_one_shot);
+    RUN_TEST(test_only_requested_algorithms);
+
+    return UNITY_END();
+}
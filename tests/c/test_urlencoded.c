@@ -0,0 +1,169 @@
+// tests/c/test_urlencoded.c
+#include "unity.h"
+#include "urlencoded.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static catzilla_request_arena_t arena;
+static catzilla_param_table_t table;
+
+static void parse(const char* data, bool skip_empty_names) {
+    TEST_ASSERT_EQUAL(0, catzilla_urlencoded_parse(&arena, data, strlen(data), skip_empty_names, &table));
+}
+
+void setUp(void) {
+    memset(&arena, 0, sizeof(arena));
+    memset(&table, 0, sizeof(table));
+}
+
+void tearDown(void) {
+    catzilla_arena_reset(&arena);
+    catzilla_arena_pool_trim();
+}
+
+void test_pairs_are_split_and_decoded() {
+    parse("name=John+Doe&email=john%40example.com&empty=&x=1=2", false);
+    TEST_ASSERT_EQUAL(4, table.count);
+    TEST_ASSERT_EQUAL_STRING("name", table.names[0]);
+    TEST_ASSERT_EQUAL_STRING("John Doe", table.values[0]);
+    TEST_ASSERT_EQUAL_STRING("john@example.com", catzilla_param_table_get(&table, "email"));
+    TEST_ASSERT_EQUAL_STRING("", catzilla_param_table_get(&table, "empty"));
+    // Only the first '=' splits
+    TEST_ASSERT_EQUAL_STRING("1=2", catzilla_param_table_get(&table, "x"));
+    TEST_ASSERT_NULL(catzilla_param_table_get(&table, "missing"));
+}
+
+void test_pairs_without_values_are_skipped() {
+    parse("flag&&a=1&=anonymous&", false);
+    TEST_ASSERT_EQUAL(2, table.count);
+    TEST_ASSERT_EQUAL_STRING("a", table.names[0]);
+    TEST_ASSERT_EQUAL_STRING("", table.names[1]);
+    TEST_ASSERT_EQUAL_STRING("anonymous", table.values[1]);
+
+    memset(&table, 0, sizeof(table));
+    parse("=anonymous&b=2", true);
+    TEST_ASSERT_EQUAL(1, table.count);
+    TEST_ASSERT_EQUAL_STRING("b", table.names[0]);
+}
+
+void test_escapes() {
+    // Upper and lower case hex, a multi-byte character, encoded separators
+    parse("q=%E2%82%ac%3d%26%2B&bad=%zz%4&tail=100%", false);
+    TEST_ASSERT_EQUAL_STRING("\xE2\x82\xAC=&+", catzilla_param_table_get(&table, "q"));
+    TEST_ASSERT_EQUAL_STRING("%zz%4", catzilla_param_table_get(&table, "bad"));
+    TEST_ASSERT_EQUAL_STRING("100%", catzilla_param_table_get(&table, "tail"));
+
+    char buffer[32] = "a+b%20c%2";
+    TEST_ASSERT_EQUAL(7, catzilla_url_decode(buffer, strlen(buffer), buffer));
+    TEST_ASSERT_EQUAL_STRING("a b c%2", buffer);
+}
+
+void test_input_is_not_modified() {
+    char data[] = "a=%41&b=+";
+    parse(data, false);
+    TEST_ASSERT_EQUAL_STRING("a=%41&b=+", data);
+    TEST_ASSERT_EQUAL_STRING("A", catzilla_param_table_get(&table, "a"));
+    TEST_ASSERT_EQUAL_STRING(" ", catzilla_param_table_get(&table, "b"));
+}
+
+void test_table_grows_past_the_old_limits() {
+    // The fixed arrays used to drop everything after 50 pairs
+    size_t size = 1000 * 16;
+    char* data = malloc(size);
+    size_t length = 0;
+    for (int i = 0; i < 1000; i++) {
+        length += (size_t)snprintf(data + length, size - length, "%sk%d=v%d", i ? "&" : "", i, i);
+    }
+    TEST_ASSERT_EQUAL(0, catzilla_urlencoded_parse(&arena, data, length, false, &table));
+    free(data);
+
+    TEST_ASSERT_EQUAL(1000, table.count);
+    TEST_ASSERT_TRUE(table.capacity >= 1000);
+    TEST_ASSERT_EQUAL_STRING("k0", table.names[0]);
+    TEST_ASSERT_EQUAL_STRING("v999", table.values[999]);
+    TEST_ASSERT_EQUAL_STRING("v500", catzilla_param_table_get(&table, "k500"));
+}
+
+void test_repeated_names_keep_every_value() {
+    parse("tag=a&tag=b&tag=c", false);
+    TEST_ASSERT_EQUAL(3, table.count);
+    TEST_ASSERT_EQUAL_STRING("a", catzilla_param_table_get(&table, "tag"));
+    TEST_ASSERT_EQUAL_STRING("c", table.values[2]);
+}
+
+// Byte at a time reference decoder
+static int reference_hex(char c) {
+    const char* digits = "0123456789abcdef";
+    const char* hit = c ? strchr(digits, c | 0x20) : NULL;
+    return hit ? (int)(hit - digits) : -1;
+}
+
+static void reference_decode(const char* src, size_t length, char* dst) {
+    for (size_t i = 0; i < length; i++) {
+        if (src[i] == '%' && i + 2 < length &&
+            reference_hex(src[i + 1]) >= 0 && reference_hex(src[i + 2]) >= 0) {
+            *dst++ = (char)(reference_hex(src[i + 1]) * 16 + reference_hex(src[i + 2]));
+            i += 2;
+        } else {
+            *dst++ = src[i] == '+' ? ' ' : src[i];
+        }
+    }
+    *dst = '\0';
+}
+
+void test_matches_reference_across_block_boundaries() {
+    // Escapes and separators straddling the 16-byte scan blocks must come out
+    // the same as splitting and decoding a byte at a time
+    static const char alphabet[] = "ab%2F+=&9Z";
+    char input[80], expected[80];
+    srand(7);
+    for (int round = 0; round < 5000; round++) {
+        size_t length = (size_t)(rand() % 64);
+        for (size_t i = 0; i < length; i++) {
+            input[i] = alphabet[rand() % (sizeof(alphabet) - 1)];
+        }
+        input[length] = '\0';
+
+        catzilla_arena_reset(&arena);
+        memset(&table, 0, sizeof(table));
+        TEST_ASSERT_EQUAL(0, catzilla_urlencoded_parse(&arena, input, length, false, &table));
+
+        int pair = 0;
+        const char* segment = input;
+        while (segment <= input + length) {
+            const char* next = strchr(segment, '&');
+            size_t segment_length = next ? (size_t)(next - segment) : strlen(segment);
+            const char* eq = memchr(segment, '=', segment_length);
+            if (eq) {
+                TEST_ASSERT_TRUE(pair < table.count);
+                reference_decode(segment, (size_t)(eq - segment), expected);
+                TEST_ASSERT_EQUAL_STRING(expected, table.names[pair]);
+                reference_decode(eq + 1, segment_length - (size_t)(eq + 1 - segment), expected);
+                TEST_ASSERT_EQUAL_STRING(expected, table.values[pair]);
+                pair++;
+            }
+            segment += segment_length + 1;
+        }
+        TEST_ASSERT_EQUAL(pair, table.count);
+
+        reference_decode(input, length, expected);
+        char actual[80];
+        catzilla_url_decode(input, length, actual);
+        TEST_ASSERT_EQUAL_STRING(expected, actual);
+    }
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_pairs_are_split_and_decoded);
+    RUN_TEST(test_pairs_without_values_are_skipped);
+    RUN_TEST(test_escapes);
+    RUN_TEST(test_input_is_not_modified);
+    RUN_TEST(test_table_grows_past_the_old_limits);
+    RUN_TEST(test_repeated_names_keep_every_value);
+    RUN_TEST(test_matches_reference_across_block_boundaries);
+
+    return UNITY_END();
+}
@@ -12,6 +12,9 @@
 #include "unity.h"
 #include "validation.h"
 #include "memory.h"
+#ifndef _WIN32
+#include "task_system.h"
+#endif
 #include <string.h>
 #include <stdlib.h>
 #include <time.h>
@@ -355,6 +358,329 @@ void test_validate_model_optional_field_null(void) {
     catzilla_free_model_spec(model);
 }
 
+// ============================================================================
+// yyjson Validation Tests
+// ============================================================================
+
+typedef struct {
+    const char* names[8];
+    yyjson_val* values[8];
+    int count;
+} emitted_fields_t;
+
+static int collect_field(void* user_data, const field_spec_t* field, yyjson_val* value) {
+    emitted_fields_t* emitted = user_data;
+    emitted->names[emitted->count] = field->field_name;
+    emitted->values[emitted->count] = value;
+    emitted->count++;
+    return 0;
+}
+
+static model_spec_t* create_user_model(void) {
+    model_spec_t* model = catzilla_create_model_spec("User", 10);
+    catzilla_add_field_spec(model, "name", catzilla_create_string_validator(1, 10, "^[a-z]+$"), 1, NULL);
+    catzilla_add_field_spec(model, "age", catzilla_create_int_validator(0, 150, 1, 1), 1, NULL);
+    catzilla_add_field_spec(model, "score", catzilla_create_float_validator(0.0, 1.0, 1, 1), 0, NULL);
+    catzilla_add_field_spec(model, "tags", catzilla_create_list_validator(
+        catzilla_create_string_validator(1, 5, NULL), 0, 3), 0, NULL);
+    catzilla_compile_model_spec(model);
+    return model;
+}
+
+static validation_result_t validate_json_text(model_spec_t* model, const char* text,
+                                              validation_context_t* ctx, emitted_fields_t* emitted) {
+    yyjson_doc* doc = yyjson_read(text, strlen(text), 0);
+    TEST_ASSERT_NOT_NULL(doc);
+    validation_result_t result = catzilla_validate_model_yyjson(model, yyjson_doc_get_root(doc), ctx,
+                                                               emitted ? collect_field : NULL, emitted);
+    yyjson_doc_free(doc);
+    return result;
+}
+
+void test_validate_yyjson_value_types(void) {
+    const char* text = "[7, -3, 2.5, \"abc\", true, null, [1, 2], 9223372036854775808]";
+    yyjson_doc* doc = yyjson_read(text, strlen(text), 0);
+    TEST_ASSERT_NOT_NULL(doc);
+    yyjson_val* root = yyjson_doc_get_root(doc);
+
+    validator_t* int_validator = catzilla_create_int_validator(0, 10, 1, 1);
+    validator_t* float_validator = catzilla_create_float_validator(0.0, 10.0, 1, 1);
+    validator_t* bool_validator = catzilla_create_validator(TYPE_BOOL);
+    validator_t* optional_validator = catzilla_create_optional_validator(
+        catzilla_create_string_validator(1, 5, NULL));
+    validator_t* list_validator = catzilla_create_list_validator(
+        catzilla_create_int_validator(0, 1, 1, 1), 0, 5);
+
+    TEST_ASSERT_EQUAL(VALIDATION_SUCCESS, catzilla_validate_value_yyjson(int_validator, yyjson_arr_get(root, 0), NULL));
+    TEST_ASSERT_EQUAL(VALIDATION_ERROR_RANGE, catzilla_validate_value_yyjson(int_validator, yyjson_arr_get(root, 1), NULL));
+    TEST_ASSERT_EQUAL(VALIDATION_ERROR_TYPE, catzilla_validate_value_yyjson(int_validator, yyjson_arr_get(root, 2), NULL));
+    TEST_ASSERT_EQUAL(VALIDATION_ERROR_RANGE, catzilla_validate_value_yyjson(int_validator, yyjson_arr_get(root, 7), NULL));
+
+    // Floats accept integers too
+    TEST_ASSERT_EQUAL(VALIDATION_SUCCESS, catzilla_validate_value_yyjson(float_validator, yyjson_arr_get(root, 0), NULL));
+    TEST_ASSERT_EQUAL(VALIDATION_SUCCESS, catzilla_validate_value_yyjson(float_validator, yyjson_arr_get(root, 2), NULL));
+    TEST_ASSERT_EQUAL(VALIDATION_ERROR_RANGE, catzilla_validate_value_yyjson(float_validator, yyjson_arr_get(root, 1), NULL));
+
+    TEST_ASSERT_EQUAL(VALIDATION_SUCCESS, catzilla_validate_value_yyjson(bool_validator, yyjson_arr_get(root, 4), NULL));
+    TEST_ASSERT_EQUAL(VALIDATION_ERROR_TYPE, catzilla_validate_value_yyjson(bool_validator, yyjson_arr_get(root, 0), NULL));
+
+    TEST_ASSERT_EQUAL(VALIDATION_SUCCESS, catzilla_validate_value_yyjson(optional_validator, yyjson_arr_get(root, 3), NULL));
+    TEST_ASSERT_EQUAL(VALIDATION_SUCCESS, catzilla_validate_value_yyjson(optional_validator, yyjson_arr_get(root, 5), NULL));
+
+    // [1, 2] has an item out of range
+    TEST_ASSERT_EQUAL(VALIDATION_ERROR_RANGE, catzilla_validate_value_yyjson(list_validator, yyjson_arr_get(root, 6), NULL));
+
+    catzilla_free_validator(int_validator);
+    catzilla_free_validator(float_validator);
+    catzilla_free_validator(bool_validator);
+    catzilla_free_validator(optional_validator);
+    catzilla_free_validator(list_validator);
+    yyjson_doc_free(doc);
+}
+
+void test_validate_model_yyjson_emits_fields_in_model_order(void) {
+    model_spec_t* model = create_user_model();
+    validation_context_t ctx = {0};
+    emitted_fields_t emitted = {0};
+
+    const char* text = "{\"tags\": [\"a\", \"bc\"], \"age\": 30, \"name\": \"john\", \"extra\": 1}";
+    yyjson_doc* doc = yyjson_read(text, strlen(text), 0);
+    TEST_ASSERT_NOT_NULL(doc);
+
+    validation_result_t result = catzilla_validate_model_yyjson(model, yyjson_doc_get_root(doc), &ctx,
+                                                               collect_field, &emitted);
+    TEST_ASSERT_EQUAL(VALIDATION_SUCCESS, result);
+    TEST_ASSERT_EQUAL(0, ctx.error_count);
+
+    // Unknown keys are ignored and the missing optional field is emitted as NULL
+    TEST_ASSERT_EQUAL(4, emitted.count);
+    TEST_ASSERT_EQUAL_STRING("name", emitted.names[0]);
+    TEST_ASSERT_EQUAL_STRING("john", yyjson_get_str(emitted.values[0]));
+    TEST_ASSERT_EQUAL_STRING("age", emitted.names[1]);
+    TEST_ASSERT_EQUAL(30, yyjson_get_sint(emitted.values[1]));
+    TEST_ASSERT_EQUAL_STRING("score", emitted.names[2]);
+    TEST_ASSERT_NULL(emitted.values[2]);
+    TEST_ASSERT_EQUAL_STRING("tags", emitted.names[3]);
+    TEST_ASSERT_EQUAL(2, yyjson_arr_size(emitted.values[3]));
+
+    yyjson_doc_free(doc);
+    catzilla_free_model_spec(model);
+}
+
+void test_validate_model_yyjson_collects_errors(void) {
+    model_spec_t* model = create_user_model();
+    validation_context_t ctx = {0};
+    emitted_fields_t emitted = {0};
+
+    // Pattern mismatch on name, age missing, score out of range
+    validation_result_t result = validate_json_text(model, "{\"name\": \"John\", \"score\": 2}", &ctx, &emitted);
+    TEST_ASSERT_NOT_EQUAL(VALIDATION_SUCCESS, result);
+    TEST_ASSERT_EQUAL(3, ctx.error_count);
+    TEST_ASSERT_EQUAL(0, emitted.count);
+
+    char* errors = catzilla_get_validation_errors(&ctx);
+    TEST_ASSERT_NOT_NULL(errors);
+    TEST_ASSERT_NOT_NULL(strstr(errors, "Field 'age' is required"));
+    catzilla_request_free(errors);
+    catzilla_clear_validation_errors(&ctx);
+
+    // Wrong item type inside the list
+    TEST_ASSERT_EQUAL(VALIDATION_ERROR_TYPE,
+                      validate_json_text(model, "{\"name\": \"jo\", \"age\": 1, \"tags\": [1]}", &ctx, NULL));
+    catzilla_clear_validation_errors(&ctx);
+
+    // Only objects can be validated against a model
+    TEST_ASSERT_EQUAL(VALIDATION_ERROR_TYPE, validate_json_text(model, "[1, 2]", &ctx, NULL));
+    TEST_ASSERT_EQUAL(1, ctx.error_count);
+    catzilla_clear_validation_errors(&ctx);
+
+    catzilla_free_model_spec(model);
+}
+
+void test_validate_model_yyjson_optional_field_null(void) {
+    model_spec_t* model = create_user_model();
+    validation_context_t ctx = {0};
+    emitted_fields_t emitted = {0};
+
+    validation_result_t result = validate_json_text(model, "{\"name\": \"jo\", \"age\": 1, \"score\": null}",
+                                                    &ctx, &emitted);
+    TEST_ASSERT_EQUAL(VALIDATION_SUCCESS, result);
+    TEST_ASSERT_EQUAL(4, emitted.count);
+
+    catzilla_free_model_spec(model);
+}
+
+static int abort_after_first(void* user_data, const field_spec_t* field, yyjson_val* value) {
+    int* calls = user_data;
+    return (*calls)++ == 0 ? 0 : -1;
+}
+
+void test_validate_model_yyjson_emit_can_abort(void) {
+    model_spec_t* model = create_user_model();
+    validation_context_t ctx = {0};
+    int calls = 0;
+
+    const char* text = "{\"name\": \"jo\", \"age\": 1}";
+    yyjson_doc* doc = yyjson_read(text, strlen(text), 0);
+    TEST_ASSERT_NOT_NULL(doc);
+    TEST_ASSERT_EQUAL(VALIDATION_ERROR_MEMORY,
+                      catzilla_validate_model_yyjson(model, yyjson_doc_get_root(doc), &ctx, abort_after_first, &calls));
+    TEST_ASSERT_EQUAL(2, calls);
+
+    yyjson_doc_free(doc);
+    catzilla_free_model_spec(model);
+}
+
+// ============================================================================
+// Batch Validation Tests
+// ============================================================================
+
+// Items 0..count-1; the ones in invalid get an out-of-range age
+static json_object_t** create_batch(int count, const int* invalid, int invalid_count) {
+    json_object_t** items = malloc(sizeof(json_object_t*) * (size_t)count);
+    for (int i = 0; i < count; i++) {
+        int age = 30;
+        for (int k = 0; k < invalid_count; k++) {
+            if (invalid[k] == i) age = 500;
+        }
+        items[i] = catzilla_create_json_object();
+        catzilla_json_add_string(items[i], "name", "ann");
+        catzilla_json_add_int(items[i], "age", age);
+    }
+    return items;
+}
+
+static void free_batch(json_object_t** items, int count) {
+    for (int i = 0; i < count; i++) catzilla_free_json_object(items[i]);
+    free(items);
+}
+
+// Items that have errors, in the order the context lists them
+static int error_indices(validation_context_t* ctx, int* indices, int max) {
+    int count = 0;
+    for (validation_error_t* error = ctx->errors; error && count < max; error = error->next) {
+        if (count == 0 || indices[count - 1] != error->item_index) indices[count++] = error->item_index;
+    }
+    return count;
+}
+
+void test_batch_validate_reports_errors_in_item_order(void) {
+    model_spec_t* model = create_user_model();
+    const int invalid[] = { 7, 2 };
+    json_object_t** items = create_batch(10, invalid, 2);
+    catzilla_free_json_object(items[5]);
+    items[5] = NULL;
+
+    json_object_t** validated = NULL;
+    validation_context_t ctx = {0};
+    TEST_ASSERT_EQUAL(VALIDATION_ERROR_RANGE, catzilla_batch_validate(model, items, 10, &validated, &ctx));
+    TEST_ASSERT_NOT_NULL(validated);
+
+    for (int i = 0; i < 10; i++) {
+        if (i == 2 || i == 5 || i == 7) {
+            TEST_ASSERT_NULL(validated[i]);
+        } else {
+            TEST_ASSERT_NOT_NULL(validated[i]);
+        }
+    }
+
+    // Item 2 and 7 fail in age, item 5 is not an object
+    int indices[8];
+    int count = error_indices(&ctx, indices, 8);
+    TEST_ASSERT_EQUAL(3, count);
+    TEST_ASSERT_EQUAL(2, indices[0]);
+    TEST_ASSERT_EQUAL(5, indices[1]);
+    TEST_ASSERT_EQUAL(7, indices[2]);
+    for (validation_error_t* error = ctx.errors; error; error = error->next) {
+        if (error->item_index == 5) TEST_ASSERT_EQUAL(VALIDATION_ERROR_TYPE, error->error_code);
+    }
+
+    catzilla_free_batch_results(validated, 10);
+    catzilla_clear_validation_errors(&ctx);
+    free_batch(items, 10);
+    catzilla_free_model_spec(model);
+}
+
+#ifndef _WIN32
+void test_batch_validate_on_task_engine_workers(void) {
+    task_engine_t* engine = catzilla_task_engine_create(4, 1, 4, 4096, false, 0);
+    TEST_ASSERT_NOT_NULL(engine);
+    TEST_ASSERT_EQUAL(0, catzilla_task_engine_start(engine));
+
+    model_spec_t* model = create_user_model();
+    const int count = 20000;
+    const int invalid[] = { 19999, 3, 12000, 4096 };
+    json_object_t** items = create_batch(count, invalid, 4);
+
+    validation_batch_options_t options = { engine, 0, false };
+    for (int round = 0; round < 5; round++) {
+        json_object_t** validated = NULL;
+        validation_context_t ctx = {0};
+        TEST_ASSERT_EQUAL(VALIDATION_ERROR_RANGE,
+                          catzilla_batch_validate_with_options(model, items, count, &validated, &ctx, &options));
+
+        int indices[8];
+        TEST_ASSERT_EQUAL(4, error_indices(&ctx, indices, 8));
+        TEST_ASSERT_EQUAL(3, indices[0]);
+        TEST_ASSERT_EQUAL(4096, indices[1]);
+        TEST_ASSERT_EQUAL(12000, indices[2]);
+        TEST_ASSERT_EQUAL(19999, indices[3]);
+
+        int valid = 0;
+        for (int i = 0; i < count; i++) valid += validated[i] != NULL;
+        TEST_ASSERT_EQUAL(count - 4, valid);
+
+        catzilla_free_batch_results(validated, count);
+        catzilla_clear_validation_errors(&ctx);
+    }
+
+    free_batch(items, count);
+    catzilla_free_model_spec(model);
+    catzilla_task_engine_stop(engine, true);
+    catzilla_task_engine_destroy(engine);
+}
+
+void test_batch_validate_stops_at_first_error(void) {
+    task_engine_t* engine = catzilla_task_engine_create(4, 1, 4, 4096, false, 0);
+    TEST_ASSERT_NOT_NULL(engine);
+    TEST_ASSERT_EQUAL(0, catzilla_task_engine_start(engine));
+
+    model_spec_t* model = create_user_model();
+    const int count = 20000;
+    const int invalid[] = { 15000, 6000, 6001 };
+    json_object_t** items = create_batch(count, invalid, 3);
+
+    validation_batch_options_t options = { engine, 2, true };
+    for (int round = 0; round < 5; round++) {
+        json_object_t** validated = NULL;
+        validation_context_t ctx = {0};
+        TEST_ASSERT_EQUAL(VALIDATION_ERROR_RANGE,
+                          catzilla_batch_validate_with_options(model, items, count, &validated, &ctx, &options));
+
+        // Only the first invalid item is reported, however the workers raced
+        int indices[8];
+        TEST_ASSERT_EQUAL(1, error_indices(&ctx, indices, 8));
+        TEST_ASSERT_EQUAL(6000, indices[0]);
+
+        for (int i = 0; i < count; i++) {
+            if (i < 6000) {
+                TEST_ASSERT_NOT_NULL(validated[i]);
+            } else {
+                TEST_ASSERT_NULL(validated[i]);
+            }
+        }
+
+        catzilla_free_batch_results(validated, count);
+        catzilla_clear_validation_errors(&ctx);
+    }
+
+    free_batch(items, count);
+    catzilla_free_model_spec(model);
+    catzilla_task_engine_stop(engine, true);
+    catzilla_task_engine_destroy(engine);
+}
+#endif
+
 // ============================================================================
 // Performance Tests
 // ============================================================================
@@ -443,6 +769,20 @@ int main(void) {
     RUN_TEST(test_validate_model_with_optional_fields);
     RUN_TEST(test_validate_model_optional_field_null);
 
+    // yyjson Validation Tests
+    RUN_TEST(test_validate_yyjson_value_types);
+    RUN_TEST(test_validate_model_yyjson_emits_fields_in_model_order);
+    RUN_TEST(test_validate_model_yyjson_collects_errors);
+    RUN_TEST(test_validate_model_yyjson_optional_field_null);
+    RUN_TEST(test_validate_model_yyjson_emit_can_abort);
+
+    // Batch Validation Tests
+    RUN_TEST(test_batch_validate_reports_errors_in_item_order);
+#ifndef _WIN32
+    RUN_TEST(test_batch_validate_on_task_engine_workers);
+    RUN_TEST(test_batch_validate_stops_at_first_error);
+#endif
+
     // Performance Tests
     RUN_TEST(test_performance_validation_benchmark);
 
@@ -0,0 +1,470 @@
+// tests/c/test_websocket.c
+#include "unity.h"
+#include "websocket.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef CATZILLA_HAS_ZLIB
+#include <zlib.h>
+#endif
+
+// What the session handed back: messages and written frames
+typedef struct {
+    int messages;
+    int last_opcode;
+    char last_message[4096];
+    size_t last_length;
+    const char* last_pointer;
+    unsigned char sent[70000 + 16];
+    size_t sent_length;
+    bool close_after;
+    int sends;
+} ws_capture_t;
+
+static ws_capture_t capture;
+
+static void on_message(void* user_data, int opcode, char* data, size_t length) {
+    ws_capture_t* c = user_data;
+    c->messages++;
+    c->last_opcode = opcode;
+    c->last_pointer = data;
+    c->last_length = length;
+    memcpy(c->last_message, data, length < sizeof(c->last_message) ? length : sizeof(c->last_message));
+}
+
+static int on_send(void* user_data, const char* header, size_t header_length,
+                   const char* payload, size_t payload_length, bool close_after) {
+    ws_capture_t* c = user_data;
+    if (c->sent_length + header_length + payload_length > sizeof(c->sent)) return -1;
+    memcpy(c->sent + c->sent_length, header, header_length);
+    c->sent_length += header_length;
+    if (payload_length > 0) memcpy(c->sent + c->sent_length, payload, payload_length);
+    c->sent_length += payload_length;
+    c->close_after |= close_after;
+    c->sends++;
+    return 0;
+}
+
+static catzilla_ws_session_t* new_session(size_t max_message_size, const catzilla_ws_deflate_params_t* deflate) {
+    catzilla_ws_session_t* session = catzilla_ws_session_create(on_message, on_send, &capture,
+                                                                max_message_size, deflate);
+    TEST_ASSERT_NOT_NULL(session);
+    return session;
+}
+
+// Build a masked client frame into out; returns its length
+static size_t client_frame(unsigned char* out, int first_byte, const void* payload, size_t length) {
+    static const uint8_t mask[4] = {0x37, 0xfa, 0x21, 0x3d};
+    size_t pos = 0;
+    out[pos++] = (unsigned char)first_byte;
+    if (length < 126) {
+        out[pos++] = (unsigned char)(0x80 | length);
+    } else if (length <= 0xffff) {
+        out[pos++] = 0x80 | 126;
+        out[pos++] = (unsigned char)(length >> 8);
+        out[pos++] = (unsigned char)length;
+    } else {
+        out[pos++] = 0x80 | 127;
+        for (int i = 7; i >= 0; i--) out[pos++] = (unsigned char)((uint64_t)length >> (8 * i));
+    }
+    memcpy(out + pos, mask, 4);
+    pos += 4;
+    for (size_t i = 0; i < length; i++) {
+        out[pos + i] = ((const unsigned char*)payload)[i] ^ mask[i & 3];
+    }
+    return pos + length;
+}
+
+// Close code of the close frame the session sent last, -1 if none
+static int sent_close_code(void) {
+    for (size_t pos = 0; pos + 2 <= capture.sent_length;) {
+        size_t length = capture.sent[pos + 1] & 0x7f;
+        size_t header = 2 + (length == 126 ? 2 : length == 127 ? 8 : 0);
+        if ((capture.sent[pos] & 0x0f) == CATZILLA_WS_OP_CLOSE) {
+            return length >= 2 ? (capture.sent[pos + header] << 8) | capture.sent[pos + header + 1] : 0;
+        }
+        if (length >= 126) return -1;
+        pos += header + length;
+    }
+    return -1;
+}
+
+void setUp(void) {
+    memset(&capture, 0, sizeof(capture));
+}
+
+void tearDown(void) {}
+
+// ---------------------------------------------------------------------------
+// Handshake
+// ---------------------------------------------------------------------------
+
+void test_accept_key_matches_rfc_sample(void) {
+    char accept[CATZILLA_WS_ACCEPT_LEN + 1];
+    const char* key = "dGhlIHNhbXBsZSBub25jZQ==";
+    catzilla_ws_accept_key(key, strlen(key), accept);
+    TEST_ASSERT_EQUAL_STRING("s3pPLMBiTxaQ9kYGzzhZRbK+xOo=", accept);
+}
+
+void test_key_must_encode_sixteen_bytes(void) {
+    TEST_ASSERT_TRUE(catzilla_ws_key_valid("dGhlIHNhbXBsZSBub25jZQ==", 24));
+    TEST_ASSERT_FALSE(catzilla_ws_key_valid("dGhlIHNhbXBsZSBub25jZQ=", 23));
+    TEST_ASSERT_FALSE(catzilla_ws_key_valid("dGhlIHNhbXBsZSBub25j!Q==", 24));
+    TEST_ASSERT_FALSE(catzilla_ws_key_valid("dGhlIHNhbXBsZSBub25jZR==", 24));
+    TEST_ASSERT_FALSE(catzilla_ws_key_valid(NULL, 0));
+}
+
+void test_negotiate_deflate(void) {
+    catzilla_ws_deflate_params_t params;
+    char response[128];
+    const char* offer = "permessage-deflate; client_max_window_bits";
+    bool accepted = catzilla_ws_negotiate_deflate(offer, strlen(offer), &params, response, sizeof(response));
+#ifdef CATZILLA_HAS_ZLIB
+    TEST_ASSERT_TRUE(accepted);
+    TEST_ASSERT_EQUAL_STRING("permessage-deflate", response);
+    TEST_ASSERT_EQUAL(15, params.server_max_window_bits);
+
+    // A 256 byte window cannot be honoured; the second offer is taken
+    offer = "permessage-deflate; server_max_window_bits=8, "
+            "permessage-deflate; server_no_context_takeover; server_max_window_bits=\"10\"";
+    TEST_ASSERT_TRUE(catzilla_ws_negotiate_deflate(offer, strlen(offer), &params, response, sizeof(response)));
+    TEST_ASSERT_TRUE(params.server_no_context_takeover);
+    TEST_ASSERT_EQUAL(10, params.server_max_window_bits);
+    TEST_ASSERT_EQUAL_STRING("permessage-deflate; server_no_context_takeover; server_max_window_bits=10", response);
+
+    offer = "permessage-deflate; unknown_param, x-webkit-deflate-frame";
+    TEST_ASSERT_FALSE(catzilla_ws_negotiate_deflate(offer, strlen(offer), &params, response, sizeof(response)));
+    TEST_ASSERT_FALSE(params.enabled);
+#else
+    TEST_ASSERT_FALSE(accepted);
+#endif
+}
+
+// ---------------------------------------------------------------------------
+// Unmasking and UTF-8
+// ---------------------------------------------------------------------------
+
+void test_unmask_matches_bytewise_xor(void) {
+    const uint8_t mask[4] = {0xa1, 0x02, 0xc3, 0x74};
+    uint8_t data[300], expected[300];
+    for (size_t length = 0; length < 200; length += 7) {
+        for (uint64_t offset = 0; offset < 4; offset++) {
+            for (size_t i = 0; i < sizeof(data); i++) data[i] = (uint8_t)(i * 31 + 7);
+            memcpy(expected, data, sizeof(data));
+            for (size_t i = 0; i < length; i++) expected[i] ^= mask[(offset + i) & 3];
+
+            catzilla_ws_unmask(data, length, mask, offset);
+            TEST_ASSERT_EQUAL_MEMORY(expected, data, sizeof(data));
+        }
+    }
+}
+
+void test_utf8_validation(void) {
+    const char* ascii = "plain ascii text that is longer than sixteen bytes";
+    TEST_ASSERT_TRUE(catzilla_ws_utf8_valid((const uint8_t*)ascii, strlen(ascii)));
+    const char* mixed = "caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\xba and more ascii after it";
+    TEST_ASSERT_TRUE(catzilla_ws_utf8_valid((const uint8_t*)mixed, strlen(mixed)));
+    TEST_ASSERT_TRUE(catzilla_ws_utf8_valid((const uint8_t*)"\xf4\x8f\xbf\xbf", 4));
+
+    TEST_ASSERT_FALSE(catzilla_ws_utf8_valid((const uint8_t*)"\xc0\xaf", 2));           // Overlong
+    TEST_ASSERT_FALSE(catzilla_ws_utf8_valid((const uint8_t*)"\xe0\x80\xaf", 3));       // Overlong
+    TEST_ASSERT_FALSE(catzilla_ws_utf8_valid((const uint8_t*)"\xed\xa0\x80", 3));       // Surrogate
+    TEST_ASSERT_FALSE(catzilla_ws_utf8_valid((const uint8_t*)"\xf4\x90\x80\x80", 4));   // Past U+10FFFF
+    TEST_ASSERT_FALSE(catzilla_ws_utf8_valid((const uint8_t*)"0123456789abcdef\xe2\x82", 18));  // Truncated
+    TEST_ASSERT_FALSE(catzilla_ws_utf8_valid((const uint8_t*)"\xce\xba\xff", 3));
+}
+
+// ---------------------------------------------------------------------------
+// Frames
+// ---------------------------------------------------------------------------
+
+void test_single_frame_is_delivered_in_place(void) {
+    catzilla_ws_session_t* session = new_session(0, NULL);
+    // RFC 6455 5.7: a masked "Hello"
+    unsigned char frame[] = {0x81, 0x85, 0x37, 0xfa, 0x21, 0x3d, 0x7f, 0x9f, 0x4d, 0x51, 0x58};
+
+    TEST_ASSERT_EQUAL(0, catzilla_ws_session_receive(session, (char*)frame, sizeof(frame)));
+    TEST_ASSERT_EQUAL(1, capture.messages);
+    TEST_ASSERT_EQUAL(CATZILLA_WS_OP_TEXT, capture.last_opcode);
+    TEST_ASSERT_EQUAL(5, capture.last_length);
+    TEST_ASSERT_EQUAL_MEMORY("Hello", capture.last_message, 5);
+    TEST_ASSERT_EQUAL_PTR(frame + 6, capture.last_pointer);
+    catzilla_ws_session_free(session);
+}
+
+void test_fragments_split_over_reads_are_reassembled(void) {
+    catzilla_ws_session_t* session = new_session(0, NULL);
+    unsigned char input[128];
+    size_t length = client_frame(input, 0x01, "Hel", 3);       // Text, not final
+    length += client_frame(input + length, 0x89, "hi", 2);     // Ping between fragments
+    length += client_frame(input + length, 0x80, "lo", 2);     // Final continuation
+
+    // One byte per read
+    for (size_t i = 0; i < length; i++) {
+        TEST_ASSERT_EQUAL(0, catzilla_ws_session_receive(session, (char*)input + i, 1));
+    }
+    TEST_ASSERT_EQUAL(1, capture.messages);
+    TEST_ASSERT_EQUAL(5, capture.last_length);
+    TEST_ASSERT_EQUAL_MEMORY("Hello", capture.last_message, 5);
+
+    // The ping was answered with its payload, unmasked
+    const unsigned char pong[] = {0x8a, 0x02, 'h', 'i'};
+    TEST_ASSERT_EQUAL(sizeof(pong), capture.sent_length);
+    TEST_ASSERT_EQUAL_MEMORY(pong, capture.sent, sizeof(pong));
+    TEST_ASSERT_FALSE(capture.close_after);
+    catzilla_ws_session_free(session);
+}
+
+void test_extended_lengths(void) {
+    catzilla_ws_session_t* session = new_session(0, NULL);
+    static unsigned char payload[70000];
+    static unsigned char input[70016];
+    for (size_t i = 0; i < sizeof(payload); i++) payload[i] = (unsigned char)i;
+
+    size_t length = client_frame(input, 0x82, payload, 300);
+    TEST_ASSERT_EQUAL(0, catzilla_ws_session_receive(session, (char*)input, length));
+    TEST_ASSERT_EQUAL(300, capture.last_length);
+    TEST_ASSERT_EQUAL_MEMORY(payload, capture.last_message, 300);
+
+    length = client_frame(input, 0x82, payload, sizeof(payload));
+    TEST_ASSERT_EQUAL(0, catzilla_ws_session_receive(session, (char*)input, 5000));
+    TEST_ASSERT_EQUAL(1, capture.messages);
+    TEST_ASSERT_EQUAL(0, catzilla_ws_session_receive(session, (char*)input + 5000, length - 5000));
+    TEST_ASSERT_EQUAL(2, capture.messages);
+    TEST_ASSERT_EQUAL(sizeof(payload), capture.last_length);
+
+    // Frames the server writes use the shortest length encoding
+    capture.sent_length = 0;
+    TEST_ASSERT_EQUAL(0, catzilla_ws_session_send(session, CATZILLA_WS_OP_BINARY, (const char*)payload, 125));
+    TEST_ASSERT_EQUAL(0x82, capture.sent[0]);
+    TEST_ASSERT_EQUAL(125, capture.sent[1]);
+    capture.sent_length = 0;
+    TEST_ASSERT_EQUAL(0, catzilla_ws_session_send(session, CATZILLA_WS_OP_BINARY, (const char*)payload, 126));
+    TEST_ASSERT_EQUAL(126, capture.sent[1]);
+    TEST_ASSERT_EQUAL(0, capture.sent[2]);
+    TEST_ASSERT_EQUAL(126, capture.sent[3]);
+    capture.sent_length = 0;
+    TEST_ASSERT_EQUAL(0, catzilla_ws_session_send(session, CATZILLA_WS_OP_BINARY, (const char*)payload, 65536));
+    TEST_ASSERT_EQUAL(127, capture.sent[1]);
+    TEST_ASSERT_EQUAL(1, capture.sent[7]);
+    TEST_ASSERT_EQUAL(0, capture.sent[8]);
+    TEST_ASSERT_EQUAL(10 + 65536, capture.sent_length);
+    catzilla_ws_session_free(session);
+}
+
+void test_peer_close_is_echoed(void) {
+    catzilla_ws_session_t* session = new_session(0, NULL);
+    unsigned char input[64];
+    const char close_body[] = "\x03\xe8" "bye";
+    size_t length = client_frame(input, 0x88, close_body, 5);
+
+    TEST_ASSERT_EQUAL(-1, catzilla_ws_session_receive(session, (char*)input, length));
+    TEST_ASSERT_EQUAL(CATZILLA_WS_CLOSED, catzilla_ws_session_state(session));
+    TEST_ASSERT_EQUAL(1000, sent_close_code());
+    TEST_ASSERT_TRUE(capture.close_after);
+
+    const char* reason;
+    size_t reason_length;
+    TEST_ASSERT_EQUAL(1000, catzilla_ws_session_close_code(session, &reason, &reason_length));
+    TEST_ASSERT_EQUAL(3, reason_length);
+    TEST_ASSERT_EQUAL_MEMORY("bye", reason, 3);
+    TEST_ASSERT_EQUAL(-1, catzilla_ws_session_send(session, CATZILLA_WS_OP_TEXT, "x", 1));
+    catzilla_ws_session_free(session);
+}
+
+void test_server_close_waits_for_the_peer(void) {
+    catzilla_ws_session_t* session = new_session(0, NULL);
+    TEST_ASSERT_EQUAL(0, catzilla_ws_session_close(session, 1001, "restart", 7));
+    TEST_ASSERT_EQUAL(CATZILLA_WS_CLOSING, catzilla_ws_session_state(session));
+    TEST_ASSERT_EQUAL(1001, sent_close_code());
+    TEST_ASSERT_FALSE(capture.close_after);
+    TEST_ASSERT_EQUAL(-1, catzilla_ws_session_close(session, 1000, NULL, 0));
+
+    // Messages still in flight are dropped; the answer ends the session
+    unsigned char input[64];
+    size_t length = client_frame(input, 0x81, "late", 4);
+    length += client_frame(input + length, 0x88, "\x03\xe9", 2);
+    capture.sends = 0;
+    TEST_ASSERT_EQUAL(-1, catzilla_ws_session_receive(session, (char*)input, length));
+    TEST_ASSERT_EQUAL(0, capture.messages);
+    TEST_ASSERT_EQUAL(0, capture.sends);
+    TEST_ASSERT_EQUAL(1001, catzilla_ws_session_close_code(session, NULL, NULL));
+    catzilla_ws_session_free(session);
+}
+
+static void assert_fails_with(const unsigned char* input, size_t length, size_t max_message_size, int code) {
+    memset(&capture, 0, sizeof(capture));
+    catzilla_ws_session_t* session = new_session(max_message_size, NULL);
+    TEST_ASSERT_EQUAL(-1, catzilla_ws_session_receive(session, (char*)input, length));
+    TEST_ASSERT_EQUAL(code, sent_close_code());
+    TEST_ASSERT_TRUE(capture.close_after);
+    TEST_ASSERT_EQUAL(0, capture.messages);
+    catzilla_ws_session_free(session);
+}
+
+void test_protocol_errors_fail_the_connection(void) {
+    unsigned char input[256];
+
+    const unsigned char unmasked[] = {0x81, 0x02, 'h', 'i'};
+    assert_fails_with(unmasked, sizeof(unmasked), 0, CATZILLA_WS_CLOSE_PROTOCOL_ERROR);
+
+    size_t length = client_frame(input, 0xc1, "hi", 2);  // RSV1 without deflate
+    assert_fails_with(input, length, 0, CATZILLA_WS_CLOSE_PROTOCOL_ERROR);
+
+    length = client_frame(input, 0x80, "hi", 2);  // Continuation outside a message
+    assert_fails_with(input, length, 0, CATZILLA_WS_CLOSE_PROTOCOL_ERROR);
+
+    length = client_frame(input, 0x09, "hi", 2);  // Fragmented ping
+    assert_fails_with(input, length, 0, CATZILLA_WS_CLOSE_PROTOCOL_ERROR);
+
+    length = client_frame(input, 0x83, "hi", 2);  // Reserved opcode
+    assert_fails_with(input, length, 0, CATZILLA_WS_CLOSE_PROTOCOL_ERROR);
+
+    length = client_frame(input, 0x88, "\x03\xed", 2);  // Close code 1005 is never sent
+    assert_fails_with(input, length, 0, CATZILLA_WS_CLOSE_PROTOCOL_ERROR);
+
+    length = client_frame(input, 0x81, "\xce\xba\xe1\xbd\xb9\xcf\x83\xce\xbc\xce\xb5\xed\xa0\x80", 14);
+    assert_fails_with(input, length, 0, CATZILLA_WS_CLOSE_INVALID_DATA);
+
+    length = client_frame(input, 0x82, input + 128, 100);
+    assert_fails_with(input, length, 64, CATZILLA_WS_CLOSE_TOO_BIG);
+}
+
+void test_utf8_checked_on_whole_message(void) {
+    catzilla_ws_session_t* session = new_session(0, NULL);
+    unsigned char input[64];
+    // A valid character split between two fragments is fine
+    size_t length = client_frame(input, 0x01, "\xe2\x82", 2);
+    length += client_frame(input + length, 0x80, "\xac", 1);
+    TEST_ASSERT_EQUAL(0, catzilla_ws_session_receive(session, (char*)input, length));
+    TEST_ASSERT_EQUAL(1, capture.messages);
+    TEST_ASSERT_EQUAL_MEMORY("\xe2\x82\xac", capture.last_message, 3);
+    catzilla_ws_session_free(session);
+}
+
+// ---------------------------------------------------------------------------
+// permessage-deflate
+// ---------------------------------------------------------------------------
+
+#ifdef CATZILLA_HAS_ZLIB
+static catzilla_ws_deflate_params_t default_deflate(void) {
+    catzilla_ws_deflate_params_t params;
+    memset(&params, 0, sizeof(params));
+    params.enabled = true;
+    params.server_max_window_bits = 15;
+    return params;
+}
+
+void test_deflate_receive_rfc_sample(void) {
+    catzilla_ws_deflate_params_t params = default_deflate();
+    catzilla_ws_session_t* session = new_session(0, &params);
+    // RFC 7692 7.2.3.1: "Hello" compressed, sent twice with context takeover
+    const unsigned char hello[] = {0xf2, 0x48, 0xcd, 0xc9, 0xc9, 0x07, 0x00};
+    const unsigned char again[] = {0xf2, 0x00, 0x11, 0x00, 0x00};
+    unsigned char input[64];
+
+    size_t length = client_frame(input, 0xc1, hello, sizeof(hello));
+    TEST_ASSERT_EQUAL(0, catzilla_ws_session_receive(session, (char*)input, length));
+    TEST_ASSERT_EQUAL(1, capture.messages);
+    TEST_ASSERT_EQUAL(5, capture.last_length);
+    TEST_ASSERT_EQUAL_MEMORY("Hello", capture.last_message, 5);
+
+    length = client_frame(input, 0xc1, again, sizeof(again));
+    TEST_ASSERT_EQUAL(0, catzilla_ws_session_receive(session, (char*)input, length));
+    TEST_ASSERT_EQUAL(2, capture.messages);
+    TEST_ASSERT_EQUAL_MEMORY("Hello", capture.last_message, 5);
+    catzilla_ws_session_free(session);
+}
+
+void test_deflate_send_round_trips(void) {
+    catzilla_ws_deflate_params_t params = default_deflate();
+    catzilla_ws_session_t* session = new_session(0, &params);
+    char text[1024];
+    for (size_t i = 0; i < sizeof(text); i++) text[i] = "catzilla "[i % 9];
+
+    for (int round = 0; round < 2; round++) {
+        capture.sent_length = 0;
+        TEST_ASSERT_EQUAL(0, catzilla_ws_session_send(session, CATZILLA_WS_OP_TEXT, text, sizeof(text)));
+        TEST_ASSERT_EQUAL(0xc1, capture.sent[0]);  // FIN, RSV1, text
+        size_t payload_length = capture.sent[1];
+        TEST_ASSERT_TRUE(payload_length < 126);
+
+        // Inflate what was sent, with the stripped tail put back
+        static z_stream z;
+        if (round == 0) {
+            memset(&z, 0, sizeof(z));
+            TEST_ASSERT_EQUAL(Z_OK, inflateInit2(&z, -MAX_WBITS));
+        }
+        unsigned char compressed[256];
+        memcpy(compressed, capture.sent + 2, payload_length);
+        memcpy(compressed + payload_length, "\x00\x00\xff\xff", 4);
+        char out[2048];
+        z.next_in = compressed;
+        z.avail_in = (uInt)(payload_length + 4);
+        z.next_out = (Bytef*)out;
+        z.avail_out = sizeof(out);
+        TEST_ASSERT_EQUAL(Z_OK, inflate(&z, Z_SYNC_FLUSH));
+        TEST_ASSERT_EQUAL(sizeof(text), sizeof(out) - z.avail_out);
+        TEST_ASSERT_EQUAL_MEMORY(text, out, sizeof(text));
+        if (round == 1) inflateEnd(&z);
+    }
+
+    // Short messages go out uncompressed
+    capture.sent_length = 0;
+    TEST_ASSERT_EQUAL(0, catzilla_ws_session_send(session, CATZILLA_WS_OP_TEXT, "hi", 2));
+    TEST_ASSERT_EQUAL(0x81, capture.sent[0]);
+    catzilla_ws_session_free(session);
+}
+
+void test_deflate_limits_inflated_size(void) {
+    catzilla_ws_deflate_params_t params = default_deflate();
+    memset(&capture, 0, sizeof(capture));
+    catzilla_ws_session_t* session = new_session(1000, &params);
+
+    // 4000 zero bytes compress to a few bytes but inflate past the limit
+    static char zeros[4000];
+    unsigned char compressed[128];
+    z_stream z;
+    memset(&z, 0, sizeof(z));
+    TEST_ASSERT_EQUAL(Z_OK, deflateInit2(&z, 9, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY));
+    z.next_in = (Bytef*)zeros;
+    z.avail_in = sizeof(zeros);
+    z.next_out = compressed;
+    z.avail_out = sizeof(compressed);
+    TEST_ASSERT_EQUAL(Z_OK, deflate(&z, Z_SYNC_FLUSH));
+    size_t compressed_length = sizeof(compressed) - z.avail_out - 4;
+    deflateEnd(&z);
+
+    unsigned char input[256];
+    size_t length = client_frame(input, 0xc2, compressed, compressed_length);
+    TEST_ASSERT_EQUAL(-1, catzilla_ws_session_receive(session, (char*)input, length));
+    TEST_ASSERT_EQUAL(CATZILLA_WS_CLOSE_TOO_BIG, sent_close_code());
+    TEST_ASSERT_EQUAL(0, capture.messages);
+    catzilla_ws_session_free(session);
+}
+#endif
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_accept_key_matches_rfc_sample);
+    RUN_TEST(test_key_must_encode_sixteen_bytes);
+    RUN_TEST(test_negotiate_deflate);
+    RUN_TEST(test_unmask_matches_bytewise_xor);
+    RUN_TEST(test_utf8_validation);
+    RUN_TEST(test_single_frame_is_delivered_in_place);
+    RUN_TEST(test_fragments_split_over_reads_are_reassembled);
+    RUN_TEST(test_extended_lengths);
+    RUN_TEST(test_peer_close_is_echoed);
+    RUN_TEST(test_server_close_waits_for_the_peer);
+    RUN_TEST(test_protocol_errors_fail_the_connection);
+    RUN_TEST(test_utf8_checked_on_whole_message);
+#ifdef CATZILLA_HAS_ZLIB
+    RUN_TEST(test_deflate_receive_rfc_sample);
+    RUN_TEST(test_deflate_send_round_trips);
+    RUN_TEST(test_deflate_limits_inflated_size);
+#endif
+
+    return UNITY_END();
+}
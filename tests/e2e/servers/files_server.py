@@ -355,6 +355,20 @@ def delete_file(request) -> Response:
             "message": str(e)
         }, status_code=500)
 
+@app.post("/raw-upload")
+def raw_upload(request: Request) -> Response:
+    """Accept a raw body; large bodies are spooled to a temp file by the server"""
+    if request.body_file:
+        size = os.path.getsize(request.body_file)
+        return JSONResponse({"spooled": True, "size": size, "reported_size": request.body_file_size})
+
+    return JSONResponse({"spooled": False, "size": len(request.body or "")})
+
+# Spill bodies above 4 KB to disk and cap this route at 1 MB
+app.set_route_body_mode(
+    "POST", "/raw-upload", "spool", max_body_size=1024 * 1024, spool_threshold=4096
+)
+
 # ============================================================================
 # OPERATIONS TRACKING
 # ============================================================================
@@ -181,6 +181,13 @@ def error_handler(request: Request, error_type: str = PathParam(...)) -> Respons
     else:
         return JSONResponse({"error": f"Unknown error type: {error_type}"}, status_code=400)
 
+# Server counters, for tests that check how responses were written
+@app.get("/stats/connections")
+def connection_stats(request: Request) -> Response:
+    """Connection and write statistics of the native server"""
+    from catzilla._catzilla import get_connection_stats
+    return JSONResponse(get_connection_stats())
+
 if __name__ == "__main__":
     parser = argparse.ArgumentParser(description="Catzilla E2E Routing Test Server")
     parser.add_argument("--port", type=int, default=8100, help="Port to run server on")
@@ -378,3 +378,49 @@ async def test_large_file_handling(files_server):
         assert response.status_code == 200
         assert len(response.text) == 1024
         assert response.text == large_content
+
+@pytest.mark.asyncio
+async def test_raw_upload_small_body_stays_in_memory(files_server):
+    """Test bodies under the spool threshold are buffered"""
+    async with httpx.AsyncClient() as client:
+        response = await client.post(
+            f"{files_server}/raw-upload",
+            content=b"x" * 100,
+            headers={"Content-Type": "application/octet-stream"},
+        )
+        assert response.status_code == 200
+        data = response.json()
+        assert data["spooled"] is False
+        assert data["size"] == 100
+
+@pytest.mark.asyncio
+async def test_raw_upload_large_body_is_spooled(files_server):
+    """Test bodies above the spool threshold reach the handler as a temp file"""
+    async with httpx.AsyncClient() as client:
+        response = await client.post(
+            f"{files_server}/raw-upload",
+            content=b"y" * (256 * 1024),
+            headers={"Content-Type": "application/octet-stream"},
+        )
+        assert response.status_code == 200
+        data = response.json()
+        assert data["spooled"] is True
+        assert data["size"] == 256 * 1024
+        assert data["reported_size"] == 256 * 1024
+
+@pytest.mark.asyncio
+async def test_raw_upload_over_limit_gets_413(files_server):
+    """Test a Content-Length above max_body_size is rejected before the body is read"""
+    reader, writer = await asyncio.open_connection(FILES_SERVER_HOST, FILES_SERVER_PORT)
+    try:
+        writer.write(
+            b"POST /raw-upload HTTP/1.1\r\n"
+            b"Host: 127.0.0.1\r\n"
+            b"Content-Type: application/octet-stream\r\n"
+            b"Content-Length: 10485760\r\n\r\n"
+        )
+        await writer.drain()
+        status_line = await asyncio.wait_for(reader.readline(), timeout=10.0)
+        assert status_line.startswith(b"HTTP/1.1 413")
+    finally:
+        writer.close()
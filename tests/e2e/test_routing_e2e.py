@@ -265,6 +265,72 @@ class TestE2ERouting:
             data = response.json()
             assert data["user_id"] == i
 
+    @pytest.mark.asyncio
+    async def test_pipelined_requests(self, routing_server):
+        """Test HTTP/1.1 pipelined requests are answered in order on one connection"""
+        reader, writer = await asyncio.open_connection(ROUTING_SERVER_HOST, ROUTING_SERVER_PORT)
+        try:
+            user_ids = [7, 8, 9]
+            request = b"".join(
+                f"GET /users/{user_id} HTTP/1.1\r\nHost: {ROUTING_SERVER_HOST}\r\n\r\n".encode()
+                for user_id in user_ids
+            )
+            writer.write(request)
+            await writer.drain()
+
+            for user_id in user_ids:
+                status_line = await asyncio.wait_for(reader.readline(), timeout=10.0)
+                assert status_line.startswith(b"HTTP/1.1 200")
+
+                content_length = 0
+                while True:
+                    line = await reader.readline()
+                    if line == b"\r\n":
+                        break
+                    name, _, value = line.decode().partition(":")
+                    if name.lower() == "content-length":
+                        content_length = int(value.strip())
+
+                body = await reader.readexactly(content_length)
+                assert f'"user_id": {user_id}'.encode() in body or f'"user_id":{user_id}'.encode() in body
+        finally:
+            writer.close()
+            await writer.wait_closed()
+
+    @pytest.mark.asyncio
+    async def test_pipelined_python_responses_share_one_write(self, routing_server, http_client):
+        """Test Python responses to requests pipelined in one read go out in one write"""
+        before = (await http_client.get(f"{routing_server}/stats/connections")).json()
+
+        reader, writer = await asyncio.open_connection(ROUTING_SERVER_HOST, ROUTING_SERVER_PORT)
+        try:
+            user_ids = [11, 12, 13, 14, 15]
+            writer.write(b"".join(
+                f"GET /users/{user_id} HTTP/1.1\r\nHost: {ROUTING_SERVER_HOST}\r\n\r\n".encode()
+                for user_id in user_ids
+            ))
+            await writer.drain()
+
+            for user_id in user_ids:
+                status_line = await asyncio.wait_for(reader.readline(), timeout=10.0)
+                assert status_line.startswith(b"HTTP/1.1 200")
+                content_length = 0
+                while True:
+                    line = await reader.readline()
+                    if line == b"\r\n":
+                        break
+                    name, _, value = line.decode().partition(":")
+                    if name.lower() == "content-length":
+                        content_length = int(value.strip())
+                await reader.readexactly(content_length)
+        finally:
+            writer.close()
+            await writer.wait_closed()
+
+        after = (await http_client.get(f"{routing_server}/stats/connections")).json()
+        assert after["corked_flushes"] - before["corked_flushes"] == 1
+        assert after["corked_responses"] - before["corked_responses"] == len(user_ids)
+
     @pytest.mark.asyncio
     async def test_complete_crud_workflow(self, routing_server, http_client):
         """Test complete CRUD workflow"""
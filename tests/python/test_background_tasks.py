@@ -180,6 +180,96 @@ class TestBackgroundTasks(unittest.TestCase):
             self.assertIsNotNone(result.task_id)
 
 
+durable_runs = []
+
+
+def record_durable_run(value):
+    durable_runs.append(value)
+    return value
+
+
+class FakeTaskLog:
+    """In-memory stand-in for catzilla._catzilla.TaskLog"""
+
+    def __init__(self):
+        self.entries = {}
+        self.next_id = 1
+        self.closed = False
+
+    def append(self, payload, durable=True):
+        entry_id = self.next_id
+        self.next_id += 1
+        self.entries[entry_id] = payload
+        return entry_id
+
+    def complete(self, entry_id):
+        return self.entries.pop(entry_id, None) is not None
+
+    def pending(self):
+        return sorted(self.entries.items())
+
+    def close(self):
+        self.closed = True
+
+
+class TestDurableTasks(unittest.TestCase):
+    """Test durable tasks backed by the write-ahead task log"""
+
+    def setUp(self):
+        durable_runs.clear()
+        self.task_log = FakeTaskLog()
+        self.patcher = patch(
+            'catzilla.background_tasks._open_task_log',
+            return_value=self.task_log
+        )
+        self.patcher.start()
+
+    def tearDown(self):
+        self.patcher.stop()
+
+    def test_durable_task_completes_its_log_entry(self):
+        """A durable task is logged before it runs and completed after"""
+        task_system = BackgroundTasks(workers=1, enable_auto_scaling=False,
+                                      durable_dir='/tmp/unused')
+        try:
+            task_system.add_task(record_durable_run, 7)
+            deadline = time.time() + 5.0
+            while self.task_log.entries and time.time() < deadline:
+                time.sleep(0.01)
+            self.assertEqual(durable_runs, [7])
+            self.assertEqual(self.task_log.entries, {})
+        finally:
+            task_system.shutdown()
+        self.assertTrue(self.task_log.closed)
+
+    def test_pending_tasks_are_replayed_on_start(self):
+        """Tasks left pending by a previous process run on the next start"""
+        import pickle
+        self.task_log.append(pickle.dumps(
+            (record_durable_run, ('replayed',), {}, TaskPriority.HIGH.value)))
+        self.task_log.append(b'not a pickle')
+
+        task_system = BackgroundTasks(workers=1, enable_auto_scaling=False,
+                                      durable_dir='/tmp/unused')
+        try:
+            deadline = time.time() + 5.0
+            while self.task_log.entries and time.time() < deadline:
+                time.sleep(0.01)
+            self.assertEqual(durable_runs, ['replayed'])
+            self.assertEqual(self.task_log.entries, {})
+        finally:
+            task_system.shutdown()
+
+    def test_durable_requires_a_log(self):
+        """durable=True without a durable_dir is an error"""
+        task_system = BackgroundTasks(workers=1, enable_auto_scaling=False)
+        try:
+            with self.assertRaises(RuntimeError):
+                task_system.add_task(record_durable_run, 1, durable=True)
+        finally:
+            task_system.shutdown(wait_for_completion=False)
+
+
 class TestCatzillaIntegration(unittest.TestCase):
     """Test Background Task System integration with Catzilla"""
 
@@ -230,6 +230,36 @@ def test_app_route_registration():
     # Note: handler_name not available in C router
 
 
+def test_startup_report_phases():
+    """
+    Test the startup timing report:
+    - Import and constructor phases are reported right away
+    - Phases that run in listen() are missing before it
+    - The total is the sum of the phases
+    """
+    app = Catzilla(production=True)
+
+    report = app.get_startup_report()
+    assert list(report) == ["import", "init", "total"]
+    assert report["import"] > 0
+    assert report["total"] == pytest.approx(report["import"] + report["init"], abs=0.01)
+
+
+def test_subsystems_imported_on_first_use():
+    """
+    Test lazily imported subsystems:
+    - Their names still resolve from the package and are listed by dir()
+    - Unknown names raise AttributeError
+    """
+    import catzilla
+    from catzilla.smart_cache import SmartCache
+
+    assert catzilla.SmartCache is SmartCache
+    assert "StreamingResponse" in dir(catzilla)
+    with pytest.raises(AttributeError):
+        catzilla.NoSuchName
+
+
 def test_async_handler_sync_bridge_reuses_event_loop():
     """Async handlers executed from sync request handling should reuse the same loop."""
     app = Catzilla(production=True)
@@ -269,7 +299,7 @@ def test_production_async_timeout_disabled_by_default():
 
 def test_async_route_can_defer_response_completion(monkeypatch):
     """Async routes should defer completion through the bridge callback contract."""
-    app = Catzilla(production=True)
+    app = Catzilla(production=True, async_mode="thread")
     sent_responses = []
 
     @app.get("/async-deferred")
@@ -293,6 +323,36 @@ def test_async_route_can_defer_response_completion(monkeypatch):
     assert sent_responses == [(client, 200, '{"ok":true}')]
 
 
+def test_async_route_defers_to_loop_scheduler_by_default(monkeypatch):
+    """Without async_mode, async routes go to the I/O thread's event loop."""
+    app = Catzilla(production=True)
+    sent_responses = []
+
+    @app.get("/async-loop")
+    async def async_handler(request):
+        return JSONResponse({"ok": True})
+
+    def fake_send(self, client):
+        sent_responses.append((client, self.status_code, self.body))
+
+    def fake_schedule(coroutine, completion_callback):
+        completion_callback(asyncio.run(coroutine), None)
+        return True
+
+    monkeypatch.setattr(Response, "send", fake_send)
+    monkeypatch.setattr(app_module, "schedule_on_loop", fake_schedule)
+
+    client = object()
+    result = app._handle_request(client, "GET", "/async-loop", "", None)
+
+    assert app.async_mode == "loop"
+    assert result is True
+    assert sent_responses == [(client, 200, '{"ok":true}')]
+
+    with pytest.raises(ValueError):
+        Catzilla(production=True, async_mode="uvloop")
+
+
 # =====================================================
 # MODERN CATZILLA v0.2.0 AUTO-VALIDATION TESTS
 # =====================================================
@@ -0,0 +1,151 @@
+"""
+Tests for the C JSON serializer behind JSONResponse
+
+The serializer must give the same bytes as
+json.dumps(separators=(",", ":"), ensure_ascii=False) for everything json
+supports, and handle the extra types handlers commonly return.
+"""
+
+import datetime
+import decimal
+import json
+import threading
+import uuid
+
+import pytest
+
+from catzilla import JSONResponse
+from catzilla._catzilla import json_dumps
+
+
+def reference(value):
+    return json.dumps(value, separators=(",", ":"), ensure_ascii=False).encode("utf-8")
+
+
+class TestJSONSerializer:
+    """json_dumps output and errors"""
+
+    @pytest.mark.parametrize(
+        "value",
+        [
+            None,
+            True,
+            False,
+            0,
+            -1,
+            2**63 - 1,
+            -(2**63),
+            2**64 + 1,
+            10**40,
+            0.0,
+            -0.0,
+            0.1,
+            1e16,
+            1e-7,
+            123456789.0,
+            float("nan"),
+            float("inf"),
+            float("-inf"),
+            "",
+            "plain",
+            'quote " backslash \\ slash /',
+            "\n\r\t\b\f\x00\x1f\x7f",
+            "é ü 中文 😀",
+            [],
+            {},
+            [1, [2, [3, []]], {}],
+            (1, "two", None),
+            {"a": 1, "b": [True, None], "c": {"d": "e"}},
+            {1: "int", 2.5: "float", True: "bool", None: "none"},
+        ],
+    )
+    def test_matches_json_dumps(self, value):
+        assert json_dumps(value) == reference(value)
+
+    def test_large_payload(self):
+        value = [{"id": i, "name": f"item-{i}", "tags": ["x"] * 5} for i in range(5000)]
+        assert json_dumps(value) == reference(value)
+        # Reusing the per-thread buffer must not leak data between calls
+        assert json_dumps([1]) == b"[1]"
+
+    def test_subclasses(self):
+        class Number(int):
+            pass
+
+        class Text(str):
+            pass
+
+        class Mapping(dict):
+            pass
+
+        value = [Number(5), Text("q"), Mapping(a=1)]
+        assert json_dumps(value) == reference(value)
+
+    def test_extra_types(self):
+        when = datetime.datetime(2024, 1, 2, 3, 4, 5, tzinfo=datetime.timezone.utc)
+        ident = uuid.UUID("12345678-1234-5678-1234-567812345678")
+        value = {
+            "when": when,
+            "date": datetime.date(2024, 1, 2),
+            "time": datetime.time(3, 4),
+            "id": ident,
+            "price": decimal.Decimal("19.90"),
+        }
+        assert json_dumps(value) == (
+            b'{"when":"2024-01-02T03:04:05+00:00","date":"2024-01-02","time":"03:04:00",'
+            b'"id":"12345678-1234-5678-1234-567812345678","price":19.90}'
+        )
+
+    def test_extra_types_from_many_threads(self):
+        # Free-threaded builds may load the optional types on several threads at once
+        value = {"id": uuid.UUID(int=1), "price": decimal.Decimal("1.50")}
+        barrier = threading.Barrier(8)
+        results = []
+
+        def encode():
+            barrier.wait()
+            results.append(json_dumps(value))
+
+        threads = [threading.Thread(target=encode) for _ in range(8)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        assert results == [b'{"id":"00000000-0000-0000-0000-000000000001","price":1.50}'] * 8
+
+    def test_model_dump(self):
+        class Inner:
+            def model_dump(self):
+                return "inner"
+
+        class Model:
+            def model_dump(self):
+                return {"inner": Inner(), "n": 1}
+
+        assert json_dumps([Model()]) == b'[{"inner":"inner","n":1}]'
+
+    def test_errors(self):
+        with pytest.raises(TypeError):
+            json_dumps(object())
+        with pytest.raises(TypeError):
+            json_dumps({(1, 2): "tuple key"})
+
+        cycle = []
+        cycle.append(cycle)
+        with pytest.raises(RecursionError):
+            json_dumps(cycle)
+
+
+class TestJSONResponse:
+    """JSONResponse serializes lazily"""
+
+    def test_body_is_compact_json(self):
+        response = JSONResponse({"message": "héllo", "items": [1, 2]})
+        assert response.body == '{"message":"héllo","items":[1,2]}'
+        assert response.content_type == "application/json"
+
+    def test_body_can_be_replaced(self):
+        response = JSONResponse({"a": 1})
+        response.body = '{"b":2}'
+        assert response.body == '{"b":2}'
+        assert response.data == {"a": 1}
@@ -237,6 +237,38 @@ def test_headers_normalization():
     assert request.headers["x-custom-header"] == "value"
 
 
+def test_headers_lazy_from_native_request():
+    """
+    Test headers backed by the C request object:
+    - Verify headers are only read from the native object on first access
+    - Check the materialised dict is reused afterwards
+    - Ensure assigning headers replaces the native ones
+    """
+    class FakeNativeRequest:
+        reads = 0
+
+        @property
+        def headers(self):
+            FakeNativeRequest.reads += 1
+            return {"host": "example.com"}
+
+    native = FakeNativeRequest()
+    request = Request(
+        method="GET",
+        path="/test",
+        body="",
+        client=None,
+        request_capsule=native,
+    )
+    assert FakeNativeRequest.reads == 0
+    assert request.headers["host"] == "example.com"
+    assert request.headers.get("host") == "example.com"
+    assert FakeNativeRequest.reads == 1
+
+    request.headers = {"X-Override": "1"}
+    assert request.headers == {"x-override": "1"}
+
+
 def test_text_method():
     """
     Test text body access method:
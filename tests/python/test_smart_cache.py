@@ -498,6 +498,103 @@ class TestCacheDecorator:
         assert call_count == 2
 
 
+class TestRequestCoalescing:
+    """Test single-flight misses and stale-while-revalidate"""
+
+    @pytest.fixture
+    def smart_cache(self):
+        """Create a cache whose claims lapse quickly"""
+        temp_dir = tempfile.mkdtemp()
+        reset_cache()
+        try:
+            yield SmartCache(SmartCacheConfig(
+                memory_capacity=50,
+                disk_enabled=True,
+                disk_path=temp_dir,
+                fill_timeout=5.0,
+            ))
+        finally:
+            reset_cache()
+            import shutil
+            shutil.rmtree(temp_dir, ignore_errors=True)
+
+    def test_concurrent_misses_compute_once(self, smart_cache):
+        """Only the first miss runs the computation"""
+        calls = 0
+        started = threading.Event()
+
+        def compute():
+            nonlocal calls
+            calls += 1
+            started.set()
+            time.sleep(0.2)
+            return "expensive"
+
+        with ThreadPoolExecutor(max_workers=8) as executor:
+            futures = [executor.submit(smart_cache.get_or_set, "herd", compute, 60)
+                       for _ in range(8)]
+            results = [future.result(timeout=10) for future in futures]
+
+        assert results == ["expensive"] * 8
+        assert calls == 1
+        assert smart_cache.get_stats().coalesced >= 1
+
+    def test_failed_computation_hands_over(self, smart_cache):
+        """A caller whose computation raises lets the next one claim"""
+        with pytest.raises(RuntimeError):
+            smart_cache.get_or_set("flaky", Mock(side_effect=RuntimeError("down")), 60)
+        assert smart_cache.get_or_set("flaky", lambda: "recovered", 60) == "recovered"
+
+    def test_lapsed_claim_is_taken_over(self, smart_cache):
+        """A claim that is never released stops blocking after fill_timeout"""
+        smart_cache.config.fill_timeout = 0.05
+        leader, _ = smart_cache.claim("abandoned")
+        assert leader
+        time.sleep(0.1)
+        leader, flight = smart_cache.claim("abandoned")
+        assert leader
+        smart_cache.release("abandoned", flight)
+
+    def test_stale_value_served_while_refreshing(self, smart_cache):
+        """Past its TTL a value is returned at once and refreshed in the background"""
+        refreshed = threading.Event()
+
+        def compute_new():
+            refreshed.set()
+            return "new"
+
+        smart_cache.set("swr", "old", ttl=1, stale_ttl=60)
+        value, found, stale = smart_cache.lookup("swr")
+        assert (value, found, stale) == ("old", True, False)
+
+        with patch("time.time", return_value=time.time() + 2):
+            assert smart_cache.get_or_set("swr", compute_new, 1, 60) == "old"
+        assert refreshed.wait(5)
+
+        deadline = time.time() + 5
+        while smart_cache.get("swr")[0] != "new" and time.time() < deadline:
+            time.sleep(0.01)
+        assert smart_cache.get("swr") == ("new", True)
+        assert smart_cache.get_stats().stale_hits == 1
+
+    def test_decorator_coalesces(self, smart_cache):
+        """The cached decorator computes concurrent misses once"""
+        calls = 0
+
+        @cached(ttl=60, key_prefix="coalesce_")
+        def slow_square(x):
+            nonlocal calls
+            calls += 1
+            time.sleep(0.2)
+            return x * x
+
+        with ThreadPoolExecutor(max_workers=4) as executor:
+            results = list(executor.map(slow_square, [3] * 4))
+
+        assert results == [9] * 4
+        assert calls == 1
+
+
 # ============================================================================
 # Cache Middleware Tests
 # ============================================================================
@@ -580,7 +677,31 @@ class TestCacheMiddleware:
 
         if cached_response:  # If caching is working
             assert cached_response is not None
-            assert cached_response.headers.get('x-cache') == 'HIT'
+            assert cached_response.get_header('x-cache') == 'HIT'
+
+    @pytest.mark.asyncio
+    async def test_concurrent_misses_wait_for_first_response(self, temp_dir):
+        """Requests that miss while the first is computing reuse its response"""
+        cache = SmartCache(SmartCacheConfig(disk_enabled=True, disk_path=temp_dir))
+        middleware = SmartCacheMiddleware(cache_instance=cache, default_ttl=300)
+
+        first = self.create_mock_request(path="/api/herd")
+        assert await middleware.process_request(first) is None
+
+        waiting = asyncio.ensure_future(
+            middleware.process_request(self.create_mock_request(path="/api/herd"))
+        )
+        await asyncio.sleep(0.05)
+        assert not waiting.done()
+
+        response = self.create_mock_response("herd")
+        response.media_type = "text/plain"
+        await middleware.process_response(first, response)
+        cached_response = await asyncio.wait_for(waiting, 5)
+        assert cached_response is not None
+        assert cached_response.get_header('x-cache') == 'HIT'
+        assert cached_response.body == "herd"
+        assert middleware.stats["cache_coalesced"] == 1
 
     @pytest.mark.asyncio
     async def test_cache_skip_conditions(self, middleware):